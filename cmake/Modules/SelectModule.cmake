@@ -39,6 +39,7 @@ macro (SelectModule)
   option(BUILD_BOX2D "Build box2d external without using it for physics library" OFF)
   option(BUILD_CPP_TESTS "Build TestCpp samples" ${BUILD_CPP_TESTS_DEFAULT})
   option(BUILD_CPP_EMPTY_TEST "Build TestCpp samples" ${BUILD_CPP_EMPTY_TEST_DEFAULT})
+  option(BUILD_MICRO_BENCHMARKS "Build the micro-benchmarks of the engine internals" OFF)
   option(BUILD_LUA_LIBS "Build lua libraries" ${BUILD_LUA_LIBS_DEFAULT})
   option(BUILD_LUA_TESTS "Build TestLua samples" ${BUILD_LUA_TESTS_DEFAULT})
   option(BUILD_JS_LIBS "Build js libraries" ${BUILD_JS_LIBS_DEFAULT})
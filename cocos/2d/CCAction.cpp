@@ -31,7 +31,118 @@ THE SOFTWARE.
 #include "base/CCDirector.h"
 #include "base/ccUTF8.h"
 
+#if CC_ENABLE_ACTION_POOL
+#include <mutex>
+#endif
+
 NS_CC_BEGIN
+
+#if CC_ENABLE_ACTION_POOL
+namespace
+{
+    // Every block starts with a header holding its bucket, so operator delete doesn't need
+    // the size and the payload keeps the 16 byte alignment malloc gives.
+    const std::size_t ACTION_POOL_HEADER_SIZE = 16;
+    const std::size_t ACTION_POOL_GRANULARITY = 16;
+    // sizes up to 512 bytes are pooled, bigger actions go straight to the heap
+    const std::size_t ACTION_POOL_BUCKET_COUNT = 32;
+    const std::size_t ACTION_POOL_BLOCKS_PER_CHUNK = 32;
+    const unsigned char ACTION_POOL_HEAP_BLOCK = 0xff;
+
+    struct ActionPool
+    {
+        std::mutex mutex;
+        void* freeLists[ACTION_POOL_BUCKET_COUNT];
+    };
+
+    ActionPool* getActionPool()
+    {
+        // intentionally never destroyed: actions held by static objects may be released
+        // after the static destructors have run
+        static ActionPool* pool = new (std::nothrow) ActionPool();
+        return pool;
+    }
+
+    void* allocateActionBlock(std::size_t size)
+    {
+        std::size_t bucket = size == 0 ? 0 : (size - 1) / ACTION_POOL_GRANULARITY;
+        ActionPool* pool = getActionPool();
+        if (bucket >= ACTION_POOL_BUCKET_COUNT || pool == nullptr)
+        {
+            auto block = static_cast<unsigned char*>(malloc(ACTION_POOL_HEADER_SIZE + size));
+            if (block == nullptr)
+                return nullptr;
+            block[0] = ACTION_POOL_HEAP_BLOCK;
+            return block + ACTION_POOL_HEADER_SIZE;
+        }
+
+        std::lock_guard<std::mutex> lock(pool->mutex);
+        void*& head = pool->freeLists[bucket];
+        if (head == nullptr)
+        {
+            // blocks of a chunk are never given back to the heap, the pool only grows to the peak
+            // number of live actions per bucket
+            const std::size_t blockSize = ACTION_POOL_HEADER_SIZE + (bucket + 1) * ACTION_POOL_GRANULARITY;
+            auto chunk = static_cast<unsigned char*>(malloc(blockSize * ACTION_POOL_BLOCKS_PER_CHUNK));
+            if (chunk == nullptr)
+                return nullptr;
+            for (std::size_t i = 0; i < ACTION_POOL_BLOCKS_PER_CHUNK; ++i)
+            {
+                unsigned char* block = chunk + i * blockSize;
+                block[0] = static_cast<unsigned char>(bucket);
+                *reinterpret_cast<void**>(block + ACTION_POOL_HEADER_SIZE) =
+                    (i + 1 < ACTION_POOL_BLOCKS_PER_CHUNK) ? block + blockSize + ACTION_POOL_HEADER_SIZE : nullptr;
+            }
+            head = chunk + ACTION_POOL_HEADER_SIZE;
+        }
+
+        void* ptr = head;
+        head = *static_cast<void**>(ptr);
+        return ptr;
+    }
+
+    void deallocateActionBlock(void* ptr)
+    {
+        if (ptr == nullptr)
+            return;
+
+        unsigned char* block = static_cast<unsigned char*>(ptr) - ACTION_POOL_HEADER_SIZE;
+        if (block[0] == ACTION_POOL_HEAP_BLOCK)
+        {
+            free(block);
+            return;
+        }
+
+        ActionPool* pool = getActionPool();
+        std::lock_guard<std::mutex> lock(pool->mutex);
+        *static_cast<void**>(ptr) = pool->freeLists[block[0]];
+        pool->freeLists[block[0]] = ptr;
+    }
+}
+
+void* Action::operator new(std::size_t size)
+{
+    void* ptr = allocateActionBlock(size);
+    CCASSERT(ptr, "No memory");
+    return ptr;
+}
+
+void* Action::operator new(std::size_t size, const std::nothrow_t&) throw()
+{
+    return allocateActionBlock(size);
+}
+
+void Action::operator delete(void* ptr) throw()
+{
+    deallocateActionBlock(ptr);
+}
+
+void Action::operator delete(void* ptr, const std::nothrow_t&) throw()
+{
+    deallocateActionBlock(ptr);
+}
+#endif // CC_ENABLE_ACTION_POOL
+
 //
 // Action Base Class
 //
@@ -41,6 +152,7 @@ Action::Action()
 ,_target(nullptr)
 ,_tag(Action::INVALID_TAG)
 ,_flags(0)
+,_actionManagerIndex(-1)
 {
 #if CC_ENABLE_SCRIPT_BINDING
     ScriptEngineProtocol* engine = ScriptEngineManager::getInstance()->getScriptEngine();
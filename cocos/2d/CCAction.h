@@ -31,6 +31,7 @@ THE SOFTWARE.
 #include "base/CCRef.h"
 #include "math/CCGeometry.h"
 #include "base/CCScriptSupport.h"
+#include <new>
 
 NS_CC_BEGIN
 
@@ -53,6 +54,17 @@ class CC_DLL Action : public Ref, public Clonable
 public:
     /** Default tag used for all the actions. */
     static const int INVALID_TAG = -1;
+#if CC_ENABLE_ACTION_POOL
+    /** Actions are allocated from a pool of size bucketed blocks. The memory of a finished
+     * action goes back to the pool and is reused by the next action of a similar size.
+     * @js NA
+     * @lua NA
+     */
+    static void* operator new(std::size_t size);
+    static void* operator new(std::size_t size, const std::nothrow_t&) throw();
+    static void operator delete(void* ptr) throw();
+    static void operator delete(void* ptr, const std::nothrow_t&) throw();
+#endif
     /**
      * @js NA
      * @lua NA
@@ -182,6 +194,10 @@ protected:
     ccScriptType _scriptType;         ///< type of script binding, lua or javascript
 #endif
 private:
+    friend class ActionManager;
+    // slot of this action in the update array of its ActionManager, -1 when not running
+    ssize_t _actionManagerIndex;
+
     CC_DISALLOW_COPY_AND_ASSIGN(Action);
 };
 
@@ -29,6 +29,7 @@ THE SOFTWARE.
 #include "2d/CCGrid.h"
 #include "2d/CCNodeGrid.h"
 #include "base/CCDirector.h"
+#include "renderer/CCGLProgramState.h"
 
 NS_CC_BEGIN
 // implementation of GridAction
@@ -99,6 +100,29 @@ GridBase* GridAction::getGrid()
 
 // implementation of Grid3DAction
 
+Grid3DAction::Grid3DAction()
+: _shaderEnabled(false)
+, _shaderState(nullptr)
+{
+}
+
+Grid3DAction::~Grid3DAction()
+{
+    CC_SAFE_RELEASE(_shaderState);
+}
+
+void Grid3DAction::startWithTarget(Node *target)
+{
+    GridAction::startWithTarget(target);
+
+    // a reused grid may have the shader of the previous action
+    CC_SAFE_RELEASE_NULL(_shaderState);
+    Grid3D *g = (Grid3D*)_gridNodeTarget->getGrid();
+    const char* vertexShader = _shaderEnabled ? getVertexShader() : nullptr;
+    _shaderState = g->setVertexShader(vertexShader ? getShaderKey() : "", vertexShader);
+    CC_SAFE_RETAIN(_shaderState);
+}
+
 GridBase* Grid3DAction::getGrid()
 {
     return Grid3D::create(_gridSize, _gridNodeTarget->getGridRect());
@@ -33,6 +33,7 @@ NS_CC_BEGIN
 
 class GridBase;
 class NodeGrid;
+class GLProgramState;
 
 /**
  * @addtogroup actions
@@ -146,6 +147,32 @@ public:
      * @return Return the effect grid rect.
      */
     Rect getGridRect() const;
+
+    /**
+     * @brief Moves the vertices in a vertex shader instead of on the CPU, each update then only sets uniforms.
+     * Waves3D, Ripple3D, Liquid, Waves, Twirl and PageTurn3D have a shader, the other actions move the vertices
+     * on the CPU anyway. It's false by default, and set before the action starts.
+     * While the shader is used getVertex() returns the vertices before they are moved.
+     * @since v3.14
+     */
+    void setShaderEnabled(bool enabled) { _shaderEnabled = enabled; }
+    bool isShaderEnabled() const { return _shaderEnabled; }
+
+    virtual void startWithTarget(Node *target) override;
+
+CC_CONSTRUCTOR_ACCESS:
+    Grid3DAction();
+    virtual ~Grid3DAction();
+
+protected:
+    /** Returns the key of the program of the shader of the action in GLProgramCache, nullptr if it has none. */
+    virtual const char* getShaderKey() const { return nullptr; }
+    /** Returns the source of the vertex shader of the action, see Grid3D::setVertexShader(). */
+    virtual const char* getVertexShader() const { return nullptr; }
+
+    bool _shaderEnabled;
+    // the state of the shader while the action runs with it, the update sets its uniforms
+    GLProgramState* _shaderState;
 };
 
 /**
@@ -25,8 +25,121 @@ THE SOFTWARE.
 ****************************************************************************/
 #include "2d/CCActionGrid3D.h"
 #include "base/CCDirector.h"
+#include "renderer/CCGLProgramState.h"
 
 NS_CC_BEGIN
+
+// The vertex shaders of the actions, they move a_position as the updates move the vertices on the CPU.
+// u_phase is time * PI * waves * 2 and u_amplitude is the amplitude by its rate.
+#define GRID_SHADER_HEADER               \
+    "attribute vec4 a_position;\n"       \
+    "attribute vec2 a_texCoord;\n"       \
+    "#ifdef GL_ES\n"                     \
+    "varying mediump vec2 v_texCoord;\n" \
+    "#else\n"                            \
+    "varying vec2 v_texCoord;\n"         \
+    "#endif\n"
+
+// u_grid is the origin of the grid and the size of its cells, u_gridSize its number of cells
+#define GRID_SHADER_INDEX                                          \
+    "uniform vec4 u_grid;\n"                                       \
+    "uniform vec2 u_gridSize;\n"                                   \
+    "vec2 gridIndex(vec2 position)\n"                              \
+    "{\n"                                                          \
+    "    return floor((position - u_grid.xy) / u_grid.zw + 0.5);\n" \
+    "}\n"
+
+static const char* s_waves3DVert = GRID_SHADER_HEADER R"(
+uniform float u_phase;
+uniform float u_amplitude;
+
+void main()
+{
+    vec4 position = a_position;
+    position.z += sin(u_phase + (position.x + position.y) * 0.01) * u_amplitude;
+    gl_Position = CC_MVPMatrix * position;
+    v_texCoord = a_texCoord;
+}
+)";
+
+static const char* s_ripple3DVert = GRID_SHADER_HEADER R"(
+uniform float u_phase;
+uniform float u_amplitude;
+uniform vec2 u_position;
+uniform float u_radius;
+
+void main()
+{
+    vec4 position = a_position;
+    float r = length(u_position - position.xy);
+    if (r < u_radius)
+    {
+        r = u_radius - r;
+        float rate = r / u_radius;
+        position.z += sin(u_phase + r * 0.1) * u_amplitude * rate * rate;
+    }
+    gl_Position = CC_MVPMatrix * position;
+    v_texCoord = a_texCoord;
+}
+)";
+
+static const char* s_liquidVert = GRID_SHADER_HEADER GRID_SHADER_INDEX R"(
+uniform float u_phase;
+uniform float u_amplitude;
+
+void main()
+{
+    vec4 position = a_position;
+    // the border of the grid doesn't move
+    vec2 index = gridIndex(position.xy);
+    if (index.x > 0.0 && index.y > 0.0 && index.x < u_gridSize.x && index.y < u_gridSize.y)
+    {
+        position.xy += sin(u_phase + position.xy * 0.01) * u_amplitude;
+    }
+    gl_Position = CC_MVPMatrix * position;
+    v_texCoord = a_texCoord;
+}
+)";
+
+// u_directions is 1 or 0 for vertical and horizontal
+static const char* s_wavesVert = GRID_SHADER_HEADER R"(
+uniform float u_phase;
+uniform float u_amplitude;
+uniform vec2 u_directions;
+
+void main()
+{
+    vec4 position = a_position;
+    position.x += sin(u_phase + position.y * 0.01) * u_amplitude * u_directions.x;
+    position.y += sin(u_phase + position.x * 0.01) * u_amplitude * u_directions.y;
+    gl_Position = CC_MVPMatrix * position;
+    v_texCoord = a_texCoord;
+}
+)";
+
+// u_angle is the angle of rotation per cell from the center of the grid
+static const char* s_twirlVert = GRID_SHADER_HEADER GRID_SHADER_INDEX R"(
+uniform float u_angle;
+uniform vec2 u_position;
+
+void main()
+{
+    vec4 position = a_position;
+    float a = length(gridIndex(position.xy) - u_gridSize * 0.5) * u_angle;
+    vec2 d = position.xy - u_position;
+    position.x = u_position.x + sin(a) * d.y + cos(a) * d.x;
+    position.y = u_position.y + cos(a) * d.y - sin(a) * d.x;
+    gl_Position = CC_MVPMatrix * position;
+    v_texCoord = a_texCoord;
+}
+)";
+
+static void setGridUniforms(GLProgramState* state, const Rect& gridRect, const Size& gridSize)
+{
+    state->setUniformVec4("u_grid", Vec4(gridRect.origin.x, gridRect.origin.y,
+                                         gridRect.size.width / gridSize.width, gridRect.size.height / gridSize.height));
+    state->setUniformVec2("u_gridSize", Vec2(gridSize.width, gridSize.height));
+}
 // implementation of Waves3D
 
 Waves3D* Waves3D::create(float duration, const Size& gridSize, unsigned int waves, float amplitude)
@@ -60,11 +173,30 @@ bool Waves3D::initWithDuration(float duration, const Size& gridSize, unsigned in
 Waves3D* Waves3D::clone() const
 {
     // no copy constructor
-    return Waves3D::create(_duration, _gridSize, _waves, _amplitude);
+    auto a = Waves3D::create(_duration, _gridSize, _waves, _amplitude);
+    a->setShaderEnabled(_shaderEnabled);
+    return a;
+}
+
+const char* Waves3D::getShaderKey() const
+{
+    return "Grid3DAction:Waves3D";
+}
+
+const char* Waves3D::getVertexShader() const
+{
+    return s_waves3DVert;
 }
 
 void Waves3D::update(float time)
 {
+    if (_shaderState)
+    {
+        _shaderState->setUniformFloat("u_phase", (float)M_PI * time * _waves * 2);
+        _shaderState->setUniformFloat("u_amplitude", _amplitude * _amplitudeRate);
+        return;
+    }
+
     int i, j;
     for (i = 0; i < _gridSize.width + 1; ++i)
     {
@@ -426,12 +558,32 @@ Ripple3D* Ripple3D::clone() const
     // no copy constructor
     auto a = new (std::nothrow) Ripple3D();
     a->initWithDuration(_duration, _gridSize, _position, _radius, _waves, _amplitude);
+    a->setShaderEnabled(_shaderEnabled);
     a->autorelease();
     return a;
 }
 
+const char* Ripple3D::getShaderKey() const
+{
+    return "Grid3DAction:Ripple3D";
+}
+
+const char* Ripple3D::getVertexShader() const
+{
+    return s_ripple3DVert;
+}
+
 void Ripple3D::update(float time)
 {
+    if (_shaderState)
+    {
+        _shaderState->setUniformFloat("u_phase", time * (float)M_PI * _waves * 2);
+        _shaderState->setUniformFloat("u_amplitude", _amplitude * _amplitudeRate);
+        _shaderState->setUniformVec2("u_position", _position);
+        _shaderState->setUniformFloat("u_radius", _radius);
+        return;
+    }
+
     int i, j;
 
     for (i = 0; i < (_gridSize.width+1); ++i)
@@ -558,12 +710,31 @@ Liquid* Liquid::clone() const
     // no copy constructor
     auto a = new (std::nothrow) Liquid();
     a->initWithDuration(_duration, _gridSize, _waves, _amplitude);
+    a->setShaderEnabled(_shaderEnabled);
     a->autorelease();
     return a;
 }
 
+const char* Liquid::getShaderKey() const
+{
+    return "Grid3DAction:Liquid";
+}
+
+const char* Liquid::getVertexShader() const
+{
+    return s_liquidVert;
+}
+
 void Liquid::update(float time)
 {
+    if (_shaderState)
+    {
+        setGridUniforms(_shaderState, getGridRect(), _gridSize);
+        _shaderState->setUniformFloat("u_phase", time * (float)M_PI * _waves * 2);
+        _shaderState->setUniformFloat("u_amplitude", _amplitude * _amplitudeRate);
+        return;
+    }
+
     int i, j;
 
     for (i = 1; i < _gridSize.width; ++i)
@@ -620,12 +791,31 @@ Waves* Waves::clone() const
     // no copy constructor
     auto a = new (std::nothrow) Waves();
     a->initWithDuration(_duration, _gridSize, _waves, _amplitude, _horizontal, _vertical);
+    a->setShaderEnabled(_shaderEnabled);
     a->autorelease();
     return a;
 }
 
+const char* Waves::getShaderKey() const
+{
+    return "Grid3DAction:Waves";
+}
+
+const char* Waves::getVertexShader() const
+{
+    return s_wavesVert;
+}
+
 void Waves::update(float time)
 {
+    if (_shaderState)
+    {
+        _shaderState->setUniformFloat("u_phase", time * (float)M_PI * _waves * 2);
+        _shaderState->setUniformFloat("u_amplitude", _amplitude * _amplitudeRate);
+        _shaderState->setUniformVec2("u_directions", Vec2(_vertical ? 1.0f : 0.0f, _horizontal ? 1.0f : 0.0f));
+        return;
+    }
+
     int i, j;
 
     for (i = 0; i < _gridSize.width + 1; ++i)
@@ -695,12 +885,32 @@ Twirl *Twirl::clone() const
     // no copy constructor    
     auto a = new (std::nothrow) Twirl();
     a->initWithDuration(_duration, _gridSize, _position, _twirls, _amplitude);
+    a->setShaderEnabled(_shaderEnabled);
     a->autorelease();
     return a;
 }
 
+const char* Twirl::getShaderKey() const
+{
+    return "Grid3DAction:Twirl";
+}
+
+const char* Twirl::getVertexShader() const
+{
+    return s_twirlVert;
+}
+
 void Twirl::update(float time)
 {
+    if (_shaderState)
+    {
+        float amp = 0.1f * _amplitude * _amplitudeRate;
+        setGridUniforms(_shaderState, getGridRect(), _gridSize);
+        _shaderState->setUniformFloat("u_angle", cosf((float)M_PI/2.0f + time * (float)M_PI * _twirls * 2) * amp);
+        _shaderState->setUniformVec2("u_position", _position);
+        return;
+    }
+
     int i, j;
     Vec2    c = _position;
     
@@ -95,6 +95,9 @@ CC_CONSTRUCTOR_ACCESS:
     bool initWithDuration(float duration, const Size& gridSize, unsigned int waves, float amplitude);
 
 protected:
+    virtual const char* getShaderKey() const override;
+    virtual const char* getVertexShader() const override;
+
     unsigned int _waves;
     float _amplitude;
     float _amplitudeRate;
@@ -328,6 +331,9 @@ CC_CONSTRUCTOR_ACCESS:
     bool initWithDuration(float duration, const Size& gridSize, const Vec2& position, float radius, unsigned int waves, float amplitude);
 
 protected:
+    virtual const char* getShaderKey() const override;
+    virtual const char* getVertexShader() const override;
+
     /* center position */
     Vec2 _position;
     float _radius;
@@ -444,6 +450,9 @@ CC_CONSTRUCTOR_ACCESS:
     bool initWithDuration(float duration, const Size& gridSize, unsigned int waves, float amplitude);
 
 protected:
+    virtual const char* getShaderKey() const override;
+    virtual const char* getVertexShader() const override;
+
     unsigned int _waves;
     float _amplitude;
     float _amplitudeRate;
@@ -517,6 +526,9 @@ CC_CONSTRUCTOR_ACCESS:
     bool initWithDuration(float duration, const Size& gridSize, unsigned int waves, float amplitude, bool horizontal, bool vertical);
 
 protected:
+    virtual const char* getShaderKey() const override;
+    virtual const char* getVertexShader() const override;
+
     unsigned int _waves;
     float _amplitude;
     float _amplitudeRate;
@@ -601,6 +613,9 @@ CC_CONSTRUCTOR_ACCESS:
     bool initWithDuration(float duration, const Size& gridSize, const Vec2& position, unsigned int twirls, float amplitude);
 
 protected:
+    virtual const char* getShaderKey() const override;
+    virtual const char* getVertexShader() const override;
+
     /* twirl center */
     Vec2 _position;
     unsigned int _twirls;
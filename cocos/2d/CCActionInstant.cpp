@@ -36,7 +36,14 @@
 #pragma warning (disable: 4996)
 #endif
 
+#if CC_ENABLE_ALLOCATOR && CC_ENABLE_ENGINE_ALLOCATOR_POOLS
+#include "base/allocator/CCAllocatorStrategyPool.h"
+#endif
+
 NS_CC_BEGIN
+
+CC_DEFINE_ALLOCATOR_POOL(CallFunc, 128)
+
 //
 // InstantAction
 //
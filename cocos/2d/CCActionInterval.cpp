@@ -39,8 +39,27 @@ THE SOFTWARE.
 #include "platform/CCStdC.h"
 #include "base/CCScriptSupport.h"
 
+#if CC_ENABLE_ALLOCATOR && CC_ENABLE_ENGINE_ALLOCATOR_POOLS
+#include "base/allocator/CCAllocatorStrategyPool.h"
+#endif
+
 NS_CC_BEGIN
 
+CC_DEFINE_ALLOCATOR_POOL(Sequence, 128)
+CC_DEFINE_ALLOCATOR_POOL(Spawn, 128)
+CC_DEFINE_ALLOCATOR_POOL(RepeatForever, 128)
+CC_DEFINE_ALLOCATOR_POOL(Repeat, 128)
+CC_DEFINE_ALLOCATOR_POOL(MoveBy, 128)
+CC_DEFINE_ALLOCATOR_POOL(MoveTo, 128)
+CC_DEFINE_ALLOCATOR_POOL(ScaleTo, 128)
+CC_DEFINE_ALLOCATOR_POOL(ScaleBy, 128)
+CC_DEFINE_ALLOCATOR_POOL(RotateTo, 128)
+CC_DEFINE_ALLOCATOR_POOL(RotateBy, 128)
+CC_DEFINE_ALLOCATOR_POOL(FadeTo, 128)
+CC_DEFINE_ALLOCATOR_POOL(FadeIn, 128)
+CC_DEFINE_ALLOCATOR_POOL(FadeOut, 128)
+CC_DEFINE_ALLOCATOR_POOL(DelayTime, 128)
+
 // Extra action for making a Sequence or Spawn when only adding one action to it.
 class ExtraAction : public FiniteTimeAction
 {
@@ -2536,7 +2555,7 @@ Animate* Animate::create(Animation *animation)
 }
 
 Animate::Animate()
-: _splitTimes(new std::vector<float>)
+: _frameTable(nullptr)
 , _nextFrame(0)
 , _origFrame(nullptr)
 , _executedLoops(0)
@@ -2551,7 +2570,7 @@ Animate::~Animate()
 {
     CC_SAFE_RELEASE(_animation);
     CC_SAFE_RELEASE(_origFrame);
-    CC_SAFE_DELETE(_splitTimes);
+    CC_SAFE_RELEASE(_frameTable);
     CC_SAFE_RELEASE(_frameDisplayedEvent);
 }
 
@@ -2572,20 +2591,6 @@ bool Animate::initWithAnimation(Animation* animation)
         setAnimation(animation);
         _origFrame = nullptr;
         _executedLoops = 0;
-
-        _splitTimes->reserve(animation->getFrames().size());
-
-        float accumUnitsOfTime = 0;
-        float newUnitOfTimeValue = singleDuration / animation->getTotalDelayUnits();
-
-        auto& frames = animation->getFrames();
-
-        for (auto& frame : frames)
-        {
-            float value = (accumUnitsOfTime * newUnitOfTimeValue) / singleDuration;
-            accumUnitsOfTime += frame->getDelayUnits();
-            _splitTimes->push_back(value);
-        }    
         return true;
     }
     return false;
@@ -2598,13 +2603,18 @@ void Animate::setAnimation(cocos2d::Animation *animation)
         CC_SAFE_RETAIN(animation);
         CC_SAFE_RELEASE(_animation);
         _animation = animation;
+
+        auto frameTable = animation ? animation->getFrameTable() : nullptr;
+        CC_SAFE_RETAIN(frameTable);
+        CC_SAFE_RELEASE(_frameTable);
+        _frameTable = frameTable;
     }
 }
 
 Animate* Animate::clone() const
 {
     // no copy constructor
-    return Animate::create(_animation->clone());
+    return Animate::create(_animation);
 }
 
 void Animate::startWithTarget(Node *target)
@@ -2654,31 +2664,27 @@ void Animate::update(float t)
         t = fmodf(t, 1.0f);
     }
 
-    auto& frames = _animation->getFrames();
-    auto numberOfFrames = frames.size();
-    SpriteFrame *frameToDisplay = nullptr;
+    auto& frames = _frameTable->getFrames();
+    int numberOfFrames = (int)frames.size();
 
     for( int i=_nextFrame; i < numberOfFrames; i++ )
     {
-        float splitTime = _splitTimes->at(i);
+        const auto& frame = frames[i];
 
-        if( splitTime <= t )
+        if( frame.splitTime <= t )
         {
             auto blend = static_cast<Sprite*>(_target)->getBlendFunc();
             _currFrameIndex = i;
-            AnimationFrame* frame = frames.at(_currFrameIndex);
-            frameToDisplay = frame->getSpriteFrame();
-            static_cast<Sprite*>(_target)->setSpriteFrame(frameToDisplay);
+            static_cast<Sprite*>(_target)->setSpriteFrame(frame.spriteFrame);
             static_cast<Sprite*>(_target)->setBlendFunc(blend);
 
-            const ValueMap& dict = frame->getUserInfo();
-            if ( !dict.empty() )
+            if ( frame.userInfo )
             {
                 if (_frameDisplayedEvent == nullptr)
                     _frameDisplayedEvent = new (std::nothrow) EventCustom(AnimationFrameDisplayedNotification);
                 
                 _frameDisplayedEventInfo.target = _target;
-                _frameDisplayedEventInfo.userInfo = &dict;
+                _frameDisplayedEventInfo.userInfo = frame.userInfo;
                 _frameDisplayedEvent->setUserData(&_frameDisplayedEventInfo);
                 Director::getInstance()->getEventDispatcher()->dispatchEvent(_frameDisplayedEvent);
             }
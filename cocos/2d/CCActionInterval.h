@@ -119,6 +119,9 @@ protected:
     
 protected:
     bool sendUpdateEventToScript(float dt, Action *actionObject);
+
+    // ActionManager steps simple tweens in batches and keeps their time in sync
+    friend class ActionManager;
 };
 
 /** @class Sequence
@@ -127,6 +130,8 @@ protected:
 class CC_DLL Sequence : public ActionInterval
 {
 public:
+    CC_DECLARE_ALLOCATOR_POOL(Sequence)
+
     /** Helper constructor to create an array of sequenceable actions.
      *
      * @return An autoreleased Sequence object.
@@ -215,6 +220,8 @@ private:
 class CC_DLL Repeat : public ActionInterval
 {
 public:
+    CC_DECLARE_ALLOCATOR_POOL(Repeat)
+
     /** Creates a Repeat action. Times is an unsigned integer between 1 and pow(2,30).
      *
      * @param action The action needs to repeat.
@@ -286,6 +293,8 @@ private:
 class CC_DLL RepeatForever : public ActionInterval
 {
 public:
+    CC_DECLARE_ALLOCATOR_POOL(RepeatForever)
+
     /** Creates the action.
      *
      * @param action The action need to repeat forever.
@@ -351,6 +360,8 @@ private:
 class CC_DLL Spawn : public ActionInterval
 {
 public:
+    CC_DECLARE_ALLOCATOR_POOL(Spawn)
+
     /** Helper constructor to create an array of spawned actions.
      * @code
      * When this function bound to the js or lua, the input params changed.
@@ -440,6 +451,8 @@ private:
 class CC_DLL RotateTo : public ActionInterval
 {
 public:
+    CC_DECLARE_ALLOCATOR_POOL(RotateTo)
+
     /** 
      * Creates the action with separate rotation angles.
      *
@@ -506,6 +519,7 @@ protected:
     Vec3 _dstAngle;
     Vec3 _startAngle;
     Vec3 _diffAngle;
+    friend class ActionManager;
 
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(RotateTo);
@@ -517,6 +531,8 @@ private:
 class CC_DLL RotateBy : public ActionInterval
 {
 public:
+    CC_DECLARE_ALLOCATOR_POOL(RotateBy)
+
     /** 
      * Creates the action.
      *
@@ -587,6 +603,8 @@ private:
 class CC_DLL MoveBy : public ActionInterval
 {
 public:
+    CC_DECLARE_ALLOCATOR_POOL(MoveBy)
+
     /** 
      * Creates the action.
      *
@@ -628,6 +646,7 @@ protected:
     Vec3 _positionDelta;
     Vec3 _startPosition;
     Vec3 _previousPosition;
+    friend class ActionManager;
 
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(MoveBy);
@@ -642,6 +661,8 @@ private:
 class CC_DLL MoveTo : public MoveBy
 {
 public:
+    CC_DECLARE_ALLOCATOR_POOL(MoveTo)
+
     /** 
      * Creates the action.
      * @param duration Duration time, in seconds.
@@ -1052,6 +1073,8 @@ private:
 class CC_DLL ScaleTo : public ActionInterval
 {
 public:
+    CC_DECLARE_ALLOCATOR_POOL(ScaleTo)
+
     /** 
      * Creates the action with the same scale factor for X and Y.
      * @param duration Duration time, in seconds.
@@ -1123,6 +1146,7 @@ protected:
     float _deltaX;
     float _deltaY;
     float _deltaZ;
+    friend class ActionManager;
 
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(ScaleTo);
@@ -1135,6 +1159,8 @@ private:
 class CC_DLL ScaleBy : public ScaleTo
 {
 public:
+    CC_DECLARE_ALLOCATOR_POOL(ScaleBy)
+
     /** 
      * Creates the action with the same scale factor for X and Y.
      * @param duration Duration time, in seconds.
@@ -1229,6 +1255,8 @@ private:
 class CC_DLL FadeTo : public ActionInterval
 {
 public:
+    CC_DECLARE_ALLOCATOR_POOL(FadeTo)
+
     /** 
      * Creates an action with duration and opacity.
      * @param duration Duration time, in seconds.
@@ -1263,6 +1291,7 @@ protected:
     GLubyte _fromOpacity;
     friend class FadeOut;
     friend class FadeIn;
+    friend class ActionManager;
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(FadeTo);
 };
@@ -1274,6 +1303,8 @@ private:
 class CC_DLL FadeIn : public FadeTo
 {
 public:
+    CC_DECLARE_ALLOCATOR_POOL(FadeIn)
+
     /** 
      * Creates the action.
      * @param d Duration time, in seconds.
@@ -1309,6 +1340,8 @@ private:
 class CC_DLL FadeOut : public FadeTo
 {
 public:
+    CC_DECLARE_ALLOCATOR_POOL(FadeOut)
+
     /** 
      * Creates the action.
      * @param d Duration time, in seconds.
@@ -1381,6 +1414,7 @@ CC_CONSTRUCTOR_ACCESS:
 protected:
     Color3B _to;
     Color3B _from;
+    friend class ActionManager;
 
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(TintTo);
@@ -1440,6 +1474,8 @@ private:
 class CC_DLL DelayTime : public ActionInterval
 {
 public:
+    CC_DECLARE_ALLOCATOR_POOL(DelayTime)
+
     /** 
      * Creates the action.
      * @param d Duration time, in seconds.
@@ -1524,6 +1560,7 @@ public:
     static Animate* create(Animation *animation);
 
     /** Sets the Animation object to be animated 
+     * The action shares the frames of the animation, see Animation::getFrameTable().
      * 
      * @param animation certain animation.
      */
@@ -1543,6 +1580,7 @@ public:
     //
     // Overrides
     //
+    /** The clone shares the animation, the action doesn't modify it.*/
     virtual Animate* clone() const override;
     virtual Animate* reverse() const override;
     virtual void startWithTarget(Node *target) override;
@@ -1560,7 +1598,8 @@ CC_CONSTRUCTOR_ACCESS:
     bool initWithAnimation(Animation *animation);
 
 protected:
-    std::vector<float>* _splitTimes;
+    /** the frames of the animation, shared with the other actions playing it */
+    AnimationFrameTable* _frameTable;
     int             _nextFrame;
     SpriteFrame*    _origFrame;
     int _currFrameIndex;
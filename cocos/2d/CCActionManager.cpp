@@ -29,10 +29,20 @@ THE SOFTWARE.
 #include "2d/CCActionManager.h"
 #include "2d/CCNode.h"
 #include "2d/CCAction.h"
+#include "2d/CCActionInterval.h"
+#include "2d/CCActionEase.h"
+#include "2d/CCTweenFunction.h"
 #include "base/CCScheduler.h"
 #include "base/ccMacros.h"
 #include "base/ccCArray.h"
 #include "base/uthash.h"
+#include "base/CCProfiling.h"
+
+#include <typeinfo>
+
+#ifdef __SSE__
+#include <xmmintrin.h>
+#endif
 
 NS_CC_BEGIN
 //
@@ -42,17 +52,153 @@ typedef struct _hashElement
 {
     struct _ccArray     *actions;
     Node                *target;
-    int                 actionIndex;
-    Action              *currentAction;
-    bool                currentActionSalvaged;
     bool                paused;
     UT_hash_handle      hh;
 } tHashElement;
 
+namespace
+{
+    enum
+    {
+        TWEEN_EASE_NONE,
+        TWEEN_EASE_FUNCTION,
+        TWEEN_EASE_IN,
+        TWEEN_EASE_OUT,
+        TWEEN_EASE_IN_OUT
+    };
+
+    struct TweenEase
+    {
+        const std::type_info    *type;
+        int                     easeType;
+        float                   (*function)(float);
+    };
+
+    // eases which only remap the time of their inner action, the ones with
+    // more state (elastic, bezier, custom) are always stepped by themselves
+    const TweenEase* findTweenEase(const std::type_info& type)
+    {
+        static const TweenEase eases[] = {
+            { &typeid(EaseIn), TWEEN_EASE_IN, nullptr },
+            { &typeid(EaseOut), TWEEN_EASE_OUT, nullptr },
+            { &typeid(EaseInOut), TWEEN_EASE_IN_OUT, nullptr },
+            { &typeid(EaseExponentialIn), TWEEN_EASE_FUNCTION, tweenfunc::expoEaseIn },
+            { &typeid(EaseExponentialOut), TWEEN_EASE_FUNCTION, tweenfunc::expoEaseOut },
+            { &typeid(EaseExponentialInOut), TWEEN_EASE_FUNCTION, tweenfunc::expoEaseInOut },
+            { &typeid(EaseSineIn), TWEEN_EASE_FUNCTION, tweenfunc::sineEaseIn },
+            { &typeid(EaseSineOut), TWEEN_EASE_FUNCTION, tweenfunc::sineEaseOut },
+            { &typeid(EaseSineInOut), TWEEN_EASE_FUNCTION, tweenfunc::sineEaseInOut },
+            { &typeid(EaseBounceIn), TWEEN_EASE_FUNCTION, tweenfunc::bounceEaseIn },
+            { &typeid(EaseBounceOut), TWEEN_EASE_FUNCTION, tweenfunc::bounceEaseOut },
+            { &typeid(EaseBounceInOut), TWEEN_EASE_FUNCTION, tweenfunc::bounceEaseInOut },
+            { &typeid(EaseBackIn), TWEEN_EASE_FUNCTION, tweenfunc::backEaseIn },
+            { &typeid(EaseBackOut), TWEEN_EASE_FUNCTION, tweenfunc::backEaseOut },
+            { &typeid(EaseBackInOut), TWEEN_EASE_FUNCTION, tweenfunc::backEaseInOut },
+            { &typeid(EaseQuadraticActionIn), TWEEN_EASE_FUNCTION, tweenfunc::quadraticIn },
+            { &typeid(EaseQuadraticActionOut), TWEEN_EASE_FUNCTION, tweenfunc::quadraticOut },
+            { &typeid(EaseQuadraticActionInOut), TWEEN_EASE_FUNCTION, tweenfunc::quadraticInOut },
+            { &typeid(EaseQuarticActionIn), TWEEN_EASE_FUNCTION, tweenfunc::quartEaseIn },
+            { &typeid(EaseQuarticActionOut), TWEEN_EASE_FUNCTION, tweenfunc::quartEaseOut },
+            { &typeid(EaseQuarticActionInOut), TWEEN_EASE_FUNCTION, tweenfunc::quartEaseInOut },
+            { &typeid(EaseQuinticActionIn), TWEEN_EASE_FUNCTION, tweenfunc::quintEaseIn },
+            { &typeid(EaseQuinticActionOut), TWEEN_EASE_FUNCTION, tweenfunc::quintEaseOut },
+            { &typeid(EaseQuinticActionInOut), TWEEN_EASE_FUNCTION, tweenfunc::quintEaseInOut },
+            { &typeid(EaseCircleActionIn), TWEEN_EASE_FUNCTION, tweenfunc::circEaseIn },
+            { &typeid(EaseCircleActionOut), TWEEN_EASE_FUNCTION, tweenfunc::circEaseOut },
+            { &typeid(EaseCircleActionInOut), TWEEN_EASE_FUNCTION, tweenfunc::circEaseInOut },
+            { &typeid(EaseCubicActionIn), TWEEN_EASE_FUNCTION, tweenfunc::cubicEaseIn },
+            { &typeid(EaseCubicActionOut), TWEEN_EASE_FUNCTION, tweenfunc::cubicEaseOut },
+            { &typeid(EaseCubicActionInOut), TWEEN_EASE_FUNCTION, tweenfunc::cubicEaseInOut },
+        };
+
+        for (const auto& ease : eases)
+        {
+            if (*ease.type == type)
+            {
+                return &ease;
+            }
+        }
+        return nullptr;
+    }
+
+    // elapsed += dt * speed, time = clamp(elapsed / duration, 0, 1), the same as ActionInterval::step
+    void advanceTweens(float *elapsed, const float *duration, const float *speed, float *time, size_t count, float dt)
+    {
+        size_t i = 0;
+#ifdef __SSE__
+        const __m128 dt4 = _mm_set1_ps(dt);
+        const __m128 zero = _mm_setzero_ps();
+        const __m128 one = _mm_set1_ps(1.0f);
+        for (; i + 4 <= count; i += 4)
+        {
+            __m128 e = _mm_add_ps(_mm_loadu_ps(elapsed + i), _mm_mul_ps(dt4, _mm_loadu_ps(speed + i)));
+            _mm_storeu_ps(elapsed + i, e);
+            _mm_storeu_ps(time + i, _mm_max_ps(zero, _mm_min_ps(one, _mm_div_ps(e, _mm_loadu_ps(duration + i)))));
+        }
+#endif
+        for (; i < count; ++i)
+        {
+            elapsed[i] += dt * speed[i];
+            time[i] = MAX(0, MIN(1, elapsed[i] / duration[i]));
+        }
+    }
+
+    // value = from + delta * time
+    void lerpTweens(const float *from, const float *delta, const float *time, float *value, size_t count)
+    {
+        size_t i = 0;
+#ifdef __SSE__
+        for (; i + 4 <= count; i += 4)
+        {
+            _mm_storeu_ps(value + i, _mm_add_ps(_mm_loadu_ps(from + i), _mm_mul_ps(_mm_loadu_ps(delta + i), _mm_loadu_ps(time + i))));
+        }
+#endif
+        for (; i < count; ++i)
+        {
+            value[i] = from[i] + delta[i] * time[i];
+        }
+    }
+}
+
+void ActionManager::TweenBuffer::moveLane(size_t dst, size_t src)
+{
+    actions[dst] = actions[src];
+    tweens[dst] = tweens[src];
+    elapsed[dst] = elapsed[src];
+    duration[dst] = duration[src];
+    speed[dst] = speed[src];
+    time[dst] = time[src];
+    easeTypes[dst] = easeTypes[src];
+    easeFunctions[dst] = easeFunctions[src];
+    for (int c = 0; c < 3; ++c)
+    {
+        from[c][dst] = from[c][src];
+        delta[c][dst] = delta[c][src];
+        value[c][dst] = value[c][src];
+    }
+}
+
+void ActionManager::TweenBuffer::resize(size_t count)
+{
+    actions.resize(count);
+    tweens.resize(count);
+    elapsed.resize(count);
+    duration.resize(count);
+    speed.resize(count);
+    time.resize(count);
+    easeTypes.resize(count);
+    easeFunctions.resize(count);
+    for (int c = 0; c < 3; ++c)
+    {
+        from[c].resize(count);
+        delta[c].resize(count);
+        value[c].resize(count);
+    }
+}
+
 ActionManager::ActionManager()
 : _targets(nullptr),
-  _currentTarget(nullptr),
-  _currentTargetSalvaged(false)
+  _removedActionEntries(0)
 {
 
 }
@@ -92,31 +238,42 @@ void ActionManager::removeActionAtIndex(ssize_t index, tHashElement *element)
 {
     Action *action = static_cast<Action*>(element->actions->arr[index]);
 
-    if (action == element->currentAction && (! element->currentActionSalvaged))
+    // leave a hole in the update array, it is compacted before the next update
+    auto& entry = _actionEntries[action->_actionManagerIndex];
+    if (entry.tweenIndex >= 0)
     {
-        element->currentAction->retain();
-        element->currentActionSalvaged = true;
+        unbatchTween(entry);
     }
+    entry.action = nullptr;
+    action->_actionManagerIndex = -1;
+    ++_removedActionEntries;
 
     ccArrayRemoveObjectAtIndex(element->actions, index, true);
 
-    // update actionIndex in case we are in tick. looping over the actions
-    if (element->actionIndex >= index)
+    if (element->actions->num == 0)
     {
-        element->actionIndex--;
+        deleteHashElement(element);
     }
+}
 
-    if (element->actions->num == 0)
+void ActionManager::compactActionEntries()
+{
+    if (_removedActionEntries == 0)
     {
-        if (_currentTarget == element)
-        {
-            _currentTargetSalvaged = true;
-        }
-        else
+        return;
+    }
+
+    size_t count = 0;
+    for (const auto& entry : _actionEntries)
+    {
+        if (entry.action != nullptr)
         {
-            deleteHashElement(element);
+            entry.action->_actionManagerIndex = count;
+            _actionEntries[count++] = entry;
         }
     }
+    _actionEntries.resize(count);
+    _removedActionEntries = 0;
 }
 
 // pause / resume
@@ -128,6 +285,7 @@ void ActionManager::pauseTarget(Node *target)
     if (element)
     {
         element->paused = true;
+        setTweensPaused(element, true);
     }
 }
 
@@ -138,6 +296,7 @@ void ActionManager::resumeTarget(Node *target)
     if (element)
     {
         element->paused = false;
+        setTweensPaused(element, false);
     }
 }
 
@@ -150,6 +309,7 @@ Vector<Node*> ActionManager::pauseAllRunningActions()
         if (! element->paused) 
         {
             element->paused = true;
+            setTweensPaused(element, true);
             idsWithActions.pushBack(element->target);
         }
     }    
@@ -190,7 +350,11 @@ void ActionManager::addAction(Action *action, Node *target, bool paused)
      actionAllocWithHashElement(element);
  
      CCASSERT(! ccArrayContainsObject(element->actions, action), "action already be added!");
+     CCASSERT(action->_actionManagerIndex < 0, "action is already running in an ActionManager!");
      ccArrayAppendObject(element->actions, action);
+
+     action->_actionManagerIndex = _actionEntries.size();
+     _actionEntries.push_back({action, element, getTweenKind(action), -1});
  
      action->startWithTarget(target);
 }
@@ -219,21 +383,21 @@ void ActionManager::removeAllActionsFromTarget(Node *target)
     HASH_FIND_PTR(_targets, &target, element);
     if (element)
     {
-        if (ccArrayContainsObject(element->actions, element->currentAction) && (! element->currentActionSalvaged))
+        for (ssize_t i = 0; i < element->actions->num; ++i)
         {
-            element->currentAction->retain();
-            element->currentActionSalvaged = true;
+            auto action = static_cast<Action*>(element->actions->arr[i]);
+            auto& entry = _actionEntries[action->_actionManagerIndex];
+            if (entry.tweenIndex >= 0)
+            {
+                unbatchTween(entry);
+            }
+            entry.action = nullptr;
+            action->_actionManagerIndex = -1;
         }
+        _removedActionEntries += element->actions->num;
 
         ccArrayRemoveAllObjects(element->actions);
-        if (_currentTarget == element)
-        {
-            _currentTargetSalvaged = true;
-        }
-        else
-        {
-            deleteHashElement(element);
-        }
+        deleteHashElement(element);
     }
 }
 
@@ -435,69 +599,368 @@ ssize_t ActionManager::getNumberOfRunningActions() const
     return count;
 }
 
-// main loop
-void ActionManager::update(float dt)
+// batched tweens
+
+int ActionManager::getTweenKind(Action *action)
+{
+#if CC_ENABLE_BATCHED_TWEENS
+#if CC_ENABLE_SCRIPT_BINDING
+    // the script engine may take over the update of javascript actions
+    if (action->_scriptType == kScriptTypeJavascript)
+    {
+        return -1;
+    }
+#endif
+
+    // exact types only, a subclass may override update()
+    Action *tween = action;
+    if (findTweenEase(typeid(*action)) != nullptr)
+    {
+        tween = static_cast<ActionEase*>(action)->getInnerAction();
+        if (tween == nullptr)
+        {
+            return -1;
+        }
+    }
+
+    const std::type_info& type = typeid(*tween);
+    if (type == typeid(MoveBy) || type == typeid(MoveTo))
+    {
+        return TWEEN_MOVE;
+    }
+    if (type == typeid(ScaleTo) || type == typeid(ScaleBy))
+    {
+        return TWEEN_SCALE;
+    }
+    if (type == typeid(RotateTo))
+    {
+        return static_cast<RotateTo*>(tween)->_is3D ? TWEEN_ROTATE_3D : TWEEN_ROTATE;
+    }
+    if (type == typeid(FadeTo) || type == typeid(FadeIn) || type == typeid(FadeOut))
+    {
+        return TWEEN_FADE;
+    }
+    if (type == typeid(TintTo))
+    {
+        return TWEEN_TINT;
+    }
+#else
+    CC_UNUSED_PARAM(action);
+#endif
+    return -1;
+}
+
+void ActionManager::batchTween(ActionEntry &entry)
+{
+    // called after the first step, so the tween has already started and set up its values
+    auto action = static_cast<ActionInterval*>(entry.action);
+    ActionInterval *tween = action;
+    auto ease = findTweenEase(typeid(*action));
+    if (ease)
+    {
+        tween = static_cast<ActionEase*>(action)->getInnerAction();
+    }
+
+    float from[3] = { 0, 0, 0 };
+    float delta[3] = { 0, 0, 0 };
+    float value[3] = { 0, 0, 0 };
+    switch (entry.tweenKind)
+    {
+    case TWEEN_MOVE:
+        {
+            auto move = static_cast<MoveBy*>(tween);
+            from[0] = move->_startPosition.x; from[1] = move->_startPosition.y; from[2] = move->_startPosition.z;
+            delta[0] = move->_positionDelta.x; delta[1] = move->_positionDelta.y; delta[2] = move->_positionDelta.z;
+            value[0] = move->_previousPosition.x; value[1] = move->_previousPosition.y; value[2] = move->_previousPosition.z;
+        }
+        break;
+    case TWEEN_SCALE:
+        {
+            auto scale = static_cast<ScaleTo*>(tween);
+            from[0] = scale->_startScaleX; from[1] = scale->_startScaleY; from[2] = scale->_startScaleZ;
+            delta[0] = scale->_deltaX; delta[1] = scale->_deltaY; delta[2] = scale->_deltaZ;
+        }
+        break;
+    case TWEEN_ROTATE:
+    case TWEEN_ROTATE_3D:
+        {
+            auto rotate = static_cast<RotateTo*>(tween);
+            from[0] = rotate->_startAngle.x; from[1] = rotate->_startAngle.y; from[2] = rotate->_startAngle.z;
+            delta[0] = rotate->_diffAngle.x; delta[1] = rotate->_diffAngle.y; delta[2] = rotate->_diffAngle.z;
+        }
+        break;
+    case TWEEN_FADE:
+        {
+            auto fade = static_cast<FadeTo*>(tween);
+            from[0] = fade->_fromOpacity;
+            delta[0] = fade->_toOpacity - fade->_fromOpacity;
+        }
+        break;
+    case TWEEN_TINT:
+        {
+            auto tint = static_cast<TintTo*>(tween);
+            from[0] = tint->_from.r; from[1] = tint->_from.g; from[2] = tint->_from.b;
+            delta[0] = tint->_to.r - tint->_from.r; delta[1] = tint->_to.g - tint->_from.g; delta[2] = tint->_to.b - tint->_from.b;
+        }
+        break;
+    default:
+        return;
+    }
+
+    TweenBuffer& buffer = _tweens[entry.tweenKind];
+    size_t lane = buffer.actions.size();
+    buffer.resize(lane + 1);
+    buffer.actions[lane] = action;
+    buffer.tweens[lane] = tween;
+    buffer.elapsed[lane] = action->_elapsed;
+    buffer.duration[lane] = action->getDuration();
+    buffer.speed[lane] = entry.element->paused ? 0.0f : 1.0f;
+    buffer.easeTypes[lane] = ease ? ease->easeType : TWEEN_EASE_NONE;
+    buffer.easeFunctions[lane] = ease ? ease->function : nullptr;
+    for (int c = 0; c < 3; ++c)
+    {
+        buffer.from[c][lane] = from[c];
+        buffer.delta[c][lane] = delta[c];
+        buffer.value[c][lane] = value[c];
+    }
+    entry.tweenIndex = lane;
+}
+
+void ActionManager::unbatchTween(ActionEntry &entry)
+{
+    TweenBuffer& buffer = _tweens[entry.tweenKind];
+    ssize_t lane = entry.tweenIndex;
+
+    // hand the state back, so the action is consistent if it is stepped by itself again
+    buffer.actions[lane]->_elapsed = buffer.elapsed[lane];
+    if (entry.tweenKind == TWEEN_MOVE)
+    {
+        auto move = static_cast<MoveBy*>(buffer.tweens[lane]);
+        move->_startPosition.set(buffer.from[0][lane], buffer.from[1][lane], buffer.from[2][lane]);
+        move->_previousPosition.set(buffer.value[0][lane], buffer.value[1][lane], buffer.value[2][lane]);
+    }
+
+    // the lane is compacted before the buffer is updated the next time
+    buffer.actions[lane] = nullptr;
+    ++buffer.removed;
+    entry.tweenIndex = -1;
+}
+
+void ActionManager::compactTweens(TweenBuffer &buffer)
+{
+    if (buffer.removed == 0)
+    {
+        return;
+    }
+
+    size_t count = 0;
+    for (size_t i = 0; i < buffer.actions.size(); ++i)
+    {
+        if (buffer.actions[i] == nullptr)
+        {
+            continue;
+        }
+        if (count != i)
+        {
+            buffer.moveLane(count, i);
+        }
+        _actionEntries[buffer.actions[count]->_actionManagerIndex].tweenIndex = count;
+        ++count;
+    }
+    buffer.resize(count);
+    buffer.removed = 0;
+}
+
+void ActionManager::setTweensPaused(tHashElement *element, bool paused)
+{
+    for (ssize_t i = 0; i < element->actions->num; ++i)
+    {
+        auto action = static_cast<Action*>(element->actions->arr[i]);
+        const auto& entry = _actionEntries[action->_actionManagerIndex];
+        if (entry.tweenIndex >= 0)
+        {
+            _tweens[entry.tweenKind].speed[entry.tweenIndex] = paused ? 0.0f : 1.0f;
+        }
+    }
+}
+
+void ActionManager::updateTweens(float dt)
 {
-    for (tHashElement *elt = _targets; elt != nullptr; )
+    for (int kind = 0; kind < TWEEN_KIND_COUNT; ++kind)
     {
-        _currentTarget = elt;
-        _currentTargetSalvaged = false;
+        TweenBuffer& buffer = _tweens[kind];
+        compactTweens(buffer);
+
+        const size_t count = buffer.actions.size();
+        if (count == 0)
+        {
+            continue;
+        }
+
+        advanceTweens(buffer.elapsed.data(), buffer.duration.data(), buffer.speed.data(), buffer.time.data(), count, dt);
 
-        if (! _currentTarget->paused)
+        for (size_t i = 0; i < count; ++i)
         {
-            // The 'actions' MutableArray may change while inside this loop.
-            for (_currentTarget->actionIndex = 0; _currentTarget->actionIndex < _currentTarget->actions->num;
-                _currentTarget->actionIndex++)
+            switch (buffer.easeTypes[i])
             {
-                _currentTarget->currentAction = static_cast<Action*>(_currentTarget->actions->arr[_currentTarget->actionIndex]);
-                if (_currentTarget->currentAction == nullptr)
-                {
-                    continue;
-                }
+            case TWEEN_EASE_FUNCTION:
+                buffer.time[i] = buffer.easeFunctions[i](buffer.time[i]);
+                break;
+            // the rate is read every step, it may be changed while the ease runs
+            case TWEEN_EASE_IN:
+                buffer.time[i] = tweenfunc::easeIn(buffer.time[i], static_cast<EaseRateAction*>(buffer.actions[i])->getRate());
+                break;
+            case TWEEN_EASE_OUT:
+                buffer.time[i] = tweenfunc::easeOut(buffer.time[i], static_cast<EaseRateAction*>(buffer.actions[i])->getRate());
+                break;
+            case TWEEN_EASE_IN_OUT:
+                buffer.time[i] = tweenfunc::easeInOut(buffer.time[i], static_cast<EaseRateAction*>(buffer.actions[i])->getRate());
+                break;
+            default:
+                break;
+            }
+        }
 
-                _currentTarget->currentActionSalvaged = false;
+#if CC_ENABLE_STACKABLE_ACTIONS
+        // moves follow changes of the position made by others, they are computed in applyTween()
+        if (kind != TWEEN_MOVE)
+#endif
+        {
+            const int components = kind == TWEEN_FADE ? 1 : (kind == TWEEN_ROTATE ? 2 : 3);
+            for (int c = 0; c < components; ++c)
+            {
+                lerpTweens(buffer.from[c].data(), buffer.delta[c].data(), buffer.time.data(), buffer.value[c].data(), count);
+            }
+        }
+    }
+}
 
-                _currentTarget->currentAction->step(dt);
+void ActionManager::applyTween(const ActionEntry &entry)
+{
+    TweenBuffer& buffer = _tweens[entry.tweenKind];
+    const ssize_t i = entry.tweenIndex;
 
-                if (_currentTarget->currentActionSalvaged)
-                {
-                    // The currentAction told the node to remove it. To prevent the action from
-                    // accidentally deallocating itself before finishing its step, we retained
-                    // it. Now that step is done, it's safe to release it.
-                    _currentTarget->currentAction->release();
-                } else
-                if (_currentTarget->currentAction->isDone())
-                {
-                    _currentTarget->currentAction->stop();
+    ActionInterval *action = buffer.actions[i];
+    action->_elapsed = buffer.elapsed[i];
+    action->_done = buffer.elapsed[i] >= buffer.duration[i];
 
-                    Action *action = _currentTarget->currentAction;
-                    // Make currentAction nil to prevent removeAction from salvaging it.
-                    _currentTarget->currentAction = nullptr;
-                    removeAction(action);
-                }
+    Node *target = buffer.tweens[i]->_target;
+    if (target == nullptr)
+    {
+        return;
+    }
 
-                _currentTarget->currentAction = nullptr;
+    switch (entry.tweenKind)
+    {
+    case TWEEN_MOVE:
+        {
+#if CC_ENABLE_STACKABLE_ACTIONS
+            Vec3 currentPos = target->getPosition3D();
+            buffer.from[0][i] += currentPos.x - buffer.value[0][i];
+            buffer.from[1][i] += currentPos.y - buffer.value[1][i];
+            buffer.from[2][i] += currentPos.z - buffer.value[2][i];
+            for (int c = 0; c < 3; ++c)
+            {
+                buffer.value[c][i] = buffer.from[c][i] + buffer.delta[c][i] * buffer.time[i];
             }
+#endif
+            target->setPosition3D(Vec3(buffer.value[0][i], buffer.value[1][i], buffer.value[2][i]));
+        }
+        break;
+    case TWEEN_SCALE:
+        target->setScaleX(buffer.value[0][i]);
+        target->setScaleY(buffer.value[1][i]);
+        target->setScaleZ(buffer.value[2][i]);
+        break;
+    case TWEEN_ROTATE:
+#if CC_USE_PHYSICS
+        if (buffer.from[0][i] == buffer.from[1][i] && buffer.delta[0][i] == buffer.delta[1][i])
+        {
+            target->setRotation(buffer.value[0][i]);
         }
+        else
+#endif // CC_USE_PHYSICS
+        {
+            target->setRotationSkewX(buffer.value[0][i]);
+            target->setRotationSkewY(buffer.value[1][i]);
+        }
+        break;
+    case TWEEN_ROTATE_3D:
+        target->setRotation3D(Vec3(buffer.value[0][i], buffer.value[1][i], buffer.value[2][i]));
+        break;
+    case TWEEN_FADE:
+        target->setOpacity((GLubyte)buffer.value[0][i]);
+        break;
+    case TWEEN_TINT:
+        target->setColor(Color3B((GLubyte)buffer.value[0][i], (GLubyte)buffer.value[1][i], (GLubyte)buffer.value[2][i]));
+        break;
+    default:
+        break;
+    }
+}
+
+// main loop
+void ActionManager::update(float dt)
+{
+    CC_PROFILER_ZONE("ActionManager::update");
+    compactActionEntries();
 
-        // elt, at this moment, is still valid
-        // so it is safe to ask this here (issue #490)
-        elt = (tHashElement*)(elt->hh.next);
+    // the tweens batched during earlier frames are computed all at once,
+    // their values are set below in the order of the actions, like the stepped ones
+    updateTweens(dt);
 
-        // only delete currentTarget if no actions were scheduled during the cycle (issue #481)
-        if (_currentTargetSalvaged && _currentTarget->actions->num == 0)
+    // Actions added while stepping are appended, and stepped in this same frame.
+    // Removed actions only leave a hole, so indices stay valid during the loop.
+    for (size_t i = 0; i < _actionEntries.size(); ++i)
+    {
+        const ActionEntry entry = _actionEntries[i];
+        if (entry.action == nullptr)
         {
-            deleteHashElement(_currentTarget);
+            continue;
         }
+
         //if some node reference 'target', it's reference count >= 2 (issues #14050)
-        else if (_currentTarget->target->getReferenceCount() == 1)
+        if (entry.element->target->getReferenceCount() == 1)
         {
-            deleteHashElement(_currentTarget);
+            removeAllActionsFromTarget(entry.element->target);
+            continue;
+        }
+
+        if (entry.element->paused)
+        {
+            continue;
+        }
+
+        // The action may remove itself, or its target's actions, while stepping.
+        // Keep it alive until step is done.
+        Action *action = entry.action;
+        action->retain();
+
+        if (entry.tweenIndex >= 0)
+        {
+            applyTween(entry);
+        }
+        else
+        {
+            action->step(dt);
+        }
+
+        // an action which was removed during its step already left this slot
+        if (action->_actionManagerIndex == (ssize_t)i)
+        {
+            if (action->isDone())
+            {
+                action->stop();
+                removeAction(action);
+            }
+            else if (entry.tweenKind >= 0 && entry.tweenIndex < 0)
+            {
+                batchTween(_actionEntries[i]);
+            }
         }
-    }
 
-    // issue #635
-    _currentTarget = nullptr;
+        action->release();
+    }
 }
 
 NS_CC_END
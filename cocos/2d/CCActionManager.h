@@ -36,6 +36,7 @@ THE SOFTWARE.
 NS_CC_BEGIN
 
 class Action;
+class ActionInterval;
 
 struct _hashElement;
 
@@ -204,11 +205,68 @@ protected:
     void removeActionAtIndex(ssize_t index, struct _hashElement *element);
     void deleteHashElement(struct _hashElement *element);
     void actionAllocWithHashElement(struct _hashElement *element);
+    void compactActionEntries();
+
+    /** @cond */
+    // one running action in the update array, action is nullptr once it was removed
+    struct ActionEntry
+    {
+        Action              *action;
+        struct _hashElement *element;
+        // kind of tween buffer the action can be batched into, -1 if it is always stepped
+        int                 tweenKind;
+        // lane in that buffer, -1 while the action is stepped by itself
+        ssize_t             tweenIndex;
+    };
+
+    enum
+    {
+        TWEEN_MOVE,
+        TWEEN_SCALE,
+        TWEEN_ROTATE,
+        TWEEN_ROTATE_3D,
+        TWEEN_FADE,
+        TWEEN_TINT,
+        TWEEN_KIND_COUNT
+    };
+
+    // Structure of arrays for the batched tweens of one kind, one lane per action.
+    // value = from + delta * ease(elapsed / duration) for up to three components.
+    struct TweenBuffer
+    {
+        std::vector<ActionInterval*> actions;   // the action run by the manager, nullptr once removed
+        std::vector<ActionInterval*> tweens;    // the tween itself, the inner action of an ease
+        std::vector<float>  elapsed;
+        std::vector<float>  duration;
+        std::vector<float>  speed;              // 0 while the target is paused
+        std::vector<float>  time;
+        std::vector<int>    easeTypes;
+        std::vector<float (*)(float)> easeFunctions;
+        std::vector<float>  from[3];
+        std::vector<float>  delta[3];
+        std::vector<float>  value[3];
+        ssize_t             removed;
+
+        TweenBuffer() : removed(0) {}
+        void moveLane(size_t dst, size_t src);
+        void resize(size_t count);
+    };
+    /** @endcond */
+
+    static int getTweenKind(Action *action);
+    void batchTween(ActionEntry &entry);
+    void unbatchTween(ActionEntry &entry);
+    void compactTweens(TweenBuffer &buffer);
+    void setTweensPaused(struct _hashElement *element, bool paused);
+    void updateTweens(float dt);
+    void applyTween(const ActionEntry &entry);
 
 protected:
     struct _hashElement    *_targets;
-    struct _hashElement    *_currentTarget;
-    bool            _currentTargetSalvaged;
+    // all the running actions in the order they were added, so update() walks them linearly
+    std::vector<ActionEntry> _actionEntries;
+    ssize_t                 _removedActionEntries;
+    TweenBuffer             _tweens[TWEEN_KIND_COUNT];
 };
 
 // end of actions group
@@ -26,9 +26,50 @@ THE SOFTWARE.
 #include "2d/CCActionPageTurn3D.h"
 #include "2d/CCGrid.h"
 #include "2d/CCNodeGrid.h"
+#include "renderer/CCGLProgramState.h"
 
 NS_CC_BEGIN
 
+// moves a_position as update() on the CPU, u_theta is the sine and the cosine of theta and
+// u_rotation those of the rotation about the y axis
+static const char* s_pageTurn3DVert = R"(
+attribute vec4 a_position;
+attribute vec2 a_texCoord;
+
+#ifdef GL_ES
+varying mediump vec2 v_texCoord;
+#else
+varying vec2 v_texCoord;
+#endif
+
+uniform float u_ay;
+uniform vec2 u_theta;
+uniform vec2 u_rotation;
+uniform float u_originX;
+
+void main()
+{
+    vec4 p = a_position;
+    p.x -= u_originX;
+    float R = sqrt(p.x * p.x + (p.y - u_ay) * (p.y - u_ay));
+    float r = R * u_theta.x;
+    float beta = asin(p.x / R) / u_theta.x;
+    float cosBeta = cos(beta);
+
+    // wrapped around the cone
+    p.x = beta <= 3.14159265 ? r * sin(beta) : 0.0;
+    p.y = R + u_ay - r * (1.0 - cosBeta) * u_theta.x;
+    p.z = r * (1.0 - cosBeta) * u_theta.y;
+    p.x = p.z * u_rotation.x + p.x * u_rotation.y;
+    p.z = p.z * u_rotation.y - p.x * u_rotation.x;
+    p.z = max(p.z / 7.0, 0.5);
+
+    p.x += u_originX;
+    gl_Position = CC_MVPMatrix * p;
+    v_texCoord = a_texCoord;
+}
+)";
+
 PageTurn3D* PageTurn3D::create(float duration, const Size& gridSize)
 {
     PageTurn3D *action = new (std::nothrow) PageTurn3D();
@@ -46,7 +87,19 @@ PageTurn3D* PageTurn3D::create(float duration, const Size& gridSize)
 PageTurn3D *PageTurn3D::clone() const
 {
     // no copy constructor
-    return PageTurn3D::create(_duration, _gridSize);
+    auto a = PageTurn3D::create(_duration, _gridSize);
+    a->setShaderEnabled(_shaderEnabled);
+    return a;
+}
+
+const char* PageTurn3D::getShaderKey() const
+{
+    return "Grid3DAction:PageTurn3D";
+}
+
+const char* PageTurn3D::getVertexShader() const
+{
+    return s_pageTurn3DVert;
 }
 
 GridBase* PageTurn3D::getGrid()
@@ -77,6 +130,15 @@ void PageTurn3D::update(float time)
     
     float sinTheta = sinf(theta);
     float cosTheta = cosf(theta);
+
+    if (_shaderState)
+    {
+        _shaderState->setUniformFloat("u_ay", ay);
+        _shaderState->setUniformVec2("u_theta", Vec2(sinTheta, cosTheta));
+        _shaderState->setUniformVec2("u_rotation", Vec2(sinf(rotateByYAxis), cosf(rotateByYAxis)));
+        _shaderState->setUniformFloat("u_originX", getGridRect().origin.x);
+        return;
+    }
     
     for (int i = 0; i <= _gridSize.width; ++i)
     {
@@ -63,6 +63,10 @@ public:
     // Overrides
     virtual PageTurn3D* clone() const override;
     virtual void update(float time) override;
+
+protected:
+    virtual const char* getShaderKey() const override;
+    virtual const char* getVertexShader() const override;
 };
 
 // end of actions group
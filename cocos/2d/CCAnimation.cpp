@@ -27,7 +27,14 @@ THE SOFTWARE.
 #include "2d/CCAnimation.h"
 #include "renderer/CCTextureCache.h"
 #include "renderer/CCTexture2D.h"
+#include "2d/CCSprite.h"
 #include "base/CCDirector.h"
+#include "base/CCScheduler.h"
+#include "base/CCEventCustom.h"
+#include "base/CCEventDispatcher.h"
+
+#include <algorithm>
+#include <climits>
 
 NS_CC_BEGIN
 
@@ -80,6 +87,68 @@ AnimationFrame* AnimationFrame::clone() const
     return frame;
 }
 
+// implementation of AnimationFrameTable
+
+AnimationFrameTable* AnimationFrameTable::create(const Vector<AnimationFrame*>& frames)
+{
+    auto ret = new (std::nothrow) AnimationFrameTable();
+    if (ret && ret->initWithAnimationFrames(frames))
+    {
+        ret->autorelease();
+    }
+    else
+    {
+        CC_SAFE_DELETE(ret);
+    }
+    return ret;
+}
+
+AnimationFrameTable::AnimationFrameTable()
+: _hasUserInfo(false)
+{
+}
+
+AnimationFrameTable::~AnimationFrameTable()
+{
+    CCLOGINFO("deallocing AnimationFrameTable: %p", this);
+}
+
+bool AnimationFrameTable::initWithAnimationFrames(const Vector<AnimationFrame*>& frames)
+{
+    _animationFrames = frames;
+    _frames.clear();
+    _frames.reserve(frames.size());
+    _hasUserInfo = false;
+
+    float totalDelayUnits = 0;
+    for (auto& frame : frames)
+    {
+        totalDelayUnits += frame->getDelayUnits();
+    }
+
+    float accumUnitsOfTime = 0;
+    for (auto& frame : frames)
+    {
+        Frame entry;
+        entry.spriteFrame = frame->getSpriteFrame();
+        entry.splitTime = totalDelayUnits > 0 ? accumUnitsOfTime / totalDelayUnits : 0;
+        entry.userInfo = frame->getUserInfo().empty() ? nullptr : &frame->getUserInfo();
+        _hasUserInfo = _hasUserInfo || entry.userInfo != nullptr;
+        _frames.push_back(entry);
+
+        accumUnitsOfTime += frame->getDelayUnits();
+    }
+    return true;
+}
+
+ssize_t AnimationFrameTable::findFrame(float t) const
+{
+    auto it = std::upper_bound(_frames.begin(), _frames.end(), t, [](float value, const Frame& frame) {
+        return value < frame.splitTime;
+    });
+    return (ssize_t)(it - _frames.begin()) - 1;
+}
+
 // implementation of Animation
 
 Animation* Animation::create()
@@ -120,6 +189,7 @@ bool Animation::initWithSpriteFrames(const Vector<SpriteFrame*>& frames, float d
 {
     _delayPerUnit = delay;
     _loops = loops;
+    invalidateFrameTable();
 
     for (auto& spriteFrame : frames)
     {
@@ -151,6 +221,7 @@ Animation::Animation()
 , _duration(0.0f)
 , _restoreOriginalFrame(false)
 , _loops(0)
+, _frameTable(nullptr)
 {
 
 }
@@ -158,12 +229,29 @@ Animation::Animation()
 Animation::~Animation(void)
 {
     CCLOGINFO("deallocing Animation: %p", this);
+    CC_SAFE_RELEASE(_frameTable);
+}
+
+AnimationFrameTable* Animation::getFrameTable() const
+{
+    if (_frameTable == nullptr)
+    {
+        _frameTable = AnimationFrameTable::create(_frames);
+        CC_SAFE_RETAIN(_frameTable);
+    }
+    return _frameTable;
+}
+
+void Animation::invalidateFrameTable()
+{
+    CC_SAFE_RELEASE_NULL(_frameTable);
 }
 
 void Animation::addSpriteFrame(SpriteFrame* spriteFrame)
 {
     AnimationFrame *animFrame = AnimationFrame::create(spriteFrame, 1.0f, ValueMap());
     _frames.pushBack(animFrame);
+    invalidateFrameTable();
 
     // update duration
     _totalDelayUnits++;
@@ -195,8 +283,246 @@ Animation* Animation::clone() const
     auto a = new (std::nothrow) Animation();
     a->initWithAnimationFrames(_frames, _delayPerUnit, _loops);
     a->setRestoreOriginalFrame(_restoreOriginalFrame);
+    // it has the same frames
+    a->_frameTable = _frameTable;
+    CC_SAFE_RETAIN(_frameTable);
     a->autorelease();
     return a;
 }
 
+// implementation of FlipbookAnimator
+
+FlipbookAnimator* FlipbookAnimator::create()
+{
+    auto ret = new (std::nothrow) FlipbookAnimator();
+    if (ret)
+    {
+        ret->autorelease();
+    }
+    return ret;
+}
+
+FlipbookAnimator::FlipbookAnimator()
+: _timeScale(1.0f)
+, _updating(false)
+, _frameDisplayedEvent(nullptr)
+{
+    Director::getInstance()->getScheduler()->scheduleUpdate(this, 0, false);
+}
+
+FlipbookAnimator::~FlipbookAnimator()
+{
+    Director::getInstance()->getScheduler()->unscheduleUpdate(this);
+    for (auto& entry : _entries)
+    {
+        releaseEntry(entry);
+    }
+    CC_SAFE_RELEASE(_frameDisplayedEvent);
+}
+
+void FlipbookAnimator::play(Sprite* sprite, Animation* animation, float elapsed)
+{
+    CCASSERT(sprite && animation, "FlipbookAnimator: sprite and animation must be non-nullptr");
+    if (sprite == nullptr || animation == nullptr)
+        return;
+
+    // the new references are taken first, the sprite may only be kept alive by its current entry
+    auto frameTable = animation->getFrameTable();
+    sprite->retain();
+    animation->retain();
+    frameTable->retain();
+
+    auto it = _indices.find(sprite);
+    size_t index;
+    if (it != _indices.end())
+    {
+        index = it->second;
+        auto originalFrame = _entries[index].originalFrame;
+        CC_SAFE_RETAIN(originalFrame);
+        releaseEntry(_entries[index]);
+        _entries[index].originalFrame = originalFrame;
+    }
+    else
+    {
+        index = _entries.size();
+        _indices[sprite] = index;
+        _entries.push_back(Entry());
+        _entries[index].originalFrame = nullptr;
+    }
+
+    auto& entry = _entries[index];
+    entry.sprite = sprite;
+    entry.animation = animation;
+    entry.frameTable = frameTable;
+    entry.elapsed = elapsed;
+    entry.frameIndex = -1;
+
+    // a sprite restarted keeps the frame it had before its first animation
+    if (!animation->getRestoreOriginalFrame())
+    {
+        CC_SAFE_RELEASE_NULL(entry.originalFrame);
+    }
+    else if (entry.originalFrame == nullptr)
+    {
+        entry.originalFrame = sprite->getSpriteFrame();
+        CC_SAFE_RETAIN(entry.originalFrame);
+    }
+}
+
+void FlipbookAnimator::stop(Sprite* sprite)
+{
+    auto it = _indices.find(sprite);
+    if (it == _indices.end())
+        return;
+
+    size_t index = it->second;
+    _indices.erase(it);
+    if (_updating)
+    {
+        // removed at the end of the update
+        releaseEntry(_entries[index]);
+    }
+    else
+    {
+        removeEntry(index);
+    }
+}
+
+void FlipbookAnimator::stopAll()
+{
+    for (auto& entry : _entries)
+    {
+        releaseEntry(entry);
+    }
+    _indices.clear();
+    if (!_updating)
+    {
+        _entries.clear();
+    }
+}
+
+bool FlipbookAnimator::isPlaying(Sprite* sprite) const
+{
+    return _indices.find(sprite) != _indices.end();
+}
+
+ssize_t FlipbookAnimator::getSpriteCount() const
+{
+    return (ssize_t)_indices.size();
+}
+
+void FlipbookAnimator::update(float dt)
+{
+    dt *= _timeScale;
+    _updating = true;
+
+    // the entries of the sprites starting to play from the callbacks are added at the end, and updated next time
+    size_t count = _entries.size();
+    for (size_t i = 0; i < count; ++i)
+    {
+        auto& entry = _entries[i];
+        if (entry.sprite == nullptr)
+            continue;
+
+        entry.elapsed += dt;
+        float duration = entry.animation->getDuration();
+        unsigned int loops = entry.animation->getLoops();
+        if (entry.frameTable->getFrameCount() == 0)
+            continue;
+
+        bool forever = loops == UINT_MAX;
+        if (forever && entry.elapsed >= duration && duration > 0)
+        {
+            // keeps the precision of the time
+            entry.elapsed = fmodf(entry.elapsed, duration);
+        }
+
+        if (duration <= 0 || (!forever && entry.elapsed >= duration * loops))
+        {
+            // finished, Animate ends on the last frame too
+            showFrame(entry, entry.frameTable->getFrameCount() - 1);
+            auto& finished = _entries[i];
+            if (finished.sprite != nullptr)
+            {
+                if (finished.originalFrame)
+                {
+                    auto blend = finished.sprite->getBlendFunc();
+                    finished.sprite->setSpriteFrame(finished.originalFrame);
+                    finished.sprite->setBlendFunc(blend);
+                }
+                _indices.erase(finished.sprite);
+                releaseEntry(finished);
+            }
+            continue;
+        }
+
+        float t = fmodf(entry.elapsed / duration, 1.0f);
+        ssize_t frameIndex = entry.frameTable->findFrame(t);
+        if (frameIndex != entry.frameIndex && frameIndex >= 0)
+        {
+            showFrame(entry, frameIndex);
+        }
+    }
+
+    _updating = false;
+
+    for (size_t i = _entries.size(); i > 0; --i)
+    {
+        if (_entries[i - 1].sprite == nullptr)
+            removeEntry(i - 1);
+    }
+}
+
+void FlipbookAnimator::showFrame(Entry& entry, ssize_t frameIndex)
+{
+    if (frameIndex == entry.frameIndex)
+        return;
+
+    const auto& frame = entry.frameTable->getFrames()[frameIndex];
+    entry.frameIndex = frameIndex;
+
+    auto sprite = entry.sprite;
+    auto blend = sprite->getBlendFunc();
+    sprite->setSpriteFrame(frame.spriteFrame);
+    sprite->setBlendFunc(blend);
+
+    if (frame.userInfo)
+    {
+        // the listeners may play or stop sprites, so the entry isn't used after it
+        if (_frameDisplayedEvent == nullptr)
+            _frameDisplayedEvent = new (std::nothrow) EventCustom(AnimationFrameDisplayedNotification);
+
+        _frameDisplayedEventInfo.target = sprite;
+        _frameDisplayedEventInfo.userInfo = frame.userInfo;
+        _frameDisplayedEvent->setUserData(&_frameDisplayedEventInfo);
+        Director::getInstance()->getEventDispatcher()->dispatchEvent(_frameDisplayedEvent);
+    }
+}
+
+void FlipbookAnimator::releaseEntry(Entry& entry)
+{
+    auto sprite = entry.sprite;
+    entry.sprite = nullptr;
+    CC_SAFE_RELEASE_NULL(entry.originalFrame);
+    CC_SAFE_RELEASE_NULL(entry.frameTable);
+    CC_SAFE_RELEASE_NULL(entry.animation);
+    // last, releasing the sprite may run code playing or stopping sprites
+    CC_SAFE_RELEASE(sprite);
+}
+
+void FlipbookAnimator::removeEntry(size_t index)
+{
+    if (_entries[index].sprite)
+        releaseEntry(_entries[index]);
+
+    size_t last = _entries.size() - 1;
+    if (index != last)
+    {
+        _entries[index] = _entries[last];
+        if (_entries[index].sprite)
+            _indices[_entries[index].sprite] = index;
+    }
+    _entries.pop_back();
+}
+
 NS_CC_END
@@ -34,11 +34,15 @@ THE SOFTWARE.
 #include "2d/CCSpriteFrame.h"
 
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 NS_CC_BEGIN
 
 class Texture2D;
 class SpriteFrame;
+class Sprite;
+class EventCustom;
 
 /**
  * @addtogroup _2d
@@ -154,6 +158,54 @@ private:
 
 
 
+/** @class AnimationFrameTable
+ * The frames of an Animation in a compact and immutable form: the sprite frame of each frame, the time it starts
+ * at, normalized to the duration of one loop, and its user info.
+ * An Animation builds it once, then every Animate and FlipbookAnimator playing the animation shares it.
+ * @since v3.14
+ */
+class CC_DLL AnimationFrameTable : public Ref
+{
+public:
+    struct Frame
+    {
+        SpriteFrame* spriteFrame;
+        /** When the frame starts, from 0 to 1.*/
+        float splitTime;
+        /** The user info of the frame, nullptr if it's empty.*/
+        const ValueMap* userInfo;
+    };
+
+    /** Creates the table of the frames, it keeps them alive.*/
+    static AnimationFrameTable* create(const Vector<AnimationFrame*>& frames);
+
+    const std::vector<Frame>& getFrames() const { return _frames; }
+    ssize_t getFrameCount() const { return (ssize_t)_frames.size(); }
+
+    /** Whether a frame has user info, then its display is notified.*/
+    bool hasUserInfo() const { return _hasUserInfo; }
+
+    /** Returns the index of the last frame starting at or before t, -1 if there is none.
+     *
+     * @param t The time, normalized to the duration of one loop.
+     */
+    ssize_t findFrame(float t) const;
+
+CC_CONSTRUCTOR_ACCESS:
+    AnimationFrameTable();
+    virtual ~AnimationFrameTable();
+
+    bool initWithAnimationFrames(const Vector<AnimationFrame*>& frames);
+
+protected:
+    std::vector<Frame> _frames;
+    /** keeps the sprite frames and the user info alive */
+    Vector<AnimationFrame*> _animationFrames;
+    bool _hasUserInfo;
+
+private:
+    CC_DISALLOW_COPY_AND_ASSIGN(AnimationFrameTable);
+};
 
 /** @class Animation
  * A Animation object is used to perform animations on the Sprite objects.
@@ -252,7 +304,17 @@ public:
     void setFrames(const Vector<AnimationFrame*>& frames)
     {
         _frames = frames;
+        invalidateFrameTable();
     }
+
+    /** Gets the frames in the compact form shared by the Animate actions, it's built on the first call.
+     * It's built again when frames are set or added, not when the delay units of a frame already in the
+     * animation change: call setFrames() with the same frames then.
+     *
+     * @return The table of the frames.
+     * @since v3.14
+     */
+    AnimationFrameTable* getFrameTable() const;
     
     /** Checks whether to restore the original frame when animation finishes. 
      *
@@ -299,6 +361,8 @@ CC_CONSTRUCTOR_ACCESS:
     bool initWithAnimationFrames(const Vector<AnimationFrame*>& arrayOfAnimationFrameNames, float delayPerUnit, unsigned int loops);
 
 protected:
+    void invalidateFrameTable();
+
     /** total Delay units of the Animation. */
     float _totalDelayUnits;
 
@@ -316,11 +380,87 @@ protected:
 
     /** how many times the animation is going to loop. 0 means animation is not animated. 1, animation is executed one time, ... */
     unsigned int _loops;
+
+    /** the frames in the compact form, built on demand */
+    mutable AnimationFrameTable* _frameTable;
     
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(Animation);
 };
 
+/** @class FlipbookAnimator
+ * Plays animations on many sprites from a single scheduled update, instead of an Animate action per sprite.
+ * Each sprite costs one entry in an array, that refers to the shared AnimationFrameTable of its animation,
+ * so playing the same animation on 1000 sprites allocates nothing per sprite.
+ * @code
+ * auto animator = FlipbookAnimator::create();
+ * for (auto sprite : sprites)
+ *     animator->play(sprite, animation, CCRANDOM_0_1() * animation->getDuration());
+ * @endcode
+ * The animations play the loops they say, setLoops(-1) makes one play forever.
+ * Like Animate, it notifies the frames with user info with an AnimationFrameDisplayedNotification event, and it
+ * restores the original frame of a sprite when the animation finishes if the animation says so.
+ * The animator keeps the sprites playing alive, it's updated by the scheduler of the Director while it exists,
+ * so keep a reference to it.
+ * @since v3.14
+ */
+class CC_DLL FlipbookAnimator : public Ref
+{
+public:
+    static FlipbookAnimator* create();
+
+    /** Plays the animation on a sprite, from its start if the sprite was already playing.
+     *
+     * @param sprite The sprite to animate.
+     * @param animation The animation to play, with the loops it says.
+     * @param elapsed The time in seconds already played, so the sprites don't all show the same frame.
+     */
+    void play(Sprite* sprite, Animation* animation, float elapsed = 0.0f);
+
+    /** Stops the animation on a sprite, leaving its current frame.*/
+    void stop(Sprite* sprite);
+    void stopAll();
+
+    bool isPlaying(Sprite* sprite) const;
+    ssize_t getSpriteCount() const;
+
+    /** Sets the scale of the time of all the animations, 1 by default.*/
+    void setTimeScale(float timeScale) { _timeScale = timeScale; }
+    float getTimeScale() const { return _timeScale; }
+
+    /** Advances the animations, it's called by the scheduler every frame.*/
+    void update(float dt);
+
+CC_CONSTRUCTOR_ACCESS:
+    FlipbookAnimator();
+    virtual ~FlipbookAnimator();
+
+protected:
+    struct Entry
+    {
+        Sprite* sprite;
+        Animation* animation;
+        AnimationFrameTable* frameTable;
+        SpriteFrame* originalFrame;
+        float elapsed;
+        ssize_t frameIndex;
+    };
+
+    void showFrame(Entry& entry, ssize_t frameIndex);
+    void releaseEntry(Entry& entry);
+    void removeEntry(size_t index);
+
+    std::vector<Entry> _entries;
+    std::unordered_map<Sprite*, size_t> _indices;
+    float _timeScale;
+    bool _updating;
+    EventCustom* _frameDisplayedEvent;
+    AnimationFrame::DisplayedEventInfo _frameDisplayedEventInfo;
+
+private:
+    CC_DISALLOW_COPY_AND_ASSIGN(FlipbookAnimator);
+};
+
 // end of sprite_nodes group
 /// @}
 
@@ -29,9 +29,13 @@ THE SOFTWARE.
 #include "poly2tri/poly2tri.h"
 #include "base/CCDirector.h"
 #include "renderer/CCTextureCache.h"
+#include "base/CCAsyncTaskPool.h"
+#include "base/ccUTF8.h"
+#include "platform/CCFileUtils.h"
 #include "clipper/clipper.hpp"
 #include <algorithm>
 #include <math.h>
+#include <unordered_map>
 
 USING_NS_CC;
 
@@ -49,6 +53,17 @@ static unsigned short quadIndices9[]={
 
 const static float PRECISION = 10.0f;
 
+// the polygons generated by AutoPolygon::generatePolygon(), and the callbacks of the ones being generated
+static std::unordered_map<std::string, PolygonInfo> s_polygonCache;
+static std::unordered_map<std::string, std::vector<std::function<void(const PolygonInfo&)>>> s_pendingPolygons;
+
+static std::string polygonCacheKey(const std::string& fullPath, const Rect& rect, float epsilon, float threshold)
+{
+    // the rect is converted to pixels with the content scale factor
+    return StringUtils::format("%s|%g,%g,%g,%g|%g|%g|%g", fullPath.c_str(), rect.origin.x, rect.origin.y, rect.size.width, rect.size.height,
+                               epsilon, threshold, Director::getInstance()->getContentScaleFactor());
+}
+
 PolygonInfo::PolygonInfo()
 : _rect(Rect::ZERO)
 , _filename("")
@@ -198,6 +213,16 @@ AutoPolygon::AutoPolygon(const std::string &filename)
     _scaleFactor = Director::getInstance()->getContentScaleFactor();
 }
 
+AutoPolygon::AutoPolygon(Image* image, const std::string& filename)
+:_image(image)
+,_data(image->getData())
+,_filename(filename)
+,_width(image->getWidth())
+,_height(image->getHeight())
+,_scaleFactor(Director::getInstance()->getContentScaleFactor())
+{
+}
+
 AutoPolygon::~AutoPolygon()
 {
     CC_SAFE_DELETE(_image);
@@ -720,6 +745,74 @@ PolygonInfo AutoPolygon::generateTriangles(const Rect& rect, float epsilon, floa
 
 PolygonInfo AutoPolygon::generatePolygon(const std::string& filename, const Rect& rect, float epsilon, float threshold)
 {
+    std::string key = polygonCacheKey(FileUtils::getInstance()->fullPathForFilename(filename), rect, epsilon, threshold);
+    auto iter = s_polygonCache.find(key);
+    if (iter != s_polygonCache.end())
+    {
+        return iter->second;
+    }
+
     AutoPolygon ap(filename);
-    return ap.generateTriangles(rect, epsilon, threshold);
+    PolygonInfo ret = ap.generateTriangles(rect, epsilon, threshold);
+    s_polygonCache.emplace(key, ret);
+    return ret;
+}
+
+void AutoPolygon::generatePolygonAsync(const std::string& filename, const Rect& rect, float epsilon, float threshold, const std::function<void(const PolygonInfo&)>& callback)
+{
+    std::string fullPath = FileUtils::getInstance()->fullPathForFilename(filename);
+    std::string key = polygonCacheKey(fullPath, rect, epsilon, threshold);
+
+    auto iter = s_polygonCache.find(key);
+    if (iter != s_polygonCache.end())
+    {
+        if (callback)
+            callback(iter->second);
+        return;
+    }
+
+    // the same polygon is only generated once
+    auto pending = s_pendingPolygons.find(key);
+    if (pending != s_pendingPolygons.end())
+    {
+        pending->second.push_back(callback);
+        return;
+    }
+    s_pendingPolygons[key].push_back(callback);
+
+    // filled on a worker, then read on the cocos thread
+    auto result = std::make_shared<PolygonInfo>();
+    auto jobSystem = JobSystem::getInstance();
+    auto job = jobSystem->schedule([result, fullPath, filename, rect, epsilon, threshold]() {
+        Image* image = new (std::nothrow) Image();
+        if (!image->initWithImageFileThreadSafe(fullPath) || image->getRenderFormat() != Texture2D::PixelFormat::RGBA8888)
+        {
+            CCLOG("cocos2d: AutoPolygon: unsupported image %s, currently only supports rgba8888", fullPath.c_str());
+            delete image;
+            return;
+        }
+
+        AutoPolygon ap(image, filename);
+        *result = ap.generateTriangles(rect, epsilon, threshold);
+    });
+
+    jobSystem->scheduleOnCocosThread([result, key]() {
+        auto callbacks = std::move(s_pendingPolygons[key]);
+        s_pendingPolygons.erase(key);
+
+        if (result->getTrianglesCount() > 0)
+        {
+            s_polygonCache.emplace(key, *result);
+        }
+        for (const auto& pendingCallback : callbacks)
+        {
+            if (pendingCallback)
+                pendingCallback(*result);
+        }
+    }, {job});
+}
+
+void AutoPolygon::purgeCache()
+{
+    s_polygonCache.clear();
 }
@@ -28,6 +28,7 @@ THE SOFTWARE.
 #ifndef COCOS_2D_CCAUTOPOLYGON_H__
 #define COCOS_2D_CCAUTOPOLYGON_H__
 
+#include <functional>
 #include <string>
 #include <vector>
 #include "platform/CCImage.h"
@@ -254,9 +255,39 @@ public:
      * @code
      * auto sp = Sprite::create(AutoPolygon::generatePolygon("grossini.png"));
      * @endcode
+     * The results are cached by file, rect, epsilon and threshold, so the same polygon is only generated once.
+     * It must be called on the cocos thread.
      */
     static PolygonInfo generatePolygon(const std::string& filename, const Rect& rect = Rect::ZERO, float epsilon = 2.0f, float threshold = 0.05f);
+
+    /**
+     * generates a polygon like generatePolygon() on a worker thread of the JobSystem, the polygons of several
+     * files are generated in parallel
+     * the callback is called on the cocos thread with the polygon, which has no triangles if the image can't be loaded
+     * the results share the cache of generatePolygon()
+     * @param   filename     A path to image file, e.g., "scene1/monster.png".
+     * @param   rect    texture rect, use Rect::ZERO for the size of the texture
+     * @param   epsilon the value used to reduce and expand
+     * @param   threshold   the value where bigger than the threshold will be counted as opaque, used in trace
+     * @param   callback    called with the generated polygon
+     * @code
+     * AutoPolygon::generatePolygonAsync("grossini.png", Rect::ZERO, 2.0f, 0.05f, [this](const PolygonInfo& info) {
+     *     addChild(Sprite::create(info));
+     * });
+     * @endcode
+     * @since v3.14
+     */
+    static void generatePolygonAsync(const std::string& filename, const Rect& rect, float epsilon, float threshold, const std::function<void(const PolygonInfo&)>& callback);
+
+    /**
+     * removes all the polygons cached by generatePolygon() and generatePolygonAsync()
+     * @since v3.14
+     */
+    static void purgeCache();
 protected:
+    // takes the ownership of an image that is already loaded, e.g. on a worker thread
+    AutoPolygon(Image* image, const std::string& filename);
+
     Vec2 findFirstNoneTransparentPixel(const Rect& rect, float threshold);
     std::vector<cocos2d::Vec2> marchSquare(const Rect& rect, const Vec2& first, float threshold);
     unsigned int getSquareValue(unsigned int x, unsigned int y, const Rect& rect, float threshold);
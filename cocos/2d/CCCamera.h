@@ -205,6 +205,18 @@ public:
      * Is this aabb visible in frustum
      */
     bool isVisibleInFrustum(const AABB* aabb) const;
+
+    /**
+     * Get the frustum of the camera, updated if the camera moved.
+     * @since v3.14
+     */
+    const Frustum& getFrustum() const;
+
+    /**
+     * Tests many boxes against the frustum of the camera at once, see Frustum::cullAABBs.
+     * @since v3.14
+     */
+    void cullAABBs(const AABBArray& boxes, uint32_t* visibleMasks) const { getFrustum().cullAABBs(boxes, visibleMasks); }
     
     /**
      * Get object depth towards camera
@@ -257,6 +269,11 @@ public:
      Set FBO, which will attach several render target for the rendered result.
      */
     void setFrameBufferObject(experimental::FrameBuffer* fbo);
+    /**
+     The FBO set by setFrameBufferObject(), nullptr for the one bound when the camera is rendered.
+     @since v3.14
+     */
+    experimental::FrameBuffer* getFrameBufferObject() const { return _fbo; }
     /**
      Set Viewport for camera.
      */
@@ -27,6 +27,10 @@
 
 #include "2d/CCClippingNode.h"
 #include "2d/CCDrawingPrimitives.h"
+#include "2d/CCCamera.h"
+#include "2d/CCDrawNode.h"
+#include "2d/CCLayer.h"
+#include "2d/CCSprite.h"
 #include "renderer/CCGLProgramCache.h"
 #include "renderer/ccGLStateCache.h"
 #include "renderer/CCRenderer.h"
@@ -58,6 +62,7 @@ ClippingNode::ClippingNode()
 : _stencil(nullptr)
 , _stencilStateManager(new StencilStateManager())
 , _originStencilProgram(nullptr)
+, _previousScissorEnabled(GL_FALSE)
 {
 }
 
@@ -211,12 +216,20 @@ void ClippingNode::visit(Renderer *renderer, const Mat4 &parentTransform, uint32
 
     renderer->pushGroup(_groupCommand.getRenderQueueID());
 
+    // a rectangle clips with the scissor test, the stencil isn't drawn and the batching isn't broken by it
+    bool scissor = getStencilScissorRect(&_scissorRect);
+    if (scissor)
+        _scissorTransform = _modelViewTransform * _stencil->getNodeToParentTransform();
+
     _beforeVisitCmd.init(_globalZOrder);
-    _beforeVisitCmd.func = CC_CALLBACK_0(StencilStateManager::onBeforeVisit, _stencilStateManager);
+    if (scissor)
+        _beforeVisitCmd.func = CC_CALLBACK_0(ClippingNode::onBeforeVisitScissor, this);
+    else
+        _beforeVisitCmd.func = CC_CALLBACK_0(StencilStateManager::onBeforeVisit, _stencilStateManager);
     renderer->addCommand(&_beforeVisitCmd);
     
     auto alphaThreshold = this->getAlphaThreshold();
-    if (alphaThreshold < 1)
+    if (!scissor && alphaThreshold < 1)
     {
 #if CC_CLIPPING_NODE_OPENGLES
         // since glAlphaTest do not exists in OES, use a shader that writes
@@ -232,11 +245,14 @@ void ClippingNode::visit(Renderer *renderer, const Mat4 &parentTransform, uint32
 #endif
 
     }
-    _stencil->visit(renderer, _modelViewTransform, flags);
+    if (!scissor)
+    {
+        _stencil->visit(renderer, _modelViewTransform, flags);
 
-    _afterDrawStencilCmd.init(_globalZOrder);
-    _afterDrawStencilCmd.func = CC_CALLBACK_0(StencilStateManager::onAfterDrawStencil, _stencilStateManager);
-    renderer->addCommand(&_afterDrawStencilCmd);
+        _afterDrawStencilCmd.init(_globalZOrder);
+        _afterDrawStencilCmd.func = CC_CALLBACK_0(StencilStateManager::onAfterDrawStencil, _stencilStateManager);
+        renderer->addCommand(&_afterDrawStencilCmd);
+    }
 
     int i = 0;
     bool visibleByCamera = isVisitableByVisitingCamera();
@@ -267,7 +283,10 @@ void ClippingNode::visit(Renderer *renderer, const Mat4 &parentTransform, uint32
     }
 
     _afterVisitCmd.init(_globalZOrder);
-    _afterVisitCmd.func = CC_CALLBACK_0(StencilStateManager::onAfterVisit, _stencilStateManager);
+    if (scissor)
+        _afterVisitCmd.func = CC_CALLBACK_0(ClippingNode::onAfterVisitScissor, this);
+    else
+        _afterVisitCmd.func = CC_CALLBACK_0(StencilStateManager::onAfterVisit, _stencilStateManager);
     renderer->addCommand(&_afterVisitCmd);
 
     renderer->popGroup();
@@ -275,6 +294,150 @@ void ClippingNode::visit(Renderer *renderer, const Mat4 &parentTransform, uint32
     director->popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
 }
 
+// the rectangle of 4 vertices which are its corners
+static bool getQuadRect(const V3F_C4B_T2F* verts, Rect* rect)
+{
+    float minX = verts[0].vertices.x, maxX = minX;
+    float minY = verts[0].vertices.y, maxY = minY;
+    for (int i = 1; i < 4; ++i)
+    {
+        minX = std::min(minX, verts[i].vertices.x);
+        maxX = std::max(maxX, verts[i].vertices.x);
+        minY = std::min(minY, verts[i].vertices.y);
+        maxY = std::max(maxY, verts[i].vertices.y);
+    }
+
+    int corners = 0;
+    for (int i = 0; i < 4; ++i)
+    {
+        const auto& vertex = verts[i].vertices;
+        if ((vertex.x != minX && vertex.x != maxX) || (vertex.y != minY && vertex.y != maxY))
+            return false;
+        corners |= 1 << ((vertex.x == maxX ? 1 : 0) + (vertex.y == maxY ? 2 : 0));
+    }
+    if (corners != 0xf)
+        return false;
+
+    rect->setRect(minX, minY, maxX - minX, maxY - minY);
+    return true;
+}
+
+bool ClippingNode::getStencilScissorRect(Rect* rect) const
+{
+    // the threshold discards pixels and the scissor test can't draw outside of a rectangle
+    if (_stencil == nullptr || !_stencil->isVisible() || !_stencil->getChildren().empty()
+        || getAlphaThreshold() < 1 || isInverted())
+        return false;
+
+    // the points are only the window coordinates with the default camera of a single view, and not inside a RenderTexture
+    auto camera = Camera::getVisitingCamera();
+    if (camera == nullptr || camera != Camera::getDefaultCamera() || _director->getProjectionMatrixStackSize() != 1
+        || memcmp(_director->getMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION).m, camera->getViewProjectionMatrix().m, sizeof(Mat4::m)) != 0)
+        return false;
+
+    Rect local;
+    auto cache = GLProgramCache::getInstance();
+    if (auto drawNode = dynamic_cast<DrawNode*>(_stencil))
+    {
+        if (!drawNode->isAxisAlignedRectangle(&local))
+            return false;
+    }
+    else if (auto layer = dynamic_cast<LayerColor*>(_stencil))
+    {
+        if (layer->getGLProgram() != cache->getGLProgram(GLProgram::SHADER_NAME_POSITION_COLOR_NO_MVP))
+            return false;
+        local.size = layer->getContentSize();
+    }
+    else if (auto sprite = dynamic_cast<Sprite*>(_stencil))
+    {
+        const auto& triangles = sprite->getPolygonInfo().triangles;
+        if (sprite->getGLProgram() != cache->getGLProgram(GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR_NO_MVP)
+            || triangles.vertCount != 4 || !getQuadRect(triangles.verts, &local))
+            return false;
+    }
+    else
+    {
+        return false;
+    }
+
+    // project the corners like Camera::projectGL(), they must still be the ones of a rectangle: no rotation nor skew
+    Mat4 transform = camera->getViewProjectionMatrix() * _modelViewTransform * _stencil->getNodeToParentTransform();
+    const auto& winSize = _director->getWinSize();
+    Vec2 corners[4];
+    for (int i = 0; i < 4; ++i)
+    {
+        Vec4 clipPos;
+        transform.transformVector(Vec4(i & 1 ? local.getMaxX() : local.getMinX(), i & 2 ? local.getMaxY() : local.getMinY(), 0, 1), &clipPos);
+        // behind the camera
+        if (clipPos.w <= 0)
+            return false;
+        corners[i].x = (clipPos.x / clipPos.w + 1.0f) * 0.5f * winSize.width;
+        corners[i].y = (clipPos.y / clipPos.w + 1.0f) * 0.5f * winSize.height;
+    }
+
+    const float epsilon = 0.01f;
+    if (std::fabs(corners[0].x - corners[2].x) > epsilon || std::fabs(corners[1].x - corners[3].x) > epsilon
+        || std::fabs(corners[0].y - corners[1].y) > epsilon || std::fabs(corners[2].y - corners[3].y) > epsilon)
+        return false;
+
+    *rect = local;
+    return true;
+}
+
+void ClippingNode::onBeforeVisitScissor()
+{
+    _previousScissorEnabled = GL::isEnabled(GL_SCISSOR_TEST);
+
+    // projected when the command is executed, it may be executed for each eye of a stereo rendering
+    Mat4 transform = _director->getMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION) * _scissorTransform;
+    GLint viewport[4];
+    GL::getViewport(viewport);
+
+    float minX = FLT_MAX, minY = FLT_MAX, maxX = -FLT_MAX, maxY = -FLT_MAX;
+    for (int i = 0; i < 4; ++i)
+    {
+        Vec4 clipPos;
+        transform.transformVector(Vec4(i & 1 ? _scissorRect.getMaxX() : _scissorRect.getMinX(), i & 2 ? _scissorRect.getMaxY() : _scissorRect.getMinY(), 0, 1), &clipPos);
+        float x = viewport[0] + (clipPos.x / clipPos.w + 1.0f) * 0.5f * viewport[2];
+        float y = viewport[1] + (clipPos.y / clipPos.w + 1.0f) * 0.5f * viewport[3];
+        minX = std::min(minX, x);
+        minY = std::min(minY, y);
+        maxX = std::max(maxX, x);
+        maxY = std::max(maxY, y);
+    }
+
+    // the pixels whose center is inside the rectangle, as the rasterization of the stencil
+    GLint x1 = (GLint)std::floor(minX + 0.5f);
+    GLint y1 = (GLint)std::floor(minY + 0.5f);
+    GLint x2 = (GLint)std::floor(maxX + 0.5f);
+    GLint y2 = (GLint)std::floor(maxY + 0.5f);
+
+    // nested in an other scissor clipping
+    if (_previousScissorEnabled)
+    {
+        GL::getScissor(_previousScissor);
+        x1 = std::max(x1, _previousScissor[0]);
+        y1 = std::max(y1, _previousScissor[1]);
+        x2 = std::min(x2, _previousScissor[0] + _previousScissor[2]);
+        y2 = std::min(y2, _previousScissor[1] + _previousScissor[3]);
+    }
+
+    GL::enable(GL_SCISSOR_TEST);
+    GL::scissor(x1, y1, std::max(x2 - x1, 0), std::max(y2 - y1, 0));
+}
+
+void ClippingNode::onAfterVisitScissor()
+{
+    if (_previousScissorEnabled)
+    {
+        GL::scissor(_previousScissor[0], _previousScissor[1], _previousScissor[2], _previousScissor[3]);
+    }
+    else
+    {
+        GL::disable(GL_SCISSOR_TEST);
+    }
+}
+
 void ClippingNode::setCameraMask(unsigned short mask, bool applyChildren)
 {
     Node::setCameraMask(mask, applyChildren);
@@ -44,6 +44,9 @@ class StencilStateManager;
  * It draws its content (children) clipped using a stencil.
  * The stencil is an other Node that will not be drawn.
  * The clipping is done using the alpha part of the stencil (adjusted with an alphaThreshold).
+ * When the stencil is a rectangle on the screen, eg: a LayerColor, a Sprite or a DrawNode filled with drawSolidRect()
+ * without rotation nor skew, the alphaThreshold is 1 and the clipping isn't inverted, the scissor test is used
+ * instead of the stencil buffer, like ClippingRectangleNode.
  */
 class CC_DLL ClippingNode : public Node
 {
@@ -155,6 +158,14 @@ CC_CONSTRUCTOR_ACCESS:
     virtual bool init(Node *stencil);
 
 protected:
+    /** Whether or not the stencil is a rectangle on the screen, in which case the scissor test can clip.
+     * The rectangle is stored in the coordinates of the stencil.
+     * @since v3.14
+     */
+    bool getStencilScissorRect(Rect* rect) const;
+    void onBeforeVisitScissor();
+    void onAfterVisitScissor();
+
     Node* _stencil;
     GLProgram* _originStencilProgram;
    
@@ -165,6 +176,11 @@ protected:
     CustomCommand _afterDrawStencilCmd;
     CustomCommand _afterVisitCmd;
 
+    Rect _scissorRect;
+    Mat4 _scissorTransform;
+    GLboolean _previousScissorEnabled;
+    GLint _previousScissor[4];
+
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(ClippingNode);
 };
@@ -23,12 +23,17 @@ THE SOFTWARE.
 ****************************************************************************/
 
 #include "2d/CCComponent.h"
+#include "2d/CCComponentSystem.h"
+#include "2d/CCNode.h"
+#include "base/CCScheduler.h"
 
 NS_CC_BEGIN
 
 Component::Component()
 : _owner(nullptr)
 , _enabled(true)
+, _updateIndex(-1)
+, _updateBatched(false)
 {
 #if CC_ENABLE_SCRIPT_BINDING
     ScriptEngineProtocol* engine = ScriptEngineManager::getInstance()->getScriptEngine();
@@ -38,6 +43,7 @@ Component::Component()
 
 Component::~Component()
 {
+    CCASSERT(_updateIndex == -1, "Component: deleted while in ComponentSystem");
 }
 
 bool Component::init()
@@ -144,6 +150,24 @@ void Component::setOwner(Node *owner)
     _owner = owner;
 }
 
+void Component::setUpdateType(const std::string& type)
+{
+    if (type == _updateType)
+        return;
+
+    // moves to the list of its new type
+    bool added = _updateIndex != -1 || (_owner && !_owner->getScheduler()->isTargetPaused(_owner));
+    if (_updateIndex != -1)
+    {
+        ComponentSystem::getInstance()->removeComponent(this);
+    }
+    _updateType = type;
+    if (added && !_updateType.empty())
+    {
+        ComponentSystem::getInstance()->addComponent(this);
+    }
+}
+
 void Component::setEnabled(bool enabled)
 {
     _enabled = enabled;
@@ -64,6 +64,17 @@ public:
     Node* getOwner() const { return _owner; }
     virtual void setOwner(Node *owner);
 
+    /**
+     * Sets the type the component is updated with by ComponentSystem, once the type is registered there.
+     * Empty by default, the component is updated by its owner.
+     * @since v3.14
+     */
+    void setUpdateType(const std::string& type);
+    const std::string& getUpdateType() const { return _updateType; }
+
+    /** Whether the component is updated by ComponentSystem rather than by its owner. @since v3.14 */
+    bool isUpdateBatched() const { return _updateBatched; }
+
     virtual void update(float delta);
     virtual bool serialize(void* r);
 
@@ -82,6 +93,11 @@ protected:
     Node* _owner;
     std::string _name;
     bool _enabled;
+    std::string _updateType;
+    ssize_t _updateIndex;             ///< index in the list of its type in ComponentSystem, -1 when it isn't in it
+    bool _updateBatched;
+
+    friend class ComponentSystem;
     
 #if CC_ENABLE_SCRIPT_BINDING
     ccScriptType _scriptType;         ///< type of script binding, lua or javascript
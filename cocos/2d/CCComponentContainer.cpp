@@ -25,7 +25,9 @@ THE SOFTWARE.
 
 #include "2d/CCComponentContainer.h"
 #include "2d/CCComponent.h"
+#include "2d/CCComponentSystem.h"
 #include "2d/CCNode.h"
+#include "base/CCScheduler.h"
 
 NS_CC_BEGIN
 
@@ -70,6 +72,11 @@ bool ComponentContainer::add(Component *com)
         com->setOwner(_owner);
         com->onAdd();
 
+        if (!com->getUpdateType().empty() && !_owner->getScheduler()->isTargetPaused(_owner))
+        {
+            ComponentSystem::getInstance()->addComponent(com);
+        }
+
         ret = true;
     } while(0);
     return ret;
@@ -86,6 +93,11 @@ bool ComponentContainer::remove(const std::string& componentName)
         auto component = iter->second;
         _componentMap.erase(componentName);
 
+        if (ComponentSystem::s_componentSystem)
+        {
+            ComponentSystem::s_componentSystem->removeComponent(component);
+        }
+
         component->onRemove();
         component->setOwner(nullptr);
         component->release();
@@ -105,6 +117,7 @@ void ComponentContainer::removeAll()
 {
     if (!_componentMap.empty())
     {
+        pause();
         for (auto& iter : _componentMap)
         {
             iter.second->onRemove();
@@ -124,7 +137,10 @@ void ComponentContainer::visit(float delta)
         CC_SAFE_RETAIN(_owner);
         for (auto& iter : _componentMap)
         {
-            iter.second->update(delta);
+            if (!iter.second->isUpdateBatched())
+            {
+                iter.second->update(delta);
+            }
         }
         CC_SAFE_RELEASE(_owner);
     }
@@ -138,6 +154,28 @@ void ComponentContainer::onEnter()
     }
 }
 
+void ComponentContainer::resume()
+{
+    for (auto& iter : _componentMap)
+    {
+        if (!iter.second->getUpdateType().empty())
+        {
+            ComponentSystem::getInstance()->addComponent(iter.second);
+        }
+    }
+}
+
+void ComponentContainer::pause()
+{
+    if (ComponentSystem::s_componentSystem)
+    {
+        for (auto& iter : _componentMap)
+        {
+            ComponentSystem::s_componentSystem->removeComponent(iter.second);
+        }
+    }
+}
+
 void ComponentContainer::onExit()
 {
     for (auto& iter : _componentMap)
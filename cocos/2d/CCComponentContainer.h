@@ -63,6 +63,10 @@ public:
     
     void onEnter();
     void onExit();
+
+    // add the components with an update type to ComponentSystem, or remove them
+    void resume();
+    void pause();
     
     bool isEmpty() const { return _componentMap.empty(); } 
 private:
@@ -0,0 +1,294 @@
+/****************************************************************************
+Copyright (c) 2017 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+
+#include "2d/CCComponentSystem.h"
+
+#include <algorithm>
+
+#include "2d/CCComponent.h"
+#include "2d/CCNode.h"
+#include "base/CCDirector.h"
+#include "base/CCScheduler.h"
+
+NS_CC_BEGIN
+
+ComponentSystem* ComponentSystem::s_componentSystem = nullptr;
+
+static const char* COMPONENT_SYSTEM_KEY = "ComponentSystem";
+
+// the index of a component added while updating, it's in _addedComponents
+static const ssize_t ADDED_INDEX = -2;
+
+ComponentSystem* ComponentSystem::getInstance()
+{
+    if (s_componentSystem == nullptr)
+    {
+        s_componentSystem = new (std::nothrow) ComponentSystem();
+    }
+    return s_componentSystem;
+}
+
+void ComponentSystem::destroyInstance()
+{
+    delete s_componentSystem;
+    s_componentSystem = nullptr;
+}
+
+ComponentSystem::ComponentSystem()
+: _updating(false)
+, _scheduled(false)
+{
+}
+
+ComponentSystem::~ComponentSystem()
+{
+    if (_scheduled)
+    {
+        Director::getInstance()->getScheduler()->unschedule(COMPONENT_SYSTEM_KEY, this);
+    }
+    for (auto& iter : _entries)
+    {
+        for (auto component : iter.second->components)
+        {
+            if (component)
+            {
+                component->_updateIndex = -1;
+                component->_updateBatched = false;
+            }
+        }
+        delete iter.second;
+    }
+    for (auto component : _addedComponents)
+    {
+        component->_updateIndex = -1;
+    }
+}
+
+ComponentSystem::TypeEntry* ComponentSystem::getEntry(const std::string& type)
+{
+    auto iter = _entries.find(type);
+    if (iter != _entries.end())
+        return iter->second;
+
+    auto entry = new (std::nothrow) TypeEntry();
+    entry->type = type;
+    entry->priority = 0;
+    entry->registered = false;
+    entry->hasHoles = false;
+    _entries[type] = entry;
+    return entry;
+}
+
+void ComponentSystem::registerType(const std::string& type, const UpdateCallback& callback, int priority)
+{
+    CCASSERT(!type.empty(), "ComponentSystem: the type should not be empty");
+
+    auto entry = getEntry(type);
+    entry->callback = callback;
+    entry->priority = priority;
+
+    _registeredEntries.erase(std::remove(_registeredEntries.begin(), _registeredEntries.end(), entry), _registeredEntries.end());
+    auto position = std::upper_bound(_registeredEntries.begin(), _registeredEntries.end(), entry, [](const TypeEntry* a, const TypeEntry* b) {
+        return a->priority < b->priority;
+    });
+    _registeredEntries.insert(position, entry);
+
+    setBatched(entry, true);
+    scheduleUpdate();
+}
+
+void ComponentSystem::unregisterType(const std::string& type)
+{
+    auto iter = _entries.find(type);
+    if (iter == _entries.end() || !iter->second->registered)
+        return;
+
+    // the callback is kept, it may be the one running
+    auto entry = iter->second;
+    _registeredEntries.erase(std::remove(_registeredEntries.begin(), _registeredEntries.end(), entry), _registeredEntries.end());
+    setBatched(entry, false);
+
+    if (_registeredEntries.empty() && _scheduled)
+    {
+        Director::getInstance()->getScheduler()->unschedule(COMPONENT_SYSTEM_KEY, this);
+        _scheduled = false;
+    }
+}
+
+bool ComponentSystem::isTypeRegistered(const std::string& type) const
+{
+    auto iter = _entries.find(type);
+    return iter != _entries.end() && iter->second->registered;
+}
+
+const std::vector<Component*>& ComponentSystem::getComponents(const std::string& type) const
+{
+    static const std::vector<Component*> empty;
+    auto iter = _entries.find(type);
+    return iter != _entries.end() ? iter->second->components : empty;
+}
+
+void ComponentSystem::setBatched(TypeEntry* entry, bool batched)
+{
+    entry->registered = batched;
+    for (auto component : entry->components)
+    {
+        if (component)
+        {
+            component->_updateBatched = batched;
+        }
+    }
+    for (auto component : _addedComponents)
+    {
+        if (component->getUpdateType() == entry->type)
+        {
+            component->_updateBatched = batched;
+        }
+    }
+}
+
+void ComponentSystem::scheduleUpdate()
+{
+    if (!_scheduled)
+    {
+        // a frame timer, after the updates of the nodes
+        Director::getInstance()->getScheduler()->schedule(CC_CALLBACK_1(ComponentSystem::update, this), this, 0, false, COMPONENT_SYSTEM_KEY);
+        _scheduled = true;
+    }
+}
+
+void ComponentSystem::addComponent(Component* component)
+{
+    CCASSERT(!component->getUpdateType().empty(), "ComponentSystem: the component has no update type");
+    if (component->_updateIndex != -1)
+        return;
+
+    auto entry = getEntry(component->getUpdateType());
+    component->_updateBatched = entry->registered;
+    if (_updating)
+    {
+        component->_updateIndex = ADDED_INDEX;
+        _addedComponents.push_back(component);
+    }
+    else
+    {
+        component->_updateIndex = (ssize_t)entry->components.size();
+        entry->components.push_back(component);
+    }
+}
+
+void ComponentSystem::removeComponent(Component* component)
+{
+    auto index = component->_updateIndex;
+    if (index == -1)
+        return;
+
+    component->_updateIndex = -1;
+    component->_updateBatched = false;
+
+    if (index == ADDED_INDEX)
+    {
+        _addedComponents.erase(std::find(_addedComponents.begin(), _addedComponents.end(), component));
+        return;
+    }
+
+    auto entry = getEntry(component->getUpdateType());
+    auto& components = entry->components;
+    CCASSERT(index < (ssize_t)components.size() && components[index] == component, "ComponentSystem: invalid component index");
+    if (_updating)
+    {
+        components[index] = nullptr;
+        entry->hasHoles = true;
+    }
+    else
+    {
+        // the order doesn't matter, the last one takes its place
+        auto last = components.back();
+        components[index] = last;
+        last->_updateIndex = index;
+        components.pop_back();
+    }
+}
+
+void ComponentSystem::update(float delta)
+{
+    _updating = true;
+
+    // the callbacks may register or unregister types
+    auto entries = _registeredEntries;
+    for (auto entry : entries)
+    {
+        if (!entry->registered || entry->components.empty())
+            continue;
+
+        if (entry->callback)
+        {
+            entry->callback(entry->components, delta);
+        }
+        else
+        {
+            auto& components = entry->components;
+            for (size_t i = 0; i < components.size(); ++i)
+            {
+                auto component = components[i];
+                if (component)
+                {
+                    // as ComponentContainer::visit(), the update may remove the owner
+                    auto owner = component->getOwner();
+                    CC_SAFE_RETAIN(owner);
+                    component->update(delta);
+                    CC_SAFE_RELEASE(owner);
+                }
+            }
+        }
+    }
+
+    _updating = false;
+
+    for (auto& iter : _entries)
+    {
+        auto entry = iter.second;
+        if (!entry->hasHoles)
+            continue;
+
+        auto& components = entry->components;
+        components.erase(std::remove(components.begin(), components.end(), nullptr), components.end());
+        for (size_t i = 0; i < components.size(); ++i)
+        {
+            components[i]->_updateIndex = (ssize_t)i;
+        }
+        entry->hasHoles = false;
+    }
+
+    auto added = std::move(_addedComponents);
+    _addedComponents.clear();
+    for (auto component : added)
+    {
+        component->_updateIndex = -1;
+        addComponent(component);
+    }
+}
+
+NS_CC_END
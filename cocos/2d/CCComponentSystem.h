@@ -0,0 +1,137 @@
+/****************************************************************************
+Copyright (c) 2017 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+
+#ifndef __CC_COMPONENT_SYSTEM_H__
+#define __CC_COMPONENT_SYSTEM_H__
+
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "platform/CCPlatformMacros.h"
+
+/**
+ * @addtogroup _2d
+ * @{
+ */
+NS_CC_BEGIN
+
+class Component;
+
+/**
+ * @class ComponentSystem
+ * @brief Updates the components of the same type together, from a list per type, rather than from their owners.
+ *
+ * A component takes part with Component::setUpdateType(); ComponentLua and ComponentJS use their script file.
+ * Once its type is registered, the components of this type in the nodes that are not paused are updated in
+ * a single call per frame, after the updates of the nodes, and their owners no longer update them. The
+ * callback of a type gets the whole list, so a plugin or a script layer can update them in one pass, e.g.
+ * ComponentLua::registerBatchUpdate() crosses into Lua once per type.
+ *
+ * All the methods must be called on the cocos thread.
+ * @since v3.14
+ * @js NA
+ * @lua NA
+ */
+class CC_DLL ComponentSystem
+{
+public:
+    /**
+     * Updates the components of a type, in no particular order.
+     * The entries of the components removed during the update are nullptr, the added ones are in the next update.
+     */
+    typedef std::function<void(const std::vector<Component*>& components, float delta)> UpdateCallback;
+
+    /** Returns the shared system, it runs from the scheduler of the Director. */
+    static ComponentSystem* getInstance();
+
+    /** Destroys the shared system, the components are updated by their owners again. */
+    static void destroyInstance();
+
+    /**
+     * Updates the components of a type together from now on.
+     * @param type The update type of the components.
+     * @param callback Updates the components, nullptr calls Component::update() on each one.
+     * @param priority The types with a lower priority are updated first.
+     */
+    void registerType(const std::string& type, const UpdateCallback& callback = nullptr, int priority = 0);
+
+    /** The components of the type are updated by their owners again. */
+    void unregisterType(const std::string& type);
+
+    bool isTypeRegistered(const std::string& type) const;
+
+    /** Returns the components of a type in the nodes that are not paused, registered or not. */
+    const std::vector<Component*>& getComponents(const std::string& type) const;
+
+    /** Runs the callbacks of the registered types, called by the scheduler. */
+    void update(float delta);
+
+CC_CONSTRUCTOR_ACCESS:
+    ComponentSystem();
+    ~ComponentSystem();
+
+protected:
+    friend class Component;
+    friend class ComponentContainer;
+
+    struct TypeEntry
+    {
+        std::string type;
+        std::vector<Component*> components;
+        UpdateCallback callback;
+        int priority;
+        bool registered;
+        /** some components were removed while updating, their entries are nullptr */
+        bool hasHoles;
+    };
+
+    /** Adds a component with an update type, when its owner is resumed.*/
+    void addComponent(Component* component);
+    /** Removes a component, when its owner is paused or it's removed from it.*/
+    void removeComponent(Component* component);
+    TypeEntry* getEntry(const std::string& type);
+    void setBatched(TypeEntry* entry, bool batched);
+    void scheduleUpdate();
+
+    // every type seen, the entries are never deleted so the components can keep their index
+    std::unordered_map<std::string, TypeEntry*> _entries;
+    // sorted by priority
+    std::vector<TypeEntry*> _registeredEntries;
+    // the components added while updating
+    std::vector<Component*> _addedComponents;
+    bool _updating;
+    bool _scheduled;
+
+    static ComponentSystem* s_componentSystem;
+};
+
+NS_CC_END
+/**
+ * @}
+ */
+
+#endif // __CC_COMPONENT_SYSTEM_H__
@@ -97,6 +97,20 @@ static inline Tex2F __t(const Vec2 &v)
     return *(Tex2F*)&v;
 }
 
+static void uploadVertices(GLuint vbo, const V2F_C4B_T2F* vertices, GLsizei count, int capacity, bool isStatic)
+{
+    glBindBuffer(GL_ARRAY_BUFFER, vbo);
+    if (isStatic)
+    {
+        // the geometry is not expected to change, so only its used part is uploaded
+        glBufferData(GL_ARRAY_BUFFER, sizeof(V2F_C4B_T2F)*count, vertices, GL_STATIC_DRAW);
+    }
+    else
+    {
+        glBufferData(GL_ARRAY_BUFFER, sizeof(V2F_C4B_T2F)*capacity, vertices, GL_STREAM_DRAW);
+    }
+}
+
 // implementation of DrawNode
 
 DrawNode::DrawNode(GLfloat lineWidth)
@@ -120,6 +134,10 @@ DrawNode::DrawNode(GLfloat lineWidth)
 , _dirtyGLLine(false)
 , _lineWidth(lineWidth)
 , _defaultLineWidth(lineWidth)
+, _isStatic(false)
+, _isBatchingEnabled(false)
+, _batchedOpacity(0)
+, _drawnQueueGeneration(0)
 {
     _blendFunc = BlendFunc::ALPHA_PREMULTIPLIED;
 }
@@ -295,27 +313,83 @@ bool DrawNode::init()
     return true;
 }
 
+void DrawNode::updateBatchedTriangles()
+{
+    // the opacity is baked into the colors, since a batch can't share the u_alpha uniform
+    const float alpha = _displayedOpacity / 255.0f;
+    _batchedVertices.resize(_bufferCount);
+    for (GLsizei i = 0; i < _bufferCount; ++i)
+    {
+        const V2F_C4B_T2F& src = _buffer[i];
+        V3F_C4B_T2F& dst = _batchedVertices[i];
+        const float a = src.colors.a / 255.0f * alpha;
+        dst.vertices.set(src.vertices.x, src.vertices.y, 0.0f);
+        dst.colors = Color4B(static_cast<GLubyte>(src.colors.r * a),
+                             static_cast<GLubyte>(src.colors.g * a),
+                             static_cast<GLubyte>(src.colors.b * a),
+                             static_cast<GLubyte>(src.colors.a * alpha));
+        dst.texCoords = src.texCoords;
+    }
+
+    if (_batchedIndices.size() != static_cast<size_t>(_bufferCount))
+    {
+        _batchedIndices.resize(_bufferCount);
+        for (GLsizei i = 0; i < _bufferCount; ++i)
+        {
+            _batchedIndices[i] = static_cast<unsigned short>(i);
+        }
+    }
+
+    _batchedOpacity = _displayedOpacity;
+}
+
 void DrawNode::draw(Renderer *renderer, const Mat4 &transform, uint32_t flags)
 {
-    if(_bufferCount)
+    // the own commands are still queued when the node is drawn twice in a frame
+    bool useTransientCommands = _drawnQueueGeneration == renderer->getQueueGeneration();
+    _drawnQueueGeneration = renderer->getQueueGeneration();
+
+    if(_bufferCount && _isBatchingEnabled && _bufferCount < Renderer::VBO_SIZE)
     {
-        _customCommand.init(_globalZOrder, transform, flags);
-        _customCommand.func = CC_CALLBACK_0(DrawNode::onDraw, this, transform, flags);
-        renderer->addCommand(&_customCommand);
+        if (_dirty || _batchedOpacity != _displayedOpacity)
+        {
+            updateBatchedTriangles();
+            // the VBO is left as is, setBatchingEnabled(false) marks it dirty again
+            _dirty = false;
+        }
+
+        TrianglesCommand::Triangles triangles;
+        triangles.verts = _batchedVertices.data();
+        triangles.indices = _batchedIndices.data();
+        triangles.vertCount = _bufferCount;
+        triangles.indexCount = _bufferCount;
+        auto glProgramState = GLProgramState::getOrCreateWithGLProgramName(GLProgram::SHADER_NAME_POSITION_LENGTH_TEXTURE_COLOR_NO_MVP);
+        auto trianglesCommand = useTransientCommands ? renderer->generateTransientTrianglesCommand() : &_trianglesCommand;
+        trianglesCommand->init(_globalZOrder, (GLuint)0, glProgramState, _blendFunc, triangles, transform, flags);
+        renderer->addCommand(trianglesCommand);
+    }
+    else if(_bufferCount)
+    {
+        auto customCommand = useTransientCommands ? renderer->generateTransientCustomCommand() : &_customCommand;
+        customCommand->init(_globalZOrder, transform, flags);
+        customCommand->func = CC_CALLBACK_0(DrawNode::onDraw, this, transform, flags);
+        renderer->addCommand(customCommand);
     }
     
     if(_bufferCountGLPoint)
     {
-        _customCommandGLPoint.init(_globalZOrder, transform, flags);
-        _customCommandGLPoint.func = CC_CALLBACK_0(DrawNode::onDrawGLPoint, this, transform, flags);
-        renderer->addCommand(&_customCommandGLPoint);
+        auto customCommand = useTransientCommands ? renderer->generateTransientCustomCommand() : &_customCommandGLPoint;
+        customCommand->init(_globalZOrder, transform, flags);
+        customCommand->func = CC_CALLBACK_0(DrawNode::onDrawGLPoint, this, transform, flags);
+        renderer->addCommand(customCommand);
     }
     
     if(_bufferCountGLLine)
     {
-        _customCommandGLLine.init(_globalZOrder, transform, flags);
-        _customCommandGLLine.func = CC_CALLBACK_0(DrawNode::onDrawGLLine, this, transform, flags);
-        renderer->addCommand(&_customCommandGLLine);
+        auto customCommand = useTransientCommands ? renderer->generateTransientCustomCommand() : &_customCommandGLLine;
+        customCommand->init(_globalZOrder, transform, flags);
+        customCommand->func = CC_CALLBACK_0(DrawNode::onDrawGLLine, this, transform, flags);
+        renderer->addCommand(customCommand);
     }
 }
 
@@ -328,8 +402,7 @@ void DrawNode::onDraw(const Mat4 &transform, uint32_t /*flags*/)
 
     if (_dirty)
     {
-        glBindBuffer(GL_ARRAY_BUFFER, _vbo);
-        glBufferData(GL_ARRAY_BUFFER, sizeof(V2F_C4B_T2F)*_bufferCapacity, _buffer, GL_STREAM_DRAW);
+        uploadVertices(_vbo, _buffer, _bufferCount, _bufferCapacity, _isStatic);
         
         _dirty = false;
     }
@@ -373,8 +446,7 @@ void DrawNode::onDrawGLLine(const Mat4 &transform, uint32_t /*flags*/)
 
     if (_dirtyGLLine)
     {
-        glBindBuffer(GL_ARRAY_BUFFER, _vboGLLine);
-        glBufferData(GL_ARRAY_BUFFER, sizeof(V2F_C4B_T2F)*_bufferCapacityGLLine, _bufferGLLine, GL_STREAM_DRAW);
+        uploadVertices(_vboGLLine, _bufferGLLine, _bufferCountGLLine, _bufferCapacityGLLine, _isStatic);
         _dirtyGLLine = false;
     }
     if (Configuration::getInstance()->supportsShareableVAO())
@@ -418,8 +490,7 @@ void DrawNode::onDrawGLPoint(const Mat4 &transform, uint32_t /*flags*/)
 
     if (_dirtyGLPoint)
     {
-        glBindBuffer(GL_ARRAY_BUFFER, _vboGLPoint);
-        glBufferData(GL_ARRAY_BUFFER, sizeof(V2F_C4B_T2F)*_bufferCapacityGLPoint, _bufferGLPoint, GL_STREAM_DRAW);
+        uploadVertices(_vboGLPoint, _bufferGLPoint, _bufferCountGLPoint, _bufferCapacityGLPoint, _isStatic);
         
         _dirtyGLPoint = false;
     }
@@ -927,6 +998,57 @@ void DrawNode::clear()
     _lineWidth = _defaultLineWidth;
 }
 
+bool DrawNode::isAxisAlignedRectangle(Rect* rect) const
+{
+    // two triangles
+    if (_bufferCount != 6 || _bufferCountGLLine != 0 || _bufferCountGLPoint != 0)
+    {
+        return false;
+    }
+
+    float minX = _buffer[0].vertices.x, maxX = minX;
+    float minY = _buffer[0].vertices.y, maxY = minY;
+    for (int i = 1; i < 6; ++i)
+    {
+        minX = std::min(minX, _buffer[i].vertices.x);
+        maxX = std::max(maxX, _buffer[i].vertices.x);
+        minY = std::min(minY, _buffer[i].vertices.y);
+        maxY = std::max(maxY, _buffer[i].vertices.y);
+    }
+    if (minX == maxX || minY == maxY)
+    {
+        return false;
+    }
+
+    // every vertex is a corner, and each triangle misses one of two opposite corners
+    int missingCorners = 0;
+    for (int triangle = 0; triangle < 2; ++triangle)
+    {
+        int corners = 0;
+        for (int i = triangle * 3; i < triangle * 3 + 3; ++i)
+        {
+            const auto& vertex = _buffer[i].vertices;
+            if ((vertex.x != minX && vertex.x != maxX) || (vertex.y != minY && vertex.y != maxY))
+            {
+                return false;
+            }
+            corners |= 1 << ((vertex.x == maxX ? 1 : 0) + (vertex.y == maxY ? 2 : 0));
+        }
+        if (corners != 0x7 && corners != 0xb && corners != 0xd && corners != 0xe)
+        {
+            return false;
+        }
+        missingCorners |= ~corners & 0xf;
+    }
+    if (missingCorners != 0x9 && missingCorners != 0x6)
+    {
+        return false;
+    }
+
+    rect->setRect(minX, minY, maxX - minX, maxY - minY);
+    return true;
+}
+
 const BlendFunc& DrawNode::getBlendFunc() const
 {
     return _blendFunc;
@@ -937,6 +1059,28 @@ void DrawNode::setBlendFunc(const BlendFunc &blendFunc)
     _blendFunc = blendFunc;
 }
 
+void DrawNode::setStatic(bool isStatic)
+{
+    if (_isStatic != isStatic)
+    {
+        _isStatic = isStatic;
+        // re-upload with the new usage hint
+        _dirty = true;
+        _dirtyGLLine = true;
+        _dirtyGLPoint = true;
+    }
+}
+
+void DrawNode::setBatchingEnabled(bool enabled)
+{
+    if (_isBatchingEnabled != enabled)
+    {
+        _isBatchingEnabled = enabled;
+        // the VBO isn't updated while batching, and the batched vertices aren't updated while not
+        _dirty = true;
+    }
+}
+
 void DrawNode::setLineWidth(GLfloat lineWidth)
 {
     _lineWidth = lineWidth;
@@ -34,6 +34,7 @@
 #include "2d/CCNode.h"
 #include "base/ccTypes.h"
 #include "renderer/CCCustomCommand.h"
+#include "renderer/CCTrianglesCommand.h"
 #include "math/CCMath.h"
 
 NS_CC_BEGIN
@@ -318,6 +319,42 @@ public:
     // Get CocosStudio guide lines width.
     GLfloat getLineWidth();
 
+    /** Sets whether the geometry of the DrawNode rarely changes, like debug overlays or vector UI.
+     * A static DrawNode uploads its vertices with GL_STATIC_DRAW, only once after each change, and moving it only updates the MVP uniform.
+     * Default is false, the vertices are uploaded with GL_STREAM_DRAW.
+     *
+     * @param isStatic True if the geometry is static.
+     * @since v3.14
+     */
+    void setStatic(bool isStatic);
+    /** Whether the geometry of the DrawNode is static.
+     * @since v3.14
+     */
+    bool isStatic() const { return _isStatic; }
+
+    /** Sets whether the triangles are submitted as a TrianglesCommand instead of a CustomCommand.
+     * Consecutive DrawNodes with the same blend function are then merged by the renderer into a single draw call.
+     * The renderer transforms the vertices on the CPU, so it suits static DrawNodes with few vertices.
+     * Points and GL lines are still drawn by a CustomCommand.
+     * Default is false.
+     *
+     * @param enabled True to batch the triangles.
+     * @since v3.14
+     */
+    void setBatchingEnabled(bool enabled);
+    /** Whether the triangles are batched by the renderer.
+     * @since v3.14
+     */
+    bool isBatchingEnabled() const { return _isBatchingEnabled; }
+
+    /** Whether the node only draws a filled rectangle aligned with its axes, eg: with drawSolidRect().
+     * ClippingNode uses it to clip with the scissor test instead of the stencil buffer.
+     *
+     * @param rect Where the rectangle is stored, in the node space.
+     * @since v3.14
+     */
+    bool isAxisAlignedRectangle(Rect* rect) const;
+
 CC_CONSTRUCTOR_ACCESS:
     DrawNode(GLfloat lineWidth = DEFAULT_LINE_WIDTH);
     virtual ~DrawNode();
@@ -327,6 +364,7 @@ protected:
     void ensureCapacity(int count);
     void ensureCapacityGLPoint(int count);
     void ensureCapacityGLLine(int count);
+    void updateBatchedTriangles();
 
     GLuint      _vao;
     GLuint      _vbo;
@@ -361,6 +399,15 @@ protected:
     GLfloat         _lineWidth;
 
     GLfloat  _defaultLineWidth;
+
+    bool        _isStatic;
+    bool        _isBatchingEnabled;
+    GLubyte     _batchedOpacity;
+    std::vector<V3F_C4B_T2F> _batchedVertices;
+    std::vector<unsigned short> _batchedIndices;
+    TrianglesCommand _trianglesCommand;
+    // Renderer::getQueueGeneration() when the own commands were added
+    unsigned int _drawnQueueGeneration;
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(DrawNode);
 };
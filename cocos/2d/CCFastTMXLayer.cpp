@@ -123,6 +123,8 @@ TMXLayer::TMXLayer()
 , _vertexBuffer(nullptr)
 , _vData(nullptr)
 , _indexBuffer(nullptr)
+, _chunkSize(0)
+, _chunksPerRow(0)
 {
 }
 
@@ -134,11 +136,17 @@ TMXLayer::~TMXLayer()
     CC_SAFE_RELEASE(_vData);
     CC_SAFE_RELEASE(_vertexBuffer);
     CC_SAFE_RELEASE(_indexBuffer);
-    
+    releaseChunks();
 }
 
 void TMXLayer::draw(Renderer *renderer, const Mat4& transform, uint32_t flags)
 {
+    if (_chunkSize > 0)
+    {
+        drawChunks(renderer, transform, flags);
+        return;
+    }
+
     updateTotalQuads();
 
     bool isViewProjectionUpdated = true;
@@ -150,17 +158,7 @@ void TMXLayer::draw(Renderer *renderer, const Mat4& transform, uint32_t flags)
     
     if( flags != 0 || _dirty || _quadsDirty || isViewProjectionUpdated)
     {
-        Size s = Director::getInstance()->getVisibleSize();
-        auto rect = Rect(Camera::getVisitingCamera()->getPositionX() - s.width * 0.5f,
-                     Camera::getVisitingCamera()->getPositionY() - s.height * 0.5f,
-                     s.width,
-                     s.height);
-        
-        Mat4 inv = transform;
-        inv.inverse();
-        rect = RectApplyTransform(rect, inv);
-        
-        updateTiles(rect);
+        updateTiles(getCullingRect(transform));
         updateIndexBuffer();
         updatePrimitives();
         _dirty = false;
@@ -196,7 +194,20 @@ void TMXLayer::onDraw(Primitive *primitive)
     CC_INCREMENT_GL_DRAWN_BATCHES_AND_VERTICES(1, primitive->getCount() * 4);
 }
 
-void TMXLayer::updateTiles(const Rect& culledRect)
+Rect TMXLayer::getCullingRect(const Mat4& transform) const
+{
+    Size s = Director::getInstance()->getVisibleSize();
+    auto rect = Rect(Camera::getVisitingCamera()->getPositionX() - s.width * 0.5f,
+                 Camera::getVisitingCamera()->getPositionY() - s.height * 0.5f,
+                 s.width,
+                 s.height);
+    
+    Mat4 inv = transform;
+    inv.inverse();
+    return RectApplyTransform(rect, inv);
+}
+
+void TMXLayer::getTileRangeForRect(const Rect& culledRect, int& xBegin, int& xEnd, int& yBegin, int& yEnd) const
 {
     Rect visibleTiles = Rect(culledRect.origin, culledRect.size * Director::getInstance()->getContentScaleFactor());
     Size mapTileSize = CC_SIZE_PIXELS_TO_POINTS(_mapTileSize);
@@ -242,6 +253,17 @@ void TMXLayer::updateTiles(const Rect& culledRect)
         //CCASSERT(0, "TMX invalid value");
     }
     
+    yBegin = std::max(0.f,visibleTiles.origin.y - tilesOverY);
+    yEnd = std::min(_layerSize.height,visibleTiles.origin.y + visibleTiles.size.height + tilesOverY);
+    xBegin = std::max(0.f,visibleTiles.origin.x - tilesOverX);
+    xEnd = std::min(_layerSize.width,visibleTiles.origin.x + visibleTiles.size.width + tilesOverX);
+}
+
+void TMXLayer::updateTiles(const Rect& culledRect)
+{
+    int xBegin, xEnd, yBegin, yEnd;
+    getTileRangeForRect(culledRect, xBegin, xEnd, yBegin, yEnd);
+    
     _indicesVertexZNumber.clear();
     
     for(const auto& iter : _indicesVertexZOffsets)
@@ -249,11 +271,6 @@ void TMXLayer::updateTiles(const Rect& culledRect)
         _indicesVertexZNumber[iter.first] = iter.second;
     }
     
-    int yBegin = std::max(0.f,visibleTiles.origin.y - tilesOverY);
-    int yEnd = std::min(_layerSize.height,visibleTiles.origin.y + visibleTiles.size.height + tilesOverY);
-    int xBegin = std::max(0.f,visibleTiles.origin.x - tilesOverX);
-    int xEnd = std::min(_layerSize.width,visibleTiles.origin.x + visibleTiles.size.width + tilesOverX);
-    
     for (int y =  yBegin; y < yEnd; ++y)
     {
         for (int x = xBegin; x < xEnd; ++x)
@@ -440,12 +457,95 @@ void TMXLayer::updatePrimitives()
     }
 }
 
+void TMXLayer::setupQuad(V3F_C4B_T2F_Quad& quad, int x, int y, uint32_t tileGID, int z)
+{
+    Size tileSize = CC_SIZE_PIXELS_TO_POINTS(_tileSet->_tileSize);
+    Size texSize = _tileSet->_imageSize;
+    
+    Vec3 nodePos(float(x), float(y), 0);
+    _tileToNodeTransform.transformPoint(&nodePos);
+    
+    float left, right, top, bottom;
+    
+    // vertices
+    if (tileGID & kTMXTileDiagonalFlag)
+    {
+        left = nodePos.x;
+        right = nodePos.x + tileSize.height;
+        bottom = nodePos.y + tileSize.width;
+        top = nodePos.y;
+    }
+    else
+    {
+        left = nodePos.x;
+        right = nodePos.x + tileSize.width;
+        bottom = nodePos.y + tileSize.height;
+        top = nodePos.y;
+    }
+    
+    if(tileGID & kTMXTileVerticalFlag)
+        std::swap(top, bottom);
+    if(tileGID & kTMXTileHorizontalFlag)
+        std::swap(left, right);
+    
+    if(tileGID & kTMXTileDiagonalFlag)
+    {
+        // FIXME: not working correctly
+        quad.bl.vertices.x = left;
+        quad.bl.vertices.y = bottom;
+        quad.bl.vertices.z = z;
+        quad.br.vertices.x = left;
+        quad.br.vertices.y = top;
+        quad.br.vertices.z = z;
+        quad.tl.vertices.x = right;
+        quad.tl.vertices.y = bottom;
+        quad.tl.vertices.z = z;
+        quad.tr.vertices.x = right;
+        quad.tr.vertices.y = top;
+        quad.tr.vertices.z = z;
+    }
+    else
+    {
+        quad.bl.vertices.x = left;
+        quad.bl.vertices.y = bottom;
+        quad.bl.vertices.z = z;
+        quad.br.vertices.x = right;
+        quad.br.vertices.y = bottom;
+        quad.br.vertices.z = z;
+        quad.tl.vertices.x = left;
+        quad.tl.vertices.y = top;
+        quad.tl.vertices.z = z;
+        quad.tr.vertices.x = right;
+        quad.tr.vertices.y = top;
+        quad.tr.vertices.z = z;
+    }
+    
+    // texcoords
+    Rect tileTexture = _tileSet->getRectForGID(tileGID);
+    left   = (tileTexture.origin.x / texSize.width);
+    right  = left + (tileTexture.size.width / texSize.width);
+    bottom = (tileTexture.origin.y / texSize.height);
+    top    = bottom + (tileTexture.size.height / texSize.height);
+    
+    quad.bl.texCoords.u = left;
+    quad.bl.texCoords.v = bottom;
+    quad.br.texCoords.u = right;
+    quad.br.texCoords.v = bottom;
+    quad.tl.texCoords.u = left;
+    quad.tl.texCoords.v = top;
+    quad.tr.texCoords.u = right;
+    quad.tr.texCoords.v = top;
+    
+    quad.bl.colors = Color4B::WHITE;
+    quad.br.colors = Color4B::WHITE;
+    quad.tl.colors = Color4B::WHITE;
+    quad.tr.colors = Color4B::WHITE;
+}
+
 void TMXLayer::updateTotalQuads()
 {
     if(_quadsDirty)
     {
-        Size tileSize = CC_SIZE_PIXELS_TO_POINTS(_tileSet->_tileSize);
-        Size texSize = _tileSet->_imageSize;
         _tileToQuadIndex.clear();
         _totalQuads.resize(int(_layerSize.width * _layerSize.height));
         _indices.resize(6 * int(_layerSize.width * _layerSize.height));
@@ -464,14 +564,7 @@ void TMXLayer::updateTotalQuads()
                 
                 _tileToQuadIndex[tileIndex] = quadIndex;
                 
-                auto& quad = _totalQuads[quadIndex];
-                
-                Vec3 nodePos(float(x), float(y), 0);
-                _tileToNodeTransform.transformPoint(&nodePos);
-                
-                float left, right, top, bottom, z;
-                
-                z = getVertexZForPos(Vec2(x, y));
+                int z = getVertexZForPos(Vec2(x, y));
                 auto iter = _indicesVertexZOffsets.find(z);
                 if(iter == _indicesVertexZOffsets.end())
                 {
@@ -481,79 +574,7 @@ void TMXLayer::updateTotalQuads()
                 {
                     iter->second++;
                 }
-                // vertices
-                if (tileGID & kTMXTileDiagonalFlag)
-                {
-                    left = nodePos.x;
-                    right = nodePos.x + tileSize.height;
-                    bottom = nodePos.y + tileSize.width;
-                    top = nodePos.y;
-                }
-                else
-                {
-                    left = nodePos.x;
-                    right = nodePos.x + tileSize.width;
-                    bottom = nodePos.y + tileSize.height;
-                    top = nodePos.y;
-                }
-                
-                if(tileGID & kTMXTileVerticalFlag)
-                    std::swap(top, bottom);
-                if(tileGID & kTMXTileHorizontalFlag)
-                    std::swap(left, right);
-                
-                if(tileGID & kTMXTileDiagonalFlag)
-                {
-                    // FIXME: not working correctly
-                    quad.bl.vertices.x = left;
-                    quad.bl.vertices.y = bottom;
-                    quad.bl.vertices.z = z;
-                    quad.br.vertices.x = left;
-                    quad.br.vertices.y = top;
-                    quad.br.vertices.z = z;
-                    quad.tl.vertices.x = right;
-                    quad.tl.vertices.y = bottom;
-                    quad.tl.vertices.z = z;
-                    quad.tr.vertices.x = right;
-                    quad.tr.vertices.y = top;
-                    quad.tr.vertices.z = z;
-                }
-                else
-                {
-                    quad.bl.vertices.x = left;
-                    quad.bl.vertices.y = bottom;
-                    quad.bl.vertices.z = z;
-                    quad.br.vertices.x = right;
-                    quad.br.vertices.y = bottom;
-                    quad.br.vertices.z = z;
-                    quad.tl.vertices.x = left;
-                    quad.tl.vertices.y = top;
-                    quad.tl.vertices.z = z;
-                    quad.tr.vertices.x = right;
-                    quad.tr.vertices.y = top;
-                    quad.tr.vertices.z = z;
-                }
-                
-                // texcoords
-                Rect tileTexture = _tileSet->getRectForGID(tileGID);
-                left   = (tileTexture.origin.x / texSize.width);
-                right  = left + (tileTexture.size.width / texSize.width);
-                bottom = (tileTexture.origin.y / texSize.height);
-                top    = bottom + (tileTexture.size.height / texSize.height);
-                
-                quad.bl.texCoords.u = left;
-                quad.bl.texCoords.v = bottom;
-                quad.br.texCoords.u = right;
-                quad.br.texCoords.v = bottom;
-                quad.tl.texCoords.u = left;
-                quad.tl.texCoords.v = top;
-                quad.tr.texCoords.u = right;
-                quad.tr.texCoords.v = top;
-                
-                quad.bl.colors = Color4B::WHITE;
-                quad.br.colors = Color4B::WHITE;
-                quad.tl.colors = Color4B::WHITE;
-                quad.tr.colors = Color4B::WHITE;
+                setupQuad(_totalQuads[quadIndex], x, y, tileGID, z);
                 
                 ++quadIndex;
             }
@@ -571,6 +592,215 @@ void TMXLayer::updateTotalQuads()
     }
 }
 
+// FastTMXLayer - chunks
+TMXLayer::Chunk::Chunk()
+: dirty(true)
+, vertexBuffer(nullptr)
+, vData(nullptr)
+, indexBuffer(nullptr)
+{
+}
+
+void TMXLayer::setChunkSize(int chunkSize)
+{
+    // the quads of a chunk have to be addressable by unsigned short indices
+    chunkSize = std::min(std::max(chunkSize, 0), 128);
+    if (_chunkSize == chunkSize) return;
+
+    releaseChunks();
+    _chunkSize = chunkSize;
+    _quadsDirty = true;
+    _dirty = true;
+}
+
+void TMXLayer::setupChunks()
+{
+    // the chunks don't use the buffers of the whole layer
+    std::vector<V3F_C4B_T2F_Quad>().swap(_totalQuads);
+    std::vector<int>().swap(_tileToQuadIndex);
+    _indices.clear();
+    _indices.shrink_to_fit();
+    _indicesVertexZOffsets.clear();
+    _indicesVertexZNumber.clear();
+    _primitives.clear();
+    CC_SAFE_RELEASE_NULL(_vData);
+    CC_SAFE_RELEASE_NULL(_vertexBuffer);
+    CC_SAFE_RELEASE_NULL(_indexBuffer);
+
+    releaseChunks();
+    _chunksPerRow = (static_cast<int>(_layerSize.width) + _chunkSize - 1) / _chunkSize;
+    int chunksPerColumn = (static_cast<int>(_layerSize.height) + _chunkSize - 1) / _chunkSize;
+    _chunks.resize(_chunksPerRow * chunksPerColumn);
+}
+
+void TMXLayer::releaseChunk(Chunk& chunk)
+{
+    for (auto& iter : chunk.primitives)
+    {
+        iter.second->release();
+    }
+    chunk.primitives.clear();
+    CC_SAFE_RELEASE_NULL(chunk.vData);
+    CC_SAFE_RELEASE_NULL(chunk.vertexBuffer);
+    CC_SAFE_RELEASE_NULL(chunk.indexBuffer);
+}
+
+void TMXLayer::releaseChunks()
+{
+    for (auto& chunk : _chunks)
+    {
+        releaseChunk(chunk);
+    }
+    _chunks.clear();
+}
+
+void TMXLayer::buildChunk(Chunk& chunk, int chunkX, int chunkY)
+{
+    releaseChunk(chunk);
+    chunk.dirty = false;
+
+    int xBegin = chunkX * _chunkSize;
+    int xEnd = std::min(xBegin + _chunkSize, static_cast<int>(_layerSize.width));
+    int yBegin = chunkY * _chunkSize;
+    int yEnd = std::min(yBegin + _chunkSize, static_cast<int>(_layerSize.height));
+
+    // the quads are sorted by vertexZ, so that every vertexZ is drawn by one primitive
+    std::map<int/*vertexZ*/, int/*number of quads, then offset*/> vertexZOffsets;
+    for (int y = yBegin; y < yEnd; ++y)
+    {
+        for (int x = xBegin; x < xEnd; ++x)
+        {
+            if (_tiles[getTileIndexByPos(x, y)] != 0)
+            {
+                ++vertexZOffsets[getVertexZForPos(Vec2(x, y))];
+            }
+        }
+    }
+
+    int quadCount = 0;
+    for (auto& iter : vertexZOffsets)
+    {
+        chunk.primitives.push_back(std::make_pair(iter.first, nullptr));
+        std::swap(quadCount, iter.second);
+        quadCount += iter.second;
+    }
+    if (quadCount == 0) return;
+
+    std::vector<V3F_C4B_T2F_Quad> quads(quadCount);
+    chunk.tileToQuadIndex.assign(_chunkSize * _chunkSize, -1);
+    for (int y = yBegin; y < yEnd; ++y)
+    {
+        for (int x = xBegin; x < xEnd; ++x)
+        {
+            uint32_t tileGID = _tiles[getTileIndexByPos(x, y)];
+            if (tileGID == 0) continue;
+
+            int z = getVertexZForPos(Vec2(x, y));
+            int quadIndex = vertexZOffsets[z]++;
+            chunk.tileToQuadIndex[(x - xBegin) + (y - yBegin) * _chunkSize] = quadIndex;
+            setupQuad(quads[quadIndex], x, y, tileGID, z);
+        }
+    }
+
+    std::vector<GLushort> indices(quadCount * 6);
+    for (int i = 0; i < quadCount; ++i)
+    {
+        indices[6 * i + 0] = i * 4 + 0;
+        indices[6 * i + 1] = i * 4 + 1;
+        indices[6 * i + 2] = i * 4 + 2;
+        indices[6 * i + 3] = i * 4 + 3;
+        indices[6 * i + 4] = i * 4 + 2;
+        indices[6 * i + 5] = i * 4 + 1;
+    }
+
+    GL::bindVAO(0);
+    chunk.vertexBuffer = VertexBuffer::create(sizeof(V3F_C4B_T2F), quadCount * 4);
+    chunk.vertexBuffer->retain();
+    chunk.vertexBuffer->updateVertices(quads.data(), quadCount * 4, 0);
+    chunk.vData = VertexData::create();
+    chunk.vData->retain();
+    chunk.vData->setStream(chunk.vertexBuffer, VertexStreamAttribute(0, GLProgram::VERTEX_ATTRIB_POSITION, GL_FLOAT, 3));
+    chunk.vData->setStream(chunk.vertexBuffer, VertexStreamAttribute(offsetof(V3F_C4B_T2F, colors), GLProgram::VERTEX_ATTRIB_COLOR, GL_UNSIGNED_BYTE, 4, true));
+    chunk.vData->setStream(chunk.vertexBuffer, VertexStreamAttribute(offsetof(V3F_C4B_T2F, texCoords), GLProgram::VERTEX_ATTRIB_TEX_COORD, GL_FLOAT, 2));
+    chunk.indexBuffer = IndexBuffer::create(IndexBuffer::IndexType::INDEX_TYPE_SHORT_16, quadCount * 6);
+    chunk.indexBuffer->retain();
+    chunk.indexBuffer->updateIndices(indices.data(), quadCount * 6, 0);
+
+    int start = 0;
+    for (auto& iter : chunk.primitives)
+    {
+        // vertexZOffsets now holds the end of every vertexZ
+        int end = vertexZOffsets[iter.first];
+        auto primitive = Primitive::create(chunk.vData, chunk.indexBuffer, GL_TRIANGLES);
+        primitive->setStart(start * 6);
+        primitive->setCount((end - start) * 6);
+        primitive->retain();
+        iter.second = primitive;
+        start = end;
+    }
+    chunk.renderCommands.resize(chunk.primitives.size());
+}
+
+void TMXLayer::updateChunkTile(int tileIndex, uint32_t oldGID)
+{
+    if (_quadsDirty) return;
+
+    int x = tileIndex % static_cast<int>(_layerSize.width);
+    int y = tileIndex / static_cast<int>(_layerSize.width);
+    Chunk& chunk = _chunks[x / _chunkSize + (y / _chunkSize) * _chunksPerRow];
+    if (chunk.dirty) return;
+
+    uint32_t tileGID = _tiles[tileIndex];
+    if (oldGID != 0 && tileGID != 0)
+    {
+        // the tile keeps its quad, only upload that quad
+        int quadIndex = chunk.tileToQuadIndex[(x % _chunkSize) + (y % _chunkSize) * _chunkSize];
+        V3F_C4B_T2F_Quad quad;
+        setupQuad(quad, x, y, tileGID, getVertexZForPos(Vec2(x, y)));
+        chunk.vertexBuffer->updateVertices(&quad, 4, quadIndex * 4);
+    }
+    else
+    {
+        // a quad is added or removed, rebuild the chunk the next time it is visible
+        chunk.dirty = true;
+    }
+}
+
+void TMXLayer::drawChunks(Renderer *renderer, const Mat4& transform, uint32_t flags)
+{
+    if (_quadsDirty)
+    {
+        setupChunks();
+        _quadsDirty = false;
+    }
+    _dirty = false;
+
+    int xBegin, xEnd, yBegin, yEnd;
+    getTileRangeForRect(getCullingRect(transform), xBegin, xEnd, yBegin, yEnd);
+    if (xBegin >= xEnd || yBegin >= yEnd) return;
+
+    auto blendfunc = _texture->hasPremultipliedAlpha() ? BlendFunc::ALPHA_PREMULTIPLIED : BlendFunc::ALPHA_NON_PREMULTIPLIED;
+    for (int chunkY = yBegin / _chunkSize; chunkY <= (yEnd - 1) / _chunkSize; ++chunkY)
+    {
+        for (int chunkX = xBegin / _chunkSize; chunkX <= (xEnd - 1) / _chunkSize; ++chunkX)
+        {
+            Chunk& chunk = _chunks[chunkX + chunkY * _chunksPerRow];
+            if (chunk.dirty)
+            {
+                buildChunk(chunk, chunkX, chunkY);
+            }
+
+            for (size_t i = 0; i < chunk.primitives.size(); ++i)
+            {
+                auto& cmd = chunk.renderCommands[i];
+                const auto& iter = chunk.primitives[i];
+                cmd.init(iter.first, _texture->getName(), getGLProgramState(), blendfunc, iter.second, _modelViewTransform, flags);
+                renderer->addCommand(&cmd);
+            }
+        }
+    }
+}
+
 // removing / getting tiles
 Sprite* TMXLayer::getTileAt(const Vec2& tileCoordinate)
 {
@@ -700,7 +930,13 @@ void TMXLayer::removeTileAt(const Vec2& tileCoordinate)
 void TMXLayer::setFlaggedTileGIDByIndex(int index, uint32_t gid)
 {
     if(gid == _tiles[index]) return;
+    uint32_t oldGID = _tiles[index];
     _tiles[index] = gid;
+    if (_chunkSize > 0)
+    {
+        updateChunkTile(index, oldGID);
+        return;
+    }
     _quadsDirty = true;
     _dirty = true;
 }
@@ -727,6 +963,12 @@ Value TMXLayer::getProperty(const std::string& propertyName) const
 
 void TMXLayer::parseInternalProperties()
 {
+    auto chunkSize = getProperty("cc_chunk_size");
+    if (!chunkSize.isNull())
+    {
+        setChunkSize(chunkSize.asInt());
+    }
+
     auto vertexz = getProperty("cc_vertexz");
     if (vertexz.isNull()) return;
     
@@ -68,6 +68,9 @@ namespace experimental{
  * "value" by default is 0, but you can change it from Tiled by adding the "cc_alpha_func" property to the layer.
  * The value 0 should work for most cases, but if you have tiles that are semi-transparent, then you might want to use a different
  * value, like 0.5.
+
+ * If the layer contains a property named "cc_chunk_size" with an integer, the layer is drawn in chunks of that many tiles per side,
+ * see setChunkSize().
  
  * For further information, please see the programming guide:
  * http://www.cocos2d-iphone.org/wiki/doku.php/prog_guide:tiled_maps
@@ -263,6 +266,22 @@ public:
      */
     void setupTileSprite(Sprite* sprite, const Vec2& pos, uint32_t gid);
 
+    /** Splits the layer into square chunks of chunkSize x chunkSize tiles, each one with its own static vertex and index buffer.
+     * A chunk is only built the first time it becomes visible, and chunks outside of the camera are culled,
+     * so moving the camera doesn't rebuild any buffer. Changing a tile only updates the quad of that tile,
+     * or rebuilds its chunk if the tile is added or removed. Suits big maps where most of the layer is off screen.
+     * Default is 0, the whole layer shares one vertex buffer and the indices of the visible tiles are rebuilt when the view changes.
+     *
+     * @param chunkSize The number of tiles per side of a chunk, at most 128. 0 disables the chunks.
+     * @since v3.14
+     */
+    void setChunkSize(int chunkSize);
+
+    /** Gets the number of tiles per side of a chunk, 0 if the layer isn't drawn in chunks.
+     * @since v3.14
+     */
+    int getChunkSize() const { return _chunkSize; }
+
     //
     // Override
     //
@@ -296,6 +315,30 @@ protected:
     void updateVertexBuffer();
     void updateIndexBuffer();
     void updatePrimitives();
+
+    Rect getCullingRect(const Mat4& transform) const;
+    void getTileRangeForRect(const Rect& culledRect, int& xBegin, int& xEnd, int& yBegin, int& yEnd) const;
+    void setupQuad(V3F_C4B_T2F_Quad& quad, int x, int y, uint32_t tileGID, int z);
+
+    struct Chunk
+    {
+        Chunk();
+
+        bool dirty;
+        std::vector<int> tileToQuadIndex;
+        VertexBuffer* vertexBuffer;
+        VertexData* vData;
+        IndexBuffer* indexBuffer;
+        std::vector<std::pair<int/*vertexZ*/, Primitive*> > primitives;
+        std::vector<PrimitiveCommand> renderCommands;
+    };
+
+    void drawChunks(Renderer *renderer, const Mat4& transform, uint32_t flags);
+    void setupChunks();
+    void buildChunk(Chunk& chunk, int chunkX, int chunkY);
+    void releaseChunk(Chunk& chunk);
+    void releaseChunks();
+    void updateChunkTile(int tileIndex, uint32_t oldGID);
 protected:
     
     //! name of the layer
@@ -351,6 +394,10 @@ protected:
     IndexBuffer* _indexBuffer;
     
     Map<int , Primitive*> _primitives;
+
+    int _chunkSize;
+    int _chunksPerRow;
+    std::vector<Chunk> _chunks;
     
 public:
     /** Possible orientations of the TMX map */
@@ -24,6 +24,7 @@
  ****************************************************************************/
 
 #include "2d/CCFontAtlas.h"
+#include <algorithm>
 #if CC_TARGET_PLATFORM != CC_PLATFORM_WIN32 && CC_TARGET_PLATFORM != CC_PLATFORM_WINRT && CC_TARGET_PLATFORM != CC_PLATFORM_ANDROID
 #include <iconv.h>
 #elif CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID
@@ -35,23 +36,54 @@
 #include "base/CCEventListenerCustom.h"
 #include "base/CCEventDispatcher.h"
 #include "base/CCEventType.h"
+#include "base/CCData.h"
+#include "base/CCAsyncTaskPool.h"
+#include "platform/CCFileUtils.h"
 
 NS_CC_BEGIN
 
+namespace
+{
+    // version of the glyph cache files, to change with their layout
+    const char GLYPH_CACHE_MAGIC[4] = { 'C', 'C', 'G', 'A' };
+    const int GLYPH_CACHE_VERSION = 2;
+
+    template<typename T>
+    void writeGlyphCacheValue(std::vector<unsigned char>& out, const T& value)
+    {
+        const unsigned char* bytes = reinterpret_cast<const unsigned char*>(&value);
+        out.insert(out.end(), bytes, bytes + sizeof(T));
+    }
+
+    template<typename T>
+    bool readGlyphCacheValue(const unsigned char*& in, const unsigned char* end, T& value)
+    {
+        if (end - in < (ssize_t)sizeof(T))
+            return false;
+        memcpy(&value, in, sizeof(T));
+        in += sizeof(T);
+        return true;
+    }
+}
+
 const int FontAtlas::CacheTextureWidth = 512;
 const int FontAtlas::CacheTextureHeight = 512;
 const char* FontAtlas::CMD_PURGE_FONTATLAS = "__cc_PURGE_FONTATLAS";
 const char* FontAtlas::CMD_RESET_FONTATLAS = "__cc_RESET_FONTATLAS";
+const char* FontAtlas::CMD_UPDATE_FONTATLAS = "__cc_UPDATE_FONTATLAS";
 
 FontAtlas::FontAtlas(Font &theFont) 
 : _font(&theFont)
 , _fontFreeType(nullptr)
 , _iconv(nullptr)
 , _currentPageData(nullptr)
+, _useStamp(0)
+, _maxPageCount(0)
 , _fontAscender(0)
 , _rendererRecreatedListener(nullptr)
 , _antialiasEnabled(true)
-, _currLineHeight(0)
+, _glyphCacheDirty(false)
+, _asyncRasterizationEnabled(false)
 {
     _font->retain();
 
@@ -60,9 +92,7 @@ FontAtlas::FontAtlas(Font &theFont)
     {
         _lineHeight = _font->getFontMaxHeight();
         _fontAscender = _fontFreeType->getFontAscender();
-        _currentPage = 0;
-        _currentPageOrigX = 0;
-        _currentPageOrigY = 0;
+        resetPages();
         _letterEdgeExtend = 2;
         _letterPadding = 0;
 
@@ -141,13 +171,25 @@ void FontAtlas::reset()
 {
     releaseTextures();
     
-    _currLineHeight = 0;
-    _currentPage = 0;
-    _currentPageOrigX = 0;
-    _currentPageOrigY = 0;
+    resetPages();
     _letterDefinitions.clear();
+    _glyphCacheDirty = false;
     
     reinit();
+
+    // the glyphs saved before are still valid, e.g. when the renderer was recreated
+    if (!_glyphCacheFile.empty())
+    {
+        loadGlyphCache();
+    }
+}
+
+void FontAtlas::resetPages()
+{
+    _currentPage = 0;
+    _skyline.assign(1, SkylineNode{ 0, 0, CacheTextureWidth });
+    _pagesLastUse.assign(1, 0);
+    _fullPagesData.clear();
 }
 
 void FontAtlas::releaseTextures()
@@ -309,6 +351,11 @@ void FontAtlas::findNewCharacters(const std::u32string& u32Text, std::unordered_
             {
                 newChars.push_back(u32Text[i]);
             }
+            else if (outIterator->second.height > 0 && outIterator->second.textureID < (int)_pagesLastUse.size())
+            {
+                // the page can't be reused while the glyph is displayed
+                _pagesLastUse[outIterator->second.textureID] = _useStamp;
+            }
         }
     }
 
@@ -343,30 +390,144 @@ bool FontAtlas::prepareLetterDefinitions(const std::u32string& utf32Text)
         return false;
     } 
     
+    _useStamp = Director::getInstance()->getTotalFrames();
+
     std::unordered_map<unsigned int, unsigned int> codeMapOfNewChar;
     findNewCharacters(utf32Text, codeMapOfNewChar);
+    if (!_pendingGlyphs.empty())
+    {
+        for (auto it = codeMapOfNewChar.begin(); it != codeMapOfNewChar.end();)
+        {
+            if (_pendingGlyphs.find(it->first) != _pendingGlyphs.end())
+                it = codeMapOfNewChar.erase(it);
+            else
+                ++it;
+        }
+    }
     if (codeMapOfNewChar.empty())
     {
         return false;
     }
 
+    if (_asyncRasterizationEnabled)
+    {
+        rasterizeGlyphsAsync(codeMapOfNewChar);
+        return false;
+    }
+
+    std::vector<GlyphBitmap> glyphs(codeMapOfNewChar.size());
+    size_t index = 0;
+    for (auto&& it : codeMapOfNewChar)
+    {
+        auto& glyph = glyphs[index++];
+        glyph.utf32Char = it.first;
+        glyph.charCode = it.second;
+        glyph.pixels = _fontFreeType->rasterizeGlyph(it.second, glyph.width, glyph.height, glyph.rect, glyph.xAdvance);
+    }
+    if (addGlyphs(glyphs))
+    {
+        Director::getInstance()->getEventDispatcher()->dispatchCustomEvent(CMD_UPDATE_FONTATLAS, this);
+    }
+
+    return true;
+}
+
+void FontAtlas::rasterizeGlyphsAsync(const std::unordered_map<unsigned int, unsigned int>& charCodeMap)
+{
+    auto glyphs = std::make_shared<std::vector<GlyphBitmap>>(charCodeMap.size());
+    size_t index = 0;
+    for (auto&& it : charCodeMap)
+    {
+        auto& glyph = (*glyphs)[index++];
+        glyph.utf32Char = it.first;
+        glyph.charCode = it.second;
+        glyph.pixels = nullptr;
+        _pendingGlyphs.insert(it.first);
+    }
+
+    // the atlas, and the font it retains, are used by the job until the glyphs were added
+    this->retain();
+    auto jobSystem = JobSystem::getInstance();
+    auto job = jobSystem->schedule([this, glyphs]() {
+        for (auto&& glyph : *glyphs)
+        {
+            glyph.pixels = _fontFreeType->rasterizeGlyph(glyph.charCode, glyph.width, glyph.height, glyph.rect, glyph.xAdvance);
+        }
+    });
+    jobSystem->scheduleOnCocosThread([this, glyphs]() {
+        for (auto&& glyph : *glyphs)
+        {
+            _pendingGlyphs.erase(glyph.utf32Char);
+        }
+        addGlyphs(*glyphs);
+        Director::getInstance()->getEventDispatcher()->dispatchCustomEvent(CMD_UPDATE_FONTATLAS, this);
+        this->release();
+    }, { job });
+}
+
+bool FontAtlas::addGlyphs(std::vector<GlyphBitmap>& glyphs)
+{
     int adjustForDistanceMap = _letterPadding / 2;
     int adjustForExtend = _letterEdgeExtend / 2;
-    long bitmapWidth;
-    long bitmapHeight;
-    int glyphHeight;
-    Rect tempRect;
     FontLetterDefinition tempDef;
 
     auto scaleFactor = CC_CONTENT_SCALE_FACTOR();
     auto  pixelFormat = _fontFreeType->getOutlineSize() > 0 ? Texture2D::PixelFormat::AI88 : Texture2D::PixelFormat::A8;
+    int bytesPerPixel = pixelFormat == Texture2D::PixelFormat::AI88 ? 2 : 1;
 
-    float startY = _currentPageOrigY;
+    bool pageEvicted = false;
+    int dirtyTop = CacheTextureHeight;
+    int dirtyBottom = 0;
+    auto updateDirtyRows = [&]() {
+        if (dirtyBottom > dirtyTop)
+        {
+            _atlasTextures[_currentPage]->updateWithData(_currentPageData + CacheTextureWidth * dirtyTop * bytesPerPixel,
+                0, dirtyTop, CacheTextureWidth, dirtyBottom - dirtyTop);
+        }
+        dirtyTop = CacheTextureHeight;
+        dirtyBottom = 0;
+    };
 
-    for (auto&& it : codeMapOfNewChar)
+    _useStamp = Director::getInstance()->getTotalFrames();
+
+    for (auto&& glyph : glyphs)
     {
-        auto bitmap = _fontFreeType->getGlyphBitmap(it.second, bitmapWidth, bitmapHeight, tempRect, tempDef.xAdvance);
-        if (bitmap && bitmapWidth > 0 && bitmapHeight > 0)
+        // e.g. the glyph cache was restored while the glyph was rasterized
+        if (_letterDefinitions.find(glyph.utf32Char) != _letterDefinitions.end())
+        {
+            delete [] glyph.pixels;
+            glyph.pixels = nullptr;
+            continue;
+        }
+
+        tempDef.xAdvance = glyph.xAdvance;
+
+        // the distance field already includes the padding, one more pixel separates the glyphs
+        int posX = 0;
+        int posY = 0;
+        size_t skylineIndex = 0;
+        auto& tempRect = glyph.rect;
+        int packedWidth = std::max((int)glyph.width + _letterEdgeExtend,
+            (int)ceilf(tempRect.size.width) + _letterPadding + _letterEdgeExtend) + 1;
+        int packedHeight = std::max((int)glyph.height + _letterEdgeExtend,
+            (int)ceilf(tempRect.size.height) + _letterPadding + _letterEdgeExtend) + 1;
+        if (glyph.pixels && !findSkylinePosition(packedWidth, packedHeight, posX, posY, skylineIndex))
+        {
+            bool pageEmpty = _skyline.size() == 1 && _skyline[0].y == 0;
+            if (!pageEmpty)
+            {
+                updateDirtyRows();
+                pageEvicted |= startNewPage();
+            }
+            if (!findSkylinePosition(packedWidth, packedHeight, posX, posY, skylineIndex))
+            {
+                CCLOG("FontAtlas: the glyph %u doesn't fit in a page", (unsigned int)glyph.utf32Char);
+                delete [] glyph.pixels;
+                glyph.pixels = nullptr;
+            }
+        }
+
+        if (glyph.pixels)
         {
             tempDef.validDefinition = true;
             tempDef.width = tempRect.size.width + _letterPadding + _letterEdgeExtend;
@@ -374,56 +535,23 @@ bool FontAtlas::prepareLetterDefinitions(const std::u32string& utf32Text)
             tempDef.offsetX = tempRect.origin.x - adjustForDistanceMap - adjustForExtend;
             tempDef.offsetY = _fontAscender + tempRect.origin.y - adjustForDistanceMap - adjustForExtend;
 
-            if (_currentPageOrigX + tempDef.width > CacheTextureWidth)
-            {
-                _currentPageOrigY += _currLineHeight;
-                _currLineHeight = 0;
-                _currentPageOrigX = 0;
-                if (_currentPageOrigY + _lineHeight + _letterPadding + _letterEdgeExtend >= CacheTextureHeight)
-                {
-                    unsigned char *data = nullptr;
-                    if (pixelFormat == Texture2D::PixelFormat::AI88)
-                    {
-                        data = _currentPageData + CacheTextureWidth * (int)startY * 2;
-                    }
-                    else
-                    {
-                        data = _currentPageData + CacheTextureWidth * (int)startY;
-                    }
-                    _atlasTextures[_currentPage]->updateWithData(data, 0, startY,
-                        CacheTextureWidth, CacheTextureHeight - startY);
-
-                    startY = 0.0f;
-
-                    _currentPageOrigY = 0;
-                    memset(_currentPageData, 0, _currentPageDataSize);
-                    _currentPage++;
-                    auto tex = new (std::nothrow) Texture2D;
-                    if (_antialiasEnabled)
-                    {
-                        tex->setAntiAliasTexParameters();
-                    }
-                    else
-                    {
-                        tex->setAliasTexParameters();
-                    }
-                    tex->initWithData(_currentPageData, _currentPageDataSize,
-                        pixelFormat, CacheTextureWidth, CacheTextureHeight, Size(CacheTextureWidth, CacheTextureHeight));
-                    addTexture(tex, _currentPage);
-                    tex->release();
-                }
-            }
-            glyphHeight = static_cast<int>(bitmapHeight) + _letterPadding + _letterEdgeExtend;
-            if (glyphHeight > _currLineHeight)
+            addSkylineLevel(skylineIndex, posX, posY, packedWidth, packedHeight);
+            dirtyTop = std::min(dirtyTop, posY);
+            dirtyBottom = std::min(std::max(dirtyBottom, posY + packedHeight), CacheTextureHeight);
+
+            long rowSize = glyph.width * bytesPerPixel;
+            for (long y = 0; y < glyph.height; ++y)
             {
-                _currLineHeight = glyphHeight;
+                memcpy(_currentPageData + ((posY + adjustForExtend + y) * CacheTextureWidth + posX + adjustForExtend) * bytesPerPixel,
+                    glyph.pixels + y * rowSize, rowSize);
             }
-            _fontFreeType->renderCharAt(_currentPageData, _currentPageOrigX + adjustForExtend, _currentPageOrigY + adjustForExtend, bitmap, bitmapWidth, bitmapHeight);
+            delete [] glyph.pixels;
+            glyph.pixels = nullptr;
 
-            tempDef.U = _currentPageOrigX;
-            tempDef.V = _currentPageOrigY;
+            tempDef.U = posX;
+            tempDef.V = posY;
             tempDef.textureID = _currentPage;
-            _currentPageOrigX += tempDef.width + 1;
+            _pagesLastUse[_currentPage] = _useStamp;
             // take from pixels to points
             tempDef.width = tempDef.width / scaleFactor;
             tempDef.height = tempDef.height / scaleFactor;
@@ -431,8 +559,6 @@ bool FontAtlas::prepareLetterDefinitions(const std::u32string& utf32Text)
             tempDef.V = tempDef.V / scaleFactor;
         }
         else{
-            if(bitmap)
-                delete[] bitmap;
             if (tempDef.xAdvance)
                 tempDef.validDefinition = true;
             else
@@ -445,26 +571,359 @@ bool FontAtlas::prepareLetterDefinitions(const std::u32string& utf32Text)
             tempDef.offsetX = 0;
             tempDef.offsetY = 0;
             tempDef.textureID = 0;
-            _currentPageOrigX += 1;
         }
 
-        _letterDefinitions[it.first] = tempDef;
+        _letterDefinitions[glyph.utf32Char] = tempDef;
     }
 
-    unsigned char *data = nullptr;
-    if (pixelFormat == Texture2D::PixelFormat::AI88)
+    updateDirtyRows();
+
+    _glyphCacheDirty = true;
+    return pageEvicted;
+}
+
+bool FontAtlas::findSkylinePosition(int width, int height, int& outX, int& outY, size_t& outIndex) const
+{
+    // bottom-left: the lowest top edge, then the leftmost position
+    int bestTop = CacheTextureHeight + 1;
+    size_t count = _skyline.size();
+    for (size_t i = 0; i < count; ++i)
     {
-        data = _currentPageData + CacheTextureWidth * (int)startY * 2;
+        int x = _skyline[i].x;
+        if (x + width > CacheTextureWidth)
+        {
+            break;
+        }
+
+        int y = 0;
+        int widthLeft = width;
+        for (size_t j = i; j < count && widthLeft > 0; ++j)
+        {
+            y = std::max(y, _skyline[j].y);
+            widthLeft -= _skyline[j].width;
+        }
+
+        if (y + height <= CacheTextureHeight && y + height < bestTop)
+        {
+            bestTop = y + height;
+            outX = x;
+            outY = y;
+            outIndex = i;
+        }
+    }
+
+    return bestTop <= CacheTextureHeight;
+}
+
+void FontAtlas::addSkylineLevel(size_t index, int x, int y, int width, int height)
+{
+    _skyline.insert(_skyline.begin() + index, SkylineNode{ x, y + height, width });
+
+    // the new level covers the beginning of the next ones
+    for (size_t i = index + 1; i < _skyline.size();)
+    {
+        auto& previous = _skyline[i - 1];
+        auto& node = _skyline[i];
+        int overlap = previous.x + previous.width - node.x;
+        if (overlap <= 0)
+        {
+            break;
+        }
+        node.x += overlap;
+        node.width -= overlap;
+        if (node.width > 0)
+        {
+            break;
+        }
+        _skyline.erase(_skyline.begin() + i);
+    }
+
+    for (size_t i = 0; i + 1 < _skyline.size();)
+    {
+        if (_skyline[i].y == _skyline[i + 1].y)
+        {
+            _skyline[i].width += _skyline[i + 1].width;
+            _skyline.erase(_skyline.begin() + i + 1);
+        }
+        else
+        {
+            ++i;
+        }
+    }
+}
+
+bool FontAtlas::startNewPage()
+{
+    // the full pages are only on the GPU, unless they can be saved to the glyph cache
+    if (!_glyphCacheFile.empty())
+    {
+        _fullPagesData.resize(_atlasTextures.size());
+        _fullPagesData[_currentPage].assign(_currentPageData, _currentPageData + _currentPageDataSize);
+    }
+
+    int pageCount = (int)_atlasTextures.size();
+    int page = -1;
+    if (_maxPageCount <= 0 || pageCount < _maxPageCount)
+    {
+        page = pageCount;
     }
     else
     {
-        data = _currentPageData + CacheTextureWidth * (int)startY;
+        // the page used least recently, if it isn't used in this frame
+        for (int i = 0; i < pageCount; ++i)
+        {
+            if (_pagesLastUse[i] != _useStamp && (page < 0 || _pagesLastUse[i] < _pagesLastUse[page]))
+            {
+                page = i;
+            }
+        }
+        if (page < 0)
+        {
+            page = pageCount;
+        }
+    }
+
+    memset(_currentPageData, 0, _currentPageDataSize);
+    _currentPage = page;
+    _skyline.assign(1, SkylineNode{ 0, 0, CacheTextureWidth });
+
+    if (page == pageCount)
+    {
+        _pagesLastUse.push_back(_useStamp);
+        addPageTexture(_currentPageData, page);
+        return false;
     }
-    _atlasTextures[_currentPage]->updateWithData(data, 0, startY, CacheTextureWidth, _currentPageOrigY - startY + _currLineHeight);
 
+    evictPage(page);
     return true;
 }
 
+void FontAtlas::evictPage(int page)
+{
+    for (auto it = _letterDefinitions.begin(); it != _letterDefinitions.end();)
+    {
+        if (it->second.textureID == page && it->second.height > 0)
+            it = _letterDefinitions.erase(it);
+        else
+            ++it;
+    }
+
+    if (page < (int)_fullPagesData.size())
+    {
+        std::vector<unsigned char>().swap(_fullPagesData[page]);
+    }
+    _pagesLastUse[page] = _useStamp;
+}
+
+void FontAtlas::addPageTexture(unsigned char* data, int slot)
+{
+    auto  pixelFormat = _fontFreeType->getOutlineSize() > 0 ? Texture2D::PixelFormat::AI88 : Texture2D::PixelFormat::A8;
+    auto tex = new (std::nothrow) Texture2D;
+    if (_antialiasEnabled)
+    {
+        tex->setAntiAliasTexParameters();
+    }
+    else
+    {
+        tex->setAliasTexParameters();
+    }
+    tex->initWithData(data, _currentPageDataSize,
+        pixelFormat, CacheTextureWidth, CacheTextureHeight, Size(CacheTextureWidth, CacheTextureHeight));
+    addTexture(tex, slot);
+    tex->release();
+}
+
+bool FontAtlas::setGlyphCacheFile(const std::string& fullPath, const std::string& key)
+{
+    if (_fontFreeType == nullptr)
+    {
+        return false;
+    }
+
+    _glyphCacheFile = fullPath;
+    _glyphCacheKey = key;
+    return loadGlyphCache();
+}
+
+bool FontAtlas::loadGlyphCache()
+{
+    auto fileUtils = FileUtils::getInstance();
+    if (!fileUtils->isFileExist(_glyphCacheFile))
+    {
+        return false;
+    }
+
+    Data data = fileUtils->getDataFromFile(_glyphCacheFile);
+    const unsigned char* in = data.getBytes();
+    const unsigned char* end = in + data.getSize();
+
+    char magic[4];
+    int version = 0;
+    unsigned int keyLength = 0;
+    if (data.isNull() || !readGlyphCacheValue(in, end, magic) || memcmp(magic, GLYPH_CACHE_MAGIC, sizeof(magic)) != 0
+        || !readGlyphCacheValue(in, end, version) || version != GLYPH_CACHE_VERSION
+        || !readGlyphCacheValue(in, end, keyLength) || keyLength != _glyphCacheKey.size() || end - in < (ssize_t)keyLength
+        || memcmp(in, _glyphCacheKey.data(), keyLength) != 0)
+    {
+        CCLOG("FontAtlas: ignoring the outdated glyph cache %s", _glyphCacheFile.c_str());
+        return false;
+    }
+    in += keyLength;
+
+    int pageDataSize = 0;
+    int pageCount = 0;
+    int currentPage = 0;
+    unsigned int skylineCount = 0;
+    if (!readGlyphCacheValue(in, end, pageDataSize) || pageDataSize != _currentPageDataSize
+        || !readGlyphCacheValue(in, end, pageCount) || pageCount < 1
+        || !readGlyphCacheValue(in, end, currentPage) || currentPage < 0 || currentPage >= pageCount
+        || !readGlyphCacheValue(in, end, skylineCount) || skylineCount < 1)
+    {
+        return false;
+    }
+
+    std::vector<SkylineNode> skyline(skylineCount);
+    for (auto&& node : skyline)
+    {
+        if (!readGlyphCacheValue(in, end, node.x) || !readGlyphCacheValue(in, end, node.y)
+            || !readGlyphCacheValue(in, end, node.width))
+        {
+            return false;
+        }
+    }
+
+    unsigned int letterCount = 0;
+    if (!readGlyphCacheValue(in, end, letterCount))
+    {
+        return false;
+    }
+
+    std::unordered_map<char32_t, FontLetterDefinition> letterDefinitions;
+    letterDefinitions.reserve(letterCount);
+    for (unsigned int i = 0; i < letterCount; ++i)
+    {
+        char32_t utf32Char;
+        FontLetterDefinition def;
+        unsigned char valid = 0;
+        if (!readGlyphCacheValue(in, end, utf32Char)
+            || !readGlyphCacheValue(in, end, def.U) || !readGlyphCacheValue(in, end, def.V)
+            || !readGlyphCacheValue(in, end, def.width) || !readGlyphCacheValue(in, end, def.height)
+            || !readGlyphCacheValue(in, end, def.offsetX) || !readGlyphCacheValue(in, end, def.offsetY)
+            || !readGlyphCacheValue(in, end, def.textureID) || !readGlyphCacheValue(in, end, def.xAdvance)
+            || !readGlyphCacheValue(in, end, valid))
+        {
+            return false;
+        }
+        def.validDefinition = valid != 0;
+        letterDefinitions[utf32Char] = def;
+    }
+
+    if (end - in != (ssize_t)pageDataSize * pageCount)
+    {
+        return false;
+    }
+
+    // each page is uploaded once, the pixels of the current page stay in _currentPageData
+    releaseTextures();
+    _fullPagesData.assign(pageCount, std::vector<unsigned char>());
+    for (int page = 0; page < pageCount; ++page, in += pageDataSize)
+    {
+        if (page == currentPage)
+        {
+            memcpy(_currentPageData, in, pageDataSize);
+            addPageTexture(_currentPageData, page);
+        }
+        else
+        {
+            _fullPagesData[page].assign(in, in + pageDataSize);
+            addPageTexture(_fullPagesData[page].data(), page);
+        }
+    }
+
+    _letterDefinitions.swap(letterDefinitions);
+    _currentPage = currentPage;
+    _skyline.swap(skyline);
+    _pagesLastUse.assign(pageCount, 0);
+    _glyphCacheDirty = false;
+    return true;
+}
+
+bool FontAtlas::saveGlyphCache()
+{
+    if (_glyphCacheFile.empty() || !_glyphCacheDirty)
+    {
+        return false;
+    }
+
+    // the pages filled before the file was set can't be saved
+    const int pageCount = (int)_atlasTextures.size();
+    for (int page = 0; page < pageCount; ++page)
+    {
+        if (page != _currentPage
+            && (page >= (int)_fullPagesData.size() || (int)_fullPagesData[page].size() != _currentPageDataSize))
+        {
+            return false;
+        }
+    }
+
+    std::vector<unsigned char> out;
+    out.reserve(_glyphCacheKey.size() + _skyline.size() * 12 + _letterDefinitions.size() * 48
+        + (size_t)_currentPageDataSize * pageCount + 64);
+
+    out.insert(out.end(), GLYPH_CACHE_MAGIC, GLYPH_CACHE_MAGIC + sizeof(GLYPH_CACHE_MAGIC));
+    writeGlyphCacheValue(out, GLYPH_CACHE_VERSION);
+    writeGlyphCacheValue(out, (unsigned int)_glyphCacheKey.size());
+    out.insert(out.end(), _glyphCacheKey.begin(), _glyphCacheKey.end());
+
+    writeGlyphCacheValue(out, _currentPageDataSize);
+    writeGlyphCacheValue(out, pageCount);
+    writeGlyphCacheValue(out, _currentPage);
+    writeGlyphCacheValue(out, (unsigned int)_skyline.size());
+    for (auto&& node : _skyline)
+    {
+        writeGlyphCacheValue(out, node.x);
+        writeGlyphCacheValue(out, node.y);
+        writeGlyphCacheValue(out, node.width);
+    }
+    writeGlyphCacheValue(out, (unsigned int)_letterDefinitions.size());
+    for (auto&& item : _letterDefinitions)
+    {
+        const FontLetterDefinition& def = item.second;
+        writeGlyphCacheValue(out, item.first);
+        writeGlyphCacheValue(out, def.U);
+        writeGlyphCacheValue(out, def.V);
+        writeGlyphCacheValue(out, def.width);
+        writeGlyphCacheValue(out, def.height);
+        writeGlyphCacheValue(out, def.offsetX);
+        writeGlyphCacheValue(out, def.offsetY);
+        writeGlyphCacheValue(out, def.textureID);
+        writeGlyphCacheValue(out, def.xAdvance);
+        writeGlyphCacheValue(out, (unsigned char)(def.validDefinition ? 1 : 0));
+    }
+
+    for (int page = 0; page < pageCount; ++page)
+    {
+        if (page == _currentPage)
+        {
+            out.insert(out.end(), _currentPageData, _currentPageData + _currentPageDataSize);
+        }
+        else
+        {
+            out.insert(out.end(), _fullPagesData[page].begin(), _fullPagesData[page].end());
+        }
+    }
+
+    Data data;
+    data.copy(out.data(), out.size());
+    bool saved = FileUtils::getInstance()->writeDataToFile(data, _glyphCacheFile);
+
+    if (saved)
+    {
+        _glyphCacheDirty = false;
+    }
+    return saved;
+}
+
 void FontAtlas::addTexture(Texture2D *texture, int slot)
 {
     texture->retain();
@@ -30,9 +30,12 @@
 
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
+#include <vector>
 
 #include "platform/CCPlatformMacros.h"
 #include "base/CCRef.h"
+#include "math/CCGeometry.h"
 #include "platform/CCStdC.h" // ssize_t on windows
 
 NS_CC_BEGIN
@@ -63,6 +66,7 @@ public:
     static const int CacheTextureHeight;
     static const char* CMD_PURGE_FONTATLAS;
     static const char* CMD_RESET_FONTATLAS;
+    static const char* CMD_UPDATE_FONTATLAS;
     /**
      * @js ctor
      */
@@ -108,13 +112,78 @@ public:
      */
      void setAliasTexParameters();
 
+    /** Sets the file of the persistent glyph cache and restores the glyphs saved in it.
+     The file is only restored if it was saved with the same key, see FontAtlasCache::setGlyphCacheEnabled.
+     While a file is set, the atlas keeps the pixels of all its pages to be able to save them.
+
+     @param fullPath Full path of the glyph cache file.
+     @param key Identifies the font file, size, outline and distance field settings of the atlas.
+     @return True if the glyphs were restored.
+     */
+    bool setGlyphCacheFile(const std::string& fullPath, const std::string& key);
+
+    /** Saves the glyphs and the pages of the atlas to its glyph cache file, if it got new glyphs since
+     it was restored or saved.
+     */
+    bool saveGlyphCache();
+
+    /** Rasterizes the missing glyphs on a worker thread instead of in prepareLetterDefinitions(), disabled by default.
+     The labels are laid out without the glyphs which are not ready, and again when CMD_UPDATE_FONTATLAS is
+     dispatched with the atlas, after the glyphs were added to the pages on the cocos thread.
+     */
+    void setAsyncRasterizationEnabled(bool enabled) { _asyncRasterizationEnabled = enabled; }
+    bool isAsyncRasterizationEnabled() const { return _asyncRasterizationEnabled; }
+
+    /** Whether glyphs are being rasterized on a worker thread. */
+    bool hasPendingGlyphs() const { return !_pendingGlyphs.empty(); }
+
+    /** Sets the maximum number of pages of the atlas, 0 for no limit, which is the default.
+     Once the atlas has that many pages, the page used least recently is cleared and reused for the new glyphs.
+     The labels using the glyphs of that page are laid out again, which rasterizes the glyphs they still need.
+     The pages used during the current frame are never reused, if all of them are the limit is exceeded.
+     */
+    void setMaxPageCount(int count) { _maxPageCount = count; }
+    int getMaxPageCount() const { return _maxPageCount; }
+
 protected:
+    struct GlyphBitmap
+    {
+        char32_t utf32Char;
+        unsigned int charCode;
+        // the pixels in the layout of the pages, see FontFreeType::rasterizeGlyph
+        unsigned char* pixels;
+        long width;
+        long height;
+        Rect rect;
+        int xAdvance;
+    };
+
     void reset();
     
     void reinit();
     
     void releaseTextures();
 
+    bool loadGlyphCache();
+    void addPageTexture(unsigned char* data, int slot);
+
+    void rasterizeGlyphsAsync(const std::unordered_map<unsigned int, unsigned int>& charCodeMap);
+    bool addGlyphs(std::vector<GlyphBitmap>& glyphs);
+
+    // skyline packing of the current page
+    struct SkylineNode
+    {
+        int x;
+        int y;
+        int width;
+    };
+
+    void resetPages();
+    bool findSkylinePosition(int width, int height, int& outX, int& outY, size_t& outIndex) const;
+    void addSkylineLevel(size_t index, int x, int y, int width, int height);
+    bool startNewPage();
+    void evictPage(int page);
+
     void findNewCharacters(const std::u32string& u32Text, std::unordered_map<unsigned int, unsigned int>& charCodeMap);
 
     void conversionU32TOGB2312(const std::u32string& u32Text, std::unordered_map<unsigned int, unsigned int>& charCodeMap);
@@ -137,15 +206,26 @@ protected:
     int _currentPage;
     unsigned char *_currentPageData;
     int _currentPageDataSize;
-    float _currentPageOrigX;
-    float _currentPageOrigY;
+    std::vector<SkylineNode> _skyline;
+    std::vector<unsigned int> _pagesLastUse;
+    unsigned int _useStamp;
+    int _maxPageCount;
     int _letterPadding;
     int _letterEdgeExtend;
 
     int _fontAscender;
     EventListenerCustom* _rendererRecreatedListener;
     bool _antialiasEnabled;
-    int _currLineHeight;
+
+    // persistent glyph cache
+    std::string _glyphCacheFile;
+    std::string _glyphCacheKey;
+    // the pixels of the pages by index, except for the current page
+    std::vector<std::vector<unsigned char>> _fullPagesData;
+    bool _glyphCacheDirty;
+
+    bool _asyncRasterizationEnabled;
+    std::unordered_set<char32_t> _pendingGlyphs;
 
     friend class Label;
 };
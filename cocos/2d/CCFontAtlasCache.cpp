@@ -35,10 +35,15 @@
 NS_CC_BEGIN
 
 std::unordered_map<std::string, FontAtlas *> FontAtlasCache::_atlasMap;
+bool FontAtlasCache::_glyphCacheEnabled = false;
+bool FontAtlasCache::_asyncRasterizationEnabled = false;
+int FontAtlasCache::_maxPageCount = 0;
 #define ATLAS_MAP_KEY_BUFFER 255
 
 void FontAtlasCache::purgeCachedData()
 {
+    saveGlyphCaches();
+
     auto atlasMapCopy = _atlasMap;
     for (auto&& atlas : atlasMapCopy)
     {
@@ -80,6 +85,17 @@ FontAtlas* FontAtlasCache::getFontAtlasTTF(const _ttfConfig* config)
             auto tempAtlas = font->createFontAtlas();
             if (tempAtlas)
             {
+                if (_glyphCacheEnabled)
+                {
+                    std::string key;
+                    auto cacheFile = getGlyphCacheFile(atlasName, realFontFilename, key);
+                    if (!cacheFile.empty())
+                    {
+                        tempAtlas->setGlyphCacheFile(cacheFile, key);
+                    }
+                }
+                tempAtlas->setAsyncRasterizationEnabled(_asyncRasterizationEnabled);
+                tempAtlas->setMaxPageCount(_maxPageCount);
                 _atlasMap[atlasName] = tempAtlas;
                 return _atlasMap[atlasName];
             }
@@ -91,6 +107,32 @@ FontAtlas* FontAtlasCache::getFontAtlasTTF(const _ttfConfig* config)
     return nullptr;
 }
 
+std::string FontAtlasCache::getGlyphCacheFile(const std::string& atlasName, const std::string& fontFile, std::string& key)
+{
+    auto fileUtils = FileUtils::getInstance();
+    std::string directory = fileUtils->getWritablePath() + "fontatlas/";
+    if (!fileUtils->isDirectoryExist(directory) && !fileUtils->createDirectory(directory))
+    {
+        return "";
+    }
+
+    // the file is rasterized again when the font file or the content scale factor change
+    char tmp[ATLAS_MAP_KEY_BUFFER];
+    snprintf(tmp, ATLAS_MAP_KEY_BUFFER, "%ld %.2f ", fileUtils->getFileSize(fontFile), CC_CONTENT_SCALE_FACTOR());
+    key = tmp + atlasName;
+
+    snprintf(tmp, ATLAS_MAP_KEY_BUFFER, "%016llx.glyphs", (unsigned long long)std::hash<std::string>()(atlasName));
+    return directory + tmp;
+}
+
+void FontAtlasCache::saveGlyphCaches()
+{
+    for (auto&& item : _atlasMap)
+    {
+        item.second->saveGlyphCache();
+    }
+}
+
 FontAtlas* FontAtlasCache::getFontAtlasFNT(const std::string& fontFileName, const Vec2& imageOffset /* = Vec2::ZERO */)
 {
     auto realFontFilename = FileUtils::getInstance()->getNewFilename(fontFileName);  // resolves real file path, to prevent storing multiple atlases for the same file.
@@ -208,6 +250,7 @@ bool FontAtlasCache::releaseFontAtlas(FontAtlas *atlas)
             {
                 if (atlas->getReferenceCount() == 1)
                 {
+                  atlas->saveGlyphCache();
                   _atlasMap.erase(item.first);
                 }
                 
@@ -253,6 +296,7 @@ void FontAtlasCache::unloadFontAtlasTTF(const std::string& fontFileName)
     {
         if (item->first.find(fontFileName) != std::string::npos)
         {
+            item->second->saveGlyphCache();
             CC_SAFE_RELEASE_NULL(item->second);
             item = _atlasMap.erase(item);
         }
@@ -66,8 +66,42 @@ public:
     */
     static void unloadFontAtlasTTF(const std::string& fontFileName);
 
+    /** Enables the persistent glyph cache of the TTF atlases, disabled by default.
+     The glyphs rasterized by FreeType are saved with the pages of their atlas in the writable path, and restored
+     by the next getFontAtlasTTF() with the same font file, size, outline and distance field settings instead of being
+     rasterized again. The atlases are saved when they are released or purged, and by saveGlyphCaches().
+     */
+    static void setGlyphCacheEnabled(bool enabled) { _glyphCacheEnabled = enabled; }
+    static bool isGlyphCacheEnabled() { return _glyphCacheEnabled; }
+
+    /** Makes the new TTF atlases rasterize their missing glyphs on a worker thread, disabled by default.
+     @see FontAtlas::setAsyncRasterizationEnabled
+     */
+    static void setAsyncRasterizationEnabled(bool enabled) { _asyncRasterizationEnabled = enabled; }
+    static bool isAsyncRasterizationEnabled() { return _asyncRasterizationEnabled; }
+
+    /** Sets the maximum number of pages of the new TTF atlases, 0 for no limit, which is the default.
+     @see FontAtlas::setMaxPageCount
+     */
+    static void setMaxPageCount(int count) { _maxPageCount = count; }
+    static int getMaxPageCount() { return _maxPageCount; }
+
+    /** Saves the glyph caches of the atlases which got new glyphs, e.g. when the application enters the background.
+     */
+    static void saveGlyphCaches();
+
+    /** Returns the number of cached font atlases.
+     @since v3.14
+     */
+    static ssize_t getFontAtlasCount() { return (ssize_t)_atlasMap.size(); }
+
 private:
+    static std::string getGlyphCacheFile(const std::string& atlasName, const std::string& fontFile, std::string& key);
+
     static std::unordered_map<std::string, FontAtlas *> _atlasMap;
+    static bool _glyphCacheEnabled;
+    static bool _asyncRasterizationEnabled;
+    static int _maxPageCount;
 };
 
 NS_CC_END
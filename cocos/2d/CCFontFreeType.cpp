@@ -36,6 +36,7 @@ NS_CC_BEGIN
 
 FT_Library FontFreeType::_FTlibrary;
 bool       FontFreeType::_FTInitialized = false;
+std::mutex FontFreeType::_FTMutex;
 const int  FontFreeType::DistanceMapSpread = 3;
 
 const char* FontFreeType::_glyphASCII = "\"!#$%&'()*+,-./0123456789:;<=>?@ABCDEFGHIJKLMNOPQRSTUVWXYZ[\\]^_`abcdefghijklmnopqrstuvwxyz{|}~¡¢£¤¥¦§¨©ª«¬­®¯°±²³´µ¶·¸¹º»¼½¾¿ÀÁÂÃÄÅÆÇÈÉÊËÌÍÎÏÐÑÒÓÔÕÖ×ØÙÚÛÜÝÞßàáâãäåæçèéêëìíîïðñòóôõö÷øùúûüýþ ";
@@ -83,6 +84,7 @@ bool FontFreeType::initFreeType()
 
 void FontFreeType::shutdownFreeType()
 {
+    std::lock_guard<std::mutex> lock(_FTMutex);
     if (_FTInitialized == true)
     {
         FT_Done_FreeType(_FTlibrary);
@@ -109,6 +111,7 @@ FontFreeType::FontFreeType(bool distanceFieldEnabled /* = false */, float outlin
 {
     if (outline > 0.0f)
     {
+        std::lock_guard<std::mutex> lock(_FTMutex);
         _outlineSize = outline * CC_CONTENT_SCALE_FACTOR();
         FT_Stroker_New(FontFreeType::getFTLibrary(), &_stroker);
         FT_Stroker_Set(_stroker,
@@ -141,6 +144,7 @@ bool FontFreeType::createFontObject(const std::string &fontName, float fontSize)
         }
     }
 
+    std::lock_guard<std::mutex> lock(_FTMutex);
     if (FT_New_Memory_Face(getFTLibrary(), s_cacheFontData[fontName].data.getBytes(), s_cacheFontData[fontName].data.getSize(), 0, &face ))
         return false;
 
@@ -184,6 +188,7 @@ bool FontFreeType::createFontObject(const std::string &fontName, float fontSize)
 
 FontFreeType::~FontFreeType()
 {
+    std::unique_lock<std::mutex> lock(_FTMutex);
     if (_FTInitialized)
     {
         if (_stroker)
@@ -195,6 +200,7 @@ FontFreeType::~FontFreeType()
             FT_Done_Face(_fontRef);
         }
     }
+    lock.unlock();
 
     auto iter = s_cacheFontData.find(_fontName);
     if (iter != s_cacheFontData.end())
@@ -244,6 +250,7 @@ int * FontFreeType::getHorizontalKerningForTextUTF32(const std::u32string& text,
     bool hasKerning = FT_HAS_KERNING( _fontRef ) != 0;
     if (hasKerning)
     {
+        std::lock_guard<std::mutex> lock(_FTMutex);
         for (int c = 1; c < outNumLetters; ++c)
         {
             sizes[c] = getHorizontalKerningForChars(text[c-1], text[c]);
@@ -289,6 +296,12 @@ const char* FontFreeType::getFontFamily() const
 }
 
 unsigned char* FontFreeType::getGlyphBitmap(uint64_t theChar, long &outWidth, long &outHeight, Rect &outRect,int &xAdvance)
+{
+    std::lock_guard<std::mutex> lock(_FTMutex);
+    return loadGlyphBitmap(theChar, outWidth, outHeight, outRect, xAdvance);
+}
+
+unsigned char* FontFreeType::loadGlyphBitmap(uint64_t theChar, long &outWidth, long &outHeight, Rect &outRect, int &xAdvance)
 {
     bool invalidChar = true;
     unsigned char* ret = nullptr;
@@ -620,6 +633,49 @@ void FontFreeType::renderCharAt(unsigned char *dest,int posX, int posY, unsigned
     } 
 }
 
+unsigned char* FontFreeType::rasterizeGlyph(uint64_t theChar, long &outWidth, long &outHeight, Rect &outRect, int &xAdvance)
+{
+    unsigned char* bitmap = nullptr;
+    {
+        std::lock_guard<std::mutex> lock(_FTMutex);
+        if (!_FTInitialized)
+        {
+            outWidth = outHeight = 0;
+            xAdvance = 0;
+            return nullptr;
+        }
+
+        bitmap = loadGlyphBitmap(theChar, outWidth, outHeight, outRect, xAdvance);
+        if (bitmap == nullptr || outWidth <= 0 || outHeight <= 0)
+        {
+            // nothing was allocated for the empty glyphs
+            return nullptr;
+        }
+
+        // without outline the bitmap belongs to the glyph slot, which is overwritten by the next glyph
+        if (_outlineSize <= 0)
+        {
+            auto copyBitmap = new (std::nothrow) unsigned char[outWidth * outHeight];
+            memcpy(copyBitmap, bitmap, outWidth * outHeight);
+            bitmap = copyBitmap;
+        }
+    }
+
+    if (_distanceFieldEnabled)
+    {
+        auto distanceMap = makeDistanceMap(bitmap, outWidth, outHeight);
+        delete [] bitmap;
+
+        outWidth += 2 * DistanceMapSpread;
+        outHeight += 2 * DistanceMapSpread;
+        bitmap = new (std::nothrow) unsigned char[outWidth * outHeight];
+        memcpy(bitmap, distanceMap, outWidth * outHeight);
+        free(distanceMap);
+    }
+
+    return bitmap;
+}
+
 void FontFreeType::setGlyphCollection(GlyphCollection glyphs, const char* customGlyphs /* = nullptr */)
 {
     _usedGlyphs = glyphs;
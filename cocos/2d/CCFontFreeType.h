@@ -31,6 +31,7 @@
 #include "2d/CCFont.h"
 
 #include <string>
+#include <mutex>
 #include <ft2build.h>
 
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_WINRT)
@@ -69,6 +70,16 @@ public:
     int* getHorizontalKerningForTextUTF32(const std::u32string& text, int &outNumLetters) const override;
     
     unsigned char* getGlyphBitmap(uint64_t theChar, long &outWidth, long &outHeight, Rect &outRect,int &xAdvance);
+
+    /** Rasterizes a glyph into a new buffer, in the layout of the atlas pages: with the distance field already
+     computed, and two bytes per pixel if the font has an outline. Unlike getGlyphBitmap(), it can be called
+     from any thread.
+
+     @param outWidth Width of the buffer in pixels.
+     @param outHeight Height of the buffer in pixels.
+     @return The buffer, to release with delete[], or nullptr if the glyph has no pixels.
+     */
+    unsigned char* rasterizeGlyph(uint64_t theChar, long &outWidth, long &outHeight, Rect &outRect, int &xAdvance);
     
     int getFontAscender() const;
     const char* getFontFamily() const;
@@ -83,6 +94,8 @@ private:
     static const char* _glyphNEHE;
     static FT_Library _FTlibrary;
     static bool _FTInitialized;
+    // FreeType objects are not thread safe, all the faces share the library
+    static std::mutex _FTMutex;
 
     FontFreeType(bool distanceFieldEnabled = false, float outline = 0);
     virtual ~FontFreeType();
@@ -93,6 +106,7 @@ private:
     FT_Library getFTLibrary();
     
     int getHorizontalKerningForChars(uint64_t firstChar, uint64_t secondChar) const;
+    unsigned char* loadGlyphBitmap(uint64_t theChar, long &outWidth, long &outHeight, Rect &outRect, int &xAdvance);
     unsigned char* getGlyphBitmapWithOutline(uint64_t code, FT_BBox &bbox);
 
     void setGlyphCollection(GlyphCollection glyphs, const char* customGlyphs = nullptr);
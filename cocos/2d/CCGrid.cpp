@@ -29,14 +29,20 @@ THE SOFTWARE.
 #include "base/ccUtils.h"
 #include "2d/CCNode.h"
 #include "2d/CCGrabber.h"
+#include "2d/CCRenderTexture.h"
 #include "renderer/CCGLProgram.h"
 #include "renderer/CCGLProgramCache.h"
+#include "renderer/CCGLProgramState.h"
 #include "renderer/ccGLStateCache.h"
 #include "renderer/CCRenderer.h"
 #include "renderer/CCRenderState.h"
 #include "renderer/CCTexture2D.h"
+#include "renderer/ccShaders.h"
 #include "platform/CCGL.h"
 #include "2d/CCCamera.h"
+#include "base/CCEventType.h"
+#include "base/CCEventListenerCustom.h"
+#include "base/CCEventDispatcher.h"
 
 NS_CC_BEGIN
 // implementation of GridBase
@@ -60,6 +66,23 @@ GridBase* GridBase::create(const Size& gridSize)
     return pGridBase;
 }
 
+GridBase::GridBase()
+: _active(false)
+, _reuseGrid(0)
+, _texture(nullptr)
+, _grabber(nullptr)
+, _isTextureFlipped(false)
+, _isTexturePooled(false)
+, _shaderProgram(nullptr)
+, _vertexBufferDirty(true)
+, _buffersDirty(true)
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+, _rendererRecreatedListener(nullptr)
+#endif
+{
+    memset(_buffersVBO, 0, sizeof(_buffersVBO));
+}
+
 GridBase* GridBase::create(const Size& gridSize, Texture2D *texture, bool flipped)
 {
     GridBase *pGridBase = new (std::nothrow) GridBase();
@@ -94,6 +117,16 @@ bool GridBase::initWithSize(const cocos2d::Size &gridSize, const cocos2d::Rect &
     
     // we only use rgba8888
     Texture2D::PixelFormat format = Texture2D::PixelFormat::RGBA8888;
+
+    // the grabber clears the texture before each use
+    Texture2D *pooledTexture = RenderTargetPool::getInstance()->acquireTexture(POTWide, POTHigh, s, format);
+    if (pooledTexture)
+    {
+        initWithSize(gridSize, pooledTexture, false, rect);
+        _isTexturePooled = true;
+        pooledTexture->release();
+        return true;
+    }
     
     auto dataLen = POTWide * POTHigh * 4;
     void *data = calloc(dataLen, 1);
@@ -116,6 +149,7 @@ bool GridBase::initWithSize(const cocos2d::Size &gridSize, const cocos2d::Rect &
     }
     
     initWithSize(gridSize, texture, false, rect);
+    _isTexturePooled = true;
     
     texture->release();
     
@@ -161,7 +195,16 @@ bool GridBase::initWithSize(const Size& gridSize, Texture2D *texture, bool flipp
     
     _shaderProgram = GLProgramCache::getInstance()->getGLProgram(GLProgram::SHADER_NAME_POSITION_TEXTURE);
     calculateVertexPoints();
-    
+
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+    if (_rendererRecreatedListener == nullptr)
+    {
+        // listen the event that renderer was recreated on Android/WP8
+        _rendererRecreatedListener = EventListenerCustom::create(EVENT_RENDERER_RECREATED, CC_CALLBACK_1(GridBase::listenRendererRecreated, this));
+        Director::getInstance()->getEventDispatcher()->addEventListenerWithFixedPriority(_rendererRecreatedListener, -1);
+    }
+#endif
+
     return ret;
 }
 
@@ -170,8 +213,69 @@ GridBase::~GridBase(void)
     CCLOGINFO("deallocing GridBase: %p", this);
 
     //TODO: ? why 2.0 comments this line:        setActive(false);
-    CC_SAFE_RELEASE(_texture);
     CC_SAFE_RELEASE(_grabber);
+    if (_isTexturePooled && _texture)
+    {
+        RenderTargetPool::getInstance()->recycleTexture(_texture);
+    }
+    else
+    {
+        CC_SAFE_RELEASE(_texture);
+    }
+
+    glDeleteBuffers(3, _buffersVBO);
+
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+    Director::getInstance()->getEventDispatcher()->removeEventListener(_rendererRecreatedListener);
+#endif
+}
+
+void GridBase::listenRendererRecreated(EventCustom* /*event*/)
+{
+    // the buffers are created again by the next blit
+    memset(_buffersVBO, 0, sizeof(_buffersVBO));
+}
+
+void GridBase::drawBuffers(const GLvoid* vertices, const GLvoid* texCoords, const GLushort* indices, int vertexCount, int indexCount)
+{
+    // the attributes are set on the default vertex array
+    GL::bindVAO(0);
+
+    if (_buffersVBO[0] == 0)
+    {
+        glGenBuffers(3, _buffersVBO);
+        _buffersDirty = true;
+    }
+
+    if (_buffersDirty)
+    {
+        glBindBuffer(GL_ARRAY_BUFFER, _buffersVBO[1]);
+        glBufferData(GL_ARRAY_BUFFER, vertexCount * sizeof(Vec2), texCoords, GL_STATIC_DRAW);
+        glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffersVBO[2]);
+        glBufferData(GL_ELEMENT_ARRAY_BUFFER, indexCount * sizeof(GLushort), indices, GL_STATIC_DRAW);
+        _buffersDirty = false;
+        _vertexBufferDirty = true;
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
+    if (_vertexBufferDirty)
+    {
+        // the whole array is sent again, so the driver doesn't wait for the previous draw
+        glBufferData(GL_ARRAY_BUFFER, vertexCount * sizeof(Vec3), vertices, GL_DYNAMIC_DRAW);
+        _vertexBufferDirty = false;
+    }
+    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 3, GL_FLOAT, GL_FALSE, 0, nullptr);
+
+    glBindBuffer(GL_ARRAY_BUFFER, _buffersVBO[1]);
+    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORD, 2, GL_FLOAT, GL_FALSE, 0, nullptr);
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffersVBO[2]);
+    glDrawElements(GL_TRIANGLES, (GLsizei)indexCount, GL_UNSIGNED_SHORT, nullptr);
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+    CC_INCREMENT_GL_DRAWN_BATCHES_AND_VERTICES(1, indexCount);
 }
 
 // properties
@@ -227,7 +331,7 @@ void GridBase::beforeDraw(void)
     set2DProjection();
     
     Size    size = director->getWinSizeInPixels();
-    glViewport(0, 0, (GLsizei)(size.width), (GLsizei)(size.height) );
+    GL::viewport(0, 0, (GLsizei)(size.width), (GLsizei)(size.height) );
     _grabber->beforeRender(_texture);
 }
 
@@ -241,7 +345,7 @@ void GridBase::afterDraw(cocos2d::Node * /*target*/)
 
     director->setViewport();
     const auto& vp = Camera::getDefaultViewport();
-    glViewport(vp._left, vp._bottom, vp._width, vp._height);
+    GL::viewport(vp._left, vp._bottom, vp._width, vp._height);
 //    if (target->getCamera()->isDirty())
 //    {
 //        Vec2 offset = target->getAnchorPointInPoints();
@@ -368,6 +472,7 @@ Grid3D::Grid3D()
 , _originalVertices(nullptr)
 , _indices(nullptr)
 , _needDepthTestForBlit(false)
+, _vertexShaderState(nullptr)
 {
 
 }
@@ -378,22 +483,60 @@ Grid3D::~Grid3D(void)
     CC_SAFE_FREE(_vertices);
     CC_SAFE_FREE(_indices);
     CC_SAFE_FREE(_originalVertices);
+    CC_SAFE_RELEASE(_vertexShaderState);
+}
+
+GLProgramState* Grid3D::setVertexShader(const std::string& key, const char* vertexShader)
+{
+    CC_SAFE_RELEASE_NULL(_vertexShaderState);
+    _vertexShaderSource.clear();
+    if (vertexShader == nullptr)
+        return nullptr;
+
+    auto glProgramCache = GLProgramCache::getInstance();
+    auto glProgram = glProgramCache->getGLProgram(key);
+    if (glProgram == nullptr)
+    {
+        glProgram = GLProgram::createWithByteArrays(vertexShader, ccPositionTexture_frag);
+        if (glProgram == nullptr)
+            return nullptr;
+        glProgramCache->addGLProgram(glProgram, key);
+    }
+
+    _vertexShaderState = GLProgramState::create(glProgram);
+    CC_SAFE_RETAIN(_vertexShaderState);
+    _vertexShaderSource = vertexShader;
+    return _vertexShaderState;
+}
+
+void Grid3D::listenRendererRecreated(EventCustom* event)
+{
+    GridBase::listenRendererRecreated(event);
+
+    if (_vertexShaderState)
+    {
+        auto glProgram = _vertexShaderState->getGLProgram();
+        glProgram->reset();
+        glProgram->initWithByteArrays(_vertexShaderSource.c_str(), ccPositionTexture_frag);
+        glProgram->link();
+        glProgram->updateUniforms();
+    }
 }
 
 void Grid3D::beforeBlit()
 {
     if(_needDepthTestForBlit)
     {
-        _oldDepthTestValue = glIsEnabled(GL_DEPTH_TEST) != GL_FALSE;
+        _oldDepthTestValue = GL::isEnabled(GL_DEPTH_TEST) != GL_FALSE;
         GLboolean depthWriteMask;
-        glGetBooleanv(GL_DEPTH_WRITEMASK, &depthWriteMask);
+        depthWriteMask = GL::getDepthMask();
 		_oldDepthWriteValue = depthWriteMask != GL_FALSE;
         CHECK_GL_ERROR_DEBUG();
 
-        glEnable(GL_DEPTH_TEST);
+        GL::enable(GL_DEPTH_TEST);
         RenderState::StateBlock::_defaultState->setDepthTest(true);
 
-        glDepthMask(true);
+        GL::depthMask(true);
         RenderState::StateBlock::_defaultState->setDepthWrite(true);
     }
 }
@@ -403,12 +546,12 @@ void Grid3D::afterBlit()
     if(_needDepthTestForBlit)
     {
         if(_oldDepthTestValue)
-            glEnable(GL_DEPTH_TEST);
+            GL::enable(GL_DEPTH_TEST);
         else
-            glDisable(GL_DEPTH_TEST);
+            GL::disable(GL_DEPTH_TEST);
         RenderState::StateBlock::_defaultState->setDepthTest(_oldDepthTestValue);
 
-        glDepthMask(_oldDepthWriteValue);
+        GL::depthMask(_oldDepthWriteValue);
         RenderState::StateBlock::_defaultState->setDepthWrite(_oldDepthWriteValue);
     }
 }
@@ -418,20 +561,18 @@ void Grid3D::blit(void)
     int n = _gridSize.width * _gridSize.height;
 
     GL::enableVertexAttribs( GL::VERTEX_ATTRIB_FLAG_POSITION | GL::VERTEX_ATTRIB_FLAG_TEX_COORD );
-    _shaderProgram->use();
-    _shaderProgram->setUniformsForBuiltins();
-
-    //
-    // Attributes
-    //
-
-    // position
-    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 3, GL_FLOAT, GL_FALSE, 0, _vertices);
-
-    // texCoords
-    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORD, 2, GL_FLOAT, GL_FALSE, 0, _texCoordinates);
+    if (_vertexShaderState)
+    {
+        _vertexShaderState->applyGLProgram(Director::getInstance()->getMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW));
+        _vertexShaderState->applyUniforms();
+    }
+    else
+    {
+        _shaderProgram->use();
+        _shaderProgram->setUniformsForBuiltins();
+    }
 
-    glDrawElements(GL_TRIANGLES, (GLsizei) n*6, GL_UNSIGNED_SHORT, _indices);
+    drawBuffers(_vertices, _texCoordinates, _indices, (_gridSize.width+1) * (_gridSize.height+1), n*6);
 }
 
 void Grid3D::calculateVertexPoints(void)
@@ -508,6 +649,7 @@ void Grid3D::calculateVertexPoints(void)
     }
 
     memcpy(_originalVertices, _vertices, (_gridSize.width+1) * (_gridSize.height+1) * sizeof(Vec3));
+    _buffersDirty = true;
 }
 
 Vec3 Grid3D::getVertex(const Vec2& pos) const
@@ -542,6 +684,7 @@ void Grid3D::setVertex(const Vec2& pos, const Vec3& vertex)
     vertArray[index] = vertex.x;
     vertArray[index+1] = vertex.y;
     vertArray[index+2] = vertex.z;
+    _vertexBufferDirty = true;
 }
 
 void Grid3D::reuse(void)
@@ -665,15 +808,7 @@ void TiledGrid3D::blit(void)
     //
     GL::enableVertexAttribs( GL::VERTEX_ATTRIB_FLAG_POSITION | GL::VERTEX_ATTRIB_FLAG_TEX_COORD );
 
-    // position
-    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 3, GL_FLOAT, GL_FALSE, 0, _vertices);
-
-    // texCoords
-    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORD, 2, GL_FLOAT, GL_FALSE, 0, _texCoordinates);
-
-    glDrawElements(GL_TRIANGLES, (GLsizei)n*6, GL_UNSIGNED_SHORT, _indices);
-
-    CC_INCREMENT_GL_DRAWN_BATCHES_AND_VERTICES(1,n*6);
+    drawBuffers(_vertices, _texCoordinates, _indices, n*4, n*6);
 }
 
 void TiledGrid3D::calculateVertexPoints(void)
@@ -753,6 +888,7 @@ void TiledGrid3D::calculateVertexPoints(void)
     }
     
     memcpy(_originalVertices, _vertices, numQuads * 12 * sizeof(GLfloat));
+    _buffersDirty = true;
 }
 
 void TiledGrid3D::setTile(const Vec2& pos, const Quad3& coords)
@@ -761,6 +897,7 @@ void TiledGrid3D::setTile(const Vec2& pos, const Quad3& coords)
     int idx = (_gridSize.height * pos.x + pos.y) * 4 * 3;
     float *vertArray = (float*)_vertices;
     memcpy(&vertArray[idx], &coords, sizeof(Quad3));
+    _vertexBufferDirty = true;
 }
 
 Quad3 TiledGrid3D::getOriginalTile(const Vec2& pos) const
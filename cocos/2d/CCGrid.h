@@ -26,6 +26,8 @@ THE SOFTWARE.
 #ifndef __EFFECTS_CCGRID_H__
 #define __EFFECTS_CCGRID_H__
 
+#include <string>
+
 #include "base/CCRef.h"
 #include "base/ccTypes.h"
 #include "base/CCDirector.h"
@@ -35,7 +37,10 @@ NS_CC_BEGIN
 class Texture2D;
 class Grabber;
 class GLProgram;
+class GLProgramState;
 class Node;
+class EventCustom;
+class EventListenerCustom;
 
 /**
  * @addtogroup _2d
@@ -51,6 +56,11 @@ public:
     static GridBase* create(const Size& gridSize, Texture2D *texture, bool flipped);
     /** create one Grid */
     static GridBase* create(const Size& gridSize);
+    /**
+     Constructor.
+     * @js ctor
+     */
+    GridBase();
     /**
     Destructor.
      * @js NA
@@ -135,6 +145,12 @@ public:
     const Rect& getGridRect() const { return _gridRect; }
 
 protected:
+    /** Uploads the arrays that changed to the buffers of the grid, then draws the grid from the buffers.
+     * @since v3.14
+     */
+    void drawBuffers(const GLvoid* vertices, const GLvoid* texCoords, const GLushort* indices, int vertexCount, int indexCount);
+    virtual void listenRendererRecreated(EventCustom* event);
+
     bool _active;
     int  _reuseGrid;
     Size _gridSize;
@@ -142,9 +158,20 @@ protected:
     Vec2 _step;
     Grabber *_grabber;
     bool _isTextureFlipped;
+    // the texture was created by the grid, it goes back to the RenderTargetPool
+    bool _isTexturePooled;
     GLProgram* _shaderProgram;
     Director::Projection _directorProjection;
     Rect _gridRect;
+    // the positions, the texture coordinates and the indices
+    GLuint _buffersVBO[3];
+    // the vertices were set since the last blit
+    bool _vertexBufferDirty;
+    // the texture coordinates and the indices were calculated again
+    bool _buffersDirty;
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+    EventListenerCustom* _rendererRecreatedListener;
+#endif
 };
 
 /**
@@ -213,7 +240,27 @@ public:
     void setNeedDepthTestForBlit( bool neededDepthTest) { _needDepthTestForBlit = neededDepthTest; }
     bool getNeedDepthTestForBlit() const { return _needDepthTestForBlit; }
     /**@}*/
+
+    /**
+     * @brief Draws the grid with a vertex shader moving its vertices, instead of setting them with setVertex().
+     * The CPU then only sets the uniforms of the shader, the vertices are those of getVertex().
+     * The shader has the attributes, varyings and builtin uniforms of ccShader_PositionTexture.vert, the
+     * fragment shader is the one of the grid.
+     *
+     * @param key The key of the program in GLProgramCache, it's created the first time.
+     * @param vertexShader The source of the shader, nullptr to draw the vertices as they are.
+     * @return The state holding the uniforms of the shader, nullptr if it doesn't compile.
+     * @since v3.14
+     */
+    GLProgramState* setVertexShader(const std::string& key, const char* vertexShader);
+    /** The state of the vertex shader set by setVertexShader(), nullptr if there is none.
+     * @since v3.14
+     */
+    GLProgramState* getVertexShaderState() const { return _vertexShaderState; }
+
 protected:
+    virtual void listenRendererRecreated(EventCustom* event) override;
+
     GLvoid *_texCoordinates;
     GLvoid *_vertices;
     GLvoid *_originalVertices;
@@ -221,6 +268,8 @@ protected:
     bool _needDepthTestForBlit;
     bool _oldDepthTestValue;
     bool _oldDepthWriteValue;
+    GLProgramState* _vertexShaderState;
+    std::string _vertexShaderSource;
 };
 
 /**
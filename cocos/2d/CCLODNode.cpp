@@ -0,0 +1,189 @@
+/****************************************************************************
+Copyright (c) 2017 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+
+#include "2d/CCLODNode.h"
+#include "2d/CCCamera.h"
+#include "base/CCDirector.h"
+
+NS_CC_BEGIN
+
+LODNode* LODNode::create()
+{
+    LODNode* ret = new (std::nothrow) LODNode();
+    if (ret && ret->init())
+    {
+        ret->autorelease();
+        return ret;
+    }
+    CC_SAFE_DELETE(ret);
+    return nullptr;
+}
+
+LODNode::LODNode()
+: _currentLevel(-1)
+, _hysteresis(0.1f)
+, _screenScale(1.0f)
+{
+}
+
+LODNode::~LODNode()
+{
+}
+
+void LODNode::addLevel(Node* node, float minScale, int zOrder)
+{
+    CCASSERT(node != nullptr && node->getParent() == nullptr, "The representation of a level can't have a parent");
+    CCASSERT(_minScales.empty() || minScale < _minScales.back(), "The levels must be added from the most detailed one");
+
+    _levels.pushBack(node);
+    _minScales.push_back(minScale);
+    _zOrders.push_back(zOrder);
+
+    // the first level is shown until the node is visited
+    if (_currentLevel == -1 && _levels.size() == 1)
+    {
+        setCurrentLevel(0);
+    }
+}
+
+void LODNode::removeAllLevels(bool cleanup)
+{
+    if (_currentLevel != -1)
+    {
+        removeChild(_levels.at(_currentLevel), cleanup);
+        _currentLevel = -1;
+    }
+
+    // the detached levels aren't running, only their callbacks and actions are left
+    if (cleanup)
+    {
+        for (auto& level : _levels)
+        {
+            if (level->getParent() == nullptr)
+                level->cleanup();
+        }
+    }
+
+    _levels.clear();
+    _minScales.clear();
+    _zOrders.clear();
+}
+
+float LODNode::computeScreenScale(const Mat4& nodeToWorld) const
+{
+    const Camera* camera = Camera::getVisitingCamera();
+    if (camera == nullptr)
+    {
+        camera = Camera::getDefaultCamera();
+    }
+    if (camera == nullptr)
+    {
+        return _screenScale;
+    }
+
+    Mat4 nodeToClip = camera->getViewProjectionMatrix() * nodeToWorld;
+    Vec4 origin, unitX, unitY;
+    nodeToClip.transformVector(Vec4(0, 0, 0, 1), &origin);
+    nodeToClip.transformVector(Vec4(1, 0, 0, 1), &unitX);
+    nodeToClip.transformVector(Vec4(0, 1, 0, 1), &unitY);
+
+    // behind the camera
+    if (origin.w <= 0 || unitX.w <= 0 || unitY.w <= 0)
+    {
+        return 0;
+    }
+
+    // from normalized device coordinates to design resolution points
+    const Size& winSize = Director::getInstance()->getWinSize();
+    Vec2 originPoints(origin.x / origin.w * winSize.width * 0.5f, origin.y / origin.w * winSize.height * 0.5f);
+    Vec2 unitXPoints(unitX.x / unitX.w * winSize.width * 0.5f, unitX.y / unitX.w * winSize.height * 0.5f);
+    Vec2 unitYPoints(unitY.x / unitY.w * winSize.width * 0.5f, unitY.y / unitY.w * winSize.height * 0.5f);
+
+    return std::max(originPoints.distance(unitXPoints), originPoints.distance(unitYPoints));
+}
+
+ssize_t LODNode::selectLevel(float screenScale) const
+{
+    // the current level is kept below its threshold, a more detailed level needs a margin above its threshold
+    ssize_t current = _currentLevel == -1 ? _levels.size() : _currentLevel;
+    for (ssize_t i = 0; i < _levels.size(); ++i)
+    {
+        float margin = i < current ? 1.0f + _hysteresis : 1.0f - _hysteresis;
+        if (screenScale >= _minScales[i] * margin)
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+void LODNode::setCurrentLevel(ssize_t level)
+{
+    // the representation may also have been removed with removeChild()
+    if (level == _currentLevel && (level == -1 || _levels.at(level)->getParent() == this))
+        return;
+
+    // detached, the representation is retained by _levels
+    if (_currentLevel != -1 && _levels.at(_currentLevel)->getParent() == this)
+    {
+        removeChild(_levels.at(_currentLevel), false);
+    }
+
+    _currentLevel = level;
+
+    if (_currentLevel != -1)
+    {
+        addChild(_levels.at(_currentLevel), _zOrders[_currentLevel]);
+    }
+}
+
+void LODNode::visit(Renderer *renderer, const Mat4 &parentTransform, uint32_t parentFlags)
+{
+    if (!_visible)
+    {
+        return;
+    }
+
+    if (!_levels.empty())
+    {
+        _screenScale = computeScreenScale(transform(parentTransform));
+        setCurrentLevel(selectLevel(_screenScale));
+    }
+
+    Node::visit(renderer, parentTransform, parentFlags);
+}
+
+void LODNode::cleanup()
+{
+    Node::cleanup();
+
+    for (auto& level : _levels)
+    {
+        if (level->getParent() == nullptr)
+            level->cleanup();
+    }
+}
+
+NS_CC_END
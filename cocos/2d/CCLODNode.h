@@ -0,0 +1,131 @@
+/****************************************************************************
+Copyright (c) 2017 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#ifndef __CCLOD_NODE_H__
+#define __CCLOD_NODE_H__
+
+#include "2d/CCNode.h"
+#include "base/CCVector.h"
+
+NS_CC_BEGIN
+
+/**
+ * @addtogroup _2d
+ * @{
+ */
+
+/** @class LODNode
+ * @brief A node that shows one of several representations of its content, according to its scale on the screen.
+
+The levels are ordered from the most detailed representation to the simplest one, e.g. the full sprite with its
+labels and effects, then a small sprite, then an impostor. A level is used while the on-screen scale of the node is
+at least the minimum scale of the level, nothing is shown below the minimum scale of the last level.
+
+The on-screen scale is the size, in design resolution points, of a unit of the node seen through the camera
+visiting it. It is 1 for a node that isn't scaled, seen through the default camera. The hysteresis keeps the
+level from flickering when the scale stays around a threshold.
+
+Only the current level is a child of the node, the other ones are detached: they skip the scheduler, the actions,
+the events and the visit until they are used again, so zoomed out views stay cheap. Their onExit() and onEnter()
+are called when they are switched. The children added with addChild() are always shown.
+@since v3.14
+*/
+class CC_DLL LODNode : public Node
+{
+public:
+    /** Creates a LOD node without level.
+     *
+     * @return An autoreleased LODNode object.
+     */
+    static LODNode* create();
+
+    /** Adds a level, simpler than the levels already added.
+     *
+     * @param node The representation of the level, it shouldn't have a parent.
+     * @param minScale The on-screen scale from which the level is used, smaller than the one of the previous level.
+     * @param zOrder The local z-order of the representation.
+     */
+    void addLevel(Node* node, float minScale, int zOrder = 0);
+
+    /** Removes all the levels.
+     *
+     * @param cleanup Whether the actions and the callbacks of the representations are cleaned up.
+     */
+    void removeAllLevels(bool cleanup = true);
+
+    /** Returns the number of levels. */
+    ssize_t getLevelCount() const { return _levels.size(); }
+
+    /** Returns the representation of a level. */
+    Node* getLevelNode(ssize_t level) const { return _levels.at(level); }
+
+    /** Returns the minimum on-screen scale of a level. */
+    float getLevelMinScale(ssize_t level) const { return _minScales.at(level); }
+
+    /** Returns the level shown, or -1 if the node is too small on the screen for the last level. */
+    ssize_t getCurrentLevel() const { return _currentLevel; }
+
+    /** Sets the relative margin around the thresholds, 0.1 by default.
+     * A more detailed level is used from 1 + hysteresis times its minimum scale, and kept until
+     * 1 - hysteresis times its minimum scale.
+     */
+    void setHysteresis(float hysteresis) { _hysteresis = hysteresis; }
+    float getHysteresis() const { return _hysteresis; }
+
+    /** Returns the on-screen scale computed at the last visit. */
+    float getScreenScale() const { return _screenScale; }
+
+    //
+    // Overrides
+    //
+    virtual void visit(Renderer *renderer, const Mat4 &parentTransform, uint32_t parentFlags) override;
+    virtual void cleanup() override;
+
+CC_CONSTRUCTOR_ACCESS:
+    LODNode();
+    virtual ~LODNode();
+
+protected:
+    // the on-screen scale of a unit of the node through the visiting camera
+    float computeScreenScale(const Mat4& nodeToWorld) const;
+    ssize_t selectLevel(float screenScale) const;
+    void setCurrentLevel(ssize_t level);
+
+    Vector<Node*> _levels;
+    std::vector<float> _minScales;
+    std::vector<int> _zOrders;
+    ssize_t _currentLevel;
+    float _hysteresis;
+    float _screenScale;
+
+private:
+    CC_DISALLOW_COPY_AND_ASSIGN(LODNode);
+};
+
+// end of _2d group
+/// @}
+
+NS_CC_END
+
+#endif //__CCLOD_NODE_H__
@@ -38,14 +38,23 @@
 #include "platform/CCFileUtils.h"
 #include "renderer/CCRenderer.h"
 #include "renderer/ccGLStateCache.h"
+#include "renderer/CCGLProgramCache.h"
+#include "renderer/CCGLProgramState.h"
+#include "renderer/CCTextureCache.h"
 #include "base/CCDirector.h"
 #include "base/CCEventListenerCustom.h"
 #include "base/CCEventDispatcher.h"
 #include "base/CCEventCustom.h"
 #include "2d/CCFontFNT.h"
 
+#if CC_ENABLE_ALLOCATOR && CC_ENABLE_ENGINE_ALLOCATOR_POOLS
+#include "base/allocator/CCAllocatorStrategyPool.h"
+#endif
+
 NS_CC_BEGIN
 
+CC_DEFINE_ALLOCATOR_POOL(Label, 64)
+
 /**
  * LabelLetter used to update the quad in texture atlas without SpriteBatchNode.
  */
@@ -384,6 +393,10 @@ Label::Label(TextHAlignment hAlignment /* = TextHAlignment::LEFT */,
 , _boldEnabled(false)
 , _underlineNode(nullptr)
 , _strikethroughEnabled(false)
+, _layoutCacheSize(0)
+, _labelBatch(nullptr)
+, _drawnQueueGeneration(0)
+, _systemFontAsyncRendering(false)
 {
     setAnchorPoint(Vec2::ANCHOR_MIDDLE);
     reset();
@@ -403,6 +416,7 @@ Label::Label(TextHAlignment hAlignment /* = TextHAlignment::LEFT */,
                 it.second->setTexture(nullptr);
             }
             _batchNodes.clear();
+            _layoutCache.clear();
 
             if (_fontAtlas)
             {
@@ -429,6 +443,17 @@ Label::Label(TextHAlignment hAlignment /* = TextHAlignment::LEFT */,
         }
     });
     _eventDispatcher->addEventListenerWithFixedPriority(_resetTextureListener, 2);
+
+    // the glyphs rasterized asynchronously are ready
+    _updateTextureListener = EventListenerCustom::create(FontAtlas::CMD_UPDATE_FONTATLAS, [this](EventCustom* event){
+        if (_fontAtlas && _currentLabelType == LabelType::TTF && event->getUserData() == _fontAtlas)
+        {
+            // the glyphs of the cached layouts may have moved
+            _layoutCache.clear();
+            _contentDirty = true;
+        }
+    });
+    _eventDispatcher->addEventListenerWithFixedPriority(_updateTextureListener, 3);
 }
 
 Label::~Label()
@@ -444,6 +469,7 @@ Label::~Label()
     }
     _eventDispatcher->removeEventListener(_purgeTextureListener);
     _eventDispatcher->removeEventListener(_resetTextureListener);
+    _eventDispatcher->removeEventListener(_updateTextureListener);
 
     CC_SAFE_RELEASE_NULL(_textSprite);
     CC_SAFE_RELEASE_NULL(_shadowNode);
@@ -458,6 +484,7 @@ void Label::reset()
     _letters.clear();
     _batchNodes.clear();
     _lettersInfo.clear();
+    _layoutCache.clear();
     if (_fontAtlas)
     {
         FontAtlasCache::releaseFontAtlas(_fontAtlas);
@@ -666,11 +693,8 @@ void Label::setString(const std::string& text)
         _utf8Text = text;
         _contentDirty = true;
 
-        std::u32string utf32String;
-        if (StringUtils::UTF8ToUTF32(_utf8Text, utf32String))
-        {
-            _utf32Text  = utf32String;
-        }
+        // converts in place, _utf32Text is left untouched if _utf8Text isn't valid UTF8
+        StringUtils::UTF8ToUTF32(_utf8Text, _utf32Text);
     }
 }
 
@@ -969,6 +993,143 @@ bool Label::updateQuads()
     return ret;
 }
 
+void Label::setLayoutCacheSize(unsigned int size)
+{
+    _layoutCacheSize = size;
+    if (_layoutCache.size() > size)
+    {
+        _layoutCache.resize(size);
+    }
+}
+
+bool Label::LayoutSettings::operator==(const LayoutSettings& other) const
+{
+    return fontAtlas == other.fontAtlas && lineHeight == other.lineHeight && lineSpacing == other.lineSpacing
+        && additionalKerning == other.additionalKerning && maxLineWidth == other.maxLineWidth
+        && labelWidth == other.labelWidth && labelHeight == other.labelHeight && bmfontScale == other.bmfontScale
+        && hAlignment == other.hAlignment && vAlignment == other.vAlignment && overflow == other.overflow
+        && lineBreakWithoutSpaces == other.lineBreakWithoutSpaces && enableWrap == other.enableWrap;
+}
+
+Label::LayoutSettings Label::getLayoutSettings() const
+{
+    LayoutSettings settings;
+    settings.fontAtlas = _fontAtlas;
+    settings.lineHeight = _lineHeight;
+    settings.lineSpacing = _lineSpacing;
+    settings.additionalKerning = _additionalKerning;
+    settings.maxLineWidth = _maxLineWidth;
+    settings.labelWidth = _labelWidth;
+    settings.labelHeight = _labelHeight;
+    settings.bmfontScale = _bmfontScale;
+    settings.hAlignment = _hAlignment;
+    settings.vAlignment = _vAlignment;
+    settings.overflow = _overflow;
+    settings.lineBreakWithoutSpaces = _lineBreakWithoutSpaces;
+    settings.enableWrap = _enableWrap;
+    return settings;
+}
+
+bool Label::restoreCachedLayout()
+{
+    // shrinking changes the font size during the layout
+    if (_layoutCacheSize == 0 || _overflow == Overflow::SHRINK || _utf32Text.empty())
+    {
+        return false;
+    }
+
+    auto settings = getLayoutSettings();
+    if (_layoutCache.empty() || !(settings == _layoutCacheSettings))
+    {
+        _layoutCache.clear();
+        _layoutCacheSettings = settings;
+        return false;
+    }
+
+    auto it = std::find_if(_layoutCache.begin(), _layoutCache.end(), [this](const LayoutCacheEntry& entry) {
+        return entry.text == _utf8Text;
+    });
+    if (it == _layoutCache.end())
+    {
+        return false;
+    }
+
+    // the glyphs are also marked as used by the atlas, if some are missing the layouts are outdated
+    if (_fontAtlas->prepareLetterDefinitions(_utf32Text) || it->quads.size() > static_cast<size_t>(_batchNodes.size()))
+    {
+        _layoutCache.clear();
+        return false;
+    }
+
+    std::rotate(_layoutCache.begin(), it, it + 1);
+    auto& entry = _layoutCache.front();
+
+    for (ssize_t index = 0; index < _batchNodes.size(); ++index)
+    {
+        auto textureAtlas = _batchNodes.at(index)->getTextureAtlas();
+        textureAtlas->removeAllQuads();
+        if (static_cast<size_t>(index) < entry.quads.size() && !entry.quads[index].empty())
+        {
+            auto& quads = entry.quads[index];
+            auto count = static_cast<ssize_t>(quads.size());
+            if (textureAtlas->getCapacity() < count)
+            {
+                textureAtlas->resizeCapacity(count);
+            }
+            textureAtlas->insertQuads(quads.data(), 0, count);
+        }
+    }
+
+    _lettersInfo = entry.lettersInfo;
+    _linesWidth = entry.linesWidth;
+    _linesOffsetX = entry.linesOffsetX;
+    _numberOfLines = entry.numberOfLines;
+    _lengthOfString = entry.lengthOfString;
+    _textDesiredHeight = entry.textDesiredHeight;
+    _letterOffsetY = entry.letterOffsetY;
+    _tailoredTopY = entry.tailoredTopY;
+    _tailoredBottomY = entry.tailoredBottomY;
+    setContentSize(entry.contentSize);
+
+    updateLabelLetters();
+    updateColor();
+    return true;
+}
+
+void Label::storeCachedLayout()
+{
+    if (_layoutCacheSize == 0 || _overflow == Overflow::SHRINK || _utf32Text.empty() || _batchNodes.empty())
+    {
+        return;
+    }
+
+    if (_layoutCache.size() >= _layoutCacheSize)
+    {
+        _layoutCache.pop_back();
+    }
+    _layoutCache.insert(_layoutCache.begin(), LayoutCacheEntry());
+    auto& entry = _layoutCache.front();
+
+    entry.text = _utf8Text;
+    entry.lettersInfo = _lettersInfo;
+    entry.quads.resize(_batchNodes.size());
+    for (ssize_t index = 0; index < _batchNodes.size(); ++index)
+    {
+        auto textureAtlas = _batchNodes.at(index)->getTextureAtlas();
+        auto quads = textureAtlas->getQuads();
+        entry.quads[index].assign(quads, quads + textureAtlas->getTotalQuads());
+    }
+    entry.linesWidth = _linesWidth;
+    entry.linesOffsetX = _linesOffsetX;
+    entry.numberOfLines = _numberOfLines;
+    entry.lengthOfString = _lengthOfString;
+    entry.textDesiredHeight = _textDesiredHeight;
+    entry.letterOffsetY = _letterOffsetY;
+    entry.tailoredTopY = _tailoredTopY;
+    entry.tailoredBottomY = _tailoredBottomY;
+    entry.contentSize = _contentSize;
+}
+
 bool Label::setTTFConfigInternal(const TTFConfig& ttfConfig)
 {
     FontAtlas *newAtlas = FontAtlasCache::getFontAtlasTTF(&ttfConfig);
@@ -1258,8 +1419,18 @@ void Label::createSpriteForSystemFont(const FontDefinition& fontDef)
 {
     _currentLabelType = LabelType::STRING_TEXTURE;
 
-    auto texture = new (std::nothrow) Texture2D;
-    texture->initWithString(_utf8Text.c_str(), fontDef);
+    auto texture = getSystemFontTexture(fontDef);
+    if (texture == nullptr)
+    {
+        if (_systemFontAsyncRendering && !_utf8Text.empty())
+        {
+            // the sprite is created once the string is rendered
+            return;
+        }
+        // an empty string, or one that can't be rendered
+        texture = new (std::nothrow) Texture2D;
+        texture->autorelease();
+    }
 
     _textSprite = Sprite::createWithTexture(texture);
     //set camera mask using label's camera mask, because _textSprite may be null when setting camera mask to label
@@ -1267,7 +1438,6 @@ void Label::createSpriteForSystemFont(const FontDefinition& fontDef)
     _textSprite->setGlobalZOrder(getGlobalZOrder());
     _textSprite->setAnchorPoint(Vec2::ANCHOR_BOTTOM_LEFT);
     this->setContentSize(_textSprite->getContentSize());
-    texture->release();
     if (_blendFuncDirty)
     {
         _textSprite->setBlendFunc(_blendFunc);
@@ -1296,10 +1466,11 @@ void Label::createShadowSpriteForSystemFont(const FontDefinition& fontDef)
         shadowFontDefinition._stroke._strokeColor = shadowFontDefinition._fontFillColor;
         shadowFontDefinition._stroke._strokeAlpha = shadowFontDefinition._fontAlpha;
 
-        auto texture = new (std::nothrow) Texture2D;
-        texture->initWithString(_utf8Text.c_str(), shadowFontDefinition);
-        _shadowNode = Sprite::createWithTexture(texture);
-        texture->release();
+        auto texture = getSystemFontTexture(shadowFontDefinition);
+        if (texture)
+        {
+            _shadowNode = Sprite::createWithTexture(texture);
+        }
     }
 
     if (_shadowNode)
@@ -1319,6 +1490,30 @@ void Label::createShadowSpriteForSystemFont(const FontDefinition& fontDef)
     }
 }
 
+Texture2D* Label::getSystemFontTexture(const FontDefinition& fontDef)
+{
+    auto textureCache = _director->getTextureCache();
+    if (!_systemFontAsyncRendering)
+    {
+        return textureCache->getTextureForText(_utf8Text, fontDef);
+    }
+
+    auto texture = textureCache->getCachedTextureForText(_utf8Text, fontDef);
+    if (texture == nullptr && !_utf8Text.empty())
+    {
+        // updates the label again once the string is rendered, it is found in the cache then
+        this->retain();
+        textureCache->getTextureForTextAsync(_utf8Text, fontDef, [this](Texture2D* rendered) {
+            if (rendered)
+            {
+                _contentDirty = true;
+            }
+            this->release();
+        });
+    }
+    return texture;
+}
+
 void Label::setCameraMask(unsigned short mask, bool applyChildren)
 {
     Node::setCameraMask(mask, applyChildren);
@@ -1387,20 +1582,24 @@ void Label::updateContent()
 
     if (_fontAtlas)
     {
-        std::u32string utf32String;
-        if (StringUtils::UTF8ToUTF32(_utf8Text, utf32String))
+        // converts in place, _utf32Text is left untouched if _utf8Text isn't valid UTF8
+        StringUtils::UTF8ToUTF32(_utf8Text, _utf32Text);
+
+        if (!restoreCachedLayout())
         {
-            _utf32Text = utf32String;
+            computeHorizontalKernings(_utf32Text);
+            updateFinished = alignText();
+            if (updateFinished)
+            {
+                storeCachedLayout();
+            }
         }
-
-        computeHorizontalKernings(_utf32Text);
-        updateFinished = alignText();
     }
     else
     {
         auto fontDef = _getFontDefinition();
         createSpriteForSystemFont(fontDef);
-        if (_shadowEnabled)
+        if (_shadowEnabled && _textSprite)
         {
             createShadowSpriteForSystemFont(fontDef);
         }
@@ -1589,7 +1788,10 @@ void Label::draw(Renderer *renderer, const Mat4 &transform, uint32_t flags)
 #if CC_USE_CULLING
     auto visitingCamera = Camera::getVisitingCamera();
     auto defaultCamera = Camera::getDefaultCamera();
-    if (visitingCamera == defaultCamera) {
+    if (!renderer->isCullingEnabled()) {
+        _insideBounds = true;
+    }
+    else if (visitingCamera == defaultCamera) {
         _insideBounds = (transformUpdated || visitingCamera->isViewProjectionUpdated()) ? renderer->checkVisibility(transform, _contentSize) : _insideBounds;
     }
     else
@@ -1600,6 +1802,15 @@ void Label::draw(Renderer *renderer, const Mat4 &transform, uint32_t flags)
     if (_insideBounds)
 #endif
     {
+        if (_labelBatch && appendToBatch(transform))
+        {
+            return;
+        }
+
+        // the own commands are still queued when the label is drawn twice in a frame
+        bool useTransientCommands = _drawnQueueGeneration == renderer->getQueueGeneration();
+        _drawnQueueGeneration = renderer->getQueueGeneration();
+
         if (!_shadowEnabled && (_currentLabelType == LabelType::BMFONT || _currentLabelType == LabelType::CHARMAP))
         {
             for (auto&& it : _letters)
@@ -1609,18 +1820,83 @@ void Label::draw(Renderer *renderer, const Mat4 &transform, uint32_t flags)
             // ETC1 ALPHA supports for BMFONT & CHARMAP
             auto textureAtlas = _batchNodes.at(0)->getTextureAtlas();
             auto texture = textureAtlas->getTexture();
-            _quadCommand.init(_globalZOrder, texture, getGLProgramState(), 
+            auto quadCommand = useTransientCommands ? renderer->generateTransientQuadCommand() : &_quadCommand;
+            quadCommand->init(_globalZOrder, texture, getGLProgramState(),
                 _blendFunc, textureAtlas->getQuads(), textureAtlas->getTotalQuads(), transform, flags);
-            renderer->addCommand(&_quadCommand);
+            renderer->addCommand(quadCommand);
         }
         else
         {
-            _customCommand.init(_globalZOrder, transform, flags);
-            _customCommand.func = CC_CALLBACK_0(Label::onDraw, this, transform, transformUpdated);
+            auto customCommand = useTransientCommands ? renderer->generateTransientCustomCommand() : &_customCommand;
+            customCommand->init(_globalZOrder, transform, flags);
+            customCommand->func = CC_CALLBACK_0(Label::onDraw, this, transform, transformUpdated);
+
+            renderer->addCommand(customCommand);
+        }
+    }
+}
+
+bool Label::appendToBatch(const Mat4& transform)
+{
+    const char* programName = nullptr;
+    if (_currentLabelType == LabelType::TTF)
+    {
+        if (_currLabelEffect == LabelEffect::OUTLINE)
+            programName = GLProgram::SHADER_NAME_LABEL_OUTLINE_NO_MVP;
+        else if (_currLabelEffect == LabelEffect::NORMAL)
+            programName = _useDistanceField ? GLProgram::SHADER_NAME_LABEL_DISTANCEFIELD_NORMAL_NO_MVP : GLProgram::SHADER_NAME_LABEL_NORMAL_NO_MVP;
+        else
+            return false;
+    }
+    else if (_shadowEnabled || (_currentLabelType != LabelType::BMFONT && _currentLabelType != LabelType::CHARMAP))
+    {
+        return false;
+    }
+
+    for (auto&& it : _letters)
+    {
+        it.second->updateTransform();
+    }
+
+    bool outline = _currLabelEffect == LabelEffect::OUTLINE;
+    for (auto&& batchNode : _batchNodes)
+    {
+        auto textureAtlas = batchNode->getTextureAtlas();
+        auto quads = textureAtlas->getQuads();
+        auto count = textureAtlas->getTotalQuads();
+        if (count == 0)
+        {
+            continue;
+        }
+        auto texture = textureAtlas->getTexture();
+
+        if (programName == nullptr)
+        {
+            // BMFONT & CHARMAP use the noMVP shader already
+            _labelBatch->appendQuads(LabelBatchNode::Pass::TEXT, texture, getGLProgramState(), _blendFunc,
+                quads, count, transform, Color4F::WHITE);
+            continue;
+        }
 
-            renderer->addCommand(&_customCommand);
+        // same passes as onDraw, the colors of the uniforms are baked into the vertices
+        if (_shadowEnabled)
+        {
+            _labelBatch->appendQuads(LabelBatchNode::Pass::SHADOW, texture,
+                LabelBatchNode::getPassGLProgramState(programName, outline ? 2 : 0), _blendFunc,
+                quads, count, _shadowTransform, _boldEnabled ? _textColorF : _shadowColor4F);
         }
+        if (outline)
+        {
+            _labelBatch->appendQuads(LabelBatchNode::Pass::OUTLINE, texture,
+                LabelBatchNode::getPassGLProgramState(programName, 1), _blendFunc,
+                quads, count, transform, _effectColorF);
+        }
+        _labelBatch->appendQuads(LabelBatchNode::Pass::TEXT, texture,
+            LabelBatchNode::getPassGLProgramState(programName, 0), _blendFunc,
+            quads, count, transform, _textColorF);
     }
+
+    return true;
 }
 
 void Label::visit(Renderer *renderer, const Mat4 &parentTransform, uint32_t parentFlags)
@@ -2212,4 +2488,233 @@ void Label::updateLetterSpriteScale(Sprite* sprite)
     }
 }
 
+//
+// LabelBatchNode
+//
+namespace
+{
+    // the indices of the batches are unsigned short and a command must fit in the VBO of the renderer
+    const ssize_t LABEL_BATCH_MAX_QUADS = Renderer::VBO_SIZE / 4;
+}
+
+LabelBatchNode* LabelBatchNode::create()
+{
+    auto ret = new (std::nothrow) LabelBatchNode();
+    if (ret && ret->init())
+    {
+        ret->autorelease();
+        return ret;
+    }
+
+    CC_SAFE_DELETE(ret);
+    return nullptr;
+}
+
+LabelBatchNode::LabelBatchNode()
+: _usedBatches(0)
+, _visitBatches(0)
+, _lastFrame(0)
+{
+}
+
+LabelBatchNode::~LabelBatchNode()
+{
+    for (auto&& child : _children)
+    {
+        auto label = dynamic_cast<Label*>(child);
+        if (label)
+        {
+            label->_labelBatch = nullptr;
+        }
+    }
+
+    for (auto&& batch : _batches)
+    {
+        delete batch;
+    }
+}
+
+void LabelBatchNode::addChild(Node* child, int localZOrder, int tag)
+{
+    CCASSERT(child != nullptr, "child should not be null");
+    Node::addChild(child, localZOrder, tag);
+
+    auto label = dynamic_cast<Label*>(child);
+    if (label)
+    {
+        label->_labelBatch = this;
+    }
+}
+
+void LabelBatchNode::addChild(Node* child, int localZOrder, const std::string& name)
+{
+    CCASSERT(child != nullptr, "child should not be null");
+    Node::addChild(child, localZOrder, name);
+
+    auto label = dynamic_cast<Label*>(child);
+    if (label)
+    {
+        label->_labelBatch = this;
+    }
+}
+
+void LabelBatchNode::removeChild(Node* child, bool cleanup)
+{
+    auto label = dynamic_cast<Label*>(child);
+    if (label && label->_labelBatch == this)
+    {
+        label->_labelBatch = nullptr;
+    }
+
+    Node::removeChild(child, cleanup);
+}
+
+void LabelBatchNode::removeAllChildrenWithCleanup(bool cleanup)
+{
+    for (auto&& child : _children)
+    {
+        auto label = dynamic_cast<Label*>(child);
+        if (label)
+        {
+            label->_labelBatch = nullptr;
+        }
+    }
+
+    Node::removeAllChildrenWithCleanup(cleanup);
+}
+
+void LabelBatchNode::visit(Renderer* renderer, const Mat4& parentTransform, uint32_t parentFlags)
+{
+    if (!_visible)
+    {
+        return;
+    }
+
+    // the commands of the previous frame have been rendered, their batches can be refilled
+    auto frame = _director->getTotalFrames();
+    if (frame != _lastFrame)
+    {
+        _lastFrame = frame;
+        _usedBatches = 0;
+    }
+    _visitBatches = _usedBatches;
+
+    // the labels append their letters from Label::draw
+    Node::visit(renderer, parentTransform, parentFlags);
+
+    std::stable_sort(_batches.begin() + _visitBatches, _batches.begin() + _usedBatches, [](const Batch* a, const Batch* b) {
+        return a->pass < b->pass;
+    });
+
+    for (auto i = _visitBatches; i < _usedBatches; ++i)
+    {
+        auto batch = _batches[i];
+        TrianglesCommand::Triangles triangles;
+        triangles.verts = batch->vertices.data();
+        triangles.vertCount = (int)batch->vertices.size();
+        triangles.indices = batch->indices.data();
+        triangles.indexCount = (int)batch->indices.size();
+
+        // the vertices are in world space already
+        batch->command.init(_globalZOrder, batch->texture, batch->glProgramState, batch->blendFunc, triangles, Mat4::IDENTITY, 0);
+        renderer->addCommand(&batch->command);
+    }
+}
+
+void LabelBatchNode::appendQuads(Pass pass, Texture2D* texture, GLProgramState* glProgramState, const BlendFunc& blendFunc,
+                                 const V3F_C4B_T2F_Quad* quads, ssize_t count, const Mat4& transform, const Color4F& color)
+{
+    while (count > 0)
+    {
+        Batch* batch = nullptr;
+        for (auto i = _visitBatches; i < _usedBatches; ++i)
+        {
+            auto candidate = _batches[i];
+            if (candidate->pass == pass && candidate->texture == texture && candidate->glProgramState == glProgramState
+                && candidate->blendFunc == blendFunc && (ssize_t)candidate->vertices.size() < LABEL_BATCH_MAX_QUADS * 4)
+            {
+                batch = candidate;
+                break;
+            }
+        }
+
+        if (batch == nullptr)
+        {
+            if (_usedBatches == _batches.size())
+            {
+                _batches.push_back(new (std::nothrow) Batch());
+            }
+            batch = _batches[_usedBatches++];
+            batch->pass = pass;
+            batch->texture = texture;
+            batch->glProgramState = glProgramState;
+            batch->blendFunc = blendFunc;
+            batch->vertices.clear();
+            batch->indices.clear();
+        }
+
+        auto quadCount = std::min(count, LABEL_BATCH_MAX_QUADS - (ssize_t)batch->vertices.size() / 4);
+        bool tinted = color != Color4F::WHITE;
+        auto firstVertex = batch->vertices.size();
+        for (ssize_t i = 0; i < quadCount; ++i)
+        {
+            auto first = (unsigned short)batch->vertices.size();
+            const V3F_C4B_T2F* corners = &quads[i].tl;
+            for (int j = 0; j < 4; ++j)
+            {
+                V3F_C4B_T2F vertex = corners[j];
+                if (tinted)
+                {
+                    vertex.colors.r = (GLubyte)(vertex.colors.r * color.r);
+                    vertex.colors.g = (GLubyte)(vertex.colors.g * color.g);
+                    vertex.colors.b = (GLubyte)(vertex.colors.b * color.b);
+                    vertex.colors.a = (GLubyte)(vertex.colors.a * color.a);
+                }
+                batch->vertices.push_back(vertex);
+            }
+
+            // same triangles as QuadCommand
+            batch->indices.push_back(first);
+            batch->indices.push_back(first + 1);
+            batch->indices.push_back(first + 2);
+            batch->indices.push_back(first + 3);
+            batch->indices.push_back(first + 2);
+            batch->indices.push_back(first + 1);
+        }
+        if (quadCount > 0)
+        {
+            transform.transformPoints(&batch->vertices[firstVertex].vertices, quadCount * 4, sizeof(V3F_C4B_T2F));
+        }
+
+        quads += quadCount;
+        count -= quadCount;
+    }
+}
+
+GLProgramState* LabelBatchNode::getPassGLProgramState(const char* programName, int effectType)
+{
+    // the states are shared by all the batches so that the renderer can merge the consecutive commands
+    static std::unordered_map<std::string, GLProgramState*> s_passStates;
+
+    auto key = StringUtils::format("%s_%d", programName, effectType);
+    auto it = s_passStates.find(key);
+    if (it != s_passStates.end())
+    {
+        return it->second;
+    }
+
+    auto glProgram = GLProgramCache::getInstance()->getGLProgram(programName);
+    auto state = GLProgramState::create(glProgram);
+    state->retain();
+    state->setUniformVec4("u_textColor", Vec4(1.0f, 1.0f, 1.0f, 1.0f));
+    if (strcmp(programName, GLProgram::SHADER_NAME_LABEL_OUTLINE_NO_MVP) == 0)
+    {
+        state->setUniformVec4("u_effectColor", Vec4(1.0f, 1.0f, 1.0f, 1.0f));
+        state->setUniformInt("u_effectType", effectType);
+    }
+    s_passStates.emplace(key, state);
+
+    return state;
+}
+
 NS_CC_END
@@ -29,6 +29,7 @@
 #include "2d/CCNode.h"
 #include "renderer/CCCustomCommand.h"
 #include "renderer/CCQuadCommand.h"
+#include "renderer/CCTrianglesCommand.h"
 #include "2d/CCFontAtlas.h"
 #include "base/ccTypes.h"
 
@@ -92,6 +93,7 @@ class Sprite;
 class SpriteBatchNode;
 class DrawNode;
 class EventListenerCustom;
+class LabelBatchNode;
 
 /**
  * @brief Label is a subclass of Node that knows how to render text labels.
@@ -112,6 +114,8 @@ class EventListenerCustom;
 class CC_DLL Label : public Node, public LabelProtocol, public BlendProtocol
 {
 public:
+    CC_DECLARE_ALLOCATOR_POOL(Label)
+
     enum class Overflow
     {
         //In NONE mode, the dimensions is (0,0) and the content size will change dynamically to fit the label.
@@ -567,6 +571,27 @@ public:
      */
     float getAdditionalKerning() const;
 
+    /**
+     * Sets how many layouts of the Label are cached by text, 0 by default.
+     * A cached layout is reused while the font, the dimensions, the overflow, the alignment and the spacing of
+     * the Label don't change, e.g. by a score or a timer switching between a few strings.
+     *
+     * @warning Not support system font and Overflow::SHRINK.
+     */
+    void setLayoutCacheSize(unsigned int size);
+    unsigned int getLayoutCacheSize() const { return _layoutCacheSize; }
+
+    /**
+     * Renders the string of a system font Label on a JobSystem worker instead of the cocos thread, disabled by default.
+     * Until it is rendered the Label shows nothing, unless the texture of the string is already cached.
+     * Either way, the Labels showing the same string with the same system font share a texture of the TextureCache.
+     *
+     * @see TextureCache::getTextureForTextAsync()
+     * @since v3.14
+     */
+    void setSystemFontAsyncRendering(bool async) { _systemFontAsyncRendering = async; }
+    bool isSystemFontAsyncRendering() const { return _systemFontAsyncRendering; }
+
     FontAtlas* getFontAtlas() { return _fontAtlas; }
 
     virtual const BlendFunc& getBlendFunc() const override { return _blendFunc; }
@@ -638,12 +663,50 @@ protected:
         STRING_TEXTURE
     };
 
+    struct LayoutSettings
+    {
+        FontAtlas* fontAtlas;
+        float lineHeight;
+        float lineSpacing;
+        float additionalKerning;
+        float maxLineWidth;
+        float labelWidth;
+        float labelHeight;
+        float bmfontScale;
+        TextHAlignment hAlignment;
+        TextVAlignment vAlignment;
+        Overflow overflow;
+        bool lineBreakWithoutSpaces;
+        bool enableWrap;
+
+        bool operator==(const LayoutSettings& other) const;
+    };
+
+    struct LayoutCacheEntry
+    {
+        std::string text;
+        std::vector<LetterInfo> lettersInfo;
+        // the quads of each batch node
+        std::vector<std::vector<V3F_C4B_T2F_Quad>> quads;
+        std::vector<float> linesWidth;
+        std::vector<float> linesOffsetX;
+        int numberOfLines;
+        int lengthOfString;
+        float textDesiredHeight;
+        float letterOffsetY;
+        float tailoredTopY;
+        float tailoredBottomY;
+        Size contentSize;
+    };
+
     virtual void setFontAtlas(FontAtlas* atlas, bool distanceFieldEnabled = false, bool useA8Shader = false);
 
     void computeStringNumLines();
 
     void onDraw(const Mat4& transform, bool transformUpdated);
     void onDrawShadow(GLProgram* glProgram, const Color4F& shadowColor);
+    /** Appends the letters to _labelBatch, returns false if the label can't be batched. */
+    bool appendToBatch(const Mat4& transform);
     void drawSelf(bool visibleByCamera, Renderer* renderer, uint32_t flags);
 
     bool multilineTextWrapByChar();
@@ -667,6 +730,8 @@ protected:
 
     void createSpriteForSystemFont(const FontDefinition& fontDef);
     void createShadowSpriteForSystemFont(const FontDefinition& fontDef);
+    // the cached texture of the string, nullptr while it is rendered asynchronously
+    Texture2D* getSystemFontTexture(const FontDefinition& fontDef);
 
     virtual void updateShaderProgram();
     void updateBMFontScale();
@@ -681,6 +746,10 @@ protected:
 
     void reset();
 
+    LayoutSettings getLayoutSettings() const;
+    bool restoreCachedLayout();
+    void storeCachedLayout();
+
     FontDefinition _getFontDefinition() const;
 
     virtual void updateColor() override;
@@ -766,6 +835,7 @@ protected:
 
     EventListenerCustom* _purgeTextureListener;
     EventListenerCustom* _resetTextureListener;
+    EventListenerCustom* _updateTextureListener;
 
 #if CC_LABEL_DEBUG_DRAW
     DrawNode* _debugDrawNode;
@@ -781,8 +851,87 @@ protected:
     DrawNode* _underlineNode;
     bool _strikethroughEnabled;
 
+    unsigned int _layoutCacheSize;
+    LayoutSettings _layoutCacheSettings;
+    // most recently used first
+    std::vector<LayoutCacheEntry> _layoutCache;
+
+    // the LabelBatchNode parent drawing the letters, or nullptr
+    LabelBatchNode* _labelBatch;
+    // Renderer::getQueueGeneration() when the own commands were added
+    unsigned int _drawnQueueGeneration;
+
+    bool _systemFontAsyncRendering;
+
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(Label);
+
+    friend class LabelBatchNode;
+};
+
+/**
+ * @brief LabelBatchNode draws its Label children with a few TrianglesCommands instead of one command per label.
+ *
+ * The letters of the children sharing a font atlas texture, a shader and a blend function are merged into
+ * one vertex stream per pass: the shadows of all the labels are drawn first, then their outlines, then their texts.
+ * So a label of the batch never covers the shadow or the outline of another one, which suits damage numbers or name tags.
+ *
+ * Only the direct children are batched. Supported are the TTF labels with the normal or the outline effect,
+ * including their shadow and the distance field ones, and the BMFont and CharMap labels without shadow.
+ * The other children are drawn as usual, before the batched labels.
+ */
+class CC_DLL LabelBatchNode : public Node
+{
+public:
+    /** Creates an empty LabelBatchNode. */
+    static LabelBatchNode* create();
+
+    using Node::addChild;
+    virtual void addChild(Node* child, int localZOrder, int tag) override;
+    virtual void addChild(Node* child, int localZOrder, const std::string& name) override;
+    virtual void removeChild(Node* child, bool cleanup = true) override;
+    virtual void removeAllChildrenWithCleanup(bool cleanup) override;
+    virtual void visit(Renderer* renderer, const Mat4& parentTransform, uint32_t parentFlags) override;
+
+CC_CONSTRUCTOR_ACCESS:
+    LabelBatchNode();
+    virtual ~LabelBatchNode();
+
+protected:
+    enum class Pass
+    {
+        SHADOW,
+        OUTLINE,
+        TEXT
+    };
+
+    struct Batch
+    {
+        Pass pass;
+        Texture2D* texture;
+        GLProgramState* glProgramState;
+        BlendFunc blendFunc;
+        std::vector<V3F_C4B_T2F> vertices;
+        std::vector<unsigned short> indices;
+        TrianglesCommand command;
+    };
+
+    /** Transforms the quads to world space, multiplies their colors by color and appends them to the batch of the pass. */
+    void appendQuads(Pass pass, Texture2D* texture, GLProgramState* glProgramState, const BlendFunc& blendFunc,
+                     const V3F_C4B_T2F_Quad* quads, ssize_t count, const Mat4& transform, const Color4F& color);
+    /** The shared state of the noMVP label program, with white colors and the given u_effectType. */
+    static GLProgramState* getPassGLProgramState(const char* programName, int effectType);
+
+    // the batches in use this frame are [0, _usedBatches), the ones of the current visit start at _visitBatches
+    std::vector<Batch*> _batches;
+    size_t _usedBatches;
+    size_t _visitBatches;
+    unsigned int _lastFrame;
+
+private:
+    CC_DISALLOW_COPY_AND_ASSIGN(LabelBatchNode);
+
+    friend class Label;
 };
 
 // end group
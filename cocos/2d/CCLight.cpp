@@ -1,5 +1,6 @@
 #include "2d/CCLight.h"
 #include "2d/CCScene.h"
+#include "3d/CCAABB.h"
 
 NS_CC_BEGIN
 
@@ -17,7 +18,10 @@ void BaseLight::onEnter()
         auto &lights = scene->_lights;
         auto iter = std::find(lights.begin(), lights.end(), this);
         if (iter == lights.end())
+        {
             lights.push_back(this);
+            scene->_lightGrid->invalidate();
+        }
     }
     Node::onEnter();
 }
@@ -29,7 +33,10 @@ void BaseLight::onExit()
         auto &lights = scene->_lights;
         auto iter = std::find(lights.begin(), lights.end(), this);
         if (iter != lights.end())
+        {
             lights.erase(iter);
+            scene->_lightGrid->invalidate();
+        }
     }
     Node::onExit();
 }
@@ -181,4 +188,156 @@ AmbientLight::~AmbientLight()
 
 }
 
+/////////////////////////////////////////////////////////////
+
+// a light covering more cells is tested for every box
+static const int MAX_LIGHT_CELLS = 64;
+// a box covering more cells tests every light
+static const int MAX_BOX_CELLS = 64;
+
+LightGrid::LightGrid()
+: _cellSize(1.0f)
+, _valid(false)
+{
+}
+
+int64_t LightGrid::cellKey(int x, int y, int z) const
+{
+    return ((int64_t)(x & 0x1FFFFF) << 42) | ((int64_t)(y & 0x1FFFFF) << 21) | (int64_t)(z & 0x1FFFFF);
+}
+
+void LightGrid::cellRange(const Vec3& min, const Vec3& max, int* from, int* to) const
+{
+    from[0] = (int)floorf(min.x / _cellSize);
+    from[1] = (int)floorf(min.y / _cellSize);
+    from[2] = (int)floorf(min.z / _cellSize);
+    to[0] = (int)floorf(max.x / _cellSize);
+    to[1] = (int)floorf(max.y / _cellSize);
+    to[2] = (int)floorf(max.z / _cellSize);
+}
+
+void LightGrid::invalidate()
+{
+    _globalLights.clear();
+    _localLights.clear();
+    _largeLights.clear();
+    _cells.clear();
+    _valid = false;
+}
+
+void LightGrid::update(const std::vector<BaseLight*>& lights)
+{
+    invalidate();
+
+    float rangeSum = 0;
+    for (const auto& light : lights)
+    {
+        auto type = light->getLightType();
+        if (type == LightType::POINT || type == LightType::SPOT)
+        {
+            float range = type == LightType::POINT ? static_cast<PointLight*>(light)->getRange() : static_cast<SpotLight*>(light)->getRange();
+            Mat4 mat = light->getNodeToWorldTransform();
+            _localLights.push_back({light, Vec3(mat.m[12], mat.m[13], mat.m[14]), range});
+            rangeSum += range;
+        }
+        else
+        {
+            _globalLights.push_back(light);
+        }
+    }
+    _valid = true;
+
+    if (_localLights.empty())
+        return;
+    _cellSize = std::max(rangeSum / _localLights.size(), 1.0f);
+
+    int from[3], to[3];
+    for (int i = 0; i < (int)_localLights.size(); ++i)
+    {
+        const auto& local = _localLights[i];
+        Vec3 extent(local.range, local.range, local.range);
+        cellRange(local.position - extent, local.position + extent, from, to);
+        if ((to[0] - from[0] + 1) * (to[1] - from[1] + 1) * (to[2] - from[2] + 1) > MAX_LIGHT_CELLS)
+        {
+            _largeLights.push_back(i);
+            continue;
+        }
+
+        for (int x = from[0]; x <= to[0]; ++x)
+            for (int y = from[1]; y <= to[1]; ++y)
+                for (int z = from[2]; z <= to[2]; ++z)
+                    _cells[cellKey(x, y, z)].push_back(i);
+    }
+}
+
+void LightGrid::findLights(const AABB& aabb, unsigned int lightMask, std::vector<BaseLight*>* result) const
+{
+    auto useLight = [lightMask](BaseLight* light) {
+        return light->isEnabled() && ((unsigned int)light->getLightFlag() & lightMask);
+    };
+
+    for (const auto& light : _globalLights)
+    {
+        if (useLight(light))
+            result->push_back(light);
+    }
+
+    if (_localLights.empty())
+        return;
+
+    // the indices of the local lights that may reach the box
+    std::vector<int> candidates;
+    int from[3], to[3];
+    if (!aabb.isEmpty())
+        cellRange(aabb._min, aabb._max, from, to);
+    if (aabb.isEmpty() || (int64_t)(to[0] - from[0] + 1) * (to[1] - from[1] + 1) * (to[2] - from[2] + 1) > MAX_BOX_CELLS)
+    {
+        candidates.resize(_localLights.size());
+        for (int i = 0; i < (int)candidates.size(); ++i)
+            candidates[i] = i;
+    }
+    else
+    {
+        for (int x = from[0]; x <= to[0]; ++x)
+            for (int y = from[1]; y <= to[1]; ++y)
+                for (int z = from[2]; z <= to[2]; ++z)
+                {
+                    auto iter = _cells.find(cellKey(x, y, z));
+                    if (iter != _cells.end())
+                        candidates.insert(candidates.end(), iter->second.begin(), iter->second.end());
+                }
+        candidates.insert(candidates.end(), _largeLights.begin(), _largeLights.end());
+        std::sort(candidates.begin(), candidates.end());
+        candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+    }
+
+    // the distance from the box relative to the range, the lights beyond their range don't light anything
+    std::vector<std::pair<float, BaseLight*>> reaching;
+    for (auto index : candidates)
+    {
+        const auto& local = _localLights[index];
+        if (!useLight(local.light))
+            continue;
+
+        float distance = 0;
+        if (!aabb.isEmpty())
+        {
+            Vec3 closest(clampf(local.position.x, aabb._min.x, aabb._max.x),
+                         clampf(local.position.y, aabb._min.y, aabb._max.y),
+                         clampf(local.position.z, aabb._min.z, aabb._max.z));
+            distance = closest.distance(local.position);
+            if (distance > local.range)
+                continue;
+        }
+        reaching.push_back(std::make_pair(local.range > 0 ? distance / local.range : 0, local.light));
+    }
+
+    // stable, so the lights at the same distance keep the order of the scene
+    std::stable_sort(reaching.begin(), reaching.end(), [](const std::pair<float, BaseLight*>& a, const std::pair<float, BaseLight*>& b) {
+        return a.first < b.first;
+    });
+    for (const auto& light : reaching)
+        result->push_back(light.second);
+}
+
 NS_CC_END
\ No newline at end of file
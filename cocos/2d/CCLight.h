@@ -25,10 +25,13 @@
 #ifndef __CCLIGHT_H__
 #define __CCLIGHT_H__
 
+#include <unordered_map>
 #include "2d/CCNode.h"
 
 NS_CC_BEGIN
 
+class AABB;
+
 enum class LightType
 {
     DIRECTIONAL = 0,
@@ -289,6 +292,63 @@ CC_CONSTRUCTOR_ACCESS:
     virtual ~AmbientLight();
 };
 
+/** @class LightGrid
+ * @brief The lights of a scene sorted into a grid of world space cells, once per frame.
+
+A mesh gets the directional and ambient lights, and only the point and spot lights whose range reaches its
+bounding box, the closest first. So a scene can have more point and spot lights than the shaders support, see
+`Configuration::getMaxSupportPointLightInShader()`, each mesh is lit by the ones around it.
+@since v3.14
+@js NA
+*/
+class CC_DLL LightGrid
+{
+public:
+    LightGrid();
+
+    /** Sorts the lights into the cells. The scene calls it before visiting its cameras. */
+    void update(const std::vector<BaseLight*>& lights);
+
+    /** Forgets the lights until the next update(), when a light is added to or removed from the scene. */
+    void invalidate();
+
+    /** Whether or not the lights were sorted since they changed. */
+    bool isValid() const { return _valid; }
+
+    /**
+     * Adds to `result` the enabled lights matching `lightMask` that can light a world space box. It can be
+     * called while visiting on worker threads.
+     *
+     * @param aabb The world space bounding box, all the lights are returned if it's empty.
+     * @param lightMask The light flags used by the mesh.
+     * @param result The directional and ambient lights are added first, then the point and spot lights
+     * reaching the box, the closest first.
+     */
+    void findLights(const AABB& aabb, unsigned int lightMask, std::vector<BaseLight*>* result) const;
+
+    /** The size of the cells, the average range of the point and spot lights at the last update. */
+    float getCellSize() const { return _cellSize; }
+
+protected:
+    struct LocalLight
+    {
+        BaseLight* light;
+        Vec3 position;
+        float range;
+    };
+
+    int64_t cellKey(int x, int y, int z) const;
+    void cellRange(const Vec3& min, const Vec3& max, int* from, int* to) const;
+
+    std::vector<BaseLight*> _globalLights;
+    std::vector<LocalLight> _localLights;
+    // the local lights covering too many cells, tested for every box
+    std::vector<int> _largeLights;
+    std::unordered_map<int64_t, std::vector<int>> _cells;
+    float _cellSize;
+    bool _valid;
+};
+
 NS_CC_END
 
 #endif
\ No newline at end of file
@@ -28,7 +28,6 @@ THE SOFTWARE.
 #include "math/CCVertex.h"
 #include "base/CCDirector.h"
 #include "renderer/CCTextureCache.h"
-#include "renderer/ccGLStateCache.h"
 #include "renderer/CCTexture2D.h"
 #include "renderer/CCRenderer.h"
 #include "renderer/CCGLProgramState.h"
@@ -45,12 +44,12 @@ MotionStreak::MotionStreak()
 , _minSeg(0.0f)
 , _maxPoints(0)
 , _nuPoints(0)
-, _previousNuPoints(0)
+, _firstPoint(0)
 , _pointVertexes(nullptr)
 , _pointState(nullptr)
 , _vertices(nullptr)
-, _colorPointer(nullptr)
-, _texCoords(nullptr)
+, _triangleVertices(nullptr)
+, _indices(nullptr)
 {
 }
 
@@ -60,8 +59,8 @@ MotionStreak::~MotionStreak()
     CC_SAFE_FREE(_pointState);
     CC_SAFE_FREE(_pointVertexes);
     CC_SAFE_FREE(_vertices);
-    CC_SAFE_FREE(_colorPointer);
-    CC_SAFE_FREE(_texCoords);
+    CC_SAFE_FREE(_triangleVertices);
+    CC_SAFE_FREE(_indices);
 }
 
 MotionStreak* MotionStreak::create(float fade, float minSeg, float stroke, const Color3B& color, const std::string& path)
@@ -117,18 +116,32 @@ bool MotionStreak::initWithFade(float fade, float minSeg, float stroke, const Co
     _maxPoints = (int)(fade*fps)+2;
     
     _nuPoints = 0;
-    _pointState = (float *)malloc(sizeof(float) * _maxPoints);
-    _pointVertexes = (Vec2*)malloc(sizeof(Vec2) * _maxPoints);
+    _firstPoint = 0;
+    // twice the points, so the living ones are moved back only once every _maxPoints new points
+    _pointState = (float *)malloc(sizeof(float) * _maxPoints * 2);
+    _pointVertexes = (Vec2*)malloc(sizeof(Vec2) * _maxPoints * 2);
 
-    _vertices = (Vec2*)malloc(sizeof(Vec2) * _maxPoints * 2);
-    _texCoords = (Tex2F*)malloc(sizeof(Tex2F) * _maxPoints * 2);
-    _colorPointer =  (GLubyte*)malloc(sizeof(GLubyte) * _maxPoints * 2 * 4);
+    _vertices = (Vec2*)malloc(sizeof(Vec2) * _maxPoints * 4);
+    _triangleVertices = (V3F_C4B_T2F*)malloc(sizeof(V3F_C4B_T2F) * _maxPoints * 4);
+
+    // two triangles between two points of the strip
+    _indices = (unsigned short*)malloc(sizeof(unsigned short) * (_maxPoints - 1) * 6);
+    for (unsigned int i = 0; i < _maxPoints - 1; i++)
+    {
+        const unsigned short vertex = (unsigned short)(i * 2);
+        _indices[i*6+0] = vertex;
+        _indices[i*6+1] = vertex + 1;
+        _indices[i*6+2] = vertex + 2;
+        _indices[i*6+3] = vertex + 1;
+        _indices[i*6+4] = vertex + 3;
+        _indices[i*6+5] = vertex + 2;
+    }
 
     // Set blend mode
     _blendFunc = BlendFunc::ALPHA_NON_PREMULTIPLIED;
 
     // shader state
-    setGLProgramState(GLProgramState::getOrCreateWithGLProgramName(GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR, texture));
+    setGLProgramState(GLProgramState::getOrCreateWithGLProgramName(GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR_NO_MVP, texture));
 
     setTexture(texture);
     setColor(color);
@@ -201,9 +214,12 @@ void MotionStreak::tintWithColor(const Color3B& colors)
     setColor(colors);
 
     // Fast assignation
+    V3F_C4B_T2F* vertices = _triangleVertices + _firstPoint * 2;
     for(unsigned int i = 0; i<_nuPoints*2; i++) 
     {
-        *((Color3B*) (_colorPointer+i*4)) = colors;
+        vertices[i].colors.r = colors.r;
+        vertices[i].colors.g = colors.g;
+        vertices[i].colors.b = colors.b;
     }
 }
 
@@ -261,52 +277,26 @@ void MotionStreak::update(float delta)
     
     delta *= _fadeDelta;
 
-    unsigned int newIdx, newIdx2, i, i2;
-    unsigned int mov = 0;
-
-    // Update current points
+    // Update current points, the oldest ones fade first and are dropped from the front
+    unsigned int i, mov = 0;
     for(i = 0; i<_nuPoints; i++)
     {
-        _pointState[i]-=delta;
+        const unsigned int index = _firstPoint + i;
+        _pointState[index]-=delta;
 
-        if(_pointState[i] <= 0)
-            mov++;
+        if(_pointState[index] <= 0)
+            mov = i + 1;
         else
         {
-            newIdx = i-mov;
-
-            if(mov>0)
-            {
-                // Move data
-                _pointState[newIdx] = _pointState[i];
-
-                // Move point
-                _pointVertexes[newIdx] = _pointVertexes[i];
-
-                // Move vertices
-                i2 = i*2;
-                newIdx2 = newIdx*2;
-                _vertices[newIdx2] = _vertices[i2];
-                _vertices[newIdx2+1] = _vertices[i2+1];
-
-                // Move color
-                i2 *= 4;
-                newIdx2 *= 4;
-                _colorPointer[newIdx2+0] = _colorPointer[i2+0];
-                _colorPointer[newIdx2+1] = _colorPointer[i2+1];
-                _colorPointer[newIdx2+2] = _colorPointer[i2+2];
-                _colorPointer[newIdx2+4] = _colorPointer[i2+4];
-                _colorPointer[newIdx2+5] = _colorPointer[i2+5];
-                _colorPointer[newIdx2+6] = _colorPointer[i2+6];
-            }else
-                newIdx2 = newIdx*8;
-
-            const GLubyte op = (GLubyte)(_pointState[newIdx] * 255.0f);
-            _colorPointer[newIdx2+3] = op;
-            _colorPointer[newIdx2+7] = op;
+            const GLubyte op = (GLubyte)(_pointState[index] * 255.0f);
+            _triangleVertices[index*2].colors.a = op;
+            _triangleVertices[index*2+1].colors.a = op;
         }
     }
     _nuPoints-=mov;
+    _firstPoint = _nuPoints ? _firstPoint + mov : 0;
+
+    Vec2* points = _pointVertexes + _firstPoint;
 
     // Append new point
     bool appendNewPoint = true;
@@ -317,38 +307,48 @@ void MotionStreak::update(float delta)
 
     else if(_nuPoints>0)
     {
-        bool a1 = _pointVertexes[_nuPoints-1].getDistanceSq(_positionR) < _minSeg;
-        bool a2 = (_nuPoints == 1) ? false : (_pointVertexes[_nuPoints-2].getDistanceSq(_positionR)< (_minSeg * 2.0f));
+        bool a1 = points[_nuPoints-1].getDistanceSq(_positionR) < _minSeg;
+        bool a2 = (_nuPoints == 1) ? false : (points[_nuPoints-2].getDistanceSq(_positionR)< (_minSeg * 2.0f));
         if(a1 || a2)
         {
             appendNewPoint = false;
         }
     }
 
+    // the vertices to copy from the polygon
+    unsigned int polygonBegin = _fastMode ? _nuPoints : 0;
     if(appendNewPoint)
     {
-        _pointVertexes[_nuPoints] = _positionR;
-        _pointState[_nuPoints] = 1.0f;
+        // there is no room left after the living points, move them to the beginning of the arrays
+        if(_firstPoint + _nuPoints == _maxPoints * 2)
+        {
+            memmove(_pointState, _pointState + _firstPoint, sizeof(float) * _nuPoints);
+            memmove(_pointVertexes, _pointVertexes + _firstPoint, sizeof(Vec2) * _nuPoints);
+            memmove(_vertices, _vertices + _firstPoint * 2, sizeof(Vec2) * _nuPoints * 2);
+            memmove(_triangleVertices, _triangleVertices + _firstPoint * 2, sizeof(V3F_C4B_T2F) * _nuPoints * 2);
+            _firstPoint = 0;
+            points = _pointVertexes;
+        }
 
-        // Color assignment
-        const unsigned int offset = _nuPoints*8;
-        *((Color3B*)(_colorPointer + offset)) = _displayedColor;
-        *((Color3B*)(_colorPointer + offset+4)) = _displayedColor;
+        points[_nuPoints] = _positionR;
+        _pointState[_firstPoint + _nuPoints] = 1.0f;
 
-        // Opacity
-        _colorPointer[offset+3] = 255;
-        _colorPointer[offset+7] = 255;
+        // Color assignment
+        V3F_C4B_T2F* vertices = _triangleVertices + (_firstPoint + _nuPoints) * 2;
+        vertices[0].colors = Color4B(_displayedColor);
+        vertices[1].colors = Color4B(_displayedColor);
 
         // Generate polygon
         if(_nuPoints > 0 && _fastMode )
         {
             if(_nuPoints > 1)
             {
-                ccVertexLineToPolygon(_pointVertexes, _stroke, _vertices, _nuPoints, 1);
+                ccVertexLineToPolygon(points, _stroke, _vertices + _firstPoint * 2, _nuPoints, 1);
             }
             else
             {
-                ccVertexLineToPolygon(_pointVertexes, _stroke, _vertices, 0, 2);
+                ccVertexLineToPolygon(points, _stroke, _vertices + _firstPoint * 2, 0, 2);
+                polygonBegin = 0;
             }
         }
 
@@ -357,51 +357,44 @@ void MotionStreak::update(float delta)
 
     if( ! _fastMode )
     {
-        ccVertexLineToPolygon(_pointVertexes, _stroke, _vertices, 0, _nuPoints);
+        ccVertexLineToPolygon(points, _stroke, _vertices + _firstPoint * 2, 0, _nuPoints);
     }
 
-    // Updated Tex Coords only if they are different than previous step
-    if( _nuPoints  && _previousNuPoints != _nuPoints ) {
+    for(i = polygonBegin * 2; i < _nuPoints * 2; i++)
+    {
+        const Vec2& vertex = _vertices[_firstPoint * 2 + i];
+        _triangleVertices[_firstPoint * 2 + i].vertices.set(vertex.x, vertex.y, 0.0f);
+    }
+
+    // Updated Tex Coords only if the living points changed
+    if( _nuPoints  && (mov > 0 || appendNewPoint) ) {
         float texDelta = 1.0f / _nuPoints;
+        V3F_C4B_T2F* vertices = _triangleVertices + _firstPoint * 2;
         for( i=0; i < _nuPoints; i++ ) {
-            _texCoords[i*2] = Tex2F(0, texDelta*i);
-            _texCoords[i*2+1] = Tex2F(1, texDelta*i);
+            vertices[i*2].texCoords = Tex2F(0, texDelta*i);
+            vertices[i*2+1].texCoords = Tex2F(1, texDelta*i);
         }
-
-        _previousNuPoints = _nuPoints;
     }
 }
 
 void MotionStreak::reset()
 {
     _nuPoints = 0;
-}
-
-void MotionStreak::onDraw(const Mat4 &transform, uint32_t /*flags*/)
-{  
-    getGLProgram()->use();
-    getGLProgram()->setUniformsForBuiltins(transform);
-
-    GL::enableVertexAttribs(GL::VERTEX_ATTRIB_FLAG_POS_COLOR_TEX );
-    GL::blendFunc( _blendFunc.src, _blendFunc.dst );
-
-    GL::bindTexture2D( _texture );
-
-    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 2, GL_FLOAT, GL_FALSE, 0, _vertices);
-    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORD, 2, GL_FLOAT, GL_FALSE, 0, _texCoords);
-    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, 0, _colorPointer);
-
-    glDrawArrays(GL_TRIANGLE_STRIP, 0, (GLsizei)_nuPoints*2);
-    CC_INCREMENT_GL_DRAWN_BATCHES_AND_VERTICES(1, _nuPoints*2);
+    _firstPoint = 0;
 }
 
 void MotionStreak::draw(Renderer *renderer, const Mat4 &transform, uint32_t flags)
 {
     if(_nuPoints <= 1)
         return;
-    _customCommand.init(_globalZOrder, transform, flags);
-    _customCommand.func = CC_CALLBACK_0(MotionStreak::onDraw, this, transform, flags);
-    renderer->addCommand(&_customCommand);
+
+    TrianglesCommand::Triangles triangles;
+    triangles.verts = _triangleVertices + _firstPoint * 2;
+    triangles.vertCount = _nuPoints * 2;
+    triangles.indices = _indices;
+    triangles.indexCount = (_nuPoints - 1) * 6;
+    _trianglesCommand.init(_globalZOrder, _texture, getGLProgramState(), _blendFunc, triangles, transform, flags);
+    renderer->addCommand(&_trianglesCommand);
 }
 
 NS_CC_END
@@ -28,7 +28,7 @@ THE SOFTWARE.
 
 #include "base/CCProtocols.h"
 #include "2d/CCNode.h"
-#include "renderer/CCCustomCommand.h"
+#include "renderer/CCTrianglesCommand.h"
 
 NS_CC_BEGIN
 
@@ -41,6 +41,10 @@ class Texture2D;
 
 /** @class MotionStreak.
  * @brief Creates a trailing path.
+ *
+ * The streak is drawn with a TrianglesCommand, so consecutive streaks with the same texture, blend function and
+ * shader are batched in one draw call by the Renderer. A custom shader must not apply the model view matrix, like
+ * the "_noMVP" ones, because the Renderer transforms the vertices.
  */
 class CC_DLL MotionStreak : public Node, public TextureProtocol
 {
@@ -158,9 +162,6 @@ CC_CONSTRUCTOR_ACCESS:
     bool initWithFade(float fade, float minSeg, float stroke, const Color3B& color, Texture2D* texture);
 
 protected:
-    //renderer callback
-    void onDraw(const Mat4 &transform, uint32_t flags);
-
     bool _fastMode;
     bool _startingPositionInitialized;
 
@@ -175,7 +176,10 @@ protected:
 
     unsigned int _maxPoints;
     unsigned int _nuPoints;
-    unsigned int _previousNuPoints;
+    /** The living points are in [_firstPoint, _firstPoint + _nuPoints) of the arrays, which have room for
+     * 2 * _maxPoints points: the faded points are dropped from the front without moving the others.
+     */
+    unsigned int _firstPoint;
 
     /** Pointers */
     Vec2* _pointVertexes;
@@ -183,10 +187,11 @@ protected:
 
     // Opengl
     Vec2* _vertices;
-    GLubyte* _colorPointer;
-    Tex2F* _texCoords;
-    
-    CustomCommand _customCommand;
+    V3F_C4B_T2F* _triangleVertices;
+    /** The triangles of the strip, their indices are relative to the first living point */
+    unsigned short* _indices;
+
+    TrianglesCommand _trianglesCommand;
 
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(MotionStreak);
@@ -31,6 +31,8 @@ THE SOFTWARE.
 #include <algorithm>
 #include <string>
 #include <regex>
+#include <mutex>
+#include <unordered_map>
 
 #include "base/CCDirector.h"
 #include "base/CCScheduler.h"
@@ -40,6 +42,7 @@ THE SOFTWARE.
 #include "2d/CCActionManager.h"
 #include "2d/CCScene.h"
 #include "2d/CCComponent.h"
+#include "renderer/CCRenderer.h"
 #include "renderer/CCGLProgram.h"
 #include "renderer/CCGLProgramState.h"
 #include "renderer/CCMaterial.h"
@@ -53,12 +56,505 @@ THE SOFTWARE.
 #endif
 
 
+#if CC_ENABLE_ALLOCATOR && CC_ENABLE_ENGINE_ALLOCATOR_POOLS
+#include "base/allocator/CCAllocatorStrategyPool.h"
+#endif
+
 NS_CC_BEGIN
 
+CC_DEFINE_ALLOCATOR_POOL(Node, 256)
+
 // FIXME:: Yes, nodes might have a sort problem once every 30 days if the game runs at 60 FPS and each frame sprites are reordered.
 std::uint32_t Node::s_globalOrderOfArrival = 0;
 int Node::__attachedNodeCount = 0;
 
+// Keeps the world transforms and the dirty flags of a subtree in depth-first order, see Node::setFlatTransformRoot().
+// A parent is always stored before its children, so the world transforms are updated in one linear pass.
+class TransformHierarchy
+{
+public:
+    explicit TransformHierarchy(Node* root)
+    : _root(root)
+    , _dirty(true)
+    , _lastFrame(0)
+    {
+    }
+
+    Node* getRoot() const { return _root; }
+    void setDirty() { _dirty = true; }
+    uint32_t getFlags(int handle) const { return _flags[handle]; }
+
+    // Updates the world transforms of the subtree from the one of the root, once per frame
+    void update(uint32_t rootFlags)
+    {
+        unsigned int frame = Director::getInstance()->getTotalFrames();
+        if (_dirty)
+        {
+            build();
+            // the world transforms of the new nodes are unknown
+            rootFlags |= Node::FLAGS_TRANSFORM_DIRTY;
+        }
+        else if (frame == _lastFrame)
+        {
+            // visited again by another camera
+            return;
+        }
+        _lastFrame = frame;
+
+        _worldTransforms[0] = _root->_modelViewTransform;
+        _flags[0] = rootFlags;
+
+        const int count = (int)_nodes.size();
+        for (int i = 1; i < count; /* nothing */)
+        {
+            Node* node = _nodes[i];
+            // invisible subtrees are not visited, their nodes keep their dirty flags until they are
+            if (!node->_visible)
+            {
+                i = _subtreeEnds[i];
+                continue;
+            }
+
+            const int parent = _parents[i];
+            uint32_t flags = _flags[parent];
+            if (node->_usingNormalizedPosition)
+                node->updateNormalizedPosition(flags);
+            flags |= (node->_transformUpdated ? Node::FLAGS_TRANSFORM_DIRTY : 0);
+            flags |= (node->_contentSizeDirty ? Node::FLAGS_CONTENT_SIZE_DIRTY : 0);
+
+            if (flags & Node::FLAGS_DIRTY_MASK)
+            {
+                Mat4::multiply(_worldTransforms[parent], node->getNodeToParentTransform(), &_worldTransforms[i]);
+                node->_modelViewTransform = _worldTransforms[i];
+            }
+            _flags[i] = flags;
+            ++i;
+        }
+    }
+
+    // Removes the nodes from the hierarchy, walking the live tree since removed nodes may be gone
+    void reset()
+    {
+        for (auto child : _root->_children)
+            child->leaveTransformHierarchy();
+    }
+
+private:
+    void build()
+    {
+        _nodes.clear();
+        _parents.clear();
+        _subtreeEnds.clear();
+
+        _nodes.push_back(_root);
+        _parents.push_back(-1);
+        _subtreeEnds.push_back(0);
+        addChildren(_root, 0);
+        _subtreeEnds[0] = (int)_nodes.size();
+
+        _worldTransforms.resize(_nodes.size());
+        _flags.resize(_nodes.size());
+        _dirty = false;
+    }
+
+    void addChildren(Node* node, int index)
+    {
+        for (auto child : node->_children)
+        {
+            // nested flat roots update their own subtree
+            if (child->isFlatTransformRoot() || !child->isTransformFlattenable())
+                continue;
+
+            int childIndex = (int)_nodes.size();
+            child->_transformHierarchy = this;
+            child->_transformHandle = childIndex;
+            _nodes.push_back(child);
+            _parents.push_back(index);
+            _subtreeEnds.push_back(0);
+            addChildren(child, childIndex);
+            _subtreeEnds[childIndex] = (int)_nodes.size();
+        }
+    }
+
+    Node* _root;
+    std::vector<Node*> _nodes;
+    std::vector<int> _parents;
+    // index after the last node of the subtree
+    std::vector<int> _subtreeEnds;
+    std::vector<Mat4> _worldTransforms;
+    std::vector<uint32_t> _flags;
+    bool _dirty;
+    unsigned int _lastFrame;
+};
+
+// Uniform grid of the bounding boxes of the children of a node, see Node::setSpatialIndexEnabled().
+class SpatialIndex
+{
+public:
+    explicit SpatialIndex(float cellSize)
+    : _cellSize(cellSize)
+    , _queryStamp(0)
+    {
+    }
+
+    void add(Node* child)
+    {
+        auto& entry = _entries[child];
+        entry.node = child;
+        entry.dirty = false;
+        entry.linked = false;
+        entry.large = false;
+        entry.queryStamp = 0;
+        setDirty(child);
+    }
+
+    void remove(Node* child)
+    {
+        auto it = _entries.find(child);
+        if (it == _entries.end())
+            return;
+
+        unlink(&it->second);
+        if (it->second.dirty)
+            _dirtyEntries.erase(std::find(_dirtyEntries.begin(), _dirtyEntries.end(), &it->second));
+        _entries.erase(it);
+    }
+
+    void setDirty(Node* child)
+    {
+        auto it = _entries.find(child);
+        if (it != _entries.end() && !it->second.dirty)
+        {
+            it->second.dirty = true;
+            _dirtyEntries.push_back(&it->second);
+        }
+    }
+
+    // Appends the children intersecting rect to result, in no particular order
+    void query(const Rect& rect, std::vector<Node*>& result)
+    {
+        update();
+
+        // a child that spans several cells is only added once
+        ++_queryStamp;
+        auto test = [&](Entry* entry) {
+            if (entry->queryStamp != _queryStamp)
+            {
+                entry->queryStamp = _queryStamp;
+                if (entry->bounds.intersectsRect(rect))
+                    result.push_back(entry->node);
+            }
+        };
+
+        for (auto entry : _largeEntries)
+            test(entry);
+
+        int x0, y0, x1, y1;
+        getCells(rect, &x0, &y0, &x1, &y1);
+        if ((int64_t)(x1 - x0 + 1) * (y1 - y0 + 1) > (int64_t)_cells.size())
+        {
+            // the rectangle covers more cells than the grid uses
+            for (auto& cell : _cells)
+                for (auto entry : cell.second)
+                    test(entry);
+            return;
+        }
+
+        for (int y = y0; y <= y1; ++y)
+        {
+            for (int x = x0; x <= x1; ++x)
+            {
+                auto it = _cells.find(getCellKey(x, y));
+                if (it != _cells.end())
+                    for (auto entry : it->second)
+                        test(entry);
+            }
+        }
+    }
+
+private:
+    struct Entry
+    {
+        Node* node;
+        Rect bounds;
+        int x0, y0, x1, y1;
+        unsigned int queryStamp;
+        bool dirty;
+        bool linked;
+        bool large;
+    };
+
+    // children covering more cells are tested by every query
+    static const int MAX_CELLS_PER_CHILD = 16;
+
+    static uint64_t getCellKey(int x, int y)
+    {
+        return ((uint64_t)(uint32_t)x << 32) | (uint32_t)y;
+    }
+
+    void getCells(const Rect& rect, int* x0, int* y0, int* x1, int* y1) const
+    {
+        *x0 = (int)std::floor(rect.getMinX() / _cellSize);
+        *y0 = (int)std::floor(rect.getMinY() / _cellSize);
+        *x1 = (int)std::floor(rect.getMaxX() / _cellSize);
+        *y1 = (int)std::floor(rect.getMaxY() / _cellSize);
+    }
+
+    // bounds of node and its subtree, in the coordinates of its parent
+    static Rect getSubtreeBounds(Node* node)
+    {
+        Rect rect(0, 0, node->_contentSize.width, node->_contentSize.height);
+        for (auto child : node->_children)
+            rect.merge(getSubtreeBounds(child));
+        return RectApplyTransform(rect, node->getNodeToParentTransform());
+    }
+
+    void update()
+    {
+        for (auto entry : _dirtyEntries)
+        {
+            unlink(entry);
+            entry->dirty = false;
+            entry->bounds = getSubtreeBounds(entry->node);
+            getCells(entry->bounds, &entry->x0, &entry->y0, &entry->x1, &entry->y1);
+            link(entry);
+        }
+        _dirtyEntries.clear();
+    }
+
+    void link(Entry* entry)
+    {
+        entry->linked = true;
+        entry->large = (int64_t)(entry->x1 - entry->x0 + 1) * (entry->y1 - entry->y0 + 1) > MAX_CELLS_PER_CHILD;
+        if (entry->large)
+        {
+            _largeEntries.push_back(entry);
+            return;
+        }
+
+        for (int y = entry->y0; y <= entry->y1; ++y)
+            for (int x = entry->x0; x <= entry->x1; ++x)
+                _cells[getCellKey(x, y)].push_back(entry);
+    }
+
+    static void eraseEntry(std::vector<Entry*>& entries, Entry* entry)
+    {
+        auto it = std::find(entries.begin(), entries.end(), entry);
+        if (it != entries.end())
+        {
+            *it = entries.back();
+            entries.pop_back();
+        }
+    }
+
+    void unlink(Entry* entry)
+    {
+        if (!entry->linked)
+            return;
+        entry->linked = false;
+
+        if (entry->large)
+        {
+            eraseEntry(_largeEntries, entry);
+            return;
+        }
+
+        for (int y = entry->y0; y <= entry->y1; ++y)
+        {
+            for (int x = entry->x0; x <= entry->x1; ++x)
+            {
+                auto it = _cells.find(getCellKey(x, y));
+                eraseEntry(it->second, entry);
+                if (it->second.empty())
+                    _cells.erase(it);
+            }
+        }
+    }
+
+    float _cellSize;
+    unsigned int _queryStamp;
+    // the entries are never moved, so the cells can point to them
+    std::unordered_map<Node*, Entry> _entries;
+    std::unordered_map<uint64_t, std::vector<Entry*>> _cells;
+    std::vector<Entry*> _largeEntries;
+    std::vector<Entry*> _dirtyEntries;
+};
+
+// The children of a node by hash of their name and by tag, see Node::setChildIndexEnabled().
+class ChildIndex
+{
+public:
+    void add(Node* child)
+    {
+        _names.emplace(child->_hashOfName, child);
+        _tags.emplace(child->_tag, child);
+    }
+
+    // returns false if the child wasn't indexed
+    bool remove(Node* child)
+    {
+        bool removed = erase(_names, child->_hashOfName, child);
+        erase(_tags, child->_tag, child);
+        return removed;
+    }
+
+    // a renamed or tagged child, before it's changed
+    bool removeName(Node* child) { return erase(_names, child->_hashOfName, child); }
+    bool removeTag(Node* child) { return erase(_tags, child->_tag, child); }
+    void addName(Node* child) { _names.emplace(child->_hashOfName, child); }
+    void addTag(Node* child) { _tags.emplace(child->_tag, child); }
+
+    void clear()
+    {
+        _names.clear();
+        _tags.clear();
+    }
+
+    // returns the number of children with the name, 0, 1 or 2 for several ones, and the first one found
+    int findName(size_t hash, const std::string& name, Node** found) const
+    {
+        int count = 0;
+        auto range = _names.equal_range(hash);
+        for (auto it = range.first; it != range.second && count < 2; ++it)
+        {
+            // different strings may have the same hash code
+            if (it->second->_name == name)
+            {
+                if (count++ == 0)
+                    *found = it->second;
+            }
+        }
+        return count;
+    }
+
+    int findTag(int tag, Node** found) const
+    {
+        auto range = _tags.equal_range(tag);
+        if (range.first == range.second)
+            return 0;
+        *found = range.first->second;
+        return ++range.first == range.second ? 1 : 2;
+    }
+
+private:
+    template <typename Key>
+    static bool erase(std::unordered_multimap<Key, Node*>& map, const Key& key, Node* child)
+    {
+        auto range = map.equal_range(key);
+        for (auto it = range.first; it != range.second; ++it)
+        {
+            if (it->second == child)
+            {
+                map.erase(it);
+                return true;
+            }
+        }
+        return false;
+    }
+
+    std::unordered_multimap<size_t, Node*> _names;
+    std::unordered_multimap<int, Node*> _tags;
+};
+
+// The last world transform of a node and what it was computed from, see Node::getNodeToWorldTransform().
+struct WorldTransformCache
+{
+    Mat4 local;
+    Mat4 world;
+    Mat4 inverse;
+    const Node* parent;
+    // the version of the world transform of the parent
+    unsigned int parentVersion;
+    // changes with the world transform, never 0 once computed
+    unsigned int version;
+    unsigned int inverseVersion;
+};
+
+// the world transforms are only cached on the main thread
+static unsigned int s_worldTransformVersion = 0;
+
+// The search string of Node::enumerateChildren(), split at the '/'.
+struct NodePathQuery::Data
+{
+    struct Part
+    {
+        std::string name;
+        size_t hash;
+        bool isPattern;
+        std::regex pattern;
+    };
+
+    std::string path;
+    bool searchRecursively;
+    std::vector<Part> parts;
+};
+
+NodePathQuery::NodePathQuery(const std::string& path)
+{
+    CCASSERT(!path.empty(), "Invalid name");
+
+    auto data = std::make_shared<Data>();
+    data->path = path;
+
+    size_t length = path.length();
+    size_t subStrStartPos = 0;  // sub string start index
+    size_t subStrlength = length; // sub string length
+
+    // Starts with '//'?
+    data->searchRecursively = false;
+    if (length > 2 && path[0] == '/' && path[1] == '/')
+    {
+        data->searchRecursively = true;
+        subStrStartPos = 2;
+        subStrlength -= 2;
+    }
+
+    // End with '/..'?
+    bool searchFromParent = false;
+    if (length > 3 &&
+        path[length-3] == '/' &&
+        path[length-2] == '.' &&
+        path[length-1] == '.')
+    {
+        searchFromParent = true;
+        subStrlength -= 3;
+    }
+
+    // Remove '//', '/..' if exist
+    std::string newName = path.substr(subStrStartPos, subStrlength);
+
+    if (searchFromParent)
+    {
+        newName.insert(0, "[[:alnum:]]+/");
+    }
+
+    // name may be xxx/yyy, each part matches a level of children
+    std::hash<std::string> h;
+    size_t start = 0;
+    while (true)
+    {
+        size_t pos = newName.find('/', start);
+        Data::Part part;
+        part.name = newName.substr(start, pos == std::string::npos ? std::string::npos : pos - start);
+        part.hash = h(part.name);
+        part.isPattern = part.name.find_first_of(".[]{}()\\*+?|^$") != std::string::npos;
+        if (part.isPattern)
+            part.pattern = std::regex(part.name);
+        data->parts.push_back(std::move(part));
+
+        if (pos == std::string::npos)
+            break;
+        start = pos + 1;
+    }
+
+    _data = data;
+}
+
+const std::string& NodePathQuery::getPath() const
+{
+    return _data->path;
+}
+
 // MARK: Constructor, Destructor, Init
 
 Node::Node()
@@ -78,6 +574,8 @@ Node::Node()
 , _contentSizeDirty(true)
 , _transformDirty(true)
 , _inverseDirty(true)
+, _worldTransformCache(nullptr)
+, _fixedUpdateState(nullptr)
 , _additionalTransform(nullptr)
 , _additionalTransformDirty(false)
 , _transformUpdated(true)
@@ -98,6 +596,8 @@ Node::Node()
 , _visible(true)
 , _ignoreAnchorPointForPosition(false)
 , _reorderChildDirty(false)
+, _reorderPending(false)
+, _reorderedChildrenCount(0)
 , _isTransitionFinished(false)
 #if CC_ENABLE_SCRIPT_BINDING
 , _updateScriptHandler(0)
@@ -110,6 +610,14 @@ Node::Node()
 , _cascadeColorEnabled(false)
 , _cascadeOpacityEnabled(false)
 , _cameraMask(1)
+, _subtreeCameraMask(1)
+, _subtreeCameraMaskDirty(true)
+, _parallelVisitRoot(false)
+, _transformHierarchy(nullptr)
+, _transformHandle(-1)
+, _spatialIndex(nullptr)
+, _childIndex(nullptr)
+, _hitTestListeners(0)
 #if CC_USE_PHYSICS
 , _physicsBody(nullptr)
 #endif
@@ -167,9 +675,16 @@ Node::~Node()
     // attributes
     CC_SAFE_RELEASE_NULL(_glProgramState);
 
+    setFlatTransformRoot(false);
+    CC_SAFE_DELETE(_spatialIndex);
+    CC_SAFE_DELETE(_childIndex);
+    CC_SAFE_DELETE(_worldTransformCache);
+    CC_SAFE_DELETE(_fixedUpdateState);
+
     for (auto& child : _children)
     {
         child->_parent = nullptr;
+        child->_reorderPending = false;
     }
 
     removeAllComponents();
@@ -242,6 +757,7 @@ void Node::setSkewX(float skewX)
     
     _skewX = skewX;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    setBoundsDirty();
 }
 
 float Node::getSkewY() const
@@ -256,6 +772,7 @@ void Node::setSkewY(float skewY)
     
     _skewY = skewY;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    setBoundsDirty();
 }
 
 void Node::setLocalZOrder(std::int32_t z)
@@ -308,6 +825,7 @@ void Node::setRotation(float rotation)
     
     _rotationZ_X = _rotationZ_Y = rotation;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    setBoundsDirty();
     
     updateRotationQuat();
 }
@@ -325,6 +843,7 @@ void Node::setRotation3D(const Vec3& rotation)
         return;
     
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    setBoundsDirty();
 
     _rotationX = rotation.x;
     _rotationY = rotation.y;
@@ -376,6 +895,7 @@ void Node::setRotationQuat(const Quaternion& quat)
     _rotationQuat = quat;
     updateRotation3D();
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    setBoundsDirty();
 }
 
 Quaternion Node::getRotationQuat() const
@@ -390,6 +910,7 @@ void Node::setRotationSkewX(float rotationX)
     
     _rotationZ_X = rotationX;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    setBoundsDirty();
     
     updateRotationQuat();
 }
@@ -406,6 +927,7 @@ void Node::setRotationSkewY(float rotationY)
     
     _rotationZ_Y = rotationY;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    setBoundsDirty();
     
     updateRotationQuat();
 }
@@ -425,6 +947,7 @@ void Node::setScale(float scale)
     
     _scaleX = _scaleY = _scaleZ = scale;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    setBoundsDirty();
 }
 
 /// scaleX getter
@@ -442,6 +965,7 @@ void Node::setScale(float scaleX,float scaleY)
     _scaleX = scaleX;
     _scaleY = scaleY;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    setBoundsDirty();
 }
 
 /// scaleX setter
@@ -452,6 +976,7 @@ void Node::setScaleX(float scaleX)
     
     _scaleX = scaleX;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    setBoundsDirty();
 }
 
 /// scaleY getter
@@ -468,6 +993,7 @@ void Node::setScaleZ(float scaleZ)
     
     _scaleZ = scaleZ;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    setBoundsDirty();
 }
 
 /// scaleY getter
@@ -484,6 +1010,7 @@ void Node::setScaleY(float scaleY)
     
     _scaleY = scaleY;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    setBoundsDirty();
 }
 
 
@@ -514,6 +1041,7 @@ void Node::setPosition(float x, float y)
     _position.y = y;
     
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    setBoundsDirty();
     _usingNormalizedPosition = false;
 }
 
@@ -559,6 +1087,7 @@ void Node::setPositionZ(float positionZ)
         return;
     
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    setBoundsDirty();
 
     _positionZ = positionZ;
 }
@@ -579,6 +1108,7 @@ void Node::setPositionNormalized(const Vec2& position)
     _usingNormalizedPosition = true;
     _normalizedPositionDirty = true;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    setBoundsDirty();
 }
 
 ssize_t Node::getChildrenCount() const
@@ -621,6 +1151,7 @@ void Node::setAnchorPoint(const Vec2& point)
         _anchorPoint = point;
         _anchorPointInPoints.set(_contentSize.width * _anchorPoint.x, _contentSize.height * _anchorPoint.y);
         _transformUpdated = _transformDirty = _inverseDirty = true;
+        setBoundsDirty();
     }
 }
 
@@ -638,6 +1169,7 @@ void Node::setContentSize(const Size & size)
 
         _anchorPointInPoints.set(_contentSize.width * _anchorPoint.x, _contentSize.height * _anchorPoint.y);
         _transformUpdated = _transformDirty = _inverseDirty = _contentSizeDirty = true;
+        setBoundsDirty();
     }
 }
 
@@ -650,8 +1182,26 @@ bool Node::isRunning() const
 /// parent setter
 void Node::setParent(Node * parent)
 {
+    if (_transformHandle > 0)
+    {
+        _transformHierarchy->setDirty();
+        leaveTransformHierarchy();
+    }
+
+    if (_parent && _parent->_spatialIndex)
+        _parent->_spatialIndex->remove(this);
+
+    if (_parent)
+        _parent->setSubtreeCameraMaskDirty();
     _parent = parent;
     _transformUpdated = _transformDirty = _inverseDirty = true;
+    if (_parent)
+        _parent->setSubtreeCameraMaskDirty();
+
+    if (_parent && _parent->_transformHierarchy)
+        _parent->_transformHierarchy->setDirty();
+    if (_parent && _parent->_spatialIndex)
+        _parent->_spatialIndex->add(this);
 }
 
 /// isRelativeAnchorPoint getter
@@ -667,6 +1217,7 @@ void Node::setIgnoreAnchorPointForPosition(bool newValue)
     {
         _ignoreAnchorPointForPosition = newValue;
         _transformUpdated = _transformDirty = _inverseDirty = true;
+        setBoundsDirty();
     }
 }
 
@@ -679,6 +1230,12 @@ int Node::getTag() const
 /// tag setter
 void Node::setTag(int tag)
 {
+    if (_parent && _parent->_childIndex && _parent->_childIndex->removeTag(this))
+    {
+        _tag = tag;
+        _parent->_childIndex->addTag(this);
+        return;
+    }
     _tag = tag ;
 }
 
@@ -689,9 +1246,12 @@ const std::string& Node::getName() const
 
 void Node::setName(const std::string& name)
 {
+    bool indexed = _parent && _parent->_childIndex && _parent->_childIndex->removeName(this);
     _name = name;
     std::hash<std::string> h;
     _hashOfName = h(name);
+    if (indexed)
+        _parent->_childIndex->addName(this);
 }
 
 /// userData setter
@@ -785,6 +1345,15 @@ Node* Node::getChildByTag(int tag) const
 {
     CCASSERT(tag != Node::INVALID_TAG, "Invalid tag");
 
+    if (_childIndex)
+    {
+        Node* found = nullptr;
+        int count = _childIndex->findTag(tag, &found);
+        // several children with the tag, the first one in the order of the children is returned
+        if (count < 2)
+            return found;
+    }
+
     for (const auto child : _children)
     {
         if(child && child->_tag == tag)
@@ -799,6 +1368,15 @@ Node* Node::getChildByName(const std::string& name) const
     
     std::hash<std::string> h;
     size_t hash = h(name);
+
+    if (_childIndex)
+    {
+        Node* found = nullptr;
+        int count = _childIndex->findName(hash, name, &found);
+        // several children with the name, the first one in the order of the children is returned
+        if (count < 2)
+            return found;
+    }
     
     for (const auto& child : _children)
     {
@@ -813,58 +1391,46 @@ void Node::enumerateChildren(const std::string &name, std::function<bool (Node *
 {
     CCASSERT(!name.empty(), "Invalid name");
     CCASSERT(callback != nullptr, "Invalid callback function");
-    
-    size_t length = name.length();
-    
-    size_t subStrStartPos = 0;  // sub string start index
-    size_t subStrlength = length; // sub string length
-    
-    // Starts with '//'?
-    bool searchRecursively = false;
-    if (length > 2 && name[0] == '/' && name[1] == '/')
-    {
-        searchRecursively = true;
-        subStrStartPos = 2;
-        subStrlength -= 2;
-    }
-    
-    // End with '/..'?
-    bool searchFromParent = false;
-    if (length > 3 &&
-        name[length-3] == '/' &&
-        name[length-2] == '.' &&
-        name[length-1] == '.')
-    {
-        searchFromParent = true;
-        subStrlength -= 3;
-    }
-    
-    // Remove '//', '/..' if exist
-    std::string newName = name.substr(subStrStartPos, subStrlength);
 
-    if (searchFromParent)
+    // the parsed search strings, the regular expressions are expensive to compile
+    static std::unordered_map<std::string, NodePathQuery> s_queries;
+    static std::mutex s_queriesMutex;
+    std::unique_lock<std::mutex> lock(s_queriesMutex);
+    auto it = s_queries.find(name);
+    if (it == s_queries.end())
     {
-        newName.insert(0, "[[:alnum:]]+/");
+        // the names built at runtime would grow it forever
+        if (s_queries.size() >= 256)
+            s_queries.clear();
+        it = s_queries.emplace(name, NodePathQuery(name)).first;
     }
-    
-    
-    if (searchRecursively)
+    NodePathQuery query = it->second;
+    lock.unlock();
+
+    enumerateChildren(query, callback);
+}
+
+void Node::enumerateChildren(const NodePathQuery& query, const std::function<bool (Node *)>& callback) const
+{
+    CCASSERT(callback != nullptr, "Invalid callback function");
+
+    if (query._data->searchRecursively)
     {
         // name is '//xxx'
-        doEnumerateRecursive(this, newName, callback);
+        doEnumerateRecursive(this, query, callback);
     }
     else
     {
         // name is xxx
-        doEnumerate(newName, callback);
+        doEnumerate(query, 0, callback);
     }
 }
 
-bool Node::doEnumerateRecursive(const Node* node, const std::string &name, std::function<bool (Node *)> callback) const
+bool Node::doEnumerateRecursive(const Node* node, const NodePathQuery& query, const std::function<bool (Node *)>& callback) const
 {
     bool ret =false;
     
-    if (node->doEnumerate(name, callback))
+    if (node->doEnumerate(query, 0, callback))
     {
         // search itself
         ret = true;
@@ -874,7 +1440,7 @@ bool Node::doEnumerateRecursive(const Node* node, const std::string &name, std::
         // search its children
         for (const auto& child : node->getChildren())
         {
-            if (doEnumerateRecursive(child, name, callback))
+            if (doEnumerateRecursive(child, query, callback))
             {
                 ret = true;
                 break;
@@ -885,43 +1451,36 @@ bool Node::doEnumerateRecursive(const Node* node, const std::string &name, std::
     return ret;
 }
 
-bool Node::doEnumerate(std::string name, std::function<bool (Node *)> callback) const
+bool Node::doEnumerate(const NodePathQuery& query, size_t part, const std::function<bool (Node *)>& callback) const
 {
-    // name may be xxx/yyy, should find its parent
-    size_t pos = name.find('/');
-    std::string searchName = name;
-    bool needRecursive = false;
-    if (pos != name.npos)
+    const auto& parts = query._data->parts;
+    const auto& searchPart = parts[part];
+    bool needRecursive = part + 1 < parts.size();
+
+    auto enumerate = [&](Node* child) {
+        // terminate enumeration if callback return true
+        return needRecursive ? child->doEnumerate(query, part + 1, callback) : callback(child);
+    };
+
+    if (!searchPart.isPattern && _childIndex)
     {
-        searchName = name.substr(0, pos);
-        name.erase(0, pos+1);
-        needRecursive = true;
+        Node* found = nullptr;
+        int count = _childIndex->findName(searchPart.hash, searchPart.name, &found);
+        if (count == 0)
+            return false;
+        if (count == 1)
+            return enumerate(found);
     }
-    
-    bool ret = false;
+
     for (const auto& child : getChildren())
     {
-        if (std::regex_match(child->_name, std::regex(searchName)))
-        {
-            if (!needRecursive)
-            {
-                // terminate enumeration if callback return true
-                if (callback(child))
-                {
-                    ret = true;
-                    break;
-                }
-            }
-            else
-            {
-                ret = child->doEnumerate(name, callback);
-                if (ret)
-                    break;
-            }
-        }
+        bool matches = searchPart.isPattern ? std::regex_match(child->_name, searchPart.pattern)
+            : child->_hashOfName == searchPart.hash && child->_name == searchPart.name;
+        if (matches && enumerate(child))
+            return true;
     }
     
-    return ret;
+    return false;
 }
 
 /* "add" logic MUST only be on this method
@@ -972,6 +1531,7 @@ void Node::addChildHelper(Node* child, int localZOrder, int tag, const std::stri
         child->setTag(tag);
     else
         child->setName(name);
+    childIndexAdd(child);
     
     child->setParent(this);
 
@@ -1104,9 +1664,12 @@ void Node::removeAllChildrenWithCleanup(bool cleanup)
 #endif // CC_ENABLE_GC_FOR_NATIVE_OBJECTS
         // set parent nil at the end
         child->setParent(nullptr);
+        unmarkChildReordered(child);
     }
     
     _children.clear();
+    if (_childIndex)
+        _childIndex->clear();
 }
 
 void Node::detachChild(Node *child, ssize_t childIndex, bool doCleanup)
@@ -1136,8 +1699,10 @@ void Node::detachChild(Node *child, ssize_t childIndex, bool doCleanup)
 #endif // CC_ENABLE_GC_FOR_NATIVE_OBJECTS
     // set parent nil at the end
     child->setParent(nullptr);
+    unmarkChildReordered(child);
 
     _children.erase(childIndex);
+    childIndexRemove(child);
 }
 
 
@@ -1155,6 +1720,7 @@ void Node::insertChild(Node* child, int z)
     _reorderChildDirty = true;
     _children.pushBack(child);
     child->_setLocalZOrder(z);
+    markChildReordered(child);
 }
 
 void Node::reorderChild(Node *child, int zOrder)
@@ -1163,13 +1729,70 @@ void Node::reorderChild(Node *child, int zOrder)
     _reorderChildDirty = true;
     child->updateOrderOfArrival();
     child->_setLocalZOrder(zOrder);
+    markChildReordered(child);
+}
+
+bool Node::isDrawnBefore(const Node* n1, const Node* n2)
+{
+#if CC_64BITS
+    return n1->_localZOrder$Arrival < n2->_localZOrder$Arrival;
+#else
+    return (n1->_localZOrder == n2->_localZOrder && n1->_orderOfArrival < n2->_orderOfArrival) || n1->_localZOrder < n2->_localZOrder;
+#endif
+}
+
+void Node::markChildReordered(Node* child)
+{
+    if (!child->_reorderPending)
+    {
+        child->_reorderPending = true;
+        ++_reorderedChildrenCount;
+    }
+}
+
+void Node::unmarkChildReordered(Node* child)
+{
+    if (child->_reorderPending)
+    {
+        child->_reorderPending = false;
+        --_reorderedChildrenCount;
+    }
 }
 
 void Node::sortAllChildren()
 {
     if (_reorderChildDirty)
     {
-        sortNodes(_children);
+        auto first = _children.begin();
+        auto last = _children.end();
+        bool sorted = false;
+
+        // a few added or reordered children: the others are still sorted, sort the moved ones and merge them back
+        if (_reorderedChildrenCount <= (ssize_t)_children.size() / 4)
+        {
+            auto less = isDrawnBefore;
+            auto middle = std::stable_partition(first, last, [](Node* n) { return !n->_reorderPending; });
+            // subclasses may also change the order without marking the children
+            if (std::is_sorted(first, middle, less))
+            {
+                for (auto it = middle; it != last; ++it)
+                    (*it)->_reorderPending = false;
+                _reorderedChildrenCount = 0;
+
+                std::sort(middle, last, less);
+                std::inplace_merge(first, middle, last, less);
+                sorted = true;
+            }
+        }
+
+        if (!sorted)
+        {
+            sortNodes(_children);
+            for (auto child : _children)
+                child->_reorderPending = false;
+            _reorderedChildrenCount = 0;
+        }
+
         _reorderChildDirty = false;
         _eventDispatcher->setDirtyForNode(this);
     }
@@ -1194,20 +1817,27 @@ void Node::visit()
     visit(renderer, parentTransform, true);
 }
 
-uint32_t Node::processParentFlags(const Mat4& parentTransform, uint32_t parentFlags)
+void Node::updateNormalizedPosition(uint32_t parentFlags)
 {
-    if(_usingNormalizedPosition)
+    CCASSERT(_parent, "setPositionNormalized() doesn't work with orphan nodes");
+    if ((parentFlags & FLAGS_CONTENT_SIZE_DIRTY) || _normalizedPositionDirty)
     {
-        CCASSERT(_parent, "setPositionNormalized() doesn't work with orphan nodes");
-        if ((parentFlags & FLAGS_CONTENT_SIZE_DIRTY) || _normalizedPositionDirty)
-        {
-            auto& s = _parent->getContentSize();
-            _position.x = _normalizedPosition.x * s.width;
-            _position.y = _normalizedPosition.y * s.height;
-            _transformUpdated = _transformDirty = _inverseDirty = true;
-            _normalizedPositionDirty = false;
-        }
+        auto& s = _parent->getContentSize();
+        _position.x = _normalizedPosition.x * s.width;
+        _position.y = _normalizedPosition.y * s.height;
+        _transformUpdated = _transformDirty = _inverseDirty = true;
+        setBoundsDirty();
+        _normalizedPositionDirty = false;
     }
+}
+
+uint32_t Node::processParentFlags(const Mat4& parentTransform, uint32_t parentFlags)
+{
+    // the flat transform hierarchy already updated the transform, unless the parent visits with another one
+    const bool flattened = _transformHandle > 0 && &parentTransform == &_parent->_modelViewTransform;
+
+    if(_usingNormalizedPosition && !flattened)
+        updateNormalizedPosition(parentFlags);
 
     // Fixes Github issue #16100. Basically when having two cameras, one camera might set as dirty the
     // node that is not visited by it, and might affect certain calculations. Besides, it is faster to do this.
@@ -1215,15 +1845,28 @@ uint32_t Node::processParentFlags(const Mat4& parentTransform, uint32_t parentFl
         return parentFlags;
 
     uint32_t flags = parentFlags;
-    flags |= (_transformUpdated ? FLAGS_TRANSFORM_DIRTY : 0);
-    flags |= (_contentSizeDirty ? FLAGS_CONTENT_SIZE_DIRTY : 0);
-    
 
-    if(flags & FLAGS_DIRTY_MASK)
-        _modelViewTransform = this->transform(parentTransform);
-    
-    _transformUpdated = false;
-    _contentSizeDirty = false;
+    if (flattened)
+    {
+        _transformUpdated = false;
+        _contentSizeDirty = false;
+        flags |= _transformHierarchy->getFlags(_transformHandle);
+    }
+    else
+    {
+        flags |= (_transformUpdated ? FLAGS_TRANSFORM_DIRTY : 0);
+        flags |= (_contentSizeDirty ? FLAGS_CONTENT_SIZE_DIRTY : 0);
+
+        if(flags & FLAGS_DIRTY_MASK)
+            _modelViewTransform = this->transform(parentTransform);
+
+        _transformUpdated = false;
+        _contentSizeDirty = false;
+    }
+
+    // the world bounds of hit tested touch listeners follow the node as it is visited
+    if (_hitTestListeners > 0 && (flags & FLAGS_DIRTY_MASK))
+        _eventDispatcher->setHitTestBoundsDirty(this);
 
     return flags;
 }
@@ -1235,6 +1878,35 @@ bool Node::isVisitableByVisitingCamera() const
     return visibleByCamera;
 }
 
+unsigned short Node::getSubtreeCameraMask() const
+{
+    if (_subtreeCameraMaskDirty)
+    {
+        _subtreeCameraMask = computeSubtreeCameraMask();
+        _subtreeCameraMaskDirty = false;
+    }
+    return _subtreeCameraMask;
+}
+
+unsigned short Node::computeSubtreeCameraMask() const
+{
+    unsigned short mask = _cameraMask;
+    for (const auto& child : _children)
+    {
+        mask |= child->getSubtreeCameraMask();
+    }
+    return mask;
+}
+
+void Node::setSubtreeCameraMaskDirty()
+{
+    // the ancestors of a dirty node are already dirty
+    for (Node* node = this; node && !node->_subtreeCameraMaskDirty; node = node->_parent)
+    {
+        node->_subtreeCameraMaskDirty = true;
+    }
+}
+
 void Node::visit(Renderer* renderer, const Mat4 &parentTransform, uint32_t parentFlags)
 {
     // quick return if not visible. children won't be drawn.
@@ -1243,13 +1915,28 @@ void Node::visit(Renderer* renderer, const Mat4 &parentTransform, uint32_t paren
         return;
     }
 
+    // quick return if the visiting camera sees neither the node nor its descendants
+    auto visitingCamera = Camera::getVisitingCamera();
+    if (visitingCamera && ((unsigned short)visitingCamera->getCameraFlag() & getSubtreeCameraMask()) == 0)
+    {
+        return;
+    }
+
     uint32_t flags = processParentFlags(parentTransform, parentFlags);
 
+    if (_transformHandle == 0)
+        _transformHierarchy->update(flags);
+
     // IMPORTANT:
     // To ease the migration to v3.0, we still support the Mat4 stack,
-    // but it is deprecated and your code should not rely on it
-    _director->pushMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
-    _director->loadMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW, _modelViewTransform);
+    // but it is deprecated and your code should not rely on it.
+    // It is not available while visiting on a worker thread.
+    const bool useMatrixStack = !renderer->isRecordingVisit();
+    if (useMatrixStack)
+    {
+        _director->pushMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
+        _director->loadMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW, _modelViewTransform);
+    }
     
     bool visibleByCamera = isVisitableByVisitingCamera();
 
@@ -1258,29 +1945,55 @@ void Node::visit(Renderer* renderer, const Mat4 &parentTransform, uint32_t paren
     if(!_children.empty())
     {
         sortAllChildren();
+
+        if (_spatialIndex && visitSpatialIndex(renderer, flags, visibleByCamera))
+        {
+            if (useMatrixStack)
+                _director->popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
+            return;
+        }
+
+        // visit the parallel roots on worker threads first, their commands are added in order below
+        const bool hasRecordedChildren = renderer->recordParallelVisits(_children, _modelViewTransform, flags) > 0;
+
         // draw children zOrder < 0
         for(auto size = _children.size(); i < size; ++i)
         {
             auto node = _children.at(i);
 
             if (node && node->_localZOrder < 0)
-                node->visit(renderer, _modelViewTransform, flags);
+            {
+                if (!hasRecordedChildren || !renderer->replayParallelVisit(node))
+                    node->visit(renderer, _modelViewTransform, flags);
+            }
             else
                 break;
         }
         // self draw
         if (visibleByCamera)
-            this->draw(renderer, _modelViewTransform, flags);
+        {
+            if (renderer->isDrawStatisticsEnabled())
+                renderer->drawWithStatistics(this, _modelViewTransform, flags);
+            else
+                this->draw(renderer, _modelViewTransform, flags);
+        }
 
         for(auto it=_children.cbegin()+i, itCend = _children.cend(); it != itCend; ++it)
-            (*it)->visit(renderer, _modelViewTransform, flags);
+        {
+            if (!hasRecordedChildren || !renderer->replayParallelVisit(*it))
+                (*it)->visit(renderer, _modelViewTransform, flags);
+        }
     }
     else if (visibleByCamera)
     {
-        this->draw(renderer, _modelViewTransform, flags);
+        if (renderer->isDrawStatisticsEnabled())
+            renderer->drawWithStatistics(this, _modelViewTransform, flags);
+        else
+            this->draw(renderer, _modelViewTransform, flags);
     }
 
-    _director->popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
+    if (useMatrixStack)
+        _director->popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
     
     // FIX ME: Why need to set _orderOfArrival to 0??
     // Please refer to https://github.com/cocos2d/cocos2d-x/pull/6920
@@ -1288,6 +2001,146 @@ void Node::visit(Renderer* renderer, const Mat4 &parentTransform, uint32_t paren
     // _orderOfArrival = 0;
 }
 
+bool Node::visitSpatialIndex(Renderer* renderer, uint32_t flags, bool visibleByCamera)
+{
+    // like Renderer::checkVisibility(), only the default camera is culled
+    auto scene = _director->getRunningScene();
+    if (!renderer->isCullingEnabled() || !scene || scene->getDefaultCamera() != Camera::getVisitingCamera())
+        return false;
+
+    // the visible area in world coordinates, mapped to the coordinates of this node
+    Rect visibleRect(_director->getVisibleOrigin(), _director->getVisibleSize());
+    Rect rect = RectApplyTransform(visibleRect, _modelViewTransform.getInversed());
+
+    auto children = getChildrenInRect(rect);
+
+    int i = 0;
+    for (auto size = children.size(); i < size && children[i]->_localZOrder < 0; ++i)
+        children[i]->visit(renderer, _modelViewTransform, flags);
+
+    if (visibleByCamera)
+    {
+        if (renderer->isDrawStatisticsEnabled())
+            renderer->drawWithStatistics(this, _modelViewTransform, flags);
+        else
+            this->draw(renderer, _modelViewTransform, flags);
+    }
+
+    for (auto size = children.size(); i < size; ++i)
+        children[i]->visit(renderer, _modelViewTransform, flags);
+
+    return true;
+}
+
+std::vector<Node*> Node::getChildrenInRect(const Rect& rect)
+{
+    std::vector<Node*> children;
+    if (_spatialIndex)
+    {
+        _spatialIndex->query(rect, children);
+        std::sort(children.begin(), children.end(), isDrawnBefore);
+    }
+    else
+    {
+        for (auto child : _children)
+        {
+            if (child->getBoundingBox().intersectsRect(rect))
+                children.push_back(child);
+        }
+    }
+    return children;
+}
+
+void Node::setChildIndexEnabled(bool enabled)
+{
+    CC_SAFE_DELETE(_childIndex);
+    if (enabled)
+    {
+        _childIndex = new (std::nothrow) ChildIndex();
+        for (auto child : _children)
+            _childIndex->add(child);
+    }
+}
+
+void Node::childIndexAdd(Node* child)
+{
+    if (_childIndex)
+        _childIndex->add(child);
+}
+
+void Node::childIndexRemove(Node* child)
+{
+    if (_childIndex)
+        _childIndex->remove(child);
+}
+
+void Node::setSpatialIndexEnabled(bool enabled, float cellSize)
+{
+    CC_SAFE_DELETE(_spatialIndex);
+    if (enabled)
+    {
+        CCASSERT(cellSize > 0, "Invalid cell size");
+        _spatialIndex = new (std::nothrow) SpatialIndex(cellSize);
+        for (auto child : _children)
+            _spatialIndex->add(child);
+    }
+}
+
+void Node::spatialIndexChildMoved(Node* child)
+{
+    _spatialIndex->setDirty(child);
+}
+
+void Node::setFlatTransformRoot(bool flatTransformRoot)
+{
+    if (flatTransformRoot == isFlatTransformRoot())
+        return;
+
+    if (flatTransformRoot)
+    {
+        // a nested root leaves the hierarchy of its ancestor
+        if (_transformHandle > 0)
+        {
+            _transformHierarchy->setDirty();
+            leaveTransformHierarchy();
+        }
+        _transformHierarchy = new (std::nothrow) TransformHierarchy(this);
+        _transformHandle = 0;
+    }
+    else
+    {
+        _transformHierarchy->reset();
+        delete _transformHierarchy;
+        _transformHierarchy = nullptr;
+        _transformHandle = -1;
+
+        for (Node* parent = _parent; parent; parent = parent->_parent)
+        {
+            if (parent->_transformHierarchy)
+            {
+                parent->_transformHierarchy->setDirty();
+                break;
+            }
+        }
+    }
+}
+
+bool Node::isFlatTransformRoot() const
+{
+    return _transformHandle == 0;
+}
+
+void Node::leaveTransformHierarchy()
+{
+    if (_transformHandle <= 0)
+        return;
+
+    _transformHierarchy = nullptr;
+    _transformHandle = -1;
+    for (auto child : _children)
+        child->leaveTransformHierarchy();
+}
+
 Mat4 Node::transform(const Mat4& parentTransform)
 {
     return parentTransform * this->getNodeToParentTransform();
@@ -1555,6 +2408,83 @@ void Node::unscheduleUpdate()
 #endif
 }
 
+static const char* FIXED_UPDATE_KEY = "__fixedUpdate";
+static const char* FIXED_UPDATE_INTERPOLATION_KEY = "__fixedUpdateInterpolation";
+
+struct FixedUpdateState
+{
+    // the position after the last two steps
+    Vec3 previous;
+    Vec3 current;
+    // the position set by the interpolation, another one was set outside of the fixed updates
+    Vec3 interpolated;
+};
+
+void Node::scheduleFixedUpdate(int priority)
+{
+    _scheduler->scheduleFixedUpdate([this](float delta) {
+        if (_fixedUpdateState)
+        {
+            syncFixedUpdatePosition();
+            // the step starts from the simulated position
+            setPosition3D(_fixedUpdateState->current);
+            _fixedUpdateState->previous = _fixedUpdateState->current;
+        }
+
+        fixedUpdate(delta);
+
+        if (_fixedUpdateState)
+        {
+            _fixedUpdateState->current = _fixedUpdateState->interpolated = getPosition3D();
+        }
+    }, this, priority, !_running, FIXED_UPDATE_KEY);
+}
+
+void Node::unscheduleFixedUpdate()
+{
+    _scheduler->unscheduleFixedUpdate(FIXED_UPDATE_KEY, this);
+}
+
+void Node::fixedUpdate(float /*delta*/)
+{
+}
+
+void Node::setFixedUpdateInterpolationEnabled(bool enabled)
+{
+    if (enabled == (_fixedUpdateState != nullptr))
+        return;
+
+    if (enabled)
+    {
+        _fixedUpdateState = new (std::nothrow) FixedUpdateState();
+        _fixedUpdateState->previous = _fixedUpdateState->current = _fixedUpdateState->interpolated = getPosition3D();
+        // after the updates of the frame, a frame timer is triggered after them
+        schedule([this](float /*delta*/) {
+            syncFixedUpdatePosition();
+            float alpha = _scheduler->getFixedUpdateAlpha();
+            _fixedUpdateState->interpolated = _fixedUpdateState->previous.lerp(_fixedUpdateState->current, alpha);
+            setPosition3D(_fixedUpdateState->interpolated);
+        }, FIXED_UPDATE_INTERPOLATION_KEY);
+    }
+    else
+    {
+        unschedule(FIXED_UPDATE_INTERPOLATION_KEY);
+        syncFixedUpdatePosition();
+        setPosition3D(_fixedUpdateState->current);
+        CC_SAFE_DELETE(_fixedUpdateState);
+    }
+}
+
+void Node::syncFixedUpdatePosition()
+{
+    auto position = getPosition3D();
+    if (position != _fixedUpdateState->interpolated)
+    {
+        // moved outside of the fixed updates, it's the simulated position from now on
+        _fixedUpdateState->previous = _fixedUpdateState->current = _fixedUpdateState->interpolated = position;
+    }
+}
+
 void Node::schedule(SEL_SCHEDULE selector)
 {
     this->schedule(selector, 0.0f, CC_REPEAT_FOREVER, 0.0f);
@@ -1622,6 +2552,8 @@ void Node::resume()
     _scheduler->resumeTarget(this);
     _actionManager->resumeTarget(this);
     _eventDispatcher->resumeEventListenersForTarget(this);
+    if (_componentContainer)
+        _componentContainer->resume();
 }
 
 void Node::pause()
@@ -1629,6 +2561,8 @@ void Node::pause()
     _scheduler->pauseTarget(this);
     _actionManager->pauseTarget(this);
     _eventDispatcher->pauseEventListenersForTarget(this);
+    if (_componentContainer)
+        _componentContainer->pause();
 }
 
 void Node::resumeSchedulerAndActions()
@@ -1799,6 +2733,7 @@ void Node::setNodeToParentTransform(const Mat4& transform)
     _transform = transform;
     _transformDirty = false;
     _transformUpdated = true;
+    setBoundsDirty();
 
     if (_additionalTransform)
         // _additionalTransform[1] has a copy of lastest transform
@@ -1832,6 +2767,7 @@ void Node::setAdditionalTransform(const Mat4* additionalTransform)
         _additionalTransform[0] = *additionalTransform;
     }
     _transformUpdated = _additionalTransformDirty = _inverseDirty = true;
+    setBoundsDirty();
 }
 
 void Node::setAdditionalTransform(const Mat4& additionalTransform)
@@ -1864,9 +2800,43 @@ AffineTransform Node::getNodeToWorldAffineTransform() const
     return this->getNodeToParentAffineTransform(nullptr);
 }
 
+const WorldTransformCache* Node::updateWorldTransformCache() const
+{
+    const WorldTransformCache* parentCache = _parent ? _parent->updateWorldTransformCache() : nullptr;
+    const Mat4& local = getNodeToParentTransform();
+
+    if (_worldTransformCache == nullptr)
+    {
+        _worldTransformCache = new (std::nothrow) WorldTransformCache();
+        _worldTransformCache->version = 0;
+        _worldTransformCache->inverseVersion = 0;
+    }
+
+    // the subclasses may compute the transform to their parent without the dirty flags, so it's compared
+    auto cache = _worldTransformCache;
+    unsigned int parentVersion = parentCache ? parentCache->version : 0;
+    if (cache->version == 0 || cache->parent != _parent || cache->parentVersion != parentVersion
+        || memcmp(cache->local.m, local.m, sizeof(local.m)) != 0)
+    {
+        cache->local = local;
+        cache->world = parentCache ? parentCache->world * local : local;
+        cache->parent = _parent;
+        cache->parentVersion = parentVersion;
+        if (++s_worldTransformVersion == 0)
+            s_worldTransformVersion = 1;
+        cache->version = s_worldTransformVersion;
+    }
+    return cache;
+}
+
 Mat4 Node::getNodeToWorldTransform() const
 {
-    return this->getNodeToParentTransform(nullptr);
+    // the subtrees visited on worker threads don't share the caches of their ancestors
+    auto renderer = _director->getRenderer();
+    if (renderer && renderer->isRecordingVisit())
+        return this->getNodeToParentTransform(nullptr);
+
+    return updateWorldTransformCache()->world;
 }
 
 AffineTransform Node::getWorldToNodeAffineTransform() const
@@ -1876,7 +2846,17 @@ AffineTransform Node::getWorldToNodeAffineTransform() const
 
 Mat4 Node::getWorldToNodeTransform() const
 {
-    return getNodeToWorldTransform().getInversed();
+    auto renderer = _director->getRenderer();
+    if (renderer && renderer->isRecordingVisit())
+        return getNodeToWorldTransform().getInversed();
+
+    auto cache = const_cast<WorldTransformCache*>(updateWorldTransformCache());
+    if (cache->inverseVersion != cache->version)
+    {
+        cache->inverse = cache->world.getInversed();
+        cache->inverseVersion = cache->version;
+    }
+    return cache->inverse;
 }
 
 
@@ -1899,6 +2879,28 @@ Vec2 Node::convertToWorldSpace(const Vec2& nodePoint) const
 
 }
 
+static void transformPoints(const Mat4& transform, const Vec2* points, Vec2* result, ssize_t count)
+{
+    const float* m = transform.m;
+    for (ssize_t i = 0; i < count; ++i)
+    {
+        float x = points[i].x;
+        float y = points[i].y;
+        result[i].x = m[0] * x + m[4] * y + m[12];
+        result[i].y = m[1] * x + m[5] * y + m[13];
+    }
+}
+
+void Node::convertToNodeSpace(const Vec2* worldPoints, Vec2* nodePoints, ssize_t count) const
+{
+    transformPoints(getWorldToNodeTransform(), worldPoints, nodePoints, count);
+}
+
+void Node::convertToWorldSpace(const Vec2* nodePoints, Vec2* worldPoints, ssize_t count) const
+{
+    transformPoints(getNodeToWorldTransform(), nodePoints, worldPoints, count);
+}
+
 Vec2 Node::convertToNodeSpaceAR(const Vec2& worldPoint) const
 {
     Vec2 nodePoint(convertToNodeSpace(worldPoint));
@@ -2194,6 +3196,7 @@ bool isScreenPointInRect(const Vec2 &pt, const Camera* camera, const Mat4& w2l,
 void Node::setCameraMask(unsigned short mask, bool applyChildren)
 {
     _cameraMask = mask;
+    setSubtreeCameraMaskDirty();
     if (applyChildren)
     {
         for (const auto& child : _children)
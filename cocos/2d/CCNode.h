@@ -30,6 +30,7 @@
 #define __CCNODE_H__
 
 #include <cstdint>
+#include <memory>
 #include "base/ccMacros.h"
 #include "base/CCVector.h"
 #include "base/CCProtocols.h"
@@ -62,12 +63,45 @@ class GLProgramState;
 class Material;
 class Camera;
 class PhysicsBody;
+class TransformHierarchy;
+class SpatialIndex;
+class ChildIndex;
+struct WorldTransformCache;
+struct FixedUpdateState;
 
 /**
  * @addtogroup _2d
  * @{
  */
 
+/** @class NodePathQuery
+ * @brief A search string of `Node::enumerateChildren()`, parsed once.
+ *
+ * The parts of the path that are regular expressions are compiled once, the plain names are compared by hash
+ * and found with the child index of the nodes, see `Node::setChildIndexEnabled()`. Keep a query to search the
+ * same path often; the search strings given to `Node::enumerateChildren()` are parsed once too, while few
+ * different strings are used.
+ * @since v3.14
+ * @js NA
+ */
+class CC_DLL NodePathQuery
+{
+public:
+    /**
+     * @param path The search string, see `Node::enumerateChildren()`.
+     */
+    explicit NodePathQuery(const std::string& path);
+
+    /** Returns the search string. */
+    const std::string& getPath() const;
+
+private:
+    friend class Node;
+    struct Data;
+    // shared by the copies, it's immutable
+    std::shared_ptr<const Data> _data;
+};
+
 enum {
     kNodeOnEnter,
     kNodeOnExit,
@@ -108,6 +142,8 @@ class EventListener;
 class CC_DLL Node : public Ref
 {
 public:
+    CC_DECLARE_ALLOCATOR_POOL(Node)
+
     /** Default tag used for all the nodes */
     static const int INVALID_TAG = -1;
 
@@ -776,6 +812,20 @@ public:
      * Please use `getChildByName()` instead.
      */
      virtual Node * getChildByTag(int tag) const;
+
+    /**
+     * Indexes the children by name and by tag, so `getChildByName()`, `getChildByTag()` and the plain names of
+     * `enumerateChildren()` don't compare every child. Worth it for nodes with many children looked up often.
+     * The index is kept up to date when the children are added, removed, renamed or tagged.
+     * @param enabled Whether or not the children are indexed.
+     * @since v3.14
+     */
+    void setChildIndexEnabled(bool enabled);
+    /**
+     * Returns whether or not the children are indexed by name and by tag.
+     * @since v3.14
+     */
+    bool isChildIndexEnabled() const { return _childIndex != nullptr; }
     
      /**
      * Gets a child from the container with its tag that can be cast to Type T.
@@ -834,6 +884,13 @@ public:
      * @since v3.2
      */
     virtual void enumerateChildren(const std::string &name, std::function<bool(Node* node)> callback) const;
+    /** Search the children of the receiving node with a search string parsed once, see `NodePathQuery`.
+     *
+     * @param query The parsed search string.
+     * @param callback A callback function to execute on nodes that match the query, see above.
+     * @since v3.14
+     */
+    void enumerateChildren(const NodePathQuery& query, const std::function<bool(Node* node)>& callback) const;
     /**
      * Returns the array of the node's children.
      *
@@ -933,6 +990,8 @@ public:
     /**
      * Sorts the children array once before drawing, instead of every time when a child is added or reordered.
      * This approach can improves the performance massively.
+     * When only a few children were added or reordered since the last sort, they are sorted on their own
+     * and merged back into the already sorted children, in O(n + k log k) instead of O(n log n).
      * @note Don't call this manually unless a child added needs to be removed in the same frame.
      */
     virtual void sortAllChildren();
@@ -1382,6 +1441,36 @@ public:
      */
     void unscheduleUpdate(void);
 
+    /**
+     * Schedules the "fixedUpdate" method, called with the fixed timestep of the scheduler zero or more
+     * times per frame, before the "update" methods. Only one "fixedUpdate" method is scheduled per node.
+     * @see Scheduler::scheduleFixedUpdate()
+     * @param priority The nodes with a lower priority are updated first in a step.
+     * @since v3.14
+     * @js NA
+     */
+    void scheduleFixedUpdate(int priority = 0);
+
+    /**
+     * Unschedules the "fixedUpdate" method.
+     * @since v3.14
+     * @js NA
+     */
+    void unscheduleFixedUpdate();
+
+    /**
+     * Enables/Disables interpolating the position set by "fixedUpdate".
+     * The node is drawn between its positions after the last two steps, with Scheduler::getFixedUpdateAlpha(),
+     * so it moves smoothly whatever the number of steps per frame, one step behind the simulation.
+     * "fixedUpdate" sees the simulated position; outside of it getPosition() returns the interpolated one, and
+     * a position set outside of it, eg: by an action, moves the node without interpolation. Disabled by default.
+     * @since v3.14
+     * @js NA
+     */
+    void setFixedUpdateInterpolationEnabled(bool enabled);
+    /** Whether or not the position set by "fixedUpdate" is interpolated. @since v3.14 @js NA */
+    bool isFixedUpdateInterpolationEnabled() const { return _fixedUpdateState != nullptr; }
+
     /**
      * Schedules a custom selector.
      *
@@ -1525,6 +1614,14 @@ public:
      */
     virtual void update(float delta);
 
+    /**
+     * Called with the fixed timestep of the scheduler if "scheduleFixedUpdate" is called, and the node is "live".
+     * @param delta In seconds, Scheduler::getFixedTimestep().
+     * @since v3.14
+     * @js NA
+     */
+    virtual void fixedUpdate(float delta);
+
     /// @} end of Scheduler and Timer
 
     /// @{
@@ -1595,6 +1692,7 @@ public:
 
     /**
      * Returns the world affine transform matrix. The matrix is in Pixels.
+     * It's kept between the calls and only computed again when the transform of the node or of an ancestor changed.
      *
      * @return transformation matrix, in pixels.
      */
@@ -1606,6 +1704,7 @@ public:
 
     /**
      * Returns the inverse world affine transform matrix. The matrix is in Pixels.
+     * It's kept between the calls like `getNodeToWorldTransform()`, it isn't inverted again for an unchanged node.
      *
      * @return The transformation matrix.
      */
@@ -1637,6 +1736,26 @@ public:
      */
     Vec2 convertToWorldSpace(const Vec2& nodePoint) const;
 
+    /**
+     * Converts points to node (local) space coordinates, with one world transform for all of them.
+     *
+     * @param worldPoints The points in world space coordinates.
+     * @param nodePoints The converted points, it can be `worldPoints`.
+     * @param count The number of points.
+     * @since v3.14
+     */
+    void convertToNodeSpace(const Vec2* worldPoints, Vec2* nodePoints, ssize_t count) const;
+
+    /**
+     * Converts points to world space coordinates, with one world transform for all of them.
+     *
+     * @param nodePoints The points in node (local) space coordinates.
+     * @param worldPoints The converted points, it can be `nodePoints`.
+     * @param count The number of points.
+     * @since v3.14
+     */
+    void convertToWorldSpace(const Vec2* nodePoints, Vec2* worldPoints, ssize_t count) const;
+
     /**
      * Converts a Vec2 to node (local) space coordinates. The result is in Points.
      * treating the returned/received node point as anchor relative.
@@ -1856,6 +1975,72 @@ public:
      */
     virtual void setCameraMask(unsigned short mask, bool applyChildren = true);
 
+    /**
+     * Returns the camera masks of the node and of all its descendants combined. visit() returns right away
+     * when the visiting camera sees none of them, so each camera only walks the parts of the scene it can see.
+     * @since v3.14
+     */
+    unsigned short getSubtreeCameraMask() const;
+
+    /**
+     * Marks the node as the root of a subtree that can be visited on a worker thread.
+     * It only has effect when `Renderer::setParallelVisitEnabled(true)` was called and the parent
+     * uses the default `Node::visit()`. The render commands of the subtree are recorded off the
+     * main thread and added to the renderer in the same order as a sequential visit would.
+     * The `draw()` methods of the subtree must not create or release objects, nor rely on the
+     * deprecated Director matrix stack.
+     * @param parallelVisitRoot Whether or not the subtree can be visited in parallel.
+     * @since v3.14
+     */
+    void setParallelVisitRoot(bool parallelVisitRoot) { _parallelVisitRoot = parallelVisitRoot; }
+    /**
+     * Returns whether or not the node subtree can be visited on a worker thread.
+     * @since v3.14
+     */
+    bool isParallelVisitRoot() const { return _parallelVisitRoot; }
+
+    /**
+     * Marks the node as the root of a flat transform hierarchy.
+     * The world transforms and dirty flags of the subtree are kept in contiguous arrays, in depth-first
+     * order, and updated in one linear pass when the root is visited instead of one `transform()`
+     * per visited node. Useful for subtrees with thousands of moving nodes.
+     * The subtrees of nodes that compute the transform of their children themselves, like `BillBoard`,
+     * keep the recursive update.
+     * @param flatTransformRoot Whether or not the subtree transforms are updated in one pass.
+     * @since v3.14
+     */
+    void setFlatTransformRoot(bool flatTransformRoot);
+    /**
+     * Returns whether or not the node is the root of a flat transform hierarchy.
+     * @since v3.14
+     */
+    bool isFlatTransformRoot() const;
+
+    /**
+     * Enables a uniform grid of the children bounding boxes, for 2D scenes with many children.
+     * When visited by the default camera, the children outside of the visible area are rejected
+     * by the grid before being visited: their transforms are not updated and their subtrees are not traversed.
+     * The bounds of a child include its subtree as it is when the child is added or moved;
+     * children whose own children move far away should not be indexed.
+     * The render commands of the children are not recorded on worker threads, see `setParallelVisitRoot()`.
+     * @param enabled Whether or not the children are indexed.
+     * @param cellSize The size of the grid cells, in points of this node.
+     * @since v3.14
+     */
+    void setSpatialIndexEnabled(bool enabled, float cellSize = 256.0f);
+    /**
+     * Returns whether or not the children are indexed in a grid.
+     * @since v3.14
+     */
+    bool isSpatialIndexEnabled() const { return _spatialIndex != nullptr; }
+    /**
+     * Returns the children whose bounding boxes intersect a rectangle, in the order they are drawn.
+     * Uses the grid when `setSpatialIndexEnabled(true)` was called, tests every child otherwise.
+     * @param rect The rectangle in the coordinates of this node.
+     * @since v3.14
+     */
+    std::vector<Node*> getChildrenInRect(const Rect& rect);
+
 CC_CONSTRUCTOR_ACCESS:
     // Nodes should be created using create();
     Node();
@@ -1885,12 +2070,31 @@ protected:
     virtual void disableCascadeColor();
     virtual void updateColor() {}
     
-    bool doEnumerate(std::string name, std::function<bool (Node *)> callback) const;
-    bool doEnumerateRecursive(const Node* node, const std::string &name, std::function<bool (Node *)> callback) const;
+    // the cached world transform, validated up the parent chain
+    const WorldTransformCache* updateWorldTransformCache() const;
+
+    // calls back the children matching the part of the query and the following ones
+    bool doEnumerate(const NodePathQuery& query, size_t part, const std::function<bool (Node *)>& callback) const;
+    bool doEnumerateRecursive(const Node* node, const NodePathQuery& query, const std::function<bool (Node *)>& callback) const;
+    // inform the child index, for the subclasses that don't add or remove with the helpers of Node
+    void childIndexAdd(Node* child);
+    void childIndexRemove(Node* child);
     
     //check whether this camera mask is visible by the current visiting camera
     bool isVisitableByVisitingCamera() const;
+
+    // the subtree camera mask of the node and of its ancestors must be combined again
+    void setSubtreeCameraMaskDirty();
+    // combines the camera mask of the node with the subtree masks of its children
+    virtual unsigned short computeSubtreeCameraMask() const;
     
+    /// Whether or not the node and its children can be part of a flat transform hierarchy, see setFlatTransformRoot().
+    /// Nodes that change their own or their children's transform in visit() must return false.
+    virtual bool isTransformFlattenable() const { return true; }
+
+    // takes the position set outside of the fixed updates as the simulated one
+    void syncFixedUpdatePosition();
+
     // update quaternion from Rotation3D
     void updateRotationQuat();
     // update Rotation3D from quaternion
@@ -1898,6 +2102,15 @@ protected:
     
 private:
     void addChildHelper(Node* child, int localZOrder, int tag, const std::string &name, bool setTag);
+    // the order of the sorted children
+    static bool isDrawnBefore(const Node* n1, const Node* n2);
+    void markChildReordered(Node* child);
+    void unmarkChildReordered(Node* child);
+    void updateNormalizedPosition(uint32_t parentFlags);
+    void setBoundsDirty() { if (_parent && _parent->_spatialIndex) _parent->spatialIndexChildMoved(this); }
+    void spatialIndexChildMoved(Node* child);
+    bool visitSpatialIndex(Renderer* renderer, uint32_t flags, bool visibleByCamera);
+    void leaveTransformHierarchy();
     
 protected:
 
@@ -1936,6 +2149,8 @@ protected:
     mutable bool _transformDirty;   ///< transform dirty flag
     mutable Mat4 _inverse;          ///< inverse transform
     mutable bool _inverseDirty;     ///< inverse transform dirty flag
+    mutable WorldTransformCache* _worldTransformCache; ///< last world transform, allocated when it's first asked
+    FixedUpdateState* _fixedUpdateState; ///< simulated positions, allocated when the fixed update interpolation is enabled
     mutable Mat4* _additionalTransform; ///< two transforms needed by additional transforms
     mutable bool _additionalTransformDirty; ///< transform dirty ?
     bool _transformUpdated;         ///< Whether or not the Transform object was updated since the last frame
@@ -1989,6 +2204,8 @@ protected:
                                           ///< Used by Layer and Scene.
 
     bool _reorderChildDirty;          ///< children order dirty flag
+    bool _reorderPending;             ///< whether or not the node was added or reordered since its parent sorted its children
+    int _reorderedChildrenCount;      ///< number of children with _reorderPending set
     bool _isTransitionFinished;       ///< flag to indicate whether the transition was finished
 
 #if CC_ENABLE_SCRIPT_BINDING
@@ -2009,6 +2226,25 @@ protected:
 
     // camera mask, it is visible only when _cameraMask & current camera' camera flag is true
     unsigned short _cameraMask;
+    // the camera masks of the subtree, computed again when it's dirty; a dirty node has dirty ancestors
+    mutable unsigned short _subtreeCameraMask;
+    mutable bool _subtreeCameraMaskDirty;
+
+    // the subtree may be visited on a worker thread, see setParallelVisitRoot()
+    bool _parallelVisitRoot;
+
+    // the flat transform hierarchy owned by this node, or the one it belongs to, see setFlatTransformRoot()
+    TransformHierarchy* _transformHierarchy;
+    // index of the node in _transformHierarchy, 0 for the root and -1 if none
+    int _transformHandle;
+
+    // grid of the children bounding boxes, see setSpatialIndexEnabled()
+    SpatialIndex* _spatialIndex;
+    // children by hash of name and by tag, see setChildIndexEnabled()
+    ChildIndex* _childIndex;
+
+    // number of hit tested touch listeners associated with this node, see EventListenerTouchOneByOne::setHitTestEnabled()
+    unsigned short _hitTestListeners;
     
     std::function<void()> _onEnterCallback;
     std::function<void()> _onExitCallback;
@@ -2033,6 +2269,11 @@ public:
     friend class PhysicsBody;
 #endif
 
+    friend class TransformHierarchy;
+    friend class SpatialIndex;
+    friend class ChildIndex;
+    friend class HitTestIndex;
+
     static int __attachedNodeCount;
     
 private:
@@ -26,6 +26,7 @@ THE SOFTWARE.
 ****************************************************************************/
 #include "2d/CCParallaxNode.h"
 #include "base/ccCArray.h"
+#include "base/CCDirector.h"
 
 NS_CC_BEGIN
 
@@ -64,6 +65,8 @@ private:
 };
 
 ParallaxNode::ParallaxNode()
+: _positionDirty(true)
+, _lastVisitFrame(0)
 {
     _parallaxArray = ccArrayNew(5);        
     _lastPosition.set(-100.0f, -100.0f);
@@ -151,17 +154,31 @@ void ParallaxNode::visit(Renderer *renderer, const Mat4 &parentTransform, uint32
 {
     //    Vec2 pos = position_;
     //    Vec2    pos = [self convertToWorldSpace:Vec2::ZERO];
-    Vec2 pos = this->absolutePosition();
-    if( ! pos.equals(_lastPosition) )
+    // Walking up the parents is only needed when one of them moved, the flags of the parents tell it.
+    // The flags of the frames that didn't visit the node are lost, e.g. while a parent was hidden.
+    unsigned int frame = _director->getTotalFrames();
+    if (frame != _lastVisitFrame && frame != _lastVisitFrame + 1)
     {
-        for( int i=0; i < _parallaxArray->num; i++ ) 
+        _positionDirty = true;
+    }
+    _lastVisitFrame = frame;
+
+    if (_positionDirty || _transformUpdated || (parentFlags & FLAGS_TRANSFORM_DIRTY))
+    {
+        _positionDirty = false;
+
+        Vec2 pos = this->absolutePosition();
+        if( ! pos.equals(_lastPosition) )
         {
-            PointObject *point = (PointObject*)_parallaxArray->arr[i];
-            float x = -pos.x + pos.x * point->getRatio().x + point->getOffset().x;
-            float y = -pos.y + pos.y * point->getRatio().y + point->getOffset().y;            
-            point->getChild()->setPosition(x,y);
+            for( int i=0; i < _parallaxArray->num; i++ ) 
+            {
+                PointObject *point = (PointObject*)_parallaxArray->arr[i];
+                float x = -pos.x + pos.x * point->getRatio().x + point->getOffset().x;
+                float y = -pos.y + pos.y * point->getRatio().y + point->getOffset().y;            
+                point->getChild()->setPosition(x,y);
+            }
+            _lastPosition = pos;
         }
-        _lastPosition = pos;
     }
     Node::visit(renderer, parentTransform, parentFlags);
 }
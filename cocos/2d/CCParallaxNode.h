@@ -105,6 +105,9 @@ protected:
 
     Vec2    _lastPosition;
     struct _ccArray* _parallaxArray;
+    // the absolute position is computed again when the transform of the node or of a parent changes
+    bool _positionDirty;
+    unsigned int _lastVisitFrame;
 
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(ParallaxNode);
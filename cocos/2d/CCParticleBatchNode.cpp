@@ -220,6 +220,7 @@ int ParticleBatchNode::addChildHelper(ParticleSystem* child, int z, int aTag, co
         child->setTag(aTag);
     else
         child->setName(name);
+    childIndexAdd(child);
     
     child->setLocalZOrder(z);
 
@@ -52,10 +52,20 @@ THE SOFTWARE.
 #include "base/ZipUtils.h"
 #include "base/CCDirector.h"
 #include "base/CCProfiling.h"
+#include "base/CCAsyncTaskPool.h"
+#include "base/CCEventDispatcher.h"
+#include "base/CCEventListenerCustom.h"
 #include "base/ccUTF8.h"
 #include "renderer/CCTextureCache.h"
 #include "platform/CCFileUtils.h"
 
+#ifdef __SSE__
+#include <xmmintrin.h>
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#define CC_PARTICLE_USE_NEON
+#endif
+
 using namespace std;
 
 NS_CC_BEGIN
@@ -95,6 +105,196 @@ inline void normalize_point(float x, float y, particle_point* out)
     out->y = y * n;
 }
 
+// The particle data is laid out as structure of arrays, so the update is done
+// by kernels working on one or a few arrays at a time, four particles per step where
+// SSE or NEON is available. The vector paths repeat the scalar arithmetic in the
+// same order so both give the same results.
+
+// value[i] += delta[i] * dt
+static void integrateParticles(float* value, const float* delta, float dt, int count)
+{
+    int i = 0;
+#ifdef __SSE__
+    const __m128 t = _mm_set1_ps(dt);
+    for (; i + 4 <= count; i += 4)
+    {
+        _mm_storeu_ps(value + i, _mm_add_ps(_mm_loadu_ps(value + i), _mm_mul_ps(_mm_loadu_ps(delta + i), t)));
+    }
+#elif defined(CC_PARTICLE_USE_NEON)
+    for (; i + 4 <= count; i += 4)
+    {
+        vst1q_f32(value + i, vaddq_f32(vld1q_f32(value + i), vmulq_n_f32(vld1q_f32(delta + i), dt)));
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        value[i] += delta[i] * dt;
+    }
+}
+
+// value[i] = MAX(0, value[i] + delta[i] * dt)
+static void integrateParticlesNonNegative(float* value, const float* delta, float dt, int count)
+{
+    int i = 0;
+#ifdef __SSE__
+    const __m128 t = _mm_set1_ps(dt);
+    const __m128 zero = _mm_setzero_ps();
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 v = _mm_add_ps(_mm_loadu_ps(value + i), _mm_mul_ps(_mm_loadu_ps(delta + i), t));
+        _mm_storeu_ps(value + i, _mm_max_ps(v, zero));
+    }
+#elif defined(CC_PARTICLE_USE_NEON)
+    const float32x4_t zero = vdupq_n_f32(0.0f);
+    for (; i + 4 <= count; i += 4)
+    {
+        float32x4_t v = vaddq_f32(vld1q_f32(value + i), vmulq_n_f32(vld1q_f32(delta + i), dt));
+        vst1q_f32(value + i, vmaxq_f32(v, zero));
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        value[i] += delta[i] * dt;
+        value[i] = MAX(0, value[i]);
+    }
+}
+
+// timeToLive[i] -= dt
+static void ageParticles(float* timeToLive, float dt, int count)
+{
+    int i = 0;
+#ifdef __SSE__
+    const __m128 t = _mm_set1_ps(dt);
+    for (; i + 4 <= count; i += 4)
+    {
+        _mm_storeu_ps(timeToLive + i, _mm_sub_ps(_mm_loadu_ps(timeToLive + i), t));
+    }
+#elif defined(CC_PARTICLE_USE_NEON)
+    const float32x4_t t = vdupq_n_f32(dt);
+    for (; i + 4 <= count; i += 4)
+    {
+        vst1q_f32(timeToLive + i, vsubq_f32(vld1q_f32(timeToLive + i), t));
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        timeToLive[i] -= dt;
+    }
+}
+
+// index of the first particle from begin whose time to live ran out, count if none
+static int findDeadParticle(const float* timeToLive, int begin, int count)
+{
+    int i = begin;
+#ifdef __SSE__
+    const __m128 zero = _mm_setzero_ps();
+    for (; i + 4 <= count; i += 4)
+    {
+        int mask = _mm_movemask_ps(_mm_cmple_ps(_mm_loadu_ps(timeToLive + i), zero));
+        if (mask)
+        {
+            while (!(mask & 1))
+            {
+                mask >>= 1;
+                ++i;
+            }
+            return i;
+        }
+    }
+#elif defined(CC_PARTICLE_USE_NEON)
+    const float32x4_t zero = vdupq_n_f32(0.0f);
+    for (; i + 4 <= count; i += 4)
+    {
+        uint32x4_t dead = vcleq_f32(vld1q_f32(timeToLive + i), zero);
+        uint32x2_t folded = vorr_u32(vget_low_u32(dead), vget_high_u32(dead));
+        if (vget_lane_u32(vpmax_u32(folded, folded), 0))
+            break;
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        if (timeToLive[i] <= 0.0f)
+            return i;
+    }
+    return count;
+}
+
+// gravity mode: accelerates by gravity, radial and tangential acceleration, then moves
+static void updateGravityParticles(float* posx, float* posy, float* dirX, float* dirY,
+                                   const float* radialAccel, const float* tangentialAccel,
+                                   const Vec2& gravity, float dt, float yCoordFlipped, int count)
+{
+    int i = 0;
+#ifdef __SSE__
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 one = _mm_set1_ps(1.0f);
+    const __m128 tolerance = _mm_set1_ps(MATH_TOLERANCE);
+    const __m128 gx = _mm_set1_ps(gravity.x);
+    const __m128 gy = _mm_set1_ps(gravity.y);
+    const __m128 t = _mm_set1_ps(dt);
+    const __m128 flip = _mm_set1_ps(yCoordFlipped);
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 x = _mm_loadu_ps(posx + i);
+        __m128 y = _mm_loadu_ps(posy + i);
+
+        // same as normalize_point: no radial direction at the origin, at distance 1 or below the tolerance
+        __m128 n = _mm_add_ps(_mm_mul_ps(x, x), _mm_mul_ps(y, y));
+        __m128 length = _mm_sqrt_ps(n);
+        __m128 valid = _mm_and_ps(_mm_cmpneq_ps(n, one), _mm_cmpge_ps(length, tolerance));
+        valid = _mm_andnot_ps(_mm_and_ps(_mm_cmpeq_ps(x, zero), _mm_cmpeq_ps(y, zero)), valid);
+        __m128 inverse = _mm_div_ps(one, length);
+        __m128 nx = _mm_and_ps(_mm_mul_ps(x, inverse), valid);
+        __m128 ny = _mm_and_ps(_mm_mul_ps(y, inverse), valid);
+
+        __m128 radial = _mm_loadu_ps(radialAccel + i);
+        __m128 tangential = _mm_loadu_ps(tangentialAccel + i);
+        __m128 ax = _mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, radial), _mm_mul_ps(ny, _mm_sub_ps(zero, tangential))), gx);
+        __m128 ay = _mm_add_ps(_mm_add_ps(_mm_mul_ps(ny, radial), _mm_mul_ps(nx, tangential)), gy);
+
+        __m128 dx = _mm_add_ps(_mm_loadu_ps(dirX + i), _mm_mul_ps(ax, t));
+        __m128 dy = _mm_add_ps(_mm_loadu_ps(dirY + i), _mm_mul_ps(ay, t));
+        _mm_storeu_ps(dirX + i, dx);
+        _mm_storeu_ps(dirY + i, dy);
+        _mm_storeu_ps(posx + i, _mm_add_ps(x, _mm_mul_ps(_mm_mul_ps(dx, t), flip)));
+        _mm_storeu_ps(posy + i, _mm_add_ps(y, _mm_mul_ps(_mm_mul_ps(dy, t), flip)));
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        particle_point tmp, radial = {0.0f, 0.0f}, tangential;
+
+        // radial acceleration
+        if (posx[i] || posy[i])
+        {
+            normalize_point(posx[i], posy[i], &radial);
+        }
+        tangential = radial;
+        radial.x *= radialAccel[i];
+        radial.y *= radialAccel[i];
+
+        // tangential acceleration
+        std::swap(tangential.x, tangential.y);
+        tangential.x *= - tangentialAccel[i];
+        tangential.y *= tangentialAccel[i];
+
+        // (gravity + radial + tangential) * dt
+        tmp.x = radial.x + tangential.x + gravity.x;
+        tmp.y = radial.y + tangential.y + gravity.y;
+        tmp.x *= dt;
+        tmp.y *= dt;
+
+        dirX[i] += tmp.x;
+        dirY[i] += tmp.y;
+
+        // this is cocos2d-x v3.0
+        tmp.x = dirX[i] * dt * yCoordFlipped;
+        tmp.y = dirY[i] * dt * yCoordFlipped;
+        posx[i] += tmp.x;
+        posy[i] += tmp.y;
+    }
+}
+
 /**
  A more effect random number getter function, get from ejoy2d.
  */
@@ -187,6 +387,74 @@ void ParticleData::release()
 
 Vector<ParticleSystem*> ParticleSystem::__allInstances;
 float ParticleSystem::__totalParticleCountFactor = 1.0f;
+bool ParticleSystem::__parallelUpdateEnabled = false;
+Vector<ParticleSystem*> ParticleSystem::__parallelUpdateQueue;
+unsigned int ParticleSystem::__parallelUpdateFrame = 0;
+EventListenerCustom* ParticleSystem::__parallelUpdateListener = nullptr;
+std::unordered_map<std::string, ValueMap> ParticleSystem::__emitterTemplates;
+std::unordered_map<std::string, std::vector<std::function<void(bool)>>> ParticleSystem::__pendingTemplates;
+
+// the directory of a plist file, the textures it names are relative to it
+static std::string getPlistDirname(const std::string& plistFile)
+{
+    // FIXME: compute path from a path, should define a function somewhere to do it
+    size_t pos = plistFile.rfind('/');
+    return pos != std::string::npos ? plistFile.substr(0, pos + 1) : "";
+}
+
+// the name of the texture of an emitter, as initWithDictionary() loads it
+static std::string getEmitterTextureName(const ValueMap& dictionary, const std::string& dirname)
+{
+    auto iter = dictionary.find("textureFileName");
+    std::string textureName = iter != dictionary.end() ? iter->second.asString() : "";
+
+    size_t rPos = textureName.rfind('/');
+
+    if (rPos != string::npos)
+    {
+        string textureDir = textureName.substr(0, rPos + 1);
+
+        if (!dirname.empty() && textureDir != dirname)
+        {
+            textureName = textureName.substr(rPos+1);
+            textureName = dirname + textureName;
+        }
+    }
+    else if (!dirname.empty() && !textureName.empty())
+    {
+        textureName = dirname + textureName;
+    }
+    return textureName;
+}
+
+// decodes the base64-gzipped image embedded in a plist file, it can run on any thread
+static Image* decodeEmbeddedImage(const std::string& textureData)
+{
+    unsigned char *buffer = nullptr;
+    unsigned char *deflated = nullptr;
+    Image *image = nullptr;
+    do
+    {
+        int decodeLen = base64Decode((unsigned char*)textureData.c_str(), (unsigned int)textureData.size(), &buffer);
+        CCASSERT( buffer != nullptr, "CCParticleSystem: error decoding textureImageData");
+        CC_BREAK_IF(!buffer);
+
+        ssize_t deflatedLen = ZipUtils::inflateMemory(buffer, decodeLen, &deflated);
+        CCASSERT( deflated != nullptr, "CCParticleSystem: error ungzipping textureImageData");
+        CC_BREAK_IF(!deflated);
+
+        image = new (std::nothrow) Image();
+        bool isOK = image && image->initWithImageData(deflated, deflatedLen);
+        CCASSERT(isOK, "CCParticleSystem: error init image with Data");
+        if (!isOK)
+        {
+            CC_SAFE_RELEASE_NULL(image);
+        }
+    } while (0);
+    free(buffer);
+    free(deflated);
+    return image;
+}
 
 ParticleSystem::ParticleSystem()
 : _isBlendAdditive(false)
@@ -224,6 +492,8 @@ ParticleSystem::ParticleSystem()
 , _positionType(PositionType::FREE)
 , _paused(false)
 , _sourcePositionCompatible(true) // In the furture this member's default value maybe false or be removed.
+, _parallelUpdateTime(-1)
+, _useCapturedTransform(false)
 {
     modeA.gravity.setZero();
     modeA.speed = 0;
@@ -286,21 +556,22 @@ bool ParticleSystem::initWithFile(const std::string& plistFile)
 {
     bool ret = false;
     _plistFile = FileUtils::getInstance()->fullPathForFilename(plistFile);
-    ValueMap dict = FileUtils::getInstance()->getValueMapFromFile(_plistFile);
 
-    CCASSERT( !dict.empty(), "Particles: file not found");
-    
-    // FIXME: compute path from a path, should define a function somewhere to do it
-    string listFilePath = plistFile;
-    if (listFilePath.find('/') != string::npos)
+    // the same effects are created again and again, only parse their files once
+    ValueMap parsed;
+    auto iter = __emitterTemplates.find(_plistFile);
+    if (iter == __emitterTemplates.end())
     {
-        listFilePath = listFilePath.substr(0, listFilePath.rfind('/') + 1);
-        ret = this->initWithDictionary(dict, listFilePath);
-    }
-    else
-    {
-        ret = this->initWithDictionary(dict, "");
+        parsed = FileUtils::getInstance()->getValueMapFromFile(_plistFile);
+        CCASSERT( !parsed.empty(), "Particles: file not found");
+        if (!parsed.empty())
+        {
+            iter = __emitterTemplates.emplace(_plistFile, std::move(parsed)).first;
+        }
     }
+    ValueMap& dict = iter != __emitterTemplates.end() ? iter->second : parsed;
+
+    ret = this->initWithDictionary(dict, getPlistDirname(plistFile));
     
     return ret;
 }
@@ -313,9 +584,6 @@ bool ParticleSystem::initWithDictionary(ValueMap& dictionary)
 bool ParticleSystem::initWithDictionary(ValueMap& dictionary, const std::string& dirname)
 {
     bool ret = false;
-    unsigned char *buffer = nullptr;
-    unsigned char *deflated = nullptr;
-    Image *image = nullptr;
     do 
     {
         int maxParticles = dictionary["maxParticles"].asInt();
@@ -473,24 +741,7 @@ bool ParticleSystem::initWithDictionary(ValueMap& dictionary, const std::string&
 
                 // texture        
                 // Try to get the texture from the cache
-                std::string textureName = dictionary["textureFileName"].asString();
-                
-                size_t rPos = textureName.rfind('/');
-               
-                if (rPos != string::npos)
-                {
-                    string textureDir = textureName.substr(0, rPos + 1);
-                    
-                    if (!dirname.empty() && textureDir != dirname)
-                    {
-                        textureName = textureName.substr(rPos+1);
-                        textureName = dirname + textureName;
-                    }
-                }
-                else if (!dirname.empty() && !textureName.empty())
-                {
-                	textureName = dirname + textureName;
-                }
+                std::string textureName = getEmitterTextureName(dictionary, dirname);
                 
                 Texture2D *tex = nullptr;
                 
@@ -508,6 +759,11 @@ bool ParticleSystem::initWithDictionary(ValueMap& dictionary, const std::string&
                 {
                     setTexture(tex);
                 }
+                else if ((tex = Director::getInstance()->getTextureCache()->getTextureForKey(_plistFile + textureName)))
+                {
+                    // the embedded image was already decoded by another system of this file
+                    setTexture(tex);
+                }
                 else if( dictionary.find("textureImageData") != dictionary.end() )
                 {                        
                     std::string textureData = dictionary.at("textureImageData").asString();
@@ -517,19 +773,9 @@ bool ParticleSystem::initWithDictionary(ValueMap& dictionary, const std::string&
                     if (dataLen != 0)
                     {
                         // if it fails, try to get it from the base64-gzipped data    
-                        int decodeLen = base64Decode((unsigned char*)textureData.c_str(), (unsigned int)dataLen, &buffer);
-                        CCASSERT( buffer != nullptr, "CCParticleSystem: error decoding textureImageData");
-                        CC_BREAK_IF(!buffer);
-                        
-                        ssize_t deflatedLen = ZipUtils::inflateMemory(buffer, decodeLen, &deflated);
-                        CCASSERT( deflated != nullptr, "CCParticleSystem: error ungzipping textureImageData");
-                        CC_BREAK_IF(!deflated);
-                        
                         // For android, we should retain it in VolatileTexture::addImage which invoked in Director::getInstance()->getTextureCache()->addUIImage()
-                        image = new (std::nothrow) Image();
-                        bool isOK = image->initWithImageData(deflated, deflatedLen);
-                        CCASSERT(isOK, "CCParticleSystem: error init image with Data");
-                        CC_BREAK_IF(!isOK);
+                        Image* image = decodeEmbeddedImage(textureData);
+                        CC_BREAK_IF(!image);
                         
                         setTexture(Director::getInstance()->getTextureCache()->addImage(image, _plistFile + textureName));
 
@@ -545,8 +791,6 @@ bool ParticleSystem::initWithDictionary(ValueMap& dictionary, const std::string&
             ret = true;
         }
     } while (0);
-    free(buffer);
-    free(deflated);
     return ret;
 }
 
@@ -701,7 +945,7 @@ dc[i] = (dc[i] - c[i]) / _particleData.timeToLive[i];\
     Vec2 pos;
     if (_positionType == PositionType::FREE)
     {
-        pos = this->convertToWorldSpace(Vec2::ZERO);
+        pos = _useCapturedTransform ? _capturedWorldPosition : this->convertToWorldSpace(Vec2::ZERO);
     }
     else if (_positionType == PositionType::RELATIVE)
     {
@@ -864,6 +1108,22 @@ void ParticleSystem::update(float dt)
 {
     CC_PROFILER_START_CATEGORY(kProfilerCategoryParticles , "CCParticleSystem - update");
 
+    updateEmission(dt);
+
+    if (__parallelUpdateEnabled && !_batchNode)
+    {
+        queueParallelUpdate(dt);
+    }
+    else
+    {
+        finishUpdate(updateParticles(dt));
+    }
+
+    CC_PROFILER_STOP_CATEGORY(kProfilerCategoryParticles , "CCParticleSystem - update");
+}
+
+void ParticleSystem::updateEmission(float dt)
+{
     if (_isActive && _emissionRate)
     {
         float rate = 1.0f / _emissionRate;
@@ -889,143 +1149,293 @@ void ParticleSystem::update(float dt)
             this->stopSystem();
         }
     }
-    
+}
+
+bool ParticleSystem::updateParticles(float dt)
+{
+    bool finished = simulateParticles(dt);
+
+    updateParticleQuads();
+    _transformSystemDirty = false;
+
+    return finished;
+}
+
+bool ParticleSystem::simulateParticles(float dt)
+{
+    bool finished = false;
+
+    ageParticles(_particleData.timeToLive, dt, _particleCount);
+
+    // remove the dead particles, each hole is filled with the last live particle
+    for (int i = findDeadParticle(_particleData.timeToLive, 0, _particleCount); i < _particleCount;
+         i = findDeadParticle(_particleData.timeToLive, i + 1, _particleCount))
     {
-        for (int i = 0; i < _particleCount; ++i)
+        while (_particleCount - 1 > i && _particleData.timeToLive[_particleCount - 1] <= 0.0f)
         {
-            _particleData.timeToLive[i] -= dt;
+            removeLastParticle();
         }
-        
-        for (int i = 0; i < _particleCount; ++i)
+        if (i != _particleCount - 1)
         {
-            if (_particleData.timeToLive[i] <= 0.0f)
-            {
-                int j = _particleCount - 1;
-                while (j > 0 && _particleData.timeToLive[j] <= 0)
-                {
-                    _particleCount--;
-                    j--;
-                }
-                _particleData.copyParticle(i, _particleCount - 1);
-                if (_batchNode)
-                {
-                    //disable the switched particle
-                    int currentIndex = _particleData.atlasIndex[i];
-                    _batchNode->disableParticle(_atlasIndex + currentIndex);
-                    //switch indexes
-                    _particleData.atlasIndex[_particleCount - 1] = currentIndex;
-                }
-                --_particleCount;
-                if( _particleCount == 0 && _isAutoRemoveOnFinish )
-                {
-                    this->unscheduleUpdate();
-                    _parent->removeChild(this, true);
-                    return;
-                }
-            }
+            int currentIndex = _particleData.atlasIndex[i];
+            _particleData.copyParticle(i, _particleCount - 1);
+            //switch indexes
+            _particleData.atlasIndex[_particleCount - 1] = currentIndex;
+        }
+        removeLastParticle();
+
+        if (_particleCount == 0)
+        {
+            finished = true;
         }
+    }
+    
+    if (_emitterMode == Mode::GRAVITY)
+    {
+        updateGravityParticles(_particleData.posx, _particleData.posy, _particleData.modeA.dirX, _particleData.modeA.dirY,
+                               _particleData.modeA.radialAccel, _particleData.modeA.tangentialAccel,
+                               modeA.gravity, dt, _yCoordFlipped, _particleCount);
+    }
+    else
+    {
+        //Why use so many for-loop separately instead of putting them together?
+        //When the processor needs to read from or write to a location in memory,
+        //it first checks whether a copy of that data is in the cache.
+        //And every property's memory of the particle system is continuous,
+        //for the purpose of improving cache hit rate, we should process only one property in one for-loop AFAP.
+        //It was proved to be effective especially for low-end machine. 
+        integrateParticles(_particleData.modeB.angle, _particleData.modeB.degreesPerSecond, dt, _particleCount);
+        integrateParticles(_particleData.modeB.radius, _particleData.modeB.deltaRadius, dt, _particleCount);
         
-        if (_emitterMode == Mode::GRAVITY)
+        for (int i = 0; i < _particleCount; ++i)
         {
-            for (int i = 0 ; i < _particleCount; ++i)
-            {
-                particle_point tmp, radial = {0.0f, 0.0f}, tangential;
-                
-                // radial acceleration
-                if (_particleData.posx[i] || _particleData.posy[i])
-                {
-                    normalize_point(_particleData.posx[i], _particleData.posy[i], &radial);
-                }
-                tangential = radial;
-                radial.x *= _particleData.modeA.radialAccel[i];
-                radial.y *= _particleData.modeA.radialAccel[i];
-                
-                // tangential acceleration
-                std::swap(tangential.x, tangential.y);
-                tangential.x *= - _particleData.modeA.tangentialAccel[i];
-                tangential.y *= _particleData.modeA.tangentialAccel[i];
-                
-                // (gravity + radial + tangential) * dt
-                tmp.x = radial.x + tangential.x + modeA.gravity.x;
-                tmp.y = radial.y + tangential.y + modeA.gravity.y;
-                tmp.x *= dt;
-                tmp.y *= dt;
-                
-                _particleData.modeA.dirX[i] += tmp.x;
-                _particleData.modeA.dirY[i] += tmp.y;
-                
-                // this is cocos2d-x v3.0
-                // if (_configName.length()>0 && _yCoordFlipped != -1)
-                
-                // this is cocos2d-x v3.0
-                tmp.x = _particleData.modeA.dirX[i] * dt * _yCoordFlipped;
-                tmp.y = _particleData.modeA.dirY[i] * dt * _yCoordFlipped;
-                _particleData.posx[i] += tmp.x;
-                _particleData.posy[i] += tmp.y;
-            }
+            _particleData.posx[i] = - cosf(_particleData.modeB.angle[i]) * _particleData.modeB.radius[i];
         }
-        else
+        for (int i = 0; i < _particleCount; ++i)
         {
-            //Why use so many for-loop separately instead of putting them together?
-            //When the processor needs to read from or write to a location in memory,
-            //it first checks whether a copy of that data is in the cache.
-            //And every property's memory of the particle system is continuous,
-            //for the purpose of improving cache hit rate, we should process only one property in one for-loop AFAP.
-            //It was proved to be effective especially for low-end machine. 
-            for (int i = 0; i < _particleCount; ++i)
-            {
-                _particleData.modeB.angle[i] += _particleData.modeB.degreesPerSecond[i] * dt;
-            }
-            
-            for (int i = 0; i < _particleCount; ++i)
-            {
-                _particleData.modeB.radius[i] += _particleData.modeB.deltaRadius[i] * dt;
-            }
-            
-            for (int i = 0; i < _particleCount; ++i)
-            {
-                _particleData.posx[i] = - cosf(_particleData.modeB.angle[i]) * _particleData.modeB.radius[i];
-            }
-            for (int i = 0; i < _particleCount; ++i)
-            {
-                _particleData.posy[i] = - sinf(_particleData.modeB.angle[i]) * _particleData.modeB.radius[i] * _yCoordFlipped;
-            }
+            _particleData.posy[i] = - sinf(_particleData.modeB.angle[i]) * _particleData.modeB.radius[i] * _yCoordFlipped;
         }
-        
-        //color r,g,b,a
-        for (int i = 0 ; i < _particleCount; ++i)
+    }
+    
+    //color r,g,b,a
+    integrateParticles(_particleData.colorR, _particleData.deltaColorR, dt, _particleCount);
+    integrateParticles(_particleData.colorG, _particleData.deltaColorG, dt, _particleCount);
+    integrateParticles(_particleData.colorB, _particleData.deltaColorB, dt, _particleCount);
+    integrateParticles(_particleData.colorA, _particleData.deltaColorA, dt, _particleCount);
+    //size
+    integrateParticlesNonNegative(_particleData.size, _particleData.deltaSize, dt, _particleCount);
+    //angle
+    integrateParticles(_particleData.rotation, _particleData.deltaRotation, dt, _particleCount);
+
+    return finished;
+}
+
+void ParticleSystem::prewarm(float duration, float step)
+{
+    CCASSERT(step > 0, "ParticleSystem: the prewarm step must be positive");
+
+    CC_PROFILER_START_CATEGORY(kProfilerCategoryParticles , "CCParticleSystem - prewarm");
+
+    while (duration > 0)
+    {
+        float dt = MIN(step, duration);
+        updateEmission(dt);
+        simulateParticles(dt);
+        duration -= dt;
+    }
+    updateParticleQuads();
+    _transformSystemDirty = false;
+
+    CC_PROFILER_STOP_CATEGORY(kProfilerCategoryParticles , "CCParticleSystem - prewarm");
+}
+
+void ParticleSystem::prewarmAsync(float duration, const std::function<void(ParticleSystem*)>& callback)
+{
+    CCASSERT(!_running && !_batchNode, "ParticleSystem: can't prewarm a running or batched system on another thread");
+
+    // the transforms of the ancestors can't be computed on a worker thread
+    if (_positionType == PositionType::FREE)
+    {
+        _capturedWorldPosition = this->convertToWorldSpace(Vec2::ZERO);
+        _capturedWorldToNodeTransform = getWorldToNodeTransform();
+        _useCapturedTransform = true;
+    }
+
+    this->retain();
+    auto jobSystem = JobSystem::getInstance();
+    auto job = jobSystem->schedule([this, duration]() {
+        prewarm(duration);
+    });
+    jobSystem->scheduleOnCocosThread([this, callback]() {
+        _useCapturedTransform = false;
+        if (callback)
         {
-            _particleData.colorR[i] += _particleData.deltaColorR[i] * dt;
+            callback(this);
         }
-        
-        for (int i = 0 ; i < _particleCount; ++i)
+        this->release();
+    }, { job });
+}
+
+void ParticleSystem::copyEmitterSettings(const ParticleSystem* other)
+{
+    if (_texture != other->_texture)
+    {
+        setTexture(other->_texture);
+    }
+    setTotalParticles(other->_totalParticles);
+
+    _configName = other->_configName;
+    _plistFile = other->_plistFile;
+    _isBlendAdditive = other->_isBlendAdditive;
+    _isAutoRemoveOnFinish = other->_isAutoRemoveOnFinish;
+    _duration = other->_duration;
+    _sourcePosition = other->_sourcePosition;
+    _posVar = other->_posVar;
+    _life = other->_life;
+    _lifeVar = other->_lifeVar;
+    _angle = other->_angle;
+    _angleVar = other->_angleVar;
+    _emitterMode = other->_emitterMode;
+    modeA = other->modeA;
+    modeB = other->modeB;
+    _startSize = other->_startSize;
+    _startSizeVar = other->_startSizeVar;
+    _endSize = other->_endSize;
+    _endSizeVar = other->_endSizeVar;
+    _startColor = other->_startColor;
+    _startColorVar = other->_startColorVar;
+    _endColor = other->_endColor;
+    _endColorVar = other->_endColorVar;
+    _startSpin = other->_startSpin;
+    _startSpinVar = other->_startSpinVar;
+    _endSpin = other->_endSpin;
+    _endSpinVar = other->_endSpinVar;
+    _emissionRate = other->_emissionRate;
+    _blendFunc = other->_blendFunc;
+    _opacityModifyRGB = other->_opacityModifyRGB;
+    _yCoordFlipped = other->_yCoordFlipped;
+    _positionType = other->_positionType;
+    _sourcePositionCompatible = other->_sourcePositionCompatible;
+    _paused = false;
+
+    // start again without any particle
+    _particleCount = 0;
+    _emitCounter = 0;
+    _isActive = true;
+    _elapsed = 0;
+}
+
+void ParticleSystem::purgeCachedData()
+{
+    __emitterTemplates.clear();
+}
+
+void ParticleSystem::loadTemplateAsync(const std::string& plistFile, const std::function<void(bool)>& callback)
+{
+    std::string fullPath = FileUtils::getInstance()->fullPathForFilename(plistFile);
+    if (fullPath.empty() || __emitterTemplates.find(fullPath) != __emitterTemplates.end())
+    {
+        if (callback)
         {
-            _particleData.colorG[i] += _particleData.deltaColorG[i] * dt;
+            callback(!fullPath.empty());
         }
-        
-        for (int i = 0 ; i < _particleCount; ++i)
+        return;
+    }
+
+    // a file loading already only calls the new callback too
+    auto pending = __pendingTemplates.find(fullPath);
+    if (pending != __pendingTemplates.end())
+    {
+        pending->second.push_back(callback);
+        return;
+    }
+    __pendingTemplates[fullPath].push_back(callback);
+
+    struct Load
+    {
+        ValueMap dictionary;
+        Image* image;
+    };
+    auto load = std::make_shared<Load>();
+    load->image = nullptr;
+    std::string dirname = getPlistDirname(plistFile);
+
+    auto finish = [load, fullPath]() {
+        bool loaded = !load->dictionary.empty();
+        if (loaded && __emitterTemplates.find(fullPath) == __emitterTemplates.end())
         {
-            _particleData.colorB[i] += _particleData.deltaColorB[i] * dt;
+            __emitterTemplates.emplace(fullPath, std::move(load->dictionary));
         }
-        
-        for (int i = 0 ; i < _particleCount; ++i)
+
+        auto iter = __pendingTemplates.find(fullPath);
+        auto callbacks = std::move(iter->second);
+        __pendingTemplates.erase(iter);
+        for (auto& callback : callbacks)
         {
-            _particleData.colorA[i] += _particleData.deltaColorA[i] * dt;
+            if (callback)
+            {
+                callback(loaded);
+            }
         }
-        //size
-        for (int i = 0 ; i < _particleCount; ++i)
+    };
+
+    auto jobSystem = JobSystem::getInstance();
+    auto parse = jobSystem->schedule([load, fullPath]() {
+        load->dictionary = FileUtils::getInstance()->getValueMapFromFile(fullPath);
+    });
+    jobSystem->scheduleOnCocosThread([load, fullPath, dirname, finish]() {
+        auto& dictionary = load->dictionary;
+        auto textureCache = Director::getInstance()->getTextureCache();
+        std::string textureName = load->dictionary.empty() ? "" : getEmitterTextureName(dictionary, dirname);
+
+        // the texture of a batched system isn't loaded, but the same file may be used without a batch node too
+        if (!textureName.empty() && !textureCache->getTextureForKey(textureName))
         {
-            _particleData.size[i] += (_particleData.deltaSize[i] * dt);
-            _particleData.size[i] = MAX(0, _particleData.size[i]);
+            auto fileUtils = FileUtils::getInstance();
+            bool notify = fileUtils->isPopupNotify();
+            fileUtils->setPopupNotify(false);
+            bool exists = fileUtils->isFileExist(textureName);
+            fileUtils->setPopupNotify(notify);
+
+            if (exists)
+            {
+                textureCache->addImageAsync(textureName, [finish](Texture2D*) {
+                    finish();
+                });
+                return;
+            }
         }
-        //angle
-        for (int i = 0 ; i < _particleCount; ++i)
+
+        auto embedded = dictionary.find("textureImageData");
+        if (embedded != dictionary.end() && !textureCache->getTextureForKey(textureName)
+            && !textureCache->getTextureForKey(fullPath + textureName))
         {
-            _particleData.rotation[i] += _particleData.deltaRotation[i] * dt;
+            auto jobSystem = JobSystem::getInstance();
+            auto decode = jobSystem->schedule([load]() {
+                load->image = decodeEmbeddedImage(load->dictionary.at("textureImageData").asString());
+            });
+            jobSystem->scheduleOnCocosThread([load, fullPath, textureName, finish]() {
+                if (load->image)
+                {
+                    Director::getInstance()->getTextureCache()->addImage(load->image, fullPath + textureName);
+                    CC_SAFE_RELEASE_NULL(load->image);
+                }
+                finish();
+            }, { decode });
+            return;
         }
-        
-        updateParticleQuads();
-        _transformSystemDirty = false;
+
+        finish();
+    }, { parse });
+}
+
+void ParticleSystem::finishUpdate(bool finished)
+{
+    if (finished && _isAutoRemoveOnFinish && _parent)
+    {
+        this->unscheduleUpdate();
+        _parent->removeChild(this, true);
+        return;
     }
 
     // only update gl buffer when visible
@@ -1033,8 +1443,102 @@ void ParticleSystem::update(float dt)
     {
         postStep();
     }
+}
 
-    CC_PROFILER_STOP_CATEGORY(kProfilerCategoryParticles , "CCParticleSystem - update");
+void ParticleSystem::setParallelUpdateEnabled(bool enabled)
+{
+    if (__parallelUpdateEnabled == enabled)
+        return;
+
+    __parallelUpdateEnabled = enabled;
+    if (!enabled)
+    {
+        runParallelUpdate();
+        if (__parallelUpdateListener)
+        {
+            Director::getInstance()->getEventDispatcher()->removeEventListener(__parallelUpdateListener);
+            CC_SAFE_RELEASE_NULL(__parallelUpdateListener);
+        }
+    }
+}
+
+void ParticleSystem::queueParallelUpdate(float dt)
+{
+    auto director = Director::getInstance();
+
+    // the queue is emptied after the update of every frame, unless the listener was removed with all the others
+    if (!__parallelUpdateQueue.empty() && __parallelUpdateFrame != director->getTotalFrames())
+    {
+        runParallelUpdate();
+        director->getEventDispatcher()->removeEventListener(__parallelUpdateListener);
+        CC_SAFE_RELEASE_NULL(__parallelUpdateListener);
+    }
+    if (__parallelUpdateListener == nullptr)
+    {
+        __parallelUpdateListener = director->getEventDispatcher()->addCustomEventListener(Director::EVENT_AFTER_UPDATE, [](EventCustom*) {
+            runParallelUpdate();
+        });
+        __parallelUpdateListener->retain();
+    }
+    __parallelUpdateFrame = director->getTotalFrames();
+
+    if (_parallelUpdateTime >= 0)
+    {
+        // updated twice in a frame, simulate both steps at once
+        _parallelUpdateTime += dt;
+        return;
+    }
+
+    // the transforms of the ancestors can't be computed on a worker thread
+    if (_positionType == PositionType::FREE)
+    {
+        _capturedWorldPosition = this->convertToWorldSpace(Vec2::ZERO);
+        _capturedWorldToNodeTransform = getWorldToNodeTransform();
+        _useCapturedTransform = true;
+    }
+    _parallelUpdateTime = dt;
+    __parallelUpdateQueue.pushBack(this);
+}
+
+void ParticleSystem::runParallelUpdate()
+{
+    if (__parallelUpdateQueue.empty())
+        return;
+
+    CC_PROFILER_START_CATEGORY(kProfilerCategoryParticles , "CCParticleSystem - parallel update");
+
+    // the systems stay retained by the queue until they are finished
+    Vector<ParticleSystem*> systems;
+    std::swap(systems, __parallelUpdateQueue);
+
+    std::vector<char> finished(systems.size(), 0);
+    JobSystem::getInstance()->parallelFor(systems.size(), 1, [&systems, &finished](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            auto system = systems.at(i);
+            finished[i] = system->updateParticles(system->_parallelUpdateTime);
+        }
+    });
+
+    for (ssize_t i = 0; i < systems.size(); ++i)
+    {
+        auto system = systems.at(i);
+        system->_parallelUpdateTime = -1;
+        system->_useCapturedTransform = false;
+        system->finishUpdate(finished[i] != 0);
+    }
+
+    CC_PROFILER_STOP_CATEGORY(kProfilerCategoryParticles , "CCParticleSystem - parallel update");
+}
+
+void ParticleSystem::removeLastParticle()
+{
+    --_particleCount;
+    if (_batchNode)
+    {
+        //disable the removed particle
+        _batchNode->disableParticle(_atlasIndex + _particleData.atlasIndex[_particleCount]);
+    }
 }
 
 void ParticleSystem::updateWithNoTime(void)
@@ -39,6 +39,7 @@ NS_CC_BEGIN
  */
 
 class ParticleBatchNode;
+class EventListenerCustom;
 
 /** @struct sParticle
 Structure that contains the values of each particle.
@@ -254,13 +255,67 @@ public:
     /** Gets all ParticleSystem references
      */
     static Vector<ParticleSystem*>& getAllParticleSystems();
+
+    /** Simulates the particles of all the systems in parallel on the JobSystem.
+     * Emission still happens in update(), the simulation and the quads of the systems updated
+     * in a frame are then computed together once the scheduler has updated everything, see
+     * Director::EVENT_AFTER_UPDATE. Systems in a ParticleBatchNode are still updated one by one.
+     * Subclasses overriding updateParticleQuads() have to keep it thread safe.
+     *
+     * @param enabled True to simulate in parallel, false by default.
+     * @since v3.14
+     */
+    static void setParallelUpdateEnabled(bool enabled);
+    /** Whether or not the particles of all the systems are simulated in parallel.
+     * @since v3.14
+     */
+    static bool isParallelUpdateEnabled() { return __parallelUpdateEnabled; }
+
+    /** Removes the emitter templates parsed from the plist files.
+     * initWithFile() keeps the parsed files so that creating the same effect again doesn't read,
+     * parse and decode the plist file again.
+     * @since v3.14
+     */
+    static void purgeCachedData();
+
+    /** Reads a plist file and decodes its texture on the worker threads of the JobSystem, then keeps its
+     * emitter template like initWithFile() does. Creating systems of the file afterwards doesn't read,
+     * parse nor decode anything, see ParticleSystemQuad::createAsync().
+     * A texture file is loaded with TextureCache::addImageAsync(), an image embedded in the plist file is
+     * decoded on a worker thread.
+     *
+     * @param plistFile Particle plist file name.
+     * @param callback Called on the cocos thread with false if the file couldn't be read, at once if the
+     * file was already loaded.
+     * @since v3.14
+     */
+    static void loadTemplateAsync(const std::string& plistFile, const std::function<void(bool)>& callback);
 public:
     void addParticles(int count);
+
+    /** Fast-forwards the simulation, e.g. to show a fire already burning when it appears.
+     * The system is updated with fixed steps, the quads are only updated after the last one.
+     * Systems drawn by ParticleSystemGPU don't support it.
+     *
+     * @param duration Seconds to simulate.
+     * @param step Duration of each step.
+     * @since v3.14
+     */
+    void prewarm(float duration, float step = 1.0f / 30);
+    /** Fast-forwards the simulation on the JobSystem, see prewarm().
+     * The system can't be in a running scene or a ParticleBatchNode, and shouldn't be modified
+     * until the callback is called on the cocos thread.
+     *
+     * @param duration Seconds to simulate.
+     * @param callback Called on the cocos thread once the system is prewarmed, e.g. to add it to the scene.
+     * @since v3.14
+     */
+    void prewarmAsync(float duration, const std::function<void(ParticleSystem*)>& callback);
     
     void stopSystem();
     /** Kill all living particles.
      */
-    void resetSystem();
+    virtual void resetSystem();
     /** Whether or not the system is full.
      *
      * @return True if the system is full.
@@ -822,6 +877,28 @@ CC_CONSTRUCTOR_ACCESS:
 
 protected:
     virtual void updateBlendFunc();
+
+    /** Removes the last particle, disabling its quad in the batch node. */
+    void removeLastParticle();
+
+    /** Emits new particles and checks the duration of the system. */
+    void updateEmission(float dt);
+    /** Moves and ages the particles, then updates the quads. Returns true if the last particle died. */
+    bool updateParticles(float dt);
+    /** Moves and ages the particles without updating the quads. Returns true if the last particle died. */
+    bool simulateParticles(float dt);
+
+    /** Copies the emitter settings of another system, the particle data is not reallocated
+     * unless it has more particles than allocated. Used to reset the pooled systems.
+     */
+    void copyEmitterSettings(const ParticleSystem* other);
+    /** Removes a finished system or uploads the quads. */
+    void finishUpdate(bool finished);
+
+    /** Defers the simulation to the parallel update of all the systems. */
+    void queueParallelUpdate(float dt);
+    /** Simulates the queued systems on the JobSystem. */
+    static void runParallelUpdate();
     
 private:
     friend class EngineDataManager;
@@ -992,7 +1069,24 @@ protected:
     bool _sourcePositionCompatible;
 
     static Vector<ParticleSystem*> __allInstances;
-    
+
+    /** time to simulate in the parallel update, -1 if the system isn't queued */
+    float _parallelUpdateTime;
+    /** world transform captured on the cocos thread for the parallel update of PositionType::FREE */
+    bool _useCapturedTransform;
+    Vec2 _capturedWorldPosition;
+    Mat4 _capturedWorldToNodeTransform;
+
+    static bool __parallelUpdateEnabled;
+    static Vector<ParticleSystem*> __parallelUpdateQueue;
+    static unsigned int __parallelUpdateFrame;
+    static EventListenerCustom* __parallelUpdateListener;
+
+    /** plist files parsed by initWithFile, by full path */
+    static std::unordered_map<std::string, ValueMap> __emitterTemplates;
+    /** callbacks of the plist files loaded by loadTemplateAsync, by full path */
+    static std::unordered_map<std::string, std::vector<std::function<void(bool)>>> __pendingTemplates;
+
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(ParticleSystem);
 };
@@ -36,6 +36,8 @@ THE SOFTWARE.
 #include "renderer/CCTextureAtlas.h"
 #include "renderer/ccGLStateCache.h"
 #include "renderer/CCRenderer.h"
+#include "renderer/CCGLProgramCache.h"
+#include "renderer/CCTexture2D.h"
 #include "base/CCDirector.h"
 #include "base/CCEventType.h"
 #include "base/CCConfiguration.h"
@@ -49,6 +51,7 @@ ParticleSystemQuad::ParticleSystemQuad()
 :_quads(nullptr)
 ,_indices(nullptr)
 ,_VAOname(0)
+,_drawnQueueGeneration(0)
 {
     memset(_buffersVBO, 0, sizeof(_buffersVBO));
 }
@@ -269,6 +272,20 @@ inline void updatePosWithParticle(V3F_C4B_T2F_Quad *quad, const Vec2& newPositio
     GLfloat y2 = size_2;
     GLfloat x = newPosition.x;
     GLfloat y = newPosition.y;
+
+    // most particles don't rotate, skip the trigonometry for them
+    if (rotation == 0.0f)
+    {
+        quad->bl.vertices.x = x1 + x;
+        quad->bl.vertices.y = y1 + y;
+        quad->br.vertices.x = x2 + x;
+        quad->br.vertices.y = y1 + y;
+        quad->tl.vertices.x = x1 + x;
+        quad->tl.vertices.y = y2 + y;
+        quad->tr.vertices.x = x2 + x;
+        quad->tr.vertices.y = y2 + y;
+        return;
+    }
     
     GLfloat r = (GLfloat)-CC_DEGREES_TO_RADIANS(rotation);
     GLfloat cr = cosf(r);
@@ -308,7 +325,7 @@ void ParticleSystemQuad::updateParticleQuads()
     Vec2 currentPosition;
     if (_positionType == PositionType::FREE)
     {
-        currentPosition = this->convertToWorldSpace(Vec2::ZERO);
+        currentPosition = _useCapturedTransform ? _capturedWorldPosition : this->convertToWorldSpace(Vec2::ZERO);
     }
     else if (_positionType == PositionType::RELATIVE)
     {
@@ -331,7 +348,7 @@ void ParticleSystemQuad::updateParticleQuads()
     if( _positionType == PositionType::FREE )
     {
         Vec3 p1(currentPosition.x, currentPosition.y, 0);
-        Mat4 worldToNodeTM = getWorldToNodeTransform();
+        Mat4 worldToNodeTM = _useCapturedTransform ? _capturedWorldToNodeTransform : getWorldToNodeTransform();
         worldToNodeTM.transformPoint(&p1);
         Vec3 p2;
         Vec2 newPos;
@@ -400,14 +417,11 @@ void ParticleSystemQuad::updateParticleQuads()
         
         for (int i = 0; i < _particleCount; ++i,++quad,++r,++g,++b,++a)
         {
-            GLubyte colorR = *r * *a * 255;
-            GLubyte colorG = *g * *a * 255;
-            GLubyte colorB = *b * *a * 255;
-            GLubyte colorA = *a * 255;
-            quad->bl.colors.set(colorR, colorG, colorB, colorA);
-            quad->br.colors.set(colorR, colorG, colorB, colorA);
-            quad->tl.colors.set(colorR, colorG, colorB, colorA);
-            quad->tr.colors.set(colorR, colorG, colorB, colorA);
+            Color4B color(*r * *a * 255, *g * *a * 255, *b * *a * 255, *a * 255);
+            quad->bl.colors = color;
+            quad->br.colors = color;
+            quad->tl.colors = color;
+            quad->tr.colors = color;
         }
     }
     else
@@ -420,14 +434,11 @@ void ParticleSystemQuad::updateParticleQuads()
         
         for (int i = 0; i < _particleCount; ++i,++quad,++r,++g,++b,++a)
         {
-            GLubyte colorR = *r * 255;
-            GLubyte colorG = *g * 255;
-            GLubyte colorB = *b * 255;
-            GLubyte colorA = *a * 255;
-            quad->bl.colors.set(colorR, colorG, colorB, colorA);
-            quad->br.colors.set(colorR, colorG, colorB, colorA);
-            quad->tl.colors.set(colorR, colorG, colorB, colorA);
-            quad->tr.colors.set(colorR, colorG, colorB, colorA);
+            Color4B color(*r * 255, *g * 255, *b * 255, *a * 255);
+            quad->bl.colors = color;
+            quad->br.colors = color;
+            quad->tl.colors = color;
+            quad->tr.colors = color;
         }
     }
 }
@@ -436,8 +447,8 @@ void ParticleSystemQuad::postStep()
 {
     glBindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
     
-    // Option 1: Sub Data
-    glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(_quads[0])*_totalParticles, _quads);
+    // Option 1: Sub Data, only the quads of the live particles are drawn
+    glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(_quads[0])*_particleCount, _quads);
     
     // Option 2: Data
     //  glBufferData(GL_ARRAY_BUFFER, sizeof(quads_[0]) * particleCount, quads_, GL_DYNAMIC_DRAW);
@@ -459,8 +470,14 @@ void ParticleSystemQuad::draw(Renderer *renderer, const Mat4 &transform, uint32_
     //quad command
     if(_particleCount > 0)
     {
-        _quadCommand.init(_globalZOrder, _texture, getGLProgramState(), _blendFunc, _quads, _particleCount, transform, flags);
-        renderer->addCommand(&_quadCommand);
+        // _quadCommand is still queued when the particles are drawn twice in a frame
+        auto quadCommand = &_quadCommand;
+        if (_drawnQueueGeneration == renderer->getQueueGeneration())
+            quadCommand = renderer->generateTransientQuadCommand();
+        _drawnQueueGeneration = renderer->getQueueGeneration();
+
+        quadCommand->init(_globalZOrder, _texture, getGLProgramState(), _blendFunc, _quads, _particleCount, transform, flags);
+        renderer->addCommand(quadCommand);
     }
 }
 
@@ -697,8 +714,666 @@ ParticleSystemQuad * ParticleSystemQuad::create() {
     return nullptr;
 }
 
+// implementation of the pool
+
+namespace
+{
+    struct ParticleSystemPool
+    {
+        // the settings of the file, never added to a scene
+        ParticleSystem* prototype;
+        Vector<ParticleSystemQuad*> systems;
+        ssize_t cursor;
+    };
+    std::unordered_map<std::string, ParticleSystemPool> s_particleSystemPools;
+
+    ParticleSystemPool* getParticleSystemPool(const std::string& filename)
+    {
+        auto iter = s_particleSystemPools.find(filename);
+        if (iter != s_particleSystemPools.end())
+        {
+            return &iter->second;
+        }
+
+        ParticleSystem* prototype = ParticleSystem::create(filename);
+        if (prototype == nullptr)
+        {
+            return nullptr;
+        }
+        prototype->retain();
+
+        ParticleSystemPool& pool = s_particleSystemPools[filename];
+        pool.prototype = prototype;
+        pool.cursor = 0;
+        return &pool;
+    }
+
+    ParticleSystemQuad* addPooledParticleSystem(ParticleSystemPool* pool)
+    {
+        auto system = ParticleSystemQuad::create(pool->prototype->getResourceFile());
+        if (system)
+        {
+            pool->systems.pushBack(system);
+        }
+        return system;
+    }
+}
+
+void ParticleSystemQuad::createAsync(const std::string& filename, const std::function<void(ParticleSystemQuad*)>& callback)
+{
+    CCASSERT(callback, "ParticleSystemQuad: createAsync needs a callback");
+    ParticleSystem::loadTemplateAsync(filename, [filename, callback](bool loaded) {
+        callback(loaded ? ParticleSystemQuad::create(filename) : nullptr);
+    });
+}
+
+ParticleSystemQuad * ParticleSystemQuad::createFromPool(const std::string& filename)
+{
+    auto pool = getParticleSystemPool(filename);
+    if (pool == nullptr)
+    {
+        return nullptr;
+    }
+
+    // the systems used last are less likely to be finished, start after them
+    const ssize_t count = pool->systems.size();
+    for (ssize_t i = 0; i < count; ++i)
+    {
+        ssize_t index = (pool->cursor + i) % count;
+        auto system = pool->systems.at(index);
+        if (system->getReferenceCount() == 1)
+        {
+            pool->cursor = index + 1;
+
+            auto prototype = pool->prototype;
+            system->copyEmitterSettings(prototype);
+            system->setPosition(prototype->getPosition());
+            system->setRotation(prototype->getRotation());
+            system->setScaleX(prototype->getScaleX());
+            system->setScaleY(prototype->getScaleY());
+            system->setVisible(prototype->isVisible());
+            system->setTag(Node::INVALID_TAG);
+            return system;
+        }
+    }
+
+    pool->cursor = count + 1;
+    return addPooledParticleSystem(pool);
+}
+
+void ParticleSystemQuad::preallocatePool(const std::string& filename, int count)
+{
+    auto pool = getParticleSystemPool(filename);
+    while (pool && pool->systems.size() < count && addPooledParticleSystem(pool))
+    {
+    }
+}
+
+void ParticleSystemQuad::purgePool()
+{
+    for (auto iter = s_particleSystemPools.begin(); iter != s_particleSystemPools.end();)
+    {
+        auto& systems = iter->second.systems;
+        for (ssize_t i = systems.size() - 1; i >= 0; --i)
+        {
+            if (systems.at(i)->getReferenceCount() == 1)
+            {
+                systems.erase(i);
+            }
+        }
+        iter->second.cursor = 0;
+
+        if (systems.empty())
+        {
+            iter->second.prototype->release();
+            iter = s_particleSystemPools.erase(iter);
+        }
+        else
+        {
+            ++iter;
+        }
+    }
+}
+
 std::string ParticleSystemQuad::getDescription() const
 {
     return StringUtils::format("<ParticleSystemQuad | Tag = %d, Total Particles = %d>", _tag, _totalParticles);
 }
+// implementation ParticleSystemGPU
+
+static const char* s_particleSystemGPUKey = "ParticleSystemGPU";
+
+// The particles follow the integration of ParticleSystem::update, with no radial and tangential acceleration
+static const char* s_particleSystemGPUVert = R"(
+attribute vec4 a_position;
+attribute vec4 a_color;
+attribute vec4 a_texCoord;
+attribute vec4 a_texCoord1;
+attribute vec4 a_texCoord2;
+attribute vec4 a_texCoord3;
+
+uniform float u_time;
+uniform float u_resetTime;
+// gravity, y coordinate flip, radius mode
+uniform vec4 u_motion;
+uniform mat4 u_startTransform;
+uniform vec2 u_origin;
+uniform vec2 u_texCoords[3];
+uniform float u_premultiply;
+
+#ifdef GL_ES
+varying lowp vec4 v_fragmentColor;
+varying mediump vec2 v_texCoord;
+#else
+varying vec4 v_fragmentColor;
+varying vec2 v_texCoord;
+#endif
+
+void main()
+{
+    float t = u_time - a_texCoord.x;
+    float alive = step(u_resetTime, a_texCoord.x) * step(t, a_texCoord.y);
+
+    vec2 position;
+    if (u_motion.w > 0.5)
+    {
+        float angle = a_texCoord1.x + a_texCoord1.y * t;
+        float radius = a_texCoord1.z + a_texCoord1.w * t;
+        position = vec2(-cos(angle) * radius, -sin(angle) * radius * u_motion.z);
+    }
+    else
+    {
+        position = a_position.xy + (a_texCoord1.xy * t + 0.5 * u_motion.xy * t * t) * u_motion.z;
+    }
+    position += (u_startTransform * vec4(a_position.zw, 0.0, 1.0)).xy - u_origin;
+
+    // dead particles collapse to a point
+    float size = max(a_texCoord3.x + a_texCoord3.y * t, 0.0) * alive;
+    float rotation = -radians(a_texCoord3.z + a_texCoord3.w * t);
+    vec2 corner = a_texCoord.zw * size;
+    float c = cos(rotation);
+    float s = sin(rotation);
+    position += vec2(corner.x * c - corner.y * s, corner.x * s + corner.y * c);
+    gl_Position = CC_MVPMatrix * vec4(position, 0.0, 1.0);
+
+    vec4 color = clamp(a_color + a_texCoord2 * t, 0.0, 1.0);
+    color.rgb *= mix(1.0, color.a, u_premultiply);
+    v_fragmentColor = color;
+    v_texCoord = u_texCoords[0] + (a_texCoord.z + 0.5) * u_texCoords[1] + (a_texCoord.w + 0.5) * u_texCoords[2];
+}
+)";
+
+static const char* s_particleSystemGPUFrag = R"(
+#ifdef GL_ES
+precision lowp float;
+#endif
+
+varying vec4 v_fragmentColor;
+varying vec2 v_texCoord;
+
+void main()
+{
+    gl_FragColor = v_fragmentColor * texture2D(CC_Texture0, v_texCoord);
+}
+)";
+
+// the indices are GLushort, so the buffer is drawn in batches of this many particles
+static const int PARTICLE_GPU_BATCH = 16384;
+
+// the time is rebased when the system is empty, so its float precision doesn't degrade
+static const float PARTICLE_GPU_MAX_TIME = 1024.0f;
+
+ParticleSystemGPU::ParticleSystemGPU()
+: _slotCursor(0)
+, _usedSlots(0)
+, _time(0)
+, _resetTime(-1)
+, _warnedAboutAccelerations(false)
+, _texCoordOrigin(0, 1)
+, _texCoordX(1, 0)
+, _texCoordY(0, -1)
+, _uniformTime(-1)
+, _uniformResetTime(-1)
+, _uniformMotion(-1)
+, _uniformStartTransform(-1)
+, _uniformOrigin(-1)
+, _uniformTexCoords(-1)
+, _uniformPremultiply(-1)
+{
+    memset(_buffersVBO, 0, sizeof(_buffersVBO));
+}
+
+ParticleSystemGPU::~ParticleSystemGPU()
+{
+    glDeleteBuffers(2, &_buffersVBO[0]);
+}
+
+ParticleSystemGPU* ParticleSystemGPU::create(const std::string& filename)
+{
+    ParticleSystemGPU *ret = new (std::nothrow) ParticleSystemGPU();
+    if (ret && ret->initWithFile(filename))
+    {
+        ret->autorelease();
+        return ret;
+    }
+    CC_SAFE_DELETE(ret);
+    return ret;
+}
+
+ParticleSystemGPU* ParticleSystemGPU::createWithTotalParticles(int numberOfParticles)
+{
+    ParticleSystemGPU *ret = new (std::nothrow) ParticleSystemGPU();
+    if (ret && ret->initWithTotalParticles(numberOfParticles))
+    {
+        ret->autorelease();
+        return ret;
+    }
+    CC_SAFE_DELETE(ret);
+    return ret;
+}
+
+ParticleSystemGPU* ParticleSystemGPU::create(ValueMap& dictionary)
+{
+    ParticleSystemGPU *ret = new (std::nothrow) ParticleSystemGPU();
+    if (ret && ret->initWithDictionary(dictionary))
+    {
+        ret->autorelease();
+        return ret;
+    }
+    CC_SAFE_DELETE(ret);
+    return ret;
+}
+
+bool ParticleSystemGPU::initWithTotalParticles(int numberOfParticles)
+{
+    if (!ParticleSystem::initWithTotalParticles(numberOfParticles))
+        return false;
+
+    _deathTimes.assign(_totalParticles, -1.0f);
+    setupBuffers();
+    initGLProgram();
+
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+    auto listener = EventListenerCustom::create(EVENT_RENDERER_RECREATED, CC_CALLBACK_1(ParticleSystemGPU::listenRendererRecreated, this));
+    _eventDispatcher->addEventListenerWithSceneGraphPriority(listener, this);
+#endif
+
+    return true;
+}
+
+void ParticleSystemGPU::initGLProgram()
+{
+    auto glProgram = GLProgramCache::getInstance()->getGLProgram(s_particleSystemGPUKey);
+    if (glProgram == nullptr)
+    {
+        glProgram = GLProgram::createWithByteArrays(s_particleSystemGPUVert, s_particleSystemGPUFrag);
+        GLProgramCache::getInstance()->addGLProgram(glProgram, s_particleSystemGPUKey);
+    }
+    setGLProgram(glProgram);
+
+    _uniformTime = glProgram->getUniformLocation("u_time");
+    _uniformResetTime = glProgram->getUniformLocation("u_resetTime");
+    _uniformMotion = glProgram->getUniformLocation("u_motion");
+    _uniformStartTransform = glProgram->getUniformLocation("u_startTransform");
+    _uniformOrigin = glProgram->getUniformLocation("u_origin");
+    _uniformTexCoords = glProgram->getUniformLocation("u_texCoords");
+    _uniformPremultiply = glProgram->getUniformLocation("u_premultiply");
+}
+
+void ParticleSystemGPU::setupBuffers()
+{
+    glDeleteBuffers(2, &_buffersVBO[0]);
+    glGenBuffers(2, &_buffersVBO[0]);
+
+    // all the slots start dead, with no size
+    std::vector<Vertex> vertices(_totalParticles * 4);
+    memset(vertices.data(), 0, vertices.size() * sizeof(Vertex));
+    glBindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(Vertex) * vertices.size(), vertices.data(), GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    const int batch = std::min(_totalParticles, PARTICLE_GPU_BATCH);
+    std::vector<GLushort> indices(batch * 6);
+    for (int i = 0; i < batch; ++i)
+    {
+        const unsigned int i6 = i*6;
+        const unsigned int i4 = i*4;
+        indices[i6+0] = (GLushort) i4+0;
+        indices[i6+1] = (GLushort) i4+1;
+        indices[i6+2] = (GLushort) i4+2;
+
+        indices[i6+5] = (GLushort) i4+1;
+        indices[i6+4] = (GLushort) i4+2;
+        indices[i6+3] = (GLushort) i4+3;
+    }
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffersVBO[1]);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(indices[0]) * indices.size(), indices.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+    _slotCursor = 0;
+    _usedSlots = 0;
+    _particleCount = 0;
+    std::fill(_deathTimes.begin(), _deathTimes.end(), -1.0f);
+    _time = 0;
+    _resetTime = -1;
+
+    CHECK_GL_ERROR_DEBUG();
+}
+
+void ParticleSystemGPU::listenRendererRecreated(EventCustom* /*event*/)
+{
+    // the particles are lost with the buffers
+    memset(_buffersVBO, 0, sizeof(_buffersVBO));
+    setupBuffers();
+
+    auto glProgram = GLProgramCache::getInstance()->getGLProgram(s_particleSystemGPUKey);
+    if (glProgram && glProgram == getGLProgram())
+    {
+        glProgram->reset();
+        glProgram->initWithByteArrays(s_particleSystemGPUVert, s_particleSystemGPUFrag);
+        glProgram->link();
+        glProgram->updateUniforms();
+    }
+    initGLProgram();
+}
+
+void ParticleSystemGPU::setTextureWithRect(Texture2D* texture, const Rect& pointRect)
+{
+    if( !_texture || texture->getName() != _texture->getName() )
+    {
+        ParticleSystem::setTexture(texture);
+    }
+
+    Rect rect = Rect(
+        pointRect.origin.x * CC_CONTENT_SCALE_FACTOR(),
+        pointRect.origin.y * CC_CONTENT_SCALE_FACTOR(),
+        pointRect.size.width * CC_CONTENT_SCALE_FACTOR(),
+        pointRect.size.height * CC_CONTENT_SCALE_FACTOR());
+
+    GLfloat wide = (GLfloat)texture->getPixelsWide();
+    GLfloat high = (GLfloat)texture->getPixelsHigh();
+
+    GLfloat left = rect.origin.x / wide;
+    GLfloat bottom = rect.origin.y / high;
+    GLfloat right = left + rect.size.width / wide;
+    GLfloat top = bottom + rect.size.height / high;
+
+    // Important. Texture in cocos2d are inverted, so the Y component should be inverted
+    std::swap(top, bottom);
+
+    _texCoordOrigin.set(left, bottom);
+    _texCoordX.set(right - left, 0);
+    _texCoordY.set(0, top - bottom);
+}
+
+void ParticleSystemGPU::setTexture(Texture2D* texture)
+{
+    const Size& s = texture->getContentSize();
+    this->setTextureWithRect(texture, Rect(0, 0, s.width, s.height));
+}
+
+void ParticleSystemGPU::setBatchNode(ParticleBatchNode* batchNode)
+{
+    CCASSERT(batchNode == nullptr, "ParticleSystemGPU can't be batched");
+    ParticleSystem::setBatchNode(batchNode);
+}
+
+void ParticleSystemGPU::setTotalParticles(int tp)
+{
+    if (tp > _allocatedParticles)
+    {
+        _particleData.release();
+        if (!_particleData.init(tp))
+        {
+            CCLOG("Particle system: not enough memory");
+            return;
+        }
+        _allocatedParticles = tp;
+        _totalParticles = tp;
+        _deathTimes.assign(tp, -1.0f);
+        setupBuffers();
+    }
+    else
+    {
+        _totalParticles = tp;
+    }
+
+    resetSystem();
+}
+
+void ParticleSystemGPU::resetSystem()
+{
+    ParticleSystem::resetSystem();
+
+    // the vertex shader hides the particles born before the reset
+    _resetTime = _time;
+    std::fill(_deathTimes.begin(), _deathTimes.end(), _time);
+    _particleCount = 0;
+    _slotCursor = 0;
+    _usedSlots = 0;
+}
+
+void ParticleSystemGPU::update(float dt)
+{
+    CC_PROFILER_START_CATEGORY(kProfilerCategoryParticles , "CCParticleSystemGPU - update");
+
+    if (_emitterMode == Mode::GRAVITY && !_warnedAboutAccelerations
+        && (modeA.radialAccel || modeA.radialAccelVar || modeA.tangentialAccel || modeA.tangentialAccelVar))
+    {
+        CCLOG("cocos2d: ParticleSystemGPU ignores the radial and tangential accelerations");
+        _warnedAboutAccelerations = true;
+    }
+
+    float birthTime = _time;
+    _time += dt;
+
+    // the live particles are only tracked by their death time
+    int liveCount = 0;
+    for (int i = 0; i < _usedSlots; ++i)
+    {
+        liveCount += _deathTimes[i] > _time;
+    }
+    const bool finished = _particleCount > 0 && liveCount == 0;
+    _particleCount = liveCount;
+
+    if (finished && _isAutoRemoveOnFinish && _parent)
+    {
+        this->unscheduleUpdate();
+        _parent->removeChild(this, true);
+        CC_PROFILER_STOP_CATEGORY(kProfilerCategoryParticles , "CCParticleSystemGPU - update");
+        return;
+    }
+
+    if (_particleCount == 0 && _time > PARTICLE_GPU_MAX_TIME)
+    {
+        // the dead particles would come back with the earlier times
+        std::vector<Vertex> vertices(_usedSlots * 4);
+        memset(vertices.data(), 0, vertices.size() * sizeof(Vertex));
+        glBindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
+        glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(Vertex) * vertices.size(), vertices.data());
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+        std::fill(_deathTimes.begin(), _deathTimes.end(), -1.0f);
+        _slotCursor = 0;
+        _usedSlots = 0;
+        _time -= birthTime;
+        birthTime = 0;
+        _resetTime = -1;
+    }
+
+    // addParticles() writes the new particles after the live count in the particle data
+    const int start = _particleCount;
+    updateEmission(dt);
+    uploadParticles(start, birthTime);
+
+    // the particles are placed like in ParticleSystemQuad::updateParticleQuads
+    if (_positionType == PositionType::FREE)
+    {
+        _startTransform = getWorldToNodeTransform();
+        Vec2 world = this->convertToWorldSpace(Vec2::ZERO);
+        Vec3 origin(world.x, world.y, 0);
+        _startTransform.transformPoint(&origin);
+        _origin.set(origin.x, origin.y);
+    }
+    else if (_positionType == PositionType::RELATIVE)
+    {
+        _startTransform = Mat4::IDENTITY;
+        _origin = _position;
+    }
+    else
+    {
+        _startTransform = Mat4::ZERO;
+        _origin.setZero();
+    }
+
+    CC_PROFILER_STOP_CATEGORY(kProfilerCategoryParticles , "CCParticleSystemGPU - update");
+}
+
+void ParticleSystemGPU::uploadParticles(int start, float birthTime)
+{
+    if (start >= _particleCount)
+        return;
+
+    static const GLfloat corners[4][2] = { {-0.5f, 0.5f}, {-0.5f, -0.5f}, {0.5f, 0.5f}, {0.5f, -0.5f} };
+    const bool radiusMode = _emitterMode == Mode::RADIUS;
+    const int slotCount = static_cast<int>(_deathTimes.size());
+
+    glBindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
+
+    // contiguous slots are uploaded together
+    int runStart = -1;
+    _uploadVertices.clear();
+    for (int i = start; i < _particleCount; ++i)
+    {
+        // there are at least as many free slots as new particles
+        while (_deathTimes[_slotCursor] > _time)
+        {
+            _slotCursor = (_slotCursor + 1) % slotCount;
+        }
+        const int slot = _slotCursor;
+        _slotCursor = (_slotCursor + 1) % slotCount;
+        _usedSlots = std::max(_usedSlots, slot + 1);
+
+        const float life = _particleData.timeToLive[i];
+        _deathTimes[slot] = birthTime + life;
+
+        if (runStart >= 0 && slot != runStart + (int)_uploadVertices.size() / 4)
+        {
+            glBufferSubData(GL_ARRAY_BUFFER, sizeof(Vertex) * 4 * runStart, sizeof(Vertex) * _uploadVertices.size(), _uploadVertices.data());
+            _uploadVertices.clear();
+        }
+        if (_uploadVertices.empty())
+        {
+            runStart = slot;
+        }
+
+        Vertex vertex;
+        vertex.position[0] = _particleData.posx[i];
+        vertex.position[1] = _particleData.posy[i];
+        vertex.position[2] = _particleData.startPosX[i];
+        vertex.position[3] = _particleData.startPosY[i];
+        vertex.color[0] = _particleData.colorR[i];
+        vertex.color[1] = _particleData.colorG[i];
+        vertex.color[2] = _particleData.colorB[i];
+        vertex.color[3] = _particleData.colorA[i];
+        vertex.life[0] = birthTime;
+        vertex.life[1] = life;
+        if (radiusMode)
+        {
+            vertex.motion[0] = _particleData.modeB.angle[i];
+            vertex.motion[1] = _particleData.modeB.degreesPerSecond[i];
+            vertex.motion[2] = _particleData.modeB.radius[i];
+            vertex.motion[3] = _particleData.modeB.deltaRadius[i];
+        }
+        else
+        {
+            vertex.motion[0] = _particleData.modeA.dirX[i];
+            vertex.motion[1] = _particleData.modeA.dirY[i];
+            vertex.motion[2] = 0;
+            vertex.motion[3] = 0;
+        }
+        vertex.deltaColor[0] = _particleData.deltaColorR[i];
+        vertex.deltaColor[1] = _particleData.deltaColorG[i];
+        vertex.deltaColor[2] = _particleData.deltaColorB[i];
+        vertex.deltaColor[3] = _particleData.deltaColorA[i];
+        vertex.size[0] = _particleData.size[i];
+        vertex.size[1] = _particleData.deltaSize[i];
+        vertex.size[2] = _particleData.rotation[i];
+        vertex.size[3] = _particleData.deltaRotation[i];
+
+        for (int corner = 0; corner < 4; ++corner)
+        {
+            vertex.life[2] = corners[corner][0];
+            vertex.life[3] = corners[corner][1];
+            _uploadVertices.push_back(vertex);
+        }
+    }
+    if (!_uploadVertices.empty())
+    {
+        glBufferSubData(GL_ARRAY_BUFFER, sizeof(Vertex) * 4 * runStart, sizeof(Vertex) * _uploadVertices.size(), _uploadVertices.data());
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    CHECK_GL_ERROR_DEBUG();
+}
+
+void ParticleSystemGPU::draw(Renderer* renderer, const Mat4& transform, uint32_t flags)
+{
+    if (_particleCount > 0 && _texture)
+    {
+        _customCommand.init(_globalZOrder, transform, flags);
+        _customCommand.func = CC_CALLBACK_0(ParticleSystemGPU::onDraw, this, transform, flags);
+        renderer->addCommand(&_customCommand);
+    }
+}
+
+void ParticleSystemGPU::onDraw(const Mat4& transform, uint32_t /*flags*/)
+{
+    auto glProgram = getGLProgram();
+    glProgram->use();
+    glProgram->setUniformsForBuiltins(transform);
+
+    const GLfloat texCoords[6] = { _texCoordOrigin.x, _texCoordOrigin.y, _texCoordX.x, _texCoordX.y, _texCoordY.x, _texCoordY.y };
+    glProgram->setUniformLocationWith1f(_uniformTime, _time);
+    glProgram->setUniformLocationWith1f(_uniformResetTime, _resetTime);
+    glProgram->setUniformLocationWith4f(_uniformMotion, modeA.gravity.x, modeA.gravity.y, (GLfloat)_yCoordFlipped, _emitterMode == Mode::RADIUS ? 1.0f : 0.0f);
+    glProgram->setUniformLocationWithMatrix4fv(_uniformStartTransform, _startTransform.m, 1);
+    glProgram->setUniformLocationWith2f(_uniformOrigin, _origin.x, _origin.y);
+    glProgram->setUniformLocationWith2fv(_uniformTexCoords, texCoords, 3);
+    glProgram->setUniformLocationWith1f(_uniformPremultiply, _opacityModifyRGB ? 1.0f : 0.0f);
+
+    GL::bindTexture2D(_texture->getName());
+    GL::blendFunc(_blendFunc.src, _blendFunc.dst);
+    GL::enableVertexAttribs((1 << (GLProgram::VERTEX_ATTRIB_TEX_COORD3 + 1)) - 1);
+
+    glBindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffersVBO[1]);
+
+    int batches = 0;
+    for (int first = 0; first < _usedSlots; first += PARTICLE_GPU_BATCH)
+    {
+        const int count = std::min(PARTICLE_GPU_BATCH, _usedSlots - first);
+        const char* base = (const char*)(sizeof(Vertex) * 4 * first);
+        glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), base + offsetof(Vertex, position));
+        glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_COLOR, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), base + offsetof(Vertex, color));
+        glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORD, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), base + offsetof(Vertex, life));
+        glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORD1, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), base + offsetof(Vertex, motion));
+        glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORD2, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), base + offsetof(Vertex, deltaColor));
+        glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORD3, 4, GL_FLOAT, GL_FALSE, sizeof(Vertex), base + offsetof(Vertex, size));
+        glDrawElements(GL_TRIANGLES, count * 6, GL_UNSIGNED_SHORT, 0);
+        ++batches;
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+    CC_INCREMENT_GL_DRAWN_BATCHES_AND_VERTICES(batches, _usedSlots * 4);
+    CHECK_GL_ERROR_DEBUG();
+}
+
+std::string ParticleSystemGPU::getDescription() const
+{
+    return StringUtils::format("<ParticleSystemGPU | Tag = %d, Total Particles = %d>", _tag, _totalParticles);
+}
+
 NS_CC_END
@@ -30,6 +30,7 @@ THE SOFTWARE.
 
 #include "2d/CCParticleSystem.h"
 #include "renderer/CCQuadCommand.h"
+#include "renderer/CCCustomCommand.h"
 
 NS_CC_BEGIN
 
@@ -84,6 +85,38 @@ public:
      */
     static ParticleSystemQuad * create(ValueMap &dictionary);
 
+    /** Returns a system of a plist file, reusing a pooled system of the same file that is not used anymore.
+     * The pool keeps a reference to its systems and reuses the ones that nothing else retains, e.g. once
+     * setAutoRemoveOnFinish(true) removed them from their parent. A reused system gets the settings, the
+     * position, rotation, scale and visibility of the file again and keeps its particle data, quads and
+     * buffers, so spawning an effect doesn't allocate anything once the pool is warm.
+     *
+     * @param filename Particle plist file name.
+     * @return A ParticleSystemQuad owned by the pool, it is not autoreleased.
+     * @since v3.14
+     */
+    static ParticleSystemQuad * createFromPool(const std::string& filename);
+    /** Creates a system of a plist file without reading or decoding it on the cocos thread.
+     * The file and its texture are loaded on worker threads by ParticleSystem::loadTemplateAsync(), then the
+     * system is created on the cocos thread from the loaded template.
+     *
+     * @param filename Particle plist file name.
+     * @param callback Called on the cocos thread with an autoreleased system, nullptr if the file couldn't be read.
+     * @since v3.14
+     */
+    static void createAsync(const std::string& filename, const std::function<void(ParticleSystemQuad*)>& callback);
+    /** Adds systems to the pool of a plist file until it has count of them, e.g. while loading a level.
+     *
+     * @param filename Particle plist file name.
+     * @param count The number of systems in the pool of the file.
+     * @since v3.14
+     */
+    static void preallocatePool(const std::string& filename, int count);
+    /** Releases the pooled systems that are not used anymore.
+     * @since v3.14
+     */
+    static void purgePool();
+
     /** Sets a new SpriteFrame as particle.
     WARNING: this method is experimental. Use setTextureWithRect instead.
      *
@@ -184,6 +217,7 @@ protected:
     GLuint              _buffersVBO[2]; //0: vertex  1: indices
 
     QuadCommand _quadCommand;           // quad command
+    unsigned int _drawnQueueGeneration; // Renderer::getQueueGeneration() when _quadCommand was added
     
 
 
@@ -191,6 +225,123 @@ private:
     CC_DISALLOW_COPY_AND_ASSIGN(ParticleSystemQuad);
 };
 
+/** @class ParticleSystemGPU
+ * @brief ParticleSystemGPU is a ParticleSystem whose particles are moved by the vertex shader.
+
+It reads the same emitter properties and plist files as ParticleSystemQuad, but the particles
+are only written to the vertex buffer when they are emitted. Every particle follows a closed
+formula of its age, which the vertex shader evaluates, so the CPU cost doesn't depend on the
+number of live particles and systems can be a lot bigger than with ParticleSystemQuad.
+
+Limitations:
+- Radial and tangential accelerations of the gravity mode are ignored.
+- It can't be added to a ParticleBatchNode.
+- It doesn't support subrects with offsets.
+@since v3.14
+@js NA
+@lua NA
+*/
+class CC_DLL ParticleSystemGPU : public ParticleSystem
+{
+public:
+    /** Creates and initializes a ParticleSystemGPU from a plist file.
+     *
+     * @param filename Particle plist file name.
+     * @return An autoreleased ParticleSystemGPU object.
+     */
+    static ParticleSystemGPU* create(const std::string& filename);
+    /** Creates a Particle Emitter with a number of particles.
+     *
+     * @param numberOfParticles A given number of particles.
+     * @return An autoreleased ParticleSystemGPU object.
+     */
+    static ParticleSystemGPU* createWithTotalParticles(int numberOfParticles);
+    /** Creates a Particle Emitter with a dictionary.
+     *
+     * @param dictionary Particle dictionary.
+     * @return An autoreleased ParticleSystemGPU object.
+     */
+    static ParticleSystemGPU* create(ValueMap& dictionary);
+
+    /** Sets a new texture with a rect. The rect is in Points.
+     *
+     * @param texture A given texture.
+     * @param rect A given rect, in points.
+     */
+    void setTextureWithRect(Texture2D* texture, const Rect& rect);
+
+    /** Listen the event that renderer was recreated on Android/WP8.
+     *
+     * @param event the event that renderer was recreated on Android/WP8.
+     */
+    void listenRendererRecreated(EventCustom* event);
+
+    // Overrides
+    virtual void setTexture(Texture2D* texture) override;
+    virtual void update(float dt) override;
+    virtual void resetSystem() override;
+    virtual void draw(Renderer* renderer, const Mat4& transform, uint32_t flags) override;
+    virtual void setBatchNode(ParticleBatchNode* batchNode) override;
+    virtual void setTotalParticles(int tp) override;
+    virtual std::string getDescription() const override;
+
+CC_CONSTRUCTOR_ACCESS:
+    ParticleSystemGPU();
+    virtual ~ParticleSystemGPU();
+
+    virtual bool initWithTotalParticles(int numberOfParticles) override;
+
+protected:
+    /** The attributes of one vertex, the four vertices of a particle only differ by their corner */
+    struct Vertex
+    {
+        GLfloat position[4];    // position relative to the source, start position of the emitter
+        GLfloat color[4];       // color at birth
+        GLfloat life[4];        // birth time, life, corner
+        GLfloat motion[4];      // gravity: direction; radius: angle, radians per second, radius, delta radius
+        GLfloat deltaColor[4];  // color change per second
+        GLfloat size[4];        // size, delta size, rotation, delta rotation
+    };
+
+    void initGLProgram();
+    void setupBuffers();
+    void onDraw(const Mat4& transform, uint32_t flags);
+    /** Writes the particles emitted in this frame, from index start of the particle data, to free slots */
+    void uploadParticles(int start, float birthTime);
+
+    GLuint _buffersVBO[2]; //0: vertex  1: indices
+    CustomCommand _customCommand;
+
+    /** when the particle of each slot of the vertex buffer dies */
+    std::vector<float> _deathTimes;
+    int _slotCursor;
+    int _usedSlots;
+    std::vector<Vertex> _uploadVertices;
+
+    float _time;
+    float _resetTime;
+    // maps the start positions of the particles to node space, see PositionType
+    Mat4 _startTransform;
+    Vec2 _origin;
+    bool _warnedAboutAccelerations;
+
+    // texture coordinates of the bottom left corner and along the quad edges
+    Vec2 _texCoordOrigin;
+    Vec2 _texCoordX;
+    Vec2 _texCoordY;
+
+    GLint _uniformTime;
+    GLint _uniformResetTime;
+    GLint _uniformMotion;
+    GLint _uniformStartTransform;
+    GLint _uniformOrigin;
+    GLint _uniformTexCoords;
+    GLint _uniformPremultiply;
+
+private:
+    CC_DISALLOW_COPY_AND_ASSIGN(ParticleSystemGPU);
+};
+
 // end of _2d group
 /// @}
 
@@ -30,7 +30,6 @@ THE SOFTWARE.
 #include "base/ccMacros.h"
 #include "base/CCDirector.h"
 #include "2d/CCSprite.h"
-#include "renderer/ccGLStateCache.h"
 #include "renderer/CCRenderer.h"
 
 NS_CC_BEGIN
@@ -78,13 +77,13 @@ bool ProgressTimer::initWithSprite(Sprite* sp)
     setSprite(sp);
 
     // shader state
-    setGLProgramState(GLProgramState::getOrCreateWithGLProgramName(GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR, sp->getTexture()));
+    // the shader of the sprites, the renderer transforms the vertices of the triangles
+    setGLProgramState(GLProgramState::getOrCreateWithGLProgramName(GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR_NO_MVP, sp->getTexture()));
     return true;
 }
 
 ProgressTimer::~ProgressTimer(void)
 {
-    CC_SAFE_FREE(_vertexData);
     CC_SAFE_RELEASE(_sprite);
 }
 
@@ -116,10 +115,10 @@ void ProgressTimer::setSprite(Sprite *sprite)
         _sprite = sprite;
         setContentSize(_sprite->getContentSize());
 
-        //    Every time we set a new sprite, we free the current vertex data
+        //    Every time we set a new sprite, we recompute the vertex data
         if (_vertexData)
         {
-            CC_SAFE_FREE(_vertexData);
+            _vertexData = nullptr;
             _vertexDataCount = 0;
             updateProgress();
         }
@@ -133,7 +132,6 @@ void ProgressTimer::setType(Type type)
         //    release all previous information
         if (_vertexData)
         {
-            CC_SAFE_FREE(_vertexData);
             _vertexData = nullptr;
             _vertexDataCount = 0;
         }
@@ -148,7 +146,7 @@ void ProgressTimer::setReverseDirection(bool reverse)
         _reverseDirection = reverse;
 
         //    release all previous information
-        CC_SAFE_FREE(_vertexData);
+        _vertexData = nullptr;
         _vertexDataCount = 0;
     }
 }
@@ -353,15 +351,15 @@ void ProgressTimer::updateRadial(void)
     bool sameIndexCount = true;
     if(_vertexDataCount != index + 3){
         sameIndexCount = false;
-        CC_SAFE_FREE(_vertexData);
+        _vertexData = nullptr;
         _vertexDataCount = 0;
     }
 
 
     if(!_vertexData) {
         _vertexDataCount = index + 3;
-        _vertexData = (V2F_C4B_T2F*)malloc(_vertexDataCount * sizeof(V2F_C4B_T2F));
-        CCASSERT( _vertexData, "CCProgressTimer. Not enough memory");
+        _vertexData = _vertexBuffer;
+        CCASSERT(_vertexDataCount <= MAX_VERTEX_COUNT, "CCProgressTimer. Too many vertices");
     }
     updateColor();
 
@@ -431,8 +429,8 @@ void ProgressTimer::updateBar(void)
     if (!_reverseDirection) {
         if(!_vertexData) {
             _vertexDataCount = 4;
-            _vertexData = (V2F_C4B_T2F*)malloc(_vertexDataCount * sizeof(V2F_C4B_T2F));
-            CCASSERT( _vertexData, "CCProgressTimer. Not enough memory");
+            _vertexData = _vertexBuffer;
+            CCASSERT(_vertexDataCount <= MAX_VERTEX_COUNT, "CCProgressTimer. Too many vertices");
         }
         //    TOPLEFT
         _vertexData[0].texCoords = textureCoordFromAlphaPoint(Vec2(min.x,max.y));
@@ -452,8 +450,8 @@ void ProgressTimer::updateBar(void)
     } else {
         if(!_vertexData) {
             _vertexDataCount = 8;
-            _vertexData = (V2F_C4B_T2F*)malloc(_vertexDataCount * sizeof(V2F_C4B_T2F));
-            CCASSERT( _vertexData, "CCProgressTimer. Not enough memory");
+            _vertexData = _vertexBuffer;
+            CCASSERT(_vertexDataCount <= MAX_VERTEX_COUNT, "CCProgressTimer. Too many vertices");
             //    TOPLEFT 1
             _vertexData[0].texCoords = textureCoordFromAlphaPoint(Vec2(0,1));
             _vertexData[0].vertices = vertexFromAlphaPoint(Vec2(0,1));
@@ -502,52 +500,56 @@ Vec2 ProgressTimer::boundaryTexCoord(char index)
     return Vec2::ZERO;
 }
 
-void ProgressTimer::onDraw(const Mat4 &transform, uint32_t /*flags*/)
+int ProgressTimer::updateTriangleIndices()
 {
-
-    getGLProgram()->use();
-    getGLProgram()->setUniformsForBuiltins(transform);
-
-    GL::blendFunc( _sprite->getBlendFunc().src, _sprite->getBlendFunc().dst );
-
-    GL::enableVertexAttribs(GL::VERTEX_ATTRIB_FLAG_POS_COLOR_TEX );
-
-    GL::bindTexture2D( _sprite->getTexture() );
-
-    glVertexAttribPointer( GLProgram::VERTEX_ATTRIB_POSITION, 2, GL_FLOAT, GL_FALSE, sizeof(_vertexData[0]) , &_vertexData[0].vertices);
-    glVertexAttribPointer( GLProgram::VERTEX_ATTRIB_TEX_COORD, 2, GL_FLOAT, GL_FALSE, sizeof(_vertexData[0]), &_vertexData[0].texCoords);
-    glVertexAttribPointer( GLProgram::VERTEX_ATTRIB_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(_vertexData[0]), &_vertexData[0].colors);
-
-    if(_type == Type::RADIAL)
+    int count = 0;
+    if (_type == Type::RADIAL)
     {
-        glDrawArrays(GL_TRIANGLE_FAN, 0, _vertexDataCount);
-        CC_INCREMENT_GL_DRAWN_BATCHES_AND_VERTICES(1,_vertexDataCount);
-    }
-    else if (_type == Type::BAR)
-    {
-        if (!_reverseDirection) 
+        //    the fan around the midpoint
+        for (int i = 1; i + 1 < _vertexDataCount; ++i)
         {
-            glDrawArrays(GL_TRIANGLE_STRIP, 0, _vertexDataCount);
-            CC_INCREMENT_GL_DRAWN_BATCHES_AND_VERTICES(1,_vertexDataCount);
+            _triangleIndices[count++] = 0;
+            _triangleIndices[count++] = i;
+            _triangleIndices[count++] = i + 1;
         }
-        else 
+    }
+    else
+    {
+        //    a strip of 4 vertices, two strips when the direction is reversed
+        for (int i = 0; i + 3 < _vertexDataCount; i += 4)
         {
-            glDrawArrays(GL_TRIANGLE_STRIP, 0, _vertexDataCount/2);
-            glDrawArrays(GL_TRIANGLE_STRIP, 4, _vertexDataCount/2);
-            // 2 draw calls
-            CC_INCREMENT_GL_DRAWN_BATCHES_AND_VERTICES(2,_vertexDataCount);
+            _triangleIndices[count++] = i;
+            _triangleIndices[count++] = i + 1;
+            _triangleIndices[count++] = i + 2;
+            _triangleIndices[count++] = i + 2;
+            _triangleIndices[count++] = i + 1;
+            _triangleIndices[count++] = i + 3;
         }
     }
+    return count;
 }
 
 void ProgressTimer::draw(Renderer *renderer, const Mat4 &transform, uint32_t flags)
 {
-    if( ! _vertexData || ! _sprite)
+    if( ! _vertexData || ! _sprite || ! _sprite->getTexture())
         return;
 
-    _customCommand.init(_globalZOrder, transform, flags);
-    _customCommand.func = CC_CALLBACK_0(ProgressTimer::onDraw, this, transform, flags);
-    renderer->addCommand(&_customCommand);
+    //    indexed triangles like the sprites, so the renderer batches the timer with the sprites drawing the same texture
+    for (int i = 0; i < _vertexDataCount; ++i)
+    {
+        _triangleVertices[i].vertices.set(_vertexData[i].vertices.x, _vertexData[i].vertices.y, 0.0f);
+        _triangleVertices[i].colors = _vertexData[i].colors;
+        _triangleVertices[i].texCoords = _vertexData[i].texCoords;
+    }
+
+    TrianglesCommand::Triangles triangles;
+    triangles.verts = _triangleVertices;
+    triangles.vertCount = _vertexDataCount;
+    triangles.indices = _triangleIndices;
+    triangles.indexCount = updateTriangleIndices();
+
+    _trianglesCommand.init(_globalZOrder, _sprite->getTexture(), getGLProgramState(), _sprite->getBlendFunc(), triangles, transform, flags);
+    renderer->addCommand(&_trianglesCommand);
 }
 
 
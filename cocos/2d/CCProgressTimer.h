@@ -26,7 +26,7 @@ THE SOFTWARE.
 #ifndef __MISC_NODE_CCPROGRESS_TIMER_H__
 #define __MISC_NODE_CCPROGRESS_TIMER_H__
 
-#include "renderer/CCCustomCommand.h"
+#include "renderer/CCTrianglesCommand.h"
 #include "2d/CCNode.h"
 
 NS_CC_BEGIN
@@ -176,8 +176,12 @@ CC_CONSTRUCTOR_ACCESS:
     bool initWithSprite(Sprite* sp);
     
 protected:
-    void onDraw(const Mat4 &transform, uint32_t flags);
-    
+    /** The most vertices of a radial or a reversed bar timer. */
+    static const int MAX_VERTEX_COUNT = 8;
+
+    // fills _triangleIndices with the triangles of the vertices, returns the number of indices
+    int updateTriangleIndices();
+
     Tex2F textureCoordFromAlphaPoint(Vec2 alpha);
     Vec2 vertexFromAlphaPoint(Vec2 alpha);
     void updateProgress(void);
@@ -192,9 +196,13 @@ protected:
     float _percentage;
     Sprite *_sprite;
     int _vertexDataCount;
+    // points to _vertexBuffer once the vertices are computed, nullptr when they have to be recomputed
     V2F_C4B_T2F *_vertexData;
-    
-    CustomCommand _customCommand;
+    V2F_C4B_T2F _vertexBuffer[MAX_VERTEX_COUNT];
+
+    V3F_C4B_T2F _triangleVertices[MAX_VERTEX_COUNT];
+    unsigned short _triangleIndices[(MAX_VERTEX_COUNT - 2) * 3];
+    TrianglesCommand _trianglesCommand;
 
     bool _reverseDirection;
 
@@ -30,6 +30,7 @@
 
 #include "base/CCDirector.h"
 #include "2d/CCScene.h"
+#include "2d/CCCamera.h"
 
 NS_CC_BEGIN
 
@@ -273,6 +274,13 @@ void ProtectedNode::visit(Renderer* renderer, const Mat4 &parentTransform, uint3
     {
         return;
     }
+
+    // quick return if the visiting camera sees neither the node nor its descendants
+    auto visitingCamera = Camera::getVisitingCamera();
+    if (visitingCamera && ((unsigned short)visitingCamera->getCameraFlag() & getSubtreeCameraMask()) == 0)
+    {
+        return;
+    }
     
     uint32_t flags = processParentFlags(parentTransform, parentFlags);
     
@@ -466,6 +474,16 @@ void ProtectedNode::setCameraMask(unsigned short mask, bool applyChildren)
     
 }
 
+unsigned short ProtectedNode::computeSubtreeCameraMask() const
+{
+    unsigned short mask = Node::computeSubtreeCameraMask();
+    for (const auto& child : _protectedChildren)
+    {
+        mask |= child->getSubtreeCameraMask();
+    }
+    return mask;
+}
+
 void ProtectedNode::setGlobalZOrder(float globalZOrder)
 {
     Node::setGlobalZOrder(globalZOrder);
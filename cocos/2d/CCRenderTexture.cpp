@@ -31,9 +31,11 @@ THE SOFTWARE.
 #include "base/CCEventType.h"
 #include "base/CCConfiguration.h"
 #include "base/CCDirector.h"
+#include "base/CCStencilStateManager.h"
 #include "base/CCEventListenerCustom.h"
 #include "base/CCEventDispatcher.h"
 #include "renderer/CCRenderer.h"
+#include "renderer/ccGLStateCache.h"
 #include "2d/CCCamera.h"
 #include "renderer/CCTextureCache.h"
 
@@ -48,6 +50,7 @@ RenderTexture::RenderTexture()
 , _FBO(0)
 , _depthRenderBuffer(0)
 , _stencilRenderBuffer(0)
+, _depthStencilFormat(0)
 , _oldFBO(0)
 , _texture(0)
 , _textureCopy(0)
@@ -74,18 +77,24 @@ RenderTexture::RenderTexture()
 
 RenderTexture::~RenderTexture()
 {
+    // the sprite owns the texture, keep it for the pool
+    CC_SAFE_RETAIN(_texture);
     CC_SAFE_RELEASE(_sprite);
-    CC_SAFE_RELEASE(_textureCopy);
-    
-    glDeleteFramebuffers(1, &_FBO);
-    if (_depthRenderBuffer)
+
+    RenderTargetPool::Target target;
+    target.texture = _texture;
+    target.textureCopy = _textureCopy;
+    target.fbo = _FBO;
+    target.depthRenderBuffer = _depthRenderBuffer;
+    target.stencilRenderBuffer = _stencilRenderBuffer;
+    target.depthStencilFormat = _depthStencilFormat;
+    if (_texture)
     {
-        glDeleteRenderbuffers(1, &_depthRenderBuffer);
+        RenderTargetPool::getInstance()->recycle(target);
     }
-
-    if (_stencilRenderBuffer)
+    else
     {
-        glDeleteRenderbuffers(1, &_stencilRenderBuffer);
+        RenderTargetPool::destroyTarget(target);
     }
 
     CC_SAFE_DELETE(_UITextureImage);
@@ -190,7 +199,6 @@ bool RenderTexture::initWithWidthAndHeight(int w, int h, Texture2D::PixelFormat
     CCASSERT(format != Texture2D::PixelFormat::A8, "only RGB and RGBA formats are valid for a render texture");
 
     bool ret = false;
-    void *data = nullptr;
     do 
     {
         _fullRect = _rtTextureRect = Rect(0,0,w,h);
@@ -217,12 +225,95 @@ bool RenderTexture::initWithWidthAndHeight(int w, int h, Texture2D::PixelFormat
             powH = ccNextPOT(h);
         }
 
+        _pixelFormat = format;
+        _depthStencilFormat = depthStencilFormat;
+
+        GLint oldRBO;
+        glGetIntegerv(GL_RENDERBUFFER_BINDING, &oldRBO);
+
+        RenderTargetPool::Target target;
+        bool withTextureCopy = Configuration::getInstance()->checkForGLExtension("GL_QCOM");
+        if (RenderTargetPool::getInstance()->acquire(powW, powH, Size((float)w, (float)h), format, depthStencilFormat, withTextureCopy, &target))
+        {
+            _texture = target.texture;
+            _textureCopy = target.textureCopy;
+            _FBO = target.fbo;
+            _depthRenderBuffer = target.depthRenderBuffer;
+            _stencilRenderBuffer = target.stencilRenderBuffer;
+
+            // a grid's texture has no FBO
+            if (!_FBO)
+            {
+                glGenFramebuffers(1, &_FBO);
+                glBindFramebuffer(GL_FRAMEBUFFER, _FBO);
+                glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, _texture->getName(), 0);
+            }
+            glBindFramebuffer(GL_FRAMEBUFFER, _FBO);
+
+            // a new render texture is transparent, clear what the previous one rendered
+            GLfloat oldClearColor[4] = {0.0f};
+            glGetFloatv(GL_COLOR_CLEAR_VALUE, oldClearColor);
+            glClearColor(0, 0, 0, 0);
+            glClear(GL_COLOR_BUFFER_BIT);
+            glClearColor(oldClearColor[0], oldClearColor[1], oldClearColor[2], oldClearColor[3]);
+
+            // the previous owner may have changed the parameters
+            Texture2D::TexParams texParams = {GL_LINEAR, GL_LINEAR, GL_CLAMP_TO_EDGE, GL_CLAMP_TO_EDGE};
+            _texture->setTexParameters(texParams);
+            if (_textureCopy)
+            {
+                _textureCopy->setTexParameters(texParams);
+            }
+        }
+        else
+        {
+            CC_BREAK_IF(!initRenderTarget(powW, powH, w, h, depthStencilFormat));
+        }
+
+        // check if it worked (probably worth doing :) )
+        CCASSERT(glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE, "Could not attach texture to framebuffer");
+
+        _texture->setAntiAliasTexParameters();
+        if(_textureCopy)
+        {
+            _textureCopy->setAntiAliasTexParameters();
+        }
+
+        // retained
+        setSprite(Sprite::createWithTexture(_texture));
+
+        _texture->release();
+        _sprite->setFlippedY(true);
+
+        _sprite->setBlendFunc( BlendFunc::ALPHA_PREMULTIPLIED );
+        _sprite->setOpacityModifyRGB(true);
+
+        glBindRenderbuffer(GL_RENDERBUFFER, oldRBO);
+        glBindFramebuffer(GL_FRAMEBUFFER, _oldFBO);
+        
+        // Disabled by default.
+        _autoDraw = false;
+        
+        // add sprite for backward compatibility
+        addChild(_sprite);
+        
+        ret = true;
+    } while (0);
+    
+    return ret;
+}
+
+bool RenderTexture::initRenderTarget(int powW, int powH, int w, int h, GLuint depthStencilFormat)
+{
+    bool ret = false;
+    void *data = nullptr;
+    do
+    {
         auto dataLen = powW * powH * 4;
         data = malloc(dataLen);
         CC_BREAK_IF(! data);
 
         memset(data, 0, dataLen);
-        _pixelFormat = format;
 
         _texture = new (std::nothrow) Texture2D();
         if (_texture)
@@ -233,9 +324,6 @@ bool RenderTexture::initWithWidthAndHeight(int w, int h, Texture2D::PixelFormat
         {
             break;
         }
-        GLint oldRBO;
-        glGetIntegerv(GL_RENDERBUFFER_BINDING, &oldRBO);
-        
         if (Configuration::getInstance()->checkForGLExtension("GL_QCOM"))
         {
             _textureCopy = new (std::nothrow) Texture2D();
@@ -316,38 +404,11 @@ bool RenderTexture::initWithWidthAndHeight(int w, int h, Texture2D::PixelFormat
             
         }
 
-        // check if it worked (probably worth doing :) )
-        CCASSERT(glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE, "Could not attach texture to framebuffer");
-
-        _texture->setAntiAliasTexParameters();
-        if(_textureCopy)
-        {
-            _textureCopy->setAntiAliasTexParameters();
-        }
-
-        // retained
-        setSprite(Sprite::createWithTexture(_texture));
-
-        _texture->release();
-        _sprite->setFlippedY(true);
-
-        _sprite->setBlendFunc( BlendFunc::ALPHA_PREMULTIPLIED );
-        _sprite->setOpacityModifyRGB(true);
-
-        glBindRenderbuffer(GL_RENDERBUFFER, oldRBO);
-        glBindFramebuffer(GL_FRAMEBUFFER, _oldFBO);
-        
-        // Disabled by default.
-        _autoDraw = false;
-        
-        // add sprite for backward compatibility
-        addChild(_sprite);
-        
         ret = true;
     } while (0);
-    
+
     CC_SAFE_FREE(data);
-    
+
     return ret;
 }
 
@@ -610,6 +671,27 @@ Image* RenderTexture::newImage(bool flipImage)
     return image;
 }
 
+void RenderTexture::newImageAsync(const std::function<void(Image*)>& callback, bool flipImage)
+{
+    CCASSERT(_pixelFormat == Texture2D::PixelFormat::RGBA8888, "only RGBA8888 can be saved as image");
+
+    if (nullptr == _texture)
+    {
+        if (callback)
+        {
+            callback(nullptr);
+        }
+        return;
+    }
+
+    const Size& s = _texture->getContentSizeInPixels();
+
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &_oldFBO);
+    glBindFramebuffer(GL_FRAMEBUFFER, _FBO);
+    utils::readPixelsAsync(0, 0, (int)s.width, (int)s.height, callback, flipImage);
+    glBindFramebuffer(GL_FRAMEBUFFER, _oldFBO);
+}
+
 void RenderTexture::onBegin()
 {
     //
@@ -646,13 +728,14 @@ void RenderTexture::onBegin()
         viewport.origin.x = (_fullRect.origin.x - _rtTextureRect.origin.x) * viewPortRectWidthRatio;
         viewport.origin.y = (_fullRect.origin.y - _rtTextureRect.origin.y) * viewPortRectHeightRatio;
         //glViewport(_fullviewPort.origin.x, _fullviewPort.origin.y, (GLsizei)_fullviewPort.size.width, (GLsizei)_fullviewPort.size.height);
-        glViewport(viewport.origin.x, viewport.origin.y, (GLsizei)viewport.size.width, (GLsizei)viewport.size.height);
+        GL::viewport(viewport.origin.x, viewport.origin.y, (GLsizei)viewport.size.width, (GLsizei)viewport.size.height);
     }
 
     // Adjust the orthographic projection and viewport
     
     glGetIntegerv(GL_FRAMEBUFFER_BINDING, &_oldFBO);
     glBindFramebuffer(GL_FRAMEBUFFER, _FBO);
+    StencilStateManager::invalidateClearedLayers();
 
     // TODO: move this to configuration, so we don't check it every time
     /*  Certain Qualcomm Adreno GPU's will retain data in memory after a frame buffer switch which corrupts the render to the texture. The solution is to clear the frame buffer before rendering to the texture. However, calling glClear has the unintended result of clearing the current texture. Create a temporary texture to overcome this. At the end of RenderTexture::begin(), switch the attached texture to the second one, call glClear, and then switch back to the original texture. This solution is unnecessary for other devices as they don't have the same issue with switching frame buffers.
@@ -672,11 +755,12 @@ void RenderTexture::onEnd()
     Director *director = Director::getInstance();
 
     glBindFramebuffer(GL_FRAMEBUFFER, _oldFBO);
+    StencilStateManager::invalidateClearedLayers();
 
     // restore viewport
     director->setViewport();
     const auto& vp = Camera::getDefaultViewport();
-    glViewport(vp._left, vp._bottom, vp._width, vp._height);
+    GL::viewport(vp._left, vp._bottom, vp._width, vp._height);
     //
     director->loadMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION, _oldProjMatrix);
     director->loadMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW, _oldTransMatrix);
@@ -703,8 +787,8 @@ void RenderTexture::onClear()
         glGetFloatv(GL_DEPTH_CLEAR_VALUE, &oldDepthClearValue);
         glClearDepth(_clearDepth);
 
-        glGetBooleanv(GL_DEPTH_WRITEMASK, &oldDepthWrite);
-        glDepthMask(GL_TRUE);
+        oldDepthWrite = GL::getDepthMask();
+        GL::depthMask(GL_TRUE);
     }
 
     if (_clearFlags & GL_STENCIL_BUFFER_BIT)
@@ -724,7 +808,7 @@ void RenderTexture::onClear()
     if (_clearFlags & GL_DEPTH_BUFFER_BIT)
     {
         glClearDepth(oldDepthClearValue);
-        glDepthMask(oldDepthWrite);
+        GL::depthMask(oldDepthWrite);
     }
     if (_clearFlags & GL_STENCIL_BUFFER_BIT)
     {
@@ -828,4 +912,168 @@ void RenderTexture::end()
 
 }
 
+// implementation RenderTargetPool
+static RenderTargetPool* s_sharedRenderTargetPool = nullptr;
+
+RenderTargetPool::Target::Target()
+: texture(nullptr)
+, textureCopy(nullptr)
+, fbo(0)
+, depthRenderBuffer(0)
+, stencilRenderBuffer(0)
+, depthStencilFormat(0)
+{
+}
+
+RenderTargetPool* RenderTargetPool::getInstance()
+{
+    if (!s_sharedRenderTargetPool)
+    {
+        s_sharedRenderTargetPool = new (std::nothrow) RenderTargetPool();
+    }
+    return s_sharedRenderTargetPool;
+}
+
+void RenderTargetPool::destroyInstance()
+{
+    CC_SAFE_DELETE(s_sharedRenderTargetPool);
+}
+
+RenderTargetPool::RenderTargetPool()
+: _size(0)
+, _maxSize(32 * 1024 * 1024)
+{
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+    // the pooled textures aren't restored with the GL context
+    _backgroundListener = Director::getInstance()->getEventDispatcher()->addCustomEventListener(EVENT_COME_TO_BACKGROUND, [this](EventCustom* /*event*/) {
+        purge();
+    });
+#endif
+}
+
+RenderTargetPool::~RenderTargetPool()
+{
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+    Director::getInstance()->getEventDispatcher()->removeEventListener(_backgroundListener);
+#endif
+    purge();
+}
+
+bool RenderTargetPool::acquire(int pixelsWide, int pixelsHigh, const Size& contentSizeInPixels, Texture2D::PixelFormat format,
+                               GLuint depthStencilFormat, bool withTextureCopy, Target* target)
+{
+    // the most recently recycled targets are at the end
+    for (auto it = _targets.rbegin(); it != _targets.rend(); ++it)
+    {
+        auto texture = it->texture;
+        if (texture->getPixelsWide() == pixelsWide && texture->getPixelsHigh() == pixelsHigh
+            && texture->getContentSizeInPixels().equals(contentSizeInPixels) && texture->getPixelFormat() == format
+            && it->depthStencilFormat == depthStencilFormat && (it->textureCopy != nullptr) == withTextureCopy)
+        {
+            *target = *it;
+            _size -= getTargetSize(*it);
+            _targets.erase(std::next(it).base());
+            return true;
+        }
+    }
+    return false;
+}
+
+Texture2D* RenderTargetPool::acquireTexture(int pixelsWide, int pixelsHigh, const Size& contentSizeInPixels, Texture2D::PixelFormat format)
+{
+    Target target;
+    if (!acquire(pixelsWide, pixelsHigh, contentSizeInPixels, format, 0, false, &target))
+    {
+        return nullptr;
+    }
+
+    if (target.fbo)
+    {
+        glDeleteFramebuffers(1, &target.fbo);
+    }
+    return target.texture;
+}
+
+void RenderTargetPool::recycle(const Target& target)
+{
+    CCASSERT(target.texture, "A render target needs a texture");
+
+    bool inUse = target.texture->getReferenceCount() > 1 || (target.textureCopy && target.textureCopy->getReferenceCount() > 1);
+    auto size = getTargetSize(target);
+    if (inUse || size > _maxSize)
+    {
+        destroyTarget(target);
+        return;
+    }
+
+    trim(_maxSize - size);
+    _targets.push_back(target);
+    _size += size;
+}
+
+void RenderTargetPool::recycleTexture(Texture2D* texture)
+{
+    Target target;
+    target.texture = texture;
+    recycle(target);
+}
+
+void RenderTargetPool::purge()
+{
+    trim(0);
+}
+
+void RenderTargetPool::setMaxSize(size_t maxSize)
+{
+    _maxSize = maxSize;
+    trim(_maxSize);
+}
+
+void RenderTargetPool::trim(size_t maxSize)
+{
+    while (_size > maxSize && !_targets.empty())
+    {
+        _size -= getTargetSize(_targets.front());
+        destroyTarget(_targets.front());
+        _targets.erase(_targets.begin());
+    }
+}
+
+size_t RenderTargetPool::getTargetSize(const Target& target)
+{
+    size_t pixels = (size_t)target.texture->getPixelsWide() * target.texture->getPixelsHigh();
+    size_t size = pixels * target.texture->getBitsPerPixelForFormat() / 8;
+    if (target.textureCopy)
+    {
+        size *= 2;
+    }
+    if (target.depthRenderBuffer)
+    {
+        size += pixels * 4;
+    }
+    if (target.stencilRenderBuffer)
+    {
+        size += pixels;
+    }
+    return size;
+}
+
+void RenderTargetPool::destroyTarget(const Target& target)
+{
+    if (target.fbo)
+    {
+        glDeleteFramebuffers(1, &target.fbo);
+    }
+    if (target.depthRenderBuffer)
+    {
+        glDeleteRenderbuffers(1, &target.depthRenderBuffer);
+    }
+    if (target.stencilRenderBuffer)
+    {
+        glDeleteRenderbuffers(1, &target.stencilRenderBuffer);
+    }
+    CC_SAFE_RELEASE(target.texture);
+    CC_SAFE_RELEASE(target.textureCopy);
+}
+
 NS_CC_END
@@ -35,6 +35,7 @@ THE SOFTWARE.
 NS_CC_BEGIN
 
 class EventCustom;
+class EventListenerCustom;
 
 /**
  * @addtogroup _2d
@@ -150,6 +151,16 @@ public:
     
     CC_DEPRECATED_ATTRIBUTE Image* newCCImage(bool flipImage = true) { return newImage(flipImage); };
 
+    /** Reads the texture's data like newImage, without stalling the GL pipeline: the pixels are fetched a frame or two later
+     * and flipped on a worker thread, see utils::readPixelsAsync.
+     *
+     * @param callback Invoked on the cocos thread with the image, or nullptr if it failed. The image is released after the callback returns.
+     * @param flipImage Whether or not to flip image.
+     * @since v3.14
+     * @js NA
+     */
+    void newImageAsync(const std::function<void(Image*)>& callback, bool flipImage = true);
+
     /** Saves the texture into a file using JPEG format. The file will be saved in the Documents folder.
      * Returns true if the operation is successful.
      *
@@ -321,6 +332,7 @@ protected:
     GLuint       _FBO;
     GLuint       _depthRenderBuffer;
     GLuint       _stencilRenderBuffer;
+    GLuint       _depthStencilFormat;
     GLint        _oldFBO;
     Texture2D* _texture;
     Texture2D* _textureCopy;    // a copy of _texture
@@ -362,6 +374,9 @@ protected:
     void onClearDepth();
 
     void onSaveToFile(const std::string& fileName, bool isRGBA = true);
+
+    // creates the textures, the FBO and the depth stencil buffers when the pool has none
+    bool initRenderTarget(int powW, int powH, int w, int h, GLuint depthStencilFormat);
     
     Mat4 _oldTransMatrix, _oldProjMatrix;
     Mat4 _transformMatrix, _projectionMatrix;
@@ -370,6 +385,90 @@ private:
 
 };
 
+/**
+ * @brief RenderTargetPool keeps the textures, frame buffers and depth stencil buffers of the destroyed render textures and grids,
+ * the next ones of the same size and formats reuse them instead of allocating new GL objects.
+ * RenderTexture and GridBase use it, so do the transitions and the grid actions built on them.
+ * A render target is only kept when nothing else retains its texture.
+ * @since v3.14
+ */
+class CC_DLL RenderTargetPool
+{
+public:
+    /** The GL objects of a render target, it owns a reference of its textures. */
+    struct Target
+    {
+        Target();
+
+        Texture2D* texture;
+        /** The second texture RenderTexture uses on Qualcomm GPUs, or nullptr. */
+        Texture2D* textureCopy;
+        GLuint fbo;
+        GLuint depthRenderBuffer;
+        GLuint stencilRenderBuffer;
+        GLuint depthStencilFormat;
+    };
+
+    /** Returns the shared render target pool. */
+    static RenderTargetPool* getInstance();
+
+    /** Purges the pool and destroys it. */
+    static void destroyInstance();
+
+    /** Takes a render target out of the pool. Its texture keeps the content of its previous use.
+     *
+     * @param pixelsWide, pixelsHigh The size of the texture in pixels.
+     * @param contentSizeInPixels The content size of the texture.
+     * @param format The pixel format of the texture.
+     * @param depthStencilFormat The format of the depth stencil buffer, 0 for none.
+     * @param withTextureCopy Whether or not the target has a textureCopy.
+     * @param target Filled with the render target, its frame buffer is 0 if it only had a texture.
+     * @return false if the pool has no such render target.
+     */
+    bool acquire(int pixelsWide, int pixelsHigh, const Size& contentSizeInPixels, Texture2D::PixelFormat format,
+                 GLuint depthStencilFormat, bool withTextureCopy, Target* target);
+
+    /** Takes a texture out of the pool, like acquire without frame buffer and depth stencil buffer.
+     * @return A texture the caller owns a reference of, or nullptr.
+     */
+    Texture2D* acquireTexture(int pixelsWide, int pixelsHigh, const Size& contentSizeInPixels, Texture2D::PixelFormat format);
+
+    /** Gives a render target back to the pool. It is destroyed when its textures are still retained by someone else.
+     * The render targets given back first are destroyed when the pool grows over its max size.
+     */
+    void recycle(const Target& target);
+
+    /** Gives a texture back to the pool, the caller's reference is taken over. */
+    void recycleTexture(Texture2D* texture);
+
+    /** Destroys all the render targets of the pool. */
+    void purge();
+
+    /** Sets the memory the pooled render targets can use, in bytes. The default is 32 MB. */
+    void setMaxSize(size_t maxSize);
+    /** Gets the memory the pooled render targets can use, in bytes. */
+    size_t getMaxSize() const { return _maxSize; }
+    /** Gets the memory used by the pooled render targets, in bytes. */
+    size_t getSize() const { return _size; }
+
+    /** Deletes the GL objects of a render target and releases its textures. */
+    static void destroyTarget(const Target& target);
+
+protected:
+    RenderTargetPool();
+    ~RenderTargetPool();
+
+    static size_t getTargetSize(const Target& target);
+    void trim(size_t maxSize);
+
+    std::vector<Target> _targets;
+    size_t _size;
+    size_t _maxSize;
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+    EventListenerCustom* _backgroundListener;
+#endif
+};
+
 // end of textures group
 /// @}
 
@@ -28,11 +28,14 @@ THE SOFTWARE.
 #include "2d/CCScene.h"
 #include "base/CCDirector.h"
 #include "2d/CCCamera.h"
+#include "2d/CCLight.h"
+#include "3d/CCSprite3D.h"
 #include "base/CCEventDispatcher.h"
 #include "base/CCEventListenerCustom.h"
 #include "base/ccUTF8.h"
 #include "renderer/CCRenderer.h"
 #include "renderer/CCFrameBuffer.h"
+#include "renderer/CCDynamicResolution.h"
 
 #if CC_USE_PHYSICS
 #include "physics/CCPhysicsWorld.h"
@@ -50,6 +53,8 @@ THE SOFTWARE.
 NS_CC_BEGIN
 
 Scene::Scene()
+: _lightGrid(new (std::nothrow) LightGrid())
+, _spatialIndex3D(nullptr)
 {
 #if CC_USE_3D_PHYSICS && CC_ENABLE_BULLET_INTEGRATION
     _physics3DWorld = nullptr;
@@ -88,6 +93,13 @@ Scene::~Scene()
 #endif
     Director::getInstance()->getEventDispatcher()->removeEventListener(_event);
     CC_SAFE_RELEASE(_event);
+    delete _lightGrid;
+
+    if (_spatialIndex3D)
+    {
+        _spatialIndex3D->clear();
+        delete _spatialIndex3D;
+    }
     
 #if CC_USE_PHYSICS
     delete _physicsWorld;
@@ -114,6 +126,34 @@ void Scene::setNavMesh(NavMesh* navMesh)
 }
 #endif
 
+static void addSprite3DsToIndex(Node* node, SpatialIndex3D* index)
+{
+    auto sprite = dynamic_cast<Sprite3D*>(node);
+    if (sprite)
+        index->add(sprite);
+    for (auto child : node->getChildren())
+        addSprite3DsToIndex(child, index);
+}
+
+void Scene::setSpatialIndex3DEnabled(bool enabled)
+{
+    if (enabled == (_spatialIndex3D != nullptr))
+        return;
+
+    if (enabled)
+    {
+        _spatialIndex3D = new (std::nothrow) SpatialIndex3D();
+        if (_running)
+            addSprite3DsToIndex(this, _spatialIndex3D);
+    }
+    else
+    {
+        _spatialIndex3D->clear();
+        delete _spatialIndex3D;
+        _spatialIndex3D = nullptr;
+    }
+}
+
 bool Scene::init()
 {
     auto size = Director::getInstance()->getWinSize();
@@ -192,9 +232,13 @@ void Scene::render(Renderer* renderer, const Mat4& eyeTransform, const Mat4* eye
 void Scene::render(Renderer* renderer, const Mat4* eyeTransforms, const Mat4* eyeProjections, unsigned int multiViewCount)
 {
     auto director = Director::getInstance();
+    auto dynamicResolution = director->getDynamicResolution();
     Camera* defaultCamera = nullptr;
     const auto& transform = getNodeToParentTransform();
 
+    // the lights moved by the update, the meshes look them up while visiting
+    _lightGrid->update(_lights);
+
     for (const auto& camera : getCameras())
     {
         if (!camera->isVisible())
@@ -223,8 +267,13 @@ void Scene::render(Renderer* renderer, const Mat4* eyeTransforms, const Mat4* ey
         }
 
         camera->apply();
+        // the world cameras may render at a lower resolution, then be stretched over their viewport
+        const bool scaled = dynamicResolution->beginCamera(camera);
         //clear background with max depth
         camera->clearBackground();
+        // cull the indexed sprites once, they only check their visibility when they draw
+        if (_spatialIndex3D)
+            _spatialIndex3D->cull(camera);
         //visit the scene
         visit(renderer, transform, 0);
 #if CC_USE_NAVMESH
@@ -235,6 +284,8 @@ void Scene::render(Renderer* renderer, const Mat4* eyeTransforms, const Mat4* ey
 #endif
 
         renderer->render();
+        if (scaled)
+            dynamicResolution->endCamera(camera);
         camera->restore();
 
         for (unsigned int i = 0; i < multiViewCount; ++i)
@@ -276,6 +327,74 @@ void Scene::render(Renderer* renderer, const Mat4* eyeTransforms, const Mat4* ey
 //    experimental::FrameBuffer::applyDefaultFBO();
 }
 
+void Scene::renderStereo(Renderer* renderer, const Mat4* eyeTransforms, const experimental::Viewport* eyeViewports, unsigned int eyeCount)
+{
+    CCASSERT(eyeCount > 0, "At least one eye is needed");
+
+    auto director = Director::getInstance();
+    const auto& transform = getNodeToParentTransform();
+    auto defaultViewport = Camera::getDefaultViewport();
+
+    _lightGrid->update(_lights);
+
+    // the middle of the eyes
+    Mat4 visitTransform = eyeTransforms[0];
+    for (int i = 12; i < 15; ++i)
+    {
+        float sum = 0;
+        for (unsigned int eye = 0; eye < eyeCount; ++eye)
+            sum += eyeTransforms[eye].m[i];
+        visitTransform.m[i] = sum / eyeCount;
+    }
+
+    for (const auto& camera : getCameras())
+    {
+        if (!camera->isVisible())
+            continue;
+
+        Camera::_visitingCamera = camera;
+
+        camera->setAdditionalTransform(visitTransform.getInversed());
+        director->pushProjectionMatrix(0);
+        director->loadProjectionMatrix(Camera::_visitingCamera->getViewProjectionMatrix(), 0);
+        Camera::setDefaultViewport(eyeViewports[0]);
+
+        // cull the indexed sprites once, they only check their visibility when they draw
+        if (_spatialIndex3D)
+            _spatialIndex3D->cull(camera);
+        //visit the scene
+        visit(renderer, transform, 0);
+#if CC_USE_NAVMESH
+        if (_navMesh && _navMeshDebugCamera == camera)
+        {
+            _navMesh->debugDraw(renderer);
+        }
+#endif
+
+        // the commands read the projection matrix when they are executed
+        for (unsigned int eye = 0; eye < eyeCount; ++eye)
+        {
+            camera->setAdditionalTransform(eyeTransforms[eye].getInversed());
+            director->loadProjectionMatrix(Camera::_visitingCamera->getViewProjectionMatrix(), 0);
+            Camera::setDefaultViewport(eyeViewports[eye]);
+
+            camera->apply();
+            //clear background with max depth
+            camera->clearBackground();
+            if (eye + 1 < eyeCount)
+                renderer->renderAndKeepCommands();
+            else
+                renderer->render();
+            camera->restore();
+        }
+
+        director->popProjectionMatrix(0);
+    }
+
+    Camera::setDefaultViewport(defaultViewport);
+    Camera::_visitingCamera = nullptr;
+}
+
 void Scene::removeAllChildren()
 {
     if (_defaultCamera)
@@ -38,6 +38,12 @@ class BaseLight;
 class Renderer;
 class EventListenerCustom;
 class EventCustom;
+class SpatialIndex3D;
+class LightGrid;
+namespace experimental
+{
+    struct Viewport;
+}
 #if CC_USE_PHYSICS
 class PhysicsWorld;
 #endif
@@ -105,6 +111,13 @@ public:
      */
     const std::vector<BaseLight*>& getLights() const { return _lights; }
 
+    /** Returns the lights sorted by position, updated before visiting the cameras, so each mesh is only lit by
+     * the point and spot lights reaching it.
+     * @since v3.14
+     * @js NA
+     */
+    const LightGrid* getLightGrid() const { return _lightGrid; }
+
     /** Render the scene.
      * @param renderer The renderer use to render the scene.
      * @param eyeTransform The AdditionalTransform of camera.
@@ -122,8 +135,32 @@ public:
      */
     virtual void render(Renderer* renderer, const Mat4* eyeTransforms, const Mat4* eyeProjections, unsigned int multiViewCount);
 
+    /** Renders the scene for each eye of a stereo rendering, visiting it once by camera.
+     * The render commands of a camera are executed once for each eye, with the view projection matrix and the default
+     * viewport of the eye. The scene is visited from the middle of the eyes, for the culling and the sorting.
+     * @param renderer The renderer use to render the scene.
+     * @param eyeTransforms The AdditionalTransform of camera for each eye, they can only differ by their translation.
+     * @param eyeViewports The default viewport of each eye.
+     * @param eyeCount The number of eyes.
+     * @since v3.14
+     * @js NA
+     */
+    virtual void renderStereo(Renderer* renderer, const Mat4* eyeTransforms, const experimental::Viewport* eyeViewports, unsigned int eyeCount);
+
     /** override function */
     virtual void removeAllChildren() override;
+
+    /** Enables a bounding volume hierarchy of the Sprite3Ds of the scene, culled once per camera
+     * instead of testing each sprite against the frustum, and used to pick and query them.
+     * Only worth it in scenes with many static Sprite3Ds, sprites moving in a frame are still tested one by one.
+     * @since v3.14
+     */
+    void setSpatialIndex3DEnabled(bool enabled);
+
+    /** Returns the index of the Sprite3Ds, nullptr if it isn't enabled.
+     * @since v3.14
+     */
+    SpatialIndex3D* getSpatialIndex3D() const { return _spatialIndex3D; }
     
 CC_CONSTRUCTOR_ACCESS:
     Scene();
@@ -150,6 +187,8 @@ protected:
     EventListenerCustom*       _event;
 
     std::vector<BaseLight *> _lights;
+    LightGrid*               _lightGrid;
+    SpatialIndex3D*          _spatialIndex3D;
     
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(Scene);
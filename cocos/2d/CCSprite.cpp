@@ -40,8 +40,14 @@ THE SOFTWARE.
 #include "base/ccUTF8.h"
 #include "2d/CCCamera.h"
 
+#if CC_ENABLE_ALLOCATOR && CC_ENABLE_ENGINE_ALLOCATOR_POOLS
+#include "base/allocator/CCAllocatorStrategyPool.h"
+#endif
+
 NS_CC_BEGIN
 
+CC_DEFINE_ALLOCATOR_POOL(Sprite, 256)
+
 // MARK: create, init, dealloc
 Sprite* Sprite::createWithTexture(Texture2D *texture)
 {
@@ -175,6 +181,13 @@ bool Sprite::initWithFile(const std::string& filename)
     _fileName = filename;
     _fileType = 0;
 
+    // small images share the pages of the dynamic atlas, so that their sprites batch
+    SpriteFrame* spriteFrame = SpriteFrameCache::getInstance()->getDynamicAtlasFrame(filename);
+    if (spriteFrame)
+    {
+        return initWithSpriteFrame(spriteFrame);
+    }
+
     Texture2D *texture = _director->getTextureCache()->addImage(filename);
     if (texture)
     {
@@ -319,6 +332,7 @@ Sprite::Sprite(void)
 , _stretchFactor(Vec2::ONE)
 , _originalContentSize(Size::ZERO)
 , _stretchEnabled(true)
+, _drawnQueueGeneration(0)
 {
 #if CC_SPRITE_DEBUG_DRAW
     _debugDrawNode = DrawNode::create();
@@ -329,7 +343,6 @@ Sprite::Sprite(void)
 Sprite::~Sprite()
 {
     CC_SAFE_FREE(_trianglesVertex);
-    CC_SAFE_FREE(_trianglesIndex);
     CC_SAFE_RELEASE(_spriteFrame);
     CC_SAFE_RELEASE(_texture);
 }
@@ -429,7 +442,34 @@ void Sprite::setTextureRect(const Rect& rect, bool rotated, const Size& untrimme
     updatePoly();
 }
 
-void Sprite::updatePoly()
+namespace {
+    // Every 9-sliced sprite is made of the same triangles, so they share one index buffer
+    struct Slice9Indices
+    {
+        unsigned short indices[6 * 9];
+
+        Slice9Indices()
+        {
+            // populate indices in CCW direction
+            for (int i=0; i<9; ++i) {
+                indices[i * 6 + 0] = (i * 4 / 3) + 4;
+                indices[i * 6 + 1] = (i * 4 / 3) + 0;
+                indices[i * 6 + 2] = (i * 4 / 3) + 5;
+                indices[i * 6 + 3] = (i * 4 / 3) + 1;
+                indices[i * 6 + 4] = (i * 4 / 3) + 5;
+                indices[i * 6 + 5] = (i * 4 / 3) + 0;
+            }
+        }
+    };
+
+    unsigned short* getSlice9Indices()
+    {
+        static Slice9Indices slice9Indices;
+        return slice9Indices.indices;
+    }
+}
+
+void Sprite::updatePoly(bool texCoordsDirty)
 {
     // There are 3 cases:
     //
@@ -652,10 +692,12 @@ void Sprite::updatePoly()
         // needed in order to get color from "_quad"
         V3F_C4B_T2F_Quad tmpQuad = _quad;
 
+        // a resize keeps the texture coordinates and colors in place, only the positions move
         for (int i=0; i<9; ++i) {
-            setTextureCoords(texRects[i], &tmpQuad);
+            if (texCoordsDirty)
+                setTextureCoords(texRects[i], &tmpQuad);
             setVertexCoords(verticesRects[i], &tmpQuad);
-            populateTriangle(i, tmpQuad);
+            populateTriangle(i, tmpQuad, !texCoordsDirty);
         }
         TrianglesCommand::Triangles triangles;
         triangles.verts = _trianglesVertex;
@@ -687,7 +729,6 @@ void Sprite::setCenterRectNormalized(const cocos2d::Rect &rectTopLeft)
         if (rect.equals(Rect(0,0,1,1))) {
             _renderMode = RenderMode::QUAD;
             free(_trianglesVertex);
-            free(_trianglesIndex);
             _trianglesVertex = nullptr;
             _trianglesIndex = nullptr;
         }
@@ -699,17 +740,7 @@ void Sprite::setCenterRectNormalized(const cocos2d::Rect &rectTopLeft)
                 // 9 quads + 7 exterior points = 16
                 _trianglesVertex = (V3F_C4B_T2F*) malloc(sizeof(*_trianglesVertex) * (9 + 3 + 4));
                 // 9 quads, each needs 6 vertices = 54
-                _trianglesIndex = (unsigned short*) malloc(sizeof(*_trianglesIndex) * 6 * 9);
-
-                // populate indices in CCW direction
-                for (int i=0; i<9; ++i) {
-                    _trianglesIndex[i * 6 + 0] = (i * 4 / 3) + 4;
-                    _trianglesIndex[i * 6 + 1] = (i * 4 / 3) + 0;
-                    _trianglesIndex[i * 6 + 2] = (i * 4 / 3) + 5;
-                    _trianglesIndex[i * 6 + 3] = (i * 4 / 3) + 1;
-                    _trianglesIndex[i * 6 + 4] = (i * 4 / 3) + 5;
-                    _trianglesIndex[i * 6 + 5] = (i * 4 / 3) + 0;
-                }
+                _trianglesIndex = getSlice9Indices();
             }
         }
 
@@ -894,7 +925,7 @@ void Sprite::setVertexCoords(const Rect& rect, V3F_C4B_T2F_Quad* outQuad)
     }
 }
 
-void Sprite::populateTriangle(int quadIndex, const V3F_C4B_T2F_Quad& quad)
+void Sprite::populateTriangle(int quadIndex, const V3F_C4B_T2F_Quad& quad, bool positionsOnly)
 {
     CCASSERT(quadIndex < 9, "Invalid quadIndex");
     // convert Quad intro Triangle since it takes less memory
@@ -942,10 +973,20 @@ void Sprite::populateTriangle(int quadIndex, const V3F_C4B_T2F_Quad& quad)
         const int index_tr = index_bl + 5;
         
 
-        _trianglesVertex[index_tr] = quad.tr;
-        _trianglesVertex[index_br] = quad.br;
-        _trianglesVertex[index_tl] = quad.tl;
-        _trianglesVertex[index_bl] = quad.bl;
+        if (positionsOnly)
+        {
+            _trianglesVertex[index_tr].vertices = quad.tr.vertices;
+            _trianglesVertex[index_br].vertices = quad.br.vertices;
+            _trianglesVertex[index_tl].vertices = quad.tl.vertices;
+            _trianglesVertex[index_bl].vertices = quad.bl.vertices;
+        }
+        else
+        {
+            _trianglesVertex[index_tr] = quad.tr;
+            _trianglesVertex[index_br] = quad.br;
+            _trianglesVertex[index_tl] = quad.tl;
+            _trianglesVertex[index_bl] = quad.bl;
+        }
     }
 }
 
@@ -1056,7 +1097,7 @@ void Sprite::draw(Renderer *renderer, const Mat4 &transform, uint32_t flags)
     // Don't calculate the culling if the transform was not updated
     auto visitingCamera = Camera::getVisitingCamera();
     auto defaultCamera = Camera::getDefaultCamera();
-    if (visitingCamera == nullptr) {
+    if (visitingCamera == nullptr || !renderer->isCullingEnabled()) {
         _insideBounds = true;
     }
     else if (visitingCamera == defaultCamera) {
@@ -1071,7 +1112,13 @@ void Sprite::draw(Renderer *renderer, const Mat4 &transform, uint32_t flags)
     if(_insideBounds)
 #endif
     {
-        _trianglesCommand.init(_globalZOrder,
+        // _trianglesCommand is still queued when the sprite is drawn twice in a frame
+        auto trianglesCommand = &_trianglesCommand;
+        if (_drawnQueueGeneration == renderer->getQueueGeneration())
+            trianglesCommand = renderer->generateTransientTrianglesCommand();
+        _drawnQueueGeneration = renderer->getQueueGeneration();
+
+        trianglesCommand->init(_globalZOrder,
                                _texture,
                                getGLProgramState(),
                                _blendFunc,
@@ -1079,7 +1126,7 @@ void Sprite::draw(Renderer *renderer, const Mat4 &transform, uint32_t flags)
                                transform,
                                flags);
 
-        renderer->addCommand(&_trianglesCommand);
+        renderer->addCommand(trianglesCommand);
 
 #if CC_SPRITE_DEBUG_DRAW
         _debugDrawNode->clear();
@@ -1354,10 +1401,14 @@ void Sprite::setContentSize(const Size& size)
     if (_renderMode == RenderMode::QUAD_BATCHNODE || _renderMode == RenderMode::POLYGON)
         CCLOGWARN("Sprite::setContentSize() doesn't stretch the sprite when using QUAD_BATCHNODE or POLYGON render modes");
 
+    // the geometry only depends on the size here, the other setters update it themselves
+    if (size.equals(_contentSize))
+        return;
+
     Node::setContentSize(size);
 
     updateStretchFactor();
-    updatePoly();
+    updatePoly(false);
 }
 
 void Sprite::setStretchEnabled(bool enabled)
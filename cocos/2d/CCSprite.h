@@ -95,6 +95,8 @@ struct transformValues_;
 class CC_DLL Sprite : public Node, public TextureProtocol
 {
 public:
+    CC_DECLARE_ALLOCATOR_POOL(Sprite)
+
     enum class RenderMode {
         QUAD,
         POLYGON,
@@ -653,12 +655,14 @@ protected:
     virtual void setTextureCoords(const Rect& rect);
     virtual void setTextureCoords(const Rect& rect, V3F_C4B_T2F_Quad* outQuad);
     virtual void setVertexCoords(const Rect& rect, V3F_C4B_T2F_Quad* outQuad);
-    void populateTriangle(int quadIndex, const V3F_C4B_T2F_Quad& quad);
+    /** Copies the corners of a slice: the whole vertices, or only their positions when positionsOnly is true. */
+    void populateTriangle(int quadIndex, const V3F_C4B_T2F_Quad& quad, bool positionsOnly = false);
     virtual void updateBlendFunc();
     virtual void setReorderChildDirtyRecursively();
     virtual void setDirtyRecursively(bool value);
 
-    void updatePoly();
+    /** Recomputes the geometry. When texCoordsDirty is false a sliced sprite only moves its vertices. */
+    void updatePoly(bool texCoordsDirty = true);
     void updateStretchFactor();
 
     virtual void flipX();
@@ -723,6 +727,7 @@ protected:
     int _fileType;
 
     bool _stretchEnabled;
+    unsigned int _drawnQueueGeneration; /// Renderer::getQueueGeneration() when _trianglesCommand was added
 
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(Sprite);
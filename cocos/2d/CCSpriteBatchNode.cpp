@@ -125,6 +125,7 @@ bool SpriteBatchNode::initWithFile(const std::string& fileImage, ssize_t capacit
 
 SpriteBatchNode::SpriteBatchNode()
 : _textureAtlas(nullptr)
+, _freeSlotsEnabled(false)
 {
 }
 
@@ -182,9 +183,17 @@ void SpriteBatchNode::addChild(Node *child, int zOrder, int tag)
     // check Sprite is using the same texture id
     CCASSERT(sprite->getTexture()->getName() == _textureAtlas->getTexture()->getName(), "CCSprite is not using the same texture id");
 
+    bool sortedLast = isAppendedInOrder(sprite, zOrder);
+
     Node::addChild(child, zOrder, tag);
 
     appendChild(sprite);
+
+    // its quad is already where the reordering would put it
+    if (sortedLast)
+    {
+        _reorderChildDirty = false;
+    }
 }
 
 void SpriteBatchNode::addChild(Node * child, int zOrder, const std::string &name)
@@ -195,9 +204,24 @@ void SpriteBatchNode::addChild(Node * child, int zOrder, const std::string &name
     // check Sprite is using the same texture id
     CCASSERT(sprite->getTexture()->getName() == _textureAtlas->getTexture()->getName(), "CCSprite is not using the same texture id");
     
+    bool sortedLast = isAppendedInOrder(sprite, zOrder);
+
     Node::addChild(child, zOrder, name);
     
     appendChild(sprite);
+
+    // its quad is already where the reordering would put it
+    if (sortedLast)
+    {
+        _reorderChildDirty = false;
+    }
+}
+
+bool SpriteBatchNode::isAppendedInOrder(Sprite* sprite, int zOrder) const
+{
+    // the children are sorted, and a sprite without children which isn't below the last one is drawn last
+    return !_reorderChildDirty && sprite->getChildren().empty()
+        && (_children.empty() || zOrder >= _children.back()->getLocalZOrder());
 }
 
 // override reorderChild
@@ -349,8 +373,7 @@ void SpriteBatchNode::swap(ssize_t oldIndex, ssize_t newIndex)
 {
     CCASSERT(oldIndex>=0 && oldIndex < (int)_descendants.size() && newIndex >=0 && newIndex < (int)_descendants.size(), "Invalid index");
 
-    V3F_C4B_T2F_Quad* quads = _textureAtlas->getQuads();
-    std::swap( quads[oldIndex], quads[newIndex] );
+    _textureAtlas->swapQuads(oldIndex, newIndex);
 
     //update the index of other swapped item
 
@@ -575,8 +598,39 @@ void SpriteBatchNode::appendChild(Sprite* sprite)
 
 void SpriteBatchNode::removeSpriteFromAtlas(Sprite *sprite)
 {
+    auto index = sprite->getAtlasIndex();
+    if (_freeSlotsEnabled && index >= 0 && index < (ssize_t)_descendants.size() && _descendants[index] == sprite)
+    {
+        // fill the slot with the last quad, the other quads don't move
+        auto last = (ssize_t)_descendants.size() - 1;
+        if (index != last)
+        {
+            Sprite* moved = _descendants[last];
+            _textureAtlas->swapQuads(index, last);
+            moved->setAtlasIndex(index);
+            _descendants[index] = moved;
+
+            // its children with a negative z order must stay before it
+            if (moved->getParent() != sprite->getParent() || moved->getLocalZOrder() != sprite->getLocalZOrder()
+                || !moved->getChildren().empty())
+            {
+                _reorderChildDirty = true;
+            }
+        }
+        _textureAtlas->removeQuadAtIndex(last);
+        _descendants.pop_back();
+
+        sprite->setBatchNode(nullptr);
+
+        auto& children = sprite->getChildren();
+        for (const auto &obj : children) {
+            removeSpriteFromAtlas(static_cast<Sprite*>(obj));
+        }
+        return;
+    }
+
     // remove from TextureAtlas
-    _textureAtlas->removeQuadAtIndex(sprite->getAtlasIndex());
+    _textureAtlas->removeQuadAtIndex(index);
 
     // Cleanup sprite. It might be reused (issue #569)
     sprite->setBatchNode(nullptr);
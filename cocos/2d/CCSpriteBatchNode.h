@@ -226,6 +226,20 @@ public:
      If the current capacity is bigger, nothing happens.
      otherwise, a new capacity is allocated */
     void reserveCapacity(ssize_t newCapacity);
+
+    /** Enables the free slot mode.
+     When a sprite is removed, its slot in the texture atlas is filled with the last quad instead of
+     shifting all the following quads. The batch is only reordered when the moved sprite doesn't have the
+     same parent and z order as the removed one, so the draw order of sprites that share a z order isn't kept.
+     Use it for large batches whose sprites don't overlap, or whose overlapping order doesn't matter.
+     Disabled by default.
+     @since v3.14
+     */
+    void setFreeSlotsEnabled(bool enabled) { _freeSlotsEnabled = enabled; }
+    /** Whether or not the free slot mode is enabled.
+     @since v3.14
+     */
+    bool isFreeSlotsEnabled() const { return _freeSlotsEnabled; }
 CC_CONSTRUCTOR_ACCESS:
     /**
      * @js ctor
@@ -259,6 +273,7 @@ protected:
 
     void updateAtlasIndex(Sprite* sprite, ssize_t* curIndex);
     void swap(ssize_t oldIndex, ssize_t newIndex);
+    bool isAppendedInOrder(Sprite* sprite, int zOrder) const;
     void updateBlendFunc();
 
     TextureAtlas *_textureAtlas;
@@ -269,6 +284,8 @@ protected:
     // There is not need to retain/release these objects, since they are already retained by _children
     // So, using std::vector<Sprite*> is slightly faster than using cocos2d::Array for this particular case
     std::vector<Sprite*> _descendants;
+
+    bool _freeSlotsEnabled;
 };
 
 // end of sprite_nodes group
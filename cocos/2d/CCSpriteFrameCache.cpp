@@ -30,6 +30,8 @@ THE SOFTWARE.
 #include "2d/CCSpriteFrameCache.h"
 
 #include <vector>
+#include <memory>
+#include <string.h>
 
 
 #include "2d/CCSprite.h"
@@ -39,6 +41,10 @@ THE SOFTWARE.
 #include "base/ccMacros.h"
 #include "base/ccUTF8.h"
 #include "base/CCDirector.h"
+#include "base/CCConfiguration.h"
+#include "base/CCAsyncTaskPool.h"
+#include "platform/CCImage.h"
+#include "platform/CCGL.h"
 #include "renderer/CCTexture2D.h"
 #include "renderer/CCTextureCache.h"
 #include "base/CCNinePatchImageParser.h"
@@ -49,6 +55,207 @@ NS_CC_BEGIN
 
 static SpriteFrameCache *_sharedSpriteFrameCache = nullptr;
 
+// Implement the binary sprite frames format
+namespace
+{
+    const uint32_t BINARY_SPRITE_FRAMES_VERSION = 1;
+
+    enum BinarySpriteFrameFlags
+    {
+        BINARY_FRAME_ROTATED = 1 << 0,
+        BINARY_FRAME_ANCHOR  = 1 << 1,
+        BINARY_FRAME_POLYGON = 1 << 2
+    };
+
+    // The file is made of the header, the frames, the aliases, the polygon data and the strings,
+    // all little endian. Names are offsets into the strings, polygon offsets index the polygon data.
+    struct BinarySpriteFramesHeader
+    {
+        char magic[4];
+        uint32_t version;
+        uint32_t frameCount;
+        uint32_t aliasCount;
+        uint32_t polygonDataCount;
+        uint32_t stringDataSize;
+        uint32_t textureNameOffset;
+        uint32_t textureNameLength;
+        uint32_t pixelFormatOffset;
+        uint32_t pixelFormatLength;
+        float textureWidth;
+        float textureHeight;
+    };
+
+    struct BinarySpriteFrame
+    {
+        uint32_t nameOffset;
+        uint32_t nameLength;
+        float x;
+        float y;
+        float width;
+        float height;
+        float offsetX;
+        float offsetY;
+        float sourceWidth;
+        float sourceHeight;
+        float anchorX;
+        float anchorY;
+        uint32_t flags;
+        // the vertices and the uv coordinates have vertexCount values each, followed by the indices
+        uint32_t polygonOffset;
+        uint32_t vertexCount;
+        uint32_t indexCount;
+    };
+
+    struct BinarySpriteFrameAlias
+    {
+        uint32_t nameOffset;
+        uint32_t nameLength;
+        uint32_t frameIndex;
+    };
+
+    struct BinarySpriteFramesView
+    {
+        const BinarySpriteFramesHeader* header;
+        const BinarySpriteFrame* frames;
+        const BinarySpriteFrameAlias* aliases;
+        const int32_t* polygonData;
+        const char* strings;
+    };
+
+    bool isBinarySpriteFrames(const Data& data)
+    {
+        return data.getSize() >= (ssize_t)sizeof(BinarySpriteFramesHeader) && memcmp(data.getBytes(), "CCSF", 4) == 0;
+    }
+
+    // the data must have been validated
+    BinarySpriteFramesView getBinarySpriteFramesView(const Data& data)
+    {
+        BinarySpriteFramesView view;
+        const unsigned char* bytes = data.getBytes();
+        view.header = reinterpret_cast<const BinarySpriteFramesHeader*>(bytes);
+        view.frames = reinterpret_cast<const BinarySpriteFrame*>(view.header + 1);
+        view.aliases = reinterpret_cast<const BinarySpriteFrameAlias*>(view.frames + view.header->frameCount);
+        view.polygonData = reinterpret_cast<const int32_t*>(view.aliases + view.header->aliasCount);
+        view.strings = reinterpret_cast<const char*>(view.polygonData + view.header->polygonDataCount);
+        return view;
+    }
+
+    bool validateBinarySpriteFrames(const Data& data)
+    {
+        if (!isBinarySpriteFrames(data))
+            return false;
+
+        const BinarySpriteFramesHeader* header = reinterpret_cast<const BinarySpriteFramesHeader*>(data.getBytes());
+        if (header->version != BINARY_SPRITE_FRAMES_VERSION)
+            return false;
+
+        uint64_t size = sizeof(BinarySpriteFramesHeader)
+            + (uint64_t)header->frameCount * sizeof(BinarySpriteFrame)
+            + (uint64_t)header->aliasCount * sizeof(BinarySpriteFrameAlias)
+            + (uint64_t)header->polygonDataCount * sizeof(int32_t)
+            + header->stringDataSize;
+        if (size != (uint64_t)data.getSize())
+            return false;
+
+        auto isValidString = [header](uint32_t offset, uint32_t length) {
+            return (uint64_t)offset + length <= header->stringDataSize;
+        };
+        if (!isValidString(header->textureNameOffset, header->textureNameLength)
+            || !isValidString(header->pixelFormatOffset, header->pixelFormatLength))
+            return false;
+
+        BinarySpriteFramesView view = getBinarySpriteFramesView(data);
+        for (uint32_t i = 0; i < header->frameCount; ++i)
+        {
+            const BinarySpriteFrame& frame = view.frames[i];
+            if (!isValidString(frame.nameOffset, frame.nameLength))
+                return false;
+            if ((frame.flags & BINARY_FRAME_POLYGON)
+                && (frame.vertexCount % 2 != 0
+                    || (uint64_t)frame.polygonOffset + 2 * (uint64_t)frame.vertexCount + frame.indexCount > header->polygonDataCount))
+                return false;
+        }
+        for (uint32_t i = 0; i < header->aliasCount; ++i)
+        {
+            const BinarySpriteFrameAlias& alias = view.aliases[i];
+            if (!isValidString(alias.nameOffset, alias.nameLength) || alias.frameIndex >= header->frameCount)
+                return false;
+        }
+        return true;
+    }
+
+    std::string getBinaryString(const BinarySpriteFramesView& view, uint32_t offset, uint32_t length)
+    {
+        return std::string(view.strings + offset, length);
+    }
+
+    // Returns true when the file is a binary sprite frames file, which is then in data, else the plist is in dictionary.
+    bool readSpriteFramesFile(const std::string& fullPath, Data& data, ValueMap& dictionary)
+    {
+        Data fileData = FileUtils::getInstance()->getDataFromFile(fullPath);
+        if (isBinarySpriteFrames(fileData))
+        {
+            data = std::move(fileData);
+            return true;
+        }
+        if (!fileData.isNull())
+        {
+            dictionary = FileUtils::getInstance()->getValueMapFromData(reinterpret_cast<const char*>(fileData.getBytes()), static_cast<int>(fileData.getSize()));
+        }
+        return false;
+    }
+
+    // Returns the metadata of a binary sprite frames file, as they are in a plist.
+    ValueMap getBinarySpriteFramesMetadata(const Data& data)
+    {
+        ValueMap metadata;
+        if (validateBinarySpriteFrames(data))
+        {
+            BinarySpriteFramesView view = getBinarySpriteFramesView(data);
+            metadata["textureFileName"] = getBinaryString(view, view.header->textureNameOffset, view.header->textureNameLength);
+            metadata["pixelFormat"] = getBinaryString(view, view.header->pixelFormatOffset, view.header->pixelFormatLength);
+        }
+
+        ValueMap dictionary;
+        dictionary["metadata"] = metadata;
+        return dictionary;
+    }
+
+    Texture2D* addImageWithPixelFormat(const std::string& texturePath, const std::string& pixelFormatName)
+    {
+        static std::unordered_map<std::string, Texture2D::PixelFormat> pixelFormats = {
+            {"RGBA8888", Texture2D::PixelFormat::RGBA8888},
+            {"RGBA4444", Texture2D::PixelFormat::RGBA4444},
+            {"RGB5A1", Texture2D::PixelFormat::RGB5A1},
+            {"RGBA5551", Texture2D::PixelFormat::RGB5A1},
+            {"RGB565", Texture2D::PixelFormat::RGB565},
+            {"A8", Texture2D::PixelFormat::A8},
+            {"ALPHA", Texture2D::PixelFormat::A8},
+            {"I8", Texture2D::PixelFormat::I8},
+            {"AI88", Texture2D::PixelFormat::AI88},
+            {"ALPHA_INTENSITY", Texture2D::PixelFormat::AI88},
+            //{"BGRA8888", Texture2D::PixelFormat::BGRA8888}, no Image conversion RGBA -> BGRA
+            {"RGB888", Texture2D::PixelFormat::RGB888}
+        };
+
+        Texture2D *texture = nullptr;
+        auto pixelFormatIt = pixelFormats.find(pixelFormatName);
+        if (pixelFormatIt != pixelFormats.end())
+        {
+            const Texture2D::PixelFormat pixelFormat = (*pixelFormatIt).second;
+            const Texture2D::PixelFormat currentPixelFormat = Texture2D::getDefaultAlphaPixelFormat();
+            Texture2D::setDefaultAlphaPixelFormat(pixelFormat);
+            texture = Director::getInstance()->getTextureCache()->addImage(texturePath);
+            Texture2D::setDefaultAlphaPixelFormat(currentPixelFormat);
+        }
+        else
+        {
+            texture = Director::getInstance()->getTextureCache()->addImage(texturePath);
+        }
+        return texture;
+    }
+}
+
 SpriteFrameCache* SpriteFrameCache::getInstance()
 {
     if (! _sharedSpriteFrameCache)
@@ -76,6 +283,7 @@ bool SpriteFrameCache::init()
 SpriteFrameCache::~SpriteFrameCache()
 {
     CC_SAFE_DELETE(_loadedFileNames);
+    removeDynamicAtlas();
 }
 
 void SpriteFrameCache::parseIntegerList(const std::string &string, std::vector<int> &res)
@@ -151,6 +359,16 @@ void SpriteFrameCache::addSpriteFramesWithDictionary(ValueMap& dictionary, Textu
     if (dictionary["frames"].getType() != cocos2d::Value::Type::MAP)
         return;
 
+    if (_lazyFrameCreationEnabled)
+    {
+        Data data;
+        if (encodeBinarySpriteFrames(dictionary, data))
+        {
+            addSpriteFramesWithBinaryData(data, texture);
+        }
+        return;
+    }
+
     ValueMap& framesDict = dictionary["frames"].asValueMap();
     int format = 0;
 
@@ -308,36 +526,7 @@ void SpriteFrameCache::addSpriteFramesWithDictionary(ValueMap& dict, const std::
         }
     }
     
-    Texture2D *texture = nullptr;
-    static std::unordered_map<std::string, Texture2D::PixelFormat> pixelFormats = {
-        {"RGBA8888", Texture2D::PixelFormat::RGBA8888},
-        {"RGBA4444", Texture2D::PixelFormat::RGBA4444},
-        {"RGB5A1", Texture2D::PixelFormat::RGB5A1},
-        {"RGBA5551", Texture2D::PixelFormat::RGB5A1},
-        {"RGB565", Texture2D::PixelFormat::RGB565},
-        {"A8", Texture2D::PixelFormat::A8},
-        {"ALPHA", Texture2D::PixelFormat::A8},
-        {"I8", Texture2D::PixelFormat::I8},
-        {"AI88", Texture2D::PixelFormat::AI88},
-        {"ALPHA_INTENSITY", Texture2D::PixelFormat::AI88},
-        //{"BGRA8888", Texture2D::PixelFormat::BGRA8888}, no Image conversion RGBA -> BGRA
-        {"RGB888", Texture2D::PixelFormat::RGB888}
-    };
-
-    auto pixelFormatIt = pixelFormats.find(pixelFormatName);
-    if (pixelFormatIt != pixelFormats.end())
-    {
-        const Texture2D::PixelFormat pixelFormat = (*pixelFormatIt).second;
-        const Texture2D::PixelFormat currentPixelFormat = Texture2D::getDefaultAlphaPixelFormat();
-        Texture2D::setDefaultAlphaPixelFormat(pixelFormat);
-        texture = Director::getInstance()->getTextureCache()->addImage(texturePath);
-        Texture2D::setDefaultAlphaPixelFormat(currentPixelFormat);
-    }
-    else
-    {
-        texture = Director::getInstance()->getTextureCache()->addImage(texturePath);
-    }
-    
+    Texture2D *texture = addImageWithPixelFormat(texturePath, pixelFormatName);
     if (texture)
     {
         addSpriteFramesWithDictionary(dict, texture);
@@ -356,9 +545,16 @@ void SpriteFrameCache::addSpriteFramesWithFile(const std::string& plist, Texture
     }
     
     std::string fullPath = FileUtils::getInstance()->fullPathForFilename(plist);
-    ValueMap dict = FileUtils::getInstance()->getValueMapFromFile(fullPath);
-
-    addSpriteFramesWithDictionary(dict, texture);
+    Data data;
+    ValueMap dict;
+    if (readSpriteFramesFile(fullPath, data, dict))
+    {
+        addSpriteFramesWithBinaryData(data, texture);
+    }
+    else
+    {
+        addSpriteFramesWithDictionary(dict, texture);
+    }
     _loadedFileNames->insert(plist);
 }
 
@@ -377,8 +573,21 @@ void SpriteFrameCache::addSpriteFramesWithFile(const std::string& plist, const s
     }
     
     const std::string fullPath = FileUtils::getInstance()->fullPathForFilename(plist);
-    ValueMap dict = FileUtils::getInstance()->getValueMapFromFile(fullPath);
-    addSpriteFramesWithDictionary(dict, textureFileName);
+    Data data;
+    ValueMap dict;
+    if (readSpriteFramesFile(fullPath, data, dict))
+    {
+        ValueMap metadata = getBinarySpriteFramesMetadata(data);
+        Texture2D* texture = addImageWithPixelFormat(textureFileName, metadata["metadata"].asValueMap()["pixelFormat"].asString());
+        if (texture)
+            addSpriteFramesWithBinaryData(data, texture);
+        else
+            CCLOG("cocos2d: SpriteFrameCache: Couldn't load texture");
+    }
+    else
+    {
+        addSpriteFramesWithDictionary(dict, textureFileName);
+    }
     _loadedFileNames->insert(plist);
 }
 
@@ -396,39 +605,114 @@ void SpriteFrameCache::addSpriteFramesWithFile(const std::string& plist)
 
     if (_loadedFileNames->find(plist) == _loadedFileNames->end())
     {
-        ValueMap dict = FileUtils::getInstance()->getValueMapFromFile(fullPath);
+        Data data;
+        ValueMap dict;
+        if (readSpriteFramesFile(fullPath, data, dict))
+        {
+            ValueMap metadata = getBinarySpriteFramesMetadata(data);
+            Texture2D* texture = addImageWithPixelFormat(getTexturePathForPlist(metadata, plist), metadata["metadata"].asValueMap()["pixelFormat"].asString());
+            if (texture)
+                addSpriteFramesWithBinaryData(data, texture);
+            else
+                CCLOG("cocos2d: SpriteFrameCache: Couldn't load texture");
+        }
+        else
+        {
+            addSpriteFramesWithDictionary(dict, getTexturePathForPlist(dict, plist));
+        }
+        _loadedFileNames->insert(plist);
+    }
+}
+
+std::string SpriteFrameCache::getTexturePathForPlist(ValueMap& dict, const std::string& plist)
+{
+    string texturePath("");
+
+    if (dict.find("metadata") != dict.end())
+    {
+        ValueMap& metadataDict = dict["metadata"].asValueMap();
+        // try to read  texture file name from meta data
+        texturePath = metadataDict["textureFileName"].asString();
+    }
 
-        string texturePath("");
+    if (!texturePath.empty())
+    {
+        // build texture path relative to plist file
+        texturePath = FileUtils::getInstance()->fullPathFromRelativeFile(texturePath, plist);
+    }
+    else
+    {
+        // build texture path by replacing file extension
+        texturePath = plist;
+
+        // remove .xxx
+        size_t startPos = texturePath.find_last_of(".");
+        texturePath = texturePath.erase(startPos);
+
+        // append .png
+        texturePath = texturePath.append(".png");
 
-        if (dict.find("metadata") != dict.end())
+        CCLOG("cocos2d: SpriteFrameCache: Trying to use file %s as texture", texturePath.c_str());
+    }
+    return texturePath;
+}
+
+void SpriteFrameCache::addSpriteFramesWithFileAsync(const std::string& plist, const std::function<void(bool)>& callback)
+{
+    CCASSERT(!plist.empty(), "plist filename should not be nullptr");
+
+    if (_loadedFileNames->find(plist) != _loadedFileNames->end())
+    {
+        if (callback)
+            callback(true);
+        return;
+    }
+
+    // filled on the io thread, then read on the main thread
+    auto data = std::make_shared<Data>();
+    auto dict = std::make_shared<ValueMap>();
+    auto texturePath = std::make_shared<std::string>();
+
+    AsyncTaskPool::getInstance()->enqueue(AsyncTaskPool::TaskType::TASK_IO, [this, plist, data, dict, texturePath, callback](void*) {
+        if (texturePath->empty())
         {
-            ValueMap& metadataDict = dict["metadata"].asValueMap();
-            // try to read  texture file name from meta data
-            texturePath = metadataDict["textureFileName"].asString();
+            CCLOG("cocos2d: SpriteFrameCache: can not find %s", plist.c_str());
+            if (callback)
+                callback(false);
+            return;
         }
 
-        if (!texturePath.empty())
+        Director::getInstance()->getTextureCache()->addImageAsync(*texturePath, [this, plist, data, dict, callback](Texture2D* texture) {
+            // the plist may have been loaded synchronously meanwhile
+            if (texture && _loadedFileNames->find(plist) == _loadedFileNames->end())
+            {
+                if (!data->isNull())
+                    addSpriteFramesWithBinaryData(*data, texture);
+                else
+                    addSpriteFramesWithDictionary(*dict, texture);
+                _loadedFileNames->insert(plist);
+            }
+            if (callback)
+                callback(texture != nullptr);
+        });
+    }, nullptr, [plist, data, dict, texturePath]() {
+        std::string fullPath = FileUtils::getInstance()->fullPathForFilename(plist);
+        if (fullPath.empty())
+            return;
+
+        if (readSpriteFramesFile(fullPath, *data, *dict))
         {
-            // build texture path relative to plist file
-            texturePath = FileUtils::getInstance()->fullPathFromRelativeFile(texturePath, plist);
+            if (validateBinarySpriteFrames(*data))
+            {
+                ValueMap metadata = getBinarySpriteFramesMetadata(*data);
+                *texturePath = getTexturePathForPlist(metadata, plist);
+            }
         }
-        else
+        else if (!dict->empty())
         {
-            // build texture path by replacing file extension
-            texturePath = plist;
-
-            // remove .xxx
-            size_t startPos = texturePath.find_last_of("."); 
-            texturePath = texturePath.erase(startPos);
-
-            // append .png
-            texturePath = texturePath.append(".png");
-
-            CCLOG("cocos2d: SpriteFrameCache: Trying to use file %s as texture", texturePath.c_str());
+            *texturePath = getTexturePathForPlist(*dict, plist);
         }
-        addSpriteFramesWithDictionary(dict, texturePath);
-        _loadedFileNames->insert(plist);
-    }
+    });
 }
 
 bool SpriteFrameCache::isSpriteFramesWithFileLoaded(const std::string& plist) const
@@ -452,8 +736,10 @@ void SpriteFrameCache::addSpriteFrame(SpriteFrame* frame, const std::string& fra
 void SpriteFrameCache::removeSpriteFrames()
 {
     _spriteFrames.clear();
+    _lazySpriteFrames.clear();
     _spriteFramesAliases.clear();
     _loadedFileNames->clear();
+    removeDynamicAtlas();
 }
 
 void SpriteFrameCache::removeUnusedSpriteFrames()
@@ -480,6 +766,8 @@ void SpriteFrameCache::removeUnusedSpriteFrames()
     {
         _loadedFileNames->clear();
     }
+
+    removeUnusedDynamicAtlasFrames();
 }
 
 
@@ -496,11 +784,13 @@ void SpriteFrameCache::removeSpriteFrameByName(const std::string& name)
     if (!key.empty())
     {
         _spriteFrames.erase(key);
+        _lazySpriteFrames.erase(key);
         _spriteFramesAliases.erase(key);
     }
     else
     {
         _spriteFrames.erase(name);
+        _lazySpriteFrames.erase(name);
     }
 
     // FIXME:. Since we don't know the .plist file that originated the frame, we must remove all .plist from the cache
@@ -510,13 +800,21 @@ void SpriteFrameCache::removeSpriteFrameByName(const std::string& name)
 void SpriteFrameCache::removeSpriteFramesFromFile(const std::string& plist)
 {
     std::string fullPath = FileUtils::getInstance()->fullPathForFilename(plist);
-    ValueMap dict = FileUtils::getInstance()->getValueMapFromFile(fullPath);
-    if (dict.empty())
+    Data data;
+    ValueMap dict;
+    if (readSpriteFramesFile(fullPath, data, dict))
+    {
+        removeSpriteFramesFromBinaryData(data);
+    }
+    else if (dict.empty())
     {
         CCLOG("cocos2d:SpriteFrameCache:removeSpriteFramesFromFile: create dict by %s fail.",plist.c_str());
         return;
     }
-    removeSpriteFramesFromDictionary(dict);
+    else
+    {
+        removeSpriteFramesFromDictionary(dict);
+    }
 
     // remove it from the cache
     set<string>::iterator ret = _loadedFileNames->find(plist);
@@ -551,11 +849,29 @@ void SpriteFrameCache::removeSpriteFramesFromDictionary(ValueMap& dictionary)
         {
             keysToRemove.push_back(iter.first);
         }
+        _lazySpriteFrames.erase(iter.first);
     }
 
     _spriteFrames.erase(keysToRemove);
 }
 
+void SpriteFrameCache::removeSpriteFramesFromBinaryData(const Data& data)
+{
+    if (!validateBinarySpriteFrames(data))
+    {
+        CCLOG("cocos2d: SpriteFrameCache: invalid binary sprite frames");
+        return;
+    }
+
+    BinarySpriteFramesView view = getBinarySpriteFramesView(data);
+    for (uint32_t i = 0; i < view.header->frameCount; ++i)
+    {
+        std::string name = getBinaryString(view, view.frames[i].nameOffset, view.frames[i].nameLength);
+        _spriteFrames.erase(name);
+        _lazySpriteFrames.erase(name);
+    }
+}
+
 void SpriteFrameCache::removeSpriteFramesFromTexture(Texture2D* texture)
 {
     std::vector<std::string> keysToRemove;
@@ -571,11 +887,23 @@ void SpriteFrameCache::removeSpriteFramesFromTexture(Texture2D* texture)
     }
 
     _spriteFrames.erase(keysToRemove);
+
+    for (auto iter = _lazySpriteFrames.begin(); iter != _lazySpriteFrames.end();)
+    {
+        if (iter->second.file->texture == texture)
+            iter = _lazySpriteFrames.erase(iter);
+        else
+            ++iter;
+    }
 }
 
 SpriteFrame* SpriteFrameCache::getSpriteFrameByName(const std::string& name)
 {
     SpriteFrame* frame = _spriteFrames.at(name);
+    if (!frame && !_lazySpriteFrames.empty())
+    {
+        frame = createLazySpriteFrame(name);
+    }
     if (!frame)
     {
         // try alias dictionary
@@ -586,6 +914,10 @@ SpriteFrame* SpriteFrameCache::getSpriteFrameByName(const std::string& name)
             {
                 frame = _spriteFrames.at(key);
                 if (!frame)
+                {
+                    frame = createLazySpriteFrame(key);
+                }
+                if (!frame)
                 {
                     CCLOG("cocos2d: SpriteFrameCache: Frame aliases '%s' isn't found", key.c_str());
                 }
@@ -725,7 +1057,13 @@ bool SpriteFrameCache::reloadTexture(const std::string& plist)
     }
 
     std::string fullPath = FileUtils::getInstance()->fullPathForFilename(plist);
-    ValueMap dict = FileUtils::getInstance()->getValueMapFromFile(fullPath);
+    Data data;
+    ValueMap dict;
+    bool isBinary = readSpriteFramesFile(fullPath, data, dict);
+    if (isBinary)
+    {
+        dict = getBinarySpriteFramesMetadata(data);
+    }
 
     string texturePath("");
 
@@ -760,7 +1098,15 @@ bool SpriteFrameCache::reloadTexture(const std::string& plist)
 
     if (texture)
     {
-        reloadSpriteFramesWithDictionary(dict, texture);
+        if (isBinary)
+        {
+            removeSpriteFramesFromBinaryData(data);
+            addSpriteFramesWithBinaryData(data, texture);
+        }
+        else
+        {
+            reloadSpriteFramesWithDictionary(dict, texture);
+        }
         _loadedFileNames->insert(plist);
     }
     else
@@ -770,4 +1116,531 @@ bool SpriteFrameCache::reloadTexture(const std::string& plist)
     return true;
 }
 
+// SpriteFrameCache - Binary sprite frames
+
+SpriteFrameCache::BinarySpriteFrames::BinarySpriteFrames(const Data& data_, Texture2D* texture_)
+: data(data_)
+, texture(texture_)
+{
+    CC_SAFE_RETAIN(texture);
+}
+
+SpriteFrameCache::BinarySpriteFrames::~BinarySpriteFrames()
+{
+    CC_SAFE_RELEASE(texture);
+}
+
+bool SpriteFrameCache::writeBinarySpriteFramesFile(const std::string& plist, const std::string& binaryFile)
+{
+    std::string fullPath = FileUtils::getInstance()->fullPathForFilename(plist);
+    if (fullPath.empty())
+    {
+        CCLOG("cocos2d: SpriteFrameCache: can not find %s", plist.c_str());
+        return false;
+    }
+
+    ValueMap dict = FileUtils::getInstance()->getValueMapFromFile(fullPath);
+    Data data;
+    if (!encodeBinarySpriteFrames(dict, data))
+    {
+        CCLOG("cocos2d: SpriteFrameCache: can not convert %s", plist.c_str());
+        return false;
+    }
+    return FileUtils::getInstance()->writeDataToFile(data, binaryFile);
+}
+
+bool SpriteFrameCache::encodeBinarySpriteFrames(ValueMap& dictionary, Data& data)
+{
+    if (dictionary["frames"].getType() != cocos2d::Value::Type::MAP)
+        return false;
+
+    ValueMap& framesDict = dictionary["frames"].asValueMap();
+    int format = 0;
+    Size textureSize;
+    std::string textureFileName;
+    std::string pixelFormatName;
+
+    if (dictionary.find("metadata") != dictionary.end())
+    {
+        ValueMap& metadataDict = dictionary["metadata"].asValueMap();
+        format = metadataDict["format"].asInt();
+        textureFileName = metadataDict["textureFileName"].asString();
+        pixelFormatName = metadataDict["pixelFormat"].asString();
+
+        if (metadataDict.find("size") != metadataDict.end())
+        {
+            textureSize = SizeFromString(metadataDict["size"].asString());
+        }
+    }
+
+    if (format < 0 || format > 3)
+    {
+        CCLOG("cocos2d: SpriteFrameCache: format %d is not supported", format);
+        return false;
+    }
+
+    std::vector<BinarySpriteFrame> frames;
+    std::vector<BinarySpriteFrameAlias> aliases;
+    std::vector<int32_t> polygonData;
+    std::string strings;
+    frames.reserve(framesDict.size());
+
+    auto addString = [&strings](const std::string& str, uint32_t& offset, uint32_t& length) {
+        offset = static_cast<uint32_t>(strings.size());
+        length = static_cast<uint32_t>(str.size());
+        strings.append(str);
+    };
+
+    for (auto& iter : framesDict)
+    {
+        ValueMap& frameDict = iter.second.asValueMap();
+        BinarySpriteFrame frame;
+        memset(&frame, 0, sizeof(frame));
+        addString(iter.first, frame.nameOffset, frame.nameLength);
+
+        Rect rect;
+        Vec2 offset;
+        Size sourceSize;
+
+        if (format == 0)
+        {
+            rect = Rect(frameDict["x"].asFloat(), frameDict["y"].asFloat(), frameDict["width"].asFloat(), frameDict["height"].asFloat());
+            offset = Vec2(frameDict["offsetX"].asFloat(), frameDict["offsetY"].asFloat());
+            int ow = frameDict["originalWidth"].asInt();
+            int oh = frameDict["originalHeight"].asInt();
+            if (!ow || !oh)
+            {
+                CCLOGWARN("cocos2d: WARNING: originalWidth/Height not found on the SpriteFrame. AnchorPoint won't work as expected. Regenerate the .plist");
+            }
+            sourceSize = Size((float)std::abs(ow), (float)std::abs(oh));
+        }
+        else if (format == 1 || format == 2)
+        {
+            rect = RectFromString(frameDict["frame"].asString());
+            if (format == 2 && frameDict["rotated"].asBool())
+            {
+                frame.flags |= BINARY_FRAME_ROTATED;
+            }
+            offset = PointFromString(frameDict["offset"].asString());
+            sourceSize = SizeFromString(frameDict["sourceSize"].asString());
+        }
+        else
+        {
+            Size spriteSize = SizeFromString(frameDict["spriteSize"].asString());
+            Rect textureRect = RectFromString(frameDict["textureRect"].asString());
+            rect = Rect(textureRect.origin.x, textureRect.origin.y, spriteSize.width, spriteSize.height);
+            if (frameDict["textureRotated"].asBool())
+            {
+                frame.flags |= BINARY_FRAME_ROTATED;
+            }
+            offset = PointFromString(frameDict["spriteOffset"].asString());
+            sourceSize = SizeFromString(frameDict["spriteSourceSize"].asString());
+
+            for (const auto& value : frameDict["aliases"].asValueVector())
+            {
+                BinarySpriteFrameAlias alias;
+                addString(value.asString(), alias.nameOffset, alias.nameLength);
+                alias.frameIndex = static_cast<uint32_t>(frames.size());
+                aliases.push_back(alias);
+            }
+
+            if (frameDict.find("vertices") != frameDict.end())
+            {
+                std::vector<int> vertices;
+                parseIntegerList(frameDict["vertices"].asString(), vertices);
+                std::vector<int> verticesUV;
+                parseIntegerList(frameDict["verticesUV"].asString(), verticesUV);
+                std::vector<int> indices;
+                parseIntegerList(frameDict["triangles"].asString(), indices);
+
+                if (vertices.size() != verticesUV.size() || vertices.size() % 2 != 0)
+                {
+                    CCLOG("cocos2d: SpriteFrameCache: invalid polygon for frame %s", iter.first.c_str());
+                    return false;
+                }
+
+                frame.flags |= BINARY_FRAME_POLYGON;
+                frame.polygonOffset = static_cast<uint32_t>(polygonData.size());
+                frame.vertexCount = static_cast<uint32_t>(vertices.size());
+                frame.indexCount = static_cast<uint32_t>(indices.size());
+                polygonData.insert(polygonData.end(), vertices.begin(), vertices.end());
+                polygonData.insert(polygonData.end(), verticesUV.begin(), verticesUV.end());
+                polygonData.insert(polygonData.end(), indices.begin(), indices.end());
+            }
+            if (frameDict.find("anchor") != frameDict.end())
+            {
+                Vec2 anchor = PointFromString(frameDict["anchor"].asString());
+                frame.flags |= BINARY_FRAME_ANCHOR;
+                frame.anchorX = anchor.x;
+                frame.anchorY = anchor.y;
+            }
+        }
+
+        frame.x = rect.origin.x;
+        frame.y = rect.origin.y;
+        frame.width = rect.size.width;
+        frame.height = rect.size.height;
+        frame.offsetX = offset.x;
+        frame.offsetY = offset.y;
+        frame.sourceWidth = sourceSize.width;
+        frame.sourceHeight = sourceSize.height;
+        frames.push_back(frame);
+    }
+
+    BinarySpriteFramesHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, "CCSF", 4);
+    header.version = BINARY_SPRITE_FRAMES_VERSION;
+    header.frameCount = static_cast<uint32_t>(frames.size());
+    header.aliasCount = static_cast<uint32_t>(aliases.size());
+    header.polygonDataCount = static_cast<uint32_t>(polygonData.size());
+    header.textureWidth = textureSize.width;
+    header.textureHeight = textureSize.height;
+    addString(textureFileName, header.textureNameOffset, header.textureNameLength);
+    addString(pixelFormatName, header.pixelFormatOffset, header.pixelFormatLength);
+    header.stringDataSize = static_cast<uint32_t>(strings.size());
+
+    size_t framesSize = frames.size() * sizeof(BinarySpriteFrame);
+    size_t aliasesSize = aliases.size() * sizeof(BinarySpriteFrameAlias);
+    size_t polygonDataSize = polygonData.size() * sizeof(int32_t);
+    size_t size = sizeof(header) + framesSize + aliasesSize + polygonDataSize + strings.size();
+
+    unsigned char* bytes = static_cast<unsigned char*>(malloc(size));
+    if (!bytes)
+        return false;
+
+    unsigned char* p = bytes;
+    memcpy(p, &header, sizeof(header));
+    p += sizeof(header);
+    if (framesSize)
+        memcpy(p, frames.data(), framesSize);
+    p += framesSize;
+    if (aliasesSize)
+        memcpy(p, aliases.data(), aliasesSize);
+    p += aliasesSize;
+    if (polygonDataSize)
+        memcpy(p, polygonData.data(), polygonDataSize);
+    p += polygonDataSize;
+    if (!strings.empty())
+        memcpy(p, strings.data(), strings.size());
+
+    data.fastSet(bytes, size);
+    return true;
+}
+
+bool SpriteFrameCache::addSpriteFramesWithBinaryData(const Data& data, Texture2D* texture)
+{
+    if (!validateBinarySpriteFrames(data))
+    {
+        CCLOG("cocos2d: SpriteFrameCache: invalid binary sprite frames");
+        return false;
+    }
+
+    BinarySpriteFramesView view = getBinarySpriteFramesView(data);
+
+    for (uint32_t i = 0; i < view.header->aliasCount; ++i)
+    {
+        const BinarySpriteFrameAlias& alias = view.aliases[i];
+        const BinarySpriteFrame& frame = view.frames[alias.frameIndex];
+        std::string oneAlias = getBinaryString(view, alias.nameOffset, alias.nameLength);
+        if (_spriteFramesAliases.find(oneAlias) != _spriteFramesAliases.end())
+        {
+            CCLOGWARN("cocos2d: WARNING: an alias with name %s already exists", oneAlias.c_str());
+        }
+
+        _spriteFramesAliases[oneAlias] = Value(getBinaryString(view, frame.nameOffset, frame.nameLength));
+    }
+
+    if (_lazyFrameCreationEnabled)
+    {
+        auto file = std::make_shared<BinarySpriteFrames>(data, texture);
+        for (uint32_t i = 0; i < view.header->frameCount; ++i)
+        {
+            std::string spriteFrameName = getBinaryString(view, view.frames[i].nameOffset, view.frames[i].nameLength);
+            if (_spriteFrames.at(spriteFrameName) == nullptr && _lazySpriteFrames.find(spriteFrameName) == _lazySpriteFrames.end())
+            {
+                LazySpriteFrame lazyFrame = { file, i };
+                _lazySpriteFrames.emplace(std::move(spriteFrameName), std::move(lazyFrame));
+            }
+        }
+    }
+    else
+    {
+        Image* image = nullptr;
+        for (uint32_t i = 0; i < view.header->frameCount; ++i)
+        {
+            std::string spriteFrameName = getBinaryString(view, view.frames[i].nameOffset, view.frames[i].nameLength);
+            if (_spriteFrames.at(spriteFrameName))
+                continue;
+
+            SpriteFrame* spriteFrame = createSpriteFrameWithBinaryData(data, texture, i, &image);
+            if (spriteFrame)
+                _spriteFrames.insert(spriteFrameName, spriteFrame);
+        }
+        CC_SAFE_DELETE(image);
+    }
+    return true;
+}
+
+SpriteFrame* SpriteFrameCache::createSpriteFrameWithBinaryData(const Data& data, Texture2D* texture, uint32_t index, Image** image)
+{
+    BinarySpriteFramesView view = getBinarySpriteFramesView(data);
+    const BinarySpriteFrame& frame = view.frames[index];
+    Size sourceSize(frame.sourceWidth, frame.sourceHeight);
+
+    SpriteFrame* spriteFrame = SpriteFrame::createWithTexture(texture,
+                                                              Rect(frame.x, frame.y, frame.width, frame.height),
+                                                              (frame.flags & BINARY_FRAME_ROTATED) != 0,
+                                                              Vec2(frame.offsetX, frame.offsetY),
+                                                              sourceSize);
+    if (!spriteFrame)
+        return nullptr;
+
+    if (frame.flags & BINARY_FRAME_POLYGON)
+    {
+        const int32_t* polygonData = view.polygonData + frame.polygonOffset;
+        std::vector<int> vertices(polygonData, polygonData + frame.vertexCount);
+        std::vector<int> verticesUV(polygonData + frame.vertexCount, polygonData + 2 * frame.vertexCount);
+        std::vector<int> indices(polygonData + 2 * frame.vertexCount, polygonData + 2 * frame.vertexCount + frame.indexCount);
+
+        PolygonInfo info;
+        initializePolygonInfo(Size(view.header->textureWidth, view.header->textureHeight), sourceSize, vertices, verticesUV, indices, info);
+        spriteFrame->setPolygonInfo(info);
+    }
+    if (frame.flags & BINARY_FRAME_ANCHOR)
+    {
+        spriteFrame->setAnchorPoint(Vec2(frame.anchorX, frame.anchorY));
+    }
+
+    if (NinePatchImageParser::isNinePatchImage(getBinaryString(view, frame.nameOffset, frame.nameLength)))
+    {
+        if (*image == nullptr)
+        {
+            *image = new (std::nothrow) Image();
+            (*image)->initWithImageFile(Director::getInstance()->getTextureCache()->getTextureFilePath(texture));
+        }
+        NinePatchImageParser parser;
+        parser.setSpriteFrameInfo(*image, spriteFrame->getRectInPixels(), spriteFrame->isRotated());
+        texture->addSpriteFrameCapInset(spriteFrame, parser.parseCapInset());
+    }
+    return spriteFrame;
+}
+
+SpriteFrame* SpriteFrameCache::createLazySpriteFrame(const std::string& name)
+{
+    auto iter = _lazySpriteFrames.find(name);
+    if (iter == _lazySpriteFrames.end())
+        return nullptr;
+
+    // the entry owns the file, keep it alive until the frame is created
+    LazySpriteFrame lazyFrame = iter->second;
+    _lazySpriteFrames.erase(iter);
+
+    Image* image = nullptr;
+    SpriteFrame* spriteFrame = createSpriteFrameWithBinaryData(lazyFrame.file->data, lazyFrame.file->texture, lazyFrame.index, &image);
+    CC_SAFE_DELETE(image);
+
+    if (spriteFrame)
+        _spriteFrames.insert(name, spriteFrame);
+    return spriteFrame;
+}
+
+// SpriteFrameCache - Dynamic atlas
+
+SpriteFrame* SpriteFrameCache::getDynamicAtlasFrame(const std::string& filename)
+{
+    if (!_dynamicAtlasEnabled)
+        return nullptr;
+
+    std::string fullpath = FileUtils::getInstance()->fullPathForFilename(filename);
+    if (fullpath.empty() || _dynamicAtlasSkippedFiles.find(fullpath) != _dynamicAtlasSkippedFiles.end())
+        return nullptr;
+
+    SpriteFrame* frame = _dynamicAtlasFrames.at(fullpath);
+    if (frame)
+        return frame;
+
+    // the textures already loaded don't get a second copy, neither do files too big for an atlas image
+    long maxBytes = (long)_dynamicAtlasMaxImageSize * _dynamicAtlasMaxImageSize * 4;
+    if (Director::getInstance()->getTextureCache()->getTextureForKey(fullpath)
+        || NinePatchImageParser::isNinePatchImage(fullpath)
+        || FileUtils::getInstance()->getFileSize(fullpath) > maxBytes)
+    {
+        _dynamicAtlasSkippedFiles.insert(fullpath);
+        return nullptr;
+    }
+
+    Image image;
+    if (!image.initWithImageFile(fullpath)
+        || image.isCompressed()
+        || image.getWidth() > _dynamicAtlasMaxImageSize
+        || image.getHeight() > _dynamicAtlasMaxImageSize
+        || (image.hasAlpha() && !image.hasPremultipliedAlpha()))
+    {
+        _dynamicAtlasSkippedFiles.insert(fullpath);
+        return nullptr;
+    }
+
+    unsigned char* pixels = nullptr;
+    ssize_t pixelsLen = 0;
+    if (Texture2D::convertDataToFormat(image.getData(), image.getDataLen(), image.getRenderFormat(),
+                                       Texture2D::PixelFormat::RGBA8888, &pixels, &pixelsLen) != Texture2D::PixelFormat::RGBA8888)
+    {
+        if (pixels != image.getData())
+            free(pixels);
+        _dynamicAtlasSkippedFiles.insert(fullpath);
+        return nullptr;
+    }
+
+    // 1 pixel around the image repeats its edges, linear filtering doesn't bleed the neighbours in
+    int width = image.getWidth();
+    int height = image.getHeight();
+    int paddedWidth = width + 2;
+    int paddedHeight = height + 2;
+
+    DynamicAtlasPage* page = nullptr;
+    int x = 0;
+    int y = 0;
+    for (auto candidate : _dynamicAtlasPages)
+    {
+        if (allocateDynamicAtlasRect(*candidate, paddedWidth, paddedHeight, x, y))
+        {
+            page = candidate;
+            break;
+        }
+    }
+
+    if (page == nullptr)
+    {
+        int pageSize = std::min(_dynamicAtlasPageSize, Configuration::getInstance()->getMaxTextureSize());
+        auto texture = new (std::nothrow) Texture2D();
+        std::vector<unsigned char> blank((size_t)pageSize * pageSize * 4, 0);
+        if (paddedWidth > pageSize || paddedHeight > pageSize || texture == nullptr
+            || !texture->initWithData(blank.data(), blank.size(), Texture2D::PixelFormat::RGBA8888, pageSize, pageSize, Size((float)pageSize, (float)pageSize)))
+        {
+            CC_SAFE_RELEASE(texture);
+            if (pixels != image.getData())
+                free(pixels);
+            _dynamicAtlasSkippedFiles.insert(fullpath);
+            return nullptr;
+        }
+        texture->_hasPremultipliedAlpha = true;
+
+        page = new (std::nothrow) DynamicAtlasPage();
+        page->texture = texture;
+        page->size = pageSize;
+        page->top = 0;
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+        page->data.swap(blank);
+        VolatileTextureMgr::addDataTexture(texture, page->data.data(), (int)page->data.size(), Texture2D::PixelFormat::RGBA8888, texture->getContentSizeInPixels());
+#endif
+        _dynamicAtlasPages.push_back(page);
+        allocateDynamicAtlasRect(*page, paddedWidth, paddedHeight, x, y);
+    }
+
+    std::vector<unsigned char> padded((size_t)paddedWidth * paddedHeight * 4);
+    for (int row = 0; row < paddedHeight; ++row)
+    {
+        const unsigned char* src = pixels + (size_t)clampf(row - 1, 0, height - 1) * width * 4;
+        unsigned char* dst = padded.data() + (size_t)row * paddedWidth * 4;
+        memcpy(dst, src, 4);
+        memcpy(dst + 4, src, width * 4);
+        memcpy(dst + (width + 1) * 4, src + (width - 1) * 4, 4);
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+        memcpy(page->data.data() + ((size_t)(y + row) * page->size + x) * 4, dst, paddedWidth * 4);
+#endif
+    }
+    if (pixels != image.getData())
+        free(pixels);
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    page->texture->updateWithData(padded.data(), x, y, paddedWidth, paddedHeight);
+
+    frame = SpriteFrame::createWithTexture(page->texture, CC_RECT_PIXELS_TO_POINTS(Rect((float)(x + 1), (float)(y + 1), (float)width, (float)height)));
+    _dynamicAtlasFrames.insert(fullpath, frame);
+    return frame;
+}
+
+bool SpriteFrameCache::allocateDynamicAtlasRect(DynamicAtlasPage& page, int width, int height, int& outX, int& outY)
+{
+    // the shelf wasting the least height, or a new one
+    DynamicAtlasShelf* best = nullptr;
+    for (auto& shelf : page.shelves)
+    {
+        if (shelf.height >= height && shelf.width + width <= page.size && (best == nullptr || shelf.height < best->height))
+            best = &shelf;
+    }
+
+    if (best == nullptr)
+    {
+        if (page.top + height > page.size || width > page.size)
+            return false;
+
+        DynamicAtlasShelf shelf = { page.top, height, 0 };
+        page.shelves.push_back(shelf);
+        page.top += height;
+        best = &page.shelves.back();
+    }
+
+    outX = best->width;
+    outY = best->y;
+    best->width += width;
+    return true;
+}
+
+void SpriteFrameCache::removeUnusedDynamicAtlasFrames()
+{
+    std::vector<std::string> toRemoveFrames;
+    for (auto& iter : _dynamicAtlasFrames)
+    {
+        if (iter.second->getReferenceCount() == 1)
+            toRemoveFrames.push_back(iter.first);
+    }
+    _dynamicAtlasFrames.erase(toRemoveFrames);
+
+    // the pages without frames are released, the space of the others is kept
+    for (auto it = _dynamicAtlasPages.begin(); it != _dynamicAtlasPages.end(); /* nothing */)
+    {
+        Texture2D* texture = (*it)->texture;
+        bool used = false;
+        for (auto& iter : _dynamicAtlasFrames)
+        {
+            if (iter.second->getTexture() == texture)
+            {
+                used = true;
+                break;
+            }
+        }
+
+        if (used)
+        {
+            ++it;
+        }
+        else
+        {
+            CCLOG("cocos2d: SpriteFrameCache: removing unused dynamic atlas page");
+            texture->release();
+            delete *it;
+            it = _dynamicAtlasPages.erase(it);
+        }
+    }
+}
+
+void SpriteFrameCache::removeDynamicAtlas()
+{
+    // the sprites still using the pages retain their textures
+    _dynamicAtlasFrames.clear();
+    _dynamicAtlasSkippedFiles.clear();
+    for (auto page : _dynamicAtlasPages)
+    {
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+        // the pixels are deleted with the page, the texture can't be restored any more
+        VolatileTextureMgr::removeTexture(page->texture);
+#endif
+        page->texture->release();
+        delete page;
+    }
+    _dynamicAtlasPages.clear();
+}
+
 NS_CC_END
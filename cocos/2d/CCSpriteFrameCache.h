@@ -32,16 +32,22 @@ THE SOFTWARE.
 
 #include <set>
 #include <string>
+#include <vector>
+#include <functional>
+#include <memory>
+#include <unordered_map>
 #include "2d/CCSpriteFrame.h"
 #include "base/CCRef.h"
 #include "base/CCValue.h"
 #include "base/CCMap.h"
+#include "base/CCData.h"
 
 NS_CC_BEGIN
 
 class Sprite;
 class Texture2D;
 class PolygonInfo;
+class Image;
 
 /**
  * @addtogroup _2d
@@ -80,6 +86,10 @@ class PolygonInfo;
  Use one of the following tools to create the .plist file and sprite sheet:
  - [TexturePacker](https://www.codeandweb.com/texturepacker/cocos2d)
  - [Zwoptex](https://zwopple.com/zwoptex/)
+
+ The .plist file can be converted offline with writeBinarySpriteFramesFile() into a compact binary file,
+ which is loaded by the same methods without parsing XML. With lazy frame creation enabled, the
+ sprite frames of a file are only created the first time getSpriteFrameByName() returns them.
  
  @since v0.9
  @js cc.spriteFrameCache
@@ -159,6 +169,43 @@ public:
      */
     void addSpriteFramesWithFileContent(const std::string& plist_content, Texture2D *texture);
 
+    /** Adds multiple Sprite Frames from a plist file, like addSpriteFramesWithFile(const std::string& plist),
+     * without blocking the main thread: the plist is parsed off the main thread and the texture is loaded
+     * with TextureCache::addImageAsync().
+     * @js NA
+     * @lua NA
+     *
+     * @param plist Plist file name.
+     * @param callback Called on the main thread once the sprite frames are added, with false if they couldn't be loaded.
+     * @since v3.14
+     */
+    void addSpriteFramesWithFileAsync(const std::string& plist, const std::function<void(bool)>& callback);
+
+    /** Converts a plist file into a binary sprite frames file.
+     * The addSpriteFramesWithFile() methods load the binary file in place of the plist, without parsing XML.
+     * All the plist formats are supported, and the texture file name is kept relative to the binary file.
+     * @js NA
+     * @lua NA
+     *
+     * @param plist Plist file name.
+     * @param binaryFile Full path of the binary file to write.
+     * @return False if the plist can't be read or the binary file can't be written.
+     * @since v3.14
+     */
+    bool writeBinarySpriteFramesFile(const std::string& plist, const std::string& binaryFile);
+
+    /** Enables lazy frame creation, disabled by default.
+     * The frames added afterwards are kept as compact descriptors instead of SpriteFrame objects,
+     * and each sprite frame is created the first time getSpriteFrameByName() returns it.
+     * The textures are still loaded when the frames are added.
+     * @since v3.14
+     */
+    void setLazyFrameCreationEnabled(bool enabled) { _lazyFrameCreationEnabled = enabled; }
+    /** Whether or not the sprite frames are created the first time they are used.
+     * @since v3.14
+     */
+    bool isLazyFrameCreationEnabled() const { return _lazyFrameCreationEnabled; }
+
     /** Adds an sprite frame with a given name.
      If the name already exists, then the contents of the old name will be replaced with the new one.
      *
@@ -239,9 +286,66 @@ public:
 
     bool reloadTexture(const std::string& plist);
 
+    /** Enables the dynamic atlas, disabled by default.
+     * Sprite::create(filename) then packs the images no larger than the dynamic atlas maximum image size
+     * into shared atlas pages, instead of giving each of them its own texture, so that their sprites batch.
+     * Compressed images, 9-patch images, images with straight alpha and images already loaded as textures
+     * keep their own texture.
+     * @since v3.14
+     */
+    void setDynamicAtlasEnabled(bool enabled) { _dynamicAtlasEnabled = enabled; }
+    /** Whether or not Sprite::create(filename) packs small images into the dynamic atlas.
+     * @since v3.14
+     */
+    bool isDynamicAtlasEnabled() const { return _dynamicAtlasEnabled; }
+
+    /** Sets the largest width and height of the images packed into the dynamic atlas, 128 pixels by default.
+     * @since v3.14
+     */
+    void setDynamicAtlasMaxImageSize(int pixels) { _dynamicAtlasMaxImageSize = pixels; }
+    /** Returns the largest width and height of the images packed into the dynamic atlas.
+     * @since v3.14
+     */
+    int getDynamicAtlasMaxImageSize() const { return _dynamicAtlasMaxImageSize; }
+
+    /** Sets the size of the new dynamic atlas pages, 1024 pixels by default, at most the maximum texture size.
+     * @since v3.14
+     */
+    void setDynamicAtlasPageSize(int pixels) { _dynamicAtlasPageSize = pixels; }
+    /** Returns the size of the new dynamic atlas pages.
+     * @since v3.14
+     */
+    int getDynamicAtlasPageSize() const { return _dynamicAtlasPageSize; }
+
+    /** Returns the sprite frame of an image file in the dynamic atlas, packing the image first if needed.
+     * The frame rect points into a shared RGBA8888 page, with premultiplied alpha.
+     * Unused frames are removed by removeUnusedSpriteFrames(), and pages without frames are released then.
+     *
+     * @param filename The image file.
+     * @return The sprite frame, or nullptr when the dynamic atlas is disabled or the image can't be packed.
+     * @since v3.14
+     */
+    SpriteFrame* getDynamicAtlasFrame(const std::string& filename);
+
+    /** Returns the number of dynamic atlas pages.
+     * @since v3.14
+     */
+    ssize_t getDynamicAtlasPageCount() const { return (ssize_t)_dynamicAtlasPages.size(); }
+
+    /** Returns the number of cached sprite frames, the lazy ones which aren't created yet included.
+     * @since v3.14
+     */
+    ssize_t getSpriteFrameCount() const { return _spriteFrames.size() + (ssize_t)_lazySpriteFrames.size(); }
+
 protected:
     // MARMALADE: Made this protected not private, as deriving from this class is pretty useful
-    SpriteFrameCache(){}
+    SpriteFrameCache()
+    : _loadedFileNames(nullptr)
+    , _lazyFrameCreationEnabled(false)
+    , _dynamicAtlasEnabled(false)
+    , _dynamicAtlasMaxImageSize(128)
+    , _dynamicAtlasPageSize(1024)
+    {}
 
     /*Adds multiple Sprite Frames with a dictionary. The texture will be associated with the created sprite frames.
      */
@@ -250,6 +354,9 @@ protected:
     /*Adds multiple Sprite Frames with a dictionary. The texture will be associated with the created sprite frames.
      */
     void addSpriteFramesWithDictionary(ValueMap& dictionary, const std::string &texturePath);
+
+    /** Returns the texture of a plist, from its metadata or by replacing the .plist suffix with .png. */
+    static std::string getTexturePathForPlist(ValueMap& dictionary, const std::string& plist);
     
     /** Removes multiple Sprite Frames from Dictionary.
     * @since v0.99.5
@@ -269,9 +376,64 @@ protected:
 
     void reloadSpriteFramesWithDictionary(ValueMap& dictionary, Texture2D *texture);
 
+    // a binary sprite frames file, whose sprite frames are created lazily
+    struct BinarySpriteFrames
+    {
+        BinarySpriteFrames(const Data& data, Texture2D* texture);
+        ~BinarySpriteFrames();
+
+        Data data;
+        Texture2D* texture;
+    };
+    struct LazySpriteFrame
+    {
+        std::shared_ptr<BinarySpriteFrames> file;
+        uint32_t index;
+    };
+    /** Encodes the frames of a plist dictionary in the binary sprite frames format. */
+    bool encodeBinarySpriteFrames(ValueMap& dictionary, Data& data);
+    /** Adds the sprite frames of a binary file, or only their descriptors when lazy frame creation is enabled. */
+    bool addSpriteFramesWithBinaryData(const Data& data, Texture2D* texture);
+    SpriteFrame* createSpriteFrameWithBinaryData(const Data& data, Texture2D* texture, uint32_t index, Image** image);
+    SpriteFrame* createLazySpriteFrame(const std::string& name);
+    void removeSpriteFramesFromBinaryData(const Data& data);
+
+    // a page of the dynamic atlas, the images are packed on shelves that are never freed
+    struct DynamicAtlasShelf
+    {
+        int y;
+        int height;
+        int width;
+    };
+    struct DynamicAtlasPage
+    {
+        Texture2D* texture;
+        int size;
+        int top;
+        std::vector<DynamicAtlasShelf> shelves;
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+        // the pixels the texture is restored from when the GL context is lost
+        std::vector<unsigned char> data;
+#endif
+    };
+    bool allocateDynamicAtlasRect(DynamicAtlasPage& page, int width, int height, int& outX, int& outY);
+    void removeUnusedDynamicAtlasFrames();
+    void removeDynamicAtlas();
+
     Map<std::string, SpriteFrame*> _spriteFrames;
     ValueMap _spriteFramesAliases;
     std::set<std::string>*  _loadedFileNames;
+
+    bool _lazyFrameCreationEnabled;
+    std::unordered_map<std::string, LazySpriteFrame> _lazySpriteFrames;
+
+    bool _dynamicAtlasEnabled;
+    int _dynamicAtlasMaxImageSize;
+    int _dynamicAtlasPageSize;
+    // frames by full path, and the full paths of the images that can't be packed
+    Map<std::string, SpriteFrame*> _dynamicAtlasFrames;
+    std::set<std::string> _dynamicAtlasSkippedFiles;
+    std::vector<DynamicAtlasPage*> _dynamicAtlasPages;
 };
 
 // end of _2d group
@@ -0,0 +1,357 @@
+/****************************************************************************
+Copyright (c) 2017 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+
+#include "2d/CCStaticBatchNode.h"
+#include "base/CCDirector.h"
+#include "base/CCEventCustom.h"
+#include "base/CCEventListenerCustom.h"
+#include "base/CCEventDispatcher.h"
+#include "base/CCEventType.h"
+#include "base/CCConfiguration.h"
+#include "renderer/CCRenderer.h"
+#include "renderer/CCGroupCommand.h"
+#include "renderer/CCTrianglesCommand.h"
+#include "renderer/CCGLProgramState.h"
+#include "renderer/ccGLStateCache.h"
+
+NS_CC_BEGIN
+
+// the indices of a segment are 16 bits
+static const ssize_t MAX_SEGMENT_VERTICES = 65536;
+
+StaticBatchNode* StaticBatchNode::create()
+{
+    StaticBatchNode* ret = new (std::nothrow) StaticBatchNode();
+    if (ret && ret->init())
+    {
+        ret->autorelease();
+        return ret;
+    }
+    CC_SAFE_DELETE(ret);
+    return nullptr;
+}
+
+StaticBatchNode::StaticBatchNode()
+: _buffersDirty(false)
+, _dirty(true)
+, _recorded(false)
+{
+    _buffersVBO[0] = _buffersVBO[1] = 0;
+}
+
+StaticBatchNode::~StaticBatchNode()
+{
+    clearSegments();
+    releaseBuffers();
+}
+
+bool StaticBatchNode::init()
+{
+    if (!Node::init())
+        return false;
+
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+    // the buffers were lost with the context, the vertices are still there
+    auto listener = EventListenerCustom::create(EVENT_RENDERER_RECREATED, [this](EventCustom* /*event*/){
+        _buffersVBO[0] = _buffersVBO[1] = 0;
+        _buffersDirty = true;
+    });
+    _eventDispatcher->addEventListenerWithSceneGraphPriority(listener, this);
+#endif
+
+    return true;
+}
+
+void StaticBatchNode::addChild(Node *child, int localZOrder, int tag)
+{
+    Node::addChild(child, localZOrder, tag);
+    _dirty = true;
+}
+
+void StaticBatchNode::addChild(Node *child, int localZOrder, const std::string &name)
+{
+    Node::addChild(child, localZOrder, name);
+    _dirty = true;
+}
+
+void StaticBatchNode::removeChild(Node *child, bool cleanup)
+{
+    Node::removeChild(child, cleanup);
+    _dirty = true;
+}
+
+void StaticBatchNode::removeAllChildrenWithCleanup(bool cleanup)
+{
+    Node::removeAllChildrenWithCleanup(cleanup);
+    _dirty = true;
+}
+
+void StaticBatchNode::reorderChild(Node *child, int localZOrder)
+{
+    Node::reorderChild(child, localZOrder);
+    _dirty = true;
+}
+
+void StaticBatchNode::updateDisplayedOpacity(GLubyte parentOpacity)
+{
+    GLubyte displayedOpacity = _displayedOpacity;
+    Node::updateDisplayedOpacity(parentOpacity);
+    if (_displayedOpacity != displayedOpacity)
+        _dirty = true;
+}
+
+void StaticBatchNode::updateDisplayedColor(const Color3B& parentColor)
+{
+    Color3B displayedColor = _displayedColor;
+    Node::updateDisplayedColor(parentColor);
+    if (_displayedColor != displayedColor)
+        _dirty = true;
+}
+
+void StaticBatchNode::visit(Renderer *renderer, const Mat4 &parentTransform, uint32_t parentFlags)
+{
+    if (!_visible)
+        return;
+
+    // the commands of a subtree visited on a worker thread can't be read back, it's recorded on the main thread
+    if (_dirty && !renderer->isRecordingVisit())
+        record(renderer);
+
+    if (!_recorded)
+    {
+        Node::visit(renderer, parentTransform, parentFlags);
+        return;
+    }
+
+    uint32_t flags = processParentFlags(parentTransform, parentFlags);
+
+    if (isVisitableByVisitingCamera())
+    {
+        _director->pushMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
+        _director->loadMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW, _modelViewTransform);
+
+        draw(renderer, _modelViewTransform, flags);
+
+        _director->popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
+    }
+}
+
+void StaticBatchNode::record(Renderer* renderer)
+{
+    _dirty = false;
+    _recorded = false;
+    clearSegments();
+
+    auto groupCommandManager = renderer->getGroupCommandManager();
+    int renderQueueID = groupCommandManager->getGroupID();
+
+    // the children are visited relative to the node, the culling would test them at the origin of the world
+    bool cullingEnabled = renderer->isCullingEnabled();
+    renderer->setCullingEnabled(false);
+    renderer->pushGroup(renderQueueID);
+
+    sortAllChildren();
+    for (const auto& child : _children)
+    {
+        child->visit(renderer, Mat4::IDENTITY, FLAGS_DIRTY_MASK);
+    }
+
+    renderer->popGroup();
+    renderer->setCullingEnabled(cullingEnabled);
+
+    auto& queue = renderer->getRenderQueue(renderQueueID);
+    _recorded = copyCommands(queue);
+    queue.clear();
+    groupCommandManager->releaseGroupID(renderQueueID);
+
+    if (!_recorded)
+    {
+        CCLOG("cocos2d: StaticBatchNode: the children use commands that can't be batched, they are visited every frame");
+        clearSegments();
+    }
+    _buffersDirty = true;
+}
+
+bool StaticBatchNode::copyCommands(RenderQueue& queue)
+{
+    if (queue.getSubQueueSize(RenderQueue::QUEUE_GROUP::GLOBALZ_ZERO) != queue.size())
+        return false;
+
+    Vec2 minPoint(FLT_MAX, FLT_MAX);
+    Vec2 maxPoint(-FLT_MAX, -FLT_MAX);
+
+    for (auto command : queue.getSubQueue(RenderQueue::QUEUE_GROUP::GLOBALZ_ZERO))
+    {
+        if (command->getType() != RenderCommand::Type::TRIANGLES_COMMAND)
+            return false;
+
+        auto trianglesCommand = static_cast<TrianglesCommand*>(command);
+        ssize_t vertexCount = trianglesCommand->getVertexCount();
+        ssize_t indexCount = trianglesCommand->getIndexCount();
+        if (vertexCount == 0 || indexCount == 0)
+            continue;
+        if (vertexCount > MAX_SEGMENT_VERTICES)
+            return false;
+
+        Segment* segment = _segments.empty() ? nullptr : &_segments.back();
+        if (segment == nullptr || segment->materialID != trianglesCommand->getMaterialID()
+            || (ssize_t)_vertices.size() - segment->firstVertex + vertexCount > MAX_SEGMENT_VERTICES)
+        {
+            Segment newSegment;
+            newSegment.textureID = trianglesCommand->getTextureID();
+            newSegment.alphaTextureID = trianglesCommand->getAlphaTextureID();
+            newSegment.glProgramState = trianglesCommand->getGLProgramState();
+            newSegment.glProgramState->retain();
+            newSegment.blendFunc = trianglesCommand->getBlendType();
+            newSegment.materialID = trianglesCommand->getMaterialID();
+            newSegment.firstVertex = _vertices.size();
+            newSegment.firstIndex = _indices.size();
+            newSegment.indexCount = 0;
+            _segments.push_back(newSegment);
+            segment = &_segments.back();
+        }
+
+        // the vertices are transformed on the CPU once, like the renderer does every frame
+        const Mat4& modelView = trianglesCommand->getModelView();
+        auto vertices = trianglesCommand->getVertices();
+        GLushort indexOffset = (GLushort)(_vertices.size() - segment->firstVertex);
+        for (ssize_t i = 0; i < vertexCount; ++i)
+        {
+            V3F_C4B_T2F vertex = vertices[i];
+            modelView.transformPoint(&vertex.vertices);
+            minPoint.set(std::min(minPoint.x, vertex.vertices.x), std::min(minPoint.y, vertex.vertices.y));
+            maxPoint.set(std::max(maxPoint.x, vertex.vertices.x), std::max(maxPoint.y, vertex.vertices.y));
+            _vertices.push_back(vertex);
+        }
+
+        auto indices = trianglesCommand->getIndices();
+        for (ssize_t i = 0; i < indexCount; ++i)
+        {
+            _indices.push_back(indices[i] + indexOffset);
+        }
+        segment->indexCount += indexCount;
+    }
+
+    _bounds = _vertices.empty() ? Rect::ZERO : Rect(minPoint.x, minPoint.y, maxPoint.x - minPoint.x, maxPoint.y - minPoint.y);
+    return true;
+}
+
+void StaticBatchNode::clearSegments()
+{
+    for (auto& segment : _segments)
+    {
+        segment.glProgramState->release();
+    }
+    _segments.clear();
+    _vertices.clear();
+    _indices.clear();
+    _bounds = Rect::ZERO;
+}
+
+void StaticBatchNode::uploadBuffers()
+{
+    _buffersDirty = false;
+
+    if (_buffersVBO[0] == 0)
+        glGenBuffers(2, &_buffersVBO[0]);
+
+    glBindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(V3F_C4B_T2F) * _vertices.size(), _vertices.data(), GL_STATIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffersVBO[1]);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(GLushort) * _indices.size(), _indices.data(), GL_STATIC_DRAW);
+
+    CHECK_GL_ERROR_DEBUG();
+}
+
+void StaticBatchNode::releaseBuffers()
+{
+    if (_buffersVBO[0] != 0)
+    {
+        glDeleteBuffers(2, &_buffersVBO[0]);
+        _buffersVBO[0] = _buffersVBO[1] = 0;
+    }
+}
+
+void StaticBatchNode::draw(Renderer *renderer, const Mat4 &transform, uint32_t flags)
+{
+    if (_segments.empty())
+        return;
+
+    // the whole batch is culled at once
+    Mat4 boundsTransform = transform;
+    boundsTransform.translate(_bounds.origin.x, _bounds.origin.y, 0);
+    if (!renderer->checkVisibility(boundsTransform, _bounds.size))
+        return;
+
+    _customCommand.init(_globalZOrder, transform, flags);
+    _customCommand.func = CC_CALLBACK_0(StaticBatchNode::onDraw, this, transform, flags);
+    renderer->addCommand(&_customCommand);
+}
+
+void StaticBatchNode::onDraw(const Mat4& transform, uint32_t /*flags*/)
+{
+    if (_buffersDirty)
+        uploadBuffers();
+
+    if (Configuration::getInstance()->supportsShareableVAO())
+    {
+        GL::bindVAO(0);
+    }
+    GL::enableVertexAttribs(GL::VERTEX_ATTRIB_FLAG_POS_COLOR_TEX);
+    glBindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffersVBO[1]);
+
+    // the shaders of the triangles commands expect vertices in view space and only apply the projection,
+    // so the transform of the node goes into the projection
+    _director->pushMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION);
+    _director->multiplyMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION, transform);
+
+    for (const auto& segment : _segments)
+    {
+        GL::bindTexture2D(segment.textureID);
+        if (segment.alphaTextureID > 0)
+        {
+            GL::bindTexture2DN(1, segment.alphaTextureID);
+        }
+        GL::blendFunc(segment.blendFunc.src, segment.blendFunc.dst);
+        segment.glProgramState->apply(transform);
+
+        intptr_t vertexOffset = segment.firstVertex * sizeof(V3F_C4B_T2F);
+        glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 3, GL_FLOAT, GL_FALSE, sizeof(V3F_C4B_T2F), (GLvoid*)(vertexOffset + offsetof(V3F_C4B_T2F, vertices)));
+        glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(V3F_C4B_T2F), (GLvoid*)(vertexOffset + offsetof(V3F_C4B_T2F, colors)));
+        glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORD, 2, GL_FLOAT, GL_FALSE, sizeof(V3F_C4B_T2F), (GLvoid*)(vertexOffset + offsetof(V3F_C4B_T2F, texCoords)));
+
+        glDrawElements(GL_TRIANGLES, (GLsizei)segment.indexCount, GL_UNSIGNED_SHORT, (GLvoid*)(segment.firstIndex * sizeof(GLushort)));
+        CC_INCREMENT_GL_DRAWN_BATCHES_AND_VERTICES(1, segment.indexCount);
+    }
+
+    _director->popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION);
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    CHECK_GL_ERROR_DEBUG();
+}
+
+NS_CC_END
@@ -0,0 +1,143 @@
+/****************************************************************************
+Copyright (c) 2017 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+
+#ifndef __CCSTATIC_BATCH_NODE_H__
+#define __CCSTATIC_BATCH_NODE_H__
+
+#include "2d/CCNode.h"
+#include "renderer/CCCustomCommand.h"
+
+NS_CC_BEGIN
+
+class GLProgramState;
+class RenderQueue;
+
+/**
+ * @addtogroup _2d
+ * @{
+ */
+
+/** @class StaticBatchNode
+ * @brief A node that draws a subtree that doesn't change with one draw call per material.
+
+The children are visited once, their triangles are copied into a vertex buffer and an index buffer kept on the
+GPU, and the following frames only draw these buffers, without visiting the subtree again. The consecutive
+triangles sharing a texture, a blend function and a GLProgramState are drawn together. The node itself can be
+moved, scaled or rotated freely, the buffers are relative to it.
+
+The subtree is recorded again at the next visit after markDirty(). It's called for you when a child is added,
+removed or reordered and when the displayed color or opacity of the node changes, but not when a descendant is
+modified: call it after changing the position or the frame of a child.
+
+The subtree must only use `TrianglesCommand`s and `QuadCommand`s with the global z-order 0, like the sprites and
+the labels do. Otherwise the node logs it and visits its children every frame, like a Node. The children are
+recorded with the camera visiting the node at that time, and they aren't culled one by one.
+@since v3.14
+*/
+class CC_DLL StaticBatchNode : public Node
+{
+public:
+    /** Creates an empty static batch node.
+     *
+     * @return An autoreleased StaticBatchNode object.
+     */
+    static StaticBatchNode* create();
+
+    /** Records the children again at the next visit. */
+    void markDirty() { _dirty = true; }
+
+    /** Whether or not the children will be recorded again at the next visit. */
+    bool isDirty() const { return _dirty; }
+
+    /** Whether or not the last recording succeeded, the children are visited every frame otherwise. */
+    bool isRecorded() const { return _recorded; }
+
+    /** Returns the number of draw calls of the recorded children. */
+    ssize_t getDrawCallCount() const { return _segments.size(); }
+
+    //
+    // Overrides
+    //
+    virtual void visit(Renderer *renderer, const Mat4 &parentTransform, uint32_t parentFlags) override;
+    virtual void draw(Renderer *renderer, const Mat4 &transform, uint32_t flags) override;
+    using Node::addChild;
+    virtual void addChild(Node *child, int localZOrder, int tag) override;
+    virtual void addChild(Node *child, int localZOrder, const std::string &name) override;
+    virtual void removeChild(Node *child, bool cleanup = true) override;
+    virtual void removeAllChildrenWithCleanup(bool cleanup) override;
+    virtual void reorderChild(Node *child, int localZOrder) override;
+    virtual void updateDisplayedOpacity(GLubyte parentOpacity) override;
+    virtual void updateDisplayedColor(const Color3B& parentColor) override;
+
+CC_CONSTRUCTOR_ACCESS:
+    StaticBatchNode();
+    virtual ~StaticBatchNode();
+
+    virtual bool init() override;
+
+protected:
+    // consecutive triangles drawn with the same material
+    struct Segment
+    {
+        GLuint textureID;
+        GLuint alphaTextureID;
+        GLProgramState* glProgramState;
+        BlendFunc blendFunc;
+        uint32_t materialID;
+        // the indices are relative to the first vertex, so a segment can use 16 bits indices
+        ssize_t firstVertex;
+        ssize_t firstIndex;
+        ssize_t indexCount;
+    };
+
+    void record(Renderer* renderer);
+    // copies the triangles of the commands, returns false if a command can't be batched
+    bool copyCommands(RenderQueue& queue);
+    void clearSegments();
+    void uploadBuffers();
+    void releaseBuffers();
+    void onDraw(const Mat4& transform, uint32_t flags);
+
+    std::vector<Segment> _segments;
+    std::vector<V3F_C4B_T2F> _vertices;
+    std::vector<GLushort> _indices;
+    // the bounding box of the vertices, to cull the whole batch
+    Rect _bounds;
+    GLuint _buffersVBO[2];
+    bool _buffersDirty;
+    bool _dirty;
+    bool _recorded;
+    CustomCommand _customCommand;
+
+private:
+    CC_DISALLOW_COPY_AND_ASSIGN(StaticBatchNode);
+};
+
+// end of _2d group
+/// @}
+
+NS_CC_END
+
+#endif //__CCSTATIC_BATCH_NODE_H__
@@ -0,0 +1,360 @@
+/****************************************************************************
+Copyright (c) 2017 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#include "2d/CCTMXTileStore.h"
+
+#include <algorithm>
+#include <zlib.h>
+
+#include "2d/CCTMXXMLParser.h"
+#include "platform/CCFileUtils.h"
+
+NS_CC_BEGIN
+
+/*
+ * The file is made of little endian 32 bits integers:
+ *   'CCTS', version, chunk size, layer count
+ *   for each layer: name length, name bytes, width, height, then an offset and a size per chunk, row by row
+ *   the zlib compressed chunks, chunk size * chunk size gids each, rows from the top one
+ * Like the base64 data of TMX files, the gids are stored in the byte order of the device.
+ */
+static const uint32_t TILE_STORE_MAGIC = 0x53544343; // "CCTS"
+static const uint32_t TILE_STORE_VERSION = 1;
+
+// the chunk index of a layer is in the low bits of the cache keys
+static const int CACHE_KEY_LAYER_SHIFT = 24;
+
+static void writeUInt32(std::vector<unsigned char>& out, uint32_t value)
+{
+    for (int i = 0; i < 4; ++i)
+    {
+        out.push_back((unsigned char)(value >> (i * 8)));
+    }
+}
+
+static bool readUInt32(const Data& data, ssize_t& offset, uint32_t* value)
+{
+    if (offset + 4 > data.getSize())
+        return false;
+
+    const unsigned char* bytes = data.getBytes() + offset;
+    *value = bytes[0] | (bytes[1] << 8) | (bytes[2] << 16) | ((uint32_t)bytes[3] << 24);
+    offset += 4;
+    return true;
+}
+
+TMXTileStore* TMXTileStore::create(const std::string& filename)
+{
+    auto ret = new (std::nothrow) TMXTileStore();
+    if (ret && ret->initWithFile(filename))
+    {
+        ret->autorelease();
+        return ret;
+    }
+    CC_SAFE_DELETE(ret);
+    return nullptr;
+}
+
+bool TMXTileStore::writeToFile(TMXMapInfo* mapInfo, const std::string& fullPath, int chunkSize)
+{
+    CCASSERT(mapInfo, "TMXTileStore: mapInfo should not be null");
+    CCASSERT(chunkSize > 0, "TMXTileStore: invalid chunk size");
+
+    struct LayerRecord
+    {
+        std::string name;
+        int width;
+        int height;
+        std::vector<ChunkEntry> chunks;
+    };
+    std::vector<LayerRecord> records;
+    std::vector<unsigned char> body;
+
+    std::vector<uint32_t> chunk(chunkSize * chunkSize);
+    std::vector<unsigned char> compressed(compressBound((uLong)(chunk.size() * sizeof(uint32_t))));
+    for (auto layerInfo : mapInfo->getLayers())
+    {
+        LayerRecord record;
+        record.name = layerInfo->_name;
+        record.width = (int)layerInfo->_layerSize.width;
+        record.height = (int)layerInfo->_layerSize.height;
+        const int columns = (record.width + chunkSize - 1) / chunkSize;
+        const int rows = (record.height + chunkSize - 1) / chunkSize;
+        CCASSERT(columns * rows < (1 << CACHE_KEY_LAYER_SHIFT), "TMXTileStore: too many chunks, use bigger ones");
+        record.chunks.resize(columns * rows);
+
+        const uint32_t* tiles = layerInfo->getTiles();
+        if (tiles == nullptr)
+        {
+            CCLOG("cocos2d: TMXTileStore: layer '%s' has no tiles", layerInfo->_name.c_str());
+        }
+
+        for (int row = 0; row < rows && tiles; ++row)
+        {
+            for (int column = 0; column < columns; ++column)
+            {
+                bool empty = true;
+                std::fill(chunk.begin(), chunk.end(), 0);
+                for (int y = 0; y < chunkSize && row * chunkSize + y < record.height; ++y)
+                {
+                    for (int x = 0; x < chunkSize && column * chunkSize + x < record.width; ++x)
+                    {
+                        uint32_t gid = tiles[(row * chunkSize + y) * record.width + column * chunkSize + x];
+                        chunk[y * chunkSize + x] = gid;
+                        empty &= gid == 0;
+                    }
+                }
+                if (empty)
+                    continue;
+
+                uLongf size = (uLongf)compressed.size();
+                if (compress2(compressed.data(), &size, (const Bytef*)chunk.data(), (uLong)(chunk.size() * sizeof(uint32_t)), Z_BEST_COMPRESSION) != Z_OK)
+                {
+                    CCLOG("cocos2d: TMXTileStore: can't compress the tiles of '%s'", layerInfo->_name.c_str());
+                    return false;
+                }
+
+                // from the start of the chunks until the size of the index is known
+                auto& entry = record.chunks[row * columns + column];
+                entry.offset = (uint32_t)body.size();
+                entry.size = (uint32_t)size;
+                body.insert(body.end(), compressed.begin(), compressed.begin() + size);
+            }
+        }
+
+        // the tiles of lazily decoded layers are only needed for the conversion
+        layerInfo->releaseTiles();
+        records.push_back(std::move(record));
+    }
+
+    size_t indexSize = 16;
+    for (auto& record : records)
+    {
+        indexSize += 12 + record.name.size() + record.chunks.size() * 8;
+    }
+
+    std::vector<unsigned char> file;
+    file.reserve(indexSize + body.size());
+    writeUInt32(file, TILE_STORE_MAGIC);
+    writeUInt32(file, TILE_STORE_VERSION);
+    writeUInt32(file, (uint32_t)chunkSize);
+    writeUInt32(file, (uint32_t)records.size());
+    for (auto& record : records)
+    {
+        writeUInt32(file, (uint32_t)record.name.size());
+        file.insert(file.end(), record.name.begin(), record.name.end());
+        writeUInt32(file, (uint32_t)record.width);
+        writeUInt32(file, (uint32_t)record.height);
+        for (auto& entry : record.chunks)
+        {
+            writeUInt32(file, entry.size ? (uint32_t)indexSize + entry.offset : 0);
+            writeUInt32(file, entry.size);
+        }
+    }
+    file.insert(file.end(), body.begin(), body.end());
+
+    Data data;
+    data.copy(file.data(), file.size());
+    return FileUtils::getInstance()->writeDataToFile(data, fullPath);
+}
+
+TMXTileStore::TMXTileStore()
+: _chunkSize(0)
+, _cacheLimit(DEFAULT_CACHE_LIMIT)
+, _useCount(0)
+{
+}
+
+TMXTileStore::~TMXTileStore()
+{
+}
+
+bool TMXTileStore::initWithFile(const std::string& filename)
+{
+    _data = FileUtils::getInstance()->getDataFromFile(filename);
+    if (_data.isNull())
+    {
+        CCLOG("cocos2d: TMXTileStore: can't read '%s'", filename.c_str());
+        return false;
+    }
+
+    ssize_t offset = 0;
+    uint32_t magic = 0, version = 0, chunkSize = 0, layerCount = 0;
+    if (!readUInt32(_data, offset, &magic) || magic != TILE_STORE_MAGIC
+        || !readUInt32(_data, offset, &version) || version != TILE_STORE_VERSION
+        || !readUInt32(_data, offset, &chunkSize) || chunkSize == 0
+        || !readUInt32(_data, offset, &layerCount))
+    {
+        CCLOG("cocos2d: TMXTileStore: '%s' isn't a tile store", filename.c_str());
+        return false;
+    }
+    _chunkSize = (int)chunkSize;
+
+    for (uint32_t i = 0; i < layerCount; ++i)
+    {
+        Layer layer;
+        uint32_t nameLength = 0, width = 0, height = 0;
+        if (!readUInt32(_data, offset, &nameLength) || offset + nameLength > _data.getSize())
+            return false;
+        layer.name.assign((const char*)_data.getBytes() + offset, nameLength);
+        offset += nameLength;
+
+        if (!readUInt32(_data, offset, &width) || !readUInt32(_data, offset, &height))
+            return false;
+        layer.width = (int)width;
+        layer.height = (int)height;
+        layer.chunkColumns = (layer.width + _chunkSize - 1) / _chunkSize;
+
+        const int chunkCount = layer.chunkColumns * ((layer.height + _chunkSize - 1) / _chunkSize);
+        layer.chunks.resize(chunkCount);
+        for (auto& entry : layer.chunks)
+        {
+            if (!readUInt32(_data, offset, &entry.offset) || !readUInt32(_data, offset, &entry.size)
+                || (ssize_t)entry.offset + entry.size > _data.getSize())
+            {
+                CCLOG("cocos2d: TMXTileStore: '%s' is truncated", filename.c_str());
+                return false;
+            }
+        }
+        _layers.push_back(layer);
+    }
+    return true;
+}
+
+int TMXTileStore::getLayerIndex(const std::string& layerName) const
+{
+    for (size_t i = 0; i < _layers.size(); ++i)
+    {
+        if (_layers[i].name == layerName)
+            return (int)i;
+    }
+    return -1;
+}
+
+const std::string& TMXTileStore::getLayerName(int layer) const
+{
+    CCASSERT(layer >= 0 && layer < (int)_layers.size(), "TMXTileStore: invalid layer");
+    return _layers[layer].name;
+}
+
+Size TMXTileStore::getLayerSize(int layer) const
+{
+    CCASSERT(layer >= 0 && layer < (int)_layers.size(), "TMXTileStore: invalid layer");
+    return Size((float)_layers[layer].width, (float)_layers[layer].height);
+}
+
+const uint32_t* TMXTileStore::getChunk(int layer, int chunk)
+{
+    auto& entry = _layers[layer].chunks[chunk];
+    if (entry.size == 0)
+        return nullptr;
+
+    const uint32_t key = ((uint32_t)layer << CACHE_KEY_LAYER_SHIFT) | (uint32_t)chunk;
+    auto iter = _cache.find(key);
+    if (iter != _cache.end())
+    {
+        iter->second.lastUse = ++_useCount;
+        return iter->second.tiles.data();
+    }
+
+    trimCache(_cacheLimit - 1);
+
+    Chunk decoded;
+    decoded.tiles.resize(_chunkSize * _chunkSize);
+    decoded.lastUse = ++_useCount;
+    uLongf size = (uLongf)(decoded.tiles.size() * sizeof(uint32_t));
+    if (uncompress((Bytef*)decoded.tiles.data(), &size, _data.getBytes() + entry.offset, entry.size) != Z_OK)
+    {
+        CCLOG("cocos2d: TMXTileStore: can't inflate chunk %d of layer '%s'", chunk, _layers[layer].name.c_str());
+        entry.size = 0;
+        return nullptr;
+    }
+    return _cache.emplace(key, std::move(decoded)).first->second.tiles.data();
+}
+
+void TMXTileStore::trimCache(ssize_t size)
+{
+    while ((ssize_t)_cache.size() > std::max(size, (ssize_t)0))
+    {
+        auto oldest = _cache.begin();
+        for (auto iter = _cache.begin(); iter != _cache.end(); ++iter)
+        {
+            if (iter->second.lastUse < oldest->second.lastUse)
+                oldest = iter;
+        }
+        _cache.erase(oldest);
+    }
+}
+
+void TMXTileStore::setCacheLimit(int chunkCount)
+{
+    _cacheLimit = std::max(chunkCount, 1);
+    trimCache(_cacheLimit);
+}
+
+uint32_t TMXTileStore::getTileGIDAt(int layer, int x, int y)
+{
+    CCASSERT(layer >= 0 && layer < (int)_layers.size(), "TMXTileStore: invalid layer");
+
+    auto& info = _layers[layer];
+    if (x < 0 || y < 0 || x >= info.width || y >= info.height)
+        return 0;
+
+    auto tiles = getChunk(layer, (y / _chunkSize) * info.chunkColumns + x / _chunkSize);
+    return tiles ? tiles[(y % _chunkSize) * _chunkSize + x % _chunkSize] : 0;
+}
+
+void TMXTileStore::getTiles(int layer, int x, int y, int width, int height, uint32_t* tiles)
+{
+    CCASSERT(layer >= 0 && layer < (int)_layers.size(), "TMXTileStore: invalid layer");
+
+    auto& info = _layers[layer];
+    std::fill(tiles, tiles + width * height, 0);
+
+    const int left = std::max(x, 0);
+    const int top = std::max(y, 0);
+    const int right = std::min(x + width, info.width);
+    const int bottom = std::min(y + height, info.height);
+
+    // one chunk at a time, so each of them is looked up once
+    for (int chunkTop = top - top % _chunkSize; chunkTop < bottom; chunkTop += _chunkSize)
+    {
+        for (int chunkLeft = left - left % _chunkSize; chunkLeft < right; chunkLeft += _chunkSize)
+        {
+            auto chunk = getChunk(layer, (chunkTop / _chunkSize) * info.chunkColumns + chunkLeft / _chunkSize);
+            if (chunk == nullptr)
+                continue;
+
+            const int fromX = std::max(left, chunkLeft);
+            const int toX = std::min(right, chunkLeft + _chunkSize);
+            for (int row = std::max(top, chunkTop); row < std::min(bottom, chunkTop + _chunkSize); ++row)
+            {
+                const uint32_t* src = chunk + (row - chunkTop) * _chunkSize + (fromX - chunkLeft);
+                std::copy(src, src + (toX - fromX), tiles + (row - y) * width + (fromX - x));
+            }
+        }
+    }
+}
+
+NS_CC_END
@@ -0,0 +1,160 @@
+/****************************************************************************
+Copyright (c) 2017 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#ifndef __CCTMX_TILE_STORE_H__
+#define __CCTMX_TILE_STORE_H__
+
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "base/CCRef.h"
+#include "base/CCData.h"
+#include "math/CCGeometry.h"
+
+NS_CC_BEGIN
+
+class TMXMapInfo;
+
+/**
+ * @addtogroup _2d
+ * @{
+ */
+
+/** @class TMXTileStore
+ * @brief The tiles of the layers of a map in a compact binary file, decoded by region when they are needed.
+ *
+ * The layers are cut in square chunks compressed separately, so reading some tiles only inflates the chunks
+ * they are in. The decoded chunks are kept in a cache of limited size, the least recently used ones are
+ * freed first, so the memory used depends on the area being read rather than on the size of the map.
+ *
+ * The file is written from a TMX file by writeToFile(), e.g. by a tool at build time. The tilesets and the
+ * objects of the map stay in the TMX file, TMXMapInfo::createWithLazyTiles() reads them without decoding
+ * the tiles.
+ * @since v3.14
+ */
+class CC_DLL TMXTileStore : public Ref
+{
+public:
+    static const int DEFAULT_CHUNK_SIZE = 32;
+    static const int DEFAULT_CACHE_LIMIT = 64;
+
+    /** Opens a file written by writeToFile(), only its index is read.
+     *
+     * @return An autoreleased TMXTileStore, or nullptr if the file can't be read.
+     */
+    static TMXTileStore* create(const std::string& filename);
+
+    /** Writes the tile layers of a map. The layers of a map created by TMXMapInfo::createWithLazyTiles()
+     * are decoded one at a time.
+     *
+     * @param mapInfo The map.
+     * @param fullPath The path of the file to write.
+     * @param chunkSize The width and height of the chunks in tiles.
+     * @return Whether the file was written.
+     */
+    static bool writeToFile(TMXMapInfo* mapInfo, const std::string& fullPath, int chunkSize = DEFAULT_CHUNK_SIZE);
+
+    int getChunkSize() const { return _chunkSize; }
+
+    int getLayerCount() const { return (int)_layers.size(); }
+    /** Returns the index of a layer, -1 if there is none with this name.*/
+    int getLayerIndex(const std::string& layerName) const;
+    const std::string& getLayerName(int layer) const;
+    /** The size of a layer in tiles.*/
+    Size getLayerSize(int layer) const;
+
+    /** Returns the gid of a tile with its flip flags, 0 if it's empty or outside the layer.
+     *
+     * @param layer The index of the layer.
+     * @param x The column of the tile.
+     * @param y The row of the tile, from the top one.
+     */
+    uint32_t getTileGIDAt(int layer, int x, int y);
+
+    /** Copies the gids of a region, the row at the top first. The tiles outside the layer are 0.
+     *
+     * @param tiles width * height gids.
+     */
+    void getTiles(int layer, int x, int y, int width, int height, uint32_t* tiles);
+
+    /** Sets the number of decoded chunks kept in memory, DEFAULT_CACHE_LIMIT by default.*/
+    void setCacheLimit(int chunkCount);
+    int getCacheLimit() const { return _cacheLimit; }
+
+    /** The number of chunks in the cache.*/
+    ssize_t getDecodedChunkCount() const { return (ssize_t)_cache.size(); }
+    /** Frees all the decoded chunks.*/
+    void releaseChunks() { _cache.clear(); }
+
+CC_CONSTRUCTOR_ACCESS:
+    TMXTileStore();
+    virtual ~TMXTileStore();
+
+    bool initWithFile(const std::string& filename);
+
+protected:
+    struct ChunkEntry
+    {
+        /** 0 for a chunk without tiles */
+        uint32_t offset;
+        uint32_t size;
+    };
+
+    struct Layer
+    {
+        std::string name;
+        int width;
+        int height;
+        int chunkColumns;
+        std::vector<ChunkEntry> chunks;
+    };
+
+    struct Chunk
+    {
+        std::vector<uint32_t> tiles;
+        unsigned int lastUse;
+    };
+
+    /** Returns the decoded gids of a chunk, nullptr if it's empty.*/
+    const uint32_t* getChunk(int layer, int chunk);
+    void trimCache(ssize_t size);
+
+    Data _data;
+    int _chunkSize;
+    std::vector<Layer> _layers;
+    std::unordered_map<uint32_t, Chunk> _cache;
+    int _cacheLimit;
+    unsigned int _useCount;
+
+private:
+    CC_DISALLOW_COPY_AND_ASSIGN(TMXTileStore);
+};
+
+// end of _2d group
+/// @}
+
+NS_CC_END
+
+#endif //__CCTMX_TILE_STORE_H__
@@ -0,0 +1,708 @@
+/****************************************************************************
+Copyright (c) 2017 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#include "2d/CCTMXTiledMapGPU.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "2d/CCTMXTiledMap.h"
+#include "renderer/CCDynamicTexture.h"
+#include "renderer/CCGLProgram.h"
+#include "renderer/CCGLProgramCache.h"
+#include "renderer/CCRenderer.h"
+#include "renderer/CCTextureCache.h"
+#include "renderer/ccGLStateCache.h"
+#include "base/CCConfiguration.h"
+#include "base/CCDirector.h"
+#include "base/CCEventType.h"
+#include "base/CCEventListenerCustom.h"
+#include "base/CCEventDispatcher.h"
+#include "base/ccUTF8.h"
+
+NS_CC_BEGIN
+
+static const char* s_tmxTiledMapGPUKey = "TMXTiledMapGPU";
+
+static const char* s_tmxTiledMapGPUVert = R"(
+attribute vec4 a_position;
+attribute vec2 a_texCoord;
+
+#ifdef GL_ES
+varying highp vec2 v_tile;
+#else
+varying vec2 v_tile;
+#endif
+
+void main()
+{
+    gl_Position = CC_MVPMatrix * a_position;
+    v_tile = a_texCoord;
+}
+)";
+
+// v_tile is the position in tiles from the top left corner of the map
+static const char* s_tmxTiledMapGPUFrag = R"(
+#ifdef GL_ES
+#ifdef GL_FRAGMENT_PRECISION_HIGH
+precision highp float;
+#else
+precision mediump float;
+#endif
+#endif
+
+varying vec2 v_tile;
+
+uniform sampler2D u_tiles;
+uniform sampler2D u_animation;
+// width and height in tiles, layer count, 1 if the tileset has premultiplied alpha
+uniform vec4 u_map;
+uniform vec2 u_animationSize;
+uniform vec4 u_layerOpacities;
+// width and height of the tileset in pixels, tile columns
+uniform vec3 u_tileset;
+// margin, spacing, tile width and height in pixels
+uniform vec4 u_tilesetLayout;
+uniform vec4 u_color;
+
+float decodeIndex(vec4 texel)
+{
+    return floor(texel.r * 255.0 + 0.5) + floor(texel.g * 255.0 + 0.5) * 256.0;
+}
+
+void main()
+{
+    vec2 cell = floor(v_tile);
+    vec2 halfTexel = 0.5 / u_tilesetLayout.zw;
+    vec4 result = vec4(0.0);
+
+    for (int i = 0; i < 4; ++i)
+    {
+        if (float(i) >= u_map.z)
+            break;
+
+        vec2 uv = vec2((cell.x + 0.5) / u_map.x, (float(i) * u_map.y + cell.y + 0.5) / (u_map.y * u_map.z));
+        vec4 texel = texture2D(u_tiles, uv);
+        float index = decodeIndex(texel);
+        if (index > 0.5)
+        {
+            index -= 1.0;
+            vec2 frame = vec2(mod(index, u_animationSize.x), floor(index / u_animationSize.x));
+            index = decodeIndex(texture2D(u_animation, (frame + 0.5) / u_animationSize));
+
+            // undoes Tiled's diagonal, horizontal then vertical flips
+            float flags = floor(texel.b * 255.0 + 0.5);
+            vec2 t = v_tile - cell;
+            if (mod(floor(flags / 2.0), 2.0) > 0.5)
+                t.y = 1.0 - t.y;
+            if (mod(flags, 2.0) > 0.5)
+                t.x = 1.0 - t.x;
+            if (flags > 3.5)
+                t = t.yx;
+            t = clamp(t, halfTexel, 1.0 - halfTexel);
+
+            vec2 tile = vec2(mod(index, u_tileset.z), floor(index / u_tileset.z));
+            vec2 pixel = u_tilesetLayout.xx + tile * (u_tilesetLayout.zw + u_tilesetLayout.yy) + t * u_tilesetLayout.zw;
+            vec4 color = texture2D(CC_Texture0, pixel / u_tileset.xy);
+            color.rgb = mix(color.rgb * color.a, color.rgb, u_map.w);
+            color *= texel.a * u_layerOpacities[i];
+
+            result = color + result * (1.0 - color.a);
+        }
+    }
+
+    gl_FragColor = u_color * result;
+}
+)";
+
+// the flip flags of a tile, in the blue component of its texel
+static const unsigned char TILE_FLAG_HORIZONTAL = 1;
+static const unsigned char TILE_FLAG_VERTICAL = 2;
+static const unsigned char TILE_FLAG_DIAGONAL = 4;
+
+static const int MAX_TILESET_TILES = 65535;
+static const int ANIMATION_TEXTURE_WIDTH = 256;
+
+static void encodeIndex(unsigned char* texel, int index)
+{
+    texel[0] = (unsigned char)(index & 0xff);
+    texel[1] = (unsigned char)(index >> 8);
+}
+
+static int decodeIndex(const unsigned char* texel)
+{
+    return texel[0] | (texel[1] << 8);
+}
+
+// the same choice as TMXTiledMap::tilesetForLayer()
+static TMXTilesetInfo* tilesetForLayer(TMXLayerInfo* layerInfo, TMXMapInfo* mapInfo)
+{
+    auto count = static_cast<uint32_t>(layerInfo->_layerSize.width * layerInfo->_layerSize.height);
+    auto& tilesets = mapInfo->getTilesets();
+
+    for (auto iter = tilesets.crbegin(), end = tilesets.crend(); iter != end; ++iter)
+    {
+        TMXTilesetInfo* tileset = *iter;
+        for (uint32_t i = 0; i < count; ++i)
+        {
+            auto gid = layerInfo->_tiles[i];
+            if (gid != 0 && (tileset->_firstGid < 0 || (gid & kTMXFlippedMask) >= static_cast<uint32_t>(tileset->_firstGid)))
+                return tileset;
+        }
+    }
+    return nullptr;
+}
+
+TMXTiledMapGPU* TMXTiledMapGPU::create(const std::string& tmxFile)
+{
+    auto ret = new (std::nothrow) TMXTiledMapGPU();
+    if (ret && ret->initWithTMXFile(tmxFile))
+    {
+        ret->autorelease();
+        return ret;
+    }
+    CC_SAFE_DELETE(ret);
+    return nullptr;
+}
+
+TMXTiledMapGPU::TMXTiledMapGPU()
+: _animationTime(0)
+, _animationSpeed(1)
+, _vbo(0)
+, _uniformTiles(-1)
+, _uniformAnimation(-1)
+, _uniformMap(-1)
+, _uniformAnimationSize(-1)
+, _uniformLayerOpacities(-1)
+, _uniformTileset(-1)
+, _uniformTilesetLayout(-1)
+, _uniformColor(-1)
+{
+}
+
+TMXTiledMapGPU::~TMXTiledMapGPU()
+{
+    for (auto group : _groups)
+    {
+        CC_SAFE_RELEASE(group->tileset);
+        CC_SAFE_RELEASE(group->texture);
+        CC_SAFE_RELEASE(group->tiles);
+        CC_SAFE_RELEASE(group->animation);
+        delete group;
+    }
+    if (_vbo)
+    {
+        glDeleteBuffers(1, &_vbo);
+    }
+}
+
+bool TMXTiledMapGPU::initWithTMXFile(const std::string& tmxFile)
+{
+    CCASSERT(!tmxFile.empty(), "TMXTiledMapGPU: tmx file should not be empty");
+
+    auto mapInfo = TMXMapInfo::create(tmxFile);
+    if (!mapInfo)
+        return false;
+
+    if (mapInfo->getOrientation() != TMXOrientationOrtho)
+    {
+        CCLOG("cocos2d: TMXTiledMapGPU: '%s' isn't an orthogonal map, use TMXTiledMap", tmxFile.c_str());
+        return false;
+    }
+
+    _mapSize = mapInfo->getMapSize();
+    _tileSize = mapInfo->getTileSize();
+    if (_mapSize.width > Configuration::getInstance()->getMaxTextureSize())
+    {
+        CCLOG("cocos2d: TMXTiledMapGPU: '%s' is too wide", tmxFile.c_str());
+        return false;
+    }
+
+    std::vector<TMXLayerInfo*> layerInfos;
+    Group* group = nullptr;
+    for (auto layerInfo : mapInfo->getLayers())
+    {
+        if (layerInfo->_layerSize.width != _mapSize.width || layerInfo->_layerSize.height != _mapSize.height)
+        {
+            CCLOG("cocos2d: TMXTiledMapGPU: layer '%s' isn't the size of the map, skipped", layerInfo->_name.c_str());
+            continue;
+        }
+
+        auto tileset = tilesetForLayer(layerInfo, mapInfo);
+        if (tileset == nullptr)
+        {
+            CCLOG("cocos2d: TMXTiledMapGPU: layer '%s' has no tiles, skipped", layerInfo->_name.c_str());
+            continue;
+        }
+        if (!tileset->_tileSize.equals(_tileSize))
+        {
+            CCLOG("cocos2d: TMXTiledMapGPU: the tiles of layer '%s' aren't the size of the map's, skipped", layerInfo->_name.c_str());
+            continue;
+        }
+        if (!layerInfo->_offset.isZero())
+        {
+            CCLOG("cocos2d: TMXTiledMapGPU: the offset of layer '%s' is ignored", layerInfo->_name.c_str());
+        }
+
+        if (group == nullptr || group->tileset != tileset || (int)group->layers.size() == MAX_LAYERS_PER_DRAW)
+        {
+            if (group && !createTiles(group, layerInfos))
+                return false;
+            layerInfos.clear();
+
+            group = createGroup(tileset, mapInfo);
+            if (group == nullptr)
+                return false;
+            _groups.push_back(group);
+        }
+
+        Layer layer;
+        layer.name = layerInfo->_name;
+        layer.group = group;
+        layer.slot = (int)group->layers.size();
+        layer.opacity = layerInfo->_opacity;
+        layer.visible = layerInfo->_visible;
+        group->layers.push_back((int)_layers.size());
+        _layers.push_back(layer);
+        layerInfos.push_back(layerInfo);
+    }
+    if (group && !createTiles(group, layerInfos))
+        return false;
+
+    setContentSize(CC_SIZE_PIXELS_TO_POINTS(Size(_mapSize.width * _tileSize.width, _mapSize.height * _tileSize.height)));
+
+    initGLProgram();
+    setupBuffer();
+
+    for (auto g : _groups)
+    {
+        if (!g->animations.empty())
+        {
+            scheduleUpdate();
+            break;
+        }
+    }
+
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+    auto listener = EventListenerCustom::create(EVENT_RENDERER_RECREATED, CC_CALLBACK_1(TMXTiledMapGPU::listenRendererRecreated, this));
+    _eventDispatcher->addEventListenerWithSceneGraphPriority(listener, this);
+#endif
+
+    return true;
+}
+
+TMXTiledMapGPU::Group* TMXTiledMapGPU::createGroup(TMXTilesetInfo* tileset, TMXMapInfo* mapInfo)
+{
+    auto texture = Director::getInstance()->getTextureCache()->addImage(tileset->_sourceImage);
+    if (texture == nullptr)
+    {
+        CCLOG("cocos2d: TMXTiledMapGPU: can't load '%s'", tileset->_sourceImage.c_str());
+        return nullptr;
+    }
+
+    // the same layout as TMXTilesetInfo::getRectForGID()
+    const int columns = (int)((tileset->_imageSize.width - tileset->_margin * 2 + tileset->_spacing) / (tileset->_tileSize.width + tileset->_spacing));
+    const int rows = (int)((tileset->_imageSize.height - tileset->_margin * 2 + tileset->_spacing) / (tileset->_tileSize.height + tileset->_spacing));
+    const int tileCount = std::min(std::max(columns, 1) * std::max(rows, 1), MAX_TILESET_TILES);
+
+    const int animationWidth = std::min(tileCount, ANIMATION_TEXTURE_WIDTH);
+    const int animationHeight = (tileCount + animationWidth - 1) / animationWidth;
+    auto animation = DynamicTexture::create(animationWidth, animationHeight);
+    if (animation == nullptr)
+        return nullptr;
+
+    Texture2D::TexParams texParams = { GL_NEAREST, GL_NEAREST, GL_CLAMP_TO_EDGE, GL_CLAMP_TO_EDGE };
+    animation->setTexParameters(texParams);
+
+    // every tile shows itself until its animation starts
+    for (int i = 0; i < tileCount; ++i)
+    {
+        encodeIndex(animation->getPixels() + (i / animationWidth) * animation->getBytesPerRow() + (i % animationWidth) * 4, i);
+    }
+    animation->markAllDirty();
+
+    auto group = new (std::nothrow) Group();
+    group->tileset = tileset;
+    group->texture = texture;
+    group->tileCount = tileCount;
+    group->columns = std::max(columns, 1);
+    group->tiles = nullptr;
+    group->animation = animation;
+    tileset->retain();
+    texture->retain();
+    animation->retain();
+
+    for (auto& entry : mapInfo->getTileAnimations())
+    {
+        const int tile = (int)entry.first - tileset->_firstGid;
+        if (tile < 0 || tile >= tileCount || entry.second.empty())
+            continue;
+
+        TileAnimation tileAnimation;
+        tileAnimation.tile = tile;
+        tileAnimation.currentFrame = 0;
+        float end = 0;
+        for (auto& frame : entry.second)
+        {
+            const int frameTile = (int)frame.gid - tileset->_firstGid;
+            if (frameTile < 0 || frameTile >= tileCount)
+                continue;
+            end += frame.duration;
+            tileAnimation.frameTiles.push_back(frameTile);
+            tileAnimation.frameEnds.push_back(end);
+        }
+        if (tileAnimation.frameTiles.size() > 1 && end > 0)
+        {
+            encodeIndex(animation->getPixels() + (tile / animationWidth) * animation->getBytesPerRow() + (tile % animationWidth) * 4, tileAnimation.frameTiles[0]);
+            group->animations.push_back(tileAnimation);
+        }
+    }
+
+    return group;
+}
+
+bool TMXTiledMapGPU::createTiles(Group* group, const std::vector<TMXLayerInfo*>& layerInfos)
+{
+    const int width = (int)_mapSize.width;
+    const int height = (int)_mapSize.height;
+    const int textureHeight = height * (int)layerInfos.size();
+    if (textureHeight > Configuration::getInstance()->getMaxTextureSize())
+    {
+        CCLOG("cocos2d: TMXTiledMapGPU: the map is too tall");
+        return false;
+    }
+
+    auto tiles = DynamicTexture::create(width, textureHeight);
+    if (tiles == nullptr)
+        return false;
+
+    Texture2D::TexParams texParams = { GL_NEAREST, GL_NEAREST, GL_CLAMP_TO_EDGE, GL_CLAMP_TO_EDGE };
+    tiles->setTexParameters(texParams);
+    group->tiles = tiles;
+    tiles->retain();
+
+    const int firstGid = group->tileset->_firstGid;
+    for (size_t slot = 0; slot < layerInfos.size(); ++slot)
+    {
+        auto layerInfo = layerInfos[slot];
+        bool warned = false;
+        for (int y = 0; y < height; ++y)
+        {
+            unsigned char* texel = tiles->getPixels() + (slot * height + y) * tiles->getBytesPerRow();
+            for (int x = 0; x < width; ++x, texel += 4)
+            {
+                // the opacity of the tile, set even where it's empty for setTileGID()
+                texel[3] = 255;
+
+                const uint32_t gid = layerInfo->_tiles[x + y * width];
+                const int tile = (int)(gid & kTMXFlippedMask) - firstGid;
+                if (gid == 0 || tile < 0 || tile >= group->tileCount)
+                {
+                    if (gid != 0 && !warned)
+                    {
+                        CCLOG("cocos2d: TMXTiledMapGPU: layer '%s' uses more than one tileset, its other tiles are empty", layerInfo->_name.c_str());
+                        warned = true;
+                    }
+                    continue;
+                }
+
+                encodeIndex(texel, tile + 1);
+                texel[2] = ((gid & kTMXTileHorizontalFlag) ? TILE_FLAG_HORIZONTAL : 0)
+                         | ((gid & kTMXTileVerticalFlag) ? TILE_FLAG_VERTICAL : 0)
+                         | ((gid & kTMXTileDiagonalFlag) ? TILE_FLAG_DIAGONAL : 0);
+            }
+        }
+    }
+    tiles->markAllDirty();
+    return true;
+}
+
+void TMXTiledMapGPU::initGLProgram()
+{
+    auto glProgram = GLProgramCache::getInstance()->getGLProgram(s_tmxTiledMapGPUKey);
+    if (glProgram == nullptr)
+    {
+        glProgram = GLProgram::createWithByteArrays(s_tmxTiledMapGPUVert, s_tmxTiledMapGPUFrag);
+        GLProgramCache::getInstance()->addGLProgram(glProgram, s_tmxTiledMapGPUKey);
+    }
+    setGLProgram(glProgram);
+
+    _uniformTiles = glProgram->getUniformLocation("u_tiles");
+    _uniformAnimation = glProgram->getUniformLocation("u_animation");
+    _uniformMap = glProgram->getUniformLocation("u_map");
+    _uniformAnimationSize = glProgram->getUniformLocation("u_animationSize");
+    _uniformLayerOpacities = glProgram->getUniformLocation("u_layerOpacities");
+    _uniformTileset = glProgram->getUniformLocation("u_tileset");
+    _uniformTilesetLayout = glProgram->getUniformLocation("u_tilesetLayout");
+    _uniformColor = glProgram->getUniformLocation("u_color");
+}
+
+void TMXTiledMapGPU::setupBuffer()
+{
+    glDeleteBuffers(1, &_vbo);
+    glGenBuffers(1, &_vbo);
+
+    // position in points and position in tiles from the top left corner, as a triangle strip
+    const Size& size = getContentSize();
+    const GLfloat vertices[] = {
+        0,          0,           0,               _mapSize.height,
+        size.width, 0,           _mapSize.width,  _mapSize.height,
+        0,          size.height, 0,               0,
+        size.width, size.height, _mapSize.width,  0,
+    };
+    glBindBuffer(GL_ARRAY_BUFFER, _vbo);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(vertices), vertices, GL_STATIC_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    CHECK_GL_ERROR_DEBUG();
+}
+
+void TMXTiledMapGPU::listenRendererRecreated(EventCustom* /*event*/)
+{
+    _vbo = 0;
+    setupBuffer();
+
+    auto glProgram = GLProgramCache::getInstance()->getGLProgram(s_tmxTiledMapGPUKey);
+    if (glProgram && glProgram == getGLProgram())
+    {
+        glProgram->reset();
+        glProgram->initWithByteArrays(s_tmxTiledMapGPUVert, s_tmxTiledMapGPUFrag);
+        glProgram->link();
+        glProgram->updateUniforms();
+    }
+    initGLProgram();
+}
+
+int TMXTiledMapGPU::getLayerIndex(const std::string& layerName) const
+{
+    for (size_t i = 0; i < _layers.size(); ++i)
+    {
+        if (_layers[i].name == layerName)
+            return (int)i;
+    }
+    return -1;
+}
+
+const std::string& TMXTiledMapGPU::getLayerName(int layer) const
+{
+    CCASSERT(layer >= 0 && layer < (int)_layers.size(), "TMXTiledMapGPU: invalid layer");
+    return _layers[layer].name;
+}
+
+unsigned char* TMXTiledMapGPU::getTexel(int layer, const Vec2& tileCoordinate) const
+{
+    CCASSERT(layer >= 0 && layer < (int)_layers.size(), "TMXTiledMapGPU: invalid layer");
+    CCASSERT(tileCoordinate.x >= 0 && tileCoordinate.x < _mapSize.width && tileCoordinate.y >= 0 && tileCoordinate.y < _mapSize.height,
+             "TMXTiledMapGPU: invalid position");
+
+    auto& info = _layers[layer];
+    auto tiles = info.group->tiles;
+    const int row = info.slot * (int)_mapSize.height + (int)tileCoordinate.y;
+    return tiles->getPixels() + row * tiles->getBytesPerRow() + (int)tileCoordinate.x * 4;
+}
+
+void TMXTiledMapGPU::markTileDirty(int layer, const Vec2& tileCoordinate)
+{
+    auto& info = _layers[layer];
+    info.group->tiles->markDirty((int)tileCoordinate.x, info.slot * (int)_mapSize.height + (int)tileCoordinate.y, 1, 1);
+}
+
+uint32_t TMXTiledMapGPU::getTileGIDAt(int layer, const Vec2& tileCoordinate, TMXTileFlags* flags) const
+{
+    const unsigned char* texel = getTexel(layer, tileCoordinate);
+    const int index = decodeIndex(texel);
+    if (flags)
+    {
+        int value = 0;
+        if (index != 0)
+        {
+            value |= (texel[2] & TILE_FLAG_HORIZONTAL) ? kTMXTileHorizontalFlag : 0;
+            value |= (texel[2] & TILE_FLAG_VERTICAL) ? kTMXTileVerticalFlag : 0;
+            value |= (texel[2] & TILE_FLAG_DIAGONAL) ? kTMXTileDiagonalFlag : 0;
+        }
+        *flags = (TMXTileFlags)value;
+    }
+    return index == 0 ? 0 : index - 1 + _layers[layer].group->tileset->_firstGid;
+}
+
+void TMXTiledMapGPU::setTileGID(int layer, uint32_t gid, const Vec2& tileCoordinate, TMXTileFlags flags)
+{
+    unsigned char* texel = getTexel(layer, tileCoordinate);
+    const uint32_t allFlags = (gid & kTMXFlipedAll) | (uint32_t)flags;
+    gid &= kTMXFlippedMask;
+
+    if (gid == 0)
+    {
+        encodeIndex(texel, 0);
+        texel[2] = 0;
+    }
+    else
+    {
+        auto group = _layers[layer].group;
+        const int tile = (int)gid - group->tileset->_firstGid;
+        CCASSERT(tile >= 0 && tile < group->tileCount, "TMXTiledMapGPU: invalid gid for the tileset of the layer");
+        if (tile < 0 || tile >= group->tileCount)
+            return;
+
+        encodeIndex(texel, tile + 1);
+        texel[2] = ((allFlags & kTMXTileHorizontalFlag) ? TILE_FLAG_HORIZONTAL : 0)
+                 | ((allFlags & kTMXTileVerticalFlag) ? TILE_FLAG_VERTICAL : 0)
+                 | ((allFlags & kTMXTileDiagonalFlag) ? TILE_FLAG_DIAGONAL : 0);
+    }
+    markTileDirty(layer, tileCoordinate);
+}
+
+void TMXTiledMapGPU::setTileOpacity(int layer, const Vec2& tileCoordinate, GLubyte opacity)
+{
+    unsigned char* texel = getTexel(layer, tileCoordinate);
+    if (texel[3] != opacity)
+    {
+        texel[3] = opacity;
+        markTileDirty(layer, tileCoordinate);
+    }
+}
+
+void TMXTiledMapGPU::setLayerVisible(int layer, bool visible)
+{
+    CCASSERT(layer >= 0 && layer < (int)_layers.size(), "TMXTiledMapGPU: invalid layer");
+    _layers[layer].visible = visible;
+}
+
+bool TMXTiledMapGPU::isLayerVisible(int layer) const
+{
+    CCASSERT(layer >= 0 && layer < (int)_layers.size(), "TMXTiledMapGPU: invalid layer");
+    return _layers[layer].visible;
+}
+
+void TMXTiledMapGPU::setLayerOpacity(int layer, GLubyte opacity)
+{
+    CCASSERT(layer >= 0 && layer < (int)_layers.size(), "TMXTiledMapGPU: invalid layer");
+    _layers[layer].opacity = opacity;
+}
+
+GLubyte TMXTiledMapGPU::getLayerOpacity(int layer) const
+{
+    CCASSERT(layer >= 0 && layer < (int)_layers.size(), "TMXTiledMapGPU: invalid layer");
+    return _layers[layer].opacity;
+}
+
+void TMXTiledMapGPU::update(float dt)
+{
+    _animationTime += dt * _animationSpeed;
+
+    for (auto group : _groups)
+    {
+        auto animation = group->animation;
+        const int width = animation->getWidth();
+        for (auto& tileAnimation : group->animations)
+        {
+            auto& ends = tileAnimation.frameEnds;
+            const float time = (float)std::fmod(_animationTime, (double)ends.back());
+            int frame = (int)(std::upper_bound(ends.begin(), ends.end(), time) - ends.begin());
+            frame = std::min(frame, (int)ends.size() - 1);
+            if (frame == tileAnimation.currentFrame)
+                continue;
+
+            // only the entry of the animated tile changes, all the tiles showing it follow
+            tileAnimation.currentFrame = frame;
+            const int x = tileAnimation.tile % width;
+            const int y = tileAnimation.tile / width;
+            encodeIndex(animation->getPixels() + y * animation->getBytesPerRow() + x * 4, tileAnimation.frameTiles[frame]);
+            animation->markDirty(x, y, 1, 1);
+        }
+    }
+}
+
+void TMXTiledMapGPU::draw(Renderer* renderer, const Mat4& transform, uint32_t flags)
+{
+    for (auto group : _groups)
+    {
+        bool visible = false;
+        for (auto layer : group->layers)
+        {
+            visible |= _layers[layer].visible && _layers[layer].opacity > 0;
+        }
+        if (!visible)
+            continue;
+
+        group->command.init(_globalZOrder, transform, flags);
+        group->command.func = CC_CALLBACK_0(TMXTiledMapGPU::onDraw, this, group, transform);
+        renderer->addCommand(&group->command);
+    }
+}
+
+void TMXTiledMapGPU::onDraw(Group* group, const Mat4& transform)
+{
+    auto glProgram = getGLProgram();
+    glProgram->use();
+    glProgram->setUniformsForBuiltins(transform);
+
+    GLfloat opacities[MAX_LAYERS_PER_DRAW] = { 0, 0, 0, 0 };
+    for (size_t i = 0; i < group->layers.size(); ++i)
+    {
+        auto& layer = _layers[group->layers[i]];
+        opacities[i] = layer.visible ? layer.opacity / 255.0f : 0.0f;
+    }
+
+    const float opacity = _displayedOpacity / 255.0f;
+    auto tileset = group->tileset;
+    glProgram->setUniformLocationWith1i(_uniformTiles, 1);
+    glProgram->setUniformLocationWith1i(_uniformAnimation, 2);
+    glProgram->setUniformLocationWith4f(_uniformMap, _mapSize.width, _mapSize.height, (GLfloat)group->layers.size(),
+                                        group->texture->hasPremultipliedAlpha() ? 1.0f : 0.0f);
+    glProgram->setUniformLocationWith2f(_uniformAnimationSize, (GLfloat)group->animation->getWidth(), (GLfloat)group->animation->getHeight());
+    glProgram->setUniformLocationWith4fv(_uniformLayerOpacities, opacities, 1);
+    glProgram->setUniformLocationWith3f(_uniformTileset, (GLfloat)group->texture->getPixelsWide(), (GLfloat)group->texture->getPixelsHigh(), (GLfloat)group->columns);
+    glProgram->setUniformLocationWith4f(_uniformTilesetLayout, (GLfloat)tileset->_margin, (GLfloat)tileset->_spacing,
+                                        tileset->_tileSize.width, tileset->_tileSize.height);
+    glProgram->setUniformLocationWith4f(_uniformColor, _displayedColor.r / 255.0f * opacity, _displayedColor.g / 255.0f * opacity,
+                                        _displayedColor.b / 255.0f * opacity, opacity);
+
+    GL::bindTexture2DN(2, group->animation->getTexture()->getName());
+    GL::bindTexture2DN(1, group->tiles->getTexture()->getName());
+    GL::bindTexture2DN(0, group->texture->getName());
+    GL::blendFunc(BlendFunc::ALPHA_PREMULTIPLIED.src, BlendFunc::ALPHA_PREMULTIPLIED.dst);
+
+    if (Configuration::getInstance()->supportsShareableVAO())
+    {
+        GL::bindVAO(0);
+    }
+    GL::enableVertexAttribs(GL::VERTEX_ATTRIB_FLAG_POSITION | GL::VERTEX_ATTRIB_FLAG_TEX_COORD);
+
+    glBindBuffer(GL_ARRAY_BUFFER, _vbo);
+    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(GLfloat), (GLvoid*)0);
+    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORD, 2, GL_FLOAT, GL_FALSE, 4 * sizeof(GLfloat), (GLvoid*)(2 * sizeof(GLfloat)));
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    CC_INCREMENT_GL_DRAWN_BATCHES_AND_VERTICES(1, 4);
+    CHECK_GL_ERROR_DEBUG();
+}
+
+std::string TMXTiledMapGPU::getDescription() const
+{
+    return StringUtils::format("<TMXTiledMapGPU | Tag = %d, Layers = %d, Draws = %d>", _tag, (int)_layers.size(), (int)_groups.size());
+}
+
+NS_CC_END
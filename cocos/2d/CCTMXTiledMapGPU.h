@@ -0,0 +1,195 @@
+/****************************************************************************
+Copyright (c) 2017 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#ifndef __CCTMX_TILED_MAP_GPU_H__
+#define __CCTMX_TILED_MAP_GPU_H__
+
+#include <string>
+#include <vector>
+
+#include "2d/CCNode.h"
+#include "2d/CCTMXXMLParser.h"
+#include "renderer/CCCustomCommand.h"
+
+NS_CC_BEGIN
+
+class DynamicTexture;
+class GLProgram;
+class Texture2D;
+class EventCustom;
+
+/**
+ * @addtogroup _2d
+ * @{
+ */
+
+/** @class TMXTiledMapGPU
+ * @brief Draws the tile layers of an orthogonal TMX map with the tiles generated in the fragment shader.
+ *
+ * The gids of the layers are stored in a texture, one texel per tile, and the shader looks up the tile
+ * of each pixel in it, then the current frame of animated tiles in a lookup table, then the pixel in the
+ * tileset. Up to MAX_LAYERS_PER_DRAW consecutive layers using the same tileset are drawn by one quad.
+ *
+ * Nothing is rebuilt on the CPU when the map scrolls, when a tile changes (a texel is updated) or when
+ * tiles are animated (an entry of the lookup table per animated tile in the tileset is updated when its
+ * frame changes), so the cost of a frame doesn't depend on the size of the map.
+ *
+ * Each layer has to use a single tileset whose tiles are the size of the tiles of the map, layer offsets
+ * are ignored. Isometric and hexagonal maps aren't supported, use TMXTiledMap for them. The fragment
+ * shader needs high precision floats to address large maps.
+ * @since v3.14
+ */
+class CC_DLL TMXTiledMapGPU : public Node
+{
+public:
+    /** The number of layers a draw can combine.*/
+    static const int MAX_LAYERS_PER_DRAW = 4;
+
+    /** Creates the map of a TMX file.
+     *
+     * @param tmxFile A TMX file.
+     * @return An autoreleased map, nullptr if the file can't be read or isn't an orthogonal map.
+     */
+    static TMXTiledMapGPU* create(const std::string& tmxFile);
+
+    const Size& getMapSize() const { return _mapSize; }
+    const Size& getTileSize() const { return _tileSize; }
+
+    /** The number of tile layers, in drawing order.*/
+    int getLayerCount() const { return (int)_layers.size(); }
+    /** Returns the index of a layer, -1 if there is none with this name.*/
+    int getLayerIndex(const std::string& layerName) const;
+    const std::string& getLayerName(int layer) const;
+
+    /** Returns the gid of a tile, 0 if it's empty.
+     *
+     * @param layer The index of the layer.
+     * @param tileCoordinate The column and row, from the top left tile.
+     * @param flags If not nullptr, receives the flip flags of the tile.
+     */
+    uint32_t getTileGIDAt(int layer, const Vec2& tileCoordinate, TMXTileFlags* flags = nullptr) const;
+    /** Sets the gid and the flip flags of a tile, 0 makes it empty. It updates one texel of the gid texture.*/
+    void setTileGID(int layer, uint32_t gid, const Vec2& tileCoordinate, TMXTileFlags flags = (TMXTileFlags)0);
+
+    /** Sets the opacity of a single tile, 255 by default.*/
+    void setTileOpacity(int layer, const Vec2& tileCoordinate, GLubyte opacity);
+
+    void setLayerVisible(int layer, bool visible);
+    bool isLayerVisible(int layer) const;
+    void setLayerOpacity(int layer, GLubyte opacity);
+    GLubyte getLayerOpacity(int layer) const;
+
+    /** Sets the speed of the tile animations, 1 by default and 0 stops them.*/
+    void setAnimationSpeed(float speed) { _animationSpeed = speed; }
+    float getAnimationSpeed() const { return _animationSpeed; }
+
+    /** The number of draws of the map, the layers sharing a tileset are combined.*/
+    int getDrawCount() const { return (int)_groups.size(); }
+
+    //
+    // Overrides
+    //
+    virtual void draw(Renderer *renderer, const Mat4& transform, uint32_t flags) override;
+    virtual void update(float dt) override;
+    virtual std::string getDescription() const override;
+
+CC_CONSTRUCTOR_ACCESS:
+    TMXTiledMapGPU();
+    virtual ~TMXTiledMapGPU();
+
+    bool initWithTMXFile(const std::string& tmxFile);
+
+protected:
+    struct TileAnimation
+    {
+        /** the tile in the tileset, from 0 */
+        int tile;
+        std::vector<int> frameTiles;
+        /** the end of each frame in seconds, from the start of the animation */
+        std::vector<float> frameEnds;
+        int currentFrame;
+    };
+
+    /** consecutive layers drawn together, with the same tileset */
+    struct Group
+    {
+        TMXTilesetInfo* tileset;
+        Texture2D* texture;
+        int tileCount;
+        int columns;
+        /** the tiles of the layers, the rows of each layer from the top one of the map */
+        DynamicTexture* tiles;
+        /** the tile shown in place of each tile of the tileset */
+        DynamicTexture* animation;
+        std::vector<TileAnimation> animations;
+        std::vector<int> layers;
+        CustomCommand command;
+    };
+
+    struct Layer
+    {
+        std::string name;
+        Group* group;
+        int slot;
+        GLubyte opacity;
+        bool visible;
+    };
+
+    Group* createGroup(TMXTilesetInfo* tileset, TMXMapInfo* mapInfo);
+    bool createTiles(Group* group, const std::vector<TMXLayerInfo*>& layerInfos);
+    unsigned char* getTexel(int layer, const Vec2& tileCoordinate) const;
+    void markTileDirty(int layer, const Vec2& tileCoordinate);
+    void initGLProgram();
+    void setupBuffer();
+    void onDraw(Group* group, const Mat4& transform);
+    void listenRendererRecreated(EventCustom* event);
+
+    Size _mapSize;
+    Size _tileSize;
+    std::vector<Layer> _layers;
+    std::vector<Group*> _groups;
+    /** in seconds, a double so the frames stay accurate in long sessions */
+    double _animationTime;
+    float _animationSpeed;
+
+    GLuint _vbo;
+    GLint _uniformTiles;
+    GLint _uniformAnimation;
+    GLint _uniformMap;
+    GLint _uniformAnimationSize;
+    GLint _uniformLayerOpacities;
+    GLint _uniformTileset;
+    GLint _uniformTilesetLayout;
+    GLint _uniformColor;
+
+private:
+    CC_DISALLOW_COPY_AND_ASSIGN(TMXTiledMapGPU);
+};
+
+// end of _2d group
+/// @}
+
+NS_CC_END
+
+#endif //__CCTMX_TILED_MAP_GPU_H__
@@ -44,6 +44,7 @@ TMXLayerInfo::TMXLayerInfo()
 : _name("")
 , _tiles(nullptr)
 , _ownTiles(true)
+, _encodedAttribs(0)
 {
 }
 
@@ -67,6 +68,94 @@ void TMXLayerInfo::setProperties(ValueMap var)
     _properties = var;
 }
 
+uint32_t* TMXLayerInfo::getTiles()
+{
+    if (_tiles == nullptr && !_encodedTiles.empty())
+    {
+        _tiles = decodeTiles(_encodedTiles, _encodedAttribs, _layerSize);
+        _ownTiles = true;
+    }
+    return _tiles;
+}
+
+void TMXLayerInfo::releaseTiles()
+{
+    if (_encodedTiles.empty())
+        return;
+
+    if (_ownTiles && _tiles)
+    {
+        free(_tiles);
+    }
+    _tiles = nullptr;
+}
+
+uint32_t* TMXLayerInfo::decodeTiles(const std::string& data, int layerAttribs, const Size& layerSize)
+{
+    if (layerAttribs & TMXLayerAttribBase64)
+    {
+        unsigned char *buffer;
+        auto len = base64Decode((unsigned char*)data.c_str(), (unsigned int)data.length(), &buffer);
+        if (!buffer)
+        {
+            CCLOG("cocos2d: TiledMap: decode data error");
+            return nullptr;
+        }
+
+        if (layerAttribs & (TMXLayerAttribGzip | TMXLayerAttribZlib))
+        {
+            unsigned char *deflated = nullptr;
+            ssize_t sizeHint = layerSize.width * layerSize.height * sizeof(unsigned int);
+
+            ssize_t CC_UNUSED inflatedLen = ZipUtils::inflateMemoryWithHint(buffer, len, &deflated, sizeHint);
+            CCASSERT(inflatedLen == sizeHint, "inflatedLen should be equal to sizeHint!");
+
+            free(buffer);
+            buffer = nullptr;
+
+            if (!deflated)
+            {
+                CCLOG("cocos2d: TiledMap: inflate data error");
+                return nullptr;
+            }
+
+            return reinterpret_cast<uint32_t*>(deflated);
+        }
+        return reinterpret_cast<uint32_t*>(buffer);
+    }
+    else if (layerAttribs & TMXLayerAttribCSV)
+    {
+        vector<string> gidTokens;
+        istringstream filestr(data);
+        string sRow;
+        while(getline(filestr, sRow, '\n')) {
+            string sGID;
+            istringstream rowstr(sRow);
+            while (getline(rowstr, sGID, ',')) {
+                gidTokens.push_back(sGID);
+            }
+        }
+
+        // 32-bits per gid
+        unsigned char *buffer = (unsigned char*)malloc(gidTokens.size() * 4);
+        if (!buffer)
+        {
+            CCLOG("cocos2d: TiledMap: CSV buffer not allocated.");
+            return nullptr;
+        }
+
+        uint32_t* bufferPtr = reinterpret_cast<uint32_t*>(buffer);
+        for(auto gidToken : gidTokens) {
+            auto tileGid = (uint32_t)strtoul(gidToken.c_str(), nullptr, 10);
+            *bufferPtr = tileGid;
+            bufferPtr++;
+        }
+
+        return reinterpret_cast<uint32_t*>(buffer);
+    }
+    return nullptr;
+}
+
 // implementation TMXTilesetInfo
 TMXTilesetInfo::TMXTilesetInfo()
     :_firstGid(0)
@@ -114,6 +203,19 @@ TMXMapInfo * TMXMapInfo::create(const std::string& tmxFile)
     return nullptr;
 }
 
+TMXMapInfo * TMXMapInfo::createWithLazyTiles(const std::string& tmxFile)
+{
+    TMXMapInfo *ret = new (std::nothrow) TMXMapInfo();
+    ret->_lazyTiles = true;
+    if (ret->initWithTMXFile(tmxFile))
+    {
+        ret->autorelease();
+        return ret;
+    }
+    CC_SAFE_DELETE(ret);
+    return nullptr;
+}
+
 TMXMapInfo * TMXMapInfo::createWithXML(const std::string& tmxString, const std::string& resourcePath)
 {
     TMXMapInfo *ret = new (std::nothrow) TMXMapInfo();
@@ -174,6 +276,7 @@ TMXMapInfo::TMXMapInfo()
 , _xmlTileIndex(0)
 , _currentFirstGID(-1)
 , _recordFirstGID(true)
+, _lazyTiles(false)
 {
 }
 
@@ -370,6 +473,18 @@ void TMXMapInfo::startElement(void* /*ctx*/, const char *name, const char **atts
             tmxMapInfo->setParentElement(TMXPropertyTile);
         }
     }
+    else if (elementName == "frame")
+    {
+        // the frames of <animation> in a <tile> of a tileset
+        if (tmxMapInfo->getParentElement() == TMXPropertyTile && !tmxMapInfo->getTilesets().empty())
+        {
+            TMXTilesetInfo* info = tmxMapInfo->getTilesets().back();
+            TMXTileAnimationFrame frame;
+            frame.gid = info->_firstGid + attributeDict["tileid"].asUnsignedInt();
+            frame.duration = attributeDict["duration"].asFloat() / 1000.0f;
+            _tileAnimations[tmxMapInfo->getParentGID()].push_back(frame);
+        }
+    }
     else if (elementName == "layer")
     {
         TMXLayerInfo *layer = new (std::nothrow) TMXLayerInfo();
@@ -673,85 +788,20 @@ void TMXMapInfo::endElement(void* /*ctx*/, const char *name)
 
     if (elementName == "data")
     {
-        if (tmxMapInfo->getLayerAttribs() & TMXLayerAttribBase64)
+        if (tmxMapInfo->getLayerAttribs() & (TMXLayerAttribBase64 | TMXLayerAttribCSV))
         {
             tmxMapInfo->setStoringCharacters(false);
-            
+
             TMXLayerInfo* layer = tmxMapInfo->getLayers().back();
-            
-            std::string currentString = tmxMapInfo->getCurrentString();
-            unsigned char *buffer;
-            auto len = base64Decode((unsigned char*)currentString.c_str(), (unsigned int)currentString.length(), &buffer);
-            if (!buffer)
+            if (_lazyTiles)
             {
-                CCLOG("cocos2d: TiledMap: decode data error");
-                return;
-            }
-            
-            if (tmxMapInfo->getLayerAttribs() & (TMXLayerAttribGzip | TMXLayerAttribZlib))
-            {
-                unsigned char *deflated = nullptr;
-                Size s = layer->_layerSize;
-                // int sizeHint = s.width * s.height * sizeof(uint32_t);
-                ssize_t sizeHint = s.width * s.height * sizeof(unsigned int);
-                
-                ssize_t CC_UNUSED inflatedLen = ZipUtils::inflateMemoryWithHint(buffer, len, &deflated, sizeHint);
-                CCASSERT(inflatedLen == sizeHint, "inflatedLen should be equal to sizeHint!");
-                
-                free(buffer);
-                buffer = nullptr;
-                
-                if (!deflated)
-                {
-                    CCLOG("cocos2d: TiledMap: inflate data error");
-                    return;
-                }
-                
-                layer->_tiles = reinterpret_cast<uint32_t*>(deflated);
+                layer->_encodedTiles = tmxMapInfo->getCurrentString();
+                layer->_encodedAttribs = tmxMapInfo->getLayerAttribs();
             }
             else
             {
-                layer->_tiles = reinterpret_cast<uint32_t*>(buffer);
+                layer->_tiles = TMXLayerInfo::decodeTiles(tmxMapInfo->getCurrentString(), tmxMapInfo->getLayerAttribs(), layer->_layerSize);
             }
-            
-            tmxMapInfo->setCurrentString("");
-        }
-        else if (tmxMapInfo->getLayerAttribs() & TMXLayerAttribCSV)
-        {
-            unsigned char *buffer;
-
-            TMXLayerInfo* layer = tmxMapInfo->getLayers().back();
-
-            tmxMapInfo->setStoringCharacters(false);
-            std::string currentString = tmxMapInfo->getCurrentString();
-
-            vector<string> gidTokens;
-            istringstream filestr(currentString);
-            string sRow;
-            while(getline(filestr, sRow, '\n')) {
-                string sGID;
-                istringstream rowstr(sRow);
-                while (getline(rowstr, sGID, ',')) {
-                    gidTokens.push_back(sGID);
-                }
-            }
-
-            // 32-bits per gid
-            buffer = (unsigned char*)malloc(gidTokens.size() * 4);
-            if (!buffer)
-            {
-                CCLOG("cocos2d: TiledMap: CSV buffer not allocated.");
-                return;
-            }
-
-            uint32_t* bufferPtr = reinterpret_cast<uint32_t*>(buffer);
-            for(auto gidToken : gidTokens) {
-                auto tileGid = (uint32_t)strtoul(gidToken.c_str(), nullptr, 10);
-                *bufferPtr = tileGid;
-                bufferPtr++;
-            }
-
-            layer->_tiles = reinterpret_cast<uint32_t*>(buffer);
 
             tmxMapInfo->setCurrentString("");
         }
@@ -38,6 +38,8 @@ THE SOFTWARE.
 #include "2d/CCTMXObjectGroup.h" // needed for Vector<TMXObjectGroup*> for binding
 
 #include <string>
+#include <unordered_map>
+#include <vector>
 
 NS_CC_BEGIN
 
@@ -84,6 +86,17 @@ typedef enum TMXTileFlags_ {
 
 // Bits on the far end of the 32-bit global tile ID (GID's) are used for tile flags
 
+/** @brief A frame of the animation of a tile, from the <animation> element of a tile of a tileset.
+ * @since v3.14
+ */
+struct CC_DLL TMXTileAnimationFrame
+{
+    /** The tile shown during the frame.*/
+    uint32_t gid;
+    /** In seconds.*/
+    float duration;
+};
+
 /** @brief TMXLayerInfo contains the information about the layers like:
 - Layer name
 - Layer size
@@ -108,6 +121,20 @@ public:
     void setProperties(ValueMap properties);
     ValueMap& getProperties();
 
+    /** Returns the gids of the layer, decoding them first if the map was parsed by TMXMapInfo::createWithLazyTiles().
+     * @since v3.14
+     */
+    uint32_t* getTiles();
+    /** Frees the gids decoded by getTiles(), the layer keeps them encoded until getTiles() is called again.
+     * @since v3.14
+     */
+    void releaseTiles();
+
+    /** Decodes the text of a <data> element, returns the gids allocated with malloc() or nullptr.
+     * @since v3.14
+     */
+    static uint32_t* decodeTiles(const std::string& data, int layerAttribs, const Size& layerSize);
+
     ValueMap            _properties;
     std::string         _name;
     Size                _layerSize;
@@ -116,6 +143,9 @@ public:
     unsigned char       _opacity;
     bool                _ownTiles;
     Vec2               _offset;
+    /** the text of the <data> element of a lazily decoded layer */
+    std::string         _encodedTiles;
+    int                 _encodedAttribs;
 };
 
 /** @brief TMXTilesetInfo contains the information about the tilesets like:
@@ -175,6 +205,12 @@ public:
     /** creates a TMX Format with a tmx file */
     static TMXMapInfo * create(const std::string& tmxFile);
     /** creates a TMX Format with an XML string and a TMX resource path */
+    /** Creates a TMX Format with a tmx file, keeping the tiles of the layers encoded.
+     * TMXLayerInfo::getTiles() decodes the tiles of a layer when they are needed, _tiles is nullptr until then.
+     * @since v3.14
+     */
+    static TMXMapInfo * createWithLazyTiles(const std::string& tmxFile);
+
     static TMXMapInfo * createWithXML(const std::string& tmxString, const std::string& resourcePath);
     
     /** creates a TMX Format with a tmx file */
@@ -205,6 +241,11 @@ public:
         _tileProperties = tileProperties;
     }
 
+    /** The frames of the animated tiles, by gid.
+     * @since v3.14
+     */
+    std::unordered_map<uint32_t, std::vector<TMXTileAnimationFrame>>& getTileAnimations() { return _tileAnimations; }
+
     /// map orientation
     int getOrientation() const { return _orientation; }
     void setOrientation(int orientation) { _orientation = orientation; }
@@ -339,9 +380,12 @@ protected:
     std::string _currentString;
     //! tile properties
     ValueMapIntKey _tileProperties;
+    //! frames of the animated tiles
+    std::unordered_map<uint32_t, std::vector<TMXTileAnimationFrame>> _tileAnimations;
     int _currentFirstGID;
     bool _recordFirstGID;
     std::string _externalTilesetFilename;
+    bool _lazyTiles;
 };
 
 // end of tilemap_parallax_nodes group
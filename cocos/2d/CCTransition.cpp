@@ -42,21 +42,132 @@ NS_CC_BEGIN
 
 const unsigned int kSceneFade = 0xFADEFADE;
 
+// the snapshots of a transition at most, the other textures are released
+#define SNAPSHOT_POOL_SIZE 2
+
+static TransitionScene::SnapshotMode s_defaultSnapshotMode = TransitionScene::SnapshotMode::NONE;
+static std::vector<RenderTexture*> s_snapshotPool;
+
 TransitionScene::TransitionScene()
 : _inScene(nullptr)
 , _outScene(nullptr)
 , _duration(0.0f)
 , _isInSceneOnTop(false)
 , _isSendCleanupToScene(false)
+, _snapshotMode(s_defaultSnapshotMode)
+, _inSceneSnapshot(nullptr)
+, _outSceneSnapshot(nullptr)
 {
 }
 
 TransitionScene::~TransitionScene()
 {
+    releaseSnapshots();
     CC_SAFE_RELEASE(_inScene);
     CC_SAFE_RELEASE(_outScene);
 }
 
+void TransitionScene::setDefaultSnapshotMode(SnapshotMode mode)
+{
+    s_defaultSnapshotMode = mode;
+}
+
+TransitionScene::SnapshotMode TransitionScene::getDefaultSnapshotMode()
+{
+    return s_defaultSnapshotMode;
+}
+
+void TransitionScene::purgeSnapshotPool()
+{
+    for (auto renderTexture : s_snapshotPool)
+    {
+        renderTexture->release();
+    }
+    s_snapshotPool.clear();
+}
+
+static RenderTexture* takeSnapshot(Scene* scene)
+{
+    auto size = Director::getInstance()->getWinSize();
+    int width = (int)size.width;
+    int height = (int)size.height;
+
+    RenderTexture* renderTexture = nullptr;
+    for (auto it = s_snapshotPool.begin(); it != s_snapshotPool.end(); ++it)
+    {
+        auto texture = (*it)->getSprite()->getTexture();
+        if (texture->getPixelsWide() == (int)(width * CC_CONTENT_SCALE_FACTOR()) && texture->getPixelsHigh() == (int)(height * CC_CONTENT_SCALE_FACTOR()))
+        {
+            renderTexture = *it;
+            s_snapshotPool.erase(it);
+            break;
+        }
+    }
+
+    if (renderTexture == nullptr)
+    {
+        renderTexture = RenderTexture::create(width, height, Texture2D::PixelFormat::RGBA8888, GL_DEPTH24_STENCIL8);
+        if (renderTexture == nullptr)
+        {
+            return nullptr;
+        }
+        renderTexture->retain();
+    }
+
+    renderTexture->beginWithClear(0, 0, 0, 0);
+    scene->visit();
+    renderTexture->end();
+    return renderTexture;
+}
+
+static void recycleSnapshot(RenderTexture* renderTexture)
+{
+    if (s_snapshotPool.size() < SNAPSHOT_POOL_SIZE)
+    {
+        renderTexture->getSprite()->setVisible(true);
+        s_snapshotPool.push_back(renderTexture);
+    }
+    else
+    {
+        renderTexture->release();
+    }
+}
+
+void TransitionScene::takeSnapshots()
+{
+    if (_snapshotMode == SnapshotMode::BOTH || _snapshotMode == SnapshotMode::OUT_SCENE)
+    {
+        _outSceneSnapshot = takeSnapshot(_outScene);
+    }
+    if (_snapshotMode == SnapshotMode::BOTH || _snapshotMode == SnapshotMode::IN_SCENE)
+    {
+        _inSceneSnapshot = takeSnapshot(_inScene);
+    }
+}
+
+void TransitionScene::releaseSnapshots()
+{
+    if (_outSceneSnapshot)
+    {
+        recycleSnapshot(_outSceneSnapshot);
+        _outSceneSnapshot = nullptr;
+    }
+    if (_inSceneSnapshot)
+    {
+        recycleSnapshot(_inSceneSnapshot);
+        _inSceneSnapshot = nullptr;
+    }
+}
+
+Node* TransitionScene::getSceneNode(Scene* scene) const
+{
+    if (scene == _outScene && _outSceneSnapshot)
+        return _outSceneSnapshot->getSprite();
+    if (scene == _inScene && _inSceneSnapshot)
+        return _inSceneSnapshot->getSprite();
+    return scene;
+}
+
 TransitionScene * TransitionScene::create(float t, Scene *scene)
 {
     TransitionScene * pScene = new (std::nothrow) TransitionScene();
@@ -114,16 +225,35 @@ void TransitionScene::sceneOrder()
     _isInSceneOnTop = true;
 }
 
+static void updateSnapshot(Scene* scene, RenderTexture* snapshot)
+{
+    if (snapshot)
+    {
+        auto sprite = snapshot->getSprite();
+        sprite->setVisible(scene->isVisible());
+        sprite->setNodeToParentTransform(scene->getNodeToParentTransform());
+    }
+}
+
+void TransitionScene::visit(Renderer *renderer, const Mat4& parentTransform, uint32_t parentFlags)
+{
+    // the snapshots follow the actions run on the scenes
+    updateSnapshot(_outScene, _outSceneSnapshot);
+    updateSnapshot(_inScene, _inSceneSnapshot);
+
+    Scene::visit(renderer, parentTransform, parentFlags);
+}
+
 void TransitionScene::draw(Renderer *renderer, const Mat4 &transform, uint32_t flags)
 {
     Scene::draw(renderer, transform, flags);
 
     if( _isInSceneOnTop ) {
-        _outScene->visit(renderer, transform, flags);
-        _inScene->visit(renderer, transform, flags);
+        getSceneNode(_outScene)->visit(renderer, transform, flags);
+        getSceneNode(_inScene)->visit(renderer, transform, flags);
     } else {
-        _inScene->visit(renderer, transform, flags);
-        _outScene->visit(renderer, transform, flags);
+        getSceneNode(_inScene)->visit(renderer, transform, flags);
+        getSceneNode(_outScene)->visit(renderer, transform, flags);
     }
 }
 
@@ -195,6 +325,8 @@ void TransitionScene::onEnter()
     _outScene->onExitTransitionDidStart();
     
     _inScene->onEnter();
+
+    takeSnapshots();
 }
 
 // custom onExit
@@ -209,6 +341,7 @@ void TransitionScene::onExit()
 #endif // #if CC_ENABLE_SCRIPT_BINDING
     
     Scene::onExit();
+    releaseSnapshots();
     
     // enable events while transitions
     _eventDispatcher->setEnabled(true);
@@ -1417,7 +1550,7 @@ void TransitionTurnOffTiles::sceneOrder()
 void TransitionTurnOffTiles::onEnter()
 {
     TransitionScene::onEnter();
-    _outSceneProxy->setTarget(_outScene);
+    _outSceneProxy->setTarget(getSceneNode(_outScene));
     _outSceneProxy->onEnter();
 
     Size s = Director::getInstance()->getWinSize();
@@ -1453,11 +1586,11 @@ void TransitionTurnOffTiles::draw(Renderer *renderer, const Mat4 &transform, uin
     if( _isInSceneOnTop )
     {
         _outSceneProxy->visit(renderer, transform, flags);
-        _inScene->visit(renderer, transform, flags);
+        getSceneNode(_inScene)->visit(renderer, transform, flags);
     } 
     else
     {
-        _inScene->visit(renderer, transform, flags);
+        getSceneNode(_inScene)->visit(renderer, transform, flags);
         _outSceneProxy->visit(renderer, transform, flags);
     }
 }
@@ -1497,7 +1630,7 @@ void TransitionSplitCols::onEnter()
 {
     TransitionScene::onEnter();
 
-    _gridProxy->setTarget(_outScene);
+    _gridProxy->setTarget(getSceneNode(_outScene));
     _gridProxy->onEnter();
 
     ActionInterval* split = action();
@@ -1523,7 +1656,7 @@ void TransitionSplitCols::onEnter()
 
 void TransitionSplitCols::switchTargetToInscene()
 {
-    _gridProxy->setTarget(_inScene);
+    _gridProxy->setTarget(getSceneNode(_inScene));
 }
 
 void TransitionSplitCols::draw(Renderer *renderer, const Mat4 &transform, uint32_t flags)
@@ -1613,7 +1746,7 @@ void TransitionFadeTR::onEnter()
 {
     TransitionScene::onEnter();
 
-    _outSceneProxy->setTarget(_outScene);
+    _outSceneProxy->setTarget(getSceneNode(_outScene));
     _outSceneProxy->onEnter();
 
     Size s = Director::getInstance()->getWinSize();
@@ -1649,11 +1782,11 @@ void TransitionFadeTR::draw(Renderer *renderer, const Mat4 &transform, uint32_t
     if( _isInSceneOnTop )
     {
         _outSceneProxy->visit(renderer, transform, flags);
-        _inScene->visit(renderer, transform, flags);
+        getSceneNode(_inScene)->visit(renderer, transform, flags);
     } 
     else
     {
-        _inScene->visit(renderer, transform, flags);
+        getSceneNode(_inScene)->visit(renderer, transform, flags);
         _outSceneProxy->visit(renderer, transform, flags);
     }
 }
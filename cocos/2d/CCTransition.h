@@ -44,6 +44,7 @@ NS_CC_BEGIN
 class ActionInterval;
 class Node;
 class NodeGrid;
+class RenderTexture;
 
 /** @class TransitionEaseScene
  * @brief TransitionEaseScene can ease the actions of the scene protocol.
@@ -85,6 +86,23 @@ public:
         /// A vertical orientation where the Bottom is nearer
         DOWN_OVER = 1,
     };
+
+    /** The scenes drawn from a snapshot taken when the transition starts, instead of being visited every frame.
+     * The actions run on the scenes by the transition still move the snapshots, but the animations inside the
+     * scenes are frozen.
+     * @since v3.14
+     */
+    enum class SnapshotMode
+    {
+        /// Both scenes are visited every frame
+        NONE,
+        /// Only the outgoing scene is a snapshot, the incoming one keeps animating
+        OUT_SCENE,
+        /// Only the incoming scene is a snapshot, the outgoing one keeps animating
+        IN_SCENE,
+        /// Both scenes are snapshots
+        BOTH,
+    };
     
     /** Creates a base transition with duration and incoming scene.
      *
@@ -104,9 +122,35 @@ public:
 
     Scene* getInScene() const{ return _inScene; }
     float getDuration() const { return _duration; }
+
+    /** Sets which scenes are drawn from a snapshot, it must be set before the transition starts.
+     * The snapshots are rendered in textures kept in a pool for the next transitions.
+     *
+     * @param mode The snapshot mode, the default one is from getDefaultSnapshotMode().
+     * @since v3.14
+     */
+    void setSnapshotMode(SnapshotMode mode) { _snapshotMode = mode; }
+    /** @since v3.14 */
+    SnapshotMode getSnapshotMode() const { return _snapshotMode; }
+
+    /** Sets the snapshot mode of the transitions created afterwards, NONE by default.
+     *
+     * @param mode The snapshot mode, BOTH keeps the frame rate of transitions on slow devices.
+     * @since v3.14
+     */
+    static void setDefaultSnapshotMode(SnapshotMode mode);
+    /** @since v3.14 */
+    static SnapshotMode getDefaultSnapshotMode();
+
+    /** Releases the textures kept for the snapshots of the next transitions.
+     * @since v3.14
+     */
+    static void purgeSnapshotPool();
+
     //
     // Overrides
     //
+    virtual void visit(Renderer *renderer, const Mat4& parentTransform, uint32_t parentFlags) override;
     virtual void draw(Renderer *renderer, const Mat4 &transform, uint32_t flags) override;
     virtual void onEnter() override;
     virtual void onExit() override;
@@ -123,11 +167,21 @@ protected:
     virtual void sceneOrder();
     void setNewScene(float dt);
 
+    /** The node to draw for one of the scenes: its snapshot if there is one, or the scene itself.
+     * @since v3.14
+     */
+    Node* getSceneNode(Scene* scene) const;
+    void takeSnapshots();
+    void releaseSnapshots();
+
     Scene *_inScene;
     Scene *_outScene;
     float _duration;
     bool _isInSceneOnTop;
     bool _isSendCleanupToScene;
+    SnapshotMode _snapshotMode;
+    RenderTexture* _inSceneSnapshot;
+    RenderTexture* _outSceneSnapshot;
 
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(TransitionScene);
@@ -92,8 +92,8 @@ void TransitionPageTurn::onEnter()
 {
     TransitionScene::onEnter();
 
-    _inSceneProxy->setTarget(_inScene);
-    _outSceneProxy->setTarget(_outScene);
+    _inSceneProxy->setTarget(getSceneNode(_inScene));
+    _outSceneProxy->setTarget(getSceneNode(_outScene));
 
     _inSceneProxy->onEnter();
     _outSceneProxy->onEnter();
@@ -145,7 +145,7 @@ void TransitionPageTurn::onEnter()
 }
 void TransitionPageTurn::onExit()
 {
-    _outSceneProxy->setTarget(nullptr);
+    _inSceneProxy->setTarget(nullptr);
     _outSceneProxy->setTarget(nullptr);
     _outSceneProxy->onExit();
     _inSceneProxy->onExit();
@@ -19,6 +19,7 @@ CCBundleReader.cpp \
 CCMesh.cpp \
 CCMeshSkin.cpp \
 CCMeshVertexIndexData.cpp \
+CCMeshOptimizer.cpp \
 CCMotionStreak3D.cpp \
 CCSprite3DMaterial.cpp \
 CCObjLoader.cpp \
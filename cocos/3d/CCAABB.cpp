@@ -23,6 +23,8 @@
  ****************************************************************************/
 
 #include "3d/CCAABB.h"
+#include "3d/CCFrustum.h"
+#include "3d/CCRay.h"
 
 NS_CC_BEGIN
 
@@ -186,4 +188,404 @@ void AABB::transform(const Mat4& mat)
     updateMinMax(corners, 8);
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+void AABBArray::push_back(const AABB& aabb)
+{
+    minX.push_back(aabb._min.x);
+    minY.push_back(aabb._min.y);
+    minZ.push_back(aabb._min.z);
+    maxX.push_back(aabb._max.x);
+    maxY.push_back(aabb._max.y);
+    maxZ.push_back(aabb._max.z);
+}
+
+void AABBArray::set(size_t index, const AABB& aabb)
+{
+    minX[index] = aabb._min.x;
+    minY[index] = aabb._min.y;
+    minZ[index] = aabb._min.z;
+    maxX[index] = aabb._max.x;
+    maxY[index] = aabb._max.y;
+    maxZ[index] = aabb._max.z;
+}
+
+void AABBArray::clear()
+{
+    minX.clear(); minY.clear(); minZ.clear();
+    maxX.clear(); maxY.clear(); maxZ.clear();
+}
+
+void AABBArray::reserve(size_t count)
+{
+    minX.reserve(count); minY.reserve(count); minZ.reserve(count);
+    maxX.reserve(count); maxY.reserve(count); maxZ.reserve(count);
+}
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+// half the surface area, the cost of a box in the tree
+static float getBoxCost(const AABB& aabb)
+{
+    Vec3 size = aabb._max - aabb._min;
+    return size.x * size.y + size.y * size.z + size.z * size.x;
+}
+
+static AABB mergeBoxes(const AABB& a, const AABB& b)
+{
+    AABB box(a);
+    box.merge(b);
+    return box;
+}
+
+static bool containsBox(const AABB& outer, const AABB& inner)
+{
+    return outer._min.x <= inner._min.x && outer._min.y <= inner._min.y && outer._min.z <= inner._min.z
+        && inner._max.x <= outer._max.x && inner._max.y <= outer._max.y && inner._max.z <= outer._max.z;
+}
+
+AABBTree::AABBTree(float margin)
+: _root(NULL_PROXY)
+, _freeList(NULL_PROXY)
+, _proxyCount(0)
+, _margin(margin)
+{
+}
+
+void AABBTree::clear()
+{
+    _nodes.clear();
+    _root = NULL_PROXY;
+    _freeList = NULL_PROXY;
+    _proxyCount = 0;
+}
+
+int AABBTree::allocateNode()
+{
+    if (_freeList == NULL_PROXY)
+    {
+        _nodes.push_back(TreeNode());
+        _freeList = (int)_nodes.size() - 1;
+        _nodes[_freeList].parent = NULL_PROXY;
+    }
+
+    int node = _freeList;
+    auto& treeNode = _nodes[node];
+    _freeList = treeNode.parent;
+    treeNode.userData = nullptr;
+    treeNode.parent = NULL_PROXY;
+    treeNode.child1 = NULL_PROXY;
+    treeNode.child2 = NULL_PROXY;
+    treeNode.height = 0;
+    return node;
+}
+
+void AABBTree::freeNode(int node)
+{
+    _nodes[node].parent = _freeList;
+    _nodes[node].height = -1;
+    _freeList = node;
+}
+
+int AABBTree::createProxy(const AABB& aabb, void* userData)
+{
+    int proxy = allocateNode();
+    Vec3 margin = (aabb._max - aabb._min) * _margin;
+    _nodes[proxy].aabb.set(aabb._min - margin, aabb._max + margin);
+    _nodes[proxy].userData = userData;
+    insertLeaf(proxy);
+    ++_proxyCount;
+    return proxy;
+}
+
+void AABBTree::destroyProxy(int proxy)
+{
+    CCASSERT(proxy >= 0 && proxy < (int)_nodes.size() && _nodes[proxy].isLeaf(), "Invalid proxy");
+    removeLeaf(proxy);
+    freeNode(proxy);
+    --_proxyCount;
+}
+
+bool AABBTree::moveProxy(int proxy, const AABB& aabb)
+{
+    CCASSERT(proxy >= 0 && proxy < (int)_nodes.size() && _nodes[proxy].isLeaf(), "Invalid proxy");
+    if (containsBox(_nodes[proxy].aabb, aabb))
+        return false;
+
+    removeLeaf(proxy);
+    Vec3 margin = (aabb._max - aabb._min) * _margin;
+    _nodes[proxy].aabb.set(aabb._min - margin, aabb._max + margin);
+    insertLeaf(proxy);
+    return true;
+}
+
+void AABBTree::insertLeaf(int leaf)
+{
+    if (_root == NULL_PROXY)
+    {
+        _root = leaf;
+        _nodes[_root].parent = NULL_PROXY;
+        return;
+    }
+
+    // find the best sibling, going down while a child costs less than pairing the leaf with the node
+    AABB leafBox = _nodes[leaf].aabb;
+    int index = _root;
+    while (!_nodes[index].isLeaf())
+    {
+        int child1 = _nodes[index].child1;
+        int child2 = _nodes[index].child2;
+
+        float area = getBoxCost(_nodes[index].aabb);
+        float combinedArea = getBoxCost(mergeBoxes(_nodes[index].aabb, leafBox));
+
+        // cost of creating a new parent for this node and the leaf
+        float cost = 2.0f * combinedArea;
+        // minimum cost of pushing the leaf further down the tree
+        float inheritanceCost = 2.0f * (combinedArea - area);
+
+        float cost1 = getBoxCost(mergeBoxes(leafBox, _nodes[child1].aabb)) + inheritanceCost;
+        if (!_nodes[child1].isLeaf())
+            cost1 -= getBoxCost(_nodes[child1].aabb);
+        float cost2 = getBoxCost(mergeBoxes(leafBox, _nodes[child2].aabb)) + inheritanceCost;
+        if (!_nodes[child2].isLeaf())
+            cost2 -= getBoxCost(_nodes[child2].aabb);
+
+        if (cost < cost1 && cost < cost2)
+            break;
+
+        index = cost1 < cost2 ? child1 : child2;
+    }
+
+    int sibling = index;
+    int oldParent = _nodes[sibling].parent;
+    int newParent = allocateNode();
+    _nodes[newParent].parent = oldParent;
+    _nodes[newParent].aabb = mergeBoxes(leafBox, _nodes[sibling].aabb);
+    _nodes[newParent].height = _nodes[sibling].height + 1;
+    _nodes[newParent].child1 = sibling;
+    _nodes[newParent].child2 = leaf;
+    _nodes[sibling].parent = newParent;
+    _nodes[leaf].parent = newParent;
+
+    if (oldParent != NULL_PROXY)
+    {
+        if (_nodes[oldParent].child1 == sibling)
+            _nodes[oldParent].child1 = newParent;
+        else
+            _nodes[oldParent].child2 = newParent;
+    }
+    else
+    {
+        _root = newParent;
+    }
+
+    // refit and balance the ancestors
+    index = _nodes[leaf].parent;
+    while (index != NULL_PROXY)
+    {
+        index = balance(index);
+        int child1 = _nodes[index].child1;
+        int child2 = _nodes[index].child2;
+        _nodes[index].height = 1 + std::max(_nodes[child1].height, _nodes[child2].height);
+        _nodes[index].aabb = mergeBoxes(_nodes[child1].aabb, _nodes[child2].aabb);
+        index = _nodes[index].parent;
+    }
+}
+
+void AABBTree::removeLeaf(int leaf)
+{
+    if (leaf == _root)
+    {
+        _root = NULL_PROXY;
+        return;
+    }
+
+    int parent = _nodes[leaf].parent;
+    int grandParent = _nodes[parent].parent;
+    int sibling = _nodes[parent].child1 == leaf ? _nodes[parent].child2 : _nodes[parent].child1;
+
+    if (grandParent != NULL_PROXY)
+    {
+        // replace the parent by the sibling
+        if (_nodes[grandParent].child1 == parent)
+            _nodes[grandParent].child1 = sibling;
+        else
+            _nodes[grandParent].child2 = sibling;
+        _nodes[sibling].parent = grandParent;
+        freeNode(parent);
+
+        int index = grandParent;
+        while (index != NULL_PROXY)
+        {
+            index = balance(index);
+            int child1 = _nodes[index].child1;
+            int child2 = _nodes[index].child2;
+            _nodes[index].aabb = mergeBoxes(_nodes[child1].aabb, _nodes[child2].aabb);
+            _nodes[index].height = 1 + std::max(_nodes[child1].height, _nodes[child2].height);
+            index = _nodes[index].parent;
+        }
+    }
+    else
+    {
+        _root = sibling;
+        _nodes[sibling].parent = NULL_PROXY;
+        freeNode(parent);
+    }
+}
+
+// rotate the subtree of a if it is imbalanced, returns the new root of the subtree
+int AABBTree::balance(int a)
+{
+    auto& nodeA = _nodes[a];
+    if (nodeA.isLeaf() || nodeA.height < 2)
+        return a;
+
+    int b = nodeA.child1;
+    int c = nodeA.child2;
+    int heightBalance = _nodes[c].height - _nodes[b].height;
+
+    // rotate c up, or b up, the higher child takes the place of a
+    if (heightBalance > 1 || heightBalance < -1)
+    {
+        int up = heightBalance > 1 ? c : b;
+        int other = heightBalance > 1 ? b : c;
+        int f = _nodes[up].child1;
+        int g = _nodes[up].child2;
+
+        // swap a and up
+        _nodes[up].child1 = a;
+        _nodes[up].parent = nodeA.parent;
+        nodeA.parent = up;
+
+        if (_nodes[up].parent != NULL_PROXY)
+        {
+            if (_nodes[_nodes[up].parent].child1 == a)
+                _nodes[_nodes[up].parent].child1 = up;
+            else
+                _nodes[_nodes[up].parent].child2 = up;
+        }
+        else
+        {
+            _root = up;
+        }
+
+        // the higher grandchild stays under up, the other one replaces up under a
+        int keep = _nodes[f].height > _nodes[g].height ? f : g;
+        int move = keep == f ? g : f;
+        _nodes[up].child2 = keep;
+        if (heightBalance > 1)
+            nodeA.child2 = move;
+        else
+            nodeA.child1 = move;
+        _nodes[move].parent = a;
+
+        nodeA.aabb = mergeBoxes(_nodes[other].aabb, _nodes[move].aabb);
+        nodeA.height = 1 + std::max(_nodes[other].height, _nodes[move].height);
+        _nodes[up].aabb = mergeBoxes(nodeA.aabb, _nodes[keep].aabb);
+        _nodes[up].height = 1 + std::max(nodeA.height, _nodes[keep].height);
+        return up;
+    }
+
+    return a;
+}
+
+void AABBTree::query(const AABB& aabb, const std::function<bool(int proxy)>& callback) const
+{
+    if (_root == NULL_PROXY)
+        return;
+
+    std::vector<int> stack;
+    stack.reserve(64);
+    stack.push_back(_root);
+    while (!stack.empty())
+    {
+        int index = stack.back();
+        stack.pop_back();
+
+        const auto& node = _nodes[index];
+        if (!node.aabb.intersects(aabb))
+            continue;
+
+        if (node.isLeaf())
+        {
+            if (!callback(index))
+                return;
+        }
+        else
+        {
+            stack.push_back(node.child1);
+            stack.push_back(node.child2);
+        }
+    }
+}
+
+void AABBTree::query(const Frustum& frustum, const std::function<bool(int proxy)>& callback) const
+{
+    if (_root == NULL_PROXY)
+        return;
+
+    // the second value tells whether the node is known to be inside the frustum
+    std::vector<std::pair<int, bool>> stack;
+    stack.reserve(64);
+    stack.push_back(std::make_pair(_root, false));
+    while (!stack.empty())
+    {
+        int index = stack.back().first;
+        bool inside = stack.back().second;
+        stack.pop_back();
+
+        const auto& node = _nodes[index];
+        if (!inside)
+        {
+            if (frustum.isOutOfFrustum(node.aabb))
+                continue;
+            inside = frustum.containsAABB(node.aabb);
+        }
+
+        if (node.isLeaf())
+        {
+            if (!callback(index))
+                return;
+        }
+        else
+        {
+            stack.push_back(std::make_pair(node.child1, inside));
+            stack.push_back(std::make_pair(node.child2, inside));
+        }
+    }
+}
+
+void AABBTree::rayCast(const Ray& ray, float maxDistance, const std::function<float(int proxy, float distance)>& callback) const
+{
+    if (_root == NULL_PROXY)
+        return;
+
+    std::vector<int> stack;
+    stack.reserve(64);
+    stack.push_back(_root);
+    while (!stack.empty())
+    {
+        int index = stack.back();
+        stack.pop_back();
+
+        const auto& node = _nodes[index];
+        float distance = 0.0f;
+        if (!ray.intersects(node.aabb, &distance) || distance > maxDistance)
+            continue;
+
+        if (node.isLeaf())
+        {
+            maxDistance = callback(index, distance);
+            if (maxDistance < 0.0f)
+                return;
+        }
+        else
+        {
+            stack.push_back(node.child1);
+            stack.push_back(node.child2);
+        }
+    }
+}
+
 NS_CC_END
@@ -25,11 +25,17 @@
 #ifndef __CC_AABB_H__
 #define __CC_AABB_H__
 
+#include <functional>
+#include <vector>
+
 #include "base/ccMacros.h"
 #include "math/CCMath.h"
 
 NS_CC_BEGIN
 
+class Frustum;
+class Ray;
+
 /**
  * @addtogroup _3d
  * @{
@@ -124,6 +130,117 @@ public:
     Vec3 _max;
 };
 
+/**
+ * Boxes stored as arrays of their coordinates, so that Frustum::cullAABBs can test four of them at once.
+ * @since v3.14
+ */
+class CC_DLL AABBArray
+{
+public:
+    /** Appends a box. */
+    void push_back(const AABB& aabb);
+
+    /** Replaces the box at index. */
+    void set(size_t index, const AABB& aabb);
+
+    /** Removes all the boxes, keeping the memory. */
+    void clear();
+
+    /** Reserves room for count boxes. */
+    void reserve(size_t count);
+
+    /** Returns the number of boxes. */
+    size_t size() const { return minX.size(); }
+
+    std::vector<float> minX, minY, minZ;
+    std::vector<float> maxX, maxY, maxZ;
+};
+
+/**
+ * A dynamic bounding volume hierarchy of AABBs, to cull, pick and query many objects without testing each of them.
+ * Each object is a proxy, a leaf storing a box enlarged by a margin so that small moves don't change the tree.
+ * Leaves are inserted next to the sibling that grows the surface of the tree the least, and the tree is kept
+ * balanced with rotations, so that queries stay logarithmic while objects are added, moved and removed.
+ * @since v3.14
+ */
+class CC_DLL AABBTree
+{
+public:
+    /** An invalid proxy. */
+    static const int NULL_PROXY = -1;
+
+    /**
+     * Constructor.
+     * @param margin The fraction of their size the boxes are enlarged by in the leaves.
+     */
+    explicit AABBTree(float margin = 0.1f);
+
+    /** Adds an object and returns its proxy. */
+    int createProxy(const AABB& aabb, void* userData);
+
+    /** Removes an object. */
+    void destroyProxy(int proxy);
+
+    /** Updates the box of an object, returns true if it left the enlarged box and was reinserted. */
+    bool moveProxy(int proxy, const AABB& aabb);
+
+    /** Returns the user data of a proxy. */
+    void* getUserData(int proxy) const { return _nodes[proxy].userData; }
+
+    /** Returns the enlarged box of a proxy. */
+    const AABB& getFatAABB(int proxy) const { return _nodes[proxy].aabb; }
+
+    /** Returns the number of proxies. */
+    int getProxyCount() const { return _proxyCount; }
+
+    /** Returns the height of the tree, 0 for a single leaf. */
+    int getHeight() const { return _root == NULL_PROXY ? 0 : _nodes[_root].height; }
+
+    /** Removes all the proxies. */
+    void clear();
+
+    /** Calls the callback for each proxy whose enlarged box intersects aabb, until it returns false. */
+    void query(const AABB& aabb, const std::function<bool(int proxy)>& callback) const;
+
+    /**
+     * Calls the callback for each proxy whose enlarged box isn't out of the frustum, until it returns false.
+     * The subtrees inside the frustum are reported without testing their leaves.
+     */
+    void query(const Frustum& frustum, const std::function<bool(int proxy)>& callback) const;
+
+    /**
+     * Calls the callback for each proxy whose enlarged box is hit by the ray closer than maxDistance,
+     * with the distance of the hit, 0 when the ray starts inside. The callback returns the new maximum distance,
+     * e.g. the distance of an exact hit to only look for closer ones, or a negative value to stop.
+     */
+    void rayCast(const Ray& ray, float maxDistance, const std::function<float(int proxy, float distance)>& callback) const;
+
+protected:
+    struct TreeNode
+    {
+        AABB aabb;
+        void* userData;
+        int parent; // next free node when the node is in the free list
+        int child1;
+        int child2;
+        int height; // 0 for a leaf, -1 for a free node
+
+        bool isLeaf() const { return child1 == NULL_PROXY; }
+    };
+
+    int allocateNode();
+    void freeNode(int node);
+    void insertLeaf(int leaf);
+    void removeLeaf(int leaf);
+    int balance(int node);
+
+    std::vector<TreeNode> _nodes;
+    int _root;
+    int _freeList;
+    int _proxyCount;
+    float _margin;
+};
+
 // end of 3d group
 /// @}
 
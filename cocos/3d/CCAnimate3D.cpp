@@ -30,6 +30,8 @@
 #include "base/CCEventCustom.h"
 #include "base/CCDirector.h"
 #include "base/CCEventDispatcher.h"
+#include "base/CCEventListenerCustom.h"
+#include "base/CCAsyncTaskPool.h"
 
 NS_CC_BEGIN
 
@@ -38,6 +40,11 @@ std::unordered_map<Node*, Animate3D*> Animate3D::s_fadeOutAnimates;
 std::unordered_map<Node*, Animate3D*> Animate3D::s_runningAnimates;
 float      Animate3D::_transTime = 0.1f;
 
+static bool s_parallelUpdateEnabled = false;
+static Vector<Animate3D*> s_parallelUpdateQueue;
+static unsigned int s_parallelUpdateFrame = 0;
+static EventListenerCustom* s_parallelUpdateListener = nullptr;
+
 //create Animate3D using Animation.
 Animate3D* Animate3D::create(Animation3D* animation)
 {
@@ -333,8 +340,6 @@ void Animate3D::update(float t)
         {
             if (_weight > 0.0f)
             {
-                float transDst[3], rotDst[4], scaleDst[3];
-                float* trans = nullptr, *rot = nullptr, *scale = nullptr;
                 if (_playReverse){
                     t = 1 - t;
                     lastTime = 1.0f - lastTime;
@@ -343,27 +348,12 @@ void Animate3D::update(float t)
                 t = _start + t * _last;
                 lastTime = _start + lastTime * _last;
                 
-                for (const auto& it : _boneCurves) {
-                    auto bone = it.first;
-                    auto curve = it.second;
-                    if (curve->translateCurve)
-                    {
-                        curve->translateCurve->evaluate(t, transDst, _translateEvaluate);
-                        trans = &transDst[0];
-                    }
-                    if (curve->rotCurve)
-                    {
-                        curve->rotCurve->evaluate(t, rotDst, _roteEvaluate);
-                        rot = &rotDst[0];
-                    }
-                    if (curve->scaleCurve)
-                    {
-                        curve->scaleCurve->evaluate(t, scaleDst, _scaleEvaluate);
-                        scale = &scaleDst[0];
-                    }
-                    bone->setAnimationValue(trans, rot, scale, this, _weight);
-                }
+                if (s_parallelUpdateEnabled && !_boneCurves.empty())
+                    queueParallelUpdate(t);
+                else
+                    evaluateBoneCurves(t);
                 
+                float transDst[3], rotDst[4], scaleDst[3];
                 for (const auto& it : _nodeCurves)
                 {
                     auto node = it.first;
@@ -417,6 +407,126 @@ void Animate3D::update(float t)
     }
 }
 
+void Animate3D::evaluateBoneCurves(float t)
+{
+    float transDst[3], rotDst[4], scaleDst[3];
+    float* trans = nullptr, *rot = nullptr, *scale = nullptr;
+    for (const auto& it : _boneCurves) {
+        auto bone = it.first;
+        auto curve = it.second;
+        if (curve->translateCurve)
+        {
+            curve->translateCurve->evaluate(t, transDst, _translateEvaluate);
+            trans = &transDst[0];
+        }
+        if (curve->rotCurve)
+        {
+            curve->rotCurve->evaluate(t, rotDst, _roteEvaluate);
+            rot = &rotDst[0];
+        }
+        if (curve->scaleCurve)
+        {
+            curve->scaleCurve->evaluate(t, scaleDst, _scaleEvaluate);
+            scale = &scaleDst[0];
+        }
+        bone->setAnimationValue(trans, rot, scale, this, _weight);
+    }
+}
+
+void Animate3D::setParallelUpdateEnabled(bool enabled)
+{
+    if (s_parallelUpdateEnabled == enabled)
+        return;
+
+    s_parallelUpdateEnabled = enabled;
+    if (!enabled)
+    {
+        runParallelUpdate();
+        if (s_parallelUpdateListener)
+        {
+            Director::getInstance()->getEventDispatcher()->removeEventListener(s_parallelUpdateListener);
+            CC_SAFE_RELEASE_NULL(s_parallelUpdateListener);
+        }
+    }
+}
+
+bool Animate3D::isParallelUpdateEnabled()
+{
+    return s_parallelUpdateEnabled;
+}
+
+void Animate3D::queueParallelUpdate(float t)
+{
+    auto director = Director::getInstance();
+
+    // The queue is emptied after the update of every frame, unless the listener was removed with all the others.
+    if (!s_parallelUpdateQueue.empty() && s_parallelUpdateFrame != director->getTotalFrames())
+    {
+        runParallelUpdate();
+        director->getEventDispatcher()->removeEventListener(s_parallelUpdateListener);
+        CC_SAFE_RELEASE_NULL(s_parallelUpdateListener);
+    }
+    if (!s_parallelUpdateListener)
+    {
+        s_parallelUpdateListener = director->getEventDispatcher()->addCustomEventListener(Director::EVENT_AFTER_UPDATE, [](EventCustom*) {
+            runParallelUpdate();
+        });
+        s_parallelUpdateListener->retain();
+    }
+    s_parallelUpdateFrame = director->getTotalFrames();
+
+    // updated twice in a frame, only the last time is evaluated
+    bool queued = _parallelUpdateTime >= 0;
+    _parallelUpdateTime = t;
+    if (!queued)
+        s_parallelUpdateQueue.pushBack(this);
+}
+
+void Animate3D::runParallelUpdate()
+{
+    if (s_parallelUpdateQueue.empty())
+        return;
+
+    // the animates stay retained by the queue until they are evaluated
+    Vector<Animate3D*> animates;
+    std::swap(animates, s_parallelUpdateQueue);
+
+    // Animates blending into the same bones must run on the same worker, group them by target
+    // and keep their update order so that the blend is the same as the serial one.
+    std::unordered_map<Node*, size_t> groupIndices;
+    std::vector<std::vector<Animate3D*>> groups;
+    for (auto animate : animates)
+    {
+        if (!animate->_target)
+            continue;
+
+        auto it = groupIndices.find(animate->_target);
+        if (it == groupIndices.end())
+        {
+            groupIndices[animate->_target] = groups.size();
+            groups.push_back(std::vector<Animate3D*>(1, animate));
+        }
+        else
+            groups[it->second].push_back(animate);
+    }
+
+    JobSystem::getInstance()->parallelFor(groups.size(), 1, [&groups](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            const auto& group = groups[i];
+            for (auto animate : group)
+                animate->evaluateBoneCurves(animate->_parallelUpdateTime);
+
+            auto sprite = dynamic_cast<Sprite3D*>(group.front()->_target);
+            if (sprite)
+                sprite->updateSkinning();
+        }
+    });
+
+    for (auto animate : animates)
+        animate->_parallelUpdateTime = -1;
+}
+
 float Animate3D::getSpeed() const
 {
     return _playReverse ? -_absSpeed : _absSpeed;
@@ -496,6 +606,7 @@ Animate3D::Animate3D()
 , _lastTime(0.0f)
 , _originInterval(0.0f)
 , _frameRate(30.0f)
+, _parallelUpdateTime(-1)
 {
     setQuality(Animate3DQuality::QUALITY_HIGH);
 }
@@ -119,6 +119,16 @@ public:
     /**get animate quality*/
     Animate3DQuality getQuality() const;
 
+    /**
+     * Enable or disable the parallel update. When enabled, the bone curves of all running Animate3Ds are
+     * evaluated after the scheduler update on the JobSystem workers, one target per task, and the bone
+     * matrices and skin palettes of the Sprite3D targets are computed there too. Curves driving plain
+     * nodes and key frame events stay on the main thread. Disabled by default.
+     * @since v3.14
+     */
+    static void setParallelUpdateEnabled(bool enabled);
+    static bool isParallelUpdateEnabled();
+
 
     struct Animate3DDisplayedEventInfo
     {
@@ -146,6 +156,13 @@ CC_CONSTRUCTOR_ACCESS:
     
 protected:
     
+    // evaluate the bone curves at t (0 - 1 of the whole animation) and blend them into the bones
+    void evaluateBoneCurves(float t);
+    
+    // defer evaluateBoneCurves to the parallel update of this frame
+    void queueParallelUpdate(float t);
+    static void runParallelUpdate();
+    
     enum class Animate3DState
     {
         FadeIn,
@@ -171,6 +188,7 @@ protected:
     EvaluateType _roteEvaluate;
     EvaluateType _scaleEvaluate;
     Animate3DQuality _quality;
+    float      _parallelUpdateTime; // t queued for the parallel update, -1 if not queued
     
     std::unordered_map<Bone3D*, Animation3D::Curve*> _boneCurves; //weak ref
     std::unordered_map<Node*, Animation3D::Curve*> _nodeCurves;
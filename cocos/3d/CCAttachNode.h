@@ -64,6 +64,9 @@ CC_CONSTRUCTOR_ACCESS:
     
 
 protected:
+    // follows the bone every frame, without dirty flags
+    virtual bool isTransformFlattenable() const override { return false; }
+
     Bone3D* _attachBone;
     mutable Mat4    _transformToParent;
 };
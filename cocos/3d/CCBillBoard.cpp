@@ -28,12 +28,16 @@
 #include "2d/CCCamera.h"
 #include "renderer/CCRenderer.h"
 #include "renderer/CCGLProgramCache.h"
+#include "renderer/ccGLStateCache.h"
+#include "base/CCEventListenerCustom.h"
+#include "base/CCEventType.h"
 
 NS_CC_BEGIN
 
 BillBoard::BillBoard()
 : _mode(Mode::VIEW_POINT_ORIENTED)
 , _modeDirty(false)
+, _billBoardBatch(nullptr)
 {
     Node::setAnchorPoint(Vec2(0.5f,0.5f));
 }
@@ -110,6 +114,12 @@ void BillBoard::visit(Renderer *renderer, const Mat4& parentTransform, uint32_t
     }
     
     uint32_t flags = processParentFlags(parentTransform, parentFlags);
+
+    // the batch turns the quad towards the camera in its vertex shader
+    if (_billBoardBatch && _children.empty() && _billBoardBatch->appendBillBoard(this))
+    {
+        return;
+    }
     
     //Add 3D flag so all the children will be rendered as 3D object
     flags |= FLAGS_RENDER_AS_3D;
@@ -231,7 +241,18 @@ bool BillBoard::calculateBillbaordTransform()
 
 void BillBoard::draw(Renderer *renderer, const Mat4 &/*transform*/, uint32_t flags)
 {
-    //FIXME: frustum culling here
+#if CC_USE_CULLING
+    // the quad, turned towards the camera
+    auto camera = Camera::getVisitingCamera();
+    if (camera && renderer->isCullingEnabled())
+    {
+        AABB aabb(Vec3::ZERO, Vec3(_contentSize.width, _contentSize.height, 0.0f));
+        aabb.transform(_modelViewTransform);
+        if (!camera->isVisibleInFrustum(&aabb))
+            return;
+    }
+#endif
+
     flags |= Node::FLAGS_RENDER_AS_3D;
     _trianglesCommand.init(0, _texture->getName(), getGLProgramState(), _blendFunc, _polyInfo.triangles, _modelViewTransform, flags);
     _trianglesCommand.setTransparent(true);
@@ -250,4 +271,401 @@ BillBoard::Mode BillBoard::getMode() const
     return _mode;
 }
 
+//
+// BillBoardBatchNode
+//
+static const char* s_billBoardBatchKey = "BillBoardBatchNode";
+
+// the same facing as BillBoard::calculateBillboardTransform, a_texCoord1.z is 0 for VIEW_POINT_ORIENTED and 1 for VIEW_PLANE_ORIENTED
+static const char* s_billBoardBatchVert = R"(
+attribute vec4 a_position;
+attribute vec4 a_color;
+attribute vec2 a_texCoord;
+attribute vec3 a_texCoord1;
+
+uniform vec3 u_cameraPosition;
+uniform vec3 u_cameraUp;
+uniform vec3 u_cameraForward;
+
+#ifdef GL_ES
+varying lowp vec4 v_fragmentColor;
+varying mediump vec2 v_texCoord;
+#else
+varying vec4 v_fragmentColor;
+varying vec2 v_texCoord;
+#endif
+
+void main()
+{
+    vec3 camDir = mix(a_position.xyz - u_cameraPosition, u_cameraForward, a_texCoord1.z);
+    if (dot(camDir, camDir) < 1e-12)
+    {
+        camDir = -u_cameraForward;
+    }
+    camDir = normalize(camDir);
+    vec3 x = normalize(cross(camDir, u_cameraUp));
+    vec3 y = normalize(cross(x, camDir));
+    gl_Position = CC_MVPMatrix * vec4(a_position.xyz + x * a_texCoord1.x + y * a_texCoord1.y, 1.0);
+    v_fragmentColor = a_color;
+    v_texCoord = a_texCoord;
+}
+)";
+
+static const char* s_billBoardBatchFrag = R"(
+#ifdef GL_ES
+precision lowp float;
+#endif
+
+varying vec4 v_fragmentColor;
+varying vec2 v_texCoord;
+
+void main()
+{
+    gl_FragColor = v_fragmentColor * texture2D(CC_Texture0, v_texCoord);
+}
+)";
+
+static const size_t BILLBOARD_BATCH_MAX_VERTICES = 65536;
+
+BillBoardBatchNode* BillBoardBatchNode::create()
+{
+    auto ret = new (std::nothrow) BillBoardBatchNode();
+    if (ret && ret->init())
+    {
+        ret->autorelease();
+        return ret;
+    }
+
+    CC_SAFE_DELETE(ret);
+    return nullptr;
+}
+
+BillBoardBatchNode::BillBoardBatchNode()
+: _usedBatches(0)
+, _visitBatches(0)
+, _lastFrame(0)
+, _glProgram(nullptr)
+, _uniformCameraPosition(-1)
+, _uniformCameraUp(-1)
+, _uniformCameraForward(-1)
+{
+}
+
+BillBoardBatchNode::~BillBoardBatchNode()
+{
+    for (auto&& child : _children)
+    {
+        auto billboard = dynamic_cast<BillBoard*>(child);
+        if (billboard)
+        {
+            billboard->_billBoardBatch = nullptr;
+        }
+    }
+
+    for (auto&& batch : _batches)
+    {
+        glDeleteBuffers(2, batch->buffers);
+        delete batch;
+    }
+}
+
+bool BillBoardBatchNode::init()
+{
+    if (!Node::init())
+        return false;
+
+    initGLProgram();
+
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+    auto listener = EventListenerCustom::create(EVENT_RENDERER_RECREATED, CC_CALLBACK_1(BillBoardBatchNode::listenRendererRecreated, this));
+    _eventDispatcher->addEventListenerWithSceneGraphPriority(listener, this);
+#endif
+    return true;
+}
+
+void BillBoardBatchNode::initGLProgram()
+{
+    _glProgram = GLProgramCache::getInstance()->getGLProgram(s_billBoardBatchKey);
+    if (_glProgram == nullptr)
+    {
+        _glProgram = GLProgram::createWithByteArrays(s_billBoardBatchVert, s_billBoardBatchFrag);
+        GLProgramCache::getInstance()->addGLProgram(_glProgram, s_billBoardBatchKey);
+    }
+
+    _uniformCameraPosition = _glProgram->getUniformLocation("u_cameraPosition");
+    _uniformCameraUp = _glProgram->getUniformLocation("u_cameraUp");
+    _uniformCameraForward = _glProgram->getUniformLocation("u_cameraForward");
+}
+
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+void BillBoardBatchNode::listenRendererRecreated(EventCustom* /*event*/)
+{
+    // the buffers are generated again on the next draw
+    for (auto&& batch : _batches)
+    {
+        batch->buffers[0] = batch->buffers[1] = 0;
+    }
+
+    auto glProgram = GLProgramCache::getInstance()->getGLProgram(s_billBoardBatchKey);
+    if (glProgram)
+    {
+        glProgram->reset();
+        glProgram->initWithByteArrays(s_billBoardBatchVert, s_billBoardBatchFrag);
+        glProgram->link();
+        glProgram->updateUniforms();
+    }
+    initGLProgram();
+}
+#endif
+
+void BillBoardBatchNode::addChild(Node* child, int localZOrder, int tag)
+{
+    CCASSERT(child != nullptr, "child should not be null");
+    Node::addChild(child, localZOrder, tag);
+
+    auto billboard = dynamic_cast<BillBoard*>(child);
+    if (billboard)
+    {
+        billboard->_billBoardBatch = this;
+    }
+}
+
+void BillBoardBatchNode::addChild(Node* child, int localZOrder, const std::string& name)
+{
+    CCASSERT(child != nullptr, "child should not be null");
+    Node::addChild(child, localZOrder, name);
+
+    auto billboard = dynamic_cast<BillBoard*>(child);
+    if (billboard)
+    {
+        billboard->_billBoardBatch = this;
+    }
+}
+
+void BillBoardBatchNode::removeChild(Node* child, bool cleanup)
+{
+    auto billboard = dynamic_cast<BillBoard*>(child);
+    if (billboard && billboard->_billBoardBatch == this)
+    {
+        billboard->_billBoardBatch = nullptr;
+    }
+
+    Node::removeChild(child, cleanup);
+}
+
+void BillBoardBatchNode::removeAllChildrenWithCleanup(bool cleanup)
+{
+    for (auto&& child : _children)
+    {
+        auto billboard = dynamic_cast<BillBoard*>(child);
+        if (billboard)
+        {
+            billboard->_billBoardBatch = nullptr;
+        }
+    }
+
+    Node::removeAllChildrenWithCleanup(cleanup);
+}
+
+void BillBoardBatchNode::visit(Renderer* renderer, const Mat4& parentTransform, uint32_t parentFlags)
+{
+    if (!_visible)
+    {
+        return;
+    }
+
+    // the commands of the previous frame have been rendered, their batches can be refilled
+    auto frame = _director->getTotalFrames();
+    if (frame != _lastFrame)
+    {
+        _lastFrame = frame;
+        _usedBatches = 0;
+    }
+    _visitBatches = _usedBatches;
+
+    // the billboards append themselves from BillBoard::visit
+    Node::visit(renderer, parentTransform, parentFlags);
+
+    for (auto i = _visitBatches; i < _usedBatches; ++i)
+    {
+        auto batch = _batches[i];
+        buildBatch(batch);
+
+        // the batch is sorted among the transparent commands by its center
+        Vec3 center;
+        for (auto&& item : batch->items)
+        {
+            center += item.center;
+        }
+        center *= 1.0f / batch->items.size();
+        Mat4 transform;
+        Mat4::createTranslation(center, &transform);
+
+        batch->command.init(_globalZOrder, transform, Node::FLAGS_RENDER_AS_3D);
+        batch->command.setTransparent(true);
+        batch->command.func = CC_CALLBACK_0(BillBoardBatchNode::onDraw, this, batch);
+        renderer->addCommand(&batch->command);
+    }
+}
+
+bool BillBoardBatchNode::appendBillBoard(BillBoard* billboard)
+{
+    auto camera = Camera::getVisitingCamera();
+    auto texture = billboard->getTexture();
+    // custom shaders draw by themselves
+    if (!camera || !texture || billboard->getGLProgram() != GLProgramCache::getInstance()->getGLProgram(GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR_NO_MVP))
+    {
+        return false;
+    }
+
+    // the position and the scale are kept, the rotation is replaced by the facing like in calculateBillboardTransform()
+    const Mat4& transform = billboard->_modelViewTransform;
+    const Vec2& anchorPoint = billboard->_anchorPointInPoints;
+    Vec3 center;
+    transform.transformPoint(Vec3(anchorPoint.x, anchorPoint.y, 0.0f), &center);
+    Vec2 scale(sqrtf(transform.m[0] * transform.m[0] + transform.m[1] * transform.m[1] + transform.m[2] * transform.m[2]),
+               sqrtf(transform.m[4] * transform.m[4] + transform.m[5] * transform.m[5] + transform.m[6] * transform.m[6]));
+
+#if CC_USE_CULLING
+    // the quad turns around its anchor point, so it stays in this sphere
+    const Size& size = billboard->_contentSize;
+    float radiusX = std::max(anchorPoint.x, size.width - anchorPoint.x) * scale.x;
+    float radiusY = std::max(anchorPoint.y, size.height - anchorPoint.y) * scale.y;
+    float radius = sqrtf(radiusX * radiusX + radiusY * radiusY);
+    AABB aabb(center - Vec3(radius, radius, radius), center + Vec3(radius, radius, radius));
+    if (Director::getInstance()->getRenderer()->isCullingEnabled() && !camera->isVisibleInFrustum(&aabb))
+    {
+        return true;
+    }
+#endif
+
+    Batch* batch = nullptr;
+    for (auto i = _visitBatches; i < _usedBatches; ++i)
+    {
+        auto candidate = _batches[i];
+        if (candidate->texture == texture && candidate->blendFunc == billboard->getBlendFunc())
+        {
+            batch = candidate;
+            break;
+        }
+    }
+
+    if (batch == nullptr)
+    {
+        if (_usedBatches == _batches.size())
+        {
+            auto newBatch = new (std::nothrow) Batch();
+            newBatch->buffers[0] = newBatch->buffers[1] = 0;
+            _batches.push_back(newBatch);
+        }
+        batch = _batches[_usedBatches++];
+        batch->texture = texture;
+        batch->blendFunc = billboard->getBlendFunc();
+        batch->items.clear();
+    }
+
+    const Mat4& cameraTransform = camera->getNodeToWorldTransform();
+    Vec3 cameraPosition(cameraTransform.m[12], cameraTransform.m[13], cameraTransform.m[14]);
+    Vec3 cameraBackward(cameraTransform.m[8], cameraTransform.m[9], cameraTransform.m[10]);
+
+    Item item;
+    item.billboard = billboard;
+    item.center = center;
+    item.scale = scale;
+    item.depth = -Vec3::dot(center - cameraPosition, cameraBackward);
+    batch->items.push_back(item);
+    return true;
+}
+
+void BillBoardBatchNode::buildBatch(Batch* batch)
+{
+    const Mat4& cameraTransform = Camera::getVisitingCamera()->getNodeToWorldTransform();
+    batch->cameraPosition.set(cameraTransform.m[12], cameraTransform.m[13], cameraTransform.m[14]);
+    cameraTransform.transformVector(Vec3(0.0f, 1.0f, 0.0f), &batch->cameraUp);
+    cameraTransform.transformVector(Vec3(0.0f, 0.0f, -1.0f), &batch->cameraForward);
+    batch->cameraForward.normalize();
+
+    // back to front, like the transparent render queue
+    std::sort(batch->items.begin(), batch->items.end(), [](const Item& a, const Item& b) {
+        return a.depth > b.depth;
+    });
+
+    batch->vertices.clear();
+    batch->indices.clear();
+    batch->ranges.clear();
+    Range range = { 0, 0, 0 };
+    for (auto&& item : batch->items)
+    {
+        auto billboard = item.billboard;
+        const TrianglesCommand::Triangles& triangles = billboard->_polyInfo.triangles;
+        if (batch->vertices.size() - range.firstVertex + triangles.vertCount > BILLBOARD_BATCH_MAX_VERTICES)
+        {
+            batch->ranges.push_back(range);
+            range.firstVertex = batch->vertices.size();
+            range.firstIndex = batch->indices.size();
+            range.indexCount = 0;
+        }
+
+        const Vec2& anchorPoint = billboard->_anchorPointInPoints;
+        float mode = billboard->_mode == BillBoard::Mode::VIEW_PLANE_ORIENTED ? 1.0f : 0.0f;
+        auto base = (GLushort)(batch->vertices.size() - range.firstVertex);
+        for (int i = 0; i < triangles.vertCount; ++i)
+        {
+            const V3F_C4B_T2F& source = triangles.verts[i];
+            Vertex vertex;
+            vertex.center = item.center;
+            vertex.corner.set((source.vertices.x - anchorPoint.x) * item.scale.x, (source.vertices.y - anchorPoint.y) * item.scale.y, mode);
+            vertex.color = source.colors;
+            vertex.texCoord = source.texCoords;
+            batch->vertices.push_back(vertex);
+        }
+        for (int i = 0; i < triangles.indexCount; ++i)
+        {
+            batch->indices.push_back(base + triangles.indices[i]);
+        }
+        range.indexCount += triangles.indexCount;
+    }
+    batch->ranges.push_back(range);
+}
+
+void BillBoardBatchNode::onDraw(Batch* batch)
+{
+    if (batch->buffers[0] == 0)
+    {
+        glGenBuffers(2, batch->buffers);
+    }
+
+    // the vertices are in world space already
+    _glProgram->use();
+    _glProgram->setUniformsForBuiltins(Mat4::IDENTITY);
+    _glProgram->setUniformLocationWith3f(_uniformCameraPosition, batch->cameraPosition.x, batch->cameraPosition.y, batch->cameraPosition.z);
+    _glProgram->setUniformLocationWith3f(_uniformCameraUp, batch->cameraUp.x, batch->cameraUp.y, batch->cameraUp.z);
+    _glProgram->setUniformLocationWith3f(_uniformCameraForward, batch->cameraForward.x, batch->cameraForward.y, batch->cameraForward.z);
+
+    GL::bindTexture2D(batch->texture->getName());
+    GL::blendFunc(batch->blendFunc.src, batch->blendFunc.dst);
+    GL::enableVertexAttribs((1 << (GLProgram::VERTEX_ATTRIB_TEX_COORD1 + 1)) - 1);
+
+    glBindBuffer(GL_ARRAY_BUFFER, batch->buffers[0]);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(Vertex) * batch->vertices.size(), batch->vertices.data(), GL_DYNAMIC_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, batch->buffers[1]);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(GLushort) * batch->indices.size(), batch->indices.data(), GL_DYNAMIC_DRAW);
+
+    for (auto&& range : batch->ranges)
+    {
+        const char* base = (const char*)(sizeof(Vertex) * range.firstVertex);
+        glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), base + offsetof(Vertex, center));
+        glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(Vertex), base + offsetof(Vertex, color));
+        glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORD, 2, GL_FLOAT, GL_FALSE, sizeof(Vertex), base + offsetof(Vertex, texCoord));
+        glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORD1, 3, GL_FLOAT, GL_FALSE, sizeof(Vertex), base + offsetof(Vertex, corner));
+        glDrawElements(GL_TRIANGLES, (GLsizei)range.indexCount, GL_UNSIGNED_SHORT, (GLvoid*)(sizeof(GLushort) * range.firstIndex));
+    }
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+    CC_INCREMENT_GL_DRAWN_BATCHES_AND_VERTICES(batch->ranges.size(), batch->vertices.size());
+    CHECK_GL_ERROR_DEBUG();
+}
+
 NS_CC_END
@@ -25,9 +25,14 @@
 #ifndef __CCBILLBOARD_H__
 #define __CCBILLBOARD_H__
 
+#include <vector>
 #include "2d/CCSprite.h"
+#include "renderer/CCCustomCommand.h"
 
 NS_CC_BEGIN
+
+class BillBoardBatchNode;
+class EventCustom;
 /**
  * @addtogroup _3d
  * @{
@@ -110,6 +115,9 @@ CC_CONSTRUCTOR_ACCESS:
 
 protected:
 
+    // the billboard transform depends on the visiting camera
+    virtual bool isTransformFlattenable() const override { return false; }
+
     /**
      * calculate a model matrix which keep original translate & scaling but always face to the camera
      */
@@ -124,9 +132,110 @@ protected:
     Mode _mode;
     bool _modeDirty;
 
+    // the BillBoardBatchNode parent drawing the billboard, or nullptr
+    BillBoardBatchNode* _billBoardBatch;
+
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(BillBoard);
 
+    friend class BillBoardBatchNode;
+};
+
+/**
+ * @brief BillBoardBatchNode draws its BillBoard children with one draw call per texture and blend function.
+ *
+ * The billboards append their center, their scaled corners, colors and texture coordinates to a dynamic vertex
+ * buffer, and the vertex shader turns the corners towards the camera. So neither a facing matrix per billboard
+ * nor a command per billboard is needed, which suits foliage, name tags and other crowds of billboards.
+ * The billboards of a batch are sorted back to front, the batches themselves are sorted like other transparent commands.
+ *
+ * Only the direct children without children of their own and with the default shader are batched,
+ * the other children are drawn as usual.
+ * @since v3.14
+ */
+class CC_DLL BillBoardBatchNode : public Node
+{
+public:
+    /** Creates an empty BillBoardBatchNode. */
+    static BillBoardBatchNode* create();
+
+    using Node::addChild;
+    virtual void addChild(Node* child, int localZOrder, int tag) override;
+    virtual void addChild(Node* child, int localZOrder, const std::string& name) override;
+    virtual void removeChild(Node* child, bool cleanup = true) override;
+    virtual void removeAllChildrenWithCleanup(bool cleanup) override;
+    virtual void visit(Renderer* renderer, const Mat4& parentTransform, uint32_t parentFlags) override;
+
+CC_CONSTRUCTOR_ACCESS:
+    BillBoardBatchNode();
+    virtual ~BillBoardBatchNode();
+    virtual bool init() override;
+
+protected:
+    struct Vertex
+    {
+        Vec3 center;
+        // the corner in the billboard plane, z is the mode
+        Vec3 corner;
+        Color4B color;
+        Tex2F texCoord;
+    };
+
+    struct Item
+    {
+        BillBoard* billboard;
+        Vec3 center;
+        Vec2 scale;
+        float depth;
+    };
+
+    // the indices are GLushort, so a batch is drawn in ranges of at most 65536 vertices
+    struct Range
+    {
+        size_t firstVertex;
+        size_t firstIndex;
+        size_t indexCount;
+    };
+
+    struct Batch
+    {
+        Texture2D* texture;
+        BlendFunc blendFunc;
+        std::vector<Item> items;
+        std::vector<Vertex> vertices;
+        std::vector<GLushort> indices;
+        std::vector<Range> ranges;
+        Vec3 cameraPosition;
+        Vec3 cameraUp;
+        Vec3 cameraForward;
+        GLuint buffers[2];
+        CustomCommand command;
+    };
+
+    /** Adds the billboard to the batch of its texture, returns false if it can't be batched. */
+    bool appendBillBoard(BillBoard* billboard);
+    /** Sorts the billboards of the batch back to front and writes their vertices. */
+    void buildBatch(Batch* batch);
+    void onDraw(Batch* batch);
+    void initGLProgram();
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+    void listenRendererRecreated(EventCustom* event);
+#endif
+
+    // the batches in use this frame are [0, _usedBatches), the ones of the current visit start at _visitBatches
+    std::vector<Batch*> _batches;
+    size_t _usedBatches;
+    size_t _visitBatches;
+    unsigned int _lastFrame;
+    GLProgram* _glProgram;
+    GLint _uniformCameraPosition;
+    GLint _uniformCameraUp;
+    GLint _uniformCameraForward;
+
+private:
+    CC_DISALLOW_COPY_AND_ASSIGN(BillBoardBatchNode);
+
+    friend class BillBoard;
 };
 
 // end of 3d group
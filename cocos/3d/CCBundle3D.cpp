@@ -24,6 +24,7 @@ THE SOFTWARE.
 
 #include "3d/CCBundle3D.h"
 #include "3d/CCObjLoader.h"
+#include "3d/CCMeshOptimizer.h"
 
 #include "base/ccMacros.h"
 #include "platform/CCFileUtils.h"
@@ -162,6 +163,7 @@ void Bundle3D::clear()
     if (_isBinary)
     {
         _binaryBuffer.clear();
+        _mappedFile.reset();
         CC_SAFE_DELETE_ARRAY(_references);
     }
     else
@@ -321,6 +323,8 @@ bool Bundle3D::loadObj(MeshDatas& meshdatas, MaterialDatas& materialdatas, NodeD
                 node->modelNodeDatas.push_back(modelnode);
             }
             nodedatas.nodes.push_back(node);
+            // the obj files repeat the vertices shared by their faces
+            MeshOptimizer::optimize(*meshdata, s_defaultMeshOptimization);
             meshdatas.meshDatas.push_back(meshdata);
         }
         
@@ -362,29 +366,36 @@ bool Bundle3D::loadAnimationData(const std::string& id, Animation3DData* animati
 bool Bundle3D::loadMeshDatas(MeshDatas& meshdatas)
 {
     meshdatas.resetData();
+    bool ret = false;
     if (_isBinary)
     {
         if (_version == "0.1" || _version == "0.2")
         {
-            return loadMeshDatasBinary_0_1(meshdatas);
+            ret = loadMeshDatasBinary_0_1(meshdatas);
         }
         else
         {
-            return loadMeshDatasBinary(meshdatas);
+            ret = loadMeshDatasBinary(meshdatas);
         }
     }
     else
     {
         if (_version == "1.2" || _version == "0.2")
         {
-            return loadMeshDataJson_0_1(meshdatas);
+            ret = loadMeshDataJson_0_1(meshdatas);
         }
         else
         {
-            return loadMeshDatasJson(meshdatas);
+            ret = loadMeshDatasJson(meshdatas);
         }
     }
-    return true;
+
+    if (ret && _meshOptimization != MeshOptimizer::NONE)
+    {
+        for (auto meshdata : meshdatas.meshDatas)
+            MeshOptimizer::optimize(*meshdata, _meshOptimization);
+    }
+    return ret;
 }
 bool  Bundle3D::loadMeshDatasBinary(MeshDatas& meshdatas)
 {
@@ -396,6 +407,8 @@ bool  Bundle3D::loadMeshDatasBinary(MeshDatas& meshdatas)
         CCLOG("warning: Failed to read meshdata: attribCount '%s'.", _path.c_str());
         return false;
     }
+    // the meshes stay in the mapping when their bounding boxes don't have to be computed from the vertices
+    const bool mapped = _mappedFile && _version != "0.3" && _version != "0.4" && _version != "0.5";
     MeshData*   meshData = nullptr;
     for(unsigned int i = 0; i < meshSize ; ++i)
     {
@@ -433,11 +446,26 @@ bool  Bundle3D::loadMeshDatasBinary(MeshDatas& meshdatas)
             goto FAILED;
         }
 
-        meshData->vertex.resize(vertexSizeInFloat);
-        if (_binaryReader.read(&meshData->vertex[0], 4, vertexSizeInFloat) != vertexSizeInFloat)
+        if (mapped)
         {
-            CCLOG("warning: Failed to read meshdata: vertex element '%s'.", _path.c_str());
-            goto FAILED;
+            meshData->mappedFile = _mappedFile;
+            meshData->mappedVertex = _mappedFile->getBytes() + _binaryReader.tell();
+            meshData->vertexSizeInFloat = vertexSizeInFloat;
+            if (_binaryReader.tell() + (ssize_t)vertexSizeInFloat * 4 > _binaryReader.length()
+                || !_binaryReader.seek((long int)vertexSizeInFloat * 4, SEEK_CUR))
+            {
+                CCLOG("warning: Failed to read meshdata: vertex element '%s'.", _path.c_str());
+                goto FAILED;
+            }
+        }
+        else
+        {
+            meshData->vertex.resize(vertexSizeInFloat);
+            if (_binaryReader.read(&meshData->vertex[0], 4, vertexSizeInFloat) != vertexSizeInFloat)
+            {
+                CCLOG("warning: Failed to read meshdata: vertex element '%s'.", _path.c_str());
+                goto FAILED;
+            }
         }
 
         // Read index data
@@ -455,14 +483,29 @@ bool  Bundle3D::loadMeshDatasBinary(MeshDatas& meshdatas)
                 CCLOG("warning: Failed to read meshdata: nIndexCount '%s'.", _path.c_str());
                 goto FAILED;
             }
-            indexArray.resize(nIndexCount);
-            if (_binaryReader.read(&indexArray[0], 2, nIndexCount) != nIndexCount)
+            if (mapped)
             {
-                CCLOG("warning: Failed to read meshdata: indices '%s'.", _path.c_str());
-                goto FAILED;
+                const void* indices = _mappedFile->getBytes() + _binaryReader.tell();
+                if (_binaryReader.tell() + (ssize_t)nIndexCount * 2 > _binaryReader.length()
+                    || !_binaryReader.seek((long int)nIndexCount * 2, SEEK_CUR))
+                {
+                    CCLOG("warning: Failed to read meshdata: indices '%s'.", _path.c_str());
+                    goto FAILED;
+                }
+                meshData->mappedSubMeshIndices.push_back(std::make_pair(indices, (ssize_t)nIndexCount));
+                meshData->numIndex = (int)meshData->mappedSubMeshIndices.size();
+            }
+            else
+            {
+                indexArray.resize(nIndexCount);
+                if (_binaryReader.read(&indexArray[0], 2, nIndexCount) != nIndexCount)
+                {
+                    CCLOG("warning: Failed to read meshdata: indices '%s'.", _path.c_str());
+                    goto FAILED;
+                }
+                meshData->subMeshIndices.push_back(indexArray);
+                meshData->numIndex = (int)meshData->subMeshIndices.size();
             }
-            meshData->subMeshIndices.push_back(indexArray);
-            meshData->numIndex = (int)meshData->subMeshIndices.size();
             //meshData->subMeshAABB.push_back(calculateAABB(meshData->vertex, meshData->getPerVertexSize(), indexArray));
             if (_version != "0.3" && _version != "0.4" && _version != "0.5")
             {
@@ -1078,18 +1121,28 @@ bool Bundle3D::loadBinary(const std::string& path)
 {
     clear();
     
-    // get file data
+    // get file data, mapped when the meshes may stay in the mapping
     _binaryBuffer.clear();
-    _binaryBuffer = FileUtils::getInstance()->getDataFromFile(path);
-    if (_binaryBuffer.isNull())
+    if (_mappedMeshesEnabled && _meshOptimization == MeshOptimizer::NONE)
+        _mappedFile.reset(FileUtils::getInstance()->mapFileContents(path));
+    if (_mappedFile)
     {
-        clear();
-        CCLOG("warning: Failed to read file: %s", path.c_str());
-        return false;
+        // the reader doesn't write to its buffer
+        _binaryReader.init((char*)_mappedFile->getBytes(), _mappedFile->getSize());
+    }
+    else
+    {
+        _binaryBuffer = FileUtils::getInstance()->getDataFromFile(path);
+        if (_binaryBuffer.isNull())
+        {
+            clear();
+            CCLOG("warning: Failed to read file: %s", path.c_str());
+            return false;
+        }
+        
+        // Initialise bundle reader
+        _binaryReader.init( (char*)_binaryBuffer.getBytes(),  _binaryBuffer.getSize() );
     }
-    
-    // Initialise bundle reader
-    _binaryReader.init( (char*)_binaryBuffer.getBytes(),  _binaryBuffer.getSize() );
     
     // Read identifier info
     char identifier[] = { 'C', '3', 'B', '\0'};
@@ -2219,10 +2272,14 @@ std::vector<Vec3> Bundle3D::getTrianglesList(const std::string& path)
     return trianglesList;
 }
 
+int Bundle3D::s_defaultMeshOptimization = MeshOptimizer::NONE;
+
 Bundle3D::Bundle3D()
 : _modelPath(""),
 _path(""),
 _version(""),
+_mappedMeshesEnabled(false),
+_meshOptimization(s_defaultMeshOptimization),
 _referenceCount(0),
 _references(nullptr),
 _isBinary(false)
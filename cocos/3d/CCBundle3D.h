@@ -80,6 +80,33 @@ public:
     
     //since 3.3, to support reskin
     virtual bool loadMeshDatas(MeshDatas& meshdatas);
+
+    /**
+     * Memory map .c3b bundles and leave the vertices and indices of the meshes loaded by loadMeshDatas()
+     * in the mapping, see MeshData::isMapped(), instead of copying them to the vectors of MeshData.
+     * Only the bundles storing their mesh bounding boxes are loaded this way. Disabled by default,
+     * Sprite3D enables it since it only uploads the meshes.
+     * @since v3.14
+     */
+    void setMappedMeshesEnabled(bool enabled) { _mappedMeshesEnabled = enabled; }
+    bool isMappedMeshesEnabled() const { return _mappedMeshesEnabled; }
+
+    /**
+     * Optimizes the meshes loaded by loadMeshDatas() with MeshOptimizer::optimize(). The meshes of an
+     * optimizing bundle are not left in the mapping. getDefaultMeshOptimization() by default.
+     * @param optimizations A combination of the MeshOptimizer::Optimization flags.
+     * @since v3.14
+     */
+    void setMeshOptimization(int optimizations) { _meshOptimization = optimizations; }
+    int getMeshOptimization() const { return _meshOptimization; }
+
+    /**
+     * Sets the optimizations of the new bundles and of loadObj(), so of the meshes loaded by Sprite3D.
+     * MeshOptimizer::NONE by default, the bundles written by a tool already optimizing them don't need it.
+     * @since v3.14
+     */
+    static void setDefaultMeshOptimization(int optimizations) { s_defaultMeshOptimization = optimizations; }
+    static int getDefaultMeshOptimization() { return s_defaultMeshOptimization; }
     //since 3.3, to support reskin
     virtual bool loadNodes(NodeDatas& nodedatas);
     //since 3.3, to support reskin
@@ -182,10 +209,15 @@ protected:
 
     // for binary reading
     Data _binaryBuffer;
+    std::shared_ptr<MappedFileData> _mappedFile; // the bundle when it is memory mapped instead of read in _binaryBuffer
+    bool _mappedMeshesEnabled;
+    int _meshOptimization;
     BundleReader _binaryReader;
     unsigned int _referenceCount;
     Reference* _references;
     bool  _isBinary;
+
+    static int s_defaultMeshOptimization;
 };
 
 // end of 3d group
@@ -32,9 +32,12 @@
 
 #include <vector>
 #include <map>
+#include <memory>
  
 NS_CC_BEGIN
 
+class MappedFileData;
+
 /**mesh vertex attribute
 * @js NA
 * @lua NA
@@ -43,7 +46,7 @@ struct MeshVertexAttrib
 {
     //attribute size
     GLint size;
-    //GL_FLOAT
+    //GL_FLOAT, or GL_SHORT, GL_UNSIGNED_SHORT and GL_UNSIGNED_BYTE for the quantized attributes of MeshVertexData
     GLenum type;
     //VERTEX_ATTRIB_POSITION,VERTEX_ATTRIB_COLOR,VERTEX_ATTRIB_TEX_COORD,VERTEX_ATTRIB_NORMAL, VERTEX_ATTRIB_BLEND_WEIGHT, VERTEX_ATTRIB_BLEND_INDEX, GLProgram for detail
     int  vertexAttrib;
@@ -153,7 +156,26 @@ struct MeshData
     std::vector<MeshVertexAttrib> attribs;
     int attribCount;
 
+    // Vertices and indices left in a memory mapped bundle instead of being copied to vertex and
+    // subMeshIndices, see Bundle3D::setMappedMeshesEnabled(). They may be unaligned, so they are only
+    // meant to be uploaded to the GL buffers. The mapping is released with the last mesh data using it.
+    std::shared_ptr<MappedFileData> mappedFile;
+    const void* mappedVertex;
+    std::vector<std::pair<const void*, ssize_t>> mappedSubMeshIndices;
+
 public:
+    /** Returns whether the vertices and indices point into a mapped bundle. */
+    bool isMapped() const { return mappedVertex != nullptr; }
+
+    /** Returns the vertices, mapped or not. */
+    const void* getVertexData() const { return mappedVertex ? mappedVertex : (const void*)vertex.data(); }
+    ssize_t getVertexSizeInFloat() const { return mappedVertex ? vertexSizeInFloat : (ssize_t)vertex.size(); }
+
+    /** Returns the indices of a sub mesh, mapped or not. */
+    ssize_t getSubMeshCount() const { return mappedVertex ? mappedSubMeshIndices.size() : subMeshIndices.size(); }
+    const void* getSubMeshIndexData(ssize_t index) const { return mappedVertex ? mappedSubMeshIndices[index].first : (const void*)subMeshIndices[index].data(); }
+    ssize_t getSubMeshIndexCount(ssize_t index) const { return mappedVertex ? mappedSubMeshIndices[index].second : (ssize_t)subMeshIndices[index].size(); }
+
     /**
      * Get per vertex size
      * @return return the sum of each vertex's all attribute size.
@@ -180,11 +202,15 @@ public:
         vertexSizeInFloat = 0;
         numIndex = 0;
         attribCount = 0;
+        mappedFile.reset();
+        mappedVertex = nullptr;
+        mappedSubMeshIndices.clear();
     }
     MeshData()
     : vertexSizeInFloat(0)
     , numIndex(0)
     , attribCount(0)
+    , mappedVertex(nullptr)
     {
     }
     ~MeshData()
@@ -24,6 +24,17 @@
 
 #include "3d/CCFrustum.h"
 #include "2d/CCCamera.h"
+#include "math/MathUtil.h"
+
+//#define USE_SSE_CULLING   : the batched culling uses SSE, always available where it is compiled
+//#define USE_NEON_CULLING  : the batched culling uses NEON when MathUtil finds it at runtime
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+    #include <xmmintrin.h>
+    #define USE_SSE_CULLING
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+    #include <arm_neon.h>
+    #define USE_NEON_CULLING
+#endif
 
 NS_CC_BEGIN
 
@@ -54,6 +65,100 @@ bool Frustum::isOutOfFrustum(const AABB& aabb) const
     return false;
 }
 
+bool Frustum::containsAABB(const AABB& aabb) const
+{
+    if (_initialized)
+    {
+        Vec3 point;
+
+        int plane = _clipZ ? 6 : 4;
+        for (int i = 0; i < plane; i++)
+        {
+            // the corner farthest along the outward normal
+            const Vec3& normal = _plane[i].getNormal();
+            point.x = normal.x < 0 ? aabb._min.x : aabb._max.x;
+            point.y = normal.y < 0 ? aabb._min.y : aabb._max.y;
+            point.z = normal.z < 0 ? aabb._min.z : aabb._max.z;
+
+            if (_plane[i].getSide(point) == PointSide::FRONT_PLANE)
+                return false;
+        }
+    }
+    return true;
+}
+
+void Frustum::cullAABBs(const AABBArray& boxes, uint32_t* visibleMasks) const
+{
+    int count = (int)boxes.size();
+    memset(visibleMasks, 0, sizeof(uint32_t) * ((count + 31) / 32));
+    if (!_initialized)
+    {
+        for (int i = 0; i < count; ++i)
+            visibleMasks[i >> 5] |= 1u << (i & 31);
+        return;
+    }
+
+    // for each plane, the corners closest to the inside are the same coordinate of every box
+    int planeCount = _clipZ ? 6 : 4;
+    const float* px[6];
+    const float* py[6];
+    const float* pz[6];
+    for (int p = 0; p < planeCount; ++p)
+    {
+        const Vec3& normal = _plane[p].getNormal();
+        px[p] = normal.x < 0 ? boxes.maxX.data() : boxes.minX.data();
+        py[p] = normal.y < 0 ? boxes.maxY.data() : boxes.minY.data();
+        pz[p] = normal.z < 0 ? boxes.maxZ.data() : boxes.minZ.data();
+    }
+
+    int i = 0;
+#if defined(USE_SSE_CULLING)
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128 out = _mm_setzero_ps();
+        for (int p = 0; p < planeCount; ++p)
+        {
+            const Vec3& normal = _plane[p].getNormal();
+            __m128 dist = _mm_add_ps(_mm_add_ps(_mm_mul_ps(_mm_set1_ps(normal.x), _mm_loadu_ps(px[p] + i)),
+                                                _mm_mul_ps(_mm_set1_ps(normal.y), _mm_loadu_ps(py[p] + i))),
+                                     _mm_mul_ps(_mm_set1_ps(normal.z), _mm_loadu_ps(pz[p] + i)));
+            out = _mm_or_ps(out, _mm_cmpgt_ps(_mm_sub_ps(dist, _mm_set1_ps(_plane[p].getDist())), _mm_setzero_ps()));
+        }
+        visibleMasks[i >> 5] |= (uint32_t)(~_mm_movemask_ps(out) & 0xF) << (i & 31);
+    }
+#elif defined(USE_NEON_CULLING)
+    // NEON is optional on 32 bit Android devices
+    static bool neonEnabled = MathUtil::isNeon32Enabled() || MathUtil::isNeon64Enabled();
+    if (neonEnabled)
+    {
+        for (; i + 4 <= count; i += 4)
+        {
+            uint32x4_t out = vdupq_n_u32(0);
+            for (int p = 0; p < planeCount; ++p)
+            {
+                const Vec3& normal = _plane[p].getNormal();
+                float32x4_t dist = vaddq_f32(vaddq_f32(vmulq_n_f32(vld1q_f32(px[p] + i), normal.x),
+                                                       vmulq_n_f32(vld1q_f32(py[p] + i), normal.y)),
+                                             vmulq_n_f32(vld1q_f32(pz[p] + i), normal.z));
+                out = vorrq_u32(out, vcgtq_f32(vsubq_f32(dist, vdupq_n_f32(_plane[p].getDist())), vdupq_n_f32(0.0f)));
+            }
+            uint32_t bits = (vgetq_lane_u32(out, 0) & 1) | (vgetq_lane_u32(out, 1) & 2)
+                | (vgetq_lane_u32(out, 2) & 4) | (vgetq_lane_u32(out, 3) & 8);
+            visibleMasks[i >> 5] |= (~bits & 0xF) << (i & 31);
+        }
+    }
+#endif
+
+    for (; i < count; ++i)
+    {
+        bool out = false;
+        for (int p = 0; p < planeCount && !out; ++p)
+            out = _plane[p].getSide(Vec3(px[p][i], py[p][i], pz[p][i])) == PointSide::FRONT_PLANE;
+        if (!out)
+            visibleMasks[i >> 5] |= 1u << (i & 31);
+    }
+}
+
 bool Frustum::isOutOfFrustum(const OBB& obb) const
 {
     if (_initialized)
@@ -64,6 +64,18 @@ public:
      * is obb out of frustum
      */
     bool isOutOfFrustum(const OBB& obb) const;
+    /**
+     * is aabb completely inside the frustum, true when the frustum isn't initialized.
+     * @since v3.14
+     */
+    bool containsAABB(const AABB& aabb) const;
+    /**
+     * tests many boxes at once, four at a time with SSE or NEON, with the same results as isOutOfFrustum.
+     * bit (i % 32) of visibleMasks[i / 32] is set when box i isn't out of the frustum,
+     * visibleMasks must have room for (boxes.size() + 31) / 32 words.
+     * @since v3.14
+     */
+    void cullAABBs(const AABBArray& boxes, uint32_t* visibleMasks) const;
 
     /**
      * get & set z clip. if bclipZ == true use near and far plane
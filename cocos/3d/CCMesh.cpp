@@ -26,6 +26,7 @@
 #include "3d/CCMeshSkin.h"
 #include "3d/CCSkeleton3D.h"
 #include "3d/CCMeshVertexIndexData.h"
+#include "3d/CCSprite3DMaterial.h"
 #include "2d/CCLight.h"
 #include "2d/CCScene.h"
 #include "base/CCEventDispatcher.h"
@@ -37,6 +38,7 @@
 #include "renderer/CCTechnique.h"
 #include "renderer/CCPass.h"
 #include "renderer/CCRenderer.h"
+#include "renderer/CCMeshCommand.h"
 #include "renderer/CCVertexAttribBinding.h"
 #include "math/Mat4.h"
 
@@ -126,11 +128,20 @@ Mesh::Mesh()
 , _visible(true)
 , _isTransparent(false)
 , _force2DQueue(false)
+, _instancingEnabled(false)
 , _meshIndexData(nullptr)
+, _lod(0)
 , _glProgramState(nullptr)
 , _blend(BlendFunc::ALPHA_NON_PREMULTIPLIED)
 , _blendDirty(true)
 , _material(nullptr)
+, _materialShared(false)
+, _instanceLightMask(0)
+, _instanceLights(nullptr)
+, _instanceMatrixPalette(nullptr)
+, _instanceQuantizedNormal(false)
+, _instanceDepthWrite(true)
+, _instanceBlend(false)
 , _texFile("")
 {
     
@@ -142,6 +153,8 @@ Mesh::~Mesh()
     }
     CC_SAFE_RELEASE(_skin);
     CC_SAFE_RELEASE(_meshIndexData);
+    for (auto indexData : _lodIndexDatas)
+        indexData->release();
     CC_SAFE_RELEASE(_material);
     CC_SAFE_RELEASE(_glProgramState);
 }
@@ -271,7 +284,7 @@ bool Mesh::isVisible() const
 void Mesh::setTexture(const std::string& texPath)
 {
     _texFile = texPath;
-    auto tex = Director::getInstance()->getTextureCache()->addImage(texPath);
+    auto tex = Director::getInstance()->getTextureCache()->addStreamedImage(texPath);
     setTexture(tex, NTextureData::Usage::Diffuse);
 }
 
@@ -287,6 +300,13 @@ void Mesh::setTexture(Texture2D* tex, NTextureData::Usage usage, bool cacheFileN
     // This functionality is added for compatibility issues
     if (tex == nullptr)
         tex = getDummyTexture();
+
+    if (_materialShared)
+    {
+        auto iter = _textures.find(usage);
+        if (iter == _textures.end() || iter->second != tex)
+            unshareMaterial();
+    }
     
     CC_SAFE_RETAIN(tex);
     CC_SAFE_RELEASE(_textures[usage]);
@@ -322,7 +342,7 @@ void Mesh::setTexture(Texture2D* tex, NTextureData::Usage usage, bool cacheFileN
 
 void Mesh::setTexture(const std::string& texPath, NTextureData::Usage usage)
 {
-    auto tex = Director::getInstance()->getTextureCache()->addImage(texPath);
+    auto tex = Director::getInstance()->getTextureCache()->addStreamedImage(texPath);
     setTexture(tex, usage);
 }
 
@@ -343,18 +363,10 @@ void Mesh::setMaterial(Material* material)
         _material = material;
         CC_SAFE_RETAIN(_material);
     }
+    _materialShared = false;
+    _meshCommand.setBeforePassCallback(nullptr);
 
-    if (_material)
-    {
-        for (auto technique: _material->getTechniques())
-        {
-            for (auto pass: technique->getPasses())
-            {
-                auto vertexAttribBinding = VertexAttribBinding::create(_meshIndexData, pass->getGLProgramState());
-                pass->setVertexAttribBinding(vertexAttribBinding);
-            }
-        }
-    }
+    bindVertexAttribs();
     // Was the texture set before the GLProgramState ? Set it
     for(auto& tex : _textures)
         setTexture(tex.second, tex.first);
@@ -371,6 +383,22 @@ Material* Mesh::getMaterial() const
     return _material;
 }
 
+void Mesh::setSharedMaterial(Material* material)
+{
+    setMaterial(material);
+    if (_material)
+    {
+        _materialShared = true;
+        _meshCommand.setBeforePassCallback(CC_CALLBACK_1(Mesh::applyInstanceUniforms, this));
+    }
+}
+
+void Mesh::unshareMaterial()
+{
+    if (_materialShared)
+        setMaterial(_material->clone());
+}
+
 void Mesh::draw(Renderer* renderer, float globalZOrder, const Mat4& transform, uint32_t flags, unsigned int lightMask, const Vec4& color, bool forceDepthWrite)
 {
     if (! isVisible())
@@ -381,6 +409,14 @@ void Mesh::draw(Renderer* renderer, float globalZOrder, const Mat4& transform, u
     if (isTransparent)
         flags |= Node::FLAGS_RENDER_AS_3D;
 
+    // quantized positions are mapped back to the mesh space by the transform, or by the matrix palette of skinned meshes
+    auto vertexData = getCurrentMeshIndexData()->getMeshVertexData();
+    const bool quantizedPosition = (vertexData->getQuantization() & MeshVertexData::QUANTIZE_POSITION) != 0;
+    const bool quantizedNormal = (vertexData->getQuantization() & MeshVertexData::QUANTIZE_NORMAL) != 0;
+    Mat4 quantizedTransform;
+    if (quantizedPosition && !_skin)
+        Mat4::multiply(transform, vertexData->getPositionTransform(), &quantizedTransform);
+
     _meshCommand.init(globalZ,
                       _material,
                       getVertexBuffer(),
@@ -388,40 +424,118 @@ void Mesh::draw(Renderer* renderer, float globalZOrder, const Mat4& transform, u
                       getPrimitiveType(),
                       getIndexFormat(),
                       getIndexCount(),
-                      transform,
+                      quantizedPosition && !_skin ? quantizedTransform : transform,
                       flags);
 
 
-   if (isTransparent && !forceDepthWrite)
-       _material->getStateBlock()->setDepthWrite(false);
-   else
-        _material->getStateBlock()->setDepthWrite(true);
-
+    _instanceDepthWrite = !isTransparent || forceDepthWrite;
+    _instanceBlend = _force2DQueue || isTransparent;
 
     _meshCommand.setSkipBatching(isTransparent);
     _meshCommand.setTransparent(isTransparent);
     _meshCommand.set3D(!_force2DQueue);
-    _material->getStateBlock()->setBlend(_force2DQueue || isTransparent);
 
     // set default uniforms for Mesh
     // 'u_color' and others
     const auto scene = Director::getInstance()->getRunningScene();
-    auto technique = _material->_currentTechnique;
-    for(const auto pass : technique->_passes)
+    const std::vector<BaseLight*>* lights = nullptr;
+    if (scene && scene->getLights().size() > 0)
+    {
+        // only the lights reaching the mesh use the uniforms of the shaders
+        auto lightGrid = scene->getLightGrid();
+        if (lightGrid->isValid())
+        {
+            AABB aabb(_aabb);
+            aabb.transform(transform);
+            _reachingLights.clear();
+            lightGrid->findLights(aabb, lightMask, &_reachingLights);
+            lights = &_reachingLights;
+        }
+        else
+        {
+            lights = &scene->getLights();
+        }
+    }
+
+    const Vec4* matrixPalette = nullptr;
+    if (_skin)
     {
-        auto programState = pass->getGLProgramState();
-        programState->setUniformVec4("u_color", color);
+        matrixPalette = _skin->getMatrixPalette();
+        if (quantizedPosition)
+            matrixPalette = getQuantizedMatrixPalette(matrixPalette, _skin->getMatrixPaletteSize(), vertexData->getPositionTransform());
+    }
 
-        if (_skin)
-            programState->setUniformVec4v("u_matrixPalette", (GLsizei)_skin->getMatrixPaletteSize(), _skin->getMatrixPalette());
+    _instanceColor = color;
+    _instanceLightMask = lightMask;
+    _instanceLights = lights;
+    _instanceMatrixPalette = matrixPalette;
+    _instanceQuantizedNormal = quantizedNormal;
+
+    auto technique = _material->_currentTechnique;
+    int boneTextureRow = -1;
+    if (_skin)
+    {
+        // programs compiled with CC_BONE_TEXTURE fetch the palette from the shared bone texture
+        for (const auto pass : technique->_passes)
+        {
+            if (pass->getGLProgramState()->getGLProgram()->getVertexAttrib(GLProgram::ATTRIBUTE_NAME_INSTANCE_BONE_ROW))
+            {
+                boneTextureRow = BoneMatrixTexture::getInstance()->addPalette(matrixPalette, _skin->getMatrixPaletteSize());
+                break;
+            }
+        }
+    }
 
-        if (scene && scene->getLights().size() > 0)
-            setLightUniforms(pass, scene, color, lightMask);
+    // a shared material gets them from the MeshCommand, the next mesh would overwrite them
+    if (!_materialShared)
+    {
+        for (const auto pass : technique->_passes)
+            applyInstanceUniforms(pass);
     }
 
+    _meshCommand.setBoneTextureRow(boneTextureRow);
+    if (_meshCommand.isInstancingEnabled())
+        _meshCommand.genInstancingKey(color, lightMask, lights == &_reachingLights ? lights : nullptr);
+
     renderer->addCommand(&_meshCommand);
 }
 
+void Mesh::applyInstanceUniforms(Pass* pass)
+{
+    auto stateBlock = _material->getStateBlock();
+    stateBlock->setDepthWrite(_instanceDepthWrite);
+    stateBlock->setBlend(_instanceBlend);
+
+    auto programState = pass->getGLProgramState();
+    auto glProgram = programState->getGLProgram();
+    programState->setUniformVec4("u_color", _instanceColor);
+
+    // the programs are shared by the meshes, so the uniform is always set
+    if (glProgram->getUniform("u_octahedralNormal"))
+        programState->setUniformFloat("u_octahedralNormal", _instanceQuantizedNormal ? 1.0f : 0.0f);
+
+    if (_instanceMatrixPalette && !glProgram->getVertexAttrib(GLProgram::ATTRIBUTE_NAME_INSTANCE_BONE_ROW))
+        programState->setUniformVec4v("u_matrixPalette", (GLsizei)_skin->getMatrixPaletteSize(), _instanceMatrixPalette);
+
+    if (_instanceLights)
+        setLightUniforms(pass, *_instanceLights, _instanceColor, _instanceLightMask);
+}
+
+const Vec4* Mesh::getQuantizedMatrixPalette(const Vec4* palette, ssize_t paletteSize, const Mat4& positionTransform)
+{
+    // each row maps the quantized position q to dot(row.xyz, center + scale * q) + row.w
+    const float scale = positionTransform.m[0];
+    const Vec3 center(positionTransform.m[12], positionTransform.m[13], positionTransform.m[14]);
+    _quantizedMatrixPalette.resize(paletteSize);
+    for (ssize_t i = 0; i < paletteSize; ++i)
+    {
+        const auto& row = palette[i];
+        _quantizedMatrixPalette[i].set(row.x * scale, row.y * scale, row.z * scale,
+                                       row.x * center.x + row.y * center.y + row.z * center.z + row.w);
+    }
+    return _quantizedMatrixPalette.data();
+}
+
 void Mesh::setSkin(MeshSkin* skin)
 {
     if (_skin != skin)
@@ -430,6 +544,82 @@ void Mesh::setSkin(MeshSkin* skin)
         CC_SAFE_RELEASE(_skin);
         _skin = skin;
         calculateAABB();
+        bindMeshCommand();
+    }
+}
+
+void Mesh::bindVertexAttribs()
+{
+    if (_material)
+    {
+        // the bindings are cached, switching between levels of detail doesn't create new ones
+        auto indexData = getCurrentMeshIndexData();
+        for (auto technique: _material->getTechniques())
+        {
+            for (auto pass: technique->getPasses())
+            {
+                auto vertexAttribBinding = VertexAttribBinding::create(indexData, pass->getGLProgramState());
+                pass->setVertexAttribBinding(vertexAttribBinding);
+            }
+        }
+    }
+}
+
+void Mesh::addLODLevel(MeshIndexData* indexData, float maxScreenSize)
+{
+    CCASSERT(indexData && _meshIndexData && indexData->getMeshVertexData() == _meshIndexData->getMeshVertexData(),
+             "A level of detail must use the vertex data of the mesh");
+
+    // switching levels binds the vertex attributes of the passes
+    unshareMaterial();
+
+    size_t i = 0;
+    while (i < _lodScreenSizes.size() && _lodScreenSizes[i] >= maxScreenSize)
+        ++i;
+    indexData->retain();
+    _lodIndexDatas.insert(_lodIndexDatas.begin() + i, indexData);
+    _lodScreenSizes.insert(_lodScreenSizes.begin() + i, maxScreenSize);
+
+    if (_lod > 0)
+    {
+        _lod = 0;
+        bindVertexAttribs();
+        bindMeshCommand();
+    }
+}
+
+void Mesh::removeAllLODLevels()
+{
+    bool selected = _lod > 0;
+    _lod = 0;
+    for (auto indexData : _lodIndexDatas)
+        indexData->release();
+    _lodIndexDatas.clear();
+    _lodScreenSizes.clear();
+
+    if (selected)
+    {
+        bindVertexAttribs();
+        bindMeshCommand();
+    }
+}
+
+void Mesh::selectLOD(float screenSize)
+{
+    int lod = 0;
+    for (size_t i = 0, size = _lodScreenSizes.size(); i < size; ++i)
+    {
+        // a coarser level is kept until the size is 10% above its threshold, so that it doesn't flicker on it
+        float threshold = _lodScreenSizes[i] * ((int)i < _lod ? 1.1f : 1.0f);
+        if (screenSize < threshold)
+            lod = (int)i + 1;
+    }
+
+    if (lod != _lod)
+    {
+        _lod = lod;
+        bindVertexAttribs();
+        bindMeshCommand();
     }
 }
 
@@ -437,6 +627,9 @@ void Mesh::setMeshIndexData(MeshIndexData* subMesh)
 {
     if (_meshIndexData != subMesh)
     {
+        unshareMaterial();
+        // the levels of detail belong to the previous vertex data
+        removeAllLODLevels();
         CC_SAFE_RETAIN(subMesh);
         CC_SAFE_RELEASE(_meshIndexData);
         _meshIndexData = subMesh;
@@ -510,22 +703,68 @@ void Mesh::bindMeshCommand()
 //        auto blend = pass->getStateBlock()->getBlendFunc();
         auto blend = BlendFunc::ALPHA_PREMULTIPLIED;
 
-        _meshCommand.genMaterialID(textureid, glprogramstate, _meshIndexData->getVertexBuffer()->getVBO(), _meshIndexData->getIndexBuffer()->getVBO(), blend);
+        _meshCommand.genMaterialID(textureid, glprogramstate, _meshIndexData->getVertexBuffer()->getVBO(), getIndexBuffer(), blend);
         _material->getStateBlock()->setCullFace(true);
         _material->getStateBlock()->setDepthTest(true);
+
+        // instanced draws need every pass to read the model view matrix from the instance attribute,
+        // and skinned meshes their matrix palette from the bone texture
+        bool instancing = _instancingEnabled;
+        for (const auto& p : _material->_currentTechnique->_passes)
+        {
+            if (!instancing)
+                break;
+            auto glProgram = p->getGLProgramState()->getGLProgram();
+            if (!glProgram->getVertexAttrib(GLProgram::ATTRIBUTE_NAME_INSTANCE_MV_MATRIX) ||
+                (_skin && !glProgram->getVertexAttrib(GLProgram::ATTRIBUTE_NAME_INSTANCE_BONE_ROW)))
+            {
+                instancing = false;
+                break;
+            }
+        }
+        _meshCommand.setInstancingEnabled(instancing);
     }
 }
 
-void Mesh::setLightUniforms(Pass* pass, Scene* scene, const Vec4& color, unsigned int lightmask)
+void Mesh::setInstancingEnabled(bool enabled)
+{
+    if (_instancingEnabled != enabled)
+    {
+        _instancingEnabled = enabled;
+        if (!switchBuiltInMaterial())
+            bindMeshCommand();
+    }
+}
+
+bool Mesh::switchBuiltInMaterial()
+{
+    // the built in materials use the regular programs, only the meshes merged into instanced draws
+    // read their model view matrix from the instance attribute
+    auto material = dynamic_cast<Sprite3DMaterial*>(_material);
+    if (material == nullptr || material->getMaterialType() == Sprite3DMaterial::MaterialType::CUSTOM || _meshIndexData == nullptr)
+        return false;
+
+    auto meshVertexData = _meshIndexData->getMeshVertexData();
+    bool skinned = meshVertexData->hasVertexAttrib(GLProgram::VERTEX_ATTRIB_BLEND_INDEX)
+    && meshVertexData->hasVertexAttrib(GLProgram::VERTEX_ATTRIB_BLEND_WEIGHT);
+    auto builtIn = Sprite3DMaterial::createBuiltInMaterial(material->getMaterialType(), skinned, _instancingEnabled);
+    if (builtIn == nullptr || builtIn->getTechnique()->getPassByIndex(0)->getGLProgramState()->getGLProgram() ==
+        material->getTechnique()->getPassByIndex(0)->getGLProgramState()->getGLProgram())
+        return false;
+
+    builtIn->setStateBlock(_material->getStateBlock());
+    setMaterial(builtIn);
+    return true;
+}
+
+void Mesh::setLightUniforms(Pass* pass, const std::vector<BaseLight*>& lights, const Vec4& color, unsigned int lightmask)
 {
     CCASSERT(pass, "Invalid Pass");
-    CCASSERT(scene, "Invalid scene");
 
     const auto& conf = Configuration::getInstance();
     int maxDirLight = conf->getMaxSupportDirLightInShader();
     int maxPointLight = conf->getMaxSupportPointLightInShader();
     int maxSpotLight = conf->getMaxSupportSpotLightInShader();
-    auto &lights = scene->getLights();
 
     auto glProgramState = pass->getGLProgramState();
     auto attributes = pass->getVertexAttributeBinding()->getVertexAttribsFlags();
@@ -669,6 +908,7 @@ void Mesh::setBlendFunc(const BlendFunc &blendFunc)
     {
         _blendDirty = true;
         _blend = blendFunc;
+        unshareMaterial();
     }
 
     if (_material) {
@@ -685,12 +925,12 @@ const BlendFunc& Mesh::getBlendFunc() const
 
 GLenum Mesh::getPrimitiveType() const
 {
-    return _meshIndexData->getPrimitiveType();
+    return getCurrentMeshIndexData()->getPrimitiveType();
 }
 
 ssize_t Mesh::getIndexCount() const
 {
-    return _meshIndexData->getIndexBuffer()->getIndexNumber();
+    return getCurrentMeshIndexData()->getIndexBuffer()->getIndexNumber();
 }
 
 GLenum Mesh::getIndexFormat() const
@@ -700,6 +940,6 @@ GLenum Mesh::getIndexFormat() const
 
 GLuint Mesh::getIndexBuffer() const
 {
-    return _meshIndexData->getIndexBuffer()->getVBO();
+    return getCurrentMeshIndexData()->getIndexBuffer()->getVBO();
 }
 NS_CC_END
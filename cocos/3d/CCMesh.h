@@ -51,6 +51,7 @@ class Material;
 class Renderer;
 class Scene;
 class Pass;
+class BaseLight;
 
 /** 
  * @brief Mesh: contains ref to index buffer, GLProgramState, texture, skin, blend function, aabb and so on
@@ -189,6 +190,22 @@ public:
     /**get AABB*/
     const AABB& getAABB() const { return _aabb; }
 
+    /**
+     * Add a level of detail, drawn instead of the mesh index data when the projected size of the Sprite3D
+     * is below maxScreenSize pixels, see selectLOD(). The level must use the vertex data of the mesh.
+     * The index buffer, count and primitive getters return the ones of the selected level.
+     * @since v3.14
+     */
+    void addLODLevel(MeshIndexData* indexData, float maxScreenSize);
+    /**remove the levels of detail, the mesh index data is then always drawn*/
+    void removeAllLODLevels();
+    /**number of levels of detail, without the mesh index data*/
+    ssize_t getLODLevelCount() const { return _lodIndexDatas.size(); }
+    /**select the level of detail for a projected size in pixels, called by Sprite3D before drawing*/
+    void selectLOD(float screenSize);
+    /**selected level of detail, 0 means the mesh index data*/
+    int getLOD() const { return _lod; }
+
     /**  Sets a new GLProgramState for the Mesh
      * A new Material will be created for it
      */
@@ -200,6 +217,20 @@ public:
     /** Returns the Material being used by the Mesh */
     Material* getMaterial() const;
 
+    /**
+     * Sets a Material used by other meshes too, e.g. the clones of a Sprite3D. Its GLProgramStates are shared:
+     * the color, the lights and the matrix palette of the mesh are set when its MeshCommand is executed, and
+     * the mesh uses a copy of the material from the first change of its texture, blend function or index data.
+     * Changes made directly to the GLProgramStates or the state block apply to all the meshes sharing it,
+     * call unshareMaterial() before.
+     * @since v3.14
+     */
+    void setSharedMaterial(Material* material);
+    /** Returns whether the Material was set by setSharedMaterial(). @since v3.14 */
+    bool isMaterialShared() const { return _materialShared; }
+    /** Replaces a shared Material by a copy used by this mesh only. @since v3.14 */
+    void unshareMaterial();
+
     void draw(Renderer* renderer, float globalZ, const Mat4& transform, uint32_t flags, unsigned int lightMask, const Vec4& color, bool forceDepthWrite);
 
     /** 
@@ -225,6 +256,18 @@ public:
      */
     void setForce2DQueue(bool force2D) { _force2DQueue = force2D; }
 
+    /**
+     * Let the Renderer merge the draws of this mesh with the ones of the meshes drawn with the same geometry,
+     * programs, textures, render states and uniform values into one instanced draw.
+     * Only the meshes whose programs read the instance attributes are merged, see MeshCommand::setInstancingEnabled().
+     * A built in material is switched to the instanced variant of its program, and back when instancing is disabled,
+     * the mesh doesn't share its material anymore.
+     * @param enabled A bool object, default value is false.
+     * @since v3.14
+     */
+    void setInstancingEnabled(bool enabled);
+    bool isInstancingEnabled() const { return _instancingEnabled; }
+
     std::string getTextureFileName(){ return _texFile; }
 
 CC_CONSTRUCTOR_ACCESS:
@@ -234,26 +277,49 @@ CC_CONSTRUCTOR_ACCESS:
 
 protected:
     void resetLightUniformValues();
-    void setLightUniforms(Pass* pass, Scene* scene, const Vec4& color, unsigned int lightmask);
+    void setLightUniforms(Pass* pass, const std::vector<BaseLight*>& lights, const Vec4& color, unsigned int lightmask);
+    /** sets the uniforms and the states of the last draw() to a pass, before it is bound when the material is shared */
+    void applyInstanceUniforms(Pass* pass);
     void bindMeshCommand();
+    void bindVertexAttribs();
+    /** switches a built in material to the program variant matching _instancingEnabled, returns true if the material was replaced */
+    bool switchBuiltInMaterial();
+    /** the matrix palette of the skin applied to the quantized positions */
+    const Vec4* getQuantizedMatrixPalette(const Vec4* palette, ssize_t paletteSize, const Mat4& positionTransform);
+    MeshIndexData* getCurrentMeshIndexData() const { return _lod > 0 ? _lodIndexDatas[_lod - 1] : _meshIndexData; }
 
     std::map<NTextureData::Usage, Texture2D*> _textures; //textures that submesh is using
     MeshSkin*           _skin;     //skin
     bool                _visible; // is the submesh visible
     bool                _isTransparent; // is this mesh transparent, it is a property of material in fact
     bool                _force2DQueue; // add this mesh to 2D render queue
+    bool                _instancingEnabled; // may be merged into instanced draws
     
     std::string         _name;
     MeshCommand         _meshCommand;
     MeshIndexData*      _meshIndexData;
+    std::vector<MeshIndexData*> _lodIndexDatas; // levels of detail, by decreasing screen size
+    std::vector<float>  _lodScreenSizes;
+    int                 _lod;
     GLProgramState*     _glProgramState;
     BlendFunc           _blend;
     bool                _blendDirty;
     Material*           _material;
+    bool                _materialShared;
     AABB                _aabb;
     std::function<void()> _visibleChanged;
     
     ///light parameters
+    std::vector<BaseLight*> _reachingLights; // found in the light grid of the scene by draw()
+    std::vector<Vec4> _quantizedMatrixPalette;
+    // the values of the last draw(), applied by applyInstanceUniforms()
+    Vec4                _instanceColor;
+    unsigned int        _instanceLightMask;
+    const std::vector<BaseLight*>* _instanceLights;
+    const Vec4*         _instanceMatrixPalette;
+    bool                _instanceQuantizedNormal;
+    bool                _instanceDepthWrite;
+    bool                _instanceBlend;
     std::vector<Vec3> _dirLightUniformColorValues;
     std::vector<Vec3> _dirLightUniformDirValues;
     
@@ -0,0 +1,369 @@
+/****************************************************************************
+Copyright (c) 2017 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+
+#include "3d/CCMeshOptimizer.h"
+
+#include <algorithm>
+#include <cstring>
+#include <unordered_set>
+
+#include "renderer/CCGLProgram.h"
+#include "xxhash.h"
+
+NS_CC_BEGIN
+
+namespace
+{
+    int getVertexCount(const MeshData& meshdata)
+    {
+        int floatsPerVertex = meshdata.getPerVertexSize() / 4;
+        return floatsPerVertex > 0 ? (int)(meshdata.vertex.size() / floatsPerVertex) : 0;
+    }
+
+    // the offset of the position in the vertices in floats, -1 if there is none
+    int getPositionOffset(const MeshData& meshdata)
+    {
+        int offset = 0;
+        for (const auto& attrib : meshdata.attribs)
+        {
+            if (attrib.vertexAttrib == GLProgram::VERTEX_ATTRIB_POSITION)
+                return attrib.type == GL_FLOAT && attrib.size >= 3 ? offset : -1;
+            offset += attrib.attribSizeBytes / 4;
+        }
+        return -1;
+    }
+
+    // hashes and compares vertices by their index in a vertex array
+    struct VertexHash
+    {
+        const std::vector<float>* vertices;
+        int floatsPerVertex;
+
+        size_t operator()(unsigned int index) const
+        {
+            return XXH32(vertices->data() + (size_t)index * floatsPerVertex, floatsPerVertex * sizeof(float), 0);
+        }
+    };
+
+    struct VertexEqual
+    {
+        const std::vector<float>* vertices;
+        int floatsPerVertex;
+
+        bool operator()(unsigned int a, unsigned int b) const
+        {
+            return memcmp(vertices->data() + (size_t)a * floatsPerVertex, vertices->data() + (size_t)b * floatsPerVertex, floatsPerVertex * sizeof(float)) == 0;
+        }
+    };
+}
+
+void MeshOptimizer::optimize(MeshData& meshdata, int optimizations, int cacheSize)
+{
+    if (meshdata.isMapped() || optimizations == NONE)
+        return;
+
+    if (optimizations & DEDUPLICATE_VERTICES)
+        deduplicateVertices(meshdata);
+
+    if (optimizations & (VERTEX_CACHE | OVERDRAW))
+    {
+        int vertexCount = getVertexCount(meshdata);
+        std::vector<size_t> clusters;
+        for (auto& indices : meshdata.subMeshIndices)
+        {
+            optimizeVertexCache(indices, vertexCount, cacheSize, (optimizations & OVERDRAW) ? &clusters : nullptr);
+            if (optimizations & OVERDRAW)
+                optimizeOverdraw(indices, meshdata, clusters);
+        }
+    }
+
+    if (optimizations & VERTEX_FETCH)
+        optimizeVertexFetch(meshdata);
+}
+
+int MeshOptimizer::deduplicateVertices(MeshData& meshdata)
+{
+    const int floatsPerVertex = meshdata.getPerVertexSize() / 4;
+    const int vertexCount = getVertexCount(meshdata);
+    if (meshdata.isMapped() || vertexCount == 0)
+        return 0;
+
+    // each vertex is appended to the unique ones, and removed again if it was already there
+    std::vector<float> unique;
+    unique.reserve(meshdata.vertex.size());
+    std::unordered_set<unsigned int, VertexHash, VertexEqual> uniqueSet(vertexCount, VertexHash{&unique, floatsPerVertex}, VertexEqual{&unique, floatsPerVertex});
+    std::vector<unsigned short> remap(vertexCount);
+    for (int i = 0; i < vertexCount; ++i)
+    {
+        unsigned int candidate = (unsigned int)(unique.size() / floatsPerVertex);
+        unique.insert(unique.end(), meshdata.vertex.begin() + (size_t)i * floatsPerVertex, meshdata.vertex.begin() + (size_t)(i + 1) * floatsPerVertex);
+        auto result = uniqueSet.insert(candidate);
+        if (!result.second)
+            unique.resize(unique.size() - floatsPerVertex);
+        remap[i] = (unsigned short)*result.first;
+    }
+
+    int removed = vertexCount - (int)(unique.size() / floatsPerVertex);
+    if (removed > 0)
+    {
+        for (auto& indices : meshdata.subMeshIndices)
+        {
+            for (auto& index : indices)
+                index = remap[index];
+        }
+        meshdata.vertex.swap(unique);
+        meshdata.vertexSizeInFloat = (int)meshdata.vertex.size();
+    }
+    return removed;
+}
+
+void MeshOptimizer::optimizeVertexCache(MeshData::IndexArray& indices, int vertexCount, int cacheSize, std::vector<size_t>* clusters)
+{
+    if (clusters)
+        clusters->clear();
+    const size_t triangleCount = indices.size() / 3;
+    if (triangleCount == 0 || indices.size() % 3 != 0 || vertexCount <= 0)
+    {
+        if (clusters && triangleCount > 0)
+            clusters->push_back(0);
+        return;
+    }
+
+    // the triangles using each vertex
+    std::vector<int> live(vertexCount, 0);
+    for (auto index : indices)
+    {
+        CCASSERT(index < vertexCount, "MeshOptimizer: index out of range");
+        ++live[index];
+    }
+    std::vector<int> offsets(vertexCount + 1, 0);
+    for (int v = 0; v < vertexCount; ++v)
+        offsets[v + 1] = offsets[v] + live[v];
+    std::vector<unsigned int> adjacency(indices.size());
+    std::vector<int> fill(offsets.begin(), offsets.end() - 1);
+    for (size_t t = 0; t < triangleCount; ++t)
+    {
+        for (int k = 0; k < 3; ++k)
+            adjacency[fill[indices[t * 3 + k]]++] = (unsigned int)t;
+    }
+
+    std::vector<int> cacheTime(vertexCount, 0);
+    std::vector<bool> emitted(triangleCount, false);
+    std::vector<unsigned short> deadEnd;
+    deadEnd.reserve(indices.size());
+    std::vector<unsigned short> candidates;
+    MeshData::IndexArray output;
+    output.reserve(indices.size());
+    int timeStamp = cacheSize + 1;
+    int cursor = 0;
+
+    int fanning = -1;
+    while (fanning == -1 && cursor < vertexCount)
+    {
+        if (live[cursor] > 0)
+            fanning = cursor;
+        ++cursor;
+    }
+    bool newCluster = true;
+
+    while (fanning >= 0)
+    {
+        if (newCluster && clusters)
+            clusters->push_back(output.size() / 3);
+
+        // emit the triangles around the fanning vertex
+        candidates.clear();
+        for (int a = offsets[fanning]; a < offsets[fanning + 1]; ++a)
+        {
+            auto t = adjacency[a];
+            if (emitted[t])
+                continue;
+            emitted[t] = true;
+            for (int k = 0; k < 3; ++k)
+            {
+                auto v = indices[t * 3 + k];
+                output.push_back(v);
+                deadEnd.push_back(v);
+                candidates.push_back(v);
+                --live[v];
+                if (timeStamp - cacheTime[v] > cacheSize)
+                    cacheTime[v] = timeStamp++;
+            }
+        }
+
+        // the next one is the vertex of these triangles which stays in the cache the longest with its remaining triangles
+        int next = -1;
+        int bestPriority = -1;
+        for (auto v : candidates)
+        {
+            if (live[v] > 0)
+            {
+                int priority = 0;
+                if (timeStamp - cacheTime[v] + 2 * live[v] <= cacheSize)
+                    priority = timeStamp - cacheTime[v];
+                if (priority > bestPriority)
+                {
+                    bestPriority = priority;
+                    next = v;
+                }
+            }
+        }
+
+        // else a recently used vertex, else the next one in the input order
+        if (next == -1)
+        {
+            while (next == -1 && !deadEnd.empty())
+            {
+                auto v = deadEnd.back();
+                deadEnd.pop_back();
+                if (live[v] > 0)
+                    next = v;
+            }
+            while (next == -1 && cursor < vertexCount)
+            {
+                if (live[cursor] > 0)
+                    next = cursor;
+                ++cursor;
+            }
+        }
+
+        // a cluster ends when the cache no longer holds the next fanning vertex
+        newCluster = next >= 0 && timeStamp - cacheTime[next] > cacheSize;
+        fanning = next;
+    }
+
+    indices.swap(output);
+}
+
+void MeshOptimizer::optimizeOverdraw(MeshData::IndexArray& indices, const MeshData& meshdata, const std::vector<size_t>& clusters)
+{
+    const int positionOffset = getPositionOffset(meshdata);
+    const size_t triangleCount = indices.size() / 3;
+    if (positionOffset < 0 || clusters.size() < 2 || triangleCount == 0)
+        return;
+
+    const int floatsPerVertex = meshdata.getPerVertexSize() / 4;
+    auto getPosition = [&](unsigned short index) {
+        const float* position = meshdata.vertex.data() + (size_t)index * floatsPerVertex + positionOffset;
+        return Vec3(position[0], position[1], position[2]);
+    };
+
+    Vec3 meshCenter;
+    for (auto index : indices)
+        meshCenter += getPosition(index);
+    meshCenter *= 1.0f / indices.size();
+
+    struct Cluster
+    {
+        size_t begin;
+        size_t end;
+        float sortKey;
+    };
+    std::vector<Cluster> sorted(clusters.size());
+    for (size_t c = 0; c < clusters.size(); ++c)
+    {
+        auto& cluster = sorted[c];
+        cluster.begin = clusters[c];
+        cluster.end = c + 1 < clusters.size() ? clusters[c + 1] : triangleCount;
+
+        // the area weighted normal and center of the cluster
+        Vec3 normal, center;
+        float area = 0;
+        for (size_t t = cluster.begin; t < cluster.end; ++t)
+        {
+            Vec3 p0 = getPosition(indices[t * 3]), p1 = getPosition(indices[t * 3 + 1]), p2 = getPosition(indices[t * 3 + 2]);
+            Vec3 cross;
+            Vec3::cross(p1 - p0, p2 - p0, &cross);
+            float triangleArea = cross.length();
+            normal += cross;
+            center += (p0 + p1 + p2) * (triangleArea / 3.0f);
+            area += triangleArea;
+        }
+        if (area > 0)
+            center *= 1.0f / area;
+        normal.normalize();
+        cluster.sortKey = (center - meshCenter).dot(normal);
+    }
+
+    std::stable_sort(sorted.begin(), sorted.end(), [](const Cluster& a, const Cluster& b) {
+        return a.sortKey > b.sortKey;
+    });
+
+    MeshData::IndexArray output;
+    output.reserve(indices.size());
+    for (const auto& cluster : sorted)
+        output.insert(output.end(), indices.begin() + cluster.begin * 3, indices.begin() + cluster.end * 3);
+    indices.swap(output);
+}
+
+void MeshOptimizer::optimizeVertexFetch(MeshData& meshdata)
+{
+    const int floatsPerVertex = meshdata.getPerVertexSize() / 4;
+    const int vertexCount = getVertexCount(meshdata);
+    if (meshdata.isMapped() || vertexCount == 0)
+        return;
+
+    // the vertices which are not used are dropped
+    std::vector<int> remap(vertexCount, -1);
+    std::vector<float> vertices;
+    vertices.reserve(meshdata.vertex.size());
+    for (auto& indices : meshdata.subMeshIndices)
+    {
+        for (auto& index : indices)
+        {
+            if (remap[index] < 0)
+            {
+                remap[index] = (int)(vertices.size() / floatsPerVertex);
+                vertices.insert(vertices.end(), meshdata.vertex.begin() + (size_t)index * floatsPerVertex, meshdata.vertex.begin() + (size_t)(index + 1) * floatsPerVertex);
+            }
+            index = (unsigned short)remap[index];
+        }
+    }
+    meshdata.vertex.swap(vertices);
+    meshdata.vertexSizeInFloat = (int)meshdata.vertex.size();
+}
+
+float MeshOptimizer::getACMR(const MeshData::IndexArray& indices, int cacheSize)
+{
+    if (indices.size() < 3)
+        return 0;
+
+    // a FIFO cache
+    std::vector<unsigned short> cache;
+    size_t misses = 0;
+    for (auto index : indices)
+    {
+        if (std::find(cache.begin(), cache.end(), index) == cache.end())
+        {
+            ++misses;
+            cache.push_back(index);
+            if ((int)cache.size() > cacheSize)
+                cache.erase(cache.begin());
+        }
+    }
+    return (float)misses / (indices.size() / 3);
+}
+
+NS_CC_END
@@ -0,0 +1,118 @@
+/****************************************************************************
+Copyright (c) 2017 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+
+#ifndef __CCMESHOPTIMIZER_H__
+#define __CCMESHOPTIMIZER_H__
+
+#include <vector>
+
+#include "3d/CCBundle3DData.h"
+
+NS_CC_BEGIN
+
+/**
+ * @addtogroup _3d
+ * @{
+ */
+
+/**
+ * @brief Reorders the triangles and the vertices of meshes so that the GPU processes less of them.
+ *
+ * The optimizations don't change what is drawn, only the order of the triangles within a sub mesh and the
+ * order of the vertices. They can run at load time, see Bundle3D::setMeshOptimization(), or be applied by a
+ * tool before the bundles are written. The meshes are triangle lists.
+ * @since v3.14
+ * @js NA
+ * @lua NA
+ */
+class CC_DLL MeshOptimizer
+{
+public:
+    enum Optimization
+    {
+        NONE = 0,
+        /** merges the identical vertices, e.g. the ones repeated by the obj files */
+        DEDUPLICATE_VERTICES = 1 << 0,
+        /** orders the triangles of each sub mesh for the post transform vertex cache, with Tipsify */
+        VERTEX_CACHE = 1 << 1,
+        /** orders the clusters found by VERTEX_CACHE so that the outer ones are drawn first, implies VERTEX_CACHE */
+        OVERDRAW = 1 << 2,
+        /** orders the vertices by their first use, so that they are fetched sequentially */
+        VERTEX_FETCH = 1 << 3,
+        ALL = DEDUPLICATE_VERTICES | VERTEX_CACHE | OVERDRAW | VERTEX_FETCH
+    };
+
+    /** The vertex cache size the triangles are ordered for, most mobile GPUs have at least this much. */
+    static const int DEFAULT_CACHE_SIZE = 16;
+
+    /**
+     * Applies the optimizations to a mesh. The meshes left in a mapped bundle, see MeshData::isMapped(),
+     * are read only and are not changed.
+     *
+     * @param meshdata The mesh.
+     * @param optimizations A combination of the Optimization flags.
+     * @param cacheSize The vertex cache size to optimize for.
+     */
+    static void optimize(MeshData& meshdata, int optimizations = ALL, int cacheSize = DEFAULT_CACHE_SIZE);
+
+    /**
+     * Merges the vertices whose attributes are bitwise identical and updates the indices of the sub meshes.
+     * @return The number of vertices removed.
+     */
+    static int deduplicateVertices(MeshData& meshdata);
+
+    /**
+     * Orders the triangles for a vertex cache, see "Fast Triangle Reordering for Vertex Locality and
+     * Reduced Overdraw", Sander et al. 2007.
+     *
+     * @param indices The triangles of a sub mesh.
+     * @param vertexCount The number of vertices the indices refer to.
+     * @param cacheSize The size of the vertex cache.
+     * @param clusters If not nullptr, receives the index of the first triangle of each cluster of the new order.
+     */
+    static void optimizeVertexCache(MeshData::IndexArray& indices, int vertexCount, int cacheSize = DEFAULT_CACHE_SIZE, std::vector<size_t>* clusters = nullptr);
+
+    /**
+     * Orders the clusters of triangles returned by optimizeVertexCache(), the ones facing away from the
+     * center of the sub mesh first, so that they hide the inner ones from most points of view.
+     */
+    static void optimizeOverdraw(MeshData::IndexArray& indices, const MeshData& meshdata, const std::vector<size_t>& clusters);
+
+    /** Orders the vertices by their first use in the sub meshes and updates the indices. */
+    static void optimizeVertexFetch(MeshData& meshdata);
+
+    /**
+     * Returns the average number of vertices transformed per triangle, the average cache miss ratio,
+     * for a FIFO vertex cache. It's from 0.5 for the best meshes to 3.
+     */
+    static float getACMR(const MeshData::IndexArray& indices, int cacheSize = DEFAULT_CACHE_SIZE);
+};
+
+// end of 3d group
+/// @}
+
+NS_CC_END
+
+#endif // __CCMESHOPTIMIZER_H__
@@ -25,6 +25,7 @@
 #include "3d/CCMeshSkin.h"
 #include "3d/CCBundle3D.h"
 #include "3d/CCSkeleton3D.h"
+#include "base/CCDirector.h"
 
 NS_CC_BEGIN
 
@@ -34,6 +35,8 @@ MeshSkin::MeshSkin()
 : _rootBone(nullptr)
 , _skeleton(nullptr)
 , _matrixPalette(nullptr)
+, _matrixPaletteUpdated(false)
+, _matrixPaletteFrame(0)
 {
     
 }
@@ -99,13 +102,31 @@ int MeshSkin::getBoneIndex(Bone3D* bone) const
 
 //compute matrix palette used by gpu skin
 Vec4* MeshSkin::getMatrixPalette()
+{
+    if (!_matrixPaletteUpdated || _matrixPaletteFrame != Director::getInstance()->getTotalFrames())
+    {
+        _matrixPaletteUpdated = false;
+        computeMatrixPalette();
+    }
+    
+    return _matrixPalette;
+}
+
+void MeshSkin::updateMatrixPalette()
+{
+    computeMatrixPalette();
+    _matrixPaletteUpdated = true;
+    _matrixPaletteFrame = Director::getInstance()->getTotalFrames();
+}
+
+void MeshSkin::computeMatrixPalette()
 {
     if (_matrixPalette == nullptr)
     {
         _matrixPalette = new (std::nothrow) Vec4[_skinBones.size() * PALETTE_ROWS];
     }
     int i = 0, paletteIndex = 0;
-    static Mat4 t;
+    Mat4 t;
     for (auto it : _skinBones )
     {
         Mat4::multiply(it->getWorldMat(), _invBindPoses[i++], &t);
@@ -113,8 +134,6 @@ Vec4* MeshSkin::getMatrixPalette()
         _matrixPalette[paletteIndex++].set(t.m[1], t.m[5], t.m[9], t.m[13]);
         _matrixPalette[paletteIndex++].set(t.m[2], t.m[6], t.m[10], t.m[14]);
     }
-    
-    return _matrixPalette;
 }
 
 ssize_t MeshSkin::getMatrixPaletteSize() const
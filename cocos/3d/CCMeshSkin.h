@@ -67,8 +67,11 @@ public:
     /**get bone index*/
     int getBoneIndex(Bone3D* bone) const;
     
-    /**compute matrix palette used by gpu skin*/
+    /**compute matrix palette used by gpu skin, unless it was already computed by updateMatrixPalette() this frame*/
     Vec4* getMatrixPalette();
+
+    /**compute the matrix palette now and keep it for the rest of the frame, used by the parallel Animate3D update*/
+    void updateMatrixPalette();
     
     /**getSkinBoneCount() * 3*/
     ssize_t getMatrixPaletteSize() const;
@@ -104,6 +107,12 @@ protected:
     // Each 4x3 row-wise matrix is represented as 3 Vec4's.
     // The number of Vec4's is (_skinBones.size() * 3).
     Vec4* _matrixPalette;
+
+    // frame the palette was computed by updateMatrixPalette()
+    bool _matrixPaletteUpdated;
+    unsigned int _matrixPaletteFrame;
+
+    void computeMatrixPalette();
 };
 
 // end of 3d group
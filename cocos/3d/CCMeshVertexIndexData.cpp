@@ -23,6 +23,10 @@
  ****************************************************************************/
 
 #include <list>
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstring>
 #include <fstream>
 #include <iostream>
 #include <sstream>
@@ -79,39 +83,115 @@ MeshIndexData::~MeshIndexData()
     CC_SAFE_RELEASE(_indexBuffer);
 }
 
+int MeshVertexData::s_defaultQuantization = MeshVertexData::QUANTIZE_NONE;
+
+namespace
+{
+    // the vertices of mapped meshes may be unaligned
+    inline float readFloat(const unsigned char* data, int index)
+    {
+        float value;
+        memcpy(&value, data + index * sizeof(float), sizeof(float));
+        return value;
+    }
+
+    template <typename T>
+    inline void writeValue(unsigned char* data, int index, T value)
+    {
+        memcpy(data + index * sizeof(T), &value, sizeof(T));
+    }
+
+    inline GLshort toSnorm16(float value)
+    {
+        return (GLshort)std::round(clampf(value, -1.0f, 1.0f) * 32767.0f);
+    }
+
+    inline GLushort toUnorm16(float value)
+    {
+        return (GLushort)std::round(clampf(value, 0.0f, 1.0f) * 65535.0f);
+    }
+
+    // projects the normal on the octahedron |x| + |y| + |z| = 1, the lower half folded over the upper one
+    void encodeOctahedral(float x, float y, float z, float& u, float& v)
+    {
+        float length = std::abs(x) + std::abs(y) + std::abs(z);
+        if (length == 0.0f)
+        {
+            u = v = 0.0f;
+            return;
+        }
+        u = x / length;
+        v = y / length;
+        if (z < 0.0f)
+        {
+            float foldedU = (1.0f - std::abs(v)) * (u >= 0.0f ? 1.0f : -1.0f);
+            float foldedV = (1.0f - std::abs(u)) * (v >= 0.0f ? 1.0f : -1.0f);
+            u = foldedU;
+            v = foldedV;
+        }
+    }
+
+    bool isTexCoord(int vertexAttrib)
+    {
+        return vertexAttrib >= GLProgram::VERTEX_ATTRIB_TEX_COORD && vertexAttrib <= GLProgram::VERTEX_ATTRIB_TEX_COORD3;
+    }
+}
+
 MeshVertexData* MeshVertexData::create(const MeshData& meshdata)
+{
+    return create(meshdata, s_defaultQuantization);
+}
+
+MeshVertexData* MeshVertexData::create(const MeshData& meshdata, int quantization)
 {
     auto vertexdata = new (std::nothrow) MeshVertexData();
     int pervertexsize = meshdata.getPerVertexSize();
-    vertexdata->_vertexBuffer = VertexBuffer::create(pervertexsize, (int)(meshdata.vertex.size() / (pervertexsize / 4)));
+    ssize_t vertexSizeInFloat = meshdata.getVertexSizeInFloat();
+    int vertexCount = (int)(vertexSizeInFloat / (pervertexsize / 4));
+
+    // the MeshData keeps its floats for the bounding boxes and the picking, only the GL buffer is quantized
+    std::vector<unsigned char> quantizedVertices;
+    vertexdata->_attribs = meshdata.attribs;
+    if (quantization != QUANTIZE_NONE && vertexCount > 0)
+    {
+        vertexdata->quantize(meshdata, vertexCount, quantization, vertexdata->_attribs, quantizedVertices);
+    }
+
+    int sizePerVertex = 0;
+    for (const auto& it : vertexdata->_attribs) {
+        sizePerVertex += it.attribSizeBytes;
+    }
+    vertexdata->_vertexBuffer = VertexBuffer::create(sizePerVertex, vertexCount);
     vertexdata->_vertexData = VertexData::create();
     CC_SAFE_RETAIN(vertexdata->_vertexData);
     CC_SAFE_RETAIN(vertexdata->_vertexBuffer);
     
     int offset = 0;
-    for (const auto& it : meshdata.attribs) {
-        vertexdata->_vertexData->setStream(vertexdata->_vertexBuffer, VertexStreamAttribute(offset, it.vertexAttrib, it.type, it.size));
+    for (const auto& it : vertexdata->_attribs) {
+        vertexdata->_vertexData->setStream(vertexdata->_vertexBuffer, VertexStreamAttribute(offset, it.vertexAttrib, it.type, it.size, isNormalized(it)));
         offset += it.attribSizeBytes;
     }
     
-    vertexdata->_attribs = meshdata.attribs;
-    
     if(vertexdata->_vertexBuffer)
     {
-        vertexdata->_vertexBuffer->updateVertices((void*)&meshdata.vertex[0], (int)meshdata.vertex.size() * 4 / vertexdata->_vertexBuffer->getSizePerVertex(), 0);
+        // mapped meshes are uploaded straight from the mapping
+        const void* vertices = quantizedVertices.empty() ? meshdata.getVertexData() : (const void*)quantizedVertices.data();
+        vertexdata->_vertexBuffer->updateVertices(vertices, vertexCount, 0);
     }
     
-    bool needCalcAABB = (meshdata.subMeshAABB.size() != meshdata.subMeshIndices.size());
-    for (size_t i = 0, size = meshdata.subMeshIndices.size(); i < size; ++i) {
+    ssize_t subMeshCount = meshdata.getSubMeshCount();
+    bool needCalcAABB = (meshdata.subMeshAABB.size() != (size_t)subMeshCount);
+    CCASSERT(!needCalcAABB || !meshdata.isMapped(), "The bounding boxes of mapped meshes are read from the bundle");
+    for (ssize_t i = 0; i < subMeshCount; ++i) {
 
-        auto& index = meshdata.subMeshIndices[i];
-        auto indexBuffer = IndexBuffer::create(IndexBuffer::IndexType::INDEX_TYPE_SHORT_16, (int)(index.size()));
-        indexBuffer->updateIndices(&index[0], (int)index.size(), 0);
-        std::string id = (i < meshdata.subMeshIds.size() ? meshdata.subMeshIds[i] : "");
+        ssize_t indexCount = meshdata.getSubMeshIndexCount(i);
+        auto indexBuffer = IndexBuffer::create(IndexBuffer::IndexType::INDEX_TYPE_SHORT_16, (int)indexCount);
+        indexBuffer->updateIndices(meshdata.getSubMeshIndexData(i), (int)indexCount, 0);
+        std::string id = (i < (ssize_t)meshdata.subMeshIds.size() ? meshdata.subMeshIds[i] : "");
         MeshIndexData* indexdata = nullptr;
         if (needCalcAABB)
         {
-            auto aabb = Bundle3D::calculateAABB(meshdata.vertex, meshdata.getPerVertexSize(), index);
+            auto aabb = Bundle3D::calculateAABB(meshdata.vertex, meshdata.getPerVertexSize(), meshdata.subMeshIndices[i]);
             indexdata = MeshIndexData::create(id, vertexdata, indexBuffer, aabb);
         }
         else
@@ -133,6 +213,178 @@ MeshIndexData* MeshVertexData::getMeshIndexDataById(const std::string& id) const
     return nullptr;
 }
 
+bool MeshVertexData::quantize(const MeshData& meshdata, int vertexCount, int quantization, std::vector<MeshVertexAttrib>& attribs, std::vector<unsigned char>& vertices)
+{
+    const auto source = (const unsigned char*)meshdata.getVertexData();
+    const int sourceFloats = meshdata.getPerVertexSize() / 4;
+
+    // choose the format of each attribute, the ones which can't be quantized stay in floats
+    int quantized = QUANTIZE_NONE;
+    Vec3 minPosition(FLT_MAX, FLT_MAX, FLT_MAX), maxPosition(-FLT_MAX, -FLT_MAX, -FLT_MAX);
+    std::vector<MeshVertexAttrib> quantizedAttribs = attribs;
+    int sourceOffset = 0;
+    for (auto& attrib : quantizedAttribs)
+    {
+        const int floats = attrib.attribSizeBytes / 4;
+        if (attrib.type == GL_FLOAT)
+        {
+            if (attrib.vertexAttrib == GLProgram::VERTEX_ATTRIB_POSITION && attrib.size == 3 && (quantization & QUANTIZE_POSITION))
+            {
+                for (int i = 0; i < vertexCount; ++i)
+                {
+                    const auto vertex = source + (i * sourceFloats + sourceOffset) * sizeof(float);
+                    float x = readFloat(vertex, 0), y = readFloat(vertex, 1), z = readFloat(vertex, 2);
+                    minPosition.set(std::min(minPosition.x, x), std::min(minPosition.y, y), std::min(minPosition.z, z));
+                    maxPosition.set(std::max(maxPosition.x, x), std::max(maxPosition.y, y), std::max(maxPosition.z, z));
+                }
+                // 3 shorts padded to 4 bytes, the w component is 1
+                attrib.type = GL_SHORT;
+                attrib.attribSizeBytes = 8;
+                quantized |= QUANTIZE_POSITION;
+            }
+            else if (attrib.vertexAttrib == GLProgram::VERTEX_ATTRIB_NORMAL && attrib.size == 3 && (quantization & QUANTIZE_NORMAL))
+            {
+                attrib.type = GL_SHORT;
+                attrib.size = 2;
+                attrib.attribSizeBytes = 4;
+                quantized |= QUANTIZE_NORMAL;
+            }
+            else if (isTexCoord(attrib.vertexAttrib) && attrib.size == 2 && (quantization & QUANTIZE_TEXCOORD))
+            {
+                bool normalized = true;
+                for (int i = 0; i < vertexCount && normalized; ++i)
+                {
+                    const auto vertex = source + (i * sourceFloats + sourceOffset) * sizeof(float);
+                    float u = readFloat(vertex, 0), v = readFloat(vertex, 1);
+                    normalized = u >= 0.0f && u <= 1.0f && v >= 0.0f && v <= 1.0f;
+                }
+                if (normalized)
+                {
+                    attrib.type = GL_UNSIGNED_SHORT;
+                    attrib.attribSizeBytes = 4;
+                    quantized |= QUANTIZE_TEXCOORD;
+                }
+            }
+            else if (attrib.vertexAttrib == GLProgram::VERTEX_ATTRIB_BLEND_WEIGHT && attrib.size == 4 && (quantization & QUANTIZE_BLEND))
+            {
+                attrib.type = GL_UNSIGNED_BYTE;
+                attrib.attribSizeBytes = 4;
+                quantized |= QUANTIZE_BLEND;
+            }
+            else if (attrib.vertexAttrib == GLProgram::VERTEX_ATTRIB_BLEND_INDEX && attrib.size == 4 && (quantization & QUANTIZE_BLEND))
+            {
+                bool inRange = true;
+                for (int i = 0; i < vertexCount && inRange; ++i)
+                {
+                    const auto vertex = source + (i * sourceFloats + sourceOffset) * sizeof(float);
+                    for (int j = 0; j < 4 && inRange; ++j)
+                    {
+                        float index = readFloat(vertex, j);
+                        inRange = index >= 0.0f && index < 256.0f;
+                    }
+                }
+                if (inRange)
+                {
+                    attrib.type = GL_UNSIGNED_BYTE;
+                    attrib.attribSizeBytes = 4;
+                    quantized |= QUANTIZE_BLEND;
+                }
+            }
+        }
+        sourceOffset += floats;
+    }
+    if (quantized == QUANTIZE_NONE)
+        return false;
+
+    // the positions are mapped to [-1, 1] with the same scale on every axis, so the normal matrix is only scaled
+    Vec3 center = (minPosition + maxPosition) * 0.5f;
+    float halfExtent = std::max(std::max(maxPosition.x - center.x, maxPosition.y - center.y), maxPosition.z - center.z);
+    if (!(halfExtent > 0.0f))
+        halfExtent = 1.0f;
+    const float invHalfExtent = 1.0f / halfExtent;
+
+    int sizePerVertex = 0;
+    for (const auto& attrib : quantizedAttribs)
+    {
+        sizePerVertex += attrib.attribSizeBytes;
+    }
+    vertices.assign((size_t)sizePerVertex * vertexCount, 0);
+
+    for (int i = 0; i < vertexCount; ++i)
+    {
+        auto input = source + (size_t)i * sourceFloats * sizeof(float);
+        auto output = vertices.data() + (size_t)i * sizePerVertex;
+        for (size_t k = 0; k < quantizedAttribs.size(); ++k)
+        {
+            const auto& attrib = quantizedAttribs[k];
+            const int sourceBytes = attribs[k].attribSizeBytes;
+            if (attrib.type == GL_FLOAT)
+            {
+                memcpy(output, input, sourceBytes);
+            }
+            else if (attrib.vertexAttrib == GLProgram::VERTEX_ATTRIB_POSITION)
+            {
+                writeValue(output, 0, toSnorm16((readFloat(input, 0) - center.x) * invHalfExtent));
+                writeValue(output, 1, toSnorm16((readFloat(input, 1) - center.y) * invHalfExtent));
+                writeValue(output, 2, toSnorm16((readFloat(input, 2) - center.z) * invHalfExtent));
+            }
+            else if (attrib.vertexAttrib == GLProgram::VERTEX_ATTRIB_NORMAL)
+            {
+                float u, v;
+                encodeOctahedral(readFloat(input, 0), readFloat(input, 1), readFloat(input, 2), u, v);
+                writeValue(output, 0, toSnorm16(u));
+                writeValue(output, 1, toSnorm16(v));
+            }
+            else if (attrib.type == GL_UNSIGNED_SHORT)
+            {
+                writeValue(output, 0, toUnorm16(readFloat(input, 0)));
+                writeValue(output, 1, toUnorm16(readFloat(input, 1)));
+            }
+            else if (attrib.vertexAttrib == GLProgram::VERTEX_ATTRIB_BLEND_WEIGHT)
+            {
+                // round the weights and give the rounding error to the largest one, so that they still sum to 1
+                int weights[4], sum = 0, largest = 0;
+                float weightSum = 0.0f;
+                for (int j = 0; j < 4; ++j)
+                {
+                    float weight = clampf(readFloat(input, j), 0.0f, 1.0f);
+                    weightSum += weight;
+                    weights[j] = (int)std::round(weight * 255.0f);
+                    sum += weights[j];
+                    if (weights[j] > weights[largest])
+                        largest = j;
+                }
+                if (std::abs(weightSum - 1.0f) < 0.01f)
+                    weights[largest] = std::max(0, std::min(255, weights[largest] + 255 - sum));
+                for (int j = 0; j < 4; ++j)
+                    output[j] = (unsigned char)weights[j];
+            }
+            else
+            {
+                for (int j = 0; j < 4; ++j)
+                    output[j] = (unsigned char)readFloat(input, j);
+            }
+            input += sourceBytes;
+            output += attrib.attribSizeBytes;
+        }
+    }
+
+    attribs = quantizedAttribs;
+    _quantization = quantized;
+    if (quantized & QUANTIZE_POSITION)
+    {
+        Mat4::createTranslation(center, &_positionTransform);
+        _positionTransform.scale(halfExtent);
+    }
+    return true;
+}
+
+bool MeshVertexData::isNormalized(const MeshVertexAttrib& attrib)
+{
+    // the bone indices are read as integers
+    return attrib.type != GL_FLOAT && attrib.vertexAttrib != GLProgram::VERTEX_ATTRIB_BLEND_INDEX;
+}
+
 bool MeshVertexData::hasVertexAttrib(int attrib) const
 {
     for (const auto& it : _attribs) {
@@ -146,6 +398,7 @@ MeshVertexData::MeshVertexData()
 : _vertexData(nullptr)
 , _vertexBuffer(nullptr)
 , _vertexCount(0)
+, _quantization(QUANTIZE_NONE)
 {
     
 }
@@ -104,8 +104,66 @@ class CC_DLL MeshVertexData : public Ref
     friend class Sprite3D;
     friend class Mesh;
 public:
-    /**create*/
+    /**
+     * The attributes stored in smaller types in the vertex buffer, the MeshData keeps its floats.
+     * @since v3.14
+     */
+    enum Quantization
+    {
+        QUANTIZE_NONE = 0,
+        /** normalized 16 bit integers within the bounding box of the positions, see getPositionTransform() */
+        QUANTIZE_POSITION = 1 << 0,
+        /** octahedral encoding in two normalized 16 bit integers, decoded by the built in 3D shaders */
+        QUANTIZE_NORMAL = 1 << 1,
+        /** normalized unsigned 16 bit integers, only for the texture coordinates within [0, 1] */
+        QUANTIZE_TEXCOORD = 1 << 2,
+        /** normalized unsigned bytes for the weights, unsigned bytes for the indices of up to 256 bones */
+        QUANTIZE_BLEND = 1 << 3,
+        QUANTIZE_ALL = QUANTIZE_POSITION | QUANTIZE_NORMAL | QUANTIZE_TEXCOORD | QUANTIZE_BLEND
+    };
+
+    /**create, the attributes are quantized as set by setDefaultQuantization()*/
     static MeshVertexData* create(const MeshData& meshdata);
+
+    /**
+     * Creates the vertex data with some attributes quantized in the vertex buffer. A vertex with a position,
+     * a normal, texture coordinates and 4 bone weights takes 24 bytes instead of 64.
+     * The normals can only be quantized for materials using the built in 3D shaders, or shaders decoding them
+     * like these when the u_octahedralNormal uniform is 1.
+     *
+     * @param meshdata The vertices, in floats.
+     * @param quantization A combination of the Quantization flags.
+     * @since v3.14
+     */
+    static MeshVertexData* create(const MeshData& meshdata, int quantization);
+
+    /**
+     * Sets the Quantization flags used by create(const MeshData&), so by the Sprite3D loaded from the bundles
+     * and obj files. QUANTIZE_NONE by default. The meshes in the Sprite3DCache keep the format they were
+     * created with.
+     * @since v3.14
+     */
+    static void setDefaultQuantization(int quantization) { s_defaultQuantization = quantization; }
+    static int getDefaultQuantization() { return s_defaultQuantization; }
+
+    /**
+     * The Quantization flags of the attributes actually quantized.
+     * @since v3.14
+     */
+    int getQuantization() const { return _quantization; }
+
+    /**
+     * Maps the quantized positions, within [-1, 1], back to the positions of the mesh. Mesh applies it
+     * with the transform of the node, or with the matrix palette of the skinned meshes.
+     * @since v3.14
+     */
+    const Mat4& getPositionTransform() const { return _positionTransform; }
+
+    /**
+     * Returns whether an attribute of the vertex buffer is normalized when read by the shaders.
+     * @since v3.14
+     */
+    static bool isNormalized(const MeshVertexAttrib& attrib);
     
     /** get vertexbuffer */
     const VertexBuffer* getVertexBuffer() const { return _vertexBuffer; }
@@ -131,12 +189,19 @@ CC_CONSTRUCTOR_ACCESS:
     virtual ~MeshVertexData();
 
 protected:
+    /** Writes the quantized vertices and their attributes, returns false if no attribute can be quantized. */
+    bool quantize(const MeshData& meshdata, int vertexCount, int quantization, std::vector<MeshVertexAttrib>& attribs, std::vector<unsigned char>& vertices);
+
     VertexData*          _vertexData; //mesh vertex data
     VertexBuffer*        _vertexBuffer; // vertex buffer
     Vector<MeshIndexData*> _indexs; //index data
     std::vector<MeshVertexAttrib> _attribs; //vertex attributes
     
     int                  _vertexCount; //vertex count
+    int                  _quantization; //the attributes quantized
+    Mat4                 _positionTransform; //from the quantized positions to the mesh space
+
+    static int s_defaultQuantization;
 };
 
 // end of 3d group
@@ -28,11 +28,9 @@ THE SOFTWARE.
 #include "math/CCVertex.h"
 #include "base/CCDirector.h"
 #include "renderer/CCTextureCache.h"
-#include "renderer/ccGLStateCache.h"
 #include "renderer/CCTexture2D.h"
 #include "renderer/CCRenderer.h"
 #include "renderer/CCGLProgramState.h"
-#include "renderer/CCRenderState.h"
 
 NS_CC_BEGIN
 
@@ -45,12 +43,11 @@ MotionStreak3D::MotionStreak3D()
 , _minSeg(0.0f)
 , _maxPoints(0)
 , _nuPoints(0)
-, _previousNuPoints(0)
+, _firstPoint(0)
 , _pointVertexes(nullptr)
 , _pointState(nullptr)
-, _vertices(nullptr)
-, _colorPointer(nullptr)
-, _texCoords(nullptr)
+, _triangleVertices(nullptr)
+, _indices(nullptr)
 , _positionR2D(0.f, 0.f)
 , _sweepAxis(0.f, 1.f, 0.f)
 {
@@ -61,9 +58,8 @@ MotionStreak3D::~MotionStreak3D()
     CC_SAFE_RELEASE(_texture);
     CC_SAFE_FREE(_pointState);
     CC_SAFE_FREE(_pointVertexes);
-    CC_SAFE_FREE(_vertices);
-    CC_SAFE_FREE(_colorPointer);
-    CC_SAFE_FREE(_texCoords);
+    CC_SAFE_FREE(_triangleVertices);
+    CC_SAFE_FREE(_indices);
 }
 
 MotionStreak3D* MotionStreak3D::create(float fade, float minSeg, float stroke, const Color3B& color, const std::string& path)
@@ -116,18 +112,38 @@ bool MotionStreak3D::initWithFade(float fade, float minSeg, float stroke, const
 
     _maxPoints = (int)(fade*60.0f)+2;
     _nuPoints = 0;
-    _pointState = (float *)malloc(sizeof(float) * _maxPoints);
-    _pointVertexes = (Vec3*)malloc(sizeof(Vec3) * _maxPoints);
+    _firstPoint = 0;
+    // twice the points, so the living ones are moved back only once every _maxPoints new points
+    _pointState = (float *)malloc(sizeof(float) * _maxPoints * 2);
+    _pointVertexes = (Vec3*)malloc(sizeof(Vec3) * _maxPoints * 2);
 
-    _vertices = (Vec3*)malloc(sizeof(Vec3) * _maxPoints * 2);
-    _texCoords = (Tex2F*)malloc(sizeof(Tex2F) * _maxPoints * 2);
-    _colorPointer =  (GLubyte*)malloc(sizeof(GLubyte) * _maxPoints * 2 * 4);
+    _triangleVertices = (V3F_C4B_T2F*)malloc(sizeof(V3F_C4B_T2F) * _maxPoints * 4);
+
+    // two triangles between two points of the strip, and the same ones reversed for the face culling
+    _indices = (unsigned short*)malloc(sizeof(unsigned short) * (_maxPoints - 1) * 12);
+    for (unsigned int i = 0; i < _maxPoints - 1; i++)
+    {
+        const unsigned short vertex = (unsigned short)(i * 2);
+        unsigned short* indices = _indices + i * 12;
+        indices[0] = vertex;
+        indices[1] = vertex + 1;
+        indices[2] = vertex + 2;
+        indices[3] = vertex + 1;
+        indices[4] = vertex + 3;
+        indices[5] = vertex + 2;
+        indices[6] = vertex;
+        indices[7] = vertex + 2;
+        indices[8] = vertex + 1;
+        indices[9] = vertex + 1;
+        indices[10] = vertex + 2;
+        indices[11] = vertex + 3;
+    }
 
     // Set blend mode
     _blendFunc = BlendFunc::ALPHA_NON_PREMULTIPLIED;
 
     // shader state
-    setGLProgramState(GLProgramState::getOrCreateWithGLProgramName(GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR, texture));
+    setGLProgramState(GLProgramState::getOrCreateWithGLProgramName(GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR_NO_MVP, texture));
 
     setTexture(texture);
     setColor(color);
@@ -216,9 +232,12 @@ void MotionStreak3D::tintWithColor(const Color3B& colors)
     setColor(colors);
 
     // Fast assignation
+    V3F_C4B_T2F* vertices = _triangleVertices + _firstPoint * 2;
     for(unsigned int i = 0; i<_nuPoints*2; i++) 
     {
-        *((Color3B*) (_colorPointer+i*4)) = colors;
+        vertices[i].colors.r = colors.r;
+        vertices[i].colors.g = colors.g;
+        vertices[i].colors.b = colors.b;
     }
 }
 
@@ -276,52 +295,26 @@ void MotionStreak3D::update(float delta)
     
     delta *= _fadeDelta;
 
-    unsigned int newIdx, newIdx2, i, i2;
-    unsigned int mov = 0;
-
-    // Update current points
+    // Update current points, the oldest ones fade first and are dropped from the front
+    unsigned int i, mov = 0;
     for(i = 0; i<_nuPoints; i++)
     {
-        _pointState[i]-=delta;
+        const unsigned int index = _firstPoint + i;
+        _pointState[index]-=delta;
 
-        if(_pointState[i] <= 0)
-            mov++;
+        if(_pointState[index] <= 0)
+            mov = i + 1;
         else
         {
-            newIdx = i-mov;
-
-            if(mov>0)
-            {
-                // Move data
-                _pointState[newIdx] = _pointState[i];
-
-                // Move point
-                _pointVertexes[newIdx] = _pointVertexes[i];
-
-                // Move vertices
-                i2 = i*2;
-                newIdx2 = newIdx*2;
-                _vertices[newIdx2] = _vertices[i2];
-                _vertices[newIdx2+1] = _vertices[i2+1];
-
-                // Move color
-                i2 *= 4;
-                newIdx2 *= 4;
-                _colorPointer[newIdx2+0] = _colorPointer[i2+0];
-                _colorPointer[newIdx2+1] = _colorPointer[i2+1];
-                _colorPointer[newIdx2+2] = _colorPointer[i2+2];
-                _colorPointer[newIdx2+4] = _colorPointer[i2+4];
-                _colorPointer[newIdx2+5] = _colorPointer[i2+5];
-                _colorPointer[newIdx2+6] = _colorPointer[i2+6];
-            }else
-                newIdx2 = newIdx*8;
-
-            const GLubyte op = (GLubyte)(_pointState[newIdx] * 255.0f);
-            _colorPointer[newIdx2+3] = op;
-            _colorPointer[newIdx2+7] = op;
+            const GLubyte op = (GLubyte)(_pointState[index] * 255.0f);
+            _triangleVertices[index*2].colors.a = op;
+            _triangleVertices[index*2+1].colors.a = op;
         }
     }
     _nuPoints-=mov;
+    _firstPoint = _nuPoints ? _firstPoint + mov : 0;
+
+    Vec3* points = _pointVertexes + _firstPoint;
 
     // Append new point
     bool appendNewPoint = true;
@@ -332,8 +325,8 @@ void MotionStreak3D::update(float delta)
 
     else if(_nuPoints>0)
     {
-        bool a1 = (_pointVertexes[_nuPoints-1] - _positionR).lengthSquared() < _minSeg;
-        bool a2 = (_nuPoints == 1) ? false : ((_pointVertexes[_nuPoints-2] - _positionR).lengthSquared() < (_minSeg * 2.0f));
+        bool a1 = (points[_nuPoints-1] - _positionR).lengthSquared() < _minSeg;
+        bool a2 = (_nuPoints == 1) ? false : ((points[_nuPoints-2] - _positionR).lengthSquared() < (_minSeg * 2.0f));
         if(a1 || a2)
         {
             appendNewPoint = false;
@@ -342,75 +335,68 @@ void MotionStreak3D::update(float delta)
 
     if(appendNewPoint)
     {
-        _pointVertexes[_nuPoints] = _positionR;
-        _pointState[_nuPoints] = 1.0f;
+        // there is no room left after the living points, move them to the beginning of the arrays
+        if(_firstPoint + _nuPoints == _maxPoints * 2)
+        {
+            memmove(_pointState, _pointState + _firstPoint, sizeof(float) * _nuPoints);
+            memmove(_pointVertexes, _pointVertexes + _firstPoint, sizeof(Vec3) * _nuPoints);
+            memmove(_triangleVertices, _triangleVertices + _firstPoint * 2, sizeof(V3F_C4B_T2F) * _nuPoints * 2);
+            _firstPoint = 0;
+            points = _pointVertexes;
+        }
 
-        // Color assignment
-        const unsigned int offset = _nuPoints*8;
-        *((Color3B*)(_colorPointer + offset)) = _displayedColor;
-        *((Color3B*)(_colorPointer + offset+4)) = _displayedColor;
+        points[_nuPoints] = _positionR;
+        _pointState[_firstPoint + _nuPoints] = 1.0f;
 
-        // Opacity
-        _colorPointer[offset+3] = 255;
-        _colorPointer[offset+7] = 255;
+        // Color assignment
+        V3F_C4B_T2F* vertices = _triangleVertices + (_firstPoint + _nuPoints) * 2;
+        vertices[0].colors = Color4B(_displayedColor);
+        vertices[1].colors = Color4B(_displayedColor);
 
         // Generate polygon
         {
             float stroke = _stroke * 0.5f;
-            _vertices[_nuPoints * 2] = _pointVertexes[_nuPoints] + (_sweepAxis * stroke);
-            _vertices[_nuPoints * 2 + 1] = _pointVertexes[_nuPoints] - (_sweepAxis * stroke);
+            vertices[0].vertices = points[_nuPoints] + (_sweepAxis * stroke);
+            vertices[1].vertices = points[_nuPoints] - (_sweepAxis * stroke);
         }
 
         _nuPoints ++;
     }
 
-    // Updated Tex Coords only if they are different than previous step
-    if( _nuPoints  && _previousNuPoints != _nuPoints ) {
+    // Updated Tex Coords only if the living points changed
+    if( _nuPoints  && (mov > 0 || appendNewPoint) ) {
         float texDelta = 1.0f / _nuPoints;
+        V3F_C4B_T2F* vertices = _triangleVertices + _firstPoint * 2;
         for( i=0; i < _nuPoints; i++ ) {
-            _texCoords[i*2] = Tex2F(0, texDelta*i);
-            _texCoords[i*2+1] = Tex2F(1, texDelta*i);
+            vertices[i*2].texCoords = Tex2F(0, texDelta*i);
+            vertices[i*2+1].texCoords = Tex2F(1, texDelta*i);
         }
-
-        _previousNuPoints = _nuPoints;
     }
 }
 
 void MotionStreak3D::reset()
 {
     _nuPoints = 0;
-}
-
-void MotionStreak3D::onDraw(const Mat4 &transform, uint32_t /*flags*/)
-{  
-    getGLProgram()->use();
-    getGLProgram()->setUniformsForBuiltins(transform);
-
-    GL::enableVertexAttribs(GL::VERTEX_ATTRIB_FLAG_POS_COLOR_TEX );
-    GL::blendFunc( _blendFunc.src, _blendFunc.dst );
-
-    GL::bindTexture2D( _texture->getName() );
-    
-    glDisable(GL_CULL_FACE);
-    RenderState::StateBlock::_defaultState->setCullFace(false);
-    glEnable(GL_DEPTH_TEST);
-    RenderState::StateBlock::_defaultState->setDepthTest(true);
-
-    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 3, GL_FLOAT, GL_FALSE, 0, _vertices);
-    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORD, 2, GL_FLOAT, GL_FALSE, 0, _texCoords);
-    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, 0, _colorPointer);
-
-    glDrawArrays(GL_TRIANGLE_STRIP, 0, (GLsizei)_nuPoints*2);
-    CC_INCREMENT_GL_DRAWN_BATCHES_AND_VERTICES(1, _nuPoints*2);
+    _firstPoint = 0;
 }
 
 void MotionStreak3D::draw(Renderer *renderer, const Mat4 &transform, uint32_t flags)
 {
     if(_nuPoints <= 1)
         return;
-    _customCommand.init(_globalZOrder, transform, flags);
-    _customCommand.func = CC_CALLBACK_0(MotionStreak3D::onDraw, this, transform, flags);
-    renderer->addCommand(&_customCommand);
+
+    TrianglesCommand::Triangles triangles;
+    triangles.verts = _triangleVertices + _firstPoint * 2;
+    triangles.vertCount = _nuPoints * 2;
+    triangles.indices = _indices;
+    triangles.indexCount = (_nuPoints - 1) * 12;
+
+    // the transparent objects are drawn with the depth test and without writing the depth
+    flags |= Node::FLAGS_RENDER_AS_3D;
+    _trianglesCommand.init(_globalZOrder, _texture, getGLProgramState(), _blendFunc, triangles, transform, flags);
+    _trianglesCommand.setTransparent(true);
+    _trianglesCommand.set3D(true);
+    renderer->addCommand(&_trianglesCommand);
 }
 
 NS_CC_END
@@ -26,7 +26,7 @@ THE SOFTWARE.
 
 #include "base/CCProtocols.h"
 #include "2d/CCNode.h"
-#include "renderer/CCCustomCommand.h"
+#include "renderer/CCTrianglesCommand.h"
 
 NS_CC_BEGIN
 
@@ -39,6 +39,10 @@ class Texture2D;
 
 /** @class MotionStreak3D.
  * @brief Creates a trailing path. It is created from a line segment sweeping along the path.
+ *
+ * The streak is drawn with a TrianglesCommand among the transparent 3D objects, so the consecutive streaks with the
+ * same texture, blend function and shader are batched in one draw call by the Renderer. A custom shader must not
+ * apply the model view matrix, like the "_noMVP" ones, because the Renderer transforms the vertices.
  */
 class CC_DLL MotionStreak3D : public Node, public TextureProtocol
 {
@@ -161,9 +165,6 @@ CC_CONSTRUCTOR_ACCESS:
     bool initWithFade(float fade, float minSeg, float stroke, const Color3B& color, Texture2D* texture);
 
 protected:
-    //renderer callback
-    void onDraw(const Mat4 &transform, uint32_t flags);
-
     bool _startingPositionInitialized;
 
     /** texture used for the motion streak */
@@ -180,18 +181,21 @@ protected:
 
     unsigned int _maxPoints;
     unsigned int _nuPoints;
-    unsigned int _previousNuPoints;
+    /** The living points are in [_firstPoint, _firstPoint + _nuPoints) of the arrays, which have room for
+     * 2 * _maxPoints points: the faded points are dropped from the front without moving the others.
+     */
+    unsigned int _firstPoint;
 
     /** Pointers */
     Vec3* _pointVertexes;
     float* _pointState;
 
     // Opengl
-    Vec3* _vertices;
-    GLubyte* _colorPointer;
-    Tex2F* _texCoords;
-    
-    CustomCommand _customCommand;
+    V3F_C4B_T2F* _triangleVertices;
+    /** The triangles of the strip with both windings, their indices are relative to the first living point */
+    unsigned short* _indices;
+
+    TrianglesCommand _trianglesCommand;
 
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(MotionStreak3D);
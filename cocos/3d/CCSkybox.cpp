@@ -60,7 +60,7 @@ Skybox::~Skybox()
         _vao = 0;
     }
 
-    _texture->release();
+    CC_SAFE_RELEASE(_texture);
 }
 
 Skybox* Skybox::create(const std::string& positive_x, const std::string& negative_x,
@@ -74,6 +74,29 @@ Skybox* Skybox::create(const std::string& positive_x, const std::string& negativ
     return ret;
 }
 
+Skybox* Skybox::createAsync(const std::string& positive_x, const std::string& negative_x,
+                            const std::string& positive_y, const std::string& negative_y,
+                            const std::string& positive_z, const std::string& negative_z,
+                            const std::function<void(Skybox*)>& callback)
+{
+    auto ret = Skybox::create();
+
+    // kept until the texture is loaded
+    ret->retain();
+    TextureCube::createAsync(positive_x, negative_x, positive_y, negative_y, positive_z, negative_z, [ret, callback](TextureCube* texture) {
+        if (texture)
+        {
+            ret->setTexture(texture);
+        }
+        if (callback)
+        {
+            callback(texture ? ret : nullptr);
+        }
+        ret->release();
+    });
+    return ret;
+}
+
 bool Skybox::init()
 {
     // create and set our custom shader
@@ -158,6 +181,10 @@ void Skybox::initBuffers()
 
 void Skybox::draw(Renderer* renderer, const Mat4& transform, uint32_t flags)
 {
+    // still loading
+    if (_texture == nullptr)
+        return;
+
     _customCommand.init(_globalZOrder);
     _customCommand.func = CC_CALLBACK_0(Skybox::onDraw, this, transform, flags);
     _customCommand.setTransparent(false);
@@ -183,19 +210,19 @@ void Skybox::onDraw(const Mat4& transform, uint32_t /*flags*/)
     state->setUniformVec4("u_color", color);
     state->setUniformMat4("u_cameraRot", cameraModelMat);
 
-    glEnable(GL_DEPTH_TEST);
+    GL::enable(GL_DEPTH_TEST);
     RenderState::StateBlock::_defaultState->setDepthTest(true);
 
-    glDepthFunc(GL_LEQUAL);
+    GL::depthFunc(GL_LEQUAL);
     RenderState::StateBlock::_defaultState->setDepthFunction(RenderState::DEPTH_LEQUAL);
 
-    glEnable(GL_CULL_FACE);
+    GL::enable(GL_CULL_FACE);
     RenderState::StateBlock::_defaultState->setCullFace(true);
 
-    glCullFace(GL_BACK);
+    GL::cullFace(GL_BACK);
     RenderState::StateBlock::_defaultState->setCullFaceSide(RenderState::CULL_FACE_SIDE_BACK);
     
-    glDisable(GL_BLEND);
+    GL::disable(GL_BLEND);
     RenderState::StateBlock::_defaultState->setBlend(false);
 
     if (Configuration::getInstance()->supportsShareableVAO())
@@ -60,6 +60,18 @@ public:
                                const std::string& positive_y, const std::string& negative_y,
                                const std::string& positive_z, const std::string& negative_z);
 
+    /** Creates a skybox without texture, its faces are loaded with TextureCube::createAsync().
+     * Nothing is drawn before they are loaded, so the frame isn't blocked while they are decoded.
+     *
+     * @param callback Called once the texture is set, or with nullptr if a face can't be loaded. Can be nullptr.
+     * @return An autoreleased skybox.
+     * @since v3.14
+     */
+    static Skybox* createAsync(const std::string& positive_x, const std::string& negative_x,
+                               const std::string& positive_y, const std::string& negative_y,
+                               const std::string& positive_z, const std::string& negative_z,
+                               const std::function<void(Skybox*)>& callback = nullptr);
+
     /**texture getter and setter*/
     void setTexture(TextureCube*);
 
@@ -29,12 +29,15 @@
 #include "3d/CCSprite3DMaterial.h"
 #include "3d/CCAttachNode.h"
 #include "3d/CCMesh.h"
+#include "3d/CCFrustum.h"
+#include "3d/CCRay.h"
 
 #include "base/CCDirector.h"
 #include "base/CCAsyncTaskPool.h"
 #include "base/ccUTF8.h"
 #include "2d/CCLight.h"
 #include "2d/CCCamera.h"
+#include "2d/CCScene.h"
 #include "base/ccMacros.h"
 #include "platform/CCPlatformMacros.h"
 #include "platform/CCFileUtils.h"
@@ -216,10 +219,17 @@ bool Sprite3D::loadFromCache(const std::string& path)
             }
         }
 
-        for (ssize_t i = 0, size = _meshes.size(); i < size; ++i) {
-            // cloning is needed in order to have one state per sprite
-            auto glstate = spritedata->glProgramStates.at(i);
-            _meshes.at(i)->setGLProgramState(glstate->clone());
+        if (Sprite3DCache::getInstance()->isMaterialSharingEnabled())
+        {
+            genMaterial();
+        }
+        else
+        {
+            for (ssize_t i = 0, size = _meshes.size(); i < size; ++i) {
+                // cloning is needed in order to have one state per sprite
+                auto glstate = spritedata->glProgramStates.at(i);
+                _meshes.at(i)->setGLProgramState(glstate->clone());
+            }
         }
         return true;
     }
@@ -239,7 +249,9 @@ bool Sprite3D::loadFromFile(const std::string& path, NodeDatas* nodedatas, MeshD
     else if (ext == ".c3b" || ext == ".c3t")
     {
         //load from .c3b or .c3t
+        // the meshes are only uploaded, so they are left in the mapped bundle
         auto bundle = Bundle3D::createBundle();
+        bundle->setMappedMeshesEnabled(true);
         if (!bundle->load(fullPath))
         {
             Bundle3D::destroyBundle(bundle);
@@ -263,11 +275,19 @@ Sprite3D::Sprite3D()
 , _shaderUsingLight(false)
 , _forceDepthWrite(false)
 , _usingAutogeneratedGLProgram(true)
+, _skinningUpdated(false)
+, _skinningFrame(0)
+, _spatialIndex(nullptr)
+, _spatialProxy(AABBTree::NULL_PROXY)
+, _spatialVisibleStamp(0)
+, _spatialMovedFrame(0)
 {
 }
 
 Sprite3D::~Sprite3D()
 {
+    if (_spatialIndex)
+        _spatialIndex->remove(this);
     _meshes.clear();
     _meshVertexDatas.clear();
     CC_SAFE_RELEASE_NULL(_skeleton);
@@ -401,7 +421,7 @@ Sprite3D* Sprite3D::createSprite3DNode(NodeData* nodedata,ModelData* modeldata,c
                 textureData = materialData->getTextureData(NTextureData::Usage::Normal);
                 if (textureData)
                 {
-                    auto tex = Director::getInstance()->getTextureCache()->addImage(textureData->filename);
+                    auto tex = Director::getInstance()->getTextureCache()->addStreamedImage(textureData->filename);
                     if(tex)
                     {
                         Texture2D::TexParams texParams;
@@ -497,6 +517,7 @@ void Sprite3D::genMaterial(bool useLight)
         materials[meshVertexData] = material;
     }
     
+    auto cache = Sprite3DCache::getInstance();
     for (auto& mesh: _meshes)
     {
         auto material = materials[mesh->getMeshIndexData()->getMeshVertexData()];
@@ -507,10 +528,35 @@ void Sprite3D::genMaterial(bool useLight)
             material->setStateBlock(oldmaterial->getStateBlock());
         }
 
-        if (material->getReferenceCount() == 1)
+        // a state block changed by the sprite only is kept for it, the shared ones live in the cache
+        if (cache->isMaterialSharingEnabled() && mesh->getLODLevelCount() == 0 && (!oldmaterial || mesh->isMaterialShared()))
+        {
+            // the hash of the state blocks isn't computed, they are identified by their address
+            std::string key;
+            const void* objects[] = { material, mesh->getMeshIndexData(), material->getStateBlock() };
+            key.append((const char*)objects, sizeof(objects));
+            for (const auto& tex : mesh->_textures)
+            {
+                key.append((const char*)&tex.first, sizeof(tex.first));
+                key.append((const char*)&tex.second, sizeof(tex.second));
+            }
+            key.append((const char*)&mesh->_blend, sizeof(mesh->_blend));
+
+            auto shared = cache->getSharedMaterial(key);
+            if (shared == nullptr)
+            {
+                shared = material->clone();
+                cache->addSharedMaterial(key, shared);
+            }
+            mesh->setSharedMaterial(shared);
+        }
+        else if (material->getReferenceCount() == 1)
             mesh->setMaterial(material);
         else
             mesh->setMaterial(material->clone());
+
+        if (mesh->isInstancingEnabled())
+            mesh->switchBuiltInMaterial();
     }
 }
 
@@ -565,7 +611,7 @@ void Sprite3D::createNode(NodeData* nodedata, Node* root, const MaterialDatas& m
                             textureData = materialData->getTextureData(NTextureData::Usage::Normal);
                             if (textureData)
                             {
-                                auto tex = Director::getInstance()->getTextureCache()->addImage(textureData->filename);
+                                auto tex = Director::getInstance()->getTextureCache()->addStreamedImage(textureData->filename);
                                 if (tex)
                                 {
                                     Texture2D::TexParams texParams;
@@ -658,7 +704,7 @@ void  Sprite3D::addMesh(Mesh* mesh)
 
 void Sprite3D::setTexture(const std::string& texFile)
 {
-    auto tex = Director::getInstance()->getTextureCache()->addImage(texFile);
+    auto tex = Director::getInstance()->getTextureCache()->addStreamedImage(texFile);
     setTexture(tex);
 }
 
@@ -720,6 +766,11 @@ void Sprite3D::visit(cocos2d::Renderer *renderer, const cocos2d::Mat4 &parentTra
     
     //
     Director* director = Director::getInstance();
+    if (_spatialIndex && ((flags & FLAGS_DIRTY_MASK) || _aabbDirty))
+    {
+        _spatialIndex->update(this);
+        _spatialMovedFrame = director->getTotalFrames();
+    }
     director->pushMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
     director->loadMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW, _modelViewTransform);
     
@@ -755,16 +806,136 @@ void Sprite3D::visit(cocos2d::Renderer *renderer, const cocos2d::Mat4 &parentTra
     director->popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
 }
 
+// the diameter in pixels of the bounding sphere of a box
+static float getProjectedSize(const AABB& aabb, const Camera* camera)
+{
+    Vec3 center = (aabb._min + aabb._max) * 0.5f;
+    float diameter = aabb._min.distance(aabb._max);
+
+    Vec4 clipPos;
+    camera->getViewProjectionMatrix().transformVector(Vec4(center.x, center.y, center.z, 1.0f), &clipPos);
+    if (clipPos.w <= FLT_EPSILON)
+        return FLT_MAX;
+
+    // the projection scales y by m[5], clip space spans 2 units of the viewport height
+    float viewportHeight = Director::getInstance()->getWinSizeInPixels().height;
+    return diameter * camera->getProjectionMatrix().m[5] * 0.5f * viewportHeight / clipPos.w;
+}
+
+void Sprite3D::setLODScreenSizes(const std::vector<float>& screenSizes)
+{
+    for (auto mesh : _meshes)
+    {
+        mesh->removeAllLODLevels();
+        auto indexData = mesh->getMeshIndexData();
+        if (!indexData)
+            continue;
+
+        for (size_t i = 0; i < screenSizes.size(); ++i)
+        {
+            auto level = getMeshIndexData(StringUtils::format("%s_LOD%d", indexData->getId().c_str(), (int)i + 1));
+            if (!level)
+                break;
+            if (level->getMeshVertexData() != indexData->getMeshVertexData())
+            {
+                CCLOG("warning: the level of detail %s doesn't use the vertex data of its mesh", level->getId().c_str());
+                break;
+            }
+            mesh->addLODLevel(level, screenSizes[i]);
+        }
+    }
+}
+
+void Sprite3D::updateSkinning()
+{
+    if (!_skeleton)
+        return;
+
+    _skeleton->updateBoneMatrix();
+    for (auto mesh : _meshes)
+    {
+        auto skin = mesh->getSkin();
+        if (skin)
+            skin->updateMatrixPalette();
+    }
+    _skinningUpdated = true;
+    _skinningFrame = Director::getInstance()->getTotalFrames();
+}
+
+void Sprite3D::onEnter()
+{
+    Node::onEnter();
+
+    auto scene = getScene();
+    if (scene && scene->getSpatialIndex3D())
+        scene->getSpatialIndex3D()->add(this);
+}
+
+void Sprite3D::onExit()
+{
+    if (_spatialIndex)
+        _spatialIndex->remove(this);
+
+    Node::onExit();
+}
+
 void Sprite3D::draw(Renderer *renderer, const Mat4 &transform, uint32_t flags)
 {
 #if CC_USE_CULLING
-    // camera clipping
-    if(_children.size() == 0 && Camera::getVisitingCamera() && !Camera::getVisitingCamera()->isVisibleInFrustum(&getAABB()))
-        return;
+    // camera clipping, with the last cull of the index unless the sprite moved since
+    if(_children.size() == 0 && Camera::getVisitingCamera() && renderer->isCullingEnabled())
+    {
+        if (_spatialIndex && _spatialMovedFrame != Director::getInstance()->getTotalFrames())
+        {
+            if (!_spatialIndex->isVisible(this))
+                return;
+        }
+        else if (!Camera::getVisitingCamera()->isVisibleInFrustum(&getAABB()))
+            return;
+
+        // hidden behind other objects in the previous frames
+        if (renderer->isOcclusionCullingEnabled() && renderer->isOccluded(this, getAABB()))
+            return;
+    }
+
+    // then the meshes
+    bool cullMeshes = _children.size() == 0 && _meshes.size() > 1 && Camera::getVisitingCamera();
+    if (cullMeshes)
+    {
+        getAABB();
+        _meshVisibleMasks.resize((_meshAABBs.size() + 31) / 32);
+        Camera::getVisitingCamera()->cullAABBs(_meshAABBs, _meshVisibleMasks.data());
+    }
+#else
+    bool cullMeshes = false;
 #endif
+
+    // streamed textures get the mips the projected bounds need, and meshes their level of detail
+    auto textureCache = Director::getInstance()->getTextureCache();
+    auto camera = Camera::getVisitingCamera();
+    bool hasLOD = false;
+    for (auto mesh : _meshes)
+        hasLOD = hasLOD || mesh->getLODLevelCount() > 0;
+    if ((textureCache->isStreamingEnabled() || hasLOD) && camera)
+    {
+        float screenSize = getProjectedSize(getAABB(), camera);
+        for (auto mesh : _meshes)
+        {
+            if (textureCache->isStreamingEnabled())
+            {
+                for (auto& texture : mesh->_textures)
+                    textureCache->requestStreamingSize(texture.second, screenSize);
+            }
+            if (hasLOD)
+                mesh->selectLOD(screenSize);
+        }
+    }
     
-    if (_skeleton)
+    if (_skeleton && (!_skinningUpdated || _skinningFrame != Director::getInstance()->getTotalFrames()))
+    {
+        _skinningUpdated = false;
         _skeleton->updateBoneMatrix();
+    }
     
     Color4F color(getDisplayedColor());
     color.a = getDisplayedOpacity() / 255.0f;
@@ -788,8 +959,12 @@ void Sprite3D::draw(Renderer *renderer, const Mat4 &transform, uint32_t flags)
         }
     }
     
-    for (auto mesh: _meshes)
+    for (ssize_t i = 0, count = _meshes.size(); i < count; ++i)
     {
+        if (cullMeshes && !(_meshVisibleMasks[i >> 5] & (1u << (i & 31))))
+            continue;
+
+        auto mesh = _meshes.at(i);
         mesh->draw(renderer,
                    _globalZOrder,
                    transform,
@@ -848,15 +1023,28 @@ const AABB& Sprite3D::getAABB() const
     else
     {
         _aabb.reset();
-        if (_meshes.size())
+        _meshAABBs.clear();
+        if (_meshes.size() == 1)
         {
-            Mat4 transform(nodeToWorldTransform);
+            if (_meshes.at(0)->isVisible())
+            {
+                _aabb = _meshes.at(0)->getAABB();
+                _aabb.transform(nodeToWorldTransform);
+            }
+            _nodeToWorldTransform = nodeToWorldTransform;
+            _aabbDirty = false;
+        }
+        else if (_meshes.size())
+        {
+            // keep the box of each mesh, so that the meshes of large models are culled one by one
             for (const auto& it : _meshes) {
+                AABB aabb(it->getAABB());
+                aabb.transform(nodeToWorldTransform);
+                _meshAABBs.push_back(aabb);
                 if (it->isVisible())
-                    _aabb.merge(it->getAABB());
+                    _aabb.merge(aabb);
             }
             
-            _aabb.transform(transform);
             _nodeToWorldTransform = nodeToWorldTransform;
             _aabbDirty = false;
         }
@@ -881,6 +1069,7 @@ Rect Sprite3D::getBoundingBox() const
 void Sprite3D::setCullFace(GLenum cullFace)
 {
     for (auto& it : _meshes) {
+        it->unshareMaterial();
         it->getMaterial()->getStateBlock()->setCullFaceSide((RenderState::CullFaceSide)cullFace);
 //        it->getMeshCommand().setCullFace(cullFace);
     }
@@ -889,6 +1078,7 @@ void Sprite3D::setCullFace(GLenum cullFace)
 void Sprite3D::setCullFaceEnabled(bool enable)
 {
     for (auto& it : _meshes) {
+        it->unshareMaterial();
         it->getMaterial()->getStateBlock()->setCullFace(enable);
 //        it->getMeshCommand().setCullFaceEnabled(enable);
     }
@@ -945,6 +1135,140 @@ void Sprite3D::setForce2DQueue(bool force2D)
     }
 }
 
+void Sprite3D::setInstancingEnabled(bool enabled)
+{
+    for (const auto &mesh : _meshes) {
+        mesh->setInstancingEnabled(enabled);
+    }
+}
+
+///////////////////////////////////////////////////////////////////////////////////
+SpatialIndex3D::SpatialIndex3D()
+: _cullStamp(1)
+{
+}
+
+SpatialIndex3D::~SpatialIndex3D()
+{
+    clear();
+}
+
+void SpatialIndex3D::add(Sprite3D* sprite)
+{
+    if (sprite->_spatialIndex == this)
+        return;
+    if (sprite->_spatialIndex)
+        sprite->_spatialIndex->remove(sprite);
+
+    const auto& aabb = sprite->getAABB();
+    std::lock_guard<std::mutex> lock(_mutex);
+    sprite->_spatialIndex = this;
+    sprite->_spatialProxy = aabb.isEmpty() ? AABBTree::NULL_PROXY : _tree.createProxy(aabb, sprite);
+    // not culled yet, the sprite tests itself until the next frame
+    sprite->_spatialMovedFrame = Director::getInstance()->getTotalFrames();
+}
+
+void SpatialIndex3D::remove(Sprite3D* sprite)
+{
+    if (sprite->_spatialIndex != this)
+        return;
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (sprite->_spatialProxy != AABBTree::NULL_PROXY)
+        _tree.destroyProxy(sprite->_spatialProxy);
+    sprite->_spatialIndex = nullptr;
+    sprite->_spatialProxy = AABBTree::NULL_PROXY;
+}
+
+void SpatialIndex3D::update(Sprite3D* sprite)
+{
+    if (sprite->_spatialIndex != this)
+        return;
+
+    const auto& aabb = sprite->getAABB();
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (aabb.isEmpty())
+    {
+        if (sprite->_spatialProxy != AABBTree::NULL_PROXY)
+            _tree.destroyProxy(sprite->_spatialProxy);
+        sprite->_spatialProxy = AABBTree::NULL_PROXY;
+    }
+    else if (sprite->_spatialProxy == AABBTree::NULL_PROXY)
+        sprite->_spatialProxy = _tree.createProxy(aabb, sprite);
+    else
+        _tree.moveProxy(sprite->_spatialProxy, aabb);
+}
+
+void SpatialIndex3D::clear()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _tree.query(AABB(Vec3(-FLT_MAX, -FLT_MAX, -FLT_MAX), Vec3(FLT_MAX, FLT_MAX, FLT_MAX)), [this](int proxy) {
+        auto sprite = static_cast<Sprite3D*>(_tree.getUserData(proxy));
+        sprite->_spatialIndex = nullptr;
+        sprite->_spatialProxy = AABBTree::NULL_PROXY;
+        return true;
+    });
+    _tree.clear();
+}
+
+void SpatialIndex3D::cull(const Camera* camera)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    unsigned int stamp = ++_cullStamp;
+    _tree.query(camera->getFrustum(), [this, stamp](int proxy) {
+        static_cast<Sprite3D*>(_tree.getUserData(proxy))->_spatialVisibleStamp = stamp;
+        return true;
+    });
+}
+
+Sprite3D* SpatialIndex3D::rayCast(const Ray& ray, float* distance) const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    Sprite3D* closest = nullptr;
+    float closestDistance = FLT_MAX;
+    _tree.rayCast(ray, FLT_MAX, [&](int proxy, float) {
+        // the tree stores enlarged boxes, test the bounds of the sprite
+        auto sprite = static_cast<Sprite3D*>(_tree.getUserData(proxy));
+        float hitDistance = 0.0f;
+        if (ray.intersects(sprite->getAABB(), &hitDistance) && hitDistance < closestDistance)
+        {
+            closest = sprite;
+            closestDistance = hitDistance;
+        }
+        return closestDistance;
+    });
+
+    if (closest && distance)
+        *distance = closestDistance;
+    return closest;
+}
+
+std::vector<Sprite3D*> SpatialIndex3D::queryAABB(const AABB& aabb) const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    std::vector<Sprite3D*> sprites;
+    _tree.query(aabb, [&](int proxy) {
+        auto sprite = static_cast<Sprite3D*>(_tree.getUserData(proxy));
+        if (sprite->getAABB().intersects(aabb))
+            sprites.push_back(sprite);
+        return true;
+    });
+    return sprites;
+}
+
+std::vector<Sprite3D*> SpatialIndex3D::queryFrustum(const Frustum& frustum) const
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    std::vector<Sprite3D*> sprites;
+    _tree.query(frustum, [&](int proxy) {
+        auto sprite = static_cast<Sprite3D*>(_tree.getUserData(proxy));
+        if (!frustum.isOutOfFrustum(sprite->getAABB()))
+            sprites.push_back(sprite);
+        return true;
+    });
+    return sprites;
+}
+
 ///////////////////////////////////////////////////////////////////////////////////
 Sprite3DCache* Sprite3DCache::_cacheInstance = nullptr;
 Sprite3DCache* Sprite3DCache::getInstance()
@@ -989,6 +1313,7 @@ void Sprite3DCache::removeSprite3DData(const std::string& key)
         delete it->second;
         _spriteDatas.erase(it);
     }
+    removeUnusedSharedMaterials();
 }
 
 void Sprite3DCache::removeAllSprite3DData()
@@ -997,9 +1322,51 @@ void Sprite3DCache::removeAllSprite3DData()
         delete it.second;
     }
     _spriteDatas.clear();
+
+    for (auto& it : _sharedMaterials) {
+        it.second->release();
+    }
+    _sharedMaterials.clear();
+}
+
+Material* Sprite3DCache::getSharedMaterial(const std::string& key) const
+{
+    auto it = _sharedMaterials.find(key);
+    if (it != _sharedMaterials.end())
+        return it->second;
+    return nullptr;
+}
+
+void Sprite3DCache::addSharedMaterial(const std::string& key, Material* material)
+{
+    CCASSERT(material, "material should not be null");
+    material->retain();
+    auto it = _sharedMaterials.find(key);
+    if (it != _sharedMaterials.end())
+    {
+        it->second->release();
+        it->second = material;
+    }
+    else
+        _sharedMaterials[key] = material;
+}
+
+void Sprite3DCache::removeUnusedSharedMaterials()
+{
+    for (auto it = _sharedMaterials.begin(); it != _sharedMaterials.end();)
+    {
+        if (it->second->getReferenceCount() == 1)
+        {
+            it->second->release();
+            it = _sharedMaterials.erase(it);
+        }
+        else
+            ++it;
+    }
 }
 
 Sprite3DCache::Sprite3DCache()
+: _materialSharing(false)
 {
     
 }
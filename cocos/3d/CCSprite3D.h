@@ -25,6 +25,7 @@
 #ifndef __CCSPRITE3D_H__
 #define __CCSPRITE3D_H__
 
+#include <mutex>
 #include <unordered_map>
 
 #include "base/CCVector.h"
@@ -50,10 +51,14 @@ class Mesh;
 class Texture2D;
 class MeshSkin;
 class AttachNode;
+class Ray;
+class Frustum;
+class SpatialIndex3D;
 struct NodeData;
 /** @brief Sprite3D: A sprite can be loaded from 3D model files, .obj, .c3t, .c3b, then can be drawn as sprite */
 class CC_DLL Sprite3D : public Node, public BlendProtocol
 {
+    friend class SpatialIndex3D;
 public:
     /**
      * Creates an empty sprite3D without 3D model and texture.
@@ -107,7 +112,22 @@ public:
     CC_DEPRECATED_ATTRIBUTE MeshSkin* getSkin() const;
     
     Skeleton3D* getSkeleton() const { return _skeleton; }
+
+    /**
+     * Update the bone matrices and the matrix palettes of the skinned meshes now, draw() then skips this work
+     * for the rest of the frame. Used by the parallel Animate3D update, which calls it from worker threads.
+     */
+    void updateSkinning();
     
+    /**
+     * Set up the levels of detail of the meshes from the model: the sub meshes whose id is the one of a mesh
+     * followed by "_LOD1", "_LOD2"... become its levels, drawn when the projected size of the sprite in pixels
+     * is below the matching screen size. Levels may also be added at runtime with Mesh::addLODLevel().
+     * @param screenSizes The screen size of each level, an empty vector removes the levels.
+     * @since v3.14
+     */
+    void setLODScreenSizes(const std::vector<float>& screenSizes);
+
     /**get AttachNode by bone name, return nullptr if not exist*/
     AttachNode* getAttachNode(const std::string& boneName);
     
@@ -177,6 +197,10 @@ public:
     /**draw*/
     virtual void draw(Renderer *renderer, const Mat4 &transform, uint32_t flags) override;
 
+    /** registers the sprite in the spatial index of its scene, if any */
+    virtual void onEnter() override;
+    virtual void onExit() override;
+
     /** Adds a new material to the sprite.
      The Material will be applied to all the meshes that belong to the sprite.
      Internally it will call `setMaterial(material,-1)`
@@ -200,6 +224,12 @@ public:
     */
     void setForce2DQueue(bool force2D);
 
+    /**
+     * Let the meshes of the sprite be merged into instanced draws, see Mesh::setInstancingEnabled().
+     * @since v3.14
+     */
+    void setInstancingEnabled(bool enabled);
+
     /**
     * Get meshes used in sprite 3d
     */
@@ -261,10 +291,18 @@ protected:
     mutable AABB                 _aabb;                 // cache current aabb
     mutable Mat4                 _nodeToWorldTransform; // cache the matrix
     mutable bool                 _aabbDirty;
+    mutable AABBArray            _meshAABBs;            // cache the aabb of every mesh, to cull them
+    std::vector<uint32_t>        _meshVisibleMasks;
     unsigned int                 _lightMask;
     bool                         _shaderUsingLight; // is current shader using light ?
     bool                         _forceDepthWrite; // Always write to depth buffer
     bool                         _usingAutogeneratedGLProgram;
+    bool                         _skinningUpdated; // skinning done by updateSkinning() in _skinningFrame
+    unsigned int                 _skinningFrame;
+    SpatialIndex3D*              _spatialIndex; // weak ref, the index of the scene the sprite is in
+    int                          _spatialProxy;
+    unsigned int                 _spatialVisibleStamp; // the last cull of _spatialIndex the sprite was visible in
+    unsigned int                 _spatialMovedFrame; // the frame the sprite moved in the index
     
     struct AsyncLoadParam
     {
@@ -280,6 +318,51 @@ protected:
     AsyncLoadParam             _asyncLoadParam;
 };
 
+///////////////////////////////////////////////////////
+/**
+ * SpatialIndex3D
+ * @brief A bounding volume hierarchy of the Sprite3Ds of a scene, see Scene::setSpatialIndex3DEnabled.
+ * The sprites are culled once per camera, before the scene is visited, and only check the result when they draw.
+ * The index can also pick the closest sprite hit by a ray and find the sprites in a box or a frustum.
+ * @since v3.14
+ */
+class CC_DLL SpatialIndex3D
+{
+public:
+    SpatialIndex3D();
+    ~SpatialIndex3D();
+
+    /** adds a sprite, done by the sprite when it enters a scene with an index */
+    void add(Sprite3D* sprite);
+    /** removes a sprite, done by the sprite when it exits the scene */
+    void remove(Sprite3D* sprite);
+    /** updates the bounds of a sprite, done by the sprite when it is visited after it moved */
+    void update(Sprite3D* sprite);
+    /** removes all the sprites */
+    void clear();
+
+    /** finds the sprites visible by the camera */
+    void cull(const Camera* camera);
+    /** whether the sprite was visible in the last cull */
+    bool isVisible(const Sprite3D* sprite) const { return sprite->_spatialVisibleStamp == _cullStamp; }
+
+    /** returns the closest sprite whose bounds are hit by the ray, nullptr if none, and the distance of the hit */
+    Sprite3D* rayCast(const Ray& ray, float* distance = nullptr) const;
+    /** returns the sprites whose bounds intersect the box */
+    std::vector<Sprite3D*> queryAABB(const AABB& aabb) const;
+    /** returns the sprites whose bounds aren't out of the frustum */
+    std::vector<Sprite3D*> queryFrustum(const Frustum& frustum) const;
+
+    /** returns the number of sprites and the height of the tree */
+    int getSpriteCount() const { return _tree.getProxyCount(); }
+    int getHeight() const { return _tree.getHeight(); }
+
+protected:
+    AABBTree _tree;
+    unsigned int _cullStamp;
+    mutable std::mutex _mutex; // sprites may move in the index from the threads visiting the scene
+};
+
 ///////////////////////////////////////////////////////
 /**
  * Sprite3DCache
@@ -328,6 +411,39 @@ public:
     
     /**remove all the SpriteData from Sprite3D*/
     void removeAllSprite3DData();
+
+    /**
+     * Enables the sharing of the materials between the meshes created from now on with the same data, textures,
+     * blend function and render states, e.g. the sprites created from the same file. One GLProgramState per pass
+     * is kept instead of one per mesh, the uniforms of each mesh are set when it is drawn, see Mesh::setSharedMaterial().
+     * Disabled by default since the changes made directly to the GLProgramStates of a sprite would apply to all of them,
+     * the meshes with levels of detail are never shared.
+     * @since v3.14
+     */
+    void setMaterialSharingEnabled(bool enabled) { _materialSharing = enabled; }
+    bool isMaterialSharingEnabled() const { return _materialSharing; }
+
+    /**
+     * get the shared material of the specified key, nullptr if there is none
+     *
+     * @lua NA
+     * @since v3.14
+     */
+    Material* getSharedMaterial(const std::string& key) const;
+
+    /**
+     * add a shared material, the cache retains it
+     *
+     * @lua NA
+     * @since v3.14
+     */
+    void addSharedMaterial(const std::string& key, Material* material);
+
+    /**remove the shared materials no mesh uses @since v3.14*/
+    void removeUnusedSharedMaterials();
+
+    /**the number of shared materials @since v3.14*/
+    ssize_t getSharedMaterialCount() const { return (ssize_t)_sharedMaterials.size(); }
     
     CC_CONSTRUCTOR_ACCESS:
     Sprite3DCache();
@@ -338,6 +454,8 @@ protected:
     
     static Sprite3DCache*                        _cacheInstance;
     std::unordered_map<std::string, Sprite3DData*> _spriteDatas; //cached sprite data
+    std::unordered_map<std::string, Material*> _sharedMaterials; //materials shared by the meshes
+    bool _materialSharing;
 };
 
 // end of 3d group
@@ -211,6 +211,49 @@ Sprite3DMaterial* Sprite3DMaterial::createBuiltInMaterial(MaterialType type, boo
     return nullptr;
 }
 
+Sprite3DMaterial* Sprite3DMaterial::createBuiltInMaterial(MaterialType type, bool skinned, bool instanced)
+{
+    const char* name = nullptr;
+    if (instanced)
+    {
+        switch (type) {
+            case Sprite3DMaterial::MaterialType::UNLIT:
+                name = skinned ? GLProgram::SHADER_3D_SKINPOSITION_TEXTURE_INSTANCED : GLProgram::SHADER_3D_POSITION_TEXTURE_INSTANCED;
+                break;
+                
+            case Sprite3DMaterial::MaterialType::UNLIT_NOTEX:
+                name = GLProgram::SHADER_3D_POSITION_INSTANCED;
+                break;
+                
+            case Sprite3DMaterial::MaterialType::DIFFUSE:
+                name = skinned ? GLProgram::SHADER_3D_SKINPOSITION_NORMAL_TEXTURE_INSTANCED : GLProgram::SHADER_3D_POSITION_NORMAL_TEXTURE_INSTANCED;
+                break;
+                
+            case Sprite3DMaterial::MaterialType::DIFFUSE_NOTEX:
+                name = GLProgram::SHADER_3D_POSITION_NORMAL_INSTANCED;
+                break;
+                
+            default:
+                break;
+        }
+    }
+    
+    // the instanced programs are only registered when the device supports instancing
+    auto glProgram = name ? GLProgramCache::getInstance()->getGLProgram(name) : nullptr;
+    if (glProgram == nullptr)
+        return createBuiltInMaterial(type, skinned);
+    
+    auto material = new (std::nothrow) Sprite3DMaterial();
+    if (material && material->initWithGLProgramState(GLProgramState::create(glProgram)))
+    {
+        material->_type = type;
+        material->autorelease();
+        return material;
+    }
+    CC_SAFE_DELETE(material);
+    return nullptr;
+}
+
 Sprite3DMaterial* Sprite3DMaterial::createWithFilename(const std::string& path)
 {
     auto validfilename = FileUtils::getInstance()->fullPathForFilename(path);
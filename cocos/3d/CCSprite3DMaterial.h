@@ -77,6 +77,16 @@ public:
      */
     static Sprite3DMaterial* createBuiltInMaterial(MaterialType type, bool skinned);
     
+    /**
+     * Create built in material from material type, using the instanced variant of its program
+     * @param type Material type
+     * @param skinned Has skin?
+     * @param instanced Whether the program reads the model view matrix from the instance attribute, see Mesh::setInstancingEnabled()
+     * @return Created material, the regular one when the device or the material type has no instanced program
+     * @since v3.14
+     */
+    static Sprite3DMaterial* createBuiltInMaterial(MaterialType type, bool skinned, bool instanced);
+    
     /**
      * Create material with file name, it creates material from cache if it is previously loaded
      * @param path Path of material file
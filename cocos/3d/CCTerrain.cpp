@@ -37,6 +37,8 @@ USING_NS_CC;
 #include "renderer/CCRenderState.h"
 #include "base/CCDirector.h"
 #include "base/CCEventType.h"
+#include "base/CCAsyncTaskPool.h"
+#include "base/ccUTF8.h"
 #include "2d/CCCamera.h"
 #include "platform/CCImage.h"
 
@@ -224,6 +226,16 @@ void Terrain::onDraw(const Mat4 &transform, uint32_t /*flags*/)
 }
 
 bool Terrain::initHeightMap(const std::string& heightMap)
+{
+    if (!initHeightMapData(heightMap))
+    {
+        return false;
+    }
+    finishChunks(-1);
+    return true;
+}
+
+bool Terrain::initHeightMapData(const std::string& heightMap)
 {
     _heightMapImage = new (std::nothrow) Image();
     _heightMapImage->initWithImageFile(heightMap);
@@ -239,6 +251,7 @@ bool Terrain::initHeightMap(const std::string& heightMap)
         loadVertices();
         calculateNormal();
         memset(_chunkesArray, 0, sizeof(_chunkesArray));
+        _finishedChunks = 0;
 
         for(int m =0;m<chunk_amount_y;m++)
         {
@@ -264,6 +277,8 @@ bool Terrain::initHeightMap(const std::string& heightMap)
         }
         _quadRoot = new (std::nothrow) QuadTree(0,0,_imageWidth,_imageHeight,this);
         setLODDistance(_chunkSize.width,2*_chunkSize.width,3*_chunkSize.width);
+        //every chunk keeps its own copy of the vertices, so the whole terrain vertices no need any more
+        std::vector<TerrainVertexData>().swap(_vertices);
         return true;
     }else
     {
@@ -272,12 +287,34 @@ bool Terrain::initHeightMap(const std::string& heightMap)
     }
 }
 
+int Terrain::finishChunks(int maxChunks)
+{
+    int chunk_amount_y = _imageHeight/_chunkSize.height;
+    int chunk_amount_x = _imageWidth/_chunkSize.width;
+    int chunk_amount = chunk_amount_x*chunk_amount_y;
+
+    while(_finishedChunks<chunk_amount && maxChunks!=0)
+    {
+        _chunkesArray[_finishedChunks/chunk_amount_x][_finishedChunks%chunk_amount_x]->finish();
+        ++_finishedChunks;
+        --maxChunks;
+    }
+    return chunk_amount - _finishedChunks;
+}
+
 Terrain::Terrain()
 : _alphaMap(nullptr)
 , _stateBlock(nullptr)
 , _lightMap(nullptr)
 , _lightDir(-1.f, -1.f, 0.f)
 {
+    _data = nullptr;
+    _quadRoot = nullptr;
+    _heightMapImage = nullptr;
+    _finishedChunks = 0;
+    memset(_chunkesArray, 0, sizeof(_chunkesArray));
+    memset(_detailMapTextures, 0, sizeof(_detailMapTextures));
+
     _stateBlock = RenderState::StateBlock::create();
     CC_SAFE_RETAIN(_stateBlock);
 
@@ -677,7 +714,7 @@ std::vector<float> Terrain::getHeightData() const
     for (int i = 0; i < _imageHeight; ++i) {
         for (int j = 0; j < _imageWidth; j++) {
             int idx = i * _imageWidth + j;
-            data[idx] = (_vertices[idx]._position.y);
+            data[idx] = getImageHeight(j, i);
         }
     }
     return data;
@@ -915,6 +952,7 @@ void Terrain::reload()
             _chunkesArray[m][n]->finish();
         }
     }
+    _finishedChunks = chunk_amount_x*chunk_amount_y;
 
     initTextures();
     _chunkLodIndicesSet.clear();
@@ -1068,11 +1106,11 @@ void Terrain::Chunk::generate(int imgWidth, int imageHei, int m, int n, const un
     }
 
     calculateAABB();
-    finish();
 }
 
 Terrain::Chunk::Chunk()
 {
+    _vbo = 0;
     _currentLod = 0;
     _left = nullptr;
     _right = nullptr;
@@ -1719,4 +1757,405 @@ bool Terrain::Triangle::getInsterctPoint(const Ray& ray, Vec3& intersectPoint) c
     return getIntersectPoint(ray, intersectPoint);
 }
 
+static Texture2D* createTerrainTexture(const std::string& fileName, const Texture2D::TexParams& texParams, bool mipmap)
+{
+    auto image = new (std::nothrow)Image();
+    image->initWithImageFile(fileName);
+    auto texture = new (std::nothrow)Texture2D();
+    texture->initWithImage(image);
+    delete image;
+    if (mipmap)
+    {
+        texture->generateMipmap();
+    }
+    texture->setTexParameters(texParams);
+    return texture;
+}
+
+StreamingTerrain* StreamingTerrain::create(const Terrain::TerrainData& tileData, int tilesX, int tilesZ, int tileSize, Terrain::CrackFixedType fixedType)
+{
+    auto terrain = new (std::nothrow) StreamingTerrain();
+    if (terrain && terrain->init(tileData, tilesX, tilesZ, tileSize, fixedType))
+    {
+        terrain->autorelease();
+        return terrain;
+    }
+    CC_SAFE_DELETE(terrain);
+    return nullptr;
+}
+
+StreamingTerrain::StreamingTerrain()
+: _crackFixedType(Terrain::CrackFixedType::SKIRT)
+, _tilesX(0)
+, _tilesZ(0)
+, _tileSize(0)
+, _tileWorldSize(0)
+, _loadDistance(0)
+, _unloadDistance(0)
+, _chunkUploadsPerFrame(8)
+, _hasLODDistance(false)
+, _isTiledAlphaMap(false)
+, _alphaMap(nullptr)
+, _pagingFrame(UINT_MAX)
+{
+    memset(_lodDistance, 0, sizeof(_lodDistance));
+    memset(_detailMapTextures, 0, sizeof(_detailMapTextures));
+}
+
+StreamingTerrain::~StreamingTerrain()
+{
+    //the tiles being loaded keep this node alive, so every tile left is on the cocos thread
+    for (auto& iter : _tiles)
+    {
+        CC_SAFE_RELEASE(iter.second->terrain);
+        delete iter.second;
+    }
+    for (int i = 0; i < 4; ++i)
+    {
+        CC_SAFE_RELEASE(_detailMapTextures[i]);
+    }
+    CC_SAFE_RELEASE(_alphaMap);
+}
+
+bool StreamingTerrain::init(const Terrain::TerrainData& tileData, int tilesX, int tilesZ, int tileSize, Terrain::CrackFixedType fixedType)
+{
+    if (tilesX <= 0 || tilesZ <= 0 || !isPOT(tileSize - 1))
+    {
+        CCLOG("warning: the terrain tile size must be POT + 1");
+        return false;
+    }
+    _terrainData = tileData;
+    _crackFixedType = fixedType;
+    _tilesX = tilesX;
+    _tilesZ = tilesZ;
+    _tileSize = tileSize;
+    _tileWorldSize = (tileSize - 1) * tileData._mapScale;
+    _loadDistance = _tileWorldSize * 1.5f;
+    _unloadDistance = _tileWorldSize * 2.5f;
+    _isTiledAlphaMap = tileData._alphaMapSrc.find('%') != std::string::npos;
+
+    //the detail maps are the same for every tile, load them once
+    Texture2D::TexParams texParam;
+    texParam.wrapS = GL_REPEAT;
+    texParam.wrapT = GL_REPEAT;
+    texParam.minFilter = GL_LINEAR_MIPMAP_LINEAR;
+    texParam.magFilter = GL_LINEAR;
+    if (tileData._alphaMapSrc.empty())
+    {
+        _detailMapTextures[0] = createTerrainTexture(tileData._detailMaps[0]._detailMapSrc, texParam, true);
+    }
+    else
+    {
+        for (int i = 0; i < tileData._detailMapAmount; ++i)
+        {
+            _detailMapTextures[i] = createTerrainTexture(tileData._detailMaps[i]._detailMapSrc, texParam, true);
+        }
+        if (!_isTiledAlphaMap)
+        {
+            texParam.wrapS = GL_CLAMP_TO_EDGE;
+            texParam.wrapT = GL_CLAMP_TO_EDGE;
+            texParam.minFilter = GL_LINEAR;
+            _alphaMap = createTerrainTexture(tileData._alphaMapSrc, texParam, false);
+        }
+    }
+    return true;
+}
+
+void StreamingTerrain::setLoadDistance(float distance)
+{
+    _loadDistance = distance;
+}
+
+void StreamingTerrain::setUnloadDistance(float distance)
+{
+    _unloadDistance = distance;
+}
+
+void StreamingTerrain::setLODDistance(float lod1, float lod2, float lod3)
+{
+    _lodDistance[0] = lod1;
+    _lodDistance[1] = lod2;
+    _lodDistance[2] = lod3;
+    _hasLODDistance = true;
+    for (auto& iter : _tiles)
+    {
+        auto tile = iter.second;
+        //a loading tile still belongs to the worker, it picks the distances up once it's back
+        if (tile->state == Tile::State::UPLOADING || tile->state == Tile::State::LOADED)
+        {
+            tile->terrain->setLODDistance(lod1, lod2, lod3);
+        }
+    }
+}
+
+void StreamingTerrain::visit(Renderer* renderer, const Mat4& parentTransform, uint32_t parentFlags)
+{
+    auto director = Director::getInstance();
+    auto camera = Camera::getVisitingCamera();
+    //page the tiles once per frame, around the first camera which sees the terrain
+    if (_visible && camera && _pagingFrame != director->getTotalFrames() && isVisitableByVisitingCamera())
+    {
+        _pagingFrame = director->getTotalFrames();
+        auto cameraTransform = camera->getNodeToWorldTransform();
+        Vec3 center(cameraTransform.m[12], cameraTransform.m[13], cameraTransform.m[14]);
+        getWorldToNodeTransform().transformPoint(&center);
+        updateTiles(center);
+        uploadTiles();
+    }
+    Node::visit(renderer, parentTransform, parentFlags);
+}
+
+float StreamingTerrain::getTileDistance(int x, int z, const Vec3& center) const
+{
+    float dx = std::max(0.0f, std::max(x * _tileWorldSize - center.x, center.x - (x + 1) * _tileWorldSize));
+    float dz = std::max(0.0f, std::max(z * _tileWorldSize - center.z, center.z - (z + 1) * _tileWorldSize));
+    return sqrtf(dx * dx + dz * dz);
+}
+
+void StreamingTerrain::updateTiles(const Vec3& center)
+{
+    float unloadDistance = std::max(_unloadDistance, _loadDistance);
+    //release the far tiles first, so their memory is back before the near ones load
+    for (auto iter = _tiles.begin(); iter != _tiles.end();)
+    {
+        auto tile = iter->second;
+        if (getTileDistance(tile->x, tile->z, center) <= unloadDistance)
+        {
+            ++iter;
+            continue;
+        }
+        if (tile->state == Tile::State::LOADING)
+        {
+            //the worker still uses it, afterTileLoaded() releases it
+            tile->discarded = true;
+        }
+        else
+        {
+            if (tile->state == Tile::State::LOADED)
+            {
+                removeChild(tile->terrain);
+            }
+            CC_SAFE_RELEASE(tile->terrain);
+            delete tile;
+        }
+        iter = _tiles.erase(iter);
+    }
+
+    int minX = std::max(0, (int)floorf((center.x - _loadDistance) / _tileWorldSize));
+    int maxX = std::min(_tilesX - 1, (int)floorf((center.x + _loadDistance) / _tileWorldSize));
+    int minZ = std::max(0, (int)floorf((center.z - _loadDistance) / _tileWorldSize));
+    int maxZ = std::min(_tilesZ - 1, (int)floorf((center.z + _loadDistance) / _tileWorldSize));
+    for (int z = minZ; z <= maxZ; ++z)
+    {
+        for (int x = minX; x <= maxX; ++x)
+        {
+            if (_tiles.find(getTileKey(x, z)) == _tiles.end() && getTileDistance(x, z, center) <= _loadDistance)
+            {
+                loadTile(x, z);
+            }
+        }
+    }
+}
+
+void StreamingTerrain::loadTile(int x, int z)
+{
+    auto terrain = new (std::nothrow) Terrain();
+    terrain->_terrainData = _terrainData;
+    terrain->_terrainData._heightMapSrc = StringUtils::format(_terrainData._heightMapSrc.c_str(), x, z);
+    if (_isTiledAlphaMap)
+    {
+        terrain->_terrainData._alphaMapSrc = StringUtils::format(_terrainData._alphaMapSrc.c_str(), x, z);
+    }
+    terrain->setSkirtHeightRatio(_terrainData._skirtHeightRatio);
+    terrain->_crackFixedType = _crackFixedType;
+    terrain->_isCameraViewChanged = true;
+    terrain->_chunkSize = _terrainData._chunkSize;
+    //the terrain is centered on its position
+    terrain->setPosition3D(Vec3((x + 0.5f) * _tileWorldSize, 0, (z + 0.5f) * _tileWorldSize));
+
+    auto tile = new (std::nothrow) Tile();
+    tile->x = x;
+    tile->z = z;
+    tile->state = Tile::State::LOADING;
+    tile->terrain = terrain;
+    tile->alphaImage = nullptr;
+    tile->result = false;
+    tile->discarded = false;
+    _tiles[getTileKey(x, z)] = tile;
+
+    //keep this node alive until the tile is back on the cocos thread
+    retain();
+    bool tiledAlphaMap = _isTiledAlphaMap;
+    AsyncTaskPool::getInstance()->enqueue(AsyncTaskPool::TaskType::TASK_IO, CC_CALLBACK_1(StreamingTerrain::afterTileLoaded, this), tile, [tile, tiledAlphaMap]()
+    {
+        tile->result = tile->terrain->initHeightMapData(tile->terrain->_terrainData._heightMapSrc);
+        if (tile->result && tiledAlphaMap)
+        {
+            tile->alphaImage = new (std::nothrow) Image();
+            if (!tile->alphaImage->initWithImageFile(tile->terrain->_terrainData._alphaMapSrc))
+            {
+                CC_SAFE_RELEASE_NULL(tile->alphaImage);
+            }
+        }
+    });
+}
+
+void StreamingTerrain::afterTileLoaded(void* param)
+{
+    auto tile = static_cast<Tile*>(param);
+    auto terrain = tile->terrain;
+    if (tile->result && (terrain->_imageWidth != _tileSize || terrain->_imageHeight != _tileSize))
+    {
+        CCLOG("warning: the terrain tile %s is not %d x %d", terrain->_terrainData._heightMapSrc.c_str(), _tileSize, _tileSize);
+        tile->result = false;
+    }
+
+    if (tile->discarded || !tile->result)
+    {
+        CC_SAFE_RELEASE_NULL(tile->alphaImage);
+        CC_SAFE_RELEASE_NULL(tile->terrain);
+        if (tile->discarded)
+        {
+            delete tile;
+        }
+        else
+        {
+            //keep the failed tile, so it isn't loaded again and again
+            tile->state = Tile::State::FAILED;
+        }
+        release();
+        return;
+    }
+
+    for (int i = 0; i < 4; ++i)
+    {
+        CC_SAFE_RETAIN(_detailMapTextures[i]);
+        terrain->_detailMapTextures[i] = _detailMapTextures[i];
+    }
+    if (tile->alphaImage)
+    {
+        Texture2D::TexParams texParam;
+        texParam.wrapS = GL_CLAMP_TO_EDGE;
+        texParam.wrapT = GL_CLAMP_TO_EDGE;
+        texParam.minFilter = GL_LINEAR;
+        texParam.magFilter = GL_LINEAR;
+        terrain->_alphaMap = new (std::nothrow) Texture2D();
+        terrain->_alphaMap->initWithImage(tile->alphaImage);
+        terrain->_alphaMap->setTexParameters(texParam);
+        CC_SAFE_RELEASE_NULL(tile->alphaImage);
+    }
+    else
+    {
+        CC_SAFE_RETAIN(_alphaMap);
+        terrain->_alphaMap = _alphaMap;
+    }
+    terrain->setMaxDetailMapAmount(_terrainData._detailMapAmount);
+    terrain->initProperties();
+    if (_hasLODDistance)
+    {
+        terrain->setLODDistance(_lodDistance[0], _lodDistance[1], _lodDistance[2]);
+    }
+    tile->state = Tile::State::UPLOADING;
+    release();
+}
+
+void StreamingTerrain::uploadTiles()
+{
+    int budget = _chunkUploadsPerFrame;
+    for (auto& iter : _tiles)
+    {
+        if (budget <= 0)
+        {
+            break;
+        }
+        auto tile = iter.second;
+        if (tile->state != Tile::State::UPLOADING)
+        {
+            continue;
+        }
+        int waiting = tile->terrain->finishChunks(0);
+        int remaining = tile->terrain->finishChunks(budget);
+        budget -= waiting - remaining;
+        if (remaining == 0)
+        {
+            tile->state = Tile::State::LOADED;
+            tile->terrain->setCameraMask(getCameraMask());
+            addChild(tile->terrain);
+        }
+    }
+}
+
+float StreamingTerrain::getHeight(float x, float z, Vec3* normal) const
+{
+    Vec3 pos(x, 0, z);
+    getWorldToNodeTransform().transformPoint(&pos);
+    auto terrain = getTile((int)floorf(pos.x / _tileWorldSize), (int)floorf(pos.z / _tileWorldSize));
+    if (!terrain)
+    {
+        if (normal)
+        {
+            normal->setZero();
+        }
+        return 0;
+    }
+    return terrain->getHeight(x, z, normal);
+}
+
+float StreamingTerrain::getHeight(const Vec2& pos, Vec3* normal) const
+{
+    return getHeight(pos.x, pos.y, normal);
+}
+
+bool StreamingTerrain::getIntersectionPoint(const Ray& ray, Vec3& intersectionPoint) const
+{
+    float minDistance = FLT_MAX;
+    for (auto& iter : _tiles)
+    {
+        auto tile = iter.second;
+        Vec3 point;
+        if (tile->state == Tile::State::LOADED && tile->terrain->getIntersectionPoint(ray, point))
+        {
+            float distance = point.distanceSquared(ray._origin);
+            if (distance < minDistance)
+            {
+                minDistance = distance;
+                intersectionPoint = point;
+            }
+        }
+    }
+    return minDistance < FLT_MAX;
+}
+
+Terrain* StreamingTerrain::getTile(int x, int z) const
+{
+    if (x < 0 || z < 0 || x >= _tilesX || z >= _tilesZ)
+        return nullptr;
+    auto iter = _tiles.find(getTileKey(x, z));
+    if (iter == _tiles.end() || iter->second->state != Tile::State::LOADED)
+        return nullptr;
+    return iter->second->terrain;
+}
+
+int StreamingTerrain::getLoadedTileCount() const
+{
+    int count = 0;
+    for (auto& iter : _tiles)
+    {
+        if (iter.second->state == Tile::State::LOADED)
+            ++count;
+    }
+    return count;
+}
+
+int StreamingTerrain::getPendingTileCount() const
+{
+    int count = 0;
+    for (auto& iter : _tiles)
+    {
+        if (iter.second->state == Tile::State::LOADING || iter.second->state == Tile::State::UPLOADING)
+            ++count;
+    }
+    return count;
+}
+
 NS_CC_END
@@ -25,6 +25,7 @@ THE SOFTWARE.
 #define CC_TERRAIN_H
 
 #include <vector>
+#include <map>
 
 #include "2d/CCNode.h"
 #include "2d/CCCamera.h"
@@ -310,6 +311,7 @@ private:
     };
     friend QuadTree;
     friend Chunk;
+    friend class StreamingTerrain;
 public:
     /** set light map texture */
     void setLightMap(const std::string& fileName);
@@ -461,6 +463,19 @@ protected:
      **/
     void calculateNormal();
 
+    /**
+     * load the heightmap and generate the chunks and the quad tree without touching OpenGL,
+     * so that it can run on a worker thread. The chunks are uploaded later by finishChunks().
+     **/
+    bool initHeightMapData(const std::string& heightMap);
+
+    /**
+     * upload the vertex buffers of the chunks that are not uploaded yet.
+     * @param maxChunks the maximum amount of chunks to upload, a negative value uploads all of them.
+     * @return the amount of chunks still waiting to be uploaded.
+     **/
+    int finishChunks(int maxChunks);
+
     //override
     virtual void onEnter() override;
 
@@ -498,6 +513,7 @@ protected:
     Chunk * _chunkesArray[MAX_CHUNKES][MAX_CHUNKES];
     std::vector<TerrainVertexData> _vertices;
     std::vector<unsigned int> _indices;
+    int _finishedChunks;
     int _imageWidth;
     int _imageHeight;
     Size _chunkSize;
@@ -528,6 +544,142 @@ protected:
 #endif
 };
 
+/**
+ * StreamingTerrain
+ * @brief pages Terrain tiles in and out around the camera, for worlds far bigger than one Terrain fits in memory.
+ * The world is split into tilesX * tilesZ heightmap files, the TerrainData's heightmap source is a printf style pattern
+ * receiving the tile's X and Z index, e.g. "terrain/height_%d_%d.png". Every tile must be POT+1 pixels large and share
+ * its border row and column with its neighbors, so that the tiles join without gaps.
+ * The alpha map source may carry the same pattern to give each tile its own alpha map, the detail maps are shared by all tiles.
+ *
+ * The heightmaps are decoded and the chunks generated on the AsyncTaskPool workers, the chunks' vertex buffers are
+ * uploaded on the GL thread a few chunks per frame, and a tile shows up once all its chunks are uploaded.
+ * Tile(0,0) starts at the origin and the tiles grow along +X and +Z.
+ * @since v3.14
+ */
+class CC_DLL StreamingTerrain : public Node
+{
+public:
+    /**
+     * create a streaming terrain.
+     * @param tileData the parameters shared by all tiles, its heightmap source is the tile file pattern.
+     * @param tilesX the amount of tiles along the X axis.
+     * @param tilesZ the amount of tiles along the Z axis.
+     * @param tileSize the width and height of each tile heightmap in pixels, like 129 or 257.
+     * @param fixedType the crack fix type, SKIRT also hides the cracks between tiles of different LOD.
+     */
+    static StreamingTerrain* create(const Terrain::TerrainData& tileData, int tilesX, int tilesZ, int tileSize, Terrain::CrackFixedType fixedType = Terrain::CrackFixedType::SKIRT);
+
+    /**
+     * set the distance from the camera within which the tiles are loaded, by default one and a half tile.
+     */
+    void setLoadDistance(float distance);
+    float getLoadDistance() const { return _loadDistance; }
+
+    /**
+     * set the distance from the camera beyond which the tiles are released, must be greater than the load distance
+     * to not reload a tile back and forth at the border. By default two and a half tiles.
+     */
+    void setUnloadDistance(float distance);
+    float getUnloadDistance() const { return _unloadDistance; }
+
+    /**
+     * set how many chunks' vertex buffers are uploaded each frame, shared by all the loading tiles.
+     */
+    void setChunkUploadsPerFrame(int amount) { _chunkUploadsPerFrame = amount; }
+    int getChunkUploadsPerFrame() const { return _chunkUploadsPerFrame; }
+
+    /**
+     * set threshold distance of each LOD level for every tile, see Terrain::setLODDistance.
+     */
+    void setLODDistance(float lod1, float lod2, float lod3);
+
+    /**
+     * get specified position's height mapping to the terrain tile under it.
+     * @return the height value, 0 if the position is out of the terrain or its tile isn't loaded.
+     */
+    float getHeight(float x, float z, Vec3* normal = nullptr) const;
+    float getHeight(const Vec2& pos, Vec3* normal = nullptr) const;
+
+    /**
+     * Ray-Terrain intersection against the loaded tiles.
+     * @return true if hit, false otherwise
+     */
+    bool getIntersectionPoint(const Ray& ray, Vec3& intersectionPoint) const;
+
+    /**
+     * get the loaded tile at the specified index, nullptr if it isn't loaded (yet).
+     */
+    Terrain* getTile(int x, int z) const;
+
+    /** get the width of a tile in the terrain space */
+    float getTileWorldSize() const { return _tileWorldSize; }
+
+    /** get the amount of tiles in the scene */
+    int getLoadedTileCount() const;
+
+    /** get the amount of tiles being loaded or uploaded */
+    int getPendingTileCount() const;
+
+    // Overrides
+    virtual void visit(Renderer* renderer, const Mat4& parentTransform, uint32_t parentFlags) override;
+    // the tiles are added and removed while visiting
+    virtual bool isTransformFlattenable() const override { return false; }
+
+CC_CONSTRUCTOR_ACCESS:
+    StreamingTerrain();
+    virtual ~StreamingTerrain();
+    bool init(const Terrain::TerrainData& tileData, int tilesX, int tilesZ, int tileSize, Terrain::CrackFixedType fixedType);
+
+protected:
+    struct Tile
+    {
+        enum class State
+        {
+            LOADING,
+            UPLOADING,
+            LOADED,
+            FAILED,
+        };
+        int x;
+        int z;
+        State state;
+        Terrain* terrain;
+        /** the tile's own alpha map, decoded on the worker */
+        Image* alphaImage;
+        bool result;
+        /** set when the tile went out of range while loading */
+        bool discarded;
+    };
+
+    /** load the tiles near the camera and release the far ones, center is in the node space */
+    void updateTiles(const Vec3& center);
+    void loadTile(int x, int z);
+    void afterTileLoaded(void* param);
+    /** upload the chunks of the loading tiles within the per frame budget */
+    void uploadTiles();
+    /** the distance from center to the nearest point of the tile in the XZ plane */
+    float getTileDistance(int x, int z, const Vec3& center) const;
+    int getTileKey(int x, int z) const { return z * _tilesX + x; }
+
+    Terrain::TerrainData _terrainData;
+    Terrain::CrackFixedType _crackFixedType;
+    int _tilesX;
+    int _tilesZ;
+    int _tileSize;
+    float _tileWorldSize;
+    float _loadDistance;
+    float _unloadDistance;
+    int _chunkUploadsPerFrame;
+    float _lodDistance[3];
+    bool _hasLODDistance;
+    bool _isTiledAlphaMap;
+    Texture2D* _detailMapTextures[4];
+    Texture2D* _alphaMap;
+    std::map<int, Tile*> _tiles;
+    unsigned int _pagingFrame;
+};
+
 // end of actions group
 /// @}
 
@@ -37,6 +37,7 @@ cocos2d.cpp \
 2d/CCClippingNode.cpp \
 2d/CCClippingRectangleNode.cpp \
 2d/CCComponent.cpp \
+2d/CCComponentSystem.cpp \
 2d/CCComponentContainer.cpp \
 2d/CCDrawNode.cpp \
 2d/CCDrawingPrimitives.cpp \
@@ -58,6 +59,7 @@ cocos2d.cpp \
 2d/CCLabelTextFormatter.cpp \
 2d/CCLayer.cpp \
 2d/CCLight.cpp \
+2d/CCLODNode.cpp \
 2d/CCMenu.cpp \
 2d/CCMenuItem.cpp \
 2d/CCMotionStreak.cpp \
@@ -76,9 +78,12 @@ cocos2d.cpp \
 2d/CCSpriteBatchNode.cpp \
 2d/CCSpriteFrame.cpp \
 2d/CCSpriteFrameCache.cpp \
+2d/CCStaticBatchNode.cpp \
 2d/CCTMXLayer.cpp \
 2d/CCTMXObjectGroup.cpp \
+2d/CCTMXTileStore.cpp \
 2d/CCTMXTiledMap.cpp \
+2d/CCTMXTiledMapGPU.cpp \
 2d/CCTMXXMLParser.cpp \
 2d/CCTextFieldTTF.cpp \
 2d/CCTileMapAtlas.cpp \
@@ -106,6 +111,9 @@ math/Vec3.cpp \
 math/Vec4.cpp \
 base/CCNinePatchImageParser.cpp \
 base/CCStencilStateManager.cpp \
+base/CCTimeSlicedQueue.cpp \
+base/CCScriptBytecodeCache.cpp \
+base/CCAsyncOperation.cpp \
 base/CCAsyncTaskPool.cpp \
 base/CCAutoreleasePool.cpp \
 base/CCConfiguration.cpp \
@@ -113,6 +121,7 @@ base/CCConsole.cpp \
 base/CCController-android.cpp \
 base/CCController.cpp \
 base/CCData.cpp \
+base/CCDataView.cpp \
 base/CCDataVisitor.cpp \
 base/CCDirector.cpp \
 base/CCEvent.cpp \
@@ -162,6 +171,8 @@ base/pvr.cpp \
 base/s3tc.cpp \
 renderer/CCBatchCommand.cpp \
 renderer/CCCustomCommand.cpp \
+renderer/CCDynamicResolution.cpp \
+renderer/CCDynamicTexture.cpp \
 renderer/CCGLProgram.cpp \
 renderer/CCGLProgramCache.cpp \
 renderer/CCGLProgramState.cpp \
@@ -25,8 +25,12 @@
 #include "platform/CCPlatformConfig.h"
 
 #include "audio/include/AudioEngine.h"
+#include <algorithm>
 #include <condition_variable>
+#include <iterator>
+#include <mutex>
 #include <queue>
+#include <unordered_set>
 #include "platform/CCFileUtils.h"
 #include "base/ccUtils.h"
 
@@ -66,6 +70,10 @@ std::unordered_map<int, AudioEngine::AudioInfo> AudioEngine::_audioIDInfoMap;
 AudioEngineImpl* AudioEngine::_audioEngineImpl = nullptr;
 
 AudioEngine::AudioEngineThreadPool* AudioEngine::s_threadPool = nullptr;
+AudioEngine::AudioCacheLedger* AudioEngine::s_cacheLedger = nullptr;
+std::list<std::shared_ptr<AudioEngine::PreloadBatch>> AudioEngine::_preloadBatches;
+unsigned int AudioEngine::_preloadsInFlight = 0;
+unsigned int AudioEngine::_decoderThreadCount = 4;
 bool AudioEngine::_isEnabled = true;
 
 AudioEngine::AudioInfo::AudioInfo()
@@ -89,7 +97,12 @@ public:
     AudioEngineThreadPool(int threads = 4)
         : _stop(false)
     {
-        for (int index = 0; index < threads; ++index)
+        grow(threads);
+    }
+
+    void grow(int threads)
+    {
+        while ((int)_workers.size() < threads)
         {
             _workers.emplace_back(std::thread(std::bind(&AudioEngineThreadPool::threadFunc, this)));
         }
@@ -149,6 +162,201 @@ private:
     bool _stop;
 };
 
+// Accounts the decoded data the platform implementations cache, in least recently played order.
+// The implementations report from their decoding threads, the evictions happen on the cocos thread.
+class AudioEngine::AudioCacheLedger
+{
+public:
+    AudioCacheLedger()
+        : _streamingThreshold(0)
+    {
+    }
+
+    void setBudget(size_t bytes)
+    {
+        std::lock_guard<std::mutex> lk(_mutex);
+        _stats.budget = bytes;
+    }
+
+    void setStreamingThreshold(size_t fileSize)
+    {
+        std::lock_guard<std::mutex> lk(_mutex);
+        _streamingThreshold = fileSize;
+    }
+
+    size_t getStreamingThreshold()
+    {
+        std::lock_guard<std::mutex> lk(_mutex);
+        return _streamingThreshold;
+    }
+
+    bool shouldStream(const std::string& fullPath, long fileSize, bool defaultStreaming)
+    {
+        std::lock_guard<std::mutex> lk(_mutex);
+        if (_lowLatencyPaths.find(fullPath) != _lowLatencyPaths.end())
+            return false;
+        if (_streamingThreshold > 0)
+            return fileSize > (long)_streamingThreshold;
+        return defaultStreaming;
+    }
+
+    void setLowLatency(const std::string& fullPath, bool lowLatency)
+    {
+        std::lock_guard<std::mutex> lk(_mutex);
+        if (lowLatency)
+            _lowLatencyPaths.insert(fullPath);
+        else
+            _lowLatencyPaths.erase(fullPath);
+    }
+
+    bool isLowLatency(const std::string& fullPath)
+    {
+        std::lock_guard<std::mutex> lk(_mutex);
+        return _lowLatencyPaths.find(fullPath) != _lowLatencyPaths.end();
+    }
+
+    AudioCacheStats getStats()
+    {
+        std::lock_guard<std::mutex> lk(_mutex);
+        AudioCacheStats stats = _stats;
+        stats.cachedFileCount = (unsigned int)_entries.size();
+        return stats;
+    }
+
+    void add(const std::string& fullPath, size_t bytes)
+    {
+        std::lock_guard<std::mutex> lk(_mutex);
+        auto iter = _entries.find(fullPath);
+        if (iter != _entries.end())
+        {
+            _stats.cachedBytes -= iter->second.bytes;
+            iter->second.bytes = bytes;
+            _lru.splice(_lru.end(), _lru, iter->second.lruIter);
+        }
+        else
+        {
+            _lru.push_back(fullPath);
+            Entry entry;
+            entry.bytes = bytes;
+            entry.lruIter = std::prev(_lru.end());
+            _entries.emplace(fullPath, entry);
+        }
+        _stats.cachedBytes += bytes;
+    }
+
+    void remove(const std::string& fullPath)
+    {
+        std::lock_guard<std::mutex> lk(_mutex);
+        erase(fullPath);
+        _playingCounts.erase(fullPath);
+        _lowLatencyPaths.erase(fullPath);
+    }
+
+    void clear()
+    {
+        std::lock_guard<std::mutex> lk(_mutex);
+        _entries.clear();
+        _lru.clear();
+        _filePaths.clear();
+        _playingCounts.clear();
+        _lowLatencyPaths.clear();
+        _stats.cachedBytes = 0;
+    }
+
+    // marks the file as the most recently used, filePath is the path the platform implementation uncaches
+    void touch(const std::string& fullPath, const std::string& filePath, bool isPlay)
+    {
+        std::lock_guard<std::mutex> lk(_mutex);
+        _filePaths[fullPath] = filePath;
+        auto iter = _entries.find(fullPath);
+        if (iter != _entries.end())
+        {
+            _lru.splice(_lru.end(), _lru, iter->second.lruIter);
+        }
+        if (isPlay)
+        {
+            if (iter != _entries.end())
+                ++_stats.hits;
+            else
+                ++_stats.misses;
+        }
+    }
+
+    void retainPlaying(const std::string& fullPath)
+    {
+        std::lock_guard<std::mutex> lk(_mutex);
+        ++_playingCounts[fullPath];
+    }
+
+    void releasePlaying(const std::string& fullPath)
+    {
+        std::lock_guard<std::mutex> lk(_mutex);
+        auto iter = _playingCounts.find(fullPath);
+        if (iter != _playingCounts.end() && --iter->second <= 0)
+            _playingCounts.erase(iter);
+    }
+
+    void clearPlaying()
+    {
+        std::lock_guard<std::mutex> lk(_mutex);
+        _playingCounts.clear();
+    }
+
+    // removes the least recently used files which aren't playing until the cache fits the budget,
+    // and returns the paths to uncache
+    std::vector<std::string> evict()
+    {
+        std::lock_guard<std::mutex> lk(_mutex);
+        std::vector<std::string> evicted;
+        if (_stats.budget == 0)
+            return evicted;
+
+        // the most recently used file, just loaded or played, is kept even if it doesn't fit alone
+        auto iter = _lru.begin();
+        auto last = _lru.empty() ? _lru.end() : std::prev(_lru.end());
+        while (_stats.cachedBytes > _stats.budget && iter != last)
+        {
+            auto fullPath = *iter++;
+            if (_playingCounts.find(fullPath) != _playingCounts.end() || _lowLatencyPaths.find(fullPath) != _lowLatencyPaths.end())
+                continue;
+
+            auto filePath = _filePaths.find(fullPath);
+            evicted.push_back(filePath != _filePaths.end() ? filePath->second : fullPath);
+            erase(fullPath);
+            ++_stats.evictions;
+        }
+        return evicted;
+    }
+
+private:
+    void erase(const std::string& fullPath)
+    {
+        auto iter = _entries.find(fullPath);
+        if (iter != _entries.end())
+        {
+            _stats.cachedBytes -= iter->second.bytes;
+            _lru.erase(iter->second.lruIter);
+            _entries.erase(iter);
+        }
+        _filePaths.erase(fullPath);
+    }
+
+    struct Entry
+    {
+        size_t bytes;
+        std::list<std::string>::iterator lruIter;
+    };
+
+    std::mutex _mutex;
+    std::unordered_map<std::string, Entry> _entries;
+    std::list<std::string> _lru;
+    std::unordered_map<std::string, std::string> _filePaths;
+    std::unordered_map<std::string, int> _playingCounts;
+    std::unordered_set<std::string> _lowLatencyPaths;
+    AudioCacheStats _stats;
+    size_t _streamingThreshold;
+};
+
 void AudioEngine::end()
 {
     if (s_threadPool)
@@ -160,12 +368,24 @@ void AudioEngine::end()
     delete _audioEngineImpl;
     _audioEngineImpl = nullptr;
 
+    // the preloads in flight won't call back anymore
+    _preloadBatches.clear();
+    _preloadsInFlight = 0;
+
+    delete s_cacheLedger;
+    s_cacheLedger = nullptr;
+
     delete _defaultProfileHelper;
     _defaultProfileHelper = nullptr;
 }
 
 bool AudioEngine::lazyInit()
 {
+    if (s_cacheLedger == nullptr)
+    {
+        s_cacheLedger = new (std::nothrow) AudioCacheLedger();
+    }
+
     if (_audioEngineImpl == nullptr)
     {
         _audioEngineImpl = new (std::nothrow) AudioEngineImpl();
@@ -179,7 +399,7 @@ bool AudioEngine::lazyInit()
 #if (CC_TARGET_PLATFORM != CC_PLATFORM_ANDROID)
     if (_audioEngineImpl && s_threadPool == nullptr)
     {
-        s_threadPool = new (std::nothrow) AudioEngineThreadPool();
+        s_threadPool = new (std::nothrow) AudioEngineThreadPool(_decoderThreadCount);
     }
 #endif
 
@@ -237,9 +457,21 @@ int AudioEngine::play2d(const std::string& filePath, bool loop, float volume, co
             volume = 1.0f;
         }
         
+        auto fullPath = FileUtils::getInstance()->fullPathForFilename(filePath);
+        if (s_cacheLedger)
+        {
+            s_cacheLedger->touch(fullPath, filePath, true);
+        }
+
         ret = _audioEngineImpl->play2d(filePath, loop, volume);
         if (ret != INVALID_AUDIO_ID)
         {
+            if (s_cacheLedger)
+            {
+                s_cacheLedger->retainPlaying(fullPath);
+            }
+            enforceCacheBudget();
+
             _audioPathIDMap[filePath].push_back(ret);
             auto it = _audioPathIDMap.find(filePath);
             
@@ -348,6 +580,10 @@ void AudioEngine::remove(int audioID)
             it->second.profileHelper->audioIDs.remove(audioID);
         }
         _audioPathIDMap[*it->second.filePath].remove(audioID);
+        if (s_cacheLedger)
+        {
+            s_cacheLedger->releasePlaying(FileUtils::getInstance()->fullPathForFilename(*it->second.filePath));
+        }
         _audioIDInfoMap.erase(audioID);
     }
 }
@@ -367,6 +603,10 @@ void AudioEngine::stopAll()
     }
     _audioPathIDMap.clear();
     _audioIDInfoMap.clear();
+    if (s_cacheLedger)
+    {
+        s_cacheLedger->clearPlaying();
+    }
 }
 
 void AudioEngine::uncache(const std::string &filePath)
@@ -400,6 +640,11 @@ void AudioEngine::uncache(const std::string &filePath)
     {
         _audioEngineImpl->uncache(filePath);
     }
+
+    if (s_cacheLedger)
+    {
+        s_cacheLedger->remove(FileUtils::getInstance()->fullPathForFilename(filePath));
+    }
 }
 
 void AudioEngine::uncacheAll()
@@ -409,6 +654,10 @@ void AudioEngine::uncacheAll()
     }
     stopAll();
     _audioEngineImpl->uncacheAll();
+    if (s_cacheLedger)
+    {
+        s_cacheLedger->clear();
+    }
 }
 
 float AudioEngine::getDuration(int audioID)
@@ -529,11 +778,23 @@ AudioProfile* AudioEngine::getProfile(const std::string &name)
     }
 }
 
+AsyncOperation<bool> AudioEngine::preloadAsync(const std::string& filePath)
+{
+    AsyncOperation<bool> operation;
+    preload(filePath, [operation](bool isSuccess) {
+        operation.resolve(isSuccess);
+    });
+    return operation;
+}
+
 void AudioEngine::preload(const std::string& filePath, std::function<void(bool isSuccess)> callback)
 {
     if (!isEnabled())
     {
-        callback(false);
+        if (callback)
+        {
+            callback(false);
+        }
         return;
     }
     
@@ -549,7 +810,220 @@ void AudioEngine::preload(const std::string& filePath, std::function<void(bool i
             return;
         }
 
-        _audioEngineImpl->preload(filePath, callback);
+        if (s_cacheLedger)
+        {
+            s_cacheLedger->touch(FileUtils::getInstance()->fullPathForFilename(filePath), filePath, false);
+        }
+
+        // the decoded size is known once loaded, the budget is enforced then
+        _audioEngineImpl->preload(filePath, [callback](bool isSuccess){
+            enforceCacheBudget();
+            if (callback)
+            {
+                callback(isSuccess);
+            }
+        });
+    }
+    else if (callback)
+    {
+        callback(false);
+    }
+}
+
+struct AudioEngine::PreloadBatch
+{
+    std::vector<std::string> filePaths;
+    std::function<void(int, int)> progressCallback;
+    std::function<void(bool)> completion;
+    int priority;
+    size_t nextIndex;
+    int loadedCount;
+    bool isSuccess;
+};
+
+void AudioEngine::preloadBatch(const std::vector<std::string>& filePaths,
+                               const std::function<void(int loadedCount, int totalCount)>& progressCallback,
+                               const std::function<void(bool isSuccess)>& completion,
+                               int priority)
+{
+    if (filePaths.empty())
+    {
+        if (completion)
+        {
+            completion(true);
+        }
+        return;
+    }
+
+    auto batch = std::make_shared<PreloadBatch>();
+    batch->filePaths = filePaths;
+    batch->progressCallback = progressCallback;
+    batch->completion = completion;
+    batch->priority = priority;
+    batch->nextIndex = 0;
+    batch->loadedCount = 0;
+    batch->isSuccess = true;
+
+    // the batches are kept by decreasing priority, in request order for the same priority
+    auto iter = _preloadBatches.begin();
+    while (iter != _preloadBatches.end() && (*iter)->priority >= priority)
+    {
+        ++iter;
+    }
+    _preloadBatches.insert(iter, batch);
+
+    pumpPreloadBatches();
+}
+
+void AudioEngine::pumpPreloadBatches()
+{
+    // preload may call back synchronously, the outermost call issues the preloads
+    static bool isPumping = false;
+    if (isPumping)
+    {
+        return;
+    }
+    isPumping = true;
+
+    while (_preloadsInFlight < std::max(_decoderThreadCount, 1u))
+    {
+        auto iter = _preloadBatches.begin();
+        while (iter != _preloadBatches.end() && (*iter)->nextIndex >= (*iter)->filePaths.size())
+        {
+            ++iter;
+        }
+        if (iter == _preloadBatches.end())
+        {
+            break;
+        }
+
+        auto batch = *iter;
+        auto& filePath = batch->filePaths[batch->nextIndex++];
+        ++_preloadsInFlight;
+        preload(filePath, [batch](bool isSuccess){
+            if (_preloadsInFlight > 0)
+            {
+                --_preloadsInFlight;
+            }
+            ++batch->loadedCount;
+            batch->isSuccess = batch->isSuccess && isSuccess;
+            int totalCount = (int)batch->filePaths.size();
+            if (batch->progressCallback)
+            {
+                batch->progressCallback(batch->loadedCount, totalCount);
+            }
+            if (batch->loadedCount == totalCount)
+            {
+                _preloadBatches.remove(batch);
+                if (batch->completion)
+                {
+                    batch->completion(batch->isSuccess);
+                }
+            }
+            pumpPreloadBatches();
+        });
+    }
+
+    isPumping = false;
+}
+
+void AudioEngine::setDecoderThreadCount(unsigned int count)
+{
+    _decoderThreadCount = count;
+    if (s_threadPool)
+    {
+        s_threadPool->grow((int)count);
+    }
+    pumpPreloadBatches();
+}
+
+void AudioEngine::setLowLatency(const std::string& filePath, bool lowLatency)
+{
+    lazyInit();
+    if (s_cacheLedger)
+    {
+        s_cacheLedger->setLowLatency(FileUtils::getInstance()->fullPathForFilename(filePath), lowLatency);
+        if (lowLatency)
+        {
+            preload(filePath);
+        }
+    }
+}
+
+bool AudioEngine::isLowLatency(const std::string& filePath)
+{
+    return s_cacheLedger && s_cacheLedger->isLowLatency(FileUtils::getInstance()->fullPathForFilename(filePath));
+}
+
+bool AudioEngine::shouldStream(const std::string& fullPath, long fileSize, bool defaultStreaming)
+{
+    return s_cacheLedger ? s_cacheLedger->shouldStream(fullPath, fileSize, defaultStreaming) : defaultStreaming;
+}
+
+void AudioEngine::setCacheBudget(size_t bytes)
+{
+    lazyInit();
+    if (s_cacheLedger)
+    {
+        s_cacheLedger->setBudget(bytes);
+        enforceCacheBudget();
+    }
+}
+
+size_t AudioEngine::getCacheBudget()
+{
+    return s_cacheLedger ? s_cacheLedger->getStats().budget : 0;
+}
+
+void AudioEngine::setStreamingThreshold(size_t fileSize)
+{
+    lazyInit();
+    if (s_cacheLedger)
+    {
+        s_cacheLedger->setStreamingThreshold(fileSize);
+    }
+}
+
+size_t AudioEngine::getStreamingThreshold()
+{
+    return s_cacheLedger ? s_cacheLedger->getStreamingThreshold() : 0;
+}
+
+AudioCacheStats AudioEngine::getCacheStats()
+{
+    return s_cacheLedger ? s_cacheLedger->getStats() : AudioCacheStats();
+}
+
+AudioOutputStats AudioEngine::getOutputStats()
+{
+    AudioOutputStats stats;
+#if CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID
+    if (_audioEngineImpl)
+    {
+        _audioEngineImpl->getOutputStats(&stats);
+    }
+#endif
+    return stats;
+}
+
+void AudioEngine::onAudioCached(const std::string& fullPath, size_t bytes)
+{
+    if (s_cacheLedger)
+    {
+        s_cacheLedger->add(fullPath, bytes);
+    }
+}
+
+void AudioEngine::enforceCacheBudget()
+{
+    if (!s_cacheLedger || !_audioEngineImpl)
+    {
+        return;
+    }
+
+    for (auto& filePath : s_cacheLedger->evict())
+    {
+        _audioEngineImpl->uncache(filePath);
     }
 }
 
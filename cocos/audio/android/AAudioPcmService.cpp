@@ -0,0 +1,409 @@
+/****************************************************************************
+Copyright (c) 2017 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+
+#define LOG_TAG "AAudioPcmService"
+
+#include "audio/android/AAudioPcmService.h"
+#include "audio/android/AudioMixerController.h"
+#include "audio/android/OpenSLHelper.h"
+
+#include <algorithm>
+#include <dlfcn.h>
+#include <string.h>
+
+// The subset of <aaudio/AAudio.h> used here, its functions are looked up in libaaudio.so
+// since they don't exist before Android 8.0
+typedef struct AAudioStreamStruct AAudioStream;
+typedef struct AAudioStreamBuilderStruct AAudioStreamBuilder;
+typedef int32_t aaudio_result_t;
+typedef int32_t aaudio_data_callback_result_t;
+typedef aaudio_data_callback_result_t (*AAudioStream_dataCallback)(AAudioStream* stream, void* userData, void* audioData, int32_t numFrames);
+typedef void (*AAudioStream_errorCallback)(AAudioStream* stream, void* userData, aaudio_result_t error);
+
+#define AAUDIO_OK                               0
+#define AAUDIO_ERROR_DISCONNECTED               (-899)
+#define AAUDIO_DIRECTION_OUTPUT                 0
+#define AAUDIO_FORMAT_PCM_I16                   1
+#define AAUDIO_SHARING_MODE_EXCLUSIVE           0
+#define AAUDIO_PERFORMANCE_MODE_LOW_LATENCY     12
+#define AAUDIO_CALLBACK_RESULT_CONTINUE         0
+
+namespace cocos2d { namespace experimental {
+
+namespace {
+
+struct AAudioLibrary
+{
+    aaudio_result_t (*createStreamBuilder)(AAudioStreamBuilder** builder);
+    void (*builderSetDirection)(AAudioStreamBuilder* builder, int32_t direction);
+    void (*builderSetSampleRate)(AAudioStreamBuilder* builder, int32_t sampleRate);
+    void (*builderSetChannelCount)(AAudioStreamBuilder* builder, int32_t channelCount);
+    void (*builderSetFormat)(AAudioStreamBuilder* builder, int32_t format);
+    void (*builderSetSharingMode)(AAudioStreamBuilder* builder, int32_t sharingMode);
+    void (*builderSetPerformanceMode)(AAudioStreamBuilder* builder, int32_t mode);
+    void (*builderSetDataCallback)(AAudioStreamBuilder* builder, AAudioStream_dataCallback callback, void* userData);
+    void (*builderSetErrorCallback)(AAudioStreamBuilder* builder, AAudioStream_errorCallback callback, void* userData);
+    aaudio_result_t (*builderOpenStream)(AAudioStreamBuilder* builder, AAudioStream** stream);
+    aaudio_result_t (*builderDelete)(AAudioStreamBuilder* builder);
+    aaudio_result_t (*streamRequestStart)(AAudioStream* stream);
+    aaudio_result_t (*streamRequestPause)(AAudioStream* stream);
+    aaudio_result_t (*streamRequestStop)(AAudioStream* stream);
+    aaudio_result_t (*streamClose)(AAudioStream* stream);
+    int32_t (*streamGetSampleRate)(AAudioStream* stream);
+    int32_t (*streamGetFramesPerBurst)(AAudioStream* stream);
+    int32_t (*streamGetBufferCapacityInFrames)(AAudioStream* stream);
+    aaudio_result_t (*streamSetBufferSizeInFrames)(AAudioStream* stream, int32_t numFrames);
+    int32_t (*streamGetXRunCount)(AAudioStream* stream);
+    const char* (*convertResultToText)(aaudio_result_t result);
+
+    bool loaded;
+
+    AAudioLibrary()
+    {
+        memset(this, 0, sizeof(*this));
+
+        void* handle = dlopen("libaaudio.so", RTLD_NOW);
+        if (handle == nullptr)
+            return;
+
+        bool ok = true;
+        auto load = [&](void* function, const char* name) {
+            void* symbol = dlsym(handle, name);
+            if (symbol == nullptr)
+            {
+                ALOGW("%s isn't in libaaudio.so", name);
+                ok = false;
+            }
+            memcpy(function, &symbol, sizeof(symbol));
+        };
+
+        load(&createStreamBuilder, "AAudio_createStreamBuilder");
+        load(&builderSetDirection, "AAudioStreamBuilder_setDirection");
+        load(&builderSetSampleRate, "AAudioStreamBuilder_setSampleRate");
+        load(&builderSetChannelCount, "AAudioStreamBuilder_setChannelCount");
+        load(&builderSetFormat, "AAudioStreamBuilder_setFormat");
+        load(&builderSetSharingMode, "AAudioStreamBuilder_setSharingMode");
+        load(&builderSetPerformanceMode, "AAudioStreamBuilder_setPerformanceMode");
+        load(&builderSetDataCallback, "AAudioStreamBuilder_setDataCallback");
+        load(&builderSetErrorCallback, "AAudioStreamBuilder_setErrorCallback");
+        load(&builderOpenStream, "AAudioStreamBuilder_openStream");
+        load(&builderDelete, "AAudioStreamBuilder_delete");
+        load(&streamRequestStart, "AAudioStream_requestStart");
+        load(&streamRequestPause, "AAudioStream_requestPause");
+        load(&streamRequestStop, "AAudioStream_requestStop");
+        load(&streamClose, "AAudioStream_close");
+        load(&streamGetSampleRate, "AAudioStream_getSampleRate");
+        load(&streamGetFramesPerBurst, "AAudioStream_getFramesPerBurst");
+        load(&streamGetBufferCapacityInFrames, "AAudioStream_getBufferCapacityInFrames");
+        load(&streamSetBufferSizeInFrames, "AAudioStream_setBufferSizeInFrames");
+        load(&streamGetXRunCount, "AAudioStream_getXRunCount");
+        load(&convertResultToText, "AAudio_convertResultToText");
+
+        // the library stays loaded until the process exits
+        loaded = ok;
+    }
+};
+
+AAudioLibrary& aaudio()
+{
+    static AAudioLibrary library;
+    return library;
+}
+
+} // namespace {
+
+#define AAUDIO_RETURN_VAL_IF_FAILED(r, rval, msg) \
+    if (r != AAUDIO_OK) {\
+        ALOGE("%s: %s", msg, aaudio().convertResultToText(r)); \
+        return rval; \
+    }
+
+// The bursts written ahead of the device when the stream starts
+#define AAUDIO_INITIAL_BURST_COUNT (2)
+
+class AAudioPcmServiceCallbackProxy
+{
+public:
+    static aaudio_data_callback_result_t dataCallback(AAudioStream* stream, void* userData, void* audioData, int32_t numFrames)
+    {
+        AAudioPcmService* thiz = reinterpret_cast<AAudioPcmService*>(userData);
+        return thiz->onAudioReady(stream, audioData, numFrames);
+    }
+
+    static void errorCallback(AAudioStream* stream, void* userData, aaudio_result_t error)
+    {
+        AAudioPcmService* thiz = reinterpret_cast<AAudioPcmService*>(userData);
+        thiz->onError(error);
+    }
+};
+
+bool AAudioPcmService::isAvailable()
+{
+    return aaudio().loaded;
+}
+
+AAudioPcmService::AAudioPcmService()
+        : _stream(nullptr), _numChannels(2), _sampleRate(0), _framesPerBurst(0),
+          _bufferSizeInFrames(0), _bufferCapacityInFrames(0), _lastXRunCount(0),
+          _underrunCount(0), _isPaused(false), _isRestarting(false), _controller(nullptr), _mixedData(nullptr), _mixedSize(0)
+{
+}
+
+AAudioPcmService::~AAudioPcmService()
+{
+    ALOGV("~AAudioPcmService() (%p), before closing the stream", this);
+    if (_restartThread.joinable())
+    {
+        _restartThread.join();
+    }
+
+    std::lock_guard<std::mutex> lk(_streamMutex);
+    closeStream();
+    ALOGV("~AAudioPcmService() end");
+}
+
+bool AAudioPcmService::open(int numChannels, int sampleRate)
+{
+    if (!isAvailable())
+        return false;
+
+    _numChannels = numChannels;
+    _sampleRate = sampleRate;
+
+    std::lock_guard<std::mutex> lk(_streamMutex);
+    if (!openStream())
+        return false;
+
+    ALOGI("AAudio stream opened, sample rate: %d, frames per burst: %d, buffer capacity: %d",
+          _sampleRate, (int) _framesPerBurst, _bufferCapacityInFrames);
+    return true;
+}
+
+bool AAudioPcmService::openStream()
+{
+    auto& lib = aaudio();
+
+    AAudioStreamBuilder* builder = nullptr;
+    aaudio_result_t r = lib.createStreamBuilder(&builder);
+    AAUDIO_RETURN_VAL_IF_FAILED(r, false, "AAudio_createStreamBuilder failed");
+
+    lib.builderSetDirection(builder, AAUDIO_DIRECTION_OUTPUT);
+    lib.builderSetSampleRate(builder, _sampleRate);
+    lib.builderSetChannelCount(builder, _numChannels);
+    lib.builderSetFormat(builder, AAUDIO_FORMAT_PCM_I16);
+    // AAudio falls back to a shared stream if the device can't be used exclusively
+    lib.builderSetSharingMode(builder, AAUDIO_SHARING_MODE_EXCLUSIVE);
+    lib.builderSetPerformanceMode(builder, AAUDIO_PERFORMANCE_MODE_LOW_LATENCY);
+    lib.builderSetDataCallback(builder, AAudioPcmServiceCallbackProxy::dataCallback, this);
+    lib.builderSetErrorCallback(builder, AAudioPcmServiceCallbackProxy::errorCallback, this);
+
+    AAudioStream* stream = nullptr;
+    r = lib.builderOpenStream(builder, &stream);
+    lib.builderDelete(builder);
+    AAUDIO_RETURN_VAL_IF_FAILED(r, false, "AAudioStreamBuilder_openStream failed");
+
+    // the decoders resample to this rate, so the mixer doesn't have to
+    _sampleRate = lib.streamGetSampleRate(stream);
+    _framesPerBurst = lib.streamGetFramesPerBurst(stream);
+    _bufferCapacityInFrames = lib.streamGetBufferCapacityInFrames(stream);
+    _lastXRunCount = 0;
+
+    // a lower latency than the default one, the buffer grows if it underruns
+    int32_t size = lib.streamSetBufferSizeInFrames(stream, _framesPerBurst * AAUDIO_INITIAL_BURST_COUNT);
+    _bufferSizeInFrames = size > 0 ? size : _bufferCapacityInFrames;
+
+    _stream = stream;
+    return true;
+}
+
+void AAudioPcmService::closeStream()
+{
+    if (_stream != nullptr)
+    {
+        aaudio().streamRequestStop(_stream);
+        aaudio().streamClose(_stream);
+        _stream = nullptr;
+    }
+}
+
+bool AAudioPcmService::start(AudioMixerController* controller)
+{
+    _controller = controller;
+
+    std::lock_guard<std::mutex> lk(_streamMutex);
+    if (_stream == nullptr)
+        return false;
+
+    aaudio_result_t r = aaudio().streamRequestStart(_stream);
+    AAUDIO_RETURN_VAL_IF_FAILED(r, false, "AAudioStream_requestStart failed");
+    return true;
+}
+
+void AAudioPcmService::pause()
+{
+    std::lock_guard<std::mutex> lk(_streamMutex);
+    _isPaused = true;
+    if (_stream != nullptr)
+    {
+        aaudio_result_t r = aaudio().streamRequestPause(_stream);
+        AAUDIO_RETURN_VAL_IF_FAILED(r, , "AAudioPcmService::pause failed");
+    }
+}
+
+void AAudioPcmService::resume()
+{
+    std::lock_guard<std::mutex> lk(_streamMutex);
+    _isPaused = false;
+    if (_stream != nullptr)
+    {
+        aaudio_result_t r = aaudio().streamRequestStart(_stream);
+        AAUDIO_RETURN_VAL_IF_FAILED(r, , "AAudioPcmService::resume failed");
+    }
+}
+
+void AAudioPcmService::mixNextBuffer()
+{
+    if (_controller->hasPlayingTacks() && !_controller->isPaused())
+    {
+        _controller->mixOneFrame();
+
+        auto current = _controller->current();
+        ALOG_ASSERT(current != nullptr, "current buffer is nullptr ...");
+        _mixedData = static_cast<const char*>(current->buf);
+        _mixedSize = current->size;
+    }
+    else
+    {
+        // silence, the size of a mixed buffer
+        _mixedData = nullptr;
+        _mixedSize = _controller->current()->size;
+    }
+}
+
+int32_t AAudioPcmService::onAudioReady(AAudioStreamStruct* stream, void* audioData, int32_t numFrames)
+{
+    // It's in the AAudio callback thread, the device may read more or less than a burst
+    char* out = static_cast<char*>(audioData);
+    size_t remaining = (size_t) numFrames * _numChannels * sizeof(int16_t);
+    while (remaining > 0)
+    {
+        if (_mixedSize == 0)
+        {
+            mixNextBuffer();
+        }
+
+        size_t size = std::min(remaining, _mixedSize);
+        if (_mixedData != nullptr)
+        {
+            memcpy(out, _mixedData, size);
+            _mixedData += size;
+        }
+        else
+        {
+            memset(out, 0, size);
+        }
+        _mixedSize -= size;
+        out += size;
+        remaining -= size;
+    }
+
+    tuneBufferSize(stream);
+    return AAUDIO_CALLBACK_RESULT_CONTINUE;
+}
+
+void AAudioPcmService::tuneBufferSize(AAudioStreamStruct* stream)
+{
+    auto& lib = aaudio();
+    int32_t xRunCount = lib.streamGetXRunCount(stream);
+    if (xRunCount <= _lastXRunCount)
+        return;
+
+    _underrunCount += xRunCount - _lastXRunCount;
+    _lastXRunCount = xRunCount;
+
+    // one more burst of latency for each underrun, up to the capacity
+    int32_t size = _bufferSizeInFrames + _framesPerBurst;
+    if (size <= _bufferCapacityInFrames)
+    {
+        size = lib.streamSetBufferSizeInFrames(stream, size);
+        if (size > 0)
+        {
+            ALOGV("Underrun, the buffer size is raised to %d frames", size);
+            _bufferSizeInFrames = size;
+        }
+    }
+}
+
+void AAudioPcmService::onError(int32_t error)
+{
+    ALOGW("AAudio stream error: %s", aaudio().convertResultToText(error));
+
+    // The stream can't be closed from its callback, the device has changed
+    if (error == AAUDIO_ERROR_DISCONNECTED && !_isRestarting.exchange(true))
+    {
+        // the previous restart has finished
+        if (_restartThread.joinable())
+        {
+            _restartThread.join();
+        }
+        _restartThread = std::thread(&AAudioPcmService::restart, this);
+    }
+}
+
+void AAudioPcmService::restart()
+{
+    std::lock_guard<std::mutex> lk(_streamMutex);
+    restartStream();
+    _isRestarting = false;
+}
+
+void AAudioPcmService::restartStream()
+{
+    // the audio is decoded at the sample rate of the first stream, AAudio resamples it if the new device doesn't support it
+    int sampleRate = _sampleRate;
+    closeStream();
+    _mixedSize = 0;
+    if (!openStream())
+    {
+        ALOGE("Failed to open the AAudio stream again");
+        return;
+    }
+
+    if (_sampleRate != sampleRate)
+    {
+        ALOGE("The AAudio stream runs at %d instead of %d", _sampleRate, sampleRate);
+        closeStream();
+        _sampleRate = sampleRate;
+        return;
+    }
+
+    if (!_isPaused && _controller != nullptr)
+    {
+        aaudio_result_t r = aaudio().streamRequestStart(_stream);
+        AAUDIO_RETURN_VAL_IF_FAILED(r, , "AAudioStream_requestStart failed");
+    }
+}
+
+}} // namespace cocos2d { namespace experimental {
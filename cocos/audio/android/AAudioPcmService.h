@@ -0,0 +1,117 @@
+/****************************************************************************
+Copyright (c) 2017 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+// AAudioStream of <aaudio/AAudio.h>
+struct AAudioStreamStruct;
+
+namespace cocos2d { namespace experimental {
+
+class AudioMixerController;
+
+// Plays the output of an AudioMixerController with AAudio (Android 8.0, API 26), in the low latency
+// performance mode, at the native sample rate and with a buffer of a few bursts.
+// libaaudio.so is loaded at runtime, so that the library still runs on the older versions, where PcmAudioService is used.
+class AAudioPcmService
+{
+public:
+    // Whether AAudio can be used on this device.
+    static bool isAvailable();
+
+    inline int getChannelCount() const
+    { return _numChannels; };
+
+    // The sample rate of the stream, the one requested if the device accepts it.
+    inline int getSampleRate() const
+    { return _sampleRate; };
+
+    // The number of frames the device reads at once.
+    inline int getFramesPerBurst() const
+    { return _framesPerBurst; };
+
+    // The number of frames written ahead of the device, it's raised by a burst after each underrun.
+    inline int getBufferSizeInFrames() const
+    { return _bufferSizeInFrames; };
+
+    inline unsigned int getUnderrunCount() const
+    { return _underrunCount; };
+
+private:
+    AAudioPcmService();
+
+    virtual ~AAudioPcmService();
+
+    // Opens the stream, it doesn't play before start().
+    bool open(int numChannels, int sampleRate);
+
+    // Plays the frames mixed by the controller, its buffer size should be the burst of the stream.
+    bool start(AudioMixerController* controller);
+
+    void pause();
+    void resume();
+
+    int32_t onAudioReady(AAudioStreamStruct* stream, void* audioData, int32_t numFrames);
+    void onError(int32_t error);
+
+    // Opens the stream again, e.g. once the headphones have been unplugged.
+    void restart();
+    void restartStream();
+
+    bool openStream();
+    void closeStream();
+    void mixNextBuffer();
+    void tuneBufferSize(AAudioStreamStruct* stream);
+
+private:
+    std::mutex _streamMutex;
+    AAudioStreamStruct* _stream;
+    std::thread _restartThread;
+
+    int _numChannels;
+    int _sampleRate;
+    std::atomic_int _framesPerBurst;
+    std::atomic_int _bufferSizeInFrames;
+    int _bufferCapacityInFrames;
+    int32_t _lastXRunCount;
+    std::atomic_uint _underrunCount;
+    bool _isPaused;
+    std::atomic_bool _isRestarting;
+
+    AudioMixerController* _controller;
+    // the part of the mixed buffer that the device hasn't read yet
+    const char* _mixedData;
+    size_t _mixedSize;
+
+    friend class AAudioPcmServiceCallbackProxy;
+    friend class AudioPlayerProvider;
+};
+
+}} // namespace cocos2d { namespace experimental {
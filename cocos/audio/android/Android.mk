@@ -27,6 +27,7 @@ LOCAL_SRC_FILES := AudioEngine-inl.cpp \
                    AudioMixerController.cpp \
                    AudioMixer.cpp \
                    PcmAudioService.cpp \
+                   AAudioPcmService.cpp \
                    Track.cpp \
                    audio_utils/format.c \
                    audio_utils/minifloat.cpp \
@@ -38,7 +39,7 @@ LOCAL_SRC_FILES := AudioEngine-inl.cpp \
 
 LOCAL_EXPORT_C_INCLUDES := $(LOCAL_PATH)/../include
 
-LOCAL_EXPORT_LDLIBS := -lOpenSLES
+LOCAL_EXPORT_LDLIBS := -lOpenSLES -ldl
 
 LOCAL_C_INCLUDES := $(LOCAL_PATH)/../include \
                     $(LOCAL_PATH)/../.. \
@@ -447,6 +447,14 @@ void AudioEngineImpl::preload(const std::string& filePath, const std::function<v
     }
 }
 
+void AudioEngineImpl::getOutputStats(AudioOutputStats* stats)
+{
+    if (_audioPlayerProvider != nullptr)
+    {
+        _audioPlayerProvider->getOutputStats(stats);
+    }
+}
+
 void AudioEngineImpl::uncache(const std::string& filePath)
 {
     if (_audioPlayerProvider != nullptr)
@@ -46,6 +46,7 @@ namespace experimental {
 
 class IAudioPlayer;
 class AudioPlayerProvider;
+struct AudioOutputStats;
 
 class AudioEngineImpl;
 
@@ -73,6 +74,8 @@ public:
     void preload(const std::string& filePath, const std::function<void(bool)>& callback);
 
     void setAudioFocusForAllPlayers(bool isFocus);
+
+    void getOutputStats(AudioOutputStats* stats);
 private:
 
     void onEnterBackground(EventCustom* event);
@@ -29,6 +29,7 @@
 
 #include "audio/android/AudioMixerOps.h"
 #include "audio/android/AudioMixer.h"
+#include "audio/android/AudioMixerNEON.h"
 
 // The FCC_2 macro refers to the Fixed Channel Count of 2 for the legacy integer mixer.
 #ifndef FCC_2
@@ -1245,12 +1246,18 @@ void AudioMixer::track__16BitsStereo(track_t* t, int32_t* out, size_t frameCount
             //        t, vlInc/65536.0f, vl/65536.0f, t->volume[0],
             //        (vl + vlInc*frameCount)/65536.0f, frameCount);
 
-            do {
+#ifdef AUDIO_MIXER_USE_NEON
+            size_t done = mixRamp16NEON<false>(out, in, frameCount, &vl, &vr, vlInc, vrInc);
+            out += done * 2;
+            in += done * 2;
+            frameCount -= done;
+#endif
+            for (; frameCount; --frameCount) {
                 *out++ += (vl >> 16) * (int32_t) *in++;
                 *out++ += (vr >> 16) * (int32_t) *in++;
                 vl += vlInc;
                 vr += vrInc;
-            } while (--frameCount);
+            }
 
             t->prevVolume[0] = vl;
             t->prevVolume[1] = vr;
@@ -1260,13 +1267,19 @@ void AudioMixer::track__16BitsStereo(track_t* t, int32_t* out, size_t frameCount
         // constant gain
         else {
             const uint32_t vrl = t->volumeRL;
-            do {
+#ifdef AUDIO_MIXER_USE_NEON
+            size_t done = mixStereo16NEON(out, in, frameCount, vrl);
+            out += done * 2;
+            in += done * 2;
+            frameCount -= done;
+#endif
+            for (; frameCount; --frameCount) {
                 uint32_t rl = *reinterpret_cast<const uint32_t *>(in);
                 in += 2;
                 out[0] = mulAddRL(1, rl, vrl, out[0]);
                 out[1] = mulAddRL(0, rl, vrl, out[1]);
                 out += 2;
-            } while (--frameCount);
+            }
         }
     }
     t->in = in;
@@ -1333,13 +1346,19 @@ void AudioMixer::track__16BitsMono(track_t* t, int32_t* out, size_t frameCount,
             //         t, vlInc/65536.0f, vl/65536.0f, t->volume[0],
             //         (vl + vlInc*frameCount)/65536.0f, frameCount);
 
-            do {
+#ifdef AUDIO_MIXER_USE_NEON
+            size_t done = mixRamp16NEON<true>(out, in, frameCount, &vl, &vr, vlInc, vrInc);
+            out += done * 2;
+            in += done;
+            frameCount -= done;
+#endif
+            for (; frameCount; --frameCount) {
                 int32_t l = *in++;
                 *out++ += (vl >> 16) * l;
                 *out++ += (vr >> 16) * l;
                 vl += vlInc;
                 vr += vrInc;
-            } while (--frameCount);
+            }
 
             t->prevVolume[0] = vl;
             t->prevVolume[1] = vr;
@@ -1349,12 +1368,18 @@ void AudioMixer::track__16BitsMono(track_t* t, int32_t* out, size_t frameCount,
         else {
             const int16_t vl = t->volume[0];
             const int16_t vr = t->volume[1];
-            do {
+#ifdef AUDIO_MIXER_USE_NEON
+            size_t done = mixMono16NEON(out, in, frameCount, vl, vr);
+            out += done * 2;
+            in += done;
+            frameCount -= done;
+#endif
+            for (; frameCount; --frameCount) {
                 int16_t l = *in++;
                 out[0] = mulAdd(l, vl, out[0]);
                 out[1] = mulAdd(l, vr, out[1]);
                 out += 2;
-            } while (--frameCount);
+            }
         }
     }
     t->in = in;
@@ -1640,6 +1665,17 @@ void AudioMixer::process__OneTrack16BitsStereoNoResampling(state_t* state,
             } while (--outFrames);
             break;
         case AUDIO_FORMAT_PCM_16_BIT:
+#ifdef AUDIO_MIXER_USE_NEON
+            // saturating, the same as the clamping below
+            {
+                size_t done = scaleStereo16NEON(out, in, outFrames, vrl);
+                out += done;
+                in += done * 2;
+                outFrames -= done;
+                if (outFrames == 0)
+                    break;
+            }
+#endif
             if (CC_UNLIKELY(uint32_t(vl) > UNITY_GAIN_INT || uint32_t(vr) > UNITY_GAIN_INT)) {
                 // volume is boosted, so we might need to clamp even though
                 // we process only one track.
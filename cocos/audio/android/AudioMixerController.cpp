@@ -40,6 +40,9 @@ AudioMixerController::AudioMixerController(int bufferSizeInFrames, int sampleRat
         , _mixer(nullptr)
         , _isPaused(false)
         , _isMixingFrame(false)
+        , _averageLoad(0.0f)
+        , _peakLoad(0.0f)
+        , _overloadCount(0)
 {
     ALOGV("In the constructor of AudioMixerController!");
 
@@ -306,6 +309,18 @@ void AudioMixerController::mixOneFrame()
     float mixInterval = intervalInMS(mixStart, mixEnd);
     ALOGV_IF(mixInterval > 1.0f, "Mix a frame waste: %fms", mixInterval);
 
+    // only written here, in the thread of the output
+    float load = mixInterval * _sampleRate / (1000.0f * _bufferSizeInFrames);
+    _averageLoad = _averageLoad * 0.95f + load * 0.05f;
+    if (load > _peakLoad)
+    {
+        _peakLoad = load;
+    }
+    if (load > 1.0f)
+    {
+        ++_overloadCount;
+    }
+
     _isMixingFrame = false;
 }
 
@@ -64,6 +64,15 @@ public:
 
     inline OutputBuffer* current() { return &_mixingBuffer; }
 
+    inline int getBufferSizeInFrames() const { return _bufferSizeInFrames; }
+
+    // The share of the duration of a buffer spent mixing it, averaged over the last buffers and the highest one.
+    // Over 1, the mixer can't keep up with the output.
+    inline float getAverageLoad() const { return _averageLoad; }
+    inline float getPeakLoad() const { return _peakLoad; }
+    // The number of buffers which took longer to mix than to play.
+    inline unsigned int getOverloadCount() const { return _overloadCount; }
+
 private:
     void destroy();
     void initTrack(Track* track, std::vector<Track*>& tracksToRemove);
@@ -82,6 +91,10 @@ private:
 
     std::atomic_bool _isPaused;
     std::atomic_bool _isMixingFrame;
+
+    std::atomic<float> _averageLoad;
+    std::atomic<float> _peakLoad;
+    std::atomic_uint _overloadCount;
 };
 
 }} // namespace cocos2d { namespace experimental {
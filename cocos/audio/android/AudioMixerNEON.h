@@ -0,0 +1,151 @@
+/****************************************************************************
+Copyright (c) 2017 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+
+#pragma once
+
+#if defined(__ARM_NEON__) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#define AUDIO_MIXER_USE_NEON 1
+#endif
+
+#include <stdint.h>
+#include <stddef.h>
+
+#ifdef AUDIO_MIXER_USE_NEON
+
+namespace cocos2d { namespace experimental {
+
+// NEON versions of the inner loops of the 16 bits hooks of AudioMixer.
+// They process the frames by groups of 4 and return how many they processed, the scalar loops
+// mix the remaining ones. The arithmetic is the one of the scalar loops, so the output doesn't change:
+// the volumes are Q4.12 and the ramps add their Q4.28 increment to the volume of each frame.
+
+// out[] += in[] * volume, for 16 bits stereo frames. vrl is the right volume in the high 16 bits, the left one in the low ones.
+static inline size_t mixStereo16NEON(int32_t* out, const int16_t* in, size_t frameCount, uint32_t vrl)
+{
+    const int16x4_t volume = vreinterpret_s16_u32(vdup_n_u32(vrl));
+    const size_t frames = frameCount & ~(size_t)3;
+    for (size_t i = 0; i < frames; i += 4)
+    {
+        int16x8_t samples = vld1q_s16(in);
+        int32x4_t lo = vld1q_s32(out);
+        int32x4_t hi = vld1q_s32(out + 4);
+        vst1q_s32(out, vmlal_s16(lo, vget_low_s16(samples), volume));
+        vst1q_s32(out + 4, vmlal_s16(hi, vget_high_s16(samples), volume));
+        in += 8;
+        out += 8;
+    }
+    return frames;
+}
+
+// Same as mixStereo16NEON for 16 bits mono frames, mixed to both channels.
+static inline size_t mixMono16NEON(int32_t* out, const int16_t* in, size_t frameCount, int16_t vl, int16_t vr)
+{
+    const int16x4_t volume = vreinterpret_s16_u32(vdup_n_u32(((uint32_t)(uint16_t)vr << 16) | (uint16_t)vl));
+    const size_t frames = frameCount & ~(size_t)3;
+    for (size_t i = 0; i < frames; i += 4)
+    {
+        int16x4x2_t samples = vzip_s16(vld1_s16(in), vld1_s16(in));
+        int32x4_t lo = vld1q_s32(out);
+        int32x4_t hi = vld1q_s32(out + 4);
+        vst1q_s32(out, vmlal_s16(lo, samples.val[0], volume));
+        vst1q_s32(out + 4, vmlal_s16(hi, samples.val[1], volume));
+        in += 4;
+        out += 8;
+    }
+    return frames;
+}
+
+// The ramp of 4 stereo frames: out[] += (volume >> 16) * samples, the volumes of frames 0 and 1 are in v0, of frames 2 and 3 in v1.
+static inline void rampStereo16NEON(int32_t* out, int16x8_t samples, int32x4_t v0, int32x4_t v1)
+{
+    int32x4_t lo = vld1q_s32(out);
+    int32x4_t hi = vld1q_s32(out + 4);
+    vst1q_s32(out, vmlaq_s32(lo, vshrq_n_s32(v0, 16), vmovl_s16(vget_low_s16(samples))));
+    vst1q_s32(out + 4, vmlaq_s32(hi, vshrq_n_s32(v1, 16), vmovl_s16(vget_high_s16(samples))));
+}
+
+// out[] += (vl >> 16) * in[], vl += vlInc for each frame, and the same for the right channel. vl and vr are updated.
+// MONO reads one sample per frame and mixes it to both channels.
+template <bool MONO>
+static inline size_t mixRamp16NEON(int32_t* out, const int16_t* in, size_t frameCount,
+                                   int32_t* vl, int32_t* vr, int32_t vlInc, int32_t vrInc)
+{
+    const size_t frames = frameCount & ~(size_t)3;
+    if (frames == 0)
+        return 0;
+
+    const int32_t start[4] = { *vl, *vr, *vl + vlInc, *vr + vrInc };
+    const int32_t step[4] = { 2 * vlInc, 2 * vrInc, 2 * vlInc, 2 * vrInc };
+    const int32x4_t inc2 = vld1q_s32(step);
+    const int32x4_t inc4 = vaddq_s32(inc2, inc2);
+    int32x4_t v0 = vld1q_s32(start);
+    int32x4_t v1 = vaddq_s32(v0, inc2);
+
+    for (size_t i = 0; i < frames; i += 4)
+    {
+        int16x8_t samples;
+        if (MONO)
+        {
+            int16x4x2_t zipped = vzip_s16(vld1_s16(in), vld1_s16(in));
+            samples = vcombine_s16(zipped.val[0], zipped.val[1]);
+            in += 4;
+        }
+        else
+        {
+            samples = vld1q_s16(in);
+            in += 8;
+        }
+        rampStereo16NEON(out, samples, v0, v1);
+        v0 = vaddq_s32(v0, inc4);
+        v1 = vaddq_s32(v1, inc4);
+        out += 8;
+    }
+
+    *vl += vlInc * (int32_t)frames;
+    *vr += vrInc * (int32_t)frames;
+    return frames;
+}
+
+// out[] = clamp16((in[] * volume) >> 12) for 16 bits stereo frames, the output frames are packed in 32 bits.
+static inline size_t scaleStereo16NEON(int32_t* out, const int16_t* in, size_t frameCount, uint32_t vrl)
+{
+    const int16x4_t volume = vreinterpret_s16_u32(vdup_n_u32(vrl));
+    const size_t frames = frameCount & ~(size_t)3;
+    for (size_t i = 0; i < frames; i += 4)
+    {
+        int16x8_t samples = vld1q_s16(in);
+        int16x4_t lo = vqshrn_n_s32(vmull_s16(vget_low_s16(samples), volume), 12);
+        int16x4_t hi = vqshrn_n_s32(vmull_s16(vget_high_s16(samples), volume), 12);
+        vst1q_s16(reinterpret_cast<int16_t*>(out), vcombine_s16(lo, hi));
+        in += 8;
+        out += 4;
+    }
+    return frames;
+}
+
+}} // namespace cocos2d { namespace experimental {
+
+#endif // AUDIO_MIXER_USE_NEON
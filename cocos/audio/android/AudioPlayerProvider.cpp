@@ -31,9 +31,11 @@ THE SOFTWARE.
 #include "audio/android/AudioDecoderProvider.h"
 #include "audio/android/AudioMixerController.h"
 #include "audio/android/PcmAudioService.h"
+#include "audio/android/AAudioPcmService.h"
 #include "audio/android/CCThreadPool.h"
 #include "audio/android/ICallerThreadUtils.h"
 #include "audio/android/utils/Utils.h"
+#include "audio/include/AudioEngine.h"
 
 #include <sys/system_properties.h>
 #include <stdlib.h>
@@ -82,11 +84,40 @@ AudioPlayerProvider::AudioPlayerProvider(SLEngineItf engineItf, SLObjectItf outp
         : _engineItf(engineItf), _outputMixObject(outputMixObject),
           _deviceSampleRate(deviceSampleRate), _bufferSizeInFrames(bufferSizeInFrames),
           _fdGetterCallback(fdGetterCallback), _callerThreadUtils(callerThreadUtils),
-          _pcmAudioService(nullptr), _mixController(nullptr),
+          _pcmAudioService(nullptr), _aaudioService(nullptr), _mixController(nullptr),
           _threadPool(ThreadPool::newCachedThreadPool(1, 8, 5, 2, 2))
 {
     ALOGI("deviceSampleRate: %d, bufferSizeInFrames: %d", _deviceSampleRate, _bufferSizeInFrames);
-    if (getSystemAPILevel() >= 17)
+    if (getSystemAPILevel() >= 26 && AAudioPcmService::isAvailable())
+    {
+        // The mixer fills a burst at the native sample rate, the decoders resample to it
+        _aaudioService = new (std::nothrow) AAudioPcmService();
+        if (_aaudioService->open(2, deviceSampleRate))
+        {
+            _deviceSampleRate = _aaudioService->getSampleRate();
+            _bufferSizeInFrames = _aaudioService->getFramesPerBurst();
+            _mixController = new (std::nothrow) AudioMixerController(_bufferSizeInFrames, _deviceSampleRate, 2);
+            _mixController->init();
+            if (!_aaudioService->start(_mixController))
+            {
+                SL_SAFE_DELETE(_aaudioService);
+                SL_SAFE_DELETE(_mixController);
+                _deviceSampleRate = deviceSampleRate;
+                _bufferSizeInFrames = bufferSizeInFrames;
+            }
+        }
+        else
+        {
+            SL_SAFE_DELETE(_aaudioService);
+        }
+
+        if (_aaudioService == nullptr)
+        {
+            ALOGW("AAudio couldn't be used, falling back to OpenSL ES");
+        }
+    }
+
+    if (_aaudioService == nullptr && getSystemAPILevel() >= 17)
     {
         _mixController = new (std::nothrow) AudioMixerController(_bufferSizeInFrames, _deviceSampleRate, 2);
         _mixController->init();
@@ -103,6 +134,7 @@ AudioPlayerProvider::~AudioPlayerProvider()
     UrlAudioPlayer::stopAll();
 
     SL_SAFE_DELETE(_pcmAudioService);
+    SL_SAFE_DELETE(_aaudioService);
     SL_SAFE_DELETE(_mixController);
     SL_SAFE_DELETE(_threadPool);
 }
@@ -308,8 +340,11 @@ void AudioPlayerProvider::preloadEffect(const AudioFileInfo &info, const Preload
             if (ret)
             {
                 d = decoder->getResult();
-                std::lock_guard<std::mutex> lk(_pcmCacheMutex);
-                _pcmCache.insert(std::make_pair(audioFilePath, d));
+                {
+                    std::lock_guard<std::mutex> lk(_pcmCacheMutex);
+                    _pcmCache.insert(std::make_pair(audioFilePath, d));
+                }
+                AudioEngine::onAudioCached(audioFilePath, d.pcmBuffer ? d.pcmBuffer->size() : 0);
             }
             else
             {
@@ -420,14 +455,20 @@ bool AudioPlayerProvider::isSmallFile(const AudioFileInfo &info)
                                  return judge.extension == extension;
                              });
 
+    bool isSmall = false;
     if (iter != std::end(__audioFileIndicator))
     {
 //        ALOGV("isSmallFile: found: %s: ", iter->extension.c_str());
-        return info.length < iter->smallSizeIndicator;
+        isSmall = info.length < iter->smallSizeIndicator;
+    }
+    else
+    {
+//        ALOGV("isSmallFile: not found return default value");
+        isSmall = info.length < __audioFileIndicator[0].smallSizeIndicator;
     }
 
-//    ALOGV("isSmallFile: not found return default value");
-    return info.length < __audioFileIndicator[0].smallSizeIndicator;
+    // The low-latency files and the streaming threshold set by developers win over the defaults of each format
+    return !AudioEngine::shouldStream(info.url, (long)info.length, !isSmall);
 }
 
 void AudioPlayerProvider::clearPcmCache(const std::string &audioFilePath)
@@ -500,6 +541,11 @@ void AudioPlayerProvider::pause()
     {
         _pcmAudioService->pause();
     }
+
+    if (_aaudioService != nullptr)
+    {
+        _aaudioService->pause();
+    }
 }
 
 void AudioPlayerProvider::resume()
@@ -513,6 +559,37 @@ void AudioPlayerProvider::resume()
     {
         _pcmAudioService->resume();
     }
+
+    if (_aaudioService != nullptr)
+    {
+        _aaudioService->resume();
+    }
+}
+
+void AudioPlayerProvider::getOutputStats(AudioOutputStats* stats)
+{
+    if (_mixController == nullptr)
+        return;
+
+    stats->sampleRate = _deviceSampleRate;
+    stats->mixerLoad = _mixController->getAverageLoad();
+    stats->mixerPeakLoad = _mixController->getPeakLoad();
+    stats->overloads = _mixController->getOverloadCount();
+
+    if (_aaudioService != nullptr)
+    {
+        stats->output = "AAudio";
+        stats->framesPerBurst = _aaudioService->getFramesPerBurst();
+        stats->bufferSizeInFrames = _aaudioService->getBufferSizeInFrames();
+        stats->underruns = _aaudioService->getUnderrunCount();
+    }
+    else
+    {
+        // OpenSL ES doesn't report its underruns
+        stats->output = "OpenSL ES";
+        stats->framesPerBurst = _bufferSizeInFrames;
+        stats->bufferSizeInFrames = _pcmAudioService->getBufferSizeInFrames();
+    }
 }
 
 }} // namespace cocos2d { namespace experimental {
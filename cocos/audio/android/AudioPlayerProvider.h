@@ -37,6 +37,8 @@ namespace cocos2d { namespace experimental {
 
 class PcmAudioPlayer;
 class PcmAudioService;
+class AAudioPcmService;
+struct AudioOutputStats;
 class UrlAudioPlayer;
 class AudioMixerController;
 class ICallerThreadUtils;
@@ -65,6 +67,8 @@ public:
 
     void resume();
 
+    void getOutputStats(AudioOutputStats* stats);
+
 private:
 
     struct AudioFileInfo
@@ -118,6 +122,7 @@ private:
     std::condition_variable _preloadWaitCond;
 
     PcmAudioService* _pcmAudioService;
+    AAudioPcmService* _aaudioService;
     AudioMixerController *_mixController;
 
     ThreadPool* _threadPool;
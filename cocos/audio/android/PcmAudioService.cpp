@@ -177,6 +177,12 @@ bool PcmAudioService::init(AudioMixerController* controller, int numChannels, in
     return true;
 }
 
+int PcmAudioService::getBufferSizeInFrames() const
+{
+    // a buffer is enqueued when the previous one has been played
+    return _controller->getBufferSizeInFrames();
+}
+
 void PcmAudioService::pause()
 {
     SLresult r = (*_playItf)->SetPlayState(_playItf, SL_PLAYSTATE_PAUSED);
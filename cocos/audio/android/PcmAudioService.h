@@ -44,6 +44,9 @@ public:
     inline int getSampleRate() const
     { return _sampleRate; };
 
+    // The frames enqueued ahead of the device.
+    int getBufferSizeInFrames() const;
+
 private:
     PcmAudioService(SLEngineItf engineItf, SLObjectItf outputMixObject);
 
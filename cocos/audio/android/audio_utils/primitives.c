@@ -18,10 +18,24 @@
 #include "audio/android/audio_utils/include/audio_utils/primitives.h"
 #include "audio/android/audio_utils/private/private.h"
 
+#if defined(__ARM_NEON__) || defined(__ARM_NEON)
+#include <arm_neon.h>
+#endif
+
 void ditherAndClamp(int32_t* out, const int32_t *sums, size_t c)
 {
-    size_t i;
-    for (i=0 ; i<c ; i++) {
+    size_t i = 0;
+#if defined(__ARM_NEON__) || defined(__ARM_NEON)
+    // 4 frames at a time, the saturating narrowing shift clamps like clamp16()
+    for (; i + 4 <= c; i += 4) {
+        int16x4_t lo = vqshrn_n_s32(vld1q_s32(sums), 12);
+        int16x4_t hi = vqshrn_n_s32(vld1q_s32(sums + 4), 12);
+        vst1q_s16((int16_t*)out, vcombine_s16(lo, hi));
+        sums += 8;
+        out += 4;
+    }
+#endif
+    for ( ; i<c ; i++) {
         int32_t l = *sums++;
         int32_t r = *sums++;
         int32_t nl = l >> 12;
@@ -113,7 +113,7 @@ float AndroidJavaEngine::getBackgroundMusicVolume() {
 }
 
 void AndroidJavaEngine::setBackgroundMusicVolume(float volume) {
-    JniHelper::callStaticVoidMethod(helperClassName, "setBackgroundMusicVolume", volume);
+    JniHelper::queueHelperCommand(JniHelper::HelperCommand::SET_BACKGROUND_MUSIC_VOLUME, 0, volume);
 }
 
 float AndroidJavaEngine::getEffectsVolume()
@@ -152,7 +152,7 @@ void AndroidJavaEngine::setEffectsVolume(float volume)
     }
     else
     {
-        JniHelper::callStaticVoidMethod(helperClassName, "setEffectsVolume", volume);
+        JniHelper::queueHelperCommand(JniHelper::HelperCommand::SET_EFFECTS_VOLUME, 0, volume);
     }
 }
 
@@ -189,7 +189,7 @@ void AndroidJavaEngine::pauseEffect(unsigned int soundID)
     }
     else
     {
-        JniHelper::callStaticVoidMethod(helperClassName, "pauseEffect", (int)soundID);
+        JniHelper::queueHelperCommand(JniHelper::HelperCommand::PAUSE_EFFECT, (int)soundID);
     }
 }
 
@@ -201,7 +201,7 @@ void AndroidJavaEngine::resumeEffect(unsigned int soundID)
     }
     else
     {
-        JniHelper::callStaticVoidMethod(helperClassName, "resumeEffect", (int)soundID);
+        JniHelper::queueHelperCommand(JniHelper::HelperCommand::RESUME_EFFECT, (int)soundID);
     }
 }
 
@@ -214,7 +214,7 @@ void AndroidJavaEngine::stopEffect(unsigned int soundID)
     }
     else
     {
-        JniHelper::callStaticVoidMethod(helperClassName, "stopEffect", (int)soundID);
+        JniHelper::queueHelperCommand(JniHelper::HelperCommand::STOP_EFFECT, (int)soundID);
     }
 }
 
@@ -229,7 +229,7 @@ void AndroidJavaEngine::pauseAllEffects()
     }
     else
     {
-        JniHelper::callStaticVoidMethod(helperClassName, "pauseAllEffects");
+        JniHelper::queueHelperCommand(JniHelper::HelperCommand::PAUSE_ALL_EFFECTS);
     }
 }
 
@@ -244,7 +244,7 @@ void AndroidJavaEngine::resumeAllEffects()
     }
     else
     {
-        JniHelper::callStaticVoidMethod(helperClassName, "resumeAllEffects");
+        JniHelper::queueHelperCommand(JniHelper::HelperCommand::RESUME_ALL_EFFECTS);
     }
 }
 
@@ -260,7 +260,7 @@ void AndroidJavaEngine::stopAllEffects()
     }
     else
     {
-        JniHelper::callStaticVoidMethod(helperClassName, "stopAllEffects");
+        JniHelper::queueHelperCommand(JniHelper::HelperCommand::STOP_ALL_EFFECTS);
     }
 }
 
@@ -34,6 +34,8 @@
 #include <thread>
 #include "base/CCDirector.h"
 #include "base/CCScheduler.h"
+#include "platform/CCFileUtils.h"
+#include "audio/include/AudioEngine.h"
 
 #include "audio/apple/AudioDecoder.h"
 
@@ -219,7 +221,10 @@ void AudioCache::readDataTask(unsigned int selfId)
         _duration = 1.0f * totalFrames / sampleRate;
         _totalFrames = totalFrames;
 
-        if (dataSize <= PCMDATA_CACHEMAXSIZE)
+        // the files above the AudioEngine streaming threshold, or decoding above PCMDATA_CACHEMAXSIZE by default, are streamed
+        const bool isStreamed = AudioEngine::shouldStream(_fileFullPath, FileUtils::getInstance()->getFileSize(_fileFullPath),
+                                                          dataSize > PCMDATA_CACHEMAXSIZE);
+        if (!isStreamed)
         {
             uint32_t framesRead = 0;
             const uint32_t framesToReadOnce = std::min(totalFrames, static_cast<uint32_t>(sampleRate * QUEUEBUFFER_TIME_STEP * QUEUEBUFFER_NUM));
@@ -277,6 +282,7 @@ void AudioCache::readDataTask(unsigned int selfId)
                 break;
 
             alBufferDataStaticProc(_alBufferId, _format, _pcmData, (ALsizei)dataSize, (ALsizei)sampleRate);
+            AudioEngine::onAudioCached(_fileFullPath, dataSize);
 
             framesRead = decoder.readFixedFrames(std::min(framesToReadOnce, remainingFrames), _pcmData + _framesRead * bytesPerFrame);
             _framesRead += framesRead;
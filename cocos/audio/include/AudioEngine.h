@@ -27,11 +27,14 @@
 #include "platform/CCPlatformConfig.h"
 #include "platform/CCPlatformMacros.h"
 #include "audio/include/Export.h"
+#include "base/CCAsyncOperation.h"
 
 #include <functional>
 #include <list>
+#include <memory>
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #ifdef ERROR
 #undef ERROR
@@ -75,6 +78,76 @@ public:
     }
 };
 
+/**
+ * @class AudioCacheStats
+ *
+ * @brief The decoded audio cache accounting of AudioEngine.
+ * @js NA
+ */
+struct EXPORT_DLL AudioCacheStats
+{
+    //The byte budget of the cache, 0 if unlimited.
+    size_t budget;
+    //The decoded bytes cached.
+    size_t cachedBytes;
+    //The number of files cached.
+    unsigned int cachedFileCount;
+    //The number of play2d calls which found the file cached, or not.
+    unsigned int hits;
+    unsigned int misses;
+    //The number of files uncached to fit the budget.
+    unsigned int evictions;
+
+    AudioCacheStats()
+    : budget(0)
+    , cachedBytes(0)
+    , cachedFileCount(0)
+    , hits(0)
+    , misses(0)
+    , evictions(0)
+    {
+
+    }
+};
+
+/**
+ * @class AudioOutputStats
+ *
+ * @brief The state of the output of AudioEngine on the platforms mixing the audio themselves (Android).
+ * @since v3.14
+ * @js NA
+ */
+struct EXPORT_DLL AudioOutputStats
+{
+    //The API playing the mixed audio, e.g. "AAudio" or "OpenSL ES", empty if the platform doesn't mix the audio.
+    std::string output;
+    //The sample rate of the output, the audio is decoded at this rate.
+    int sampleRate;
+    //The number of frames the device reads at once, and mixed at once.
+    int framesPerBurst;
+    //The number of frames written ahead of the device, the latency of the output.
+    int bufferSizeInFrames;
+    //The share of the duration of a buffer spent mixing it, averaged and the highest one. Over 1, the mixer can't keep up.
+    float mixerLoad;
+    float mixerPeakLoad;
+    //The number of underruns of the output, 0 when the output doesn't report them (OpenSL ES).
+    unsigned int underruns;
+    //The number of buffers which took longer to mix than to play.
+    unsigned int overloads;
+
+    AudioOutputStats()
+    : sampleRate(0)
+    , framesPerBurst(0)
+    , bufferSizeInFrames(0)
+    , mixerLoad(0.0f)
+    , mixerPeakLoad(0.0f)
+    , underruns(0)
+    , overloads(0)
+    {
+
+    }
+};
+
 class AudioEngineImpl;
 
 /**
@@ -292,10 +365,101 @@ public:
      */
     static void preload(const std::string& filePath, std::function<void(bool isSuccess)> callback);
 
+    /**
+     * Preload audio file.
+     * @param filePath The file path of an audio.
+     * @return An operation completed with whether the file was loaded.
+     * @since v3.14
+     * @js NA
+     * @lua NA
+     */
+    static AsyncOperation<bool> preloadAsync(const std::string& filePath);
+
+    /**
+     * Preload a batch of audio files, as many at once as there are decoder threads.
+     * The files of the batches with a higher priority are preloaded first.
+     *
+     * @param filePaths The file paths of the audios.
+     * @param progressCallback Called after each file is loaded, with the number of files loaded and the total.
+     * @param completion Called once all the files are loaded, with whether all of them succeeded.
+     * @param priority The priority of the batch, 0 by default.
+     * @since v3.14
+     */
+    static void preloadBatch(const std::vector<std::string>& filePaths,
+                             const std::function<void(int loadedCount, int totalCount)>& progressCallback,
+                             const std::function<void(bool isSuccess)>& completion,
+                             int priority = 0);
+
+    /**
+     * Sets the number of threads decoding the audio files, 4 by default.
+     * The decoder threads only grow once started, fewer threads only limit the files preloaded at once by preloadBatch.
+     * @since v3.14
+     */
+    static void setDecoderThreadCount(unsigned int count);
+
+    /** Gets the number of threads decoding the audio files. @since v3.14 */
+    static unsigned int getDecoderThreadCount() { return _decoderThreadCount; }
+
+    /**
+     * Marks an audio file for low-latency playback: it's preloaded, never streamed and never evicted to fit the cache budget.
+     * Only uncache and uncacheAll release it.
+     * @since v3.14
+     */
+    static void setLowLatency(const std::string& filePath, bool lowLatency);
+
+    /** Checks whether an audio file is marked for low-latency playback. @since v3.14 */
+    static bool isLowLatency(const std::string& filePath);
+
     /**
      * Gets playing audio count.
      */
     static int getPlayingAudioCount();
+
+    /**
+     * Sets the byte budget of the decoded audio cached by preload and play2d, 0 for no limit (the default).
+     * Once over budget, the least recently played files which aren't playing are uncached.
+     * @since v3.14
+     */
+    static void setCacheBudget(size_t bytes);
+
+    /** Gets the byte budget of the decoded audio cache. @since v3.14 */
+    static size_t getCacheBudget();
+
+    /**
+     * Sets the file size above which an audio file is streamed instead of decoded to the cache,
+     * 0 to keep the default of each platform.
+     * @since v3.14
+     */
+    static void setStreamingThreshold(size_t fileSize);
+
+    /** Gets the file size above which an audio file is streamed, 0 for the default of each platform. @since v3.14 */
+    static size_t getStreamingThreshold();
+
+    /** Gets the accounting of the decoded audio cache. @since v3.14 */
+    static AudioCacheStats getCacheStats();
+
+    /**
+     * Gets the state of the output of the mixer, e.g. to check its latency and whether it underruns.
+     * On Android 8.0 and later the audio is played with AAudio, with OpenSL ES before.
+     * @since v3.14
+     */
+    static AudioOutputStats getOutputStats();
+
+    /**
+     * Internal method, called by the platform implementations, from any thread, once the decoded data of a file is cached.
+     * @param fullPath The full path of the audio file.
+     * @param bytes The size of the decoded data.
+     */
+    static void onAudioCached(const std::string& fullPath, size_t bytes);
+
+    /**
+     * Internal method, called by the platform implementations to decide whether an audio file is streamed
+     * instead of decoded to the cache.
+     * @param fullPath The full path of the audio file.
+     * @param fileSize The size of the audio file.
+     * @param defaultStreaming Whether the platform streams the file by default.
+     */
+    static bool shouldStream(const std::string& fullPath, long fileSize, bool defaultStreaming);
     
     /**
      * Whether to enable playing audios
@@ -310,6 +474,8 @@ public:
 protected:
     static void addTask(const std::function<void()>& task);
     static void remove(int audioID);
+    static void enforceCacheBudget();
+    static void pumpPreloadBatches();
     
     struct ProfileHelper
     {
@@ -362,6 +528,14 @@ protected:
 
     class AudioEngineThreadPool;
     static AudioEngineThreadPool* s_threadPool;
+
+    class AudioCacheLedger;
+    static AudioCacheLedger* s_cacheLedger;
+
+    struct PreloadBatch;
+    static std::list<std::shared_ptr<PreloadBatch>> _preloadBatches;
+    static unsigned int _preloadsInFlight;
+    static unsigned int _decoderThreadCount;
     
     static bool _isEnabled;
     
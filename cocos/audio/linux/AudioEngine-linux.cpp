@@ -284,7 +284,10 @@ int AudioEngineImpl::preload(const std::string& filePath, std::function<void(boo
     FMOD::Sound * sound = findSound(filePath);
     if (!sound) {
         std::string fullPath = FileUtils::getInstance()->fullPathForFilename(filePath);
-        FMOD_RESULT result = pSystem->createSound(fullPath.c_str(), FMOD_LOOP_OFF, 0, &sound);
+        // the files above the streaming threshold are decoded while they play instead of into memory
+        bool streamed = AudioEngine::shouldStream(fullPath, FileUtils::getInstance()->getFileSize(fullPath), false);
+        FMOD_RESULT result = streamed ? pSystem->createStream(fullPath.c_str(), FMOD_LOOP_OFF, 0, &sound)
+                                      : pSystem->createSound(fullPath.c_str(), FMOD_LOOP_OFF, 0, &sound);
         if (ERRCHECK(result)) {
             printf("sound effect in %s could not be preload\n", filePath.c_str());
             if (callback) {
@@ -293,6 +296,11 @@ int AudioEngineImpl::preload(const std::string& filePath, std::function<void(boo
             return -1;
         }
         mapSound[fullPath] = sound;
+
+        unsigned int pcmBytes = 0;
+        if (!streamed && sound->getLength(&pcmBytes, FMOD_TIMEUNIT_PCMBYTES) == FMOD_OK) {
+            AudioEngine::onAudioCached(fullPath, pcmBytes);
+        }
     }
 
     int id = static_cast<int>(mapChannelInfo.size()) + 1;
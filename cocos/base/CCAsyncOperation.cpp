@@ -0,0 +1,62 @@
+/****************************************************************************
+Copyright (c) 2017 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+
+#include "base/CCAsyncOperation.h"
+
+#include <thread>
+
+#include "base/CCAsyncTaskPool.h"
+#include "base/CCDirector.h"
+#include "base/CCScheduler.h"
+
+NS_CC_BEGIN
+
+void runOnExecutor(AsyncExecutor executor, std::function<void()> function)
+{
+    switch (executor)
+    {
+    case AsyncExecutor::COCOS_THREAD:
+        {
+            auto director = Director::getInstance();
+            if (std::this_thread::get_id() == director->getCocos2dThreadId())
+            {
+                function();
+            }
+            else
+            {
+                director->getScheduler()->performFunctionInCocosThread(std::move(function));
+            }
+        }
+        break;
+    case AsyncExecutor::WORKER:
+        JobSystem::getInstance()->schedule(std::move(function));
+        break;
+    case AsyncExecutor::CURRENT:
+        function();
+        break;
+    }
+}
+
+NS_CC_END
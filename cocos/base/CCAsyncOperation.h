@@ -0,0 +1,323 @@
+/****************************************************************************
+Copyright (c) 2017 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+
+#ifndef __CC_ASYNC_OPERATION_H__
+#define __CC_ASYNC_OPERATION_H__
+
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include "platform/CCPlatformMacros.h"
+
+// co_await and co_return on AsyncOperation, only in the builds with C++20 coroutines
+#if defined(__cpp_impl_coroutine) && __cpp_impl_coroutine >= 201902L
+#define CC_USE_COROUTINES 1
+#include <coroutine>
+#include <exception>
+#else
+#define CC_USE_COROUTINES 0
+#endif
+
+/**
+ * @addtogroup base
+ * @{
+ */
+NS_CC_BEGIN
+
+/** The threads the continuations of an AsyncOperation run on.
+ * @since v3.14
+ */
+enum class AsyncExecutor
+{
+    /** The cocos thread: right away if the operation completes on it, else from Scheduler::performFunctionInCocosThread(). */
+    COCOS_THREAD,
+    /** A worker of the JobSystem. */
+    WORKER,
+    /** The thread completing the operation, without switching threads. */
+    CURRENT
+};
+
+/** Runs a function on an executor, right away for AsyncExecutor::CURRENT.
+ * @since v3.14
+ */
+CC_DLL void runOnExecutor(AsyncExecutor executor, std::function<void()> function);
+
+template <typename T> class AsyncOperation;
+
+/// @cond DO_NOT_SHOW
+// the operation returned by AsyncOperation::then() for a callback returning R
+template <typename R>
+struct AsyncContinuation
+{
+    typedef AsyncOperation<R> Operation;
+
+    template <typename F, typename T>
+    static void run(const Operation& next, F& callback, const T& value) { next.resolve(callback(value)); }
+};
+
+// a callback returning nothing gives an operation completed with true
+template <>
+struct AsyncContinuation<void>
+{
+    typedef AsyncOperation<bool> Operation;
+
+    template <typename F, typename T>
+    static void run(const Operation& next, F& callback, const T& value) { callback(value); next.resolve(true); }
+};
+
+// a callback returning an operation gives an operation completed with its value
+template <typename U>
+struct AsyncContinuation<AsyncOperation<U>>
+{
+    typedef AsyncOperation<U> Operation;
+
+    template <typename F, typename T>
+    static void run(const Operation& next, F& callback, const T& value)
+    {
+        callback(value).then(AsyncExecutor::CURRENT, [next](const U& result) { next.resolve(result); });
+    }
+};
+/// @endcond
+
+/**
+ * @class AsyncOperation
+ * @brief The result of an asynchronous operation, completed once on any thread.
+ *
+ * The continuations added with then() run on the executor they ask for once the value is there, and return an
+ * operation for their own result, so dependent loads are chained without nesting callbacks; with
+ * AsyncExecutor::CURRENT or WORKER, the work after a file read stays off the cocos thread.
+ * AsyncOperation is a shared handle, the copies refer to the same operation.
+ *
+ * When the compiler has C++20 coroutines (CC_USE_COROUTINES), an operation can be awaited with co_await from a
+ * coroutine returning an AsyncOperation, it resumes on the cocos thread or on the executor given to resumeOn():
+ * @code
+ * AsyncOperation<bool> loadLevel()
+ * {
+ *     Data data = co_await FileUtils::getInstance()->getDataFromFileAsync("level.bin").resumeOn(AsyncExecutor::WORKER);
+ *     auto level = parseLevel(data);             // on a worker
+ *     Texture2D* texture = co_await Director::getInstance()->getTextureCache()->addImageAsync(level.background);
+ *     co_return texture != nullptr;              // on the cocos thread
+ * }
+ * @endcode
+ * @param T The value, it must be default constructible and copyable.
+ * @since v3.14
+ * @js NA
+ * @lua NA
+ */
+template <typename T>
+class AsyncOperation
+{
+public:
+    typedef T ValueType;
+
+    AsyncOperation()
+    : _state(std::make_shared<State>())
+    {
+    }
+
+    /** Returns an operation completed with a value. */
+    static AsyncOperation resolved(T value)
+    {
+        AsyncOperation operation;
+        operation.resolve(std::move(value));
+        return operation;
+    }
+
+    /** Completes the operation, only the first call has an effect. The continuations are sent to their executors. */
+    void resolve(T value) const
+    {
+        std::vector<std::function<void()>> continuations;
+        {
+            std::lock_guard<std::mutex> lock(_state->mutex);
+            if (_state->ready)
+                return;
+            _state->value = std::move(value);
+            _state->ready = true;
+            continuations.swap(_state->continuations);
+        }
+        for (auto& continuation : continuations)
+        {
+            continuation();
+        }
+    }
+
+    bool isReady() const
+    {
+        std::lock_guard<std::mutex> lock(_state->mutex);
+        return _state->ready;
+    }
+
+    /** The value, once the operation is ready. */
+    const T& getValue() const { return _state->value; }
+
+    /**
+     * Calls callback(value) on an executor once the operation is ready.
+     * @return An operation completed with the result of the callback; with the value of the operation returned by
+     * the callback if it returns one; with true if it returns nothing.
+     */
+    template <typename F>
+    typename AsyncContinuation<decltype(std::declval<F&>()(std::declval<const T&>()))>::Operation then(AsyncExecutor executor, F callback) const
+    {
+        typedef AsyncContinuation<decltype(std::declval<F&>()(std::declval<const T&>()))> Continuation;
+        typename Continuation::Operation next;
+        auto state = _state;
+        addContinuation(executor, [state, callback, next]() mutable {
+            Continuation::run(next, callback, state->value);
+        });
+        return next;
+    }
+
+    /** Calls callback(value) on the cocos thread once the operation is ready. */
+    template <typename F>
+    typename AsyncContinuation<decltype(std::declval<F&>()(std::declval<const T&>()))>::Operation then(F callback) const
+    {
+        return then(AsyncExecutor::COCOS_THREAD, std::move(callback));
+    }
+
+    /** Runs a function on an executor once the operation is ready. */
+    void addContinuation(AsyncExecutor executor, std::function<void()> function) const
+    {
+        {
+            std::lock_guard<std::mutex> lock(_state->mutex);
+            if (!_state->ready)
+            {
+                _state->continuations.push_back([executor, function]() {
+                    runOnExecutor(executor, function);
+                });
+                return;
+            }
+        }
+        runOnExecutor(executor, std::move(function));
+    }
+
+#if CC_USE_COROUTINES
+    struct Awaiter
+    {
+        AsyncOperation operation;
+        AsyncExecutor executor;
+
+        bool await_ready() const { return executor == AsyncExecutor::CURRENT && operation.isReady(); }
+        void await_suspend(std::coroutine_handle<> handle) const
+        {
+            operation.addContinuation(executor, [handle]() { handle.resume(); });
+        }
+        const T& await_resume() const { return operation.getValue(); }
+    };
+
+    /** Awaits the operation, the coroutine resumes on an executor. */
+    Awaiter resumeOn(AsyncExecutor executor) const { return Awaiter{*this, executor}; }
+    Awaiter operator co_await() const { return resumeOn(AsyncExecutor::COCOS_THREAD); }
+
+    // a coroutine returning an AsyncOperation completes it with co_return
+    struct promise_type
+    {
+        AsyncOperation operation;
+
+        AsyncOperation get_return_object() const { return operation; }
+        std::suspend_never initial_suspend() const noexcept { return {}; }
+        std::suspend_never final_suspend() const noexcept { return {}; }
+        void return_value(T value) const { operation.resolve(std::move(value)); }
+        void unhandled_exception() const { std::terminate(); }
+    };
+#endif
+
+private:
+    struct State
+    {
+        std::mutex mutex;
+        bool ready = false;
+        T value;
+        std::vector<std::function<void()>> continuations;
+    };
+
+    std::shared_ptr<State> _state;
+};
+
+/**
+ * Returns an operation completed with the values of operations once all of them are ready, in the same order.
+ * The operations run meanwhile, e.g. a few files read at once.
+ * @since v3.14
+ */
+template <typename T>
+AsyncOperation<std::vector<T>> whenAll(const std::vector<AsyncOperation<T>>& operations)
+{
+    AsyncOperation<std::vector<T>> all;
+    if (operations.empty())
+    {
+        all.resolve(std::vector<T>());
+        return all;
+    }
+
+    auto pending = std::make_shared<std::pair<std::mutex, size_t>>();
+    pending->second = operations.size();
+    for (auto& operation : operations)
+    {
+        operation.addContinuation(AsyncExecutor::CURRENT, [all, operations, pending]() {
+            {
+                std::lock_guard<std::mutex> lock(pending->first);
+                if (--pending->second > 0)
+                    return;
+            }
+            std::vector<T> values;
+            values.reserve(operations.size());
+            for (auto& done : operations)
+            {
+                values.push_back(done.getValue());
+            }
+            all.resolve(std::move(values));
+        });
+    }
+    return all;
+}
+
+#if CC_USE_COROUTINES
+/// @cond DO_NOT_SHOW
+struct ExecutorAwaiter
+{
+    AsyncExecutor executor;
+
+    bool await_ready() const { return executor == AsyncExecutor::CURRENT; }
+    void await_suspend(std::coroutine_handle<> handle) const
+    {
+        runOnExecutor(executor, [handle]() { handle.resume(); });
+    }
+    void await_resume() const {}
+};
+/// @endcond
+
+/** co_await switchToExecutor(executor) resumes the coroutine on an executor. @since v3.14 */
+inline ExecutorAwaiter switchToExecutor(AsyncExecutor executor) { return ExecutorAwaiter{executor}; }
+#endif
+
+NS_CC_END
+/**
+ * @}
+ */
+
+#endif // __CC_ASYNC_OPERATION_H__
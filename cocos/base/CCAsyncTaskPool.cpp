@@ -24,9 +24,304 @@ THE SOFTWARE.
 ****************************************************************************/
 
 #include "base/CCAsyncTaskPool.h"
+#include "base/CCProfiling.h"
+#include "base/ccUTF8.h"
+
+#include <algorithm>
+#include <deque>
 
 NS_CC_BEGIN
 
+// JobSystem
+
+struct JobSystem::Job
+{
+    std::function<void()>   function;
+    std::atomic<int>        pendingDependencies;
+    std::atomic<bool>       finished;
+    bool                    cocosThread;
+    std::mutex              mutex;          // guards continuations
+    std::vector<JobHandle>  continuations;  // jobs waiting for this one
+};
+
+struct JobSystem::Worker
+{
+    std::thread             thread;
+    std::mutex              mutex;
+    std::deque<JobHandle>   jobs;           // the owner works at the back, thieves steal from the front
+};
+
+JobSystem* JobSystem::s_jobSystem = nullptr;
+
+// index of the worker running on this thread, -1 for the threads outside the pool
+static thread_local int s_jobWorkerIndex = -1;
+
+JobSystem* JobSystem::getInstance()
+{
+    if (s_jobSystem == nullptr)
+    {
+        s_jobSystem = new (std::nothrow) JobSystem();
+    }
+    return s_jobSystem;
+}
+
+void JobSystem::destroyInstance()
+{
+    delete s_jobSystem;
+    s_jobSystem = nullptr;
+}
+
+JobSystem::JobSystem()
+: _queuedJobs(0)
+, _nextWorker(0)
+, _stop(false)
+{
+    // leave a core to the cocos thread, but keep two workers so that blocking io can't starve the pool
+    const unsigned int concurrency = std::thread::hardware_concurrency();
+    const unsigned int count = std::max(2u, concurrency > 1 ? concurrency - 1 : 1u);
+
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        _workers.push_back(std::unique_ptr<Worker>(new (std::nothrow) Worker()));
+    }
+    // start the threads once all the queues exist, they steal from each other
+    for (unsigned int i = 0; i < count; ++i)
+    {
+        _workers[i]->thread = std::thread(&JobSystem::workerLoop, this, (int)i);
+    }
+}
+
+JobSystem::~JobSystem()
+{
+    {
+        std::lock_guard<std::mutex> lock(_sleepMutex);
+        _stop = true;
+    }
+    _sleepCondition.notify_all();
+
+    for (auto& worker : _workers)
+    {
+        worker->thread.join();
+    }
+}
+
+JobSystem::JobHandle JobSystem::schedule(std::function<void()> job)
+{
+    return schedule(std::move(job), std::vector<JobHandle>());
+}
+
+JobSystem::JobHandle JobSystem::schedule(std::function<void()> job, const std::vector<JobHandle>& dependencies)
+{
+    return addJob(std::move(job), dependencies, false);
+}
+
+JobSystem::JobHandle JobSystem::scheduleOnCocosThread(std::function<void()> job, const std::vector<JobHandle>& dependencies)
+{
+    return addJob(std::move(job), dependencies, true);
+}
+
+JobSystem::JobHandle JobSystem::addJob(std::function<void()> job, const std::vector<JobHandle>& dependencies, bool cocosThread)
+{
+    JobHandle handle = std::make_shared<Job>();
+    handle->function = std::move(job);
+    handle->finished = false;
+    handle->cocosThread = cocosThread;
+
+    // one extra dependency so that the job can't be submitted before all the dependencies are registered
+    handle->pendingDependencies = (int)dependencies.size() + 1;
+    for (const auto& dependency : dependencies)
+    {
+        std::unique_lock<std::mutex> lock(dependency->mutex);
+        if (dependency->finished.load(std::memory_order_acquire))
+        {
+            lock.unlock();
+            handle->pendingDependencies.fetch_sub(1, std::memory_order_acq_rel);
+        }
+        else
+        {
+            dependency->continuations.push_back(handle);
+        }
+    }
+
+    if (handle->pendingDependencies.fetch_sub(1, std::memory_order_acq_rel) == 1)
+    {
+        submit(handle);
+    }
+    return handle;
+}
+
+bool JobSystem::isFinished(const JobHandle& job) const
+{
+    return job->finished.load(std::memory_order_acquire);
+}
+
+void JobSystem::wait(const JobHandle& job)
+{
+    while (!job->finished.load(std::memory_order_acquire))
+    {
+        if (!runPendingJob(s_jobWorkerIndex))
+        {
+            std::this_thread::yield();
+        }
+    }
+}
+
+void JobSystem::parallelFor(size_t count, size_t grainSize, const std::function<void(size_t, size_t)>& body)
+{
+    if (count == 0)
+    {
+        return;
+    }
+
+    grainSize = std::max(grainSize, (size_t)1);
+    const size_t chunks = (count + grainSize - 1) / grainSize;
+
+    std::vector<JobHandle> jobs;
+    jobs.reserve(chunks - 1);
+    for (size_t chunk = 1; chunk < chunks; ++chunk)
+    {
+        const size_t begin = chunk * grainSize;
+        const size_t end = std::min(count, begin + grainSize);
+        jobs.push_back(schedule([&body, begin, end]() {
+            body(begin, end);
+        }));
+    }
+
+    body(0, std::min(count, grainSize));
+
+    for (const auto& job : jobs)
+    {
+        wait(job);
+    }
+}
+
+void JobSystem::submit(const JobHandle& job)
+{
+    if (job->cocosThread)
+    {
+        Director::getInstance()->getScheduler()->performFunctionInCocosThread([this, job]() {
+            execute(job);
+        });
+        return;
+    }
+
+    // jobs submitted by a worker stay on its queue, the others are spread round robin
+    int index = s_jobWorkerIndex;
+    if (index < 0)
+    {
+        index = (int)(_nextWorker.fetch_add(1, std::memory_order_relaxed) % _workers.size());
+    }
+
+    {
+        Worker* worker = _workers[index].get();
+        std::lock_guard<std::mutex> lock(worker->mutex);
+        worker->jobs.push_back(job);
+    }
+
+    _queuedJobs.fetch_add(1, std::memory_order_release);
+    {
+        // an idle worker checks _queuedJobs under this lock, so the notification can't be missed
+        std::lock_guard<std::mutex> lock(_sleepMutex);
+    }
+    _sleepCondition.notify_one();
+}
+
+void JobSystem::execute(const JobHandle& job)
+{
+    job->function();
+    job->function = nullptr;
+
+    std::vector<JobHandle> continuations;
+    {
+        std::lock_guard<std::mutex> lock(job->mutex);
+        job->finished.store(true, std::memory_order_release);
+        continuations.swap(job->continuations);
+    }
+
+    for (const auto& continuation : continuations)
+    {
+        if (continuation->pendingDependencies.fetch_sub(1, std::memory_order_acq_rel) == 1)
+        {
+            submit(continuation);
+        }
+    }
+}
+
+JobSystem::JobHandle JobSystem::takeJob(int workerIndex)
+{
+    const int count = (int)_workers.size();
+
+    // newest job of our own queue first, it is the most likely to be in the cache
+    if (workerIndex >= 0)
+    {
+        Worker* worker = _workers[workerIndex].get();
+        std::lock_guard<std::mutex> lock(worker->mutex);
+        if (!worker->jobs.empty())
+        {
+            JobHandle job = std::move(worker->jobs.back());
+            worker->jobs.pop_back();
+            _queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+            return job;
+        }
+    }
+
+    // then steal the oldest job of another worker
+    const int start = workerIndex >= 0 ? workerIndex + 1 : (int)(_nextWorker.load(std::memory_order_relaxed) % count);
+    for (int i = 0; i < count; ++i)
+    {
+        const int victimIndex = (start + i) % count;
+        if (victimIndex == workerIndex)
+        {
+            continue;
+        }
+
+        Worker* victim = _workers[victimIndex].get();
+        std::lock_guard<std::mutex> lock(victim->mutex);
+        if (!victim->jobs.empty())
+        {
+            JobHandle job = std::move(victim->jobs.front());
+            victim->jobs.pop_front();
+            _queuedJobs.fetch_sub(1, std::memory_order_relaxed);
+            return job;
+        }
+    }
+
+    return nullptr;
+}
+
+bool JobSystem::runPendingJob(int workerIndex)
+{
+    JobHandle job = takeJob(workerIndex);
+    if (!job)
+    {
+        return false;
+    }
+
+    execute(job);
+    return true;
+}
+
+void JobSystem::workerLoop(int workerIndex)
+{
+    s_jobWorkerIndex = workerIndex;
+    TraceProfiler::getInstance()->setCurrentThreadName(StringUtils::format("JobSystem worker %d", workerIndex));
+
+    while (!_stop.load(std::memory_order_acquire))
+    {
+        if (runPendingJob(workerIndex))
+        {
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(_sleepMutex);
+        _sleepCondition.wait(lock, [this]() {
+            return _stop.load(std::memory_order_acquire) || _queuedJobs.load(std::memory_order_acquire) > 0;
+        });
+    }
+}
+
+// AsyncTaskPool
+
 AsyncTaskPool* AsyncTaskPool::s_asyncTaskPool = nullptr;
 
 AsyncTaskPool* AsyncTaskPool::getInstance()
@@ -45,11 +340,59 @@ void AsyncTaskPool::destroyInstance()
 }
 
 AsyncTaskPool::AsyncTaskPool()
+: _state(std::make_shared<TaskState>())
 {
+    for (auto& generation : _state->generations)
+    {
+        generation = 0;
+    }
+    _state->runningTasks = 0;
 }
 
 AsyncTaskPool::~AsyncTaskPool()
 {
+    // drop the tasks that haven't started
+    for (auto& generation : _state->generations)
+    {
+        generation.fetch_add(1, std::memory_order_acq_rel);
+    }
+
+    // and let the running ones finish, as joining the task threads used to do
+    while (_state->runningTasks.load(std::memory_order_acquire) > 0)
+    {
+        std::this_thread::yield();
+    }
+}
+
+void AsyncTaskPool::stopTasks(TaskType type)
+{
+    _state->generations[(int)type].fetch_add(1, std::memory_order_acq_rel);
+}
+
+void AsyncTaskPool::enqueue(AsyncTaskPool::TaskType type, TaskCallBack callback, void* callbackParam, std::function<void()> task)
+{
+    auto state = _state;
+    const int index = (int)type;
+    const unsigned int generation = state->generations[index].load(std::memory_order_acquire);
+
+    // a task of a type waits for the previous one of the type, the callers rely on it not to race with each other
+    std::lock_guard<std::mutex> lock(_lastJobsMutex);
+    std::vector<JobSystem::JobHandle> dependencies;
+    if (_lastJobs[index])
+    {
+        dependencies.push_back(_lastJobs[index]);
+    }
+
+    _lastJobs[index] = JobSystem::getInstance()->schedule([state, index, generation, callback, callbackParam, task]() {
+        // counted before the check so that the destructor can't miss a task about to run
+        state->runningTasks.fetch_add(1, std::memory_order_acq_rel);
+        if (state->generations[index].load(std::memory_order_acquire) == generation)
+        {
+            task();
+            Director::getInstance()->getScheduler()->performFunctionInCocosThread(std::bind(callback, callbackParam));
+        }
+        state->runningTasks.fetch_sub(1, std::memory_order_acq_rel);
+    }, dependencies);
 }
 
 NS_CC_END
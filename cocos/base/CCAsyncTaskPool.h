@@ -28,6 +28,7 @@ THE SOFTWARE.
 #include "platform/CCPlatformMacros.h"
 #include "base/CCDirector.h"
 #include "base/CCScheduler.h"
+#include <atomic>
 #include <vector>
 #include <queue>
 #include <memory>
@@ -45,9 +46,105 @@ THE SOFTWARE.
 NS_CC_BEGIN
 
 
+/**
+ * @class JobSystem
+ * @brief Runs jobs on a pool of worker threads sized to the hardware concurrency.
+ *
+ * Every worker owns a queue. It runs its own jobs newest first and, when it runs dry, steals the
+ * oldest jobs of the other workers. Jobs can depend on other jobs, continuations can be sent back
+ * to the cocos thread, and a thread waiting for a job runs other jobs meanwhile.
+ * @js NA
+ * @lua NA
+ */
+class CC_DLL JobSystem
+{
+public:
+    struct Job;
+    typedef std::shared_ptr<Job> JobHandle;
+
+    /**
+     * Returns the shared instance of the job system, the workers are started on first use.
+     */
+    static JobSystem* getInstance();
+
+    /**
+     * Stops the workers. Jobs that haven't started are dropped.
+     */
+    static void destroyInstance();
+
+    /** Returns the number of worker threads. */
+    unsigned int getWorkerCount() const { return (unsigned int)_workers.size(); }
+
+    /**
+     * Runs a job on a worker thread.
+     *
+     * @param job The function to run.
+     * @return A handle to wait for the job or to make other jobs depend on it.
+     */
+    JobHandle schedule(std::function<void()> job);
+
+    /**
+     * Runs a job on a worker thread once all its dependencies have run.
+     *
+     * @param job The function to run.
+     * @param dependencies The jobs that must have run before.
+     */
+    JobHandle schedule(std::function<void()> job, const std::vector<JobHandle>& dependencies);
+
+    /**
+     * Runs a job on the cocos thread, from Scheduler::update(), once all its dependencies have run.
+     *
+     * @param job The function to run.
+     * @param dependencies The jobs that must have run before.
+     */
+    JobHandle scheduleOnCocosThread(std::function<void()> job, const std::vector<JobHandle>& dependencies);
+
+    /** Returns whether the job has run. */
+    bool isFinished(const JobHandle& job) const;
+
+    /**
+     * Blocks until the job has run, running other jobs meanwhile.
+     * Don't wait for a cocos thread job from the cocos thread.
+     */
+    void wait(const JobHandle& job);
+
+    /**
+     * Calls body(begin, end) in parallel on ranges of at most grainSize indices covering [0, count),
+     * and returns once all of them have run. The calling thread takes a share of the work.
+     */
+    void parallelFor(size_t count, size_t grainSize, const std::function<void(size_t, size_t)>& body);
+
+CC_CONSTRUCTOR_ACCESS:
+    JobSystem();
+    ~JobSystem();
+
+protected:
+    struct Worker;
+
+    JobHandle addJob(std::function<void()> job, const std::vector<JobHandle>& dependencies, bool cocosThread);
+    void submit(const JobHandle& job);
+    void execute(const JobHandle& job);
+    JobHandle takeJob(int workerIndex);
+    bool runPendingJob(int workerIndex);
+    void workerLoop(int workerIndex);
+
+    std::vector<std::unique_ptr<Worker>> _workers;
+
+    // idle workers sleep until a job is queued
+    std::mutex _sleepMutex;
+    std::condition_variable _sleepCondition;
+    std::atomic<int> _queuedJobs;
+    std::atomic<unsigned int> _nextWorker;
+    std::atomic<bool> _stop;
+
+    static JobSystem* s_jobSystem;
+};
+
 /**
  * @class AsyncTaskPool
  * @brief This class allows to perform background operations without having to manipulate threads.
+ * The tasks run on the workers of the JobSystem. Tasks of a type still run one after the other, in the order they
+ * were enqueued, as they did on the thread of their type, while tasks of different types run in parallel.
  * @js NA
  */
 class CC_DLL AsyncTaskPool
@@ -78,6 +175,7 @@ public:
     
     /**
      * Stop tasks.
+     * Tasks of this type that haven't started yet are dropped.
      *
      * @param type Task type you want to stop.
      */
@@ -86,7 +184,7 @@ public:
     /**
      * Enqueue a asynchronous task.
      *
-     * @param type task type is io task, network task or others, each type of task has a thread to deal with it.
+     * @param type task type is io task, network task or others, stopTasks() stops the tasks of a type.
      * @param callback callback when the task is finished. The callback is called in the main thread instead of task thread.
      * @param callbackParam parameter used by the callback.
      * @param task: task can be lambda function to be performed off thread.
@@ -97,7 +195,7 @@ public:
     /**
     * Enqueue a asynchronous task.
     *
-    * @param type task type is io task, network task or others, each type of task has a thread to deal with it.
+    * @param type task type is io task, network task or others, stopTasks() stops the tasks of a type.
     * @param task: task can be lambda function to be performed off thread.
     * @lua NA
     */
@@ -109,119 +207,22 @@ CC_CONSTRUCTOR_ACCESS:
     
 protected:
     
-    // thread tasks internally used
-    class ThreadTasks {
-        struct AsyncTaskCallBack
-        {
-            TaskCallBack          callback;
-            void*                 callbackParam;
-        };
-    public:
-        ThreadTasks()
-        : _stop(false)
-        {
-            _thread = std::thread(
-                                  [this]
-                                  {
-                                      for(;;)
-                                      {
-                                          std::function<void()> task;
-                                          AsyncTaskCallBack callback;
-                                          {
-                                              std::unique_lock<std::mutex> lock(this->_queueMutex);
-                                              this->_condition.wait(lock,
-                                                                    [this]{ return this->_stop || !this->_tasks.empty(); });
-                                              if(this->_stop && this->_tasks.empty())
-                                                  return;
-                                              task = std::move(this->_tasks.front());
-                                              callback = std::move(this->_taskCallBacks.front());
-                                              this->_tasks.pop();
-                                              this->_taskCallBacks.pop();
-                                          }
-                                          
-                                          task();
-                                          Director::getInstance()->getScheduler()->performFunctionInCocosThread(std::bind(callback.callback, callback.callbackParam));
-                                      }
-                                  }
-                                  );
-        }
-        ~ThreadTasks()
-        {
-            {
-                std::unique_lock<std::mutex> lock(_queueMutex);
-                _stop = true;
-                
-                while(_tasks.size())
-                    _tasks.pop();
-                while (_taskCallBacks.size())
-                    _taskCallBacks.pop();
-            }
-            _condition.notify_all();
-            _thread.join();
-        }
-        void clear()
-        {
-            std::unique_lock<std::mutex> lock(_queueMutex);
-            while(_tasks.size())
-                _tasks.pop();
-            while (_taskCallBacks.size())
-                _taskCallBacks.pop();
-        }
-
-        void enqueue(TaskCallBack callback, void* callbackParam, std::function<void()> task)
-        {
-            AsyncTaskCallBack taskCallBack;
-            taskCallBack.callback = std::move(callback);
-            taskCallBack.callbackParam = callbackParam;
-
-            {
-                std::unique_lock<std::mutex> lock(_queueMutex);
-                
-                // don't allow enqueueing after stopping the pool
-                if(_stop)
-                {
-                    CC_ASSERT(0 && "already stop");
-                    return;
-                }
-                
-                _tasks.push(std::move(task));
-                _taskCallBacks.push(std::move(taskCallBack));
-            }
-            _condition.notify_one();
-        }
-    private:
-        
-        // need to keep track of thread so we can join them
-        std::thread _thread;
-        // the task queue
-        std::queue< std::function<void()> > _tasks;
-        std::queue<AsyncTaskCallBack> _taskCallBacks;
-        
-        // synchronization
-        std::mutex _queueMutex;
-        std::condition_variable _condition;
-        bool _stop;
+    // state shared with the queued jobs, which may outlive the pool
+    struct TaskState
+    {
+        // bumped by stopTasks(), tasks enqueued before are dropped
+        std::atomic<unsigned int> generations[int(TaskType::TASK_MAX_TYPE)];
+        std::atomic<int> runningTasks;
     };
+    std::shared_ptr<TaskState> _state;
     
-    //tasks
-    ThreadTasks _threadTasks[int(TaskType::TASK_MAX_TYPE)];
+    // the last job enqueued of each type, the next one of the type depends on it
+    JobSystem::JobHandle _lastJobs[int(TaskType::TASK_MAX_TYPE)];
+    std::mutex _lastJobsMutex;
     
     static AsyncTaskPool* s_asyncTaskPool;
 };
 
-inline void AsyncTaskPool::stopTasks(TaskType type)
-{
-    auto& threadTask = _threadTasks[(int)type];
-    threadTask.clear();
-}
-
-inline void AsyncTaskPool::enqueue(AsyncTaskPool::TaskType type, TaskCallBack callback, void* callbackParam, std::function<void()> task)
-{
-    auto& threadTask = _threadTasks[(int)type];
-    
-    threadTask.enqueue(std::move(callback), callbackParam, std::move(task));
-}
-
 inline void AsyncTaskPool::enqueue(AsyncTaskPool::TaskType type, std::function<void()> task)
 {
     enqueue(type, [](void*) {}, nullptr, std::move(task));
@@ -24,11 +24,15 @@ THE SOFTWARE.
 ****************************************************************************/
 #include "base/CCAutoreleasePool.h"
 #include "base/ccMacros.h"
+#include <algorithm>
+#include <typeinfo>
 
 NS_CC_BEGIN
 
 AutoreleasePool::AutoreleasePool()
 : _name("")
+, _statisticsEnabled(false)
+, _lastClearCount(0)
 #if defined(COCOS2D_DEBUG) && (COCOS2D_DEBUG > 0)
 , _isClearing(false)
 #endif
@@ -39,6 +43,8 @@ AutoreleasePool::AutoreleasePool()
 
 AutoreleasePool::AutoreleasePool(const std::string &name)
 : _name(name)
+, _statisticsEnabled(false)
+, _lastClearCount(0)
 #if defined(COCOS2D_DEBUG) && (COCOS2D_DEBUG > 0)
 , _isClearing(false)
 #endif
@@ -58,6 +64,25 @@ AutoreleasePool::~AutoreleasePool()
 void AutoreleasePool::addObject(Ref* object)
 {
     _managedObjectArray.push_back(object);
+    if (_statisticsEnabled)
+    {
+        ++_typeCounts[std::type_index(typeid(*object))];
+    }
+}
+
+bool AutoreleasePool::takeLastObject(Ref* object)
+{
+    if (_managedObjectArray.empty() || _managedObjectArray.back() != object)
+        return false;
+
+    _managedObjectArray.pop_back();
+    if (_statisticsEnabled)
+    {
+        auto iter = _typeCounts.find(std::type_index(typeid(*object)));
+        if (iter != _typeCounts.end() && --iter->second == 0)
+            _typeCounts.erase(iter);
+    }
+    return true;
 }
 
 void AutoreleasePool::clear()
@@ -67,6 +92,9 @@ void AutoreleasePool::clear()
 #endif
     std::vector<Ref*> releasings;
     releasings.swap(_managedObjectArray);
+    _lastClearCount = releasings.size();
+    _lastClearTypeCounts.clear();
+    _lastClearTypeCounts.swap(_typeCounts);
     for (const auto &obj : releasings)
     {
         obj->release();
@@ -86,6 +114,27 @@ bool AutoreleasePool::contains(Ref* object) const
     return false;
 }
 
+void AutoreleasePool::setStatisticsEnabled(bool enabled)
+{
+    _statisticsEnabled = enabled;
+    _typeCounts.clear();
+    _lastClearTypeCounts.clear();
+}
+
+std::vector<std::pair<std::string, unsigned int>> AutoreleasePool::getLastClearStatistics() const
+{
+    std::vector<std::pair<std::string, unsigned int>> ret;
+    ret.reserve(_lastClearTypeCounts.size());
+    for (const auto& iter : _lastClearTypeCounts)
+    {
+        ret.push_back(std::make_pair(std::string(iter.first.name()), iter.second));
+    }
+    std::sort(ret.begin(), ret.end(), [](const std::pair<std::string, unsigned int>& a, const std::pair<std::string, unsigned int>& b) {
+        return a.second > b.second;
+    });
+    return ret;
+}
+
 void AutoreleasePool::dump()
 {
     CCLOG("autorelease pool: %s, number of managed object %d\n", _name.c_str(), static_cast<int>(_managedObjectArray.size()));
@@ -94,6 +143,14 @@ void AutoreleasePool::dump()
     {
         CCLOG("%20p%20u\n", obj, obj->getReferenceCount());
     }
+    if (_statisticsEnabled)
+    {
+        CCLOG("objects released by the last clear: %d", static_cast<int>(_lastClearCount));
+        for (const auto& iter : getLastClearStatistics())
+        {
+            CCLOG("%40s%10u", iter.first.c_str(), iter.second);
+        }
+    }
 }
 
 
@@ -27,6 +27,8 @@ THE SOFTWARE.
 
 #include <vector>
 #include <string>
+#include <typeindex>
+#include <unordered_map>
 #include "base/CCRef.h"
 
 /**
@@ -79,6 +81,18 @@ public:
      */
     void addObject(Ref *object);
 
+    /**
+     * Takes back the object added last, so its reference is owned by the caller again and is not released by
+     * the pool. Used by createRefPtr() to keep the objects it creates out of the pool.
+     *
+     * @param object    The object expected to be the last one added.
+     * @return True if object was the last object added and was removed, false if the pool is unchanged.
+     * @js NA
+     * @lua NA
+     * @since v3.14
+     */
+    bool takeLastObject(Ref *object);
+
     /**
      * Clear the autorelease pool.
      *
@@ -111,6 +125,42 @@ public:
      */
     bool contains(Ref* object) const;
 
+    /**
+     * Enables counting the added objects by type. The counts of the objects released by the last `clear()`
+     * are returned by `getLastClearStatistics()`. Disabled by default.
+     *
+     * @js NA
+     * @lua NA
+     * @since v3.14
+     */
+    void setStatisticsEnabled(bool enabled);
+
+    /**
+     * @js NA
+     * @lua NA
+     * @since v3.14
+     */
+    bool isStatisticsEnabled() const { return _statisticsEnabled; }
+
+    /**
+     * Number of objects released by the last `clear()`, which is one frame for the pool of the engine.
+     *
+     * @js NA
+     * @lua NA
+     * @since v3.14
+     */
+    size_t getLastClearCount() const { return _lastClearCount; }
+
+    /**
+     * Objects released by the last `clear()` grouped by type name, the most frequent first.
+     * Empty unless statistics are enabled.
+     *
+     * @js NA
+     * @lua NA
+     * @since v3.14
+     */
+    std::vector<std::pair<std::string, unsigned int>> getLastClearStatistics() const;
+
     /**
      * Dump the objects that are put into the autorelease pool. It is used for debugging.
      *
@@ -134,6 +184,11 @@ private:
      */
     std::vector<Ref*> _managedObjectArray;
     std::string _name;
+
+    bool _statisticsEnabled;
+    size_t _lastClearCount;
+    std::unordered_map<std::type_index, unsigned int> _typeCounts;
+    std::unordered_map<std::type_index, unsigned int> _lastClearTypeCounts;
     
 #if defined(COCOS2D_DEBUG) && (COCOS2D_DEBUG > 0)
     /**
@@ -52,6 +52,13 @@ Configuration::Configuration()
 , _supportsOESDepth24(false)
 , _supportsOESPackedDepthStencil(false)
 , _supportsOESMapBuffer(false)
+, _supportsMapBufferRange(false)
+, _supportsSyncObjects(false)
+, _supportsInstancing(false)
+, _supportsTimerQuery(false)
+, _supportsOcclusionQuery(false)
+, _supportsProgramBinary(false)
+, _supportsBoneTexture(false)
 , _maxSamplesAllowed(0)
 , _maxTextureUnits(0)
 , _glExtensions(nullptr)
@@ -160,6 +167,69 @@ void Configuration::gatherGPUInfo()
     _supportsOESMapBuffer = checkForGLExtension("GL_OES_mapbuffer");
     _valueDict["gl.supports_OES_map_buffer"] = Value(_supportsOESMapBuffer);
 
+#ifdef CC_PLATFORM_PC
+    _supportsMapBufferRange = checkForGLExtension("GL_ARB_map_buffer_range");
+    _supportsSyncObjects = checkForGLExtension("GL_ARB_sync");
+#else
+    _supportsMapBufferRange = checkForGLExtension("GL_EXT_map_buffer_range");
+    _supportsSyncObjects = checkForGLExtension("GL_APPLE_sync");
+#endif
+    _valueDict["gl.supports_map_buffer_range"] = Value(_supportsMapBufferRange);
+    _valueDict["gl.supports_sync_objects"] = Value(_supportsSyncObjects);
+
+#ifdef CC_PLATFORM_PC
+    _supportsInstancing = checkForGLExtension("GL_ARB_instanced_arrays") && checkForGLExtension("GL_ARB_draw_instanced");
+#else
+    _supportsInstancing = checkForGLExtension("GL_EXT_instanced_arrays");
+#endif
+    _valueDict["gl.supports_instancing"] = Value(_supportsInstancing);
+
+#ifdef CC_PLATFORM_PC
+    _supportsTimerQuery = checkForGLExtension("GL_ARB_timer_query");
+#else
+    _supportsTimerQuery = checkForGLExtension("GL_EXT_disjoint_timer_query");
+#endif
+    _valueDict["gl.supports_timer_query"] = Value(_supportsTimerQuery);
+
+#ifdef CC_PLATFORM_PC
+    _supportsOcclusionQuery = checkForGLExtension("GL_ARB_occlusion_query");
+#else
+    _supportsOcclusionQuery = checkForGLExtension("GL_EXT_occlusion_query_boolean");
+#endif
+    _valueDict["gl.supports_occlusion_query"] = Value(_supportsOcclusionQuery);
+
+#ifdef CC_PLATFORM_PC
+    _supportsProgramBinary = checkForGLExtension("GL_ARB_get_program_binary");
+#else
+    _supportsProgramBinary = checkForGLExtension("GL_OES_get_program_binary");
+#endif
+#ifdef GL_NUM_PROGRAM_BINARY_FORMATS
+    if (_supportsProgramBinary)
+    {
+        // some drivers expose the extension without any binary format
+        GLint numFormats = 0;
+        glGetIntegerv(GL_NUM_PROGRAM_BINARY_FORMATS, &numFormats);
+        _supportsProgramBinary = numFormats > 0;
+    }
+#else
+    _supportsProgramBinary = false;
+#endif
+    _valueDict["gl.supports_program_binary"] = Value(_supportsProgramBinary);
+
+#ifdef CC_PLATFORM_PC
+    _supportsBoneTexture = checkForGLExtension("GL_ARB_texture_float");
+#else
+    _supportsBoneTexture = checkForGLExtension("GL_OES_texture_float");
+#endif
+    if (_supportsBoneTexture)
+    {
+        // the palettes are fetched by the vertex shader
+        GLint vertexTextureUnits = 0;
+        glGetIntegerv(GL_MAX_VERTEX_TEXTURE_IMAGE_UNITS, &vertexTextureUnits);
+        _supportsBoneTexture = vertexTextureUnits > 0;
+    }
+    _valueDict["gl.supports_bone_texture"] = Value(_supportsBoneTexture);
+
     _supportsOESDepth24 = checkForGLExtension("GL_OES_depth24");
     _valueDict["gl.supports_OES_depth24"] = Value(_supportsOESDepth24);
 
@@ -294,6 +364,88 @@ bool Configuration::supportsMapBuffer() const
 #endif
 }
 
+bool Configuration::supportsMapBufferRange() const
+{
+    return _supportsMapBufferRange;
+}
+
+bool Configuration::supportsSyncObjects() const
+{
+    return _supportsSyncObjects;
+}
+
+bool Configuration::supportsInstancing() const
+{
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WINRT || CC_TARGET_PLATFORM == CC_PLATFORM_TIZEN)
+    return false;
+#else
+    return _supportsInstancing;
+#endif
+}
+
+bool Configuration::supportsTimerQuery() const
+{
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WINRT || CC_TARGET_PLATFORM == CC_PLATFORM_TIZEN)
+    return false;
+#else
+    return _supportsTimerQuery;
+#endif
+}
+
+bool Configuration::supportsOcclusionQuery() const
+{
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WINRT || CC_TARGET_PLATFORM == CC_PLATFORM_TIZEN)
+    return false;
+#else
+    return _supportsOcclusionQuery;
+#endif
+}
+
+bool Configuration::supportsProgramBinary() const
+{
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WINRT || CC_TARGET_PLATFORM == CC_PLATFORM_TIZEN)
+    return false;
+#else
+    return _supportsProgramBinary;
+#endif
+}
+
+bool Configuration::supportsBoneTexture() const
+{
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WINRT || CC_TARGET_PLATFORM == CC_PLATFORM_TIZEN)
+    return false;
+#else
+    return _supportsBoneTexture;
+#endif
+}
+
+bool Configuration::useRendererRingBuffer() const
+{
+    auto iter = _valueDict.find("cocos2d.x.renderer.ring_buffer");
+    if (iter != _valueDict.cend())
+        return iter->second.asBool();
+
+    return false;
+}
+
+bool Configuration::useRendererMultiTextureBatching() const
+{
+    auto iter = _valueDict.find("cocos2d.x.renderer.multi_texture_batching");
+    if (iter != _valueDict.cend())
+        return iter->second.asBool();
+
+    return false;
+}
+
+bool Configuration::useProgramBinaryCache() const
+{
+    auto iter = _valueDict.find("cocos2d.x.program_binary_cache");
+    if (iter != _valueDict.cend())
+        return iter->second.asBool();
+
+    return false;
+}
+
 bool Configuration::supportsOESDepth24() const
 {
     return _supportsOESDepth24;
@@ -170,6 +170,110 @@ public:
      */
     bool supportsMapBuffer() const;
 
+    /** Whether or not glMapBufferRange() is supported.
+     *
+     * On Desktop it checks for `GL_ARB_map_buffer_range`.
+     * On Mobile it checks for the extension `GL_EXT_map_buffer_range`
+     *
+     * @return Whether or not `glMapBufferRange()` is supported.
+     * @since v3.14
+     */
+    bool supportsMapBufferRange() const;
+
+    /** Whether or not GPU fence sync objects (glFenceSync()) are supported.
+     *
+     * On Desktop it checks for `GL_ARB_sync`.
+     * On iOS it checks for the extension `GL_APPLE_sync`
+     *
+     * @return Whether or not sync objects are supported.
+     * @since v3.14
+     */
+    bool supportsSyncObjects() const;
+
+    /** Whether or not hardware instancing (glVertexAttribDivisor() and glDrawElementsInstanced()) is supported.
+     *
+     * On Desktop it checks for `GL_ARB_instanced_arrays` and `GL_ARB_draw_instanced`.
+     * On Mobile it checks for the extension `GL_EXT_instanced_arrays`
+     *
+     * @return Whether or not instanced draws are supported.
+     * @since v3.14
+     */
+    bool supportsInstancing() const;
+
+    /** Whether or not GPU timestamp queries (glQueryCounter(GL_TIMESTAMP)) are supported.
+     *
+     * On Desktop it checks for `GL_ARB_timer_query`.
+     * On Mobile it checks for the extension `GL_EXT_disjoint_timer_query`
+     *
+     * @return Whether or not GPU timer queries are supported.
+     * @since v3.14
+     */
+    bool supportsTimerQuery() const;
+
+    /** Whether or not GPU occlusion queries (glBeginQuery(GL_SAMPLES_PASSED)) are supported.
+     *
+     * On Desktop it checks for `GL_ARB_occlusion_query`.
+     * On Mobile it checks for the extension `GL_EXT_occlusion_query_boolean`
+     *
+     * @return Whether or not occlusion queries are supported.
+     * @since v3.14
+     */
+    bool supportsOcclusionQuery() const;
+
+    /** Whether or not linked programs can be saved and restored (glGetProgramBinary() and glProgramBinary()).
+     *
+     * On Desktop it checks for `GL_ARB_get_program_binary`.
+     * On Mobile it checks for the extension `GL_OES_get_program_binary`.
+     * It is `false` when the driver reports no binary format.
+     *
+     * @return Whether or not program binaries are supported.
+     * @since v3.14
+     */
+    bool supportsProgramBinary() const;
+
+    /** Whether or not skinning palettes can be read from a float texture by the vertex shader.
+     *
+     * On Desktop it checks for `GL_ARB_texture_float`.
+     * On Mobile it checks for the extension `GL_OES_texture_float`.
+     * It is `false` when the vertex shader can't sample textures.
+     *
+     * @return Whether or not bone matrix textures are supported.
+     * @since v3.14
+     */
+    bool supportsBoneTexture() const;
+
+    /** Whether or not the renderer should stream batched triangles through a ring buffer.
+     *
+     * Controlled by the `cocos2d.x.renderer.ring_buffer` key (default: `false`).
+     * It only takes effect when `supportsMapBufferRange()` is `true`, and it must be set
+     * before the GLView is created.
+     *
+     * @return Whether or not the ring buffer upload mode is requested.
+     * @since v3.14
+     */
+    bool useRendererRingBuffer() const;
+
+    /** Whether or not the renderer should batch sprites using different textures.
+     *
+     * Controlled by the `cocos2d.x.renderer.multi_texture_batching` key (default: `false`).
+     * It is read when the GLView is created, see `Renderer::setMultiTextureBatchingEnabled()`.
+     *
+     * @return Whether or not multi texture batching is requested.
+     * @since v3.14
+     */
+    bool useRendererMultiTextureBatching() const;
+
+    /** Whether or not linked GLPrograms should be cached on disk.
+     *
+     * Controlled by the `cocos2d.x.program_binary_cache` key (default: `false`).
+     * It only takes effect when `supportsProgramBinary()` is `true`, and it is read when
+     * the GLProgramCache is created, see `GLProgramCache::setProgramBinaryCacheEnabled()`.
+     *
+     * @return Whether or not the program binary cache is requested.
+     * @since v3.14
+     */
+    bool useProgramBinaryCache() const;
+
     
     /** Max support directional light in shader, for Sprite3D.
      *
@@ -178,14 +282,14 @@ public:
      */
     int getMaxSupportDirLightInShader() const;
     
-    /** Max support point light in shader, for Sprite3D.
+    /** Max support point light in shader, for Sprite3D. A mesh is lit by the closest point lights reaching it, see `LightGrid`.
      *
      * @return Maximum supports point light in shader.
      * @since v3.3
      */
     int getMaxSupportPointLightInShader() const;
     
-    /** Max support spot light in shader, for Sprite3D.
+    /** Max support spot light in shader, for Sprite3D. A mesh is lit by the closest spot lights reaching it, see `LightGrid`.
      *
      * @return Maximum supports spot light in shader.
      * @since v3.3
@@ -258,6 +362,13 @@ protected:
     bool            _supportsDiscardFramebuffer;
     bool            _supportsShareableVAO;
     bool            _supportsOESMapBuffer;
+    bool            _supportsMapBufferRange;
+    bool            _supportsSyncObjects;
+    bool            _supportsInstancing;
+    bool            _supportsTimerQuery;
+    bool            _supportsOcclusionQuery;
+    bool            _supportsProgramBinary;
+    bool            _supportsBoneTexture;
     bool            _supportsOESDepth24;
     bool            _supportsOESPackedDepthStencil;
     
@@ -65,8 +65,13 @@
 #include "2d/CCScene.h"
 #include "platform/CCFileUtils.h"
 #include "renderer/CCTextureCache.h"
+#include "renderer/CCRenderer.h"
 #include "base/base64.h"
 #include "base/ccUtils.h"
+#include "base/CCProfiling.h"
+#include "base/CCEventDispatcher.h"
+#include "base/CCEventListenerCustom.h"
+#include "renderer/ccGLStateCache.h"
 #include "base/allocator/CCAllocatorDiagnostics.h"
 NS_CC_BEGIN
 
@@ -483,6 +488,7 @@ Console::Console()
 , _endThread(false)
 , _isIpv6Server(false)
 , _sendDebugStrings(false)
+, _perfStreamListener(nullptr)
 , _bindAddress("")
 {
     createCommandAllocator();
@@ -492,12 +498,16 @@ Console::Console()
     createCommandExit();
     createCommandFileUtils();
     createCommandFps();
+    createCommandGPUTime();
     createCommandHelp();
+    createCommandMemory();
+    createCommandPerf();
     createCommandProjection();
     createCommandResolution();
     createCommandSceneGraph();
     createCommandTexture();
     createCommandTouch();
+    createCommandTrace();
     createCommandUpload();
     createCommandVersion();
 }
@@ -506,6 +516,9 @@ Console::~Console()
 {
     stop();
 
+    if (_perfStreamListener)
+        Director::getInstance()->getEventDispatcher()->removeEventListener(_perfStreamListener);
+
     for (auto& e : _commands)
         delete e.second;
 }
@@ -799,6 +812,7 @@ void Console::loop()
             for(int fd: to_remove) {
                 FD_CLR(fd, &_read_set);
                 _fds.erase(std::remove(_fds.begin(), _fds.end(), fd), _fds.end());
+                removePerfStreamClient(fd);
             }
         }
         
@@ -815,6 +829,16 @@ void Console::loop()
                 _DebugStringsMutex.unlock();
             }
         }
+
+        /* per-frame samples of "perf stream" */
+        std::vector<std::pair<int, std::string>> perfStreamLines;
+        {
+            std::lock_guard<std::mutex> lock(_perfStreamMutex);
+            perfStreamLines.swap(_perfStreamLines);
+        }
+        for (const auto& line : perfStreamLines) {
+            Console::Utility::sendToConsole(line.first, line.second.c_str(), line.second.length());
+        }
     }
     
     // clean up: ignore stdin, stdout and stderr
@@ -1059,11 +1083,45 @@ void Console::createCommandFps()
     addSubCommand("fps", {"off", "Hide the FPS on the bottom-left corner.", CC_CALLBACK_2(Console::commandFpsSubCommandOnOff, this)});
 }
 
+void Console::createCommandGPUTime()
+{
+    addCommand({"gputime", "Print the GPU time of every camera, render queue and GroupCommand. Args: [-h | help | on | off | ]", CC_CALLBACK_2(Console::commandGPUTime, this)});
+    addSubCommand("gputime", {"on", "Start measuring the GPU time with timer queries.", CC_CALLBACK_2(Console::commandGPUTimeSubCommandOnOff, this)});
+    addSubCommand("gputime", {"off", "Stop measuring the GPU time.", CC_CALLBACK_2(Console::commandGPUTimeSubCommandOnOff, this)});
+}
+
+void Console::createCommandMemory()
+{
+    addCommand({"memory", "Print the heap allocations, the texture memory, the cache sizes and the alive objects. Args: [-h | help | on | off | ]", CC_CALLBACK_2(Console::commandMemory, this)});
+    addSubCommand("memory", {"on", "Display the memory statistics above the FPS.", CC_CALLBACK_2(Console::commandMemorySubCommandOnOff, this)});
+    addSubCommand("memory", {"off", "Hide the memory statistics.", CC_CALLBACK_2(Console::commandMemorySubCommandOnOff, this)});
+}
+
 void Console::createCommandHelp()
 {
     addCommand({"help", "Print this message. Args: [ ]", CC_CALLBACK_2(Console::commandHelp, this)});
 }
 
+void Console::createCommandPerf()
+{
+    addCommand({"perf", "Performance data as line-delimited JSON, for telemetry tools. Args: [-h | help | trace | stream | queues | nodes | breaks | overdraw | batching | culling | ]",
+        CC_CALLBACK_2(Console::commandPerf, this)});
+    addSubCommand("perf", {"trace", "perf trace on | off | clear | dump: record the engine zones, dump sends them as a Chrome trace: {\"type\":\"trace\",\"trace\":{...}}.",
+        CC_CALLBACK_2(Console::commandPerfSubCommandTrace, this)});
+    addSubCommand("perf", {"stream", "perf stream on [frames] | off: send {\"type\":\"frame\",...} with the timings and draw stats of every frame, or every [frames] frames, to this connection.",
+        CC_CALLBACK_2(Console::commandPerfSubCommandStream, this)});
+    addSubCommand("perf", {"queues", "Send the commands of the render queues of the next frame, the biggest first, and by command type.",
+        CC_CALLBACK_2(Console::commandPerfSubCommandQueues, this)});
+    addSubCommand("perf", {"nodes", "perf nodes [count]: send the nodes which add the most commands in the next frame. Default count: 10.",
+        CC_CALLBACK_2(Console::commandPerfSubCommandNodes, this)});
+    addSubCommand("perf", {"breaks", "perf breaks [count]: send why the triangle batches of the next frame were broken, and the first [count] breaks with their nodes. Default count: 20.",
+        CC_CALLBACK_2(Console::commandPerfSubCommandBreaks, this)});
+    addSubCommand("perf", {"overdraw", "perf overdraw on | off | stats: show the overdraw as a heatmap, stats sends the estimated pixels of every pass and the large transparent nodes.",
+        CC_CALLBACK_2(Console::commandPerfSubCommandOverdraw, this)});
+    addSubCommand("perf", {"batching", "perf batching on | off: enable or disable the batching of the renderer.", CC_CALLBACK_2(Console::commandPerfSubCommandRenderer, this)});
+    addSubCommand("perf", {"culling", "perf culling on | off: enable or disable the culling of the nodes outside the screen.", CC_CALLBACK_2(Console::commandPerfSubCommandRenderer, this)});
+}
+
 void Console::createCommandProjection()
 {
     addCommand({"projection", "Change or print the current projection. Args: [-h | help | 2d | 3d | ]",
@@ -1103,6 +1161,17 @@ void Console::createCommandTouch()
         CC_CALLBACK_2(Console::commandTouchSubCommandSwipe, this)});
 }
 
+void Console::createCommandTrace()
+{
+    addCommand({"trace", "Record a timeline of the engine zones and save it as a Chrome trace. Args: [-h | help | on | off | save filename | clear | ]",
+        CC_CALLBACK_2(Console::commandTrace, this)});
+    addSubCommand("trace", {"on", "Start recording the zones.", CC_CALLBACK_2(Console::commandTraceSubCommandOnOff, this)});
+    addSubCommand("trace", {"off", "Stop recording the zones.", CC_CALLBACK_2(Console::commandTraceSubCommandOnOff, this)});
+    addSubCommand("trace", {"save", "trace save [filename]: write the recorded zones to a JSON file in the writable path, for chrome://tracing or ui.perfetto.dev. Default filename: trace.json.",
+        CC_CALLBACK_2(Console::commandTraceSubCommandSave, this)});
+    addSubCommand("trace", {"clear", "Discard the recorded zones.", CC_CALLBACK_2(Console::commandTraceSubCommandClear, this)});
+}
+
 void Console::createCommandUpload()
 {
     addCommand({"upload", "upload file. Args: [filename base64_encoded_data]", CC_CALLBACK_1(Console::commandUpload, this)});
@@ -1186,6 +1255,7 @@ void Console::commandExit(int fd, const std::string& /*args*/)
 {
     FD_CLR(fd, &_read_set);
     _fds.erase(std::remove(_fds.begin(), _fds.end(), fd), _fds.end());
+    removePerfStreamClient(fd);
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32) || (CC_TARGET_PLATFORM == CC_PLATFORM_WINRT)
     closesocket(fd);
 #else
@@ -1217,11 +1287,419 @@ void Console::commandFpsSubCommandOnOff(int /*fd*/, const std::string& args)
     sched->performFunctionInCocosThread( std::bind(&Director::setDisplayStats, dir, state));
 }
 
+void Console::commandGPUTime(int fd, const std::string& /*args*/)
+{
+    Scheduler *sched = Director::getInstance()->getScheduler();
+    sched->performFunctionInCocosThread( [=](){
+        Console::Utility::mydprintf(fd, "%s", Director::getInstance()->getRenderer()->getGPUTimingsDescription().c_str());
+        Console::Utility::sendPrompt(fd);
+    });
+}
+
+void Console::commandGPUTimeSubCommandOnOff(int /*fd*/, const std::string& args)
+{
+    bool state = (args.compare("on") == 0);
+    Scheduler *sched = Director::getInstance()->getScheduler();
+    sched->performFunctionInCocosThread( [=](){
+        Director::getInstance()->getRenderer()->setGPUTimingEnabled(state);
+    });
+}
+
+void Console::commandMemory(int fd, const std::string& /*args*/)
+{
+    Scheduler *sched = Director::getInstance()->getScheduler();
+    sched->performFunctionInCocosThread( [=](){
+        Console::Utility::mydprintf(fd, "%s", Director::getInstance()->getMemoryStatsDescription().c_str());
+        Console::Utility::sendPrompt(fd);
+    });
+}
+
+void Console::commandMemorySubCommandOnOff(int /*fd*/, const std::string& args)
+{
+    bool state = (args.compare("on") == 0);
+    Scheduler *sched = Director::getInstance()->getScheduler();
+    sched->performFunctionInCocosThread( [=](){
+        auto director = Director::getInstance();
+        director->setDisplayMemoryStats(state);
+        if (state)
+        {
+            director->setDisplayStats(true);
+        }
+    });
+}
+
 void Console::commandHelp(int fd, const std::string& /*args*/)
 {
     sendHelp(fd, _commands, "\nAvailable commands:\n");
 }
 
+static void appendJSONString(std::string& json, const std::string& str)
+{
+    json += '"';
+    for (auto c : str)
+    {
+        if (c == '"' || c == '\\')
+        {
+            json += '\\';
+            json += c;
+        }
+        else if ((unsigned char)c < 0x20)
+        {
+            char buf[8];
+            snprintf(buf, sizeof(buf), "\\u%04x", (unsigned int)c);
+            json += buf;
+        }
+        else
+        {
+            json += c;
+        }
+    }
+    json += '"';
+}
+
+static const char* getCommandTypeName(int type)
+{
+    switch ((RenderCommand::Type)type)
+    {
+        case RenderCommand::Type::QUAD_COMMAND: return "quad";
+        case RenderCommand::Type::CUSTOM_COMMAND: return "custom";
+        case RenderCommand::Type::BATCH_COMMAND: return "batch";
+        case RenderCommand::Type::GROUP_COMMAND: return "group";
+        case RenderCommand::Type::MESH_COMMAND: return "mesh";
+        case RenderCommand::Type::PRIMITIVE_COMMAND: return "primitive";
+        case RenderCommand::Type::TRIANGLES_COMMAND: return "triangles";
+        default: return "unknown";
+    }
+}
+
+static void sendJSONLine(int fd, std::string json)
+{
+    json += '\n';
+    Console::Utility::sendToConsole(fd, json.c_str(), json.length());
+}
+
+static std::string getPerfStatusJSON()
+{
+    auto renderer = Director::getInstance()->getRenderer();
+    char buf[256];
+    snprintf(buf, sizeof(buf), "{\"type\":\"status\",\"trace\":%s,\"batching\":%s,\"culling\":%s,\"commandStatistics\":%s,\"gpuTiming\":%s,\"overdraw\":%s}",
+             TraceProfiler::getInstance()->isEnabled() ? "true" : "false",
+             renderer->isBatchingEnabled() ? "true" : "false",
+             renderer->isCullingEnabled() ? "true" : "false",
+             renderer->isCommandStatisticsEnabled() ? "true" : "false",
+             renderer->isGPUTimingEnabled() ? "true" : "false",
+             renderer->isOverdrawVisualizationEnabled() ? "true" : "false");
+    return buf;
+}
+
+void Console::commandPerf(int fd, const std::string& /*args*/)
+{
+    Scheduler *sched = Director::getInstance()->getScheduler();
+    sched->performFunctionInCocosThread( [=](){
+        sendJSONLine(fd, getPerfStatusJSON());
+    });
+}
+
+void Console::commandPerfSubCommandTrace(int fd, const std::string& args)
+{
+    auto argv = Console::Utility::split(args, ' ');
+    std::string action = argv.size() > 1 ? argv[1] : "";
+    auto profiler = TraceProfiler::getInstance();
+
+    if (action == "on" || action == "off")
+    {
+        profiler->setEnabled(action == "on");
+    }
+    else if (action == "clear")
+    {
+        profiler->clear();
+    }
+    else if (action == "dump")
+    {
+        // the Chrome trace is a single line of JSON
+        sendJSONLine(fd, "{\"type\":\"trace\",\"trace\":" + profiler->getChromeTrace() + "}");
+        return;
+    }
+    else
+    {
+        sendJSONLine(fd, "{\"type\":\"error\",\"message\":\"perf trace: invalid arguments\"}");
+        return;
+    }
+    sendJSONLine(fd, std::string("{\"type\":\"trace\",\"enabled\":") + (profiler->isEnabled() ? "true" : "false") + "}");
+}
+
+void Console::commandPerfSubCommandStream(int fd, const std::string& args)
+{
+    auto argv = Console::Utility::split(args, ' ');
+    bool enabled = argv.size() > 1 && argv[1] == "on";
+    unsigned int interval = argv.size() > 2 ? (unsigned int)std::max(1, atoi(argv[2].c_str())) : 1;
+
+    {
+        std::lock_guard<std::mutex> lock(_perfStreamMutex);
+        _perfStreamClients.erase(std::remove_if(_perfStreamClients.begin(), _perfStreamClients.end(), [fd](const std::pair<int, unsigned int>& client) {
+            return client.first == fd;
+        }), _perfStreamClients.end());
+        if (enabled)
+            _perfStreamClients.push_back(std::make_pair(fd, interval));
+    }
+
+    // the samples are taken by the cocos thread after each frame is drawn
+    if (enabled)
+    {
+        Scheduler *sched = Director::getInstance()->getScheduler();
+        sched->performFunctionInCocosThread( [this](){
+            if (_perfStreamListener == nullptr)
+            {
+                _perfStreamListener = Director::getInstance()->getEventDispatcher()->addCustomEventListener(Director::EVENT_AFTER_DRAW, [this](EventCustom* /*event*/) {
+                    samplePerfStream();
+                });
+            }
+        });
+    }
+    char buf[64];
+    snprintf(buf, sizeof(buf), "{\"type\":\"stream\",\"enabled\":%s,\"interval\":%u}", enabled ? "true" : "false", interval);
+    sendJSONLine(fd, buf);
+}
+
+void Console::samplePerfStream()
+{
+    std::lock_guard<std::mutex> lock(_perfStreamMutex);
+    if (_perfStreamClients.empty())
+        return;
+
+    auto director = Director::getInstance();
+    auto renderer = director->getRenderer();
+    auto memoryStats = director->getMemoryStats();
+    unsigned int frame = director->getTotalFrames();
+
+    char buf[512];
+    snprintf(buf, sizeof(buf), "{\"type\":\"frame\",\"frame\":%u,\"dtMs\":%.3f,\"fps\":%.1f,\"gpuMs\":%.3f,\"batches\":%ld,\"vertices\":%ld,"
+             "\"skippedStateCalls\":%u,\"allocations\":%llu,\"textureMemory\":%lu,\"autoreleased\":%lu}\n",
+             frame, director->getDeltaTime() * 1000.0f, director->getFrameRate(), renderer->getGPUFrameTime(),
+             (long)renderer->getDrawnBatches(), (long)renderer->getDrawnVertices(), (unsigned int)GL::getSkippedStateCalls(),
+             (unsigned long long)memoryStats.frameAllocations, (unsigned long)memoryStats.textureMemory, (unsigned long)memoryStats.frameAutoreleaseCount);
+
+    for (const auto& client : _perfStreamClients)
+    {
+        if (frame % client.second == 0)
+            _perfStreamLines.push_back(std::make_pair(client.first, std::string(buf)));
+    }
+}
+
+void Console::removePerfStreamClient(int fd)
+{
+    std::lock_guard<std::mutex> lock(_perfStreamMutex);
+    _perfStreamClients.erase(std::remove_if(_perfStreamClients.begin(), _perfStreamClients.end(), [fd](const std::pair<int, unsigned int>& client) {
+        return client.first == fd;
+    }), _perfStreamClients.end());
+    _perfStreamLines.erase(std::remove_if(_perfStreamLines.begin(), _perfStreamLines.end(), [fd](const std::pair<int, std::string>& line) {
+        return line.first == fd;
+    }), _perfStreamLines.end());
+}
+
+// enables the command statistics for one frame if needed, then sends them
+static void sendCommandStatistics(const std::function<void(const Renderer::CommandStatistics&)>& send)
+{
+    Scheduler *sched = Director::getInstance()->getScheduler();
+    sched->performFunctionInCocosThread( [=](){
+        auto renderer = Director::getInstance()->getRenderer();
+        bool wasEnabled = renderer->isCommandStatisticsEnabled();
+        renderer->setCommandStatisticsEnabled(true);
+
+        // the frame started by this update is counted, it's complete by the next update
+        Director::getInstance()->getScheduler()->performFunctionInCocosThread( [=](){
+            auto renderer = Director::getInstance()->getRenderer();
+            send(renderer->getCommandStatistics());
+            if (!wasEnabled)
+                renderer->setCommandStatisticsEnabled(false);
+        });
+    });
+}
+
+void Console::commandPerfSubCommandQueues(int fd, const std::string& /*args*/)
+{
+    sendCommandStatistics([fd](const Renderer::CommandStatistics& statistics) {
+        static const char* groupNames[RenderQueue::QUEUE_COUNT] = {"globalZNeg", "opaque3D", "transparent3D", "globalZZero", "globalZPos"};
+        char buf[128];
+
+        snprintf(buf, sizeof(buf), "{\"type\":\"queues\",\"frame\":%u,\"queues\":[", statistics.frame);
+        std::string json = buf;
+        for (size_t i = 0; i < statistics.queues.size(); ++i)
+        {
+            const auto& queue = statistics.queues[i];
+            snprintf(buf, sizeof(buf), "%s{\"id\":%d,\"commands\":%ld", i > 0 ? "," : "", queue.id, (long)queue.total);
+            json += buf;
+            for (int group = 0; group < RenderQueue::QUEUE_COUNT; ++group)
+            {
+                snprintf(buf, sizeof(buf), ",\"%s\":%ld", groupNames[group], (long)queue.groups[group]);
+                json += buf;
+            }
+            json += '}';
+        }
+        json += "],\"commandTypes\":{";
+        bool first = true;
+        for (const auto& type : statistics.commandTypes)
+        {
+            snprintf(buf, sizeof(buf), "%s\"%s\":%ld", first ? "" : ",", getCommandTypeName(type.first), (long)type.second);
+            json += buf;
+            first = false;
+        }
+        json += "}}";
+        sendJSONLine(fd, json);
+    });
+}
+
+void Console::commandPerfSubCommandNodes(int fd, const std::string& args)
+{
+    auto argv = Console::Utility::split(args, ' ');
+    size_t count = argv.size() > 1 ? (size_t)std::max(1, atoi(argv[1].c_str())) : 10;
+
+    sendCommandStatistics([fd, count](const Renderer::CommandStatistics& statistics) {
+        char buf[64];
+        snprintf(buf, sizeof(buf), "{\"type\":\"nodes\",\"frame\":%u,\"nodes\":[", statistics.frame);
+        std::string json = buf;
+        for (size_t i = 0; i < statistics.nodes.size() && i < count; ++i)
+        {
+            const auto& node = statistics.nodes[i];
+            json += i > 0 ? ",{\"name\":" : "{\"name\":";
+            appendJSONString(json, node.name);
+            json += ",\"class\":";
+            appendJSONString(json, node.type);
+            snprintf(buf, sizeof(buf), ",\"commands\":%ld}", (long)node.commands);
+            json += buf;
+        }
+        json += "]}";
+        sendJSONLine(fd, json);
+    });
+}
+
+void Console::commandPerfSubCommandBreaks(int fd, const std::string& args)
+{
+    auto argv = Console::Utility::split(args, ' ');
+    size_t count = argv.size() > 1 ? (size_t)std::max(1, atoi(argv[1].c_str())) : 20;
+
+    Scheduler *sched = Director::getInstance()->getScheduler();
+    sched->performFunctionInCocosThread( [=](){
+        auto renderer = Director::getInstance()->getRenderer();
+        bool wasEnabled = renderer->isBatchBreakStatisticsEnabled();
+        renderer->setBatchBreakStatisticsEnabled(true);
+
+        // same as sendCommandStatistics(), the frame is complete by the next update
+        Director::getInstance()->getScheduler()->performFunctionInCocosThread( [=](){
+            auto renderer = Director::getInstance()->getRenderer();
+            const auto& statistics = renderer->getBatchBreakStatistics();
+            char buf[64];
+
+            snprintf(buf, sizeof(buf), "{\"type\":\"breaks\",\"frame\":%u,\"causes\":{", statistics.frame);
+            std::string json = buf;
+            for (int cause = 0; cause < (int)Renderer::BatchBreakCause::COUNT; ++cause)
+            {
+                snprintf(buf, sizeof(buf), "%s\"%s\":%ld", cause > 0 ? "," : "",
+                    Renderer::getBatchBreakCauseName((Renderer::BatchBreakCause)cause), (long)statistics.causes[cause]);
+                json += buf;
+            }
+            json += "},\"breaks\":[";
+            for (size_t i = 0; i < statistics.breaks.size() && i < count; ++i)
+            {
+                const auto& entry = statistics.breaks[i];
+                json += i > 0 ? ",{\"cause\":" : "{\"cause\":";
+                appendJSONString(json, Renderer::getBatchBreakCauseName(entry.cause));
+                json += ",\"node\":";
+                appendJSONString(json, entry.node);
+                json += ",\"class\":";
+                appendJSONString(json, entry.nodeType);
+                json += ",\"previousNode\":";
+                appendJSONString(json, entry.previousNode);
+                json += ",\"previousClass\":";
+                appendJSONString(json, entry.previousNodeType);
+                json += '}';
+            }
+            json += "]}";
+            sendJSONLine(fd, json);
+
+            if (!wasEnabled)
+                renderer->setBatchBreakStatisticsEnabled(false);
+        });
+    });
+}
+
+void Console::commandPerfSubCommandOverdraw(int fd, const std::string& args)
+{
+    auto argv = Console::Utility::split(args, ' ');
+    std::string action = argv.size() > 1 ? argv[1] : "";
+    if (action != "on" && action != "off" && action != "stats")
+    {
+        sendJSONLine(fd, "{\"type\":\"error\",\"message\":\"perf overdraw: invalid arguments\"}");
+        return;
+    }
+
+    Scheduler *sched = Director::getInstance()->getScheduler();
+    sched->performFunctionInCocosThread( [=](){
+        auto renderer = Director::getInstance()->getRenderer();
+        if (action != "stats")
+        {
+            renderer->setOverdrawVisualizationEnabled(action == "on");
+            sendJSONLine(fd, getPerfStatusJSON());
+            return;
+        }
+        if (!renderer->isOverdrawVisualizationEnabled())
+        {
+            sendJSONLine(fd, "{\"type\":\"error\",\"message\":\"perf overdraw: not enabled\"}");
+            return;
+        }
+
+        const auto& statistics = renderer->getOverdrawStatistics();
+        char buf[128];
+        snprintf(buf, sizeof(buf), "{\"type\":\"overdraw\",\"frame\":%u,\"screenPixels\":%.0f,\"passes\":[", statistics.frame, statistics.screenPixels);
+        std::string json = buf;
+        for (size_t i = 0; i < statistics.passes.size(); ++i)
+        {
+            const auto& pass = statistics.passes[i];
+            json += i > 0 ? ",{\"camera\":" : "{\"camera\":";
+            appendJSONString(json, pass.camera);
+            json += ",\"group\":";
+            appendJSONString(json, pass.group);
+            snprintf(buf, sizeof(buf), ",\"pixels\":%.0f,\"transparentPixels\":%.0f}", pass.pixels, pass.transparentPixels);
+            json += buf;
+        }
+        json += "],\"transparentNodes\":[";
+        for (size_t i = 0; i < statistics.transparentNodes.size(); ++i)
+        {
+            const auto& node = statistics.transparentNodes[i];
+            json += i > 0 ? ",{\"name\":" : "{\"name\":";
+            appendJSONString(json, node.node);
+            json += ",\"class\":";
+            appendJSONString(json, node.nodeType);
+            snprintf(buf, sizeof(buf), ",\"coverage\":%.3f,\"alpha\":%.3f}", node.coverage, node.alpha);
+            json += buf;
+        }
+        json += "]}";
+        sendJSONLine(fd, json);
+    });
+}
+
+void Console::commandPerfSubCommandRenderer(int fd, const std::string& args)
+{
+    auto argv = Console::Utility::split(args, ' ');
+    if (argv.size() != 2 || (argv[1] != "on" && argv[1] != "off"))
+    {
+        sendJSONLine(fd, "{\"type\":\"error\",\"message\":\"perf: invalid arguments\"}");
+        return;
+    }
+
+    std::string feature = argv[0];
+    bool enabled = argv[1] == "on";
+    Scheduler *sched = Director::getInstance()->getScheduler();
+    sched->performFunctionInCocosThread( [=](){
+        auto renderer = Director::getInstance()->getRenderer();
+        if (feature == "batching")
+            renderer->setBatchingEnabled(enabled);
+        else
+            renderer->setCullingEnabled(enabled);
+        sendJSONLine(fd, getPerfStatusJSON());
+    });
+}
+
 void Console::commandProjection(int fd, const std::string& /*args*/)
 {
     auto director = Director::getInstance();
@@ -1326,6 +1804,33 @@ void Console::commandTexturesSubCommandFlush(int /*fd*/, const std::string& /*ar
     });
 }
 
+void Console::commandTrace(int fd, const std::string& /*args*/)
+{
+    Console::Utility::mydprintf(fd, "Trace is: %s\n", TraceProfiler::getInstance()->isEnabled() ? "on" : "off");
+}
+
+void Console::commandTraceSubCommandOnOff(int /*fd*/, const std::string& args)
+{
+    TraceProfiler::getInstance()->setEnabled(args.compare("on") == 0);
+}
+
+void Console::commandTraceSubCommandSave(int fd, const std::string& args)
+{
+    auto argv = Console::Utility::split(args, ' ');
+    std::string filename = argv.size() > 1 ? argv[1] : "trace.json";
+    std::string path = FileUtils::getInstance()->getWritablePath() + filename;
+
+    if (TraceProfiler::getInstance()->saveChromeTrace(path))
+        Console::Utility::mydprintf(fd, "Trace saved to: %s\n", path.c_str());
+    else
+        Console::Utility::mydprintf(fd, "trace: can't write %s\n", path.c_str());
+}
+
+void Console::commandTraceSubCommandClear(int /*fd*/, const std::string& /*args*/)
+{
+    TraceProfiler::getInstance()->clear();
+}
+
 void Console::commandTouchSubCommandTap(int fd, const std::string& args)
 {
     auto argv = Console::Utility::split(args,' ');
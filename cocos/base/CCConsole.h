@@ -61,6 +61,8 @@ static const int MAX_LOG_LENGTH = 16*1024;
  */
 void CC_DLL log(const char * format, ...) CC_FORMAT_PRINTF(1, 2);
 
+class EventListenerCustom;
+
 /** Console is helper class that lets the developer control the game from TCP connection.
  Console will spawn a new thread that will listen to a specified TCP port.
  Console has a basic token parser. Each token is associated with an std::function<void(int)>.
@@ -228,12 +230,16 @@ protected:
     void createCommandExit();
     void createCommandFileUtils();
     void createCommandFps();
+    void createCommandGPUTime();
     void createCommandHelp();
+    void createCommandMemory();
+    void createCommandPerf();
     void createCommandProjection();
     void createCommandResolution();
     void createCommandSceneGraph();
     void createCommandTexture();
     void createCommandTouch();
+    void createCommandTrace();
     void createCommandUpload();
     void createCommandVersion();
 
@@ -252,7 +258,19 @@ protected:
     void commandFileUtilsSubCommandFlush(int fd, const std::string& args);
     void commandFps(int fd, const std::string& args);
     void commandFpsSubCommandOnOff(int fd, const std::string& args);
+    void commandGPUTime(int fd, const std::string& args);
+    void commandGPUTimeSubCommandOnOff(int fd, const std::string& args);
     void commandHelp(int fd, const std::string& args);
+    void commandMemory(int fd, const std::string& args);
+    void commandMemorySubCommandOnOff(int fd, const std::string& args);
+    void commandPerf(int fd, const std::string& args);
+    void commandPerfSubCommandTrace(int fd, const std::string& args);
+    void commandPerfSubCommandStream(int fd, const std::string& args);
+    void commandPerfSubCommandQueues(int fd, const std::string& args);
+    void commandPerfSubCommandNodes(int fd, const std::string& args);
+    void commandPerfSubCommandBreaks(int fd, const std::string& args);
+    void commandPerfSubCommandOverdraw(int fd, const std::string& args);
+    void commandPerfSubCommandRenderer(int fd, const std::string& args);
     void commandProjection(int fd, const std::string& args);
     void commandProjectionSubCommand2d(int fd, const std::string& args);
     void commandProjectionSubCommand3d(int fd, const std::string& args);
@@ -261,6 +279,10 @@ protected:
     void commandSceneGraph(int fd, const std::string& args);
     void commandTextures(int fd, const std::string& args);
     void commandTexturesSubCommandFlush(int fd, const std::string& args);
+    void commandTrace(int fd, const std::string& args);
+    void commandTraceSubCommandOnOff(int fd, const std::string& args);
+    void commandTraceSubCommandSave(int fd, const std::string& args);
+    void commandTraceSubCommandClear(int fd, const std::string& args);
     void commandTouchSubCommandTap(int fd, const std::string& args);
     void commandTouchSubCommandSwipe(int fd, const std::string& args);
     void commandUpload(int fd);
@@ -284,6 +306,15 @@ protected:
     std::mutex _DebugStringsMutex;
     std::vector<std::string> _DebugStrings;
 
+    // per-frame samples of "perf stream": the clients and their interval in frames, and the lines
+    // written by the cocos thread for the console thread to send
+    std::mutex _perfStreamMutex;
+    std::vector<std::pair<int, unsigned int>> _perfStreamClients;
+    std::vector<std::pair<int, std::string>> _perfStreamLines;
+    EventListenerCustom* _perfStreamListener;
+    void samplePerfStream();
+    void removePerfStreamClient(int fd);
+
     intptr_t _touchId;
 
     std::string _bindAddress;
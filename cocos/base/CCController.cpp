@@ -31,9 +31,13 @@
 #include "base/CCEventController.h"
 #include "base/CCDirector.h"
 
+#include <algorithm>
+#include <iterator>
+
 NS_CC_BEGIN
 
 std::vector<Controller*> Controller::s_allController;
+bool Controller::s_keyEventsEnabled = true;
 
 Controller* Controller::getControllerByTag(int tag)
 {
@@ -71,6 +75,19 @@ void Controller::init()
         _allKeyPrevStatus[key].value = 0.0f;
     }
 
+    for (auto& state : _states)
+    {
+        for (auto& status : state.keys)
+        {
+            status.isPressed = false;
+            status.value = 0.0f;
+            status.isAnalog = false;
+        }
+        state.frame = 0;
+    }
+    _currentState = 0;
+    std::fill(std::begin(_pressedSinceUpdate), std::end(_pressedSinceUpdate), false);
+
     _eventDispatcher = Director::getInstance()->getEventDispatcher();
     _connectEvent = new (std::nothrow) EventController(EventController::ControllerEventType::CONNECTION, this, false);
     _keyEvent = new (std::nothrow) EventController(EventController::ControllerEventType::BUTTON_STATUS_CHANGED, this, 0);
@@ -88,6 +105,38 @@ const Controller::KeyStatus& Controller::getKeyStatus(int keyCode)
     return _allKeyStatus[keyCode];
 }
 
+const Controller::KeyStatus& Controller::State::getKeyStatus(int keyCode) const
+{
+    static const KeyStatus released = { false, 0.0f, false };
+    if (keyCode < JOYSTICK_LEFT_X || keyCode >= KEY_MAX)
+    {
+        return released;
+    }
+    return keys[keyCode - JOYSTICK_LEFT_X];
+}
+
+void Controller::updateStates()
+{
+    auto frame = Director::getInstance()->getTotalFrames();
+    for (auto controller : s_allController)
+    {
+        controller->updateState(frame);
+    }
+}
+
+void Controller::updateState(unsigned int frame)
+{
+    _currentState ^= 1;
+    auto& state = _states[_currentState];
+    for (int i = 0; i < State::KEY_COUNT; ++i)
+    {
+        state.keys[i] = _allKeyStatus[JOYSTICK_LEFT_X + i];
+        state.keys[i].isPressed = state.keys[i].isPressed || _pressedSinceUpdate[i];
+        _pressedSinceUpdate[i] = false;
+    }
+    state.frame = frame;
+}
+
 void Controller::onConnected()
 {
     _connectEvent->setConnectStatus(true);
@@ -109,6 +158,14 @@ void Controller::onButtonEvent(int keyCode, bool isPressed, float value, bool is
     _allKeyStatus[keyCode].value = value;
     _allKeyStatus[keyCode].isAnalog = isAnalog;
 
+    if (isPressed && keyCode >= JOYSTICK_LEFT_X && keyCode < KEY_MAX)
+    {
+        _pressedSinceUpdate[keyCode - JOYSTICK_LEFT_X] = true;
+    }
+
+    if (!s_keyEventsEnabled)
+        return;
+
     _keyEvent->setKeyCode(keyCode);
     _eventDispatcher->dispatchEvent(_keyEvent);
 }
@@ -119,6 +176,9 @@ void Controller::onAxisEvent(int axisCode, float value, bool isAnalog)
     _allKeyStatus[axisCode].value = value;
     _allKeyStatus[axisCode].isAnalog = isAnalog;
 
+    if (!s_keyEventsEnabled)
+        return;
+
     _axisEvent->setKeyCode(axisCode);
     _eventDispatcher->dispatchEvent(_axisEvent);
 }
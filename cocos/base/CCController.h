@@ -112,6 +112,27 @@ public:
 
     static const int TAG_UNSET = -1;
 
+    /**
+     * @struct State
+     * The status of the standard keys of a controller, taken once per frame before the scheduled callbacks.
+     * It doesn't change during the frame, so the updates can poll it instead of listening to the events.
+     * @since v3.14
+     */
+    struct State
+    {
+        static const int KEY_COUNT = KEY_MAX - JOYSTICK_LEFT_X;
+
+        /** The status of the keys from JOYSTICK_LEFT_X to KEY_MAX, see getKeyStatus(). */
+        KeyStatus keys[KEY_COUNT];
+        /** The value of Director::getTotalFrames() when the state was taken. */
+        unsigned int frame;
+
+        /** Returns the status of a standard key, a released one for the other key codes. */
+        const KeyStatus& getKeyStatus(int keyCode) const;
+        bool isPressed(int keyCode) const { return getKeyStatus(keyCode).isPressed; }
+        float getValue(int keyCode) const { return getKeyStatus(keyCode).value; }
+    };
+
     /**
      * Gets all Controller objects.
      */
@@ -167,6 +188,45 @@ public:
      */
     const KeyStatus& getKeyStatus(int keyCode);
 
+    /**
+     * Returns the state of the controller in this frame.
+     * A key pressed and released between two frames is pressed in the state.
+     * @since v3.14
+     */
+    const State& getState() const { return _states[_currentState]; }
+
+    /**
+     * Returns the state of the controller in the previous frame.
+     * @since v3.14
+     */
+    const State& getPreviousState() const { return _states[_currentState ^ 1]; }
+
+    /**
+     * Returns whether the key is pressed in this frame and wasn't in the previous one.
+     * @since v3.14
+     */
+    bool isKeyJustPressed(int keyCode) const { return getState().isPressed(keyCode) && !getPreviousState().isPressed(keyCode); }
+
+    /**
+     * Returns whether the key was pressed in the previous frame and isn't in this one.
+     * @since v3.14
+     */
+    bool isKeyJustReleased(int keyCode) const { return !getState().isPressed(keyCode) && getPreviousState().isPressed(keyCode); }
+
+    /**
+     * Sets whether the changes of the buttons and the axes are dispatched as EventController, true by default.
+     * The games polling the states can disable them, the connection events are still dispatched.
+     * @since v3.14
+     */
+    static void setKeyEventsEnabled(bool enabled) { s_keyEventsEnabled = enabled; }
+    static bool isKeyEventsEnabled() { return s_keyEventsEnabled; }
+
+    /**
+     * Takes the states of the connected controllers, called by the Director at the beginning of the frame.
+     * @since v3.14
+     */
+    static void updateStates();
+
     /**
      * Activate receives key event from external key. e.g. back,menu.
      * Controller receives only standard key which contained within enum Key by default.
@@ -193,6 +253,7 @@ public:
 
 private:
     static std::vector<Controller*> s_allController;
+    static bool s_keyEventsEnabled;
 
     Controller();
     virtual ~Controller();
@@ -204,10 +265,17 @@ private:
     void onButtonEvent(int keyCode, bool isPressed, float value, bool isAnalog);
     void onAxisEvent(int axisCode, float value, bool isAnalog);
     void registerListeners();
+    void updateState(unsigned int frame);
 
     std::unordered_map<int, KeyStatus> _allKeyStatus;
     std::unordered_map<int, KeyStatus> _allKeyPrevStatus;
 
+    // the current and the previous frame, the events only change _allKeyStatus
+    State _states[2];
+    int _currentState;
+    // the keys pressed since the last state, they are pressed in the next one even if they were released
+    bool _pressedSinceUpdate[State::KEY_COUNT];
+
     std::string _deviceName;
     int _deviceId;
 
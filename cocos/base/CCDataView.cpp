@@ -0,0 +1,109 @@
+/****************************************************************************
+Copyright (c) 2017 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+
+#include "base/CCDataView.h"
+
+NS_CC_BEGIN
+
+DataView::DataView()
+: _bytes(nullptr)
+, _size(0)
+{
+}
+
+DataView::DataView(Data&& data)
+: _bytes(nullptr)
+, _size(0)
+{
+    ssize_t size = 0;
+    unsigned char* bytes = data.takeBuffer(&size);
+    if (bytes)
+    {
+        // the buffer of a Data is allocated by malloc
+        _owner = std::shared_ptr<const void>(bytes, free);
+        _bytes = bytes;
+        _size = size;
+    }
+}
+
+DataView::DataView(std::vector<char>&& bytes)
+: _bytes(nullptr)
+, _size(0)
+{
+    if (!bytes.empty())
+    {
+        auto owner = std::make_shared<std::vector<char>>(std::move(bytes));
+        _bytes = reinterpret_cast<const unsigned char*>(owner->data());
+        _size = (ssize_t)owner->size();
+        _owner = std::move(owner);
+    }
+}
+
+DataView::DataView(std::string&& bytes)
+: _bytes(nullptr)
+, _size(0)
+{
+    if (!bytes.empty())
+    {
+        auto owner = std::make_shared<std::string>(std::move(bytes));
+        _bytes = reinterpret_cast<const unsigned char*>(owner->data());
+        _size = (ssize_t)owner->size();
+        _owner = std::move(owner);
+    }
+}
+
+DataView DataView::slice(ssize_t offset, ssize_t size) const
+{
+    DataView view;
+    if (offset < 0 || offset >= _size)
+        return view;
+
+    if (size < 0 || size > _size - offset)
+        size = _size - offset;
+    if (size > 0)
+    {
+        view._owner = _owner;
+        view._bytes = _bytes + offset;
+        view._size = size;
+    }
+    return view;
+}
+
+Data DataView::copyData() const
+{
+    Data data;
+    if (_size > 0)
+    {
+        data.copy(_bytes, _size);
+    }
+    return data;
+}
+
+std::string DataView::copyString() const
+{
+    return _size > 0 ? std::string(reinterpret_cast<const char*>(_bytes), _size) : std::string();
+}
+
+NS_CC_END
@@ -0,0 +1,101 @@
+/****************************************************************************
+Copyright (c) 2017 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+
+#ifndef __CCDATA_VIEW_H__
+#define __CCDATA_VIEW_H__
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "base/CCData.h"
+
+/**
+ * @addtogroup base
+ * @js NA
+ * @lua NA
+ */
+NS_CC_BEGIN
+
+/**
+ * @class DataView
+ * @brief A read-only view of bytes shared by reference count, so they are passed around without copying.
+ *
+ * A DataView takes the buffer of a Data, a std::vector<char> or a std::string it is moved from, and the
+ * buffer is freed with the last view of it. slice() returns a view of a part of the bytes sharing the same
+ * buffer, e.g. a file of an archive read in memory. Copying a view only copies a pointer.
+ *
+ * The bytes can't be modified through a view, they can be read from several threads at once.
+ * @since v3.14
+ */
+class CC_DLL DataView
+{
+public:
+    /** A null view. */
+    DataView();
+
+    /** Takes the buffer of the data, it is null afterwards. */
+    explicit DataView(Data&& data);
+    /** Takes the buffer of the vector, it is empty afterwards. */
+    explicit DataView(std::vector<char>&& bytes);
+    /** Takes the buffer of the string, it is empty afterwards. */
+    explicit DataView(std::string&& bytes);
+
+    /** Returns the first byte of the view, nullptr for a null view. */
+    const unsigned char* getBytes() const { return _bytes; }
+
+    ssize_t getSize() const { return _size; }
+
+    /** Returns whether the view has no bytes. */
+    bool isNull() const { return _size == 0; }
+
+    /**
+     * Returns a view of a part of the bytes sharing the same buffer.
+     *
+     * @param offset The first byte of the part, from the first byte of this view.
+     * @param size The number of bytes, clamped to the end of this view; -1 for all the bytes after offset.
+     * @return The view of the part, null if offset is after the end of this view.
+     */
+    DataView slice(ssize_t offset, ssize_t size = -1) const;
+
+    /** Copies the bytes in a new Data, for the APIs taking the ownership of a buffer. */
+    Data copyData() const;
+
+    /** Copies the bytes in a string, it may contain '\0'. */
+    std::string copyString() const;
+
+    /** Returns the number of views sharing the buffer, 0 for a null view. */
+    long getUseCount() const { return _owner.use_count(); }
+
+private:
+    std::shared_ptr<const void> _owner;
+    const unsigned char* _bytes;
+    ssize_t _size;
+};
+
+NS_CC_END
+
+/** @} */
+#endif // __CCDATA_VIEW_H__
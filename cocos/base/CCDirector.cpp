@@ -42,6 +42,8 @@ THE SOFTWARE.
 #include "2d/CCTransition.h"
 #include "2d/CCFontFreeType.h"
 #include "2d/CCLabelAtlas.h"
+#include "2d/CCParticleSystemQuad.h"
+#include "2d/CCRenderTexture.h"
 #include "renderer/CCGLProgramCache.h"
 #include "renderer/CCGLProgramStateCache.h"
 #include "renderer/CCTextureCache.h"
@@ -49,18 +51,28 @@ THE SOFTWARE.
 #include "renderer/CCRenderer.h"
 #include "renderer/CCRenderState.h"
 #include "renderer/CCFrameBuffer.h"
+#include "renderer/CCDynamicResolution.h"
+#include "renderer/CCMeshCommand.h"
 #include "2d/CCCamera.h"
+#include "2d/CCAutoPolygon.h"
+#include "2d/CCComponentSystem.h"
 #include "base/CCUserDefault.h"
 #include "base/ccFPSImages.h"
 #include "base/CCScheduler.h"
 #include "base/ccMacros.h"
 #include "base/CCEventDispatcher.h"
 #include "base/CCEventCustom.h"
+#include "base/CCEventType.h"
 #include "base/CCConsole.h"
 #include "base/CCAutoreleasePool.h"
 #include "base/CCConfiguration.h"
+#include "base/CCController.h"
 #include "base/CCAsyncTaskPool.h"
+#include "base/CCTimeSlicedQueue.h"
+#include "base/CCProperties.h"
 #include "base/ObjectFactory.h"
+#include "base/CCProfiling.h"
+#include "base/allocator/CCAllocatorDiagnostics.h"
 #include "platform/CCApplication.h"
 
 #if CC_ENABLE_SCRIPT_BINDING
@@ -100,6 +112,7 @@ const char *Director::EVENT_BEFORE_UPDATE = "director_before_update";
 const char *Director::EVENT_AFTER_UPDATE = "director_after_update";
 const char *Director::EVENT_RESET = "director_reset";
 const char *Director::EVENT_BEFORE_DRAW = "director_before_draw";
+const char *Director::EVENT_THERMAL_STATE_CHANGED = "director_thermal_state_changed";
 
 Director* Director::getInstance()
 {
@@ -124,6 +137,8 @@ bool Director::init(void)
 {
     setDefaultValues();
 
+    TraceProfiler::getInstance()->setCurrentThreadName("cocos");
+
     // scenes
     _runningScene = nullptr;
     _nextScene = nullptr;
@@ -135,7 +150,11 @@ bool Director::init(void)
     // FPS
     _accumDt = 0.0f;
     _frameRate = 0.0f;
-    _FPSLabel = _drawnBatchesLabel = _drawnVerticesLabel = nullptr;
+    _FPSLabel = _drawnBatchesLabel = _drawnVerticesLabel = _gpuTimeLabel = _skippedStateCallsLabel = _batchBreaksLabel = nullptr;
+    _displayMemoryStats = false;
+    _memoryAllocationsLabel = _memoryTexturesLabel = _memoryRefsLabel = nullptr;
+    _frameStartAllocations = _frameStartAllocatedBytes = 0;
+    _frameAllocations = _frameAllocatedBytes = 0;
     _totalFrames = 0;
     _lastUpdate = std::chrono::steady_clock::now();
     
@@ -145,6 +164,21 @@ bool Director::init(void)
     // paused ?
     _paused = false;
 
+    // frame pacing
+    _appliedAnimationInterval = _animationInterval;
+    _idleAnimationInterval = 0;
+    _idleTimeout = 2.0f;
+    _idleTime = 0;
+    _isIdle = false;
+    _thermalState = ThermalState::NOMINAL;
+    _thermalAnimationIntervals[(int)ThermalState::NOMINAL] = 0;
+    _thermalAnimationIntervals[(int)ThermalState::FAIR] = 0;
+    _thermalAnimationIntervals[(int)ThermalState::SERIOUS] = 1 / 30.0f;
+    _thermalAnimationIntervals[(int)ThermalState::CRITICAL] = 1 / 20.0f;
+    _deltaTimeSmoothingEnabled = false;
+    resetDeltaTimeSmoothing();
+    _fixedDeltaTime = 0;
+
     // purge ?
     _purgeDirectorInNextLoop = false;
     
@@ -194,6 +228,7 @@ bool Director::init(void)
 
     _renderer = new (std::nothrow) Renderer;
     RenderState::initialize();
+    _dynamicResolution = new (std::nothrow) DynamicResolution();
 
 #if CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID
     EngineDataManager::init();
@@ -205,9 +240,17 @@ Director::~Director(void)
 {
     CCLOGINFO("deallocing Director: %p", this);
 
+    waitForPipelinedUpdates();
+
     CC_SAFE_RELEASE(_FPSLabel);
     CC_SAFE_RELEASE(_drawnVerticesLabel);
     CC_SAFE_RELEASE(_drawnBatchesLabel);
+    CC_SAFE_RELEASE(_gpuTimeLabel);
+    CC_SAFE_RELEASE(_skippedStateCallsLabel);
+    CC_SAFE_RELEASE(_batchBreaksLabel);
+    CC_SAFE_RELEASE(_memoryAllocationsLabel);
+    CC_SAFE_RELEASE(_memoryTexturesLabel);
+    CC_SAFE_RELEASE(_memoryRefsLabel);
 
     CC_SAFE_RELEASE(_runningScene);
     CC_SAFE_RELEASE(_notificationNode);
@@ -225,6 +268,7 @@ Director::~Director(void)
     CC_SAFE_RELEASE(_eventProjectionChanged);
     CC_SAFE_RELEASE(_eventResetDirector);
 
+    delete _dynamicResolution;
     delete _renderer;
     delete _console;
 
@@ -285,22 +329,40 @@ void Director::setGLDefaultValues()
 // Draw the Scene
 void Director::drawScene()
 {
+    CC_PROFILER_ZONE("Director::drawScene");
+
     // calculate "global" dt
     calculateDeltaTime();
+    updateFramePacing();
+    updateMemoryStats();
     
     if (_openGLView)
     {
         _openGLView->pollEvents();
+        // after the events of the platform, before the scheduled callbacks
+        _openGLView->dispatchPendingTouchMoves();
     }
 
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID || CC_TARGET_PLATFORM == CC_PLATFORM_IOS || CC_TARGET_PLATFORM == CC_PLATFORM_MAC || CC_TARGET_PLATFORM == CC_PLATFORM_LINUX || CC_TARGET_PLATFORM == CC_PLATFORM_WIN32)
+    Controller::updateStates();
+#endif
+
+    // the pipelined updates of the last frame share data with the scheduled callbacks
+    waitForPipelinedUpdates();
+
     //tick before glClear: issue #533
     if (! _paused)
     {
         _eventDispatcher->dispatchEvent(_eventBeforeUpdate);
         _scheduler->update(_deltaTime);
         _eventDispatcher->dispatchEvent(_eventAfterUpdate);
+
+        // they run while the scene is visited and rendered
+        startPipelinedUpdates();
     }
 
+    _renderer->beginGPUTimingFrame();
+    _dynamicResolution->update(_deltaTime);
     _renderer->clear();
     experimental::FrameBuffer::clearAllFBOs();
     
@@ -323,6 +385,7 @@ void Director::drawScene()
 #endif
         //clear draw stats
         _renderer->clearDrawStats();
+        GL::resetSkippedStateCalls();
         
         //render the scene
         _openGLView->renderScene(_runningScene, _renderer);
@@ -374,6 +437,8 @@ void Director::calculateDeltaTime()
     {
         _deltaTime = 0;
         _nextDeltaTimeZero = false;
+        // the frames before the pause don't tell anything about the next ones
+        resetDeltaTimeSmoothing();
     }
     else
     {
@@ -385,6 +450,15 @@ void Director::calculateDeltaTime()
             _lastUpdate = now;
         }
         _deltaTime = MAX(0, _deltaTime);
+
+        if (_fixedDeltaTime > 0)
+        {
+            _deltaTime = _fixedDeltaTime;
+        }
+        else if (_deltaTimeSmoothingEnabled)
+        {
+            _deltaTime = smoothDeltaTime(_deltaTime);
+        }
     }
 
 #if COCOS2D_DEBUG
@@ -400,6 +474,185 @@ float Director::getDeltaTime() const
 {
     return _deltaTime;
 }
+
+float Director::smoothDeltaTime(float deltaTime)
+{
+    _deltaTimeHistory[_deltaTimeHistoryIndex] = deltaTime;
+    _deltaTimeHistoryIndex = (_deltaTimeHistoryIndex + 1) % DELTA_TIME_HISTORY_SIZE;
+    _deltaTimeHistoryCount = MIN(_deltaTimeHistoryCount + 1, (int)DELTA_TIME_HISTORY_SIZE);
+
+    float average = 0;
+    for (int i = 0; i < _deltaTimeHistoryCount; ++i)
+    {
+        average += _deltaTimeHistory[i];
+    }
+    average /= _deltaTimeHistoryCount;
+
+    // pay back half of what the smoothed times are late or early, the sum follows the real time
+    float smoothed = MAX(0, average + _deltaTimeResidual * 0.5f);
+    _deltaTimeResidual += deltaTime - smoothed;
+    return smoothed;
+}
+
+void Director::resetDeltaTimeSmoothing()
+{
+    _deltaTimeHistoryCount = 0;
+    _deltaTimeHistoryIndex = 0;
+    _deltaTimeResidual = 0;
+}
+
+void Director::setDeltaTimeSmoothingEnabled(bool enabled)
+{
+    if (_deltaTimeSmoothingEnabled != enabled)
+    {
+        _deltaTimeSmoothingEnabled = enabled;
+        resetDeltaTimeSmoothing();
+    }
+}
+
+void Director::setIdleAnimationInterval(float interval, float timeout)
+{
+    _idleAnimationInterval = MAX(0, interval);
+    _idleTimeout = MAX(0, timeout);
+    _idleTime = 0;
+    _isIdle = false;
+    applyEffectiveAnimationInterval();
+}
+
+void Director::notifyActivity()
+{
+    _idleTime = 0;
+    if (_isIdle)
+    {
+        _isIdle = false;
+        applyEffectiveAnimationInterval();
+        // the idle frames are slower than the next ones
+        resetDeltaTimeSmoothing();
+    }
+}
+
+void Director::setThermalState(ThermalState state)
+{
+    if (_thermalState == state)
+    {
+        return;
+    }
+
+    _thermalState = state;
+    applyEffectiveAnimationInterval();
+
+    EventCustom event(EVENT_THERMAL_STATE_CHANGED);
+    event.setUserData(&_thermalState);
+    _eventDispatcher->dispatchEvent(&event);
+}
+
+void Director::setThermalAnimationInterval(ThermalState state, float interval)
+{
+    _thermalAnimationIntervals[(int)state] = MAX(0, interval);
+    applyEffectiveAnimationInterval();
+}
+
+float Director::getEffectiveAnimationInterval() const
+{
+    float interval = MAX(_animationInterval, _thermalAnimationIntervals[(int)_thermalState]);
+    if (_isIdle)
+    {
+        interval = MAX(interval, _idleAnimationInterval);
+    }
+    return interval;
+}
+
+void Director::updateFramePacing()
+{
+    if (_idleAnimationInterval <= 0 || _paused)
+    {
+        return;
+    }
+
+    if (_actionManager->getNumberOfRunningActions() > 0)
+    {
+        _idleTime = 0;
+    }
+    else
+    {
+        _idleTime += _deltaTime;
+    }
+
+    bool isIdle = _idleTime >= _idleTimeout;
+    if (isIdle != _isIdle)
+    {
+        _isIdle = isIdle;
+        applyEffectiveAnimationInterval();
+    }
+}
+
+void Director::schedulePipelinedUpdate(const std::function<void(float)>& callback, const std::string& key)
+{
+    CCASSERT(callback, "Invalid callback");
+    waitForPipelinedUpdates();
+
+    for (auto& update : _pipelinedUpdates)
+    {
+        if (update.first == key)
+        {
+            update.second = callback;
+            return;
+        }
+    }
+    _pipelinedUpdates.push_back(std::make_pair(key, callback));
+}
+
+void Director::unschedulePipelinedUpdate(const std::string& key)
+{
+    waitForPipelinedUpdates();
+
+    auto iter = std::find_if(_pipelinedUpdates.begin(), _pipelinedUpdates.end(), [&key](const std::pair<std::string, std::function<void(float)>>& update) {
+        return update.first == key;
+    });
+    if (iter != _pipelinedUpdates.end())
+    {
+        _pipelinedUpdates.erase(iter);
+    }
+}
+
+void Director::startPipelinedUpdates()
+{
+    if (_pipelinedUpdates.empty())
+    {
+        return;
+    }
+
+    // _pipelinedUpdates isn't modified before the job is waited for
+    float dt = _deltaTime;
+    _pipelinedUpdateJob = JobSystem::getInstance()->schedule([this, dt]() {
+        for (const auto& update : _pipelinedUpdates)
+        {
+            update.second(dt);
+        }
+    });
+}
+
+void Director::waitForPipelinedUpdates()
+{
+    if (_pipelinedUpdateJob)
+    {
+        JobSystem::getInstance()->wait(std::static_pointer_cast<JobSystem::Job>(_pipelinedUpdateJob));
+        _pipelinedUpdateJob.reset();
+    }
+}
+
+void Director::applyEffectiveAnimationInterval()
+{
+    float interval = getEffectiveAnimationInterval();
+    // paused: resume() starts the animation again with the effective interval
+    if (_invalid || _paused || interval == _appliedAnimationInterval)
+    {
+        return;
+    }
+
+    _appliedAnimationInterval = interval;
+    Application::getInstance()->setAnimationInterval(interval, SetIntervalReason::BY_ENGINE);
+}
 void Director::setOpenGLView(GLView *openGLView)
 {
     CCASSERT(openGLView, "opengl view should not be null");
@@ -728,11 +981,18 @@ void Director::purgeCachedData(void)
 {
     FontFNT::purgeCachedData();
     FontAtlasCache::purgeCachedData();
+    ParticleSystem::purgeCachedData();
+    ParticleSystemQuad::purgePool();
+    TransitionScene::purgeSnapshotPool();
+    AutoPolygon::purgeCache();
+    Properties::purgeCache();
 
     if (s_SharedDirector->getOpenGLView())
     {
         SpriteFrameCache::getInstance()->removeUnusedSpriteFrames();
         _textureCache->removeUnusedTextures();
+        _dynamicResolution->releaseTargets();
+        RenderTargetPool::getInstance()->purge();
 
         // Note: some tests such as ActionsTest are leaking refcounted textures
         // There should be no test textures left in the cache
@@ -741,6 +1001,21 @@ void Director::purgeCachedData(void)
     FileUtils::getInstance()->purgeCachedEntries();
 }
 
+void Director::handleMemoryWarning()
+{
+    // give the game a chance to release its references first
+    EventCustom event(EVENT_MEMORY_WARNING);
+    _eventDispatcher->dispatchEvent(&event);
+
+    if (_textureCache)
+    {
+        CC_UNUSED size_t freed = _textureCache->evictUnusedTextures(0);
+        CCLOG("cocos2d: memory warning, %lu KB of textures evicted", (unsigned long)(freed / 1024));
+    }
+    _dynamicResolution->releaseTargets();
+    RenderTargetPool::getInstance()->purge();
+}
+
 float Director::getZEye(void) const
 {
     return (_winSizeInPoints.height / 1.154700538379252f);//(2 * tanf(M_PI/6))
@@ -1045,6 +1320,9 @@ void Director::restart()
 
 void Director::reset()
 {
+    waitForPipelinedUpdates();
+    _pipelinedUpdates.clear();
+
 #if CC_ENABLE_GC_FOR_NATIVE_OBJECTS
     auto sEngine = ScriptEngineManager::getInstance()->getScriptEngine();
 #endif // CC_ENABLE_GC_FOR_NATIVE_OBJECTS
@@ -1105,12 +1383,24 @@ void Director::reset()
     CC_SAFE_RELEASE_NULL(_FPSLabel);
     CC_SAFE_RELEASE_NULL(_drawnBatchesLabel);
     CC_SAFE_RELEASE_NULL(_drawnVerticesLabel);
+    CC_SAFE_RELEASE_NULL(_gpuTimeLabel);
+    CC_SAFE_RELEASE_NULL(_skippedStateCallsLabel);
+    CC_SAFE_RELEASE_NULL(_batchBreaksLabel);
+    CC_SAFE_RELEASE_NULL(_memoryAllocationsLabel);
+    CC_SAFE_RELEASE_NULL(_memoryTexturesLabel);
+    CC_SAFE_RELEASE_NULL(_memoryRefsLabel);
     
     // purge bitmap cache
     FontFNT::purgeCachedData();
     FontAtlasCache::purgeCachedData();
     
     FontFreeType::shutdownFreeType();
+
+    ParticleSystem::purgeCachedData();
+    ParticleSystemQuad::purgePool();
+    TransitionScene::purgeSnapshotPool();
+    AutoPolygon::purgeCache();
+    Properties::purgeCache();
     
     // purge all managed caches
     
@@ -1131,10 +1421,18 @@ void Director::reset()
 #endif
     AnimationCache::destroyInstance();
     SpriteFrameCache::destroyInstance();
+    _dynamicResolution->releaseTargets();
+    RenderTargetPool::destroyInstance();
     GLProgramCache::destroyInstance();
     GLProgramStateCache::destroyInstance();
+    BoneMatrixTexture::destroyInstance();
+    TimeSlicedQueue::destroyInstance();
+    ComponentSystem::destroyInstance();
     FileUtils::destroyInstance();
+    // the texture cache waits for its decoder jobs, before the job system is gone
+    destroyTextureCache();
     AsyncTaskPool::destroyInstance();
+    JobSystem::destroyInstance();
     
     // cocos2d-x specific data structures
     UserDefault::destroyInstance();
@@ -1142,8 +1440,6 @@ void Director::reset()
     GL::invalidateStateCache();
 
     RenderState::finalize();
-    
-    destroyTextureCache();
 }
 
 void Director::purgeDirector()
@@ -1195,6 +1491,7 @@ void Director::restartDirector()
 void Director::setNextScene()
 {
     _eventDispatcher->dispatchEvent(_beforeSetNextScene);
+    notifyActivity();
 
     bool runningIsTransition = dynamic_cast<TransitionScene*>(_runningScene) != nullptr;
     bool newIsTransition = dynamic_cast<TransitionScene*>(_nextScene) != nullptr;
@@ -1289,6 +1586,7 @@ void Director::showStats()
 
     static unsigned long prevCalls = 0;
     static unsigned long prevVerts = 0;
+    static unsigned long prevSkipped = 0;
 
     ++_frames;
     _accumDt += _deltaTime;
@@ -1306,6 +1604,18 @@ void Director::showStats()
             _FPSLabel->setString(buffer);
             _accumDt = 0;
             _frames = 0;
+
+            // the memory statistics of a single frame are too noisy to be read every frame
+            if (_displayMemoryStats && _memoryAllocationsLabel)
+            {
+                auto stats = getMemoryStats();
+                sprintf(buffer, "Allocs:%6lu %6luK", (unsigned long)stats.frameAllocations, (unsigned long)(stats.frameAllocatedBytes / 1024));
+                _memoryAllocationsLabel->setString(buffer);
+                sprintf(buffer, "Tex KB:%7lu", (unsigned long)(stats.textureMemory / 1024));
+                _memoryTexturesLabel->setString(buffer);
+                sprintf(buffer, "Refs:%7u AR:%5lu", stats.liveRefCount, (unsigned long)stats.frameAutoreleaseCount);
+                _memoryRefsLabel->setString(buffer);
+            }
         }
 
         auto currentCalls = (unsigned long)_renderer->getDrawnBatches();
@@ -1322,7 +1632,46 @@ void Director::showStats()
             prevVerts = currentVerts;
         }
 
+        auto currentSkipped = (unsigned long)GL::getSkippedStateCalls();
+        if (_skippedStateCallsLabel && currentSkipped != prevSkipped) {
+            sprintf(buffer, "GL skip:%6lu", currentSkipped);
+            _skippedStateCallsLabel->setString(buffer);
+            prevSkipped = currentSkipped;
+        }
+
         const Mat4& identity = Mat4::IDENTITY;
+        if (_gpuTimeLabel && _renderer->isGPUTimingEnabled())
+        {
+            sprintf(buffer, "GPU ms:%6.2f", _renderer->getGPUFrameTime());
+            _gpuTimeLabel->setString(buffer);
+            _gpuTimeLabel->visit(_renderer, identity, 0);
+        }
+        if (_skippedStateCallsLabel)
+        {
+            _skippedStateCallsLabel->visit(_renderer, identity, 0);
+        }
+        if (_batchBreaksLabel && _renderer->isBatchBreakStatisticsEnabled())
+        {
+            // the total, and the cause of most of the breaks
+            const auto& statistics = _renderer->getBatchBreakStatistics();
+            long total = 0;
+            int topCause = (int)Renderer::BatchBreakCause::COUNT;
+            for (int cause = 0; cause < (int)Renderer::BatchBreakCause::COUNT; ++cause)
+            {
+                total += (long)statistics.causes[cause];
+                if (statistics.causes[cause] > 0 && (topCause == (int)Renderer::BatchBreakCause::COUNT || statistics.causes[cause] > statistics.causes[topCause]))
+                    topCause = cause;
+            }
+            sprintf(buffer, "Breaks:%5ld %.12s", total, Renderer::getBatchBreakCauseName((Renderer::BatchBreakCause)topCause));
+            _batchBreaksLabel->setString(buffer);
+            _batchBreaksLabel->visit(_renderer, identity, 0);
+        }
+        if (_displayMemoryStats && _memoryAllocationsLabel)
+        {
+            _memoryRefsLabel->visit(_renderer, identity, 0);
+            _memoryTexturesLabel->visit(_renderer, identity, 0);
+            _memoryAllocationsLabel->visit(_renderer, identity, 0);
+        }
         _drawnVerticesLabel->visit(_renderer, identity, 0);
         _drawnBatchesLabel->visit(_renderer, identity, 0);
         _FPSLabel->visit(_renderer, identity, 0);
@@ -1352,15 +1701,33 @@ void Director::createStatsLabel()
     std::string fpsString = "00.0";
     std::string drawBatchString = "000";
     std::string drawVerticesString = "00000";
+    std::string gpuTimeString = "0.00";
+    std::string skippedStateCallsString = "000";
+    std::string batchBreaksString = "Breaks:";
+    std::string memoryAllocationsString = "Allocs:";
+    std::string memoryTexturesString = "Tex KB:";
+    std::string memoryRefsString = "Refs:";
     if (_FPSLabel)
     {
         fpsString = _FPSLabel->getString();
         drawBatchString = _drawnBatchesLabel->getString();
         drawVerticesString = _drawnVerticesLabel->getString();
+        gpuTimeString = _gpuTimeLabel->getString();
+        skippedStateCallsString = _skippedStateCallsLabel->getString();
+        batchBreaksString = _batchBreaksLabel->getString();
+        memoryAllocationsString = _memoryAllocationsLabel->getString();
+        memoryTexturesString = _memoryTexturesLabel->getString();
+        memoryRefsString = _memoryRefsLabel->getString();
         
         CC_SAFE_RELEASE_NULL(_FPSLabel);
         CC_SAFE_RELEASE_NULL(_drawnBatchesLabel);
         CC_SAFE_RELEASE_NULL(_drawnVerticesLabel);
+        CC_SAFE_RELEASE_NULL(_gpuTimeLabel);
+        CC_SAFE_RELEASE_NULL(_skippedStateCallsLabel);
+        CC_SAFE_RELEASE_NULL(_batchBreaksLabel);
+        CC_SAFE_RELEASE_NULL(_memoryAllocationsLabel);
+        CC_SAFE_RELEASE_NULL(_memoryTexturesLabel);
+        CC_SAFE_RELEASE_NULL(_memoryRefsLabel);
         _textureCache->removeTextureForKey("/cc_fps_images");
         FileUtils::getInstance()->purgeCachedEntries();
     }
@@ -1409,10 +1776,51 @@ void Director::createStatsLabel()
     _drawnVerticesLabel->initWithString(drawVerticesString, texture, 12, 32, '.');
     _drawnVerticesLabel->setScale(scaleFactor);
 
+    _gpuTimeLabel = LabelAtlas::create();
+    _gpuTimeLabel->retain();
+    _gpuTimeLabel->setIgnoreContentScaleFactor(true);
+    _gpuTimeLabel->initWithString(gpuTimeString, texture, 12, 32, '.');
+    _gpuTimeLabel->setScale(scaleFactor);
+
+    _skippedStateCallsLabel = LabelAtlas::create();
+    _skippedStateCallsLabel->retain();
+    _skippedStateCallsLabel->setIgnoreContentScaleFactor(true);
+    _skippedStateCallsLabel->initWithString(skippedStateCallsString, texture, 12, 32, '.');
+    _skippedStateCallsLabel->setScale(scaleFactor);
+
+    _batchBreaksLabel = LabelAtlas::create();
+    _batchBreaksLabel->retain();
+    _batchBreaksLabel->setIgnoreContentScaleFactor(true);
+    _batchBreaksLabel->initWithString(batchBreaksString, texture, 12, 32, '.');
+    _batchBreaksLabel->setScale(scaleFactor);
+
+    _memoryAllocationsLabel = LabelAtlas::create();
+    _memoryAllocationsLabel->retain();
+    _memoryAllocationsLabel->setIgnoreContentScaleFactor(true);
+    _memoryAllocationsLabel->initWithString(memoryAllocationsString, texture, 12, 32, '.');
+    _memoryAllocationsLabel->setScale(scaleFactor);
+
+    _memoryTexturesLabel = LabelAtlas::create();
+    _memoryTexturesLabel->retain();
+    _memoryTexturesLabel->setIgnoreContentScaleFactor(true);
+    _memoryTexturesLabel->initWithString(memoryTexturesString, texture, 12, 32, '.');
+    _memoryTexturesLabel->setScale(scaleFactor);
+
+    _memoryRefsLabel = LabelAtlas::create();
+    _memoryRefsLabel->retain();
+    _memoryRefsLabel->setIgnoreContentScaleFactor(true);
+    _memoryRefsLabel->initWithString(memoryRefsString, texture, 12, 32, '.');
+    _memoryRefsLabel->setScale(scaleFactor);
 
     Texture2D::setDefaultAlphaPixelFormat(currentFormat);
 
     const int height_spacing = 22 / CC_CONTENT_SCALE_FACTOR();
+    _batchBreaksLabel->setPosition(Vec2(0, height_spacing*8) + CC_DIRECTOR_STATS_POSITION);
+    _memoryRefsLabel->setPosition(Vec2(0, height_spacing*7) + CC_DIRECTOR_STATS_POSITION);
+    _memoryTexturesLabel->setPosition(Vec2(0, height_spacing*6) + CC_DIRECTOR_STATS_POSITION);
+    _memoryAllocationsLabel->setPosition(Vec2(0, height_spacing*5) + CC_DIRECTOR_STATS_POSITION);
+    _skippedStateCallsLabel->setPosition(Vec2(0, height_spacing*4) + CC_DIRECTOR_STATS_POSITION);
+    _gpuTimeLabel->setPosition(Vec2(0, height_spacing*3) + CC_DIRECTOR_STATS_POSITION);
     _drawnVerticesLabel->setPosition(Vec2(0, height_spacing*2) + CC_DIRECTOR_STATS_POSITION);
     _drawnBatchesLabel->setPosition(Vec2(0, height_spacing*1) + CC_DIRECTOR_STATS_POSITION);
     _FPSLabel->setPosition(Vec2(0, height_spacing*0)+CC_DIRECTOR_STATS_POSITION);
@@ -1420,6 +1828,80 @@ void Director::createStatsLabel()
 
 #endif // #if !CC_STRIP_FPS
 
+void Director::updateMemoryStats()
+{
+    auto heapStats = allocator::getHeapStats();
+    _frameAllocations = heapStats.allocations - _frameStartAllocations;
+    _frameAllocatedBytes = heapStats.allocatedBytes - _frameStartAllocatedBytes;
+    _frameStartAllocations = heapStats.allocations;
+    _frameStartAllocatedBytes = heapStats.allocatedBytes;
+}
+
+Director::MemoryStats Director::getMemoryStats() const
+{
+    auto heapStats = allocator::getHeapStats();
+
+    MemoryStats stats;
+    stats.frameAllocations = _frameAllocations;
+    stats.frameAllocatedBytes = _frameAllocatedBytes;
+    stats.heapAllocations = heapStats.allocations - heapStats.deallocations;
+    stats.textureMemory = Texture2D::getTotalTextureMemory();
+    stats.cachedTextureCount = _textureCache ? _textureCache->getTextureCount() : 0;
+    stats.spriteFrameCount = SpriteFrameCache::getInstance()->getSpriteFrameCount();
+    stats.fontAtlasCount = FontAtlasCache::getFontAtlasCount();
+    stats.liveRefCount = Ref::getLiveCount();
+    stats.frameAutoreleaseCount = PoolManager::getInstance()->getCurrentPool()->getLastClearCount();
+    return stats;
+}
+
+std::string Director::getMemoryStatsDescription() const
+{
+    auto stats = getMemoryStats();
+    char buffer[256];
+    std::string description;
+
+#if CC_ENABLE_MEMORY_STATS
+    snprintf(buffer, sizeof(buffer), "heap: %llu allocations, %llu KB in the last frame, %llu allocations alive\n",
+             (unsigned long long)stats.frameAllocations, (unsigned long long)(stats.frameAllocatedBytes / 1024),
+             (unsigned long long)stats.heapAllocations);
+    description += buffer;
+#else
+    description += "heap: not counted, enable CC_ENABLE_MEMORY_STATS\n";
+#endif
+
+    snprintf(buffer, sizeof(buffer), "textures: %.2f MB, %ld cached\n", stats.textureMemory / (1024.0 * 1024.0), (long)stats.cachedTextureCount);
+    description += buffer;
+    for (const auto& format : Texture2D::getTextureMemoryByFormat())
+    {
+        snprintf(buffer, sizeof(buffer), "    %s: %.2f MB\n", Texture2D::getStringForFormat(format.first), format.second / (1024.0 * 1024.0));
+        description += buffer;
+    }
+
+    snprintf(buffer, sizeof(buffer), "sprite frames: %ld\nfont atlases: %ld\nrefs: %u alive\n",
+             (long)stats.spriteFrameCount, (long)stats.fontAtlasCount, stats.liveRefCount);
+    description += buffer;
+#if CC_REF_LEAK_DETECTION
+    for (const auto& type : Ref::getLiveStatistics())
+    {
+        snprintf(buffer, sizeof(buffer), "    %s: %u\n", type.first.c_str(), type.second);
+        description += buffer;
+    }
+#endif
+
+    auto pool = PoolManager::getInstance()->getCurrentPool();
+    snprintf(buffer, sizeof(buffer), "autorelease: %lu released in the last frame\n", (unsigned long)stats.frameAutoreleaseCount);
+    description += buffer;
+    if (pool->isStatisticsEnabled())
+    {
+        for (const auto& type : pool->getLastClearStatistics())
+        {
+            snprintf(buffer, sizeof(buffer), "    %s: %u\n", type.first.c_str(), type.second);
+            description += buffer;
+        }
+    }
+    return description;
+}
+
 void Director::setContentScaleFactor(float scaleFactor)
 {
     if (scaleFactor != _contentScaleFactor)
@@ -1489,7 +1971,8 @@ void Director::startAnimation(SetIntervalReason reason)
 
     _cocos2d_thread_id = std::this_thread::get_id();
 
-    Application::getInstance()->setAnimationInterval(_animationInterval, reason);
+    _appliedAnimationInterval = getEffectiveAnimationInterval();
+    Application::getInstance()->setAnimationInterval(_appliedAnimationInterval, reason);
 
     // fix issue #3509, skip one fps to avoid incorrect time calculation.
     setNextDeltaTimeZero(true);
@@ -31,6 +31,8 @@ THE SOFTWARE.
 #include <stack>
 #include <thread>
 #include <chrono>
+#include <functional>
+#include <memory>
 
 #include "platform/CCPlatformMacros.h"
 #include "base/CCRef.h"
@@ -59,6 +61,7 @@ class EventCustom;
 class EventListenerCustom;
 class TextureCache;
 class Renderer;
+class DynamicResolution;
 class Camera;
 
 class Console;
@@ -116,6 +119,8 @@ public:
     static const char* EVENT_AFTER_DRAW;
     /** Director will trigger an event before a scene is drawn, right after clear. */
     static const char* EVENT_BEFORE_DRAW;
+    /** Director will trigger an event when the thermal state changes, the user data points to the new `ThermalState`. */
+    static const char* EVENT_THERMAL_STATE_CHANGED;
 
     /**
      * @brief Possible OpenGL projections used by director
@@ -134,6 +139,18 @@ public:
         /// Default projection is 3D projection.
         DEFAULT = _3D,
     };
+
+    /**
+     * @brief Thermal states of the device, from the coolest to the hottest.
+     * @since v3.14
+     */
+    enum class ThermalState
+    {
+        NOMINAL,
+        FAIR,
+        SERIOUS,
+        CRITICAL,
+    };
     
     /** 
      * Returns a shared instance of the director. 
@@ -173,6 +190,47 @@ public:
     bool isDisplayStats() { return _displayStats; }
     /** Display the FPS on the bottom-left corner of the screen. */
     void setDisplayStats(bool displayStats) { _displayStats = displayStats; }
+
+    /** Memory statistics of the engine, see getMemoryStats().
+     * @since v3.14
+     */
+    struct MemoryStats
+    {
+        /** Heap allocations and allocated bytes of the last frame, counted when CC_ENABLE_MEMORY_STATS is enabled. */
+        uint64_t frameAllocations;
+        uint64_t frameAllocatedBytes;
+        /** Heap allocations not freed yet, counted when CC_ENABLE_MEMORY_STATS is enabled. */
+        uint64_t heapAllocations;
+        /** OpenGL memory of the alive textures in bytes, see Texture2D::getTextureMemoryByFormat(). */
+        size_t textureMemory;
+        ssize_t cachedTextureCount;
+        ssize_t spriteFrameCount;
+        ssize_t fontAtlasCount;
+        /** Alive Ref objects, counted when CC_ENABLE_MEMORY_STATS or CC_REF_LEAK_DETECTION is enabled. */
+        unsigned int liveRefCount;
+        /** Objects released by the autorelease pool at the end of the last frame. */
+        size_t frameAutoreleaseCount;
+    };
+
+    /** Returns the memory statistics of the engine and of the last frame.
+     * @since v3.14
+     */
+    MemoryStats getMemoryStats() const;
+
+    /** Returns a text report of the memory statistics, with the texture memory by pixel format, and the alive
+     * Ref objects and the autoreleased objects by type when CC_REF_LEAK_DETECTION and the statistics of the pool
+     * are enabled. It's printed by the "memory" command of the Console.
+     * @since v3.14
+     */
+    std::string getMemoryStatsDescription() const;
+
+    /** Whether or not the memory statistics are displayed above the FPS, disabled by default.
+     * They're only displayed with the FPS, see setDisplayStats().
+     * @since v3.14
+     */
+    void setDisplayMemoryStats(bool displayMemoryStats) { _displayMemoryStats = displayMemoryStats; }
+    /** Whether or not the memory statistics are displayed. @since v3.14 */
+    bool isDisplayMemoryStats() const { return _displayMemoryStats; }
     
     /** Get seconds per frame. */
     float getSecondsPerFrame() { return _secondsPerFrame; }
@@ -206,6 +264,82 @@ public:
     /** Whether or not the Director is paused. */
     bool isPaused() { return _paused; }
 
+    /**
+     * Lowers the frame rate to 1/interval while the scene is idle: no input event was received, no action was running
+     * and notifyActivity() was not called for `timeout` seconds. The next input event restores the frame rate.
+     * An interval of 0 disables it, it's the default.
+     * @since v3.14
+     */
+    void setIdleAnimationInterval(float interval, float timeout = 2.0f);
+    /** The animation interval used while the scene is idle, 0 if it is disabled. @since v3.14 */
+    float getIdleAnimationInterval() const { return _idleAnimationInterval; }
+    /** Whether or not the frame rate is lowered because the scene is idle. @since v3.14 */
+    bool isIdle() const { return _isIdle; }
+    /**
+     * Keeps the scene out of the idle frame rate, eg: call it every frame while nodes are animated by `update()`.
+     * The input events and the scene changes call it.
+     * @since v3.14
+     */
+    void notifyActivity();
+
+    /**
+     * Sets the thermal state of the device, the platforms that report it call this.
+     * The frame rate is limited by the interval of the state set with setThermalAnimationInterval(), and
+     * `EVENT_THERMAL_STATE_CHANGED` is dispatched so that the game can lower its workload.
+     * @since v3.14
+     */
+    void setThermalState(ThermalState state);
+    /** The current thermal state, NOMINAL if the platform doesn't report it. @since v3.14 */
+    ThermalState getThermalState() const { return _thermalState; }
+    /**
+     * Sets the minimum animation interval used in a thermal state, 0 to not limit the frame rate.
+     * The defaults are 1/30 for SERIOUS, 1/20 for CRITICAL and 0 for the others.
+     * @since v3.14
+     */
+    void setThermalAnimationInterval(ThermalState state, float interval);
+    /**
+     * The interval asked to the platform: the largest of the animation interval, the idle interval while the scene
+     * is idle and the interval of the thermal state.
+     * @since v3.14
+     */
+    float getEffectiveAnimationInterval() const;
+
+    /**
+     * Enable/Disable smoothing the delta time. The average of the last frames is used, and the difference with the
+     * real elapsed time is carried over to the next frames, so the game time doesn't drift. Disabled by default.
+     * @since v3.14
+     */
+    void setDeltaTimeSmoothingEnabled(bool enabled);
+    /** Whether or not the delta time is smoothed. @since v3.14 */
+    bool isDeltaTimeSmoothingEnabled() const { return _deltaTimeSmoothingEnabled; }
+
+    /**
+     * Sets a fixed delta time. When greater than 0, each frame advances the game time by this value instead of the
+     * measured time, so runs are reproducible whatever the frame rate, eg: benchmarks and replays. 0 by default.
+     * @since v3.14
+     */
+    void setFixedDeltaTime(float deltaTime) { _fixedDeltaTime = MAX(0, deltaTime); }
+    /** Returns the fixed delta time, 0 if the measured time is used. @since v3.14 */
+    float getFixedDeltaTime() const { return _fixedDeltaTime; }
+
+    /**
+     * Schedules a callback of the pipelined update stage, eg: the game simulation.
+     * The pipelined updates of a frame run on a `JobSystem` worker after `Scheduler::update()`, while the cocos thread
+     * visits the scene and sends it to OpenGL, and they are finished before the next `Scheduler::update()`.
+     * So they can share data with the scheduled callbacks without locks, the results are used by the next frame.
+     * They must not touch the nodes, the scheduler, the event dispatcher, the renderer, the caches or OpenGL,
+     * which the cocos thread uses meanwhile. They get the delta time of the frame and don't run while paused.
+     * @param callback The callback, called with the delta time.
+     * @param key The key to unschedule it, a callback with the same key is replaced.
+     * @since v3.14
+     * @js NA
+     */
+    void schedulePipelinedUpdate(const std::function<void(float)>& callback, const std::string& key);
+    /** Unschedules a pipelined update, it waits for it if it is running. @since v3.14 @js NA */
+    void unschedulePipelinedUpdate(const std::string& key);
+    /** Blocks until the pipelined updates of the frame have run, the Director calls it before `Scheduler::update()`. @since v3.14 */
+    void waitForPipelinedUpdates();
+
     /** How many frames were called since the director started */
     unsigned int getTotalFrames() { return _totalFrames; }
     
@@ -374,6 +508,13 @@ public:
      */
     void purgeCachedData();
 
+    /** Called by the platform when the system is running low on memory.
+     * It dispatches EVENT_MEMORY_WARNING and then evicts the unused textures that aren't pinned,
+     * see TextureCache::evictUnusedTextures().
+     * @since v3.14
+     */
+    void handleMemoryWarning();
+
 	/** Sets the default values based on the Configuration info. */
     void setDefaultValues();
 
@@ -453,6 +594,13 @@ public:
      */
     Renderer* getRenderer() const { return _renderer; }
 
+    /** Returns the DynamicResolution scaling the world cameras to hold the frame rate, disabled by default.
+     * @since v3.14
+     * @js NA
+     * @lua NA
+     */
+    DynamicResolution* getDynamicResolution() const { return _dynamicResolution; }
+
     /** Returns the Console associated with this director.
      * @since v3.0
      * @js NA
@@ -607,6 +755,12 @@ protected:
     
     /** calculates delta time since last time it was called */    
     void calculateDeltaTime();
+    float smoothDeltaTime(float deltaTime);
+    void resetDeltaTimeSmoothing();
+
+    /** updates the idle state and asks the platform for the effective animation interval if it changed */
+    void updateFramePacing();
+    void applyEffectiveAnimationInterval();
 
     //textureCache creation or release
     void initTextureCache();
@@ -661,6 +815,21 @@ protected:
     LabelAtlas *_FPSLabel;
     LabelAtlas *_drawnBatchesLabel;
     LabelAtlas *_drawnVerticesLabel;
+    LabelAtlas *_gpuTimeLabel;
+    LabelAtlas *_skippedStateCallsLabel;
+    /* shown while Renderer::isBatchBreakStatisticsEnabled() */
+    LabelAtlas *_batchBreaksLabel;
+
+    /* memory statistics, the heap counters are sampled at the start of each frame */
+    bool _displayMemoryStats;
+    LabelAtlas *_memoryAllocationsLabel;
+    LabelAtlas *_memoryTexturesLabel;
+    LabelAtlas *_memoryRefsLabel;
+    uint64_t _frameStartAllocations;
+    uint64_t _frameStartAllocatedBytes;
+    uint64_t _frameAllocations;
+    uint64_t _frameAllocatedBytes;
+    void updateMemoryStats();
     
     /** Whether or not the Director is paused */
     bool _paused;
@@ -688,6 +857,29 @@ protected:
 
     /* whether or not the next delta time will be zero */
     bool _nextDeltaTimeZero;
+
+    /* frame pacing */
+    float _appliedAnimationInterval;
+    float _idleAnimationInterval;
+    float _idleTimeout;
+    float _idleTime;
+    bool _isIdle;
+    ThermalState _thermalState;
+    float _thermalAnimationIntervals[4];
+
+    /* pipelined update stage, _pipelinedUpdateJob is a JobSystem::JobHandle */
+    std::vector<std::pair<std::string, std::function<void(float)>>> _pipelinedUpdates;
+    std::shared_ptr<void> _pipelinedUpdateJob;
+    void startPipelinedUpdates();
+
+    /* delta time smoothing */
+    enum { DELTA_TIME_HISTORY_SIZE = 4 };
+    bool _deltaTimeSmoothingEnabled;
+    float _fixedDeltaTime;
+    float _deltaTimeHistory[DELTA_TIME_HISTORY_SIZE];
+    int _deltaTimeHistoryCount;
+    int _deltaTimeHistoryIndex;
+    float _deltaTimeResidual;
     
     /* projection used */
     Projection _projection;
@@ -703,6 +895,9 @@ protected:
 
     /* Renderer for the Director */
     Renderer *_renderer;
+
+    /* The dynamic resolution of the world cameras */
+    DynamicResolution* _dynamicResolution;
     
     /* Default FrameBufferObject*/
     experimental::FrameBuffer* _defaultFBO;
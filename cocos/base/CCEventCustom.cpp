@@ -25,8 +25,14 @@
 #include "base/CCEventCustom.h"
 #include "base/CCEvent.h"
 
+#if CC_ENABLE_ALLOCATOR && CC_ENABLE_ENGINE_ALLOCATOR_POOLS
+#include "base/allocator/CCAllocatorStrategyPool.h"
+#endif
+
 NS_CC_BEGIN
 
+CC_DEFINE_ALLOCATOR_POOL(EventCustom, 64)
+
 EventCustom::EventCustom(const std::string& eventName)
 : Event(Type::CUSTOM)
 , _userData(nullptr)
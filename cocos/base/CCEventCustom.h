@@ -41,6 +41,8 @@ NS_CC_BEGIN
 class CC_DLL EventCustom : public Event
 {
 public:
+    CC_DECLARE_ALLOCATOR_POOL(EventCustom)
+
     /** Constructor.
      *
      * @param eventName A given name of the custom event.
@@ -37,8 +37,12 @@
 #include "2d/CCScene.h"
 #include "base/CCDirector.h"
 #include "base/CCEventType.h"
+#include "base/CCProfiling.h"
 #include "2d/CCCamera.h"
 
+#include <climits>
+#include <mutex>
+
 #define DUMP_LISTENER_ITEM_PRIORITY_INFO 0
 
 namespace
@@ -66,6 +70,197 @@ private:
 
 NS_CC_BEGIN
 
+/** World space grid of the hit rectangles of hit tested touch listeners, see EventListenerTouchOneByOne::setHitTestEnabled().
+ *  Bounds are cached and only computed again after the node reports a dirty transform while it's visited,
+ *  which might happen on a worker thread.
+ */
+class HitTestIndex
+{
+public:
+    HitTestIndex()
+    : _queryStamp(0)
+    {
+    }
+
+    bool empty() const { return _entries.empty(); }
+
+    void add(Node* node, EventListenerTouchOneByOne* listener)
+    {
+        CCASSERT(node->_hitTestListeners < USHRT_MAX, "Too many hit tested listeners for one node.");
+        Entry& entry = _entries[listener];
+        entry.node = node;
+        entry.listener = listener;
+        entry.linked = false;
+        entry.dirty = true;
+        _dirtyEntries.push_back(&entry);
+        _nodeEntries[node].push_back(&entry);
+        ++node->_hitTestListeners;
+    }
+
+    void remove(EventListenerTouchOneByOne* listener)
+    {
+        auto found = _entries.find(listener);
+        if (found == _entries.end())
+            return;
+
+        Entry* entry = &found->second;
+        unlink(entry);
+        if (entry->dirty)
+            _dirtyEntries.erase(std::find(_dirtyEntries.begin(), _dirtyEntries.end(), entry));
+
+        Node* node = entry->node;
+        auto& nodeEntries = _nodeEntries[node];
+        nodeEntries.erase(std::find(nodeEntries.begin(), nodeEntries.end(), entry));
+        if (nodeEntries.empty())
+        {
+            _nodeEntries.erase(node);
+            std::lock_guard<std::mutex> lock(_dirtyNodesMutex);
+            _dirtyNodes.erase(std::remove(_dirtyNodes.begin(), _dirtyNodes.end(), node), _dirtyNodes.end());
+        }
+        --node->_hitTestListeners;
+        _entries.erase(found);
+    }
+
+    void setDirty(Node* node)
+    {
+        std::lock_guard<std::mutex> lock(_dirtyNodesMutex);
+        _dirtyNodes.push_back(node);
+    }
+
+    /** Stamps the listeners whose bounds contain the point, returns the stamp */
+    unsigned int query(const Vec2& point)
+    {
+        update();
+
+        if (++_queryStamp == 0)
+            ++_queryStamp;
+
+        auto found = _cells.find(cellKey(cellCoord(point.x), cellCoord(point.y)));
+        if (found != _cells.end())
+            stamp(found->second, point);
+        stamp(_largeEntries, point);
+        return _queryStamp;
+    }
+
+private:
+    struct Entry
+    {
+        Node* node;
+        EventListenerTouchOneByOne* listener;
+        Rect bounds;
+        int minX, minY, maxX, maxY;
+        bool linked;
+        bool large;
+        bool dirty;
+    };
+
+    static const int CELL_SIZE = 128;
+    // entries covering more cells are kept in a single list
+    static const int MAX_CELLS = 64;
+
+    static int cellCoord(float value) { return static_cast<int>(std::floor(value / CELL_SIZE)); }
+    static int64_t cellKey(int x, int y) { return (static_cast<int64_t>(x) << 32) | static_cast<uint32_t>(y); }
+
+    void stamp(const std::vector<Entry*>& entries, const Vec2& point)
+    {
+        for (auto entry : entries)
+        {
+            if (entry->bounds.containsPoint(point))
+                entry->listener->_hitTestStamp = _queryStamp;
+        }
+    }
+
+    void update()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_dirtyNodesMutex);
+            for (auto node : _dirtyNodes)
+            {
+                auto found = _nodeEntries.find(node);
+                if (found == _nodeEntries.end())
+                    continue;
+                for (auto entry : found->second)
+                {
+                    if (!entry->dirty)
+                    {
+                        entry->dirty = true;
+                        _dirtyEntries.push_back(entry);
+                    }
+                }
+            }
+            _dirtyNodes.clear();
+        }
+
+        for (auto entry : _dirtyEntries)
+        {
+            unlink(entry);
+            entry->dirty = false;
+
+            Rect rect = entry->listener->_hitTestRect;
+            if (rect.equals(Rect::ZERO))
+                rect.size = entry->node->getContentSize();
+            entry->bounds = RectApplyTransform(rect, entry->node->getNodeToWorldTransform());
+            link(entry);
+        }
+        _dirtyEntries.clear();
+    }
+
+    void link(Entry* entry)
+    {
+        const Rect& bounds = entry->bounds;
+        entry->minX = cellCoord(bounds.getMinX());
+        entry->minY = cellCoord(bounds.getMinY());
+        entry->maxX = cellCoord(bounds.getMaxX());
+        entry->maxY = cellCoord(bounds.getMaxY());
+        entry->large = static_cast<int64_t>(entry->maxX - entry->minX + 1) * (entry->maxY - entry->minY + 1) > MAX_CELLS;
+        entry->linked = true;
+
+        if (entry->large)
+        {
+            _largeEntries.push_back(entry);
+            return;
+        }
+        for (int y = entry->minY; y <= entry->maxY; ++y)
+            for (int x = entry->minX; x <= entry->maxX; ++x)
+                _cells[cellKey(x, y)].push_back(entry);
+    }
+
+    void unlink(Entry* entry)
+    {
+        if (!entry->linked)
+            return;
+        entry->linked = false;
+
+        if (entry->large)
+        {
+            _largeEntries.erase(std::find(_largeEntries.begin(), _largeEntries.end(), entry));
+            return;
+        }
+        for (int y = entry->minY; y <= entry->maxY; ++y)
+        {
+            for (int x = entry->minX; x <= entry->maxX; ++x)
+            {
+                auto found = _cells.find(cellKey(x, y));
+                auto& cell = found->second;
+                cell.erase(std::find(cell.begin(), cell.end(), entry));
+                if (cell.empty())
+                    _cells.erase(found);
+            }
+        }
+    }
+
+    std::unordered_map<EventListener*, Entry> _entries;
+    std::unordered_map<Node*, std::vector<Entry*>> _nodeEntries;
+    std::unordered_map<int64_t, std::vector<Entry*>> _cells;
+    std::vector<Entry*> _largeEntries;
+    std::vector<Entry*> _dirtyEntries;
+
+    std::mutex _dirtyNodesMutex;
+    std::vector<Node*> _dirtyNodes;
+
+    unsigned int _queryStamp;
+};
+
 static EventListener::ListenerID __getListenerID(Event* event)
 {
     EventListener::ListenerID ret;
@@ -202,6 +397,8 @@ EventDispatcher::EventDispatcher()
 : _inDispatch(0)
 , _isEnabled(false)
 , _nodePriorityIndex(0)
+, _listenersVersion(1)
+, _hitTestIndex(nullptr)
 {
     _toAddedListeners.reserve(50);
     _toRemovedListeners.reserve(50);
@@ -219,6 +416,12 @@ EventDispatcher::~EventDispatcher()
     // so removeAllEventListeners would clean internal custom listeners.
     _internalCustomListenerIDs.clear();
     removeAllEventListeners();
+
+    for (auto& entry : _customEvents)
+    {
+        CC_SAFE_RELEASE(entry.event);
+    }
+    CC_SAFE_DELETE(_hitTestIndex);
 }
 
 void EventDispatcher::visitTarget(Node* node, bool isRootNode)
@@ -417,10 +620,20 @@ void EventDispatcher::associateNodeAndEventListener(Node* node, EventListener* l
     }
     
     listeners->push_back(listener);
+
+    if (listener->getType() == EventListener::Type::TOUCH_ONE_BY_ONE && static_cast<EventListenerTouchOneByOne*>(listener)->_hitTestEnabled)
+    {
+        if (_hitTestIndex == nullptr)
+            _hitTestIndex = new (std::nothrow) HitTestIndex();
+        _hitTestIndex->add(node, static_cast<EventListenerTouchOneByOne*>(listener));
+    }
 }
 
 void EventDispatcher::dissociateNodeAndEventListener(Node* node, EventListener* listener)
 {
+    if (_hitTestIndex && listener->getType() == EventListener::Type::TOUCH_ONE_BY_ONE)
+        _hitTestIndex->remove(static_cast<EventListenerTouchOneByOne*>(listener));
+
     std::vector<EventListener*>* listeners = nullptr;
     auto found = _nodeListenersMap.find(node);
     if (found != _nodeListenersMap.end())
@@ -800,7 +1013,7 @@ void EventDispatcher::dispatchEventToListeners(EventListenerVector* listeners, c
     }
 }
 
-void EventDispatcher::dispatchTouchEventToListeners(EventListenerVector* listeners, const std::function<bool(EventListener*)>& onEvent)
+void EventDispatcher::dispatchTouchEventToListeners(EventListenerVector* listeners, const std::function<bool(EventListener*)>& onEvent, unsigned int hitTestStamp)
 {
     bool shouldStopPropagation = false;
     auto fixedPriorityListeners = listeners->getFixedPriorityListeners();
@@ -856,12 +1069,22 @@ void EventDispatcher::dispatchTouchEventToListeners(EventListenerVector* listene
                 
                 Camera::_visitingCamera = camera;
                 auto cameraFlag = (unsigned short)camera->getCameraFlag();
+                // hit test bounds are in world space, so they only hold for the default camera
+                const bool hitTesting = hitTestStamp != 0 && camera == Camera::getDefaultCamera();
                 for (auto& l : sceneListeners)
                 {
                     if (nullptr == l->getAssociatedNode() || 0 == (l->getAssociatedNode()->getCameraMask() & cameraFlag))
                     {
                         continue;
                     }
+                    if (hitTesting)
+                    {
+                        auto touchListener = static_cast<EventListenerTouchOneByOne*>(l);
+                        if (touchListener->_hitTestEnabled && touchListener->_hitTestStamp != hitTestStamp)
+                        {
+                            continue;
+                        }
+                    }
                     if (onEvent(l))
                     {
                         shouldStopPropagation = true;
@@ -901,11 +1124,19 @@ void EventDispatcher::dispatchEvent(Event* event)
 {
     if (!_isEnabled)
         return;
+
+    CC_PROFILER_ZONE("EventDispatcher::dispatchEvent");
     
     updateDirtyFlagForSceneGraph();
     
     
     DispatchGuard guard(_inDispatch);
+
+    // input events bring the scene out of the idle frame rate
+    if (event->getType() != Event::Type::CUSTOM && event->getType() != Event::Type::FOCUS)
+    {
+        Director::getInstance()->notifyActivity();
+    }
     
     if (event->getType() == Event::Type::TOUCH)
     {
@@ -917,10 +1148,6 @@ void EventDispatcher::dispatchEvent(Event* event)
     
     sortEventListeners(listenerID);
     
-    auto pfnDispatchEventToListeners = &EventDispatcher::dispatchEventToListeners;
-    if (event->getType() == Event::Type::MOUSE) {
-        pfnDispatchEventToListeners = &EventDispatcher::dispatchTouchEventToListeners;
-    }
     auto iter = _listenerMap.find(listenerID);
     if (iter != _listenerMap.end())
     {
@@ -932,7 +1159,14 @@ void EventDispatcher::dispatchEvent(Event* event)
             return event->isStopped();
         };
         
-        (this->*pfnDispatchEventToListeners)(listeners, onEvent);
+        if (event->getType() == Event::Type::MOUSE)
+        {
+            dispatchTouchEventToListeners(listeners, onEvent);
+        }
+        else
+        {
+            dispatchEventToListeners(listeners, onEvent);
+        }
     }
     
     updateListeners(event);
@@ -940,11 +1174,128 @@ void EventDispatcher::dispatchEvent(Event* event)
 
 void EventDispatcher::dispatchCustomEvent(const std::string &eventName, void *optionalUserData)
 {
+    auto iter = _customEventIDs.find(eventName);
+    if (iter != _customEventIDs.end())
+    {
+        dispatchCustomEvent(iter->second, optionalUserData);
+        return;
+    }
+
     EventCustom ev(eventName);
     ev.setUserData(optionalUserData);
     dispatchEvent(&ev);
 }
 
+int EventDispatcher::getCustomEventID(const std::string &eventName)
+{
+    auto iter = _customEventIDs.find(eventName);
+    if (iter != _customEventIDs.end())
+    {
+        return iter->second;
+    }
+
+    CustomEventEntry entry;
+    entry.listenerID = eventName;
+    entry.event = new (std::nothrow) EventCustom(eventName);
+    entry.version = 0;
+
+    int eventID = static_cast<int>(_customEvents.size());
+    _customEvents.push_back(std::move(entry));
+    _customEventIDs.emplace(eventName, eventID);
+    return eventID;
+}
+
+void EventDispatcher::dispatchCustomEvent(int eventID, void *optionalUserData)
+{
+    CCASSERT(eventID >= 0 && eventID < static_cast<int>(_customEvents.size()), "Invalid custom event id!");
+
+    if (!_isEnabled)
+        return;
+
+    auto event = _customEvents[eventID].event;
+    if (event == nullptr)
+    {
+        // dispatched again from one of its own listeners, the cached event and listeners are in use
+        EventCustom ev(_customEvents[eventID].listenerID);
+        ev.setUserData(optionalUserData);
+        dispatchEvent(&ev);
+        return;
+    }
+
+    CC_PROFILER_ZONE("EventDispatcher::dispatchCustomEvent");
+
+    updateDirtyFlagForSceneGraph();
+
+    DispatchGuard guard(_inDispatch);
+
+    if (_customEvents[eventID].version != _listenersVersion)
+    {
+        updateCustomEventListeners(eventID);
+    }
+
+    const unsigned int listenersVersion = _listenersVersion;
+    _customEvents[eventID].event = nullptr;
+    event->_isStopped = false;
+    event->setUserData(optionalUserData);
+
+    // listeners may register new custom events, so don't hold on to the entry while calling them
+    for (size_t i = 0; i < _customEvents[eventID].listeners.size(); ++i)
+    {
+        auto l = _customEvents[eventID].listeners[i];
+        if (l->isEnabled() && !l->isPaused() && l->isRegistered())
+        {
+            event->setCurrentTarget(l->getAssociatedNode());
+            l->_onEvent(event);
+            if (event->isStopped())
+                break;
+        }
+    }
+
+    event->setCurrentTarget(nullptr);
+    _customEvents[eventID].event = event;
+
+    // nothing to clean up unless listeners were added or removed while dispatching
+    if (listenersVersion != _listenersVersion || !_toAddedListeners.empty() || !_toRemovedListeners.empty())
+    {
+        updateListeners(event);
+    }
+}
+
+void EventDispatcher::updateCustomEventListeners(int eventID)
+{
+    auto& entry = _customEvents[eventID];
+    sortEventListeners(entry.listenerID);
+
+    entry.listeners.clear();
+    auto listeners = getListeners(entry.listenerID);
+    if (listeners)
+    {
+        auto fixedPriorityListeners = listeners->getFixedPriorityListeners();
+        auto sceneGraphPriorityListeners = listeners->getSceneGraphPriorityListeners();
+        ssize_t gt0Index = 0;
+
+        // priority < 0, scene graph priority, priority > 0: the order of dispatchEventToListeners
+        if (fixedPriorityListeners)
+        {
+            gt0Index = listeners->getGt0Index();
+            entry.listeners.insert(entry.listeners.end(), fixedPriorityListeners->begin(), fixedPriorityListeners->begin() + gt0Index);
+        }
+        if (sceneGraphPriorityListeners)
+        {
+            entry.listeners.insert(entry.listeners.end(), sceneGraphPriorityListeners->begin(), sceneGraphPriorityListeners->end());
+        }
+        if (fixedPriorityListeners)
+        {
+            entry.listeners.insert(entry.listeners.end(), fixedPriorityListeners->begin() + gt0Index, fixedPriorityListeners->end());
+        }
+    }
+
+    // without a running scene the scene graph listeners can't be sorted yet, try again next time
+    auto dirtyIter = _priorityDirtyFlagMap.find(entry.listenerID);
+    bool stillDirty = dirtyIter != _priorityDirtyFlagMap.end() && dirtyIter->second != DirtyFlag::NONE;
+    entry.version = stillDirty ? 0 : _listenersVersion;
+}
+
 bool EventDispatcher::hasEventListener(const EventListener::ListenerID& listenerID) const
 {
     return getListeners(listenerID) != nullptr;
@@ -1066,8 +1417,14 @@ void EventDispatcher::dispatchTouchEvent(EventTouch* event)
                 return false;
             };
             
-            //
-            dispatchTouchEventToListeners(oneByOneListeners, onTouchEvent);
+            // with hit testing, only the listeners under the touch are asked to claim it
+            unsigned int hitTestStamp = 0;
+            if (_hitTestIndex && !_hitTestIndex->empty() && event->getEventCode() == EventTouch::EventCode::BEGAN)
+            {
+                hitTestStamp = _hitTestIndex->query(touches->getLocation());
+            }
+
+            dispatchTouchEventToListeners(oneByOneListeners, onTouchEvent, hitTestStamp);
             if (event->isStopped())
             {
                 return;
@@ -1168,6 +1525,7 @@ void EventDispatcher::updateListeners(Event* event)
                 auto l = *iter;
                 if (!l->isRegistered())
                 {
+                    ++_listenersVersion;
                     iter = sceneGraphPriorityListeners->erase(iter);
                     // if item in toRemove list, remove it from the list
                     auto matchIter = std::find(_toRemovedListeners.begin(), _toRemovedListeners.end(), l);
@@ -1189,6 +1547,7 @@ void EventDispatcher::updateListeners(Event* event)
                 auto l = *iter;
                 if (!l->isRegistered())
                 {
+                    ++_listenersVersion;
                     iter = fixedPriorityListeners->erase(iter);
                     // if item in toRemove list, remove it from the list
                     auto matchIter = std::find(_toRemovedListeners.begin(), _toRemovedListeners.end(), l);
@@ -1230,6 +1589,7 @@ void EventDispatcher::updateListeners(Event* event)
     {
         if (iter->second->empty())
         {
+            ++_listenersVersion;
             _priorityDirtyFlagMap.erase(iter->first);
             delete iter->second;
             iter = _listenerMap.erase(iter);
@@ -1391,6 +1751,8 @@ EventDispatcher::EventListenerVector* EventDispatcher::getListeners(const EventL
 
 void EventDispatcher::removeEventListenersForListenerID(const EventListener::ListenerID& listenerID)
 {
+    ++_listenersVersion;
+
     auto listenerItemIter = _listenerMap.find(listenerID);
     if (listenerItemIter != _listenerMap.end())
     {
@@ -1512,6 +1874,7 @@ void EventDispatcher::removeAllEventListeners()
     
     if (!_inDispatch && cleanMap)
     {
+        ++_listenersVersion;
         _listenerMap.clear();
     }
 }
@@ -1526,6 +1889,12 @@ bool EventDispatcher::isEnabled() const
     return _isEnabled;
 }
 
+void EventDispatcher::setHitTestBoundsDirty(Node* node)
+{
+    if (_hitTestIndex)
+        _hitTestIndex->setDirty(node);
+}
+
 void EventDispatcher::setDirtyForNode(Node* node)
 {
     // Mark the node dirty only when there is an eventlistener associated with it. 
@@ -1544,6 +1913,8 @@ void EventDispatcher::setDirtyForNode(Node* node)
 
 void EventDispatcher::setDirty(const EventListener::ListenerID& listenerID, DirtyFlag flag)
 {    
+    ++_listenersVersion;
+
     auto iter = _priorityDirtyFlagMap.find(listenerID);
     if (iter == _priorityDirtyFlagMap.end())
     {
@@ -1558,6 +1929,8 @@ void EventDispatcher::setDirty(const EventListener::ListenerID& listenerID, Dirt
 
 void EventDispatcher::cleanToRemovedListeners()
 {
+    ++_listenersVersion;
+
     for (auto& l : _toRemovedListeners)
     {
         auto listenersIter = _listenerMap.find(l->getListenerID());
@@ -48,6 +48,7 @@ class EventTouch;
 class Node;
 class EventCustom;
 class EventListenerCustom;
+class HitTestIndex;
 
 /** @class EventDispatcher
 * @brief This class manages event listener subscriptions
@@ -177,6 +178,22 @@ public:
      */
     void dispatchCustomEvent(const std::string &eventName, void *optionalUserData = nullptr);
 
+    /** Returns the id of a custom event name, the name is registered the first time it is asked for.
+     * Dispatching by id skips the lookups by name, and walks a cached list of the sorted listeners
+     * which is only rebuilt after listeners of any event were added, removed or reordered.
+     *
+     * @param eventName The name of the custom event.
+     * @return The id to pass to dispatchCustomEvent, it stays valid for the lifetime of the dispatcher.
+     */
+    int getCustomEventID(const std::string &eventName);
+
+    /** Dispatches a Custom Event by the id returned by getCustomEventID.
+     *
+     * @param eventID The id of the event which needs to be dispatched.
+     * @param optionalUserData The optional user data, it's a void*, the default value is nullptr.
+     */
+    void dispatchCustomEvent(int eventID, void *optionalUserData = nullptr);
+
     /** Query whether the specified event listener id has been added.
      *
      * @param listenerID The listenerID of the event listener id.
@@ -209,6 +226,9 @@ protected:
     
     /** Sets the dirty flag for a node. */
     void setDirtyForNode(Node* node);
+
+    /** Marks the hit test bounds of the listeners of a node as outdated, can be called from any thread. */
+    void setHitTestBoundsDirty(Node* node);
     
     /**
      *  The vector to store event listeners with scene graph based priority and fixed priority.
@@ -291,8 +311,9 @@ protected:
      *      order by viewport/camera first, because the touch location convert
      *      to 3D world space is different by different camera.
      *  When listener process touch event, can get current camera by Camera::getVisitingCamera().
+     *  For the default camera, hit tested listeners are skipped unless they carry hitTestStamp.
      */
-    void dispatchTouchEventToListeners(EventListenerVector* listeners, const std::function<bool(EventListener*)>& onEvent);
+    void dispatchTouchEventToListeners(EventListenerVector* listeners, const std::function<bool(EventListener*)>& onEvent, unsigned int hitTestStamp = 0);
     
     void releaseListener(EventListener* listener);
     
@@ -314,6 +335,20 @@ protected:
     /** Remove all listeners in _toRemoveListeners list and cleanup */
     void cleanToRemovedListeners();
 
+    /** Rebuilds the cached listeners of a custom event id in dispatch order */
+    void updateCustomEventListeners(int eventID);
+
+    /** A custom event name registered by getCustomEventID */
+    struct CustomEventEntry
+    {
+        EventListener::ListenerID listenerID;
+        /** Reused for every dispatch, nullptr while it is being dispatched */
+        EventCustom* event;
+        /** Listeners in dispatch order, valid while version equals _listenersVersion */
+        std::vector<EventListener*> listeners;
+        unsigned int version;
+    };
+
     /** Listeners map */
     std::unordered_map<EventListener::ListenerID, EventListenerVector*> _listenerMap;
     
@@ -347,6 +382,18 @@ protected:
     int _nodePriorityIndex;
     
     std::set<std::string> _internalCustomListenerIDs;
+
+    /** The custom events registered by getCustomEventID, indexed by id */
+    std::vector<CustomEventEntry> _customEvents;
+
+    /** key: custom event name, value: its id */
+    std::unordered_map<EventListener::ListenerID, int> _customEventIDs;
+
+    /** Changes whenever listeners were added, removed or need to be sorted again */
+    unsigned int _listenersVersion;
+
+    /** World bounds of the hit tested touch listeners, created with the first one */
+    HitTestIndex* _hitTestIndex;
 };
 
 
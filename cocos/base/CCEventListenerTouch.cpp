@@ -39,6 +39,8 @@ EventListenerTouchOneByOne::EventListenerTouchOneByOne()
 , onTouchEnded(nullptr)
 , onTouchCancelled(nullptr)
 , _needSwallow(false)
+, _hitTestEnabled(false)
+, _hitTestStamp(0)
 {
 }
 
@@ -67,6 +69,13 @@ bool EventListenerTouchOneByOne::isSwallowTouches()
     return _needSwallow;
 }
 
+void EventListenerTouchOneByOne::setHitTestEnabled(bool enabled, const Rect& rect)
+{
+    CCASSERT(!isRegistered(), "Hit testing must be set before adding the listener.");
+    _hitTestEnabled = enabled;
+    _hitTestRect = rect;
+}
+
 EventListenerTouchOneByOne* EventListenerTouchOneByOne::create()
 {
     auto ret = new (std::nothrow) EventListenerTouchOneByOne();
@@ -108,6 +117,8 @@ EventListenerTouchOneByOne* EventListenerTouchOneByOne::clone()
         
         ret->_claimedTouches = _claimedTouches;
         ret->_needSwallow = _needSwallow;
+        ret->_hitTestEnabled = _hitTestEnabled;
+        ret->_hitTestRect = _hitTestRect;
     }
     else
     {
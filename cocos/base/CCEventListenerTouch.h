@@ -27,6 +27,7 @@
 #define __cocos2d_libs__CCTouchEventListener__
 
 #include "base/CCEventListener.h"
+#include "math/CCGeometry.h"
 #include <vector>
 
 /**
@@ -67,6 +68,24 @@ public:
      * @return True if needs to swall touches.
      */
     bool isSwallowTouches();
+
+    /** Enables hit testing for a listener with scene graph priority.
+     * onTouchBegan is then only called for touches inside the world bounding box of the hit
+     * rectangle of the associated node, as seen by the default camera. The dispatcher keeps
+     * those boxes in a grid, so with many touchable nodes only the ones under the touch are asked.
+     * It must be set before the listener is added to the dispatcher.
+     *
+     * @param enabled True if needs to hit test.
+     * @param rect The hit rectangle in node space, Rect::ZERO for the content size of the node.
+     * @since v3.14
+     */
+    void setHitTestEnabled(bool enabled, const Rect& rect = Rect::ZERO);
+    /** Is hit testing enabled or not.
+     *
+     * @return True if hit testing is enabled.
+     * @since v3.14
+     */
+    bool isHitTestEnabled() const { return _hitTestEnabled; }
     
     /// Overrides
     virtual EventListenerTouchOneByOne* clone() override;
@@ -90,8 +109,12 @@ CC_CONSTRUCTOR_ACCESS:
 private:
     std::vector<Touch*> _claimedTouches;
     bool _needSwallow;
+    bool _hitTestEnabled;
+    Rect _hitTestRect;
+    unsigned int _hitTestStamp;
     
     friend class EventDispatcher;
+    friend class HitTestIndex;
 };
 
 /** @class EventListenerTouchAllAtOnce
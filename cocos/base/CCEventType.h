@@ -44,5 +44,10 @@
 // This message is posted in cocos/platform/android/jni/Java_org_cocos2dx_lib_Cocos2dxRenderer.cpp and cocos\platform\wp8-xaml\cpp\Cocos2dRenderer.cpp.
 #define EVENT_COME_TO_BACKGROUND    "event_come_to_background"
 
+// The system is running low on memory (Android onTrimMemory, iOS memory warning).
+// This message is used for releasing caches, the TextureCache evicts its unused textures right after it.
+// This message is posted by Director::handleMemoryWarning().
+#define EVENT_MEMORY_WARNING        "event_memory_warning"
+
 /// @endcond
 #endif // __CCEVENT_TYPE_H__
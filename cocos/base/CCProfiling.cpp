@@ -24,6 +24,7 @@ OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
 THE SOFTWARE.
 ****************************************************************************/
 #include "base/CCProfiling.h"
+#include "platform/CCFileUtils.h"
 
 using namespace std;
 
@@ -180,5 +181,139 @@ void ProfilingResetTimingBlock(const char *timerName)
     timer->reset();
 }
 
+// implementation of TraceProfiler
+
+// the buffers are owned by the TraceProfiler, so the events of the finished threads can still be exported
+static thread_local void* s_traceThreadBuffer = nullptr;
+
+TraceProfiler* TraceProfiler::getInstance()
+{
+    static TraceProfiler s_sharedTraceProfiler;
+    return &s_sharedTraceProfiler;
+}
+
+TraceProfiler::TraceProfiler()
+: _enabled(false)
+, _eventsPerThread(16384)
+, _epoch(std::chrono::steady_clock::now())
+{
+}
+
+void TraceProfiler::setEnabled(bool enabled)
+{
+    _enabled.store(enabled, std::memory_order_relaxed);
+}
+
+TraceProfiler::ThreadBuffer* TraceProfiler::getCurrentThreadBuffer()
+{
+    if (s_traceThreadBuffer)
+        return static_cast<ThreadBuffer*>(s_traceThreadBuffer);
+
+    std::unique_ptr<ThreadBuffer> buffer(new (std::nothrow) ThreadBuffer);
+    buffer->next = 0;
+    buffer->wrapped = false;
+
+    std::lock_guard<std::mutex> lock(_buffersMutex);
+    buffer->tid = (int)_buffers.size();
+    s_traceThreadBuffer = buffer.get();
+    _buffers.push_back(std::move(buffer));
+    return static_cast<ThreadBuffer*>(s_traceThreadBuffer);
+}
+
+void TraceProfiler::setCurrentThreadName(const std::string& name)
+{
+    auto buffer = getCurrentThreadBuffer();
+    std::lock_guard<std::mutex> lock(buffer->mutex);
+    buffer->name = name;
+}
+
+void TraceProfiler::addZone(const char* name, const std::chrono::steady_clock::time_point& start, const std::chrono::steady_clock::time_point& end)
+{
+    auto buffer = getCurrentThreadBuffer();
+
+    // only contended while exporting
+    std::lock_guard<std::mutex> lock(buffer->mutex);
+    if (buffer->events.empty())
+        buffer->events.resize(MAX(_eventsPerThread, (size_t)1));
+
+    Event& event = buffer->events[buffer->next];
+    event.name = name;
+    event.start = chrono::duration_cast<chrono::nanoseconds>(start - _epoch).count();
+    event.duration = chrono::duration_cast<chrono::nanoseconds>(end - start).count();
+
+    if (++buffer->next == buffer->events.size())
+    {
+        buffer->next = 0;
+        buffer->wrapped = true;
+    }
+}
+
+static void appendJSONString(std::string& json, const char* str)
+{
+    json += '"';
+    for (const char* c = str; *c; ++c)
+    {
+        if (*c == '"' || *c == '\\')
+            json += '\\';
+        json += *c;
+    }
+    json += '"';
+}
+
+std::string TraceProfiler::getChromeTrace()
+{
+    std::string json = "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    bool first = true;
+    char buf[128];
+
+    std::lock_guard<std::mutex> buffersLock(_buffersMutex);
+    for (auto& buffer : _buffers)
+    {
+        std::lock_guard<std::mutex> lock(buffer->mutex);
+
+        if (!buffer->name.empty())
+        {
+            snprintf(buf, sizeof(buf), "%s{\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"name\":\"thread_name\",\"args\":{\"name\":", first ? "" : ",", buffer->tid);
+            json += buf;
+            appendJSONString(json, buffer->name.c_str());
+            json += "}}";
+            first = false;
+        }
+
+        // oldest first
+        size_t count = buffer->wrapped ? buffer->events.size() : buffer->next;
+        size_t begin = buffer->wrapped ? buffer->next : 0;
+        for (size_t i = 0; i < count; ++i)
+        {
+            const Event& event = buffer->events[(begin + i) % buffer->events.size()];
+            snprintf(buf, sizeof(buf), "%s{\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f,\"name\":",
+                     first ? "" : ",", buffer->tid, event.start / 1000.0, event.duration / 1000.0);
+            json += buf;
+            appendJSONString(json, event.name);
+            json += '}';
+            first = false;
+        }
+    }
+
+    json += "]}";
+    return json;
+}
+
+bool TraceProfiler::saveChromeTrace(const std::string& path)
+{
+    return FileUtils::getInstance()->writeStringToFile(getChromeTrace(), path);
+}
+
+void TraceProfiler::clear()
+{
+    std::lock_guard<std::mutex> buffersLock(_buffersMutex);
+    for (auto& buffer : _buffers)
+    {
+        std::lock_guard<std::mutex> lock(buffer->mutex);
+        buffer->next = 0;
+        buffer->wrapped = false;
+    }
+}
+
 NS_CC_END
 
@@ -30,6 +30,11 @@ THE SOFTWARE.
 
 #include <string>
 #include <chrono>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+#include <memory>
 #include "base/ccConfig.h"
 #include "base/CCRef.h"
 #include "base/CCMap.h"
@@ -145,6 +150,130 @@ public:
     long numberOfCalls;
 };
 
+/** TraceProfiler
+ Records the zones declared with CC_PROFILER_ZONE as a timeline, and exports it as a
+ Chrome / Perfetto JSON trace (chrome://tracing, https://ui.perfetto.dev).
+
+ Every thread records into its own ring buffer, so the newest events are kept when the
+ buffer is full. Tracing is switched on and off at runtime, and a disabled zone
+ only costs one atomic load. Zone names must be string literals, only their pointer is stored.
+ It can also be driven from the Console with the "trace" command.
+ @since v3.14
+ */
+class CC_DLL TraceProfiler
+{
+public:
+    /** returns the singleton
+     * @js NA
+     * @lua NA
+     */
+    static TraceProfiler* getInstance();
+
+    /** Starts or stops recording the zones.
+     * @js NA
+     * @lua NA
+     */
+    void setEnabled(bool enabled);
+    /** Whether or not the zones are being recorded.
+     * @js NA
+     * @lua NA
+     */
+    bool isEnabled() const { return _enabled.load(std::memory_order_relaxed); }
+
+    /** Sets the number of events kept per thread. Applies to the threads that haven't recorded any event yet.
+     * @js NA
+     * @lua NA
+     */
+    void setEventsPerThread(size_t count) { _eventsPerThread = count; }
+    /**
+     * @js NA
+     * @lua NA
+     */
+    size_t getEventsPerThread() const { return _eventsPerThread; }
+
+    /** Names the calling thread in the exported traces.
+     * @js NA
+     * @lua NA
+     */
+    void setCurrentThreadName(const std::string& name);
+
+    /** Records a zone of the calling thread. Used by ProfilingScopedZone.
+     * @js NA
+     * @lua NA
+     */
+    void addZone(const char* name, const std::chrono::steady_clock::time_point& start, const std::chrono::steady_clock::time_point& end);
+
+    /** Returns the recorded events in the Chrome trace event JSON format.
+     * @js NA
+     * @lua NA
+     */
+    std::string getChromeTrace();
+    /** Writes the recorded events to a Chrome trace event JSON file.
+     * @param path The absolute path of the file.
+     * @return true if the file was written.
+     * @js NA
+     * @lua NA
+     */
+    bool saveChromeTrace(const std::string& path);
+
+    /** Discards the recorded events.
+     * @js NA
+     * @lua NA
+     */
+    void clear();
+
+private:
+    struct Event
+    {
+        const char* name;
+        int64_t start;      // ns since _epoch
+        int64_t duration;   // ns
+    };
+
+    struct ThreadBuffer
+    {
+        std::mutex mutex;
+        std::vector<Event> events;
+        size_t next;
+        bool wrapped;
+        int tid;
+        std::string name;
+    };
+
+    TraceProfiler();
+    ThreadBuffer* getCurrentThreadBuffer();
+
+    std::atomic<bool> _enabled;
+    size_t _eventsPerThread;
+    std::chrono::steady_clock::time_point _epoch;
+
+    std::mutex _buffersMutex;
+    std::vector<std::unique_ptr<ThreadBuffer>> _buffers;
+};
+
+/** Records the lifetime of the object as a TraceProfiler zone, see CC_PROFILER_ZONE.
+ */
+class CC_DLL ProfilingScopedZone
+{
+public:
+    explicit ProfilingScopedZone(const char* name)
+    : _name(TraceProfiler::getInstance()->isEnabled() ? name : nullptr)
+    {
+        if (_name)
+            _start = std::chrono::steady_clock::now();
+    }
+
+    ~ProfilingScopedZone()
+    {
+        if (_name)
+            TraceProfiler::getInstance()->addZone(_name, _start, std::chrono::steady_clock::now());
+    }
+
+private:
+    const char* _name;
+    std::chrono::steady_clock::time_point _start;
+};
+
 extern void CC_DLL ProfilingBeginTimingBlock(const char *timerName);
 extern void CC_DLL ProfilingEndTimingBlock(const char *timerName);
 extern void CC_DLL ProfilingResetTimingBlock(const char *timerName);
@@ -24,6 +24,9 @@
 
 #include <string.h>
 
+#include <mutex>
+#include <unordered_map>
+
 #include "platform/CCPlatformMacros.h"
 #include "platform/CCFileUtils.h"
 #include "math/Vec2.h"
@@ -42,6 +45,54 @@ void calculateNamespacePath(const std::string& urlString, std::string& fileStrin
 /** @script{ignore} */
 Properties* getPropertiesFromNamespacePath(Properties* properties, const std::vector<std::string>& namespacePath);
 
+namespace
+{
+    // the parsed files by full path, their roots are copied by createNonRefCounted()
+    std::mutex s_cacheMutex;
+    std::unordered_map<std::string, Properties*> s_cache;
+    bool s_cacheEnabled = true;
+
+    const char BINARY_MAGIC[4] = { 'C', 'C', 'P', 'B' };
+    const uint32_t BINARY_VERSION = 1;
+
+    void writeUInt32(std::string& out, uint32_t value)
+    {
+        out.append((const char*)&value, sizeof(value));
+    }
+
+    void writeString(std::string& out, const std::string& value)
+    {
+        writeUInt32(out, (uint32_t)value.size());
+        out.append(value);
+    }
+
+    struct BinaryReader
+    {
+        const unsigned char* bytes;
+        ssize_t size;
+        ssize_t offset;
+
+        bool readUInt32(uint32_t* value)
+        {
+            if (size - offset < (ssize_t)sizeof(*value))
+                return false;
+            memcpy(value, bytes + offset, sizeof(*value));
+            offset += sizeof(*value);
+            return true;
+        }
+
+        bool readString(std::string* value)
+        {
+            uint32_t length;
+            if (!readUInt32(&length) || size - offset < (ssize_t)length)
+                return false;
+            value->assign((const char*)bytes + offset, length);
+            offset += length;
+            return true;
+        }
+    };
+}
+
 Properties::Properties()
     :  _dataIdx(nullptr), _data(nullptr), _variables(nullptr), _dirPath(nullptr), _parent(nullptr)
 {
@@ -100,12 +151,7 @@ Properties* Properties::createNonRefCounted(const std::string& url)
     calculateNamespacePath(urlString, fileString, namespacePath);
 
 
-    // data will be released automatically when 'data' goes out of scope
-    // so we pass data as weak pointer
-    auto data = FileUtils::getInstance()->getDataFromFile(fileString);
-    ssize_t dataIdx = 0;
-    Properties* properties = new (std::nothrow) Properties(&data, &dataIdx);
-    properties->resolveInheritance();
+    Properties* properties = loadFile(fileString);
 
     // Get the specified properties object.
     Properties* p = getPropertiesFromNamespacePath(properties, namespacePath);
@@ -130,6 +176,159 @@ Properties* Properties::createNonRefCounted(const std::string& url)
     return p;
 }
 
+Properties* Properties::loadFile(const std::string& fileString)
+{
+    auto fileUtils = FileUtils::getInstance();
+    auto fullPath = fileUtils->fullPathForFilename(fileString);
+    if (s_cacheEnabled && !fullPath.empty())
+    {
+        std::lock_guard<std::mutex> lock(s_cacheMutex);
+        auto iter = s_cache.find(fullPath);
+        if (iter != s_cache.end())
+        {
+            return iter->second->clone();
+        }
+    }
+
+    // data will be released automatically when 'data' goes out of scope
+    // so we pass data as weak pointer
+    auto data = fileUtils->getDataFromFile(fileString);
+    Properties* properties = readBinary(data);
+    if (properties == nullptr)
+    {
+        ssize_t dataIdx = 0;
+        properties = new (std::nothrow) Properties(&data, &dataIdx);
+        properties->resolveInheritance();
+    }
+
+    if (s_cacheEnabled && !fullPath.empty() && !data.isNull())
+    {
+        std::lock_guard<std::mutex> lock(s_cacheMutex);
+        auto& cached = s_cache[fullPath];
+        if (cached == nullptr)
+        {
+            cached = properties->clone();
+        }
+    }
+    return properties;
+}
+
+void Properties::setCacheEnabled(bool enabled)
+{
+    s_cacheEnabled = enabled;
+    if (!enabled)
+    {
+        purgeCache();
+    }
+}
+
+bool Properties::isCacheEnabled()
+{
+    return s_cacheEnabled;
+}
+
+void Properties::purgeCache()
+{
+    std::lock_guard<std::mutex> lock(s_cacheMutex);
+    for (auto& cached : s_cache)
+    {
+        delete cached.second;
+    }
+    s_cache.clear();
+}
+
+bool Properties::writeBinaryFile(const std::string& fullPath) const
+{
+    std::string out(BINARY_MAGIC, sizeof(BINARY_MAGIC));
+    writeUInt32(out, BINARY_VERSION);
+    writeBinary(out);
+
+    Data data;
+    data.copy((const unsigned char*)out.data(), out.size());
+    return FileUtils::getInstance()->writeDataToFile(data, fullPath);
+}
+
+void Properties::writeBinary(std::string& out) const
+{
+    writeString(out, _namespace);
+    writeString(out, _id);
+    writeString(out, _parentID);
+
+    writeUInt32(out, (uint32_t)_properties.size());
+    for (const auto& property : _properties)
+    {
+        writeString(out, property.name);
+        writeString(out, property.value);
+    }
+
+    writeUInt32(out, (uint32_t)_namespaces.size());
+    for (const auto space : _namespaces)
+    {
+        space->writeBinary(out);
+    }
+}
+
+Properties* Properties::readBinary(const Data& data)
+{
+    BinaryReader reader = { data.getBytes(), data.getSize(), (ssize_t)sizeof(BINARY_MAGIC) };
+    uint32_t version;
+    if (data.getSize() < (ssize_t)sizeof(BINARY_MAGIC) || memcmp(data.getBytes(), BINARY_MAGIC, sizeof(BINARY_MAGIC)) != 0
+        || !reader.readUInt32(&version) || version != BINARY_VERSION)
+    {
+        return nullptr;
+    }
+
+    // the namespaces are read depth first, like they were written
+    Properties* root = new (std::nothrow) Properties();
+    std::vector<std::pair<Properties*, uint32_t>> unread;
+    Properties* space = root;
+    bool valid = true;
+    while (space)
+    {
+        uint32_t propertyCount, namespaceCount;
+        valid = reader.readString(&space->_namespace) && reader.readString(&space->_id) && reader.readString(&space->_parentID)
+            && reader.readUInt32(&propertyCount);
+        for (uint32_t i = 0; valid && i < propertyCount; ++i)
+        {
+            std::string name, value;
+            valid = reader.readString(&name) && reader.readString(&value);
+            space->_properties.push_back(Property(name, value));
+        }
+        valid = valid && reader.readUInt32(&namespaceCount);
+        if (!valid)
+            break;
+        space->rewind();
+
+        if (namespaceCount > 0)
+        {
+            unread.push_back(std::make_pair(space, namespaceCount));
+        }
+
+        // the next namespace is the first unread child of the deepest namespace having some
+        space = nullptr;
+        if (!unread.empty())
+        {
+            auto& parent = unread.back();
+            space = new (std::nothrow) Properties();
+            space->_parent = parent.first;
+            parent.first->_namespaces.push_back(space);
+            parent.first->rewind();
+            if (--parent.second == 0)
+            {
+                unread.pop_back();
+            }
+        }
+    }
+
+    if (!valid)
+    {
+        CCLOGERROR("Properties: invalid binary file");
+        delete root;
+        return nullptr;
+    }
+    return root;
+}
+
 static bool isVariable(const char* str, char* outName, size_t outSize)
 {
     size_t len = strlen(str);
@@ -187,6 +187,32 @@ public:
      */
     static Properties* createNonRefCounted(const std::string& url);
 
+    /**
+     * Enables the cache of the parsed files, enabled by default.
+     * While it's enabled, createNonRefCounted() parses a file once and returns copies of the parsed
+     * properties, e.g. when Material::createWithFilename() creates the materials of many nodes.
+     * @since v3.14
+     */
+    static void setCacheEnabled(bool enabled);
+    static bool isCacheEnabled();
+
+    /**
+     * Removes the parsed files from the cache, e.g. after a file changed.
+     * @since v3.14
+     */
+    static void purgeCache();
+
+    /**
+     * Writes the properties in a binary file. createNonRefCounted() reads such a file without tokenizing
+     * it, whatever its extension, e.g. a .material compiled at build time.
+     * The inheritance of the namespaces is already resolved in the file.
+     *
+     * @param fullPath The path of the file to write.
+     * @return Whether the file was written.
+     * @since v3.14
+     */
+    bool writeBinaryFile(const std::string& fullPath) const;
+
     /**
      * Destructor.
      */
@@ -580,6 +606,13 @@ private:
     // Called after createNonRefCounted(); copies info from parents into derived namespaces.
     void resolveInheritance(const char* id = NULL);
 
+    // Returns the parsed, resolved root of a file, from the cache when it's enabled.
+    static Properties* loadFile(const std::string& fileString);
+
+    // The binary files written by writeBinaryFile(); readBinary() returns nullptr if the data isn't one.
+    void writeBinary(std::string& out) const;
+    static Properties* readBinary(const Data& data);
+
     // Called by resolveInheritance().
     void mergeWith(Properties* overrides);
 
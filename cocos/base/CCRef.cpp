@@ -33,6 +33,11 @@ THE SOFTWARE.
 #include <thread>
 #include <mutex>
 #include <vector>
+#include <unordered_map>
+#endif
+
+#if CC_ENABLE_MEMORY_STATS
+#include <atomic>
 #endif
 
 NS_CC_BEGIN
@@ -42,6 +47,10 @@ static void trackRef(Ref* ref);
 static void untrackRef(Ref* ref);
 #endif
 
+#if CC_ENABLE_MEMORY_STATS
+static std::atomic<unsigned int> __liveRefCount(0);
+#endif
+
 Ref::Ref()
 : _referenceCount(1) // when the Ref is created, the reference count of it is 1
 #if CC_ENABLE_SCRIPT_BINDING
@@ -58,6 +67,10 @@ Ref::Ref()
 #if CC_REF_LEAK_DETECTION
     trackRef(this);
 #endif
+
+#if CC_ENABLE_MEMORY_STATS
+    __liveRefCount.fetch_add(1, std::memory_order_relaxed);
+#endif
 }
 
 Ref::~Ref()
@@ -85,6 +98,10 @@ Ref::~Ref()
     if (_referenceCount != 0)
         untrackRef(this);
 #endif
+
+#if CC_ENABLE_MEMORY_STATS
+    __liveRefCount.fetch_sub(1, std::memory_order_relaxed);
+#endif
 }
 
 void Ref::retain()
@@ -166,6 +183,35 @@ unsigned int Ref::getReferenceCount() const
 static std::vector<Ref*> __refAllocationList;
 static std::mutex __refMutex;
 
+unsigned int Ref::getLiveCount()
+{
+#if CC_ENABLE_MEMORY_STATS
+    return __liveRefCount.load(std::memory_order_relaxed);
+#else
+    std::lock_guard<std::mutex> refLockGuard(__refMutex);
+    return (unsigned int)__refAllocationList.size();
+#endif
+}
+
+std::vector<std::pair<std::string, unsigned int>> Ref::getLiveStatistics()
+{
+    std::unordered_map<std::string, unsigned int> counts;
+    {
+        std::lock_guard<std::mutex> refLockGuard(__refMutex);
+        for (const auto& ref : __refAllocationList)
+        {
+            const char* type = typeid(*ref).name();
+            ++counts[type ? type : ""];
+        }
+    }
+
+    std::vector<std::pair<std::string, unsigned int>> statistics(counts.begin(), counts.end());
+    std::sort(statistics.begin(), statistics.end(), [](const std::pair<std::string, unsigned int>& a, const std::pair<std::string, unsigned int>& b) {
+        return a.second > b.second;
+    });
+    return statistics;
+}
+
 void Ref::printLeaks()
 {
     std::lock_guard<std::mutex> refLockGuard(__refMutex);
@@ -209,6 +255,17 @@ static void untrackRef(Ref* ref)
     __refAllocationList.erase(iter);
 }
 
+#else
+
+unsigned int Ref::getLiveCount()
+{
+#if CC_ENABLE_MEMORY_STATS
+    return __liveRefCount.load(std::memory_order_relaxed);
+#else
+    return 0;
+#endif
+}
+
 #endif // #if CC_REF_LEAK_DETECTION
 
 
@@ -28,9 +28,16 @@ THE SOFTWARE.
 
 #include "platform/CCPlatformMacros.h"
 #include "base/ccConfig.h"
+#include "base/allocator/CCAllocatorMacros.h"
 
 #define CC_REF_LEAK_DETECTION 0
 
+#if CC_REF_LEAK_DETECTION
+#include <string>
+#include <utility>
+#include <vector>
+#endif
+
 /**
  * @addtogroup base
  * @{
@@ -124,6 +131,15 @@ public:
      */
     unsigned int getReferenceCount() const;
 
+    /**
+     * Returns the number of Ref objects alive.
+     *
+     * It's only counted when CC_ENABLE_MEMORY_STATS or CC_REF_LEAK_DETECTION is enabled, 0 otherwise.
+     * @since v3.14
+     * @js NA
+     */
+    static unsigned int getLiveCount();
+
 protected:
     /**
      * Constructor
@@ -167,6 +183,11 @@ public:
 #if CC_REF_LEAK_DETECTION
 public:
     static void printLeaks();
+
+    /** Returns the number of alive Ref objects of each type, the most common first.
+     * @since v3.14
+     */
+    static std::vector<std::pair<std::string, unsigned int>> getLiveStatistics();
 #endif
 };
 
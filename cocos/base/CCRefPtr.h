@@ -28,6 +28,7 @@
 /// @cond DO_NOT_SHOW
 
 #include "base/CCRef.h"
+#include "base/CCAutoreleasePool.h"
 #include "base/ccMacros.h"
 #include <functional>
 #include <type_traits>
@@ -276,6 +277,32 @@ RefPtr<T> makeRef(T *ptr)
     return RefPtr<T>(ptr);
 }
 
+/**
+ * Calls T::create(args...) and takes over the reference the new object gave to the autorelease pool, so it is
+ * released as soon as the last RefPtr<T> goes away instead of at the end of the frame.
+ *
+ * E.G:
+ *      RefPtr<cocos2d::Sprite> bullet = createRefPtr<cocos2d::Sprite>("bullet.png");
+ *
+ * Objects that create() does not autorelease last, e.g. cached ones, are simply retained.
+ * @since v3.14
+ */
+template <class T, class... Args> inline
+RefPtr<T> createRefPtr(Args&&... args)
+{
+    RefPtr<T> ret;
+    T* ptr = T::create(std::forward<Args>(args)...);
+    if (ptr && PoolManager::getInstance()->getCurrentPool()->takeLastObject(ptr))
+    {
+        ret.weakAssign(ptr);
+    }
+    else
+    {
+        ret = ptr;
+    }
+    return ret;
+}
+
 template<class T> inline
 bool operator<(const RefPtr<T>& r, std::nullptr_t)
 {
@@ -28,44 +28,50 @@ THE SOFTWARE.
 #include "base/CCScheduler.h"
 #include "base/ccMacros.h"
 #include "base/CCDirector.h"
-#include "base/utlist.h"
-#include "base/ccCArray.h"
 #include "base/CCScriptSupport.h"
+#include "base/CCProfiling.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <iterator>
 
 NS_CC_BEGIN
 
 // data structures
 
-// A list double-linked list used for "updates with priority"
-typedef struct _listEntry
+// Element used for "selectors with interval"
+typedef struct _hashSelectorEntry
 {
-    struct _listEntry   *prev, *next;
-    ccSchedulerFunc     callback;
+    Vector<Timer*>      timers;
     void                *target;
-    int                 priority;
     bool                paused;
-    bool                markedForDeletion; // selector will no longer be called and entry will be removed at end of the next tick
-} tListEntry;
+} tHashTimerEntry;
 
-typedef struct _hashUpdateEntry
+// Where a timer currently lives, see Timer::_schedulerState
+enum
 {
-    tListEntry          **list;        // Which list does it belong to ?
-    tListEntry          *entry;        // entry in the list
-    void                *target;
-    ccSchedulerFunc     callback;
-    UT_hash_handle      hh;
-} tHashUpdateEntry;
-
-// Hash Element used for "selectors with interval"
-typedef struct _hashSelectorEntry
+    TIMER_IDLE,             // not scheduled
+    TIMER_PENDING,          // in _pendingTimers, starts counting at the end of the next tick
+    TIMER_WHEEL,            // linked in the timer wheel
+    TIMER_DUE,              // in _dueTimers, being triggered
+    TIMER_FRAME,            // in _frameTimers
+    TIMER_PAUSED,           // target paused, _dueTime holds the time left
+    TIMER_PAUSED_FRAME,     // target paused, was in _frameTimers
+    TIMER_PAUSED_PENDING,   // target paused before the timer started
+};
+
+// Resolution of the timer wheel
+static const double TIMER_TICKS_PER_SECOND = 1024.0;
+
+// Node of the "perform function" queue
+struct Scheduler::PerformNode
 {
-    ccArray             *timers;
-    void                *target;
-    int                 timerIndex;
-    Timer               *currentTimer;
-    bool                paused;
-    UT_hash_handle      hh;
-} tHashTimerEntry;
+    std::atomic<PerformNode*>   next;
+    std::function<void()>       function;
+    int                         priority;
+    unsigned int                generation;
+};
 
 // implementation Timer
 
@@ -79,6 +85,12 @@ Timer::Timer()
 , _delay(0.0f)
 , _interval(0.0f)
 , _aborted(false)
+, _dueTime(0.0)
+, _wheelPrev(nullptr)
+, _wheelNext(nullptr)
+, _wheelSlot(-1)
+, _frameIndex(-1)
+, _schedulerState(TIMER_IDLE)
 {
 }
 
@@ -241,6 +253,7 @@ void TimerScriptHandler::cancel()
 
 #endif
 
+
 // implementation of Scheduler
 
 // Priority level reserved for system services.
@@ -251,227 +264,516 @@ const int Scheduler::PRIORITY_NON_SYSTEM_MIN = PRIORITY_SYSTEM + 1;
 
 Scheduler::Scheduler(void)
 : _timeScale(1.0f)
-, _updatesNegList(nullptr)
-, _updates0List(nullptr)
-, _updatesPosList(nullptr)
-, _hashForUpdates(nullptr)
-, _hashForTimers(nullptr)
-, _currentTarget(nullptr)
-, _currentTargetSalvaged(false)
-, _updateHashLocked(false)
+, _updateEntriesDirty(false)
+, _timerWheelTick(0)
+, _timerTime(0.0)
+, _frameTimersDirty(false)
+, _fixedTimestep(1.0f / 60)
+, _fixedAccumulator(0.0f)
+, _fixedUpdateAlpha(0.0f)
+, _maxFixedSteps(5)
+, _fixedStepCount(0)
 #if CC_ENABLE_SCRIPT_BINDING
 , _scriptHandlerEntries(20)
 #endif
+, _performTail(nullptr)
+, _performStub(nullptr)
+, _performGeneration(0)
+, _performFunctionBudget(0.0f)
 {
-    // I don't expect to have more than 30 functions to all per frame
-    _functionsToPerform.reserve(30);
+    std::fill(_timerWheel, _timerWheel + TIMER_WHEEL_LEVELS * TIMER_WHEEL_SIZE, nullptr);
+
+    _performStub = new (std::nothrow) PerformNode();
+    _performStub->next.store(nullptr, std::memory_order_relaxed);
+    _performHead.store(_performStub, std::memory_order_relaxed);
+    _performTail = _performStub;
 }
 
 Scheduler::~Scheduler(void)
 {
     unscheduleAll();
+
+    // timers that never started still hold a reference
+    for (auto timer : _pendingTimers)
+    {
+        timer->release();
+    }
+
+    for (auto node : _functionsToPerform)
+    {
+        delete node;
+    }
+    for (PerformNode *node = popFunctionToPerform(); node; node = popFunctionToPerform())
+    {
+        delete node;
+    }
+    delete _performStub;
 }
 
 void Scheduler::removeHashElement(_hashSelectorEntry *element)
 {
-    ccArrayFree(element->timers);
-    HASH_DEL(_hashForTimers, element);
-    free(element);
+    _hashForTimers.erase(element->target);
+    delete element;
 }
 
-void Scheduler::schedule(const ccSchedulerFunc& callback, void *target, float interval, bool paused, const std::string& key)
-{
-    this->schedule(callback, target, interval, CC_REPEAT_FOREVER, 0.0f, paused, key);
-}
+// timer wheel
 
-void Scheduler::schedule(const ccSchedulerFunc& callback, void *target, float interval, unsigned int repeat, float delay, bool paused, const std::string& key)
+void Scheduler::linkTimer(Timer *timer)
 {
-    CCASSERT(target, "Argument target must be non-nullptr");
-    CCASSERT(!key.empty(), "key should not be empty!");
+    const uint64_t mask = TIMER_WHEEL_SIZE - 1;
+    uint64_t dueTick = timer->_dueTime > 0 ? (uint64_t)(timer->_dueTime * TIMER_TICKS_PER_SECOND) : 0;
+    dueTick = std::max(dueTick, _timerWheelTick);
 
-    tHashTimerEntry *element = nullptr;
-    HASH_FIND_PTR(_hashForTimers, &target, element);
+    // timers further away than the wheel can express wait in the last level and are linked again when their slot comes round
+    const uint64_t range = ((uint64_t)1 << (TIMER_WHEEL_BITS * TIMER_WHEEL_LEVELS)) - 1;
+    dueTick = std::min(dueTick, _timerWheelTick + range);
 
-    if (! element)
+    const uint64_t delta = dueTick - _timerWheelTick;
+    int level = 0;
+    while (level < TIMER_WHEEL_LEVELS - 1 && delta >= ((uint64_t)1 << (TIMER_WHEEL_BITS * (level + 1))))
     {
-        element = (tHashTimerEntry *)calloc(sizeof(*element), 1);
-        element->target = target;
+        ++level;
+    }
 
-        HASH_ADD_PTR(_hashForTimers, target, element);
+    const int slot = level * TIMER_WHEEL_SIZE + (int)((dueTick >> (TIMER_WHEEL_BITS * level)) & mask);
+    timer->_wheelSlot = slot;
+    timer->_wheelPrev = nullptr;
+    timer->_wheelNext = _timerWheel[slot];
+    if (timer->_wheelNext)
+    {
+        timer->_wheelNext->_wheelPrev = timer;
+    }
+    _timerWheel[slot] = timer;
+    timer->_schedulerState = TIMER_WHEEL;
+}
 
-        // Is this the 1st element ? Then set the pause level to all the selectors of this target
-        element->paused = paused;
+void Scheduler::unlinkTimer(Timer *timer)
+{
+    if (timer->_wheelPrev)
+    {
+        timer->_wheelPrev->_wheelNext = timer->_wheelNext;
     }
     else
     {
-        CCASSERT(element->paused == paused, "element's paused should be paused!");
+        _timerWheel[timer->_wheelSlot] = timer->_wheelNext;
     }
 
-    if (element->timers == nullptr)
+    if (timer->_wheelNext)
     {
-        element->timers = ccArrayNew(10);
+        timer->_wheelNext->_wheelPrev = timer->_wheelPrev;
     }
-    else 
+
+    timer->_wheelPrev = timer->_wheelNext = nullptr;
+    timer->_wheelSlot = -1;
+}
+
+void Scheduler::detachTimer(Timer *timer)
+{
+    switch (timer->_schedulerState)
     {
-        for (int i = 0; i < element->timers->num; ++i)
+        case TIMER_WHEEL:
+            unlinkTimer(timer);
+            break;
+        case TIMER_FRAME:
+            _frameTimers[timer->_frameIndex] = nullptr;
+            timer->_frameIndex = -1;
+            _frameTimersDirty = true;
+            break;
+        default:
+            // pending and due timers are skipped and released when their array is processed
+            break;
+    }
+
+    timer->_schedulerState = TIMER_IDLE;
+}
+
+void Scheduler::queueTimer(Timer *timer, bool paused)
+{
+    if (paused)
+    {
+        timer->_schedulerState = TIMER_PAUSED_PENDING;
+        return;
+    }
+
+    timer->retain();
+    _pendingTimers.push_back(timer);
+    timer->_schedulerState = TIMER_PENDING;
+}
+
+void Scheduler::startTimer(Timer *timer)
+{
+    if (timer->_useDelay)
+    {
+        timer->_dueTime = _timerTime + timer->_delay;
+        linkTimer(timer);
+    }
+    else if (timer->_interval > 0)
+    {
+        timer->_dueTime = _timerTime + timer->_interval;
+        linkTimer(timer);
+    }
+    else
+    {
+        addFrameTimer(timer);
+    }
+}
+
+void Scheduler::addFrameTimer(Timer *timer)
+{
+    timer->_frameIndex = (int)_frameTimers.size();
+    _frameTimers.push_back(timer);
+    timer->_schedulerState = TIMER_FRAME;
+}
+
+void Scheduler::fireTimer(Timer *timer)
+{
+    // same semantics as Timer::update(): the delay is triggered once, then the interval,
+    // and the timer catches up when a tick was longer than its interval
+    do
+    {
+        float dt = timer->_interval;
+        if (timer->_useDelay)
         {
-            TimerTargetCallback *timer = dynamic_cast<TimerTargetCallback*>(element->timers->arr[i]);
+            dt = timer->_delay;
+            timer->_useDelay = false;
+        }
+        timer->_dueTime += timer->_interval;
 
-            if (timer && !timer->isExhausted() && key == timer->getKey())
-            {
-                CCLOG("CCScheduler#schedule. Reiniting timer with interval %.4f, repeat %u, delay %.4f", interval, repeat, delay);
-                timer->setupTimerWithInterval(interval, repeat, delay);
-                return;
-            }
+        timer->_timesExecuted += 1; // important to increment before call trigger
+        timer->trigger(dt);
+
+        // the callback may have unscheduled, rescheduled or paused the timer
+        if (timer->_schedulerState != TIMER_DUE)
+        {
+            return;
         }
-        ccArrayEnsureExtraCapacity(element->timers, 1);
-    }
 
-    TimerTargetCallback *timer = new (std::nothrow) TimerTargetCallback();
-    timer->initWithCallback(this, callback, target, key, interval, repeat, delay);
-    ccArrayAppendObject(element->timers, timer);
-    timer->release();
+        if (timer->isExhausted())
+        {
+            timer->cancel();
+            return;
+        }
+    } while (timer->_interval > 0 && timer->_dueTime <= _timerTime);
+
+    if (timer->_interval > 0)
+    {
+        linkTimer(timer);
+    }
+    else
+    {
+        addFrameTimer(timer);
+    }
 }
 
-void Scheduler::unschedule(const std::string &key, void *target)
+void Scheduler::setTimersPaused(tHashTimerEntry *element, bool paused)
 {
-    // explicit handle nil arguments when removing an object
-    if (target == nullptr || key.empty())
+    if (element->paused == paused)
     {
         return;
     }
+    element->paused = paused;
+
+    for (auto timer : element->timers)
+    {
+        if (paused)
+        {
+            switch (timer->_schedulerState)
+            {
+                case TIMER_WHEEL:
+                    unlinkTimer(timer);
+                    timer->_dueTime -= _timerTime;
+                    timer->_schedulerState = TIMER_PAUSED;
+                    break;
+                case TIMER_DUE:
+                    timer->_dueTime -= _timerTime;
+                    timer->_schedulerState = (timer->_interval > 0 || timer->_useDelay) ? TIMER_PAUSED : TIMER_PAUSED_FRAME;
+                    break;
+                case TIMER_FRAME:
+                    detachTimer(timer);
+                    timer->_schedulerState = TIMER_PAUSED_FRAME;
+                    break;
+                case TIMER_PENDING:
+                    timer->_schedulerState = TIMER_PAUSED_PENDING;
+                    break;
+                default:
+                    break;
+            }
+        }
+        else
+        {
+            switch (timer->_schedulerState)
+            {
+                case TIMER_PAUSED:
+                    timer->_dueTime += _timerTime;
+                    linkTimer(timer);
+                    break;
+                case TIMER_PAUSED_FRAME:
+                    addFrameTimer(timer);
+                    break;
+                case TIMER_PAUSED_PENDING:
+                    queueTimer(timer, false);
+                    break;
+                default:
+                    break;
+            }
+        }
+    }
+}
 
-    //CCASSERT(target);
-    //CCASSERT(selector);
+void Scheduler::updateTimers(float dt)
+{
+    _timerTime += dt;
 
-    tHashTimerEntry *element = nullptr;
-    HASH_FIND_PTR(_hashForTimers, &target, element);
+    // Timers with an interval of 0, triggered every tick.
+    // Timers added while looping are not triggered before the next tick.
+    for (size_t i = 0, count = _frameTimers.size(); i < count; ++i)
+    {
+        Timer *timer = _frameTimers[i];
+        if (timer == nullptr)
+        {
+            continue;
+        }
+
+        // the callback may release the timer
+        timer->retain();
+        timer->_timesExecuted += 1; // important to increment before call trigger
+        timer->trigger(dt);
+        if (timer->_schedulerState == TIMER_FRAME && timer->isExhausted())
+        {
+            timer->cancel();
+        }
+        timer->release();
+    }
 
-    if (element)
+    if (_frameTimersDirty)
     {
-        for (int i = 0; i < element->timers->num; ++i)
+        _frameTimers.erase(std::remove(_frameTimers.begin(), _frameTimers.end(), nullptr), _frameTimers.end());
+        for (size_t i = 0, count = _frameTimers.size(); i < count; ++i)
         {
-            TimerTargetCallback *timer = dynamic_cast<TimerTargetCallback*>(element->timers->arr[i]);
+            _frameTimers[i]->_frameIndex = (int)i;
+        }
+        _frameTimersDirty = false;
+    }
 
-            if (timer && key == timer->getKey())
+    // Advance the wheel up to the current tick and collect the timers that are due.
+    // The current tick is visited again next time since it may hold timers due later in the same tick.
+    const uint64_t mask = TIMER_WHEEL_SIZE - 1;
+    const uint64_t nowTick = (uint64_t)(_timerTime * TIMER_TICKS_PER_SECOND);
+    for (;;)
+    {
+        if ((_timerWheelTick & mask) == 0)
+        {
+            // bring down the timers of the coarser levels whose slot came round
+            for (int level = 1; level < TIMER_WHEEL_LEVELS; ++level)
             {
-                if (timer == element->currentTimer && (! timer->isAborted()))
+                const uint64_t index = (_timerWheelTick >> (TIMER_WHEEL_BITS * level)) & mask;
+                Timer *timer = _timerWheel[level * TIMER_WHEEL_SIZE + index];
+                _timerWheel[level * TIMER_WHEEL_SIZE + index] = nullptr;
+                while (timer)
                 {
-                    timer->retain();
-                    timer->setAborted();
+                    Timer *next = timer->_wheelNext;
+                    linkTimer(timer);
+                    timer = next;
                 }
 
-                ccArrayRemoveObjectAtIndex(element->timers, i, true);
-
-                // update timerIndex in case we are in tick:, looping over the actions
-                if (element->timerIndex >= i)
+                if (index != 0)
                 {
-                    element->timerIndex--;
+                    break;
                 }
+            }
+        }
 
-                if (element->timers->num == 0)
-                {
-                    if (_currentTarget == element)
-                    {
-                        _currentTargetSalvaged = true;
-                    }
-                    else
-                    {
-                        removeHashElement(element);
-                    }
-                }
+        Timer *timer = _timerWheel[_timerWheelTick & mask];
+        _timerWheel[_timerWheelTick & mask] = nullptr;
+        while (timer)
+        {
+            Timer *next = timer->_wheelNext;
+            if (timer->_dueTime <= _timerTime)
+            {
+                timer->_wheelPrev = timer->_wheelNext = nullptr;
+                timer->_wheelSlot = -1;
+                timer->_schedulerState = TIMER_DUE;
+                timer->retain();
+                _dueTimers.push_back(timer);
+            }
+            else
+            {
+                linkTimer(timer);
+            }
+            timer = next;
+        }
 
-                return;
+        if (_timerWheelTick >= nowTick)
+        {
+            break;
+        }
+        ++_timerWheelTick;
+    }
+
+    if (!_dueTimers.empty())
+    {
+        std::stable_sort(_dueTimers.begin(), _dueTimers.end(), [](const Timer *a, const Timer *b) {
+            return a->_dueTime < b->_dueTime;
+        });
+
+        for (size_t i = 0; i < _dueTimers.size(); ++i)
+        {
+            Timer *timer = _dueTimers[i];
+            if (timer->_schedulerState == TIMER_DUE)
+            {
+                fireTimer(timer);
             }
+            timer->release();
+        }
+        _dueTimers.clear();
+    }
+
+    // Timers scheduled since the last tick start counting now
+    for (size_t i = 0; i < _pendingTimers.size(); ++i)
+    {
+        Timer *timer = _pendingTimers[i];
+        if (timer->_schedulerState == TIMER_PENDING)
+        {
+            startTimer(timer);
         }
+        timer->release();
     }
+    _pendingTimers.clear();
 }
 
-void Scheduler::priorityIn(tListEntry **list, const ccSchedulerFunc& callback, void *target, int priority, bool paused)
+void Scheduler::schedule(const ccSchedulerFunc& callback, void *target, float interval, bool paused, const std::string& key)
+{
+    this->schedule(callback, target, interval, CC_REPEAT_FOREVER, 0.0f, paused, key);
+}
+
+void Scheduler::schedule(const ccSchedulerFunc& callback, void *target, float interval, unsigned int repeat, float delay, bool paused, const std::string& key)
 {
-    tListEntry *listElement = new (std::nothrow) tListEntry();
+    CCASSERT(target, "Argument target must be non-nullptr");
+    CCASSERT(!key.empty(), "key should not be empty!");
 
-    listElement->callback = callback;
-    listElement->target = target;
-    listElement->priority = priority;
-    listElement->paused = paused;
-    listElement->next = listElement->prev = nullptr;
-    listElement->markedForDeletion = false;
+    tHashTimerEntry *element = nullptr;
+    auto iter = _hashForTimers.find(target);
 
-    // empty list ?
-    if (! *list)
+    if (iter == _hashForTimers.end())
     {
-        DL_APPEND(*list, listElement);
+        element = new (std::nothrow) tHashTimerEntry();
+        element->target = target;
+
+        _hashForTimers.emplace(target, element);
+
+        // Is this the 1st element ? Then set the pause level to all the selectors of this target
+        element->paused = paused;
     }
     else
     {
-        bool added = false;
+        element = iter->second;
+        CCASSERT(element->paused == paused, "element's paused should be paused!");
+    }
+
+    for (auto t : element->timers)
+    {
+        TimerTargetCallback *timer = dynamic_cast<TimerTargetCallback*>(t);
+
+        if (timer && !timer->isExhausted() && key == timer->getKey())
+        {
+            CCLOG("CCScheduler#schedule. Reiniting timer with interval %.4f, repeat %u, delay %.4f", interval, repeat, delay);
+            timer->setupTimerWithInterval(interval, repeat, delay);
+            detachTimer(timer);
+            queueTimer(timer, element->paused);
+            return;
+        }
+    }
+
+    TimerTargetCallback *timer = new (std::nothrow) TimerTargetCallback();
+    timer->initWithCallback(this, callback, target, key, interval, repeat, delay);
+    element->timers.pushBack(timer);
+    timer->release();
+    queueTimer(timer, element->paused);
+}
+
+void Scheduler::unschedule(const std::string &key, void *target)
+{
+    // explicit handle nil arguments when removing an object
+    if (target == nullptr || key.empty())
+    {
+        return;
+    }
+
+    auto iter = _hashForTimers.find(target);
 
-        for (tListEntry *element = *list; element; element = element->next)
+    if (iter != _hashForTimers.end())
+    {
+        tHashTimerEntry *element = iter->second;
+        for (ssize_t i = 0; i < element->timers.size(); ++i)
         {
-            if (priority < element->priority)
+            TimerTargetCallback *timer = dynamic_cast<TimerTargetCallback*>(element->timers.at(i));
+
+            if (timer && key == timer->getKey())
             {
-                if (element == *list)
-                {
-                    DL_PREPEND(*list, listElement);
-                }
-                else
-                {
-                    listElement->next = element;
-                    listElement->prev = element->prev;
+                // a timer being triggered is kept alive by the array it is triggered from
+                detachTimer(timer);
+                timer->setAborted();
+                element->timers.erase(i);
 
-                    element->prev->next = listElement;
-                    element->prev = listElement;
+                if (element->timers.empty())
+                {
+                    removeHashElement(element);
                 }
 
-                added = true;
-                break;
+                return;
             }
         }
+    }
+}
 
-        // Not added? priority has the higher value. Append it.
-        if (! added)
-        {
-            DL_APPEND(*list, listElement);
-        }
+_listEntry* Scheduler::findUpdateEntry(void *target)
+{
+    auto iter = _updateEntryIndices.find(target);
+    if (iter == _updateEntryIndices.end())
+    {
+        return nullptr;
     }
 
-    // update hash entry for quick access
-    tHashUpdateEntry *hashElement = (tHashUpdateEntry *)calloc(sizeof(*hashElement), 1);
-    hashElement->target = target;
-    hashElement->list = list;
-    hashElement->entry = listElement;
-    HASH_ADD_PTR(_hashForUpdates, target, hashElement);
+    const ssize_t index = iter->second;
+    return index >= 0 ? &_updateEntries[index] : &_pendingUpdateEntries[-index - 1];
 }
 
-void Scheduler::appendIn(_listEntry **list, const ccSchedulerFunc& callback, void *target, bool paused)
+void Scheduler::compactUpdateEntries()
 {
-    tListEntry *listElement = new (std::nothrow) tListEntry();
+    if (!_updateEntriesDirty && _pendingUpdateEntries.empty())
+    {
+        return;
+    }
 
-    listElement->callback = callback;
-    listElement->target = target;
-    listElement->paused = paused;
-    listElement->priority = 0;
-    listElement->markedForDeletion = false;
+    auto isRemoved = [](const _listEntry& entry) { return entry.markedForDeletion; };
+    _updateEntries.erase(std::remove_if(_updateEntries.begin(), _updateEntries.end(), isRemoved), _updateEntries.end());
+    _pendingUpdateEntries.erase(std::remove_if(_pendingUpdateEntries.begin(), _pendingUpdateEntries.end(), isRemoved), _pendingUpdateEntries.end());
 
-    DL_APPEND(*list, listElement);
+    // stable, so entries with the same priority keep being called in the order they were scheduled
+    auto byPriority = [](const _listEntry& a, const _listEntry& b) { return a.priority < b.priority; };
+    std::stable_sort(_pendingUpdateEntries.begin(), _pendingUpdateEntries.end(), byPriority);
 
-    // update hash entry for quicker access
-    tHashUpdateEntry *hashElement = (tHashUpdateEntry *)calloc(sizeof(*hashElement), 1);
-    hashElement->target = target;
-    hashElement->list = list;
-    hashElement->entry = listElement;
-    HASH_ADD_PTR(_hashForUpdates, target, hashElement);
+    const size_t middle = _updateEntries.size();
+    _updateEntries.insert(_updateEntries.end(),
+                          std::make_move_iterator(_pendingUpdateEntries.begin()),
+                          std::make_move_iterator(_pendingUpdateEntries.end()));
+    std::inplace_merge(_updateEntries.begin(), _updateEntries.begin() + middle, _updateEntries.end(), byPriority);
+    _pendingUpdateEntries.clear();
+
+    for (size_t i = 0, count = _updateEntries.size(); i < count; ++i)
+    {
+        _updateEntryIndices[_updateEntries[i].target] = (ssize_t)i;
+    }
+    _updateEntriesDirty = false;
 }
 
 void Scheduler::schedulePerFrame(const ccSchedulerFunc& callback, void *target, int priority, bool paused)
 {
-    tHashUpdateEntry *hashElement = nullptr;
-    HASH_FIND_PTR(_hashForUpdates, &target, hashElement);
-    if (hashElement)
+    _listEntry *entry = findUpdateEntry(target);
+    if (entry)
     {
         // change priority: should unschedule it first
-        if (hashElement->entry->priority != priority)
+        if (entry->priority != priority)
         {
             unscheduleUpdate(target);
         }
@@ -483,21 +785,10 @@ void Scheduler::schedulePerFrame(const ccSchedulerFunc& callback, void *target,
         }
     }
 
-    // most of the updates are going to be 0, that's way there
-    // is an special list for updates with priority 0
-    if (priority == 0)
-    {
-        appendIn(&_updates0List, callback, target, paused);
-    }
-    else if (priority < 0)
-    {
-        priorityIn(&_updatesNegList, callback, target, priority, paused);
-    }
-    else
-    {
-        // priority > 0
-        priorityIn(&_updatesPosList, callback, target, priority, paused);
-    }
+    // merged into the sorted array at the start of the next tick
+    _listEntry newEntry = { callback, target, priority, paused, false };
+    _pendingUpdateEntries.push_back(std::move(newEntry));
+    _updateEntryIndices[target] = -(ssize_t)_pendingUpdateEntries.size();
 }
 
 bool Scheduler::isScheduled(const std::string& key, const void *target) const
@@ -505,22 +796,16 @@ bool Scheduler::isScheduled(const std::string& key, const void *target) const
     CCASSERT(!key.empty(), "Argument key must not be empty");
     CCASSERT(target, "Argument target must be non-nullptr");
     
-    tHashTimerEntry *element = nullptr;
-    HASH_FIND_PTR(_hashForTimers, &target, element);
-    
-    if (!element)
-    {
-        return false;
-    }
+    auto iter = _hashForTimers.find(const_cast<void*>(target));
     
-    if (element->timers == nullptr)
+    if (iter == _hashForTimers.end())
     {
         return false;
     }
     
-    for (int i = 0; i < element->timers->num; ++i)
+    for (auto t : iter->second->timers)
     {
-        TimerTargetCallback *timer = dynamic_cast<TimerTargetCallback*>(element->timers->arr[i]);
+        TimerTargetCallback *timer = dynamic_cast<TimerTargetCallback*>(t);
         
         if (timer && !timer->isExhausted() && key == timer->getKey())
         {
@@ -531,29 +816,6 @@ bool Scheduler::isScheduled(const std::string& key, const void *target) const
     return false;
 }
 
-void Scheduler::removeUpdateFromHash(struct _listEntry *entry)
-{
-    tHashUpdateEntry *element = nullptr;
-
-    HASH_FIND_PTR(_hashForUpdates, &entry->target, element);
-    if (element)
-    {
-        // list entry
-        DL_DELETE(*element->list, element->entry);
-        if (!_updateHashLocked)
-            CC_SAFE_DELETE(element->entry);
-        else
-        {
-            element->entry->markedForDeletion = true;
-            _updateDeleteVector.push_back(element->entry);
-        }
-
-        // hash entry
-        HASH_DEL(_hashForUpdates, element);
-        free(element);
-    }
-}
-
 void Scheduler::unscheduleUpdate(void *target)
 {
     if (target == nullptr)
@@ -561,10 +823,14 @@ void Scheduler::unscheduleUpdate(void *target)
         return;
     }
 
-    tHashUpdateEntry *element = nullptr;
-    HASH_FIND_PTR(_hashForUpdates, &target, element);
-    if (element)
-        this->removeUpdateFromHash(element->entry);
+    _listEntry *entry = findUpdateEntry(target);
+    if (entry)
+    {
+        // removed from the array at the start of the next tick
+        entry->markedForDeletion = true;
+        _updateEntryIndices.erase(target);
+        _updateEntriesDirty = true;
+    }
 }
 
 void Scheduler::unscheduleAll(void)
@@ -575,44 +841,45 @@ void Scheduler::unscheduleAll(void)
 void Scheduler::unscheduleAllWithMinPriority(int minPriority)
 {
     // Custom Selectors
-    tHashTimerEntry *element = nullptr;
-    tHashTimerEntry *nextElement = nullptr;
-    for (element = _hashForTimers; element != nullptr;)
+    std::vector<void*> targets;
+    targets.reserve(_hashForTimers.size());
+    for (const auto& pair : _hashForTimers)
     {
-        // element may be removed in unscheduleAllSelectorsForTarget
-        nextElement = (tHashTimerEntry *)element->hh.next;
-        unscheduleAllForTarget(element->target);
+        targets.push_back(pair.first);
+    }
 
-        element = nextElement;
+    for (auto target : targets)
+    {
+        unscheduleAllForTarget(target);
     }
 
-    // Updates selectors
-    tListEntry *entry, *tmp;
-    if(minPriority < 0)
+    // Updates selectors, unscheduling only marks the entries
+    for (const auto& entry : _updateEntries)
     {
-        DL_FOREACH_SAFE(_updatesNegList, entry, tmp)
+        if (!entry.markedForDeletion && entry.priority >= minPriority)
         {
-            if(entry->priority >= minPriority)
-            {
-                unscheduleUpdate(entry->target);
-            }
+            unscheduleUpdate(entry.target);
         }
     }
 
-    if(minPriority <= 0)
+    for (const auto& entry : _pendingUpdateEntries)
     {
-        DL_FOREACH_SAFE(_updates0List, entry, tmp)
+        if (!entry.markedForDeletion && entry.priority >= minPriority)
         {
-            unscheduleUpdate(entry->target);
+            unscheduleUpdate(entry.target);
         }
     }
 
-    DL_FOREACH_SAFE(_updatesPosList, entry, tmp)
+    // Fixed updates
+    for (auto& entry : _fixedUpdateEntries)
     {
-        if(entry->priority >= minPriority)
-        {
-            unscheduleUpdate(entry->target);
-        }
+        if (entry.priority >= minPriority)
+            entry.markedForDeletion = true;
+    }
+    for (auto& entry : _pendingFixedUpdateEntries)
+    {
+        if (entry.priority >= minPriority)
+            entry.markedForDeletion = true;
     }
 #if CC_ENABLE_SCRIPT_BINDING
     _scriptHandlerEntries.clear();
@@ -628,31 +895,35 @@ void Scheduler::unscheduleAllForTarget(void *target)
     }
 
     // Custom Selectors
-    tHashTimerEntry *element = nullptr;
-    HASH_FIND_PTR(_hashForTimers, &target, element);
+    auto iter = _hashForTimers.find(target);
 
-    if (element)
+    if (iter != _hashForTimers.end())
     {
-        if (ccArrayContainsObject(element->timers, element->currentTimer)
-            && (! element->currentTimer->isAborted()))
+        tHashTimerEntry *element = iter->second;
+        for (auto timer : element->timers)
         {
-            element->currentTimer->retain();
-            element->currentTimer->setAborted();
+            detachTimer(timer);
+            timer->setAborted();
         }
-        ccArrayRemoveAllObjects(element->timers);
+        element->timers.clear();
 
-        if (_currentTarget == element)
-        {
-            _currentTargetSalvaged = true;
-        }
-        else
-        {
-            removeHashElement(element);
-        }
+        removeHashElement(element);
     }
 
     // update selector
     unscheduleUpdate(target);
+
+    // fixed updates
+    for (auto& entry : _fixedUpdateEntries)
+    {
+        if (entry.target == target)
+            entry.markedForDeletion = true;
+    }
+    for (auto& entry : _pendingFixedUpdateEntries)
+    {
+        if (entry.target == target)
+            entry.markedForDeletion = true;
+    }
 }
 
 #if CC_ENABLE_SCRIPT_BINDING
@@ -683,20 +954,29 @@ void Scheduler::resumeTarget(void *target)
     CCASSERT(target != nullptr, "target can't be nullptr!");
 
     // custom selectors
-    tHashTimerEntry *element = nullptr;
-    HASH_FIND_PTR(_hashForTimers, &target, element);
-    if (element)
+    auto iter = _hashForTimers.find(target);
+    if (iter != _hashForTimers.end())
     {
-        element->paused = false;
+        setTimersPaused(iter->second, false);
     }
 
     // update selector
-    tHashUpdateEntry *elementUpdate = nullptr;
-    HASH_FIND_PTR(_hashForUpdates, &target, elementUpdate);
-    if (elementUpdate)
+    _listEntry *entry = findUpdateEntry(target);
+    if (entry)
+    {
+        entry->paused = false;
+    }
+
+    // fixed updates
+    for (auto& fixedEntry : _fixedUpdateEntries)
+    {
+        if (fixedEntry.target == target)
+            fixedEntry.paused = false;
+    }
+    for (auto& fixedEntry : _pendingFixedUpdateEntries)
     {
-        CCASSERT(elementUpdate->entry != nullptr, "elementUpdate's entry can't be nullptr!");
-        elementUpdate->entry->paused = false;
+        if (fixedEntry.target == target)
+            fixedEntry.paused = false;
     }
 }
 
@@ -705,20 +985,29 @@ void Scheduler::pauseTarget(void *target)
     CCASSERT(target != nullptr, "target can't be nullptr!");
 
     // custom selectors
-    tHashTimerEntry *element = nullptr;
-    HASH_FIND_PTR(_hashForTimers, &target, element);
-    if (element)
+    auto iter = _hashForTimers.find(target);
+    if (iter != _hashForTimers.end())
     {
-        element->paused = true;
+        setTimersPaused(iter->second, true);
     }
 
     // update selector
-    tHashUpdateEntry *elementUpdate = nullptr;
-    HASH_FIND_PTR(_hashForUpdates, &target, elementUpdate);
-    if (elementUpdate)
+    _listEntry *entry = findUpdateEntry(target);
+    if (entry)
+    {
+        entry->paused = true;
+    }
+
+    // fixed updates
+    for (auto& fixedEntry : _fixedUpdateEntries)
+    {
+        if (fixedEntry.target == target)
+            fixedEntry.paused = true;
+    }
+    for (auto& fixedEntry : _pendingFixedUpdateEntries)
     {
-        CCASSERT(elementUpdate->entry != nullptr, "elementUpdate's entry can't be nullptr!");
-        elementUpdate->entry->paused = true;
+        if (fixedEntry.target == target)
+            fixedEntry.paused = true;
     }
 }
 
@@ -727,19 +1016,29 @@ bool Scheduler::isTargetPaused(void *target)
     CCASSERT( target != nullptr, "target must be non nil" );
 
     // Custom selectors
-    tHashTimerEntry *element = nullptr;
-    HASH_FIND_PTR(_hashForTimers, &target, element);
-    if( element )
+    auto iter = _hashForTimers.find(target);
+    if (iter != _hashForTimers.end())
     {
-        return element->paused;
+        return iter->second->paused;
     }
     
     // We should check update selectors if target does not have custom selectors
-    tHashUpdateEntry *elementUpdate = nullptr;
-    HASH_FIND_PTR(_hashForUpdates, &target, elementUpdate);
-    if ( elementUpdate )
+    _listEntry *entry = findUpdateEntry(target);
+    if (entry)
+    {
+        return entry->paused;
+    }
+
+    // Then the fixed updates
+    for (const auto& fixedEntry : _fixedUpdateEntries)
+    {
+        if (fixedEntry.target == target && !fixedEntry.markedForDeletion)
+            return fixedEntry.paused;
+    }
+    for (const auto& fixedEntry : _pendingFixedUpdateEntries)
     {
-        return elementUpdate->entry->paused;
+        if (fixedEntry.target == target && !fixedEntry.markedForDeletion)
+            return fixedEntry.paused;
     }
     
     return false;  // should never get here
@@ -755,42 +1054,41 @@ std::set<void*> Scheduler::pauseAllTargetsWithMinPriority(int minPriority)
     std::set<void*> idsWithSelectors;
 
     // Custom Selectors
-    for(tHashTimerEntry *element = _hashForTimers; element != nullptr;
-        element = (tHashTimerEntry*)element->hh.next)
+    for (const auto& pair : _hashForTimers)
     {
-        element->paused = true;
-        idsWithSelectors.insert(element->target);
+        setTimersPaused(pair.second, true);
+        idsWithSelectors.insert(pair.first);
     }
 
     // Updates selectors
-    tListEntry *entry, *tmp;
-    if(minPriority < 0)
+    for (auto& entry : _updateEntries)
     {
-        DL_FOREACH_SAFE( _updatesNegList, entry, tmp ) 
+        if (!entry.markedForDeletion && entry.priority >= minPriority)
         {
-            if(entry->priority >= minPriority)
-            {
-                entry->paused = true;
-                idsWithSelectors.insert(entry->target);
-            }
+            entry.paused = true;
+            idsWithSelectors.insert(entry.target);
         }
     }
 
-    if(minPriority <= 0)
+    for (auto& entry : _pendingUpdateEntries)
     {
-        DL_FOREACH_SAFE( _updates0List, entry, tmp )
+        if (!entry.markedForDeletion && entry.priority >= minPriority)
         {
-            entry->paused = true;
-            idsWithSelectors.insert(entry->target);
+            entry.paused = true;
+            idsWithSelectors.insert(entry.target);
         }
     }
 
-    DL_FOREACH_SAFE( _updatesPosList, entry, tmp ) 
+    // Fixed updates
+    for (auto* entries : { &_fixedUpdateEntries, &_pendingFixedUpdateEntries })
     {
-        if(entry->priority >= minPriority) 
+        for (auto& entry : *entries)
         {
-            entry->paused = true;
-            idsWithSelectors.insert(entry->target);
+            if (!entry.markedForDeletion && entry.priority >= minPriority)
+            {
+                entry.paused = true;
+                idsWithSelectors.insert(entry.target);
+            }
         }
     }
 
@@ -806,109 +1104,252 @@ void Scheduler::resumeTargets(const std::set<void*>& targetsToResume)
 
 void Scheduler::performFunctionInCocosThread(std::function<void ()> function)
 {
-    std::lock_guard<std::mutex> lock(_performMutex);
-    _functionsToPerform.push_back(std::move(function));
+    performFunctionInCocosThread(std::move(function), 0);
+}
+
+void Scheduler::performFunctionInCocosThread(std::function<void ()> function, int priority)
+{
+    PerformNode *node = new (std::nothrow) PerformNode();
+    node->function = std::move(function);
+    node->priority = priority;
+    node->generation = _performGeneration.load(std::memory_order_acquire);
+    pushFunctionToPerform(node);
 }
 
 void Scheduler::removeAllFunctionsToBePerformedInCocosThread()
 {
-    std::unique_lock<std::mutex> lock(_performMutex);
-    _functionsToPerform.clear();
+    // the queue may only be drained by the cocos thread, so the functions are dropped when they are reached
+    _performGeneration.fetch_add(1, std::memory_order_acq_rel);
 }
 
-// main loop
-void Scheduler::update(float dt)
+// Intrusive MPSC queue (D. Vyukov): producers only swap the head, the consumer walks from the tail.
+void Scheduler::pushFunctionToPerform(PerformNode *node)
 {
-    _updateHashLocked = true;
+    node->next.store(nullptr, std::memory_order_relaxed);
+    PerformNode *prev = _performHead.exchange(node, std::memory_order_acq_rel);
+    prev->next.store(node, std::memory_order_release);
+}
 
-    if (_timeScale != 1.0f)
+Scheduler::PerformNode* Scheduler::popFunctionToPerform()
+{
+    PerformNode *tail = _performTail;
+    PerformNode *next = tail->next.load(std::memory_order_acquire);
+
+    if (tail == _performStub)
     {
-        dt *= _timeScale;
+        if (next == nullptr)
+        {
+            return nullptr;
+        }
+        _performTail = next;
+        tail = next;
+        next = next->next.load(std::memory_order_acquire);
     }
 
-    //
-    // Selector callbacks
-    //
+    if (next)
+    {
+        _performTail = next;
+        return tail;
+    }
 
-    // Iterate over all the Updates' selectors
-    tListEntry *entry, *tmp;
+    // a producer swapped the head but hasn't linked its node yet, pick it up next frame
+    if (tail != _performHead.load(std::memory_order_acquire))
+    {
+        return nullptr;
+    }
 
-    // updates with priority < 0
-    DL_FOREACH_SAFE(_updatesNegList, entry, tmp)
+    pushFunctionToPerform(_performStub);
+    next = tail->next.load(std::memory_order_acquire);
+    if (next)
     {
-        if ((! entry->paused) && (! entry->markedForDeletion))
+        _performTail = next;
+        return tail;
+    }
+
+    return nullptr;
+}
+
+void Scheduler::performFunctions()
+{
+    // Functions posted while the others are called wait until the next frame
+    for (PerformNode *node = popFunctionToPerform(); node; node = popFunctionToPerform())
+    {
+        if (node->generation != _performGeneration.load(std::memory_order_acquire))
         {
-            entry->callback(dt);
+            delete node;
+            continue;
         }
+
+        // almost all functions have the same priority and go to the back
+        auto position = std::upper_bound(_functionsToPerform.begin(), _functionsToPerform.end(), node, [](const PerformNode *a, const PerformNode *b) {
+            return a->priority < b->priority;
+        });
+        _functionsToPerform.insert(position, node);
     }
 
-    // updates with priority == 0
-    DL_FOREACH_SAFE(_updates0List, entry, tmp)
+    if (_functionsToPerform.empty())
     {
-        if ((! entry->paused) && (! entry->markedForDeletion))
+        return;
+    }
+
+    const auto start = std::chrono::steady_clock::now();
+    const auto budget = std::chrono::duration<float>(_performFunctionBudget);
+    while (!_functionsToPerform.empty())
+    {
+        PerformNode *node = _functionsToPerform.front();
+        _functionsToPerform.pop_front();
+
+        // removeAllFunctionsToBePerformedInCocosThread() may be called by one of the functions
+        if (node->generation == _performGeneration.load(std::memory_order_acquire))
+        {
+            node->function();
+        }
+        delete node;
+
+        if (_performFunctionBudget > 0 && std::chrono::steady_clock::now() - start >= budget)
         {
-            entry->callback(dt);
+            break;
         }
     }
+}
+
+// main loop
+void Scheduler::scheduleFixedUpdate(const ccSchedulerFunc& callback, void *target, int priority, bool paused, const std::string& key)
+{
+    CCASSERT(target, "Argument target must be non-nullptr");
+    CCASSERT(!key.empty(), "key should not be empty!");
 
-    // updates with priority > 0
-    DL_FOREACH_SAFE(_updatesPosList, entry, tmp)
+    // the previous callback may be running, it's replaced when the entries are folded in
+    unscheduleFixedUpdate(key, target);
+
+    FixedUpdateEntry entry;
+    entry.callback = callback;
+    entry.target = target;
+    entry.key = key;
+    entry.priority = priority;
+    entry.paused = paused;
+    entry.markedForDeletion = false;
+    _pendingFixedUpdateEntries.push_back(std::move(entry));
+}
+
+void Scheduler::unscheduleFixedUpdate(const std::string& key, void *target)
+{
+    for (auto* entries : { &_fixedUpdateEntries, &_pendingFixedUpdateEntries })
     {
-        if ((! entry->paused) && (! entry->markedForDeletion))
+        for (auto& entry : *entries)
         {
-            entry->callback(dt);
+            if (entry.target == target && entry.key == key)
+                entry.markedForDeletion = true;
         }
     }
+}
 
-    // Iterate over all the custom selectors
-    for (tHashTimerEntry *elt = _hashForTimers; elt != nullptr; )
+bool Scheduler::isFixedUpdateScheduled(const std::string& key, const void *target) const
+{
+    for (auto* entries : { &_fixedUpdateEntries, &_pendingFixedUpdateEntries })
     {
-        _currentTarget = elt;
-        _currentTargetSalvaged = false;
-
-        if (! _currentTarget->paused)
+        for (const auto& entry : *entries)
         {
-            // The 'timers' array may change while inside this loop
-            for (elt->timerIndex = 0; elt->timerIndex < elt->timers->num; ++(elt->timerIndex))
-            {
-                elt->currentTimer = (Timer*)(elt->timers->arr[elt->timerIndex]);
-                CCASSERT
-                  ( !elt->currentTimer->isAborted(),
-                    "An aborted timer should not be updated" );
+            if (entry.target == target && entry.key == key && !entry.markedForDeletion)
+                return true;
+        }
+    }
+    return false;
+}
 
-                elt->currentTimer->update(dt);
+void Scheduler::setFixedTimestep(float seconds)
+{
+    CCASSERT(seconds > 0, "The fixed timestep must be positive");
+    _fixedTimestep = seconds;
+}
 
-                if (elt->currentTimer->isAborted())
-                {
-                    // The currentTimer told the remove itself. To prevent the timer from
-                    // accidentally deallocating itself before finishing its step, we retained
-                    // it. Now that step is done, it's safe to release it.
-                    elt->currentTimer->release();
-                }
+void Scheduler::setMaxFixedStepsPerFrame(int steps)
+{
+    CCASSERT(steps > 0, "At least one fixed step per frame");
+    _maxFixedSteps = steps;
+}
+
+void Scheduler::compactFixedUpdateEntries()
+{
+    _fixedUpdateEntries.erase(std::remove_if(_fixedUpdateEntries.begin(), _fixedUpdateEntries.end(), [](const FixedUpdateEntry& entry) {
+        return entry.markedForDeletion;
+    }), _fixedUpdateEntries.end());
+
+    for (auto& entry : _pendingFixedUpdateEntries)
+    {
+        if (entry.markedForDeletion)
+            continue;
+        // after the entries of the same priority
+        auto position = std::upper_bound(_fixedUpdateEntries.begin(), _fixedUpdateEntries.end(), entry.priority, [](int priority, const FixedUpdateEntry& other) {
+            return priority < other.priority;
+        });
+        _fixedUpdateEntries.insert(position, std::move(entry));
+    }
+    _pendingFixedUpdateEntries.clear();
+}
+
+void Scheduler::updateFixed(float dt)
+{
+    _fixedAccumulator += dt;
+    _fixedStepCount = 0;
+    while (_fixedAccumulator >= _fixedTimestep)
+    {
+        if (_fixedStepCount == _maxFixedSteps)
+        {
+            // drop the time the steps can't catch up with, only the fraction of a step is kept
+            _fixedAccumulator = std::fmod(_fixedAccumulator, _fixedTimestep);
+            break;
+        }
 
-                elt->currentTimer = nullptr;
+        compactFixedUpdateEntries();
+        // the array is not modified while looping: new entries wait in _pendingFixedUpdateEntries
+        for (size_t i = 0, count = _fixedUpdateEntries.size(); i < count; ++i)
+        {
+            FixedUpdateEntry &entry = _fixedUpdateEntries[i];
+            if (!entry.paused && !entry.markedForDeletion)
+            {
+                entry.callback(_fixedTimestep);
             }
         }
 
-        // elt, at this moment, is still valid
-        // so it is safe to ask this here (issue #490)
-        elt = (tHashTimerEntry *)elt->hh.next;
+        _fixedAccumulator -= _fixedTimestep;
+        ++_fixedStepCount;
+    }
+    _fixedUpdateAlpha = _fixedAccumulator / _fixedTimestep;
+}
+
+void Scheduler::update(float dt)
+{
+    CC_PROFILER_ZONE("Scheduler::update");
+
+    if (_timeScale != 1.0f)
+    {
+        dt *= _timeScale;
+    }
+
+    // the fixed steps of the frame, before the callbacks that see their result
+    updateFixed(dt);
+
+    //
+    // Selector callbacks
+    //
+
+    // fold in the updates scheduled and unscheduled since the last tick
+    compactUpdateEntries();
 
-        // only delete currentTarget if no actions were scheduled during the cycle (issue #481)
-        if (_currentTargetSalvaged && _currentTarget->timers->num == 0)
+    // Iterate over all the Updates' selectors, sorted by priority.
+    // The array is not modified while looping: new entries wait in _pendingUpdateEntries.
+    for (size_t i = 0, count = _updateEntries.size(); i < count; ++i)
+    {
+        _listEntry &entry = _updateEntries[i];
+        if ((! entry.paused) && (! entry.markedForDeletion))
         {
-            removeHashElement(_currentTarget);
+            entry.callback(dt);
         }
     }
- 
-    // delete all updates that are removed in update
-    for (auto &e : _updateDeleteVector)
-        delete e;
 
-    _updateDeleteVector.clear();
-
-    _updateHashLocked = false;
-    _currentTarget = nullptr;
+    // Trigger the custom selectors that are due
+    updateTimers(dt);
 
 #if CC_ENABLE_SCRIPT_BINDING
     //
@@ -935,19 +1376,7 @@ void Scheduler::update(float dt)
     //
     // Functions allocated from another thread
     //
-
-    // Testing size is faster than locking / unlocking.
-    // And almost never there will be functions scheduled to be called.
-    if( !_functionsToPerform.empty() ) {
-        _performMutex.lock();
-        // fixed #4123: Save the callback functions, they must be invoked after '_performMutex.unlock()', otherwise if new functions are added in callback, it will cause thread deadlock.
-        auto temp = std::move(_functionsToPerform);
-        _performMutex.unlock();
-        
-        for (const auto &function : temp) {
-            function();
-        }
-    }
+    performFunctions();
 }
 
 void Scheduler::schedule(SEL_SCHEDULE selector, Ref *target, float interval, unsigned int repeat, float delay, bool paused)
@@ -955,47 +1384,43 @@ void Scheduler::schedule(SEL_SCHEDULE selector, Ref *target, float interval, uns
     CCASSERT(target, "Argument target must be non-nullptr");
     
     tHashTimerEntry *element = nullptr;
-    HASH_FIND_PTR(_hashForTimers, &target, element);
+    auto iter = _hashForTimers.find(target);
     
-    if (! element)
+    if (iter == _hashForTimers.end())
     {
-        element = (tHashTimerEntry *)calloc(sizeof(*element), 1);
+        element = new (std::nothrow) tHashTimerEntry();
         element->target = target;
         
-        HASH_ADD_PTR(_hashForTimers, target, element);
+        _hashForTimers.emplace(target, element);
         
         // Is this the 1st element ? Then set the pause level to all the selectors of this target
         element->paused = paused;
     }
     else
     {
+        element = iter->second;
         CCASSERT(element->paused == paused, "element's paused should be paused.");
     }
     
-    if (element->timers == nullptr)
-    {
-        element->timers = ccArrayNew(10);
-    }
-    else
+    for (auto t : element->timers)
     {
-        for (int i = 0; i < element->timers->num; ++i)
+        TimerTargetSelector *timer = dynamic_cast<TimerTargetSelector*>(t);
+        
+        if (timer && !timer->isExhausted() && selector == timer->getSelector())
         {
-            TimerTargetSelector *timer = dynamic_cast<TimerTargetSelector*>(element->timers->arr[i]);
-            
-            if (timer && !timer->isExhausted() && selector == timer->getSelector())
-            {
-                CCLOG("CCScheduler#schedule. Reiniting timer with interval %.4f, repeat %u, delay %.4f", interval, repeat, delay);
-                timer->setupTimerWithInterval(interval, repeat, delay);
-                return;
-            }
+            CCLOG("CCScheduler#schedule. Reiniting timer with interval %.4f, repeat %u, delay %.4f", interval, repeat, delay);
+            timer->setupTimerWithInterval(interval, repeat, delay);
+            detachTimer(timer);
+            queueTimer(timer, element->paused);
+            return;
         }
-        ccArrayEnsureExtraCapacity(element->timers, 1);
     }
     
     TimerTargetSelector *timer = new (std::nothrow) TimerTargetSelector();
     timer->initWithSelector(this, selector, target, interval, repeat, delay);
-    ccArrayAppendObject(element->timers, timer);
+    element->timers.pushBack(timer);
     timer->release();
+    queueTimer(timer, element->paused);
 }
 
 void Scheduler::schedule(SEL_SCHEDULE selector, Ref *target, float interval, bool paused)
@@ -1008,22 +1433,16 @@ bool Scheduler::isScheduled(SEL_SCHEDULE selector, const Ref *target) const
     CCASSERT(selector, "Argument selector must be non-nullptr");
     CCASSERT(target, "Argument target must be non-nullptr");
     
-    tHashTimerEntry *element = nullptr;
-    HASH_FIND_PTR(_hashForTimers, &target, element);
-    
-    if (!element)
-    {
-        return false;
-    }
+    auto iter = _hashForTimers.find(const_cast<Ref*>(target));
     
-    if (element->timers == nullptr)
+    if (iter == _hashForTimers.end())
     {
         return false;
     }
 
-    for (int i = 0; i < element->timers->num; ++i)
+    for (auto t : iter->second->timers)
     {
-        TimerTargetSelector *timer = dynamic_cast<TimerTargetSelector*>(element->timers->arr[i]);
+        TimerTargetSelector *timer = dynamic_cast<TimerTargetSelector*>(t);
         
         if (timer && !timer->isExhausted() && selector == timer->getSelector())
         {
@@ -1042,41 +1461,25 @@ void Scheduler::unschedule(SEL_SCHEDULE selector, Ref *target)
         return;
     }
     
-    tHashTimerEntry *element = nullptr;
-    HASH_FIND_PTR(_hashForTimers, &target, element);
+    auto iter = _hashForTimers.find(target);
     
-    if (element)
+    if (iter != _hashForTimers.end())
     {
-        for (int i = 0; i < element->timers->num; ++i)
+        tHashTimerEntry *element = iter->second;
+        for (ssize_t i = 0; i < element->timers.size(); ++i)
         {
-            TimerTargetSelector *timer = dynamic_cast<TimerTargetSelector*>(element->timers->arr[i]);
+            TimerTargetSelector *timer = dynamic_cast<TimerTargetSelector*>(element->timers.at(i));
             
             if (timer && selector == timer->getSelector())
             {
-                if (timer == element->currentTimer && !timer->isAborted())
-                {
-                    timer->retain();
-                    timer->setAborted();
-                }
-                
-                ccArrayRemoveObjectAtIndex(element->timers, i, true);
-                
-                // update timerIndex in case we are in tick:, looping over the actions
-                if (element->timerIndex >= i)
-                {
-                    element->timerIndex--;
-                }
+                // a timer being triggered is kept alive by the array it is triggered from
+                detachTimer(timer);
+                timer->setAborted();
+                element->timers.erase(i);
                 
-                if (element->timers->num == 0)
+                if (element->timers.empty())
                 {
-                    if (_currentTarget == element)
-                    {
-                        _currentTargetSalvaged = true;
-                    }
-                    else
-                    {
-                        removeHashElement(element);
-                    }
+                    removeHashElement(element);
                 }
                 
                 return;
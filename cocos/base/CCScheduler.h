@@ -28,9 +28,13 @@ THE SOFTWARE.
 #ifndef __CCSCHEDULER_H__
 #define __CCSCHEDULER_H__
 
+#include <atomic>
+#include <deque>
 #include <functional>
 #include <mutex>
 #include <set>
+#include <unordered_map>
+#include <vector>
 
 #include "base/CCRef.h"
 #include "base/CCVector.h"
@@ -71,6 +75,15 @@ protected:
     float _delay;
     float _interval;
     bool _aborted;
+
+    // Bookkeeping owned by the Scheduler's timer wheel.
+    friend class Scheduler;
+    double _dueTime;                // scheduler time of the next trigger, or the time left while paused
+    Timer* _wheelPrev;
+    Timer* _wheelNext;
+    int _wheelSlot;                 // slot of the wheel the timer is linked in, -1 if none
+    int _frameIndex;                // index in the per-frame timer array, -1 if none
+    unsigned char _schedulerState;
 };
 
 
@@ -130,6 +143,16 @@ private:
 
 #endif
 
+// Entry of the flat array used for "updates with priority"
+struct _listEntry
+{
+    ccSchedulerFunc     callback;
+    void                *target;
+    int                 priority;
+    bool                paused;
+    bool                markedForDeletion; // selector will no longer be called and entry will be removed at end of the next tick
+};
+
 /**
  * @endcond
  */
@@ -139,9 +162,7 @@ private:
  * @{
  */
 
-struct _listEntry;
 struct _hashSelectorEntry;
-struct _hashUpdateEntry;
 
 #if CC_ENABLE_SCRIPT_BINDING
 class SchedulerScriptHandlerEntry;
@@ -296,6 +317,63 @@ public:
      */
     unsigned int scheduleScriptFunc(unsigned int handler, float interval, bool paused);
 #endif
+
+    /////////////////////////////////////
+
+    // fixed update
+
+    /** Schedules a callback called with the fixed timestep, zero or more times per frame.
+     The time of the frames is accumulated, and each step consumed calls the fixed updates once, before the
+     other callbacks of the frame. The state they simulate then doesn't depend on the frame rate; the rendering
+     can interpolate between the last two steps with getFixedUpdateAlpha().
+     If the callback is already scheduled for the key and the target, it's replaced from the next step.
+     @param callback The callback function, called with getFixedTimestep().
+     @param target The target of the callback, paused and unscheduled like the other callbacks of the target.
+     @param priority The callbacks with a lower priority are called first in a step.
+     @param paused Whether or not to pause the callback.
+     @param key The key to identify the callback.
+     @since v3.14
+     @js NA
+     */
+    void scheduleFixedUpdate(const ccSchedulerFunc& callback, void *target, int priority, bool paused, const std::string& key);
+
+    /** Unschedules a fixed update callback for a key and a given target.
+     @since v3.14
+     @js NA
+     */
+    void unscheduleFixedUpdate(const std::string& key, void *target);
+
+    /** Checks whether a fixed update callback is scheduled for a key and a given target.
+     @since v3.14
+     @js NA
+     */
+    bool isFixedUpdateScheduled(const std::string& key, const void *target) const;
+
+    /** Sets the time simulated by a fixed update step, 1/60 of a second by default.
+     @since v3.14
+     */
+    void setFixedTimestep(float seconds);
+    /** Gets the time simulated by a fixed update step. @since v3.14 */
+    float getFixedTimestep() const { return _fixedTimestep; }
+
+    /** Sets the maximum number of fixed update steps per frame, 5 by default.
+     When a frame is longer than that many steps, eg: after a hitch, the time left is dropped and the simulation
+     slows down for a frame, instead of taking ever longer frames to catch up.
+     @since v3.14
+     */
+    void setMaxFixedStepsPerFrame(int steps);
+    /** Gets the maximum number of fixed update steps per frame. @since v3.14 */
+    int getMaxFixedStepsPerFrame() const { return _maxFixedSteps; }
+
+    /** The number of fixed update steps of the last frame. @since v3.14 */
+    int getFixedStepCount() const { return _fixedStepCount; }
+
+    /** The time accumulated since the last fixed update step, as a share of the timestep from 0 to 1.
+     The state rendered is the one of the last two steps, `previous + (current - previous) * alpha`.
+     @since v3.14
+     */
+    float getFixedUpdateAlpha() const { return _fixedUpdateAlpha; }
+
     /////////////////////////////////////
     
     // unschedule
@@ -427,6 +505,15 @@ public:
      @js NA
      */
     void performFunctionInCocosThread(std::function<void()> function);
+
+    /** Calls a function on the cocos2d thread with a given priority.
+     Functions with a lower priority are called first, functions with the same priority in the order they were posted.
+     This function is thread safe and lock free.
+     @param function The function to be run in cocos2d thread.
+     @param priority The priority of the function, 0 for performFunctionInCocosThread(function).
+     @js NA
+     */
+    void performFunctionInCocosThread(std::function<void()> function, int priority);
     
     /**
      * Remove all pending functions queued to be performed with Scheduler::performFunctionInCocosThread
@@ -436,6 +523,20 @@ public:
      * @js NA
      */
     void removeAllFunctionsToBePerformedInCocosThread();
+
+    /** Sets the time in seconds the functions posted with performFunctionInCocosThread may use per frame.
+     When the budget is spent the remaining functions are called in the next frames, so a burst of
+     completions doesn't cause one long frame. At least one function is called each frame.
+     Default is 0, no limit.
+     @param seconds The budget in seconds, 0 for no limit.
+     @js NA
+     */
+    void setPerformFunctionBudget(float seconds) { _performFunctionBudget = seconds; }
+    /** Gets the per frame budget of the functions posted with performFunctionInCocosThread.
+     @see Scheduler::setPerformFunctionBudget()
+     @js NA
+     */
+    float getPerformFunctionBudget() const { return _performFunctionBudget; }
     
     /////////////////////////////////////
     
@@ -507,39 +608,93 @@ protected:
     void schedulePerFrame(const ccSchedulerFunc& callback, void *target, int priority, bool paused);
     
     void removeHashElement(struct _hashSelectorEntry *element);
-    void removeUpdateFromHash(struct _listEntry *entry);
 
     // update specific
 
-    void priorityIn(struct _listEntry **list, const ccSchedulerFunc& callback, void *target, int priority, bool paused);
-    void appendIn(struct _listEntry **list, const ccSchedulerFunc& callback, void *target, bool paused);
+    struct _listEntry* findUpdateEntry(void *target);
+    void compactUpdateEntries();
 
+    // timer wheel specific
+
+    void linkTimer(Timer *timer);
+    void unlinkTimer(Timer *timer);
+    void detachTimer(Timer *timer);
+    void queueTimer(Timer *timer, bool paused);
+    void startTimer(Timer *timer);
+    void fireTimer(Timer *timer);
+    void addFrameTimer(Timer *timer);
+    void setTimersPaused(struct _hashSelectorEntry *element, bool paused);
+    void updateTimers(float dt);
+
+    // fixed update specific
+
+    struct FixedUpdateEntry
+    {
+        ccSchedulerFunc callback;
+        void *target;
+        std::string key;
+        int priority;
+        bool paused;
+        bool markedForDeletion;
+    };
+    void compactFixedUpdateEntries();
+    void updateFixed(float dt);
 
     float _timeScale;
 
     //
     // "updates with priority" stuff
     //
-    struct _listEntry *_updatesNegList;        // list of priority < 0
-    struct _listEntry *_updates0List;            // list priority == 0
-    struct _listEntry *_updatesPosList;        // list priority > 0
-    struct _hashUpdateEntry *_hashForUpdates; // hash used to fetch quickly the list entries for pause,delete,etc
-    std::vector<struct _listEntry *> _updateDeleteVector; // the vector holds list entries that needs to be deleted after update
+    // Entries live in one contiguous array sorted by priority. Entries scheduled since the last tick are kept
+    // in _pendingUpdateEntries and entries unscheduled are only marked; both are folded in at the start of the next tick.
+    std::vector<struct _listEntry> _updateEntries;
+    std::vector<struct _listEntry> _pendingUpdateEntries;
+    // target -> index in _updateEntries, or -(index + 1) in _pendingUpdateEntries
+    std::unordered_map<void*, ssize_t> _updateEntryIndices;
+    bool _updateEntriesDirty;
 
     // Used for "selectors with interval"
-    struct _hashSelectorEntry *_hashForTimers;
-    struct _hashSelectorEntry *_currentTarget;
-    bool _currentTargetSalvaged;
-    // If true unschedule will not remove anything from a hash. Elements will only be marked for deletion.
-    bool _updateHashLocked;
+    std::unordered_map<void*, struct _hashSelectorEntry*> _hashForTimers;
+
+    // Hierarchical timing wheel: interval timers are bucketed by due tick so a tick only touches the timers that are due.
+    enum { TIMER_WHEEL_BITS = 8, TIMER_WHEEL_SIZE = 1 << TIMER_WHEEL_BITS, TIMER_WHEEL_LEVELS = 4 };
+    Timer *_timerWheel[TIMER_WHEEL_LEVELS * TIMER_WHEEL_SIZE];
+    uint64_t _timerWheelTick;
+    double _timerTime;
+    std::vector<Timer*> _frameTimers;   // interval 0 timers, triggered every tick
+    std::vector<Timer*> _pendingTimers; // (re)scheduled timers, started at the end of the next tick
+    std::vector<Timer*> _dueTimers;
+    bool _frameTimersDirty;
+
+    // Fixed updates, sorted by priority. Like the update entries, the ones scheduled wait in
+    // _pendingFixedUpdateEntries and the ones unscheduled are only marked until the next step.
+    std::vector<FixedUpdateEntry> _fixedUpdateEntries;
+    std::vector<FixedUpdateEntry> _pendingFixedUpdateEntries;
+    float _fixedTimestep;
+    float _fixedAccumulator;
+    float _fixedUpdateAlpha;
+    int _maxFixedSteps;
+    int _fixedStepCount;
     
 #if CC_ENABLE_SCRIPT_BINDING
     Vector<SchedulerScriptHandlerEntry*> _scriptHandlerEntries;
 #endif
     
     // Used for "perform Function"
-    std::vector<std::function<void()>> _functionsToPerform;
-    std::mutex _performMutex;
+    // Other threads post to a lock free multi-producer single-consumer queue, the cocos thread moves
+    // the functions to _functionsToPerform, ordered by priority, and calls them within the frame budget.
+    struct PerformNode;
+    void pushFunctionToPerform(PerformNode *node);
+    PerformNode* popFunctionToPerform();
+    void performFunctions();
+
+    std::atomic<PerformNode*> _performHead;
+    PerformNode *_performTail;
+    PerformNode *_performStub;
+    // bumped by removeAllFunctionsToBePerformedInCocosThread(), functions posted before are dropped
+    std::atomic<unsigned int> _performGeneration;
+    std::deque<PerformNode*> _functionsToPerform;
+    float _performFunctionBudget;
 };
 
 // end of base group
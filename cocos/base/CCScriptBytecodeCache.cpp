@@ -0,0 +1,202 @@
+/****************************************************************************
+Copyright (c) 2017 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+
+#include "base/CCScriptBytecodeCache.h"
+
+#include <string.h>
+
+#include "platform/CCFileUtils.h"
+#include "base/ccUTF8.h"
+
+NS_CC_BEGIN
+
+extern const char* cocos2dVersion();
+
+ScriptBytecodeCache* ScriptBytecodeCache::s_sharedCache = nullptr;
+
+namespace
+{
+    const char ENTRY_MAGIC[4] = { 'C', 'C', 'B', 'C' };
+    const char* VERSION_FILE = "version";
+
+    // in front of the bytecode of an entry, checked before it's returned
+    struct EntryHeader
+    {
+        char magic[4];
+        uint32_t sourceSize;
+        uint64_t sourceHash;
+        uint32_t bytecodeSize;
+        uint32_t reserved;
+    };
+}
+
+ScriptBytecodeCache* ScriptBytecodeCache::getInstance()
+{
+    if (s_sharedCache == nullptr)
+    {
+        s_sharedCache = new (std::nothrow) ScriptBytecodeCache();
+    }
+    return s_sharedCache;
+}
+
+void ScriptBytecodeCache::destroyInstance()
+{
+    delete s_sharedCache;
+    s_sharedCache = nullptr;
+}
+
+ScriptBytecodeCache::ScriptBytecodeCache()
+: _enabled(false)
+, _directoryReady(false)
+{
+    _directory = FileUtils::getInstance()->getWritablePath() + "bytecode/";
+}
+
+void ScriptBytecodeCache::setDirectory(const std::string& directory)
+{
+    CCASSERT(!directory.empty() && directory.back() == '/', "ScriptBytecodeCache: the directory should end with '/'");
+    if (_directory != directory)
+    {
+        _directory = directory;
+        _directoryReady = false;
+    }
+}
+
+uint64_t ScriptBytecodeCache::hash(const unsigned char* bytes, ssize_t size)
+{
+    // 64 bits FNV-1a, stable across platforms and launches unlike std::hash
+    uint64_t value = 14695981039346656037ULL;
+    for (ssize_t i = 0; i < size; ++i)
+    {
+        value ^= bytes[i];
+        value *= 1099511628211ULL;
+    }
+    return value;
+}
+
+std::string ScriptBytecodeCache::getEntryPath(const std::string& engine, uint64_t sourceHash) const
+{
+    // the bytecode of 32 and 64 bits builds of an engine may differ
+    return StringUtils::format("%s%s-%d-%016llx.bc", _directory.c_str(), engine.c_str(), (int)sizeof(void*) * 8, (unsigned long long)sourceHash);
+}
+
+bool ScriptBytecodeCache::prepareDirectory()
+{
+    if (_directoryReady)
+        return true;
+
+    auto fileUtils = FileUtils::getInstance();
+    std::string versionPath = _directory + VERSION_FILE;
+    std::string version = cocos2dVersion();
+    if (fileUtils->isDirectoryExist(_directory) && fileUtils->getStringFromFile(versionPath) != version)
+    {
+        fileUtils->removeDirectory(_directory);
+    }
+    if (!fileUtils->isDirectoryExist(_directory))
+    {
+        if (!fileUtils->createDirectory(_directory) || !fileUtils->writeStringToFile(version, versionPath))
+        {
+            CCLOG("ScriptBytecodeCache: can't write in %s", _directory.c_str());
+            return false;
+        }
+    }
+    _directoryReady = true;
+    return true;
+}
+
+Data ScriptBytecodeCache::getBytecode(const std::string& engine, const unsigned char* source, ssize_t size)
+{
+    Data bytecode;
+    if (!_enabled || size <= 0 || !prepareDirectory())
+        return bytecode;
+
+    uint64_t sourceHash = hash(source, size);
+    std::string path = getEntryPath(engine, sourceHash);
+    auto fileUtils = FileUtils::getInstance();
+    if (!fileUtils->isFileExist(path))
+        return bytecode;
+
+    Data entry = fileUtils->getDataFromFile(path);
+    EntryHeader header;
+    if (entry.getSize() < (ssize_t)sizeof(header))
+        return bytecode;
+
+    memcpy(&header, entry.getBytes(), sizeof(header));
+    if (memcmp(header.magic, ENTRY_MAGIC, sizeof(ENTRY_MAGIC)) != 0
+        || header.sourceSize != (uint32_t)size || header.sourceHash != sourceHash
+        || header.bytecodeSize != (uint32_t)(entry.getSize() - sizeof(header)))
+    {
+        // written by a build with another layout, or interrupted
+        fileUtils->removeFile(path);
+        return bytecode;
+    }
+
+    bytecode.copy(entry.getBytes() + sizeof(header), header.bytecodeSize);
+    return bytecode;
+}
+
+bool ScriptBytecodeCache::setBytecode(const std::string& engine, const unsigned char* source, ssize_t size, const Data& bytecode)
+{
+    if (!_enabled || size <= 0 || bytecode.isNull() || !prepareDirectory())
+        return false;
+
+    EntryHeader header;
+    memcpy(header.magic, ENTRY_MAGIC, sizeof(ENTRY_MAGIC));
+    header.sourceSize = (uint32_t)size;
+    header.sourceHash = hash(source, size);
+    header.bytecodeSize = (uint32_t)bytecode.getSize();
+    header.reserved = 0;
+
+    ssize_t entrySize = sizeof(header) + bytecode.getSize();
+    auto bytes = (unsigned char*)malloc(entrySize);
+    memcpy(bytes, &header, sizeof(header));
+    memcpy(bytes + sizeof(header), bytecode.getBytes(), bytecode.getSize());
+    Data entry;
+    entry.fastSet(bytes, entrySize);
+
+    return FileUtils::getInstance()->writeDataToFile(entry, getEntryPath(engine, header.sourceHash));
+}
+
+void ScriptBytecodeCache::removeBytecode(const std::string& engine, const unsigned char* source, ssize_t size)
+{
+    auto fileUtils = FileUtils::getInstance();
+    std::string path = getEntryPath(engine, hash(source, size));
+    if (fileUtils->isFileExist(path))
+    {
+        fileUtils->removeFile(path);
+    }
+}
+
+void ScriptBytecodeCache::clear()
+{
+    auto fileUtils = FileUtils::getInstance();
+    if (fileUtils->isDirectoryExist(_directory))
+    {
+        fileUtils->removeDirectory(_directory);
+    }
+    _directoryReady = false;
+}
+
+NS_CC_END
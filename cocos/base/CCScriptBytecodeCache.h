@@ -0,0 +1,116 @@
+/****************************************************************************
+Copyright (c) 2017 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+
+#ifndef __CCSCRIPT_BYTECODE_CACHE_H__
+#define __CCSCRIPT_BYTECODE_CACHE_H__
+
+#include <string>
+
+#include "base/CCData.h"
+
+/**
+ * @addtogroup base
+ * @{
+ */
+NS_CC_BEGIN
+
+/**
+ * @class ScriptBytecodeCache
+ * @brief Keeps the bytecode of the scripts compiled at runtime in the writable path, so the next launches skip the compilation.
+ *
+ * The entries are keyed by a hash of the source and by the engine which compiled it, e.g. the Lua stack and the
+ * JS bindings store their own bytecode. The whole cache is cleared when the version of cocos2d-x changes, and
+ * AssetsManagerEx clears it after an update so the entries of the replaced scripts don't pile up. An entry which
+ * can't be loaded is recompiled and written again.
+ *
+ * The scripts already shipped as bytecode (.luac, .jsc) and the encrypted ones are never cached.
+ * Disabled by default, all the methods must be called on the cocos thread.
+ * @since v3.14
+ * @js NA
+ * @lua NA
+ */
+class CC_DLL ScriptBytecodeCache
+{
+public:
+    /** Returns the shared cache. */
+    static ScriptBytecodeCache* getInstance();
+
+    /** Destroys the shared cache, the files are kept. */
+    static void destroyInstance();
+
+    /** Enables the cache, the scripts loaded afterwards use it. */
+    void setEnabled(bool enabled) { _enabled = enabled; }
+    bool isEnabled() const { return _enabled; }
+
+    /**
+     * Sets the directory of the cache, FileUtils::getWritablePath() + "bytecode/" by default.
+     * @param directory A full path ending with '/'.
+     */
+    void setDirectory(const std::string& directory);
+    const std::string& getDirectory() const { return _directory; }
+
+    /**
+     * Returns the bytecode stored for a source, a null Data if there is none.
+     *
+     * @param engine Identifies the compiler and its bytecode format, e.g. "lua".
+     * @param source The source as loaded from the file.
+     * @param size The size of the source in bytes.
+     */
+    Data getBytecode(const std::string& engine, const unsigned char* source, ssize_t size);
+
+    /**
+     * Stores the bytecode compiled from a source, it replaces the one stored before.
+     * @return Whether it was written.
+     */
+    bool setBytecode(const std::string& engine, const unsigned char* source, ssize_t size, const Data& bytecode);
+
+    /** Removes the bytecode of a source, e.g. when it couldn't be loaded. */
+    void removeBytecode(const std::string& engine, const unsigned char* source, ssize_t size);
+
+    /** Removes all the entries. */
+    void clear();
+
+protected:
+    ScriptBytecodeCache();
+
+    /** Creates the directory and clears it when it was written by another version of cocos2d-x. */
+    bool prepareDirectory();
+    std::string getEntryPath(const std::string& engine, uint64_t hash) const;
+
+    static uint64_t hash(const unsigned char* bytes, ssize_t size);
+
+    std::string _directory;
+    bool _enabled;
+    bool _directoryReady;
+
+    static ScriptBytecodeCache* s_sharedCache;
+};
+
+NS_CC_END
+/**
+ * @}
+ */
+
+#endif // __CCSCRIPT_BYTECODE_CACHE_H__
@@ -37,7 +37,13 @@
 
 NS_CC_BEGIN
 
-GLint StencilStateManager::s_layer = -1;
+// the stencil buffers have 8 bits
+#define STENCIL_LAYERS_MASK 0xff
+
+GLuint StencilStateManager::s_usedLayers = 0;
+GLuint StencilStateManager::s_clearedLayers = 0;
+unsigned int StencilStateManager::s_clearedLayersFrame = 0;
+GLint StencilStateManager::s_clearedLayersViewport[4] = { 0, 0, 0, 0 };
 
 StencilStateManager::StencilStateManager()
 : _alphaThreshold(1.0f)
@@ -54,8 +60,14 @@ StencilStateManager::StencilStateManager()
 ,  _currentAlphaTestEnabled(GL_FALSE)
 , _currentAlphaTestFunc(GL_ALWAYS)
 , _currentAlphaTestRef(1)
+, _mask_layer_le(0)
+, _layer(0)
+{
+}
 
+void StencilStateManager::invalidateClearedLayers()
 {
+    s_clearedLayers = 0;
 }
 
 void StencilStateManager::drawFullScreenQuadClearStencil()
@@ -124,29 +136,48 @@ void StencilStateManager::onBeforeVisit()
     ///////////////////////////////////
     // INIT
     
-    // increment the current layer
-    s_layer++;
-    
+    // the stencil buffer isn't cleared between the frames, and the clear quad only covers the viewport
+    auto frame = Director::getInstance()->getTotalFrames();
+    GLint viewport[4];
+    GL::getViewport(viewport);
+    if (s_clearedLayersFrame != frame || memcmp(viewport, s_clearedLayersViewport, sizeof(viewport)) != 0)
+    {
+        s_clearedLayersFrame = frame;
+        memcpy(s_clearedLayersViewport, viewport, sizeof(viewport));
+        s_clearedLayers = 0;
+    }
+
+    GLuint freeLayers = ~s_usedLayers & STENCIL_LAYERS_MASK;
+    if (freeLayers == 0)
+    {
+        CCLOGWARN("cocos2d: StencilStateManager: too many nested clipping nodes, the stencil buffer only has 8 layers");
+    }
+    // an inverted clipping node sets its layer to 1 on its own, the other ones take a cleared layer.
+    // when there is none, all the free layers are cleared at once for the next sibling clipping nodes
+    GLuint availableLayers = _inverted ? freeLayers : (freeLayers & s_clearedLayers);
+    bool clearLayers = !_inverted && availableLayers == 0;
+    if (clearLayers)
+    {
+        availableLayers = freeLayers;
+    }
+    // the lowest one
+    _layer = availableLayers & (~availableLayers + 1);
+    s_usedLayers |= _layer;
+
     // mask of the current layer (ie: for layer 3: 00000100)
-    GLint mask_layer = 0x1 << s_layer;
-    // mask of all layers less than the current (ie: for layer 3: 00000011)
-    GLint mask_layer_l = mask_layer - 1;
-    // mask of all layers less than or equal to the current (ie: for layer 3: 00000111)
-    _mask_layer_le = mask_layer | mask_layer_l;
+    GLint mask_layer = _layer;
+    // mask of the layers of this clipping node and the ones which contain it
+    _mask_layer_le = s_usedLayers;
     
     // manually save the stencil state
     
-    _currentStencilEnabled = glIsEnabled(GL_STENCIL_TEST);
-    glGetIntegerv(GL_STENCIL_WRITEMASK, (GLint *)&_currentStencilWriteMask);
-    glGetIntegerv(GL_STENCIL_FUNC, (GLint *)&_currentStencilFunc);
-    glGetIntegerv(GL_STENCIL_REF, &_currentStencilRef);
-    glGetIntegerv(GL_STENCIL_VALUE_MASK, (GLint *)&_currentStencilValueMask);
-    glGetIntegerv(GL_STENCIL_FAIL, (GLint *)&_currentStencilFail);
-    glGetIntegerv(GL_STENCIL_PASS_DEPTH_FAIL, (GLint *)&_currentStencilPassDepthFail);
-    glGetIntegerv(GL_STENCIL_PASS_DEPTH_PASS, (GLint *)&_currentStencilPassDepthPass);
+    _currentStencilEnabled = GL::isEnabled(GL_STENCIL_TEST);
+    _currentStencilWriteMask = GL::getStencilMask();
+    GL::getStencilFunc(&_currentStencilFunc, &_currentStencilRef, &_currentStencilValueMask);
+    GL::getStencilOp(&_currentStencilFail, &_currentStencilPassDepthFail, &_currentStencilPassDepthPass);
     
     // enable stencil use
-    glEnable(GL_STENCIL_TEST);
+    GL::enable(GL_STENCIL_TEST);
     //    RenderState::StateBlock::_defaultState->setStencilTest(true);
     
     // check for OpenGL error while enabling stencil test
@@ -154,12 +185,12 @@ void StencilStateManager::onBeforeVisit()
     
     // all bits on the stencil buffer are readonly, except the current layer bit,
     // this means that operation like glClear or glStencilOp will be masked with this value
-    glStencilMask(mask_layer);
+    GL::stencilMask(mask_layer);
     //    RenderState::StateBlock::_defaultState->setStencilWrite(mask_layer);
     
     // manually save the depth test state
     
-    glGetBooleanv(GL_DEPTH_WRITEMASK, &_currentDepthWriteMask);
+    _currentDepthWriteMask = GL::getDepthMask();
     
     // disable depth test while drawing the stencil
     //glDisable(GL_DEPTH_TEST);
@@ -167,7 +198,7 @@ void StencilStateManager::onBeforeVisit()
     // as the stencil is not meant to be rendered in the real scene,
     // it should never prevent something else to be drawn,
     // only disabling depth buffer update should do
-    glDepthMask(GL_FALSE);
+    GL::depthMask(GL_FALSE);
     RenderState::StateBlock::_defaultState->setDepthWrite(false);
     
     ///////////////////////////////////
@@ -179,12 +210,29 @@ void StencilStateManager::onBeforeVisit()
     //     never draw it into the frame buffer
     //     if not in inverted mode: set the current layer value to 0 in the stencil buffer
     //     if in inverted mode: set the current layer value to 1 in the stencil buffer
-    glStencilFunc(GL_NEVER, mask_layer, mask_layer);
-    glStencilOp(!_inverted ? GL_ZERO : GL_REPLACE, GL_KEEP, GL_KEEP);
-    
-    // draw a fullscreen solid rectangle to clear the stencil buffer
-    //ccDrawSolidRect(Vec2::ZERO, ccpFromSize([[Director sharedDirector] winSize]), Color4F(1, 1, 1, 1));
-    drawFullScreenQuadClearStencil();
+    if (clearLayers)
+    {
+        // the scissor test would only clear a part of the other layers
+        GLuint layers = GL::isEnabled(GL_SCISSOR_TEST) ? _layer : freeLayers;
+        GL::stencilMask(layers);
+        GL::stencilFunc(GL_NEVER, layers, layers);
+        GL::stencilOp(GL_ZERO, GL_KEEP, GL_KEEP);
+        drawFullScreenQuadClearStencil();
+        GL::stencilMask(mask_layer);
+
+        s_clearedLayers |= layers;
+    }
+    else if (_inverted)
+    {
+        GL::stencilFunc(GL_NEVER, mask_layer, mask_layer);
+        GL::stencilOp(GL_REPLACE, GL_KEEP, GL_KEEP);
+
+        // draw a fullscreen solid rectangle to clear the stencil buffer
+        //ccDrawSolidRect(Vec2::ZERO, ccpFromSize([[Director sharedDirector] winSize]), Color4F(1, 1, 1, 1));
+        drawFullScreenQuadClearStencil();
+    }
+    // the stencil is drawn into the layer
+    s_clearedLayers &= ~_layer;
     
     ///////////////////////////////////
     // DRAW CLIPPING STENCIL
@@ -194,10 +242,10 @@ void StencilStateManager::onBeforeVisit()
     //     never draw it into the frame buffer
     //     if not in inverted mode: set the current layer value to 1 in the stencil buffer
     //     if in inverted mode: set the current layer value to 0 in the stencil buffer
-    glStencilFunc(GL_NEVER, mask_layer, mask_layer);
+    GL::stencilFunc(GL_NEVER, mask_layer, mask_layer);
     //    RenderState::StateBlock::_defaultState->setStencilFunction(RenderState::STENCIL_NEVER, mask_layer, mask_layer);
     
-    glStencilOp(!_inverted ? GL_REPLACE : GL_ZERO, GL_KEEP, GL_KEEP);
+    GL::stencilOp(!_inverted ? GL_REPLACE : GL_ZERO, GL_KEEP, GL_KEEP);
     //    RenderState::StateBlock::_defaultState->setStencilOperation(
     //                                                                !_inverted ? RenderState::STENCIL_OP_REPLACE : RenderState::STENCIL_OP_ZERO,
     //                                                                RenderState::STENCIL_OP_KEEP,
@@ -242,7 +290,7 @@ void StencilStateManager::onAfterDrawStencil()
     }
     
     // restore the depth test state
-    glDepthMask(_currentDepthWriteMask);
+    GL::depthMask(_currentDepthWriteMask);
     RenderState::StateBlock::_defaultState->setDepthWrite(_currentDepthWriteMask != 0);
     
     //if (currentDepthTestEnabled) {
@@ -258,10 +306,10 @@ void StencilStateManager::onAfterDrawStencil()
     //         draw the pixel and keep the current layer in the stencil buffer
     //     else
     //         do not draw the pixel but keep the current layer in the stencil buffer
-    glStencilFunc(GL_EQUAL, _mask_layer_le, _mask_layer_le);
+    GL::stencilFunc(GL_EQUAL, _mask_layer_le, _mask_layer_le);
     //    RenderState::StateBlock::_defaultState->setStencilFunction(RenderState::STENCIL_EQUAL, _mask_layer_le, _mask_layer_le);
     
-    glStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
+    GL::stencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
     //    RenderState::StateBlock::_defaultState->setStencilOperation(RenderState::STENCIL_OP_KEEP, RenderState::STENCIL_OP_KEEP, RenderState::STENCIL_OP_KEEP);
     
     // draw (according to the stencil test function) this node and its children
@@ -274,23 +322,23 @@ void StencilStateManager::onAfterVisit()
     // CLEANUP
     
     // manually restore the stencil state
-    glStencilFunc(_currentStencilFunc, _currentStencilRef, _currentStencilValueMask);
+    GL::stencilFunc(_currentStencilFunc, _currentStencilRef, _currentStencilValueMask);
     //    RenderState::StateBlock::_defaultState->setStencilFunction((RenderState::StencilFunction)_currentStencilFunc, _currentStencilRef, _currentStencilValueMask);
     
-    glStencilOp(_currentStencilFail, _currentStencilPassDepthFail, _currentStencilPassDepthPass);
+    GL::stencilOp(_currentStencilFail, _currentStencilPassDepthFail, _currentStencilPassDepthPass);
     //    RenderState::StateBlock::_defaultState->setStencilOperation((RenderState::StencilOperation)_currentStencilFail,
     //                                                                (RenderState::StencilOperation)_currentStencilPassDepthFail,
     //                                                                (RenderState::StencilOperation)_currentStencilPassDepthPass);
     
-    glStencilMask(_currentStencilWriteMask);
+    GL::stencilMask(_currentStencilWriteMask);
     if (!_currentStencilEnabled)
     {
-        glDisable(GL_STENCIL_TEST);
+        GL::disable(GL_STENCIL_TEST);
         //        RenderState::StateBlock::_defaultState->setStencilTest(false);
     }
     
-    // we are done using this layer, decrement
-    s_layer--;
+    // we are done using this layer
+    s_usedLayers &= ~_layer;
 }
 
 
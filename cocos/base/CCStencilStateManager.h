@@ -45,9 +45,22 @@ public:
     void setInverted(bool inverted);
     bool isInverted()const;
     GLfloat getAlphaThreshold()const;
+
+    /** Forgets which stencil layers are known to be cleared.
+     * The layers that aren't used by the clipping nodes being visited are cleared together, so that the
+     * following sibling clipping nodes can use them without clearing the stencil buffer again.
+     * It must be called when the bound framebuffer changes, it's done by RenderTexture and FrameBuffer.
+     * @since v3.14
+     */
+    static void invalidateClearedLayers();
 private:
     CC_DISALLOW_COPY_AND_ASSIGN(StencilStateManager);
-    static GLint s_layer;
+    // the stencil layers of the clipping nodes being visited
+    static GLuint s_usedLayers;
+    // the stencil layers which were cleared and not used since
+    static GLuint s_clearedLayers;
+    static unsigned int s_clearedLayersFrame;
+    static GLint s_clearedLayersViewport[4];
     /**draw fullscreen quad to clear stencil bits
      */
     void drawFullScreenQuadClearStencil();
@@ -71,6 +84,7 @@ private:
     GLclampf _currentAlphaTestRef;
     
     GLint _mask_layer_le;
+    GLuint _layer;
 };
 
 NS_CC_END
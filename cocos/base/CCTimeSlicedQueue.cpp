@@ -0,0 +1,335 @@
+/****************************************************************************
+Copyright (c) 2017 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#include "base/CCTimeSlicedQueue.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include "base/CCDirector.h"
+#include "base/CCScheduler.h"
+#include "base/ccUTF8.h"
+#include "renderer/CCTextureCache.h"
+
+NS_CC_BEGIN
+
+TimeSlicedQueue* TimeSlicedQueue::s_timeSlicedQueue = nullptr;
+
+static const char* TIME_SLICED_QUEUE_KEY = "TimeSlicedQueue";
+
+typedef std::chrono::steady_clock TimeSliceClock;
+
+static float secondsSince(const TimeSliceClock::time_point& begin)
+{
+    return std::chrono::duration_cast<std::chrono::duration<float>>(TimeSliceClock::now() - begin).count();
+}
+
+TimeSlicedQueue* TimeSlicedQueue::getInstance()
+{
+    if (s_timeSlicedQueue == nullptr)
+    {
+        s_timeSlicedQueue = new (std::nothrow) TimeSlicedQueue();
+    }
+    return s_timeSlicedQueue;
+}
+
+void TimeSlicedQueue::destroyInstance()
+{
+    delete s_timeSlicedQueue;
+    s_timeSlicedQueue = nullptr;
+}
+
+TimeSlicedQueue::TimeSlicedQueue()
+: _nextId(0)
+, _frameBudget(0.004f)
+, _updating(false)
+, _scheduled(false)
+{
+}
+
+TimeSlicedQueue::~TimeSlicedQueue()
+{
+    cancelAll();
+    if (_scheduled)
+    {
+        Director::getInstance()->getScheduler()->unschedule(TIME_SLICED_QUEUE_KEY, this);
+    }
+    for (auto task : _tasks)
+    {
+        delete task;
+    }
+    for (auto task : _addedTasks)
+    {
+        delete task;
+    }
+}
+
+TimeSlicedQueue::TaskId TimeSlicedQueue::addTask(const Step& step, int priority, const CompletionCallback& completion)
+{
+    CCASSERT(step, "TimeSlicedQueue: step should not be null");
+
+    auto task = new (std::nothrow) Task();
+    task->priority = priority;
+    task->step = step;
+    task->completion = completion;
+    task->progress = 0;
+    task->budget = 0;
+    task->pendingTextures = 0;
+    task->finished = false;
+    return insertTask(task);
+}
+
+TimeSlicedQueue::TaskId TimeSlicedQueue::addTask(const std::vector<std::function<void()>>& steps, int priority, const CompletionCallback& completion)
+{
+    size_t next = 0;
+    return addTask([steps, next](float& progress) mutable {
+        if (next < steps.size())
+        {
+            steps[next++]();
+        }
+        progress = steps.empty() ? 1.0f : (float)next / steps.size();
+        return next >= steps.size();
+    }, priority, completion);
+}
+
+TimeSlicedQueue::TaskId TimeSlicedQueue::insertTask(Task* task)
+{
+    // 0 is never an id, even after wrapping around
+    if (++_nextId == 0)
+        ++_nextId;
+    task->id = _nextId;
+    _tasksById[task->id] = task;
+
+    if (_updating)
+    {
+        _addedTasks.push_back(task);
+    }
+    else
+    {
+        auto position = std::upper_bound(_tasks.begin(), _tasks.end(), task, [](const Task* a, const Task* b) {
+            return a->priority < b->priority;
+        });
+        _tasks.insert(position, task);
+    }
+    scheduleUpdate();
+    return task->id;
+}
+
+void TimeSlicedQueue::scheduleUpdate()
+{
+    if (!_scheduled)
+    {
+        Director::getInstance()->getScheduler()->schedule(CC_CALLBACK_1(TimeSlicedQueue::update, this), this, 0, false, TIME_SLICED_QUEUE_KEY);
+        _scheduled = true;
+    }
+}
+
+TimeSlicedQueue::Task* TimeSlicedQueue::findTask(TaskId id) const
+{
+    auto iter = _tasksById.find(id);
+    return iter != _tasksById.end() ? iter->second : nullptr;
+}
+
+void TimeSlicedQueue::setProgressCallback(TaskId id, const ProgressCallback& callback)
+{
+    auto task = findTask(id);
+    if (task)
+    {
+        task->progressCallback = callback;
+    }
+}
+
+void TimeSlicedQueue::setTaskBudget(TaskId id, float seconds)
+{
+    auto task = findTask(id);
+    if (task)
+    {
+        task->budget = seconds;
+    }
+}
+
+void TimeSlicedQueue::waitForJob(TaskId id, const JobSystem::JobHandle& job)
+{
+    auto task = findTask(id);
+    if (task && job)
+    {
+        task->jobs.push_back(job);
+    }
+}
+
+void TimeSlicedQueue::waitForTexture(TaskId id, const std::string& filepath)
+{
+    auto task = findTask(id);
+    if (task == nullptr)
+        return;
+
+    // a key of its own, so cancelling the task doesn't cancel the loads of others
+    auto key = StringUtils::format("%s:%u:%s", TIME_SLICED_QUEUE_KEY, id, filepath.c_str());
+    task->textureKeys.push_back(key);
+    ++task->pendingTextures;
+
+    Director::getInstance()->getTextureCache()->addImageAsync(filepath, [this, id](Texture2D* /*texture*/) {
+        auto task = findTask(id);
+        if (task)
+        {
+            --task->pendingTextures;
+        }
+    }, key);
+}
+
+bool TimeSlicedQueue::isReady(Task* task)
+{
+    if (task->pendingTextures > 0)
+        return false;
+
+    auto jobSystem = JobSystem::getInstance();
+    task->jobs.erase(std::remove_if(task->jobs.begin(), task->jobs.end(), [jobSystem](const JobSystem::JobHandle& job) {
+        return jobSystem->isFinished(job);
+    }), task->jobs.end());
+    return task->jobs.empty();
+}
+
+void TimeSlicedQueue::finishTask(Task* task, bool done)
+{
+    task->finished = true;
+    _tasksById.erase(task->id);
+
+    if (done)
+    {
+        if (task->progress < 1 && task->progressCallback)
+        {
+            task->progressCallback(1);
+        }
+    }
+    else if (task->pendingTextures > 0)
+    {
+        auto textureCache = Director::getInstance()->getTextureCache();
+        for (auto& key : task->textureKeys)
+        {
+            textureCache->cancelImageAsync(key);
+        }
+    }
+    task->progress = 1;
+
+    if (task->completion)
+    {
+        task->completion(done);
+    }
+}
+
+void TimeSlicedQueue::cancel(TaskId id)
+{
+    auto task = findTask(id);
+    if (task)
+    {
+        finishTask(task, false);
+    }
+}
+
+void TimeSlicedQueue::cancelAll()
+{
+    // the completion callbacks may add or cancel tasks
+    while (!_tasksById.empty())
+    {
+        finishTask(_tasksById.begin()->second, false);
+    }
+}
+
+bool TimeSlicedQueue::isPending(TaskId id) const
+{
+    return findTask(id) != nullptr;
+}
+
+float TimeSlicedQueue::getProgress(TaskId id) const
+{
+    auto task = findTask(id);
+    return task ? task->progress : 1.0f;
+}
+
+void TimeSlicedQueue::update(float /*dt*/)
+{
+    _updating = true;
+
+    auto begin = TimeSliceClock::now();
+    bool outOfTime = false;
+    for (size_t i = 0; i < _tasks.size() && !outOfTime; ++i)
+    {
+        Task* task = _tasks[i];
+        if (task->finished || !isReady(task))
+            continue;
+
+        auto taskBegin = TimeSliceClock::now();
+        bool done = false;
+        do
+        {
+            float previous = task->progress;
+            done = task->step(task->progress);
+            if (!task->finished && task->progressCallback && task->progress != previous)
+            {
+                task->progressCallback(task->progress);
+            }
+            outOfTime = secondsSince(begin) >= _frameBudget;
+        } while (!done && !task->finished && !outOfTime && (task->budget <= 0 || secondsSince(taskBegin) < task->budget));
+
+        if (done && !task->finished)
+        {
+            finishTask(task, true);
+        }
+    }
+
+    auto finished = std::stable_partition(_tasks.begin(), _tasks.end(), [](const Task* task) {
+        return !task->finished;
+    });
+    for (auto iter = finished; iter != _tasks.end(); ++iter)
+    {
+        delete *iter;
+    }
+    _tasks.erase(finished, _tasks.end());
+
+    _updating = false;
+
+    // the tasks added by the steps and the callbacks
+    auto added = std::move(_addedTasks);
+    _addedTasks.clear();
+    for (auto task : added)
+    {
+        if (task->finished)
+        {
+            delete task;
+            continue;
+        }
+        auto position = std::upper_bound(_tasks.begin(), _tasks.end(), task, [](const Task* a, const Task* b) {
+            return a->priority < b->priority;
+        });
+        _tasks.insert(position, task);
+    }
+
+    if (_tasks.empty())
+    {
+        Director::getInstance()->getScheduler()->unschedule(TIME_SLICED_QUEUE_KEY, this);
+        _scheduled = false;
+    }
+}
+
+NS_CC_END
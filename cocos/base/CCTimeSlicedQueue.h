@@ -0,0 +1,187 @@
+/****************************************************************************
+Copyright (c) 2017 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#ifndef __CCTIME_SLICED_QUEUE_H__
+#define __CCTIME_SLICED_QUEUE_H__
+
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "base/CCAsyncTaskPool.h"
+
+/**
+ * @addtogroup base
+ * @{
+ */
+NS_CC_BEGIN
+
+/**
+ * @class TimeSlicedQueue
+ * @brief Runs long tasks on the cocos thread a slice at a time, within a time budget per frame.
+ *
+ * A task is a function called repeatedly until it returns true, e.g. creating the nodes of a scene a
+ * few at a time, or a list of steps called one after the other. Every frame the ready tasks are
+ * called, lowest priority first, until the frame budget is spent; a task can also have its own budget.
+ * At least one step runs each frame, so a step longer than the budget still makes progress.
+ *
+ * A task can wait for JobSystem jobs or for textures loaded by TextureCache::addImageAsync() before it
+ * starts, so the work off the cocos thread is done first. CSLoader::createNodeAsync() creates its nodes
+ * with a task.
+ *
+ * All the methods must be called on the cocos thread.
+ * @since v3.14
+ * @js NA
+ * @lua NA
+ */
+class CC_DLL TimeSlicedQueue
+{
+public:
+    /** Identifies a task, 0 is never used. */
+    typedef unsigned int TaskId;
+
+    /**
+     * A slice of a task. Returns true once the task is done.
+     * @param progress Can be set to the progress of the task, from 0 to 1.
+     */
+    typedef std::function<bool(float& progress)> Step;
+
+    /** Called once per task, with true when it's done and false when it was cancelled. */
+    typedef std::function<void(bool done)> CompletionCallback;
+
+    /** Called when the progress of a task changes. */
+    typedef std::function<void(float progress)> ProgressCallback;
+
+    /** Returns the shared queue, it runs its tasks from the scheduler of the Director. */
+    static TimeSlicedQueue* getInstance();
+
+    /** Cancels the tasks and destroys the shared queue. */
+    static void destroyInstance();
+
+    /**
+     * Sets the time the tasks may use per frame, 0.004 seconds by default.
+     * @param seconds The budget in seconds, 0 runs a single step per frame.
+     */
+    void setFrameBudget(float seconds) { _frameBudget = seconds; }
+    float getFrameBudget() const { return _frameBudget; }
+
+    /**
+     * Adds a task, its first slice runs in the next frame.
+     *
+     * @param step Called until it returns true.
+     * @param priority The tasks with a lower priority run first, the ones with the same priority in the order they were added.
+     * @param completion Called when the task is done or cancelled, can be nullptr.
+     * @return The id of the task.
+     */
+    TaskId addTask(const Step& step, int priority = 0, const CompletionCallback& completion = nullptr);
+
+    /**
+     * Adds a task calling the functions one after the other, its progress is the share of the functions called.
+     * @see TimeSlicedQueue::addTask()
+     */
+    TaskId addTask(const std::vector<std::function<void()>>& steps, int priority = 0, const CompletionCallback& completion = nullptr);
+
+    /** Sets the function called when the progress of a task changes. */
+    void setProgressCallback(TaskId task, const ProgressCallback& callback);
+
+    /**
+     * Limits the time a task may use per frame, within the frame budget.
+     * @param seconds The budget of the task in seconds, 0 for the frame budget only.
+     */
+    void setTaskBudget(TaskId task, float seconds);
+
+    /** The task doesn't run before the job has run. */
+    void waitForJob(TaskId task, const JobSystem::JobHandle& job);
+
+    /**
+     * Loads a texture with TextureCache::addImageAsync(), the task doesn't run before it's loaded.
+     * The load is cancelled with the task.
+     */
+    void waitForTexture(TaskId task, const std::string& filepath);
+
+    /**
+     * Cancels a task, its completion callback is called with false.
+     * A task can cancel itself from its step.
+     */
+    void cancel(TaskId task);
+
+    /** Cancels all the tasks. */
+    void cancelAll();
+
+    /** Returns whether the task is waiting or running. */
+    bool isPending(TaskId task) const;
+
+    /** Returns the progress of a task from 0 to 1, 1 once it's done or cancelled. */
+    float getProgress(TaskId task) const;
+
+    /** The number of tasks waiting or running. */
+    ssize_t getTaskCount() const { return (ssize_t)_tasksById.size(); }
+
+CC_CONSTRUCTOR_ACCESS:
+    TimeSlicedQueue();
+    ~TimeSlicedQueue();
+
+protected:
+    struct Task
+    {
+        TaskId id;
+        int priority;
+        Step step;
+        CompletionCallback completion;
+        ProgressCallback progressCallback;
+        float progress;
+        float budget;
+        std::vector<JobSystem::JobHandle> jobs;
+        std::vector<std::string> textureKeys;
+        int pendingTextures;
+        /** done or cancelled, the task is deleted by the next update */
+        bool finished;
+    };
+
+    TaskId insertTask(Task* task);
+    Task* findTask(TaskId id) const;
+    bool isReady(Task* task);
+    void finishTask(Task* task, bool done);
+    void update(float dt);
+    void scheduleUpdate();
+
+    // sorted by priority, then by id; the tasks added while updating wait in _addedTasks
+    std::vector<Task*> _tasks;
+    std::vector<Task*> _addedTasks;
+    std::unordered_map<TaskId, Task*> _tasksById;
+    TaskId _nextId;
+    float _frameBudget;
+    bool _updating;
+    bool _scheduled;
+
+    static TimeSlicedQueue* s_timeSlicedQueue;
+};
+
+NS_CC_END
+/**
+ * @}
+ */
+
+#endif // __CCTIME_SLICED_QUEUE_H__
@@ -70,6 +70,34 @@ Vec2 Touch::getDelta() const
     return getLocation() - getPreviousLocation();
 }
 
+void Touch::addSample(int id, float x, float y, float force, float maxForce, double timestamp)
+{
+    if (_history.empty())
+    {
+        setTouchInfo(id, x, y, force, maxForce);
+    }
+    else
+    {
+        // coalesced with the samples not dispatched yet, the previous location doesn't change
+        _point.x = x;
+        _point.y = y;
+        _curForce = force;
+        _maxForce = maxForce;
+    }
+
+    Sample sample;
+    sample.locationInView = _point;
+    sample.force = force;
+    sample.timestamp = timestamp;
+    _history.push_back(sample);
+}
+
+Vec2 Touch::getHistoricalLocation(ssize_t index) const
+{
+    CCASSERT(index >= 0 && index < (ssize_t)_history.size(), "Touch: invalid history index");
+    return Director::getInstance()->convertToGL(_history[index].locationInView);
+}
+
 // Returns the current touch force for 3d touch.
 float Touch::getCurrentForce() const
 {
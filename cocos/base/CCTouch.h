@@ -26,6 +26,8 @@ THE SOFTWARE.
 #ifndef __CC_TOUCH_H__
 #define __CC_TOUCH_H__
 
+#include <vector>
+
 #include "base/CCRef.h"
 #include "math/CCGeometry.h"
 
@@ -52,6 +54,20 @@ public:
         ONE_BY_ONE,  /** One by one. */
     };
 
+    /** A location of the touch reported by the platform.
+     * @since v3.14
+     * @js NA
+     * @lua NA
+     */
+    struct Sample
+    {
+        /** The location in screen coordinates. */
+        Vec2 locationInView;
+        float force;
+        /** In seconds, only the differences between the timestamps are meaningful. */
+        double timestamp;
+    };
+
     /** Constructor.
      * @js ctor
      */
@@ -143,6 +159,35 @@ public:
             _prevPoint = _point;
         }
     }
+
+    /** Sets the touch information and adds a sample to its history. The samples added before the
+     * history is cleared are coalesced: the previous location stays the one before the first sample.
+     *
+     * @param timestamp The time of the sample in seconds.
+     * @since v3.14
+     */
+    void addSample(int id, float x, float y, float force, float maxForce, double timestamp);
+
+    /** Returns the locations reported since the previous event of the touch, the oldest first, the last
+     * one being the current location. An EventTouch::MOVED carries several samples when
+     * GLView::setTouchMovesCoalesced() is enabled, e.g. for the high rate touch panels.
+     * It's only valid while the event is dispatched.
+     * @since v3.14
+     * @js NA
+     * @lua NA
+     */
+    const std::vector<Sample>& getHistory() const { return _history; }
+
+    /** Returns the location of a sample of the history in OpenGL coordinates.
+     * @since v3.14
+     */
+    Vec2 getHistoricalLocation(ssize_t index) const;
+
+    /** Clears the history once the event of the touch was dispatched.
+     * @since v3.14
+     */
+    void clearHistory() { _history.clear(); }
+
     /** Get touch id.
      * @js getId
      * @lua getId
@@ -172,6 +217,7 @@ private:
     Vec2 _prevPoint;
     float _curForce;
     float _maxForce;
+    std::vector<Sample> _history;
 };
 
 // end of base group
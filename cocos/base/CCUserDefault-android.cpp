@@ -144,6 +144,7 @@ UserDefault::~UserDefault()
 }
 
 UserDefault::UserDefault()
+: _batchDepth(0)
 {
 }
 
@@ -521,6 +522,20 @@ void UserDefault::flush()
 {
 }
 
+void UserDefault::beginBatch()
+{
+    ++_batchDepth;
+}
+
+void UserDefault::commit(bool /*async*/)
+{
+    CCASSERT(_batchDepth > 0, "commit() without beginBatch()");
+    if (_batchDepth > 0 && --_batchDepth == 0)
+    {
+        flush();
+    }
+}
+
 void UserDefault::deleteValueForKey(const char* key)
 {
     // check the params
@@ -143,6 +143,7 @@ UserDefault::~UserDefault()
 }
 
 UserDefault::UserDefault()
+: _batchDepth(0)
 {
 }
 
@@ -542,6 +543,20 @@ void UserDefault::flush()
     [[NSUserDefaults standardUserDefaults] synchronize];
 }
 
+void UserDefault::beginBatch()
+{
+    ++_batchDepth;
+}
+
+void UserDefault::commit(bool /*async*/)
+{
+    CCASSERT(_batchDepth > 0, "commit() without beginBatch()");
+    if (_batchDepth > 0 && --_batchDepth == 0)
+    {
+        flush();
+    }
+}
+
 void UserDefault::deleteValueForKey(const char* key)
 {
     // check the params
@@ -552,7 +567,11 @@ void UserDefault::deleteValueForKey(const char* key)
 
     [[NSUserDefaults standardUserDefaults] removeObjectForKey:[NSString stringWithUTF8String:key]];
 
-    flush();
+    // synchronized once by commit()
+    if (!isInBatch())
+    {
+        flush();
+    }
 }
 
 NS_CC_END
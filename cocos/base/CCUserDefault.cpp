@@ -28,6 +28,11 @@ THE SOFTWARE.
 #include "tinyxml2.h"
 #include "base/base64.h"
 #include "base/ccUtils.h"
+#include "base/CCAsyncTaskPool.h"
+#include <atomic>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
 
 #if (CC_TARGET_PLATFORM != CC_PLATFORM_IOS && CC_TARGET_PLATFORM != CC_PLATFORM_MAC && CC_TARGET_PLATFORM != CC_PLATFORM_ANDROID)
 
@@ -45,95 +50,156 @@ NS_CC_BEGIN
  * export xmlNodePtr and other types in "CCUserDefault.h"
  */
 
-static tinyxml2::XMLElement* getXMLNodeForKey(const char* pKey, tinyxml2::XMLElement** rootNode, tinyxml2::XMLDocument **doc)
+namespace {
+
+    // the values of the xml file, parsed once and written back as a whole
+    struct UserDefaultStore
+    {
+        // in the order of the xml file
+        std::vector<std::pair<std::string, std::string>> entries;
+        std::unordered_map<std::string, size_t> indices;
+        bool loaded = false;
+        bool dirty = false;
+    };
+
+    UserDefaultStore s_store;
+
+    // serializes the writes of the xml file, a write is skipped when a newer one has been issued
+    std::mutex s_writeMutex;
+    std::atomic<unsigned int> s_writeGeneration(0);
+    std::atomic<unsigned int> s_writtenGeneration(0);
+}
+
+static UserDefaultStore& getStore()
 {
-    tinyxml2::XMLElement* curNode = nullptr;
+    if (s_store.loaded)
+    {
+        return s_store;
+    }
+    s_store.loaded = true;
+
+    std::string xmlBuffer = FileUtils::getInstance()->getStringFromFile(UserDefault::getXMLFilePath());
+    if (xmlBuffer.empty())
+    {
+        CCLOG("can not read xml file");
+        return s_store;
+    }
+
+    tinyxml2::XMLDocument xmlDoc;
+    xmlDoc.Parse(xmlBuffer.c_str(), xmlBuffer.size());
+
+    // get root node
+    tinyxml2::XMLElement* rootNode = xmlDoc.RootElement();
+    if (nullptr == rootNode)
+    {
+        CCLOG("read root node error");
+        return s_store;
+    }
+
+    for (tinyxml2::XMLElement* node = rootNode->FirstChildElement(); node; node = node->NextSiblingElement())
+    {
+        // the first node of a key wins, as it did when the file was searched on every access
+        const char* key = node->Value();
+        if (s_store.indices.find(key) != s_store.indices.end())
+        {
+            continue;
+        }
+        const char* value = node->FirstChild() ? node->FirstChild()->Value() : "";
+        s_store.indices.emplace(key, s_store.entries.size());
+        s_store.entries.emplace_back(key, value);
+    }
+
+    return s_store;
+}
 
-    // check the key value
+// returns nullptr if the key doesn't exist, empty values are read back as missing from the xml file
+static const char* getValueForKey(const char* pKey)
+{
     if (! pKey)
     {
         return nullptr;
     }
 
-    do 
+    auto& store = getStore();
+    auto iter = store.indices.find(pKey);
+    if (iter == store.indices.end() || store.entries[iter->second].second.empty())
     {
-         tinyxml2::XMLDocument* xmlDoc = new (std::nothrow) tinyxml2::XMLDocument();
-        *doc = xmlDoc;
+        return nullptr;
+    }
+    return store.entries[iter->second].second.c_str();
+}
 
-        std::string xmlBuffer = FileUtils::getInstance()->getStringFromFile(UserDefault::getInstance()->getXMLFilePath());
+static void writeXMLFile(const std::string& content, const std::string& filePath, unsigned int generation)
+{
+    std::lock_guard<std::mutex> lock(s_writeMutex);
+    if (generation != s_writeGeneration)
+    {
+        return;
+    }
 
-        if (xmlBuffer.empty())
-        {
-            CCLOG("can not read xml file");
-            break;
-        }
-        xmlDoc->Parse(xmlBuffer.c_str(), xmlBuffer.size());
+    if (! FileUtils::getInstance()->writeStringToFile(content, filePath))
+    {
+        CCLOG("can not write xml file");
+    }
+    s_writtenGeneration = generation;
+}
 
-        // get root node
-        *rootNode = xmlDoc->RootElement();
-        if (nullptr == *rootNode)
-        {
-            CCLOG("read root node error");
-            break;
-        }
-        // find the node
-        curNode = (*rootNode)->FirstChildElement();
-        while (nullptr != curNode)
-        {
-            const char* nodeName = curNode->Value();
-            if (!strcmp(nodeName, pKey))
-            {
-                break;
-            }
+static void saveStore(bool async)
+{
+    auto& store = getStore();
+    store.dirty = false;
 
-            curNode = curNode->NextSiblingElement();
-        }
-    } while (0);
+    tinyxml2::XMLDocument doc;
+    doc.LinkEndChild(doc.NewDeclaration(nullptr));
+    tinyxml2::XMLElement* rootNode = doc.NewElement(USERDEFAULT_ROOT_NAME);
+    doc.LinkEndChild(rootNode);
+    for (const auto& entry : store.entries)
+    {
+        tinyxml2::XMLElement* node = doc.NewElement(entry.first.c_str());
+        node->LinkEndChild(doc.NewText(entry.second.c_str()));
+        rootNode->LinkEndChild(node);
+    }
 
-    return curNode;
+    tinyxml2::XMLPrinter printer;
+    doc.Print(&printer);
+    std::string content(printer.CStr(), printer.CStrSize() - 1);
+
+    unsigned int generation = ++s_writeGeneration;
+    if (async)
+    {
+        AsyncTaskPool::getInstance()->enqueue(AsyncTaskPool::TaskType::TASK_IO,
+            std::bind(writeXMLFile, std::move(content), UserDefault::getXMLFilePath(), generation));
+    }
+    else
+    {
+        writeXMLFile(content, UserDefault::getXMLFilePath(), generation);
+    }
 }
 
-static void setValueForKey(const char* pKey, const char* pValue)
+static void setValueForKey(const char* pKey, const char* pValue, bool deferred)
 {
-     tinyxml2::XMLElement* rootNode;
-    tinyxml2::XMLDocument* doc;
-    tinyxml2::XMLElement* node;
     // check the params
     if (! pKey || ! pValue)
     {
         return;
     }
-    // find the node
-    node = getXMLNodeForKey(pKey, &rootNode, &doc);
-    // if node exist, change the content
-    if (node)
+
+    auto& store = getStore();
+    auto iter = store.indices.find(pKey);
+    if (iter != store.indices.end())
     {
-        if (node->FirstChild())
-        {
-            node->FirstChild()->SetValue(pValue);
-        }
-        else
-        {
-            tinyxml2::XMLText* content = doc->NewText(pValue);
-            node->LinkEndChild(content);
-        }
+        store.entries[iter->second].second = pValue;
     }
     else
     {
-        if (rootNode)
-        {
-            tinyxml2::XMLElement* tmpNode = doc->NewElement(pKey);//new tinyxml2::XMLElement(pKey);
-            rootNode->LinkEndChild(tmpNode);
-            tinyxml2::XMLText* content = doc->NewText(pValue);//new tinyxml2::XMLText(pValue);
-            tmpNode->LinkEndChild(content);
-        }    
+        store.indices.emplace(pKey, store.entries.size());
+        store.entries.emplace_back(pKey, pValue);
     }
+    store.dirty = true;
 
-    // save file and free doc
-    if (doc)
+    if (! deferred)
     {
-        doc->SaveFile(FileUtils::getInstance()->getSuitableFOpen(UserDefault::getInstance()->getXMLFilePath()).c_str());
-        delete doc;
+        saveStore(false);
     }
 }
 
@@ -147,9 +213,11 @@ bool UserDefault::_isFilePathInitialized = false;
 
 UserDefault::~UserDefault()
 {
+    flush();
 }
 
 UserDefault::UserDefault()
+: _batchDepth(0)
 {
 }
 
@@ -160,16 +228,7 @@ bool UserDefault::getBoolForKey(const char* pKey)
 
 bool UserDefault::getBoolForKey(const char* pKey, bool defaultValue)
 {
-    const char* value = nullptr;
-    tinyxml2::XMLElement* rootNode;
-    tinyxml2::XMLDocument* doc;
-    tinyxml2::XMLElement* node;
-    node =  getXMLNodeForKey(pKey, &rootNode, &doc);
-    // find the node
-    if (node && node->FirstChild())
-    {
-        value = (const char*)(node->FirstChild()->Value());
-    }
+    const char* value = getValueForKey(pKey);
 
     bool ret = defaultValue;
 
@@ -178,7 +237,6 @@ bool UserDefault::getBoolForKey(const char* pKey, bool defaultValue)
         ret = (! strcmp(value, "true"));
     }
 
-    if (doc) delete doc;
 
     return ret;
 }
@@ -190,16 +248,7 @@ int UserDefault::getIntegerForKey(const char* pKey)
 
 int UserDefault::getIntegerForKey(const char* pKey, int defaultValue)
 {
-    const char* value = nullptr;
-    tinyxml2::XMLElement* rootNode;
-    tinyxml2::XMLDocument* doc;
-    tinyxml2::XMLElement* node;
-    node =  getXMLNodeForKey(pKey, &rootNode, &doc);
-    // find the node
-    if (node && node->FirstChild())
-    {
-        value = (const char*)(node->FirstChild()->Value());
-    }
+    const char* value = getValueForKey(pKey);
 
     int ret = defaultValue;
 
@@ -208,11 +257,6 @@ int UserDefault::getIntegerForKey(const char* pKey, int defaultValue)
         ret = atoi(value);
     }
 
-    if(doc)
-    {
-        delete doc;
-    }
-
 
     return ret;
 }
@@ -236,16 +280,7 @@ double  UserDefault::getDoubleForKey(const char* pKey)
 
 double UserDefault::getDoubleForKey(const char* pKey, double defaultValue)
 {
-    const char* value = nullptr;
-    tinyxml2::XMLElement* rootNode;
-    tinyxml2::XMLDocument* doc;
-    tinyxml2::XMLElement* node;
-    node =  getXMLNodeForKey(pKey, &rootNode, &doc);
-    // find the node
-    if (node && node->FirstChild())
-    {
-        value = (const char*)(node->FirstChild()->Value());
-    }
+    const char* value = getValueForKey(pKey);
 
     double ret = defaultValue;
 
@@ -254,7 +289,6 @@ double UserDefault::getDoubleForKey(const char* pKey, double defaultValue)
         ret = utils::atof(value);
     }
 
-    if (doc) delete doc;
 
     return ret;
 }
@@ -266,16 +300,7 @@ std::string UserDefault::getStringForKey(const char* pKey)
 
 string UserDefault::getStringForKey(const char* pKey, const std::string & defaultValue)
 {
-    const char* value = nullptr;
-    tinyxml2::XMLElement* rootNode;
-    tinyxml2::XMLDocument* doc;
-    tinyxml2::XMLElement* node;
-    node =  getXMLNodeForKey(pKey, &rootNode, &doc);
-    // find the node
-    if (node && node->FirstChild())
-    {
-        value = (const char*)(node->FirstChild()->Value());
-    }
+    const char* value = getValueForKey(pKey);
 
     string ret = defaultValue;
 
@@ -284,7 +309,6 @@ string UserDefault::getStringForKey(const char* pKey, const std::string & defaul
         ret = string(value);
     }
 
-    if (doc) delete doc;
 
     return ret;
 }
@@ -296,16 +320,7 @@ Data UserDefault::getDataForKey(const char* pKey)
 
 Data UserDefault::getDataForKey(const char* pKey, const Data& defaultValue)
 {
-    const char* encodedData = nullptr;
-    tinyxml2::XMLElement* rootNode;
-    tinyxml2::XMLDocument* doc;
-    tinyxml2::XMLElement* node;
-    node =  getXMLNodeForKey(pKey, &rootNode, &doc);
-    // find the node
-    if (node && node->FirstChild())
-    {
-        encodedData = (const char*)(node->FirstChild()->Value());
-    }
+    const char* encodedData = getValueForKey(pKey);
     
     Data ret = defaultValue;
     
@@ -319,7 +334,6 @@ Data UserDefault::getDataForKey(const char* pKey, const Data& defaultValue)
         }
     }
     
-    if (doc) delete doc;
     
     return ret;    
 }
@@ -352,7 +366,7 @@ void UserDefault::setIntegerForKey(const char* pKey, int value)
     memset(tmp, 0, 50);
     sprintf(tmp, "%d", value);
 
-    setValueForKey(pKey, tmp);
+    setValueForKey(pKey, tmp, isInBatch());
 }
 
 void UserDefault::setFloatForKey(const char* pKey, float value)
@@ -373,7 +387,7 @@ void UserDefault::setDoubleForKey(const char* pKey, double value)
     memset(tmp, 0, 50);
     sprintf(tmp, "%f", value);
 
-    setValueForKey(pKey, tmp);
+    setValueForKey(pKey, tmp, isInBatch());
 }
 
 void UserDefault::setStringForKey(const char* pKey, const std::string & value)
@@ -384,7 +398,7 @@ void UserDefault::setStringForKey(const char* pKey, const std::string & value)
         return;
     }
 
-    setValueForKey(pKey, value.c_str());
+    setValueForKey(pKey, value.c_str(), isInBatch());
 }
 
 void UserDefault::setDataForKey(const char* pKey, const Data& value) {
@@ -398,7 +412,7 @@ void UserDefault::setDataForKey(const char* pKey, const Data& value) {
     
     base64Encode(value.getBytes(), static_cast<unsigned int>(value.getSize()), &encodedData);
         
-    setValueForKey(pKey, encodedData);
+    setValueForKey(pKey, encodedData, isInBatch());
     
     if (encodedData)
         free(encodedData);
@@ -501,14 +515,29 @@ const string& UserDefault::getXMLFilePath()
 
 void UserDefault::flush()
 {
+    // write the pending values, or the values of an asynchronous commit that may not be written yet
+    if (s_store.dirty || s_writtenGeneration != s_writeGeneration)
+    {
+        saveStore(false);
+    }
 }
 
-void UserDefault::deleteValueForKey(const char* key)
+void UserDefault::beginBatch()
 {
-    tinyxml2::XMLElement* rootNode;
-    tinyxml2::XMLDocument* doc;
-    tinyxml2::XMLElement* node;
+    ++_batchDepth;
+}
 
+void UserDefault::commit(bool async)
+{
+    CCASSERT(_batchDepth > 0, "commit() without beginBatch()");
+    if (_batchDepth > 0 && --_batchDepth == 0 && s_store.dirty)
+    {
+        saveStore(async);
+    }
+}
+
+void UserDefault::deleteValueForKey(const char* key)
+{
     // check the params
     if (!key)
     {
@@ -516,25 +545,31 @@ void UserDefault::deleteValueForKey(const char* key)
         return;
     }
 
-    // find the node
-    node = getXMLNodeForKey(key, &rootNode, &doc);
+    auto& store = getStore();
+    auto iter = store.indices.find(key);
 
     // if node not exist, don't need to delete
-    if (!node)
+    if (iter == store.indices.end())
     {
-        CC_SAFE_DELETE(doc);
         return;
     }
 
-    // save file and free doc
-    if (doc)
+    size_t index = iter->second;
+    store.indices.erase(iter);
+    store.entries.erase(store.entries.begin() + index);
+    for (auto& entry : store.indices)
     {
-        doc->DeleteNode(node);
-        doc->SaveFile(FileUtils::getInstance()->getSuitableFOpen(UserDefault::getInstance()->getXMLFilePath()).c_str());
-        delete doc;
+        if (entry.second > index)
+        {
+            --entry.second;
+        }
     }
+    store.dirty = true;
 
-    flush();
+    if (!isInBatch())
+    {
+        saveStore(false);
+    }
 }
 
 NS_CC_END
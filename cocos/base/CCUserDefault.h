@@ -201,10 +201,35 @@ public:
     virtual void setDataForKey(const char* key, const Data& value);
     /**
      * You should invoke this function to save values set by setXXXForKey().
+     * It also writes the values of a batch in progress, and waits for the values committed asynchronously.
      * @js NA
      */
     virtual void flush();
 
+    /**
+     * Starts a batch of writes. The values set until the matching commit() are only kept in memory,
+     * so the backing store is written once instead of once per setXXXForKey() call.
+     * Batches can be nested, only the outermost commit() writes.
+     * @since v3.14
+     * @js NA
+     */
+    virtual void beginBatch();
+
+    /**
+     * Ends a batch started by beginBatch(), and writes the values set during the batch.
+     * @param async If true, the xml file is written on a worker thread, flush() waits for it.
+     * @since v3.14
+     * @js NA
+     */
+    virtual void commit(bool async = false);
+
+    /**
+     * Whether a batch started by beginBatch() is in progress.
+     * @since v3.14
+     * @js NA
+     */
+    bool isInBatch() const { return _batchDepth > 0; }
+
     /**
     * delete any value by key,
     * @param key The key to delete value.
@@ -256,6 +281,8 @@ public:
 protected:
     UserDefault();
     virtual ~UserDefault();
+
+    int _batchDepth;
     
 private:
     
@@ -79,20 +79,21 @@ Value::Value(bool v)
 }
 
 Value::Value(const char* v)
-: _type(Type::STRING)
+: _type(Type::NONE)
 {
-    _field.strVal = new (std::nothrow) std::string();
-    if (v)
-    {
-        *_field.strVal = v;
-    }
+    setString(v ? v : "", v ? strlen(v) : 0);
 }
 
 Value::Value(const std::string& v)
-: _type(Type::STRING)
+: _type(Type::NONE)
 {
-    _field.strVal = new (std::nothrow) std::string();
-    *_field.strVal = v;
+    setString(v.data(), v.size());
+}
+
+Value::Value(std::string&& v)
+: _type(Type::NONE)
+{
+    setString(std::move(v));
 }
 
 Value::Value(const ValueVector& v)
@@ -179,11 +180,7 @@ Value& Value::operator= (const Value& other)
                 _field.boolVal = other._field.boolVal;
                 break;
             case Type::STRING:
-                if (_field.strVal == nullptr)
-                {
-                    _field.strVal = new std::string();
-                }
-                *_field.strVal = *other._field.strVal;
+                setString(other.stringData(), other.stringLength());
                 break;
             case Type::VECTOR:
                 if (_field.vectorVal == nullptr)
@@ -239,7 +236,8 @@ Value& Value::operator= (Value&& other)
                 _field.boolVal = other._field.boolVal;
                 break;
             case Type::STRING:
-                _field.strVal = other._field.strVal;
+                memcpy(&_field, &other._field, sizeof(_field));
+                _smallStringLength = other._smallStringLength;
                 break;
             case Type::VECTOR:
                 _field.vectorVal = other._field.vectorVal;
@@ -306,15 +304,19 @@ Value& Value::operator= (bool v)
 
 Value& Value::operator= (const char* v)
 {
-    reset(Type::STRING);
-    *_field.strVal = v ? v : "";
+    setString(v ? v : "", v ? strlen(v) : 0);
     return *this;
 }
 
 Value& Value::operator= (const std::string& v)
 {
-    reset(Type::STRING);
-    *_field.strVal = v;
+    setString(v.data(), v.size());
+    return *this;
+}
+
+Value& Value::operator= (std::string&& v)
+{
+    setString(std::move(v));
     return *this;
 }
 
@@ -385,7 +387,7 @@ bool Value::operator== (const Value& v) const
         case Type::INTEGER: return v._field.intVal      == this->_field.intVal;
         case Type::UNSIGNED:return v._field.unsignedVal == this->_field.unsignedVal;
         case Type::BOOLEAN: return v._field.boolVal     == this->_field.boolVal;
-        case Type::STRING:  return *v._field.strVal     == *this->_field.strVal;
+        case Type::STRING:  return v.stringLength() == this->stringLength() && memcmp(v.stringData(), this->stringData(), this->stringLength()) == 0;
         case Type::FLOAT:   return std::abs(v._field.floatVal  - this->_field.floatVal)  <= FLT_EPSILON;
         case Type::DOUBLE:  return std::abs(v._field.doubleVal - this->_field.doubleVal) <= DBL_EPSILON;
         case Type::VECTOR:
@@ -460,7 +462,7 @@ unsigned char Value::asByte() const
 
     if (_type == Type::STRING)
     {
-        return static_cast<unsigned char>(atoi(_field.strVal->c_str()));
+        return static_cast<unsigned char>(atoi(stringData()));
     }
 
     if (_type == Type::FLOAT)
@@ -502,7 +504,7 @@ int Value::asInt() const
 
     if (_type == Type::STRING)
     {
-        return atoi(_field.strVal->c_str());
+        return atoi(stringData());
     }
 
     if (_type == Type::FLOAT)
@@ -546,7 +548,7 @@ unsigned int Value::asUnsignedInt() const
     if (_type == Type::STRING)
     {
         // NOTE: strtoul is required (need to augment on unsupported platforms)
-        return static_cast<unsigned int>(strtoul(_field.strVal->c_str(), nullptr, 10));
+        return static_cast<unsigned int>(strtoul(stringData(), nullptr, 10));
     }
 
     if (_type == Type::FLOAT)
@@ -582,7 +584,7 @@ float Value::asFloat() const
 
     if (_type == Type::STRING)
     {
-        return utils::atof(_field.strVal->c_str());
+        return utils::atof(stringData());
     }
 
     if (_type == Type::INTEGER)
@@ -623,7 +625,7 @@ double Value::asDouble() const
 
     if (_type == Type::STRING)
     {
-        return static_cast<double>(utils::atof(_field.strVal->c_str()));
+        return static_cast<double>(utils::atof(stringData()));
     }
 
     if (_type == Type::INTEGER)
@@ -664,7 +666,7 @@ bool Value::asBool() const
 
     if (_type == Type::STRING)
     {
-        return (*_field.strVal == "0" || *_field.strVal == "false") ? false : true;
+        return (strcmp(stringData(), "0") == 0 || strcmp(stringData(), "false") == 0) ? false : true;
     }
 
     if (_type == Type::INTEGER)
@@ -696,7 +698,7 @@ std::string Value::asString() const
 
     if (_type == Type::STRING)
     {
-        return *_field.strVal;
+        return std::string(stringData(), stringLength());
     }
 
     std::stringstream ret;
@@ -883,7 +885,10 @@ void Value::clear()
             _field.boolVal = false;
             break;
         case Type::STRING:
-            CC_SAFE_DELETE(_field.strVal);
+            if (_smallStringLength == HEAP_STRING)
+            {
+                CC_SAFE_DELETE(_field.strVal);
+            }
             break;
         case Type::VECTOR:
             CC_SAFE_DELETE(_field.vectorVal);
@@ -912,7 +917,8 @@ void Value::reset(Type type)
     switch (type)
     {
         case Type::STRING:
-            _field.strVal = new (std::nothrow) std::string();
+            _field.smallStrVal[0] = '\0';
+            _smallStringLength = 0;
             break;
         case Type::VECTOR:
             _field.vectorVal = new (std::nothrow) ValueVector();
@@ -930,4 +936,56 @@ void Value::reset(Type type)
     _type = type;
 }
 
+void Value::setString(const char* v, size_t length)
+{
+    if (length < sizeof(_field.smallStrVal))
+    {
+        clear();
+        memcpy(_field.smallStrVal, v, length);
+        _field.smallStrVal[length] = '\0';
+        _smallStringLength = static_cast<unsigned char>(length);
+    }
+    else if (_type == Type::STRING && _smallStringLength == HEAP_STRING)
+    {
+        // reuse the buffer of the current string
+        _field.strVal->assign(v, length);
+    }
+    else
+    {
+        clear();
+        _field.strVal = new (std::nothrow) std::string(v, length);
+        _smallStringLength = HEAP_STRING;
+    }
+    _type = Type::STRING;
+}
+
+void Value::setString(std::string&& v)
+{
+    if (v.size() < sizeof(_field.smallStrVal))
+    {
+        setString(v.data(), v.size());
+    }
+    else if (_type == Type::STRING && _smallStringLength == HEAP_STRING)
+    {
+        *_field.strVal = std::move(v);
+    }
+    else
+    {
+        clear();
+        _field.strVal = new (std::nothrow) std::string(std::move(v));
+        _smallStringLength = HEAP_STRING;
+        _type = Type::STRING;
+    }
+}
+
+const char* Value::stringData() const
+{
+    return _smallStringLength == HEAP_STRING ? _field.strVal->c_str() : _field.smallStrVal;
+}
+
+size_t Value::stringLength() const
+{
+    return _smallStringLength == HEAP_STRING ? _field.strVal->size() : _smallStringLength;
+}
+
 NS_CC_END
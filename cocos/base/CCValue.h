@@ -83,6 +83,8 @@ public:
     
     /** Create a Value by a string. */
     explicit Value(const std::string& v);
+    /** Create a Value by a string. It will use std::move internally. */
+    explicit Value(std::string&& v);
     
     /** Create a Value by a ValueVector object. */
     explicit Value(const ValueVector& v);
@@ -128,6 +130,8 @@ public:
     Value& operator= (const char* v);
     /** Assignment operator, assign from string to Value. */
     Value& operator= (const std::string& v);
+    /** Assignment operator, assign from string to Value. It will use std::move internally. */
+    Value& operator= (std::string&& v);
 
     /** Assignment operator, assign from ValueVector to Value. */
     Value& operator= (const ValueVector& v);
@@ -225,6 +229,13 @@ public:
 private:
     void clear();
     void reset(Type type);
+    void setString(const char* v, size_t length);
+    void setString(std::string&& v);
+    const char* stringData() const;
+    size_t stringLength() const;
+
+    // strings shorter than smallStrVal are stored in place instead of in a new std::string
+    static const unsigned char HEAP_STRING = 0xff;
 
     union
     {
@@ -236,12 +247,15 @@ private:
         bool boolVal;
 
         std::string* strVal;
+        char smallStrVal[16];
         ValueVector* vectorVal;
         ValueMap* mapVal;
         ValueMapIntKey* intKeyMapVal;
     }_field;
 
     Type _type;
+    // length of a string stored in smallStrVal, HEAP_STRING when it is in strVal
+    unsigned char _smallStringLength;
 };
 
 /** @} */
@@ -37,9 +37,18 @@
 #include <stdlib.h>
 
 #include "base/CCData.h"
+#include "base/ccConfig.h"
 #include "base/ccMacros.h"
 #include "platform/CCFileUtils.h"
+#include "xxhash.h"
 #include <map>
+#include <mutex>
+#include <algorithm>
+#include <vector>
+
+#if CC_USE_LZ4
+#include "lz4.h"
+#endif // CC_USE_LZ4
 
 // FIXME: Other platforms should use upstream minizip like mingw-w64  
 #ifdef MINIZIP_FROM_SYSTEM
@@ -53,6 +62,9 @@ unsigned int ZipUtils::s_uEncryptedPvrKeyParts[4] = {0,0,0,0};
 unsigned int ZipUtils::s_uEncryptionKey[1024];
 bool ZipUtils::s_bEncryptionKeyIsValid = false;
 
+// the long key is created in place, CCZ files may be decoded on several threads
+static std::mutex s_encryptionKeyMutex;
+
 // --------------------- ZipUtils ---------------------
 
 inline void ZipUtils::decodeEncodedPvr(unsigned int *data, ssize_t len)
@@ -68,9 +80,14 @@ inline void ZipUtils::decodeEncodedPvr(unsigned int *data, ssize_t len)
     CCASSERT(s_uEncryptedPvrKeyParts[2] != 0, "Cocos2D: CCZ file is encrypted but key part 2 is not set. Did you call ZipUtils::setPvrEncryptionKeyPart(...)?");
     CCASSERT(s_uEncryptedPvrKeyParts[3] != 0, "Cocos2D: CCZ file is encrypted but key part 3 is not set. Did you call ZipUtils::setPvrEncryptionKeyPart(...)?");
     
+    std::unique_lock<std::mutex> lock(s_encryptionKeyMutex);
+
     // create long key
     if(!s_bEncryptionKeyIsValid)
     {
+        // from scratch, the key of other parts mustn't leak into this one
+        memset(s_uEncryptionKey, 0, sizeof(s_uEncryptionKey));
+
         unsigned int y, p, e;
         unsigned int rounds = 6;
         unsigned int sum = 0;
@@ -97,6 +114,7 @@ inline void ZipUtils::decodeEncodedPvr(unsigned int *data, ssize_t len)
         
         s_bEncryptionKeyIsValid = true;
     }
+    lock.unlock();
     
     int b = 0;
     int i = 0;
@@ -143,22 +161,37 @@ inline unsigned int ZipUtils::checksumPvr(const unsigned int *data, ssize_t len)
 // Should buffer factor be 1.5 instead of 2 ?
 #define BUFFER_INC_FACTOR (2)
 
-int ZipUtils::inflateMemoryWithHint(unsigned char *in, ssize_t inLength, unsigned char **out, ssize_t *outLength, ssize_t outLengthHint)
+int ZipUtils::inflateMemoryWithHint(const unsigned char *in, ssize_t inLength, ResizableBuffer *out, ssize_t outLengthHint)
 {
     /* ret value */
     int err = Z_OK;
     
+    // the size of a gzip stream is stored modulo 2^32 in its last 4 bytes
     ssize_t bufferSize = outLengthHint;
-    *out = (unsigned char*)malloc(bufferSize);
+    if (isGZipBuffer(in, inLength) && inLength >= 18)
+    {
+        const unsigned char* size = in + inLength - 4;
+        ssize_t gzipSize = size[0] | (size[1] << 8) | (size[2] << 16) | ((ssize_t)size[3] << 24);
+        // deflate can't compress more than 1032:1, a bigger size is a corrupted trailer
+        if (gzipSize > 0 && gzipSize / 1032 <= inLength)
+        {
+            bufferSize = gzipSize;
+        }
+    }
+    out->resize(bufferSize);
+    if (out->buffer() == nullptr)
+    {
+        return Z_MEM_ERROR;
+    }
     
     z_stream d_stream; /* decompression stream */
     d_stream.zalloc = (alloc_func)0;
     d_stream.zfree = (free_func)0;
     d_stream.opaque = (voidpf)0;
     
-    d_stream.next_in  = in;
+    d_stream.next_in  = const_cast<Bytef*>(in);
     d_stream.avail_in = static_cast<unsigned int>(inLength);
-    d_stream.next_out = *out;
+    d_stream.next_out = static_cast<Bytef*>(out->buffer());
     d_stream.avail_out = static_cast<unsigned int>(bufferSize);
     
     /* window size to hold 256k */
@@ -174,46 +207,51 @@ int ZipUtils::inflateMemoryWithHint(unsigned char *in, ssize_t inLength, unsigne
             break;
         }
         
-        switch (err)
+        // an exactly sized buffer is full before the end of the stream is read,
+        // it is only grown when inflate() can't progress without more room
+        if (err == Z_BUF_ERROR && d_stream.avail_out == 0)
         {
-            case Z_NEED_DICT:
-                err = Z_DATA_ERROR;
-            case Z_DATA_ERROR:
-            case Z_MEM_ERROR:
-                inflateEnd(&d_stream);
-                return err;
-        }
-        
-        // not enough memory ?
-        if (err != Z_STREAM_END)
-        {
-            *out = (unsigned char*)realloc(*out, bufferSize * BUFFER_INC_FACTOR);
+            ssize_t inflatedSize = bufferSize;
+            bufferSize *= BUFFER_INC_FACTOR;
+            out->resize(bufferSize);
             
             /* not enough memory, ouch */
-            if (! *out )
+            if (out->buffer() == nullptr)
             {
                 CCLOG("cocos2d: ZipUtils: realloc failed");
                 inflateEnd(&d_stream);
                 return Z_MEM_ERROR;
             }
             
-            d_stream.next_out = *out + bufferSize;
-            d_stream.avail_out = static_cast<unsigned int>(bufferSize);
-            bufferSize *= BUFFER_INC_FACTOR;
+            d_stream.next_out = static_cast<Bytef*>(out->buffer()) + inflatedSize;
+            d_stream.avail_out = static_cast<unsigned int>(bufferSize - inflatedSize);
+            continue;
+        }
+        
+        switch (err)
+        {
+            case Z_OK:
+                break;
+            case Z_NEED_DICT:
+            case Z_BUF_ERROR: // truncated stream
+                err = Z_DATA_ERROR;
+            default:
+                inflateEnd(&d_stream);
+                return err;
         }
     }
     
-    *outLength = bufferSize - d_stream.avail_out;
+    out->resize(bufferSize - d_stream.avail_out);
     err = inflateEnd(&d_stream);
     return err;
 }
 
-ssize_t ZipUtils::inflateMemoryWithHint(unsigned char *in, ssize_t inLength, unsigned char **out, ssize_t outLengthHint)
+bool ZipUtils::inflateMemory(const unsigned char *in, ssize_t inLength, ResizableBuffer *out, ssize_t outLengthHint)
 {
-    ssize_t outLength = 0;
-    int err = inflateMemoryWithHint(in, inLength, out, &outLength, outLengthHint);
+    // 256k for hint
+    int err = inflateMemoryWithHint(in, inLength, out, outLengthHint > 0 ? outLengthHint : 256 * 1024);
     
-    if (err != Z_OK || *out == nullptr) {
+    if (err != Z_OK) {
         if (err == Z_MEM_ERROR)
         {
             CCLOG("cocos2d: ZipUtils: Out of memory while decompressing map data!");
@@ -231,11 +269,23 @@ ssize_t ZipUtils::inflateMemoryWithHint(unsigned char *in, ssize_t inLength, uns
                     CCLOG("cocos2d: ZipUtils: Unknown error while decompressing map data!");
                 }
 
-        if(*out) {
-            free(*out);
-            *out = nullptr;
-        }
-        outLength = 0;
+        out->resize(0);
+        return false;
+    }
+    
+    return true;
+}
+
+ssize_t ZipUtils::inflateMemoryWithHint(unsigned char *in, ssize_t inLength, unsigned char **out, ssize_t outLengthHint)
+{
+    Data data;
+    ResizableBufferAdapter<Data> buffer(&data);
+    ssize_t outLength = 0;
+    
+    *out = nullptr;
+    if (inflateMemory(in, inLength, &buffer, outLengthHint))
+    {
+        *out = data.takeBuffer(&outLength);
     }
     
     return outLength;
@@ -317,6 +367,18 @@ int ZipUtils::inflateGZipFile(const char *path, unsigned char **out)
     return offset;
 }
 
+bool ZipUtils::inflateGZipFile(const std::string &path, ResizableBuffer *out)
+{
+    Data compressedData = FileUtils::getInstance()->getDataFromFile(path);
+    if (compressedData.isNull())
+    {
+        CCLOG("cocos2d: ZipUtils: error open gzip file: %s", path.c_str());
+        return false;
+    }
+    
+    return inflateMemory(compressedData.getBytes(), compressedData.getSize(), out);
+}
+
 bool ZipUtils::isCCZFile(const char *path)
 {
     // load file into memory
@@ -368,94 +430,110 @@ bool ZipUtils::isGZipBuffer(const unsigned char *buffer, ssize_t len)
 }
 
 
-int ZipUtils::inflateCCZBuffer(const unsigned char *buffer, ssize_t bufferLen, unsigned char **out)
+bool ZipUtils::inflateCCZBuffer(const unsigned char *buffer, ssize_t bufferLen, ResizableBuffer *out)
 {
-    struct CCZHeader *header = (struct CCZHeader*) buffer;
-
-    // verify header
-    if( header->sig[0] == 'C' && header->sig[1] == 'C' && header->sig[2] == 'Z' && header->sig[3] == '!' )
+    if (!isCCZBuffer(buffer, bufferLen))
     {
-        // verify header version
-        unsigned int version = CC_SWAP_INT16_BIG_TO_HOST( header->version );
-        if( version > 2 )
-        {
-            CCLOG("cocos2d: Unsupported CCZ header format");
-            return -1;
-        }
-
-        // verify compression format
-        if( CC_SWAP_INT16_BIG_TO_HOST(header->compression_type) != CCZ_COMPRESSION_ZLIB )
-        {
-            CCLOG("cocos2d: CCZ Unsupported compression method");
-            return -1;
-        }
+        CCLOG("cocos2d: Invalid CCZ file");
+        return false;
     }
-    else if( header->sig[0] == 'C' && header->sig[1] == 'C' && header->sig[2] == 'Z' && header->sig[3] == 'p' )
-    {
-        // encrypted ccz file
-        header = (struct CCZHeader*) buffer;
 
-        // verify header version
-        unsigned int version = CC_SWAP_INT16_BIG_TO_HOST( header->version );
-        if( version > 0 )
-        {
-            CCLOG("cocos2d: Unsupported CCZ header format");
-            return -1;
-        }
-
-        // verify compression format
-        if( CC_SWAP_INT16_BIG_TO_HOST(header->compression_type) != CCZ_COMPRESSION_ZLIB )
-        {
-            CCLOG("cocos2d: CCZ Unsupported compression method");
-            return -1;
-        }
+    const struct CCZHeader *header = (const struct CCZHeader*) buffer;
+    unsigned int len = CC_SWAP_INT32_BIG_TO_HOST( header->len );
+    const unsigned char* source = buffer + sizeof(*header);
+    ssize_t sourceLen = bufferLen - sizeof(*header);
+    unsigned int compression = CC_SWAP_INT16_BIG_TO_HOST(header->compression_type);
 
-        // decrypt
-        unsigned int* ints = (unsigned int*)(buffer+12);
-        ssize_t enclen = (bufferLen-12)/4;
+    // verify header version
+    unsigned int version = CC_SWAP_INT16_BIG_TO_HOST( header->version );
+    if( version > (header->sig[3] == '!' ? 2u : 0u) )
+    {
+        CCLOG("cocos2d: Unsupported CCZ header format");
+        return false;
+    }
 
-        decodeEncodedPvr(ints, enclen);
+    // decrypted in a copy, the buffer may be read only
+    std::vector<unsigned int> decrypted;
+    if( header->sig[3] == 'p' )
+    {
+        // encrypted ccz file, from the len field, the trailing bytes that don't fill an int aren't encrypted
+        const ssize_t encryptedBytes = bufferLen - 12;
+        ssize_t enclen = encryptedBytes / 4;
+        decrypted.resize((encryptedBytes + 3) / 4);
+        memcpy(decrypted.data(), buffer + 12, encryptedBytes);
+        decodeEncodedPvr(decrypted.data(), enclen);
 
 #if COCOS2D_DEBUG > 0
         // verify checksum in debug mode
-        unsigned int calculated = checksumPvr(ints, enclen);
+        unsigned int calculated = checksumPvr(decrypted.data(), enclen);
         unsigned int required = CC_SWAP_INT32_BIG_TO_HOST( header->reserved );
 
         if(calculated != required)
         {
             CCLOG("cocos2d: Can't decrypt image file. Is the decryption key valid?");
-            return -1;
+            return false;
         }
 #endif
+
+        len = CC_SWAP_INT32_BIG_TO_HOST( decrypted[0] );
+        source = (const unsigned char*)(decrypted.data() + 1);
+        sourceLen = bufferLen - sizeof(*header);
     }
-    else
+
+    // sized from the header, no intermediate copy
+    out->resize(len);
+    if (len > 0 && out->buffer() == nullptr)
     {
-        CCLOG("cocos2d: Invalid CCZ file");
-        return -1;
+        CCLOG("cocos2d: CCZ: Failed to allocate memory for texture");
+        return false;
     }
 
-    unsigned int len = CC_SWAP_INT32_BIG_TO_HOST( header->len );
+    if (compression == CCZ_COMPRESSION_ZLIB)
+    {
+        uLongf destlen = len;
+        int ret = uncompress((Bytef*)out->buffer(), &destlen, (const Bytef*)source, (uLong)sourceLen);
+        if( ret != Z_OK || destlen != len )
+        {
+            CCLOG("cocos2d: CCZ: Failed to uncompress data");
+            out->resize(0);
+            return false;
+        }
+        return true;
+    }
 
-    *out = (unsigned char*)malloc( len );
-    if(! *out )
+#if CC_USE_LZ4
+    if (compression == CCZ_COMPRESSION_LZ4)
     {
-        CCLOG("cocos2d: CCZ: Failed to allocate memory for texture");
-        return -1;
+        int ret = LZ4_decompress_safe((const char*)source, (char*)out->buffer(), (int)sourceLen, (int)len);
+        if( ret != (int)len )
+        {
+            CCLOG("cocos2d: CCZ: Failed to decompress LZ4 data");
+            out->resize(0);
+            return false;
+        }
+        return true;
     }
+#endif // CC_USE_LZ4
+
+    CCLOG("cocos2d: CCZ Unsupported compression method");
+    out->resize(0);
+    return false;
+}
 
-    unsigned long destlen = len;
-    size_t source = (size_t) buffer + sizeof(*header);
-    int ret = uncompress(*out, &destlen, (Bytef*)source, bufferLen - sizeof(*header) );
+int ZipUtils::inflateCCZBuffer(const unsigned char *buffer, ssize_t bufferLen, unsigned char **out)
+{
+    Data data;
+    ResizableBufferAdapter<Data> inflated(&data);
+    ssize_t outLength = 0;
 
-    if( ret != Z_OK )
+    *out = nullptr;
+    if (!inflateCCZBuffer(buffer, bufferLen, &inflated))
     {
-        CCLOG("cocos2d: CCZ: Failed to uncompress data");
-        free( *out );
-        *out = nullptr;
         return -1;
     }
 
-    return len;
+    *out = data.takeBuffer(&outLength);
+    return static_cast<int>(outLength);
 }
 
 int ZipUtils::inflateCCZFile(const char *path, unsigned char **out)
@@ -506,16 +584,210 @@ struct ZipEntryInfo
     uLong uncompressed_size;
 };
 
+// an entry of the central directory, its name points into the mapped archive
+struct ZipIndexEntry
+{
+    uint32_t hash;
+    uint32_t nameOffset;
+    uint32_t compressedSize;
+    uint32_t uncompressedSize;
+    uint32_t localHeaderOffset;
+    uint16_t nameLength;
+    uint16_t method;
+};
+
 class ZipFilePrivate
 {
 public:
+    ZipFilePrivate()
+    : zipFile(nullptr)
+    , mappedArchive(nullptr)
+    , archive(nullptr)
+    , archiveSize(0)
+    , cursor(0)
+    {
+    }
+
+    ~ZipFilePrivate()
+    {
+        CC_SAFE_DELETE(mappedArchive);
+    }
+
+    bool buildIndex(const std::string& filter);
+    const ZipIndexEntry* findEntry(const std::string& fileName) const;
+    const unsigned char* getEntryData(const ZipIndexEntry& entry) const;
+    bool readEntry(const ZipIndexEntry& entry, unsigned char* out) const;
+
     unzFile zipFile;
     
     // std::unordered_map is faster if available on the platform
     typedef std::unordered_map<std::string, struct ZipEntryInfo> FileListContainer;
     FileListContainer fileList;
+
+    // the indexed mode, the index is sorted by hash and only read after it is built
+    MappedFileData* mappedArchive;
+    const unsigned char* archive;
+    size_t archiveSize;
+    std::vector<ZipIndexEntry> index;
+    size_t cursor;
 };
 
+namespace
+{
+    const uint32_t ZIP_LOCAL_HEADER_SIGNATURE = 0x04034b50;
+    const uint32_t ZIP_CENTRAL_HEADER_SIGNATURE = 0x02014b50;
+    const uint32_t ZIP_END_OF_CENTRAL_DIRECTORY_SIGNATURE = 0x06054b50;
+    const size_t ZIP_LOCAL_HEADER_SIZE = 30;
+    const size_t ZIP_CENTRAL_HEADER_SIZE = 46;
+    const size_t ZIP_END_OF_CENTRAL_DIRECTORY_SIZE = 22;
+
+    inline uint16_t readUInt16(const unsigned char* p)
+    {
+        return static_cast<uint16_t>(p[0] | (p[1] << 8));
+    }
+
+    inline uint32_t readUInt32(const unsigned char* p)
+    {
+        return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8)
+            | (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+    }
+
+    inline uint32_t hashFilename(const char* name, size_t length)
+    {
+        return XXH32(name, length, 0);
+    }
+}
+
+bool ZipFilePrivate::buildIndex(const std::string& filter)
+{
+    index.clear();
+    cursor = 0;
+    if (!archive || archiveSize < ZIP_END_OF_CENTRAL_DIRECTORY_SIZE)
+        return false;
+
+    // the end of central directory record is followed by a comment of 64k at most
+    size_t endRecord = archiveSize - ZIP_END_OF_CENTRAL_DIRECTORY_SIZE;
+    size_t lowestRecord = endRecord > 0xFFFF ? endRecord - 0xFFFF : 0;
+    while (readUInt32(archive + endRecord) != ZIP_END_OF_CENTRAL_DIRECTORY_SIGNATURE)
+    {
+        if (endRecord == lowestRecord)
+            return false;
+        --endRecord;
+    }
+
+    uint16_t entryCount = readUInt16(archive + endRecord + 10);
+    uint32_t directorySize = readUInt32(archive + endRecord + 12);
+    uint32_t directoryOffset = readUInt32(archive + endRecord + 16);
+    // zip64 archives aren't indexed
+    if (entryCount == 0xFFFF || directoryOffset == 0xFFFFFFFF || (size_t)directoryOffset + directorySize > endRecord)
+        return false;
+
+    index.reserve(entryCount);
+    size_t position = directoryOffset;
+    const size_t directoryEnd = (size_t)directoryOffset + directorySize;
+    for (uint16_t i = 0; i < entryCount; ++i)
+    {
+        const unsigned char* header = archive + position;
+        if (position + ZIP_CENTRAL_HEADER_SIZE > directoryEnd || readUInt32(header) != ZIP_CENTRAL_HEADER_SIGNATURE)
+        {
+            index.clear();
+            return false;
+        }
+
+        uint16_t flags = readUInt16(header + 8);
+        uint16_t method = readUInt16(header + 10);
+        uint16_t nameLength = readUInt16(header + 28);
+        size_t entrySize = ZIP_CENTRAL_HEADER_SIZE + nameLength + readUInt16(header + 30) + readUInt16(header + 32);
+        if (position + entrySize > directoryEnd)
+        {
+            index.clear();
+            return false;
+        }
+
+        const char* name = reinterpret_cast<const char*>(header + ZIP_CENTRAL_HEADER_SIZE);
+        // cache info about filtered files only (like 'assets/'), the encrypted ones can't be read
+        if ((filter.empty() || (nameLength >= filter.size() && memcmp(name, filter.data(), filter.size()) == 0))
+            && (flags & 1) == 0 && (method == 0 || method == Z_DEFLATED))
+        {
+            ZipIndexEntry entry;
+            entry.hash = hashFilename(name, nameLength);
+            entry.nameOffset = static_cast<uint32_t>(position + ZIP_CENTRAL_HEADER_SIZE);
+            entry.compressedSize = readUInt32(header + 20);
+            entry.uncompressedSize = readUInt32(header + 24);
+            entry.localHeaderOffset = readUInt32(header + 42);
+            entry.nameLength = nameLength;
+            entry.method = method;
+            index.push_back(entry);
+        }
+        position += entrySize;
+    }
+
+    std::sort(index.begin(), index.end(), [](const ZipIndexEntry& a, const ZipIndexEntry& b) {
+        return a.hash < b.hash;
+    });
+    return true;
+}
+
+const ZipIndexEntry* ZipFilePrivate::findEntry(const std::string& fileName) const
+{
+    uint32_t hash = hashFilename(fileName.data(), fileName.size());
+    auto iter = std::lower_bound(index.begin(), index.end(), hash, [](const ZipIndexEntry& entry, uint32_t value) {
+        return entry.hash < value;
+    });
+    for (; iter != index.end() && iter->hash == hash; ++iter)
+    {
+        if (iter->nameLength == fileName.size() && memcmp(archive + iter->nameOffset, fileName.data(), fileName.size()) == 0)
+            return &*iter;
+    }
+    return nullptr;
+}
+
+const unsigned char* ZipFilePrivate::getEntryData(const ZipIndexEntry& entry) const
+{
+    // the extra field of the local header may differ from the central directory one
+    size_t position = entry.localHeaderOffset;
+    if (position + ZIP_LOCAL_HEADER_SIZE > archiveSize || readUInt32(archive + position) != ZIP_LOCAL_HEADER_SIGNATURE)
+        return nullptr;
+
+    size_t dataOffset = position + ZIP_LOCAL_HEADER_SIZE + readUInt16(archive + position + 26) + readUInt16(archive + position + 28);
+    if (dataOffset + entry.compressedSize > archiveSize)
+        return nullptr;
+    return archive + dataOffset;
+}
+
+bool ZipFilePrivate::readEntry(const ZipIndexEntry& entry, unsigned char* out) const
+{
+    const unsigned char* data = getEntryData(entry);
+    if (!data)
+        return false;
+
+    if (entry.method == 0)
+    {
+        if (entry.compressedSize != entry.uncompressedSize)
+            return false;
+        memcpy(out, data, entry.uncompressedSize);
+        return true;
+    }
+
+    if (entry.uncompressedSize == 0)
+        return true;
+
+    // each read has its own stream, so the reads may be concurrent
+    z_stream stream;
+    memset(&stream, 0, sizeof(stream));
+    stream.next_in = const_cast<Bytef*>(data);
+    stream.avail_in = entry.compressedSize;
+    stream.next_out = out;
+    stream.avail_out = entry.uncompressedSize;
+
+    // raw deflate data, without zlib header
+    if (inflateInit2(&stream, -MAX_WBITS) != Z_OK)
+        return false;
+    int err = inflate(&stream, Z_FINISH);
+    inflateEnd(&stream);
+    return err == Z_STREAM_END && stream.total_out == entry.uncompressedSize;
+}
+
 ZipFile *ZipFile::createWithBuffer(const void* buffer, uLong size)
 {
     ZipFile *zip = new (std::nothrow) ZipFile();
@@ -527,10 +799,37 @@ ZipFile *ZipFile::createWithBuffer(const void* buffer, uLong size)
     }
 }
 
+ZipFile *ZipFile::createWithIndex(const std::string &zipFile, const std::string &filter)
+{
+    ZipFile *zip = new (std::nothrow) ZipFile();
+    if (!zip)
+        return nullptr;
+
+    zip->_data->mappedArchive = FileUtils::getInstance()->mapFileContents(zipFile);
+    if (zip->_data->mappedArchive)
+    {
+        zip->_data->archive = zip->_data->mappedArchive->getBytes();
+        zip->_data->archiveSize = static_cast<size_t>(zip->_data->mappedArchive->getSize());
+        if (zip->_data->buildIndex(filter))
+            return zip;
+        CC_SAFE_DELETE(zip->_data->mappedArchive);
+        zip->_data->archive = nullptr;
+        zip->_data->archiveSize = 0;
+    }
+
+    zip->_data->zipFile = unzOpen(FileUtils::getInstance()->getSuitableFOpen(zipFile).c_str());
+    if (!zip->_data->zipFile)
+    {
+        delete zip;
+        return nullptr;
+    }
+    zip->setFilter(filter);
+    return zip;
+}
+
 ZipFile::ZipFile()
 : _data(new ZipFilePrivate)
 {
-    _data->zipFile = nullptr;
 }
 
 ZipFile::ZipFile(const std::string &zipFile, const std::string &filter)
@@ -550,8 +849,18 @@ ZipFile::~ZipFile()
     CC_SAFE_DELETE(_data);
 }
 
+bool ZipFile::isIndexed() const
+{
+    return _data && _data->archive;
+}
+
 bool ZipFile::setFilter(const std::string &filter)
 {
+    if (isIndexed())
+    {
+        return _data->buildIndex(filter);
+    }
+
     bool ret = false;
     do
     {
@@ -603,6 +912,12 @@ bool ZipFile::fileExists(const std::string &fileName) const
     {
         CC_BREAK_IF(!_data);
         
+        if (_data->archive)
+        {
+            ret = _data->findEntry(fileName) != nullptr;
+            break;
+        }
+
         ret = _data->fileList.find(fileName) != _data->fileList.end();
     } while(false);
     
@@ -615,6 +930,25 @@ unsigned char *ZipFile::getFileData(const std::string &fileName, ssize_t *size)
     if (size)
         *size = 0;
 
+    if (isIndexed())
+    {
+        const ZipIndexEntry* entry = fileName.empty() ? nullptr : _data->findEntry(fileName);
+        if (!entry)
+            return nullptr;
+
+        buffer = (unsigned char*)malloc(entry->uncompressedSize);
+        if (buffer && !_data->readEntry(*entry, buffer))
+        {
+            free(buffer);
+            return nullptr;
+        }
+        if (buffer && size)
+        {
+            *size = entry->uncompressedSize;
+        }
+        return buffer;
+    }
+
     do
     {
         CC_BREAK_IF(!_data->zipFile);
@@ -645,9 +979,31 @@ unsigned char *ZipFile::getFileData(const std::string &fileName, ssize_t *size)
     return buffer;
 }
 
+DataView ZipFile::getFileDataView(const std::string &fileName)
+{
+    Data data;
+    ssize_t size = 0;
+    unsigned char* buffer = getFileData(fileName, &size);
+    if (buffer)
+    {
+        data.fastSet(buffer, size);
+    }
+    return DataView(std::move(data));
+}
+
 bool ZipFile::getFileData(const std::string &fileName, ResizableBuffer* buffer)
 {
     bool res = false;
+    if (isIndexed())
+    {
+        const ZipIndexEntry* entry = fileName.empty() ? nullptr : _data->findEntry(fileName);
+        if (!entry)
+            return false;
+
+        buffer->resize(entry->uncompressedSize);
+        return _data->readEntry(*entry, static_cast<unsigned char*>(buffer->buffer()));
+    }
+
     do
     {
         CC_BREAK_IF(!_data->zipFile);
@@ -674,8 +1030,42 @@ bool ZipFile::getFileData(const std::string &fileName, ResizableBuffer* buffer)
     return res;
 }
 
+const unsigned char *ZipFile::getStoredFileData(const std::string &fileName, ssize_t *size) const
+{
+    if (size)
+        *size = 0;
+    if (!isIndexed())
+        return nullptr;
+
+    const ZipIndexEntry* entry = _data->findEntry(fileName);
+    if (!entry || entry->method != 0 || entry->compressedSize != entry->uncompressedSize)
+        return nullptr;
+
+    const unsigned char* data = _data->getEntryData(*entry);
+    if (data && size)
+    {
+        *size = entry->uncompressedSize;
+    }
+    return data;
+}
+
+ssize_t ZipFile::getFileOffset(const std::string &fileName) const
+{
+    if (!isIndexed())
+        return -1;
+
+    const ZipIndexEntry* entry = _data->findEntry(fileName);
+    return entry ? static_cast<ssize_t>(entry->localHeaderOffset) : -1;
+}
+
 std::string ZipFile::getFirstFilename()
 {
+    if (isIndexed())
+    {
+        _data->cursor = 0;
+        return getNextFilename();
+    }
+
     if (unzGoToFirstFile(_data->zipFile) != UNZ_OK) return emptyFilename;
     std::string path;
     unz_file_info info;
@@ -685,6 +1075,13 @@ std::string ZipFile::getFirstFilename()
 
 std::string ZipFile::getNextFilename()
 {
+    if (isIndexed())
+    {
+        if (_data->cursor >= _data->index.size()) return emptyFilename;
+        const ZipIndexEntry& entry = _data->index[_data->cursor++];
+        return std::string(reinterpret_cast<const char*>(_data->archive + entry.nameOffset), entry.nameLength);
+    }
+
     if (unzGoToNextFile(_data->zipFile) != UNZ_OK) return emptyFilename;
     std::string path;
     unz_file_info info;
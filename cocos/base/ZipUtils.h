@@ -66,6 +66,7 @@ typedef struct unz_file_info_s unz_file_info;
         CCZ_COMPRESSION_BZIP2,              /** bzip2 format (not supported yet). */
         CCZ_COMPRESSION_GZIP,               /** gzip format (not supported yet). */
         CCZ_COMPRESSION_NONE,               /** plain (not supported yet). */
+        CCZ_COMPRESSION_LZ4,                /** LZ4 block format, needs CC_USE_LZ4. @since v3.14 */
     };
 
     class CC_DLL ZipUtils
@@ -93,6 +94,21 @@ typedef struct unz_file_info_s unz_file_info;
         CC_DEPRECATED_ATTRIBUTE static ssize_t ccInflateMemoryWithHint(unsigned char *in, ssize_t inLength, unsigned char **out, ssize_t outLengthHint) { return inflateMemoryWithHint(in, inLength, out, outLengthHint); }
         static ssize_t inflateMemoryWithHint(unsigned char *in, ssize_t inLength, unsigned char **out, ssize_t outLengthHint);
 
+        /**
+         * Inflates either zlib or gzip deflated memory into a buffer of the caller, streaming into it without intermediate copies.
+         * The buffer is sized once, from the size stored at the end of a gzip stream or from the hint for a zlib stream,
+         * and it is only grown if that isn't enough. It is resized to the inflated length at the end.
+         * It may be called from several threads at once, e.g. to inflate several files in parallel on the JobSystem.
+         *
+         * @param in The deflated memory.
+         * @param inLength The length of the deflated memory.
+         * @param out The buffer receiving the inflated memory.
+         * @param outLengthHint The expected inflated length of a zlib stream, 256k if it is 0.
+         * @return True if the memory is inflated.
+         * @since v3.14
+         */
+        static bool inflateMemory(const unsigned char *in, ssize_t inLength, ResizableBuffer *out, ssize_t outLengthHint = 0);
+
         /** 
          * Inflates a GZip file into memory.
          *
@@ -101,6 +117,15 @@ typedef struct unz_file_info_s unz_file_info;
          */
         CC_DEPRECATED_ATTRIBUTE static int ccInflateGZipFile(const char *filename, unsigned char **out) { return inflateGZipFile(filename, out); }
         static int inflateGZipFile(const char *filename, unsigned char **out);
+
+        /**
+         * Inflates a GZip file into a buffer of the caller, sized from the gzip trailer, see inflateMemory().
+         * The file is read with FileUtils, so it may also be in the apk.
+         *
+         * @return True if the file is inflated.
+         * @since v3.14
+         */
+        static bool inflateGZipFile(const std::string &filename, ResizableBuffer *out);
         
         /** 
          * Test a file is a GZip format file or not.
@@ -137,6 +162,18 @@ typedef struct unz_file_info_s unz_file_info;
          */
         CC_DEPRECATED_ATTRIBUTE static int ccInflateCCZBuffer(const unsigned char *buffer, ssize_t len, unsigned char **out) { return inflateCCZBuffer(buffer, len, out); }
         static int inflateCCZBuffer(const unsigned char *buffer, ssize_t len, unsigned char **out);
+
+        /**
+         * Inflates a buffer with CCZ format into a buffer of the caller, sized from the CCZ header.
+         * The CCZ buffer isn't modified, even if it is encrypted, so it may be a read only file mapping.
+         * Buffers compressed with CCZ_COMPRESSION_LZ4 decompress several times faster than zlib ones, they need the
+         * engine built with CC_USE_LZ4.
+         * It may be called from several threads at once.
+         *
+         * @return True if the buffer is inflated.
+         * @since v3.14
+         */
+        static bool inflateCCZBuffer(const unsigned char *buffer, ssize_t len, ResizableBuffer *out);
         
         /** 
          * Test a file is a CCZ format file or not.
@@ -209,7 +246,7 @@ typedef struct unz_file_info_s unz_file_info;
         static void setPvrEncryptionKey(unsigned int keyPart1, unsigned int keyPart2, unsigned int keyPart3, unsigned int keyPart4);
 
     private:
-        static int inflateMemoryWithHint(unsigned char *in, ssize_t inLength, unsigned char **out, ssize_t *outLength, ssize_t outLengthHint);
+        static int inflateMemoryWithHint(const unsigned char *in, ssize_t inLength, ResizableBuffer *out, ssize_t outLengthHint);
         static inline void decodeEncodedPvr (unsigned int *data, ssize_t len);
         static inline unsigned int checksumPvr(const unsigned int *data, ssize_t len);
 
@@ -228,6 +265,11 @@ typedef struct unz_file_info_s unz_file_info;
     * It will cache the file list of a particular zip file with positions inside an archive,
     * so it would be much faster to read some particular files or to check their existence.
     *
+    * A zip file created with createWithIndex() maps the archive and parses its central directory once
+    * into a hashed index instead. Its files are read without seeking through minizip, getFileData()
+    * may then be called from several threads at once, and the stored (uncompressed) files are
+    * readable without copy with getStoredFileData().
+    *
     * @since v2.0.5
     */
     class CC_DLL ZipFile
@@ -245,6 +287,25 @@ typedef struct unz_file_info_s unz_file_info;
         ZipFile(const std::string &zipFile, const std::string &filter = std::string());
         virtual ~ZipFile();
 
+        /**
+        * Creates a zip file reading from a hashed index of its central directory, see the class description.
+        * Falls back to minizip when the archive can't be mapped or uses zip64.
+        *
+        * @param zipFile Zip file name
+        * @param filter The first part of file names, which should be accessible.
+        * @return The zip file, or nullptr if it can't be opened. It is deleted by the caller.
+        *
+        * @since v3.14
+        */
+        static ZipFile *createWithIndex(const std::string &zipFile, const std::string &filter = std::string());
+
+        /**
+        * Returns whether the files are read from a hashed index, so that getFileData() is thread safe.
+        *
+        * @since v3.14
+        */
+        bool isIndexed() const;
+
         /**
         * Regenerate accessible file list based on a new filter string.
         *
@@ -285,6 +346,36 @@ typedef struct unz_file_info_s unz_file_info;
         */
         bool getFileData(const std::string &fileName, ResizableBuffer* buffer);
 
+        /**
+        * Get resource file data from a zip file, in a buffer shared by its views.
+        * @param fileName File name
+        * @return A view of the data, null if the file can't be read.
+        *
+        * @since v3.14
+        */
+        DataView getFileDataView(const std::string &fileName);
+
+        /**
+        * Returns the data of a file stored without compression, pointing into the mapped archive.
+        * Only zip files created with createWithIndex() are mapped.
+        * @param fileName File name
+        * @param[out] size The data size if the file is found, otherwise 0.
+        * @return The data, valid as long as the zip file, or nullptr if the file isn't found,
+        *         is compressed or the archive isn't mapped.
+        *
+        * @since v3.14
+        */
+        const unsigned char *getStoredFileData(const std::string &fileName, ssize_t *size) const;
+
+        /**
+        * Returns the offset of a file in the archive, to read several files in the order of the archive.
+        * @param fileName File name
+        * @return The offset of the local header of the file, or -1 if the file isn't found or the zip file isn't indexed.
+        *
+        * @since v3.14
+        */
+        ssize_t getFileOffset(const std::string &fileName) const;
+
         std::string getFirstFilename();
         std::string getNextFilename();
         
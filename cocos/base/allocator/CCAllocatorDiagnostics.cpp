@@ -26,10 +26,36 @@
 
 #include "base/allocator/CCAllocatorDiagnostics.h"
 #include "base/allocator/CCAllocatorGlobal.h"
+#include <atomic>
 
 NS_CC_BEGIN
 NS_CC_ALLOCATOR_BEGIN
 
+// constant initialized, the global new can count before the static constructors run
+static std::atomic<uint64_t> s_heapAllocations(0);
+static std::atomic<uint64_t> s_heapDeallocations(0);
+static std::atomic<uint64_t> s_heapAllocatedBytes(0);
+
+HeapStats getHeapStats()
+{
+    HeapStats stats;
+    stats.allocations = s_heapAllocations.load(std::memory_order_relaxed);
+    stats.deallocations = s_heapDeallocations.load(std::memory_order_relaxed);
+    stats.allocatedBytes = s_heapAllocatedBytes.load(std::memory_order_relaxed);
+    return stats;
+}
+
+void recordHeapAllocation(size_t size)
+{
+    s_heapAllocations.fetch_add(1, std::memory_order_relaxed);
+    s_heapAllocatedBytes.fetch_add(size, std::memory_order_relaxed);
+}
+
+void recordHeapDeallocation()
+{
+    s_heapDeallocations.fetch_add(1, std::memory_order_relaxed);
+}
+
 #if CC_ENABLE_ALLOCATOR_DIAGNOSTICS
 AllocatorDiagnostics::AllocatorDiagnostics()
     : _allocators(nullptr)
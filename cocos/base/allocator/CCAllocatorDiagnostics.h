@@ -27,6 +27,7 @@
 #define CC_ALLOCATOR_DIAGNOSTICS_H
 /// @cond DO_NOT_SHOW
 
+#include <stdint.h>
 #include <unordered_set>
 
 #include "base/allocator/CCAllocatorMacros.h"
@@ -55,6 +56,19 @@ protected:
 };
 #endif//CC_ENABLE_ALLOCATOR_DIAGNOSTICS
 
+/** Heap allocations counted by the global new and delete since the start.
+ * They stay at 0 unless CC_ENABLE_MEMORY_STATS is enabled.
+ */
+struct HeapStats
+{
+    uint64_t allocations;
+    uint64_t deallocations;
+    uint64_t allocatedBytes;
+};
+CC_DLL HeapStats getHeapStats();
+CC_DLL void recordHeapAllocation(size_t size);
+CC_DLL void recordHeapDeallocation();
+
 NS_CC_ALLOCATOR_END
 NS_CC_END
 
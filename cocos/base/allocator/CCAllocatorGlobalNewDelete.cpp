@@ -25,10 +25,12 @@
  ****************************************************************************/
 
 #include "base/allocator/CCAllocatorStrategyGlobalSmallBlock.h"
+#include "base/allocator/CCAllocatorDiagnostics.h"
 #include <new>
 #include <exception>
 
 #include <assert.h>
+#include <stdlib.h>
 
 USING_NS_CC_ALLOCATOR;
 
@@ -46,6 +48,9 @@ void* operator new[] (std::size_t size)
 {
     void* ptr = global.allocate(size);
     assert(ptr && "No memory");
+#if CC_ENABLE_MEMORY_STATS
+    recordHeapAllocation(size);
+#endif
 
     // disabling exceptions since cocos2d-x doesn't use them
 //#if CC_TARGET_PLATFORM != CC_PLATFORM_ANDROID
@@ -60,6 +65,9 @@ void* operator new(std::size_t size)
 {
     void* ptr = global.allocate(size);
     assert(ptr && "No memory");
+#if CC_ENABLE_MEMORY_STATS
+    recordHeapAllocation(size);
+#endif
 
     // disabling exceptions since cocos2d-x doesn't use them
 //#if CC_TARGET_PLATFORM != CC_PLATFORM_ANDROID
@@ -73,8 +81,80 @@ void* operator new(std::size_t size)
 void operator delete(void* p) throw()
 {
     if (p)
+    {
+#if CC_ENABLE_MEMORY_STATS
+        recordHeapDeallocation();
+#endif
         global.deallocate(p);
+    }
 }
 
 #endif // CC_ENABLE_ALLOCATOR_GLOBAL_NEW_DELETE
 #endif // CC_ENABLE_ALLOCATOR
+
+#if CC_ENABLE_MEMORY_STATS && !(CC_ENABLE_ALLOCATOR && CC_ENABLE_ALLOCATOR_GLOBAL_NEW_DELETE)
+
+// @brief counting global new/delete on top of malloc/free when the global allocator doesn't replace them
+// The size isn't known by delete, so only the allocated bytes are counted, not the live ones.
+
+void* operator new[] (std::size_t size)
+{
+    void* ptr = malloc(size ? size : 1);
+    assert(ptr && "No memory");
+    recordHeapAllocation(size);
+    return ptr;
+}
+
+void* operator new(std::size_t size)
+{
+    void* ptr = malloc(size ? size : 1);
+    assert(ptr && "No memory");
+    recordHeapAllocation(size);
+    return ptr;
+}
+
+void* operator new[] (std::size_t size, const std::nothrow_t&) throw()
+{
+    void* ptr = malloc(size ? size : 1);
+    if (ptr)
+        recordHeapAllocation(size);
+    return ptr;
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) throw()
+{
+    void* ptr = malloc(size ? size : 1);
+    if (ptr)
+        recordHeapAllocation(size);
+    return ptr;
+}
+
+void operator delete[] (void* p) throw()
+{
+    if (p)
+    {
+        recordHeapDeallocation();
+        free(p);
+    }
+}
+
+void operator delete(void* p) throw()
+{
+    if (p)
+    {
+        recordHeapDeallocation();
+        free(p);
+    }
+}
+
+void operator delete[] (void* p, const std::nothrow_t&) throw()
+{
+    operator delete[](p);
+}
+
+void operator delete(void* p, const std::nothrow_t&) throw()
+{
+    operator delete(p);
+}
+
+#endif // CC_ENABLE_MEMORY_STATS
@@ -29,6 +29,7 @@
 
 #include "base/ccConfig.h"
 #include "platform/CCPlatformMacros.h"
+#include <new>
 
 // namespace allocator {}
 #ifdef __cplusplus
@@ -108,6 +109,45 @@
 
 #endif
 
+#if CC_ENABLE_ALLOCATOR && CC_ENABLE_ENGINE_ALLOCATOR_POOLS
+
+    // @brief declares the new/delete operators of an engine class allocated from a pool.
+    // Put it in a public section of the class and CC_DEFINE_ALLOCATOR_POOL in its source file.
+    #define CC_DECLARE_ALLOCATOR_POOL(T) \
+        static void* operator new (size_t size); \
+        static void* operator new (size_t size, const std::nothrow_t&) throw(); \
+        static void operator delete (void* object, size_t size);
+
+    // @brief defines the pool and the operators declared by CC_DECLARE_ALLOCATOR_POOL.
+    // The pool is never destroyed, objects may still be deleted after the static destructors ran.
+    // Subclasses of T fall back to the global allocator as their size differs.
+    #define CC_DEFINE_ALLOCATOR_POOL(T, pageSize) \
+        typedef NS_CC_ALLOCATOR::AllocatorStrategyPool<T, NS_CC_ALLOCATOR::PooledClassTraits<T>> T##PoolAllocator; \
+        static T##PoolAllocator& get##T##PoolAllocator() \
+        { \
+            static T##PoolAllocator* allocator = new T##PoolAllocator(#T, pageSize); \
+            return *allocator; \
+        } \
+        void* T::operator new (size_t size) \
+        { \
+            return get##T##PoolAllocator().allocate(size); \
+        } \
+        void* T::operator new (size_t size, const std::nothrow_t&) throw() \
+        { \
+            return get##T##PoolAllocator().allocate(size); \
+        } \
+        void T::operator delete (void* object, size_t size) \
+        { \
+            get##T##PoolAllocator().deallocate(object, size); \
+        }
+
+#else
+
+    #define CC_DECLARE_ALLOCATOR_POOL(...)
+    #define CC_DEFINE_ALLOCATOR_POOL(...)
+
+#endif
+
 // @ brief Quick and dirty macro to dump an area of memory
 // useful for debugging blocks of memory from allocators.
 #define DUMP(a, l, C) \
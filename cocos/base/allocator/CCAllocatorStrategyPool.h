@@ -81,6 +81,26 @@ public:
     }
 };
 
+/**
+ * ObjectTraits for classes whose operator new and delete take their memory from the pool,
+ * see CC_DECLARE_ALLOCATOR_POOL. The new and delete expressions already run the constructor
+ * and the destructor, so the pool must not.
+ *
+ * @param T Type of object.
+ * @param _alignment Alignment of object T.
+ */
+template <typename T, size_t _alignment = sizeof(uint32_t)>
+class PooledClassTraits : public ObjectTraits<T, _alignment>
+{
+public:
+    
+    void construct(T* address)
+    {}
+    
+    void destroy(T* address)
+    {}
+};
+
 /**
  * Fixed sized pool allocator strategy for objects of type T.
  *
@@ -246,6 +246,15 @@ THE SOFTWARE.
 #define CC_ENABLE_PROFILERS 0
 #endif
 
+/** @def CC_ENABLE_TRACE_ZONES
+ * If enabled, the built-in CC_PROFILER_ZONE zones are compiled in. They are recorded only while
+ * TraceProfiler is enabled at runtime, and cost one atomic load otherwise.
+ * To disable set it to 0. Enabled by default.
+ */
+#ifndef CC_ENABLE_TRACE_ZONES
+#define CC_ENABLE_TRACE_ZONES 1
+#endif
+
 /** Enable Lua engine debug log. */
 #ifndef CC_LUA_ENGINE_DEBUG
 #define CC_LUA_ENGINE_DEBUG 0
@@ -256,6 +265,21 @@ THE SOFTWARE.
 #define CC_USE_PHYSICS 1
 #endif
 
+/** @def CC_USE_CHIPMUNK_HASTY_SPACE
+ * Step the physics world with Chipmunk's multithreaded solver, cpHastySpace.
+ * The Windows builds need a Chipmunk compiled with cpHastySpace.c against pthreads-win32,
+ * so it's disabled there by default; define it to 1 when linking such a library.
+ * Without it the world is stepped on one thread and PhysicsWorld::setSolverThreads() only logs a warning.
+ * @since v3.14
+ */
+#ifndef CC_USE_CHIPMUNK_HASTY_SPACE
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32 || CC_TARGET_PLATFORM == CC_PLATFORM_WINRT)
+#define CC_USE_CHIPMUNK_HASTY_SPACE 0
+#else
+#define CC_USE_CHIPMUNK_HASTY_SPACE 1
+#endif
+#endif
+
 /** Use 3d physics integration API. */
 #ifndef CC_USE_3D_PHYSICS
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_IOS || CC_TARGET_PLATFORM == CC_PLATFORM_MAC || CC_TARGET_PLATFORM == CC_PLATFORM_WIN32 || CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID || CC_TARGET_PLATFORM == CC_PLATFORM_LINUX /*|| CC_TARGET_PLATFORM == CC_PLATFORM_WINRT*/)
@@ -268,6 +292,15 @@ THE SOFTWARE.
 #ifndef CC_ENABLE_BULLET_INTEGRATION
 #define CC_ENABLE_BULLET_INTEGRATION 1
 #endif
+
+/** @def CC_ENABLE_BULLET_MULTITHREADING
+ * Step Physics3DWorld with btDiscreteDynamicsWorldMt, its tasks running on the JobSystem.
+ * It needs Bullet 2.88 or later compiled with BT_THREADSAFE=1, so it's disabled by default.
+ * @since v3.14
+ */
+#ifndef CC_ENABLE_BULLET_MULTITHREADING
+#define CC_ENABLE_BULLET_MULTITHREADING 0
+#endif
 #endif
 
 /** Use 3D navigation API */
@@ -306,6 +339,21 @@ THE SOFTWARE.
 #endif
 #endif // CC_USE_WEBP
 
+/** Support Basis Universal supercompressed KTX2 textures or not. They are transcoded at load time to a format the GPU supports.
+ * It needs the Basis Universal transcoder (basisu_transcoder.h), which isn't one of the prebuilt dependencies of the engine.
+ * KTX2 textures in a GPU format are supported without it.
+ */
+#ifndef CC_USE_BASIS_UNIVERSAL
+#define CC_USE_BASIS_UNIVERSAL  0
+#endif // CC_USE_BASIS_UNIVERSAL
+
+/** Support CCZ files compressed with LZ4 (CCZ_COMPRESSION_LZ4) or not. They decompress several times faster than zlib ones.
+ * It needs the LZ4 library (lz4.h), which isn't one of the prebuilt dependencies of the engine.
+ */
+#ifndef CC_USE_LZ4
+#define CC_USE_LZ4  0
+#endif // CC_USE_LZ4
+
 /** Support WIC (Windows Image Component) or not. Replaces PNG, TIFF and JPEG
  */
 #ifndef CC_USE_WIC
@@ -363,6 +411,16 @@ THE SOFTWARE.
 # define CC_ENABLE_ALLOCATOR_DIAGNOSTICS CC_ENABLE_ALLOCATOR
 #endif
 
+/** @def CC_ENABLE_ENGINE_ALLOCATOR_POOLS
+ * Allocate the most frequently created engine objects (nodes, sprites, labels, actions, custom events,
+ * physics contacts and render commands) from per class pools. Requires CC_ENABLE_ALLOCATOR.
+ * The pools show up in the allocator diagnostics, the page size of a pool can be set in the
+ * configuration with the class name as key.
+ */
+#ifndef CC_ENABLE_ENGINE_ALLOCATOR_POOLS
+# define CC_ENABLE_ENGINE_ALLOCATOR_POOLS 0
+#endif
+
 /** @def CC_ENABLE_ALLOCATOR_GLOBAL_NEW_DELETE
  * Turn on override of global new and delete
  * as specified by CC_ALLOCATOR_GLOBAL_NEW_DELETE below.
@@ -371,6 +429,16 @@ THE SOFTWARE.
 # define CC_ENABLE_ALLOCATOR_GLOBAL_NEW_DELETE 0
 # endif//CC_ENABLE_ALLOCATOR_GLOBAL_NEW_DELETE
 
+/** @def CC_ENABLE_MEMORY_STATS
+ * Count the heap allocations of the global new and the live Ref objects, see Director::getMemoryStats().
+ * The global new and delete are replaced by counting ones calling malloc and free, unless
+ * CC_ENABLE_ALLOCATOR_GLOBAL_NEW_DELETE already replaces them, then the global allocator counts.
+ * Disabled by default, an application replacing the global new itself must not enable it.
+ */
+#ifndef CC_ENABLE_MEMORY_STATS
+# define CC_ENABLE_MEMORY_STATS 0
+#endif
+
 /** @def CC_ALLOCATOR_GLOBAL
  * Specify allocator to use for global allocator.
  */
@@ -385,6 +453,24 @@ THE SOFTWARE.
 # define CC_ALLOCATOR_GLOBAL_NEW_DELETE cocos2d::allocator::AllocatorStrategyGlobalSmallBlock
 #endif
 
+/** @def CC_ENABLE_ACTION_POOL
+ * If enabled, actions are allocated from size bucketed free lists, so the memory of
+ * finished actions is reused by the next create() instead of going back to the heap.
+ */
+#ifndef CC_ENABLE_ACTION_POOL
+# define CC_ENABLE_ACTION_POOL 1
+#endif
+
+/** @def CC_ENABLE_BATCHED_TWEENS
+ * If enabled, ActionManager steps simple tweens (MoveBy, MoveTo, ScaleTo, ScaleBy, RotateTo,
+ * FadeTo, FadeIn, FadeOut and TintTo, optionally wrapped in one ease) from structure of
+ * arrays buffers instead of calling their step() one by one. The values are still set in the
+ * order the actions were added to their target.
+ */
+#ifndef CC_ENABLE_BATCHED_TWEENS
+# define CC_ENABLE_BATCHED_TWEENS 1
+#endif
+
 #ifndef CC_FILEUTILS_APPLE_ENABLE_OBJC
 #define CC_FILEUTILS_APPLE_ENABLE_OBJC  1
 #endif
@@ -241,6 +241,17 @@ It should work same as apples CFSwapInt32LittleToHost(..)
 
 #endif
 
+/** @def CC_PROFILER_ZONE
+ * Records the rest of the enclosing scope as a TraceProfiler zone named __name__, a string literal.
+ */
+#if CC_ENABLE_TRACE_ZONES
+#define CC_PROFILER_ZONE_CONCAT2(__a__, __b__) __a__##__b__
+#define CC_PROFILER_ZONE_CONCAT(__a__, __b__) CC_PROFILER_ZONE_CONCAT2(__a__, __b__)
+#define CC_PROFILER_ZONE(__name__) NS_CC::ProfilingScopedZone CC_PROFILER_ZONE_CONCAT(__profilerZone, __LINE__)(__name__)
+#else
+#define CC_PROFILER_ZONE(__name__) do {} while(0)
+#endif
+
 #if !defined(COCOS2D_DEBUG) || COCOS2D_DEBUG == 0
 #define CHECK_GL_ERROR_DEBUG()
 #else
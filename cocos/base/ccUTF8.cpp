@@ -28,6 +28,15 @@
 #include "base/CCConsole.h"
 #include "ConvertUTF.h"
 #include <limits>
+#include <cstring>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#include <emmintrin.h>
+#define USE_SSE2_UTF8
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON) || defined(__aarch64__)
+#include <arm_neon.h>
+#define USE_NEON_UTF8
+#endif
 
 NS_CC_BEGIN
 
@@ -265,19 +274,181 @@ bool utfConvert(
     return true;
 };
 
+// Returns the number of leading ASCII bytes of str.
+static size_t getASCIIPrefixLength(const char* str, size_t length)
+{
+    size_t i = 0;
+#if defined(USE_SSE2_UTF8)
+    for (; i + 16 <= length; i += 16)
+    {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(str + i));
+        if (_mm_movemask_epi8(chunk) != 0)
+            break;
+    }
+#elif defined(USE_NEON_UTF8)
+    for (; i + 16 <= length; i += 16)
+    {
+        uint8x16_t chunk = vandq_u8(vld1q_u8(reinterpret_cast<const uint8_t*>(str + i)), vdupq_n_u8(0x80));
+        uint64x2_t high = vreinterpretq_u64_u8(chunk);
+        if ((vgetq_lane_u64(high, 0) | vgetq_lane_u64(high, 1)) != 0)
+            break;
+    }
+#else
+    for (; i + 8 <= length; i += 8)
+    {
+        uint64_t chunk;
+        memcpy(&chunk, str + i, sizeof(chunk));
+        if ((chunk & 0x8080808080808080ull) != 0)
+            break;
+    }
+#endif
+    while (i < length && static_cast<unsigned char>(str[i]) < 0x80)
+        ++i;
+    return i;
+}
+
+static void widenASCII(const char* src, size_t length, char16_t* dst)
+{
+    size_t i = 0;
+#if defined(USE_SSE2_UTF8)
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 16 <= length; i += 16)
+    {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_unpacklo_epi8(chunk, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + 8), _mm_unpackhi_epi8(chunk, zero));
+    }
+#elif defined(USE_NEON_UTF8)
+    for (; i + 16 <= length; i += 16)
+    {
+        uint8x16_t chunk = vld1q_u8(reinterpret_cast<const uint8_t*>(src + i));
+        vst1q_u16(reinterpret_cast<uint16_t*>(dst + i), vmovl_u8(vget_low_u8(chunk)));
+        vst1q_u16(reinterpret_cast<uint16_t*>(dst + i + 8), vmovl_u8(vget_high_u8(chunk)));
+    }
+#endif
+    for (; i < length; ++i)
+        dst[i] = static_cast<char16_t>(src[i]);
+}
+
+static void widenASCII(const char* src, size_t length, char32_t* dst)
+{
+    size_t i = 0;
+#if defined(USE_SSE2_UTF8)
+    const __m128i zero = _mm_setzero_si128();
+    for (; i + 16 <= length; i += 16)
+    {
+        __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        __m128i low = _mm_unpacklo_epi8(chunk, zero);
+        __m128i high = _mm_unpackhi_epi8(chunk, zero);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i), _mm_unpacklo_epi16(low, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + 4), _mm_unpackhi_epi16(low, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + 8), _mm_unpacklo_epi16(high, zero));
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(dst + i + 12), _mm_unpackhi_epi16(high, zero));
+    }
+#elif defined(USE_NEON_UTF8)
+    for (; i + 16 <= length; i += 16)
+    {
+        uint8x16_t chunk = vld1q_u8(reinterpret_cast<const uint8_t*>(src + i));
+        uint16x8_t low = vmovl_u8(vget_low_u8(chunk));
+        uint16x8_t high = vmovl_u8(vget_high_u8(chunk));
+        vst1q_u32(reinterpret_cast<uint32_t*>(dst + i), vmovl_u16(vget_low_u16(low)));
+        vst1q_u32(reinterpret_cast<uint32_t*>(dst + i + 4), vmovl_u16(vget_high_u16(low)));
+        vst1q_u32(reinterpret_cast<uint32_t*>(dst + i + 8), vmovl_u16(vget_low_u16(high)));
+        vst1q_u32(reinterpret_cast<uint32_t*>(dst + i + 12), vmovl_u16(vget_high_u16(high)));
+    }
+#endif
+    for (; i < length; ++i)
+        dst[i] = static_cast<char32_t>(src[i]);
+}
+
+// UTF8 to UTF16/UTF32 with the ASCII runs widened directly, only the other characters go through cvtfunc.
+// The input is validated first, so the output string is only modified when the conversion succeeds, and its
+// buffer is reused instead of converting into a temporary one.
+template <typename To, typename ToTrait = ConvertTrait<To>>
+static bool utf8Convert(const std::string& from, std::basic_string<To>& to,
+    ConversionResult(*cvtfunc)(const UTF8**, const UTF8*, typename ToTrait::ArgType**, typename ToTrait::ArgType*, ConversionFlags))
+{
+    const size_t length = from.length();
+    const char* src = from.data();
+    size_t ascii = getASCIIPrefixLength(src, length);
+    if (ascii < length)
+    {
+        auto rest = reinterpret_cast<const UTF8*>(src + ascii);
+        if (!isLegalUTF8String(&rest, reinterpret_cast<const UTF8*>(src + length)))
+            return false;
+    }
+
+    // a UTF8 sequence never takes fewer bytes than its UTF16 or UTF32 units
+    to.resize(length);
+    To* dst = &to[0];
+    size_t in = 0;
+    size_t out = 0;
+    while (in < length)
+    {
+        widenASCII(src + in, ascii, dst + out);
+        in += ascii;
+        out += ascii;
+        if (in == length)
+            break;
+
+        size_t end = in + 1;
+        while (end < length && static_cast<unsigned char>(src[end]) >= 0x80)
+            ++end;
+
+        auto inbeg = reinterpret_cast<const UTF8*>(src + in);
+        auto outbeg = reinterpret_cast<typename ToTrait::ArgType*>(dst + out);
+        auto start = outbeg;
+        if (cvtfunc(&inbeg, reinterpret_cast<const UTF8*>(src + end), &outbeg, reinterpret_cast<typename ToTrait::ArgType*>(dst + length), strictConversion) != conversionOK)
+        {
+            to.clear();
+            return false;
+        }
+        out += outbeg - start;
+        in = end;
+        ascii = getASCIIPrefixLength(src + in, length - in);
+    }
+    to.resize(out);
+    return true;
+}
+
+// UTF16/UTF32 to UTF8, narrowing the string directly when it only holds ASCII characters.
+template <typename From>
+static bool isASCII(const std::basic_string<From>& from)
+{
+    for (auto ch : from)
+    {
+        if (ch >= 0x80)
+            return false;
+    }
+    return true;
+}
+
+template <typename From>
+static void narrowASCII(const std::basic_string<From>& from, std::string& to)
+{
+    const size_t length = from.length();
+    to.resize(length);
+    for (size_t i = 0; i < length; ++i)
+        to[i] = static_cast<char>(from[i]);
+}
 
 bool UTF8ToUTF16(const std::string& utf8, std::u16string& outUtf16)
 {
-    return utfConvert(utf8, outUtf16, ConvertUTF8toUTF16);
+    return utf8Convert(utf8, outUtf16, ConvertUTF8toUTF16);
 }
 
 bool UTF8ToUTF32(const std::string& utf8, std::u32string& outUtf32)
 {
-    return utfConvert(utf8, outUtf32, ConvertUTF8toUTF32);
+    return utf8Convert(utf8, outUtf32, ConvertUTF8toUTF32);
 }
 
 bool UTF16ToUTF8(const std::u16string& utf16, std::string& outUtf8)
 {
+    if (isASCII(utf16))
+    {
+        narrowASCII(utf16, outUtf8);
+        return true;
+    }
     return utfConvert(utf16, outUtf8, ConvertUTF16toUTF8);
 }
     
@@ -288,6 +459,11 @@ bool UTF16ToUTF32(const std::u16string& utf16, std::u32string& outUtf32)
 
 bool UTF32ToUTF8(const std::u32string& utf32, std::string& outUtf8)
 {
+    if (isASCII(utf32))
+    {
+        narrowASCII(utf32, outUtf8);
+        return true;
+    }
     return utfConvert(utf32, outUtf8, ConvertUTF32toUTF8);
 }
 
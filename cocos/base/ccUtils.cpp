@@ -32,6 +32,7 @@ THE SOFTWARE.
 #include "base/CCDirector.h"
 #include "base/CCAsyncTaskPool.h"
 #include "base/CCEventDispatcher.h"
+#include "base/CCScheduler.h"
 #include "base/base64.h"
 #include "renderer/CCCustomCommand.h"
 #include "renderer/CCRenderer.h"
@@ -42,6 +43,20 @@ THE SOFTWARE.
 #include "2d/CCSprite.h"
 #include "2d/CCRenderTexture.h"
 
+// Pixel buffer objects are core on desktop GL and GL ES 3, the GL ES 2 headers don't have them.
+// The legacy GL 2.1 context used on Mac has them but no glMapBufferRange().
+#if defined(GL_PIXEL_PACK_BUFFER) && (defined(GL_MAP_READ_BIT) || (CC_TARGET_PLATFORM == CC_PLATFORM_MAC))
+#define CC_USE_READBACK_PBO 1
+#else
+#define CC_USE_READBACK_PBO 0
+#endif
+
+#if CC_USE_READBACK_PBO && defined(GL_SYNC_GPU_COMMANDS_COMPLETE)
+#define CC_USE_READBACK_FENCE 1
+#else
+#define CC_USE_READBACK_FENCE 0
+#endif
+
 NS_CC_BEGIN
 
 int ccNextPOT(int x)
@@ -57,6 +72,27 @@ int ccNextPOT(int x)
 
 namespace utils
 {
+static Size getScreenSizeInPixels()
+{
+    auto glView = Director::getInstance()->getOpenGLView();
+    auto frameSize = glView->getFrameSize();
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_MAC) || (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32) || (CC_TARGET_PLATFORM == CC_PLATFORM_LINUX)
+    frameSize = frameSize * glView->getFrameZoomFactor() * glView->getRetinaFactor();
+#endif
+    return frameSize;
+}
+
+static std::string getCaptureFilePath(const std::string& filename)
+{
+    if (FileUtils::getInstance()->isAbsolutePath(filename))
+    {
+        return filename;
+    }
+
+    CCASSERT(filename.find("/") == std::string::npos, "The existence of a relative path is not guaranteed!");
+    return FileUtils::getInstance()->getWritablePath() + filename;
+}
+
 /**
 * Capture screen implementation, don't use it directly.
 */
@@ -79,11 +115,7 @@ void onCaptureScreen(const std::function<void(bool, const std::string&)>& afterC
     }
 
 
-    auto glView = Director::getInstance()->getOpenGLView();
-    auto frameSize = glView->getFrameSize();
-#if (CC_TARGET_PLATFORM == CC_PLATFORM_MAC) || (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32) || (CC_TARGET_PLATFORM == CC_PLATFORM_LINUX)
-    frameSize = frameSize * glView->getFrameZoomFactor() * glView->getRetinaFactor();
-#endif
+    auto frameSize = getScreenSizeInPixels();
 
     int width = static_cast<int>(frameSize.width);
     int height = static_cast<int>(frameSize.height);
@@ -117,15 +149,7 @@ void onCaptureScreen(const std::function<void(bool, const std::string&)>& afterC
         if (image)
         {
             image->initWithRawData(flippedBuffer.get(), width * height * 4, width, height, 8);
-            if (FileUtils::getInstance()->isAbsolutePath(filename))
-            {
-                outputFile = filename;
-            }
-            else
-            {
-                CCASSERT(filename.find("/") == std::string::npos, "The existence of a relative path is not guaranteed!");
-                outputFile = FileUtils::getInstance()->getWritablePath() + filename;
-            }
+            outputFile = getCaptureFilePath(filename);
 
             // Save image in AsyncTaskPool::TaskType::TASK_IO thread, and call afterCaptured in mainThread
             static bool succeedSaveToFile = false;
@@ -179,6 +203,253 @@ void captureScreen(const std::function<void(bool, const std::string&)>& afterCap
     });
 }
 
+namespace
+{
+    typedef std::function<void(Image*)> ReadbackCallback;
+
+    // flips the pixels and runs onWorker on a worker, then the callback on the cocos thread, takes the ownership of pixels
+    void finishReadback(GLubyte* pixels, int width, int height, bool flipImage, const ReadbackCallback& onWorker, const ReadbackCallback& callback)
+    {
+        if (nullptr == pixels)
+        {
+            JobSystem::getInstance()->scheduleOnCocosThread([callback]() {
+                if (callback)
+                {
+                    callback(nullptr);
+                }
+            }, {});
+            return;
+        }
+
+        auto result = std::make_shared<Image*>(nullptr);
+        auto job = JobSystem::getInstance()->schedule([=]() {
+            const int rowSize = width * 4;
+            if (flipImage)
+            {
+                std::vector<GLubyte> row(rowSize);
+                for (int top = 0, bottom = height - 1; top < bottom; ++top, --bottom)
+                {
+                    memcpy(row.data(), pixels + top * rowSize, rowSize);
+                    memcpy(pixels + top * rowSize, pixels + bottom * rowSize, rowSize);
+                    memcpy(pixels + bottom * rowSize, row.data(), rowSize);
+                }
+            }
+
+            auto image = new (std::nothrow) Image();
+            if (image && image->initWithRawData(pixels, rowSize * height, width, height, 8))
+            {
+                if (onWorker)
+                {
+                    onWorker(image);
+                }
+                *result = image;
+            }
+            else
+            {
+                CC_SAFE_RELEASE(image);
+            }
+            free(pixels);
+        });
+
+        JobSystem::getInstance()->scheduleOnCocosThread([result, callback]() {
+            if (callback)
+            {
+                callback(*result);
+            }
+            CC_SAFE_RELEASE(*result);
+        }, { job });
+    }
+
+#if CC_USE_READBACK_PBO
+    struct PendingReadback
+    {
+        GLuint buffer;
+        void* fence;
+        int width;
+        int height;
+        unsigned int frames;
+        bool flipImage;
+        ReadbackCallback onWorker;
+        ReadbackCallback callback;
+    };
+
+    std::vector<PendingReadback> s_pendingReadbacks;
+    std::vector<GLuint> s_freeReadbackBuffers;
+    const char* READBACK_SCHEDULE_KEY = "utils::readPixelsAsync";
+    // a buffer is mapped after this many frames even if the GPU isn't done with it, which waits for it,
+    // without fences the buffers are expected to be ready after READBACK_FRAMES_WITHOUT_FENCE frames
+    const unsigned int READBACK_MAX_FRAMES = 4;
+    const unsigned int READBACK_FRAMES_WITHOUT_FENCE = 2;
+    const size_t READBACK_MAX_FREE_BUFFERS = 4;
+
+    GLubyte* mapReadback(const PendingReadback& readback)
+    {
+        const GLsizeiptr size = (GLsizeiptr)readback.width * readback.height * 4;
+        GLubyte* pixels = (GLubyte*)malloc(size);
+
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.buffer);
+#if CC_TARGET_PLATFORM == CC_PLATFORM_MAC
+        void* mapped = glMapBuffer(GL_PIXEL_PACK_BUFFER, GL_READ_ONLY);
+#else
+        void* mapped = glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, size, GL_MAP_READ_BIT);
+#endif
+        if (mapped && pixels)
+        {
+            memcpy(pixels, mapped, size);
+        }
+        else
+        {
+            CCLOG("cocos2d: readPixelsAsync: can't map the pixel buffer");
+            free(pixels);
+            pixels = nullptr;
+        }
+        if (mapped)
+        {
+            glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+        }
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        return pixels;
+    }
+
+    void updateReadbacks(float /*dt*/)
+    {
+        for (auto it = s_pendingReadbacks.begin(); it != s_pendingReadbacks.end();)
+        {
+            auto& readback = *it;
+            ++readback.frames;
+
+            bool ready = readback.frames >= READBACK_MAX_FRAMES;
+#if CC_USE_READBACK_FENCE
+            ready = ready || glClientWaitSync((GLsync)readback.fence, 0, 0) != GL_TIMEOUT_EXPIRED;
+#else
+            ready = ready || readback.frames >= READBACK_FRAMES_WITHOUT_FENCE;
+#endif
+            if (!ready)
+            {
+                ++it;
+                continue;
+            }
+
+            finishReadback(mapReadback(readback), readback.width, readback.height, readback.flipImage, readback.onWorker, readback.callback);
+
+#if CC_USE_READBACK_FENCE
+            glDeleteSync((GLsync)readback.fence);
+#endif
+            if (s_freeReadbackBuffers.size() < READBACK_MAX_FREE_BUFFERS)
+            {
+                s_freeReadbackBuffers.push_back(readback.buffer);
+            }
+            else
+            {
+                glDeleteBuffers(1, &readback.buffer);
+            }
+            it = s_pendingReadbacks.erase(it);
+        }
+
+        if (s_pendingReadbacks.empty())
+        {
+            Director::getInstance()->getScheduler()->unschedule(READBACK_SCHEDULE_KEY, &s_pendingReadbacks);
+        }
+    }
+#endif
+
+    void readPixels(int x, int y, int width, int height, bool flipImage, const ReadbackCallback& onWorker, const ReadbackCallback& callback)
+    {
+        glPixelStorei(GL_PACK_ALIGNMENT, 1);
+#if CC_USE_READBACK_PBO
+        PendingReadback readback;
+        if (s_freeReadbackBuffers.empty())
+        {
+            glGenBuffers(1, &readback.buffer);
+        }
+        else
+        {
+            readback.buffer = s_freeReadbackBuffers.back();
+            s_freeReadbackBuffers.pop_back();
+        }
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, readback.buffer);
+        glBufferData(GL_PIXEL_PACK_BUFFER, (GLsizeiptr)width * height * 4, nullptr, GL_STREAM_READ);
+        glReadPixels(x, y, width, height, GL_RGBA, GL_UNSIGNED_BYTE, nullptr);
+        glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+        CHECK_GL_ERROR_DEBUG();
+
+#if CC_USE_READBACK_FENCE
+        readback.fence = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+#else
+        readback.fence = nullptr;
+#endif
+        readback.width = width;
+        readback.height = height;
+        readback.frames = 0;
+        readback.flipImage = flipImage;
+        readback.onWorker = onWorker;
+        readback.callback = callback;
+
+        if (s_pendingReadbacks.empty())
+        {
+            Director::getInstance()->getScheduler()->schedule(updateReadbacks, &s_pendingReadbacks, 0, false, READBACK_SCHEDULE_KEY);
+        }
+        s_pendingReadbacks.push_back(std::move(readback));
+#else
+        GLubyte* pixels = (GLubyte*)malloc((size_t)width * height * 4);
+        if (pixels)
+        {
+            glReadPixels(x, y, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels);
+        }
+        finishReadback(pixels, width, height, flipImage, onWorker, callback);
+#endif
+    }
+}
+
+void readPixelsAsync(int x, int y, int width, int height, const std::function<void(Image*)>& callback, bool flipImage)
+{
+    readPixels(x, y, width, height, flipImage, nullptr, callback);
+}
+
+static EventListenerCustom* s_captureScreenAsyncListener;
+static CustomCommand s_captureScreenAsyncCommand;
+static std::vector<std::pair<std::function<void(bool, const std::string&)>, std::string>> s_captureScreenAsyncRequests;
+
+static void onCaptureScreenAsync()
+{
+    auto frameSize = getScreenSizeInPixels();
+    for (auto& request : s_captureScreenAsyncRequests)
+    {
+        auto afterCaptured = request.first;
+        auto outputFile = getCaptureFilePath(request.second);
+        auto succeed = std::make_shared<bool>(false);
+
+        readPixels(0, 0, (int)frameSize.width, (int)frameSize.height, true, [succeed, outputFile](Image* image) {
+            *succeed = image->saveToFile(outputFile);
+        }, [afterCaptured, outputFile, succeed](Image* /*image*/) {
+            if (afterCaptured)
+            {
+                afterCaptured(*succeed, outputFile);
+            }
+        });
+    }
+    s_captureScreenAsyncRequests.clear();
+}
+
+void captureScreenAsync(const std::function<void(bool, const std::string&)>& afterCaptured, const std::string& filename)
+{
+    // several captures of a frame share its command
+    s_captureScreenAsyncRequests.push_back(std::make_pair(afterCaptured, filename));
+    if (s_captureScreenAsyncListener)
+    {
+        return;
+    }
+    s_captureScreenAsyncCommand.init(std::numeric_limits<float>::max());
+    s_captureScreenAsyncCommand.func = onCaptureScreenAsync;
+    s_captureScreenAsyncListener = Director::getInstance()->getEventDispatcher()->addCustomEventListener(Director::EVENT_AFTER_DRAW, [](EventCustom* /*event*/) {
+        auto director = Director::getInstance();
+        director->getEventDispatcher()->removeEventListener((EventListener*)(s_captureScreenAsyncListener));
+        s_captureScreenAsyncListener = nullptr;
+        director->getRenderer()->addCommand(&s_captureScreenAsyncCommand);
+        director->getRenderer()->render();
+    });
+}
+
 Image* captureNode(Node* startNode, float scale)
 { // The best snapshot API, support Scene and any Node
     auto& size = startNode->getContentSize();
@@ -76,6 +76,26 @@ namespace utils
     * !!! remark: Caller is responsible for releasing it by calling delete.
     */
     CC_DLL Image* captureNode(Node* startNode, float scale = 1.0f);
+
+    /** Reads a rectangle of the bound framebuffer into an image without stalling the GL pipeline.
+     * The pixels are read into a pixel buffer object and fetched a frame or two later, when the GPU is done with them.
+     * The rows are flipped on a JobSystem worker. Platforms without pixel buffer objects read the pixels synchronously.
+     * It has to be called on the cocos thread while the framebuffer holds the content, from a custom command for example.
+     * @param x, y, width, height The rectangle to read, in pixels.
+     * @param callback Invoked on the cocos thread with the RGBA8888 image, or nullptr if the read failed.
+     * The image is released after the callback returns, retain it to keep it.
+     * @param flipImage Whether or not to flip the image, images are upside down in the framebuffer.
+     * @since v3.14
+     */
+    CC_DLL void readPixelsAsync(int x, int y, int width, int height, const std::function<void(Image*)>& callback, bool flipImage = true);
+
+    /** Capture the entire screen like captureScreen, but the pixels are read back asynchronously with readPixelsAsync
+     * and the image is encoded on a JobSystem worker, so the frame isn't stalled.
+     * @param afterCaptured specify the callback function which will be invoked on the cocos thread after the snapshot is saved.
+     * @param filename specify a filename where the snapshot is stored, like the one of captureScreen.
+     * @since v3.14
+     */
+    CC_DLL void captureScreenAsync(const std::function<void(bool, const std::string&)>& afterCaptured, const std::string& filename);
     
     /** Find children by name, it will return all child that has the same name.
      * It supports c++ 11 regular expression. It is  a helper function of `Node::enumerateChildren()`.
@@ -38,11 +38,15 @@ THE SOFTWARE.
 #include "base/ccConfig.h"
 
 // base
+#include "base/CCAsyncOperation.h"
 #include "base/CCAsyncTaskPool.h"
+#include "base/CCTimeSlicedQueue.h"
+#include "base/CCScriptBytecodeCache.h"
 #include "base/CCAutoreleasePool.h"
 #include "base/CCConfiguration.h"
 #include "base/CCConsole.h"
 #include "base/CCData.h"
+#include "base/CCDataView.h"
 #include "base/CCDirector.h"
 #include "base/CCIMEDelegate.h"
 #include "base/CCIMEDispatcher.h"
@@ -151,6 +155,8 @@ THE SOFTWARE.
 
 // renderer
 #include "renderer/CCCustomCommand.h"
+#include "renderer/CCDynamicResolution.h"
+#include "renderer/CCDynamicTexture.h"
 #include "renderer/CCGLProgram.h"
 #include "renderer/CCGLProgramCache.h"
 #include "renderer/CCGLProgramState.h"
@@ -264,6 +270,7 @@ THE SOFTWARE.
 #include "2d/CCSpriteBatchNode.h"
 #include "2d/CCSpriteFrame.h"
 #include "2d/CCSpriteFrameCache.h"
+#include "2d/CCStaticBatchNode.h"
 
 // text_input_node
 #include "2d/CCTextFieldTTF.h"
@@ -273,9 +280,12 @@ THE SOFTWARE.
 
 // tilemap_parallax_nodes
 #include "2d/CCParallaxNode.h"
+#include "2d/CCLODNode.h"
 #include "2d/CCTMXLayer.h"
 #include "2d/CCTMXObjectGroup.h"
+#include "2d/CCTMXTileStore.h"
 #include "2d/CCTMXTiledMap.h"
+#include "2d/CCTMXTiledMapGPU.h"
 #include "2d/CCTMXXMLParser.h"
 #include "2d/CCTileMapAtlas.h"
 #include "2d/CCFastTMXLayer.h"
@@ -284,6 +294,7 @@ THE SOFTWARE.
 // component
 #include "2d/CCComponent.h"
 #include "2d/CCComponentContainer.h"
+#include "2d/CCComponentSystem.h"
 
 //3d
 #include "3d/CCAABB.h"
@@ -296,6 +307,7 @@ THE SOFTWARE.
 #include "3d/CCMeshSkin.h"
 #include "3d/CCMotionStreak3D.h"
 #include "3d/CCMeshVertexIndexData.h"
+#include "3d/CCMeshOptimizer.h"
 #include "3d/CCOBB.h"
 #include "3d/CCPlane.h"
 #include "3d/CCRay.h"
@@ -1,6 +1,8 @@
 #include <ctype.h>
 #include <algorithm>
+#include <unordered_map>
 
+#include "base/CCAsyncTaskPool.h"
 #include "base/CCDirector.h"
 #include "platform/CCFileUtils.h"
 #include "2d/CCScene.h"
@@ -57,6 +59,159 @@ void CCBFile::setCCBFileNode(Node *pNode)
  Implementation of CCBReader
  *************************************************************************/
 
+namespace {
+
+// A ccbi file whose header and string cache are decoded, the reader starts at the sequences.
+struct CCBFileCacheEntry
+{
+    std::shared_ptr<Data> data;
+    bool jsControlled = false;
+    std::shared_ptr<std::vector<std::string>> stringCache;
+    int bodyOffset = 0;
+};
+
+// Decodes the header and the string cache like CCBReader::readHeader() and CCBReader::readStringCache(),
+// without touching the engine, so it also runs on a background thread.
+class CCBFileParser
+{
+public:
+    explicit CCBFileParser(const Data& data)
+    : _bytes(data.getBytes())
+    , _size(data.getSize())
+    {
+    }
+
+    bool parse(CCBFileCacheEntry* entry)
+    {
+        if (_bytes == nullptr || _size < 4)
+        {
+            return false;
+        }
+
+        int magicBytes = *((int*)_bytes);
+        _currentByte = 4;
+        if (CC_SWAP_INT32_BIG_TO_HOST(magicBytes) != (*reinterpret_cast<const int*>("ccbi")))
+        {
+            return false;
+        }
+
+        int version = readInt();
+        if (version != CCB_VERSION)
+        {
+            log("WARNING! Incompatible ccbi file version (file: %d reader: %d)", version, CCB_VERSION);
+            return false;
+        }
+
+        if (!hasBytes(1))
+        {
+            return false;
+        }
+        entry->jsControlled = _bytes[_currentByte++] != 0;
+
+        int numStrings = readInt();
+        entry->stringCache = std::make_shared<std::vector<std::string>>();
+        entry->stringCache->reserve(numStrings);
+        for (int i = 0; i < numStrings && !_overflow; i++)
+        {
+            if (!hasBytes(2))
+            {
+                return false;
+            }
+            int numBytes = _bytes[_currentByte] << 8 | _bytes[_currentByte + 1];
+            _currentByte += 2;
+            if (!hasBytes(numBytes))
+            {
+                return false;
+            }
+            entry->stringCache->emplace_back((const char*)_bytes + _currentByte, numBytes);
+            _currentByte += numBytes;
+        }
+
+        entry->bodyOffset = (int)_currentByte;
+        return !_overflow;
+    }
+
+private:
+    bool hasBytes(ssize_t count) const
+    {
+        return _currentByte + count <= _size;
+    }
+
+    bool getBit()
+    {
+        if (!hasBytes(1))
+        {
+            _overflow = true;
+            return true;
+        }
+
+        bool bit = (_bytes[_currentByte] & (1 << _currentBit)) != 0;
+        if (++_currentBit >= 8)
+        {
+            _currentBit = 0;
+            _currentByte++;
+        }
+        return bit;
+    }
+
+    // unsigned, see CCBReader::readInt()
+    int readInt()
+    {
+        int numBits = 0;
+        while (!getBit())
+        {
+            numBits++;
+        }
+
+        long long current = 0;
+        for (int a = numBits - 1; a >= 0; a--)
+        {
+            if (getBit())
+            {
+                current |= 1LL << a;
+            }
+        }
+        current |= 1LL << numBits;
+
+        if (_currentBit)
+        {
+            _currentBit = 0;
+            _currentByte++;
+        }
+        return _overflow ? 0 : static_cast<int>(current - 1);
+    }
+
+    const unsigned char* _bytes;
+    ssize_t _size;
+    ssize_t _currentByte = 0;
+    int _currentBit = 0;
+    bool _overflow = false;
+};
+
+bool parseCCBFile(CCBFileCacheEntry* entry)
+{
+    return CCBFileParser(*entry->data).parse(entry);
+}
+
+std::string fullPathForCCBFile(const std::string& fileName)
+{
+    std::string strCCBFileName(fileName);
+    std::string strSuffix(".ccbi");
+    // Add ccbi suffix
+    if (!CCBReader::endsWith(strCCBFileName.c_str(), strSuffix.c_str()))
+    {
+        strCCBFileName += strSuffix;
+    }
+
+    return FileUtils::getInstance()->fullPathForFilename(strCCBFileName);
+}
+
+// only accessed on the main thread
+std::unordered_map<std::string, std::shared_ptr<const CCBFileCacheEntry>> __ccbFileCache;
+bool __ccbFileCacheEnabled = false;
+
+}
+
 CCBReader::CCBReader(NodeLoaderLibrary * pNodeLoaderLibrary, CCBMemberVariableAssigner * pCCBMemberVariableAssigner, CCBSelectorResolver * pCCBSelectorResolver, NodeLoaderListener * pNodeLoaderListener) 
 : _data(nullptr)
 , _bytes(nullptr)
@@ -121,7 +276,7 @@ CCBReader::~CCBReader()
     _ownerCallbackNames.clear();
     
     // Clear string cache.
-    this->_stringCache.clear();
+    this->_stringCache.reset();
 
     setAnimationManager(nullptr);
 }
@@ -212,21 +367,12 @@ Node* CCBReader::readNodeGraphFromFile(const char *pCCBFileName, Ref *pOwner, co
         return nullptr;
     }
 
-    std::string strCCBFileName(pCCBFileName);
-    std::string strSuffix(".ccbi");
-    // Add ccbi suffix
-    if (!CCBReader::endsWith(strCCBFileName.c_str(), strSuffix.c_str()))
+    if (!loadFile(fullPathForCCBFile(pCCBFileName)))
     {
-        strCCBFileName += strSuffix;
+        return nullptr;
     }
 
-    std::string strPath = FileUtils::getInstance()->fullPathForFilename(strCCBFileName);
-
-    auto dataPtr = std::make_shared<Data>(FileUtils::getInstance()->getDataFromFile(strPath));
-    
-    Node *ret =  this->readNodeGraphFromData(dataPtr, pOwner, parentSize);
-    
-    return ret;
+    return readLoadedNodeGraph(pOwner, parentSize);
 }
 
 Node* CCBReader::readNodeGraphFromData(std::shared_ptr<cocos2d::Data> data, Ref *pOwner, const Size &parentSize)
@@ -235,13 +381,88 @@ Node* CCBReader::readNodeGraphFromData(std::shared_ptr<cocos2d::Data> data, Ref
     _bytes =_data->getBytes();
     _currentByte = 0;
     _currentBit = 0;
+
+    if (!readHeader() || !readStringCache())
+    {
+        return nullptr;
+    }
+
+    return readLoadedNodeGraph(pOwner, parentSize);
+}
+
+void CCBReader::readNodeGraphFromFileAsync(const std::string& fileName, Ref *pOwner, const Size &parentSize, const std::function<void(Node*)>& callback)
+{
+    this->retain();
+    CC_SAFE_RETAIN(pOwner);
+
+    loadFileAsync(fileName, [this, fileName, pOwner, parentSize, callback](bool success) {
+        Node *pNodeGraph = nullptr;
+        if (success)
+        {
+            std::string path = fullPathForCCBFile(fileName);
+            pNodeGraph = loadFile(path) ? readLoadedNodeGraph(pOwner, parentSize) : nullptr;
+            // loadFileAsync() caches the file even if the cache is disabled
+            if (!__ccbFileCacheEnabled)
+            {
+                __ccbFileCache.erase(path);
+            }
+        }
+
+        if (callback)
+        {
+            callback(pNodeGraph);
+        }
+
+        CC_SAFE_RELEASE(pOwner);
+        this->release();
+    });
+}
+
+bool CCBReader::loadFile(const std::string& fullPath)
+{
+    std::shared_ptr<const CCBFileCacheEntry> entry;
+
+    auto iter = __ccbFileCache.find(fullPath);
+    if (iter != __ccbFileCache.end())
+    {
+        entry = iter->second;
+    }
+    else
+    {
+        auto parsed = std::make_shared<CCBFileCacheEntry>();
+        parsed->data = std::make_shared<Data>(FileUtils::getInstance()->getDataFromFile(fullPath));
+        if (!parseCCBFile(parsed.get()))
+        {
+            return false;
+        }
+
+        if (__ccbFileCacheEnabled)
+        {
+            __ccbFileCache[fullPath] = parsed;
+        }
+        entry = parsed;
+    }
+
+    _data = entry->data;
+    _bytes = _data->getBytes();
+    _currentByte = entry->bodyOffset;
+    _currentBit = 0;
+    _stringCache = entry->stringCache;
+    _jsControlled = entry->jsControlled;
+    _animationManager->_jsControlled = _jsControlled;
+
+    return true;
+}
+
+Node* CCBReader::readLoadedNodeGraph(Ref *pOwner, const Size &parentSize)
+{
     _owner = pOwner;
     CC_SAFE_RETAIN(_owner);
 
     _animationManager->setRootContainerSize(parentSize);
     _animationManager->_owner = _owner;
     
-    Node *pNodeGraph = readFileWithCleanUp(true, std::make_shared<CCBAnimationManagerMap>());
+    Node *pNodeGraph = readBodyWithCleanUp(true, std::make_shared<CCBAnimationManagerMap>());
     
     if (pNodeGraph && _animationManager->getAutoPlaySequenceId() != -1)
     {
@@ -307,7 +528,12 @@ Node* CCBReader::readFileWithCleanUp(bool bCleanUp, CCBAnimationManagerMapPtr am
     {
         return nullptr;
     }
-    
+
+    return readBodyWithCleanUp(bCleanUp, am);
+}
+
+Node* CCBReader::readBodyWithCleanUp(bool bCleanUp, CCBAnimationManagerMapPtr am)
+{
     if (! readSequences())
     {
         return nullptr;
@@ -330,9 +556,12 @@ Node* CCBReader::readFileWithCleanUp(bool bCleanUp, CCBAnimationManagerMapPtr am
 bool CCBReader::readStringCache() {
     int numStrings = this->readInt(false);
 
+    auto stringCache = std::make_shared<std::vector<std::string>>();
+    stringCache->reserve(numStrings);
     for(int i = 0; i < numStrings; i++) {
-        this->_stringCache.push_back(this->readUTF8());
+        stringCache->push_back(this->readUTF8());
     }
+    _stringCache = stringCache;
 
     return true;
 }
@@ -503,7 +732,7 @@ float CCBReader::readFloat()
 std::string CCBReader::readCachedString()
 {
     int n = this->readInt(false);
-    return this->_stringCache[n];
+    return (*this->_stringCache)[n];
 }
 
 Node * CCBReader::readNodeGraph(Node * pParent)
@@ -1074,4 +1303,60 @@ void CCBReader::setResolutionScale(float scale)
     __ccbResolutionScale = scale;
 }
 
+void CCBReader::setFileCacheEnabled(bool enabled)
+{
+    __ccbFileCacheEnabled = enabled;
+    if (!enabled)
+    {
+        purgeFileCache();
+    }
+}
+
+bool CCBReader::isFileCacheEnabled()
+{
+    return __ccbFileCacheEnabled;
+}
+
+void CCBReader::loadFileAsync(const std::string& fileName, const std::function<void(bool)>& callback)
+{
+    std::string fullPath = fullPathForCCBFile(fileName);
+    if (__ccbFileCache.find(fullPath) != __ccbFileCache.end())
+    {
+        if (callback)
+        {
+            callback(true);
+        }
+        return;
+    }
+
+    // filled on the io thread, then read on the main thread
+    auto entry = std::make_shared<CCBFileCacheEntry>();
+    auto success = std::make_shared<bool>(false);
+
+    AsyncTaskPool::getInstance()->enqueue(AsyncTaskPool::TaskType::TASK_IO, [fullPath, entry, success, callback](void*) {
+        // the file may have been cached synchronously meanwhile
+        if (*success && __ccbFileCache.find(fullPath) == __ccbFileCache.end())
+        {
+            __ccbFileCache[fullPath] = entry;
+        }
+        if (callback)
+        {
+            callback(*success);
+        }
+    }, nullptr, [fullPath, entry, success]() {
+        entry->data = std::make_shared<Data>(FileUtils::getInstance()->getDataFromFile(fullPath));
+        *success = parseCCBFile(entry.get());
+    });
+}
+
+void CCBReader::removeFileFromCache(const std::string& fileName)
+{
+    __ccbFileCache.erase(fullPathForCCBFile(fileName));
+}
+
+void CCBReader::purgeFileCache()
+{
+    __ccbFileCache.clear();
+}
+
 };
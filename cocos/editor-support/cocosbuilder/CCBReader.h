@@ -1,6 +1,8 @@
 #ifndef _CCB_CCBREADER_H_
 #define _CCB_CCBREADER_H_
 
+#include <functional>
+#include <memory>
 #include <set>
 #include <string>
 #include <vector>
@@ -197,6 +199,48 @@ public:
      @lua NA
      */
     cocos2d::Scene* createSceneWithNodeGraphFromFile(const char *pCCBFileName, cocos2d::Ref *pOwner, const cocos2d::Size &parentSize);
+
+    /**
+     * Reads the node graph of a ccbi file asynchronously.
+     * The file is read and its header and string cache are decoded on a background thread, then the nodes are
+     * created on the main thread, where the callback is called with the node graph, or nullptr on failure.
+     * The reader and the owner are retained until the callback is called.
+     * @since v3.14
+     * @js NA
+     * @lua NA
+     */
+    void readNodeGraphFromFileAsync(const std::string& fileName, cocos2d::Ref *pOwner, const cocos2d::Size &parentSize, const std::function<void(cocos2d::Node*)>& callback);
+
+    /**
+     * Enables the cache of the parsed ccbi files, disabled by default.
+     * readNodeGraphFromFile() then skips the file IO and the decoding of the header and of the string cache
+     * when a file is opened again. The nodes and the animations are still created on each read.
+     * Disabling the cache purges it.
+     * @since v3.14
+     */
+    static void setFileCacheEnabled(bool enabled);
+    /**
+     * @since v3.14
+     */
+    static bool isFileCacheEnabled();
+    /**
+     * Reads and parses a ccbi file on a background thread and adds it to the file cache, even if the cache is disabled.
+     * The callback is called on the main thread, with false if the file can't be parsed.
+     * @since v3.14
+     * @js NA
+     * @lua NA
+     */
+    static void loadFileAsync(const std::string& fileName, const std::function<void(bool)>& callback);
+    /**
+     * Removes a ccbi file from the file cache.
+     * @since v3.14
+     */
+    static void removeFileFromCache(const std::string& fileName);
+    /**
+     * Removes all the ccbi files from the file cache.
+     * @since v3.14
+     */
+    static void purgeFileCache();
     
     /**
      * @js NA
@@ -353,6 +397,10 @@ public:
 
 private:
     void cleanUpNodeGraph(cocos2d::Node *pNode);
+    // reads the file from the file cache or from the disk, then the reader is ready to read the sequences
+    bool loadFile(const std::string& fullPath);
+    cocos2d::Node* readLoadedNodeGraph(cocos2d::Ref *pOwner, const cocos2d::Size &parentSize);
+    cocos2d::Node* readBodyWithCleanUp(bool bCleanUp, CCBAnimationManagerMapPtr am);
     bool readSequences();
     CCBKeyframe* readKeyframe(PropertyType type);
     
@@ -375,7 +423,8 @@ private:
     int _currentByte;
     int _currentBit;
     
-    std::vector<std::string> _stringCache;
+    // shared with the file cache
+    std::shared_ptr<const std::vector<std::string>> _stringCache;
     std::set<std::string> _loadedSpriteSheets;
     
     cocos2d::Ref *_owner;
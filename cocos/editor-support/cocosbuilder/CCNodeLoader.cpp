@@ -932,17 +932,13 @@ Node * NodeLoader::parsePropTypeCCBFile(Node * /*pNode*/, Node * pParent, CCBRea
     // Load sub file
     std::string path = FileUtils::getInstance()->fullPathForFilename(ccbFileName);
 
-    auto dataPtr = std::make_shared<Data>(FileUtils::getInstance()->getDataFromFile(path));
-    
     CCBReader * reader = new (std::nothrow) CCBReader(pCCBReader);
     reader->autorelease();
     reader->getAnimationManager()->setRootContainerSize(pParent->getContentSize());
     
     
-    reader->_data = dataPtr;
-    reader->_bytes = dataPtr->getBytes();
-    reader->_currentByte = 0;
-    reader->_currentBit = 0;
+    // shares the parsed file with the file cache
+    bool loaded = reader->loadFile(path);
     CC_SAFE_RETAIN(pCCBReader->_owner);
     reader->_owner = pCCBReader->_owner;
     
@@ -957,7 +953,7 @@ Node * NodeLoader::parsePropTypeCCBFile(Node * /*pNode*/, Node * pParent, CCBRea
 //     reader->_ownerCallbackNodes->retain();
 
     
-    Node * ccbFileNode = reader->readFileWithCleanUp(false, pCCBReader->getAnimationManagers());
+    Node * ccbFileNode = loaded ? reader->readBodyWithCleanUp(false, pCCBReader->getAnimationManagers()) : nullptr;
     
     if (ccbFileNode && reader->getAnimationManager()->getAutoPlaySequenceId() != -1)
     {
@@ -50,11 +50,18 @@ Timeline::Timeline()
     , _actionTag(0)
     , _ActionTimeline(nullptr)
     , _node(nullptr)
+    , _sharedFrames(false)
 {
 }
 
 Timeline::~Timeline()
 {
+    // shared frames may outlive this timeline, so don't leave them pointing at it
+    for (auto frame : _frames)
+    {
+        if (frame->getTimeline() == this)
+            frame->setTimeline(nullptr);
+    }
 }
 
 void Timeline::gotoFrame(int frameIndex)
@@ -79,42 +86,84 @@ Timeline* Timeline::clone()
 {
     Timeline* timeline = Timeline::create();
     timeline->_actionTag = _actionTag;
-
-    for (auto frame : _frames)
-    {
-        Frame* newFrame = frame->clone();
-        timeline->addFrame(newFrame);
-    }
+    timeline->_frames = _frames;
+    timeline->_sharedFrames = !_frames.empty();
 
     return timeline;
 }
 
 void Timeline::addFrame(Frame* frame)
 {
+    unshareFrames();
     _frames.pushBack(frame);
     frame->setTimeline(this);
 }
 
 void Timeline::insertFrame(Frame* frame, int index)
 {
+    unshareFrames();
     _frames.insert(index, frame);
     frame->setTimeline(this);
 }
 
 void Timeline::removeFrame(Frame* frame)
 {
+    if (_sharedFrames)
+    {
+        ssize_t index = _frames.getIndex(frame);
+        if (index == -1)
+            return;
+
+        unshareFrames();
+        frame = _frames.at(index);
+    }
+
     _frames.eraseObject(frame);
     frame->setTimeline(nullptr);
 }
 
 void Timeline::setNode(Node* node)
 {
+    _node = node;
     for (auto frame : _frames)
     {
+        frame->setTimeline(this);
         frame->setNode(node);
     }
 }
 
+void Timeline::bindFrame(Frame* frame)
+{
+    if (frame->getTimeline() != this || frame->getNode() != _node)
+    {
+        frame->setTimeline(this);
+        frame->setNode(_node);
+    }
+}
+
+void Timeline::unshareFrames()
+{
+    if (!_sharedFrames)
+        return;
+
+    _sharedFrames = false;
+
+    ssize_t currentIndex = _currentKeyFrame ? _frames.getIndex(_currentKeyFrame) : -1;
+
+    Vector<Frame*> frames;
+    frames.reserve(_frames.size());
+    for (auto frame : _frames)
+    {
+        Frame* newFrame = frame->clone();
+        newFrame->setTimeline(this);
+        newFrame->setNode(_node);
+        frames.pushBack(newFrame);
+    }
+    _frames = std::move(frames);
+
+    _currentKeyFrame = currentIndex == -1 ? nullptr : _frames.at(currentIndex);
+}
+
 Node* Timeline::getNode() const
 {
     return _node;
@@ -125,6 +174,7 @@ void Timeline::apply(unsigned int frameIndex)
     if (_currentKeyFrame)
     {
         float currentPercent = _betweenDuration == 0 ? 0 : (frameIndex - _currentKeyFrameIndex) / (float)_betweenDuration;
+        bindFrame(_currentKeyFrame);
         _currentKeyFrame->apply(currentPercent);
     }
 }
@@ -201,6 +251,7 @@ void Timeline::binarySearchKeyFrame(unsigned int frameIndex)
     if(needEnterFrame || _currentKeyFrame != from)
     {
         _currentKeyFrame = from;
+        bindFrame(_currentKeyFrame);
         _currentKeyFrame->onEnter(to, frameIndex);
     }
 }
@@ -251,7 +302,10 @@ void Timeline::updateCurrentKeyFrame(unsigned int frameIndex)
                 if(frameIndex > from->getFrameIndex() && frameIndex < to->getFrameIndex())
                     break;
                 if(from->isEnterWhenPassed())
+                {
+                    bindFrame(from);
                     from->onEnter(to, from->getFrameIndex());
+                }
             }
             while (true);
 
@@ -263,6 +317,7 @@ void Timeline::updateCurrentKeyFrame(unsigned int frameIndex)
         } while (0);
 
         _currentKeyFrame = from;
+        bindFrame(_currentKeyFrame);
         _currentKeyFrame->onEnter(to, frameIndex);
         
     }
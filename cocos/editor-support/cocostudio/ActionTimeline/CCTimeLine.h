@@ -59,11 +59,22 @@ public:
     virtual void setActionTimeline(ActionTimeline* action) { _ActionTimeline = action; }
     virtual ActionTimeline* getActionTimeline() const { return _ActionTimeline; }
 
+    /**
+     * Creates a timeline that shares this timeline's frames instead of deep copying them.
+     * Frames are immutable keyframe data once loaded, so clones only own their playback state
+     * and bind the shared frames to their own node right before entering or applying them.
+     * Adding, inserting or removing a frame on a clone gives it a private copy of the frames first.
+     */
     virtual Timeline* clone();
 
 protected:
     virtual void apply(unsigned int frameIndex);
 
+    /** Points a possibly shared frame at this timeline and its node before it is used. */
+    void bindFrame(Frame* frame);
+    /** Replaces shared frames with private copies, so that they can be modified safely. */
+    void unshareFrames();
+
     virtual void binarySearchKeyFrame (unsigned int frameIndex);
     virtual void updateCurrentKeyFrame(unsigned int frameIndex);
 
@@ -78,6 +89,8 @@ protected:
 
     ActionTimeline*  _ActionTimeline;
     cocos2d::Node* _node;
+
+    bool _sharedFrames;
 };
 
 NS_TIMELINE_END
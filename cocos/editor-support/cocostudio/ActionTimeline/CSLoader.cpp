@@ -197,6 +197,7 @@ CSLoader::CSLoader()
 , _monoCocos2dxVersion("")
 , _rootNode(nullptr)
 , _csBuildID("2.1.0.0")
+, _asyncLoadTask(0)
 {
     CREATE_CLASS_NODE_READER_INFO(NodeReader);
     CREATE_CLASS_NODE_READER_INFO(SingleNodeReader);
@@ -231,6 +232,38 @@ CSLoader::CSLoader()
     CREATE_CLASS_NODE_READER_INFO(SkeletonNodeReader);
 }
 
+struct CSLoader::AsyncLoad
+{
+    // a node being created, with the index of its next child
+    struct Frame
+    {
+        const flatbuffers::NodeTree* nodeTree;
+        Node* node;
+        int nextChild;
+    };
+
+    std::string filename;
+    ccNodeAsyncLoadCallback callback;
+    float timeBudget;
+    // the flatbuffers point into the data
+    Data data;
+    int pendingSpriteFrames;
+    std::vector<Frame> frames;
+};
+
+CSLoader::~CSLoader()
+{
+    // the loads are dropped without calling back into a destroyed loader
+    for (auto load : _asyncLoads)
+    {
+        load->callback = nullptr;
+    }
+    if (_asyncLoadTask != 0)
+    {
+        TimeSlicedQueue::getInstance()->cancel(_asyncLoadTask);
+    }
+}
+
 void CSLoader::purge()
 {
 }
@@ -327,6 +360,208 @@ Node* CSLoader::createNodeWithVisibleSize(const std::string &filename, const ccN
     return node;
 }
 
+void CSLoader::createNodeAsync(const std::string& filename, const ccNodeAsyncLoadCallback& callback, float timeBudget)
+{
+    CSLoader* loader = CSLoader::getInstance();
+
+    auto load = new (std::nothrow) AsyncLoad();
+    if (load == nullptr)
+    {
+        if (callback)
+            callback(nullptr);
+        return;
+    }
+    load->filename = filename;
+    load->callback = callback;
+    load->timeBudget = timeBudget;
+    load->pendingSpriteFrames = 0;
+
+    const Data* prototype = loader->getPrototypeData(filename);
+    if (prototype)
+    {
+        load->data = *prototype;
+        loader->onAsyncLoadReady(load);
+        return;
+    }
+
+    FileUtils::getInstance()->getDataFromFile(filename, [loader, load](Data data) {
+        load->data = std::move(data);
+        loader->onAsyncLoadReady(load);
+    });
+}
+
+void CSLoader::onAsyncLoadReady(AsyncLoad* load)
+{
+    if (load->data.isNull() || load->data.getSize() <= 0)
+    {
+        CCLOG("CSLoader::createNodeAsync - failed read file: %s", load->filename.c_str());
+        finishAsyncLoad(load, nullptr);
+        return;
+    }
+
+    // the nodes are created once the sprite frames of the file are loaded
+    auto csparsebinary = GetCSParseBinary(load->data.getBytes());
+    auto textures = csparsebinary->textures();
+    int textureSize = textures->size();
+    load->pendingSpriteFrames = textureSize + 1;
+
+    auto onSpriteFramesLoaded = [this, load](bool /*loaded*/) {
+        if (--load->pendingSpriteFrames > 0)
+            return;
+
+        AsyncLoad::Frame root = { GetCSParseBinary(load->data.getBytes())->nodeTree(), nullptr, -1 };
+        load->frames.push_back(root);
+        _asyncLoads.push_back(load);
+
+        if (_asyncLoadTask == 0)
+        {
+            auto queue = TimeSlicedQueue::getInstance();
+            _asyncLoadTask = queue->addTask(CC_CALLBACK_1(CSLoader::stepAsyncLoads, this), 0, [this](bool done) {
+                _asyncLoadTask = 0;
+                if (done)
+                    return;
+
+                // cancelled, the nodes created so far are thrown away
+                auto loads = std::move(_asyncLoads);
+                _asyncLoads.clear();
+                for (auto pending : loads)
+                {
+                    for (auto& frame : pending->frames)
+                    {
+                        CC_SAFE_RELEASE(frame.node);
+                    }
+                    finishAsyncLoad(pending, nullptr);
+                }
+            });
+            queue->setTaskBudget(_asyncLoadTask, load->timeBudget);
+        }
+    };
+
+    for (int i = 0; i < textureSize; ++i)
+    {
+        SpriteFrameCache::getInstance()->addSpriteFramesWithFileAsync(textures->Get(i)->c_str(), onSpriteFramesLoaded);
+    }
+    onSpriteFramesLoaded(true);
+}
+
+bool CSLoader::stepAsyncLoads(float& /*progress*/)
+{
+    AsyncLoad* load = _asyncLoads.front();
+    if (stepAsyncLoad(load))
+    {
+        _asyncLoads.pop_front();
+        finishAsyncLoad(load, load->frames.empty() ? nullptr : load->frames.back().node);
+
+        if (!_asyncLoads.empty())
+        {
+            TimeSlicedQueue::getInstance()->setTaskBudget(_asyncLoadTask, _asyncLoads.front()->timeBudget);
+        }
+    }
+    return _asyncLoads.empty();
+}
+
+bool CSLoader::stepAsyncLoad(AsyncLoad* load)
+{
+    // creates a node
+    AsyncLoad::Frame& frame = load->frames.back();
+    if (frame.nextChild < 0)
+    {
+        frame.node = createSingleNodeWithFlatBuffers(frame.nodeTree, nullptr);
+        frame.nextChild = 0;
+        if (frame.node == nullptr)
+        {
+            // If node is invalid, there is no necessity to process children of node.
+            load->frames.pop_back();
+            return load->frames.empty();
+        }
+        // the nodes aren't in the tree yet, they'd be released with the autorelease pool
+        frame.node->retain();
+        return false;
+    }
+
+    // then its children
+    auto children = frame.nodeTree->children();
+    if (frame.nextChild < (int)children->size())
+    {
+        AsyncLoad::Frame child = { children->Get(frame.nextChild++), nullptr, -1 };
+        load->frames.push_back(child);
+        return false;
+    }
+
+    // then adds it to its parent
+    if (load->frames.size() == 1)
+    {
+        reconstructNestNode(frame.node);
+        return true;
+    }
+
+    Node* node = frame.node;
+    load->frames.pop_back();
+    addChildWithFlatBuffers(load->frames.back().node, node);
+    node->release();
+    return false;
+}
+
+void CSLoader::finishAsyncLoad(AsyncLoad* load, Node* node)
+{
+    if (load->callback)
+    {
+        load->callback(node);
+    }
+    CC_SAFE_RELEASE(node);
+    delete load;
+}
+
+const Data* CSLoader::getPrototypeData(const std::string& filename) const
+{
+    if (_prototypes.empty())
+        return nullptr;
+
+    auto iter = _prototypes.find(filename);
+    return iter != _prototypes.end() ? &iter->second : nullptr;
+}
+
+bool CSLoader::addPrototype(const std::string& filename)
+{
+    CSLoader* loader = CSLoader::getInstance();
+    if (loader->_prototypes.find(filename) != loader->_prototypes.end())
+        return true;
+
+    Data data = FileUtils::getInstance()->getDataFromFile(filename);
+    if (data.isNull())
+    {
+        CCLOG("CSLoader::addPrototype - failed read file: %s", filename.c_str());
+        return false;
+    }
+
+    // the buffer is checked once, instead of each time it is instantiated
+    flatbuffers::Verifier verifier(data.getBytes(), data.getSize());
+    if (!VerifyCSParseBinaryBuffer(verifier))
+    {
+        CCLOG("CSLoader::addPrototype - invalid file: %s", filename.c_str());
+        return false;
+    }
+
+    auto textures = GetCSParseBinary(data.getBytes())->textures();
+    for (int i = 0, textureSize = textures->size(); i < textureSize; ++i)
+    {
+        SpriteFrameCache::getInstance()->addSpriteFramesWithFile(textures->Get(i)->c_str());
+    }
+
+    loader->_prototypes.emplace(filename, std::move(data));
+    return true;
+}
+
+void CSLoader::removePrototype(const std::string& filename)
+{
+    CSLoader::getInstance()->_prototypes.erase(filename);
+}
+
+void CSLoader::removeAllPrototypes()
+{
+    CSLoader::getInstance()->_prototypes.clear();
+}
+
 std::string CSLoader::getExtentionName(const std::string& name)
 {
     std::string path = name;
@@ -948,6 +1183,19 @@ Node* CSLoader::nodeWithFlatBuffersFile(const std::string &fileName)
 
 Node* CSLoader::nodeWithFlatBuffersFile(const std::string &fileName, const ccNodeLoadCallback &callback)
 {
+    // a prototype was read and checked already
+    const Data* prototype = getPrototypeData(fileName);
+    if (prototype)
+    {
+        auto csparsebinary = GetCSParseBinary(prototype->getBytes());
+        auto textures = csparsebinary->textures();
+        for (int i = 0, textureSize = textures->size(); i < textureSize; ++i)
+        {
+            SpriteFrameCache::getInstance()->addSpriteFramesWithFile(textures->Get(i)->c_str());
+        }
+        return nodeWithFlatBuffers(csparsebinary->nodeTree(), callback);
+    }
+
     std::string fullPath = FileUtils::getInstance()->fullPathForFilename(fileName);
     
     CC_ASSERT(FileUtils::getInstance()->isFileExist(fullPath));
@@ -1001,136 +1249,152 @@ Node* CSLoader::nodeWithFlatBuffers(const flatbuffers::NodeTree *nodetree)
 
 Node* CSLoader::nodeWithFlatBuffers(const flatbuffers::NodeTree *nodetree, const ccNodeLoadCallback &callback)
 {
-    if (nodetree == nullptr)
+    Node* node = createSingleNodeWithFlatBuffers(nodetree, callback);
+
+    // If node is invalid, there is no necessity to process children of node.
+    if (!node)
+    {
         return nullptr;
+    }
 
+    auto children = nodetree->children();
+    int size = children->size();
+    for (int i = 0; i < size; ++i)
     {
-        Node* node = nullptr;
-        
-        std::string classname = nodetree->classname()->c_str();
-        
-        auto options = nodetree->options();
-        
-        if (classname == "ProjectNode")
+        auto subNodeTree = children->Get(i);
+        Node* child = nodeWithFlatBuffers(subNodeTree, callback);
+        if (child)
         {
-            auto reader = ProjectNodeReader::getInstance();
-            auto projectNodeOptions = (ProjectNodeOptions*)options->data();
-            std::string filePath = projectNodeOptions->fileName()->c_str();
-            
-            cocostudio::timeline::ActionTimeline* action = nullptr;
-            if (filePath != "" && FileUtils::getInstance()->isFileExist(filePath))
-            {
-                Data buf = FileUtils::getInstance()->getDataFromFile(filePath);
-                node = createNode(buf, callback);
-                action = createTimeline(buf, filePath);
-            }
-            else
-            {
-                node = Node::create();
-            }
-            reader->setPropsWithFlatBuffers(node, options->data());
-            if (action)
+            addChildWithFlatBuffers(node, child);
+
+            if (callback)
             {
-                action->setTimeSpeed(projectNodeOptions->innerActionSpeed());
-                node->runAction(action);
-                action->gotoFrameAndPause(0);
+                callback(child);
             }
         }
-        else if (classname == "SimpleAudio")
+    }
+
+    //    _loadingNodeParentHierarchy.pop_back();
+
+    return node;
+}
+
+Node* CSLoader::createSingleNodeWithFlatBuffers(const flatbuffers::NodeTree *nodetree, const ccNodeLoadCallback &callback)
+{
+    if (nodetree == nullptr)
+        return nullptr;
+
+    Node* node = nullptr;
+    
+    std::string classname = nodetree->classname()->c_str();
+    
+    auto options = nodetree->options();
+    
+    if (classname == "ProjectNode")
+    {
+        auto reader = ProjectNodeReader::getInstance();
+        auto projectNodeOptions = (ProjectNodeOptions*)options->data();
+        std::string filePath = projectNodeOptions->fileName()->c_str();
+        
+        cocostudio::timeline::ActionTimeline* action = nullptr;
+        const Data* prototype = getPrototypeData(filePath);
+        if (prototype)
         {
-            node = Node::create();
-            auto reader = ComAudioReader::getInstance();
-            Component* component = reader->createComAudioWithFlatBuffers(options->data());
-            if (component)
-            {
-                component->setName(PlayableFrame::PLAYABLE_EXTENTION);
-                node->addComponent(component);
-                reader->setPropsWithFlatBuffers(node, options->data());
-            }
+            node = createNode(*prototype, callback);
+            action = createTimeline(*prototype, filePath);
+        }
+        else if (filePath != "" && FileUtils::getInstance()->isFileExist(filePath))
+        {
+            Data buf = FileUtils::getInstance()->getDataFromFile(filePath);
+            node = createNode(buf, callback);
+            action = createTimeline(buf, filePath);
         }
         else
         {
-            std::string customClassName = nodetree->customClassName()->c_str();
-            if (customClassName != "")
-            {
-                classname = customClassName;
-            }
-            std::string readername = getGUIClassName(classname);
-            readername.append("Reader");
-            
-            NodeReaderProtocol* reader = dynamic_cast<NodeReaderProtocol*>(ObjectFactory::getInstance()->createObject(readername));
-            if (reader)
-            {
-                node = reader->createNodeWithFlatBuffers(options->data());
-            }
-            
-            Widget* widget = dynamic_cast<Widget*>(node);
-            if (widget)
-            {
-                std::string callbackName = widget->getCallbackName();
-                std::string callbackType = widget->getCallbackType();
-                
-                bindCallback(callbackName, callbackType, widget, _rootNode);
-            }
-            
-            /* To reconstruct nest node as WidgetCallBackHandlerProtocol. */
-            auto callbackHandler = dynamic_cast<WidgetCallBackHandlerProtocol *>(node);
-            if (callbackHandler)
-            {
-                _callbackHandlers.pushBack(node);
-                _rootNode = _callbackHandlers.back();
-            }
-            /**/
-            //        _loadingNodeParentHierarchy.push_back(node);
+            node = Node::create();
         }
-        
-        // If node is invalid, there is no necessity to process children of node.
-        if (!node)
+        reader->setPropsWithFlatBuffers(node, options->data());
+        if (action)
+        {
+            action->setTimeSpeed(projectNodeOptions->innerActionSpeed());
+            node->runAction(action);
+            action->gotoFrameAndPause(0);
+        }
+    }
+    else if (classname == "SimpleAudio")
+    {
+        node = Node::create();
+        auto reader = ComAudioReader::getInstance();
+        Component* component = reader->createComAudioWithFlatBuffers(options->data());
+        if (component)
+        {
+            component->setName(PlayableFrame::PLAYABLE_EXTENTION);
+            node->addComponent(component);
+            reader->setPropsWithFlatBuffers(node, options->data());
+        }
+    }
+    else
+    {
+        std::string customClassName = nodetree->customClassName()->c_str();
+        if (customClassName != "")
         {
-            return nullptr;
+            classname = customClassName;
         }
+        std::string readername = getGUIClassName(classname);
+        readername.append("Reader");
         
-        auto children = nodetree->children();
-        int size = children->size();
-        for (int i = 0; i < size; ++i)
+        NodeReaderProtocol* reader = dynamic_cast<NodeReaderProtocol*>(ObjectFactory::getInstance()->createObject(readername));
+        if (reader)
         {
-            auto subNodeTree = children->Get(i);
-            Node* child = nodeWithFlatBuffers(subNodeTree, callback);
-            if (child)
-            {
-                PageView* pageView = dynamic_cast<PageView*>(node);
-                ListView* listView = dynamic_cast<ListView*>(node);
-                if (pageView)
-                {
-                    Layout* layout = dynamic_cast<Layout*>(child);
-                    if (layout)
-                    {
-                        pageView->addPage(layout);
-                    }
-                }
-                else if (listView)
-                {
-                    Widget* widget = dynamic_cast<Widget*>(child);
-                    if (widget)
-                    {
-                        listView->pushBackCustomItem(widget);
-                    }
-                }
-                else
-                {
-                    node->addChild(child);
-                }
-                
-                if (callback)
-                {
-                    callback(child);
-                }
-            }
+            node = reader->createNodeWithFlatBuffers(options->data());
         }
         
-        //    _loadingNodeParentHierarchy.pop_back();
+        Widget* widget = dynamic_cast<Widget*>(node);
+        if (widget)
+        {
+            std::string callbackName = widget->getCallbackName();
+            std::string callbackType = widget->getCallbackType();
+            
+            bindCallback(callbackName, callbackType, widget, _rootNode);
+        }
         
-        return node;
+        /* To reconstruct nest node as WidgetCallBackHandlerProtocol. */
+        auto callbackHandler = dynamic_cast<WidgetCallBackHandlerProtocol *>(node);
+        if (callbackHandler)
+        {
+            _callbackHandlers.pushBack(node);
+            _rootNode = _callbackHandlers.back();
+        }
+        /**/
+        //        _loadingNodeParentHierarchy.push_back(node);
+    }
+
+    return node;
+}
+
+void CSLoader::addChildWithFlatBuffers(Node* node, Node* child)
+{
+    PageView* pageView = dynamic_cast<PageView*>(node);
+    ListView* listView = dynamic_cast<ListView*>(node);
+    if (pageView)
+    {
+        Layout* layout = dynamic_cast<Layout*>(child);
+        if (layout)
+        {
+            pageView->addPage(layout);
+        }
+    }
+    else if (listView)
+    {
+        Widget* widget = dynamic_cast<Widget*>(child);
+        if (widget)
+        {
+            listView->pushBackCustomItem(widget);
+        }
+    }
+    else
+    {
+        node->addChild(child);
     }
 }
 
@@ -30,8 +30,11 @@
 
 #include "base/ObjectFactory.h"
 #include "base/CCData.h"
+#include "base/CCTimeSlicedQueue.h"
 #include "ui/UIWidget.h"
 
+#include <deque>
+
 namespace flatbuffers
 {
     class FlatBufferBuilder;
@@ -66,6 +69,7 @@ namespace cocostudio
 NS_CC_BEGIN
 
 typedef std::function<void(Ref*)> ccNodeLoadCallback;
+typedef std::function<void(cocos2d::Node*)> ccNodeAsyncLoadCallback;
 
 class CC_STUDIO_DLL CSLoader
 {
@@ -74,6 +78,7 @@ public:
     static void destroyInstance();
     
     CSLoader();
+    ~CSLoader();
     /** @deprecated Use method destroyInstance() instead */
     CC_DEPRECATED_ATTRIBUTE void purge();    
     
@@ -86,6 +91,37 @@ public:
     static cocos2d::Node* createNodeWithVisibleSize(const std::string& filename);
     static cocos2d::Node* createNodeWithVisibleSize(const std::string& filename, const ccNodeLoadCallback& callback);
 
+    /**
+     * Creates a node from a .csb file without blocking the main thread.
+     * The file is read and its sprite frames are loaded off the main thread, then the nodes are
+     * created by a TimeSlicedQueue task, in slices of at most timeBudget seconds per frame within the
+     * frame budget of the queue. The loads run one after the other.
+     *
+     * @param filename The .csb file.
+     * @param callback Called on the main thread with the node, or nullptr if it couldn't be created.
+     *                 The node is released after the callback unless it is retained, e.g. added to a parent.
+     * @param timeBudget The time spent creating nodes per frame, in seconds.
+     * @since v3.14
+     */
+    static void createNodeAsync(const std::string& filename, const ccNodeAsyncLoadCallback& callback, float timeBudget = 0.004f);
+
+    /**
+     * Keeps a .csb file in memory as a prototype, so that the layouts opened repeatedly are created
+     * without reading and checking the file again, by createNode() and createNodeAsync().
+     * The nested .csb files of the prototype can be added as prototypes too.
+     *
+     * @param filename The .csb file.
+     * @return false if the file can't be read.
+     * @since v3.14
+     */
+    static bool addPrototype(const std::string& filename);
+
+    /** Removes a prototype added with addPrototype(). @since v3.14 */
+    static void removePrototype(const std::string& filename);
+
+    /** Removes all the prototypes. @since v3.14 */
+    static void removeAllPrototypes();
+
     static cocostudio::timeline::ActionTimeline* createTimeline(const std::string& filename);
     static cocostudio::timeline::ActionTimeline* createTimeline(const Data& data, const std::string& filename);
 
@@ -124,6 +160,18 @@ protected:
     cocos2d::Node* createNodeWithFlatBuffersFile(const std::string& filename, const ccNodeLoadCallback& callback);
     cocos2d::Node* nodeWithFlatBuffersFile(const std::string& fileName, const ccNodeLoadCallback& callback);
     cocos2d::Node* nodeWithFlatBuffers(const flatbuffers::NodeTree* nodetree, const ccNodeLoadCallback& callback);
+
+    // creates a node without its children, then adds its children one by one
+    cocos2d::Node* createSingleNodeWithFlatBuffers(const flatbuffers::NodeTree* nodetree, const ccNodeLoadCallback& callback);
+    void addChildWithFlatBuffers(cocos2d::Node* node, cocos2d::Node* child);
+
+    const cocos2d::Data* getPrototypeData(const std::string& filename) const;
+    
+    struct AsyncLoad;
+    void onAsyncLoadReady(AsyncLoad* load);
+    bool stepAsyncLoads(float& progress);
+    bool stepAsyncLoad(AsyncLoad* load);
+    void finishAsyncLoad(AsyncLoad* load, cocos2d::Node* node);
     
     cocos2d::Node* loadNode(const rapidjson::Value& json);
     
@@ -174,6 +222,13 @@ protected:
     cocos2d::Vector<cocos2d::Node*> _callbackHandlers;
     
     std::string _csBuildID;
+
+    std::unordered_map<std::string, cocos2d::Data> _prototypes;
+
+    // the loads whose nodes are created, one after the other since loading changes _rootNode,
+    // by a single task of the TimeSlicedQueue
+    std::deque<AsyncLoad*> _asyncLoads;
+    cocos2d::TimeSlicedQueue::TaskId _asyncLoadTask;
     
 };
 
@@ -28,6 +28,9 @@ THE SOFTWARE.
 #include "editor-support/cocostudio/CCArmatureDefine.h"
 #include "editor-support/cocostudio/CCUtilMath.h"
 #include "editor-support/cocostudio/CCDatas.h"
+#include "editor-support/cocostudio/CCArmatureDataManager.h"
+
+#include <algorithm>
 
 using namespace cocos2d;
 
@@ -59,6 +62,9 @@ ArmatureAnimation::ArmatureAnimation()
     , _movementListLoop(false)
     , _movementListDurationTo(-1)
     , _userObject(nullptr)
+    , _bakedPlaybackEnabled(false)
+    , _bakedMovementData(nullptr)
+    , _bakedFrameIndex(-1)
 
     , _movementEventCallFunc(nullptr)
     , _frameEventCallFunc(nullptr)
@@ -74,6 +80,7 @@ ArmatureAnimation::ArmatureAnimation()
 ArmatureAnimation::~ArmatureAnimation(void)
 {
     CC_SAFE_RELEASE_NULL(_animationData);
+    clearBakedMovement();
 
     CC_SAFE_RELEASE_NULL(_userObject);
 }
@@ -188,8 +195,21 @@ void ArmatureAnimation::play(const std::string& animationName, int durationTo,
 
     _processScale = _speedScale * _movementData->scale;
 
+    clearBakedMovement();
+    if (_bakedPlaybackEnabled && _armature->getParentBone() == nullptr
+        && _animationData->name == _armature->getArmatureData()->name)
+    {
+        _bakedMovementData = ArmatureDataManager::getInstance()->getBakedMovementData(_animationData->name, animationName);
+        CC_SAFE_RETAIN(_bakedMovementData);
+    }
+
     //! Further processing parameters
     durationTo = (durationTo == -1) ? _movementData->durationTo : durationTo;
+    if (_bakedMovementData)
+    {
+        //! Baked movements are not blended
+        durationTo = 0;
+    }
 
     int durationTween = _movementData->durationTween == 0 ? _rawDuration : _movementData->durationTween;
 
@@ -230,11 +250,15 @@ void ArmatureAnimation::play(const std::string& animationName, int durationTo,
         Tween *tween = bone->getTween();
         if(movementBoneData && movementBoneData->frameList.size() > 0)
         {
-            _tweenList.push_back(tween);
-            movementBoneData->duration = _movementData->duration;
-            tween->play(movementBoneData, durationTo, durationTween, loop, tweenEasing);
+            //! The bones of a baked movement copy their baked frames instead of being tweened
+            if (!_bakedMovementData)
+            {
+                _tweenList.push_back(tween);
+                movementBoneData->duration = _movementData->duration;
+                tween->play(movementBoneData, durationTo, durationTween, loop, tweenEasing);
 
-            tween->setProcessScale(_processScale);
+                tween->setProcessScale(_processScale);
+            }
 
             if (bone->getChildArmature())
             {
@@ -253,6 +277,20 @@ void ArmatureAnimation::play(const std::string& animationName, int durationTo,
         }
     }
 
+    if (_bakedMovementData)
+    {
+        const std::vector<std::string>& boneNames = _bakedMovementData->boneNames;
+        for (size_t i = 0; i < boneNames.size(); ++i)
+        {
+            if (Bone *bone = _armature->getBone(boneNames[i]))
+            {
+                bone->retain();
+                _bakedBones.push_back(bone);
+                _bakedBoneIndices.push_back((int)i);
+            }
+        }
+    }
+
     _armature->update(0);
 }
 
@@ -320,6 +358,7 @@ void ArmatureAnimation::gotoAndPlay(int frameIndex)
     ProcessBase::gotoFrame(frameIndex);
     _currentPercent = (float)_curFrameIndex / ((float)_movementData->duration-1);
     _currentFrame = _nextFrameIndex * _currentPercent;
+    _bakedFrameIndex = -1;
 
     
     for (const auto &tween : _tweenList)
@@ -352,6 +391,11 @@ void ArmatureAnimation::update(float dt)
         tween->update(dt);
     }
 
+    if (_bakedMovementData)
+    {
+        updateBakedFrame();
+    }
+
     if(_frameEventQueue.size() > 0 || _movementEventQueue.size() > 0)
     {
         _armature->retain();
@@ -556,4 +600,85 @@ void ArmatureAnimation::updateMovementList()
     }
 }
 
+
+void ArmatureAnimation::updateBakedFrame()
+{
+    int frameCount = _bakedMovementData->frameCount;
+    float percent = _currentPercent < 0 ? 0 : (_currentPercent > 1 ? 1 : _currentPercent);
+    int frameIndex = (int)((frameCount - 1) * percent);
+    if (frameIndex == _bakedFrameIndex)
+    {
+        return;
+    }
+
+    //! Emit the frame events passed since the last frame, the movement may have looped
+    if (_bakedFrameIndex >= 0 && !_ignoreFrameEvent)
+    {
+        for (const auto& bakedEvent : _bakedMovementData->frameEvents)
+        {
+            bool passed = frameIndex > _bakedFrameIndex
+                ? (bakedEvent.frameIndex > _bakedFrameIndex && bakedEvent.frameIndex <= frameIndex)
+                : (bakedEvent.frameIndex > _bakedFrameIndex || bakedEvent.frameIndex <= frameIndex);
+            if (!passed)
+            {
+                continue;
+            }
+
+            auto iter = std::find(_bakedBoneIndices.begin(), _bakedBoneIndices.end(), bakedEvent.boneIndex);
+            if (iter != _bakedBoneIndices.end())
+            {
+                frameEvent(_bakedBones[iter - _bakedBoneIndices.begin()], bakedEvent.name, bakedEvent.frameIndex, frameIndex);
+            }
+        }
+    }
+    _bakedFrameIndex = frameIndex;
+
+    for (size_t i = 0; i < _bakedBones.size(); ++i)
+    {
+        Bone *bone = _bakedBones[i];
+        const BakedBoneFrame &boneFrame = _bakedMovementData->getBoneFrame(frameIndex, _bakedBoneIndices[i]);
+        FrameData *tweenData = bone->getTweenData();
+
+        DisplayManager *displayManager = bone->getDisplayManager();
+        if (!displayManager->isForceChangeDisplay() && displayManager->getCurrentDisplayIndex() != boneFrame.displayIndex)
+        {
+            displayManager->changeDisplayWithIndex(boneFrame.displayIndex, false);
+        }
+
+        if (tweenData->zOrder != boneFrame.zOrder)
+        {
+            tweenData->zOrder = boneFrame.zOrder;
+            bone->updateZOrder();
+        }
+
+        bone->setBlendFunc(boneFrame.blendFunc);
+
+        if (tweenData->a != boneFrame.a || tweenData->r != boneFrame.r || tweenData->g != boneFrame.g || tweenData->b != boneFrame.b)
+        {
+            tweenData->a = boneFrame.a;
+            tweenData->r = boneFrame.r;
+            tweenData->g = boneFrame.g;
+            tweenData->b = boneFrame.b;
+            bone->updateColor();
+        }
+
+        bone->setBakedFrame(&boneFrame);
+        bone->setTransformDirty(true);
+    }
+}
+
+void ArmatureAnimation::clearBakedMovement()
+{
+    for (const auto& bone : _bakedBones)
+    {
+        bone->setBakedFrame(nullptr);
+        bone->setTransformDirty(true);
+        bone->release();
+    }
+    _bakedBones.clear();
+    _bakedBoneIndices.clear();
+    _bakedFrameIndex = -1;
+    CC_SAFE_RELEASE_NULL(_bakedMovementData);
+}
+
 }
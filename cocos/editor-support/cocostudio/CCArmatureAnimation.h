@@ -44,6 +44,7 @@ enum MovementEventType
 
 class Armature;
 class Bone;
+class BakedMovementData;
 
 typedef void (cocos2d::Ref::*SEL_MovementEventCallFunc)(Armature *, MovementEventType, const std::string&);
 typedef void (cocos2d::Ref::*SEL_FrameEventCallFunc)(Bone *, const std::string&, int, int);
@@ -109,6 +110,17 @@ public:
     //! The animation update speed
     CC_DEPRECATED_ATTRIBUTE virtual void setAnimationInternal(float animationInternal) {}
 
+    /**
+     * Enable baked playback, disabled by default. It applies to the movements played afterwards.
+     * A baked movement is sampled once per frame by ArmatureDataManager::getBakedMovementData() and shared
+     * by all the armatures, so playing it only copies the baked bone frames instead of tweening each bone.
+     * Movements change without blending, frames are not interpolated, and the position and scale set on the
+     * bones are ignored. An armature displayed by a bone is never baked.
+     * @since v3.14
+     */
+    virtual void setBakedPlaybackEnabled(bool enabled) { _bakedPlaybackEnabled = enabled; }
+    virtual bool isBakedPlaybackEnabled() const { return _bakedPlaybackEnabled; }
+
     using ProcessBase::play;
     /**
      * Play animation by animation name.
@@ -269,6 +281,10 @@ protected:
 
     friend class Tween;
 protected:
+    //! Copy the baked frame of the current frame index to the bones
+    void updateBakedFrame();
+    void clearBakedMovement();
+
     //! AnimationData save all MovementDatas this animation used.
     AnimationData *_animationData;
 
@@ -298,6 +314,12 @@ protected:
     int _movementListDurationTo;
 
     cocos2d::Ref *_userObject;
+
+    bool _bakedPlaybackEnabled;
+    BakedMovementData *_bakedMovementData;      //! The baked movement being played, nullptr when the bones are tweened
+    std::vector<Bone*> _bakedBones;             //! The bones of the baked movement, retained
+    std::vector<int> _bakedBoneIndices;         //! The index of each bone in _bakedMovementData->boneNames
+    int _bakedFrameIndex;                       //! The last frame copied to the bones
 protected:
     /**
      * MovementEvent CallFunc.
@@ -28,6 +28,9 @@ THE SOFTWARE.
 #include "editor-support/cocostudio/CCTransformHelp.h"
 #include "editor-support/cocostudio/CCDataReaderHelper.h"
 #include "editor-support/cocostudio/CCSpriteFrameCacheHelper.h"
+#include "editor-support/cocostudio/CCArmature.h"
+
+#include <algorithm>
 
 using namespace cocos2d;
 
@@ -66,6 +69,7 @@ ArmatureDataManager::ArmatureDataManager(void)
 
 ArmatureDataManager::~ArmatureDataManager(void)
 {
+    _bakedMovementDatas.clear();
     _animationDatas.clear();
     _armarureDatas.clear();
     _textureDatas.clear();
@@ -138,6 +142,7 @@ ArmatureData *ArmatureDataManager::getArmatureData(const std::string& id)
 void ArmatureDataManager::removeArmatureData(const std::string& id)
 {
     _armarureDatas.erase(id);
+    removeBakedMovementDatas(id);
 }
 
 void ArmatureDataManager::addAnimationData(const std::string& id, AnimationData *animationData, const std::string& configFilePath)
@@ -147,6 +152,7 @@ void ArmatureDataManager::addAnimationData(const std::string& id, AnimationData
         data->animations.push_back(id);
     }
 
+    removeBakedMovementDatas(id);
     _animationDatas.insert(id, animationData);
 }
 
@@ -158,6 +164,7 @@ AnimationData *ArmatureDataManager::getAnimationData(const std::string& id)
 void ArmatureDataManager::removeAnimationData(const std::string& id)
 {
     _animationDatas.erase(id);
+    removeBakedMovementDatas(id);
 }
 
 void ArmatureDataManager::addTextureData(const std::string& id, TextureData *textureData, const std::string& configFilePath)
@@ -257,4 +264,110 @@ RelativeData *ArmatureDataManager::getRelativeData(const std::string& configFile
     return &_relativeDatas[configFilePath];
 }
 
+BakedMovementData *ArmatureDataManager::getBakedMovementData(const std::string& armatureName, const std::string& movementName)
+{
+    std::string key = armatureName + "/" + movementName;
+    BakedMovementData *bakedData = _bakedMovementDatas.at(key);
+    if (bakedData)
+    {
+        return bakedData;
+    }
+
+    AnimationData *animationData = getAnimationData(armatureName);
+    MovementData *movementData = animationData ? animationData->getMovement(movementName) : nullptr;
+    if (!getArmatureData(armatureName) || !movementData)
+    {
+        return nullptr;
+    }
+
+    //! Sample a private armature at each frame of the movement
+    Armature *armature = Armature::create(armatureName);
+    if (!armature)
+    {
+        return nullptr;
+    }
+    ArmatureAnimation *animation = armature->getAnimation();
+    animation->play(movementName, 0, 0);
+
+    bakedData = BakedMovementData::create();
+    bakedData->name = movementName;
+    bakedData->frameCount = std::max(movementData->duration, 1);
+
+    std::vector<Bone*> bones;
+    for (auto& element : movementData->movBoneDataDic)
+    {
+        Bone *bone = armature->getBone(element.first);
+        MovementBoneData *movementBoneData = element.second;
+        if (!bone || movementBoneData->frameList.empty())
+        {
+            continue;
+        }
+
+        for (auto& frameData : movementBoneData->frameList)
+        {
+            if (!frameData->strEvent.empty() && frameData->frameID < bakedData->frameCount)
+            {
+                BakedMovementData::FrameEvent frameEvent = { frameData->frameID, (int)bones.size(), frameData->strEvent };
+                bakedData->frameEvents.push_back(frameEvent);
+            }
+        }
+
+        bakedData->boneNames.push_back(element.first);
+        bones.push_back(bone);
+    }
+
+    std::stable_sort(bakedData->frameEvents.begin(), bakedData->frameEvents.end(), [](const BakedMovementData::FrameEvent& a, const BakedMovementData::FrameEvent& b) {
+        return a.frameIndex < b.frameIndex;
+    });
+
+    bakedData->boneFrames.resize(bakedData->frameCount * bones.size());
+    for (int frameIndex = 0; frameIndex < bakedData->frameCount; ++frameIndex)
+    {
+        if (movementData->duration > 0)
+        {
+            animation->gotoAndPlay(frameIndex);
+        }
+
+        for (size_t i = 0; i < bones.size(); ++i)
+        {
+            Bone *bone = bones[i];
+            BakedBoneFrame &boneFrame = bakedData->boneFrames[frameIndex * bones.size() + i];
+            BaseData *worldInfo = bone->getWorldInfo();
+            FrameData *tweenData = bone->getTweenData();
+
+            boneFrame.transform = bone->getNodeToArmatureTransform();
+            boneFrame.x = worldInfo->x;
+            boneFrame.y = worldInfo->y;
+            boneFrame.scaleX = worldInfo->scaleX;
+            boneFrame.scaleY = worldInfo->scaleY;
+            boneFrame.skewX = worldInfo->skewX;
+            boneFrame.skewY = worldInfo->skewY;
+            boneFrame.a = tweenData->a;
+            boneFrame.r = tweenData->r;
+            boneFrame.g = tweenData->g;
+            boneFrame.b = tweenData->b;
+            boneFrame.zOrder = tweenData->zOrder;
+            boneFrame.displayIndex = bone->getDisplayManager()->getCurrentDisplayIndex();
+            boneFrame.blendFunc = bone->getBlendFunc();
+        }
+    }
+
+    _bakedMovementDatas.insert(key, bakedData);
+    return bakedData;
+}
+
+void ArmatureDataManager::removeBakedMovementDatas(const std::string& armatureName)
+{
+    std::string prefix = armatureName + "/";
+    std::vector<std::string> keysToRemove;
+    for (auto& element : _bakedMovementDatas)
+    {
+        if (element.first.compare(0, prefix.size(), prefix) == 0)
+        {
+            keysToRemove.push_back(element.first);
+        }
+    }
+    _bakedMovementDatas.erase(keysToRemove);
+}
+
 }
@@ -168,6 +168,16 @@ public:
     bool isAutoLoadSpriteFile();
 
 
+    /**
+     *    @brief    Get a movement of an armature sampled once per frame, it is baked the first time.
+     *            The baked movements are shared by all the armatures, and removed with their armature data.
+     *    @param    armatureName the name of the armature data, which is also the name of its animation data
+     *    @param    movementName the name of the movement
+     *  @return    BakedMovementData *, nullptr if the armature or the movement doesn't exist
+     *  @since v3.14
+     */
+    BakedMovementData *getBakedMovementData(const std::string& armatureName, const std::string& movementName);
+
     const cocos2d::Map<std::string, ArmatureData*>&     getArmatureDatas() const;
     const cocos2d::Map<std::string, AnimationData*>&    getAnimationDatas() const;
     const cocos2d::Map<std::string, TextureData*>&      getTextureDatas() const;
@@ -175,6 +185,7 @@ public:
 protected:
     void addRelativeData(const std::string& configFilePath);
     RelativeData *getRelativeData(const std::string& configFilePath);
+    void removeBakedMovementDatas(const std::string& armatureName);
 private:
     /**
      *    @brief    save armature datas
@@ -197,6 +208,13 @@ private:
      */
     cocos2d::Map<std::string, TextureData*> _textureDatas;
 
+    /**
+     *    @brief    save baked movement datas
+     *  @key    armature name/movement name
+     *  @value    BakedMovementData *
+     */
+    cocos2d::Map<std::string, BakedMovementData*> _bakedMovementDatas;
+
     bool _autoLoadSpriteFile;
 
     std::unordered_map<std::string, RelativeData> _relativeDatas;
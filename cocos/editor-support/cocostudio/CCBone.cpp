@@ -77,6 +77,7 @@ Bone::Bone()
     _worldInfo = nullptr;
 
     _armatureParentBone = nullptr;
+    _bakedFrame = nullptr;
     _dataVersion = 0;
 }
 
@@ -184,7 +185,17 @@ void Bone::update(float delta)
         _boneTransformDirty = _armatureParentBone->isTransformDirty();
     }
 
-    if (_boneTransformDirty)
+    if (_boneTransformDirty && _bakedFrame)
+    {
+        _worldInfo->x = _bakedFrame->x;
+        _worldInfo->y = _bakedFrame->y;
+        _worldInfo->scaleX = _bakedFrame->scaleX;
+        _worldInfo->scaleY = _bakedFrame->scaleY;
+        _worldInfo->skewX = _bakedFrame->skewX;
+        _worldInfo->skewY = _bakedFrame->skewY;
+        _worldTransform = _bakedFrame->transform;
+    }
+    else if (_boneTransformDirty)
     {
         _worldInfo->copy(_tweenData);
         if (_dataVersion >= VERSION_COMBINED)
@@ -209,6 +209,13 @@ public:
     virtual FrameData *getTweenData() const { return _tweenData; }
 
     virtual BaseData *getWorldInfo() const { return _worldInfo; }
+
+    /**
+     *  Set the baked frame the bone copies its transform from instead of computing it, nullptr to compute it again.
+     *  The frame is owned by a BakedMovementData, see ArmatureAnimation::setBakedPlaybackEnabled().
+     */
+    void setBakedFrame(const BakedBoneFrame *frame) { _bakedFrame = frame; }
+    const BakedBoneFrame *getBakedFrame() const { return _bakedFrame; }
 protected:
     void applyParentTransform(Bone *parent);
 
@@ -250,6 +257,8 @@ protected:
     
     //! Armature's parent bone
     Bone *_armatureParentBone;
+
+    const BakedBoneFrame *_bakedFrame;     //! A weak reference to the baked frame copied by update()
     
     //! Data version
     float _dataVersion;
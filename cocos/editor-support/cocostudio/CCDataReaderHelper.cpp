@@ -26,6 +26,8 @@ THE SOFTWARE.
 #include "base/CCDirector.h"
 #include "base/CCScheduler.h"
 #include "base/ccUtils.h"
+#include "base/ccUTF8.h"
+#include "base/CCTimeSlicedQueue.h"
 
 #include "tinyxml2.h"
 
@@ -161,69 +163,437 @@ std::vector<std::string> DataReaderHelper::_configFileList;
 
 DataReaderHelper *DataReaderHelper::_dataReaderHelper = nullptr;
 
+std::mutex DataReaderHelper::_addDataMutex;
 
+bool DataReaderHelper::_dataCacheEnabled = false;
+std::string DataReaderHelper::_dataCacheDirectory;
 
-//! Async load
-void DataReaderHelper::loadData()
+static bool s_dataCacheDirectoryReady = false;
+
+
+/*
+ * The data cache file: a header, then the armatures, the animations, the textures and the config file paths
+ * decoded from a file. The values are written as they are in memory, the cache is only read by the device
+ * which wrote it.
+ */
+static const char DATA_CACHE_MAGIC[4] = { 'C', 'S', 'A', 'D' };
+static const uint32_t DATA_CACHE_VERSION = 1;
+
+static uint64_t hashDataCacheBytes(const void *bytes, size_t size, uint64_t value = 14695981039346656037ULL)
 {
-    AsyncStruct *pAsyncStruct = nullptr;
+    // 64 bits FNV-1a, stable across platforms and launches unlike std::hash
+    const unsigned char *data = (const unsigned char *)bytes;
+    for (size_t i = 0; i < size; ++i)
+    {
+        value ^= data[i];
+        value *= 1099511628211ULL;
+    }
+    return value;
+}
 
-    while (true)
+class DataCacheWriter
+{
+public:
+    template <typename T>
+    void write(const T& value) { _buffer.append((const char *)&value, sizeof(T)); }
+    void writeString(const std::string& value)
+    {
+        write((uint32_t)value.size());
+        _buffer.append(value);
+    }
+
+    void writeBaseData(const BaseData& data)
+    {
+        write(data.x);
+        write(data.y);
+        write(data.zOrder);
+        write(data.skewX);
+        write(data.skewY);
+        write(data.scaleX);
+        write(data.scaleY);
+        write(data.tweenRotate);
+        write((uint8_t)data.isUseColorInfo);
+        write(data.a);
+        write(data.r);
+        write(data.g);
+        write(data.b);
+    }
+
+    void writeArmature(ArmatureData *armatureData)
+    {
+        writeString(armatureData->name);
+        write(armatureData->dataVersion);
+        write((uint32_t)armatureData->boneDataDic.size());
+        for (auto& element : armatureData->boneDataDic)
+        {
+            BoneData *boneData = element.second;
+            writeBaseData(*boneData);
+            writeString(boneData->name);
+            writeString(boneData->parentName);
+            const AffineTransform& transform = boneData->boneDataTransform;
+            write(transform.a);
+            write(transform.b);
+            write(transform.c);
+            write(transform.d);
+            write(transform.tx);
+            write(transform.ty);
+            write((uint32_t)boneData->displayDataList.size());
+            for (auto displayData : boneData->displayDataList)
+            {
+                write((uint8_t)displayData->displayType);
+                writeString(displayData->displayName);
+                if (displayData->displayType == CS_DISPLAY_SPRITE)
+                {
+                    writeBaseData(static_cast<SpriteDisplayData *>(displayData)->skinData);
+                }
+            }
+        }
+    }
+
+    void writeFrame(FrameData *frameData)
+    {
+        writeBaseData(*frameData);
+        write(frameData->frameID);
+        write(frameData->duration);
+        write(frameData->tweenEasing);
+        int easingParamNumber = frameData->easingParams ? frameData->easingParamNumber : 0;
+        write(easingParamNumber);
+        for (int i = 0; i < easingParamNumber; ++i)
+        {
+            write(frameData->easingParams[i]);
+        }
+        write((uint8_t)frameData->isTween);
+        write(frameData->displayIndex);
+        write(frameData->blendFunc);
+        writeString(frameData->strEvent);
+        writeString(frameData->strMovement);
+        writeString(frameData->strSound);
+        writeString(frameData->strSoundEffect);
+    }
+
+    void writeAnimation(AnimationData *animationData)
     {
-        std::queue<AsyncStruct *> *pQueue = _asyncStructQueue;
-        _asyncStructQueueMutex.lock(); // get async struct from queue
-        if (pQueue->empty())
+        writeString(animationData->name);
+        write((uint32_t)animationData->movementNames.size());
+        for (auto& movementName : animationData->movementNames)
         {
-            _asyncStructQueueMutex.unlock();
-            if (need_quit)
+            MovementData *movementData = animationData->movementDataDic.at(movementName);
+            writeString(movementData->name);
+            write(movementData->duration);
+            write(movementData->scale);
+            write(movementData->durationTo);
+            write(movementData->durationTween);
+            write((uint8_t)movementData->loop);
+            write(movementData->tweenEasing);
+            write((uint32_t)movementData->movBoneDataDic.size());
+            for (auto& element : movementData->movBoneDataDic)
             {
-                break;
+                MovementBoneData *movBoneData = element.second;
+                write(movBoneData->delay);
+                write(movBoneData->scale);
+                write(movBoneData->duration);
+                writeString(movBoneData->name);
+                write((uint32_t)movBoneData->frameList.size());
+                for (auto frameData : movBoneData->frameList)
+                {
+                    writeFrame(frameData);
+                }
             }
-            else
+        }
+    }
+
+    void writeTexture(TextureData *textureData)
+    {
+        write(textureData->height);
+        write(textureData->width);
+        write(textureData->pivotX);
+        write(textureData->pivotY);
+        writeString(textureData->name);
+        write((uint32_t)textureData->contourDataList.size());
+        for (auto contourData : textureData->contourDataList)
+        {
+            write((uint32_t)contourData->vertexList.size());
+            for (auto& vertex : contourData->vertexList)
             {
-				std::unique_lock<std::mutex> lk(_sleepMutex);
-				_sleepCondition.wait(lk);
-                continue;
+                write(vertex.x);
+                write(vertex.y);
             }
         }
-        else
+    }
+
+    const std::string& getBuffer() const { return _buffer; }
+
+private:
+    std::string _buffer;
+};
+
+class DataCacheReader
+{
+public:
+    DataCacheReader(const char *bytes, size_t size)
+    : _bytes(bytes)
+    , _size(size)
+    , _offset(0)
+    , _failed(false)
+    {
+    }
+
+    bool failed() const { return _failed; }
+    bool atEnd() const { return _offset == _size; }
+
+    template <typename T>
+    T read()
+    {
+        T value = T();
+        if (_failed || sizeof(T) > _size - _offset)
         {
-            pAsyncStruct = pQueue->front();
-            pQueue->pop();
-            _asyncStructQueueMutex.unlock();
+            _failed = true;
+            return value;
         }
+        memcpy(&value, _bytes + _offset, sizeof(T));
+        _offset += sizeof(T);
+        return value;
+    }
 
-        // generate data info
-        DataInfo *pDataInfo = new (std::nothrow) DataInfo();
-        pDataInfo->asyncStruct = pAsyncStruct;
-        pDataInfo->filename = pAsyncStruct->filename;
-        pDataInfo->baseFilePath = pAsyncStruct->baseFilePath;
+    std::string readString()
+    {
+        uint32_t size = read<uint32_t>();
+        if (_failed || size > _size - _offset)
+        {
+            _failed = true;
+            return std::string();
+        }
+        std::string value(_bytes + _offset, size);
+        _offset += size;
+        return value;
+    }
 
-        if (pAsyncStruct->configType == DragonBone_XML)
+    // each element takes at least a byte, so a damaged count doesn't allocate much
+    uint32_t readCount()
+    {
+        uint32_t count = read<uint32_t>();
+        if (_failed || count > _size - _offset)
         {
-            DataReaderHelper::addDataFromCache(pAsyncStruct->fileContent, pDataInfo);
+            _failed = true;
+            return 0;
+        }
+        return count;
+    }
+
+    void readBaseData(BaseData& data)
+    {
+        data.x = read<float>();
+        data.y = read<float>();
+        data.zOrder = read<int>();
+        data.skewX = read<float>();
+        data.skewY = read<float>();
+        data.scaleX = read<float>();
+        data.scaleY = read<float>();
+        data.tweenRotate = read<float>();
+        data.isUseColorInfo = read<uint8_t>() != 0;
+        data.a = read<int>();
+        data.r = read<int>();
+        data.g = read<int>();
+        data.b = read<int>();
+    }
+
+    ArmatureData *readArmature()
+    {
+        ArmatureData *armatureData = new (std::nothrow) ArmatureData();
+        armatureData->init();
+        armatureData->name = readString();
+        armatureData->dataVersion = read<float>();
+        uint32_t boneCount = readCount();
+        for (uint32_t i = 0; i < boneCount && !_failed; ++i)
+        {
+            BoneData *boneData = new (std::nothrow) BoneData();
+            boneData->init();
+            readBaseData(*boneData);
+            boneData->name = readString();
+            boneData->parentName = readString();
+            AffineTransform& transform = boneData->boneDataTransform;
+            transform.a = read<float>();
+            transform.b = read<float>();
+            transform.c = read<float>();
+            transform.d = read<float>();
+            transform.tx = read<float>();
+            transform.ty = read<float>();
+            uint32_t displayCount = readCount();
+            for (uint32_t j = 0; j < displayCount && !_failed; ++j)
+            {
+                DisplayData *displayData = nullptr;
+                DisplayType displayType = (DisplayType)read<uint8_t>();
+                switch (displayType)
+                {
+                case CS_DISPLAY_SPRITE:
+                    displayData = new (std::nothrow) SpriteDisplayData();
+                    break;
+                case CS_DISPLAY_ARMATURE:
+                    displayData = new (std::nothrow) ArmatureDisplayData();
+                    break;
+                case CS_DISPLAY_PARTICLE:
+                    displayData = new (std::nothrow) ParticleDisplayData();
+                    break;
+                default:
+                    _failed = true;
+                    continue;
+                }
+                displayData->displayName = readString();
+                if (displayType == CS_DISPLAY_SPRITE)
+                {
+                    readBaseData(static_cast<SpriteDisplayData *>(displayData)->skinData);
+                }
+                boneData->addDisplayData(displayData);
+                displayData->release();
+            }
+            armatureData->addBoneData(boneData);
+            boneData->release();
         }
-        else if(pAsyncStruct->configType == CocoStudio_JSON)
+        return armatureData;
+    }
+
+    FrameData *readFrame()
+    {
+        FrameData *frameData = new (std::nothrow) FrameData();
+        readBaseData(*frameData);
+        frameData->frameID = read<int>();
+        frameData->duration = read<int>();
+        frameData->tweenEasing = read<cocos2d::tweenfunc::TweenType>();
+        int easingParamNumber = read<int>();
+        if (easingParamNumber < 0 || easingParamNumber > (int)((_size - _offset) / sizeof(float)))
         {
-            DataReaderHelper::addDataFromJsonCache(pAsyncStruct->fileContent, pDataInfo);
+            _failed = true;
+            easingParamNumber = 0;
         }
-        else if(pAsyncStruct->configType == CocoStudio_Binary)
+        frameData->easingParamNumber = easingParamNumber;
+        if (easingParamNumber > 0)
         {
-            DataReaderHelper::addDataFromBinaryCache(pAsyncStruct->fileContent.c_str(),pDataInfo);
+            frameData->easingParams = new (std::nothrow) float[easingParamNumber];
+            for (int i = 0; i < easingParamNumber; ++i)
+            {
+                frameData->easingParams[i] = read<float>();
+            }
+        }
+        frameData->isTween = read<uint8_t>() != 0;
+        frameData->displayIndex = read<int>();
+        frameData->blendFunc = read<BlendFunc>();
+        frameData->strEvent = readString();
+        frameData->strMovement = readString();
+        frameData->strSound = readString();
+        frameData->strSoundEffect = readString();
+        return frameData;
+    }
+
+    AnimationData *readAnimation()
+    {
+        AnimationData *animationData = new (std::nothrow) AnimationData();
+        animationData->name = readString();
+        uint32_t movementCount = readCount();
+        for (uint32_t i = 0; i < movementCount && !_failed; ++i)
+        {
+            MovementData *movementData = new (std::nothrow) MovementData();
+            movementData->name = readString();
+            movementData->duration = read<int>();
+            movementData->scale = read<float>();
+            movementData->durationTo = read<int>();
+            movementData->durationTween = read<int>();
+            movementData->loop = read<uint8_t>() != 0;
+            movementData->tweenEasing = read<cocos2d::tweenfunc::TweenType>();
+            uint32_t movBoneCount = readCount();
+            for (uint32_t j = 0; j < movBoneCount && !_failed; ++j)
+            {
+                MovementBoneData *movBoneData = new (std::nothrow) MovementBoneData();
+                movBoneData->init();
+                movBoneData->delay = read<float>();
+                movBoneData->scale = read<float>();
+                movBoneData->duration = read<float>();
+                movBoneData->name = readString();
+                uint32_t frameCount = readCount();
+                for (uint32_t k = 0; k < frameCount && !_failed; ++k)
+                {
+                    FrameData *frameData = readFrame();
+                    movBoneData->addFrameData(frameData);
+                    frameData->release();
+                }
+                movementData->addMovementBoneData(movBoneData);
+                movBoneData->release();
+            }
+            animationData->addMovement(movementData);
+            movementData->release();
         }
+        return animationData;
+    }
 
-        // put the image info into the queue
-        _dataInfoMutex.lock();
-        _dataQueue->push(pDataInfo);
-        _dataInfoMutex.unlock();
+    TextureData *readTexture()
+    {
+        TextureData *textureData = new (std::nothrow) TextureData();
+        textureData->init();
+        textureData->height = read<float>();
+        textureData->width = read<float>();
+        textureData->pivotX = read<float>();
+        textureData->pivotY = read<float>();
+        textureData->name = readString();
+        uint32_t contourCount = readCount();
+        for (uint32_t i = 0; i < contourCount && !_failed; ++i)
+        {
+            ContourData *contourData = new (std::nothrow) ContourData();
+            contourData->init();
+            uint32_t vertexCount = readCount();
+            for (uint32_t j = 0; j < vertexCount && !_failed; ++j)
+            {
+                Vec2 vertex;
+                vertex.x = read<float>();
+                vertex.y = read<float>();
+                contourData->addVertex(vertex);
+            }
+            textureData->addContourData(contourData);
+            contourData->release();
+        }
+        return textureData;
     }
 
-    if( _asyncStructQueue != nullptr )
+private:
+    const char *_bytes;
+    size_t _size;
+    size_t _offset;
+    bool _failed;
+};
+
+static bool prepareDataCacheDirectory(const std::string& directory)
+{
+    if (s_dataCacheDirectoryReady)
+        return true;
+
+    auto fileUtils = FileUtils::getInstance();
+    if (!fileUtils->isDirectoryExist(directory) && !fileUtils->createDirectory(directory))
+    {
+        CCLOG("DataReaderHelper: can't write the data cache in %s", directory.c_str());
+        return false;
+    }
+    s_dataCacheDirectoryReady = true;
+    return true;
+}
+
+static std::string getDataCachePath(const std::string& directory, const std::string& fileContent, bool autoLoadSpriteFile)
+{
+    // the decoded positions are scaled, and the config file paths are only decoded to be loaded
+    uint64_t hash = hashDataCacheBytes(fileContent.data(), fileContent.size());
+    hash = hashDataCacheBytes(&s_PositionReadScale, sizeof(s_PositionReadScale), hash);
+    return StringUtils::format("%s%016llx%s.csad", directory.c_str(), (unsigned long long)hash, autoLoadSpriteFile ? "-sf" : "");
+}
+
+static void addSpriteFrameFromConfigFile(const std::string& baseFilePath, const std::string& configPath, const std::string& filename)
+{
+    std::string plistPath = baseFilePath + configPath + ".plist";
+    std::string pngPath = baseFilePath + configPath + ".png";
+    auto fileUtils = FileUtils::getInstance();
+    if (fileUtils->isFileExist(plistPath) && fileUtils->isFileExist(pngPath))
     {
-        delete _asyncStructQueue;
-        _asyncStructQueue = nullptr;
-        delete _dataQueue;
-        _dataQueue = nullptr;
+        ValueMap dict = fileUtils->getValueMapFromFile(plistPath);
+        if (dict.find("particleLifespan") != dict.end())
+            return;
+
+        ArmatureDataManager::getInstance()->addSpriteFrameFromFile(plistPath, pngPath, filename);
     }
 }
 
@@ -248,6 +618,50 @@ float DataReaderHelper::getPositionReadScale()
     return s_PositionReadScale;
 }
 
+void DataReaderHelper::setDataCacheEnabled(bool enabled)
+{
+    _dataCacheEnabled = enabled;
+}
+
+bool DataReaderHelper::isDataCacheEnabled()
+{
+    return _dataCacheEnabled;
+}
+
+void DataReaderHelper::setDataCacheDirectory(const std::string& directory)
+{
+    std::string path = directory;
+    if (!path.empty() && path.back() != '/')
+    {
+        path += '/';
+    }
+    if (_dataCacheDirectory != path)
+    {
+        _dataCacheDirectory = path;
+        s_dataCacheDirectoryReady = false;
+    }
+}
+
+std::string DataReaderHelper::getDataCacheDirectory()
+{
+    if (_dataCacheDirectory.empty())
+    {
+        _dataCacheDirectory = FileUtils::getInstance()->getWritablePath() + "armature_cache/";
+    }
+    return _dataCacheDirectory;
+}
+
+void DataReaderHelper::clearDataCache()
+{
+    std::string directory = getDataCacheDirectory();
+    auto fileUtils = FileUtils::getInstance();
+    if (fileUtils->isDirectoryExist(directory))
+    {
+        fileUtils->removeDirectory(directory);
+    }
+    s_dataCacheDirectoryReady = false;
+}
+
 
 void DataReaderHelper::purge()
 {
@@ -257,24 +671,14 @@ void DataReaderHelper::purge()
 
 
 DataReaderHelper::DataReaderHelper()
-	: _loadingThread(nullptr)
-	, _asyncRefCount(0)
+	: _asyncRefCount(0)
 	, _asyncRefTotalCount(0)
-	, need_quit(false)
-	, _asyncStructQueue(nullptr)
-	, _dataQueue(nullptr)
 {
 
 }
 
 DataReaderHelper::~DataReaderHelper()
 {
-    need_quit = true;
-
-	_sleepCondition.notify_one();
-	if (_loadingThread) _loadingThread->join();
-
-	CC_SAFE_DELETE(_loadingThread);
 	_dataReaderHelper = nullptr;
 }
 
@@ -312,23 +716,60 @@ void DataReaderHelper::addDataFromFile(const std::string& filePath)
     std::string fullPath = FileUtils::getInstance()->fullPathForFilename(filePath);
     bool isbinaryfilesrc = fileExtension == ".csb";
 
-    _dataReaderHelper->_getFileMutex.lock();
     std::string contentStr(readFileContent(fullPath, isbinaryfilesrc));
-    _dataReaderHelper->_getFileMutex.unlock();
 
     DataInfo dataInfo;
     dataInfo.filename = filePath;
     dataInfo.asyncStruct = nullptr;
     dataInfo.baseFilePath = basefilePath;
+
+    ConfigType configType;
     if (fileExtension == ".xml")
     {
-        DataReaderHelper::addDataFromCache(contentStr, &dataInfo);
+        configType = DragonBone_XML;
     }
     else if(fileExtension == ".json" || fileExtension == ".exportjson")
     {
-        DataReaderHelper::addDataFromJsonCache(contentStr, &dataInfo);
+        configType = CocoStudio_JSON;
     }
     else if(isbinaryfilesrc)
+    {
+        configType = CocoStudio_Binary;
+    }
+    else
+    {
+        return;
+    }
+
+    if (_dataCacheEnabled && prepareDataCacheDirectory(getDataCacheDirectory()))
+    {
+        // the datas are collected like an asynchronous load to be written in the cache, then added at once
+        AsyncStruct asyncStruct;
+        asyncStruct.filename = filePath;
+        asyncStruct.configType = configType;
+        asyncStruct.baseFilePath = basefilePath;
+        asyncStruct.target = nullptr;
+        asyncStruct.selector = nullptr;
+        asyncStruct.autoLoadSpriteFile = ArmatureDataManager::getInstance()->isAutoLoadSpriteFile();
+        dataInfo.asyncStruct = &asyncStruct;
+
+        decodeFile(contentStr, configType, &dataInfo);
+        for (auto& step : getAddDataSteps(&dataInfo))
+        {
+            step();
+        }
+        return;
+    }
+
+    if (configType == DragonBone_XML)
+    {
+        DataReaderHelper::addDataFromCache(contentStr, &dataInfo);
+    }
+    else if(configType == CocoStudio_JSON)
+    {
+        DataReaderHelper::addDataFromJsonCache(contentStr, &dataInfo);
+    }
+    else
     {
         DataReaderHelper::addDataFromBinaryCache(contentStr.c_str(),&dataInfo);
     }
@@ -372,24 +813,6 @@ void DataReaderHelper::addDataFromFileAsync(const std::string& imagePath, const
         basefilePath = "";
     }
 
-
-    // lazy init
-    if (_asyncStructQueue == nullptr)
-    {
-        _asyncStructQueue = new std::queue<AsyncStruct *>();
-        _dataQueue = new (std::nothrow) std::queue<DataInfo *>();
-
-		// create a new thread to load images
-		_loadingThread = new std::thread(&DataReaderHelper::loadData, this);
-
-        need_quit = false;
-    }
-
-    if (0 == _asyncRefCount)
-    {
-        Director::getInstance()->getScheduler()->schedule(CC_SCHEDULE_SELECTOR(DataReaderHelper::addDataAsyncCallBack), this, 0, false);
-    }
-
     ++_asyncRefCount;
     ++_asyncRefTotalCount;
 
@@ -399,7 +822,8 @@ void DataReaderHelper::addDataFromFileAsync(const std::string& imagePath, const
     }
 
     // generate async struct
-    AsyncStruct *data = new (std::nothrow) AsyncStruct();
+    auto load = std::make_shared<AsyncLoad>();
+    AsyncStruct *data = &load->asyncStruct;
     data->filename = filePath;
     data->baseFilePath = basefilePath;
     data->target = target;
@@ -414,12 +838,6 @@ void DataReaderHelper::addDataFromFileAsync(const std::string& imagePath, const
 
     bool isbinaryfilesrc = fileExtension == ".csb";
 
-    // This only read exportJson file, it takes only a little time.
-    // Large image files are loaded in DataReaderHelper::addDataFromJsonCache(dataInfo) asynchronously.
-    _dataReaderHelper->_getFileMutex.lock();
-    data->fileContent.assign(readFileContent(fullPath, isbinaryfilesrc));
-    _dataReaderHelper->_getFileMutex.unlock();
-
     if (fileExtension == ".xml")
     {
         data->configType = DragonBone_XML;
@@ -432,73 +850,334 @@ void DataReaderHelper::addDataFromFileAsync(const std::string& imagePath, const
     {
         data->configType = CocoStudio_Binary;
     }
+    else
+    {
+        asyncLoadFinished(data);
+        return;
+    }
 
+    DataInfo *dataInfo = &load->dataInfo;
+    dataInfo->asyncStruct = data;
+    dataInfo->filename = filePath;
+    dataInfo->baseFilePath = basefilePath;
 
-    // add async struct into queue
-    _asyncStructQueueMutex.lock();
-    _asyncStructQueue->push(data);
-    _asyncStructQueueMutex.unlock();
+    if (_dataCacheEnabled)
+    {
+        prepareDataCacheDirectory(getDataCacheDirectory());
+    }
 
-    _sleepCondition.notify_one();
+    // the file is read and decoded on a worker, each file by a job of its own
+    auto jobSystem = JobSystem::getInstance();
+    auto decodeJob = jobSystem->schedule([load, fullPath, isbinaryfilesrc]() {
+        std::string content = readFileContent(fullPath, isbinaryfilesrc);
+        DataReaderHelper::decodeFile(content, load->asyncStruct.configType, &load->dataInfo);
+    });
+    jobSystem->scheduleOnCocosThread([load]() {
+        if (_dataReaderHelper)
+        {
+            _dataReaderHelper->addDecodedDataAsync(load);
+        }
+        else if (load->asyncStruct.target)
+        {
+            load->asyncStruct.target->release();
+        }
+    }, { decodeJob });
 }
 
-void DataReaderHelper::addDataAsyncCallBack(float /*dt*/)
+void DataReaderHelper::addDecodedDataAsync(const std::shared_ptr<AsyncLoad>& load)
 {
-    // the data is generated in loading thread
-    std::queue<DataInfo *> *dataQueue = _dataQueue;
+    AsyncStruct *asyncStruct = &load->asyncStruct;
+    auto steps = getAddDataSteps(&load->dataInfo);
 
-    _dataInfoMutex.lock();
-    if (dataQueue->empty())
+    auto queue = TimeSlicedQueue::getInstance();
+    auto task = queue->addTask(steps, 0, [this, load](bool /*done*/) {
+        asyncLoadFinished(&load->asyncStruct);
+    });
+
+    // the textures of the sprite frames are loaded by the TextureCache before the frames are added
+    if (asyncStruct->imagePath != "" && asyncStruct->plistPath != "")
     {
-        _dataInfoMutex.unlock();
+        queue->waitForTexture(task, asyncStruct->imagePath);
     }
-    else
+    if (asyncStruct->autoLoadSpriteFile)
     {
-        DataInfo *pDataInfo = dataQueue->front();
-        dataQueue->pop();
-        _dataInfoMutex.unlock();
+        std::queue<std::string> configFileQueue = load->dataInfo.configFileQueue;
+        auto fileUtils = FileUtils::getInstance();
+        while (!configFileQueue.empty())
+        {
+            std::string pngPath = asyncStruct->baseFilePath + configFileQueue.front() + ".png";
+            if (fileUtils->isFileExist(pngPath))
+            {
+                queue->waitForTexture(task, pngPath);
+            }
+            configFileQueue.pop();
+        }
+    }
+}
+
+void DataReaderHelper::asyncLoadFinished(AsyncStruct *asyncStruct)
+{
+    Ref* target = asyncStruct->target;
+    SEL_SCHEDULE selector = asyncStruct->selector;
 
-        AsyncStruct *pAsyncStruct = pDataInfo->asyncStruct;
+    --_asyncRefCount;
+
+    if (target && selector)
+    {
+        (target->*selector)((_asyncRefTotalCount - _asyncRefCount) / (float)_asyncRefTotalCount);
+    }
+    CC_SAFE_RELEASE(target);
+
+    if (0 == _asyncRefCount)
+    {
+        _asyncRefTotalCount = 0;
+    }
+}
 
+std::vector<std::function<void()>> DataReaderHelper::getAddDataSteps(DataInfo *dataInfo)
+{
+    // one step per data or sprite frame file, the datas are retained by the dataInfo
+    std::vector<std::function<void()>> steps;
+    for (auto armatureData : dataInfo->armatureDatas)
+    {
+        steps.push_back([armatureData, dataInfo]() {
+            std::lock_guard<std::mutex> lock(_addDataMutex);
+            ArmatureDataManager::getInstance()->addArmatureData(armatureData->name, armatureData, dataInfo->filename);
+        });
+    }
+    for (auto animationData : dataInfo->animationDatas)
+    {
+        steps.push_back([animationData, dataInfo]() {
+            ArmatureDataManager::getInstance()->addAnimationData(animationData->name, animationData, dataInfo->filename);
+        });
+    }
+    for (auto textureData : dataInfo->textureDatas)
+    {
+        steps.push_back([textureData, dataInfo]() {
+            ArmatureDataManager::getInstance()->addTextureData(textureData->name, textureData, dataInfo->filename);
+        });
+    }
 
-        if (pAsyncStruct->imagePath != "" && pAsyncStruct->plistPath != "")
+    AsyncStruct *asyncStruct = dataInfo->asyncStruct;
+    if (asyncStruct->imagePath != "" && asyncStruct->plistPath != "")
+    {
+        steps.push_back([asyncStruct, dataInfo]() {
+            ArmatureDataManager::getInstance()->addSpriteFrameFromFile(asyncStruct->plistPath, asyncStruct->imagePath, dataInfo->filename);
+        });
+    }
+    if (asyncStruct->autoLoadSpriteFile)
+    {
+        std::queue<std::string> configFileQueue = dataInfo->configFileQueue;
+        while (!configFileQueue.empty())
         {
-            _getFileMutex.lock();
-            ArmatureDataManager::getInstance()->addSpriteFrameFromFile(pAsyncStruct->plistPath, pAsyncStruct->imagePath, pDataInfo->filename);
-            _getFileMutex.unlock();
+            std::string configPath = configFileQueue.front();
+            steps.push_back([configPath, dataInfo]() {
+                addSpriteFrameFromConfigFile(dataInfo->baseFilePath, configPath, dataInfo->filename);
+            });
+            configFileQueue.pop();
         }
+    }
+    return steps;
+}
 
-        while (!pDataInfo->configFileQueue.empty())
+void DataReaderHelper::decodeFile(const std::string& fileContent, ConfigType configType, DataInfo *dataInfo)
+{
+    std::string cachePath;
+    if (_dataCacheEnabled && s_dataCacheDirectoryReady)
+    {
+        cachePath = getDataCachePath(_dataCacheDirectory, fileContent, dataInfo->asyncStruct->autoLoadSpriteFile);
+        if (readDataCache(cachePath, dataInfo))
         {
-            std::string configPath = pDataInfo->configFileQueue.front();
-            _getFileMutex.lock();
-            ArmatureDataManager::getInstance()->addSpriteFrameFromFile((pAsyncStruct->baseFilePath + configPath + ".plist"), (pAsyncStruct->baseFilePath + configPath + ".png"), pDataInfo->filename);
-            _getFileMutex.unlock();
-            pDataInfo->configFileQueue.pop();
+            return;
         }
+    }
+
+    if (configType == DragonBone_XML)
+    {
+        DataReaderHelper::addDataFromCache(fileContent, dataInfo);
+    }
+    else if(configType == CocoStudio_JSON)
+    {
+        DataReaderHelper::addDataFromJsonCache(fileContent, dataInfo);
+    }
+    else if(configType == CocoStudio_Binary)
+    {
+        DataReaderHelper::addDataFromBinaryCache(fileContent.c_str(), dataInfo);
+    }
+
+    if (!cachePath.empty())
+    {
+        writeDataCache(cachePath, dataInfo);
+    }
+}
+
+bool DataReaderHelper::readDataCache(const std::string& cachePath, DataInfo *dataInfo)
+{
+    auto fileUtils = FileUtils::getInstance();
+    if (!fileUtils->isFileExist(cachePath))
+        return false;
+
+    std::string content;
+    fileUtils->getContents(cachePath, &content);
+
+    // the magic, the version, then the size and the hash of the datas, so a file being written isn't read
+    const size_t headerSize = sizeof(DATA_CACHE_MAGIC) + sizeof(uint32_t) + sizeof(uint32_t) + sizeof(uint64_t);
+    if (content.size() < headerSize || memcmp(content.data(), DATA_CACHE_MAGIC, sizeof(DATA_CACHE_MAGIC)) != 0)
+        return false;
+
+    DataCacheReader header(content.data() + sizeof(DATA_CACHE_MAGIC), headerSize - sizeof(DATA_CACHE_MAGIC));
+    uint32_t version = header.read<uint32_t>();
+    uint32_t size = header.read<uint32_t>();
+    uint64_t hash = header.read<uint64_t>();
+    const char *bytes = content.data() + headerSize;
+    if (version != DATA_CACHE_VERSION || size != content.size() - headerSize || hash != hashDataCacheBytes(bytes, size))
+        return false;
+
+    cocos2d::Vector<ArmatureData*> armatureDatas;
+    cocos2d::Vector<AnimationData*> animationDatas;
+    cocos2d::Vector<TextureData*> textureDatas;
+    std::queue<std::string> configFileQueue;
+
+    DataCacheReader reader(bytes, size);
+    uint32_t count = reader.readCount();
+    for (uint32_t i = 0; i < count && !reader.failed(); ++i)
+    {
+        ArmatureData *armatureData = reader.readArmature();
+        armatureDatas.pushBack(armatureData);
+        armatureData->release();
+    }
+    count = reader.readCount();
+    for (uint32_t i = 0; i < count && !reader.failed(); ++i)
+    {
+        AnimationData *animationData = reader.readAnimation();
+        animationDatas.pushBack(animationData);
+        animationData->release();
+    }
+    count = reader.readCount();
+    for (uint32_t i = 0; i < count && !reader.failed(); ++i)
+    {
+        TextureData *textureData = reader.readTexture();
+        textureDatas.pushBack(textureData);
+        textureData->release();
+    }
+    count = reader.readCount();
+    for (uint32_t i = 0; i < count && !reader.failed(); ++i)
+    {
+        configFileQueue.push(reader.readString());
+    }
 
+    if (reader.failed() || !reader.atEnd())
+    {
+        CCLOG("DataReaderHelper: the data cache %s is damaged", cachePath.c_str());
+        return false;
+    }
 
-        Ref* target = pAsyncStruct->target;
-        SEL_SCHEDULE selector = pAsyncStruct->selector;
+    dataInfo->armatureDatas = std::move(armatureDatas);
+    dataInfo->animationDatas = std::move(animationDatas);
+    dataInfo->textureDatas = std::move(textureDatas);
+    dataInfo->configFileQueue = std::move(configFileQueue);
+    return true;
+}
 
-        --_asyncRefCount;
+bool DataReaderHelper::writeDataCache(const std::string& cachePath, DataInfo *dataInfo)
+{
+    DataCacheWriter writer;
+    writer.write((uint32_t)dataInfo->armatureDatas.size());
+    for (auto armatureData : dataInfo->armatureDatas)
+    {
+        writer.writeArmature(armatureData);
+    }
+    writer.write((uint32_t)dataInfo->animationDatas.size());
+    for (auto animationData : dataInfo->animationDatas)
+    {
+        writer.writeAnimation(animationData);
+    }
+    writer.write((uint32_t)dataInfo->textureDatas.size());
+    for (auto textureData : dataInfo->textureDatas)
+    {
+        writer.writeTexture(textureData);
+    }
+    std::queue<std::string> configFileQueue = dataInfo->configFileQueue;
+    writer.write((uint32_t)configFileQueue.size());
+    while (!configFileQueue.empty())
+    {
+        writer.writeString(configFileQueue.front());
+        configFileQueue.pop();
+    }
 
-        if (target && selector)
-        {
-            (target->*selector)((_asyncRefTotalCount - _asyncRefCount) / (float)_asyncRefTotalCount);
-            target->release();
-        }
+    const std::string& datas = writer.getBuffer();
+    DataCacheWriter header;
+    header.write(DATA_CACHE_MAGIC);
+    header.write(DATA_CACHE_VERSION);
+    header.write((uint32_t)datas.size());
+    header.write(hashDataCacheBytes(datas.data(), datas.size()));
+
+    if (!FileUtils::getInstance()->writeStringToFile(header.getBuffer() + datas, cachePath))
+    {
+        CCLOG("DataReaderHelper: can't write the data cache %s", cachePath.c_str());
+        return false;
+    }
+    return true;
+}
+
+void DataReaderHelper::addArmatureData(ArmatureData *armatureData, DataInfo *dataInfo)
+{
+    if (dataInfo->asyncStruct)
+    {
+        dataInfo->armatureDatas.pushBack(armatureData);
+    }
+    else
+    {
+        ArmatureDataManager::getInstance()->addArmatureData(armatureData->name, armatureData, dataInfo->filename);
+    }
+    armatureData->release();
+}
 
+void DataReaderHelper::addAnimationData(AnimationData *animationData, DataInfo *dataInfo)
+{
+    if (dataInfo->asyncStruct)
+    {
+        dataInfo->animationDatas.pushBack(animationData);
+    }
+    else
+    {
+        ArmatureDataManager::getInstance()->addAnimationData(animationData->name, animationData, dataInfo->filename);
+    }
+    animationData->release();
+}
 
-        delete pAsyncStruct;
-        delete pDataInfo;
+void DataReaderHelper::addTextureData(TextureData *textureData, DataInfo *dataInfo)
+{
+    if (dataInfo->asyncStruct)
+    {
+        dataInfo->textureDatas.pushBack(textureData);
+    }
+    else
+    {
+        ArmatureDataManager::getInstance()->addTextureData(textureData->name, textureData, dataInfo->filename);
+    }
+    textureData->release();
+}
 
-        if (0 == _asyncRefCount)
+ArmatureData *DataReaderHelper::getArmatureData(const std::string& name, DataInfo *dataInfo)
+{
+    if (dataInfo->asyncStruct)
+    {
+        for (auto armatureData : dataInfo->armatureDatas)
         {
-            _asyncRefTotalCount = 0;
-            Director::getInstance()->getScheduler()->unschedule(CC_SCHEDULE_SELECTOR(DataReaderHelper::addDataAsyncCallBack), this);
+            if (armatureData->name == name)
+            {
+                return armatureData;
+            }
         }
+        std::lock_guard<std::mutex> lock(_addDataMutex);
+        return ArmatureDataManager::getInstance()->getArmatureData(name);
     }
+    return ArmatureDataManager::getInstance()->getArmatureData(name);
+}
+
+void DataReaderHelper::addDataAsyncCallBack(float /*dt*/)
+{
 }
 
 
@@ -536,16 +1215,7 @@ void DataReaderHelper::addDataFromCache(const std::string& pFileContent, DataInf
     {
         ArmatureData *armatureData = DataReaderHelper::decodeArmature(armatureXML, dataInfo);
 
-        if (dataInfo->asyncStruct)
-        {
-            _dataReaderHelper->_addDataMutex.lock();
-        }
-        ArmatureDataManager::getInstance()->addArmatureData(armatureData->name, armatureData, dataInfo->filename);
-        armatureData->release();
-        if (dataInfo->asyncStruct)
-        {
-            _dataReaderHelper->_addDataMutex.unlock();
-        }
+        addArmatureData(armatureData, dataInfo);
 
         armatureXML = armatureXML->NextSiblingElement(ARMATURE);
     }
@@ -559,16 +1229,7 @@ void DataReaderHelper::addDataFromCache(const std::string& pFileContent, DataInf
     while(animationXML)
     {
         AnimationData *animationData = DataReaderHelper::decodeAnimation(animationXML, dataInfo);
-        if (dataInfo->asyncStruct)
-        {
-            _dataReaderHelper->_addDataMutex.lock();
-        }
-        ArmatureDataManager::getInstance()->addAnimationData(animationData->name, animationData, dataInfo->filename);
-        animationData->release();
-        if (dataInfo->asyncStruct)
-        {
-            _dataReaderHelper->_addDataMutex.unlock();
-        }
+        addAnimationData(animationData, dataInfo);
         animationXML = animationXML->NextSiblingElement(ANIMATION);
     }
 
@@ -582,16 +1243,7 @@ void DataReaderHelper::addDataFromCache(const std::string& pFileContent, DataInf
     {
         TextureData *textureData = DataReaderHelper::decodeTexture(textureXML, dataInfo);
 
-        if (dataInfo->asyncStruct)
-        {
-            _dataReaderHelper->_addDataMutex.lock();
-        }
-        ArmatureDataManager::getInstance()->addTextureData(textureData->name, textureData, dataInfo->filename);
-        textureData->release();
-        if (dataInfo->asyncStruct)
-        {
-            _dataReaderHelper->_addDataMutex.unlock();
-        }
+        addTextureData(textureData, dataInfo);
         textureXML = textureXML->NextSiblingElement(SUB_TEXTURE);
     }
 }
@@ -714,7 +1366,7 @@ AnimationData *DataReaderHelper::decodeAnimation(tinyxml2::XMLElement *animation
 
     const char	*name = animationXML->Attribute(A_NAME);
 
-    ArmatureData *armatureData = ArmatureDataManager::getInstance()->getArmatureData(name);
+    ArmatureData *armatureData = getArmatureData(name, dataInfo);
 
     aniData->name = name;
 
@@ -1239,16 +1891,7 @@ void DataReaderHelper::addDataFromJsonCache(const std::string& fileContent, Data
 		const rapidjson::Value &armatureDic = DICTOOL->getSubDictionary_json(json, ARMATURE_DATA, i);
         ArmatureData *armatureData = decodeArmature(armatureDic, dataInfo);
 
-        if (dataInfo->asyncStruct)
-        {
-            _dataReaderHelper->_addDataMutex.lock();
-        }
-        ArmatureDataManager::getInstance()->addArmatureData(armatureData->name, armatureData, dataInfo->filename);
-        armatureData->release();
-        if (dataInfo->asyncStruct)
-        {
-            _dataReaderHelper->_addDataMutex.unlock();
-        }
+        addArmatureData(armatureData, dataInfo);
     }
 
     // Decode animations
@@ -1258,16 +1901,7 @@ void DataReaderHelper::addDataFromJsonCache(const std::string& fileContent, Data
 		const rapidjson::Value &animationDic = DICTOOL->getSubDictionary_json(json, ANIMATION_DATA, i);
         AnimationData *animationData = decodeAnimation(animationDic, dataInfo);
 
-        if (dataInfo->asyncStruct)
-        {
-            _dataReaderHelper->_addDataMutex.lock();
-        }
-        ArmatureDataManager::getInstance()->addAnimationData(animationData->name, animationData, dataInfo->filename);
-        animationData->release();
-        if (dataInfo->asyncStruct)
-        {
-            _dataReaderHelper->_addDataMutex.unlock();
-        }
+        addAnimationData(animationData, dataInfo);
     }
 
     // Decode textures
@@ -1277,16 +1911,7 @@ void DataReaderHelper::addDataFromJsonCache(const std::string& fileContent, Data
         const rapidjson::Value &textureDic =  DICTOOL->getSubDictionary_json(json, TEXTURE_DATA, i);
         TextureData *textureData = decodeTexture(textureDic);
 
-        if (dataInfo->asyncStruct)
-        {
-            _dataReaderHelper->_addDataMutex.lock();
-        }
-        ArmatureDataManager::getInstance()->addTextureData(textureData->name, textureData, dataInfo->filename);
-        textureData->release();
-        if (dataInfo->asyncStruct)
-        {
-            _dataReaderHelper->_addDataMutex.unlock();
-        }
+        addTextureData(textureData, dataInfo);
     }
 
     // Auto load sprite file
@@ -1768,16 +2393,7 @@ void DataReaderHelper::decodeNode(BaseData *node, const rapidjson::Value& json,
                         for (int ii = 0; ii < length; ++ii)
                         {
                             armatureData = decodeArmature(&tCocoLoader, &pDataArray[ii], dataInfo);
-                            if (dataInfo->asyncStruct)
-                            {
-                                _dataReaderHelper->_addDataMutex.lock();
-                            }
-                            ArmatureDataManager::getInstance()->addArmatureData(armatureData->name, armatureData, dataInfo->filename);
-                            armatureData->release();
-                            if (dataInfo->asyncStruct)
-                            {
-                                _dataReaderHelper->_addDataMutex.unlock();
-                            }
+                            addArmatureData(armatureData, dataInfo);
                         }
                     }
                     else if ( 0 == key.compare(ANIMATION_DATA))
@@ -1788,16 +2404,7 @@ void DataReaderHelper::decodeNode(BaseData *node, const rapidjson::Value& json,
                         for (int ii = 0; ii < length; ++ii)
                         {
                             animationData = decodeAnimation(&tCocoLoader, &pDataArray[ii], dataInfo);
-                            if (dataInfo->asyncStruct)
-                            {
-                                _dataReaderHelper->_addDataMutex.lock();
-                            }
-                            ArmatureDataManager::getInstance()->addAnimationData(animationData->name, animationData, dataInfo->filename);
-                            animationData->release();
-                            if (dataInfo->asyncStruct)
-                            {
-                                _dataReaderHelper->_addDataMutex.unlock();
-                            }
+                            addAnimationData(animationData, dataInfo);
                         }
                     }
                     else if (key.compare(TEXTURE_DATA) == 0)
@@ -1807,16 +2414,7 @@ void DataReaderHelper::decodeNode(BaseData *node, const rapidjson::Value& json,
                         for (int ii = 0; ii < length; ++ii)
                         {
                             TextureData *textureData = decodeTexture(&tCocoLoader, &pDataArray[ii]);
-                            if (dataInfo->asyncStruct)
-                            {
-                                _dataReaderHelper->_addDataMutex.lock();
-                            }
-                            ArmatureDataManager::getInstance()->addTextureData(textureData->name, textureData, dataInfo->filename);
-                            textureData->release();
-                            if (dataInfo->asyncStruct)
-                            {
-                                _dataReaderHelper->_addDataMutex.unlock();
-                            }
+                            addTextureData(textureData, dataInfo);
                         }
                     }
                 }
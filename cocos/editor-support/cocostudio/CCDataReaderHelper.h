@@ -33,11 +33,11 @@ THE SOFTWARE.
 
 #include "json/document-wrapper.h"
 
+#include <functional>
 #include <string>
 #include <queue>
+#include <memory>
 #include <mutex>
-#include <thread>
-#include <condition_variable>
 
 namespace tinyxml2
 {
@@ -85,8 +85,19 @@ protected:
         std::string    baseFilePath;
         float flashToolVersion;
         float cocoStudioVersion;
+
+        // with an asyncStruct the decoded datas wait here, they are added to the ArmatureDataManager on the cocos thread
+        cocos2d::Vector<ArmatureData*> armatureDatas;
+        cocos2d::Vector<AnimationData*> animationDatas;
+        cocos2d::Vector<TextureData*> textureDatas;
     } DataInfo;
 
+    struct AsyncLoad
+    {
+        AsyncStruct asyncStruct;
+        DataInfo dataInfo;
+    };
+
 public:
 
     /** @deprecated Use getInstance() instead */
@@ -101,6 +112,28 @@ public:
     static void setPositionReadScale(float scale);
     static float getPositionReadScale();
 
+    /**
+     * Keeps a compact binary copy of the datas decoded from each file, the next loads of a file that
+     * didn't change read the copy instead of parsing the file again. Disabled by default.
+     * The copies depend on the position read scale, they are kept apart for each scale.
+     * @since v3.14
+     */
+    static void setDataCacheEnabled(bool enabled);
+    static bool isDataCacheEnabled();
+
+    /**
+     * Sets the directory of the cache, the writable path followed by "armature_cache/" by default.
+     * @since v3.14
+     */
+    static void setDataCacheDirectory(const std::string& directory);
+    static std::string getDataCacheDirectory();
+
+    /**
+     * Removes the files of the cache.
+     * @since v3.14
+     */
+    static void clearDataCache();
+
     static void purge();
 public:
     /**
@@ -114,9 +147,15 @@ public:
     ~DataReaderHelper();
 
     void addDataFromFile(const std::string& filePath);
+    /**
+     * Decodes a file on a thread of the JobSystem, several files are decoded at the same time.
+     * The datas and the sprite frames are then added on the cocos thread by a task of the TimeSlicedQueue,
+     * so adding them doesn't take more than the frame budget.
+     */
     void addDataFromFileAsync(const std::string& imagePath, const std::string& plistPath, const std::string& filePath, cocos2d::Ref *target, cocos2d::SEL_SCHEDULE selector);
 
-    void addDataAsyncCallBack(float dt);
+    /** @deprecated The decoded datas are added by a task of the TimeSlicedQueue, this does nothing. */
+    CC_DEPRECATED_ATTRIBUTE void addDataAsyncCallBack(float dt);
 
     void removeConfigFile(const std::string& configFile);
 public:
@@ -194,34 +233,35 @@ public:
     static void decodeNode(BaseData *node, CocoLoader *cocoLoader, stExpCocoNode *pCocoNode, DataInfo *dataInfo);
     
 protected:
-    void loadData();
+    /** Decodes a file, from the cache when it has a copy of its datas. */
+    static void decodeFile(const std::string& fileContent, ConfigType configType, DataInfo *dataInfo);
 
+    /** Adds a decoded data to the ArmatureDataManager, or to the dataInfo decoding a file asynchronously, and releases it. */
+    static void addArmatureData(ArmatureData *armatureData, DataInfo *dataInfo);
+    static void addAnimationData(AnimationData *animationData, DataInfo *dataInfo);
+    static void addTextureData(TextureData *textureData, DataInfo *dataInfo);
 
+    /** Returns an armature data decoded from the same file, or one already added to the ArmatureDataManager. */
+    static ArmatureData *getArmatureData(const std::string& name, DataInfo *dataInfo);
 
+    /** The functions adding the datas decoded asynchronously to the ArmatureDataManager, in order. */
+    static std::vector<std::function<void()>> getAddDataSteps(DataInfo *dataInfo);
 
-    std::condition_variable        _sleepCondition;
+    static bool readDataCache(const std::string& cachePath, DataInfo *dataInfo);
+    static bool writeDataCache(const std::string& cachePath, DataInfo *dataInfo);
 
-    std::thread     *_loadingThread;
+    void addDecodedDataAsync(const std::shared_ptr<AsyncLoad>& load);
+    void asyncLoadFinished(AsyncStruct *asyncStruct);
 
-    std::mutex      _sleepMutex;
+    // the armature datas are added on the cocos thread while the workers look for them
+    static std::mutex _addDataMutex;
 
-    std::mutex      _asyncStructQueueMutex;
-    std::mutex      _dataInfoMutex;
-
-    std::mutex      _addDataMutex;
-
-    std::mutex      _getFileMutex;
-
-      
     unsigned long _asyncRefCount;
     unsigned long _asyncRefTotalCount;
 
-    bool need_quit;
-
-    std::queue<AsyncStruct *> *_asyncStructQueue;
-    std::queue<DataInfo *>   *_dataQueue;
-
     static std::vector<std::string> _configFileList;
+    static bool _dataCacheEnabled;
+    static std::string _dataCacheDirectory;
 
     static DataReaderHelper *_dataReaderHelper;
 };
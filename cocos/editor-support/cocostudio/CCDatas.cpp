@@ -351,6 +351,18 @@ MovementBoneData *MovementData::getMovementBoneData(const std::string& boneName)
 
 
 
+BakedMovementData::BakedMovementData(void)
+    : name("")
+    , frameCount(0)
+{
+}
+
+BakedMovementData::~BakedMovementData(void)
+{
+}
+
+
+
 AnimationData::AnimationData(void)
 {
 }
@@ -30,6 +30,7 @@ THE SOFTWARE.
 #include "base/CCVector.h"
 #include "base/CCMap.h"
 #include "math/CCAffineTransform.h"
+#include "math/Mat4.h"
 
 #include "editor-support/cocostudio/CCArmatureDefine.h"
 #include "2d/CCTweenFunction.h"
@@ -449,6 +450,63 @@ public:
 };
 
 
+/**
+*  BakedBoneFrame is the state of a bone at one frame of a baked movement
+*  @js NA
+*  @lua NA
+*/
+struct BakedBoneFrame
+{
+    cocos2d::Mat4 transform;    //! the bone's node to armature transform
+    float x;                    //! the bone's world info, child armatures are placed with it
+    float y;
+    float scaleX;
+    float scaleY;
+    float skewX;
+    float skewY;
+    int a, r, g, b;
+    int zOrder;
+    int displayIndex;
+    cocos2d::BlendFunc blendFunc;
+};
+
+/**
+*  BakedMovementData is a movement sampled once per frame, shared by the armatures playing it in baked mode
+*  @js NA
+*  @lua NA
+*/
+class CC_STUDIO_DLL BakedMovementData : public cocos2d::Ref
+{
+public:
+    CC_CREATE_NO_PARAM_NO_INIT(BakedMovementData)
+public:
+    struct FrameEvent
+    {
+        int frameIndex;
+        int boneIndex;
+        std::string name;
+    };
+
+    /**
+     * @js ctor
+     */
+    BakedMovementData(void);
+    /**
+     * @js NA
+     * @lua NA
+     */
+    ~BakedMovementData(void);
+
+    const BakedBoneFrame& getBoneFrame(int frameIndex, int boneIndex) const { return boneFrames[frameIndex * boneNames.size() + boneIndex]; }
+public:
+    std::string name;
+    int frameCount;                             //! the frames sampled, one per frame of the movement
+    std::vector<std::string> boneNames;         //! the bones animated by the movement
+    std::vector<BakedBoneFrame> boneFrames;     //! frameCount * boneNames.size() bone frames, a frame after the other
+    std::vector<FrameEvent> frameEvents;        //! sorted by frame index
+};
+
+
 /**
 *  AnimationData include all movement information for the Armature
 *  The struct is AnimationData -> MovementData -> MovementBoneData -> FrameData
@@ -31,7 +31,9 @@
 #include <spine/SkeletonAnimation.h>
 #include <spine/spine-cocos2dx.h>
 #include <spine/extension.h>
+#include <spine/AttachmentVertices.h>
 #include <algorithm>
+#include <cfloat>
 
 USING_NS_CC;
 using std::min;
@@ -59,6 +61,13 @@ void trackEntryCallback (spAnimationState* state, spEventType type, spTrackEntry
         if (entry->rendererObject) delete (spine::_TrackEntryListeners*)entry->rendererObject;
 }
 
+static bool parallelUpdateEnabled = false;
+static Vector<SkeletonAnimation*> parallelUpdateQueue;
+static unsigned int parallelUpdateFrame = 0;
+static EventListenerCustom* parallelUpdateListener = nullptr;
+
+static std::unordered_map<std::string, BakedAnimation*> bakedAnimations;
+
 static _TrackEntryListeners* getListeners (spTrackEntry* entry) {
 	if (!entry->rendererObject) {
 		entry->rendererObject = new spine::_TrackEntryListeners();
@@ -69,6 +78,16 @@ static _TrackEntryListeners* getListeners (spTrackEntry* entry) {
     
 //
 
+BakedAnimation::BakedAnimation ()
+	: frameRate(0), duration(0) {
+}
+
+BakedAnimation::~BakedAnimation () {
+	if (!_key.empty()) bakedAnimations.erase(_key);
+}
+
+//
+
 SkeletonAnimation* SkeletonAnimation::createWithData (spSkeletonData* skeletonData, bool ownsSkeletonData) {
 	SkeletonAnimation* node = new SkeletonAnimation();
 	node->initWithData(skeletonData, ownsSkeletonData);
@@ -85,8 +104,7 @@ SkeletonAnimation* SkeletonAnimation::createWithJsonFile (const std::string& ske
 
 SkeletonAnimation* SkeletonAnimation::createWithJsonFile (const std::string& skeletonJsonFile, const std::string& atlasFile, float scale) {
 	SkeletonAnimation* node = new SkeletonAnimation();
-	spAtlas* atlas = spAtlas_createFromFile(atlasFile.c_str(), 0);
-	node->initWithJsonFile(skeletonJsonFile, atlas, scale);
+	node->initWithJsonFile(skeletonJsonFile, atlasFile, scale);
 	node->autorelease();
 	return node;
 }
@@ -100,8 +118,7 @@ SkeletonAnimation* SkeletonAnimation::createWithBinaryFile (const std::string& s
 
 SkeletonAnimation* SkeletonAnimation::createWithBinaryFile (const std::string& skeletonBinaryFile, const std::string& atlasFile, float scale) {
 	SkeletonAnimation* node = new SkeletonAnimation();
-	spAtlas* atlas = spAtlas_createFromFile(atlasFile.c_str(), 0);
-	node->initWithBinaryFile(skeletonBinaryFile, atlas, scale);
+	node->initWithBinaryFile(skeletonBinaryFile, atlasFile, scale);
 	node->autorelease();
 	return node;
 }
@@ -117,10 +134,11 @@ void SkeletonAnimation::initialize () {
 }
 
 SkeletonAnimation::SkeletonAnimation ()
-		: SkeletonRenderer() {
+		: SkeletonRenderer(), _parallelUpdateTime(-1), _bakedAnimation(nullptr), _bakedTime(0), _bakedLoop(false) {
 }
 
 SkeletonAnimation::~SkeletonAnimation () {
+	CC_SAFE_RELEASE(_bakedAnimation);
 	if (_ownsAnimationStateData) spAnimationStateData_dispose(_state->data);
 	spAnimationState_dispose(_state);
 }
@@ -129,11 +147,90 @@ void SkeletonAnimation::update (float deltaTime) {
 	super::update(deltaTime);
 
 	deltaTime *= _timeScale;
+	if (_bakedAnimation) {
+		_bakedTime += deltaTime;
+		return;
+	}
+	if (parallelUpdateEnabled && isVisible()) {
+		queueParallelUpdate(deltaTime);
+		return;
+	}
 	spAnimationState_update(_state, deltaTime);
 	spAnimationState_apply(_state, _skeleton);
 	spSkeleton_updateWorldTransform(_skeleton);
 }
 
+void SkeletonAnimation::setParallelUpdateEnabled (bool enabled) {
+	if (parallelUpdateEnabled == enabled) return;
+
+	parallelUpdateEnabled = enabled;
+	if (!enabled) {
+		runParallelUpdate();
+		if (parallelUpdateListener) {
+			Director::getInstance()->getEventDispatcher()->removeEventListener(parallelUpdateListener);
+			CC_SAFE_RELEASE_NULL(parallelUpdateListener);
+		}
+	}
+}
+
+bool SkeletonAnimation::isParallelUpdateEnabled () {
+	return parallelUpdateEnabled;
+}
+
+void SkeletonAnimation::queueParallelUpdate (float deltaTime) {
+	Director* director = Director::getInstance();
+
+	// The queue is emptied after the update of every frame, unless the listener was removed with all the others.
+	if (!parallelUpdateQueue.empty() && parallelUpdateFrame != director->getTotalFrames()) {
+		runParallelUpdate();
+		director->getEventDispatcher()->removeEventListener(parallelUpdateListener);
+		CC_SAFE_RELEASE_NULL(parallelUpdateListener);
+	}
+	if (!parallelUpdateListener) {
+		parallelUpdateListener = director->getEventDispatcher()->addCustomEventListener(Director::EVENT_AFTER_UPDATE, [](EventCustom*) {
+			runParallelUpdate();
+		});
+		parallelUpdateListener->retain();
+	}
+	parallelUpdateFrame = director->getTotalFrames();
+
+	if (_parallelUpdateTime >= 0) {
+		// Updated twice in a frame, apply both steps at once.
+		_parallelUpdateTime += deltaTime;
+		return;
+	}
+	_parallelUpdateTime = deltaTime;
+	parallelUpdateQueue.pushBack(this);
+}
+
+void SkeletonAnimation::runParallelUpdate () {
+	if (parallelUpdateQueue.empty()) return;
+
+	// The skeletons stay retained by the queue until they are updated.
+	Vector<SkeletonAnimation*> skeletons;
+	std::swap(skeletons, parallelUpdateQueue);
+
+	// Events are queued on the workers and their listeners called here, the track entries are only disposed by the drain.
+	for (SkeletonAnimation* skeleton : skeletons)
+		SUB_CAST(_spAnimationState, skeleton->_state)->queue->drainDisabled = 1;
+
+	JobSystem::getInstance()->parallelFor(skeletons.size(), 1, [&skeletons](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; ++i) {
+			SkeletonAnimation* skeleton = skeletons.at(i);
+			spAnimationState_update(skeleton->_state, skeleton->_parallelUpdateTime);
+			spAnimationState_apply(skeleton->_state, skeleton->_skeleton);
+			spSkeleton_updateWorldTransform(skeleton->_skeleton);
+		}
+	});
+
+	for (SkeletonAnimation* skeleton : skeletons) {
+		skeleton->_parallelUpdateTime = -1;
+		_spEventQueue* queue = SUB_CAST(_spAnimationState, skeleton->_state)->queue;
+		queue->drainDisabled = 0;
+		_spEventQueue_drain(queue);
+	}
+}
+
 void SkeletonAnimation::setAnimationStateData (spAnimationStateData* stateData) {
 	CCASSERT(stateData, "stateData cannot be null.");
 
@@ -151,6 +248,7 @@ void SkeletonAnimation::setMix (const std::string& fromAnimation, const std::str
 }
 
 spTrackEntry* SkeletonAnimation::setAnimation (int trackIndex, const std::string& name, bool loop) {
+	clearBakedAnimation();
 	spAnimation* animation = spSkeletonData_findAnimation(_skeleton->data, name.c_str());
 	if (!animation) {
 		log("Spine: Animation not found: %s", name.c_str());
@@ -189,9 +287,245 @@ spTrackEntry* SkeletonAnimation::getCurrent (int trackIndex) {
 }
 
 void SkeletonAnimation::clearTracks () {
+	clearBakedAnimation();
 	spAnimationState_clearTracks(_state);
 }
 
+bool SkeletonAnimation::setBakedAnimation (const std::string& name, bool loop, float frameRate) {
+	CCASSERT(frameRate > 0, "frameRate must be positive.");
+
+	spAnimation* animation = spSkeletonData_findAnimation(_skeleton->data, name.c_str());
+	if (!animation) {
+		log("Spine: Animation not found: %s", name.c_str());
+		return false;
+	}
+	if (isTwoColorTint() || _effect) return false;
+
+	std::string key = StringUtils::format("%p %p %p %g %d %d %d", _skeleton->data, animation, _skeleton->skin, frameRate, _premultipliedAlpha, _skeleton->flipX, _skeleton->flipY);
+	BakedAnimation* bakedAnimation;
+	auto it = bakedAnimations.find(key);
+	if (it != bakedAnimations.end()) {
+		bakedAnimation = it->second;
+		bakedAnimation->retain();
+	} else {
+		bakedAnimation = bakeAnimation(animation, frameRate);
+		bakedAnimation->_key = key;
+		bakedAnimations[key] = bakedAnimation;
+	}
+
+	CC_SAFE_RELEASE(_bakedAnimation);
+	_bakedAnimation = bakedAnimation;
+	_bakedTime = 0;
+	_bakedLoop = loop;
+	return true;
+}
+
+void SkeletonAnimation::clearBakedAnimation () {
+	CC_SAFE_RELEASE_NULL(_bakedAnimation);
+}
+
+bool SkeletonAnimation::isPlayingBakedAnimation () const {
+	return _bakedAnimation != nullptr;
+}
+
+BakedAnimation* SkeletonAnimation::bakeAnimation (spAnimation* animation, float frameRate) {
+	BakedAnimation* bakedAnimation = new BakedAnimation();
+	bakedAnimation->frameRate = frameRate;
+	bakedAnimation->duration = animation->duration;
+
+	// Poses a skeleton of its own, this one keeps playing its animation state when the baked animation is cleared.
+	spSkeleton* skeleton = spSkeleton_create(_skeleton->data);
+	spSkeleton_setSkin(skeleton, _skeleton->skin);
+	skeleton->flipX = _skeleton->flipX;
+	skeleton->flipY = _skeleton->flipY;
+	spSkeletonClipping* clipper = spSkeletonClipping_create();
+
+	int framesCount = (int)(animation->duration * frameRate) + 1;
+	bakedAnimation->frames.resize(framesCount);
+	for (int f = 0; f < framesCount; ++f) {
+		float time = min(f / frameRate, animation->duration);
+		spSkeleton_setToSetupPose(skeleton);
+		spAnimation_apply(animation, skeleton, time, time, 0, 0, 0, 1, SP_MIX_POSE_SETUP, SP_MIX_DIRECTION_IN);
+		spSkeleton_updateWorldTransform(skeleton);
+
+		BakedAnimation::Frame& frame = bakedAnimation->frames[f];
+		frame.firstMesh = (uint32_t)bakedAnimation->meshes.size();
+		frame.minX = frame.minY = FLT_MAX;
+		frame.maxX = frame.maxY = -FLT_MAX;
+		for (int i = 0, n = skeleton->slotsCount; i < n; ++i) {
+			spSlot* slot = skeleton->drawOrder[i];
+			if (!slot->attachment) {
+				spSkeletonClipping_clipEnd(clipper, slot);
+				continue;
+			}
+
+			std::vector<V3F_C4B_T2F>& vertices = bakedAnimation->vertices;
+			uint32_t firstVertex = (uint32_t)vertices.size();
+			AttachmentVertices* attachmentVertices = nullptr;
+			spColor* attachmentColor = nullptr;
+			switch (slot->attachment->type) {
+			case SP_ATTACHMENT_REGION: {
+				spRegionAttachment* attachment = (spRegionAttachment*)slot->attachment;
+				attachmentVertices = getAttachmentVertices(attachment);
+				V3F_C4B_T2F* verts = attachmentVertices->_triangles->verts;
+				vertices.insert(vertices.end(), verts, verts + attachmentVertices->_triangles->vertCount);
+				spRegionAttachment_computeWorldVertices(attachment, slot->bone, (float*)&vertices[firstVertex], 0, 6);
+				attachmentColor = &attachment->color;
+				break;
+			}
+			case SP_ATTACHMENT_MESH: {
+				spMeshAttachment* attachment = (spMeshAttachment*)slot->attachment;
+				attachmentVertices = getAttachmentVertices(attachment);
+				V3F_C4B_T2F* verts = attachmentVertices->_triangles->verts;
+				int vertCount = attachmentVertices->_triangles->vertCount;
+				vertices.insert(vertices.end(), verts, verts + vertCount);
+				spVertexAttachment_computeWorldVertices(SUPER(attachment), slot, 0, vertCount * sizeof(V3F_C4B_T2F) / 4, (float*)&vertices[firstVertex], 0, 6);
+				attachmentColor = &attachment->color;
+				break;
+			}
+			case SP_ATTACHMENT_CLIPPING: {
+				spClippingAttachment* clip = (spClippingAttachment*)slot->attachment;
+				spSkeletonClipping_clipStart(clipper, slot, clip);
+			}
+			default:
+				spSkeletonClipping_clipEnd(clipper, slot);
+				continue;
+			}
+
+			BakedAnimation::Mesh mesh;
+			mesh.texture = attachmentVertices->_texture;
+			mesh.color = Color4F(attachmentColor->r * slot->color.r, attachmentColor->g * slot->color.g, attachmentColor->b * slot->color.b, attachmentColor->a * slot->color.a);
+			// skip the attachments which are never rendered
+			if (mesh.color.a == 0) {
+				vertices.resize(firstVertex);
+				spSkeletonClipping_clipEnd(clipper, slot);
+				continue;
+			}
+
+			switch (slot->data->blendMode) {
+				case SP_BLEND_MODE_ADDITIVE:
+					mesh.blendFunc.src = _premultipliedAlpha ? GL_ONE : GL_SRC_ALPHA;
+					mesh.blendFunc.dst = GL_ONE;
+					break;
+				case SP_BLEND_MODE_MULTIPLY:
+					mesh.blendFunc.src = GL_DST_COLOR;
+					mesh.blendFunc.dst = GL_ONE_MINUS_SRC_ALPHA;
+					break;
+				case SP_BLEND_MODE_SCREEN:
+					mesh.blendFunc.src = GL_ONE;
+					mesh.blendFunc.dst = GL_ONE_MINUS_SRC_COLOR;
+					break;
+				default:
+					mesh.blendFunc.src = _premultipliedAlpha ? GL_ONE : GL_SRC_ALPHA;
+					mesh.blendFunc.dst = GL_ONE_MINUS_SRC_ALPHA;
+			}
+
+			std::vector<unsigned short>& indices = bakedAnimation->indices;
+			mesh.firstVertex = firstVertex;
+			mesh.firstIndex = (uint32_t)indices.size();
+			if (spSkeletonClipping_isClipping(clipper)) {
+				uint32_t vertCount = (uint32_t)vertices.size() - firstVertex;
+				spSkeletonClipping_clipTriangles(clipper, (float*)&vertices[firstVertex].vertices, vertCount * sizeof(V3F_C4B_T2F) / 4, attachmentVertices->_triangles->indices, attachmentVertices->_triangles->indexCount, (float*)&vertices[firstVertex].texCoords, 6);
+				vertices.resize(firstVertex);
+
+				if (clipper->clippedTriangles->size == 0) {
+					spSkeletonClipping_clipEnd(clipper, slot);
+					continue;
+				}
+
+				float* verts = clipper->clippedVertices->items;
+				float* uvs = clipper->clippedUVs->items;
+				for (int v = 0, vn = clipper->clippedVertices->size >> 1; v < vn; ++v) {
+					V3F_C4B_T2F vertex;
+					vertex.vertices.set(verts[v * 2], verts[v * 2 + 1], 0);
+					vertex.texCoords.u = uvs[v * 2];
+					vertex.texCoords.v = uvs[v * 2 + 1];
+					vertices.push_back(vertex);
+				}
+				unsigned short* triangles = clipper->clippedTriangles->items;
+				indices.insert(indices.end(), triangles, triangles + clipper->clippedTriangles->size);
+			} else {
+				unsigned short* triangles = attachmentVertices->_triangles->indices;
+				indices.insert(indices.end(), triangles, triangles + attachmentVertices->_triangles->indexCount);
+			}
+			mesh.vertexCount = (uint32_t)vertices.size() - firstVertex;
+			mesh.indexCount = (uint32_t)indices.size() - mesh.firstIndex;
+
+			for (uint32_t v = firstVertex, vn = (uint32_t)vertices.size(); v < vn; ++v) {
+				frame.minX = min(frame.minX, vertices[v].vertices.x);
+				frame.minY = min(frame.minY, vertices[v].vertices.y);
+				frame.maxX = max(frame.maxX, vertices[v].vertices.x);
+				frame.maxY = max(frame.maxY, vertices[v].vertices.y);
+			}
+			bakedAnimation->meshes.push_back(mesh);
+			spSkeletonClipping_clipEnd(clipper, slot);
+		}
+		spSkeletonClipping_clipEnd2(clipper);
+
+		frame.meshCount = (uint32_t)bakedAnimation->meshes.size() - frame.firstMesh;
+		if (frame.minX == FLT_MAX) frame.minX = frame.minY = frame.maxX = frame.maxY = 0;
+	}
+
+	spSkeletonClipping_dispose(clipper);
+	spSkeleton_dispose(skeleton);
+	return bakedAnimation;
+}
+
+int SkeletonAnimation::getBakedFrameIndex () const {
+	float duration = _bakedAnimation->duration;
+	float time = _bakedLoop && duration > 0 ? fmodf(_bakedTime, duration) : min(_bakedTime, duration);
+	return min((int)(time * _bakedAnimation->frameRate + 0.5f), (int)_bakedAnimation->frames.size() - 1);
+}
+
+void SkeletonAnimation::draw (Renderer* renderer, const Mat4& transform, uint32_t transformFlags) {
+	if (!_bakedAnimation) {
+		super::draw(renderer, transform, transformFlags);
+		return;
+	}
+
+	SkeletonBatch* batch = SkeletonBatch::getInstance();
+
+	float nodeR = getDisplayedColor().r / (float)255 * _skeleton->color.r;
+	float nodeG = getDisplayedColor().g / (float)255 * _skeleton->color.g;
+	float nodeB = getDisplayedColor().b / (float)255 * _skeleton->color.b;
+	float nodeA = getDisplayedOpacity() / (float)255 * _skeleton->color.a;
+
+	const BakedAnimation::Frame& frame = _bakedAnimation->frames[getBakedFrameIndex()];
+	for (uint32_t i = frame.firstMesh, n = frame.firstMesh + frame.meshCount; i < n; ++i) {
+		const BakedAnimation::Mesh& mesh = _bakedAnimation->meshes[i];
+
+		float alpha = mesh.color.a * nodeA * 255;
+		// skip rendering if the color of this attachment is 0
+		if (alpha == 0) continue;
+		float multiplier = _premultipliedAlpha ? alpha : 255;
+		Color4B color((GLubyte)(mesh.color.r * nodeR * multiplier), (GLubyte)(mesh.color.g * nodeG * multiplier), (GLubyte)(mesh.color.b * nodeB * multiplier), (GLubyte)alpha);
+
+		// the indices of the baked animation outlive the command, it's retained until this node is destroyed
+		cocos2d::TrianglesCommand::Triangles triangles;
+		triangles.verts = batch->allocateVertices(mesh.vertexCount);
+		triangles.vertCount = mesh.vertexCount;
+		triangles.indices = const_cast<unsigned short*>(&_bakedAnimation->indices[mesh.firstIndex]);
+		triangles.indexCount = mesh.indexCount;
+		memcpy(triangles.verts, &_bakedAnimation->vertices[mesh.firstVertex], sizeof(cocos2d::V3F_C4B_T2F) * mesh.vertexCount);
+		for (uint32_t v = 0; v < mesh.vertexCount; ++v) {
+			triangles.verts[v].colors = color;
+		}
+
+		batch->addCommand(renderer, _globalZOrder, mesh.texture, _glProgramState, mesh.blendFunc, triangles, transform, transformFlags);
+	}
+}
+
+Rect SkeletonAnimation::getBoundingBox () const {
+	if (!_bakedAnimation) return super::getBoundingBox();
+
+	const BakedAnimation::Frame& frame = _bakedAnimation->frames[getBakedFrameIndex()];
+	float scaleX = getScaleX(), scaleY = getScaleY();
+	float minX = min(frame.minX * scaleX, frame.maxX * scaleX), maxX = max(frame.minX * scaleX, frame.maxX * scaleX);
+	float minY = min(frame.minY * scaleY, frame.maxY * scaleY), maxY = max(frame.minY * scaleY, frame.maxY * scaleY);
+	Vec2 position = getPosition();
+	return Rect(position.x + minX, position.y + minY, maxX - minX, maxY - minY);
+}
+
 void SkeletonAnimation::clearTrack (int trackIndex) {
 	spAnimationState_clearTrack(_state, trackIndex);
 }
@@ -44,6 +44,45 @@ typedef std::function<void(spTrackEntry* entry)> DisposeListener;
 typedef std::function<void(spTrackEntry* entry)> CompleteListener;
 typedef std::function<void(spTrackEntry* entry, spEvent* event)> EventListener;
 
+/** Vertices of an animation sampled at a fixed frame rate, shared by all the skeletons playing it baked. */
+class BakedAnimation: public cocos2d::Ref {
+public:
+	struct Mesh {
+		cocos2d::Texture2D* texture;
+		cocos2d::BlendFunc blendFunc;
+		/* Attachment color multiplied by the slot color, the node and skeleton colors are applied when drawn. */
+		cocos2d::Color4F color;
+		uint32_t firstVertex;
+		uint32_t vertexCount;
+		uint32_t firstIndex;
+		uint32_t indexCount;
+	};
+
+	struct Frame {
+		uint32_t firstMesh;
+		uint32_t meshCount;
+		/* Bounds of the vertices in the skeleton coordinates. */
+		float minX, minY, maxX, maxY;
+	};
+
+	float frameRate;
+	float duration;
+	std::vector<Frame> frames;
+	std::vector<Mesh> meshes;
+	std::vector<cocos2d::V3F_C4B_T2F> vertices;
+	std::vector<unsigned short> indices;
+
+CC_CONSTRUCTOR_ACCESS:
+	BakedAnimation ();
+	virtual ~BakedAnimation ();
+
+protected:
+	friend class SkeletonAnimation;
+
+	/* Key of the animation in the shared baked animations, empty if it isn't shared. */
+	std::string _key;
+};
+
 /** Draws an animated skeleton, providing an AnimationState for applying one or more animations and queuing animations to be
   * played later. */
 class SkeletonAnimation: public SkeletonRenderer {
@@ -67,6 +106,14 @@ public:
 	}
 
 	virtual void update (float deltaTime) override;
+	virtual void draw (cocos2d::Renderer* renderer, const cocos2d::Mat4& transform, uint32_t transformFlags) override;
+	virtual cocos2d::Rect getBoundingBox () const override;
+
+	/* Updates the animation state and world transform of all the visible skeletons in parallel on the JobSystem, after the
+	 * scheduler update and before the scene is drawn. The skeletons' bones aren't posed until then, and the listeners are
+	 * called on the cocos thread once every skeleton is updated. Disabled by default. */
+	static void setParallelUpdateEnabled (bool enabled);
+	static bool isParallelUpdateEnabled ();
 
 	void setAnimationStateData (spAnimationStateData* stateData);
 	void setMix (const std::string& fromAnimation, const std::string& toAnimation, float duration);
@@ -78,6 +125,14 @@ public:
 	spTrackEntry* addEmptyAnimation (int trackIndex, float mixDuration, float delay = 0);
 	spAnimation* findAnimation(const std::string& name) const;
 	spTrackEntry* getCurrent (int trackIndex = 0);
+
+	/* Plays the animation from vertices sampled at frameRate, shared by all the skeletons playing it with the same skeleton data
+	 * and skin. The animation state isn't updated and its listeners aren't called until clearBakedAnimation, setAnimation or
+	 * clearTracks is called, and the bones, attachments set on this skeleton and debug drawing aren't updated meanwhile.
+	 * Returns false if the animation was not found, or if two color tinting or a vertex effect is used. */
+	bool setBakedAnimation (const std::string& name, bool loop, float frameRate = 30);
+	void clearBakedAnimation ();
+	bool isPlayingBakedAnimation () const;
 	void clearTracks ();
 	void clearTrack (int trackIndex = 0);
 
@@ -106,6 +161,13 @@ CC_CONSTRUCTOR_ACCESS:
 	virtual void initialize () override;
 
 protected:
+	/* Defers the update to the parallel update of all the skeletons. */
+	void queueParallelUpdate (float deltaTime);
+	static void runParallelUpdate ();
+
+	BakedAnimation* bakeAnimation (spAnimation* animation, float frameRate);
+	int getBakedFrameIndex () const;
+
 	spAnimationState* _state;
 
 	bool _ownsAnimationStateData;
@@ -117,6 +179,13 @@ protected:
 	CompleteListener _completeListener;
 	EventListener _eventListener;
 
+	/* Time to update in the parallel update, -1 if the skeleton isn't queued. */
+	float _parallelUpdateTime;
+
+	BakedAnimation* _bakedAnimation;
+	float _bakedTime;
+	bool _bakedLoop;
+
 private:
 	typedef SkeletonRenderer super;
 };
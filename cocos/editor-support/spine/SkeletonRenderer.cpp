@@ -42,6 +42,94 @@ using std::max;
 
 namespace spine {
 
+static SkeletonDataCache* dataCacheInstance = nullptr;
+
+SkeletonDataCache* SkeletonDataCache::getInstance () {
+	if (!dataCacheInstance) dataCacheInstance = new SkeletonDataCache();
+	return dataCacheInstance;
+}
+
+void SkeletonDataCache::destroyInstance () {
+	if (dataCacheInstance) {
+		delete dataCacheInstance;
+		dataCacheInstance = nullptr;
+	}
+}
+
+SkeletonDataCache::SkeletonDataCache ()
+	: _enabled(true) {
+}
+
+SkeletonDataCache::~SkeletonDataCache () {
+	for (auto& entry : _entries) {
+		spSkeletonData_dispose(entry.second.skeletonData);
+		spAtlas_dispose(entry.second.atlas);
+		spAttachmentLoader_dispose(entry.second.attachmentLoader);
+	}
+}
+
+spSkeletonData* SkeletonDataCache::retainSkeletonData (const std::string& skeletonDataFile, const std::string& atlasFile, float scale, bool binary) {
+	FileUtils* fileUtils = FileUtils::getInstance();
+	std::string key = fileUtils->fullPathForFilename(skeletonDataFile) + '\n' + fileUtils->fullPathForFilename(atlasFile) + '\n' + std::to_string(scale);
+	auto it = _entries.find(key);
+	if (it != _entries.end()) {
+		++it->second.referenceCount;
+		return it->second.skeletonData;
+	}
+
+	spAtlas* atlas = spAtlas_createFromFile(atlasFile.c_str(), 0);
+	CCASSERT(atlas, "Error reading atlas file.");
+	if (!atlas) return 0;
+
+	spAttachmentLoader* attachmentLoader = SUPER(Cocos2dAttachmentLoader_create(atlas));
+	spSkeletonData* skeletonData;
+	if (binary) {
+		spSkeletonBinary* reader = spSkeletonBinary_createWithLoader(attachmentLoader);
+		reader->scale = scale;
+		skeletonData = spSkeletonBinary_readSkeletonDataFile(reader, skeletonDataFile.c_str());
+		CCASSERT(skeletonData, reader->error ? reader->error : "Error reading skeleton data file.");
+		spSkeletonBinary_dispose(reader);
+	} else {
+		spSkeletonJson* reader = spSkeletonJson_createWithLoader(attachmentLoader);
+		reader->scale = scale;
+		skeletonData = spSkeletonJson_readSkeletonDataFile(reader, skeletonDataFile.c_str());
+		CCASSERT(skeletonData, reader->error ? reader->error : "Error reading skeleton data file.");
+		spSkeletonJson_dispose(reader);
+	}
+	if (!skeletonData) {
+		spAttachmentLoader_dispose(attachmentLoader);
+		spAtlas_dispose(atlas);
+		return 0;
+	}
+
+	Entry entry = { skeletonData, atlas, attachmentLoader, 1 };
+	_entries.emplace(key, entry);
+	return skeletonData;
+}
+
+void SkeletonDataCache::releaseSkeletonData (spSkeletonData* skeletonData) {
+	for (auto it = _entries.begin(); it != _entries.end(); ++it) {
+		if (it->second.skeletonData != skeletonData) continue;
+		if (--it->second.referenceCount == 0) {
+			spSkeletonData_dispose(it->second.skeletonData);
+			spAtlas_dispose(it->second.atlas);
+			spAttachmentLoader_dispose(it->second.attachmentLoader);
+			_entries.erase(it);
+		}
+		return;
+	}
+}
+
+void SkeletonDataCache::setEnabled (bool enabled) {
+	_enabled = enabled;
+}
+
+bool SkeletonDataCache::isEnabled () const {
+	return _enabled;
+}
+
+//
+
 SkeletonRenderer* SkeletonRenderer::createWithData (spSkeletonData* skeletonData, bool ownsSkeletonData) {
 	SkeletonRenderer* node = new SkeletonRenderer(skeletonData, ownsSkeletonData);
 	node->autorelease();
@@ -77,27 +165,29 @@ void SkeletonRenderer::setSkeletonData (spSkeletonData *skeletonData, bool ownsS
 }
 
 SkeletonRenderer::SkeletonRenderer ()
-	: _atlas(nullptr), _attachmentLoader(nullptr), _debugSlots(false), _debugBones(false), _debugMeshes(false), _timeScale(1), _effect(nullptr) {
+	: _cachedSkeletonData(false), _atlas(nullptr), _attachmentLoader(nullptr), _debugSlots(false), _debugBones(false), _debugMeshes(false), _timeScale(1), _effect(nullptr) {
 }
 
 SkeletonRenderer::SkeletonRenderer (spSkeletonData *skeletonData, bool ownsSkeletonData)
-	: _atlas(nullptr), _attachmentLoader(nullptr), _debugSlots(false), _debugBones(false), _debugMeshes(false), _timeScale(1), _effect(nullptr) {
+	: _cachedSkeletonData(false), _atlas(nullptr), _attachmentLoader(nullptr), _debugSlots(false), _debugBones(false), _debugMeshes(false), _timeScale(1), _effect(nullptr) {
 	initWithData(skeletonData, ownsSkeletonData);
 }
 
 SkeletonRenderer::SkeletonRenderer (const std::string& skeletonDataFile, spAtlas* atlas, float scale)
-	: _atlas(nullptr), _attachmentLoader(nullptr), _debugSlots(false), _debugBones(false), _debugMeshes(false), _timeScale(1), _effect(nullptr) {
+	: _cachedSkeletonData(false), _atlas(nullptr), _attachmentLoader(nullptr), _debugSlots(false), _debugBones(false), _debugMeshes(false), _timeScale(1), _effect(nullptr) {
 	initWithJsonFile(skeletonDataFile, atlas, scale);
 }
 
 SkeletonRenderer::SkeletonRenderer (const std::string& skeletonDataFile, const std::string& atlasFile, float scale)
-	: _atlas(nullptr), _attachmentLoader(nullptr), _debugSlots(false), _debugBones(false), _debugMeshes(false), _timeScale(1), _effect(nullptr) {
+	: _cachedSkeletonData(false), _atlas(nullptr), _attachmentLoader(nullptr), _debugSlots(false), _debugBones(false), _debugMeshes(false), _timeScale(1), _effect(nullptr) {
 	initWithJsonFile(skeletonDataFile, atlasFile, scale);
 }
 
 SkeletonRenderer::~SkeletonRenderer () {
-	if (_ownsSkeletonData) spSkeletonData_dispose(_skeleton->data);
+	spSkeletonData* skeletonData = _skeleton->data;
+	if (_ownsSkeletonData) spSkeletonData_dispose(skeletonData);
 	spSkeleton_dispose(_skeleton);
+	if (_cachedSkeletonData) SkeletonDataCache::getInstance()->releaseSkeletonData(skeletonData);
 	if (_atlas) spAtlas_dispose(_atlas);
 	if (_attachmentLoader) spAttachmentLoader_dispose(_attachmentLoader);
 	delete [] _worldVertices;
@@ -126,6 +216,17 @@ void SkeletonRenderer::initWithJsonFile (const std::string& skeletonDataFile, sp
 }
 
 void SkeletonRenderer::initWithJsonFile (const std::string& skeletonDataFile, const std::string& atlasFile, float scale) {
+	SkeletonDataCache* cache = SkeletonDataCache::getInstance();
+	if (cache->isEnabled()) {
+		spSkeletonData* skeletonData = cache->retainSkeletonData(skeletonDataFile, atlasFile, scale, false);
+		CCASSERT(skeletonData, "Error reading skeleton data file.");
+		setSkeletonData(skeletonData, false);
+		_cachedSkeletonData = true;
+
+		initialize();
+		return;
+	}
+
 	_atlas = spAtlas_createFromFile(atlasFile.c_str(), 0);
 	CCASSERT(_atlas, "Error reading atlas file.");
 
@@ -158,6 +259,17 @@ void SkeletonRenderer::initWithBinaryFile (const std::string& skeletonDataFile,
 }
 
 void SkeletonRenderer::initWithBinaryFile (const std::string& skeletonDataFile, const std::string& atlasFile, float scale) {
+    SkeletonDataCache* cache = SkeletonDataCache::getInstance();
+    if (cache->isEnabled()) {
+        spSkeletonData* skeletonData = cache->retainSkeletonData(skeletonDataFile, atlasFile, scale, true);
+        CCASSERT(skeletonData, "Error reading skeleton data file.");
+        setSkeletonData(skeletonData, false);
+        _cachedSkeletonData = true;
+
+        initialize();
+        return;
+    }
+
     _atlas = spAtlas_createFromFile(atlasFile.c_str(), 0);
     CCASSERT(_atlas, "Error reading atlas file.");
     
@@ -38,6 +38,38 @@ namespace spine {
 
 class AttachmentVertices;
 
+/* Shares the skeleton data and atlas read from the same files between skeletons. An entry is disposed when the last skeleton
+ * using it is destroyed. */
+class SkeletonDataCache {
+public:
+	static SkeletonDataCache* getInstance ();
+	/* Disposes all the entries, only call it once no skeleton uses them. */
+	static void destroyInstance ();
+
+	/* Returns the skeleton data read from the files, reading them on the first request. Every call must be balanced by a call
+	 * to releaseSkeletonData. Returns 0 if the files can't be read. */
+	spSkeletonData* retainSkeletonData (const std::string& skeletonDataFile, const std::string& atlasFile, float scale, bool binary);
+	void releaseSkeletonData (spSkeletonData* skeletonData);
+
+	/* Whether skeletons created from a skeleton data file and an atlas file share their data, true by default. */
+	void setEnabled (bool enabled);
+	bool isEnabled () const;
+
+protected:
+	SkeletonDataCache ();
+	virtual ~SkeletonDataCache ();
+
+	struct Entry {
+		spSkeletonData* skeletonData;
+		spAtlas* atlas;
+		spAttachmentLoader* attachmentLoader;
+		int referenceCount;
+	};
+
+	std::unordered_map<std::string, Entry> _entries;
+	bool _enabled;
+};
+
 /* Draws a skeleton. */
 class SkeletonRenderer: public cocos2d::Node, public cocos2d::BlendProtocol {
 public:
@@ -131,6 +163,7 @@ protected:
 	virtual AttachmentVertices* getAttachmentVertices (spMeshAttachment* attachment) const;	
 
 	bool _ownsSkeletonData;
+	bool _cachedSkeletonData;
 	spAtlas* _atlas;
 	spAttachmentLoader* _attachmentLoader;
 	cocos2d::CustomCommand _debugCommand;
@@ -271,9 +271,7 @@ void SkeletonTwoColorBatch::batch (TwoColorTrianglesCommand* command) {
 	
 	memcpy(_vertexBuffer + _numVerticesBuffer, command->getTriangles().verts, sizeof(V3F_C4B_C4B_T2F) * command->getTriangles().vertCount);
 	const Mat4& modelView = command->getModelView();
-	for (int i = _numVerticesBuffer; i < _numVerticesBuffer + command->getTriangles().vertCount; i++) {
-		modelView.transformPoint(&_vertexBuffer[i].position);
-	}
+	modelView.transformPoints(&_vertexBuffer[_numVerticesBuffer].position, command->getTriangles().vertCount, sizeof(V3F_C4B_C4B_T2F));
 	
 	unsigned short vertexOffset = (unsigned short)_numVerticesBuffer;
 	unsigned short* indices = command->getTriangles().indices;
@@ -245,6 +245,9 @@ struct _spAnimationState {
 #endif
 };
 
+/* Calls the listeners of the queued events, unless draining is disabled. */
+void _spEventQueue_drain (_spEventQueue* self);
+
 
 /**/
 
@@ -906,6 +906,26 @@ void Mat4::transformVector(const Vec3& vector, Vec3* dst) const
     transformVector(vector.x, vector.y, vector.z, 0.0f, dst);
 }
 
+void Mat4::transformPoints(Vec3* points, size_t count, size_t stride) const
+{
+    GP_ASSERT(points || count == 0);
+#ifdef __SSE__
+    MathUtil::transformPoints(col, (const float*)points, stride, (float*)points, stride, count);
+#else
+    MathUtil::transformPoints(m, (const float*)points, stride, (float*)points, stride, count);
+#endif
+}
+
+void Mat4::transformPoints(Vec2* points, size_t count, size_t stride) const
+{
+    GP_ASSERT(points || count == 0);
+#ifdef __SSE__
+    MathUtil::transformPoints2D(col, (const float*)points, stride, (float*)points, stride, count);
+#else
+    MathUtil::transformPoints2D(m, (const float*)points, stride, (float*)points, stride, count);
+#endif
+}
+
 void Mat4::transformVector(float x, float y, float z, float w, Vec3* dst) const
 {
     GP_ASSERT(dst);
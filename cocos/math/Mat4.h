@@ -24,6 +24,7 @@
 
 #include "base/ccMacros.h"
 
+#include "math/Vec2.h"
 #include "math/Vec3.h"
 #include "math/Vec4.h"
 
@@ -772,6 +773,29 @@ public:
      */
     inline void transformPoint(const Vec3& point, Vec3* dst) const { GP_ASSERT(dst); transformVector(point.x, point.y, point.z, 1.0f, dst); }
 
+    /**
+     * Transforms an array of points by this matrix, as transformPoint() does for each of them.
+     *
+     * The results are stored directly into the points. The stride lets the positions of interleaved
+     * vertices be transformed in place, eg: transformPoints(&verts[0].vertices, count, sizeof(V3F_C4B_T2F)).
+     *
+     * @param points The first point to transform.
+     * @param count The number of points.
+     * @param stride The distance in bytes between two points.
+     * @since v3.14
+     */
+    void transformPoints(Vec3* points, size_t count, size_t stride = sizeof(Vec3)) const;
+
+    /**
+     * Transforms an array of 2D points by this matrix, treating their z coordinate as zero.
+     *
+     * @param points The first point to transform.
+     * @param count The number of points.
+     * @param stride The distance in bytes between two points.
+     * @since v3.14
+     */
+    void transformPoints(Vec2* points, size_t count, size_t stride = sizeof(Vec2)) const;
+
     /**
      * Transforms the specified vector by this matrix by
      * treating the fourth (w) coordinate as zero.
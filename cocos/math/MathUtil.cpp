@@ -275,4 +275,38 @@ void MathUtil::crossVec3(const float* v1, const float* v2, float* dst)
 #endif
 }
 
+void MathUtil::transformPoints(const float* m, const float* src, size_t srcStride, float* dst, size_t dstStride, size_t count)
+{
+#ifdef USE_NEON32
+    MathUtilNeon::transformPoints(m, src, srcStride, dst, dstStride, count);
+#elif defined (USE_NEON64)
+    MathUtilNeon64::transformPoints(m, src, srcStride, dst, dstStride, count);
+#elif defined (INCLUDE_NEON32)
+    if(isNeon32Enabled()) MathUtilNeon::transformPoints(m, src, srcStride, dst, dstStride, count);
+    else MathUtilC::transformPoints(m, src, srcStride, dst, dstStride, count);
+#elif defined (USE_SSE)
+    __m128 col[4] = { _mm_loadu_ps(m), _mm_loadu_ps(m + 4), _mm_loadu_ps(m + 8), _mm_loadu_ps(m + 12) };
+    transformPoints(col, src, srcStride, dst, dstStride, count);
+#else
+    MathUtilC::transformPoints(m, src, srcStride, dst, dstStride, count);
+#endif
+}
+
+void MathUtil::transformPoints2D(const float* m, const float* src, size_t srcStride, float* dst, size_t dstStride, size_t count)
+{
+#ifdef USE_NEON32
+    MathUtilNeon::transformPoints2D(m, src, srcStride, dst, dstStride, count);
+#elif defined (USE_NEON64)
+    MathUtilNeon64::transformPoints2D(m, src, srcStride, dst, dstStride, count);
+#elif defined (INCLUDE_NEON32)
+    if(isNeon32Enabled()) MathUtilNeon::transformPoints2D(m, src, srcStride, dst, dstStride, count);
+    else MathUtilC::transformPoints2D(m, src, srcStride, dst, dstStride, count);
+#elif defined (USE_SSE)
+    __m128 col[4] = { _mm_loadu_ps(m), _mm_loadu_ps(m + 4), _mm_loadu_ps(m + 8), _mm_loadu_ps(m + 12) };
+    transformPoints2D(col, src, srcStride, dst, dstStride, count);
+#else
+    MathUtilC::transformPoints2D(m, src, srcStride, dst, dstStride, count);
+#endif
+}
+
 NS_CC_MATH_END
@@ -87,9 +87,40 @@ public:
      * @return interpolated float value
      */
     static float lerp(float from, float to, float alpha);
-private:
-    //Indicates that if neon is enabled
+
+    /**
+     * Transforms an array of points by a matrix, treating the fourth (w) coordinate as one.
+     * It gives the same results as calling Mat4::transformPoint() for each point, with SSE or NEON when available.
+     *
+     * The strides are the distances in bytes between two points, so the positions of interleaved
+     * vertices, eg: V3F_C4B_T2F, can be transformed. src and dst may be the same array.
+     *
+     * @param m The column major matrix, eg: Mat4::m.
+     * @param src The x, y, z coordinates of the first point.
+     * @param srcStride The distance in bytes between two points of src.
+     * @param dst Where the x, y, z coordinates of the first transformed point are stored.
+     * @param dstStride The distance in bytes between two points of dst.
+     * @param count The number of points.
+     * @since v3.14
+     */
+    static void transformPoints(const float* m, const float* src, size_t srcStride, float* dst, size_t dstStride, size_t count);
+
+    /**
+     * Transforms an array of 2D points by a matrix, treating the z coordinate as zero and w as one.
+     * Only the x and y coordinates of the results are stored.
+     *
+     * @see transformPoints
+     * @since v3.14
+     */
+    static void transformPoints2D(const float* m, const float* src, size_t srcStride, float* dst, size_t dstStride, size_t count);
+
+    /**
+     * Whether or not the CPU runs the 32 bit NEON code paths, checked at runtime on Android.
+     */
     static bool isNeon32Enabled();
+    /**
+     * Whether or not the CPU runs the 64 bit NEON code paths.
+     */
     static bool isNeon64Enabled();
 private:
 #ifdef __SSE__
@@ -108,6 +139,10 @@ private:
     static void transposeMatrix(const __m128 m[4], __m128 dst[4]);
         
     static void transformVec4(const __m128 m[4], const __m128& v, __m128& dst);
+
+    static void transformPoints(const __m128 m[4], const float* src, size_t srcStride, float* dst, size_t dstStride, size_t count);
+
+    static void transformPoints2D(const __m128 m[4], const float* src, size_t srcStride, float* dst, size_t dstStride, size_t count);
 #endif
     static void addMatrix(const float* m, float scalar, float* dst);
 
@@ -42,6 +42,10 @@ public:
     inline static void transformVec4(const float* m, const float* v, float* dst);
     
     inline static void crossVec3(const float* v1, const float* v2, float* dst);
+
+    inline static void transformPoints(const float* m, const float* src, size_t srcStride, float* dst, size_t dstStride, size_t count);
+
+    inline static void transformPoints2D(const float* m, const float* src, size_t srcStride, float* dst, size_t dstStride, size_t count);
 };
 
 inline void MathUtilC::addMatrix(const float* m, float scalar, float* dst)
@@ -215,4 +219,36 @@ inline void MathUtilC::crossVec3(const float* v1, const float* v2, float* dst)
     dst[2] = z;
 }
 
+inline void MathUtilC::transformPoints(const float* m, const float* src, size_t srcStride, float* dst, size_t dstStride, size_t count)
+{
+    const char* in = (const char*)src;
+    char* out = (char*)dst;
+    for (size_t i = 0; i < count; ++i, in += srcStride, out += dstStride)
+    {
+        // read the whole point first, src may be dst
+        const float* v = (const float*)in;
+        float x = v[0], y = v[1], z = v[2];
+
+        float* d = (float*)out;
+        d[0] = x * m[0] + y * m[4] + z * m[8] + m[12];
+        d[1] = x * m[1] + y * m[5] + z * m[9] + m[13];
+        d[2] = x * m[2] + y * m[6] + z * m[10] + m[14];
+    }
+}
+
+inline void MathUtilC::transformPoints2D(const float* m, const float* src, size_t srcStride, float* dst, size_t dstStride, size_t count)
+{
+    const char* in = (const char*)src;
+    char* out = (char*)dst;
+    for (size_t i = 0; i < count; ++i, in += srcStride, out += dstStride)
+    {
+        const float* v = (const float*)in;
+        float x = v[0], y = v[1];
+
+        float* d = (float*)out;
+        d[0] = x * m[0] + y * m[4] + m[12];
+        d[1] = x * m[1] + y * m[5] + m[13];
+    }
+}
+
 NS_CC_MATH_END
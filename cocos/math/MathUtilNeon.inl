@@ -17,6 +17,8 @@
 
  This file was modified to fit the cocos2d-x project
  */
+#include <arm_neon.h>
+
 NS_CC_MATH_BEGIN
 
 class MathUtilNeon
@@ -41,6 +43,10 @@ public:
     inline static void transformVec4(const float* m, const float* v, float* dst);
     
     inline static void crossVec3(const float* v1, const float* v2, float* dst);
+
+    inline static void transformPoints(const float* m, const float* src, size_t srcStride, float* dst, size_t dstStride, size_t count);
+
+    inline static void transformPoints2D(const float* m, const float* src, size_t srcStride, float* dst, size_t dstStride, size_t count);
 };
 
 inline void MathUtilNeon::addMatrix(const float* m, float scalar, float* dst)
@@ -268,4 +274,41 @@ inline void MathUtilNeon::crossVec3(const float* v1, const float* v2, float* dst
                  );
 }
 
+inline void MathUtilNeon::transformPoints(const float* m, const float* src, size_t srcStride, float* dst, size_t dstStride, size_t count)
+{
+    float32x4_t col0 = vld1q_f32(m);
+    float32x4_t col1 = vld1q_f32(m + 4);
+    float32x4_t col2 = vld1q_f32(m + 8);
+    float32x4_t col3 = vld1q_f32(m + 12);
+
+    const char* in = (const char*)src;
+    char* out = (char*)dst;
+    for (size_t i = 0; i < count; ++i, in += srcStride, out += dstStride)
+    {
+        // the point is read as scalars, the fourth float after it may not belong to the array
+        const float* v = (const float*)in;
+        float32x4_t r = vmlaq_n_f32(vmlaq_n_f32(vmlaq_n_f32(col3, col0, v[0]), col1, v[1]), col2, v[2]);
+
+        // only x, y, z are stored, what follows them is left untouched, eg: the colors of a vertex
+        float* d = (float*)out;
+        vst1_f32(d, vget_low_f32(r));
+        vst1q_lane_f32(d + 2, r, 2);
+    }
+}
+
+inline void MathUtilNeon::transformPoints2D(const float* m, const float* src, size_t srcStride, float* dst, size_t dstStride, size_t count)
+{
+    float32x2_t col0 = vld1_f32(m);
+    float32x2_t col1 = vld1_f32(m + 4);
+    float32x2_t col3 = vld1_f32(m + 12);
+
+    const char* in = (const char*)src;
+    char* out = (char*)dst;
+    for (size_t i = 0; i < count; ++i, in += srcStride, out += dstStride)
+    {
+        const float* v = (const float*)in;
+        vst1_f32((float*)out, vmla_n_f32(vmla_n_f32(col3, col0, v[0]), col1, v[1]));
+    }
+}
+
 NS_CC_MATH_END
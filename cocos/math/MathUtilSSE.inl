@@ -151,6 +151,38 @@ void MathUtil::transformVec4(const __m128 m[4], const __m128& v, __m128& dst)
                      );
 }
 
+void MathUtil::transformPoints(const __m128 m[4], const float* src, size_t srcStride, float* dst, size_t dstStride, size_t count)
+{
+    const char* in = (const char*)src;
+    char* out = (char*)dst;
+    for (size_t i = 0; i < count; ++i, in += srcStride, out += dstStride)
+    {
+        // the point is read as scalars, the fourth float after it may not belong to the array
+        const float* v = (const float*)in;
+        __m128 r = _mm_add_ps(
+                              _mm_add_ps(_mm_mul_ps(m[0], _mm_set1_ps(v[0])), _mm_mul_ps(m[1], _mm_set1_ps(v[1]))),
+                              _mm_add_ps(_mm_mul_ps(m[2], _mm_set1_ps(v[2])), m[3])
+                              );
+
+        // only x, y, z are stored, what follows them is left untouched, eg: the colors of a vertex
+        float* d = (float*)out;
+        _mm_storel_pi((__m64*)d, r);
+        _mm_store_ss(d + 2, _mm_movehl_ps(r, r));
+    }
+}
+
+void MathUtil::transformPoints2D(const __m128 m[4], const float* src, size_t srcStride, float* dst, size_t dstStride, size_t count)
+{
+    const char* in = (const char*)src;
+    char* out = (char*)dst;
+    for (size_t i = 0; i < count; ++i, in += srcStride, out += dstStride)
+    {
+        const float* v = (const float*)in;
+        __m128 r = _mm_add_ps(_mm_add_ps(_mm_mul_ps(m[0], _mm_set1_ps(v[0])), _mm_mul_ps(m[1], _mm_set1_ps(v[1]))), m[3]);
+        _mm_storel_pi((__m64*)out, r);
+    }
+}
+
 #endif
 
 
@@ -26,8 +26,13 @@
 
 #include "platform/CCFileUtils.h"
 #include "renderer/CCRenderer.h"
+#include "base/CCDirector.h"
+#include "base/CCEventDispatcher.h"
+#include "base/CCEventListenerCustom.h"
 #include "recast/Detour/DetourCommon.h"
+#include "recast/Detour/DetourNavMeshBuilder.h"
 #include "recast/DebugUtils/DetourDebugDraw.h"
+#include <algorithm>
 #include <sstream>
 
 NS_CC_BEGIN
@@ -85,6 +90,85 @@ static unsigned char* parseRow(unsigned char* buf, unsigned char* bufEnd, char*
 static const int TILECACHESET_MAGIC = 'T' << 24 | 'S' << 16 | 'E' << 8 | 'T'; //'TSET';
 static const int TILECACHESET_VERSION = 1;
 static const int MAX_AGENTS = 128;
+static const int MAX_POLYS = 256;
+static const int MAX_SMOOTH = 2048;
+static const int DEFAULT_PATH_QUERY_BUDGET = 100;
+static const int MAX_TILE_LAYERS = 32;
+
+struct ObstacleCylinder
+{
+    float pos[3];
+    float radius;
+    float height;
+};
+
+static long long tileKey(int tx, int ty)
+{
+    return ((long long)tx << 32) | (unsigned int)ty;
+}
+
+// does the work of dtTileCache::buildNavMeshTile() on a worker, with its own allocator and a snapshot of the obstacles,
+// the navmesh data is added on the cocos thread
+static void buildTileNavData(std::vector<Data> &layers, const dtTileCacheParams &params, const std::vector<ObstacleCylinder> &obstacles,
+                             MeshProcess *meshProcess, std::vector<std::pair<unsigned char*, int> > &navData)
+{
+    LinearAllocator allocator(32000);
+    FastLZCompressor compressor;
+    const int walkableClimbVx = (int)(params.walkableClimb / params.ch);
+    for (auto &layerData : layers)
+    {
+        allocator.reset();
+        if (layerData.getSize() < (ssize_t)sizeof(dtTileCacheLayerHeader)) continue;
+        const dtTileCacheLayerHeader *header = (const dtTileCacheLayerHeader*)layerData.getBytes();
+        if (header->magic != DT_TILECACHE_MAGIC || header->version != DT_TILECACHE_VERSION) continue;
+
+        dtTileCacheLayer *layer = nullptr;
+        if (dtStatusFailed(dtDecompressTileCacheLayer(&allocator, &compressor, layerData.getBytes(), (int)layerData.getSize(), &layer)))
+            continue;
+
+        for (auto &ob : obstacles)
+            dtMarkCylinderArea(*layer, header->bmin, params.cs, params.ch, ob.pos, ob.radius, ob.height, 0);
+
+        if (dtStatusFailed(dtBuildTileCacheRegions(&allocator, *layer, walkableClimbVx)))
+            continue;
+        dtTileCacheContourSet *contours = dtAllocTileCacheContourSet(&allocator);
+        if (!contours || dtStatusFailed(dtBuildTileCacheContours(&allocator, *layer, walkableClimbVx, params.maxSimplificationError, *contours)))
+            continue;
+        dtTileCachePolyMesh *mesh = dtAllocTileCachePolyMesh(&allocator);
+        if (!mesh || dtStatusFailed(dtBuildTileCachePolyMesh(&allocator, *contours, *mesh)))
+            continue;
+        if (!mesh->npolys)
+            continue;
+
+        dtNavMeshCreateParams createParams;
+        memset(&createParams, 0, sizeof(createParams));
+        createParams.verts = mesh->verts;
+        createParams.vertCount = mesh->nverts;
+        createParams.polys = mesh->polys;
+        createParams.polyAreas = mesh->areas;
+        createParams.polyFlags = mesh->flags;
+        createParams.polyCount = mesh->npolys;
+        createParams.nvp = DT_VERTS_PER_POLYGON;
+        createParams.walkableHeight = params.walkableHeight;
+        createParams.walkableRadius = params.walkableRadius;
+        createParams.walkableClimb = params.walkableClimb;
+        createParams.tileX = header->tx;
+        createParams.tileY = header->ty;
+        createParams.tileLayer = header->tlayer;
+        createParams.cs = params.cs;
+        createParams.ch = params.ch;
+        createParams.buildBvTree = false;
+        dtVcopy(createParams.bmin, header->bmin);
+        dtVcopy(createParams.bmax, header->bmax);
+        if (meshProcess)
+            meshProcess->process(&createParams, mesh->areas, mesh->flags);
+
+        unsigned char *data = nullptr;
+        int dataSize = 0;
+        if (dtCreateNavMeshData(&createParams, &data, &dataSize))
+            navData.push_back(std::make_pair(data, dataSize));
+    }
+}
 
 NavMesh* NavMesh::create(const std::string &navFilePath, const std::string &geomFilePath)
 {
@@ -98,6 +182,22 @@ NavMesh* NavMesh::create(const std::string &navFilePath, const std::string &geom
     return nullptr;
 }
 
+NavMesh* NavMesh::createWithTileStreaming(const std::string &navFilePath, const std::string &geomFilePath)
+{
+    auto ref = new (std::nothrow) NavMesh();
+    if (ref)
+    {
+        ref->_tileStreaming = true;
+        if (ref->initWithFilePath(navFilePath, geomFilePath))
+        {
+            ref->autorelease();
+            return ref;
+        }
+    }
+    CC_SAFE_DELETE(ref);
+    return nullptr;
+}
+
 NavMesh::NavMesh()
     : _navMesh(nullptr)
     , _navMeshQuery(nullptr)
@@ -108,16 +208,34 @@ NavMesh::NavMesh()
     , _meshProcess(nullptr)
     , _geomData(nullptr)
     , _isDebugDrawEnabled(false)
+    , _slicedQuery(nullptr)
+    , _slicedQueryActive(false)
+    , _slicedStartRef(0)
+    , _nextPathRequestId(0)
+    , _pathQueryBudget(DEFAULT_PATH_QUERY_BUDGET)
+    , _asyncCrowdUpdate(false)
+    , _crowdUpdateDelta(0.0f)
+    , _crowdUpdate(nullptr)
+    , _afterDrawListener(nullptr)
+    , _tileStreaming(false)
 {
 
 }
 
 NavMesh::~NavMesh()
 {
+    setAsyncCrowdUpdate(false);
+    for (auto &build : _tileBuilds){
+        JobSystem::getInstance()->wait(build->job);
+        for (auto &data : build->navData)
+            dtFree(data.first);
+    }
+    _tileBuilds.clear();
     dtFreeTileCache(_tileCache);
     dtFreeCrowd(_crowed);
     dtFreeNavMesh(_navMesh);
     dtFreeNavMeshQuery(_navMeshQuery);
+    dtFreeNavMeshQuery(_slicedQuery);
     CC_SAFE_DELETE(_allocator);
     CC_SAFE_DELETE(_compressor);
     CC_SAFE_DELETE(_meshProcess);
@@ -203,6 +321,17 @@ bool NavMesh::loadNavMeshFile()
         if (!tileHeader.tileRef || !tileHeader.dataSize)
             break;
 
+        if (_tileStreaming)
+        {
+            // the tiles are indexed by column, each column holds the layers of a tile
+            const dtTileCacheLayerHeader* layerHeader = (const dtTileCacheLayerHeader*)(data.getBytes() + offset);
+            Data layer;
+            layer.copy(data.getBytes() + offset, tileHeader.dataSize);
+            _tileLayers[tileKey(layerHeader->tx, layerHeader->ty)].push_back(layer);
+            offset += tileHeader.dataSize;
+            continue;
+        }
+
         unsigned char* tileData = (unsigned char*)dtAlloc(tileHeader.dataSize, DT_ALLOC_PERM);
         if (!tileData) break;
         memcpy(tileData, (data.getBytes() + offset), tileHeader.dataSize);
@@ -223,6 +352,10 @@ bool NavMesh::loadNavMeshFile()
     _navMeshQuery = dtAllocNavMeshQuery();
     _navMeshQuery->init(_navMesh, 2048);
 
+    //the sliced searches keep their state between updates, they don't share the query of findPath
+    _slicedQuery = dtAllocNavMeshQuery();
+    _slicedQuery->init(_navMesh, 2048);
+
     _agentList.assign(MAX_AGENTS, nullptr);
     _obstacleList.assign(header.cacheParams.maxObstacles, nullptr);
     //duDebugDrawNavMesh(&_debugDraw, *_navMesh, DU_DRAWNAVMESH_OFFMESHCONS);
@@ -395,6 +528,7 @@ void cocos2d::NavMesh::drawAgents()
 
 void NavMesh::removeNavMeshObstacle(NavMeshObstacle *obstacle)
 {
+    waitForCrowdUpdate();
     auto iter = std::find(_obstacleList.begin(), _obstacleList.end(), obstacle);
     if (iter != _obstacleList.end()){
         obstacle->removeFrom(_tileCache);
@@ -405,6 +539,7 @@ void NavMesh::removeNavMeshObstacle(NavMeshObstacle *obstacle)
 
 void NavMesh::addNavMeshObstacle(NavMeshObstacle *obstacle)
 {
+    waitForCrowdUpdate();
     auto iter = std::find(_obstacleList.begin(), _obstacleList.end(), nullptr);
     if (iter != _obstacleList.end()){
         obstacle->addTo(_tileCache);
@@ -415,6 +550,7 @@ void NavMesh::addNavMeshObstacle(NavMeshObstacle *obstacle)
 
 void NavMesh::removeNavMeshAgent(NavMeshAgent *agent)
 {
+    waitForCrowdUpdate();
     auto iter = std::find(_agentList.begin(), _agentList.end(), agent);
     if (iter != _agentList.end()){
         agent->removeFrom(_crowed);
@@ -426,6 +562,7 @@ void NavMesh::removeNavMeshAgent(NavMeshAgent *agent)
 
 void NavMesh::addNavMeshAgent(NavMeshAgent *agent)
 {
+    waitForCrowdUpdate();
     auto iter = std::find(_agentList.begin(), _agentList.end(), nullptr);
     if (iter != _agentList.end()){
         agent->addTo(_crowed);
@@ -448,6 +585,7 @@ void NavMesh::setDebugDrawEnable(bool enable)
 void NavMesh::debugDraw(Renderer* renderer)
 {
     if (_isDebugDrawEnabled){
+        waitForCrowdUpdate();
         _debugDraw.clear();
         dtDraw();
         _debugDraw.draw(renderer);
@@ -456,6 +594,10 @@ void NavMesh::debugDraw(Renderer* renderer)
 
 void NavMesh::update(float dt)
 {
+    waitForCrowdUpdate();
+    applyTileBuilds();
+    processPathRequests();
+
     for (auto iter : _agentList){
         if (iter)
             iter->preUpdate(dt);
@@ -466,27 +608,332 @@ void NavMesh::update(float dt)
             iter->preUpdate(dt);
     }
 
+    _crowdUpdateDelta = dt;
+    if (_asyncCrowdUpdate){
+        auto crowd = _crowed;
+        auto tileCache = _tileCache;
+        auto navMesh = _navMesh;
+        _crowdUpdate = JobSystem::getInstance()->schedule([crowd, tileCache, navMesh, dt]() {
+            if (crowd)
+                crowd->update(dt, nullptr);
+            if (tileCache)
+                tileCache->update(dt, navMesh);
+        });
+        return;
+    }
+
     if (_crowed)
         _crowed->update(dt, nullptr);
 
     if (_tileCache)
         _tileCache->update(dt, _navMesh);
 
+    finishCrowdUpdate();
+}
+
+void NavMesh::finishCrowdUpdate()
+{
     for (auto iter : _agentList){
         if (iter)
-            iter->postUpdate(dt);
+            iter->postUpdate(_crowdUpdateDelta);
     }
 
     for (auto iter : _obstacleList){
         if (iter)
-            iter->postUpdate(dt);
+            iter->postUpdate(_crowdUpdateDelta);
+    }
+}
+
+void NavMesh::setAsyncCrowdUpdate(bool enabled)
+{
+    if (enabled == _asyncCrowdUpdate) return;
+
+    waitForCrowdUpdate();
+    _asyncCrowdUpdate = enabled;
+    auto eventDispatcher = Director::getInstance()->getEventDispatcher();
+    if (enabled){
+        // the update overlaps the visit and the draw of the frame, it must be over before the next frame's updates run
+        _afterDrawListener = eventDispatcher->addCustomEventListener(Director::EVENT_AFTER_DRAW, [this](EventCustom* /*event*/) {
+            waitForCrowdUpdate();
+        });
+    }
+    else if (_afterDrawListener){
+        eventDispatcher->removeEventListener(_afterDrawListener);
+        _afterDrawListener = nullptr;
+    }
+}
+
+void NavMesh::waitForCrowdUpdate()
+{
+    if (_crowdUpdate){
+        JobSystem::getInstance()->wait(_crowdUpdate);
+        _crowdUpdate = nullptr;
+        finishCrowdUpdate();
+    }
+}
+
+unsigned int NavMesh::requestPath(const Vec3 &start, const Vec3 &end, const PathCallback &callback)
+{
+    PathRequest request;
+    request.id = ++_nextPathRequestId;
+    request.start = start;
+    request.end = end;
+    request.callback = callback;
+    _pathRequests.push_back(request);
+    return request.id;
+}
+
+void NavMesh::cancelPathRequest(unsigned int requestId)
+{
+    for (auto iter = _pathRequests.begin(); iter != _pathRequests.end(); ++iter){
+        if (iter->id == requestId){
+            // the search of the front request restarts from scratch with the next one
+            if (iter == _pathRequests.begin())
+                _slicedQueryActive = false;
+            _pathRequests.erase(iter);
+            return;
+        }
+    }
+}
+
+void NavMesh::setPathQueryBudget(int maxIterations)
+{
+    _pathQueryBudget = std::max(maxIterations, 1);
+}
+
+void NavMesh::processPathRequests()
+{
+    if (!_slicedQuery) return;
+
+    static const float ext[3] = { 2, 4, 2 };
+    int budget = _pathQueryBudget;
+    while (budget > 0 && !_pathRequests.empty())
+    {
+        auto &request = _pathRequests.front();
+        dtStatus status = DT_FAILURE;
+        if (!_slicedQueryActive){
+            dtPolyRef endRef = 0;
+            _slicedStartRef = 0;
+            _slicedQuery->findNearestPoly(&request.start.x, ext, &_pathQueryFilter, &_slicedStartRef, 0);
+            _slicedQuery->findNearestPoly(&request.end.x, ext, &_pathQueryFilter, &endRef, 0);
+            status = _slicedQuery->initSlicedFindPath(_slicedStartRef, endRef, &request.start.x, &request.end.x, &_pathQueryFilter);
+            _slicedQueryActive = !dtStatusFailed(status);
+            if (!_slicedQueryActive)
+                --budget;
+        }
+
+        if (_slicedQueryActive){
+            int doneIters = 0;
+            status = _slicedQuery->updateSlicedFindPath(budget, &doneIters);
+            // a request found without iterating still costs one, so a flood of them can't stall the frame
+            budget -= std::max(doneIters, 1);
+            if (dtStatusInProgress(status))
+                break;
+        }
+
+        std::vector<Vec3> pathPoints;
+        if (_slicedQueryActive && dtStatusSucceed(status)){
+            dtPolyRef polys[MAX_POLYS];
+            int npolys = 0;
+            _slicedQuery->finalizeSlicedFindPath(polys, &npolys, MAX_POLYS);
+            smoothPath(_slicedQuery, _slicedStartRef, request.start, request.end, polys, npolys, pathPoints);
+        }
+        _slicedQueryActive = false;
+
+        // the callback may request or cancel paths, the request leaves the queue first
+        auto id = request.id;
+        auto callback = request.callback;
+        _pathRequests.pop_front();
+        if (callback)
+            callback(id, pathPoints);
+    }
+}
+
+void NavMesh::streamTiles(const Vec3 &center, float radius)
+{
+    if (!_tileStreaming) return;
+
+    int minX, minY, maxX, maxY;
+    getTileCoordinates(center - Vec3(radius, 0.0f, radius), minX, minY);
+    getTileCoordinates(center + Vec3(radius, 0.0f, radius), maxX, maxY);
+
+    std::vector<long long> outside;
+    for (auto key : _loadedTiles){
+        int tx = (int)(key >> 32);
+        int ty = (int)(unsigned int)(key & 0xffffffff);
+        if (tx < minX || tx > maxX || ty < minY || ty > maxY)
+            outside.push_back(key);
+    }
+    for (auto key : outside){
+        unloadTile((int)(key >> 32), (int)(unsigned int)(key & 0xffffffff));
+    }
+
+    for (int ty = minY; ty <= maxY; ++ty){
+        for (int tx = minX; tx <= maxX; ++tx){
+            loadTile(tx, ty);
+        }
+    }
+}
+
+void NavMesh::loadTile(int tx, int ty)
+{
+    if (!_tileStreaming) return;
+
+    auto key = tileKey(tx, ty);
+    if (_loadedTiles.find(key) != _loadedTiles.end()) return;
+    auto iter = _tileLayers.find(key);
+    if (iter == _tileLayers.end()) return;
+
+    waitForCrowdUpdate();
+    _loadedTiles.insert(key);
+    scheduleTileBuild(tx, ty, iter->second);
+}
+
+void NavMesh::unloadTile(int tx, int ty)
+{
+    if (!_tileStreaming) return;
+
+    waitForCrowdUpdate();
+    // a build still running for the tile is dropped by applyTileBuilds()
+    if (_loadedTiles.erase(tileKey(tx, ty)))
+        removeTileAt(tx, ty);
+}
+
+bool NavMesh::isTileLoaded(int tx, int ty) const
+{
+    if (!_tileStreaming)
+        return _tileCache != nullptr;
+    return _loadedTiles.find(tileKey(tx, ty)) != _loadedTiles.end();
+}
+
+void NavMesh::getTileCoordinates(const Vec3 &position, int &tx, int &ty) const
+{
+    tx = ty = 0;
+    if (!_tileCache) return;
+
+    const dtTileCacheParams *params = _tileCache->getParams();
+    tx = (int)floorf((position.x - params->orig[0]) / (params->width * params->cs));
+    ty = (int)floorf((position.z - params->orig[2]) / (params->height * params->cs));
+}
+
+void NavMesh::rebuildTile(int tx, int ty, const std::vector<Data> &layers)
+{
+    if (!_tileCache) return;
+
+    waitForCrowdUpdate();
+    if (_tileStreaming){
+        auto key = tileKey(tx, ty);
+        _tileLayers[key] = layers;
+        // an unloaded tile is built from the new layers once loaded
+        if (_loadedTiles.find(key) == _loadedTiles.end())
+            return;
+    }
+    scheduleTileBuild(tx, ty, layers);
+}
+
+void NavMesh::scheduleTileBuild(int tx, int ty, const std::vector<Data> &layers)
+{
+    auto build = std::make_shared<TileBuild>();
+    build->tx = tx;
+    build->ty = ty;
+    build->layers = layers;
+
+    std::vector<ObstacleCylinder> obstacles;
+    for (auto iter : _obstacleList){
+        if (iter){
+            const dtTileCacheObstacle* ob = _tileCache->getObstacleByRef(iter->_obstacleID);
+            if (!ob || ob->state == DT_OBSTACLE_EMPTY || ob->state == DT_OBSTACLE_REMOVING) continue;
+            ObstacleCylinder cylinder;
+            dtVcopy(cylinder.pos, ob->pos);
+            cylinder.radius = ob->radius;
+            cylinder.height = ob->height;
+            obstacles.push_back(cylinder);
+        }
+    }
+
+    auto target = build.get();
+    auto params = *_tileCache->getParams();
+    auto meshProcess = _meshProcess;
+    build->job = JobSystem::getInstance()->schedule([target, params, obstacles, meshProcess]() {
+        buildTileNavData(target->layers, params, obstacles, meshProcess, target->navData);
+    });
+    _tileBuilds.push_back(build);
+}
+
+void NavMesh::applyTileBuilds()
+{
+    // the builds are applied in order, a tile rebuilt twice ends with its latest layers
+    while (!_tileBuilds.empty() && JobSystem::getInstance()->isFinished(_tileBuilds.front()->job))
+    {
+        auto build = _tileBuilds.front();
+        _tileBuilds.pop_front();
+
+        if (_tileStreaming && _loadedTiles.find(tileKey(build->tx, build->ty)) == _loadedTiles.end()){
+            for (auto &data : build->navData)
+                dtFree(data.first);
+            continue;
+        }
+
+        removeTileAt(build->tx, build->ty);
+        for (auto &layer : build->layers){
+            unsigned char* tileData = (unsigned char*)dtAlloc((int)layer.getSize(), DT_ALLOC_PERM);
+            if (!tileData) break;
+            memcpy(tileData, layer.getBytes(), layer.getSize());
+            if (dtStatusFailed(_tileCache->addTile(tileData, (int)layer.getSize(), DT_COMPRESSEDTILE_FREE_DATA, nullptr)))
+                dtFree(tileData);
+        }
+        for (auto &data : build->navData){
+            if (dtStatusFailed(_navMesh->addTile(data.first, data.second, DT_TILE_FREE_DATA, 0, nullptr)))
+                dtFree(data.first);
+        }
+        build->navData.clear();
+        refreshObstaclesAt(build->tx, build->ty);
+    }
+}
+
+void NavMesh::removeTileAt(int tx, int ty)
+{
+    dtCompressedTileRef compressedTiles[MAX_TILE_LAYERS];
+    int count = _tileCache->getTilesAt(tx, ty, compressedTiles, MAX_TILE_LAYERS);
+    for (int i = 0; i < count; ++i){
+        _tileCache->removeTile(compressedTiles[i], nullptr, nullptr);
+    }
+
+    const dtMeshTile* meshTiles[MAX_TILE_LAYERS];
+    dtTileRef meshTileRefs[MAX_TILE_LAYERS];
+    count = _navMesh->getTilesAt(tx, ty, meshTiles, MAX_TILE_LAYERS);
+    for (int i = 0; i < count; ++i){
+        meshTileRefs[i] = _navMesh->getTileRef(meshTiles[i]);
+    }
+    for (int i = 0; i < count; ++i){
+        _navMesh->removeTile(meshTileRefs[i], nullptr, nullptr);
+    }
+}
+
+void NavMesh::refreshObstaclesAt(int tx, int ty)
+{
+    // the obstacles remember the compressed tiles they touch, the ones over the tile are added again to touch its new tiles
+    const dtTileCacheParams *params = _tileCache->getParams();
+    const float tileWidth = params->width * params->cs;
+    const float tileHeight = params->height * params->cs;
+    const float minX = params->orig[0] + tx * tileWidth;
+    const float minZ = params->orig[2] + ty * tileHeight;
+    for (auto iter : _obstacleList){
+        if (iter){
+            const dtTileCacheObstacle* ob = _tileCache->getObstacleByRef(iter->_obstacleID);
+            if (!ob || ob->state == DT_OBSTACLE_EMPTY || ob->state == DT_OBSTACLE_REMOVING) continue;
+            float bmin[3], bmax[3];
+            _tileCache->getObstacleBounds(ob, bmin, bmax);
+            if (bmax[0] < minX || bmin[0] > minX + tileWidth || bmax[2] < minZ || bmin[2] > minZ + tileHeight) continue;
+            iter->removeFrom(_tileCache);
+            iter->addTo(_tileCache);
+        }
     }
 }
 
 void cocos2d::NavMesh::findPath(const Vec3 &start, const Vec3 &end, std::vector<Vec3> &pathPoints)
 {
-    static const int MAX_POLYS = 256;
-    static const int MAX_SMOOTH = 2048;
+    waitForCrowdUpdate();
     float ext[3];
     ext[0] = 2; ext[1] = 4; ext[2] = 2;
     dtQueryFilter filter;
@@ -497,6 +944,12 @@ void cocos2d::NavMesh::findPath(const Vec3 &start, const Vec3 &end, std::vector<
     _navMeshQuery->findNearestPoly(&end.x, ext, &filter, &endRef, 0);
     _navMeshQuery->findPath(startRef, endRef, &start.x, &end.x, &filter, polys, &npolys, MAX_POLYS);
 
+    smoothPath(_navMeshQuery, startRef, start, end, polys, npolys, pathPoints);
+}
+
+void NavMesh::smoothPath(dtNavMeshQuery *query, dtPolyRef startRef, const Vec3 &start, const Vec3 &end, dtPolyRef *polys, int npolys, std::vector<Vec3> &pathPoints)
+{
+    dtQueryFilter filter;
     if (npolys)
     {
         //// Iterate over the path to find smooth path on the detail mesh surface.
@@ -505,8 +958,8 @@ void cocos2d::NavMesh::findPath(const Vec3 &start, const Vec3 &end, std::vector<
         //int npolys = npolys;
 
         float iterPos[3], targetPos[3];
-        _navMeshQuery->closestPointOnPoly(startRef, &start.x, iterPos, 0);
-        _navMeshQuery->closestPointOnPoly(polys[npolys - 1], &end.x, targetPos, 0);
+        query->closestPointOnPoly(startRef, &start.x, iterPos, 0);
+        query->closestPointOnPoly(polys[npolys - 1], &end.x, targetPos, 0);
 
         static const float STEP_SIZE = 0.5f;
         static const float SLOP = 0.01f;
@@ -527,7 +980,7 @@ void cocos2d::NavMesh::findPath(const Vec3 &start, const Vec3 &end, std::vector<
             unsigned char steerPosFlag;
             dtPolyRef steerPosRef;
 
-            if (!getSteerTarget(_navMeshQuery, iterPos, targetPos, SLOP,
+            if (!getSteerTarget(query, iterPos, targetPos, SLOP,
                 polys, npolys, steerPos, steerPosFlag, steerPosRef))
                 break;
 
@@ -550,14 +1003,14 @@ void cocos2d::NavMesh::findPath(const Vec3 &start, const Vec3 &end, std::vector<
             float result[3];
             dtPolyRef visited[16];
             int nvisited = 0;
-            _navMeshQuery->moveAlongSurface(polys[0], iterPos, moveTgt, &filter,
+            query->moveAlongSurface(polys[0], iterPos, moveTgt, &filter,
                 result, visited, &nvisited, 16);
 
             npolys = fixupCorridor(polys, npolys, MAX_POLYS, visited, nvisited);
-            npolys = fixupShortcuts(polys, npolys, _navMeshQuery);
+            npolys = fixupShortcuts(polys, npolys, query);
 
             float h = 0;
-            _navMeshQuery->getPolyHeight(polys[0], result, &h);
+            query->getPolyHeight(polys[0], result, &h);
             result[1] = h;
             dtVcopy(iterPos, result);
 
@@ -615,7 +1068,7 @@ void cocos2d::NavMesh::findPath(const Vec3 &start, const Vec3 &end, std::vector<
                     // Move position at the other side of the off-mesh link.
                     dtVcopy(iterPos, endPos);
                     float eh = 0.0f;
-                    _navMeshQuery->getPolyHeight(polys[0], iterPos, &eh);
+                    query->getPolyHeight(polys[0], iterPos, &eh);
                     iterPos[1] = eh;
                 }
             }
@@ -29,12 +29,19 @@
 #if CC_USE_NAVMESH
 
 #include "base/CCRef.h"
+#include "base/CCAsyncTaskPool.h"
+#include "base/CCData.h"
 #include "math/Vec3.h"
 #include "recast/Detour/DetourNavMesh.h"
 #include "recast/Detour/DetourNavMeshQuery.h"
 #include "recast/DetourCrowd/DetourCrowd.h"
 #include "recast/DetourTileCache/DetourTileCache.h"
+#include <deque>
+#include <functional>
+#include <memory>
 #include <string>
+#include <unordered_map>
+#include <unordered_set>
 #include <vector>
 
 #include "navmesh/CCNavMeshAgent.h"
@@ -50,11 +57,20 @@ NS_CC_BEGIN
  * @{
  */
 class Renderer;
+class EventListenerCustom;
 /** @brief NavMesh: The NavMesh information container, include mesh, tileCache, and so on. */
 class CC_DLL NavMesh : public Ref
 {
 public:
 
+    /**
+    The callback of requestPath(), called on the cocos thread from update().
+
+    @param requestId The id returned by requestPath().
+    @param pathPoints The key points of path, empty if no path is found.
+    */
+    typedef std::function<void(unsigned int requestId, const std::vector<Vec3> &pathPoints)> PathCallback;
+
     /**
     Create navmesh
 
@@ -63,6 +79,16 @@ public:
     */
     static NavMesh* create(const std::string &navFilePath, const std::string &geomFilePath);
 
+    /**
+    Create navmesh which streams its tiles, no tile is loaded until loadTile() or streamTiles() is called.
+
+    The compressed tiles of the navmesh file stay in memory, the loaded tiles are built on JobSystem workers.
+    @param navFilePath The NavMesh File path.
+    @param geomFilePath The geometry File Path,include offmesh information,etc.
+    @since v3.14
+    */
+    static NavMesh* createWithTileStreaming(const std::string &navFilePath, const std::string &geomFilePath);
+
     /** update navmesh. */
     void update(float dt);
 
@@ -96,6 +122,76 @@ public:
     */
     void findPath(const Vec3 &start, const Vec3 &end, std::vector<Vec3> &pathPoints);
 
+    /**
+    Request a path on navmesh, found over the next frames by a sliced search.
+
+    The requests are searched in order by update(), within the budget set by setPathQueryBudget().
+    @param start The start search position in world coordinate system.
+    @param end The end search position in world coordinate system.
+    @param callback Called with the key points of path once the search is over.
+    @return The id of the request, to cancel it.
+    @since v3.14
+    */
+    unsigned int requestPath(const Vec3 &start, const Vec3 &end, const PathCallback &callback);
+
+    /** Cancel a path request, its callback is not called. @since v3.14 */
+    void cancelPathRequest(unsigned int requestId);
+
+    /** Set the maximum search iterations spent on the path requests per update, 100 by default. @since v3.14 */
+    void setPathQueryBudget(int maxIterations);
+
+    /** Get the maximum search iterations spent on the path requests per update. @since v3.14 */
+    int getPathQueryBudget() const { return _pathQueryBudget; }
+
+    /**
+    Update the crowd and the obstacles on a JobSystem worker while the frame is drawn, instead of blocking the cocos thread.
+
+    The update started by update() is waited for once the frame is drawn, then the agent and obstacle nodes are synchronized,
+    so they show the state of the previous update while the current one runs.
+    @since v3.14
+    */
+    void setAsyncCrowdUpdate(bool enabled);
+
+    /** Is the crowd updated asynchronously. @since v3.14 */
+    bool isAsyncCrowdUpdate() const { return _asyncCrowdUpdate; }
+
+    /** Wait for the asynchronous crowd update, if any, and synchronize the agent and obstacle nodes with it. @since v3.14 */
+    void waitForCrowdUpdate();
+
+    /**
+    Load the tiles overlapped by the square of half size radius around center, and unload the other tiles.
+    Only a navmesh created by createWithTileStreaming() streams its tiles.
+
+    @param center The center of the square in world coordinate system, usually the player position.
+    @param radius The half size of the square.
+    @since v3.14
+    */
+    void streamTiles(const Vec3 &center, float radius);
+
+    /** Load a tile of a streaming navmesh, it's added to navmesh by update() once built on a worker. @since v3.14 */
+    void loadTile(int tx, int ty);
+
+    /** Unload a tile of a streaming navmesh. @since v3.14 */
+    void unloadTile(int tx, int ty);
+
+    /** Check a tile is loaded, or built to be loaded. @since v3.14 */
+    bool isTileLoaded(int tx, int ty) const;
+
+    /** Get the coordinates of the tile containing a position in world coordinate system. @since v3.14 */
+    void getTileCoordinates(const Vec3 &position, int &tx, int &ty) const;
+
+    /**
+    Replace the layers of a tile after the level geometry changed, its navmesh is rebuilt on a JobSystem worker
+    and replaces the old one in update().
+
+    @param tx The x coordinate of the tile.
+    @param ty The y coordinate of the tile.
+    @param layers The compressed tile cache layers baked from the new geometry, as stored in the navmesh file
+    (dtBuildTileCacheLayer() with the fastlz compressor).
+    @since v3.14
+    */
+    void rebuildTile(int tx, int ty, const std::vector<Data> &layers);
+
 CC_CONSTRUCTOR_ACCESS:
     NavMesh();
     virtual ~NavMesh();
@@ -110,6 +206,30 @@ protected:
     void drawAgents();
     void drawObstacles();
     void drawOffMeshConnections();
+    void processPathRequests();
+    void finishCrowdUpdate();
+    void scheduleTileBuild(int tx, int ty, const std::vector<Data> &layers);
+    void applyTileBuilds();
+    void removeTileAt(int tx, int ty);
+    void refreshObstaclesAt(int tx, int ty);
+    void smoothPath(dtNavMeshQuery *query, dtPolyRef startRef, const Vec3 &start, const Vec3 &end, dtPolyRef *polys, int npolys, std::vector<Vec3> &pathPoints);
+
+    struct PathRequest
+    {
+        unsigned int id;
+        Vec3 start;
+        Vec3 end;
+        PathCallback callback;
+    };
+
+    struct TileBuild
+    {
+        int tx;
+        int ty;
+        std::vector<Data> layers;
+        std::vector<std::pair<unsigned char*, int> > navData;
+        JobSystem::JobHandle job;
+    };
 
 protected:
 
@@ -128,6 +248,24 @@ protected:
     std::string _navFilePath;
     std::string _geomFilePath;
     bool _isDebugDrawEnabled;
+
+    dtNavMeshQuery *_slicedQuery;
+    dtQueryFilter _pathQueryFilter;
+    std::deque<PathRequest> _pathRequests;
+    bool _slicedQueryActive;
+    dtPolyRef _slicedStartRef;
+    unsigned int _nextPathRequestId;
+    int _pathQueryBudget;
+
+    bool _asyncCrowdUpdate;
+    float _crowdUpdateDelta;
+    JobSystem::JobHandle _crowdUpdate;
+    EventListenerCustom* _afterDrawListener;
+
+    bool _tileStreaming;
+    std::unordered_map<long long, std::vector<Data> > _tileLayers;
+    std::unordered_set<long long> _loadedTiles;
+    std::deque<std::shared_ptr<TileBuild> > _tileBuilds;
 };
 
 /** @} */
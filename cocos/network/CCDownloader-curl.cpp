@@ -25,6 +25,9 @@
 #include "network/CCDownloader-curl.h"
 
 #include <set>
+#include <atomic>
+#include <chrono>
+#include <algorithm>
 
 #include <curl/curl.h>
 
@@ -41,6 +44,86 @@
 namespace cocos2d { namespace network {
     using namespace std;
 
+////////////////////////////////////////////////////////////////////////////////
+//  Implementation BandwidthThrottleCURL
+    // token bucket shared by all transfers of one downloader,
+    // only the limit is set from main thread, everything else is used in DownloaderCURL::_threadProc
+    class BandwidthThrottleCURL
+    {
+    public:
+        BandwidthThrottleCURL()
+        : _maxBytesPerSecond(0)
+        , _tokens(0)
+        , _lastRefill(chrono::steady_clock::now())
+        {
+        }
+
+        void setMaxBytesPerSecond(int64_t value)
+        {
+            _maxBytesPerSecond = value;
+        }
+
+        // returns false if the transfer should pause until refillProc() hands out new tokens
+        bool consumeProc(CURL *handle, size_t bytes)
+        {
+            if (_maxBytesPerSecond <= 0)
+            {
+                return true;
+            }
+            if (_tokens <= 0)
+            {
+                if (_paused.end() == find(_paused.begin(), _paused.end(), handle))
+                {
+                    _paused.push_back(handle);
+                }
+                return false;
+            }
+            _tokens -= bytes;
+            return true;
+        }
+
+        void refillProc()
+        {
+            auto now = chrono::steady_clock::now();
+            int64_t limit = _maxBytesPerSecond;
+            if (limit > 0)
+            {
+                // at most one second worth of data is saved up
+                int64_t elapsedUS = chrono::duration_cast<chrono::microseconds>(now - _lastRefill).count();
+                elapsedUS = std::min<int64_t>(elapsedUS, 1000000);
+                _tokens = std::min(limit, _tokens + limit * elapsedUS / 1000000);
+            }
+            _lastRefill = now;
+
+            if (_paused.size() && (limit <= 0 || _tokens > 0))
+            {
+                // resuming may deliver data and pause the handle again immediately
+                vector<CURL*> paused;
+                paused.swap(_paused);
+                for (auto handle : paused)
+                {
+                    curl_easy_pause(handle, CURLPAUSE_CONT);
+                }
+            }
+        }
+
+        void forgetProc(CURL *handle)
+        {
+            _paused.erase(std::remove(_paused.begin(), _paused.end(), handle), _paused.end());
+        }
+
+        bool hasPausedProc() const
+        {
+            return _paused.size() > 0;
+        }
+
+    private:
+        atomic<int64_t> _maxBytesPerSecond;
+        int64_t _tokens;
+        chrono::steady_clock::time_point _lastRefill;
+        vector<CURL*> _paused;
+    };
+
 ////////////////////////////////////////////////////////////////////////////////
 //  Implementation DownloadTaskCURL
 
@@ -54,9 +137,22 @@ namespace cocos2d { namespace network {
     public:
         int serialId;
 
+        // a byte range of a segmented file task, written at its own offset of the preallocated temp file
+        struct Segment
+        {
+            DownloadTaskCURL *task;
+            CURL    *handle;        // nullptr if the segment isn't transferring
+            int64_t begin;
+            int64_t end;            // exclusive
+            int64_t written;
+            uint32_t retries;
+        };
+
         DownloadTaskCURL()
         : serialId(_sSerialId++)
         , _fp(nullptr)
+        , _curlHandle(nullptr)
+        , _throttle(nullptr)
         {
             _initInternal();
             DLLOG("Construct DownloadTaskCURL %p", this);
@@ -188,6 +284,154 @@ namespace cocos2d { namespace network {
             return ret;
         }
 
+        size_t writeSegmentProc(Segment& segment, unsigned char *buffer, size_t size, size_t count)
+        {
+            lock_guard<mutex> lock(_mutex);
+            size_t ret = size * count;
+            if (nullptr == _fp || segment.written + (int64_t)ret > segment.end - segment.begin)
+            {
+                return 0;
+            }
+            if (0 != fseek(_fp, (long)(segment.begin + segment.written), SEEK_SET))
+            {
+                return 0;
+            }
+            ret = fwrite(buffer, 1, ret, _fp);
+            segment.written += ret;
+            _bytesReceived += ret;
+            _totalBytesReceived += ret;
+            return ret;
+        }
+
+        // split the file into count ranges, keeping the data of an earlier sequential download
+        void planSegmentsProc(uint32_t count, int64_t received)
+        {
+            _segments.clear();
+            int64_t length = (_totalBytesExpected + count - 1) / count;
+            for (int64_t begin = 0; begin < _totalBytesExpected; begin += length)
+            {
+                int64_t end = std::min(begin + length, _totalBytesExpected);
+                int64_t written = std::max<int64_t>(0, std::min(received - begin, end - begin));
+                Segment segment = { this, nullptr, begin, end, written, 0 };
+                _segments.push_back(segment);
+            }
+        }
+
+        // load the segments saved by an earlier attempt, fails if they don't describe a file of the expected size
+        bool loadSegmentsProc()
+        {
+            FILE *fp = fopen(FileUtils::getInstance()->getSuitableFOpen(_segmentsFileName()).c_str(), "rb");
+            if (nullptr == fp)
+            {
+                return false;
+            }
+            long long total = 0;
+            unsigned int count = 0;
+            bool ok = 2 == fscanf(fp, "%lld %u", &total, &count) && total == _totalBytesExpected && count > 0;
+            vector<Segment> segments;
+            int64_t covered = 0;
+            for (unsigned int i = 0; ok && i < count; ++i)
+            {
+                long long begin = 0, end = 0, written = 0;
+                ok = 3 == fscanf(fp, "%lld %lld %lld", &begin, &end, &written)
+                    && begin == covered && end > begin && written >= 0 && written <= end - begin;
+                Segment segment = { this, nullptr, begin, end, written, 0 };
+                segments.push_back(segment);
+                covered = end;
+            }
+            fclose(fp);
+            ok = ok && covered == total;
+            if (ok)
+            {
+                _segments.swap(segments);
+            }
+            return ok;
+        }
+
+        void saveSegmentsProc()
+        {
+            lock_guard<mutex> lock(_mutex);
+            // the saved progress must not be ahead of the data on disk
+            if (_fp)
+            {
+                fflush(_fp);
+            }
+            FILE *fp = fopen(FileUtils::getInstance()->getSuitableFOpen(_segmentsFileName()).c_str(), "wb");
+            if (nullptr == fp)
+            {
+                return;
+            }
+            fprintf(fp, "%lld %u\n", (long long)_totalBytesExpected, (unsigned int)_segments.size());
+            for (auto& segment : _segments)
+            {
+                fprintf(fp, "%lld %lld %lld\n", (long long)segment.begin, (long long)segment.end, (long long)segment.written);
+            }
+            fclose(fp);
+        }
+
+        // keep the segments for a later attempt if the task failed, forget them otherwise
+        void finishSegmentsProc()
+        {
+            if (DownloadTask::ERROR_NO_ERROR == _errCode)
+            {
+                FileUtils::getInstance()->removeFile(_segmentsFileName());
+            }
+            else
+            {
+                saveSegmentsProc();
+            }
+        }
+
+        bool hasRunningSegmentsProc() const
+        {
+            for (auto& segment : _segments)
+            {
+                if (segment.handle)
+                {
+                    return true;
+                }
+            }
+            return false;
+        }
+
+        // reopen the temp file for writing, truncating it or preallocating it for random access
+        bool reopenFileProc(bool truncate, bool preallocate)
+        {
+            lock_guard<mutex> lock(_mutex);
+            if (_fp)
+            {
+                fclose(_fp);
+            }
+            string path = FileUtils::getInstance()->getSuitableFOpen(_tempFileName);
+            _fp = truncate ? nullptr : fopen(path.c_str(), preallocate ? "r+b" : "ab");
+            if (nullptr == _fp)
+            {
+                _fp = fopen(path.c_str(), preallocate ? "w+b" : "wb");
+            }
+            if (nullptr == _fp)
+            {
+                return false;
+            }
+            if (truncate)
+            {
+                _totalBytesReceived = 0;
+            }
+            if (preallocate && 0 == fseek(_fp, 0, SEEK_END) && ftell(_fp) < _totalBytesExpected)
+            {
+                fseek(_fp, (long)(_totalBytesExpected - 1), SEEK_SET);
+                fputc(0, _fp);
+            }
+            if (preallocate)
+            {
+                _totalBytesReceived = 0;
+                for (auto& segment : _segments)
+                {
+                    _totalBytesReceived += segment.written;
+                }
+            }
+            return true;
+        }
+
     private:
         friend class DownloaderCURL;
 
@@ -216,6 +460,16 @@ namespace cocos2d { namespace network {
         vector<unsigned char> _buf;
         FILE*  _fp;
 
+        // transfer, only used in thread proc
+        CURL*  _curlHandle;
+        BandwidthThrottleCURL* _throttle;
+        vector<Segment> _segments;  // empty if the task isn't downloaded in segments
+
+        string _segmentsFileName() const
+        {
+            return _tempFileName + ".segments";
+        }
+
         void _initInternal()
         {
             _acceptRanges = (false);
@@ -307,6 +561,11 @@ namespace cocos2d { namespace network {
             _finishedQueue.clear();
         }
 
+        void setMaxBytesPerSecond(int64_t value)
+        {
+            _throttle.setMaxBytesPerSecond(value);
+        }
+
     private:
         static size_t _outputHeaderCallbackProc(void *buffer, size_t size, size_t count, void *userdata)
         {
@@ -323,9 +582,32 @@ namespace cocos2d { namespace network {
             DownloadTaskCURL *coTask = (DownloadTaskCURL*)userdata;
 
             // If your callback function returns CURL_WRITEFUNC_PAUSE it will cause this transfer to become paused.
+            if (false == coTask->_throttle->consumeProc(coTask->_curlHandle, size * count))
+            {
+                return CURL_WRITEFUNC_PAUSE;
+            }
             return coTask->writeDataProc((unsigned char *)buffer, size, count);
         }
 
+        static size_t _outputSegmentCallbackProc(void *buffer, size_t size, size_t count, void *userdata)
+        {
+            DownloadTaskCURL::Segment& segment = *((DownloadTaskCURL::Segment*)userdata);
+
+            // a server ignoring the range would write the whole file over this segment
+            long httpResponseCode = 0;
+            curl_easy_getinfo(segment.handle, CURLINFO_RESPONSE_CODE, &httpResponseCode);
+            if (206 != httpResponseCode)
+            {
+                return 0;
+            }
+
+            if (false == segment.task->_throttle->consumeProc(segment.handle, size * count))
+            {
+                return CURL_WRITEFUNC_PAUSE;
+            }
+            return segment.task->writeSegmentProc(segment, (unsigned char *)buffer, size, count);
+        }
+
         // this function designed call in work thread
         // the curl handle destroyed in _threadProc
         // handle inited for get header
@@ -392,6 +674,160 @@ namespace cocos2d { namespace network {
             }
         }
 
+        // handle inited for download the remaining range of a segment
+        void _initSegmentHandleProc(CURL *handle, TaskWrapper& wrapper, DownloadTaskCURL::Segment& segment)
+        {
+            _initCurlHandleProc(handle, wrapper, true);
+
+            char range[64] = {0};
+            sprintf(range, "%lld-%lld", (long long)(segment.begin + segment.written), (long long)(segment.end - 1));
+            curl_easy_setopt(handle, CURLOPT_RESUME_FROM_LARGE, (curl_off_t)0);
+            curl_easy_setopt(handle, CURLOPT_RANGE, range);
+            curl_easy_setopt(handle, CURLOPT_WRITEFUNCTION, DownloaderCURL::Impl::_outputSegmentCallbackProc);
+            curl_easy_setopt(handle, CURLOPT_WRITEDATA, &segment);
+            curl_easy_setopt(handle, CURLOPT_PRIVATE, &segment);
+            segment.handle = handle;
+        }
+
+        // after get header info, decide whether the file task is downloaded in segments
+        // the segments of an earlier attempt are resumed even if segmenting is disabled now, because the temp file is preallocated
+        bool _prepareSegmentsProc(TaskWrapper& wrapper, bool& segmented)
+        {
+            DownloadTaskCURL& coTask = *wrapper.second;
+            segmented = false;
+            if (0 == coTask._tempFileName.length())
+            {
+                // data task
+                return true;
+            }
+
+            auto util = FileUtils::getInstance();
+            bool resume = util->isFileExist(coTask._segmentsFileName());
+            bool truncate = false;
+            if (resume && !(coTask._acceptRanges && coTask.loadSegmentsProc()))
+            {
+                // the preallocated temp file can't be resumed, start over
+                util->removeFile(coTask._segmentsFileName());
+                resume = false;
+                truncate = true;
+            }
+
+            bool split = coTask._acceptRanges
+                && hints.countOfSegmentsPerTask > 1
+                && coTask._totalBytesExpected > 0
+                && coTask._totalBytesExpected >= hints.minSizeOfSegmentedFile;
+            if (!resume && !split)
+            {
+                if (truncate && false == coTask.reopenFileProc(true, false))
+                {
+                    coTask.setErrorProc(DownloadTask::ERROR_FILE_OP_FAILED, 0, "Can't open file.");
+                    return false;
+                }
+                return true;
+            }
+
+            if (!resume)
+            {
+                coTask.planSegmentsProc(hints.countOfSegmentsPerTask, truncate ? 0 : coTask._totalBytesReceived);
+            }
+            if (false == coTask.reopenFileProc(truncate, true))
+            {
+                coTask.setErrorProc(DownloadTask::ERROR_FILE_OP_FAILED, 0, "Can't open file.");
+                return false;
+            }
+            segmented = true;
+            return true;
+        }
+
+        // add a transfer for every unfinished segment of the task
+        void _startSegmentsProc(CURLM *curlmHandle, unordered_map<CURL*, TaskWrapper>& coTaskMap, TaskWrapper& wrapper)
+        {
+            DownloadTaskCURL& coTask = *wrapper.second;
+            for (auto& segment : coTask._segments)
+            {
+                if (segment.written == segment.end - segment.begin)
+                {
+                    continue;
+                }
+
+                CURL *handle = curl_easy_init();
+                if (nullptr == handle)
+                {
+                    coTask.setErrorProc(DownloadTask::ERROR_IMPL_INTERNAL, 0, "Alloc curl handle failed.");
+                    break;
+                }
+                _initSegmentHandleProc(handle, wrapper, segment);
+                CURLMcode mcode = curl_multi_add_handle(curlmHandle, handle);
+                if (CURLM_OK != mcode)
+                {
+                    curl_easy_cleanup(handle);
+                    segment.handle = nullptr;
+                    coTask.setErrorProc(DownloadTask::ERROR_IMPL_INTERNAL, mcode, curl_multi_strerror(mcode));
+                    break;
+                }
+                coTaskMap[handle] = wrapper;
+            }
+
+            if (DownloadTask::ERROR_NO_ERROR != coTask._errCode)
+            {
+                _abortSegmentsProc(curlmHandle, coTaskMap, coTask, nullptr);
+            }
+        }
+
+        // remove the transfers of all segments except the one given, which is cleaned by the caller
+        void _abortSegmentsProc(CURLM *curlmHandle, unordered_map<CURL*, TaskWrapper>& coTaskMap, DownloadTaskCURL& coTask, DownloadTaskCURL::Segment* except)
+        {
+            for (auto& segment : coTask._segments)
+            {
+                if (nullptr == segment.handle || &segment == except)
+                {
+                    continue;
+                }
+                _throttle.forgetProc(segment.handle);
+                curl_multi_remove_handle(curlmHandle, segment.handle);
+                curl_easy_cleanup(segment.handle);
+                coTaskMap.erase(segment.handle);
+                segment.handle = nullptr;
+            }
+        }
+
+        // a segment transfer finished, returns true if it is retried with the same handle
+        bool _onSegmentDoneProc(CURLM *curlmHandle, unordered_map<CURL*, TaskWrapper>& coTaskMap, TaskWrapper& wrapper, DownloadTaskCURL::Segment& segment, CURLcode errCode)
+        {
+            DownloadTaskCURL& coTask = *wrapper.second;
+            if (CURLE_OK == errCode && segment.written == segment.end - segment.begin)
+            {
+                coTask.saveSegmentsProc();
+                return false;
+            }
+
+            // the task has already failed in another segment
+            if (DownloadTask::ERROR_NO_ERROR != coTask._errCode)
+            {
+                return false;
+            }
+
+            if (segment.retries < hints.countOfSegmentRetries)
+            {
+                // resume the segment where it stopped
+                ++segment.retries;
+                curl_easy_reset(segment.handle);
+                _initSegmentHandleProc(segment.handle, wrapper, segment);
+                if (CURLM_OK == curl_multi_add_handle(curlmHandle, segment.handle))
+                {
+                    return true;
+                }
+            }
+
+            if (CURLE_OK == errCode)
+            {
+                errCode = CURLE_PARTIAL_FILE;
+            }
+            coTask.setErrorProc(DownloadTask::ERROR_IMPL_INTERNAL, errCode, curl_easy_strerror(errCode));
+            _abortSegmentsProc(curlmHandle, coTaskMap, coTask, &segment);
+            return false;
+        }
+
         // get header info, if success set handle to content download state
         bool _getHeaderInfoProc(CURL *handle, TaskWrapper& wrapper)
         {
@@ -488,6 +924,13 @@ namespace cocos2d { namespace network {
                         timeoutMS = 1000;
                     }
 
+                    // wake up in time to resume the transfers paused by bandwidth throttling
+                    static const long THROTTLE_INTERVAL_MS = 50;
+                    if (_throttle.hasPausedProc() && timeoutMS > THROTTLE_INTERVAL_MS)
+                    {
+                        timeoutMS = THROTTLE_INTERVAL_MS;
+                    }
+
                     /* get file descriptors from the transfers */
                     fd_set fdread;
                     fd_set fdwrite;
@@ -528,6 +971,8 @@ namespace cocos2d { namespace network {
 
                 if (coTaskMap.size())
                 {
+                    _throttle.refillProc();
+
                     mcode = CURLM_CALL_MULTI_PERFORM;
                     while(CURLM_CALL_MULTI_PERFORM == mcode)
                     {
@@ -548,53 +993,77 @@ namespace cocos2d { namespace network {
                             CURLcode errCode = m->data.result;
 
                             TaskWrapper wrapper = coTaskMap[curlHandle];
+                            DownloadTaskCURL::Segment *segment = nullptr;
+                            curl_easy_getinfo(curlHandle, CURLINFO_PRIVATE, (char **)&segment);
 
                             // remove from multi-handle
                             curl_multi_remove_handle(curlmHandle, curlHandle);
+                            _throttle.forgetProc(curlHandle);
                             bool reinited = false;
-                            do
+                            bool segmented = (nullptr != segment);
+                            if (segmented)
                             {
-                                if (CURLE_OK != errCode)
-                                {
-                                    wrapper.second->setErrorProc(DownloadTask::ERROR_IMPL_INTERNAL, errCode, curl_easy_strerror(errCode));
-                                    break;
-                                }
-
-                                // if the task is content download task, cleanup the handle
-                                if (wrapper.second->_headerAchieved)
-                                {
-                                    break;
-                                }
-
-                                // the task is get header task
-                                // first, we get info from response
-                                if (false == _getHeaderInfoProc(curlHandle, wrapper))
-                                {
-                                    // the error info has been set in _getHeaderInfoProc
-                                    break;
-                                }
-
-                                // after get header info success
-                                // wrapper.second->_totalBytesReceived inited by local file size
-                                // if the local file size equal with the content size from header, the file has downloaded finish
-                                if (wrapper.second->_totalBytesReceived &&
-                                    wrapper.second->_totalBytesReceived == wrapper.second->_totalBytesExpected)
-                                {
-                                    // the file has download complete
-                                    // break to move this task to finish queue
-                                    break;
-                                }
-                                // reinit curl handle for download content
-                                curl_easy_reset(curlHandle);
-                                _initCurlHandleProc(curlHandle, wrapper, true);
-                                mcode = curl_multi_add_handle(curlmHandle, curlHandle);
-                                if (CURLM_OK != mcode)
+                                reinited = _onSegmentDoneProc(curlmHandle, coTaskMap, wrapper, *segment, errCode);
+                            }
+                            else
+                            {
+                                do
                                 {
-                                    wrapper.second->setErrorProc(DownloadTask::ERROR_IMPL_INTERNAL, mcode, curl_multi_strerror(mcode));
-                                    break;
-                                }
-                                reinited = true;
-                            } while (0);
+                                    if (CURLE_OK != errCode)
+                                    {
+                                        wrapper.second->setErrorProc(DownloadTask::ERROR_IMPL_INTERNAL, errCode, curl_easy_strerror(errCode));
+                                        break;
+                                    }
+
+                                    // if the task is content download task, cleanup the handle
+                                    if (wrapper.second->_headerAchieved)
+                                    {
+                                        break;
+                                    }
+
+                                    // the task is get header task
+                                    // first, we get info from response
+                                    if (false == _getHeaderInfoProc(curlHandle, wrapper))
+                                    {
+                                        // the error info has been set in _getHeaderInfoProc
+                                        break;
+                                    }
+
+                                    if (false == _prepareSegmentsProc(wrapper, segmented))
+                                    {
+                                        break;
+                                    }
+
+                                    // after get header info success
+                                    // wrapper.second->_totalBytesReceived inited by local file size
+                                    // if the local file size equal with the content size from header, the file has downloaded finish
+                                    if (wrapper.second->_totalBytesReceived &&
+                                        wrapper.second->_totalBytesReceived == wrapper.second->_totalBytesExpected)
+                                    {
+                                        // the file has download complete
+                                        // break to move this task to finish queue
+                                        break;
+                                    }
+
+                                    // large file, download the segments in parallel and clean up the header handle
+                                    if (segmented)
+                                    {
+                                        _startSegmentsProc(curlmHandle, coTaskMap, wrapper);
+                                        break;
+                                    }
+
+                                    // reinit curl handle for download content
+                                    curl_easy_reset(curlHandle);
+                                    _initCurlHandleProc(curlHandle, wrapper, true);
+                                    mcode = curl_multi_add_handle(curlmHandle, curlHandle);
+                                    if (CURLM_OK != mcode)
+                                    {
+                                        wrapper.second->setErrorProc(DownloadTask::ERROR_IMPL_INTERNAL, mcode, curl_multi_strerror(mcode));
+                                        break;
+                                    }
+                                    reinited = true;
+                                } while (0);
+                            }
 
                             if (reinited)
                             {
@@ -606,6 +1075,20 @@ namespace cocos2d { namespace network {
                            // remove from coTaskMap
                             coTaskMap.erase(curlHandle);
 
+                            if (segmented)
+                            {
+                                if (segment)
+                                {
+                                    segment->handle = nullptr;
+                                }
+                                // the other segments of the task are still downloading
+                                if (wrapper.second->hasRunningSegmentsProc())
+                                {
+                                    continue;
+                                }
+                                wrapper.second->finishSegmentsProc();
+                            }
+
                             // remove from _processSet
                             {
                                 lock_guard<mutex> lock(_processMutex);
@@ -624,7 +1107,12 @@ namespace cocos2d { namespace network {
                 }
 
                 // process tasks in _requestList
-                auto size = coTaskMap.size();
+                // a segmented task has several curl handles, so the processing tasks are counted instead of handles
+                size_t size = 0;
+                {
+                    lock_guard<mutex> lock(_processMutex);
+                    size = _processSet.size();
+                }
                 while (0 == countOfMaxProcessingTasks || size < countOfMaxProcessingTasks)
                 {
                     // get task wrapper from request queue
@@ -658,6 +1146,8 @@ namespace cocos2d { namespace network {
                     }
 
                     // init curl handle for get header info
+                    wrapper.second->_curlHandle = curlHandle;
+                    wrapper.second->_throttle = &_throttle;
                     _initCurlHandleProc(curlHandle, wrapper);
 
                     // add curl handle to process list
@@ -674,6 +1164,7 @@ namespace cocos2d { namespace network {
                     coTaskMap[curlHandle] = wrapper;
                     lock_guard<mutex> lock(_processMutex);
                     _processSet.insert(wrapper);
+                    ++size;
                 }
             } while (coTaskMap.size());
 
@@ -683,6 +1174,7 @@ namespace cocos2d { namespace network {
         }
 
         thread _thread;
+        BandwidthThrottleCURL _throttle;
         deque<TaskWrapper>  _requestQueue;
         set<TaskWrapper>    _processSet;
         deque<TaskWrapper>  _finishedQueue;
@@ -702,6 +1194,7 @@ namespace cocos2d { namespace network {
     {
         DLLOG("Construct DownloaderCURL %p", this);
         _impl->hints = hints;
+        _impl->setMaxBytesPerSecond(hints.maxBytesPerSecond);
         _scheduler = Director::getInstance()->getScheduler();
         _scheduler->retain();
 
@@ -739,6 +1232,11 @@ namespace cocos2d { namespace network {
         DLLOG("Destruct DownloaderCURL %p", this);
     }
 
+    void DownloaderCURL::setMaxBytesPerSecond(int64_t value)
+    {
+        _impl->setMaxBytesPerSecond(value);
+    }
+
     IDownloadTask *DownloaderCURL::createCoTask(std::shared_ptr<const DownloadTask>& task)
     {
         DownloadTaskCURL *coTask = new (std::nothrow) DownloadTaskCURL;
@@ -810,7 +1308,8 @@ namespace cocos2d { namespace network {
                 coTask._fp = nullptr;
                 do
                 {
-                    if (0 == coTask._fileName.length())
+                    // keep the temp file of a failed task, so the next attempt can resume it
+                    if (0 == coTask._fileName.length() || DownloadTask::ERROR_NO_ERROR != coTask._errCode)
                     {
                         break;
                     }
@@ -43,6 +43,8 @@ namespace cocos2d { namespace network
 
         virtual IDownloadTask *createCoTask(std::shared_ptr<const DownloadTask>& task) override;
 
+        virtual void setMaxBytesPerSecond(int64_t value) override;
+
     protected:
         class Impl;
         std::shared_ptr<Impl>   _impl;
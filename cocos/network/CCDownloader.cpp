@@ -62,7 +62,11 @@ namespace cocos2d { namespace network {
         {
             6,
             45,
-            ".tmp"
+            ".tmp",
+            4,
+            3,
+            8 * 1024 * 1024,
+            0
         };
         new(this)Downloader(hints);
     }
@@ -171,6 +175,11 @@ namespace cocos2d { namespace network {
         return task;
     }
 
+    void Downloader::setMaxBytesPerSecond(int64_t bytesPerSecond)
+    {
+        _impl->setMaxBytesPerSecond(bytesPerSecond);
+    }
+
 //std::string Downloader::getFileNameFromUrl(const std::string& srcUrl)
 //{
 //    // Find file name and file extension
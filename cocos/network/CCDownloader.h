@@ -63,6 +63,15 @@ namespace cocos2d { namespace network {
         uint32_t countOfMaxProcessingTasks;
         uint32_t timeoutInSeconds;
         std::string tempFileNameSuffix;
+
+        // file tasks of at least minSizeOfSegmentedFile bytes are split into countOfSegmentsPerTask
+        // range requests when the server accepts ranges, 0 or 1 downloads them as one stream
+        uint32_t countOfSegmentsPerTask;
+        uint32_t countOfSegmentRetries;
+        int64_t minSizeOfSegmentedFile;
+
+        // bandwidth of all tasks of the downloader, 0 means unlimited
+        int64_t maxBytesPerSecond;
     };
 
     class CC_DLL Downloader final
@@ -103,6 +112,9 @@ namespace cocos2d { namespace network {
 
         std::shared_ptr<const DownloadTask> createDownloadFileTask(const std::string& srcUrl, const std::string& storagePath, const std::string& identifier = "");
 
+        // change the bandwidth limit of DownloaderHints::maxBytesPerSecond while tasks are running
+        void setMaxBytesPerSecond(int64_t bytesPerSecond);
+
     private:
         std::unique_ptr<IDownloaderImpl> _impl;
     };
@@ -65,6 +65,9 @@ namespace cocos2d { namespace network
                            std::vector<unsigned char>& data)> onTaskFinish;
 
         virtual IDownloadTask *createCoTask(std::shared_ptr<const DownloadTask>& task) = 0;
+
+        // bandwidth throttling is optional, implementations without it ignore the limit
+        virtual void setMaxBytesPerSecond(int64_t /*value*/) {}
     };
 
 }}  // namespace cocos2d::network
@@ -704,9 +704,11 @@ void HttpClient::processResponse(HttpResponse* response, char* responseMessage)
     char* contentInfo = urlConnection.getResponseContent(response);
     if (nullptr != contentInfo) 
     {
-        std::vector<char> * recvBuffer = (std::vector<char>*)response->getResponseData();
-        recvBuffer->clear();
-        recvBuffer->insert(recvBuffer->begin(), (char*)contentInfo, ((char*)contentInfo) + urlConnection.getContentLength());
+        if (!response->appendResponseData(contentInfo, urlConnection.getContentLength()))
+        {
+            responseCode = -1;
+            strcpy(responseMessage, "Failed to store the response data");
+        }
     }
     free(contentInfo);
     
@@ -731,6 +733,7 @@ void HttpClient::processResponse(HttpResponse* response, char* responseMessage)
     {
         response->setSucceed(true);
     }
+    response->finishResponseData();
 }
 
 // Worker thread
@@ -881,6 +884,8 @@ HttpClient::HttpClient()
 : _isInited(false)
 , _timeoutForConnect(30)
 , _timeoutForRead(60)
+, _maxConcurrentRequests(8)
+, _maxConnectionsPerHost(4)
 , _threadCount(0)
 , _cookie(nullptr)
 , _requestSentinel(new HttpRequest())
@@ -929,13 +934,23 @@ void HttpClient::send(HttpRequest* request)
     request->retain();
 
     _requestQueueMutex.lock();
-    _requestQueue.pushBack(request);
+    addRequestToQueue(request);
     _requestQueueMutex.unlock();
 
     // Notify thread start to work
     _sleepCondition.notify_one();
 }
 
+AsyncOperation<RefPtr<HttpResponse>> HttpClient::sendAsync(HttpRequest* request)
+{
+    AsyncOperation<RefPtr<HttpResponse>> operation;
+    request->setResponseCallback([operation](HttpClient* /*client*/, HttpResponse* response) {
+        operation.resolve(response);
+    });
+    send(request);
+    return operation;
+}
+
 void HttpClient::sendImmediate(HttpRequest* request)
 {
     if(nullptr == request)
@@ -1037,6 +1052,30 @@ int HttpClient::getTimeoutForRead()
     std::lock_guard<std::mutex> lock(_timeoutForReadMutex);
     return _timeoutForRead;
 }
+
+void HttpClient::setMaxConcurrentRequests(int value)
+{
+    std::lock_guard<std::mutex> lock(_maxConcurrentRequestsMutex);
+    _maxConcurrentRequests = value;
+}
+
+int HttpClient::getMaxConcurrentRequests()
+{
+    std::lock_guard<std::mutex> lock(_maxConcurrentRequestsMutex);
+    return _maxConcurrentRequests;
+}
+
+void HttpClient::setMaxConnectionsPerHost(int value)
+{
+    std::lock_guard<std::mutex> lock(_maxConnectionsPerHostMutex);
+    _maxConnectionsPerHost = value;
+}
+
+int HttpClient::getMaxConnectionsPerHost()
+{
+    std::lock_guard<std::mutex> lock(_maxConnectionsPerHostMutex);
+    return _maxConnectionsPerHost;
+}
     
 const std::string& HttpClient::getCookieFilename()
 {
@@ -179,13 +179,13 @@ static int processTask(HttpClient* client, HttpRequest* request, NSString* reque
         }
     }
 
-    //read cookie properties from file and set cookie
+    //set the cookies of the url, they are kept in memory once the file was read
     std::string cookieFilename = client->getCookieFilename();
     if(!cookieFilename.empty() && nullptr != client->getCookie())
     {
-        const CookiesInfo* cookieInfo = client->getCookie()->getMatchCookie(request->getUrl());
-        if(cookieInfo != nullptr)
+        for (auto& matchCookie : client->getCookie()->getMatchCookies(request->getUrl()))
         {
+            const CookiesInfo* cookieInfo = &matchCookie;
             NSString *domain = [NSString stringWithCString:cookieInfo->domain.c_str() encoding:[NSString defaultCStringEncoding]];
             NSString *path = [NSString stringWithCString:cookieInfo->path.c_str() encoding:[NSString defaultCStringEncoding]];
             NSString *value = [NSString stringWithCString:cookieInfo->value.c_str() encoding:[NSString defaultCStringEncoding]];
@@ -267,6 +267,10 @@ static int processTask(HttpClient* client, HttpRequest* request, NSString* reque
             
             client->getCookie()->updateOrAddCookie(&cookieInfo);
         }
+        if (cookies.count > 0)
+        {
+            client->getCookie()->writeFileLater();
+        }
     }
     
     //handle response header
@@ -288,10 +292,14 @@ static int processTask(HttpClient* client, HttpRequest* request, NSString* reque
     headerBuffer->insert(headerBuffer->end(), (char*)headerptr, (char*)headerptr+headerlen);
 
     //handle response data
-    std::vector<char> *recvBuffer = (std::vector<char>*)stream;
+    HttpResponse *response = (HttpResponse*)stream;
     const void* ptr = [httpAsynConn.responseData bytes];
     long len = [httpAsynConn.responseData length];
-    recvBuffer->insert(recvBuffer->end(), (char*)ptr, (char*)ptr+len);
+    if (!response->appendResponseData((const char*)ptr, len))
+    {
+        strcpy(errorBuffer, "Failed to store the response data");
+        return 0;
+    }
 
     return 1;
 }
@@ -367,6 +375,8 @@ HttpClient::HttpClient()
 : _isInited(false)
 , _timeoutForConnect(30)
 , _timeoutForRead(60)
+, _maxConcurrentRequests(8)
+, _maxConnectionsPerHost(4)
 , _threadCount(0)
 , _cookie(nullptr)
 , _requestSentinel(new HttpRequest())
@@ -422,7 +432,7 @@ void HttpClient::send(HttpRequest* request)
     request->retain();
 
     _requestQueueMutex.lock();
-    _requestQueue.pushBack(request);
+    addRequestToQueue(request);
     _requestQueueMutex.unlock();
 
     // Notify thread start to work
@@ -515,7 +525,7 @@ void HttpClient::processResponse(HttpResponse* response, char* responseMessage)
     retValue = processTask(this,
                            request,
                            requestType,
-                           response->getResponseData(),
+                           response,
                            &responseCode,
                            response->getResponseHeader(),
                            responseMessage);
@@ -532,6 +542,7 @@ void HttpClient::processResponse(HttpResponse* response, char* responseMessage)
         response->setSucceed(false);
         response->setErrorBuffer(responseMessage);
     }
+    response->finishResponseData();
 }
 
 
@@ -583,6 +594,30 @@ int HttpClient::getTimeoutForRead()
     return _timeoutForRead;
 }
 
+void HttpClient::setMaxConcurrentRequests(int value)
+{
+    std::lock_guard<std::mutex> lock(_maxConcurrentRequestsMutex);
+    _maxConcurrentRequests = value;
+}
+
+int HttpClient::getMaxConcurrentRequests()
+{
+    std::lock_guard<std::mutex> lock(_maxConcurrentRequestsMutex);
+    return _maxConcurrentRequests;
+}
+
+void HttpClient::setMaxConnectionsPerHost(int value)
+{
+    std::lock_guard<std::mutex> lock(_maxConnectionsPerHostMutex);
+    _maxConnectionsPerHost = value;
+}
+
+int HttpClient::getMaxConnectionsPerHost()
+{
+    std::lock_guard<std::mutex> lock(_maxConnectionsPerHostMutex);
+    return _maxConnectionsPerHost;
+}
+
 const std::string& HttpClient::getCookieFilename()
 {
     std::lock_guard<std::mutex> lock(_cookieFileMutex);
@@ -307,6 +307,16 @@ namespace network {
         }
     }
 
+    AsyncOperation<RefPtr<HttpResponse>> HttpClient::sendAsync(HttpRequest* request)
+    {
+        AsyncOperation<RefPtr<HttpResponse>> operation;
+        request->setResponseCallback([operation](HttpClient* /*client*/, HttpResponse* response) {
+            operation.resolve(response);
+        });
+        send(request);
+        return operation;
+    }
+
     void HttpClient::sendImmediate(HttpRequest* request)
     {
         if (!request)
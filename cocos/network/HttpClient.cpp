@@ -26,6 +26,9 @@
 
 #include "network/HttpClient.h"
 #include <queue>
+#include <list>
+#include <sstream>
+#include <algorithm>
 #include <errno.h>
 #include <curl/curl.h>
 #include "base/CCDirector.h"
@@ -46,14 +49,12 @@ typedef size_t (*write_callback)(void *ptr, size_t size, size_t nmemb, void *str
 // Callback function used by libcurl for collect response data
 static size_t writeData(void *ptr, size_t size, size_t nmemb, void *stream)
 {
-    std::vector<char> *recvBuffer = (std::vector<char>*)stream;
+    HttpResponse *response = (HttpResponse*)stream;
     size_t sizes = size * nmemb;
     
-    // add data to the end of recvBuffer
-    // write data maybe called more than once in a single request
-    recvBuffer->insert(recvBuffer->end(), (char*)ptr, (char*)ptr+sizes);
-    
-    return sizes;
+    // hand data to the sink of the request or add it to the end of the response data
+    // write data maybe called more than once in a single request, returning less than sizes aborts it
+    return response->appendResponseData((char*)ptr, sizes) ? sizes : 0;
 }
 
 // Callback function used by libcurl for collect header data
@@ -70,67 +71,104 @@ static size_t writeHeaderData(void *ptr, size_t size, size_t nmemb, void *stream
 }
 
 
-static int processGetTask(HttpClient* client, HttpRequest* request, write_callback callback, void *stream, long *errorCode, write_callback headerCallback, void *headerStream, char* errorBuffer);
-static int processPostTask(HttpClient* client, HttpRequest* request, write_callback callback, void *stream, long *errorCode, write_callback headerCallback, void *headerStream, char* errorBuffer);
-static int processPutTask(HttpClient* client,  HttpRequest* request, write_callback callback, void *stream, long *errorCode, write_callback headerCallback, void *headerStream, char* errorBuffer);
-static int processDeleteTask(HttpClient* client,  HttpRequest* request, write_callback callback, void *stream, long *errorCode, write_callback headerCallback, void *headerStream, char* errorBuffer);
-// int processDownloadTask(HttpRequest *task, write_callback callback, void *stream, int32_t *errorCode);
+// Share handle used by all transfers, so DNS lookups, TLS sessions and cookies are reused between requests
+static CURLSH* s_curlShare = nullptr;
+static int s_curlShareUsers = 0;
+static std::mutex s_curlShareMutex;
+static std::mutex s_curlShareLocks[CURL_LOCK_DATA_LAST];
 
-// Worker thread
-void HttpClient::networkThread()
+static void lockCurlShare(CURL* /*handle*/, curl_lock_data data, curl_lock_access /*access*/, void* /*userptr*/)
 {
-    increaseThreadCount();
+    s_curlShareLocks[data].lock();
+}
 
-    while (true)
-    {
-        HttpRequest *request;
+static void unlockCurlShare(CURL* /*handle*/, curl_lock_data data, void* /*userptr*/)
+{
+    s_curlShareLocks[data].unlock();
+}
 
-        // step 1: send http request if the requestQueue isn't empty
+// A HttpClient being destroyed may still have threads running while a new one is created, so the share handle is reference counted
+static void retainCurlShare()
+{
+    std::lock_guard<std::mutex> lock(s_curlShareMutex);
+    if (s_curlShareUsers++ == 0)
+    {
+        s_curlShare = curl_share_init();
+        if (s_curlShare)
         {
-            std::lock_guard<std::mutex> lock(_requestQueueMutex);
-            while (_requestQueue.empty())
-            {
-                _sleepCondition.wait(_requestQueueMutex);
-            }
-            request = _requestQueue.at(0);
-            _requestQueue.erase(0);
+            curl_share_setopt(s_curlShare, CURLSHOPT_LOCKFUNC, lockCurlShare);
+            curl_share_setopt(s_curlShare, CURLSHOPT_UNLOCKFUNC, unlockCurlShare);
+            curl_share_setopt(s_curlShare, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+            curl_share_setopt(s_curlShare, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+            curl_share_setopt(s_curlShare, CURLSHOPT_SHARE, CURL_LOCK_DATA_COOKIE);
         }
+    }
+}
 
-        if (request == _requestSentinel) {
-            break;
-        }
-
-        // step 2: libcurl sync access
-        
-        // Create a HttpResponse object, the default setting is http access failed
-        HttpResponse *response = new (std::nothrow) HttpResponse(request);
-
-        processResponse(response, _responseMessage);
+// Copies the cookies of the share handle in the Netscape cookie file format
+static std::string getSharedCookies()
+{
+    std::string cookies;
+    CURL* handle = s_curlShare ? curl_easy_init() : nullptr;
+    if (!handle)
+    {
+        return cookies;
+    }
+    curl_easy_setopt(handle, CURLOPT_SHARE, s_curlShare);
 
+    curl_slist* list = nullptr;
+    if (CURLE_OK == curl_easy_getinfo(handle, CURLINFO_COOKIELIST, &list))
+    {
+        for (curl_slist* item = list; item; item = item->next)
+        {
+            cookies.append(item->data);
+            cookies.append(1, '\n');
+        }
+        curl_slist_free_all(list);
+    }
+    curl_easy_cleanup(handle);
+    return cookies;
+}
 
-        // add response packet into queue
-        _responseQueueMutex.lock();
-        _responseQueue.pushBack(response);
-        _responseQueueMutex.unlock();
+// Adds the cookies read from the cookie file to the share handle, the transfers don't read the file
+static void addSharedCookies(const std::string& cookies)
+{
+    CURL* handle = s_curlShare ? curl_easy_init() : nullptr;
+    if (!handle)
+    {
+        return;
+    }
+    curl_easy_setopt(handle, CURLOPT_SHARE, s_curlShare);
 
-        _schedulerMutex.lock();
-        if (nullptr != _scheduler)
+    std::stringstream stream(cookies);
+    std::string line;
+    while (std::getline(stream, line, '\n'))
+    {
+        if (!line.empty() && (line[0] != '#' || line.compare(0, 10, "#HttpOnly_") == 0))
         {
-            _scheduler->performFunctionInCocosThread(CC_CALLBACK_0(HttpClient::dispatchResponseCallbacks, this));
+            curl_easy_setopt(handle, CURLOPT_COOKIELIST, line.c_str());
         }
-        _schedulerMutex.unlock();
     }
-    
-    // cleanup: if worker thread received quit signal, clean up un-completed request queue
-    _requestQueueMutex.lock();
-    _requestQueue.clear();
-    _requestQueueMutex.unlock();
+    curl_easy_cleanup(handle);
+}
 
-    _responseQueueMutex.lock();
-    _responseQueue.clear();
-    _responseQueueMutex.unlock();
+static bool hasSetCookieHeader(const std::vector<char>& header)
+{
+    static const char SET_COOKIE[] = "set-cookie:";
+    auto match = std::search(header.begin(), header.end(), SET_COOKIE, SET_COOKIE + sizeof(SET_COOKIE) - 1, [](char a, char b) {
+        return ::tolower(a) == b;
+    });
+    return match != header.end();
+}
 
-    decreaseThreadCountAndMayDeleteThis();
+static void releaseCurlShare()
+{
+    std::lock_guard<std::mutex> lock(s_curlShareMutex);
+    if (--s_curlShareUsers == 0 && s_curlShare)
+    {
+        curl_share_cleanup(s_curlShare);
+        s_curlShare = nullptr;
+    }
 }
 
 // Worker thread
@@ -204,6 +242,15 @@ static bool configureCURL(HttpClient* client, CURL* handle, char* errorBuffer)
 
     curl_easy_setopt(handle, CURLOPT_ACCEPT_ENCODING, "");
 
+    if (s_curlShare)
+    {
+        curl_easy_setopt(handle, CURLOPT_SHARE, s_curlShare);
+    }
+#if LIBCURL_VERSION_NUM >= 0x072f00
+    // Negotiate HTTP/2 over TLS, libcurl built without nghttp2 keeps using HTTP/1.1
+    curl_easy_setopt(handle, CURLOPT_HTTP_VERSION, (long)CURL_HTTP_VERSION_2TLS);
+#endif
+
     return true;
 }
 
@@ -259,12 +306,9 @@ public:
             if (!setOption(CURLOPT_HTTPHEADER, _headers))
                 return false;
         }
-        std::string cookieFilename = client->getCookieFilename();
-        if (!cookieFilename.empty()) {
-            if (!setOption(CURLOPT_COOKIEFILE, cookieFilename.c_str())) {
-                return false;
-            }
-            if (!setOption(CURLOPT_COOKIEJAR, cookieFilename.c_str())) {
+        // the cookies are kept by the share handle, an empty file name enables them without reading the file
+        if (client->getCookie() != nullptr) {
+            if (!setOption(CURLOPT_COOKIEFILE, "")) {
                 return false;
             }
         }
@@ -277,11 +321,15 @@ public:
         
     }
 
-    /// @param responseCode Null not allowed
-    bool perform(long *responseCode)
+    /// Instance of CURL, to hand the transfer to a multi handle
+    CURL* getHandle() const
+    {
+        return _curl;
+    }
+
+    /// @param responseCode Null not allowed, fails unless the finished transfer got a 2xx response
+    bool getResponseCode(long *responseCode)
     {
-        if (CURLE_OK != curl_easy_perform(_curl))
-            return false;
         CURLcode code = curl_easy_getinfo(_curl, CURLINFO_RESPONSE_CODE, responseCode);
         if (code != CURLE_OK || !(*responseCode >= 200 && *responseCode < 300)) {
             CCLOGERROR("Curl curl_easy_getinfo failed: %s", curl_easy_strerror(code));
@@ -293,49 +341,230 @@ public:
     }
 };
 
-//Process Get Request
-static int processGetTask(HttpClient* client, HttpRequest* request, write_callback callback, void* stream, long* responseCode, write_callback headerCallback, void* headerStream, char* errorBuffer)
+//Sets up a request of any type, the response data and headers are written into response
+static bool prepareTask(HttpClient* client, CURLRaii& curl, HttpRequest* request, HttpResponse* response, char* errorBuffer)
 {
-    CURLRaii curl;
-    bool ok = curl.init(client, request, callback, stream, headerCallback, headerStream, errorBuffer)
-            && curl.setOption(CURLOPT_FOLLOWLOCATION, true)
-            && curl.perform(responseCode);
-    return ok ? 0 : 1;
+    if (!curl.init(client, request, writeData, response, writeHeaderData, response->getResponseHeader(), errorBuffer))
+        return false;
+
+    switch (request->getRequestType())
+    {
+    case HttpRequest::Type::GET: // HTTP GET
+        return curl.setOption(CURLOPT_FOLLOWLOCATION, true);
+
+    case HttpRequest::Type::POST: // HTTP POST
+        return curl.setOption(CURLOPT_POST, 1)
+            && curl.setOption(CURLOPT_POSTFIELDS, request->getRequestData())
+            && curl.setOption(CURLOPT_POSTFIELDSIZE, request->getRequestDataSize());
+
+    case HttpRequest::Type::PUT:
+        return curl.setOption(CURLOPT_CUSTOMREQUEST, "PUT")
+            && curl.setOption(CURLOPT_POSTFIELDS, request->getRequestData())
+            && curl.setOption(CURLOPT_POSTFIELDSIZE, request->getRequestDataSize());
+
+    case HttpRequest::Type::DELETE:
+        return curl.setOption(CURLOPT_CUSTOMREQUEST, "DELETE")
+            && curl.setOption(CURLOPT_FOLLOWLOCATION, true);
+
+    default:
+        CCASSERT(false, "CCHttpClient: unknown request type, only GET, POST, PUT or DELETE is supported");
+        return false;
+    }
 }
 
-//Process POST Request
-static int processPostTask(HttpClient* client, HttpRequest* request, write_callback callback, void* stream, long* responseCode, write_callback headerCallback, void* headerStream, char* errorBuffer)
+//Writes the result of a transfer to the response
+static void finishTask(HttpClient* client, CURLRaii& curl, bool succeed, HttpResponse* response, char* errorBuffer)
 {
-    CURLRaii curl;
-    bool ok = curl.init(client, request, callback, stream, headerCallback, headerStream, errorBuffer)
-            && curl.setOption(CURLOPT_POST, 1)
-            && curl.setOption(CURLOPT_POSTFIELDS, request->getRequestData())
-            && curl.setOption(CURLOPT_POSTFIELDSIZE, request->getRequestDataSize())
-            && curl.perform(responseCode);
-    return ok ? 0 : 1;
+    // the cookie file is written on a worker once the cookies changed
+    HttpCookie* cookie = client->getCookie();
+    if (cookie && hasSetCookieHeader(*response->getResponseHeader()))
+    {
+        cookie->writeFileLater([cookie]() {
+            cookie->setCookiesFromString(getSharedCookies());
+        });
+    }
+
+    long responseCode = -1;
+    if (succeed)
+    {
+        succeed = curl.getResponseCode(&responseCode);
+    }
+
+    response->setResponseCode(responseCode);
+    response->setSucceed(succeed);
+    if (!succeed)
+    {
+        response->setErrorBuffer(errorBuffer);
+    }
+    response->finishResponseData();
 }
 
-//Process PUT Request
-static int processPutTask(HttpClient* client, HttpRequest* request, write_callback callback, void* stream, long* responseCode, write_callback headerCallback, void* headerStream, char* errorBuffer)
+// How long the worker thread waits for socket activity before it looks at the request queue again
+static const int MULTI_WAIT_TIMEOUT_MS = 20;
+
+// A request transferred by the multi handle of the worker thread
+struct HttpTransfer
 {
     CURLRaii curl;
-    bool ok = curl.init(client, request, callback, stream, headerCallback, headerStream, errorBuffer)
-            && curl.setOption(CURLOPT_CUSTOMREQUEST, "PUT")
-            && curl.setOption(CURLOPT_POSTFIELDS, request->getRequestData())
-            && curl.setOption(CURLOPT_POSTFIELDSIZE, request->getRequestDataSize())
-            && curl.perform(responseCode);
-    return ok ? 0 : 1;
+    HttpResponse* response;
+    char errorBuffer[HttpClient::RESPONSE_BUFFER_SIZE];
+
+    explicit HttpTransfer(HttpResponse* resp)
+        : response(resp)
+    {
+        memset(errorBuffer, 0, sizeof(errorBuffer));
+    }
+};
+
+// Worker thread
+void HttpClient::networkThread()
+{
+    increaseThreadCount();
+
+    CURLM* multi = curl_multi_init();
+#if LIBCURL_VERSION_NUM >= 0x072b00
+    // Several transfers to the same host share one HTTP/2 connection
+    curl_multi_setopt(multi, CURLMOPT_PIPELINING, CURLPIPE_MULTIPLEX);
+#endif
+    int appliedConnectionsPerHost = -1;
+
+    std::list<HttpTransfer*> transfers;
+    std::vector<HttpRequest*> requests;
+    bool quit = false;
+
+    while (!quit)
+    {
+        // step 1: take as many requests from the requestQueue as the concurrency limit allows, it is sorted by priority
+        int maxConcurrentRequests = std::max(1, getMaxConcurrentRequests());
+        {
+            std::lock_guard<std::mutex> lock(_requestQueueMutex);
+            while (transfers.empty() && _requestQueue.empty())
+            {
+                _sleepCondition.wait(_requestQueueMutex);
+            }
+            while (!_requestQueue.empty() && (int)(transfers.size() + requests.size()) < maxConcurrentRequests)
+            {
+                HttpRequest* request = _requestQueue.at(0);
+                _requestQueue.erase(0);
+                if (request == _requestSentinel)
+                {
+                    quit = true;
+                    break;
+                }
+                requests.push_back(request);
+            }
+        }
+
+        if (quit)
+        {
+            break;
+        }
+
+#if LIBCURL_VERSION_NUM >= 0x071e00
+        int connectionsPerHost = getMaxConnectionsPerHost();
+        if (connectionsPerHost != appliedConnectionsPerHost)
+        {
+            curl_multi_setopt(multi, CURLMOPT_MAX_HOST_CONNECTIONS, (long)connectionsPerHost);
+            appliedConnectionsPerHost = connectionsPerHost;
+        }
+#endif
+
+        // step 2: hand the new requests to libcurl
+        for (auto request : requests)
+        {
+            // Create a HttpResponse object, the default setting is http access failed
+            HttpResponse* response = new (std::nothrow) HttpResponse(request);
+            HttpTransfer* transfer = new (std::nothrow) HttpTransfer(response);
+
+            bool added = prepareTask(this, transfer->curl, request, response, transfer->errorBuffer)
+#if LIBCURL_VERSION_NUM >= 0x072b00
+                && transfer->curl.setOption(CURLOPT_PIPEWAIT, 1L)
+#endif
+                && transfer->curl.setOption(CURLOPT_PRIVATE, transfer)
+                && CURLM_OK == curl_multi_add_handle(multi, transfer->curl.getHandle());
+            if (added)
+            {
+                transfers.push_back(transfer);
+            }
+            else
+            {
+                finishTask(this, transfer->curl, false, response, transfer->errorBuffer);
+                delete transfer;
+                addResponseToQueue(response);
+            }
+        }
+        requests.clear();
+
+        if (transfers.empty())
+        {
+            continue;
+        }
+
+        // step 3: drive the transfers and collect the finished ones
+        int runningTransfers = 0;
+        curl_multi_perform(multi, &runningTransfers);
+
+        CURLMsg* message = nullptr;
+        int messagesLeft = 0;
+        while ((message = curl_multi_info_read(multi, &messagesLeft)) != nullptr)
+        {
+            if (message->msg != CURLMSG_DONE)
+            {
+                continue;
+            }
+
+            CURL* handle = message->easy_handle;
+            bool succeed = (message->data.result == CURLE_OK);
+            HttpTransfer* transfer = nullptr;
+            curl_easy_getinfo(handle, CURLINFO_PRIVATE, (char**)&transfer);
+            curl_multi_remove_handle(multi, handle);
+
+            HttpResponse* response = transfer->response;
+            finishTask(this, transfer->curl, succeed, response, transfer->errorBuffer);
+            transfers.remove(transfer);
+            delete transfer;
+            addResponseToQueue(response);
+        }
+
+        if (!transfers.empty())
+        {
+            curl_multi_wait(multi, nullptr, 0, MULTI_WAIT_TIMEOUT_MS, nullptr);
+        }
+    }
+
+    // cleanup: if worker thread received quit signal, abort the running transfers and clean up un-completed request queue
+    for (auto transfer : transfers)
+    {
+        curl_multi_remove_handle(multi, transfer->curl.getHandle());
+        transfer->response->release();
+        delete transfer;
+    }
+    curl_multi_cleanup(multi);
+
+    _requestQueueMutex.lock();
+    _requestQueue.clear();
+    _requestQueueMutex.unlock();
+
+    _responseQueueMutex.lock();
+    _responseQueue.clear();
+    _responseQueueMutex.unlock();
+
+    decreaseThreadCountAndMayDeleteThis();
 }
 
-//Process DELETE Request
-static int processDeleteTask(HttpClient* client, HttpRequest* request, write_callback callback, void* stream, long* responseCode, write_callback headerCallback, void* headerStream, char* errorBuffer)
+void HttpClient::addResponseToQueue(HttpResponse* response)
 {
-    CURLRaii curl;
-    bool ok = curl.init(client, request, callback, stream, headerCallback, headerStream, errorBuffer)
-            && curl.setOption(CURLOPT_CUSTOMREQUEST, "DELETE")
-            && curl.setOption(CURLOPT_FOLLOWLOCATION, true)
-            && curl.perform(responseCode);
-    return ok ? 0 : 1;
+    // add response packet into queue
+    _responseQueueMutex.lock();
+    _responseQueue.pushBack(response);
+    _responseQueueMutex.unlock();
+
+    _schedulerMutex.lock();
+    if (nullptr != _scheduler)
+    {
+        _scheduler->performFunctionInCocosThread(CC_CALLBACK_0(HttpClient::dispatchResponseCallbacks, this));
+    }
+    _schedulerMutex.unlock();
 }
 
 // HttpClient implementation
@@ -387,6 +616,15 @@ void HttpClient::enableCookies(const char* cookieFile)
     {
         _cookieFilename = (FileUtils::getInstance()->getWritablePath() + "cookieFile.txt");
     }
+
+    // the file is read once, the transfers then use the cookies in memory
+    if (nullptr == _cookie)
+    {
+        _cookie = new (std::nothrow) HttpCookie();
+    }
+    _cookie->setCookieFileName(_cookieFilename);
+    _cookie->readFile();
+    addSharedCookies(_cookie->getCookiesString());
 }
     
 void HttpClient::setSSLVerification(const std::string& caFile)
@@ -399,6 +637,8 @@ HttpClient::HttpClient()
 : _isInited(false)
 , _timeoutForConnect(30)
 , _timeoutForRead(60)
+, _maxConcurrentRequests(8)
+, _maxConnectionsPerHost(4)
 , _threadCount(0)
 , _cookie(nullptr)
 , _requestSentinel(new HttpRequest())
@@ -407,11 +647,19 @@ HttpClient::HttpClient()
     memset(_responseMessage, 0, RESPONSE_BUFFER_SIZE * sizeof(char));
     _scheduler = Director::getInstance()->getScheduler();
     increaseThreadCount();
+    retainCurlShare();
 }
 
 HttpClient::~HttpClient()
 {
     CC_SAFE_RELEASE(_requestSentinel);
+    if (nullptr != _cookie)
+    {
+        _cookie->setCookiesFromString(getSharedCookies());
+        _cookie->writeFile();
+        CC_SAFE_DELETE(_cookie);
+    }
+    releaseCurlShare();
     CCLOG("HttpClient destructor");
 }
 
@@ -448,13 +696,23 @@ void HttpClient::send(HttpRequest* request)
     request->retain();
 
     _requestQueueMutex.lock();
-    _requestQueue.pushBack(request);
+    addRequestToQueue(request);
     _requestQueueMutex.unlock();
 
     // Notify thread start to work
     _sleepCondition.notify_one();
 }
 
+AsyncOperation<RefPtr<HttpResponse>> HttpClient::sendAsync(HttpRequest* request)
+{
+    AsyncOperation<RefPtr<HttpResponse>> operation;
+    request->setResponseCallback([operation](HttpClient* /*client*/, HttpResponse* response) {
+        operation.resolve(response);
+    });
+    send(request);
+    return operation;
+}
+
 void HttpClient::sendImmediate(HttpRequest* request)
 {
     if(!request)
@@ -511,68 +769,14 @@ void HttpClient::dispatchResponseCallbacks()
 void HttpClient::processResponse(HttpResponse* response, char* responseMessage)
 {
     auto request = response->getHttpRequest();
-    long responseCode = -1;
-    int retValue = 0;
 
     // Process the request -> get response packet
-    switch (request->getRequestType())
-    {
-    case HttpRequest::Type::GET: // HTTP GET
-        retValue = processGetTask(this, request,
-            writeData,
-            response->getResponseData(),
-            &responseCode,
-            writeHeaderData,
-            response->getResponseHeader(),
-            responseMessage);
-        break;
-
-    case HttpRequest::Type::POST: // HTTP POST
-        retValue = processPostTask(this, request,
-            writeData,
-            response->getResponseData(),
-            &responseCode,
-            writeHeaderData,
-            response->getResponseHeader(),
-            responseMessage);
-        break;
-
-    case HttpRequest::Type::PUT:
-        retValue = processPutTask(this, request,
-            writeData,
-            response->getResponseData(),
-            &responseCode,
-            writeHeaderData,
-            response->getResponseHeader(),
-            responseMessage);
-        break;
-
-    case HttpRequest::Type::DELETE:
-        retValue = processDeleteTask(this, request,
-            writeData,
-            response->getResponseData(),
-            &responseCode,
-            writeHeaderData,
-            response->getResponseHeader(),
-            responseMessage);
-        break;
-
-    default:
-        CCASSERT(false, "CCHttpClient: unknown request type, only GET, POST, PUT or DELETE is supported");
-        break;
-    }
+    CURLRaii curl;
+    bool succeed = prepareTask(this, curl, request, response, responseMessage)
+        && CURLE_OK == curl_easy_perform(curl.getHandle());
 
     // write data to HttpResponse
-    response->setResponseCode(responseCode);
-    if (retValue != 0)
-    {
-        response->setSucceed(false);
-        response->setErrorBuffer(responseMessage);
-    }
-    else
-    {
-        response->setSucceed(true);
-    }
+    finishTask(this, curl, succeed, response, responseMessage);
 }
 
 void HttpClient::increaseThreadCount()
@@ -622,6 +826,30 @@ int HttpClient::getTimeoutForRead()
     std::lock_guard<std::mutex> lock(_timeoutForReadMutex);
     return _timeoutForRead;
 }
+
+void HttpClient::setMaxConcurrentRequests(int value)
+{
+    std::lock_guard<std::mutex> lock(_maxConcurrentRequestsMutex);
+    _maxConcurrentRequests = value;
+}
+
+int HttpClient::getMaxConcurrentRequests()
+{
+    std::lock_guard<std::mutex> lock(_maxConcurrentRequestsMutex);
+    return _maxConcurrentRequests;
+}
+
+void HttpClient::setMaxConnectionsPerHost(int value)
+{
+    std::lock_guard<std::mutex> lock(_maxConnectionsPerHostMutex);
+    _maxConnectionsPerHost = value;
+}
+
+int HttpClient::getMaxConnectionsPerHost()
+{
+    std::lock_guard<std::mutex> lock(_maxConnectionsPerHostMutex);
+    return _maxConnectionsPerHost;
+}
     
 const std::string& HttpClient::getCookieFilename()
 {
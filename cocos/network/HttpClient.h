@@ -31,6 +31,8 @@
 #include <condition_variable>
 #include "base/CCVector.h"
 #include "base/CCScheduler.h"
+#include "base/CCRefPtr.h"
+#include "base/CCAsyncOperation.h"
 #include "network/HttpRequest.h"
 #include "network/HttpResponse.h"
 #include "network/HttpCookie.h"
@@ -108,6 +110,16 @@ public:
      */
     void send(HttpRequest* request);
 
+    /**
+     * Like send(), with an operation completed on the cocos thread with the response rather than the response callback.
+     *
+     * @param request a HttpRequest object, its response callback is replaced.
+     * @since v3.14
+     * @js NA
+     * @lua NA
+     */
+    AsyncOperation<RefPtr<HttpResponse>> sendAsync(HttpRequest* request);
+
     /**
      * Immediate send a request
      *
@@ -144,6 +156,41 @@ public:
      */
     int getTimeoutForRead();
 
+    /**
+     * Set how many requests added by send() are transferred at the same time.
+     * Requests start in priority order, see HttpRequest::setPriority(); set it to 1 to process the queue serially.
+     * Only the curl backend transfers in parallel, the native backends keep processing the queue one by one.
+     *
+     * @param value the maximum number of concurrent requests, 8 by default.
+     * @since v3.14
+     */
+    void setMaxConcurrentRequests(int value);
+
+    /**
+     * Get the maximum number of concurrent requests.
+     *
+     * @return int the maximum number of concurrent requests.
+     * @since v3.14
+     */
+    int getMaxConcurrentRequests();
+
+    /**
+     * Set how many connections may be opened to a single host.
+     * Transfers beyond the limit wait for a free connection, or share one when the server speaks HTTP/2.
+     *
+     * @param value the maximum number of connections per host, 4 by default, 0 means unlimited.
+     * @since v3.14
+     */
+    void setMaxConnectionsPerHost(int value);
+
+    /**
+     * Get the maximum number of connections per host.
+     *
+     * @return int the maximum number of connections per host.
+     * @since v3.14
+     */
+    int getMaxConnectionsPerHost();
+
     HttpCookie* getCookie() const {return _cookie; }
 
     std::mutex& getCookieFileMutex() {return _cookieFileMutex;}
@@ -165,9 +212,22 @@ private:
     void dispatchResponseCallbacks();
 
     void processResponse(HttpResponse* response, char* responseMessage);
+    /** Queues a finished response and asks the cocos thread to dispatch its callback */
+    void addResponseToQueue(HttpResponse* response);
     void increaseThreadCount();
     void decreaseThreadCountAndMayDeleteThis();
 
+    /** Queues the request behind the requests of the same or a higher priority, _requestQueueMutex must be locked */
+    void addRequestToQueue(HttpRequest* request)
+    {
+        ssize_t index = _requestQueue.size();
+        while (index > 0 && _requestQueue.at(index - 1)->getPriority() < request->getPriority())
+        {
+            --index;
+        }
+        _requestQueue.insert(index, request);
+    }
+
 private:
     bool _isInited;
 
@@ -177,6 +237,12 @@ private:
     int _timeoutForRead;
     std::mutex _timeoutForReadMutex;
 
+    int _maxConcurrentRequests;
+    std::mutex _maxConcurrentRequestsMutex;
+
+    int _maxConnectionsPerHost;
+    std::mutex _maxConnectionsPerHostMutex;
+
     int  _threadCount;
     std::mutex _threadCountMutex;
 
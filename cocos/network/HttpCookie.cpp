@@ -24,66 +24,178 @@
 
 #include "network/HttpCookie.h"
 #include "platform/CCFileUtils.h"
+#include <algorithm>
 #include <sstream>
 #include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+
+static const char* HTTP_ONLY_PREFIX = "#HttpOnly_";
+
+static std::string toLower(const std::string& str)
+{
+    std::string lower = str;
+    std::transform(lower.begin(), lower.end(), lower.begin(), ::tolower);
+    return lower;
+}
+
+// the domain of a cookie is indexed lower-cased and without its leading dot
+static std::string normalizeDomain(const std::string& domain)
+{
+    return toLower(!domain.empty() && domain[0] == '.' ? domain.substr(1) : domain);
+}
+
+static bool isExpired(const CookiesInfo& cookie, time_t now)
+{
+    // 0 is a session cookie
+    long long expires = strtoll(cookie.expires.c_str(), nullptr, 10);
+    return expires > 0 && expires < (long long)now;
+}
+
+// the host, the path and whether the scheme is https, without the regular expressions of network::Uri
+static void splitUrl(const std::string& url, std::string& host, std::string& path, bool& secure)
+{
+    size_t begin = url.find("://");
+    secure = begin != std::string::npos && toLower(url.substr(0, begin)) == "https";
+    begin = begin == std::string::npos ? 0 : begin + 3;
+
+    size_t end = url.find_first_of("/?#", begin);
+    std::string authority = url.substr(begin, end == std::string::npos ? std::string::npos : end - begin);
+    size_t userInfo = authority.rfind('@');
+    if (userInfo != std::string::npos)
+    {
+        authority = authority.substr(userInfo + 1);
+    }
+    size_t port = authority.rfind(':');
+    if (port != std::string::npos && authority.find(']', port) == std::string::npos)
+    {
+        authority = authority.substr(0, port);
+    }
+    host = toLower(authority);
+
+    if (end == std::string::npos || url[end] != '/')
+    {
+        path = "/";
+    }
+    else
+    {
+        size_t pathEnd = url.find_first_of("?#", end);
+        path = url.substr(end, pathEnd == std::string::npos ? std::string::npos : pathEnd - end);
+    }
+}
+
+HttpCookie::HttpCookie()
+: _writePending(false)
+{
+}
+
+HttpCookie::~HttpCookie()
+{
+    cocos2d::JobSystem::JobHandle writeJob;
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        writeJob = _writeJob;
+    }
+    if (writeJob)
+    {
+        cocos2d::JobSystem::getInstance()->wait(writeJob);
+    }
+}
 
 void HttpCookie::readFile()
 {
     std::string inString = cocos2d::FileUtils::getInstance()->getStringFromFile(_cookieFileName);
     if(!inString.empty())
     {
-        std::vector<std::string> cookiesVec;
-        cookiesVec.clear();
+        setCookiesFromString(inString);
+    }
+}
+
+void HttpCookie::setCookiesFromString(const std::string& content)
+{
+    std::vector<CookiesInfo> cookies;
+
+    std::stringstream stream(content);
+    std::string cookie;
+    while(std::getline(stream, cookie, '\n'))
+    {
+        if (!cookie.empty() && cookie.back() == '\r')
+            cookie.pop_back();
 
-        std::stringstream stream(inString);
-        std::string item;
-        while(std::getline(stream, item, '\n'))
+        if(cookie.length() == 0)
+            continue;
+
+        if(cookie.compare(0, strlen(HTTP_ONLY_PREFIX), HTTP_ONLY_PREFIX) == 0)
         {
-            cookiesVec.push_back(item);
+            cookie = cookie.substr(strlen(HTTP_ONLY_PREFIX));
         }
 
-        if(cookiesVec.empty())
-            return;
+        if(cookie.empty() || cookie.at(0) == '#')
+            continue;
 
-        _cookies.clear();
+        std::stringstream streamInfo(cookie);
+        std::vector<std::string> elems;
+        std::string elemsItem;
 
-        for(auto& cookie : cookiesVec)
+        while (std::getline(streamInfo, elemsItem, '\t'))
         {
-            if(cookie.length() == 0)
-                continue;
+            elems.push_back(elemsItem);
+        }
+        // a cookie without value has no tab after its name
+        if (elems.size() == 6)
+            elems.push_back("");
+        if (elems.size() < 7 || elems[0].empty())
+            continue;
 
-            if(cookie.find("#HttpOnly_") != std::string::npos)
-            {
-                cookie = cookie.substr(10);
-            }
+        CookiesInfo co;
+        co.domain = normalizeDomain(elems[0]);
+        co.tailmatch = elems[1] == "TRUE";
+        co.path   = elems[2];
+        co.secure = elems[3] == "TRUE";
+        co.expires = elems[4];
+        co.name = elems[5];
+        co.value = elems[6];
+        cookies.push_back(co);
+    }
 
-            if(cookie.at(0) == '#')
-                continue;
+    std::lock_guard<std::mutex> lock(_mutex);
+    _cookies.clear();
+    _domainIndex.clear();
+    for (auto& co : cookies)
+    {
+        addCookie(co);
+    }
+}
 
-            CookiesInfo co;
-            std::stringstream streamInfo(cookie);
-            std::vector<std::string> elems;
-            std::string elemsItem;
+std::string HttpCookie::getCookiesString() const
+{
+    std::string content = "# Netscape HTTP Cookie File\n"
+        "# http://curl.haxx.se/docs/http-cookies.html\n"
+        "# This file was generated by cocos2d-x! Edit at your own risk.\n\n";
 
-            while (std::getline(streamInfo, elemsItem, '\t'))
-            {
-                elems.push_back(elemsItem);
-            }
+    time_t now = time(nullptr);
+    std::lock_guard<std::mutex> lock(_mutex);
+    for(auto& cookie : _cookies)
+    {
+        if (isExpired(cookie, now))
+            continue;
 
-            co.domain = elems[0];
-            if (co.domain.at(0) == '.')
-            {
-                co.domain = co.domain.substr(1);
-            }
-            co.tailmatch = strcmp("TRUE", elems[1].c_str())?true: false;
-            co.path   = elems[2];
-            co.secure = strcmp("TRUE", elems[3].c_str())?true: false;
-            co.expires = elems[4];
-            co.name = elems[5];
-            co.value = elems[6];
-            _cookies.push_back(co);
-        }
+        content.append(cookie.domain);
+        content.append(1, '\t');
+        content.append(cookie.tailmatch ? "TRUE" : "FALSE");
+        content.append(1, '\t');
+        content.append(cookie.path);
+        content.append(1, '\t');
+        content.append(cookie.secure ? "TRUE" : "FALSE");
+        content.append(1, '\t');
+        content.append(cookie.expires);
+        content.append(1, '\t');
+        content.append(cookie.name);
+        content.append(1, '\t');
+        content.append(cookie.value);
+        content.append(1, '\n');
     }
+    return content;
 }
 
 const std::vector<CookiesInfo>* HttpCookie::getCookies() const
@@ -91,67 +203,137 @@ const std::vector<CookiesInfo>* HttpCookie::getCookies() const
     return &_cookies;
 }
 
-const CookiesInfo* HttpCookie::getMatchCookie(const std::string& url) const
+void HttpCookie::visitMatchCookies(const std::string& url, const std::function<bool(const CookiesInfo&)>& visitor) const
 {
-    for(auto& cookie : _cookies)
+    std::string host;
+    std::string path;
+    bool secure = false;
+    splitUrl(url, host, path, secure);
+    if (host.empty())
+        return;
+
+    // the host, then the domains including it: a.b.com, b.com, com
+    time_t now = time(nullptr);
+    size_t begin = 0;
+    while (begin != std::string::npos)
     {
-        if(url.find(cookie.domain) != std::string::npos)
-            return &cookie;
+        auto domain = _domainIndex.find(host.substr(begin));
+        if (domain != _domainIndex.end())
+        {
+            for (auto index : domain->second)
+            {
+                const CookiesInfo& cookie = _cookies[index];
+                if ((begin == 0 || cookie.tailmatch)
+                    && (!cookie.secure || secure)
+                    && path.compare(0, cookie.path.size(), cookie.path) == 0
+                    && !isExpired(cookie, now)
+                    && !visitor(cookie))
+                {
+                    return;
+                }
+            }
+        }
+
+        begin = host.find('.', begin);
+        if (begin != std::string::npos)
+            ++begin;
     }
+}
+
+const CookiesInfo* HttpCookie::getMatchCookie(const std::string& url) const
+{
+    const CookiesInfo* match = nullptr;
+    std::lock_guard<std::mutex> lock(_mutex);
+    visitMatchCookies(url, [&match](const CookiesInfo& cookie) {
+        match = &cookie;
+        return false;
+    });
+    return match;
+}
 
-    return nullptr;
+std::vector<CookiesInfo> HttpCookie::getMatchCookies(const std::string& url) const
+{
+    std::vector<CookiesInfo> matches;
+    std::lock_guard<std::mutex> lock(_mutex);
+    visitMatchCookies(url, [&matches](const CookiesInfo& cookie) {
+        matches.push_back(cookie);
+        return true;
+    });
+    return matches;
 }
 
 void HttpCookie::updateOrAddCookie(CookiesInfo* cookie)
 {
-    for(auto& _cookie : _cookies)
+    std::string domain = normalizeDomain(cookie->domain);
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    auto indices = _domainIndex.find(domain);
+    if (indices != _domainIndex.end())
     {
-        if(cookie->domain == _cookie.domain)
+        for (auto index : indices->second)
         {
-            _cookie = *cookie;
-            return;
+            CookiesInfo& _cookie = _cookies[index];
+            if (_cookie.path == cookie->path && _cookie.name == cookie->name)
+            {
+                _cookie = *cookie;
+                _cookie.domain = domain;
+                return;
+            }
         }
     }
-    _cookies.push_back(*cookie);
+    CookiesInfo added = *cookie;
+    added.domain = domain;
+    addCookie(added);
+}
+
+void HttpCookie::addCookie(const CookiesInfo& cookie)
+{
+    _domainIndex[cookie.domain].push_back(_cookies.size());
+    _cookies.push_back(cookie);
 }
 
 void HttpCookie::writeFile()
 {
-    FILE *out;
-    out = fopen(_cookieFileName.c_str(), "w");
-    fputs("# Netscape HTTP Cookie File\n"
-          "# http://curl.haxx.se/docs/http-cookies.html\n"
-          "# This file was generated by cocos2d-x! Edit at your own risk.\n"
-          "# Test cocos2d-x cookie write.\n\n",
-          out);
+    std::string content = getCookiesString();
 
-    std::string line;
-    for(auto& cookie : _cookies)
+    std::lock_guard<std::mutex> lock(_fileMutex);
+    FILE *out = fopen(_cookieFileName.c_str(), "w");
+    if (out == nullptr)
     {
-        line.clear();
-        line.append(cookie.domain);
-        line.append(1, '\t');
-        cookie.tailmatch ? line.append("TRUE") : line.append("FALSE");
-        line.append(1, '\t');
-        line.append(cookie.path);
-        line.append(1, '\t');
-        cookie.secure ? line.append("TRUE") : line.append("FALSE");
-        line.append(1, '\t');
-        line.append(cookie.expires);
-        line.append(1, '\t');
-        line.append(cookie.name);
-        line.append(1, '\t');
-        line.append(cookie.value);
-        //line.append(1, '\n');
-
-        fprintf(out, "%s\n", line.c_str());
+        CCLOG("HttpCookie: can't write %s", _cookieFileName.c_str());
+        return;
     }
-
+    fwrite(content.data(), 1, content.size(), out);
     fclose(out);
 }
 
+void HttpCookie::writeFileLater(const std::function<void()>& update)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_writePending)
+        return;
+    _writePending = true;
+
+    // after the previous write, so waiting for the last one waits for all of them
+    std::vector<cocos2d::JobSystem::JobHandle> dependencies;
+    if (_writeJob)
+    {
+        dependencies.push_back(_writeJob);
+    }
+    _writeJob = cocos2d::JobSystem::getInstance()->schedule([this, update]() {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _writePending = false;
+        }
+        if (update)
+        {
+            update();
+        }
+        writeFile();
+    }, dependencies);
+}
+
 void HttpCookie::setCookieFileName(const std::string& filename)
 {
     _cookieFileName = filename;
 }
-
@@ -26,8 +26,13 @@
 #define HTTP_COOKIE_H
 /// @cond DO_NOT_SHOW
 
-#include<string>
-#include<vector>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "base/CCAsyncTaskPool.h"
 
 struct CookiesInfo
 {
@@ -40,21 +45,57 @@ struct CookiesInfo
     std::string expires;
 };
 
+/**
+ * The cookies of the requests, kept in memory and indexed by domain.
+ * The file is read once, and written on a worker thread by writeFileLater() after the cookies changed.
+ */
 class HttpCookie
 {
 public:
+    HttpCookie();
+    /** Waits for the write in progress. */
+    ~HttpCookie();
+
     void readFile();
 
     void writeFile();
+    /**
+     * Writes the file on a worker thread of the JobSystem, the changes made meanwhile are written
+     * by the same write.
+     *
+     * @param update Called on the worker before the cookies are written, can be nullptr.
+     */
+    void writeFileLater(const std::function<void()>& update = nullptr);
     void setCookieFileName(const std::string& fileName);
 
+    /** Replaces the cookies by the ones in the content of a Netscape cookie file. */
+    void setCookiesFromString(const std::string& content);
+    /** Returns the cookies in the Netscape cookie file format, without the expired ones. */
+    std::string getCookiesString() const;
+
+    /** Not thread safe, the cookies may change while they are read. */
     const std::vector<CookiesInfo>* getCookies()const;
+    /** Not thread safe, returns a cookie getMatchCookies() would return. */
     const CookiesInfo* getMatchCookie(const std::string& url) const;
+    /** Returns the cookies sent to a url: of its host or of a domain including it, of a prefix of its path, unexpired. */
+    std::vector<CookiesInfo> getMatchCookies(const std::string& url) const;
+    /** Replaces the cookie with the same domain, path and name, or adds it. */
     void updateOrAddCookie(CookiesInfo* cookie);
 
 private:
+    /** Calls visitor with the cookies matching the url until it returns false, _mutex must be locked. */
+    void visitMatchCookies(const std::string& url, const std::function<bool(const CookiesInfo&)>& visitor) const;
+    void addCookie(const CookiesInfo& cookie);
+
     std::string _cookieFileName;
     std::vector<CookiesInfo> _cookies;
+    // the indices in _cookies of the cookies of each domain
+    std::unordered_map<std::string, std::vector<size_t>> _domainIndex;
+    mutable std::mutex _mutex;
+
+    std::mutex _fileMutex;
+    cocos2d::JobSystem::JobHandle _writeJob;
+    bool _writePending;
 };
 
 /// @endcond
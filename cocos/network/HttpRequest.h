@@ -44,6 +44,8 @@ class HttpClient;
 class HttpResponse;
 
 typedef std::function<void(HttpClient* client, HttpResponse* response)> ccHttpRequestCallback;
+/** Receives the response body chunk by chunk on the network thread, returning false aborts the request */
+typedef std::function<bool(const char* data, size_t size)> ccHttpResponseDataSink;
 typedef void (cocos2d::Ref::*SEL_HttpResponse)(HttpClient* client, HttpResponse* response);
 #define httpresponse_selector(_SELECTOR) (cocos2d::network::SEL_HttpResponse)(&_SELECTOR)
 
@@ -89,6 +91,7 @@ public:
         , _pSelector(nullptr)
         , _pCallback(nullptr)
         , _pUserData(nullptr)
+        , _priority(0)
     {
     }
 
@@ -213,6 +216,29 @@ public:
         return _tag.c_str();
     }
 
+    /**
+     * Set the priority of the request.
+     * HttpClient::send() starts queued requests with a higher priority first, requests of the same priority keep their order.
+     *
+     * @param priority the priority of the request, 0 by default.
+     * @since v3.14
+     */
+    void setPriority(int priority)
+    {
+        _priority = priority;
+    }
+
+    /**
+     * Get the priority of the request.
+     *
+     * @return int the priority of the request.
+     * @since v3.14
+     */
+    int getPriority() const
+    {
+        return _priority;
+    }
+
     /**
      * Set user-customed data of HttpRequest object.
      * You can attach a customed data in each request, and get it back in response callback.
@@ -270,6 +296,54 @@ public:
         _pCallback = callback;
     }
     
+    /**
+     * Stream the response body to a sink instead of collecting it in HttpResponse::getResponseData().
+     * The sink is called on the network thread for every chunk as it arrives, so large downloads can be
+     * parsed incrementally without holding the whole body in memory. Return false from it to abort the request.
+     *
+     * @param sink the ccHttpResponseDataSink function, nullptr collects the body again.
+     * @since v3.14
+     */
+    void setResponseDataSink(const ccHttpResponseDataSink& sink)
+    {
+        _responseDataSink = sink;
+    }
+
+    /**
+     * Get the sink the response body is streamed to.
+     *
+     * @return const ccHttpResponseDataSink& the sink, empty when the body is collected.
+     * @since v3.14
+     */
+    const ccHttpResponseDataSink& getResponseDataSink() const
+    {
+        return _responseDataSink;
+    }
+
+    /**
+     * Write the response body directly to a file instead of collecting it in HttpResponse::getResponseData().
+     * The file is complete when the response callback is called, it is removed again if the request failed.
+     * A data sink takes precedence over the file.
+     *
+     * @param fullPath the full path of the file, empty collects the body again.
+     * @since v3.14
+     */
+    void setResponseFile(const std::string& fullPath)
+    {
+        _responseFile = fullPath;
+    }
+
+    /**
+     * Get the file the response body is written to.
+     *
+     * @return const std::string& the full path of the file, empty when the body is collected.
+     * @since v3.14
+     */
+    const std::string& getResponseFile() const
+    {
+        return _responseFile;
+    }
+
     /** 
      * Get the target of callback selector function, mainly used by HttpClient.
      *
@@ -365,6 +439,9 @@ protected:
     ccHttpRequestCallback       _pCallback;      /// C++11 style callbacks
     void*                       _pUserData;      /// You can add your customed data here
     std::vector<std::string>    _headers;        /// custom http headers
+    int                         _priority;       /// requests with a higher priority are sent first
+    ccHttpResponseDataSink      _responseDataSink; /// receives the body as it arrives instead of _responseData
+    std::string                 _responseFile;   /// the body is written to this file instead of _responseData
 };
 
 }
@@ -27,6 +27,7 @@
 #define __HTTP_RESPONSE__
 
 #include "network/HttpRequest.h"
+#include "platform/CCFileUtils.h"
 
 /**
  * @addtogroup network
@@ -54,6 +55,7 @@ public:
         : _pHttpRequest(request)
         , _succeed(false)
         , _responseDataString("")
+        , _responseFile(nullptr)
     {
         if (_pHttpRequest)
         {
@@ -67,6 +69,10 @@ public:
      */
     virtual ~HttpResponse()
     {
+        if (_responseFile)
+        {
+            fclose(_responseFile);
+        }
         if (_pHttpRequest)
         {
             _pHttpRequest->release();
@@ -117,6 +123,28 @@ public:
         return &_responseData;
     }
 
+    /**
+     * Take the ownership of the http response data without copying it, getResponseData() is empty afterwards.
+     * @return std::vector<char> the response data.
+     * @since v3.14
+     */
+    std::vector<char> takeResponseData()
+    {
+        return std::move(_responseData);
+    }
+
+    /**
+     * Take the http response data in a buffer shared by its views, getResponseData() is empty afterwards.
+     * @return DataView the view of the response data.
+     * @since v3.14
+     */
+    DataView takeResponseDataView()
+    {
+        DataView view(std::move(_responseData));
+        _responseData.clear();
+        return view;
+    }
+
     /**
      * Get the response headers.
      * @return std::vector<char>* the pointer that point to the _responseHeader.
@@ -169,6 +197,79 @@ public:
         _responseData = *data;
     }
 
+    /**
+     * Set the http response data buffer without copying it, it is used by HttpClient.
+     * @param data the response data buffer.
+     * @since v3.14
+     */
+    void setResponseData(std::vector<char>&& data)
+    {
+        _responseData = std::move(data);
+    }
+
+    /**
+     * Hand a chunk of the response body to the destination chosen by the request, it is used by HttpClient.
+     * The chunk goes to the data sink or the response file of the request if it has one, it is appended to the response data otherwise.
+     * @param data the chunk of the response body.
+     * @param size the size of the chunk.
+     * @return bool false if the chunk couldn't be stored and the request should be aborted.
+     * @since v3.14
+     */
+    bool appendResponseData(const char* data, size_t size)
+    {
+        if (_pHttpRequest && _pHttpRequest->getResponseDataSink())
+        {
+            return _pHttpRequest->getResponseDataSink()(data, size);
+        }
+        if (_pHttpRequest && !_pHttpRequest->getResponseFile().empty())
+        {
+            if (!_responseFile)
+            {
+                _responseFile = fopen(FileUtils::getInstance()->getSuitableFOpen(_pHttpRequest->getResponseFile()).c_str(), "wb");
+            }
+            return _responseFile && fwrite(data, 1, size, _responseFile) == size;
+        }
+        _responseData.insert(_responseData.end(), data, data + size);
+        return true;
+    }
+
+    /**
+     * Complete the response body once the request finished and setSucceed() was called, it is used by HttpClient.
+     * The response file is closed, or removed if the request failed.
+     * @since v3.14
+     */
+    void finishResponseData()
+    {
+        if (!_pHttpRequest || _pHttpRequest->getResponseDataSink() || _pHttpRequest->getResponseFile().empty())
+        {
+            return;
+        }
+        if (_responseFile)
+        {
+            fclose(_responseFile);
+            _responseFile = nullptr;
+        }
+        else if (_succeed)
+        {
+            // an empty body still leaves an empty file behind
+            _responseFile = fopen(FileUtils::getInstance()->getSuitableFOpen(_pHttpRequest->getResponseFile()).c_str(), "wb");
+            if (_responseFile)
+            {
+                fclose(_responseFile);
+                _responseFile = nullptr;
+            }
+        }
+        if (!_succeed)
+        {
+            remove(FileUtils::getInstance()->getSuitableFOpen(_pHttpRequest->getResponseFile()).c_str());
+        }
+        else
+        {
+            // the file may have been looked up before it was downloaded
+            FileUtils::getInstance()->purgeNonexistentFileCache();
+        }
+    }
+
     /**
      * Set the http response headers buffer, it is used by HttpClient.
      * @param data the pointer point to the response headers buffer.
@@ -230,6 +331,7 @@ protected:
     long                _responseCode;    /// the status code returned from libcurl, e.g. 200, 404
     std::string         _errorBuffer;   /// if _responseCode != 200, please read _errorBuffer to find the reason
     std::string         _responseDataString; // the returned raw data. You can also dump it as a string
+    FILE*               _responseFile;  /// the file the body is written to when the request asked for it
 
 };
 
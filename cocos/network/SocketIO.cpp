@@ -337,6 +337,121 @@ SocketIOPacket * SocketIOPacket::createPacketWithTypeIndex(int type, SocketIOPac
     return ret;
 }
 
+/**
+ *  @brief A socket.io 1.x packet parsed in place, the fields point into the received message
+ *         format: <type>[<attachments>-][<namespace>,][<ack id>][<json data>]
+ */
+struct SocketIOPacketV10xView
+{
+    int type;
+    int attachments;
+    const char* endpoint;
+    size_t endpointLength;
+    long ackId;
+    const char* data;
+    size_t dataLength;
+};
+
+static bool parsePacketV10x(const char* bytes, size_t len, SocketIOPacketV10xView& packet)
+{
+    const char* p = bytes;
+    const char* end = bytes + len;
+
+    packet.type = -1;
+    packet.attachments = 0;
+    packet.endpoint = nullptr;
+    packet.endpointLength = 0;
+    packet.ackId = -1;
+
+    if (p == end || *p < '0' || *p > '9')
+        return false;
+    packet.type = *p++ - '0';
+
+    // Binary packets announce their attachment count
+    if (packet.type == 5 || packet.type == 6)
+    {
+        int attachments = 0;
+        while (p != end && *p >= '0' && *p <= '9')
+        {
+            attachments = attachments * 10 + (*p++ - '0');
+        }
+        if (p == end || *p != '-')
+            return false;
+        ++p;
+        packet.attachments = attachments;
+    }
+
+    if (p != end && *p == '/')
+    {
+        packet.endpoint = p;
+        while (p != end && *p != ',')
+        {
+            ++p;
+        }
+        packet.endpointLength = p - packet.endpoint;
+        if (p != end)
+            ++p;
+    }
+
+    if (p != end && *p >= '0' && *p <= '9')
+    {
+        long ackId = 0;
+        while (p != end && *p >= '0' && *p <= '9')
+        {
+            ackId = ackId * 10 + (*p++ - '0');
+        }
+        packet.ackId = ackId;
+    }
+
+    packet.data = p;
+    packet.dataLength = end - p;
+    return true;
+}
+
+// Splits the json array of an event, ["name", args...], into the name and the raw json of the arguments
+static bool parseEventV10x(const char* data, size_t len, std::string& eventName, std::string& args)
+{
+    const char* p = data;
+    const char* end = data + len;
+
+    while (p != end && isspace((unsigned char)*p)) ++p;
+    if (p == end || *p != '[')
+        return false;
+    ++p;
+    while (p != end && isspace((unsigned char)*p)) ++p;
+    if (p == end || *p != '"')
+        return false;
+    const char* nameBegin = ++p;
+    while (p != end && *p != '"')
+    {
+        // Skip escaped characters
+        if (*p == '\\' && p + 1 != end)
+            ++p;
+        ++p;
+    }
+    if (p == end)
+        return false;
+    eventName.assign(nameBegin, p - nameBegin);
+    ++p;
+
+    while (p != end && isspace((unsigned char)*p)) ++p;
+    if (p == end || *p != ',')
+    {
+        args.clear();
+        return true;
+    }
+    ++p;
+
+    // Arguments end before the closing bracket of the array
+    const char* argsEnd = end;
+    while (argsEnd != p && *(argsEnd - 1) != ']') --argsEnd;
+    if (argsEnd != p) --argsEnd;
+    while (p != argsEnd && isspace((unsigned char)*p)) ++p;
+    while (argsEnd != p && isspace((unsigned char)*(argsEnd - 1))) --argsEnd;
+    args.assign(p, argsEnd - p);
+    return true;
+}
+
 /**
  *  @brief The implementation of the socket.io connection
  *         Clients/endpoints may share the same impl to accomplish multiplexing on the same websocket
@@ -357,6 +472,23 @@ private:
 
     Map<std::string, SIOClient*> _clients;
 
+    // Binary event waiting for its attachments
+    struct PendingBinaryPacket
+    {
+        std::string endpoint;
+        std::string eventName;
+        std::string args;
+        int remaining;
+        bool isAck;
+        std::vector<std::vector<char>> attachments;
+    };
+    PendingBinaryPacket _pendingBinary;
+
+    void onMessageV10x(const char* bytes, size_t len);
+    void onPacketV10x(const char* bytes, size_t len);
+    void onBinaryAttachment(const WebSocket::Data& data);
+    void dispatchBinaryPacket();
+
 public:
     SIOClientImpl(const Uri& uri, const std::string& caFilePath);
     virtual ~SIOClientImpl();
@@ -399,6 +531,8 @@ SIOClientImpl::SIOClientImpl(const Uri& uri, const std::string& caFilePath) :
     _connected(false),
     _ws(nullptr)
 {
+    _pendingBinary.remaining = 0;
+    _pendingBinary.isAck = false;
 }
 
 SIOClientImpl::~SIOClientImpl()
@@ -755,8 +889,20 @@ void SIOClientImpl::onOpen(WebSocket* /*ws*/)
 
 void SIOClientImpl::onMessage(WebSocket* /*ws*/, const WebSocket::Data& data)
 {
+    if (data.isBinary)
+    {
+        onBinaryAttachment(data);
+        return;
+    }
+
     CCLOGINFO("SIOClientImpl::onMessage received: %s", data.bytes);
 
+    if (_version == SocketIOPacket::SocketIOVersion::V10x)
+    {
+        onMessageV10x(data.bytes, data.len);
+        return;
+    }
+
     std::string payload = data.bytes;
     int control = atoi(payload.substr(0, 1).c_str());
     payload = payload.substr(1, payload.size() - 1);
@@ -862,126 +1008,162 @@ void SIOClientImpl::onMessage(WebSocket* /*ws*/, const WebSocket::Data& data)
             }
         }
         break;
-        case SocketIOPacket::SocketIOVersion::V10x:
-        {
-            switch (control)
-            {
-            case 0:
-                CCLOGINFO("Not supposed to receive control 0 for websocket");
-                CCLOGINFO("That's not good");
-                break;
-            case 1:
-                CCLOGINFO("Not supposed to receive control 1 for websocket");
-                break;
-            case 2:
-                CCLOGINFO("Ping received, send pong");
-                payload = "3" + payload;
-                _ws->send(payload);
-                break;
-            case 3:
-                CCLOGINFO("Pong received");
-                if (payload == "probe")
-                {
-                    CCLOGINFO("Request Update");
-                    _ws->send("5");
-                }
-                break;
-            case 4:
-            {
-                int control2 = payload.at(0) - '0';
-                CCLOGINFO("Message code: [%i]", control2);
-
-                std::string endpoint = "";
-
-                std::string::size_type a = payload.find("/");
-                std::string::size_type b = payload.find("[");
-
-                if (b != std::string::npos)
-                {
-                    if (a != std::string::npos && a < b)
-                    {
-                        //we have an endpoint and a payload
-                        endpoint = payload.substr(a, b - (a + 1));
-                    }
-                }
-                else if (a != std::string::npos) {
-                    //we have an endpoint with no payload
-                    endpoint = payload.substr(a, payload.size() - a);
-                }
+        default:
+            break;
+    }
 
-                // we didn't find and endpoint and we are in the default namespace
-                if (endpoint == "") endpoint = "/";
+    return;
+}
 
-                c = getClient(endpoint);
+void SIOClientImpl::onMessageV10x(const char* bytes, size_t len)
+{
+    if (len == 0)
+        return;
 
-                payload = payload.substr(1);
+    const char* payload = bytes + 1;
+    const size_t payloadLength = len - 1;
 
-                if (endpoint != "/") payload = payload.substr(endpoint.size());
-                if (endpoint != "/" && payload != "") payload = payload.substr(1);
+    switch (bytes[0])
+    {
+    case '0':
+        CCLOGINFO("Not supposed to receive control 0 for websocket");
+        CCLOGINFO("That's not good");
+        break;
+    case '1':
+        CCLOGINFO("Not supposed to receive control 1 for websocket");
+        break;
+    case '2':
+    {
+        CCLOGINFO("Ping received, send pong");
+        std::string pong(bytes, len);
+        pong[0] = '3';
+        _ws->send(pong);
+        break;
+    }
+    case '3':
+        CCLOGINFO("Pong received");
+        if (payloadLength == 5 && memcmp(payload, "probe", 5) == 0)
+        {
+            CCLOGINFO("Request Update");
+            _ws->send("5");
+        }
+        break;
+    case '4':
+        onPacketV10x(payload, payloadLength);
+        break;
+    case '5':
+        CCLOGINFO("Upgrade required");
+        break;
+    case '6':
+        CCLOGINFO("Noop\n");
+        break;
+    }
+}
 
-                switch (control2)
-                {
-                case 0:
-                    CCLOGINFO("Socket Connected");
-                    if (c) {
-                        c->onConnect();
-                        c->fireEvent("connect", payload);
-                    }
-                    break;
-                case 1:
-                    CCLOGINFO("Socket Disconnected");
-                    disconnectFromEndpoint(endpoint);
-                    c->fireEvent("disconnect", payload);
-                    break;
-                case 2:
-                {
-                    CCLOGINFO("Event Received (%s)", payload.c_str());
+void SIOClientImpl::onPacketV10x(const char* bytes, size_t len)
+{
+    SocketIOPacketV10xView packet;
+    if (!parsePacketV10x(bytes, len, packet))
+    {
+        CCLOGERROR("SIOClientImpl::onPacketV10x malformed packet");
+        return;
+    }
+    CCLOGINFO("Message code: [%i]", packet.type);
 
-                    std::string::size_type payloadFirstSlashPos = payload.find("\"");
-                    std::string::size_type payloadSecondSlashPos = payload.substr(payloadFirstSlashPos + 1).find("\"");
+    // we didn't find and endpoint and we are in the default namespace
+    std::string endpoint = packet.endpointLength > 0 ? std::string(packet.endpoint, packet.endpointLength) : "/";
+    SIOClient *c = getClient(endpoint);
 
-                    std::string eventname = payload.substr(payloadFirstSlashPos + 1,
-                                                           payloadSecondSlashPos - payloadFirstSlashPos + 1);
+    switch (packet.type)
+    {
+    case 0:
+        CCLOGINFO("Socket Connected");
+        if (c) {
+            c->onConnect();
+            c->fireEvent("connect", std::string(packet.data, packet.dataLength));
+        }
+        break;
+    case 1:
+        CCLOGINFO("Socket Disconnected");
+        disconnectFromEndpoint(endpoint);
+        if (c) c->fireEvent("disconnect", std::string(packet.data, packet.dataLength));
+        break;
+    case 2:
+    {
+        std::string eventName, args;
+        if (!parseEventV10x(packet.data, packet.dataLength, eventName, args))
+        {
+            CCLOGERROR("SIOClientImpl::onPacketV10x malformed event");
+            break;
+        }
+        CCLOGINFO("Event Received (%s)", eventName.c_str());
 
-                    CCLOGINFO("event name %s between %i and %i", eventname.c_str(),
-                              payloadFirstSlashPos, payloadSecondSlashPos);
+        if (c) c->fireEvent(eventName, args);
+        if (c) c->getDelegate()->onMessage(c, args);
+    }
+    break;
+    case 3:
+        CCLOGINFO("Message Ack");
+        break;
+    case 4:
+        CCLOGERROR("Error");
+        if (c) c->fireEvent("error", std::string(packet.data, packet.dataLength));
+        break;
+    case 5:
+    case 6:
+        CCLOGINFO("Binary %s with %d attachments", packet.type == 5 ? "Event" : "Ack", packet.attachments);
+        _pendingBinary.endpoint = endpoint;
+        _pendingBinary.isAck = packet.type == 6;
+        _pendingBinary.remaining = packet.attachments;
+        _pendingBinary.attachments.clear();
+        _pendingBinary.attachments.reserve(packet.attachments);
+        _pendingBinary.eventName.clear();
+        _pendingBinary.args.clear();
+        if (!_pendingBinary.isAck && !parseEventV10x(packet.data, packet.dataLength, _pendingBinary.eventName, _pendingBinary.args))
+        {
+            CCLOGERROR("SIOClientImpl::onPacketV10x malformed binary event");
+        }
+        if (_pendingBinary.remaining == 0)
+        {
+            dispatchBinaryPacket();
+        }
+        break;
+    }
+}
 
-                    payload = payload.substr(payloadSecondSlashPos + 4,
-                                             payload.size() - (payloadSecondSlashPos + 5));
+void SIOClientImpl::onBinaryAttachment(const WebSocket::Data& data)
+{
+    if (_pendingBinary.remaining <= 0)
+    {
+        CCLOGINFO("SIOClientImpl::onBinaryAttachment no binary packet waiting for attachments");
+        return;
+    }
 
-                    if (c) c->fireEvent(eventname, payload);
-                    if (c) c->getDelegate()->onMessage(c, payload);
+    const char* bytes = data.bytes;
+    ssize_t len = data.len;
+    // engine.io prefixes binary messages with the message packet type
+    if (len > 0 && bytes[0] == 4)
+    {
+        ++bytes;
+        --len;
+    }
+    _pendingBinary.attachments.emplace_back(bytes, bytes + len);
 
-                }
-                break;
-                case 3:
-                    CCLOGINFO("Message Ack");
-                    break;
-                case 4:
-                    CCLOGERROR("Error");
-                    if (c) c->fireEvent("error", payload);
-                    break;
-                case 5:
-                    CCLOGINFO("Binary Event");
-                    break;
-                case 6:
-                    CCLOGINFO("Binary Ack");
-                    break;
-                }
-            }
-            break;
-            case 5:
-                CCLOGINFO("Upgrade required");
-                break;
-            case 6:
-                CCLOGINFO("Noop\n");
-                break;
-            }
-        }
-        break;
+    if (--_pendingBinary.remaining == 0)
+    {
+        dispatchBinaryPacket();
     }
+}
 
-    return;
+void SIOClientImpl::dispatchBinaryPacket()
+{
+    SIOClient *c = getClient(_pendingBinary.endpoint);
+    if (c && !_pendingBinary.isAck && !_pendingBinary.eventName.empty())
+    {
+        c->fireBinaryEvent(_pendingBinary.eventName, _pendingBinary.args, _pendingBinary.attachments);
+    }
+    _pendingBinary.attachments.clear();
+    _pendingBinary.remaining = 0;
 }
 
 void SIOClientImpl::onClose(WebSocket* /*ws*/)
@@ -1088,17 +1270,22 @@ void SIOClient::on(const std::string& eventName, SIOEvent e)
     _eventRegistry[eventName] = e;
 }
 
+void SIOClient::onBinary(const std::string& eventName, SIOBinaryEvent e)
+{
+    _binaryEventRegistry[eventName] = e;
+}
+
 void SIOClient::fireEvent(const std::string& eventName, const std::string& data)
 {
     CCLOGINFO("SIOClient::fireEvent called with event name: %s and data: %s", eventName.c_str(), data.c_str());
 
     _delegate->fireEventToScript(this, eventName, data);
 
-    if(_eventRegistry[eventName])
+    // Look up without inserting empty callbacks for unknown events
+    auto iter = _eventRegistry.find(eventName);
+    if (iter != _eventRegistry.end() && iter->second)
     {
-        SIOEvent e = _eventRegistry[eventName];
-
-        e(this, data);
+        iter->second(this, data);
 
         return;
     }
@@ -1106,6 +1293,20 @@ void SIOClient::fireEvent(const std::string& eventName, const std::string& data)
     CCLOGINFO("SIOClient::fireEvent no native event with name %s found", eventName.c_str());
 }
 
+void SIOClient::fireBinaryEvent(const std::string& eventName, const std::string& data, const std::vector<std::vector<char>>& attachments)
+{
+    auto iter = _binaryEventRegistry.find(eventName);
+    if (iter != _binaryEventRegistry.end() && iter->second)
+    {
+        iter->second(this, data, attachments);
+        return;
+    }
+
+    // Without a binary callback, the event is handled like a text one with the attachment placeholders
+    fireEvent(eventName, data);
+    _delegate->onMessage(this, data);
+}
+
 void SIOClient::setTag(const char* tag)
 {
     _tag = tag;
@@ -194,6 +194,9 @@ private:
 typedef std::function<void(SIOClient*, const std::string&)> SIOEvent;
 //c++11 map to callbacks
 typedef std::unordered_map<std::string, SIOEvent> EventRegistry;
+//callback of socket.io 1.x binary events, receiving the json arguments and the binary attachments
+typedef std::function<void(SIOClient*, const std::string&, const std::vector<std::vector<char>>&)> SIOBinaryEvent;
+typedef std::unordered_map<std::string, SIOBinaryEvent> BinaryEventRegistry;
 
 /**
  * A single connection to a socket.io endpoint.
@@ -213,8 +216,10 @@ private:
     SocketIO::SIODelegate* _delegate;
 
     EventRegistry _eventRegistry;
+    BinaryEventRegistry _binaryEventRegistry;
 
     void fireEvent(const std::string& eventName, const std::string& data);
+    void fireBinaryEvent(const std::string& eventName, const std::string& data, const std::vector<std::vector<char>>& attachments);
 
     void onOpen();
     void onConnect();
@@ -268,6 +273,16 @@ public:
      */
     void on(const std::string& eventName, SIOEvent e);
 
+    /**
+     * Used to register a callback for a socket.io 1.x event carrying binary attachments.
+     * The json arguments still hold the attachment placeholders, the attachments are passed in order.
+     * Without such a callback, the event is fired to the callback registered with `on`.
+     * @param eventName the name of event.
+     * @param e the callback function.
+     * @since v3.14
+     */
+    void onBinary(const std::string& eventName, SIOBinaryEvent e);
+
     /**
      * Set tag of SIOClient.
      * The tag is used to distinguish the various SIOClient objects.
@@ -49,6 +49,12 @@
 
 #define WS_RX_BUFFER_SIZE (65536)
 #define WS_RESERVE_RECEIVE_BUFFER_SIZE (4096)
+// Buffers larger than the rx buffer aren't kept in the pools
+#define WS_POOL_MAX_BUFFER_SIZE (WS_RX_BUFFER_SIZE)
+#define WS_POOL_MAX_BUFFERS (16)
+#define WS_MIN_SEND_BUFFER_SIZE (256)
+// Maximum count of queued messages written in one writable callback
+#define WS_MAX_MESSAGES_PER_WRITABLE (32)
 
 #define  LOG_TAG    "WebSocket.cpp"
 
@@ -444,7 +450,8 @@ void WsThreadHelper::joinWebSocketThread()
     }
 }
 
-// Define a WebSocket frame
+// Define a WebSocket frame, the payload is written in place
+// since libwebsockets only needs LWS_PRE writable bytes in front of it for the frame header
 class WebSocketFrame
 {
 public:
@@ -460,20 +467,7 @@ public:
         if (buf == nullptr && len > 0)
             return false;
 
-        if (!_data.empty())
-        {
-            LOGD("WebSocketFrame was initialized, should not init it again!\n");
-            return false;
-        }
-
-        _data.reserve(LWS_PRE + len);
-        _data.resize(LWS_PRE, 0x00);
-        if (len > 0)
-        {
-            _data.insert(_data.end(), buf, buf + len);
-        }
-
-        _payload = _data.data() + LWS_PRE;
+        _payload = buf;
         _payloadLength = len;
         _frameLength = len;
         return true;
@@ -493,8 +487,116 @@ private:
     ssize_t _payloadLength;
 
     ssize_t _frameLength;
-    std::vector<unsigned char> _data;
 };
+
+// Outgoing message, the data has to be the first member since it's handed out to users
+struct WsSendBuffer
+{
+    WebSocket::Data data;
+    WebSocketFrame frame;
+    unsigned char* block;
+    ssize_t capacity;
+};
+
+// Recycles the send and receive buffers between the cocos and websocket threads
+class WsBufferPool
+{
+public:
+    ~WsBufferPool()
+    {
+        for (auto buffer : _sendBuffers)
+        {
+            free(buffer->block);
+            delete buffer;
+        }
+        for (auto buffer : _receiveBuffers)
+        {
+            delete buffer;
+        }
+    }
+
+    WsSendBuffer* acquireSendBuffer(ssize_t len)
+    {
+        WsSendBuffer* buffer = nullptr;
+        {
+            std::lock_guard<std::mutex> lk(_mutex);
+            for (auto iter = _sendBuffers.begin(); iter != _sendBuffers.end(); ++iter)
+            {
+                if ((*iter)->capacity >= len)
+                {
+                    buffer = *iter;
+                    _sendBuffers.erase(iter);
+                    break;
+                }
+            }
+        }
+
+        if (buffer == nullptr)
+        {
+            buffer = new (std::nothrow) WsSendBuffer();
+            buffer->capacity = std::max(len, (ssize_t)WS_MIN_SEND_BUFFER_SIZE);
+            // One more byte for the '\0' of text messages
+            buffer->block = (unsigned char*)malloc(LWS_PRE + buffer->capacity + 1);
+        }
+
+        buffer->data = WebSocket::Data();
+        buffer->data.bytes = (char*)buffer->block + LWS_PRE;
+        buffer->data.len = len;
+        buffer->frame = WebSocketFrame();
+        return buffer;
+    }
+
+    void releaseSendBuffer(WsSendBuffer* buffer)
+    {
+        {
+            std::lock_guard<std::mutex> lk(_mutex);
+            if (buffer->capacity <= WS_POOL_MAX_BUFFER_SIZE && _sendBuffers.size() < WS_POOL_MAX_BUFFERS)
+            {
+                _sendBuffers.push_back(buffer);
+                return;
+            }
+        }
+        free(buffer->block);
+        delete buffer;
+    }
+
+    std::vector<char>* acquireReceiveBuffer()
+    {
+        {
+            std::lock_guard<std::mutex> lk(_mutex);
+            if (!_receiveBuffers.empty())
+            {
+                auto buffer = _receiveBuffers.back();
+                _receiveBuffers.pop_back();
+                return buffer;
+            }
+        }
+        auto buffer = new (std::nothrow) std::vector<char>();
+        buffer->reserve(WS_RESERVE_RECEIVE_BUFFER_SIZE);
+        return buffer;
+    }
+
+    void releaseReceiveBuffer(std::vector<char>* buffer)
+    {
+        buffer->clear();
+        {
+            std::lock_guard<std::mutex> lk(_mutex);
+            if (buffer->capacity() <= WS_POOL_MAX_BUFFER_SIZE && _receiveBuffers.size() < WS_POOL_MAX_BUFFERS)
+            {
+                _receiveBuffers.push_back(buffer);
+                return;
+            }
+        }
+        delete buffer;
+    }
+
+private:
+    std::mutex _mutex;
+    std::vector<WsSendBuffer*> _sendBuffers;
+    std::vector<std::vector<char>*> _receiveBuffers;
+};
+
+static WsBufferPool __wsBufferPool;
 //
 
 void WebSocket::closeAllConnections()
@@ -522,6 +624,7 @@ WebSocket::WebSocket()
 , _isDestroyed(std::make_shared<std::atomic<bool>>(false))
 , _delegate(nullptr)
 , _closeState(CloseState::NONE)
+, _perMessageDeflateEnabled(true)
 {
     // reserve data buffer to avoid allocate memory frequently
     _receivedData.reserve(WS_RESERVE_RECEIVE_BUFFER_SIZE);
@@ -572,6 +675,15 @@ WebSocket::~WebSocket()
     Director::getInstance()->getEventDispatcher()->removeEventListener(_resetDirectorListener);
     
     *_isDestroyed = true;
+
+    {
+        std::lock_guard<std::mutex> lkMessages(_receivedMessagesMutex);
+        for (auto& message : _receivedMessages)
+        {
+            __wsBufferPool.releaseReceiveBuffer(message.first);
+        }
+        _receivedMessages.clear();
+    }
 }
 
 
@@ -644,18 +756,10 @@ void WebSocket::send(const std::string& message)
     if (_readyState == State::OPEN)
     {
         // In main thread
-        Data* data = new (std::nothrow) Data();
-        data->bytes = (char*)malloc(message.length() + 1);
+        Data* data = allocSendBuffer(static_cast<ssize_t>(message.length()), false);
         // Make sure the last byte is '\0'
-        data->bytes[message.length()] = '\0';
-        strcpy(data->bytes, message.c_str());
-        data->len = static_cast<ssize_t>(message.length());
-
-        WsMessage* msg = new (std::nothrow) WsMessage();
-        msg->what = WS_MSG_TO_SUBTRHEAD_SENDING_STRING;
-        msg->data = data;
-        msg->user = this;
-        __wsHelper->sendMessageToWebSocketThread(msg);
+        memcpy(data->bytes, message.c_str(), message.length() + 1);
+        send(data);
     }
     else
     {
@@ -668,29 +772,41 @@ void WebSocket::send(const unsigned char* binaryMsg, unsigned int len)
     if (_readyState == State::OPEN)
     {
         // In main thread
-        Data* data = new (std::nothrow) Data();
-        if (len == 0)
-        {
-            // If data length is zero, allocate 1 byte for safe.
-            data->bytes = (char*)malloc(1);
-            data->bytes[0] = '\0';
-        }
-        else
+        Data* data = allocSendBuffer(len, true);
+        if (len > 0)
         {
-            data->bytes = (char*)malloc(len);
             memcpy((void*)data->bytes, (void*)binaryMsg, len);
         }
-        data->len = len;
+        send(data);
+    }
+    else
+    {
+        LOGD("Couldn't send message since websocket wasn't opened!\n");
+    }
+}
 
+WebSocket::Data* WebSocket::allocSendBuffer(ssize_t len, bool isBinary/* = true*/)
+{
+    WsSendBuffer* buffer = __wsBufferPool.acquireSendBuffer(len);
+    buffer->data.isBinary = isBinary;
+    return &buffer->data;
+}
+
+void WebSocket::send(Data* data)
+{
+    WsSendBuffer* buffer = reinterpret_cast<WsSendBuffer*>(data);
+    if (_readyState == State::OPEN)
+    {
         WsMessage* msg = new (std::nothrow) WsMessage();
-        msg->what = WS_MSG_TO_SUBTRHEAD_SENDING_BINARY;
-        msg->data = data;
+        msg->what = data->isBinary ? WS_MSG_TO_SUBTRHEAD_SENDING_BINARY : WS_MSG_TO_SUBTRHEAD_SENDING_STRING;
+        msg->data = buffer;
         msg->user = this;
         __wsHelper->sendMessageToWebSocketThread(msg);
     }
     else
     {
         LOGD("Couldn't send message since websocket wasn't opened!\n");
+        __wsBufferPool.releaseSendBuffer(buffer);
     }
 }
 
@@ -864,6 +980,9 @@ void WebSocket::onClientOpenConnectionRequest()
             },
             { nullptr, nullptr, nullptr /* terminator */ }
         };
+        static const struct lws_extension noExts[] = {
+            { nullptr, nullptr, nullptr /* terminator */ }
+        };
 
         _readyStateMutex.lock();
         _readyState = State::CONNECTING;
@@ -908,7 +1027,7 @@ void WebSocket::onClientOpenConnectionRequest()
         connectInfo.protocol = _clientSupportedProtocols.empty() ? nullptr : _clientSupportedProtocols.c_str();
         connectInfo.ietf_version_or_minus_one = -1;
         connectInfo.userdata = this;
-        connectInfo.client_exts = exts;
+        connectInfo.client_exts = _perMessageDeflateEnabled ? exts : noExts;
         connectInfo.vhost = vhost;
 
         _wsInstance = lws_client_connect_via_info(&connectInfo);
@@ -948,56 +1067,37 @@ int WebSocket::onClientWritable()
 
         std::list<WsMessage*>::iterator iter = __wsHelper->_subThreadWsMessageQueue->begin();
 
-        while (iter != __wsHelper->_subThreadWsMessageQueue->end())
+        // Small messages are written back to back while the socket accepts them,
+        // instead of waiting for the next writable callback for each of them
+        for (int sentCount = 0; sentCount < WS_MAX_MESSAGES_PER_WRITABLE; ++sentCount)
         {
-            WsMessage* msg = *iter;
-            if (msg->user == this)
+            while (iter != __wsHelper->_subThreadWsMessageQueue->end() && (*iter)->user != this)
             {
-                break;
+                ++iter;
             }
-            else
+
+            if (iter == __wsHelper->_subThreadWsMessageQueue->end())
             {
-                ++iter;
+                break;
             }
-        }
 
-        ssize_t bytesWrite = 0;
-        if (iter != __wsHelper->_subThreadWsMessageQueue->end())
-        {
             WsMessage* subThreadMsg = *iter;
 
-            Data* data = (Data*)subThreadMsg->data;
+            WsSendBuffer* buffer = (WsSendBuffer*)subThreadMsg->data;
+            Data* data = &buffer->data;
 
             const ssize_t c_bufferSize = WS_RX_BUFFER_SIZE;
 
             const ssize_t remaining = data->len - data->issued;
             const ssize_t n = std::min(remaining, c_bufferSize);
 
-            WebSocketFrame* frame = nullptr;
+            WebSocketFrame* frame = &buffer->frame;
 
-            if (data->ext)
-            {
-                frame = (WebSocketFrame*)data->ext;
-            }
-            else
+            if (data->ext == nullptr)
             {
-                frame = new (std::nothrow) WebSocketFrame();
-                bool success = frame && frame->init((unsigned char*)(data->bytes + data->issued), n);
-                if (success)
-                {
-                    data->ext = frame;
-                }
-                else
-                { // If frame initialization failed, delete the frame and drop the sending data
-                  // These codes should never be called.
-                    LOGD("WebSocketFrame initialization failed, drop the sending data, msg(%d)\n", (int)subThreadMsg->id);
-                    delete frame;
-                    CC_SAFE_FREE(data->bytes);
-                    CC_SAFE_DELETE(data);
-                    __wsHelper->_subThreadWsMessageQueue->erase(iter);
-                    CC_SAFE_DELETE(subThreadMsg);
-                    break;
-                }
+                // The bytes in front of a following fragment were already sent, they can hold its header
+                frame->init((unsigned char*)(data->bytes + data->issued), n);
+                data->ext = frame;
             }
 
             int writeProtocol;
@@ -1024,7 +1124,7 @@ int WebSocket::onClientWritable()
                     writeProtocol |= LWS_WRITE_NO_FIN;
             }
 
-            bytesWrite = lws_write(_wsInstance, frame->getPayload(), frame->getPayloadLength(), (lws_write_protocol)writeProtocol);
+            ssize_t bytesWrite = lws_write(_wsInstance, frame->getPayload(), frame->getPayloadLength(), (lws_write_protocol)writeProtocol);
 
             // Handle the result of lws_write
             // Buffer overrun?
@@ -1032,19 +1132,18 @@ int WebSocket::onClientWritable()
             {
                 LOGD("ERROR: msg(%u), lws_write return: %d, but it should be %d, drop this message.\n", subThreadMsg->id, (int)bytesWrite, (int)n);
                 // socket error, we need to close the socket connection
-                CC_SAFE_FREE(data->bytes);
-                delete ((WebSocketFrame*)data->ext);
-                data->ext = nullptr;
-                CC_SAFE_DELETE(data);
+                __wsBufferPool.releaseSendBuffer(buffer);
                 __wsHelper->_subThreadWsMessageQueue->erase(iter);
                 CC_SAFE_DELETE(subThreadMsg);
 
                 closeAsync();
+                break;
             }
             else if (bytesWrite < frame->getPayloadLength())
             {
                 frame->update(bytesWrite);
                 LOGD("frame wasn't sent completely, bytesWrite: %d, remain: %d\n", (int)bytesWrite, (int)frame->getPayloadLength());
+                break;
             }
             // Do we have another fragments to send?
             else if (remaining > frame->getFrameLength() && bytesWrite == frame->getPayloadLength())
@@ -1052,13 +1151,14 @@ int WebSocket::onClientWritable()
                 // A frame was totally sent, plus data->issued to send next frame
                 LOGD("msg(%u) append: %d + %d = %d\n", subThreadMsg->id, (int)data->issued, (int)frame->getFrameLength(), (int)(data->issued + frame->getFrameLength()));
                 data->issued += frame->getFrameLength();
-                delete ((WebSocketFrame*)data->ext);
                 data->ext = nullptr;
+                break;
             }
             // Safely done!
             else
             {
                 LOGD("Safely done, msg(%d)!\n", subThreadMsg->id);
+                bool dropped = false;
                 if (remaining == frame->getFrameLength())
                 {
                     LOGD("msg(%u) append: %d + %d = %d\n", subThreadMsg->id, (int)data->issued, (int)frame->getFrameLength(), (int)(data->issued + frame->getFrameLength()));
@@ -1069,16 +1169,23 @@ int WebSocket::onClientWritable()
                     LOGD("ERROR: msg(%u), remaining(%d) < bytesWrite(%d)\n", subThreadMsg->id, (int)remaining, (int)frame->getFrameLength());
                     LOGD("Drop the msg(%u)\n", subThreadMsg->id);
                     closeAsync();
+                    dropped = true;
                 }
 
-                CC_SAFE_FREE(data->bytes);
-                delete ((WebSocketFrame*)data->ext);
-                data->ext = nullptr;
-                CC_SAFE_DELETE(data);
-                __wsHelper->_subThreadWsMessageQueue->erase(iter);
+                __wsBufferPool.releaseSendBuffer(buffer);
+                iter = __wsHelper->_subThreadWsMessageQueue->erase(iter);
                 CC_SAFE_DELETE(subThreadMsg);
 
                 LOGD("-----------------------------------------------------------\n");
+                if (dropped)
+                {
+                    break;
+                }
+            }
+
+            if (lws_send_pipe_choked(_wsInstance))
+            {
+                break;
             }
         }
 
@@ -1116,12 +1223,9 @@ int WebSocket::onClientReceivedData(void* in, ssize_t len)
 
     if (remainingSize == 0 && isFinalFragment)
     {
-        std::vector<char>* frameData = new (std::nothrow) std::vector<char>(std::move(_receivedData));
-
-        // reset capacity of received data buffer
-        _receivedData.reserve(WS_RESERVE_RECEIVE_BUFFER_SIZE);
-
-        ssize_t frameSize = frameData->size();
+        // Hand the received data over and keep accumulating in a recycled buffer
+        std::vector<char>* frameData = __wsBufferPool.acquireReceiveBuffer();
+        frameData->swap(_receivedData);
 
         bool isBinary = (lws_frame_is_binary(_wsInstance) != 0);
 
@@ -1130,30 +1234,62 @@ int WebSocket::onClientReceivedData(void* in, ssize_t len)
             frameData->push_back('\0');
         }
 
-        std::shared_ptr<std::atomic<bool>> isDestroyed = _isDestroyed;
-        __wsHelper->sendMessageToCocosThread([this, frameData, frameSize, isBinary, isDestroyed](){
-            // In UI thread
-            LOGD("Notify data len %d to Cocos thread.\n", (int)frameSize);
+        // Messages received before the cocos thread runs are delivered together,
+        // there's only one pending function per websocket
+        bool isFirstPending = false;
+        {
+            std::lock_guard<std::mutex> lk(_receivedMessagesMutex);
+            isFirstPending = _receivedMessages.empty();
+            _receivedMessages.push_back(std::make_pair(frameData, isBinary));
+        }
+
+        if (isFirstPending)
+        {
+            std::shared_ptr<std::atomic<bool>> isDestroyed = _isDestroyed;
+            __wsHelper->sendMessageToCocosThread([this, isDestroyed](){
+                // In UI thread
+                if (*isDestroyed)
+                {
+                    LOGD("WebSocket instance was destroyed!\n");
+                }
+                else
+                {
+                    dispatchReceivedMessages();
+                }
+            });
+        }
+    }
+
+    return 0;
+}
 
+void WebSocket::dispatchReceivedMessages()
+{
+    std::vector<std::pair<std::vector<char>*, bool>> messages;
+    {
+        std::lock_guard<std::mutex> lk(_receivedMessagesMutex);
+        messages.swap(_receivedMessages);
+    }
+
+    // The delegate may destroy the websocket while handling a message
+    std::shared_ptr<std::atomic<bool>> isDestroyed = _isDestroyed;
+    for (auto& message : messages)
+    {
+        std::vector<char>* frameData = message.first;
+        if (!*isDestroyed)
+        {
             Data data;
-            data.isBinary = isBinary;
+            data.isBinary = message.second;
             data.bytes = (char*)frameData->data();
-            data.len = frameSize;
+            // Text messages carry a '\0' which isn't part of the message
+            data.len = static_cast<ssize_t>(frameData->size()) - (data.isBinary ? 0 : 1);
+            LOGD("Notify data len %d to Cocos thread.\n", (int)data.len);
 
-            if (*isDestroyed)
-            {
-                LOGD("WebSocket instance was destroyed!\n");
-            }
-            else
-            {
-                _delegate->onMessage(this, data);
-            }
+            _delegate->onMessage(this, data);
+        }
 
-            delete frameData;
-        });
+        __wsBufferPool.releaseReceiveBuffer(frameData);
     }
-
-    return 0;
 }
 
 int WebSocket::onConnectionOpened()
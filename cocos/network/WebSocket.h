@@ -191,6 +191,40 @@ public:
      */
     void send(const unsigned char* binaryMsg, unsigned int len);
 
+    /**
+     *  @brief Gets a pooled buffer to build an outgoing message in place.
+     *         Write the message to `bytes` and queue it with send(Data*), it isn't copied again before reaching the socket.
+     *  @param len The length of the message.
+     *  @param isBinary Whether the message is sent as a binary or a text frame.
+     *  @return The buffer, owned by the websocket until it's sent.
+     *  @since v3.14
+     *  @lua NA
+     */
+    Data* allocSendBuffer(ssize_t len, bool isBinary = true);
+
+    /**
+     *  @brief Sends a buffer returned by allocSendBuffer, the buffer mustn't be used afterwards.
+     *         Small messages queued together are written in the same socket writable callback.
+     *  @param data The buffer to send.
+     *  @since v3.14
+     *  @lua NA
+     */
+    void send(Data* data);
+
+    /**
+     *  @brief Sets whether the 'permessage-deflate' extension is offered to the server, it's enabled by default.
+     *         Compression saves bandwidth for large text messages but costs CPU time for frequent small frames.
+     *  @note It has to be invoked before init.
+     *  @since v3.14
+     */
+    void setPerMessageDeflateEnabled(bool enabled) { _perMessageDeflateEnabled = enabled; }
+
+    /**
+     *  @brief Whether the 'permessage-deflate' extension is offered to the server.
+     *  @since v3.14
+     */
+    bool isPerMessageDeflateEnabled() const { return _perMessageDeflateEnabled; }
+
     /**
      *  @brief Closes the connection to server synchronously.
      *  @note It's a synchronous method, it will not return until websocket thread exits.
@@ -233,6 +267,9 @@ private:
     int onConnectionError();
     int onConnectionClosed();
 
+    // Invoked in cocos thread, delivers all messages received since the last call
+    void dispatchReceivedMessages();
+
     struct lws_vhost* createVhost(struct lws_protocols* protocols, int& sslConnection);
 
 private:
@@ -244,6 +281,10 @@ private:
 
     std::vector<char> _receivedData;
 
+    // Complete messages waiting for the cocos thread, with their binary flags
+    std::mutex _receivedMessagesMutex;
+    std::vector<std::pair<std::vector<char>*, bool>> _receivedMessages;
+
     struct lws* _wsInstance;
     struct lws_protocols* _lwsProtocols;
     std::string _clientSupportedProtocols;
@@ -265,6 +306,7 @@ private:
     CloseState _closeState;
 
     std::string _caFilePath;
+    bool _perMessageDeflateEnabled;
 
     EventListenerCustom* _resetDirectorListener;
 
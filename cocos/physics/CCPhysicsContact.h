@@ -67,6 +67,8 @@ typedef struct CC_DLL PhysicsContactData
 class CC_DLL PhysicsContact : public EventCustom
 {
 public:
+    CC_DECLARE_ALLOCATOR_POOL(PhysicsContact)
+
     
     enum class EventCode
     {
@@ -143,6 +145,22 @@ private:
     friend class PhysicsWorld;
 };
 
+/**
+ * @brief A contact event buffered by PhysicsWorld::setContactBufferMask(), instead of being dispatched.
+ *
+ * The shapes are only guaranteed to live until the next step of the world.
+ * @since v3.14
+ */
+typedef struct CC_DLL PhysicsContactRecord
+{
+    PhysicsContact::EventCode eventCode;
+    PhysicsShape* shapeA;
+    PhysicsShape* shapeB;
+    PhysicsContactData contactData;
+    /** The impulse applied to resolve the contact, only set for EventCode::POSTSOLVE. */
+    Vec2 impulse;
+}PhysicsContactRecord;
+
 /**
  * @brief Presolve value generated when onContactPreSolve called.
  */
@@ -25,6 +25,7 @@
 #include "physics/CCPhysicsWorld.h"
 #if CC_USE_PHYSICS
 #include <algorithm>
+#include <chrono>
 #include <climits>
 
 #include "chipmunk/chipmunk_private.h"
@@ -37,6 +38,7 @@
 #include "2d/CCDrawNode.h"
 #include "2d/CCScene.h"
 #include "base/CCDirector.h"
+#include "base/CCAsyncTaskPool.h"
 #include "base/CCEventDispatcher.h"
 #include "base/CCEventCustom.h"
 
@@ -50,6 +52,13 @@ const int PhysicsWorld::DEBUGDRAW_JOINT = 0x02;
 const int PhysicsWorld::DEBUGDRAW_CONTACT = 0x04;
 const int PhysicsWorld::DEBUGDRAW_ALL = DEBUGDRAW_SHAPE | DEBUGDRAW_JOINT | DEBUGDRAW_CONTACT;
 
+const int PhysicsWorld::CONTACT_BUFFER_NONE = 0x00;
+const int PhysicsWorld::CONTACT_BUFFER_BEGIN = 0x01;
+const int PhysicsWorld::CONTACT_BUFFER_PRESOLVE = 0x02;
+const int PhysicsWorld::CONTACT_BUFFER_POSTSOLVE = 0x04;
+const int PhysicsWorld::CONTACT_BUFFER_SEPARATE = 0x08;
+const int PhysicsWorld::CONTACT_BUFFER_ALL = CONTACT_BUFFER_BEGIN | CONTACT_BUFFER_PRESOLVE | CONTACT_BUFFER_POSTSOLVE | CONTACT_BUFFER_SEPARATE;
+
 namespace
 {
     typedef struct RayCastCallbackInfo
@@ -74,6 +83,67 @@ namespace
         PhysicsQueryPointCallbackFunc func;
         void* data;
     }PointQueryCallbackInfo;
+
+    typedef struct RayCastFirstInfo
+    {
+        cpVect start;
+        cpVect end;
+        int categoryMask;
+        cpSegmentQueryInfo hit;
+    }RayCastFirstInfo;
+
+    typedef struct ShapesQueryInfo
+    {
+        cpBB bb;
+        cpVect point;
+        int categoryMask;
+        std::vector<PhysicsShape*>* shapes;
+    }ShapesQueryInfo;
+
+    // the batch is split in chunks so that each job appends to its own array, the arrays are merged in order afterwards
+    const int QUERY_BATCH_CHUNK = 32;
+
+    template <typename Query>
+    void queryShapesBatch(int count, std::vector<PhysicsShape*>& shapes, PhysicsQueryResult* results, bool parallel, const Query& query)
+    {
+        if (!parallel || count <= QUERY_BATCH_CHUNK)
+        {
+            for (int i = 0; i < count; ++i)
+            {
+                results[i].first = (int)shapes.size();
+                query(i, shapes);
+                results[i].count = (int)shapes.size() - results[i].first;
+            }
+            return;
+        }
+
+        const int chunkCount = (count + QUERY_BATCH_CHUNK - 1) / QUERY_BATCH_CHUNK;
+        std::vector<std::vector<PhysicsShape*>> chunkShapes(chunkCount);
+        JobSystem::getInstance()->parallelFor(chunkCount, 1, [&](size_t begin, size_t end) {
+            for (size_t chunk = begin; chunk < end; ++chunk)
+            {
+                auto& found = chunkShapes[chunk];
+                const int last = std::min(count, (int)(chunk + 1) * QUERY_BATCH_CHUNK);
+                for (int i = (int)chunk * QUERY_BATCH_CHUNK; i < last; ++i)
+                {
+                    results[i].first = (int)found.size();
+                    query(i, found);
+                    results[i].count = (int)found.size() - results[i].first;
+                }
+            }
+        });
+
+        for (int chunk = 0; chunk < chunkCount; ++chunk)
+        {
+            const int base = (int)shapes.size();
+            const int last = std::min(count, (chunk + 1) * QUERY_BATCH_CHUNK);
+            for (int i = chunk * QUERY_BATCH_CHUNK; i < last; ++i)
+            {
+                results[i].first += base;
+            }
+            shapes.insert(shapes.end(), chunkShapes[chunk].begin(), chunkShapes[chunk].end());
+        }
+    }
 }
 
 class PhysicsWorldCallback
@@ -87,12 +157,42 @@ public:
     static void queryRectCallbackFunc(cpShape *shape, RectQueryCallbackInfo *info);
     static void queryPointFunc(cpShape *shape, cpVect point, cpFloat distance, cpVect gradient, PointQueryCallbackInfo *info);
     static void getShapesAtPointFunc(cpShape *shape, cpVect point, cpFloat distance, cpVect gradient, Vector<PhysicsShape*>* arr);
+    static void bufferContact(cpArbiter *arb, PhysicsWorld *world, PhysicsContact::EventCode eventCode, int flag);
+    static cpFloat rayCastFirstFunc(RayCastFirstInfo *info, cpShape *shape, void *data);
+    static cpCollisionID queryRectsFunc(ShapesQueryInfo *info, cpShape *shape, cpCollisionID id, void *data);
+    static cpCollisionID queryPointsFunc(ShapesQueryInfo *info, cpShape *shape, cpCollisionID id, void *data);
     
 public:
     static bool continues;
+    // the user data of the arbiters whose contacts are buffered, the silent ones have none
+    static char bufferedContact;
 };
 
 bool PhysicsWorldCallback::continues = true;
+char PhysicsWorldCallback::bufferedContact = 0;
+
+void PhysicsWorldCallback::bufferContact(cpArbiter *arb, PhysicsWorld *world, PhysicsContact::EventCode eventCode, int flag)
+{
+    if ((world->_contactBufferMask & flag) == 0 || !world->_stepping)
+    {
+        return;
+    }
+    
+    CP_ARBITER_GET_SHAPES(arb, a, b);
+    
+    world->_bufferedContacts.push_back(PhysicsContactRecord());
+    auto& record = world->_bufferedContacts.back();
+    record.eventCode = eventCode;
+    record.shapeA = static_cast<PhysicsShape*>(cpShapeGetUserData(a));
+    record.shapeB = static_cast<PhysicsShape*>(cpShapeGetUserData(b));
+    record.contactData.count = std::min(cpArbiterGetCount(arb), (int)PhysicsContactData::POINT_MAX);
+    for (int i = 0; i < record.contactData.count; ++i)
+    {
+        record.contactData.points[i] = PhysicsHelper::cpv2point(cpArbiterGetPointA(arb, i));
+    }
+    record.contactData.normal = record.contactData.count > 0 ? PhysicsHelper::cpv2point(cpArbiterGetNormal(arb)) : Vec2::ZERO;
+    record.impulse = eventCode == PhysicsContact::EventCode::POSTSOLVE ? PhysicsHelper::cpv2point(cpArbiterTotalImpulse(arb)) : Vec2::ZERO;
+}
 
 cpBool PhysicsWorldCallback::collisionBeginCallbackFunc(cpArbiter *arb, struct cpSpace* /*space*/, PhysicsWorld *world)
 {
@@ -102,6 +202,18 @@ cpBool PhysicsWorldCallback::collisionBeginCallbackFunc(cpArbiter *arb, struct c
     PhysicsShape *shapeB = static_cast<PhysicsShape*>(cpShapeGetUserData(b));
     CC_ASSERT(shapeA != nullptr && shapeB != nullptr);
     
+    if (world->_contactBufferMask != PhysicsWorld::CONTACT_BUFFER_NONE)
+    {
+        bool notify = true;
+        bool ret = world->shouldCollide(shapeA, shapeB, notify);
+        cpArbiterSetUserData(arb, notify ? &bufferedContact : nullptr);
+        if (notify)
+        {
+            bufferContact(arb, world, PhysicsContact::EventCode::BEGIN, PhysicsWorld::CONTACT_BUFFER_BEGIN);
+        }
+        return ret;
+    }
+    
     auto contact = PhysicsContact::construct(shapeA, shapeB);
     cpArbiterSetUserData(arb, contact);
     contact->_contactInfo = arb;
@@ -111,17 +223,50 @@ cpBool PhysicsWorldCallback::collisionBeginCallbackFunc(cpArbiter *arb, struct c
 
 cpBool PhysicsWorldCallback::collisionPreSolveCallbackFunc(cpArbiter *arb, cpSpace* /*space*/, PhysicsWorld *world)
 {
-    return world->collisionPreSolveCallback(*static_cast<PhysicsContact*>(cpArbiterGetUserData(arb)));
+    void* data = cpArbiterGetUserData(arb);
+    if (data == nullptr)
+    {
+        return cpTrue;
+    }
+    if (data == &bufferedContact)
+    {
+        bufferContact(arb, world, PhysicsContact::EventCode::PRESOLVE, PhysicsWorld::CONTACT_BUFFER_PRESOLVE);
+        return cpTrue;
+    }
+    
+    return world->collisionPreSolveCallback(*static_cast<PhysicsContact*>(data));
 }
 
 void PhysicsWorldCallback::collisionPostSolveCallbackFunc(cpArbiter *arb, cpSpace* /*space*/, PhysicsWorld *world)
 {
-    world->collisionPostSolveCallback(*static_cast<PhysicsContact*>(cpArbiterGetUserData(arb)));
+    void* data = cpArbiterGetUserData(arb);
+    if (data == nullptr)
+    {
+        return;
+    }
+    if (data == &bufferedContact)
+    {
+        bufferContact(arb, world, PhysicsContact::EventCode::POSTSOLVE, PhysicsWorld::CONTACT_BUFFER_POSTSOLVE);
+        return;
+    }
+    
+    world->collisionPostSolveCallback(*static_cast<PhysicsContact*>(data));
 }
 
 void PhysicsWorldCallback::collisionSeparateCallbackFunc(cpArbiter *arb, cpSpace* /*space*/, PhysicsWorld *world)
 {
-    PhysicsContact* contact = static_cast<PhysicsContact*>(cpArbiterGetUserData(arb));
+    void* data = cpArbiterGetUserData(arb);
+    if (data == nullptr)
+    {
+        return;
+    }
+    if (data == &bufferedContact)
+    {
+        bufferContact(arb, world, PhysicsContact::EventCode::SEPARATE, PhysicsWorld::CONTACT_BUFFER_SEPARATE);
+        return;
+    }
+    
+    PhysicsContact* contact = static_cast<PhysicsContact*>(data);
     
     world->collisionSeparateCallback(*contact);
     
@@ -178,6 +323,47 @@ void PhysicsWorldCallback::queryPointFunc(cpShape *shape, cpVect /*point*/, cpFl
     PhysicsWorldCallback::continues = info->func(*info->world, *physicsShape, info->data);
 }
 
+cpFloat PhysicsWorldCallback::rayCastFirstFunc(RayCastFirstInfo *info, cpShape *shape, void* /*data*/)
+{
+    PhysicsShape *physicsShape = static_cast<PhysicsShape*>(cpShapeGetUserData(shape));
+    CC_ASSERT(physicsShape != nullptr);
+    
+    cpSegmentQueryInfo hit;
+    if ((physicsShape->getCategoryBitmask() & info->categoryMask) != 0 && !cpShapeGetSensor(shape)
+        && cpShapeSegmentQuery(shape, info->start, info->end, 0.0f, &hit) && hit.alpha < info->hit.alpha)
+    {
+        info->hit = hit;
+    }
+    
+    // the farther shapes can't be hit first, the index stops looking past the current hit
+    return info->hit.alpha;
+}
+
+cpCollisionID PhysicsWorldCallback::queryRectsFunc(ShapesQueryInfo *info, cpShape *shape, cpCollisionID id, void* /*data*/)
+{
+    PhysicsShape *physicsShape = static_cast<PhysicsShape*>(cpShapeGetUserData(shape));
+    CC_ASSERT(physicsShape != nullptr);
+    
+    if ((physicsShape->getCategoryBitmask() & info->categoryMask) != 0 && cpBBIntersects(info->bb, cpShapeGetBB(shape)))
+    {
+        info->shapes->push_back(physicsShape);
+    }
+    return id;
+}
+
+cpCollisionID PhysicsWorldCallback::queryPointsFunc(ShapesQueryInfo *info, cpShape *shape, cpCollisionID id, void* /*data*/)
+{
+    PhysicsShape *physicsShape = static_cast<PhysicsShape*>(cpShapeGetUserData(shape));
+    CC_ASSERT(physicsShape != nullptr);
+    
+    cpPointQueryInfo hit;
+    if ((physicsShape->getCategoryBitmask() & info->categoryMask) != 0 && cpShapePointQuery(shape, info->point, &hit) < 0.0f)
+    {
+        info->shapes->push_back(physicsShape);
+    }
+    return id;
+}
+
 static inline cpSpaceDebugColor RGBAColor(float r, float g, float b, float a){
     cpSpaceDebugColor color = {r, g, b, a};
     return color;
@@ -296,11 +482,28 @@ void PhysicsWorld::debugDraw()
 }
 
 bool PhysicsWorld::collisionBeginCallback(PhysicsContact& contact)
+{
+    bool notify = true;
+    bool ret = shouldCollide(contact.getShapeA(), contact.getShapeB(), notify);
+    if (!notify)
+    {
+        contact.setNotificationEnable(false);
+    }
+    
+    if (contact.isNotificationEnabled())
+    {
+        contact.setEventCode(PhysicsContact::EventCode::BEGIN);
+        contact.setWorld(this);
+        _eventDispatcher->dispatchEvent(&contact);
+    }
+    
+    return ret ? contact.resetResult() : false;
+}
+
+bool PhysicsWorld::shouldCollide(PhysicsShape* shapeA, PhysicsShape* shapeB, bool& notify)
 {
     bool ret = true;
     
-    PhysicsShape* shapeA = contact.getShapeA();
-    PhysicsShape* shapeB = contact.getShapeB();
     PhysicsBody* bodyA = shapeA->getBody();
     PhysicsBody* bodyB = shapeB->getBody();
     std::vector<PhysicsJoint*> jointsA = bodyA->getJoints();
@@ -319,7 +522,7 @@ bool PhysicsWorld::collisionBeginCallback(PhysicsContact& contact)
             
             if (body == bodyB)
             {
-                contact.setNotificationEnable(false);
+                notify = false;
                 return false;
             }
         }
@@ -329,7 +532,7 @@ bool PhysicsWorld::collisionBeginCallback(PhysicsContact& contact)
     if ((shapeA->getCategoryBitmask() & shapeB->getContactTestBitmask()) == 0
         || (shapeA->getContactTestBitmask() & shapeB->getCategoryBitmask()) == 0)
     {
-        contact.setNotificationEnable(false);
+        notify = false;
     }
     
     if (shapeA->getGroup() != 0 && shapeA->getGroup() == shapeB->getGroup())
@@ -345,14 +548,7 @@ bool PhysicsWorld::collisionBeginCallback(PhysicsContact& contact)
         }
     }
     
-    if (contact.isNotificationEnabled())
-    {
-        contact.setEventCode(PhysicsContact::EventCode::BEGIN);
-        contact.setWorld(this);
-        _eventDispatcher->dispatchEvent(&contact);
-    }
-    
-    return ret ? contact.resetResult() : false;
+    return ret;
 }
 
 bool PhysicsWorld::collisionPreSolveCallback(PhysicsContact& contact)
@@ -459,6 +655,93 @@ void PhysicsWorld::queryPoint(PhysicsQueryPointCallbackFunc func, const Vec2& po
     }
 }
 
+void PhysicsWorld::rayCastFirst(const PhysicsRayCastQuery* queries, int count, PhysicsRayCastInfo* results, bool parallel)
+{
+    if (!_delayAddBodies.empty() || !_delayRemoveBodies.empty())
+    {
+        updateBodies();
+    }
+    
+    // the spatial indices are only read, the lock keeps the space from changing until every ray is cast
+    cpSpaceLock(_cpSpace);
+    auto castRays = [this, queries, results](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+        {
+            const auto& query = queries[i];
+            RayCastFirstInfo info;
+            info.start = PhysicsHelper::point2cpv(query.start);
+            info.end = PhysicsHelper::point2cpv(query.end);
+            info.categoryMask = query.categoryMask;
+            info.hit.shape = nullptr;
+            info.hit.point = info.end;
+            info.hit.normal = cpvzero;
+            info.hit.alpha = 1.0f;
+            cpSpatialIndexSegmentQuery(_cpSpace->staticShapes, &info, info.start, info.end, 1.0f,
+                                       (cpSpatialIndexSegmentQueryFunc)PhysicsWorldCallback::rayCastFirstFunc, nullptr);
+            cpSpatialIndexSegmentQuery(_cpSpace->dynamicShapes, &info, info.start, info.end, info.hit.alpha,
+                                       (cpSpatialIndexSegmentQueryFunc)PhysicsWorldCallback::rayCastFirstFunc, nullptr);
+            
+            auto& result = results[i];
+            result.shape = info.hit.shape ? static_cast<PhysicsShape*>(cpShapeGetUserData(info.hit.shape)) : nullptr;
+            result.start = query.start;
+            result.end = query.end;
+            result.contact = PhysicsHelper::cpv2point(info.hit.point);
+            result.normal = PhysicsHelper::cpv2point(info.hit.normal);
+            result.fraction = static_cast<float>(info.hit.alpha);
+            result.data = nullptr;
+        }
+    };
+    if (parallel)
+    {
+        JobSystem::getInstance()->parallelFor(count, QUERY_BATCH_CHUNK, castRays);
+    }
+    else
+    {
+        castRays(0, count);
+    }
+    cpSpaceUnlock(_cpSpace, cpTrue);
+}
+
+void PhysicsWorld::queryRects(const PhysicsRectQuery* queries, int count, std::vector<PhysicsShape*>& shapes, PhysicsQueryResult* results, bool parallel)
+{
+    if (!_delayAddBodies.empty() || !_delayRemoveBodies.empty())
+    {
+        updateBodies();
+    }
+    
+    cpSpaceLock(_cpSpace);
+    queryShapesBatch(count, shapes, results, parallel, [this, queries](int i, std::vector<PhysicsShape*>& found) {
+        ShapesQueryInfo info;
+        info.bb = PhysicsHelper::rect2cpbb(queries[i].rect);
+        info.point = cpvzero;
+        info.categoryMask = queries[i].categoryMask;
+        info.shapes = &found;
+        cpSpatialIndexQuery(_cpSpace->staticShapes, &info, info.bb, (cpSpatialIndexQueryFunc)PhysicsWorldCallback::queryRectsFunc, nullptr);
+        cpSpatialIndexQuery(_cpSpace->dynamicShapes, &info, info.bb, (cpSpatialIndexQueryFunc)PhysicsWorldCallback::queryRectsFunc, nullptr);
+    });
+    cpSpaceUnlock(_cpSpace, cpTrue);
+}
+
+void PhysicsWorld::queryPoints(const PhysicsPointQuery* queries, int count, std::vector<PhysicsShape*>& shapes, PhysicsQueryResult* results, bool parallel)
+{
+    if (!_delayAddBodies.empty() || !_delayRemoveBodies.empty())
+    {
+        updateBodies();
+    }
+    
+    cpSpaceLock(_cpSpace);
+    queryShapesBatch(count, shapes, results, parallel, [this, queries](int i, std::vector<PhysicsShape*>& found) {
+        ShapesQueryInfo info;
+        info.point = PhysicsHelper::point2cpv(queries[i].point);
+        info.bb = cpBBNewForCircle(info.point, 0.0f);
+        info.categoryMask = queries[i].categoryMask;
+        info.shapes = &found;
+        cpSpatialIndexQuery(_cpSpace->staticShapes, &info, info.bb, (cpSpatialIndexQueryFunc)PhysicsWorldCallback::queryPointsFunc, nullptr);
+        cpSpatialIndexQuery(_cpSpace->dynamicShapes, &info, info.bb, (cpSpatialIndexQueryFunc)PhysicsWorldCallback::queryPointsFunc, nullptr);
+    });
+    cpSpaceUnlock(_cpSpace, cpTrue);
+}
+
 Vector<PhysicsShape*> PhysicsWorld::getShapes(const Vec2& point) const
 {
     Vector<PhysicsShape*> arr;
@@ -486,11 +769,11 @@ bool PhysicsWorld::init()
 {
     do
     {
-#if CC_TARGET_PLATFORM == CC_PLATFORM_WINRT || CC_TARGET_PLATFORM == CC_PLATFORM_WIN32
-		_cpSpace = cpSpaceNew();
-#else
+#if CC_USE_CHIPMUNK_HASTY_SPACE
         _cpSpace = cpHastySpaceNew();
         cpHastySpaceSetThreads(_cpSpace, 0);
+#else
+        _cpSpace = cpSpaceNew();
 #endif
         CC_BREAK_IF(_cpSpace == nullptr);
         
@@ -870,6 +1153,10 @@ void PhysicsWorld::step(float delta)
 
 void PhysicsWorld::update(float delta, bool userCall/* = false*/)
 {
+    // the buffer keeps its capacity, the records are pooled across updates
+    _bufferedContacts.clear();
+    _stepStatistics = PhysicsStepStatistics();
+    
     if(!_delayAddBodies.empty())
     {
         updateBodies();
@@ -879,8 +1166,7 @@ void PhysicsWorld::update(float delta, bool userCall/* = false*/)
         updateBodies();
     }
     
-    auto sceneToWorldTransform = _scene->getNodeToParentTransform();
-    beforeSimulation(_scene, sceneToWorldTransform, 1.f, 1.f, 0.f);
+    beforeSimulation();
 
     if (!_delayAddJoints.empty() || !_delayRemoveJoints.empty())
     {
@@ -894,11 +1180,7 @@ void PhysicsWorld::update(float delta, bool userCall/* = false*/)
     
     if (userCall)
     {
-#if CC_TARGET_PLATFORM == CC_PLATFORM_WINRT || CC_TARGET_PLATFORM == CC_PLATFORM_WIN32
-		cpSpaceStep(_cpSpace, delta);
-#else
-		cpHastySpaceStep(_cpSpace, delta);
-#endif
+        stepSpace(delta);
     }
     else
     {
@@ -910,11 +1192,7 @@ void PhysicsWorld::update(float delta, bool userCall/* = false*/)
             while(_updateTime>step)
             {
                 _updateTime-=step;
-#if CC_TARGET_PLATFORM == CC_PLATFORM_WINRT || CC_TARGET_PLATFORM == CC_PLATFORM_WIN32
-				cpSpaceStep(_cpSpace, dt);
-#else
-				cpHastySpaceStep(_cpSpace, dt);
-#endif
+                stepSpace(dt);
 			}
         }
         else
@@ -924,11 +1202,7 @@ void PhysicsWorld::update(float delta, bool userCall/* = false*/)
                 const float dt = _updateTime * _speed / _substeps;
                 for (int i = 0; i < _substeps; ++i)
                 {
-#if CC_TARGET_PLATFORM == CC_PLATFORM_WINRT || CC_TARGET_PLATFORM == CC_PLATFORM_WIN32
-					cpSpaceStep(_cpSpace, dt);
-#else
-					cpHastySpaceStep(_cpSpace, dt);
-#endif 
+                    stepSpace(dt);
 					for (auto& body : _bodies)
                     {
                         body->update(dt);
@@ -945,9 +1219,254 @@ void PhysicsWorld::update(float delta, bool userCall/* = false*/)
         debugDraw();
     }
 
-    // Update physics position, should loop as the same sequence as node tree.
-    // PhysicsWorld::afterSimulation() will depend on the sequence.
-    afterSimulation(_scene, sceneToWorldTransform, 0.f);
+    afterSimulation();
+}
+
+typedef std::chrono::steady_clock StepClock;
+
+static float secondsSince(const StepClock::time_point& begin)
+{
+    return std::chrono::duration_cast<std::chrono::duration<float>>(StepClock::now() - begin).count();
+}
+
+// The pairs are found by the reindexQuery of the dynamic shapes' index. For the step statistics its class is
+// swapped for a copy counting them, from the beginning of the step until the broad phase starts: the trees
+// of Chipmunk identify each other by their class, the original one is back for the rest of the step.
+static struct
+{
+    cpSpatialIndexClass klass;
+    cpSpatialIndexClass* base;
+    PhysicsStepStatistics* statistics;
+    cpSpatialIndexQueryFunc func;
+    void* data;
+} s_pairCounter;
+
+static cpCollisionID countPair(void* obj1, void* obj2, cpCollisionID id, void* /*data*/)
+{
+    ++s_pairCounter.statistics->pairsTested;
+    return s_pairCounter.func(obj1, obj2, id, s_pairCounter.data);
+}
+
+static void countPairsReindexQuery(cpSpatialIndex* index, cpSpatialIndexQueryFunc func, void* data)
+{
+    index->klass = s_pairCounter.base;
+    s_pairCounter.func = func;
+    s_pairCounter.data = data;
+
+    auto begin = StepClock::now();
+    s_pairCounter.base->reindexQuery(index, countPair, nullptr);
+    s_pairCounter.statistics->collisionTime += secondsSince(begin);
+}
+
+static void beginCountingPairs(cpSpatialIndex* index, PhysicsStepStatistics* statistics)
+{
+    s_pairCounter.klass = *index->klass;
+    s_pairCounter.klass.reindexQuery = countPairsReindexQuery;
+    s_pairCounter.base = index->klass;
+    s_pairCounter.statistics = statistics;
+    index->klass = &s_pairCounter.klass;
+}
+
+static void endCountingPairs(cpSpatialIndex* index)
+{
+    // a step without bodies may not run the broad phase
+    if (index->klass == &s_pairCounter.klass)
+        index->klass = s_pairCounter.base;
+    s_pairCounter.statistics = nullptr;
+}
+
+void PhysicsWorld::stepSpace(float dt)
+{
+    StepClock::time_point begin;
+    float collisionTime = 0.0f;
+    if (_stepStatisticsEnabled)
+    {
+        collisionTime = _stepStatistics.collisionTime;
+        beginCountingPairs(_cpSpace->dynamicShapes, &_stepStatistics);
+        begin = StepClock::now();
+    }
+
+    // only the contacts of the steps are buffered, the ones of removed bodies may not outlive the buffer
+    _stepping = true;
+#if CC_USE_CHIPMUNK_HASTY_SPACE
+    if (!_deterministic)
+    {
+        cpHastySpaceStep(_cpSpace, dt);
+    }
+    else
+#endif
+    {
+        // a hasty space is a space, its plain step runs the solver serially
+        cpSpaceStep(_cpSpace, dt);
+    }
+    _stepping = false;
+
+    if (_stepStatisticsEnabled)
+    {
+        float stepTime = secondsSince(begin);
+        endCountingPairs(_cpSpace->dynamicShapes);
+
+        // the arbiters of the pairs colliding in this step
+        cpArray* arbiters = _cpSpace->arbiters;
+        _stepStatistics.collidingPairs += arbiters->num;
+        for (int i = 0; i < arbiters->num; ++i)
+        {
+            _stepStatistics.contacts += cpArbiterGetCount((cpArbiter*)arbiters->arr[i]);
+        }
+        collisionTime = _stepStatistics.collisionTime - collisionTime;
+        _stepStatistics.solverTime += std::max(stepTime - collisionTime, 0.0f);
+        ++_stepStatistics.steps;
+    }
+}
+
+static cpVect shapeVelocity(cpShape* shape)
+{
+    return shape->body->v;
+}
+
+static void moveShape(cpShape* shape, cpSpatialIndex* index)
+{
+    cpSpatialIndexInsert(index, shape, shape->hashid);
+}
+
+static cpSpatialIndex* newSpatialIndex(PhysicsWorld::SpatialIndex kind, float cellSize, int cellCount, cpSpatialIndex* staticIndex)
+{
+    if (kind == PhysicsWorld::SpatialIndex::SPATIAL_HASH)
+    {
+        return cpSpaceHashNew(cellSize, cellCount, (cpSpatialIndexBBFunc)cpShapeGetBB, staticIndex);
+    }
+
+    auto tree = cpBBTreeNew((cpSpatialIndexBBFunc)cpShapeGetBB, staticIndex);
+    // the dynamic tree fattens the boxes in the direction the shapes move, as the space's own one
+    if (staticIndex)
+    {
+        cpBBTreeSetVelocityFunc(tree, (cpBBTreeVelocityFunc)shapeVelocity);
+    }
+    return tree;
+}
+
+void PhysicsWorld::rebuildSpatialIndices()
+{
+    CCASSERT(!cpSpaceIsLocked(_cpSpace), "the spatial indices can't be changed while the world is stepped");
+
+    cpSpatialIndex* staticShapes = newSpatialIndex(_staticIndex, _hashCellSize, _hashCellCount, nullptr);
+    cpSpatialIndex* dynamicShapes = newSpatialIndex(_dynamicIndex, _hashCellSize, _hashCellCount, staticShapes);
+
+    cpSpatialIndexEach(_cpSpace->staticShapes, (cpSpatialIndexIteratorFunc)moveShape, staticShapes);
+    cpSpatialIndexEach(_cpSpace->dynamicShapes, (cpSpatialIndexIteratorFunc)moveShape, dynamicShapes);
+
+    cpSpatialIndexFree(_cpSpace->staticShapes);
+    cpSpatialIndexFree(_cpSpace->dynamicShapes);
+    _cpSpace->staticShapes = staticShapes;
+    _cpSpace->dynamicShapes = dynamicShapes;
+}
+
+void PhysicsWorld::setSpatialIndex(SpatialIndex dynamicIndex, SpatialIndex staticIndex/* = SpatialIndex::BB_TREE*/)
+{
+    if (dynamicIndex != _dynamicIndex || staticIndex != _staticIndex)
+    {
+        _dynamicIndex = dynamicIndex;
+        _staticIndex = staticIndex;
+        rebuildSpatialIndices();
+    }
+}
+
+void PhysicsWorld::setSpatialHashCells(float cellSize, int cellCount)
+{
+    CCASSERT(cellSize > 0 && cellCount > 0, "the cells of a spatial hash must have a size");
+    if (cellSize != _hashCellSize || cellCount != _hashCellCount)
+    {
+        _hashCellSize = cellSize;
+        _hashCellCount = cellCount;
+        if (_dynamicIndex == SpatialIndex::SPATIAL_HASH || _staticIndex == SpatialIndex::SPATIAL_HASH)
+        {
+            rebuildSpatialIndices();
+        }
+    }
+}
+
+void PhysicsWorld::setIterations(int iterations)
+{
+    CCASSERT(iterations > 0, "the solver needs an iteration at least");
+    cpSpaceSetIterations(_cpSpace, iterations);
+}
+
+int PhysicsWorld::getIterations() const
+{
+    return cpSpaceGetIterations(_cpSpace);
+}
+
+void PhysicsWorld::setSleepTimeThreshold(float seconds)
+{
+    cpSpaceSetSleepTimeThreshold(_cpSpace, seconds >= PHYSICS_INFINITY ? INFINITY : seconds);
+}
+
+float PhysicsWorld::getSleepTimeThreshold() const
+{
+    return (float)std::min(cpSpaceGetSleepTimeThreshold(_cpSpace), (cpFloat)PHYSICS_INFINITY);
+}
+
+void PhysicsWorld::setIdleSpeedThreshold(float speed)
+{
+    cpSpaceSetIdleSpeedThreshold(_cpSpace, speed);
+}
+
+float PhysicsWorld::getIdleSpeedThreshold() const
+{
+    return (float)cpSpaceGetIdleSpeedThreshold(_cpSpace);
+}
+
+void PhysicsWorld::setCollisionSlop(float slop)
+{
+    cpSpaceSetCollisionSlop(_cpSpace, slop);
+}
+
+float PhysicsWorld::getCollisionSlop() const
+{
+    return (float)cpSpaceGetCollisionSlop(_cpSpace);
+}
+
+void PhysicsWorld::setCollisionBias(float bias)
+{
+    cpSpaceSetCollisionBias(_cpSpace, bias);
+}
+
+float PhysicsWorld::getCollisionBias() const
+{
+    return (float)cpSpaceGetCollisionBias(_cpSpace);
+}
+
+void PhysicsWorld::setStepStatisticsEnabled(bool enabled)
+{
+    _stepStatisticsEnabled = enabled;
+    _stepStatistics = PhysicsStepStatistics();
+}
+
+void PhysicsWorld::setSolverThreads(unsigned int threads)
+{
+#if CC_USE_CHIPMUNK_HASTY_SPACE
+    cpHastySpaceSetThreads(_cpSpace, threads);
+    if (_deterministic && threads != 1)
+    {
+        CCLOG("Physics Warning: the world is deterministic, it keeps stepping on the calling thread only");
+    }
+#else
+    if (threads != 1)
+    {
+        CCLOG("Physics Warning: the solver is single-threaded, define CC_USE_CHIPMUNK_HASTY_SPACE to 1 and link a Chipmunk built with cpHastySpace to use %u threads", threads);
+    }
+#endif
+}
+
+unsigned int PhysicsWorld::getSolverThreads() const
+{
+#if CC_USE_CHIPMUNK_HASTY_SPACE
+    if (!_deterministic)
+    {
+        return (unsigned int)cpHastySpaceGetThreads(_cpSpace);
+    }
+#endif
+    return 1;
 }
 
 PhysicsWorld* PhysicsWorld::construct(Scene* scene)
@@ -973,14 +1492,22 @@ PhysicsWorld::PhysicsWorld()
 , _substeps(1)
 , _fixedRate(0)
 , _cpSpace(nullptr)
+, _deterministic(false)
 , _updateBodyTransform(false)
 , _scene(nullptr)
 , _autoStep(true)
 , _debugDraw(nullptr)
 , _debugDrawMask(DEBUGDRAW_NONE)
+, _contactBufferMask(CONTACT_BUFFER_NONE)
+, _stepping(false)
+, _dynamicIndex(SpatialIndex::BB_TREE)
+, _staticIndex(SpatialIndex::BB_TREE)
+, _hashCellSize(50.0f)
+, _hashCellCount(1000)
+, _stepStatisticsEnabled(false)
 , _eventDispatcher(nullptr)
 {
-    
+    _stepStatistics = PhysicsStepStatistics();
 }
 
 PhysicsWorld::~PhysicsWorld()
@@ -989,46 +1516,153 @@ PhysicsWorld::~PhysicsWorld()
     removeAllBodies();
     if (_cpSpace)
     {
-#if CC_TARGET_PLATFORM == CC_PLATFORM_WINRT || CC_TARGET_PLATFORM == CC_PLATFORM_WIN32
-		cpSpaceFree(_cpSpace);
+#if CC_USE_CHIPMUNK_HASTY_SPACE
+        cpHastySpaceFree(_cpSpace);
 #else
-		cpHastySpaceFree(_cpSpace);
-#endif 
+        cpSpaceFree(_cpSpace);
+#endif
     }
     CC_SAFE_RELEASE_NULL(_debugDraw);
 }
 
-void PhysicsWorld::beforeSimulation(Node *node, const Mat4& parentToWorldTransform, float nodeParentScaleX, float nodeParentScaleY, float parentRotation)
+int PhysicsWorld::getSyncTransform(Node* node)
 {
-    auto scaleX = nodeParentScaleX * node->getScaleX();
-    auto scaleY = nodeParentScaleY * node->getScaleY();
-    auto rotation = parentRotation + node->getRotation();
+    auto iter = _syncTransformIndices.find(node);
+    if (iter != _syncTransformIndices.end())
+    {
+        return iter->second;
+    }
 
-    auto nodeToWorldTransform = parentToWorldTransform * node->getNodeToParentTransform();
+    SyncTransform transform;
+    transform.inversed = false;
+    if (node == _scene)
+    {
+        // the scene's transform is applied on top of itself, as the tree walk always did
+        auto sceneToWorldTransform = _scene->getNodeToParentTransform();
+        transform.nodeToWorld = sceneToWorldTransform * sceneToWorldTransform;
+        transform.scaleX = _scene->getScaleX();
+        transform.scaleY = _scene->getScaleY();
+        transform.rotation = _scene->getRotation();
+    }
+    else
+    {
+        int parentIndex = node->getParent() ? getSyncTransform(node->getParent()) : -1;
+        if (parentIndex < 0)
+        {
+            _syncTransformIndices[node] = -1;
+            return -1;
+        }
+        const SyncTransform& parent = _syncTransforms[parentIndex];
+        transform.nodeToWorld = parent.nodeToWorld * node->getNodeToParentTransform();
+        transform.scaleX = parent.scaleX * node->getScaleX();
+        transform.scaleY = parent.scaleY * node->getScaleY();
+        transform.rotation = parent.rotation + node->getRotation();
+    }
 
-    auto physicsBody = node->getPhysicsBody();
-    if (physicsBody)
+    int index = (int)_syncTransforms.size();
+    _syncTransforms.push_back(transform);
+    _syncTransformIndices[node] = index;
+    return index;
+}
+
+int PhysicsWorld::getSyncParentTransform(Node* owner)
+{
+    int index;
+    if (owner == _scene)
     {
-        physicsBody->beforeSimulation(parentToWorldTransform, nodeToWorldTransform, scaleX, scaleY, rotation);
+        // the scene's parent transform is its own
+        auto iter = _syncTransformIndices.find(nullptr);
+        if (iter == _syncTransformIndices.end())
+        {
+            SyncTransform transform;
+            transform.nodeToWorld = _scene->getNodeToParentTransform();
+            transform.scaleX = 1.f;
+            transform.scaleY = 1.f;
+            transform.rotation = 0.f;
+            transform.inversed = false;
+            index = (int)_syncTransforms.size();
+            _syncTransforms.push_back(transform);
+            _syncTransformIndices[nullptr] = index;
+        }
+        else
+        {
+            index = iter->second;
+        }
     }
+    else
+    {
+        index = owner->getParent() ? getSyncTransform(owner->getParent()) : -1;
+        if (index < 0)
+        {
+            return -1;
+        }
+    }
+
+    // many bodies usually share a parent, it's inversed once
+    auto& transform = _syncTransforms[index];
+    if (!transform.inversed)
+    {
+        transform.worldToNode = transform.nodeToWorld.getInversed();
+        transform.inversed = true;
+    }
+    return index;
+}
 
-    for (auto child : node->getChildren())
-        beforeSimulation(child, nodeToWorldTransform, scaleX, scaleY, rotation);
+void PhysicsWorld::beforeSimulation()
+{
+    _syncTransformIndices.clear();
+    _syncTransforms.clear();
+    _syncTransforms.reserve(_bodies.size());
+
+    for (auto& body : _bodies)
+    {
+        auto owner = body->getNode();
+        int index = getSyncParentTransform(owner);
+        if (index < 0)
+        {
+            continue;
+        }
+
+        const SyncTransform& parent = _syncTransforms[index];
+        auto nodeToWorldTransform = parent.nodeToWorld * owner->getNodeToParentTransform();
+        body->beforeSimulation(parent.worldToNode, nodeToWorldTransform,
+                               parent.scaleX * owner->getScaleX(), parent.scaleY * owner->getScaleY(),
+                               parent.rotation + owner->getRotation());
+    }
 }
 
-void PhysicsWorld::afterSimulation(Node *node, const Mat4& parentToWorldTransform, float parentRotation)
+void PhysicsWorld::afterSimulation()
 {
-    auto nodeToWorldTransform = parentToWorldTransform * node->getNodeToParentTransform();
-    auto nodeRotation = parentRotation + node->getRotation();
+    // the parents' transforms are all taken before any node moves, so the order of the bodies doesn't matter
+    _syncTransformIndices.clear();
+    _syncTransforms.clear();
+    _syncBodies.clear();
 
-    auto physicsBody = node->getPhysicsBody();
-    if (physicsBody)
+    for (auto& body : _bodies)
     {
-        physicsBody->afterSimulation(parentToWorldTransform, parentRotation);
+        auto cpBody = body->getCPBody();
+        if (cpBodyIsSleeping(cpBody) && cpBodyGetAngle(cpBody) == body->_recordedAngle)
+        {
+            auto position = body->getPosition();
+            if (position.x == body->_recordPosX && position.y == body->_recordPosY)
+            {
+                continue;
+            }
+        }
+
+        int index = getSyncParentTransform(body->getNode());
+        if (index >= 0)
+        {
+            _syncBodies.push_back(std::make_pair(body, index));
+        }
     }
 
-    for (auto child : node->getChildren())
-        afterSimulation(child, nodeToWorldTransform, nodeRotation);
+    for (auto& syncBody : _syncBodies)
+    {
+        const SyncTransform& parent = _syncTransforms[syncBody.second];
+        syncBody.first->afterSimulation(parent.worldToNode, parent.rotation);
+    }
+    _syncBodies.clear();
 }
 
 NS_CC_END
@@ -29,9 +29,11 @@
 #if CC_USE_PHYSICS
 
 #include <list>
+#include <unordered_map>
 #include "base/CCVector.h"
 #include "math/CCGeometry.h"
 #include "physics/CCPhysicsBody.h"
+#include "physics/CCPhysicsContact.h"
 
 struct cpSpace;
 
@@ -84,6 +86,67 @@ typedef std::function<bool(PhysicsWorld& world, const PhysicsRayCastInfo& info,
 typedef std::function<bool(PhysicsWorld&, PhysicsShape&, void*)> PhysicsQueryRectCallbackFunc;
 typedef PhysicsQueryRectCallbackFunc PhysicsQueryPointCallbackFunc;
 
+/**
+ * A ray of PhysicsWorld::rayCastFirst(), only the shapes whose category bitmask shares a bit with categoryMask are hit.
+ * @since v3.14
+ */
+typedef struct PhysicsRayCastQuery
+{
+    Vec2 start;
+    Vec2 end;
+    int categoryMask;
+}PhysicsRayCastQuery;
+
+/**
+ * A rect of PhysicsWorld::queryRects(), only the shapes whose category bitmask shares a bit with categoryMask are found.
+ * @since v3.14
+ */
+typedef struct PhysicsRectQuery
+{
+    Rect rect;
+    int categoryMask;
+}PhysicsRectQuery;
+
+/**
+ * A point of PhysicsWorld::queryPoints(), only the shapes whose category bitmask shares a bit with categoryMask are found.
+ * @since v3.14
+ */
+typedef struct PhysicsPointQuery
+{
+    Vec2 point;
+    int categoryMask;
+}PhysicsPointQuery;
+
+/**
+ * The shapes found by a query of a batch, shapes[first] to shapes[first + count - 1].
+ * @since v3.14
+ */
+typedef struct PhysicsQueryResult
+{
+    int first;
+    int count;
+}PhysicsQueryResult;
+
+/**
+ * The work of the steps of the last update of a PhysicsWorld, see PhysicsWorld::setStepStatisticsEnabled().
+ * The counts and the times are the sums of the steps, divide them by steps for the averages.
+ * @since v3.14
+ */
+typedef struct PhysicsStepStatistics
+{
+    int steps;
+    /** the pairs of shapes with overlapping bounding boxes found by the spatial indices, before the filters and the narrow phase */
+    int pairsTested;
+    /** the pairs of shapes colliding after the narrow phase */
+    int collidingPairs;
+    /** the contact points of the colliding pairs */
+    int contacts;
+    /** seconds spent finding the colliding pairs, the broad and the narrow phase */
+    float collisionTime;
+    /** seconds spent in the rest of the steps, mostly solving the contacts and the joints */
+    float solverTime;
+}PhysicsStepStatistics;
+
 /**
  * @addtogroup physics
  * @{
@@ -103,6 +166,23 @@ public:
     static const int DEBUGDRAW_JOINT;       ///< draw joints
     static const int DEBUGDRAW_CONTACT;     ///< draw contact
     static const int DEBUGDRAW_ALL;         ///< draw all
+
+    static const int CONTACT_BUFFER_NONE;       ///< dispatch the contacts, don't buffer them
+    static const int CONTACT_BUFFER_BEGIN;      ///< buffer the contacts beginning
+    static const int CONTACT_BUFFER_PRESOLVE;   ///< buffer the contacts about to be solved
+    static const int CONTACT_BUFFER_POSTSOLVE;  ///< buffer the solved contacts
+    static const int CONTACT_BUFFER_SEPARATE;   ///< buffer the contacts separating
+    static const int CONTACT_BUFFER_ALL;        ///< buffer all the contacts
+
+    /**
+     * The spatial indices the colliding shapes are found with.
+     * @since v3.14
+     */
+    enum class SpatialIndex
+    {
+        BB_TREE,        ///< a tree of bounding boxes, for shapes of any size
+        SPATIAL_HASH,   ///< a hash of grid cells, faster for many shapes of similar sizes
+    };
     
 public:
     /**
@@ -187,6 +267,42 @@ public:
     * @param   data   User defined data, it is passed to func. 
     */
     void queryPoint(PhysicsQueryPointCallbackFunc func, const Vec2& point, void* data);
+
+    /**
+    * Casts a batch of rays, finding the first shape each of them hits.
+    *
+    * No callback is called, which makes it much cheaper than rayCast() for many rays.
+    * @param   queries   The rays.
+    * @param   count   The number of rays.
+    * @param   results   The hits, one per ray, their shape is nullptr for the rays hitting nothing and their data is nullptr.
+    * @param   parallel   Cast the rays on the JobSystem workers, the calling thread waits for them.
+    * @since v3.14
+    */
+    void rayCastFirst(const PhysicsRayCastQuery* queries, int count, PhysicsRayCastInfo* results, bool parallel = false);
+
+    /**
+    * Searches for the shapes whose bounding box overlaps each rect of a batch.
+    *
+    * @param   queries   The rects.
+    * @param   count   The number of rects.
+    * @param   shapes   The found shapes are appended to it.
+    * @param   results   The ranges of shapes found by each rect, one per rect.
+    * @param   parallel   Query the rects on the JobSystem workers, the calling thread waits for them.
+    * @since v3.14
+    */
+    void queryRects(const PhysicsRectQuery* queries, int count, std::vector<PhysicsShape*>& shapes, PhysicsQueryResult* results, bool parallel = false);
+
+    /**
+    * Searches for the shapes that contain each point of a batch.
+    *
+    * @param   queries   The points.
+    * @param   count   The number of points.
+    * @param   shapes   The found shapes are appended to it.
+    * @param   results   The ranges of shapes found by each point, one per point.
+    * @param   parallel   Query the points on the JobSystem workers, the calling thread waits for them.
+    * @since v3.14
+    */
+    void queryPoints(const PhysicsPointQuery* queries, int count, std::vector<PhysicsShape*>& shapes, PhysicsQueryResult* results, bool parallel = false);
     
     /**
     * Get physics shapes that contains the point. 
@@ -301,6 +417,162 @@ public:
     /** get the number of substeps */
     int getFixedUpdateRate() const { return _fixedRate; }
 
+    /**
+     * Set the number of threads the solver steps the world with.
+     *
+     * Only Chipmunk's multithreaded solver uses it, it's always 1 without CC_USE_CHIPMUNK_HASTY_SPACE.
+     * @warning CC_USE_CHIPMUNK_HASTY_SPACE is 0 by default on Windows, where this call only logs a warning
+     * and the world keeps stepping on one thread.
+     * @param threads The number of threads, 0 for one per core as allowed by Chipmunk, default value is 0.
+     * @since v3.14
+     */
+    void setSolverThreads(unsigned int threads);
+
+    /**
+     * Get the number of threads the solver actually uses.
+     *
+     * @return 1 if the world is deterministic or the solver isn't multithreaded.
+     * @since v3.14
+     */
+    unsigned int getSolverThreads() const;
+
+    /**
+     * Step the world on the calling thread only, so that the same inputs always give the same simulation.
+     *
+     * Combine it with setFixedUpdateRate() to make the steps independent of the frame rate.
+     * @param deterministic A bool object, default value is false.
+     * @since v3.14
+     */
+    void setDeterministic(bool deterministic) { _deterministic = deterministic; }
+
+    /** Whether the world is stepped deterministically. @since v3.14 */
+    bool isDeterministic() const { return _deterministic; }
+
+    /**
+     * Buffer the contacts of the steps instead of dispatching them to the EventListenerPhysicsContact listeners.
+     *
+     * While buffering, no PhysicsContact is allocated nor dispatched: the contact events whose flag is in the mask
+     * are written into a pooled array, read with getBufferedContacts() once the world has been updated.
+     * The buffered contacts can't be rejected, collisions are only filtered by the bitmasks and groups of the shapes.
+     * The separations happening when a body is removed aren't buffered, since its shapes may be released before they're read.
+     * @param mask CONTACT_BUFFER_NONE, or a combination of CONTACT_BUFFER_BEGIN, CONTACT_BUFFER_PRESOLVE,
+     * CONTACT_BUFFER_POSTSOLVE and CONTACT_BUFFER_SEPARATE, default is CONTACT_BUFFER_NONE.
+     * @since v3.14
+     */
+    void setContactBufferMask(int mask) { _contactBufferMask = mask; }
+
+    /** Get the contact buffer mask. @since v3.14 */
+    int getContactBufferMask() const { return _contactBufferMask; }
+
+    /**
+     * Get the contacts buffered by the steps of the last update of the world, in the order they happened.
+     * @since v3.14
+     */
+    const std::vector<PhysicsContactRecord>& getBufferedContacts() const { return _bufferedContacts; }
+
+    /**
+     * Set the spatial indices of the shapes, the shapes of the static bodies have an index of their own.
+     *
+     * The shapes are moved to the new indices. With thousands of dynamic bodies of similar sizes a spatial hash
+     * whose cells are about the size of the shapes finds the pairs faster, while a static level of varied
+     * sizes is usually better left in a tree.
+     * @attention It can't be called from the contact callbacks.
+     * @param dynamicIndex The index of the shapes of the dynamic and kinematic bodies, default is SpatialIndex::BB_TREE.
+     * @param staticIndex The index of the shapes of the static bodies, default is SpatialIndex::BB_TREE.
+     * @since v3.14
+     */
+    void setSpatialIndex(SpatialIndex dynamicIndex, SpatialIndex staticIndex = SpatialIndex::BB_TREE);
+
+    /** Get the spatial index of the shapes of the dynamic bodies. @since v3.14 */
+    SpatialIndex getSpatialIndex() const { return _dynamicIndex; }
+
+    /** Get the spatial index of the shapes of the static bodies. @since v3.14 */
+    SpatialIndex getStaticSpatialIndex() const { return _staticIndex; }
+
+    /**
+     * Set the cells of the spatial hashes, the indices are rebuilt if one of them is a hash.
+     *
+     * @param cellSize The width and height of a cell, about the size of the shapes, default is 50.
+     * @param cellCount The size of the hash table, about 10 times the number of shapes, default is 1000.
+     * @since v3.14
+     */
+    void setSpatialHashCells(float cellSize, int cellCount);
+
+    /** Get the size of the cells of the spatial hashes. @since v3.14 */
+    float getSpatialHashCellSize() const { return _hashCellSize; }
+
+    /** Get the size of the hash table of the spatial hashes. @since v3.14 */
+    int getSpatialHashCellCount() const { return _hashCellCount; }
+
+    /**
+     * Set the number of iterations of the solver per step, more are more accurate and slower.
+     * @param iterations An integer number, default value is 10.
+     * @since v3.14
+     */
+    void setIterations(int iterations);
+
+    /** Get the number of iterations of the solver per step. @since v3.14 */
+    int getIterations() const;
+
+    /**
+     * Set the time a group of bodies has to be idle before it falls asleep, sleeping bodies cost nothing to step.
+     * @param seconds A float number, PHYSICS_INFINITY disables the sleeping, default value is PHYSICS_INFINITY.
+     * @since v3.14
+     */
+    void setSleepTimeThreshold(float seconds);
+
+    /** Get the time a group of bodies has to be idle before it falls asleep. @since v3.14 */
+    float getSleepTimeThreshold() const;
+
+    /**
+     * Set the speed under which a body is idle.
+     * @param speed A float number, 0 for a speed estimated from the gravity, default value is 0.
+     * @since v3.14
+     */
+    void setIdleSpeedThreshold(float speed);
+
+    /** Get the speed under which a body is idle. @since v3.14 */
+    float getIdleSpeedThreshold() const;
+
+    /**
+     * Set how much the shapes may overlap, a small overlap keeps the contacts between the steps and avoids jittering.
+     * @param slop A float number, default value is 0.1.
+     * @since v3.14
+     */
+    void setCollisionSlop(float slop);
+
+    /** Get how much the shapes may overlap. @since v3.14 */
+    float getCollisionSlop() const;
+
+    /**
+     * Set how fast the overlapping shapes are pushed apart, the share of the overlap left after a second.
+     * @param bias A float number from 0 to 1, default value is 0.9 ^ 60, 10% of the overlap is corrected every 1/60 second.
+     * @since v3.14
+     */
+    void setCollisionBias(float bias);
+
+    /** Get how fast the overlapping shapes are pushed apart. @since v3.14 */
+    float getCollisionBias() const;
+
+    /**
+     * Count the work of the steps, read with getStepStatistics() once the world has been updated.
+     *
+     * The pairs are counted by wrapping the spatial index of the dynamic shapes and the steps are timed,
+     * so the statistics have a small cost and are disabled by default.
+     * @param enabled A bool object, default value is false.
+     * @since v3.14
+     */
+    void setStepStatisticsEnabled(bool enabled);
+
+    /** Whether the work of the steps is counted. @since v3.14 */
+    bool isStepStatisticsEnabled() const { return _stepStatisticsEnabled; }
+
+    /**
+     * Get the work of the steps of the last update of the world, all zeros if the statistics are disabled.
+     * @since v3.14
+     */
+    const PhysicsStepStatistics& getStepStatistics() const { return _stepStatistics; }
+
     /**
     * Set the debug draw mask of this physics world.
     * 
@@ -366,6 +638,10 @@ protected:
     virtual void removeBodyOrDelay(PhysicsBody* body);
     virtual void updateBodies();
     virtual void updateJoints();
+    void stepSpace(float dt);
+    /** moves the shapes to new spatial indices of the selected kinds */
+    void rebuildSpatialIndices();
+    bool shouldCollide(PhysicsShape* shapeA, PhysicsShape* shapeB, bool& notify);
     
 protected:
     Vec2 _gravity;
@@ -376,6 +652,7 @@ protected:
     int _substeps;
     int _fixedRate;
     cpSpace* _cpSpace;
+    bool _deterministic;
     
     bool _updateBodyTransform;
     Vector<PhysicsBody*> _bodies;
@@ -385,6 +662,16 @@ protected:
     bool _autoStep;
     DrawNode* _debugDraw;
     int _debugDrawMask;
+    int _contactBufferMask;
+    bool _stepping;
+    std::vector<PhysicsContactRecord> _bufferedContacts;
+
+    SpatialIndex _dynamicIndex;
+    SpatialIndex _staticIndex;
+    float _hashCellSize;
+    int _hashCellCount;
+    bool _stepStatisticsEnabled;
+    PhysicsStepStatistics _stepStatistics;
     
     EventDispatcher* _eventDispatcher;
 
@@ -392,13 +679,35 @@ protected:
     Vector<PhysicsBody*> _delayRemoveBodies;
     std::vector<PhysicsJoint*> _delayAddJoints;
     std::vector<PhysicsJoint*> _delayRemoveJoints;
+
+    /** the transform, scale and rotation accumulated from the scene down to a node, valid for one sync pass */
+    struct SyncTransform
+    {
+        Mat4 nodeToWorld;
+        Mat4 worldToNode;
+        float scaleX;
+        float scaleY;
+        float rotation;
+        bool inversed;
+    };
+    // the nodes' indices in _syncTransforms, -1 for the nodes outside of the scene
+    std::unordered_map<Node*, int> _syncTransformIndices;
+    std::vector<SyncTransform> _syncTransforms;
+    // the awake bodies with their parents' indices in _syncTransforms, waiting to move their nodes
+    std::vector<std::pair<PhysicsBody*, int>> _syncBodies;
     
 protected:
     PhysicsWorld();
     virtual ~PhysicsWorld();
     
-    void beforeSimulation(Node *node, const Mat4& parentToWorldTransform, float nodeParentScaleX, float nodeParentScaleY, float parentRotation);
-    void afterSimulation(Node* node, const Mat4& parentToWorldTransform, float parentRotation);
+    /** copies the nodes' transforms to their bodies, walking the bodies instead of the node tree */
+    void beforeSimulation();
+    /** copies the bodies' transforms back to their nodes, the bodies sleeping since the last sync are skipped */
+    void afterSimulation();
+    /** returns the index of the node's transform in _syncTransforms, computing its ancestors' on the way, -1 if the node isn't in the scene */
+    int getSyncTransform(Node* node);
+    /** returns the index of the parent's transform of a body's owner, with its inverse computed, -1 if the owner isn't in the scene */
+    int getSyncParentTransform(Node* owner);
 
     friend class Node;
     friend class Sprite;
@@ -151,10 +151,22 @@ void Physics3DComponent::preSimulate()
     }
 }
 
-void Physics3DComponent::postSimulate()
+void Physics3DComponent::postSimulate(bool interpolated)
 {
     if (((int)_syncFlag & (int)Physics3DComponent::PhysicsSyncFlag::PHYSICS_TO_NODE) && _physics3DObj && _owner)
     {
+        if (interpolated && _physics3DObj->getObjType() == Physics3DObject::PhysicsObjType::RIGID_BODY)
+        {
+            // the motion state gets the transform interpolated between the fixed substeps
+            auto motionState = static_cast<Physics3DRigidBody*>(_physics3DObj)->getRigidBody()->getMotionState();
+            if (motionState)
+            {
+                btTransform transform;
+                motionState->getWorldTransform(transform);
+                syncPhysicsToNode(convertbtTransformToMat4(transform));
+                return;
+            }
+        }
         syncPhysicsToNode();
     }
 }
@@ -175,6 +187,11 @@ void Physics3DComponent::setSyncFlag(PhysicsSyncFlag syncFlag)
 }
 
 void Physics3DComponent::syncPhysicsToNode()
+{
+    syncPhysicsToNode(_physics3DObj->getWorldTransform());
+}
+
+void Physics3DComponent::syncPhysicsToNode(const cocos2d::Mat4& physicsTransform)
 {
     if (_physics3DObj->getObjType() == Physics3DObject::PhysicsObjType::RIGID_BODY
      || _physics3DObj->getObjType() == Physics3DObject::PhysicsObjType::COLLIDER)
@@ -183,7 +200,7 @@ void Physics3DComponent::syncPhysicsToNode()
         if (_owner->getParent())
             parentMat = _owner->getParent()->getNodeToWorldTransform();
         
-        auto mat = parentMat.getInversed() * _physics3DObj->getWorldTransform();
+        auto mat = parentMat.getInversed() * physicsTransform;
         //remove scale, no scale support for physics
         float oneOverLen = 1.f / sqrtf(mat.m[0] * mat.m[0] + mat.m[1] * mat.m[1] + mat.m[2] * mat.m[2]);
         mat.m[0] *= oneOverLen;
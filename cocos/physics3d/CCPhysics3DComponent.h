@@ -125,7 +125,9 @@ CC_CONSTRUCTOR_ACCESS:
 protected:
     void preSimulate();
     
-    void postSimulate();
+    void postSimulate(bool interpolated = false);
+    
+    void syncPhysicsToNode(const cocos2d::Mat4& physicsTransform);
     
     cocos2d::Mat4             _transformInPhysics; //transform in physics space
     cocos2d::Mat4             _invTransformInPhysics;
@@ -22,31 +22,207 @@
  THE SOFTWARE.
  ****************************************************************************/
 
+#include <algorithm>
 #include "physics3d/CCPhysics3D.h"
 #include "renderer/CCRenderer.h"
+#include "base/CCDirector.h"
+#include "base/CCEventDispatcher.h"
+#include "base/CCEventListenerCustom.h"
 
 #if CC_USE_3D_PHYSICS
 
 #if (CC_ENABLE_BULLET_INTEGRATION)
 
+#if CC_ENABLE_BULLET_MULTITHREADING
+#include <mutex>
+#include "bullet/LinearMath/btThreads.h"
+#include "bullet/BulletCollision/CollisionDispatch/btCollisionDispatcherMt.h"
+#include "bullet/BulletDynamics/Dynamics/btDiscreteDynamicsWorldMt.h"
+#include "bullet/BulletDynamics/ConstraintSolver/btSequentialImpulseConstraintSolverMt.h"
+#endif
+
 NS_CC_BEGIN
 
+namespace
+{
+    // gathers the objects of the broadphase leaves passing the filter, the broadphase's own ray test isn't reentrant
+    class BroadphaseCollector : public btDbvt::ICollide
+    {
+    public:
+        BroadphaseCollector(btAlignedObjectArray<btCollisionObject*>& objects, short group, short mask)
+        : _objects(objects)
+        , _group(group)
+        , _mask(mask)
+        {}
+        
+        using btDbvt::ICollide::Process;
+        virtual void Process(const btDbvtNode* leaf) override
+        {
+            auto proxy = static_cast<btBroadphaseProxy*>(leaf->data);
+            if ((proxy->m_collisionFilterGroup & _mask) != 0 && (_group & proxy->m_collisionFilterMask) != 0)
+            {
+                _objects.push_back(static_cast<btCollisionObject*>(proxy->m_clientObject));
+            }
+        }
+        
+    private:
+        btAlignedObjectArray<btCollisionObject*>& _objects;
+        short _group;
+        short _mask;
+    };
+    
+    class AllHitsConvexResultCallback : public btCollisionWorld::ConvexResultCallback
+    {
+    public:
+        AllHitsConvexResultCallback(std::vector<Physics3DWorld::HitResult>& hits)
+        : _hits(hits)
+        {}
+        
+        virtual btScalar addSingleResult(btCollisionWorld::LocalConvexResult& convexResult, bool normalInWorldSpace) override
+        {
+            btVector3 normal = normalInWorldSpace ? convexResult.m_hitNormalLocal
+                : convexResult.m_hitCollisionObject->getWorldTransform().getBasis() * convexResult.m_hitNormalLocal;
+            Physics3DWorld::HitResult hit;
+            hit.hitObj = static_cast<Physics3DObject*>(convexResult.m_hitCollisionObject->getUserPointer());
+            hit.hitPosition = convertbtVector3ToVec3(convexResult.m_hitPointLocal);
+            hit.hitNormal = convertbtVector3ToVec3(normal);
+            hit.hitFraction = convexResult.m_hitFraction;
+            _hits.push_back(hit);
+            // keeps the whole sweep open to the other hits
+            return m_closestHitFraction;
+        }
+        
+    private:
+        std::vector<Physics3DWorld::HitResult>& _hits;
+    };
+    
+    Physics3DWorld::HitResult makeHitResult(const btCollisionObject* object, const btVector3& position, const btVector3& normal, btScalar fraction)
+    {
+        Physics3DWorld::HitResult hit;
+        hit.hitObj = static_cast<Physics3DObject*>(object->getUserPointer());
+        hit.hitPosition = convertbtVector3ToVec3(position);
+        hit.hitNormal = convertbtVector3ToVec3(normal);
+        hit.hitFraction = fraction;
+        return hit;
+    }
+    
+    bool hitResultLess(const Physics3DWorld::HitResult& a, const Physics3DWorld::HitResult& b)
+    {
+        return a.hitFraction < b.hitFraction;
+    }
+    
+    // the batch is split in chunks so that each job appends to its own array, the arrays are merged in order afterwards
+    const int QUERY_BATCH_CHUNK = 16;
+    
+    template <typename Query>
+    void runQueryBatch(int count, std::vector<Physics3DWorld::HitResult>& hits, Physics3DWorld::QueryRange* ranges, bool parallel, const Query& query)
+    {
+        if (!parallel || count <= QUERY_BATCH_CHUNK)
+        {
+            for (int i = 0; i < count; ++i)
+            {
+                ranges[i].first = (int)hits.size();
+                query(i, hits);
+                ranges[i].count = (int)hits.size() - ranges[i].first;
+            }
+            return;
+        }
+        
+        const int chunkCount = (count + QUERY_BATCH_CHUNK - 1) / QUERY_BATCH_CHUNK;
+        std::vector<std::vector<Physics3DWorld::HitResult>> chunkHits(chunkCount);
+        JobSystem::getInstance()->parallelFor(chunkCount, 1, [&](size_t begin, size_t end) {
+            for (size_t chunk = begin; chunk < end; ++chunk)
+            {
+                auto& found = chunkHits[chunk];
+                const int last = std::min(count, (int)(chunk + 1) * QUERY_BATCH_CHUNK);
+                for (int i = (int)chunk * QUERY_BATCH_CHUNK; i < last; ++i)
+                {
+                    ranges[i].first = (int)found.size();
+                    query(i, found);
+                    ranges[i].count = (int)found.size() - ranges[i].first;
+                }
+            }
+        });
+        
+        for (int chunk = 0; chunk < chunkCount; ++chunk)
+        {
+            const int base = (int)hits.size();
+            const int last = std::min(count, (chunk + 1) * QUERY_BATCH_CHUNK);
+            for (int i = chunk * QUERY_BATCH_CHUNK; i < last; ++i)
+            {
+                ranges[i].first += base;
+            }
+            hits.insert(hits.end(), chunkHits[chunk].begin(), chunkHits[chunk].end());
+        }
+    }
+}
+
+#if CC_ENABLE_BULLET_MULTITHREADING
+namespace
+{
+    // runs Bullet's parallel loops on the JobSystem instead of Bullet's own thread pools
+    class JobSystemTaskScheduler : public btITaskScheduler
+    {
+    public:
+        JobSystemTaskScheduler() : btITaskScheduler("JobSystem") {}
+        
+        virtual int getMaxNumThreads() const override { return std::min((int)JobSystem::getInstance()->getWorkerCount() + 1, (int)BT_MAX_THREAD_COUNT); }
+        virtual int getNumThreads() const override { return getMaxNumThreads(); }
+        virtual void setNumThreads(int /*numThreads*/) override {}
+        
+        virtual void parallelFor(int iBegin, int iEnd, int grainSize, const btIParallelForBody& body) override
+        {
+            JobSystem::getInstance()->parallelFor(iEnd - iBegin, std::max(grainSize, 1), [iBegin, &body](size_t begin, size_t end) {
+                body.forLoop(iBegin + (int)begin, iBegin + (int)end);
+            });
+        }
+        
+        virtual btScalar parallelSum(int iBegin, int iEnd, int grainSize, const btIParallelSumBody& body) override
+        {
+            btScalar sum = 0;
+            std::mutex mutex;
+            JobSystem::getInstance()->parallelFor(iEnd - iBegin, std::max(grainSize, 1), [iBegin, &body, &sum, &mutex](size_t begin, size_t end) {
+                btScalar partial = body.sumLoop(iBegin + (int)begin, iBegin + (int)end);
+                std::lock_guard<std::mutex> lock(mutex);
+                sum += partial;
+            });
+            return sum;
+        }
+    };
+    
+    void installTaskScheduler()
+    {
+        static JobSystemTaskScheduler scheduler;
+        if (btGetTaskScheduler() != &scheduler)
+        {
+            btSetTaskScheduler(&scheduler);
+        }
+    }
+}
+#endif
+
 Physics3DWorld::Physics3DWorld()
 : _btPhyiscsWorld(nullptr)
 , _collisionConfiguration(nullptr)
 , _dispatcher(nullptr)
 , _broadphase(nullptr)
 , _solver(nullptr)
+, _solverPool(nullptr)
 , _ghostCallback(nullptr)
 , _debugDrawer(nullptr)
 , _needCollisionChecking(false)
 , _collisionCheckingFlag(false)
 , _needGhostPairCallbackChecking(false)
+, _asyncSimulation(false)
+, _interpolation(false)
+, _simulation(nullptr)
+, _afterDrawListener(nullptr)
 {
     
 }
 Physics3DWorld::~Physics3DWorld()
 {
+    setAsyncSimulationEnabled(false);
     removeAllPhysics3DConstraints();
     removeAllPhysics3DObjects();
 
@@ -54,8 +230,9 @@ Physics3DWorld::~Physics3DWorld()
     CC_SAFE_DELETE(_dispatcher);
     CC_SAFE_DELETE(_broadphase);
     CC_SAFE_DELETE(_ghostCallback);
-    CC_SAFE_DELETE(_solver);
     CC_SAFE_DELETE(_btPhyiscsWorld);
+    CC_SAFE_DELETE(_solver);
+    CC_SAFE_DELETE(_solverPool);
     CC_SAFE_DELETE(_debugDrawer);
     for (auto it : _physicsComponents)
         it->setPhysics3DObject(nullptr);
@@ -72,6 +249,7 @@ Physics3DWorld* Physics3DWorld::create(Physics3DWorldDes* info)
 
 void Physics3DWorld::setGravity(const Vec3& gravity)
 {
+    waitForSimulation();
     _btPhyiscsWorld->setGravity(convertVec3TobtVector3(gravity));
 }
 
@@ -86,31 +264,100 @@ bool Physics3DWorld::init(Physics3DWorldDes* info)
     _collisionConfiguration = new (std::nothrow) btDefaultCollisionConfiguration();
     //_collisionConfiguration->setConvexConvexMultipointIterations();
     
-    ///use the default collision dispatcher. For parallel processing you can use a different dispatcher (see Extras/BulletMultiThreaded)
-    _dispatcher = new (std::nothrow) btCollisionDispatcher(_collisionConfiguration);
-    
     _broadphase = new (std::nothrow) btDbvtBroadphase();
-    
-    ///the default constraint solver. For parallel processing you can use a different solver (see Extras/BulletMultiThreaded)
-    btSequentialImpulseConstraintSolver* sol = new btSequentialImpulseConstraintSolver();
-    _solver = sol;
 
     btGhostPairCallback *ghostCallback = new btGhostPairCallback();
     _ghostCallback = ghostCallback;
     
-    _btPhyiscsWorld = new btDiscreteDynamicsWorld(_dispatcher,_broadphase,_solver,_collisionConfiguration);
+#if CC_ENABLE_BULLET_MULTITHREADING
+    if (info->isMultithreaded)
+    {
+        installTaskScheduler();
+        
+        ///the narrow phase and the islands are processed by the tasks, each island by a solver of the pool
+        _dispatcher = new (std::nothrow) btCollisionDispatcherMt(_collisionConfiguration);
+        _solverPool = new (std::nothrow) btConstraintSolverPoolMt(BT_MAX_THREAD_COUNT);
+        _solver = new (std::nothrow) btSequentialImpulseConstraintSolverMt();
+        _btPhyiscsWorld = new btDiscreteDynamicsWorldMt(_dispatcher, _broadphase, static_cast<btConstraintSolverPoolMt*>(_solverPool), _solver, _collisionConfiguration);
+    }
+    else
+#endif
+    {
+        ///use the default collision dispatcher. For parallel processing you can use a different dispatcher (see Extras/BulletMultiThreaded)
+        _dispatcher = new (std::nothrow) btCollisionDispatcher(_collisionConfiguration);
+        
+        ///the default constraint solver. For parallel processing you can use a different solver (see Extras/BulletMultiThreaded)
+        btSequentialImpulseConstraintSolver* sol = new btSequentialImpulseConstraintSolver();
+        _solver = sol;
+        
+        _btPhyiscsWorld = new btDiscreteDynamicsWorld(_dispatcher,_broadphase,_solver,_collisionConfiguration);
+    }
+#if !CC_ENABLE_BULLET_MULTITHREADING
+    if (info->isMultithreaded)
+    {
+        CCLOG("Physics3DWorld: multithreading needs CC_ENABLE_BULLET_MULTITHREADING, stepping sequentially");
+    }
+#endif
     _btPhyiscsWorld->setGravity(convertVec3TobtVector3(info->gravity));
     if (info->isDebugDrawEnabled)
     {
         _debugDrawer = new (std::nothrow) Physics3DDebugDrawer();
         _btPhyiscsWorld->setDebugDrawer(_debugDrawer);
     }
+    setAsyncSimulationEnabled(info->isAsyncSimulationEnabled);
+    _interpolation = info->isInterpolationEnabled;
     
     return true;
 }
 
+void Physics3DWorld::setAsyncSimulationEnabled(bool enabled)
+{
+    if (enabled == _asyncSimulation)
+    {
+        return;
+    }
+    
+    waitForSimulation();
+    _asyncSimulation = enabled;
+    auto eventDispatcher = Director::getInstance()->getEventDispatcher();
+    if (enabled)
+    {
+        // the step overlaps the visit and the draw of the frame, it must be over before the next frame's updates run
+        _afterDrawListener = eventDispatcher->addCustomEventListener(Director::EVENT_AFTER_DRAW, [this](EventCustom* /*event*/) {
+            waitForSimulation();
+        });
+    }
+    else if (_afterDrawListener)
+    {
+        eventDispatcher->removeEventListener(_afterDrawListener);
+        _afterDrawListener = nullptr;
+    }
+}
+
+void Physics3DWorld::waitForSimulation()
+{
+    if (_simulation)
+    {
+        JobSystem::getInstance()->wait(_simulation);
+        _simulation = nullptr;
+        finishSimulation();
+    }
+}
+
+void Physics3DWorld::finishSimulation()
+{
+    //sync dynamic node after simulation
+    for (auto it : _physicsComponents)
+    {
+        it->postSimulate(_interpolation);
+    }
+    if (needCollisionChecking())
+        collisionChecking();
+}
+
 void Physics3DWorld::setDebugDrawEnable(bool enableDebugDraw)
 {
+    waitForSimulation();
     if (enableDebugDraw && _btPhyiscsWorld->getDebugDrawer() == nullptr)
     {
         _debugDrawer = new (std::nothrow) Physics3DDebugDrawer();
@@ -125,6 +372,7 @@ bool Physics3DWorld::isDebugDrawEnabled() const
 
 void Physics3DWorld::addPhysics3DObject(Physics3DObject* physicsObj)
 {
+    waitForSimulation();
     auto it = std::find(_objects.begin(), _objects.end(), physicsObj);
     if (it == _objects.end())
     {
@@ -145,6 +393,7 @@ void Physics3DWorld::addPhysics3DObject(Physics3DObject* physicsObj)
 
 void Physics3DWorld::removePhysics3DObject(Physics3DObject* physicsObj)
 {
+    waitForSimulation();
     auto it = std::find(_objects.begin(), _objects.end(), physicsObj);
     if (it != _objects.end())
     {
@@ -165,6 +414,7 @@ void Physics3DWorld::removePhysics3DObject(Physics3DObject* physicsObj)
 
 void Physics3DWorld::removeAllPhysics3DObjects()
 {
+    waitForSimulation();
     for (auto it : _objects) {
         if (it->getObjType() == Physics3DObject::PhysicsObjType::RIGID_BODY)
         {
@@ -183,6 +433,7 @@ void Physics3DWorld::removeAllPhysics3DObjects()
 
 void Physics3DWorld::addPhysics3DConstraint(Physics3DConstraint* constraint, bool disableCollisionsBetweenLinkedObjs)
 {
+    waitForSimulation();
     auto body = constraint->getBodyA();
     if (body)
         body->addConstraint(constraint);
@@ -197,6 +448,7 @@ void Physics3DWorld::addPhysics3DConstraint(Physics3DConstraint* constraint, boo
 
 void Physics3DWorld::removePhysics3DConstraint(Physics3DConstraint* constraint)
 {
+    waitForSimulation();
     _btPhyiscsWorld->removeConstraint(constraint->getbtContraint());
     
     auto bodyA = constraint->getBodyA();
@@ -209,6 +461,7 @@ void Physics3DWorld::removePhysics3DConstraint(Physics3DConstraint* constraint)
 
 void Physics3DWorld::removeAllPhysics3DConstraints()
 {
+    waitForSimulation();
     for(auto it : _objects)
     {
         auto type = it->getObjType();
@@ -229,20 +482,23 @@ void Physics3DWorld::stepSimulate(float dt)
 {
     if (_btPhyiscsWorld)
     {
+        waitForSimulation();
         setGhostPairCallback();
         //should sync kinematic node before simulation
         for (auto it : _physicsComponents)
         {
             it->preSimulate();
         }
-        _btPhyiscsWorld->stepSimulation(dt, 3);
-        //sync dynamic node after simulation
-        for (auto it : _physicsComponents)
+        if (_asyncSimulation)
         {
-            it->postSimulate();
+            auto world = _btPhyiscsWorld;
+            _simulation = JobSystem::getInstance()->schedule([world, dt]() {
+                world->stepSimulation(dt, 3);
+            });
+            return;
         }
-        if (needCollisionChecking())
-            collisionChecking();
+        _btPhyiscsWorld->stepSimulation(dt, 3);
+        finishSimulation();
     }
 }
 
@@ -250,6 +506,7 @@ void Physics3DWorld::debugDraw(Renderer* renderer)
 {
     if (_debugDrawer)
     {
+        waitForSimulation();
         _debugDrawer->clear();
         _btPhyiscsWorld->debugDrawWorld();
         _debugDrawer->draw(renderer);
@@ -258,6 +515,7 @@ void Physics3DWorld::debugDraw(Renderer* renderer)
 
 bool Physics3DWorld::rayCast(const cocos2d::Vec3& startPos, const cocos2d::Vec3& endPos, Physics3DWorld::HitResult* result)
 {
+    waitForSimulation();
     auto btStart = convertVec3TobtVector3(startPos);
     auto btEnd = convertVec3TobtVector3(endPos);
     btCollisionWorld::ClosestRayResultCallback btResult(btStart, btEnd);
@@ -267,6 +525,7 @@ bool Physics3DWorld::rayCast(const cocos2d::Vec3& startPos, const cocos2d::Vec3&
         result->hitObj = getPhysicsObject(btResult.m_collisionObject);
         result->hitPosition = convertbtVector3ToVec3(btResult.m_hitPointWorld);
         result->hitNormal = convertbtVector3ToVec3(btResult.m_hitNormalWorld);
+        result->hitFraction = btResult.m_closestHitFraction;
         return true;
     }
     result->hitObj = nullptr;
@@ -276,6 +535,7 @@ bool Physics3DWorld::rayCast(const cocos2d::Vec3& startPos, const cocos2d::Vec3&
 bool Physics3DWorld::sweepShape(Physics3DShape* shape, const cocos2d::Mat4& startTransform, const cocos2d::Mat4& endTransform, Physics3DWorld::HitResult* result)
 {
     CC_ASSERT(shape->getShapeType() != Physics3DShape::ShapeType::HEIGHT_FIELD && shape->getShapeType() != Physics3DShape::ShapeType::MESH);
+    waitForSimulation();
     auto btStart = convertMat4TobtTransform(startTransform);
     auto btEnd = convertMat4TobtTransform(endTransform);
     btCollisionWorld::ClosestConvexResultCallback btResult(btStart.getOrigin(), btEnd.getOrigin());
@@ -285,14 +545,115 @@ bool Physics3DWorld::sweepShape(Physics3DShape* shape, const cocos2d::Mat4& star
         result->hitObj = getPhysicsObject(btResult.m_hitCollisionObject);
         result->hitPosition = convertbtVector3ToVec3(btResult.m_hitPointWorld);
         result->hitNormal = convertbtVector3ToVec3(btResult.m_hitNormalWorld);
+        result->hitFraction = btResult.m_closestHitFraction;
         return true;
     }
     result->hitObj = nullptr;
     return false;
 }
 
+void Physics3DWorld::rayCastBatch(const RayQuery* queries, int count, QueryMode mode, std::vector<HitResult>& hits, QueryRange* ranges, bool parallel)
+{
+    waitForSimulation();
+    auto broadphase = _broadphase;
+    runQueryBatch(count, hits, ranges, parallel, [queries, mode, broadphase](int i, std::vector<HitResult>& found) {
+        const auto& query = queries[i];
+        auto from = convertVec3TobtVector3(query.startPos);
+        auto to = convertVec3TobtVector3(query.endPos);
+        
+        btAlignedObjectArray<btCollisionObject*> candidates;
+        BroadphaseCollector collector(candidates, query.collisionGroup, query.collisionMask);
+        btDbvt::rayTest(broadphase->m_sets[0].m_root, from, to, collector);
+        btDbvt::rayTest(broadphase->m_sets[1].m_root, from, to, collector);
+        
+        btTransform fromTransform, toTransform;
+        fromTransform.setIdentity();
+        fromTransform.setOrigin(from);
+        toTransform.setIdentity();
+        toTransform.setOrigin(to);
+        if (mode == QueryMode::CLOSEST_HIT)
+        {
+            btCollisionWorld::ClosestRayResultCallback result(from, to);
+            for (int j = 0; j < candidates.size(); ++j)
+            {
+                btCollisionWorld::rayTestSingle(fromTransform, toTransform, candidates[j], candidates[j]->getCollisionShape(), candidates[j]->getWorldTransform(), result);
+            }
+            if (result.hasHit())
+            {
+                found.push_back(makeHitResult(result.m_collisionObject, result.m_hitPointWorld, result.m_hitNormalWorld, result.m_closestHitFraction));
+            }
+        }
+        else
+        {
+            btCollisionWorld::AllHitsRayResultCallback result(from, to);
+            for (int j = 0; j < candidates.size(); ++j)
+            {
+                btCollisionWorld::rayTestSingle(fromTransform, toTransform, candidates[j], candidates[j]->getCollisionShape(), candidates[j]->getWorldTransform(), result);
+            }
+            auto first = found.size();
+            for (int j = 0; j < result.m_collisionObjects.size(); ++j)
+            {
+                found.push_back(makeHitResult(result.m_collisionObjects[j], result.m_hitPointWorld[j], result.m_hitNormalWorld[j], result.m_hitFractions[j]));
+            }
+            std::sort(found.begin() + first, found.end(), hitResultLess);
+        }
+    });
+}
+
+void Physics3DWorld::sweepShapeBatch(const SweepQuery* queries, int count, QueryMode mode, std::vector<HitResult>& hits, QueryRange* ranges, bool parallel)
+{
+    waitForSimulation();
+    auto broadphase = _broadphase;
+    runQueryBatch(count, hits, ranges, parallel, [queries, mode, broadphase](int i, std::vector<HitResult>& found) {
+        const auto& query = queries[i];
+        CC_ASSERT(query.shape && query.shape->getShapeType() != Physics3DShape::ShapeType::HEIGHT_FIELD && query.shape->getShapeType() != Physics3DShape::ShapeType::MESH);
+        auto castShape = static_cast<btConvexShape*>(query.shape->getbtShape());
+        auto from = convertMat4TobtTransform(query.startTransform);
+        auto to = convertMat4TobtTransform(query.endTransform);
+        
+        // the candidates are the objects overlapping the box swept by the shape
+        btVector3 fromMin, fromMax, toMin, toMax;
+        castShape->getAabb(from, fromMin, fromMax);
+        castShape->getAabb(to, toMin, toMax);
+        fromMin.setMin(toMin);
+        fromMax.setMax(toMax);
+        auto volume = btDbvtVolume::FromMM(fromMin, fromMax);
+        btAlignedObjectArray<btCollisionObject*> candidates;
+        BroadphaseCollector collector(candidates, query.collisionGroup, query.collisionMask);
+        broadphase->m_sets[0].collideTV(broadphase->m_sets[0].m_root, volume, collector);
+        broadphase->m_sets[1].collideTV(broadphase->m_sets[1].m_root, volume, collector);
+        
+        if (mode == QueryMode::CLOSEST_HIT)
+        {
+            btCollisionWorld::ClosestConvexResultCallback result(from.getOrigin(), to.getOrigin());
+            for (int j = 0; j < candidates.size(); ++j)
+            {
+                btCollisionWorld::objectQuerySingle(castShape, from, to, candidates[j], candidates[j]->getCollisionShape(), candidates[j]->getWorldTransform(), result, 0.f);
+            }
+            if (result.hasHit())
+            {
+                found.push_back(makeHitResult(result.m_hitCollisionObject, result.m_hitPointWorld, result.m_hitNormalWorld, result.m_closestHitFraction));
+            }
+        }
+        else
+        {
+            auto first = found.size();
+            AllHitsConvexResultCallback result(found);
+            for (int j = 0; j < candidates.size(); ++j)
+            {
+                btCollisionWorld::objectQuerySingle(castShape, from, to, candidates[j], candidates[j]->getCollisionShape(), candidates[j]->getWorldTransform(), result, 0.f);
+            }
+            std::sort(found.begin() + first, found.end(), hitResultLess);
+        }
+    });
+}
+
 Physics3DObject* Physics3DWorld::getPhysicsObject(const btCollisionObject* btObj)
 {
+    // the rigid bodies and the colliders point back to their object
+    if (btObj->getUserPointer())
+        return static_cast<Physics3DObject*>(btObj->getUserPointer());
+    
     for(auto it : _objects)
     {
         if (it->getObjType() == Physics3DObject::PhysicsObjType::RIGID_BODY)
@@ -28,6 +28,7 @@
 #include "math/CCMath.h"
 #include "base/CCRef.h"
 #include "base/ccConfig.h"
+#include "base/CCAsyncTaskPool.h"
 
 #if CC_USE_3D_PHYSICS
 
@@ -41,6 +42,7 @@ class btSequentialImpulseConstraintSolver;
 class btGhostPairCallback;
 class btRigidBody;
 class btCollisionObject;
+class btConstraintSolver;
 
 NS_CC_BEGIN
 /**
@@ -54,6 +56,7 @@ class Physics3DDebugDrawer;
 class Physics3DComponent;
 class Physics3DShape;
 class Renderer;
+class EventListenerCustom;
 
 /**
  * @brief The description of Physics3DWorld.
@@ -62,10 +65,16 @@ struct CC_DLL Physics3DWorldDes
 {
     bool           isDebugDrawEnabled; //using physics debug draw?, false by default
     cocos2d::Vec3  gravity;//gravity, (0, -9.8, 0)
+    bool           isMultithreaded; //using btDiscreteDynamicsWorldMt on the JobSystem?, CC_ENABLE_BULLET_MULTITHREADING by default
+    bool           isAsyncSimulationEnabled; //stepping while the frame is drawn?, false by default
+    bool           isInterpolationEnabled; //syncing the nodes to the interpolated transforms?, false by default
     Physics3DWorldDes()
     {
         isDebugDrawEnabled = false;
         gravity = cocos2d::Vec3(0.f, -9.8f, 0.f);
+        isMultithreaded = CC_ENABLE_BULLET_MULTITHREADING != 0;
+        isAsyncSimulationEnabled = false;
+        isInterpolationEnabled = false;
     }
 };
 
@@ -82,6 +91,50 @@ public:
         cocos2d::Vec3 hitPosition;
         cocos2d::Vec3 hitNormal;
         Physics3DObject* hitObj;
+        float hitFraction; //where the hit is along the query, from 0 at the start to 1 at the end
+    };
+    
+    /** Which hits a batch query reports. @since v3.14 */
+    enum class QueryMode
+    {
+        CLOSEST_HIT, //the hit nearest to the start, if any
+        ALL_HITS,    //all the hits, from the nearest to the farthest
+    };
+    
+    /**
+     * A ray of rayCastBatch().
+     * Like Bullet's broadphase filtering, an object is hit if its group shares a bit with collisionMask
+     * and its mask shares a bit with collisionGroup.
+     * @since v3.14
+     */
+    struct RayQuery
+    {
+        cocos2d::Vec3 startPos;
+        cocos2d::Vec3 endPos;
+        short collisionGroup; //btBroadphaseProxy::DefaultFilter by default
+        short collisionMask;  //btBroadphaseProxy::AllFilter by default
+        RayQuery() : collisionGroup(1), collisionMask(-1) {}
+    };
+    
+    /**
+     * A sweep of sweepShapeBatch(), the shape must be convex.
+     * @since v3.14
+     */
+    struct SweepQuery
+    {
+        Physics3DShape* shape;
+        cocos2d::Mat4 startTransform;
+        cocos2d::Mat4 endTransform;
+        short collisionGroup; //btBroadphaseProxy::DefaultFilter by default
+        short collisionMask;  //btBroadphaseProxy::AllFilter by default
+        SweepQuery() : shape(nullptr), collisionGroup(1), collisionMask(-1) {}
+    };
+    
+    /** The hits of a batch query, hits[first] to hits[first + count - 1]. @since v3.14 */
+    struct QueryRange
+    {
+        int first;
+        int count;
     };
     
     /**
@@ -118,6 +171,32 @@ public:
     /** Simulate one frame. */
     void stepSimulate(float dt);
     
+    /**
+     * Step the world on a JobSystem worker while the frame is drawn, instead of blocking the cocos thread.
+     *
+     * The step started by stepSimulate() is waited for once the frame is drawn, then the nodes are synchronized,
+     * so they show the state of the previous step while the current one runs.
+     * Touching the Bullet objects from another thread while the step runs isn't safe.
+     * @since v3.14
+     */
+    void setAsyncSimulationEnabled(bool enabled);
+    
+    /** Is the world stepped asynchronously. @since v3.14 */
+    bool isAsyncSimulationEnabled() const { return _asyncSimulation; }
+    
+    /**
+     * Synchronize the nodes to the transforms Bullet interpolates between its fixed substeps,
+     * instead of the transforms of the last substep, for a smoother display.
+     * @since v3.14
+     */
+    void setInterpolationEnabled(bool enabled) { _interpolation = enabled; }
+    
+    /** Are the nodes synchronized to the interpolated transforms. @since v3.14 */
+    bool isInterpolationEnabled() const { return _interpolation; }
+    
+    /** Wait for the asynchronous step, if any, and synchronize the nodes with it. @since v3.14 */
+    void waitForSimulation();
+    
     /** Enable or disable debug drawing. */
     void setDebugDrawEnable(bool enableDebugDraw);
     
@@ -141,6 +220,33 @@ public:
     /** Performs a swept shape cast on all objects in the Physics3DWorld. */
     bool sweepShape(Physics3DShape* shape, const cocos2d::Mat4& startTransform, const cocos2d::Mat4& endTransform, HitResult* result);
     
+    /**
+     * Casts a batch of rays.
+     *
+     * The rays walk the broadphase trees by themselves, so they can run in parallel.
+     * @param queries The rays.
+     * @param count The number of rays.
+     * @param mode Whether only the closest hit or all the hits of each ray are reported.
+     * @param hits The hits are appended to it.
+     * @param ranges The hits of each ray, one range per ray.
+     * @param parallel Cast the rays on the JobSystem workers, the calling thread waits for them.
+     * @since v3.14
+     */
+    void rayCastBatch(const RayQuery* queries, int count, QueryMode mode, std::vector<HitResult>& hits, QueryRange* ranges, bool parallel = false);
+    
+    /**
+     * Sweeps a batch of convex shapes.
+     *
+     * @param queries The sweeps.
+     * @param count The number of sweeps.
+     * @param mode Whether only the closest hit or all the hits of each sweep are reported.
+     * @param hits The hits are appended to it.
+     * @param ranges The hits of each sweep, one range per sweep.
+     * @param parallel Sweep the shapes on the JobSystem workers, the calling thread waits for them.
+     * @since v3.14
+     */
+    void sweepShapeBatch(const SweepQuery* queries, int count, QueryMode mode, std::vector<HitResult>& hits, QueryRange* ranges, bool parallel = false);
+    
 CC_CONSTRUCTOR_ACCESS:
     
     Physics3DWorld();
@@ -153,6 +259,7 @@ CC_CONSTRUCTOR_ACCESS:
     void collisionChecking();
     bool needCollisionChecking();
     void setGhostPairCallback();
+    void finishSimulation();
     
 protected:
     std::vector<Physics3DObject*>      _objects;
@@ -160,6 +267,10 @@ protected:
     bool _needCollisionChecking;
     bool _collisionCheckingFlag;
     bool _needGhostPairCallbackChecking;
+    bool _asyncSimulation;
+    bool _interpolation;
+    JobSystem::JobHandle _simulation;
+    EventListenerCustom* _afterDrawListener;
     
 #if (CC_ENABLE_BULLET_INTEGRATION)
     btDynamicsWorld* _btPhyiscsWorld;
@@ -167,6 +278,7 @@ protected:
     btCollisionDispatcher* _dispatcher;
     btDbvtBroadphase* _broadphase;
     btSequentialImpulseConstraintSolver* _solver;
+    btConstraintSolver* _solverPool;
     btGhostPairCallback *_ghostCallback;
     Physics3DDebugDrawer*                _debugDrawer;
 #endif // CC_ENABLE_BULLET_INTEGRATION
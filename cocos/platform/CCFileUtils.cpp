@@ -26,6 +26,10 @@ THE SOFTWARE.
 #include "platform/CCFileUtils.h"
 
 #include <stack>
+#include <algorithm>
+#include <memory>
+#include <atomic>
+#include <thread>
 
 #include "base/CCData.h"
 #include "base/ccMacros.h"
@@ -39,6 +43,7 @@ THE SOFTWARE.
 #else // from our embedded sources
 #include "unzip.h"
 #endif
+#include "xxhash.h"
 #include <sys/stat.h>
 
 NS_CC_BEGIN
@@ -102,7 +107,7 @@ public:
         parser.setDelegator(this);
 
         parser.parse(fileName);
-        return _rootDict;
+        return std::move(_rootDict);
     }
 
     ValueMap dictionaryWithDataOfFile(const char* filedata, int filesize)
@@ -114,7 +119,7 @@ public:
         parser.setDelegator(this);
 
         parser.parse(filedata, filesize);
-        return _rootDict;
+        return std::move(_rootDict);
     }
 
     ValueVector arrayWithContentsOfFile(const std::string& fileName)
@@ -126,13 +131,12 @@ public:
         parser.setDelegator(this);
 
         parser.parse(fileName);
-        return _rootArray;
+        return std::move(_rootArray);
     }
 
     void startElement(void *ctx, const char *name, const char **atts) override
     {
-        const std::string sName(name);
-        if( sName == "dict" )
+        if( strcmp(name, "dict") == 0 )
         {
             if(_resultType == SAX_RESULT_DICT && _rootDict.empty())
             {
@@ -158,31 +162,32 @@ public:
                 // add a new dictionary into the pre dictionary
                 CCASSERT(! _dictStack.empty(), "The state is wrong!");
                 ValueMap* preDict = _dictStack.top();
-                (*preDict)[_curKey] = Value(ValueMap());
-                _curDict = &(*preDict)[_curKey].asValueMap();
+                auto& dict = (*preDict)[_curKey];
+                dict = Value(ValueMap());
+                _curDict = &dict.asValueMap();
             }
 
             // record the dict state
             _stateStack.push(_state);
             _dictStack.push(_curDict);
         }
-        else if(sName == "key")
+        else if(strcmp(name, "key") == 0)
         {
             _state = SAX_KEY;
         }
-        else if(sName == "integer")
+        else if(strcmp(name, "integer") == 0)
         {
             _state = SAX_INT;
         }
-        else if(sName == "real")
+        else if(strcmp(name, "real") == 0)
         {
             _state = SAX_REAL;
         }
-        else if(sName == "string")
+        else if(strcmp(name, "string") == 0)
         {
             _state = SAX_STRING;
         }
-        else if (sName == "array")
+        else if (strcmp(name, "array") == 0)
         {
             _state = SAX_ARRAY;
 
@@ -198,8 +203,9 @@ public:
 
             if (preState == SAX_DICT)
             {
-                (*_curDict)[_curKey] = Value(ValueVector());
-                _curArray = &(*_curDict)[_curKey].asValueVector();
+                auto& array = (*_curDict)[_curKey];
+                array = Value(ValueVector());
+                _curArray = &array.asValueVector();
             }
             else if (preState == SAX_ARRAY)
             {
@@ -221,8 +227,7 @@ public:
     void endElement(void *ctx, const char *name) override
     {
         SAXState curState = _stateStack.empty() ? SAX_DICT : _stateStack.top();
-        const std::string sName((char*)name);
-        if( sName == "dict" )
+        if( strcmp(name, "dict") == 0 )
         {
             _stateStack.pop();
             _dictStack.pop();
@@ -231,7 +236,7 @@ public:
                 _curDict = _dictStack.top();
             }
         }
-        else if (sName == "array")
+        else if (strcmp(name, "array") == 0)
         {
             _stateStack.pop();
             _arrayStack.pop();
@@ -240,7 +245,7 @@ public:
                 _curArray = _arrayStack.top();
             }
         }
-        else if (sName == "true")
+        else if (strcmp(name, "true") == 0)
         {
             if (SAX_ARRAY == curState)
             {
@@ -251,7 +256,7 @@ public:
                 (*_curDict)[_curKey] = Value(true);
             }
         }
-        else if (sName == "false")
+        else if (strcmp(name, "false") == 0)
         {
             if (SAX_ARRAY == curState)
             {
@@ -262,22 +267,22 @@ public:
                 (*_curDict)[_curKey] = Value(false);
             }
         }
-        else if (sName == "string" || sName == "integer" || sName == "real")
+        else if (strcmp(name, "string") == 0 || strcmp(name, "integer") == 0 || strcmp(name, "real") == 0)
         {
             if (SAX_ARRAY == curState)
             {
-                if (sName == "string")
-                    _curArray->push_back(Value(_curValue));
-                else if (sName == "integer")
+                if (strcmp(name, "string") == 0)
+                    _curArray->push_back(Value(std::move(_curValue)));
+                else if (strcmp(name, "integer") == 0)
                     _curArray->push_back(Value(atoi(_curValue.c_str())));
                 else
                     _curArray->push_back(Value(std::atof(_curValue.c_str())));
             }
             else if (SAX_DICT == curState)
             {
-                if (sName == "string")
-                    (*_curDict)[_curKey] = Value(_curValue);
-                else if (sName == "integer")
+                if (strcmp(name, "string") == 0)
+                    (*_curDict)[_curKey] = Value(std::move(_curValue));
+                else if (strcmp(name, "integer") == 0)
                     (*_curDict)[_curKey] = Value(atoi(_curValue.c_str()));
                 else
                     (*_curDict)[_curKey] = Value(std::atof(_curValue.c_str()));
@@ -297,12 +302,11 @@ public:
         }
 
         SAXState curState = _stateStack.empty() ? SAX_DICT : _stateStack.top();
-        const std::string text = std::string((char*)ch,len);
 
         switch(_state)
         {
         case SAX_KEY:
-            _curKey = text;
+            _curKey.assign(ch, len);
             break;
         case SAX_INT:
         case SAX_REAL:
@@ -313,7 +317,7 @@ public:
                     CCASSERT(!_curKey.empty(), "key not found : <integer/real>");
                 }
 
-                _curValue.append(text);
+                _curValue.append(ch, len);
             }
             break;
         default:
@@ -392,6 +396,10 @@ bool FileUtils::writeValueMapToFile(const ValueMap& dict, const std::string& ful
     rootEle->LinkEndChild(innerDict);
 
     bool ret = tinyxml2::XML_SUCCESS == doc->SaveFile(getSuitableFOpen(fullPath).c_str());
+    if (ret)
+    {
+        purgeNonexistentFileCache();
+    }
 
     delete doc;
     return ret;
@@ -432,6 +440,10 @@ bool FileUtils::writeValueVectorToFile(const ValueVector& vecData, const std::st
     rootEle->LinkEndChild(innerDict);
 
     bool ret = tinyxml2::XML_SUCCESS == doc->SaveFile(getSuitableFOpen(fullPath).c_str());
+    if (ret)
+    {
+        purgeNonexistentFileCache();
+    }
 
     delete doc;
     return ret;
@@ -533,6 +545,333 @@ bool FileUtils::writeToFile(const ValueMap& /*dict*/, const std::string &/*fullP
 
 #endif /* (CC_TARGET_PLATFORM != CC_PLATFORM_IOS) && (CC_TARGET_PLATFORM != CC_PLATFORM_MAC) */
 
+// Implement AssetPack
+namespace
+{
+    const uint32_t ASSET_PACK_VERSION = 1;
+    const uint32_t ASSET_PACK_ALIGNMENT = 16;
+
+    struct AssetPackHeader
+    {
+        char magic[4];
+        uint32_t version;
+        uint32_t fileCount;
+        uint32_t reserved;
+    };
+
+    struct AssetPackEntry
+    {
+        uint32_t hash;
+        uint32_t pathOffset;
+        uint32_t pathLength;
+        uint32_t dataOffset;
+        uint32_t dataSize;
+    };
+
+    inline uint32_t hashAssetPath(const std::string& relativePath)
+    {
+        return XXH32(relativePath.data(), relativePath.size(), 0);
+    }
+
+    // a file of a pack, which keeps the pack mounted while it is used
+    class AssetPackMappedFileData : public MappedFileData
+    {
+    public:
+        // created holding the lock of the FileUtils, which is taken again to release the pack
+        AssetPackMappedFileData(AssetPack* pack, const unsigned char* bytes, ssize_t size, std::mutex* mutex)
+        : _pack(pack)
+        , _mutex(mutex)
+        {
+            _pack->retain();
+            _bytes = bytes;
+            _size = size;
+        }
+
+        virtual ~AssetPackMappedFileData()
+        {
+            std::lock_guard<std::mutex> lock(*_mutex);
+            _pack->release();
+        }
+
+    private:
+        AssetPack* _pack;
+        std::mutex* _mutex;
+    };
+}
+
+namespace
+{
+    // moves a position relatively to an origin, within [0, size]
+    bool seekPosition(ssize_t* position, ssize_t size, ssize_t offset, FileStream::Origin origin)
+    {
+        ssize_t base = origin == FileStream::Origin::BEGIN ? 0 : (origin == FileStream::Origin::CURRENT ? *position : size);
+        ssize_t target = base + offset;
+        if (target < 0 || target > size)
+            return false;
+        *position = target;
+        return true;
+    }
+
+    class StdioFileStream : public FileStream
+    {
+    public:
+        StdioFileStream(FILE* fp, ssize_t size)
+        : _fp(fp)
+        , _size(size)
+        , _position(0)
+        {
+        }
+
+        virtual ~StdioFileStream()
+        {
+            fclose(_fp);
+        }
+
+        virtual ssize_t read(void* buffer, size_t size) override
+        {
+            size_t readsize = fread(buffer, 1, size, _fp);
+            if (readsize < size && ferror(_fp))
+                return -1;
+            _position += readsize;
+            return static_cast<ssize_t>(readsize);
+        }
+
+        virtual bool seek(ssize_t offset, Origin origin) override
+        {
+            ssize_t position = _position;
+            if (!seekPosition(&position, _size, offset, origin) || fseek(_fp, static_cast<long>(position), SEEK_SET) != 0)
+                return false;
+            _position = position;
+            return true;
+        }
+
+        virtual ssize_t tell() const override { return _position; }
+        virtual ssize_t getSize() const override { return _size; }
+
+    private:
+        FILE* _fp;
+        ssize_t _size;
+        ssize_t _position;
+    };
+
+    class MappedFileStream : public FileStream
+    {
+    public:
+        explicit MappedFileStream(MappedFileData* data)
+        : _data(data)
+        , _position(0)
+        {
+        }
+
+        virtual ~MappedFileStream()
+        {
+            delete _data;
+        }
+
+        virtual ssize_t read(void* buffer, size_t size) override
+        {
+            ssize_t readsize = std::min(static_cast<ssize_t>(size), _data->getSize() - _position);
+            if (readsize > 0)
+            {
+                memcpy(buffer, _data->getBytes() + _position, readsize);
+                _position += readsize;
+            }
+            return std::max(readsize, (ssize_t)0);
+        }
+
+        virtual bool seek(ssize_t offset, Origin origin) override
+        {
+            return seekPosition(&_position, _data->getSize(), offset, origin);
+        }
+
+        virtual ssize_t tell() const override { return _position; }
+        virtual ssize_t getSize() const override { return _data->getSize(); }
+
+    private:
+        MappedFileData* _data;
+        ssize_t _position;
+    };
+}
+
+FileStream* FileStream::createWithMappedFileData(MappedFileData* data)
+{
+    if (data == nullptr)
+        return nullptr;
+
+    auto stream = new (std::nothrow) MappedFileStream(data);
+    if (stream == nullptr)
+    {
+        delete data;
+    }
+    return stream;
+}
+
+const std::string AssetPack::EXTENSION = ".ccpk";
+
+AssetPack* AssetPack::create(const std::string& fullPath)
+{
+    AssetPack* ret = new (std::nothrow) AssetPack();
+    if (ret && ret->initWithFile(fullPath))
+    {
+        ret->autorelease();
+        return ret;
+    }
+    CC_SAFE_DELETE(ret);
+    return nullptr;
+}
+
+AssetPack::AssetPack()
+: _mappedData(nullptr)
+, _bytes(nullptr)
+, _size(0)
+, _fileCount(0)
+{
+}
+
+AssetPack::~AssetPack()
+{
+    CC_SAFE_DELETE(_mappedData);
+}
+
+bool AssetPack::initWithFile(const std::string& fullPath)
+{
+    auto fileUtils = FileUtils::getInstance();
+    _mappedData = fileUtils->mapFileContents(fullPath);
+    if (_mappedData)
+    {
+        _bytes = _mappedData->getBytes();
+        _size = _mappedData->getSize();
+    }
+    else
+    {
+        _data = fileUtils->getDataFromFile(fullPath);
+        _bytes = _data.getBytes();
+        _size = _data.getSize();
+    }
+
+    if (_size < static_cast<ssize_t>(sizeof(AssetPackHeader)))
+    {
+        CCLOG("cocos2d: AssetPack: can't read %s", fullPath.c_str());
+        return false;
+    }
+
+    auto header = reinterpret_cast<const AssetPackHeader*>(_bytes);
+    if (memcmp(header->magic, "CCPK", 4) != 0 || header->version != ASSET_PACK_VERSION ||
+        sizeof(AssetPackHeader) + static_cast<size_t>(header->fileCount) * sizeof(AssetPackEntry) > static_cast<size_t>(_size))
+    {
+        CCLOG("cocos2d: AssetPack: %s isn't a valid asset pack", fullPath.c_str());
+        return false;
+    }
+    _fileCount = header->fileCount;
+    return true;
+}
+
+const unsigned char* AssetPack::getFileData(const std::string& relativePath, ssize_t* size) const
+{
+    auto begin = reinterpret_cast<const AssetPackEntry*>(_bytes + sizeof(AssetPackHeader));
+    auto end = begin + _fileCount;
+    uint32_t hash = hashAssetPath(relativePath);
+
+    auto entry = std::lower_bound(begin, end, hash, [](const AssetPackEntry& e, uint32_t h) { return e.hash < h; });
+    for (; entry != end && entry->hash == hash; ++entry)
+    {
+        // the offsets are checked here rather than when mounting, so that mounting doesn't touch the whole index
+        if (static_cast<uint64_t>(entry->pathOffset) + entry->pathLength > static_cast<uint64_t>(_size) ||
+            static_cast<uint64_t>(entry->dataOffset) + entry->dataSize > static_cast<uint64_t>(_size))
+        {
+            CCLOG("cocos2d: AssetPack: the entry of %s is corrupted", relativePath.c_str());
+            return nullptr;
+        }
+
+        if (entry->pathLength == relativePath.size() &&
+            memcmp(_bytes + entry->pathOffset, relativePath.data(), relativePath.size()) == 0)
+        {
+            *size = entry->dataSize;
+            return _bytes + entry->dataOffset;
+        }
+    }
+    return nullptr;
+}
+
+bool AssetPack::writePack(const std::string& packFullPath, const std::string& directory, const std::vector<std::string>& relativePaths)
+{
+    auto fileUtils = FileUtils::getInstance();
+
+    std::string dir = directory;
+    if (!dir.empty() && dir[dir.size() - 1] != '/')
+    {
+        dir += '/';
+    }
+
+    std::vector<const std::string*> paths;
+    paths.reserve(relativePaths.size());
+    for (const auto& relativePath : relativePaths)
+    {
+        paths.push_back(&relativePath);
+    }
+    std::sort(paths.begin(), paths.end(), [](const std::string* a, const std::string* b) {
+        uint32_t ha = hashAssetPath(*a);
+        uint32_t hb = hashAssetPath(*b);
+        return ha < hb || (ha == hb && *a < *b);
+    });
+
+    std::vector<Data> contents(paths.size());
+    size_t pathsSize = 0;
+    size_t dataSize = 0;
+    for (size_t i = 0; i < paths.size(); ++i)
+    {
+        if (fileUtils->getContents(dir + *paths[i], &contents[i]) != FileUtils::Status::OK)
+        {
+            CCLOG("cocos2d: AssetPack: can't read %s", (dir + *paths[i]).c_str());
+            return false;
+        }
+        pathsSize += paths[i]->size();
+        dataSize += (contents[i].getSize() + ASSET_PACK_ALIGNMENT - 1) / ASSET_PACK_ALIGNMENT * ASSET_PACK_ALIGNMENT;
+    }
+
+    size_t indexEnd = sizeof(AssetPackHeader) + paths.size() * sizeof(AssetPackEntry);
+    size_t dataBegin = (indexEnd + pathsSize + ASSET_PACK_ALIGNMENT - 1) / ASSET_PACK_ALIGNMENT * ASSET_PACK_ALIGNMENT;
+    if (dataBegin + dataSize > UINT32_MAX)
+    {
+        CCLOG("cocos2d: AssetPack: %s would be larger than 4GB", packFullPath.c_str());
+        return false;
+    }
+
+    Data pack;
+    unsigned char* bytes = static_cast<unsigned char*>(calloc(dataBegin + dataSize, 1));
+    if (bytes == nullptr)
+        return false;
+    pack.fastSet(bytes, dataBegin + dataSize);
+
+    auto header = reinterpret_cast<AssetPackHeader*>(bytes);
+    memcpy(header->magic, "CCPK", 4);
+    header->version = ASSET_PACK_VERSION;
+    header->fileCount = static_cast<uint32_t>(paths.size());
+
+    auto entry = reinterpret_cast<AssetPackEntry*>(bytes + sizeof(AssetPackHeader));
+    size_t pathOffset = indexEnd;
+    size_t dataOffset = dataBegin;
+    for (size_t i = 0; i < paths.size(); ++i, ++entry)
+    {
+        const std::string& path = *paths[i];
+        entry->hash = hashAssetPath(path);
+        entry->pathOffset = static_cast<uint32_t>(pathOffset);
+        entry->pathLength = static_cast<uint32_t>(path.size());
+        entry->dataOffset = static_cast<uint32_t>(dataOffset);
+        entry->dataSize = static_cast<uint32_t>(contents[i].getSize());
+
+        memcpy(bytes + pathOffset, path.data(), path.size());
+        pathOffset += path.size();
+        if (!contents[i].isNull())
+        {
+            memcpy(bytes + dataOffset, contents[i].getBytes(), contents[i].getSize());
+        }
+        dataOffset += (contents[i].getSize() + ASSET_PACK_ALIGNMENT - 1) / ASSET_PACK_ALIGNMENT * ASSET_PACK_ALIGNMENT;
+    }
+
+    return fileUtils->writeDataToFile(pack, packFullPath);
+}
+
 // Implement FileUtils
 FileUtils* FileUtils::s_sharedFileUtils = nullptr;
 
@@ -550,12 +889,17 @@ void FileUtils::setDelegate(FileUtils *delegate)
 }
 
 FileUtils::FileUtils()
-    : _writablePath("")
+    : _searchGeneration(0)
+    , _writablePath("")
 {
 }
 
 FileUtils::~FileUtils()
 {
+    for (auto& iter : _assetPacks)
+    {
+        iter.second->release();
+    }
 }
 
 bool FileUtils::writeStringToFile(const std::string& dataStr, const std::string& fullPath)
@@ -595,6 +939,7 @@ bool FileUtils::writeDataToFile(const Data& data, const std::string& fullPath)
 
         fclose(fp);
 
+        fileutils->purgeNonexistentFileCache();
         return true;
     } while (0);
 
@@ -616,8 +961,22 @@ bool FileUtils::init()
 }
 
 void FileUtils::purgeCachedEntries()
+{
+    std::lock_guard<std::mutex> lock(_searchMutex);
+    clearPathCaches();
+}
+
+void FileUtils::clearPathCaches()
 {
     _fullPathCache.clear();
+    _nonexistentFileCache.clear();
+    ++_searchGeneration;
+}
+
+void FileUtils::purgeNonexistentFileCache()
+{
+    std::lock_guard<std::mutex> lock(_searchMutex);
+    _nonexistentFileCache.clear();
 }
 
 std::string FileUtils::getStringFromFile(const std::string& filename)
@@ -652,6 +1011,196 @@ void FileUtils::getDataFromFile(const std::string& filename, std::function<void(
     }, std::move(callback));
 }
 
+AsyncOperation<Data> FileUtils::getDataFromFileAsync(const std::string& filename)
+{
+    auto fullPath = fullPathForFilename(filename);
+    AsyncOperation<Data> operation;
+    AsyncTaskPool::getInstance()->enqueue(AsyncTaskPool::TaskType::TASK_IO, [](void*){}, nullptr, [fullPath, operation]() {
+        operation.resolve(FileUtils::getInstance()->getDataFromFile(fullPath));
+    });
+    return operation;
+}
+
+AsyncOperation<std::string> FileUtils::getStringFromFileAsync(const std::string& filename)
+{
+    auto fullPath = fullPathForFilename(filename);
+    AsyncOperation<std::string> operation;
+    AsyncTaskPool::getInstance()->enqueue(AsyncTaskPool::TaskType::TASK_IO, [](void*){}, nullptr, [fullPath, operation]() {
+        operation.resolve(FileUtils::getInstance()->getStringFromFile(fullPath));
+    });
+    return operation;
+}
+
+DataView FileUtils::getDataViewFromFile(const std::string& filename)
+{
+    return DataView(getDataFromFile(filename));
+}
+
+void FileUtils::getDataViewFromFile(const std::string& filename, std::function<void(DataView)> callback)
+{
+    auto fullPath = fullPathForFilename(filename);
+    performOperationOffthread([fullPath]() -> DataView {
+        return FileUtils::getInstance()->getDataViewFromFile(fullPath);
+    }, std::move(callback));
+}
+
+void FileUtils::getDataFromFiles(const std::vector<std::string>& filenames, std::function<void(std::vector<Data>)> callback, unsigned int maxParallelReads)
+{
+    struct FileRead
+    {
+        std::string fullPath;
+        size_t index;
+        const void* archive;
+        size_t offset;
+    };
+
+    auto paths = std::make_shared<std::vector<std::string>>(filenames);
+    auto results = std::make_shared<std::vector<Data>>(filenames.size());
+    maxParallelReads = std::max(maxParallelReads, 1u);
+
+    // the data is shared with the callback, instead of being copied into it
+    AsyncTaskPool::getInstance()->enqueue(AsyncTaskPool::TaskType::TASK_IO, [](void*){}, nullptr, [paths, results, callback, maxParallelReads]() {
+        auto fileUtils = FileUtils::getInstance();
+
+        std::vector<FileRead> reads;
+        reads.reserve(paths->size());
+        for (size_t i = 0; i < paths->size(); ++i)
+        {
+            FileRead read;
+            read.fullPath = fileUtils->fullPathForFilename((*paths)[i]);
+            read.index = i;
+            read.archive = nullptr;
+            read.offset = 0;
+            if (!read.fullPath.empty())
+            {
+                fileUtils->getFileLocation(read.fullPath, &read.archive, &read.offset);
+                reads.push_back(read);
+            }
+        }
+
+        // the files of an archive are read in its order, the other files follow in the given order
+        std::stable_sort(reads.begin(), reads.end(), [](const FileRead& a, const FileRead& b) {
+            if (a.archive == b.archive)
+                return a.offset < b.offset;
+            if (a.archive == nullptr)
+                return false;
+            if (b.archive == nullptr)
+                return true;
+            return std::less<const void*>()(a.archive, b.archive);
+        });
+
+        // each thread takes the next file, so the archives are still read about sequentially
+        std::atomic<size_t> next(0);
+        auto readFiles = [&reads, &next, &results, fileUtils]() {
+            for (size_t i = next++; i < reads.size(); i = next++)
+            {
+                (*results)[reads[i].index] = fileUtils->getDataFromFile(reads[i].fullPath);
+            }
+        };
+
+        size_t threadCount = std::min(static_cast<size_t>(maxParallelReads), reads.size());
+        std::vector<std::thread> threads;
+        for (size_t i = 1; i < threadCount; ++i)
+        {
+            threads.emplace_back(readFiles);
+        }
+        readFiles();
+        for (auto& thread : threads)
+        {
+            thread.join();
+        }
+
+        Director::getInstance()->getScheduler()->performFunctionInCocosThread([results, callback]() {
+            callback(std::move(*results));
+        });
+    });
+}
+
+bool FileUtils::getFileLocation(const std::string& fullPath, const void** archive, size_t* offset) const
+{
+    std::lock_guard<std::mutex> lock(_searchMutex);
+    if (_assetPacks.empty())
+        return false;
+
+    std::string relativePath;
+    auto pack = getAssetPackForFullPath(fullPath, &relativePath);
+    ssize_t size = 0;
+    auto bytes = pack ? pack->getFileData(relativePath, &size) : nullptr;
+    if (bytes == nullptr)
+        return false;
+
+    // the files are contiguous in the mapping of the pack
+    *archive = pack;
+    *offset = reinterpret_cast<uintptr_t>(bytes);
+    return true;
+}
+
+FileStream* FileUtils::openFileStream(const std::string& filename) const
+{
+    std::string fullPath = fullPathForFilename(filename);
+    if (fullPath.empty())
+        return nullptr;
+
+    auto packData = mapAssetPackContents(fullPath);
+    if (packData)
+        return FileStream::createWithMappedFileData(packData);
+
+    FILE *fp = fopen(getSuitableFOpen(fullPath).c_str(), "rb");
+    if (!fp)
+        return nullptr;
+
+    long size = -1;
+    if (fseek(fp, 0, SEEK_END) == 0)
+    {
+        size = ftell(fp);
+    }
+    if (size < 0 || fseek(fp, 0, SEEK_SET) != 0)
+    {
+        fclose(fp);
+        return nullptr;
+    }
+
+    auto stream = new (std::nothrow) StdioFileStream(fp, static_cast<ssize_t>(size));
+    if (stream == nullptr)
+    {
+        fclose(fp);
+    }
+    return stream;
+}
+
+void FileUtils::readFileChunksAsync(const std::string& filename, size_t chunkSize, std::function<void(const Data&)> chunkCallback, std::function<void(bool)> callback)
+{
+    CCASSERT(chunkSize > 0, "Invalid chunk size");
+    auto fullPath = fullPathForFilename(filename);
+    performOperationOffthread([fullPath, chunkSize, chunkCallback]() -> bool {
+        std::unique_ptr<FileStream> stream(FileUtils::getInstance()->openFileStream(fullPath));
+        if (!stream)
+            return false;
+
+        auto scheduler = Director::getInstance()->getScheduler();
+        while (true)
+        {
+            unsigned char* bytes = (unsigned char*)malloc(chunkSize);
+            if (!bytes)
+                return false;
+
+            ssize_t readsize = stream->read(bytes, chunkSize);
+            if (readsize <= 0)
+            {
+                free(bytes);
+                return readsize == 0;
+            }
+
+            // the chunks are queued in order before the final callback, shared to avoid copying them
+            auto chunk = std::make_shared<Data>();
+            chunk->fastSet(bytes, readsize);
+            scheduler->performFunctionInCocosThread([chunkCallback, chunk]() {
+                chunkCallback(*chunk);
+            });
+        }
+    }, std::move(callback));
+}
+
 FileUtils::Status FileUtils::getContents(const std::string& filename, ResizableBuffer* buffer)
 {
     if (filename.empty())
@@ -663,6 +1212,9 @@ FileUtils::Status FileUtils::getContents(const std::string& filename, ResizableB
     if (fullPath.empty())
         return Status::NotExists;
 
+    if (fs->getContentsFromAssetPack(fullPath, buffer))
+        return Status::OK;
+
     FILE *fp = fopen(fs->getSuitableFOpen(fullPath).c_str(), "rb");
     if (!fp)
         return Status::OpenFailed;
@@ -816,40 +1368,101 @@ std::string FileUtils::fullPathForFilename(const std::string &filename) const
         return filename;
     }
 
-    // Already Cached ?
-    auto cacheIter = _fullPathCache.find(filename);
-    if(cacheIter != _fullPathCache.end())
+    // Worker threads resolve paths too, so the search state is copied under the lock,
+    // and the file system is probed without holding it.
+    std::string newFilename;
+    std::vector<std::string> searchPaths;
+    std::vector<std::string> searchResolutions;
+    std::vector<bool> isAssetPack;
+    unsigned int generation;
     {
-        return cacheIter->second;
-    }
+        std::lock_guard<std::mutex> lock(_searchMutex);
 
-    // Get the new file name.
-    const std::string newFilename( getNewFilename(filename) );
+        // Already Cached ?
+        auto cacheIter = _fullPathCache.find(filename);
+        if (cacheIter != _fullPathCache.end())
+        {
+            return cacheIter->second;
+        }
+
+        // Already known to be missing ?
+        if (_nonexistentFileCache.find(filename) != _nonexistentFileCache.end())
+        {
+            return "";
+        }
+
+        // Get the new file name.
+        newFilename = getNewFilename(filename);
+        searchPaths = _searchPathArray;
+        searchResolutions = _searchResolutionsOrderArray;
+        isAssetPack.reserve(searchPaths.size());
+        for (const auto& searchIt : searchPaths)
+        {
+            isAssetPack.push_back(!_assetPacks.empty() && _assetPacks.find(searchIt) != _assetPacks.end());
+        }
+        generation = _searchGeneration;
+    }
 
     std::string fullpath;
 
-    for (const auto& searchIt : _searchPathArray)
+    for (size_t i = 0; i < searchPaths.size() && fullpath.empty(); ++i)
     {
-        for (const auto& resolutionIt : _searchResolutionsOrderArray)
+        const auto& searchIt = searchPaths[i];
+        for (const auto& resolutionIt : searchResolutions)
         {
-            fullpath = this->getPathForFilename(newFilename, resolutionIt, searchIt);
+            // a mounted pack answers with a hash lookup instead of probing the file system
+            if (isAssetPack[i])
+            {
+                std::string relativePath = newFilename;
+                if (!resolutionIt.empty())
+                {
+                    size_t pos = newFilename.find_last_of("/");
+                    std::string directory = newFilename.substr(0, pos == std::string::npos ? 0 : pos + 1) + resolutionIt;
+                    if (directory[directory.size() - 1] != '/')
+                    {
+                        directory += '/';
+                    }
+                    relativePath = directory + newFilename.substr(pos == std::string::npos ? 0 : pos + 1);
+                }
+
+                fullpath = isFileInAssetPack(searchIt, relativePath) ? searchIt + relativePath : "";
+            }
+            else
+            {
+                fullpath = this->getPathForFilename(newFilename, resolutionIt, searchIt);
+            }
+
+            if (!fullpath.empty())
+            {
+                break;
+            }
+        }
+    }
 
+    {
+        std::lock_guard<std::mutex> lock(_searchMutex);
+        // the search paths may have changed while probing, the result would be stale then
+        if (generation == _searchGeneration)
+        {
             if (!fullpath.empty())
             {
                 // Using the filename passed in as key.
                 _fullPathCache.emplace(filename, fullpath);
-                return fullpath;
             }
-
+            else
+            {
+                _nonexistentFileCache.insert(filename);
+            }
         }
     }
 
-    if(isPopupNotify()){
+    if (fullpath.empty() && isPopupNotify())
+    {
         CCLOG("cocos2d: fullPathForFilename: No file found at %s. Possible missing file.", filename.c_str());
     }
 
-    // The file wasn't found, return empty string.
-    return "";
+    // The file wasn't found if fullpath is empty.
+    return fullpath;
 }
 
 std::string FileUtils::fullPathFromRelativeFile(const std::string &filename, const std::string &relativeFile)
@@ -866,7 +1479,8 @@ void FileUtils::setSearchResolutionsOrder(const std::vector<std::string>& search
 
     bool existDefault = false;
 
-    _fullPathCache.clear();
+    std::lock_guard<std::mutex> lock(_searchMutex);
+    clearPathCaches();
     _searchResolutionsOrderArray.clear();
     for(const auto& iter : searchResolutionsOrder)
     {
@@ -896,6 +1510,8 @@ void FileUtils::addSearchResolutionsOrder(const std::string &order,const bool fr
     if (!resOrder.empty() && resOrder[resOrder.length()-1] != '/')
         resOrder.append("/");
 
+    std::lock_guard<std::mutex> lock(_searchMutex);
+    clearPathCaches();
     if (front) {
         _searchResolutionsOrderArray.insert(_searchResolutionsOrderArray.begin(), resOrder);
     } else {
@@ -932,7 +1548,6 @@ void FileUtils::setDefaultResourceRootPath(const std::string& path)
 {
     if (_defaultResRootPath != path)
     {
-        _fullPathCache.clear();
         _defaultResRootPath = path;
         if (!_defaultResRootPath.empty() && _defaultResRootPath[_defaultResRootPath.length()-1] != '/')
         {
@@ -947,12 +1562,9 @@ void FileUtils::setDefaultResourceRootPath(const std::string& path)
 void FileUtils::setSearchPaths(const std::vector<std::string>& searchPaths)
 {
     bool existDefaultRootPath = false;
-    _originalSearchPaths = searchPaths;
+    std::vector<std::string> searchPathArray;
 
-    _fullPathCache.clear();
-    _searchPathArray.clear();
-
-    for (const auto& path : _originalSearchPaths)
+    for (const auto& path : searchPaths)
     {
         std::string prefix;
         std::string fullPath;
@@ -970,14 +1582,23 @@ void FileUtils::setSearchPaths(const std::vector<std::string>& searchPaths)
         {
             existDefaultRootPath = true;
         }
-        _searchPathArray.push_back(fullPath);
+        searchPathArray.push_back(fullPath);
     }
 
     if (!existDefaultRootPath)
     {
         //CCLOG("Default root path doesn't exist, adding it.");
-        _searchPathArray.push_back(_defaultResRootPath);
+        searchPathArray.push_back(_defaultResRootPath);
     }
+
+    {
+        std::lock_guard<std::mutex> lock(_searchMutex);
+        clearPathCaches();
+        _originalSearchPaths = searchPaths;
+        _searchPathArray.swap(searchPathArray);
+    }
+
+    updateAssetPacks();
 }
 
 void FileUtils::addSearchPath(const std::string &searchpath,const bool front)
@@ -992,18 +1613,140 @@ void FileUtils::addSearchPath(const std::string &searchpath,const bool front)
         path += "/";
     }
 
-    if (front) {
-        _originalSearchPaths.insert(_originalSearchPaths.begin(), searchpath);
-        _searchPathArray.insert(_searchPathArray.begin(), path);
-    } else {
-        _originalSearchPaths.push_back(searchpath);
-        _searchPathArray.push_back(path);
+    {
+        std::lock_guard<std::mutex> lock(_searchMutex);
+        clearPathCaches();
+        if (front) {
+            _originalSearchPaths.insert(_originalSearchPaths.begin(), searchpath);
+            _searchPathArray.insert(_searchPathArray.begin(), path);
+        } else {
+            _originalSearchPaths.push_back(searchpath);
+            _searchPathArray.push_back(path);
+        }
+    }
+
+    updateAssetPacks();
+}
+
+void FileUtils::updateAssetPacks()
+{
+    // only the cocos thread modifies the packs, so it reads them unlocked
+    std::unordered_map<std::string, AssetPack*> assetPacks;
+    std::unordered_map<std::string, AssetPack*> unusedAssetPacks(_assetPacks);
+    const size_t suffixLength = AssetPack::EXTENSION.size() + 1;
+    for (const auto& searchPath : _searchPathArray)
+    {
+        // the search paths end with '/'
+        if (searchPath.size() <= suffixLength ||
+            searchPath.compare(searchPath.size() - suffixLength, AssetPack::EXTENSION.size(), AssetPack::EXTENSION) != 0 ||
+            assetPacks.find(searchPath) != assetPacks.end())
+        {
+            continue;
+        }
+
+        auto iter = unusedAssetPacks.find(searchPath);
+        if (iter != unusedAssetPacks.end())
+        {
+            assetPacks.emplace(searchPath, iter->second);
+            unusedAssetPacks.erase(iter);
+            continue;
+        }
+
+        auto pack = AssetPack::create(searchPath.substr(0, searchPath.size() - 1));
+        if (pack)
+        {
+            pack->retain();
+            assetPacks.emplace(searchPath, pack);
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(_searchMutex);
+    // the packs which aren't search paths anymore
+    for (auto& iter : unusedAssetPacks)
+    {
+        iter.second->release();
+    }
+    _assetPacks.swap(assetPacks);
+    clearPathCaches();
+}
+
+bool FileUtils::isFileInAssetPack(const std::string& searchPath, const std::string& relativePath) const
+{
+    std::lock_guard<std::mutex> lock(_searchMutex);
+    auto iter = _assetPacks.find(searchPath);
+    ssize_t size;
+    return iter != _assetPacks.end() && iter->second->getFileData(relativePath, &size) != nullptr;
+}
+
+AssetPack* FileUtils::getAssetPackForFullPath(const std::string& fullPath, std::string* relativePath) const
+{
+    for (const auto& iter : _assetPacks)
+    {
+        if (fullPath.size() > iter.first.size() && fullPath.compare(0, iter.first.size(), iter.first) == 0)
+        {
+            *relativePath = fullPath.substr(iter.first.size());
+            return iter.second;
+        }
     }
+    return nullptr;
+}
+
+bool FileUtils::getContentsFromAssetPack(const std::string& fullPath, ResizableBuffer* buffer) const
+{
+    // copies under the lock, so the pack isn't unmounted meanwhile
+    std::lock_guard<std::mutex> lock(_searchMutex);
+    if (_assetPacks.empty())
+        return false;
+
+    std::string relativePath;
+    auto pack = getAssetPackForFullPath(fullPath, &relativePath);
+    ssize_t size = 0;
+    auto bytes = pack ? pack->getFileData(relativePath, &size) : nullptr;
+    if (bytes == nullptr)
+        return false;
+
+    buffer->resize(size);
+    if (size > 0)
+    {
+        memcpy(buffer->buffer(), bytes, size);
+    }
+    return true;
+}
+
+MappedFileData* FileUtils::mapAssetPackContents(const std::string& fullPath) const
+{
+    std::lock_guard<std::mutex> lock(_searchMutex);
+    if (_assetPacks.empty())
+        return nullptr;
+
+    std::string relativePath;
+    auto pack = getAssetPackForFullPath(fullPath, &relativePath);
+    ssize_t size = 0;
+    auto bytes = pack ? pack->getFileData(relativePath, &size) : nullptr;
+    if (bytes == nullptr || size == 0)
+        return nullptr;
+
+    return new (std::nothrow) AssetPackMappedFileData(pack, bytes, size, &_searchMutex);
+}
+
+long FileUtils::getAssetPackFileSize(const std::string& fullPath) const
+{
+    std::lock_guard<std::mutex> lock(_searchMutex);
+    if (_assetPacks.empty())
+        return -1;
+
+    std::string relativePath;
+    auto pack = getAssetPackForFullPath(fullPath, &relativePath);
+    ssize_t size = 0;
+    if (pack == nullptr || pack->getFileData(relativePath, &size) == nullptr)
+        return -1;
+    return static_cast<long>(size);
 }
 
 void FileUtils::setFilenameLookupDictionary(const ValueMap& filenameLookupDict)
 {
-    _fullPathCache.clear();
+    std::lock_guard<std::mutex> lock(_searchMutex);
+    clearPathCaches();
     _filenameLookupDict = filenameLookupDict;
 }
 
@@ -1047,7 +1790,7 @@ bool FileUtils::isFileExist(const std::string& filename) const
 {
     if (isAbsolutePath(filename))
     {
-        return isFileExistInternal(filename);
+        return getAssetPackFileSize(filename) >= 0 || isFileExistInternal(filename);
     }
     else
     {
@@ -1081,23 +1824,46 @@ bool FileUtils::isDirectoryExist(const std::string& dirPath) const
         return isDirectoryExistInternal(dirPath);
     }
 
-    // Already Cached ?
-    auto cacheIter = _fullPathCache.find(dirPath);
-    if( cacheIter != _fullPathCache.end() )
+    std::string cachedPath;
+    std::vector<std::string> searchPaths;
+    std::vector<std::string> searchResolutions;
+    unsigned int generation;
+    {
+        std::lock_guard<std::mutex> lock(_searchMutex);
+
+        // Already Cached ?
+        auto cacheIter = _fullPathCache.find(dirPath);
+        if( cacheIter != _fullPathCache.end() )
+        {
+            cachedPath = cacheIter->second;
+        }
+        else
+        {
+            searchPaths = _searchPathArray;
+            searchResolutions = _searchResolutionsOrderArray;
+        }
+        generation = _searchGeneration;
+    }
+
+    if (!cachedPath.empty())
     {
-        return isDirectoryExistInternal(cacheIter->second);
+        return isDirectoryExistInternal(cachedPath);
     }
 
     std::string fullpath;
-    for (const auto& searchIt : _searchPathArray)
+    for (const auto& searchIt : searchPaths)
     {
-        for (const auto& resolutionIt : _searchResolutionsOrderArray)
+        for (const auto& resolutionIt : searchResolutions)
         {
             // searchPath + file_path + resourceDirectory
             fullpath = fullPathForFilename(searchIt + dirPath + resolutionIt);
             if (isDirectoryExistInternal(fullpath))
             {
-                _fullPathCache.emplace(dirPath, fullpath);
+                std::lock_guard<std::mutex> lock(_searchMutex);
+                if (generation == _searchGeneration)
+                {
+                    _fullPathCache.emplace(dirPath, fullpath);
+                }
                 return true;
             }
         }
@@ -1238,6 +2004,12 @@ void FileUtils::listFilesRecursively(const std::string& dirPath, std::vector<std
     return;
 }
 
+MappedFileData* FileUtils::mapFileContents(const std::string& filename) const
+{
+    // the windows FileUtils maps files, the others read them
+    return nullptr;
+}
+
 #else
 #include "tinydir/tinydir.h"
 // default implements for unix like os
@@ -1245,11 +2017,66 @@ void FileUtils::listFilesRecursively(const std::string& dirPath, std::vector<std
 #include <errno.h>
 #include <dirent.h>
 
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <unistd.h>
+
 // android doesn't have ftw.h
 #if (CC_TARGET_PLATFORM != CC_PLATFORM_ANDROID)
 #include <ftw.h>
 #endif
 
+namespace
+{
+    class PosixMappedFileData : public MappedFileData
+    {
+    public:
+        PosixMappedFileData(void* bytes, ssize_t size)
+        {
+            _bytes = static_cast<const unsigned char*>(bytes);
+            _size = size;
+        }
+
+        virtual ~PosixMappedFileData()
+        {
+            munmap(const_cast<unsigned char*>(_bytes), _size);
+        }
+    };
+}
+
+MappedFileData* FileUtils::mapFileContents(const std::string& filename) const
+{
+    std::string fullPath = fullPathForFilename(filename);
+    if (fullPath.empty())
+        return nullptr;
+
+    auto packData = mapAssetPackContents(fullPath);
+    if (packData)
+        return packData;
+
+    int fd = open(getSuitableFOpen(fullPath).c_str(), O_RDONLY);
+    if (fd == -1)
+        return nullptr;
+
+    struct stat statBuf;
+    if (fstat(fd, &statBuf) == -1 || statBuf.st_size <= 0)
+    {
+        close(fd);
+        return nullptr;
+    }
+
+    // the mapping outlives the descriptor
+    void* bytes = mmap(nullptr, statBuf.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (bytes == MAP_FAILED)
+        return nullptr;
+
+    auto mapped = new (std::nothrow) PosixMappedFileData(bytes, statBuf.st_size);
+    if (mapped == nullptr)
+        munmap(bytes, statBuf.st_size);
+    return mapped;
+}
+
 bool FileUtils::isDirectoryExistInternal(const std::string& dirPath) const
 {
     struct stat st;
@@ -1320,6 +2147,7 @@ bool FileUtils::createDirectory(const std::string& path)
             closedir(dir);
         }
     }
+    purgeNonexistentFileCache();
     return true;
 }
 
@@ -1383,6 +2211,7 @@ bool FileUtils::renameFile(const std::string &oldfullpath, const std::string &ne
         CCLOGERROR("Fail to rename file %s to %s !Error code is %d", oldfullpath.c_str(), newfullpath.c_str(), errorCode);
         return false;
     }
+    purgeNonexistentFileCache();
     return true;
 }
 
@@ -1412,6 +2241,10 @@ long FileUtils::getFileSize(const std::string &filepath)
             return 0;
     }
 
+    long packFileSize = getAssetPackFileSize(fullpath);
+    if (packFileSize >= 0)
+        return packFileSize;
+
     struct stat info;
     // Get data associated with "crt_stat.c":
     int result = stat(fullpath.c_str(), &info);
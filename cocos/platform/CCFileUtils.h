@@ -28,13 +28,18 @@ THE SOFTWARE.
 #include <string>
 #include <vector>
 #include <unordered_map>
+#include <unordered_set>
+#include <mutex>
 #include <type_traits>
 
 #include "platform/CCPlatformMacros.h"
 #include "base/ccTypes.h"
+#include "base/CCRef.h"
 #include "base/CCValue.h"
 #include "base/CCData.h"
+#include "base/CCDataView.h"
 #include "base/CCAsyncTaskPool.h"
+#include "base/CCAsyncOperation.h"
 #include "base/CCScheduler.h"
 #include "base/CCDirector.h"
 
@@ -105,10 +110,16 @@ public:
     virtual void resize(size_t size) override {
         size_t oldSize = static_cast<size_t>(_buffer->getSize());
         if (oldSize != size) {
+            if (size == 0) {
+                _buffer->clear();
+                return;
+            }
             auto old = _buffer->getBytes();
             void* buffer = realloc(old, size);
             if (buffer)
                 _buffer->fastSet((unsigned char*)buffer, size);
+            else // the callers see the failure as an empty buffer
+                _buffer->clear();
         }
     }
     virtual void* buffer() const override {
@@ -116,6 +127,129 @@ public:
     }
 };
 
+/**
+ * Read only contents of a file, mapped in memory. Returned by FileUtils::mapFileContents(),
+ * the mapping is released when the object is deleted.
+ */
+class CC_DLL MappedFileData
+{
+public:
+    virtual ~MappedFileData() {}
+
+    const unsigned char* getBytes() const { return _bytes; }
+    ssize_t getSize() const { return _size; }
+
+    /** Returns whether the memory [bytes, bytes + size) belongs to the mapping. */
+    bool contains(const unsigned char* bytes, ssize_t size) const
+    {
+        return bytes >= _bytes && size >= 0 && bytes + size <= _bytes + _size;
+    }
+
+protected:
+    MappedFileData() : _bytes(nullptr), _size(0) {}
+
+    const unsigned char* _bytes;
+    ssize_t _size;
+};
+
+/**
+ * A read only stream over the contents of a file, returned by FileUtils::openFileStream(),
+ * so that large files are read in ranges instead of at once. The file is closed when the stream is deleted.
+ * A stream isn't thread safe, but it may be used on another thread than the one which opened it.
+ *
+ * @since v3.14
+ */
+class CC_DLL FileStream
+{
+public:
+    enum class Origin
+    {
+        BEGIN,
+        CURRENT,
+        END
+    };
+
+    virtual ~FileStream() {}
+
+    /** Reads up to size bytes at the position, which moves forward. Returns the number of bytes read, 0 at the end of the stream, -1 on error. */
+    virtual ssize_t read(void* buffer, size_t size) = 0;
+
+    /** Moves the position relatively to an origin. Returns false if it would be outside of the stream, which is left unchanged then. */
+    virtual bool seek(ssize_t offset, Origin origin) = 0;
+
+    /** Returns the position in the stream. */
+    virtual ssize_t tell() const = 0;
+
+    /** Returns the size of the stream. */
+    virtual ssize_t getSize() const = 0;
+
+    /** Reads up to size bytes at an offset from the beginning of the stream. Returns the number of bytes read, -1 on error. */
+    ssize_t readRange(ssize_t offset, void* buffer, size_t size)
+    {
+        return seek(offset, Origin::BEGIN) ? read(buffer, size) : -1;
+    }
+
+    /** Creates a stream reading from memory, it takes the ownership of the data. */
+    static FileStream* createWithMappedFileData(MappedFileData* data);
+};
+
+/**
+ * A read only archive of files, with a prebuilt hash index of their relative paths.
+ * A pack is mounted by adding its path to the search paths, like a directory, e.g. `FileUtils::getInstance()->addSearchPath("packs/ui.ccpk")`.
+ * The files of the pack are then found with one hash lookup at the rank of that search path, without any file system call,
+ * and their full path is the path of the pack followed by their relative path, e.g. "packs/ui.ccpk/images/button.png".
+ * The pack is memory mapped when the platform supports it, otherwise it is read at once.
+ *
+ * The file format, all integers are 32 bits little endian:
+ * - header: "CCPK", version, number of files, 0
+ * - index sorted by hash: XXH32 hash of the relative path, path offset, path length, data offset, data size
+ * - relative paths, then the data of the files aligned to 16 bytes
+ *
+ * @since v3.14
+ */
+class CC_DLL AssetPack : public Ref
+{
+public:
+    /** The file extension of asset packs, search paths ending with it are mounted as packs. */
+    static const std::string EXTENSION;
+
+    /** Opens the asset pack at the given full path, returns nullptr if it isn't a valid pack. */
+    static AssetPack* create(const std::string& fullPath);
+
+    /** Writes an asset pack from files.
+     *
+     * @param packFullPath The full path of the pack to write.
+     * @param directory The directory containing the files.
+     * @param relativePaths The paths of the files relative to directory, which are also their paths in the pack.
+     * @return Returns true if the pack was written.
+     */
+    static bool writePack(const std::string& packFullPath, const std::string& directory, const std::vector<std::string>& relativePaths);
+
+    /** Returns the contents of a file of the pack, or nullptr if the pack doesn't contain that file.
+     * The memory is owned by the pack.
+     *
+     * @param relativePath The path of the file relative to the pack.
+     * @param size Returns the size of the file.
+     */
+    const unsigned char* getFileData(const std::string& relativePath, ssize_t* size) const;
+
+    /** Returns the number of files of the pack. */
+    int getFileCount() const { return static_cast<int>(_fileCount); }
+
+CC_CONSTRUCTOR_ACCESS:
+    AssetPack();
+    virtual ~AssetPack();
+
+    bool initWithFile(const std::string& fullPath);
+
+protected:
+    MappedFileData* _mappedData;
+    Data _data;
+    const unsigned char* _bytes;
+    ssize_t _size;
+    uint32_t _fileCount;
+};
+
 /** Helper class to handle file operations. */
 class CC_DLL FileUtils
 {
@@ -160,9 +294,18 @@ public:
 
     /**
      *  Purges full path caches.
+     *  Files which aren't found are cached as well, so call this after creating resources
+     *  which were looked up before without going through the `write*` methods of FileUtils.
      */
     virtual void purgeCachedEntries();
 
+    /**
+     *  Forgets the files which weren't found, keeping the resolved full paths.
+     *  The `write*`, renameFile() and createDirectory() methods call it, call it after creating files with fopen().
+     *  @since v3.14
+     */
+    void purgeNonexistentFileCache();
+
     /**
      *  Gets string from a file.
      */
@@ -193,6 +336,83 @@ public:
      */
     virtual void getDataFromFile(const std::string& filename, std::function<void(Data)> callback);
 
+    /**
+     * Reads a file off the cocos thread, the operation is completed on the thread reading it, so its
+     * continuations can keep working there or go to the executor they need.
+     *
+     * @param filename filepath for the data to be read. Can be relative or absolute path
+     * @return An operation completed with the data, empty if the file can't be read.
+     * @since v3.14
+     * @js NA
+     * @lua NA
+     */
+    AsyncOperation<Data> getDataFromFileAsync(const std::string& filename);
+
+    /**
+     * Like getDataFromFileAsync(), for a string.
+     * @since v3.14
+     * @js NA
+     * @lua NA
+     */
+    AsyncOperation<std::string> getStringFromFileAsync(const std::string& filename);
+
+    /**
+     * Reads a file in a buffer shared by its views, so the bytes are passed around without being copied.
+     * It reads the file with getDataFromFile() and takes its buffer.
+     *
+     * @param filename filepath for the data to be read. Can be relative or absolute path
+     * @return A view of the bytes of the file, null if it can't be read.
+     * @see DataView
+     * @since v3.14
+     */
+    DataView getDataViewFromFile(const std::string& filename);
+
+    /**
+     * Reads a file in a shared buffer, async off the main cocos thread.
+     *
+     * @param filename filepath for the data to be read. Can be relative or absolute path
+     * @param callback Function that will be called when file is read. Will be called
+     * on the main cocos thread.
+     * @since v3.14
+     */
+    void getDataViewFromFile(const std::string& filename, std::function<void(DataView)> callback);
+
+    /**
+     * Reads several files off the main cocos thread, with a single callback.
+     * The files of asset packs and zip archives are read in the order of the archives,
+     * and up to maxParallelReads files are read at once.
+     *
+     * @param filenames The files to read, relative or absolute paths.
+     * @param callback Function called on the main cocos thread once all the files are read, with their data
+     *                 in the order of filenames. The data of a file which couldn't be read is null.
+     * @param maxParallelReads The maximum number of threads reading the files.
+     * @since v3.14
+     */
+    void getDataFromFiles(const std::vector<std::string>& filenames, std::function<void(std::vector<Data>)> callback, unsigned int maxParallelReads = 4);
+
+    /**
+     *  Opens a file as a stream to read it in ranges, instead of reading it in memory at once.
+     *  It reads the files of the file system, of the asset packs, and on Android of the apk and the obb.
+     *  The files which are compressed in a zip (the obb) are inflated in memory, the stored ones are mapped.
+     *  It may be called from any thread.
+     *
+     *  @param filename The file name, relative or absolute.
+     *  @return The stream to delete once done with it, nullptr if the file can't be opened.
+     *  @since v3.14
+     */
+    virtual FileStream* openFileStream(const std::string& filename) const;
+
+    /**
+     *  Reads a file in chunks off the main cocos thread, so that it is parsed incrementally without being held in memory at once.
+     *
+     *  @param filename The file name, relative or absolute.
+     *  @param chunkSize The maximum size of the chunks.
+     *  @param chunkCallback Called with each chunk in order, on the main cocos thread.
+     *  @param callback Called once all the chunks were passed, on the main cocos thread, with false if the file couldn't be read.
+     *  @since v3.14
+     */
+    void readFileChunksAsync(const std::string& filename, size_t chunkSize, std::function<void(const Data&)> chunkCallback, std::function<void(bool)> callback);
+
     enum class Status
     {
         OK = 0,
@@ -271,6 +491,17 @@ public:
     }
     virtual Status getContents(const std::string& filename, ResizableBuffer* buffer);
 
+    /**
+     *  Maps the contents of a file in memory, read only, instead of reading it in a buffer.
+     *  The pages are loaded on access and aren't counted as heap memory. On Android the assets
+     *  stored uncompressed in the apk are mapped, the other ones are read in a buffer owned by the asset.
+     *
+     *  @param[in]  filename The file name, relative or absolute.
+     *  @return The mapped contents to delete once done with them, nullptr if the file can't be mapped.
+     *  @since v3.14
+     */
+    virtual MappedFileData* mapFileContents(const std::string& filename) const;
+
     /**
      *  Gets resource file data
      *
@@ -435,6 +666,8 @@ public:
      *            If "/mnt/sdcard/" and "resources-large" were set to the search paths vector,
      *            "resources-large" will be converted to "assets/resources-large" since it was a relative path.
      *
+     *  A search path naming an AssetPack file, ending with ".ccpk", mounts that pack, see AssetPack.
+     *
      *  @param searchPaths The array contains search paths.
      *  @see fullPathForFilename(const char*)
      *  @since v2.1
@@ -454,7 +687,7 @@ public:
     void setDefaultResourceRootPath(const std::string& path);
 
     /**
-      * Add search path.
+      * Add search path. A path ending with ".ccpk" mounts an AssetPack.
       *
       * @since v2.1
       */
@@ -840,7 +1073,7 @@ public:
     */
     virtual void listFilesRecursivelyAsync(const std::string& dirPath, std::function<void(std::vector<std::string>)> callback) const;
 
-    /** Returns the full path cache. */
+    /** Returns the full path cache. It should be used on the cocos thread only, since it isn't locked. */
     const std::unordered_map<std::string, std::string>& getFullPathCache() const { return _fullPathCache; }
 
     /**
@@ -904,6 +1137,38 @@ protected:
      */
     virtual std::string getFullPathForDirectoryAndFilename(const std::string& directory, const std::string& filename) const;
 
+    /** Mounts the asset packs of the search paths, and unmounts the packs which aren't search paths anymore. */
+    void updateAssetPacks();
+
+    /**
+     *  Returns the location of a file inside an archive, so that batched reads follow the order of the archive.
+     *  The base implementation locates the files of asset packs, the Android one also the files of the obb.
+     *
+     *  @param fullPath The full path of the file.
+     *  @param[out] archive Identifies the archive containing the file.
+     *  @param[out] offset The offset of the file in the archive.
+     *  @return false if the file isn't in an archive.
+     */
+    virtual bool getFileLocation(const std::string& fullPath, const void** archive, size_t* offset) const;
+
+    /** Returns true if the asset pack mounted at searchPath contains relativePath. */
+    bool isFileInAssetPack(const std::string& searchPath, const std::string& relativePath) const;
+
+    /** Clears the path caches. _searchMutex must be held. */
+    void clearPathCaches();
+
+    /** Returns the mounted asset pack containing a full path, and the path relative to the pack. _searchMutex must be held. */
+    AssetPack* getAssetPackForFullPath(const std::string& fullPath, std::string* relativePath) const;
+
+    /** Reads a file of a mounted asset pack. Returns false if fullPath isn't a file of a mounted pack. */
+    bool getContentsFromAssetPack(const std::string& fullPath, ResizableBuffer* buffer) const;
+
+    /** Maps a file of a mounted asset pack. Returns nullptr if fullPath isn't a file of a mounted pack. */
+    MappedFileData* mapAssetPackContents(const std::string& fullPath) const;
+
+    /** Returns the size of a file of a mounted asset pack, or -1 if fullPath isn't a file of a mounted pack. */
+    long getAssetPackFileSize(const std::string& fullPath) const;
+
     /** Dictionary used to lookup filenames based on a key.
      *  It is used internally by the following methods:
      *
@@ -945,6 +1210,30 @@ protected:
      */
     mutable std::unordered_map<std::string, std::string> _fullPathCache;
 
+    /**
+     *  The files which weren't found, so that optional resources aren't probed on disk again.
+     *  It is invalidated together with _fullPathCache.
+     */
+    mutable std::unordered_set<std::string> _nonexistentFileCache;
+
+    /**
+     *  Guards the path caches and the search state against the threads resolving paths.
+     *  The search state is only modified by the cocos thread, holding this lock, so the cocos thread reads it unlocked.
+     *  No file system access is done while holding it.
+     */
+    mutable std::mutex _searchMutex;
+
+    /**
+     *  Incremented each time the caches are invalidated, so that a lookup racing with a change
+     *  of the search paths doesn't cache a stale result.
+     */
+    unsigned int _searchGeneration;
+
+    /**
+     *  The mounted asset packs, by their search path.
+     */
+    std::unordered_map<std::string, AssetPack*> _assetPacks;
+
     /**
      * Writable path.
      */
@@ -30,7 +30,10 @@ THE SOFTWARE.
 #include "base/CCEventDispatcher.h"
 #include "2d/CCCamera.h"
 #include "2d/CCScene.h"
+#include <chrono>
+
 #include "renderer/CCRenderer.h"
+#include "renderer/ccGLStateCache.h"
 #include "vr/CCVRProtocol.h"
 #include "vr/CCVRGenericRenderer.h"
 
@@ -87,6 +90,11 @@ namespace {
         temp = ~temp;
         g_indexBitsUsed &= temp;
     }
+
+    static double getTouchTimestamp()
+    {
+        return std::chrono::duration_cast<std::chrono::duration<double>>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
     
 }
 
@@ -107,6 +115,8 @@ GLView::GLView()
 : _scaleX(1.0f)
 , _scaleY(1.0f)
 , _resolutionPolicy(ResolutionPolicy::UNKNOWN)
+, _touchMovesCoalesced(false)
+, _pendingMoveBits(0)
 , _vrImpl(nullptr)
 , _designResolutionSize(0,0)
 , _screenSize(0,0)
@@ -172,7 +182,7 @@ void GLView::updateDesignResolutionSize()
         // A default viewport is needed in order to display the FPS,
         // since the FPS are rendered in the Director, and there is no viewport there.
         // Everything, including the FPS should renderer in the Scene.
-        glViewport(0, 0, _screenSize.width, _screenSize.height);
+        GL::viewport(0, 0, _screenSize.width, _screenSize.height);
     }
 }
 
@@ -260,7 +270,7 @@ void GLView::setViewPortInPoints(float x , float y , float w , float h)
 
 void GLView::setScissorInPoints(float x , float y , float w , float h)
 {
-    glScissor((GLint)(x * _scaleX + _viewPortRect.origin.x),
+    GL::scissor((GLint)(x * _scaleX + _viewPortRect.origin.x),
               (GLint)(y * _scaleY + _viewPortRect.origin.y),
               (GLsizei)(w * _scaleX),
               (GLsizei)(h * _scaleY));
@@ -268,7 +278,7 @@ void GLView::setScissorInPoints(float x , float y , float w , float h)
 
 bool GLView::isScissorEnabled()
 {
-    return (GL_FALSE == glIsEnabled(GL_SCISSOR_TEST)) ? false : true;
+    return (GL_FALSE == GL::isEnabled(GL_SCISSOR_TEST)) ? false : true;
 }
 
 Rect GLView::getScissorRect() const
@@ -298,7 +308,10 @@ void GLView::handleTouchesBegin(int num, intptr_t ids[], float xs[], float ys[])
     float x = 0.0f;
     float y = 0.0f;
     int unusedIndex = 0;
+    double timestamp = getTouchTimestamp();
     EventTouch touchEvent;
+
+    dispatchPendingTouchMoves();
     
     for (int i = 0; i < num; ++i)
     {
@@ -320,8 +333,8 @@ void GLView::handleTouchesBegin(int num, intptr_t ids[], float xs[], float ys[])
             }
 
             Touch* touch = g_touches[unusedIndex] = new (std::nothrow) Touch();
-            touch->setTouchInfo(unusedIndex, (x - _viewPortRect.origin.x) / _scaleX,
-                                     (y - _viewPortRect.origin.y) / _scaleY);
+            touch->addSample(unusedIndex, (x - _viewPortRect.origin.x) / _scaleX,
+                             (y - _viewPortRect.origin.y) / _scaleY, 0.0f, 0.0f, timestamp);
             
             CCLOGINFO("x = %f y = %f", touch->getLocationInView().x, touch->getLocationInView().y);
             
@@ -337,8 +350,7 @@ void GLView::handleTouchesBegin(int num, intptr_t ids[], float xs[], float ys[])
     }
     
     touchEvent._eventCode = EventTouch::EventCode::BEGAN;
-    auto dispatcher = Director::getInstance()->getEventDispatcher();
-    dispatcher->dispatchEvent(&touchEvent);
+    dispatchTouchEvent(touchEvent);
 }
 
 void GLView::handleTouchesMove(int num, intptr_t ids[], float xs[], float ys[])
@@ -347,12 +359,18 @@ void GLView::handleTouchesMove(int num, intptr_t ids[], float xs[], float ys[])
 }
 
 void GLView::handleTouchesMove(int num, intptr_t ids[], float xs[], float ys[], float fs[], float ms[])
+{
+    handleTouchesMove(num, ids, xs, ys, fs, ms, nullptr);
+}
+
+void GLView::handleTouchesMove(int num, intptr_t ids[], float xs[], float ys[], float fs[], float ms[], double timestamps[])
 {
     intptr_t id = 0;
     float x = 0.0f;
     float y = 0.0f;
     float force = 0.0f;
     float maxForce = 0.0f;
+    double now = timestamps ? 0.0 : getTouchTimestamp();
     EventTouch touchEvent;
     
     for (int i = 0; i < num; ++i)
@@ -374,10 +392,17 @@ void GLView::handleTouchesMove(int num, intptr_t ids[], float xs[], float ys[],
         Touch* touch = g_touches[iter->second];
         if (touch)
         {
-            touch->setTouchInfo(iter->second, (x - _viewPortRect.origin.x) / _scaleX,
-                                (y - _viewPortRect.origin.y) / _scaleY, force, maxForce);
-            
-            touchEvent._touches.push_back(touch);
+            touch->addSample(iter->second, (x - _viewPortRect.origin.x) / _scaleX,
+                             (y - _viewPortRect.origin.y) / _scaleY, force, maxForce, timestamps ? timestamps[i] : now);
+
+            if (_touchMovesCoalesced)
+            {
+                _pendingMoveBits |= 1 << iter->second;
+            }
+            else
+            {
+                touchEvent._touches.push_back(touch);
+            }
         }
         else
         {
@@ -387,6 +412,11 @@ void GLView::handleTouchesMove(int num, intptr_t ids[], float xs[], float ys[],
         }
     }
 
+    if (_touchMovesCoalesced)
+    {
+        return;
+    }
+
     if (touchEvent._touches.size() == 0)
     {
         CCLOG("touchesMoved: size = 0");
@@ -394,8 +424,51 @@ void GLView::handleTouchesMove(int num, intptr_t ids[], float xs[], float ys[],
     }
     
     touchEvent._eventCode = EventTouch::EventCode::MOVED;
+    dispatchTouchEvent(touchEvent);
+}
+
+void GLView::setTouchMovesCoalesced(bool coalesced)
+{
+    if (!coalesced)
+    {
+        dispatchPendingTouchMoves();
+    }
+    _touchMovesCoalesced = coalesced;
+}
+
+void GLView::dispatchPendingTouchMoves()
+{
+    if (_pendingMoveBits == 0)
+    {
+        return;
+    }
+
+    EventTouch touchEvent;
+    for (int i = 0; i < EventTouch::MAX_TOUCHES; ++i)
+    {
+        if ((_pendingMoveBits & (1 << i)) && g_touches[i])
+        {
+            touchEvent._touches.push_back(g_touches[i]);
+        }
+    }
+    _pendingMoveBits = 0;
+
+    if (!touchEvent._touches.empty())
+    {
+        touchEvent._eventCode = EventTouch::EventCode::MOVED;
+        dispatchTouchEvent(touchEvent);
+    }
+}
+
+void GLView::dispatchTouchEvent(EventTouch& touchEvent)
+{
     auto dispatcher = Director::getInstance()->getEventDispatcher();
     dispatcher->dispatchEvent(&touchEvent);
+
+    for (auto& touch : touchEvent._touches)
+    {
+        touch->clearHistory();
+    }
 }
 
 void GLView::handleTouchesOfEndOrCancel(EventTouch::EventCode eventCode, int num, intptr_t ids[], float xs[], float ys[])
@@ -403,7 +476,10 @@ void GLView::handleTouchesOfEndOrCancel(EventTouch::EventCode eventCode, int num
     intptr_t id = 0;
     float x = 0.0f;
     float y = 0.0f;
+    double timestamp = getTouchTimestamp();
     EventTouch touchEvent;
+
+    dispatchPendingTouchMoves();
     
     for (int i = 0; i < num; ++i)
     {
@@ -423,8 +499,8 @@ void GLView::handleTouchesOfEndOrCancel(EventTouch::EventCode eventCode, int num
         if (touch)
         {
             CCLOGINFO("Ending touches with id: %d, x=%f, y=%f", (int)id, x, y);
-            touch->setTouchInfo(iter->second, (x - _viewPortRect.origin.x) / _scaleX,
-                                (y - _viewPortRect.origin.y) / _scaleY);
+            touch->addSample(iter->second, (x - _viewPortRect.origin.x) / _scaleX,
+                             (y - _viewPortRect.origin.y) / _scaleY, 0.0f, 0.0f, timestamp);
 
             touchEvent._touches.push_back(touch);
             
@@ -448,8 +524,7 @@ void GLView::handleTouchesOfEndOrCancel(EventTouch::EventCode eventCode, int num
     }
     
     touchEvent._eventCode = eventCode;
-    auto dispatcher = Director::getInstance()->getEventDispatcher();
-    dispatcher->dispatchEvent(&touchEvent);
+    dispatchTouchEvent(touchEvent);
     
     for (auto& touch : touchEvent._touches)
     {
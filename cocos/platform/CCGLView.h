@@ -336,6 +336,16 @@ public:
      # @param ms The maximum force of 3d touches
      */
     virtual void handleTouchesMove(int num, intptr_t ids[], float xs[], float ys[], float fs[], float ms[]);
+
+    /** Handles moves with the times the platform sampled them, e.g. the historical samples of a high
+     * rate touch panel reported one after the other.
+     *
+     * @param fs The force of 3d touches, can be nullptr.
+     * @param ms The maximum force of 3d touches, can be nullptr.
+     * @param timestamps The times of the samples in seconds, nullptr for the time they are handled.
+     * @since v3.14
+     */
+    virtual void handleTouchesMove(int num, intptr_t ids[], float xs[], float ys[], float fs[], float ms[], double timestamps[]);
     
     /** Touch events are handled by default; if you want to customize your handlers, please override this function.
      *
@@ -355,6 +365,20 @@ public:
      */
     virtual void handleTouchesCancel(int num, intptr_t ids[], float xs[], float ys[]);
 
+    /** Coalesces the moves of the touches reported during a frame: they are dispatched in one
+     * EventTouch::MOVED at the beginning of the next frame, Touch::getHistory() keeps all the samples.
+     * The pending moves are dispatched before the touches that begin, end or are cancelled.
+     * Disabled by default, every move is dispatched when it's reported.
+     * @since v3.14
+     */
+    void setTouchMovesCoalesced(bool coalesced);
+    bool isTouchMovesCoalesced() const { return _touchMovesCoalesced; }
+
+    /** Dispatches the coalesced moves, called by the Director at the beginning of the frame.
+     * @since v3.14
+     */
+    void dispatchPendingTouchMoves();
+
     /**
      * Get the opengl view port rectangle.
      *
@@ -414,6 +438,7 @@ protected:
     void updateDesignResolutionSize();
     
     void handleTouchesOfEndOrCancel(EventTouch::EventCode eventCode, int num, intptr_t ids[], float xs[], float ys[]);
+    void dispatchTouchEvent(EventTouch& touchEvent);
 
     // real screen size
     Size _screenSize;
@@ -427,6 +452,9 @@ protected:
     float _scaleX;
     float _scaleY;
     ResolutionPolicy _resolutionPolicy;
+    bool _touchMovesCoalesced;
+    // the indices of the touches with moves not dispatched yet
+    unsigned int _pendingMoveBits;
 
     // VR stuff
     VRIRenderer* _vrImpl;
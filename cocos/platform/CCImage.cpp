@@ -100,6 +100,11 @@ extern "C"
 #include "decode.h"
 #endif // CC_USE_WEBP
 
+#if CC_USE_BASIS_UNIVERSAL
+#include "basisu_transcoder.h"
+#include <mutex>
+#endif // CC_USE_BASIS_UNIVERSAL
+
 #include "base/ccMacros.h"
 #include "platform/CCCommon.h"
 #include "platform/CCStdC.h"
@@ -107,6 +112,7 @@ extern "C"
 #include "base/CCConfiguration.h"
 #include "base/ccUtils.h"
 #include "base/ZipUtils.h"
+#include "renderer/CCTexture2D.h" // Texture2D::premultiplyAlphaRGBA8888
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID)
 #include "platform/android/CCFileUtils-android.h"
 #endif
@@ -424,6 +430,73 @@ namespace
 }
 //atitc struct end
 
+//////////////////////////////////////////////////////////////////////////
+//struct and data for ktx2 struct
+
+namespace
+{
+    const unsigned char KTX2_IDENTIFIER[12] = {0xAB, 0x4B, 0x54, 0x58, 0x20, 0x32, 0x30, 0xBB, 0x0D, 0x0A, 0x1A, 0x0A};
+
+    struct KTX2TexHeader
+    {
+        unsigned char identifier[12];
+        uint32_t vkFormat;
+        uint32_t typeSize;
+        uint32_t pixelWidth;
+        uint32_t pixelHeight;
+        uint32_t pixelDepth;
+        uint32_t layerCount;
+        uint32_t faceCount;
+        uint32_t levelCount;
+        uint32_t supercompressionScheme;
+        uint32_t dfdByteOffset;
+        uint32_t dfdByteLength;
+        uint32_t kvdByteOffset;
+        uint32_t kvdByteLength;
+        uint64_t sgdByteOffset;
+        uint64_t sgdByteLength;
+    };
+
+    // follows the header, one per level, level 0 first
+    struct KTX2LevelIndex
+    {
+        uint64_t byteOffset;
+        uint64_t byteLength;
+        uint64_t uncompressedByteLength;
+    };
+
+    struct KTX2FormatInfo
+    {
+        uint32_t vkFormat;
+        Texture2D::PixelFormat pixelFormat;
+        bool (Configuration::*supported)() const;
+    };
+
+    // VK_FORMAT_UNDEFINED, the format of Basis Universal textures
+    const uint32_t KTX2_VK_FORMAT_UNDEFINED = 0;
+
+    // the Vulkan formats with a pixel format of the engine, nullptr when no extension is needed
+    const KTX2FormatInfo ktx2_formats[] = {
+        {   2, Texture2D::PixelFormat::RGBA4444,    nullptr },                          // R4G4B4A4_UNORM_PACK16
+        {   4, Texture2D::PixelFormat::RGB565,      nullptr },                          // R5G6B5_UNORM_PACK16
+        {  23, Texture2D::PixelFormat::RGB888,      nullptr },                          // R8G8B8_UNORM
+        {  29, Texture2D::PixelFormat::RGB888,      nullptr },                          // R8G8B8_SRGB
+        {  37, Texture2D::PixelFormat::RGBA8888,    nullptr },                          // R8G8B8A8_UNORM
+        {  43, Texture2D::PixelFormat::RGBA8888,    nullptr },                          // R8G8B8A8_SRGB
+        { 131, Texture2D::PixelFormat::S3TC_DXT1,   &Configuration::supportsS3TC },     // BC1_RGB_UNORM_BLOCK
+        { 132, Texture2D::PixelFormat::S3TC_DXT1,   &Configuration::supportsS3TC },     // BC1_RGB_SRGB_BLOCK
+        { 133, Texture2D::PixelFormat::S3TC_DXT1,   &Configuration::supportsS3TC },     // BC1_RGBA_UNORM_BLOCK
+        { 134, Texture2D::PixelFormat::S3TC_DXT1,   &Configuration::supportsS3TC },     // BC1_RGBA_SRGB_BLOCK
+        { 135, Texture2D::PixelFormat::S3TC_DXT3,   &Configuration::supportsS3TC },     // BC2_UNORM_BLOCK
+        { 136, Texture2D::PixelFormat::S3TC_DXT3,   &Configuration::supportsS3TC },     // BC2_SRGB_BLOCK
+        { 137, Texture2D::PixelFormat::S3TC_DXT5,   &Configuration::supportsS3TC },     // BC3_UNORM_BLOCK
+        { 138, Texture2D::PixelFormat::S3TC_DXT5,   &Configuration::supportsS3TC },     // BC3_SRGB_BLOCK
+        { 1000054000, Texture2D::PixelFormat::PVRTC2A, &Configuration::supportsPVRTC }, // PVRTC1_2BPP_UNORM_BLOCK_IMG
+        { 1000054001, Texture2D::PixelFormat::PVRTC4A, &Configuration::supportsPVRTC }, // PVRTC1_4BPP_UNORM_BLOCK_IMG
+    };
+}
+//ktx2 struct end
+
 //////////////////////////////////////////////////////////////////////////
 
 namespace
@@ -489,6 +562,8 @@ Image::Image()
 , _renderFormat(Texture2D::PixelFormat::NONE)
 , _numberOfMipmaps(0)
 , _hasPremultipliedAlpha(false)
+, _mappedFile(nullptr)
+, _dataMapped(false)
 {
 
 }
@@ -500,8 +575,9 @@ Image::~Image()
         for (int i = 0; i < _numberOfMipmaps; ++i)
             CC_SAFE_DELETE_ARRAY(_mipmaps[i].address);
     }
-    else
+    else if (!_dataMapped)
         CC_SAFE_FREE(_data);
+    CC_SAFE_DELETE(_mappedFile);
 }
 
 bool Image::initWithImageFile(const std::string& path)
@@ -509,6 +585,12 @@ bool Image::initWithImageFile(const std::string& path)
     bool ret = false;
     _filePath = FileUtils::getInstance()->fullPathForFilename(path);
 
+    auto mappedFile = FileUtils::getInstance()->mapFileContents(_filePath);
+    if (mappedFile)
+    {
+        return initWithMappedFileData(mappedFile);
+    }
+
     Data data = FileUtils::getInstance()->getDataFromFile(_filePath);
 
     if (!data.isNull())
@@ -524,6 +606,12 @@ bool Image::initWithImageFileThreadSafe(const std::string& fullpath)
     bool ret = false;
     _filePath = fullpath;
 
+    auto mappedFile = FileUtils::getInstance()->mapFileContents(fullpath);
+    if (mappedFile)
+    {
+        return initWithMappedFileData(mappedFile);
+    }
+
     Data data = FileUtils::getInstance()->getDataFromFile(fullpath);
 
     if (!data.isNull())
@@ -534,6 +622,37 @@ bool Image::initWithImageFileThreadSafe(const std::string& fullpath)
     return ret;
 }
 
+bool Image::initWithMappedFileData(MappedFileData* mappedFile)
+{
+    CC_SAFE_DELETE(_mappedFile);
+    _mappedFile = mappedFile;
+
+    bool ret = initWithImageData(mappedFile->getBytes(), mappedFile->getSize());
+
+    // decoded or software decompressed images don't need the file any more
+    if (!_dataMapped || _unpack)
+    {
+        _dataMapped = false;
+        CC_SAFE_DELETE(_mappedFile);
+    }
+
+    return ret;
+}
+
+unsigned char* Image::takePayload(const unsigned char* data, ssize_t dataLen)
+{
+    if (_mappedFile && _mappedFile->contains(data, dataLen))
+    {
+        // read only, only handed to glCompressedTexImage2D
+        _dataMapped = true;
+        return const_cast<unsigned char*>(data);
+    }
+
+    auto payload = static_cast<unsigned char*>(malloc(dataLen * sizeof(unsigned char)));
+    memcpy(payload, data, dataLen);
+    return payload;
+}
+
 bool Image::initWithImageData(const unsigned char * data, ssize_t dataLen)
 {
     bool ret = false;
@@ -588,6 +707,9 @@ bool Image::initWithImageData(const unsigned char * data, ssize_t dataLen)
         case Format::ATITC:
             ret = initWithATITCData(unpackedData, unpackedLen);
             break;
+        case Format::KTX2:
+            ret = initWithKTX2Data(unpackedData, unpackedLen);
+            break;
         default:
             {
                 // load and detect image format
@@ -658,6 +780,16 @@ bool Image::isATITC(const unsigned char *data, ssize_t /*dataLen*/)
     return true;
 }
 
+bool Image::isKTX2(const unsigned char *data, ssize_t dataLen)
+{
+    if (static_cast<size_t>(dataLen) < sizeof(KTX2TexHeader))
+    {
+        return false;
+    }
+
+    return memcmp(data, KTX2_IDENTIFIER, sizeof(KTX2_IDENTIFIER)) == 0;
+}
+
 bool Image::isJpg(const unsigned char * data, ssize_t dataLen)
 {
     if (dataLen <= 4)
@@ -741,6 +873,11 @@ Image::Format Image::detectFormat(const unsigned char * data, ssize_t dataLen)
     {
         return Format::S3TC;
     }
+    else if (isKTX2(data, dataLen))
+    {
+        // before ATITC, which accepts any KTX identifier
+        return Format::KTX2;
+    }
     else if (isATITC(data, dataLen))
     {
         return Format::ATITC;
@@ -1597,8 +1734,7 @@ bool Image::initWithPVRv3Data(const unsigned char * data, ssize_t dataLen)
     int blockSize = 0, widthBlocks = 0, heightBlocks = 0;
     
     _dataLen = dataLen - (sizeof(PVRv3TexHeader) + header->metadataLength);
-    _data = static_cast<unsigned char*>(malloc(_dataLen * sizeof(unsigned char)));
-    memcpy(_data, static_cast<const unsigned char*>(data) + sizeof(PVRv3TexHeader) + header->metadataLength, _dataLen);
+    _data = takePayload(static_cast<const unsigned char*>(data) + sizeof(PVRv3TexHeader) + header->metadataLength, _dataLen);
     
     _numberOfMipmaps = header->numberOfMipmaps;
     CCASSERT(_numberOfMipmaps < MIPMAP_MAX, "Image: Maximum number of mimpaps reached. Increase the CC_MIPMAP_MAX value");
@@ -1729,8 +1865,7 @@ bool Image::initWithETCData(const unsigned char * data, ssize_t dataLen)
 #ifdef GL_ETC1_RGB8_OES
         _renderFormat = Texture2D::PixelFormat::ETC;
         _dataLen = dataLen - ETC_PKM_HEADER_SIZE;
-        _data = static_cast<unsigned char*>(malloc(_dataLen * sizeof(unsigned char)));
-        memcpy(_data, static_cast<const unsigned char*>(data) + ETC_PKM_HEADER_SIZE, _dataLen);
+        _data = takePayload(static_cast<const unsigned char*>(data) + ETC_PKM_HEADER_SIZE, _dataLen);
         return true;
 #else
         CC_UNUSED_PARAM(dataLen);
@@ -1856,8 +1991,8 @@ bool Image::initWithS3TCData(const unsigned char * data, ssize_t dataLen)
     /* load the .dds file */
     
     S3TCTexHeader *header = (S3TCTexHeader *)data;
-    unsigned char *pixelData = static_cast<unsigned char*>(malloc((dataLen - sizeof(S3TCTexHeader)) * sizeof(unsigned char)));
-    memcpy((void *)pixelData, data + sizeof(S3TCTexHeader), dataLen - sizeof(S3TCTexHeader));
+    // read only, s3tc_decode() doesn't write to it
+    unsigned char *pixelData = const_cast<unsigned char*>(data) + sizeof(S3TCTexHeader);
     
     _width = header->ddsd.width;
     _height = header->ddsd.height;
@@ -1873,8 +2008,7 @@ bool Image::initWithS3TCData(const unsigned char * data, ssize_t dataLen)
     if (Configuration::getInstance()->supportsS3TC())  //compressed data length
     {
         _dataLen = dataLen - sizeof(S3TCTexHeader);
-        _data = static_cast<unsigned char*>(malloc(_dataLen * sizeof(unsigned char)));
-        memcpy((void *)_data,(void *)pixelData , _dataLen);
+        _data = takePayload(pixelData, _dataLen);
     }
     else                                               //decompressed data length
     {
@@ -1964,11 +2098,6 @@ bool Image::initWithS3TCData(const unsigned char * data, ssize_t dataLen)
     
     /* end load the mipmaps */
     
-    if (pixelData != nullptr)
-    {
-        free(pixelData);
-    };
-    
     return true;
 }
 
@@ -2007,8 +2136,7 @@ bool Image::initWithATITCData(const unsigned char *data, ssize_t dataLen)
     if (Configuration::getInstance()->supportsATITC())  //compressed data length
     {
         _dataLen = dataLen - sizeof(ATITCTexHeader) - header->bytesOfKeyValueData - 4;
-        _data = static_cast<unsigned char*>(malloc(_dataLen * sizeof(unsigned char)));
-        memcpy((void *)_data,(void *)pixelData , _dataLen);
+        _data = takePayload(pixelData, _dataLen);
     }
     else                                               //decompressed data length
     {
@@ -2102,6 +2230,177 @@ bool Image::initWithATITCData(const unsigned char *data, ssize_t dataLen)
     return true;
 }
 
+bool Image::initWithKTX2Data(const unsigned char *data, ssize_t dataLen)
+{
+    const KTX2TexHeader *header = reinterpret_cast<const KTX2TexHeader *>(data);
+
+    if (header->vkFormat == KTX2_VK_FORMAT_UNDEFINED)
+    {
+        return initWithBasisKTX2Data(data, dataLen);
+    }
+
+    if (header->supercompressionScheme != 0)
+    {
+        CCLOG("cocos2d: WARNING: KTX2 supercompression scheme %u is only supported for Basis Universal textures", header->supercompressionScheme);
+        return false;
+    }
+
+    if (header->pixelDepth > 1 || header->layerCount > 1 || header->faceCount != 1)
+    {
+        CCLOG("cocos2d: WARNING: only 2D KTX2 textures are supported");
+        return false;
+    }
+
+    const KTX2FormatInfo *formatInfo = nullptr;
+    for (const auto& info : ktx2_formats)
+    {
+        if (info.vkFormat == header->vkFormat)
+        {
+            formatInfo = &info;
+            break;
+        }
+    }
+
+    auto configuration = Configuration::getInstance();
+    if (formatInfo == nullptr
+        || (formatInfo->supported && !(configuration->*formatInfo->supported)())
+        || Texture2D::getPixelFormatInfoMap().find(formatInfo->pixelFormat) == Texture2D::getPixelFormatInfoMap().end())
+    {
+        CCLOG("cocos2d: WARNING: Unsupported KTX2 vkFormat: %u. Re-encode it with a format the device supports or with Basis Universal", header->vkFormat);
+        return false;
+    }
+
+    int levelCount = MAX(1, static_cast<int>(header->levelCount));
+    CCASSERT(levelCount < MIPMAP_MAX, "Image: Maximum number of mimpaps reached. Increase the CC_MIPMAP_MAX value");
+    if (static_cast<size_t>(dataLen) < sizeof(KTX2TexHeader) + levelCount * sizeof(KTX2LevelIndex))
+    {
+        return false;
+    }
+
+    // the levels are stored smallest first, the payload is the range covering all of them
+    const KTX2LevelIndex *levels = reinterpret_cast<const KTX2LevelIndex *>(data + sizeof(KTX2TexHeader));
+    uint64_t begin = levels[0].byteOffset;
+    uint64_t end = 0;
+    for (int i = 0; i < levelCount; ++i)
+    {
+        begin = MIN(begin, levels[i].byteOffset);
+        end = MAX(end, levels[i].byteOffset + levels[i].byteLength);
+    }
+    if (end > static_cast<uint64_t>(dataLen) || begin >= end)
+    {
+        CCLOG("cocos2d: WARNING: Invalid KTX2 level index");
+        return false;
+    }
+
+    _renderFormat = formatInfo->pixelFormat;
+    _width = header->pixelWidth;
+    _height = header->pixelHeight;
+    _dataLen = static_cast<ssize_t>(end - begin);
+    _data = takePayload(data + begin, _dataLen);
+    _numberOfMipmaps = levelCount;
+    for (int i = 0; i < levelCount; ++i)
+    {
+        _mipmaps[i].address = _data + (levels[i].byteOffset - begin);
+        _mipmaps[i].len = static_cast<int>(levels[i].byteLength);
+    }
+
+    return true;
+}
+
+#if CC_USE_BASIS_UNIVERSAL
+bool Image::initWithBasisKTX2Data(const unsigned char *data, ssize_t dataLen)
+{
+    static std::once_flag s_transcoderInit;
+    std::call_once(s_transcoderInit, []() {
+        basist::basisu_transcoder_init();
+    });
+
+    // the transcoder keeps pointers to data, it only lives during the initialization
+    basist::ktx2_transcoder transcoder;
+    if (!transcoder.init(data, static_cast<uint32_t>(dataLen)) || !transcoder.start_transcoding())
+    {
+        CCLOG("cocos2d: WARNING: Invalid Basis Universal KTX2 texture");
+        return false;
+    }
+
+    _width = transcoder.get_width();
+    _height = transcoder.get_height();
+    bool alpha = transcoder.get_has_alpha();
+    bool squarePOT = _width == _height && ccNextPOT(_width) == _width;
+
+    // the best format the device supports, ETC1 and PVRTC1 only when they can hold the texture
+    struct Target
+    {
+        bool supported;
+        basist::transcoder_texture_format format;
+        Texture2D::PixelFormat pixelFormat;
+    };
+    auto configuration = Configuration::getInstance();
+    const Target targets[] = {
+        { configuration->supportsS3TC(), alpha ? basist::transcoder_texture_format::cTFBC3_RGBA : basist::transcoder_texture_format::cTFBC1_RGB,
+            alpha ? Texture2D::PixelFormat::S3TC_DXT5 : Texture2D::PixelFormat::S3TC_DXT1 },
+        { configuration->supportsETC() && !alpha, basist::transcoder_texture_format::cTFETC1_RGB, Texture2D::PixelFormat::ETC },
+        { configuration->supportsPVRTC() && squarePOT, alpha ? basist::transcoder_texture_format::cTFPVRTC1_4_RGBA : basist::transcoder_texture_format::cTFPVRTC1_4_RGB,
+            alpha ? Texture2D::PixelFormat::PVRTC4A : Texture2D::PixelFormat::PVRTC4 },
+        { configuration->supportsATITC(), alpha ? basist::transcoder_texture_format::cTFATC_RGBA : basist::transcoder_texture_format::cTFATC_RGB,
+            alpha ? Texture2D::PixelFormat::ATC_INTERPOLATED_ALPHA : Texture2D::PixelFormat::ATC_RGB },
+        { true, basist::transcoder_texture_format::cTFRGBA32, Texture2D::PixelFormat::RGBA8888 },
+    };
+
+    const Target *target = nullptr;
+    for (const auto& candidate : targets)
+    {
+        if (candidate.supported && Texture2D::getPixelFormatInfoMap().find(candidate.pixelFormat) != Texture2D::getPixelFormatInfoMap().end())
+        {
+            target = &candidate;
+            break;
+        }
+    }
+
+    int levelCount = MIN(static_cast<int>(transcoder.get_levels()), MIPMAP_MAX - 1);
+    bool uncompressed = basist::basis_transcoder_format_is_uncompressed(target->format);
+    uint32_t bytesPerBlock = basist::basis_get_bytes_per_block_or_pixel(target->format);
+
+    // the sizes of the levels, in blocks or in pixels
+    uint32_t levelUnits[MIPMAP_MAX];
+    _dataLen = 0;
+    for (int i = 0; i < levelCount; ++i)
+    {
+        basist::ktx2_image_level_info info;
+        if (!transcoder.get_image_level_info(info, i, 0, 0))
+        {
+            return false;
+        }
+        levelUnits[i] = uncompressed ? info.m_orig_width * info.m_orig_height : info.m_total_blocks;
+        _dataLen += levelUnits[i] * bytesPerBlock;
+    }
+
+    _data = static_cast<unsigned char*>(malloc(_dataLen * sizeof(unsigned char)));
+    ssize_t offset = 0;
+    for (int i = 0; i < levelCount; ++i)
+    {
+        _mipmaps[i].address = _data + offset;
+        _mipmaps[i].len = static_cast<int>(levelUnits[i] * bytesPerBlock);
+        if (!transcoder.transcode_image_level(i, 0, 0, _mipmaps[i].address, levelUnits[i], target->format))
+        {
+            CCLOG("cocos2d: WARNING: Failed to transcode level %d of a Basis Universal KTX2 texture", i);
+            return false;
+        }
+        offset += _mipmaps[i].len;
+    }
+
+    _renderFormat = target->pixelFormat;
+    _numberOfMipmaps = levelCount;
+    return true;
+}
+#else
+bool Image::initWithBasisKTX2Data(const unsigned char * /*data*/, ssize_t /*dataLen*/)
+{
+    CCLOG("cocos2d: WARNING: Basis Universal KTX2 textures need the engine built with CC_USE_BASIS_UNIVERSAL");
+    return false;
+}
+#endif // CC_USE_BASIS_UNIVERSAL
+
 bool Image::initWithPVRData(const unsigned char * data, ssize_t dataLen)
 {
     return initWithPVRv2Data(data, dataLen) || initWithPVRv3Data(data, dataLen);
@@ -2451,12 +2750,7 @@ void Image::premultipliedAlpha()
 #else
     CCASSERT(_renderFormat == Texture2D::PixelFormat::RGBA8888, "The pixel format should be RGBA8888!");
     
-    unsigned int* fourBytes = (unsigned int*)_data;
-    for(int i = 0; i < _width * _height; i++)
-    {
-        unsigned char* p = _data + i * 4;
-        fourBytes[i] = CC_RGB_PREMULTIPLY_ALPHA(p[0], p[1], p[2], p[3]);
-    }
+    Texture2D::premultiplyAlphaRGBA8888(_data, (ssize_t)_width * _height * 4);
     
     _hasPremultipliedAlpha = true;
 #endif
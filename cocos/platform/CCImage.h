@@ -44,6 +44,8 @@ THE SOFTWARE.
 
 NS_CC_BEGIN
 
+class MappedFileData;
+
 /**
  * @addtogroup platform
  * @{
@@ -63,6 +65,7 @@ class CC_DLL Image : public Ref
 {
 public:
     friend class TextureCache;
+    friend class AutoPolygon;
     /**
      * @js ctor
      */
@@ -92,6 +95,8 @@ public:
         S3TC,
         //! ATITC
         ATITC,
+        //! KTX2, in a GPU format or Basis Universal supercompressed
+        KTX2,
         //! TGA
         TGA,
         //! Raw Data
@@ -175,6 +180,8 @@ protected:
     bool initWithETCData(const unsigned char * data, ssize_t dataLen);
     bool initWithS3TCData(const unsigned char * data, ssize_t dataLen);
     bool initWithATITCData(const unsigned char *data, ssize_t dataLen);
+    bool initWithKTX2Data(const unsigned char *data, ssize_t dataLen);
+    bool initWithBasisKTX2Data(const unsigned char *data, ssize_t dataLen);
     typedef struct sImageTGA tImageTGA;
     bool initWithTGAData(tImageTGA* tgaData);
 
@@ -205,6 +212,9 @@ protected:
     // false if we can't auto detect the image is premultiplied or not.
     bool _hasPremultipliedAlpha;
     std::string _filePath;
+    // the file the compressed payload of _data points into, see initWithMappedFileData()
+    MappedFileData* _mappedFile;
+    bool _dataMapped;
 
 
 protected:
@@ -220,6 +230,15 @@ protected:
      @return  true if loaded correctly.
      */
     bool initWithImageFileThreadSafe(const std::string& fullpath);
+
+    /*
+     @brief Initializes the image with the contents of a mapped file, and takes the ownership of it.
+     Compressed textures the hardware supports keep _data pointing into the mapping, uploaded
+     without any copy. The mapping is released right away for the other images.
+     */
+    bool initWithMappedFileData(MappedFileData* mappedFile);
+    // returns data if it belongs to _mappedFile, a malloc'ed copy otherwise
+    unsigned char* takePayload(const unsigned char* data, ssize_t dataLen);
     
     Format detectFormat(const unsigned char * data, ssize_t dataLen);
     bool isPng(const unsigned char * data, ssize_t dataLen);
@@ -230,6 +249,7 @@ protected:
     bool isEtc(const unsigned char * data, ssize_t dataLen);
     bool isS3TC(const unsigned char * data,ssize_t dataLen);
     bool isATITC(const unsigned char *data, ssize_t dataLen);
+    bool isKTX2(const unsigned char *data, ssize_t dataLen);
 };
 
 // end of platform group
@@ -173,12 +173,12 @@ Data Device::getTextureDataForText(const char * text, const FontDefinition& text
 
 void Device::setKeepScreenOn(bool value)
 {
-    JniHelper::callStaticVoidMethod(helperClassName, "setKeepScreenOn", value);
+    JniHelper::queueHelperCommand(JniHelper::HelperCommand::SET_KEEP_SCREEN_ON, value ? 1 : 0);
 }
 
 void Device::vibrate(float duration)
 {
-    JniHelper::callStaticVoidMethod(helperClassName, "vibrate", duration);
+    JniHelper::queueHelperCommand(JniHelper::HelperCommand::VIBRATE, 0, duration);
 }
 
 NS_CC_END
@@ -95,7 +95,8 @@ bool FileUtilsAndroid::init()
     std::string assetsPath(getApkPath());
     if (assetsPath.find("/obb/") != std::string::npos)
     {
-        obbfile = new ZipFile(assetsPath);
+        // the obb is indexed once, so its files are read without seeking and from any thread
+        obbfile = ZipFile::createWithIndex(assetsPath);
     }
 
     return FileUtils::init();
@@ -289,6 +290,9 @@ FileUtils::Status FileUtilsAndroid::getContents(const std::string& filename, Res
 
     string fullPath = fullPathForFilename(filename);
 
+    if (getContentsFromAssetPack(fullPath, buffer))
+        return FileUtils::Status::OK;
+
     if (fullPath[0] == '/')
         return FileUtils::getContents(fullPath, buffer);
 
@@ -333,6 +337,230 @@ FileUtils::Status FileUtilsAndroid::getContents(const std::string& filename, Res
     return FileUtils::Status::OK;
 }
 
+namespace
+{
+    // the buffer of an asset opened with AASSET_MODE_BUFFER, mapped when the asset isn't compressed in the apk
+    class AssetMappedFileData : public MappedFileData
+    {
+    public:
+        AssetMappedFileData(AAsset* asset)
+        : _asset(asset)
+        {
+            _bytes = static_cast<const unsigned char*>(AAsset_getBuffer(asset));
+            _size = AAsset_getLength(asset);
+        }
+
+        virtual ~AssetMappedFileData()
+        {
+            AAsset_close(_asset);
+        }
+
+    private:
+        AAsset* _asset;
+    };
+
+    // a file stored without compression in the obb, which stays mapped until the file utils are destroyed
+    class ObbMappedFileData : public MappedFileData
+    {
+    public:
+        ObbMappedFileData(const unsigned char* bytes, ssize_t size)
+        {
+            _bytes = bytes;
+            _size = size;
+        }
+    };
+
+    // a file compressed in the obb, inflated at once
+    class InflatedMappedFileData : public MappedFileData
+    {
+    public:
+        InflatedMappedFileData(unsigned char* bytes, ssize_t size)
+        {
+            _bytes = bytes;
+            _size = size;
+        }
+
+        virtual ~InflatedMappedFileData()
+        {
+            free(const_cast<unsigned char*>(_bytes));
+        }
+    };
+
+    // an asset of the apk, opened with AASSET_MODE_STREAMING
+    class AssetFileStream : public FileStream
+    {
+    public:
+        explicit AssetFileStream(AAsset* asset)
+        : _asset(asset)
+        , _size(static_cast<ssize_t>(AAsset_getLength64(asset)))
+        , _position(0)
+        {
+        }
+
+        virtual ~AssetFileStream()
+        {
+            AAsset_close(_asset);
+        }
+
+        virtual ssize_t read(void* buffer, size_t size) override
+        {
+            int readsize = AAsset_read(_asset, buffer, size);
+            if (readsize < 0)
+                return -1;
+            _position += readsize;
+            return readsize;
+        }
+
+        virtual bool seek(ssize_t offset, Origin origin) override
+        {
+            ssize_t base = origin == Origin::BEGIN ? 0 : (origin == Origin::CURRENT ? _position : _size);
+            ssize_t target = base + offset;
+            if (target < 0 || target > _size || AAsset_seek64(_asset, target, SEEK_SET) < 0)
+                return false;
+            _position = target;
+            return true;
+        }
+
+        virtual ssize_t tell() const override { return _position; }
+        virtual ssize_t getSize() const override { return _size; }
+
+    private:
+        AAsset* _asset;
+        ssize_t _size;
+        ssize_t _position;
+    };
+}
+
+MappedFileData* FileUtilsAndroid::mapFileContents(const std::string& filename) const
+{
+    static const std::string apkprefix("assets/");
+    if (filename.empty())
+        return nullptr;
+
+    string fullPath = fullPathForFilename(filename);
+
+    auto packData = mapAssetPackContents(fullPath);
+    if (packData)
+        return packData;
+
+    if (fullPath[0] == '/')
+        return FileUtils::mapFileContents(fullPath);
+
+    string relativePath = fullPath;
+    if (0 == fullPath.find(apkprefix))
+        relativePath = fullPath.substr(apkprefix.size());
+
+    // the stored files of the obb are mapped, the compressed ones are read
+    if (obbfile)
+    {
+        ssize_t size = 0;
+        auto bytes = obbfile->getStoredFileData(relativePath, &size);
+        if (bytes == nullptr || size == 0)
+            return nullptr;
+        return new (std::nothrow) ObbMappedFileData(bytes, size);
+    }
+
+    if (nullptr == assetmanager)
+        return nullptr;
+
+    AAsset* asset = AAssetManager_open(assetmanager, relativePath.data(), AASSET_MODE_BUFFER);
+    if (nullptr == asset)
+        return nullptr;
+
+    auto mapped = new (std::nothrow) AssetMappedFileData(asset);
+    if (mapped == nullptr)
+    {
+        AAsset_close(asset);
+        return nullptr;
+    }
+    if (mapped->getBytes() == nullptr)
+    {
+        delete mapped;
+        return nullptr;
+    }
+
+    return mapped;
+}
+
+FileStream* FileUtilsAndroid::openFileStream(const std::string& filename) const
+{
+    static const std::string apkprefix("assets/");
+    if (filename.empty())
+        return nullptr;
+
+    string fullPath = fullPathForFilename(filename);
+    if (fullPath.empty())
+        return nullptr;
+
+    auto packData = mapAssetPackContents(fullPath);
+    if (packData)
+        return FileStream::createWithMappedFileData(packData);
+
+    if (fullPath[0] == '/')
+        return FileUtils::openFileStream(fullPath);
+
+    string relativePath = fullPath;
+    if (0 == fullPath.find(apkprefix))
+        relativePath = fullPath.substr(apkprefix.size());
+
+    // the stored files of the obb are mapped, the compressed ones can't be streamed and are inflated
+    if (obbfile)
+    {
+        ssize_t size = 0;
+        auto bytes = obbfile->getStoredFileData(relativePath, &size);
+        if (bytes)
+            return FileStream::createWithMappedFileData(new (std::nothrow) ObbMappedFileData(bytes, size));
+
+        auto inflated = obbfile->getFileData(relativePath, &size);
+        if (inflated)
+        {
+            auto data = new (std::nothrow) InflatedMappedFileData(inflated, size);
+            if (data == nullptr)
+            {
+                free(inflated);
+                return nullptr;
+            }
+            return FileStream::createWithMappedFileData(data);
+        }
+    }
+
+    if (nullptr == assetmanager)
+        return nullptr;
+
+    AAsset* asset = AAssetManager_open(assetmanager, relativePath.data(), AASSET_MODE_STREAMING);
+    if (nullptr == asset)
+        return nullptr;
+
+    auto stream = new (std::nothrow) AssetFileStream(asset);
+    if (stream == nullptr)
+    {
+        AAsset_close(asset);
+    }
+    return stream;
+}
+
+bool FileUtilsAndroid::getFileLocation(const std::string& fullPath, const void** archive, size_t* offset) const
+{
+    static const std::string apkprefix("assets/");
+    if (FileUtils::getFileLocation(fullPath, archive, offset))
+        return true;
+
+    if (obbfile == nullptr || fullPath.empty() || fullPath[0] == '/')
+        return false;
+
+    string relativePath = fullPath;
+    if (0 == fullPath.find(apkprefix))
+        relativePath = fullPath.substr(apkprefix.size());
+
+    ssize_t position = obbfile->getFileOffset(relativePath);
+    if (position < 0)
+        return false;
+
+    *archive = obbfile;
+    *offset = static_cast<size_t>(position);
+    return true;
+}
+
 string FileUtilsAndroid::getWritablePath() const
 {
     // Fix for Nexus 10 (Android 4.2 multi-user environment)
@@ -67,6 +67,9 @@ public:
     virtual std::string getNewFilename(const std::string &filename) const override;
 
     virtual FileUtils::Status getContents(const std::string& filename, ResizableBuffer* buffer) override;
+    virtual MappedFileData* mapFileContents(const std::string& filename) const override;
+    virtual FileStream* openFileStream(const std::string& filename) const override;
+    virtual bool getFileLocation(const std::string& fullPath, const void** archive, size_t* offset) const override;
 
     virtual std::string getWritablePath() const override;
     virtual bool isAbsolutePath(const std::string& strPath) const override;
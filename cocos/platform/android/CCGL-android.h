@@ -65,6 +65,57 @@ extern PFNGLDELETEVERTEXARRAYSOESPROC glDeleteVertexArraysOESEXT;
 #define glBindVertexArrayOES glBindVertexArrayOESEXT
 #define glDeleteVertexArraysOES glDeleteVertexArraysOESEXT
 
+// GL_EXT_map_buffer_range, used by the renderer's ring buffer
+extern PFNGLMAPBUFFERRANGEEXTPROC glMapBufferRangeEXTEXT;
+
+#define glMapBufferRange            glMapBufferRangeEXTEXT
+#define GL_MAP_WRITE_BIT            GL_MAP_WRITE_BIT_EXT
+#define GL_MAP_INVALIDATE_RANGE_BIT GL_MAP_INVALIDATE_RANGE_BIT_EXT
+#define GL_MAP_INVALIDATE_BUFFER_BIT GL_MAP_INVALIDATE_BUFFER_BIT_EXT
+#define GL_MAP_UNSYNCHRONIZED_BIT   GL_MAP_UNSYNCHRONIZED_BIT_EXT
+
+// GL_EXT_instanced_arrays, used by MeshCommand's instanced draws
+extern PFNGLVERTEXATTRIBDIVISOREXTPROC glVertexAttribDivisorEXTEXT;
+extern PFNGLDRAWELEMENTSINSTANCEDEXTPROC glDrawElementsInstancedEXTEXT;
+
+#define glVertexAttribDivisor       glVertexAttribDivisorEXTEXT
+#define glDrawElementsInstanced     glDrawElementsInstancedEXTEXT
+
+// GL_EXT_disjoint_timer_query, used by the renderer's GPU timing
+extern PFNGLGENQUERIESEXTPROC glGenQueriesEXTEXT;
+extern PFNGLDELETEQUERIESEXTPROC glDeleteQueriesEXTEXT;
+extern PFNGLQUERYCOUNTEREXTPROC glQueryCounterEXTEXT;
+extern PFNGLGETQUERYOBJECTIVEXTPROC glGetQueryObjectivEXTEXT;
+extern PFNGLGETQUERYOBJECTUI64VEXTPROC glGetQueryObjectui64vEXTEXT;
+
+#define glGenQueries                glGenQueriesEXTEXT
+#define glDeleteQueries             glDeleteQueriesEXTEXT
+#define glQueryCounter              glQueryCounterEXTEXT
+#define glGetQueryObjectiv          glGetQueryObjectivEXTEXT
+#define glGetQueryObjectui64v       glGetQueryObjectui64vEXTEXT
+#define GL_TIMESTAMP                GL_TIMESTAMP_EXT
+#define GL_QUERY_RESULT             GL_QUERY_RESULT_EXT
+#define GL_QUERY_RESULT_AVAILABLE   GL_QUERY_RESULT_AVAILABLE_EXT
+
+// GL_EXT_occlusion_query_boolean, used by the renderer's occlusion culling
+extern PFNGLBEGINQUERYEXTPROC glBeginQueryEXTEXT;
+extern PFNGLENDQUERYEXTPROC glEndQueryEXTEXT;
+extern PFNGLGETQUERYOBJECTUIVEXTPROC glGetQueryObjectuivEXTEXT;
+
+#define glBeginQuery                glBeginQueryEXTEXT
+#define glEndQuery                  glEndQueryEXTEXT
+#define glGetQueryObjectuiv         glGetQueryObjectuivEXTEXT
+#define GL_ANY_SAMPLES_PASSED       GL_ANY_SAMPLES_PASSED_EXT
+
+// GL_OES_get_program_binary, used by the program binary cache
+extern PFNGLGETPROGRAMBINARYOESPROC glGetProgramBinaryOESEXT;
+extern PFNGLPROGRAMBINARYOESPROC glProgramBinaryOESEXT;
+
+#define glGetProgramBinary          glGetProgramBinaryOESEXT
+#define glProgramBinary             glProgramBinaryOESEXT
+#define GL_PROGRAM_BINARY_LENGTH    GL_PROGRAM_BINARY_LENGTH_OES
+#define GL_NUM_PROGRAM_BINARY_FORMATS GL_NUM_PROGRAM_BINARY_FORMATS_OES
+
 
 #endif // CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID
 
@@ -24,6 +24,7 @@ THE SOFTWARE.
 package org.cocos2dx.lib;
 
 import android.app.Activity;
+import android.content.ComponentCallbacks2;
 import android.content.Context;
 import android.content.Intent;
 import android.content.pm.ApplicationInfo;
@@ -202,6 +203,15 @@ public abstract class Cocos2dxActivity extends Activity implements Cocos2dxHelpe
         Cocos2dxEngineDataManager.pause();
     }
     
+    @Override
+    public void onTrimMemory(final int level) {
+        super.onTrimMemory(level);
+        // evict unused textures before the system kills the process
+        if (level >= ComponentCallbacks2.TRIM_MEMORY_RUNNING_LOW && mGLSurfaceView != null) {
+            mGLSurfaceView.onTrimMemory(level);
+        }
+    }
+
     @Override
     protected void onDestroy() {
         Cocos2dxAudioFocusManager.unregisterAudioFocusListener(this);
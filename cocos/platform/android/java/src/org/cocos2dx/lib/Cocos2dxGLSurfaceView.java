@@ -23,13 +23,16 @@ THE SOFTWARE.
  ****************************************************************************/
 package org.cocos2dx.lib;
 
+import android.annotation.TargetApi;
 import android.app.Activity;
 import android.content.Context;
 import android.opengl.GLSurfaceView;
+import android.os.Build;
 import android.os.Handler;
 import android.os.Message;
 import android.util.AttributeSet;
 import android.util.Log;
+import android.view.Choreographer;
 import android.view.KeyEvent;
 import android.view.MotionEvent;
 import android.view.View;
@@ -61,6 +64,11 @@ public class Cocos2dxGLSurfaceView extends GLSurfaceView {
     private boolean mSoftKeyboardShown = false;
     private boolean mMultipleTouchEnabled = true;
 
+    // frame pacing: render every mFramePacingVsyncs vsyncs, continuously when it is 1
+    private boolean mResumed = false;
+    private int mFramePacingVsyncs = 1;
+    private FramePacer mFramePacer;
+
     public boolean isSoftKeyboardShown() {
         return mSoftKeyboardShown;
     }
@@ -152,6 +160,52 @@ public class Cocos2dxGLSurfaceView extends GLSurfaceView {
         });
     }
 
+    public static boolean isFramePacingSupported() {
+        return Build.VERSION.SDK_INT >= Build.VERSION_CODES.JELLY_BEAN;
+    }
+
+    /**
+     * Called by Cocos2dxRenderer when the animation interval changes, on the GL thread.
+     */
+    public void setFramePacingInterval(final long intervalInNanoSeconds) {
+        if (!Cocos2dxGLSurfaceView.isFramePacingSupported()) {
+            return;
+        }
+
+        this.post(new Runnable() {
+            @Override
+            public void run() {
+                float refreshRate = ((Activity) Cocos2dxGLSurfaceView.this.getContext()).getWindowManager().getDefaultDisplay().getRefreshRate();
+                if (refreshRate <= 0) {
+                    refreshRate = 60;
+                }
+                final double vsyncInterval = 1000000000.0 / refreshRate;
+                Cocos2dxGLSurfaceView.this.mFramePacingVsyncs = Math.max(1, (int) Math.round(intervalInNanoSeconds / vsyncInterval));
+                Cocos2dxGLSurfaceView.this.updateFramePacing();
+            }
+        });
+    }
+
+    // Must be called on the UI thread
+    private void updateFramePacing() {
+        if (!this.mResumed) {
+            return;
+        }
+
+        if (this.mFramePacingVsyncs > 1) {
+            if (this.mFramePacer == null) {
+                this.mFramePacer = new FramePacer();
+            }
+            this.setRenderMode(RENDERMODE_WHEN_DIRTY);
+            this.mFramePacer.start();
+        } else {
+            if (this.mFramePacer != null) {
+                this.mFramePacer.stop();
+            }
+            this.setRenderMode(RENDERMODE_CONTINUOUSLY);
+        }
+    }
+
     public void setCocos2dxRenderer(final Cocos2dxRenderer renderer) {
         this.mCocos2dxRenderer = renderer;
         this.setRenderer(this.mCocos2dxRenderer);
@@ -180,7 +234,9 @@ public class Cocos2dxGLSurfaceView extends GLSurfaceView {
     @Override
     public void onResume() {
         super.onResume();
+        this.mResumed = true;
         this.setRenderMode(RENDERMODE_CONTINUOUSLY);
+        this.updateFramePacing();
         this.queueEvent(new Runnable() {
             @Override
             public void run() {
@@ -197,10 +253,23 @@ public class Cocos2dxGLSurfaceView extends GLSurfaceView {
                 Cocos2dxGLSurfaceView.this.mCocos2dxRenderer.handleOnPause();
             }
         });
+        this.mResumed = false;
+        if (this.mFramePacer != null) {
+            this.mFramePacer.stop();
+        }
         this.setRenderMode(RENDERMODE_WHEN_DIRTY);
         //super.onPause();
     }
 
+    public void onTrimMemory(final int level) {
+        this.queueEvent(new Runnable() {
+            @Override
+            public void run() {
+                Cocos2dxGLSurfaceView.this.mCocos2dxRenderer.handleOnTrimMemory(level);
+            }
+        });
+    }
+
     @Override
     public boolean onTouchEvent(final MotionEvent pMotionEvent) {
         // these data are used in ACTION_MOVE and ACTION_CANCEL
@@ -471,4 +540,42 @@ public class Cocos2dxGLSurfaceView extends GLSurfaceView {
         sb.append("]");
         Log.d(Cocos2dxGLSurfaceView.TAG, sb.toString());
     }
+
+    // ===========================================================
+    // Inner and Anonymous Classes
+    // ===========================================================
+
+    /**
+     * Requests a frame every mFramePacingVsyncs vsyncs, so the frames are presented at a regular pace
+     * instead of sleeping in onDrawFrame.
+     */
+    @TargetApi(Build.VERSION_CODES.JELLY_BEAN)
+    private class FramePacer implements Choreographer.FrameCallback {
+        private boolean mPosted = false;
+        private int mVsyncCount = 0;
+
+        public void start() {
+            if (!this.mPosted) {
+                this.mPosted = true;
+                this.mVsyncCount = 0;
+                Choreographer.getInstance().postFrameCallback(this);
+            }
+        }
+
+        public void stop() {
+            if (this.mPosted) {
+                this.mPosted = false;
+                Choreographer.getInstance().removeFrameCallback(this);
+            }
+        }
+
+        @Override
+        public void doFrame(final long frameTimeNanos) {
+            if (++this.mVsyncCount >= Cocos2dxGLSurfaceView.this.mFramePacingVsyncs) {
+                this.mVsyncCount = 0;
+                Cocos2dxGLSurfaceView.this.requestRender();
+            }
+            Choreographer.getInstance().postFrameCallback(this);
+        }
+    }
 }
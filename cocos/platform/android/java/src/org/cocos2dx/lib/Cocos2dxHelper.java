@@ -59,6 +59,8 @@ import java.io.FilenameFilter;
 import java.io.UnsupportedEncodingException;
 import java.lang.reflect.InvocationTargetException;
 import java.lang.reflect.Method;
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
 import java.util.LinkedHashSet;
 import java.util.Locale;
 import java.util.Map;
@@ -73,6 +75,19 @@ public class Cocos2dxHelper {
     private static final int RUNNABLES_PER_FRAME = 5;
     private static final String TAG = Cocos2dxHelper.class.getSimpleName();
 
+    // the commands of JniHelper::HelperCommand, in the same order
+    private static final int COMMAND_VIBRATE = 0;
+    private static final int COMMAND_SET_KEEP_SCREEN_ON = 1;
+    private static final int COMMAND_SET_BACKGROUND_MUSIC_VOLUME = 2;
+    private static final int COMMAND_SET_EFFECTS_VOLUME = 3;
+    private static final int COMMAND_PAUSE_EFFECT = 4;
+    private static final int COMMAND_RESUME_EFFECT = 5;
+    private static final int COMMAND_STOP_EFFECT = 6;
+    private static final int COMMAND_PAUSE_ALL_EFFECTS = 7;
+    private static final int COMMAND_RESUME_ALL_EFFECTS = 8;
+    private static final int COMMAND_STOP_ALL_EFFECTS = 9;
+    private static final int COMMAND_SIZE = 12;
+
     // ===========================================================
     // Fields
     // ===========================================================
@@ -439,6 +454,54 @@ public class Cocos2dxHelper {
         Cocos2dxHelper.getSound().stopAllEffects();
     }
 
+    /**
+     * Runs the calls queued by JniHelper::queueHelperCommand(), each one is the command, an int and a float.
+     */
+    public static void runCommands(final ByteBuffer commands, final int count) {
+        commands.order(ByteOrder.nativeOrder());
+        for (int i = 0; i < count; i++) {
+            final int offset = i * Cocos2dxHelper.COMMAND_SIZE;
+            final int intValue = commands.getInt(offset + 4);
+            final float floatValue = commands.getFloat(offset + 8);
+
+            switch (commands.getInt(offset)) {
+                case COMMAND_VIBRATE:
+                    Cocos2dxHelper.vibrate(floatValue);
+                    break;
+                case COMMAND_SET_KEEP_SCREEN_ON:
+                    Cocos2dxHelper.setKeepScreenOn(intValue != 0);
+                    break;
+                case COMMAND_SET_BACKGROUND_MUSIC_VOLUME:
+                    Cocos2dxHelper.setBackgroundMusicVolume(floatValue);
+                    break;
+                case COMMAND_SET_EFFECTS_VOLUME:
+                    Cocos2dxHelper.setEffectsVolume(floatValue);
+                    break;
+                case COMMAND_PAUSE_EFFECT:
+                    Cocos2dxHelper.pauseEffect(intValue);
+                    break;
+                case COMMAND_RESUME_EFFECT:
+                    Cocos2dxHelper.resumeEffect(intValue);
+                    break;
+                case COMMAND_STOP_EFFECT:
+                    Cocos2dxHelper.stopEffect(intValue);
+                    break;
+                case COMMAND_PAUSE_ALL_EFFECTS:
+                    Cocos2dxHelper.pauseAllEffects();
+                    break;
+                case COMMAND_RESUME_ALL_EFFECTS:
+                    Cocos2dxHelper.resumeAllEffects();
+                    break;
+                case COMMAND_STOP_ALL_EFFECTS:
+                    Cocos2dxHelper.stopAllEffects();
+                    break;
+                default:
+                    Log.e(TAG, "Unknown command " + commands.getInt(offset));
+                    break;
+            }
+        }
+    }
+
     static void setAudioFocus(boolean isAudioFocus) {
         sCocos2dMusic.setAudioFocus(isAudioFocus);
         getSound().setAudioFocus(isAudioFocus);
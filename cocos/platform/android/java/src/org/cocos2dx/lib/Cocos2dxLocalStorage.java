@@ -51,6 +51,11 @@ public class Cocos2dxLocalStorage {
             TABLE_NAME = tableName;
             mDatabaseOpenHelper = new DBOpenHelper(Cocos2dxActivity.getContext());
             mDatabase = mDatabaseOpenHelper.getWritableDatabase();
+            try {
+                mDatabase.enableWriteAheadLogging();
+            } catch (Exception e) {
+                e.printStackTrace();
+            }
             return true;
         }
         return false;
@@ -58,6 +63,9 @@ public class Cocos2dxLocalStorage {
     
     public static void destroy() {
         if (mDatabase != null) {
+            while (mBatchDepth > 0) {
+                commitBatch();
+            }
             mDatabase.close();
         }
     }
@@ -109,6 +117,29 @@ public class Cocos2dxLocalStorage {
             e.printStackTrace();
         }
     }
+
+    private static int mBatchDepth = 0;
+
+    public static void beginBatch() {
+        try {
+            if (mBatchDepth++ == 0) {
+                mDatabase.beginTransaction();
+            }
+        } catch (Exception e) {
+            e.printStackTrace();
+        }
+    }
+
+    public static void commitBatch() {
+        try {
+            if (mBatchDepth > 0 && --mBatchDepth == 0) {
+                mDatabase.setTransactionSuccessful();
+                mDatabase.endTransaction();
+            }
+        } catch (Exception e) {
+            e.printStackTrace();
+        }
+    }
     
 
     /**
@@ -25,6 +25,9 @@ package org.cocos2dx.lib;
 
 import android.opengl.GLSurfaceView;
 
+import java.nio.ByteBuffer;
+import java.nio.ByteOrder;
+
 import javax.microedition.khronos.egl.EGLConfig;
 import javax.microedition.khronos.opengles.GL10;
 public class Cocos2dxRenderer implements GLSurfaceView.Renderer {
@@ -34,6 +37,20 @@ public class Cocos2dxRenderer implements GLSurfaceView.Renderer {
 
     private final static long NANOSECONDSPERSECOND = 1000000000L;
     private final static long NANOSECONDSPERMICROSECOND = 1000000L;
+    // how often the temperature level of the game service is read
+    private final static long THERMALCHECKINTERVAL = 5 * Cocos2dxRenderer.NANOSECONDSPERSECOND;
+
+    // the types of the input events, in sync with TouchesJni.cpp
+    private final static int INPUTEVENT_TOUCHES_BEGIN = 0;
+    private final static int INPUTEVENT_TOUCHES_END = 1;
+    private final static int INPUTEVENT_TOUCHES_MOVE = 2;
+    private final static int INPUTEVENT_TOUCHES_CANCEL = 3;
+    private final static int INPUTEVENT_KEY = 4;
+    // an event is its type and its number of entries, then an id, an x and a y per entry
+    private final static int INPUTEVENT_HEADER_SIZE = 8;
+    private final static int INPUTEVENT_ENTRY_SIZE = 12;
+    // the buffer is sent before the end of the frame if it's full
+    private final static int INPUTEVENTS_CAPACITY = 16 * 1024;
 
     // The final animation interval which is used in 'onDrawFrame'
     private static long sAnimationInterval = (long) (1.0f / 60f * Cocos2dxRenderer.NANOSECONDSPERSECOND);
@@ -43,9 +60,13 @@ public class Cocos2dxRenderer implements GLSurfaceView.Renderer {
     // ===========================================================
 
     private long mLastTickInNanoSeconds;
+    private long mLastThermalCheckInNanoSeconds;
+    private int mThermalState = 0;
     private int mScreenWidth;
     private int mScreenHeight;
     private boolean mNativeInitCompleted = false;
+    // the input events of the frame, written on the GL thread and sent to the native code in a single call
+    private final ByteBuffer mInputEvents = ByteBuffer.allocateDirect(Cocos2dxRenderer.INPUTEVENTS_CAPACITY).order(ByteOrder.nativeOrder());
 
     // ===========================================================
     // Constructors
@@ -57,6 +78,11 @@ public class Cocos2dxRenderer implements GLSurfaceView.Renderer {
 
     public static void setAnimationInterval(float interval) {
         sAnimationInterval = (long) (interval * Cocos2dxRenderer.NANOSECONDSPERSECOND);
+
+        final Cocos2dxGLSurfaceView view = Cocos2dxGLSurfaceView.getInstance();
+        if (view != null) {
+            view.setFramePacingInterval(sAnimationInterval);
+        }
     }
 
     public void setScreenWidthAndHeight(final int surfaceWidth, final int surfaceHeight) {
@@ -87,7 +113,14 @@ public class Cocos2dxRenderer implements GLSurfaceView.Renderer {
          * since onDrawFrame() was called by system 60 times per second by default.
          */
 
-        if (Cocos2dxRenderer.sAnimationInterval <= 1.0f / 60f * Cocos2dxRenderer.NANOSECONDSPERSECOND) {
+        this.checkThermalState();
+        this.flushInputEvents();
+
+        /*
+         * With Choreographer the surface view requests the frames on vsync, at the animation interval.
+         */
+        if (Cocos2dxGLSurfaceView.isFramePacingSupported() ||
+            Cocos2dxRenderer.sAnimationInterval <= 1.0f / 60f * Cocos2dxRenderer.NANOSECONDSPERSECOND) {
             Cocos2dxRenderer.nativeRender();
         } else {
             final long now = System.nanoTime();
@@ -111,39 +144,94 @@ public class Cocos2dxRenderer implements GLSurfaceView.Renderer {
     // Methods
     // ===========================================================
 
-    private static native void nativeTouchesBegin(final int id, final float x, final float y);
-    private static native void nativeTouchesEnd(final int id, final float x, final float y);
-    private static native void nativeTouchesMove(final int[] ids, final float[] xs, final float[] ys);
-    private static native void nativeTouchesCancel(final int[] ids, final float[] xs, final float[] ys);
-    private static native boolean nativeKeyEvent(final int keyCode,boolean isPressed);
+    private void checkThermalState() {
+        final long now = System.nanoTime();
+        if (now - this.mLastThermalCheckInNanoSeconds < Cocos2dxRenderer.THERMALCHECKINTERVAL) {
+            return;
+        }
+        this.mLastThermalCheckInNanoSeconds = now;
+
+        final int state = Cocos2dxHelper.getTemperature();
+        if (state >= 0 && state != this.mThermalState) {
+            this.mThermalState = state;
+            Cocos2dxRenderer.nativeOnThermalStateChanged(state);
+        }
+    }
+
+    private boolean beginInputEvent(final int type, final int entryCount) {
+        final int size = Cocos2dxRenderer.INPUTEVENT_HEADER_SIZE + entryCount * Cocos2dxRenderer.INPUTEVENT_ENTRY_SIZE;
+        if (size > Cocos2dxRenderer.INPUTEVENTS_CAPACITY) {
+            return false;
+        }
+        if (this.mInputEvents.remaining() < size) {
+            this.flushInputEvents();
+        }
+        this.mInputEvents.putInt(type).putInt(entryCount);
+        return true;
+    }
+
+    private void putInputEventEntry(final int id, final float x, final float y) {
+        this.mInputEvents.putInt(id).putFloat(x).putFloat(y);
+    }
+
+    private void queueTouches(final int type, final int[] ids, final float[] xs, final float[] ys) {
+        if (this.beginInputEvent(type, ids.length)) {
+            for (int i = 0; i < ids.length; i++) {
+                this.putInputEventEntry(ids[i], xs[i], ys[i]);
+            }
+        }
+    }
+
+    private void flushInputEvents() {
+        if (this.mInputEvents.position() > 0) {
+            Cocos2dxRenderer.nativeHandleInputEvents(this.mInputEvents, this.mInputEvents.position());
+            this.mInputEvents.clear();
+        }
+    }
+
+    private static native void nativeHandleInputEvents(final ByteBuffer events, final int size);
     private static native void nativeRender();
     private static native void nativeInit(final int width, final int height);
     private static native void nativeOnSurfaceChanged(final int width, final int height);
     private static native void nativeOnPause();
     private static native void nativeOnResume();
+    private static native void nativeOnTrimMemory(final int level);
+    private static native void nativeOnThermalStateChanged(final int state);
 
+    /*
+     * The input events are queued and sent to the native code at the beginning of the next frame,
+     * a frame crosses JNI once for all of them.
+     */
     public void handleActionDown(final int id, final float x, final float y) {
-        Cocos2dxRenderer.nativeTouchesBegin(id, x, y);
+        if (this.beginInputEvent(Cocos2dxRenderer.INPUTEVENT_TOUCHES_BEGIN, 1)) {
+            this.putInputEventEntry(id, x, y);
+        }
     }
 
     public void handleActionUp(final int id, final float x, final float y) {
-        Cocos2dxRenderer.nativeTouchesEnd(id, x, y);
+        if (this.beginInputEvent(Cocos2dxRenderer.INPUTEVENT_TOUCHES_END, 1)) {
+            this.putInputEventEntry(id, x, y);
+        }
     }
 
     public void handleActionCancel(final int[] ids, final float[] xs, final float[] ys) {
-        Cocos2dxRenderer.nativeTouchesCancel(ids, xs, ys);
+        this.queueTouches(Cocos2dxRenderer.INPUTEVENT_TOUCHES_CANCEL, ids, xs, ys);
     }
 
     public void handleActionMove(final int[] ids, final float[] xs, final float[] ys) {
-        Cocos2dxRenderer.nativeTouchesMove(ids, xs, ys);
+        this.queueTouches(Cocos2dxRenderer.INPUTEVENT_TOUCHES_MOVE, ids, xs, ys);
     }
 
     public void handleKeyDown(final int keyCode) {
-        Cocos2dxRenderer.nativeKeyEvent(keyCode, true);
+        if (this.beginInputEvent(Cocos2dxRenderer.INPUTEVENT_KEY, 1)) {
+            this.putInputEventEntry(keyCode, 1, 0);
+        }
     }
 
     public void handleKeyUp(final int keyCode) {
-        Cocos2dxRenderer.nativeKeyEvent(keyCode, false);
+        if (this.beginInputEvent(Cocos2dxRenderer.INPUTEVENT_KEY, 1)) {
+            this.putInputEventEntry(keyCode, 0, 0);
+        }
     }
 
     public void handleOnPause() {
@@ -156,6 +244,7 @@ public class Cocos2dxRenderer implements GLSurfaceView.Renderer {
         if (! mNativeInitCompleted)
             return;
 
+        this.flushInputEvents();
         Cocos2dxHelper.onEnterBackground();
         Cocos2dxRenderer.nativeOnPause();
     }
@@ -165,15 +254,24 @@ public class Cocos2dxRenderer implements GLSurfaceView.Renderer {
         Cocos2dxRenderer.nativeOnResume();
     }
 
+    public void handleOnTrimMemory(final int level) {
+        if (! mNativeInitCompleted)
+            return;
+
+        Cocos2dxRenderer.nativeOnTrimMemory(level);
+    }
+
     private static native void nativeInsertText(final String text);
     private static native void nativeDeleteBackward();
     private static native String nativeGetContentText();
 
     public void handleInsertText(final String text) {
+        this.flushInputEvents();
         Cocos2dxRenderer.nativeInsertText(text);
     }
 
     public void handleDeleteBackward() {
+        this.flushInputEvents();
         Cocos2dxRenderer.nativeDeleteBackward();
     }
 
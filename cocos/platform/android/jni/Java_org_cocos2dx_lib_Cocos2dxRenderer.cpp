@@ -7,6 +7,7 @@
 #include "platform/CCFileUtils.h"
 #include "platform/android/jni/JniHelper.h"
 #include <jni.h>
+#include <algorithm>
 
 #include "base/ccUTF8.h"
 
@@ -16,6 +17,8 @@ extern "C" {
 
     JNIEXPORT void JNICALL Java_org_cocos2dx_lib_Cocos2dxRenderer_nativeRender(JNIEnv* env) {
         cocos2d::Director::getInstance()->mainLoop();
+        // the calls of Cocos2dxHelper queued by the frame
+        JniHelper::flushHelperCommands();
     }
 
     JNIEXPORT void JNICALL Java_org_cocos2dx_lib_Cocos2dxRenderer_nativeOnPause() {
@@ -24,6 +27,7 @@ extern "C" {
                 cocos2d::EventCustom backgroundEvent(EVENT_COME_TO_BACKGROUND);
                 cocos2d::Director::getInstance()->getEventDispatcher()->dispatchEvent(&backgroundEvent);
         }
+        JniHelper::flushHelperCommands();
     }
 
     JNIEXPORT void JNICALL Java_org_cocos2dx_lib_Cocos2dxRenderer_nativeOnResume() {
@@ -41,6 +45,18 @@ extern "C" {
         }
     }
 
+    JNIEXPORT void JNICALL Java_org_cocos2dx_lib_Cocos2dxRenderer_nativeOnThermalStateChanged(JNIEnv* env, jclass clazz, jint state) {
+        // the temperature levels of the game service are 0 (normal) to 3
+        state = std::max(0, std::min((int)state, (int)Director::ThermalState::CRITICAL));
+        Director::getInstance()->setThermalState((Director::ThermalState)state);
+    }
+
+    JNIEXPORT void JNICALL Java_org_cocos2dx_lib_Cocos2dxRenderer_nativeOnTrimMemory(JNIEnv* env, jclass clazz, jint level) {
+        if (Director::getInstance()->getOpenGLView()) {
+            Director::getInstance()->handleMemoryWarning();
+        }
+    }
+
     JNIEXPORT void JNICALL Java_org_cocos2dx_lib_Cocos2dxRenderer_nativeInsertText(JNIEnv* env, jobject thiz, jstring text) {
         std::string  strValue = cocos2d::StringUtils::getStringUTFCharsJNI(env, text);
         const char* pszText = strValue.c_str();
@@ -26,6 +26,8 @@ THE SOFTWARE.
 #include <android/log.h>
 #include <string.h>
 #include <pthread.h>
+#include <atomic>
+#include <mutex>
 
 #include "base/ccUTF8.h"
 
@@ -35,6 +37,20 @@ THE SOFTWARE.
 
 static pthread_key_t g_key;
 
+// global references of the classes and their method ids, looked up once
+static std::mutex g_cacheMutex;
+static std::unordered_map<std::string, jclass> g_classes;
+static std::unordered_map<std::string, jmethodID> g_methodIDs;
+
+// the calls queued by JniHelper::queueHelperCommand(): the command, an int and a float each
+static const int HELPER_COMMAND_CAPACITY = 128;
+static const char* HELPER_CLASS_NAME = "org/cocos2dx/lib/Cocos2dxHelper";
+static std::mutex g_commandMutex;
+static int32_t g_commands[HELPER_COMMAND_CAPACITY * 3];
+static std::atomic<int> g_commandCount(0);
+static jobject g_commandBuffer = nullptr;
+static jmethodID g_runCommandsMethodID = nullptr;
+
 jclass _getClassID(const char *className) {
     if (nullptr == className) {
         return nullptr;
@@ -62,6 +78,99 @@ void _detachCurrentThread(void* a) {
     cocos2d::JniHelper::getJavaVM()->DetachCurrentThread();
 }
 
+// The lookups are done without the lock, they may initialize a class which calls native code.
+static jclass _getCachedClassID(JNIEnv* env, const char* className) {
+    {
+        std::lock_guard<std::mutex> lock(g_cacheMutex);
+        auto iter = g_classes.find(className);
+        if (iter != g_classes.end()) {
+            return iter->second;
+        }
+    }
+
+    jclass localClass = _getClassID(className);
+    if (nullptr == localClass) {
+        return nullptr;
+    }
+    jclass globalClass = (jclass)env->NewGlobalRef(localClass);
+    env->DeleteLocalRef(localClass);
+
+    std::lock_guard<std::mutex> lock(g_cacheMutex);
+    auto result = g_classes.emplace(className, globalClass);
+    if (!result.second) {
+        // looked up by another thread meanwhile
+        env->DeleteGlobalRef(globalClass);
+    }
+    return result.first->second;
+}
+
+static jmethodID _getCachedMethodID(JNIEnv* env, jclass classID, const char* className, const char* methodName, const char* paramCode, bool isStatic) {
+    std::string key = className;
+    key += isStatic ? "::" : ".";
+    key += methodName;
+    key += paramCode;
+    {
+        std::lock_guard<std::mutex> lock(g_cacheMutex);
+        auto iter = g_methodIDs.find(key);
+        if (iter != g_methodIDs.end()) {
+            return iter->second;
+        }
+    }
+
+    jmethodID methodID = isStatic ? env->GetStaticMethodID(classID, methodName, paramCode)
+                                  : env->GetMethodID(classID, methodName, paramCode);
+    if (nullptr == methodID) {
+        return nullptr;
+    }
+
+    std::lock_guard<std::mutex> lock(g_cacheMutex);
+    g_methodIDs[key] = methodID;
+    return methodID;
+}
+
+static void _clearCache(JNIEnv* env) {
+    std::lock_guard<std::mutex> lock(g_cacheMutex);
+    for (auto& iter : g_classes) {
+        env->DeleteGlobalRef(iter.second);
+    }
+    g_classes.clear();
+    g_methodIDs.clear();
+}
+
+// with g_commandMutex locked; Cocos2dxHelper.runCommands() doesn't call native code
+static void _sendHelperCommands() {
+    int count = g_commandCount.load();
+    if (count == 0) {
+        return;
+    }
+
+    JNIEnv* env = cocos2d::JniHelper::getEnv();
+    if (!env) {
+        return;
+    }
+
+    jclass classID = _getCachedClassID(env, HELPER_CLASS_NAME);
+    if (nullptr == classID) {
+        return;
+    }
+    if (nullptr == g_runCommandsMethodID) {
+        g_runCommandsMethodID = _getCachedMethodID(env, classID, HELPER_CLASS_NAME, "runCommands", "(Ljava/nio/ByteBuffer;I)V", true);
+        if (nullptr == g_runCommandsMethodID) {
+            LOGE("Failed to find static method id of runCommands");
+            env->ExceptionClear();
+            return;
+        }
+    }
+    if (nullptr == g_commandBuffer) {
+        jobject buffer = env->NewDirectByteBuffer(g_commands, sizeof(g_commands));
+        g_commandBuffer = env->NewGlobalRef(buffer);
+        env->DeleteLocalRef(buffer);
+    }
+
+    env->CallStaticVoidMethod(classID, g_runCommandsMethodID, g_commandBuffer, (jint)count);
+    g_commandCount = 0;
+}
+
 namespace cocos2d {
 
     JavaVM* JniHelper::_psJavaVM = nullptr;
@@ -153,6 +262,10 @@ namespace cocos2d {
             return false;
         }
 
+        // the classes cached so far were loaded by the previous class loader
+        _clearCache(cocos2d::JniHelper::getEnv());
+        g_runCommandsMethodID = nullptr;
+
         JniHelper::classloader = cocos2d::JniHelper::getEnv()->NewGlobalRef(_c);
         JniHelper::loadclassMethod_methodID = _m.methodID;
         JniHelper::_activity = cocos2d::JniHelper::getEnv()->NewGlobalRef(activityinstance);
@@ -178,22 +291,25 @@ namespace cocos2d {
             LOGE("Failed to get JNIEnv");
             return false;
         }
-            
-        jclass classID = _getClassID(className);
+
+        // the queued calls go first
+        flushHelperCommands();
+
+        jclass classID = _getCachedClassID(env, className);
         if (! classID) {
             LOGE("Failed to find class %s", className);
             env->ExceptionClear();
             return false;
         }
 
-        jmethodID methodID = env->GetStaticMethodID(classID, methodName, paramCode);
+        jmethodID methodID = _getCachedMethodID(env, classID, className, methodName, paramCode, true);
         if (! methodID) {
             LOGE("Failed to find static method id of %s", methodName);
             env->ExceptionClear();
             return false;
         }
             
-        methodinfo.classID = classID;
+        methodinfo.classID = (jclass)env->NewLocalRef(classID);
         methodinfo.env = env;
         methodinfo.methodID = methodID;
         return true;
@@ -250,27 +366,55 @@ namespace cocos2d {
             return false;
         }
 
-        jclass classID = _getClassID(className);
+        flushHelperCommands();
+
+        jclass classID = _getCachedClassID(env, className);
         if (! classID) {
             LOGE("Failed to find class %s", className);
             env->ExceptionClear();
             return false;
         }
 
-        jmethodID methodID = env->GetMethodID(classID, methodName, paramCode);
+        jmethodID methodID = _getCachedMethodID(env, classID, className, methodName, paramCode, false);
         if (! methodID) {
             LOGE("Failed to find method id of %s", methodName);
             env->ExceptionClear();
             return false;
         }
 
-        methodinfo.classID = classID;
+        methodinfo.classID = (jclass)env->NewLocalRef(classID);
         methodinfo.env = env;
         methodinfo.methodID = methodID;
 
         return true;
     }
 
+    void JniHelper::queueHelperCommand(HelperCommand command, int intValue, float floatValue) {
+        std::lock_guard<std::mutex> lock(g_commandMutex);
+        if (g_commandCount.load() == HELPER_COMMAND_CAPACITY) {
+            _sendHelperCommands();
+            if (g_commandCount.load() == HELPER_COMMAND_CAPACITY) {
+                LOGE("Failed to send the queued calls of %s, they are dropped", HELPER_CLASS_NAME);
+                g_commandCount = 0;
+            }
+        }
+
+        int count = g_commandCount.load();
+        int32_t* entry = g_commands + count * 3;
+        entry[0] = (int32_t)command;
+        entry[1] = intValue;
+        memcpy(&entry[2], &floatValue, sizeof(floatValue));
+        g_commandCount = count + 1;
+    }
+
+    void JniHelper::flushHelperCommands() {
+        if (g_commandCount.load() == 0) {
+            return;
+        }
+        std::lock_guard<std::mutex> lock(g_commandMutex);
+        _sendHelperCommands();
+    }
+
     std::string JniHelper::jstring2string(jstring jstr) {
         if (jstr == nullptr) {
             return "";
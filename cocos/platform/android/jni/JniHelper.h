@@ -48,12 +48,36 @@ public:
 
     typedef std::unordered_map<JNIEnv*, std::vector<jobject>> LocalRefMapType;
 
+    /**
+     * The void methods of org.cocos2dx.lib.Cocos2dxHelper that can be queued by queueHelperCommand(),
+     * in sync with Cocos2dxHelper.runCommands().
+     * @since v3.14
+     */
+    enum class HelperCommand
+    {
+        VIBRATE,                        // float: the duration in seconds
+        SET_KEEP_SCREEN_ON,             // int: 0 or 1
+        SET_BACKGROUND_MUSIC_VOLUME,    // float: the volume
+        SET_EFFECTS_VOLUME,             // float: the volume
+        PAUSE_EFFECT,                   // int: the sound id
+        RESUME_EFFECT,                  // int: the sound id
+        STOP_EFFECT,                    // int: the sound id
+        PAUSE_ALL_EFFECTS,
+        RESUME_ALL_EFFECTS,
+        STOP_ALL_EFFECTS
+    };
+
     static void setJavaVM(JavaVM *javaVM);
     static JavaVM* getJavaVM();
     static JNIEnv* getEnv();
     static jobject getActivity();
 
     static bool setClassLoaderFrom(jobject activityInstance);
+
+    /**
+    @brief Looks up a method. The classes and the method ids are cached the first time they are looked up,
+    methodinfo.classID is a new local reference to delete as before.
+    */
     static bool getStaticMethodInfo(JniMethodInfo &methodinfo,
                                     const char *className,
                                     const char *methodName,
@@ -65,6 +89,19 @@ public:
 
     static std::string jstring2string(jstring str);
 
+    /**
+    @brief Queues a call of a void method of Cocos2dxHelper. The queued calls are sent to Java in a single
+    JNI call at the end of the frame, or before the next call made with JniHelper so their order is kept.
+    @since v3.14
+    */
+    static void queueHelperCommand(HelperCommand command, int intValue = 0, float floatValue = 0.0f);
+
+    /**
+    @brief Sends the calls queued by queueHelperCommand() to Java.
+    @since v3.14
+    */
+    static void flushHelperCommands();
+
     static jmethodID loadclassMethod_methodID;
     static jobject classloader;
     static std::function<void()> classloaderCallback;
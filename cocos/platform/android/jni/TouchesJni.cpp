@@ -28,53 +28,23 @@ THE SOFTWARE.
 
 #include <android/log.h>
 #include <jni.h>
+#include <string.h>
+#include <algorithm>
 
 using namespace cocos2d;
 
-extern "C" {
-    JNIEXPORT void JNICALL Java_org_cocos2dx_lib_Cocos2dxRenderer_nativeTouchesBegin(JNIEnv * env, jobject thiz, jint id, jfloat x, jfloat y) {
-        intptr_t idlong = id;
-        cocos2d::Director::getInstance()->getOpenGLView()->handleTouchesBegin(1, &idlong, &x, &y);
-    }
-
-    JNIEXPORT void JNICALL Java_org_cocos2dx_lib_Cocos2dxRenderer_nativeTouchesEnd(JNIEnv * env, jobject thiz, jint id, jfloat x, jfloat y) {
-        intptr_t idlong = id;
-        cocos2d::Director::getInstance()->getOpenGLView()->handleTouchesEnd(1, &idlong, &x, &y);
-    }
-
-    JNIEXPORT void JNICALL Java_org_cocos2dx_lib_Cocos2dxRenderer_nativeTouchesMove(JNIEnv * env, jobject thiz, jintArray ids, jfloatArray xs, jfloatArray ys) {
-        int size = env->GetArrayLength(ids);
-        jint id[size];
-        jfloat x[size];
-        jfloat y[size];
-
-        env->GetIntArrayRegion(ids, 0, size, id);
-        env->GetFloatArrayRegion(xs, 0, size, x);
-        env->GetFloatArrayRegion(ys, 0, size, y);
-
-        intptr_t idlong[size];
-        for(int i = 0; i < size; i++)
-            idlong[i] = id[i];
-
-        cocos2d::Director::getInstance()->getOpenGLView()->handleTouchesMove(size, idlong, x, y);
-    }
-
-    JNIEXPORT void JNICALL Java_org_cocos2dx_lib_Cocos2dxRenderer_nativeTouchesCancel(JNIEnv * env, jobject thiz, jintArray ids, jfloatArray xs, jfloatArray ys) {
-        int size = env->GetArrayLength(ids);
-        jint id[size];
-        jfloat x[size];
-        jfloat y[size];
-
-        env->GetIntArrayRegion(ids, 0, size, id);
-        env->GetFloatArrayRegion(xs, 0, size, x);
-        env->GetFloatArrayRegion(ys, 0, size, y);
+// the types of the input events written by Cocos2dxRenderer.java
+#define INPUTEVENT_TOUCHES_BEGIN 0
+#define INPUTEVENT_TOUCHES_END 1
+#define INPUTEVENT_TOUCHES_MOVE 2
+#define INPUTEVENT_TOUCHES_CANCEL 3
+#define INPUTEVENT_KEY 4
 
-        intptr_t idlong[size];
-        for(int i = 0; i < size; i++)
-            idlong[i] = id[i];
-
-        cocos2d::Director::getInstance()->getOpenGLView()->handleTouchesCancel(size, idlong, x, y);
-    }
+// an event is its type and its number of entries, then an id, an x and a y per entry
+#define INPUTEVENT_HEADER_SIZE 8
+#define INPUTEVENT_ENTRY_SIZE 12
+// MotionEvent has 16 pointers at most
+#define INPUTEVENT_MAX_ENTRIES 32
 
 #define KEYCODE_BACK 0x04
 #define KEYCODE_MENU 0x52
@@ -85,32 +55,87 @@ extern "C" {
 #define KEYCODE_ENTER 0x42
 #define KEYCODE_PLAY  0x7e
 #define KEYCODE_DPAD_CENTER  0x17
-    
-    
-    static std::unordered_map<int, cocos2d::EventKeyboard::KeyCode> g_keyCodeMap = {
-        { KEYCODE_BACK , cocos2d::EventKeyboard::KeyCode::KEY_ESCAPE},
-        { KEYCODE_MENU , cocos2d::EventKeyboard::KeyCode::KEY_MENU},
-        { KEYCODE_DPAD_UP  , cocos2d::EventKeyboard::KeyCode::KEY_DPAD_UP },
-        { KEYCODE_DPAD_DOWN , cocos2d::EventKeyboard::KeyCode::KEY_DPAD_DOWN },
-        { KEYCODE_DPAD_LEFT , cocos2d::EventKeyboard::KeyCode::KEY_DPAD_LEFT },
-        { KEYCODE_DPAD_RIGHT , cocos2d::EventKeyboard::KeyCode::KEY_DPAD_RIGHT },
-        { KEYCODE_ENTER  , cocos2d::EventKeyboard::KeyCode::KEY_ENTER},
-        { KEYCODE_PLAY  , cocos2d::EventKeyboard::KeyCode::KEY_PLAY},
-        { KEYCODE_DPAD_CENTER  , cocos2d::EventKeyboard::KeyCode::KEY_DPAD_CENTER},
-        
-    };
-    
-    JNIEXPORT jboolean JNICALL Java_org_cocos2dx_lib_Cocos2dxRenderer_nativeKeyEvent(JNIEnv * env, jobject thiz, jint keyCode, jboolean isPressed) {
-        Director* pDirector = Director::getInstance();
-        
-        auto iterKeyCode = g_keyCodeMap.find(keyCode);
-        if (iterKeyCode == g_keyCodeMap.end()) {
-            return JNI_FALSE;
+
+static std::unordered_map<int, cocos2d::EventKeyboard::KeyCode> g_keyCodeMap = {
+    { KEYCODE_BACK , cocos2d::EventKeyboard::KeyCode::KEY_ESCAPE},
+    { KEYCODE_MENU , cocos2d::EventKeyboard::KeyCode::KEY_MENU},
+    { KEYCODE_DPAD_UP  , cocos2d::EventKeyboard::KeyCode::KEY_DPAD_UP },
+    { KEYCODE_DPAD_DOWN , cocos2d::EventKeyboard::KeyCode::KEY_DPAD_DOWN },
+    { KEYCODE_DPAD_LEFT , cocos2d::EventKeyboard::KeyCode::KEY_DPAD_LEFT },
+    { KEYCODE_DPAD_RIGHT , cocos2d::EventKeyboard::KeyCode::KEY_DPAD_RIGHT },
+    { KEYCODE_ENTER  , cocos2d::EventKeyboard::KeyCode::KEY_ENTER},
+    { KEYCODE_PLAY  , cocos2d::EventKeyboard::KeyCode::KEY_PLAY},
+    { KEYCODE_DPAD_CENTER  , cocos2d::EventKeyboard::KeyCode::KEY_DPAD_CENTER},
+};
+
+static void dispatchKeyEvent(int keyCode, bool isPressed) {
+    auto iterKeyCode = g_keyCodeMap.find(keyCode);
+    if (iterKeyCode == g_keyCodeMap.end()) {
+        return;
+    }
+
+    cocos2d::EventKeyboard event(iterKeyCode->second, isPressed);
+    cocos2d::Director::getInstance()->getEventDispatcher()->dispatchEvent(&event);
+}
+
+extern "C" {
+    JNIEXPORT void JNICALL Java_org_cocos2dx_lib_Cocos2dxRenderer_nativeHandleInputEvents(JNIEnv * env, jobject thiz, jobject events, jint size) {
+        const char* data = (const char*)env->GetDirectBufferAddress(events);
+        if (data == nullptr) {
+            return;
         }
-        
-        cocos2d::EventKeyboard::KeyCode cocos2dKey = g_keyCodeMap.at(keyCode);
-        cocos2d::EventKeyboard event(cocos2dKey, isPressed);
-        cocos2d::Director::getInstance()->getEventDispatcher()->dispatchEvent(&event);
-        return JNI_TRUE;
-        
-    }}
+
+        GLView* glview = cocos2d::Director::getInstance()->getOpenGLView();
+        intptr_t ids[INPUTEVENT_MAX_ENTRIES];
+        float xs[INPUTEVENT_MAX_ENTRIES];
+        float ys[INPUTEVENT_MAX_ENTRIES];
+
+        const char* end = data + size;
+        while (data + INPUTEVENT_HEADER_SIZE <= end) {
+            int32_t type;
+            int32_t count;
+            memcpy(&type, data, sizeof(type));
+            memcpy(&count, data + 4, sizeof(count));
+            data += INPUTEVENT_HEADER_SIZE;
+            if (count < 0 || data + count * INPUTEVENT_ENTRY_SIZE > end) {
+                break;
+            }
+
+            // the events with more pointers than INPUTEVENT_MAX_ENTRIES are skipped
+            int entryCount = std::min((int)count, INPUTEVENT_MAX_ENTRIES);
+            for (int i = 0; i < entryCount; ++i) {
+                int32_t id;
+                memcpy(&id, data + i * INPUTEVENT_ENTRY_SIZE, sizeof(id));
+                memcpy(&xs[i], data + i * INPUTEVENT_ENTRY_SIZE + 4, sizeof(float));
+                memcpy(&ys[i], data + i * INPUTEVENT_ENTRY_SIZE + 8, sizeof(float));
+                ids[i] = id;
+            }
+            data += count * INPUTEVENT_ENTRY_SIZE;
+            if (count > INPUTEVENT_MAX_ENTRIES || glview == nullptr) {
+                continue;
+            }
+
+            switch (type) {
+            case INPUTEVENT_TOUCHES_BEGIN:
+                glview->handleTouchesBegin(count, ids, xs, ys);
+                break;
+            case INPUTEVENT_TOUCHES_END:
+                glview->handleTouchesEnd(count, ids, xs, ys);
+                break;
+            case INPUTEVENT_TOUCHES_MOVE:
+                glview->handleTouchesMove(count, ids, xs, ys);
+                break;
+            case INPUTEVENT_TOUCHES_CANCEL:
+                glview->handleTouchesCancel(count, ids, xs, ys);
+                break;
+            case INPUTEVENT_KEY:
+                if (count == 1) {
+                    dispatchKeyEvent((int)ids[0], xs[0] != 0);
+                }
+                break;
+            default:
+                break;
+            }
+        }
+    }
+}
@@ -376,7 +376,11 @@ bool FileUtils::writeValueMapToFile(const ValueMap& dict, const std::string& ful
 
     NSString *file = [NSString stringWithUTF8String:fullPath.c_str()];
     // do it atomically
-    return [nsDict writeToFile:file atomically:YES];
+    if (![nsDict writeToFile:file atomically:YES])
+        return false;
+
+    purgeNonexistentFileCache();
+    return true;
 }
 
 void FileUtilsApple::valueMapCompact(ValueMap& valueMap)
@@ -443,6 +447,7 @@ bool FileUtils::writeValueVectorToFile(const ValueVector& vecData, const std::st
 
     [array writeToFile:path atomically:YES];
 
+    purgeNonexistentFileCache();
     return true;
 }
 ValueVector FileUtilsApple::getValueVectorFromFile(const std::string& filename)
@@ -482,6 +487,8 @@ bool FileUtilsApple::createDirectory(const std::string& path)
         CCLOGERROR("Fail to create directory \"%s\": %s", path.c_str(), [error.localizedDescription UTF8String]);
     }
     
+    if (result)
+        purgeNonexistentFileCache();
     return result;
 }
 
@@ -45,6 +45,11 @@ static id s_sharedDirectorCaller;
 -(void) invalidate;
 @end
 
+// NSProcessInfo.thermalState, iOS 11 and later
+@interface NSObject(CCThermalState)
+-(NSInteger) thermalState;
+@end
+
 @implementation CCDirectorCaller
 
 @synthesize interval;
@@ -75,6 +80,12 @@ static id s_sharedDirectorCaller;
         NSNotificationCenter *nc = [NSNotificationCenter defaultCenter];
         [nc addObserver:self selector:@selector(appDidBecomeActive) name:UIApplicationDidBecomeActiveNotification object:nil];
         [nc addObserver:self selector:@selector(appDidBecomeInactive) name:UIApplicationWillResignActiveNotification object:nil];
+        [nc addObserver:self selector:@selector(appDidReceiveMemoryWarning) name:UIApplicationDidReceiveMemoryWarningNotification object:nil];
+        if ([[NSProcessInfo processInfo] respondsToSelector:@selector(thermalState)])
+        {
+            [nc addObserver:self selector:@selector(thermalStateDidChange) name:@"NSProcessInfoThermalStateDidChangeNotification" object:nil];
+            [self thermalStateDidChange];
+        }
         
         self.interval = 1;
     }
@@ -103,6 +114,23 @@ static id s_sharedDirectorCaller;
     isAppActive = NO;
 }
 
+- (void)appDidReceiveMemoryWarning
+{
+    cocos2d::Director* director = cocos2d::Director::getInstance();
+    if (director->getOpenGLView())
+        director->handleMemoryWarning();
+}
+
+- (void)thermalStateDidChange
+{
+    // the notification is posted on any thread
+    dispatch_async(dispatch_get_main_queue(), ^{
+        NSInteger state = [(NSObject*)[NSProcessInfo processInfo] thermalState];
+        state = MAX(0, MIN(state, (NSInteger)cocos2d::Director::ThermalState::CRITICAL));
+        cocos2d::Director::getInstance()->setThermalState((cocos2d::Director::ThermalState)state);
+    });
+}
+
 -(void) startMainLoop
 {
     // Director::setAnimationInterval() is called, we should invalidate it first
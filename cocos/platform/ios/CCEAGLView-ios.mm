@@ -431,6 +431,25 @@ Copyright (C) 2008 Apple Inc. All Rights Reserved.
 
 - (void)touchesMoved:(NSSet *)touches withEvent:(UIEvent *)event
 {
+    auto glview = cocos2d::Director::getInstance()->getOpenGLView();
+#if defined(__IPHONE_9_0) && (__IPHONE_OS_VERSION_MAX_ALLOWED >= __IPHONE_9_0)
+    // the moves are coalesced anyway, so pass all the samples of the high rate touch panels with their times
+    if (glview->isTouchMovesCoalesced() && [event respondsToSelector:@selector(coalescedTouchesForTouch:)]) {
+        for (UITouch *touch in touches) {
+            intptr_t touchId = (intptr_t)touch;
+            for (UITouch *sample in [event coalescedTouchesForTouch:touch]) {
+                float x = [sample locationInView: [touch view]].x * self.contentScaleFactor;
+                float y = [sample locationInView: [touch view]].y * self.contentScaleFactor;
+                float force = sample.force;
+                float maxForce = sample.maximumPossibleForce;
+                double timestamp = sample.timestamp;
+                glview->handleTouchesMove(1, &touchId, &x, &y, &force, &maxForce, &timestamp);
+            }
+        }
+        return;
+    }
+#endif
+
     UITouch* ids[IOS_MAX_TOUCHES_COUNT] = {0};
     float xs[IOS_MAX_TOUCHES_COUNT] = {0.0f};
     float ys[IOS_MAX_TOUCHES_COUNT] = {0.0f};
@@ -457,7 +476,6 @@ Copyright (C) 2008 Apple Inc. All Rights Reserved.
         ++i;
     }
 
-    auto glview = cocos2d::Director::getInstance()->getOpenGLView();
     glview->handleTouchesMove(i, (intptr_t*)ids, xs, ys, fs, ms);
 }
 
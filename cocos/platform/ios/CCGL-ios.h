@@ -42,6 +42,34 @@ THE SOFTWARE.
 #include <OpenGLES/ES2/gl.h>
 #include <OpenGLES/ES2/glext.h>
 
+// GL_EXT_map_buffer_range and GL_APPLE_sync, used by the renderer's ring buffer
+#define glMapBufferRange            glMapBufferRangeEXT
+#define GL_MAP_WRITE_BIT            GL_MAP_WRITE_BIT_EXT
+#define GL_MAP_INVALIDATE_RANGE_BIT GL_MAP_INVALIDATE_RANGE_BIT_EXT
+#define GL_MAP_INVALIDATE_BUFFER_BIT GL_MAP_INVALIDATE_BUFFER_BIT_EXT
+#define GL_MAP_UNSYNCHRONIZED_BIT   GL_MAP_UNSYNCHRONIZED_BIT_EXT
+
+#define glFenceSync                 glFenceSyncAPPLE
+#define glClientWaitSync            glClientWaitSyncAPPLE
+#define glDeleteSync                glDeleteSyncAPPLE
+#define GL_SYNC_GPU_COMMANDS_COMPLETE GL_SYNC_GPU_COMMANDS_COMPLETE_APPLE
+#define GL_SYNC_FLUSH_COMMANDS_BIT  GL_SYNC_FLUSH_COMMANDS_BIT_APPLE
+#define GL_TIMEOUT_EXPIRED          GL_TIMEOUT_EXPIRED_APPLE
+
+// GL_EXT_instanced_arrays, used by MeshCommand's instanced draws
+#define glVertexAttribDivisor       glVertexAttribDivisorEXT
+#define glDrawElementsInstanced     glDrawElementsInstancedEXT
+
+// GL_EXT_occlusion_query_boolean, used by the renderer's occlusion culling
+#define glGenQueries                glGenQueriesEXT
+#define glDeleteQueries             glDeleteQueriesEXT
+#define glBeginQuery                glBeginQueryEXT
+#define glEndQuery                  glEndQueryEXT
+#define glGetQueryObjectuiv         glGetQueryObjectuivEXT
+#define GL_ANY_SAMPLES_PASSED       GL_ANY_SAMPLES_PASSED_EXT
+#define GL_QUERY_RESULT             GL_QUERY_RESULT_EXT
+#define GL_QUERY_RESULT_AVAILABLE   GL_QUERY_RESULT_AVAILABLE_EXT
+
 #endif // CC_PLATFORM_IOS
 
 #endif // __PLATFORM_IOS_CCGL_H__
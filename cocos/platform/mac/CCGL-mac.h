@@ -42,6 +42,8 @@ THE SOFTWARE.
 #define glClearDepthf                   glClearDepth
 #define glDepthRangef                   glDepthRange
 #define glReleaseShaderCompiler(xxx)
+#define glVertexAttribDivisor           glVertexAttribDivisorARB
+#define glDrawElementsInstanced         glDrawElementsInstancedARB
 
 
 #endif // __PLATFORM_MAC_CCGL_H__
@@ -122,6 +122,10 @@ std::string FileUtilsWin32::getSuitableFOpen(const std::string& filenameUtf8) co
 
 long FileUtilsWin32::getFileSize(const std::string &filepath)
 {
+    long packFileSize = getAssetPackFileSize(filepath);
+    if (packFileSize >= 0)
+        return packFileSize;
+
     WIN32_FILE_ATTRIBUTE_DATA fad;
     if (!GetFileAttributesEx(StringUtf8ToWideChar(filepath).c_str(), GetFileExInfoStandard, &fad))
     {
@@ -172,6 +176,9 @@ FileUtils::Status FileUtilsWin32::getContents(const std::string& filename, Resiz
     // read the file from hardware
     std::string fullPath = FileUtils::getInstance()->fullPathForFilename(filename);
 
+    if (getContentsFromAssetPack(fullPath, buffer))
+        return FileUtils::Status::OK;
+
     HANDLE fileHandle = ::CreateFile(StringUtf8ToWideChar(fullPath).c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING, NULL, nullptr);
     if (fileHandle == INVALID_HANDLE_VALUE)
         return FileUtils::Status::OpenFailed;
@@ -203,6 +210,64 @@ FileUtils::Status FileUtilsWin32::getContents(const std::string& filename, Resiz
     return FileUtils::Status::OK;
 }
 
+namespace
+{
+    class Win32MappedFileData : public MappedFileData
+    {
+    public:
+        Win32MappedFileData(const void* view, ssize_t size)
+        {
+            _bytes = static_cast<const unsigned char*>(view);
+            _size = size;
+        }
+
+        virtual ~Win32MappedFileData()
+        {
+            ::UnmapViewOfFile(_bytes);
+        }
+    };
+}
+
+MappedFileData* FileUtilsWin32::mapFileContents(const std::string& filename) const
+{
+    if (filename.empty())
+        return nullptr;
+
+    std::string fullPath = fullPathForFilename(filename);
+
+    auto packData = mapAssetPackContents(fullPath);
+    if (packData)
+        return packData;
+
+    HANDLE fileHandle = ::CreateFile(StringUtf8ToWideChar(fullPath).c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, NULL, OPEN_EXISTING, NULL, nullptr);
+    if (fileHandle == INVALID_HANDLE_VALUE)
+        return nullptr;
+
+    DWORD hi;
+    auto size = ::GetFileSize(fileHandle, &hi);
+    if (hi > 0 || size == 0)
+    {
+        ::CloseHandle(fileHandle);
+        return nullptr;
+    }
+
+    // the view keeps the mapping and the file open
+    HANDLE mappingHandle = ::CreateFileMapping(fileHandle, nullptr, PAGE_READONLY, 0, 0, nullptr);
+    ::CloseHandle(fileHandle);
+    if (mappingHandle == nullptr)
+        return nullptr;
+
+    const void* view = ::MapViewOfFile(mappingHandle, FILE_MAP_READ, 0, 0, 0);
+    ::CloseHandle(mappingHandle);
+    if (view == nullptr)
+        return nullptr;
+
+    auto mapped = new (std::nothrow) Win32MappedFileData(view, size);
+    if (mapped == nullptr)
+        ::UnmapViewOfFile(view);
+    return mapped;
+}
+
 std::string FileUtilsWin32::getPathForFilename(const std::string& filename, const std::string& resolutionDirectory, const std::string& searchPath) const
 {
     std::string unixFileName = convertPathFormatToUnixStyle(filename);
@@ -376,6 +441,7 @@ bool FileUtilsWin32::renameFile(const std::string &oldfullpath, const std::strin
 
     if (MoveFile(_wOld.c_str(), _wNew.c_str()))
     {
+        purgeNonexistentFileCache();
         return true;
     }
     else
@@ -452,6 +518,7 @@ bool FileUtilsWin32::createDirectory(const std::string& dirPath)
             }
         }
     }
+    purgeNonexistentFileCache();
     return true;
 }
 
@@ -110,6 +110,7 @@ protected:
 
 
 	virtual FileUtils::Status getContents(const std::string& filename, ResizableBuffer* buffer) override;
+    virtual MappedFileData* mapFileContents(const std::string& filename) const override;
 
     /**
      *  Gets full path for filename, resolution directory and search path.
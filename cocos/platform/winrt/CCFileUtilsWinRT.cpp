@@ -132,6 +132,10 @@ std::string CCFileUtilsWinRT::getSuitableFOpen(const std::string& filenameUtf8)
 
 long CCFileUtilsWinRT::getFileSize(const std::string &filepath)
 {
+    long packFileSize = getAssetPackFileSize(filepath);
+    if (packFileSize >= 0)
+        return packFileSize;
+
     WIN32_FILE_ATTRIBUTE_DATA fad;
     if (!GetFileAttributesEx(StringUtf8ToWideChar(filepath).c_str(), GetFileExInfoStandard, &fad))
     {
@@ -151,6 +155,9 @@ FileUtils::Status CCFileUtilsWinRT::getContents(const std::string& filename, Res
     // read the file from hardware
     std::string fullPath = FileUtils::getInstance()->fullPathForFilename(filename);
 
+    if (getContentsFromAssetPack(fullPath, buffer))
+        return FileUtils::Status::OK;
+
     HANDLE fileHandle = ::CreateFile2(StringUtf8ToWideChar(fullPath).c_str(), GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, OPEN_EXISTING, nullptr);
     if (fileHandle == INVALID_HANDLE_VALUE)
         return FileUtils::Status::OpenFailed;
@@ -265,6 +272,7 @@ bool CCFileUtilsWinRT::createDirectory(const std::string& path)
             }
         }
     }
+    purgeNonexistentFileCache();
     return true;
 }
 
@@ -353,6 +361,7 @@ bool CCFileUtilsWinRT::renameFile(const std::string &oldfullpath, const std::str
     if (MoveFileEx(StringUtf8ToWideChar(_oldfullpath).c_str(), _wNewfullpath.c_str(),
         MOVEFILE_REPLACE_EXISTING & MOVEFILE_WRITE_THROUGH))
     {
+        purgeNonexistentFileCache();
         return true;
     }
     else
@@ -24,8 +24,14 @@
 
 #include "renderer/CCCustomCommand.h"
 
+#if CC_ENABLE_ALLOCATOR && CC_ENABLE_ENGINE_ALLOCATOR_POOLS
+#include "base/allocator/CCAllocatorStrategyPool.h"
+#endif
+
 NS_CC_BEGIN
 
+CC_DEFINE_ALLOCATOR_POOL(CustomCommand, 256)
+
 CustomCommand::CustomCommand()
 : func(nullptr)
 {
@@ -0,0 +1,339 @@
+/****************************************************************************
+Copyright (c) 2017 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+
+#include "renderer/CCDynamicResolution.h"
+
+#include <algorithm>
+#include <cmath>
+
+#include "2d/CCCamera.h"
+#include "base/CCConfiguration.h"
+#include "base/CCDirector.h"
+#include "base/CCEventDispatcher.h"
+#include "base/CCEventListenerCustom.h"
+#include "base/CCEventType.h"
+#include "base/CCStencilStateManager.h"
+#include "renderer/CCGLProgramCache.h"
+#include "renderer/CCRenderer.h"
+#include "renderer/ccGLStateCache.h"
+
+NS_CC_BEGIN
+
+// the scale changes by steps, so the targets of a few sizes are reused
+static const float SCALE_STEP = 0.05f;
+// the time the average frame time takes to follow a change of the scale
+static const float SETTLE_TIME = 0.25f;
+// the time before trying a higher scale, longer after going down so it doesn't go back and forth
+static const float RAISE_DELAY = 0.5f;
+static const float RAISE_DELAY_AFTER_LOWERING = 2.0f;
+
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID)
+static GLuint getDepthFormat()
+{
+    return Configuration::getInstance()->supportsOESPackedDepthStencil() ? GL_DEPTH24_STENCIL8 : GL_DEPTH_COMPONENT16;
+}
+#else
+static GLuint getDepthFormat()
+{
+    return GL_DEPTH24_STENCIL8;
+}
+#endif
+
+DynamicResolution::DynamicResolution()
+: _enabled(false)
+, _autoScale(true)
+, _cameraMask((unsigned short)~(unsigned short)CameraFlag::DEFAULT)
+, _targetFrameRate(0)
+, _minScale(0.5f)
+, _maxScale(1.0f)
+, _scale(1.0f)
+, _averageFrameTime(0)
+, _timeSinceChange(0)
+, _lowered(false)
+, _frame(0)
+, _currentTarget(nullptr)
+, _oldFBO(0)
+{
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+    // the targets aren't restored with the GL context
+    _backgroundListener = Director::getInstance()->getEventDispatcher()->addCustomEventListener(EVENT_COME_TO_BACKGROUND, [this](EventCustom* /*event*/) {
+        for (auto& scaled : _targets)
+        {
+            RenderTargetPool::destroyTarget(scaled.target);
+        }
+        _targets.clear();
+    });
+#endif
+}
+
+DynamicResolution::~DynamicResolution()
+{
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+    Director::getInstance()->getEventDispatcher()->removeEventListener(_backgroundListener);
+#endif
+    for (auto& scaled : _targets)
+    {
+        RenderTargetPool::destroyTarget(scaled.target);
+    }
+}
+
+void DynamicResolution::setEnabled(bool enabled)
+{
+    if (_enabled == enabled)
+        return;
+
+    _enabled = enabled;
+    _averageFrameTime = 0;
+    _timeSinceChange = 0;
+    if (!_enabled)
+    {
+        releaseTargets();
+    }
+}
+
+void DynamicResolution::setScaleRange(float minScale, float maxScale)
+{
+    CCASSERT(minScale > 0 && minScale <= maxScale, "DynamicResolution: invalid scale range");
+    _maxScale = std::min(maxScale, 1.0f);
+    _minScale = std::min(minScale, _maxScale);
+    setScale(_scale);
+}
+
+void DynamicResolution::setScale(float scale)
+{
+    _scale = clampf(scale, _minScale, _maxScale);
+}
+
+void DynamicResolution::update(float dt)
+{
+    ++_frame;
+    // the targets of the sizes no longer rendered, eg: after the scale changed
+    auto unused = std::remove_if(_targets.begin(), _targets.end(), [this](const ScaledTarget& scaled) {
+        return scaled.lastFrame + 1 < _frame;
+    });
+    for (auto iter = unused; iter != _targets.end(); ++iter)
+    {
+        RenderTargetPool::getInstance()->recycle(iter->target);
+    }
+    _targets.erase(unused, _targets.end());
+
+    if (!_enabled || !_autoScale)
+        return;
+
+    _timeSinceChange += dt;
+    auto renderer = Director::getInstance()->getRenderer();
+    if (renderer->isGPUTimingEnabled() && renderer->getGPUFrameTime() > 0)
+    {
+        adjustScale((float)(renderer->getGPUFrameTime() / 1000), true);
+    }
+    else
+    {
+        adjustScale(dt, false);
+    }
+}
+
+void DynamicResolution::adjustScale(float frameTime, bool gpuTime)
+{
+    _averageFrameTime = _averageFrameTime > 0 ? _averageFrameTime + (frameTime - _averageFrameTime) * 0.1f : frameTime;
+    if (_timeSinceChange < SETTLE_TIME)
+        return;
+
+    float targetTime = _targetFrameRate > 0 ? 1 / _targetFrameRate : (float)Director::getInstance()->getAnimationInterval();
+    float scale = _scale;
+    if (_averageFrameTime > targetTime * 1.1f)
+    {
+        // the cost follows the number of pixels, the square of the scale
+        scale = std::min(_scale - SCALE_STEP, _scale * std::sqrt(targetTime / _averageFrameTime));
+    }
+    // the frame time can't go under the frame interval with vsync, the scale is raised when the
+    // frame rate is held; the GPU time tells whether the next step fits
+    else if (_averageFrameTime < targetTime * (gpuTime ? 0.75f : 1.02f)
+        && _timeSinceChange >= (_lowered ? RAISE_DELAY_AFTER_LOWERING : RAISE_DELAY))
+    {
+        scale = _scale + SCALE_STEP;
+    }
+
+    scale = clampf(std::floor(scale / SCALE_STEP + 0.5f) * SCALE_STEP, _minScale, _maxScale);
+    if (std::abs(scale - _scale) > SCALE_STEP / 2)
+    {
+        _lowered = scale < _scale;
+        _scale = scale;
+        _timeSinceChange = 0;
+    }
+}
+
+DynamicResolution::ScaledTarget* DynamicResolution::getTarget(int width, int height)
+{
+    for (auto& scaled : _targets)
+    {
+        if (scaled.width == width && scaled.height == height)
+            return &scaled;
+    }
+
+    ScaledTarget scaled;
+    scaled.width = width;
+    scaled.height = height;
+    scaled.lastFrame = _frame;
+
+    const GLuint depthFormat = getDepthFormat();
+    const Size size((float)width, (float)height);
+    if (!RenderTargetPool::getInstance()->acquire(width, height, size, Texture2D::PixelFormat::RGBA8888, depthFormat, false, &scaled.target))
+    {
+        auto& target = scaled.target;
+        target.texture = new (std::nothrow) Texture2D();
+        std::vector<unsigned char> pixels(width * height * 4, 0);
+        if (!target.texture || !target.texture->initWithData(pixels.data(), pixels.size(), Texture2D::PixelFormat::RGBA8888, width, height, size))
+        {
+            CC_SAFE_RELEASE(target.texture);
+            return nullptr;
+        }
+        target.depthStencilFormat = depthFormat;
+
+        GLint oldFBO;
+        GLint oldRBO;
+        glGetIntegerv(GL_FRAMEBUFFER_BINDING, &oldFBO);
+        glGetIntegerv(GL_RENDERBUFFER_BINDING, &oldRBO);
+
+        glGenFramebuffers(1, &target.fbo);
+        glBindFramebuffer(GL_FRAMEBUFFER, target.fbo);
+        glFramebufferTexture2D(GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, target.texture->getName(), 0);
+
+        glGenRenderbuffers(1, &target.depthRenderBuffer);
+        glBindRenderbuffer(GL_RENDERBUFFER, target.depthRenderBuffer);
+        glRenderbufferStorage(GL_RENDERBUFFER, depthFormat, width, height);
+        glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, target.depthRenderBuffer);
+        if (depthFormat == GL_DEPTH24_STENCIL8)
+        {
+            glFramebufferRenderbuffer(GL_FRAMEBUFFER, GL_STENCIL_ATTACHMENT, GL_RENDERBUFFER, target.depthRenderBuffer);
+        }
+
+        bool complete = glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE;
+        glBindRenderbuffer(GL_RENDERBUFFER, oldRBO);
+        glBindFramebuffer(GL_FRAMEBUFFER, oldFBO);
+        if (!complete)
+        {
+            CCLOG("cocos2d: DynamicResolution: the %dx%d target is incomplete", width, height);
+            RenderTargetPool::destroyTarget(target);
+            return nullptr;
+        }
+    }
+
+    // the previous owner may have changed the parameters
+    Texture2D::TexParams texParams = {GL_LINEAR, GL_LINEAR, GL_CLAMP_TO_EDGE, GL_CLAMP_TO_EDGE};
+    scaled.target.texture->setTexParameters(texParams);
+
+    _targets.push_back(scaled);
+    return &_targets.back();
+}
+
+bool DynamicResolution::beginCamera(Camera* camera)
+{
+    _currentTarget = nullptr;
+    if (!_enabled || _scale >= 1 || camera->getFrameBufferObject() || !((unsigned short)camera->getCameraFlag() & _cameraMask))
+        return false;
+
+    const auto& viewport = Camera::getDefaultViewport();
+    int width = std::max(1, (int)(viewport._width * _scale + 0.5f));
+    int height = std::max(1, (int)(viewport._height * _scale + 0.5f));
+    _currentTarget = getTarget(width, height);
+    if (!_currentTarget)
+        return false;
+    _currentTarget->lastFrame = _frame;
+
+    glGetIntegerv(GL_FRAMEBUFFER_BINDING, &_oldFBO);
+    glBindFramebuffer(GL_FRAMEBUFFER, _currentTarget->target.fbo);
+    StencilStateManager::invalidateClearedLayers();
+    GL::viewport(0, 0, width, height);
+
+    // transparent where the camera draws nothing, the cameras before it show through
+    GLfloat oldClearColor[4] = {0.0f};
+    glGetFloatv(GL_COLOR_CLEAR_VALUE, oldClearColor);
+    const GLboolean oldDepthMask = GL::getDepthMask();
+    glClearColor(0, 0, 0, 0);
+    GL::depthMask(GL_TRUE);
+    GLbitfield mask = GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT;
+    if (_currentTarget->target.depthStencilFormat == GL_DEPTH24_STENCIL8)
+    {
+        GL::stencilMask(0xFF);
+        mask |= GL_STENCIL_BUFFER_BIT;
+    }
+    glClear(mask);
+    GL::depthMask(oldDepthMask);
+    glClearColor(oldClearColor[0], oldClearColor[1], oldClearColor[2], oldClearColor[3]);
+    return true;
+}
+
+void DynamicResolution::endCamera(Camera* /*camera*/)
+{
+    if (!_currentTarget)
+        return;
+
+    glBindFramebuffer(GL_FRAMEBUFFER, _oldFBO);
+    StencilStateManager::invalidateClearedLayers();
+    const auto& viewport = Camera::getDefaultViewport();
+    GL::viewport((GLint)viewport._left, (GLint)viewport._bottom, (GLsizei)viewport._width, (GLsizei)viewport._height);
+
+    const bool depthTest = GL::isEnabled(GL_DEPTH_TEST);
+    GL::disable(GL_DEPTH_TEST);
+    // the target holds premultiplied colors, it was cleared to transparent black
+    GL::blendFunc(GL_ONE, GL_ONE_MINUS_SRC_ALPHA);
+
+    auto director = Director::getInstance();
+    auto program = GLProgramCache::getInstance()->getGLProgram(GLProgram::SHADER_NAME_POSITION_TEXTURE);
+    program->use();
+    director->pushMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION);
+    director->loadIdentityMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION);
+    program->setUniformsForBuiltins(Mat4::IDENTITY);
+    director->popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION);
+
+    static const GLfloat vertices[] = { -1, -1, 1, -1, -1, 1, 1, 1 };
+    static const GLfloat texCoords[] = { 0, 0, 1, 0, 0, 1, 1, 1 };
+    GL::bindTexture2D(_currentTarget->target.texture->getName());
+    GL::bindVAO(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    GL::enableVertexAttribs(GL::VERTEX_ATTRIB_FLAG_POSITION | GL::VERTEX_ATTRIB_FLAG_TEX_COORD);
+    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 2, GL_FLOAT, GL_FALSE, 0, vertices);
+    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORD, 2, GL_FLOAT, GL_FALSE, 0, texCoords);
+    glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);
+    CC_INCREMENT_GL_DRAWN_BATCHES_AND_VERTICES(1, 4);
+
+    if (depthTest)
+    {
+        GL::enable(GL_DEPTH_TEST);
+    }
+    _currentTarget = nullptr;
+}
+
+void DynamicResolution::releaseTargets()
+{
+    for (auto& scaled : _targets)
+    {
+        RenderTargetPool::getInstance()->recycle(scaled.target);
+    }
+    _targets.clear();
+    _currentTarget = nullptr;
+}
+
+NS_CC_END
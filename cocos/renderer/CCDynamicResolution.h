@@ -0,0 +1,150 @@
+/****************************************************************************
+Copyright (c) 2017 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+
+#ifndef __CC_DYNAMIC_RESOLUTION_H__
+#define __CC_DYNAMIC_RESOLUTION_H__
+
+#include <vector>
+
+#include "2d/CCRenderTexture.h"
+
+NS_CC_BEGIN
+
+class Camera;
+class EventListenerCustom;
+
+/**
+ * @addtogroup renderer
+ * @{
+ */
+
+/**
+ * @class DynamicResolution
+ * @brief Renders the world cameras at a lower resolution when the GPU can't hold the frame rate.
+ *
+ * The cameras whose flag is in the camera mask, and which have no FrameBuffer of their own, render into an
+ * offscreen target smaller than their viewport, which is then stretched over it. The other cameras, eg: the
+ * default camera drawing the UI, stay at the native resolution. The pixels the scaled cameras don't cover
+ * show what the cameras before them rendered.
+ *
+ * The scale is adjusted every frame to hold the target frame rate, from the GPU frame time when
+ * `Renderer::setGPUTimingEnabled()` is on, from the frame time otherwise. The targets come from the
+ * RenderTargetPool and go back to it when they are no longer used.
+ *
+ * The scaled cameras have a depth buffer and a stencil buffer when the platform has a packed depth stencil
+ * format. glScissor() isn't scaled, the nodes clipping with it don't clip right under a scaled camera.
+ * @since v3.14
+ * @js NA
+ * @lua NA
+ */
+class CC_DLL DynamicResolution
+{
+public:
+    /** Enables/Disables the dynamic resolution, disabled by default.*/
+    void setEnabled(bool enabled);
+    bool isEnabled() const { return _enabled; }
+
+    /**
+     * Sets the cameras rendered at the scaled resolution, all but CameraFlag::DEFAULT by default.
+     * @param mask The CameraFlag of the cameras, or'ed.
+     */
+    void setCameraMask(unsigned short mask) { _cameraMask = mask; }
+    unsigned short getCameraMask() const { return _cameraMask; }
+
+    /** Sets the frame rate the scale is adjusted for, 0 for the one of the Director's animation interval, the default.*/
+    void setTargetFrameRate(float framesPerSecond) { _targetFrameRate = framesPerSecond; }
+    float getTargetFrameRate() const { return _targetFrameRate; }
+
+    /** Sets the range of the scale of the width and the height, 0.5 to 1 by default.*/
+    void setScaleRange(float minScale, float maxScale);
+    float getMinScale() const { return _minScale; }
+    float getMaxScale() const { return _maxScale; }
+
+    /** Enables/Disables adjusting the scale to the frame time, enabled by default. When it's disabled the scale only changes with setScale().*/
+    void setAutoScaleEnabled(bool enabled) { _autoScale = enabled; }
+    bool isAutoScaleEnabled() const { return _autoScale; }
+
+    /** Sets the scale of the width and the height of the scaled cameras, within the scale range.*/
+    void setScale(float scale);
+    /** The scale the cameras are rendered at, 1 for the native resolution.*/
+    float getScale() const { return _scale; }
+
+    /** Adjusts the scale and gives the targets that weren't used in the last frame back to the pool. Called by the Director.*/
+    void update(float dt);
+
+    /**
+     * Binds the scaled target of a camera, after Camera::apply(). Called by the Scene.
+     * @return false when the camera renders at the native resolution.
+     */
+    bool beginCamera(Camera* camera);
+    /** Stretches the target of the camera over its viewport, before Camera::restore(). Called by the Scene.*/
+    void endCamera(Camera* camera);
+
+    /** Gives all the targets back to the pool.*/
+    void releaseTargets();
+
+CC_CONSTRUCTOR_ACCESS:
+    DynamicResolution();
+    ~DynamicResolution();
+
+protected:
+    struct ScaledTarget
+    {
+        RenderTargetPool::Target target;
+        int width;
+        int height;
+        unsigned int lastFrame;
+    };
+
+    ScaledTarget* getTarget(int width, int height);
+    void adjustScale(float frameTime, bool gpuTime);
+
+    bool _enabled;
+    bool _autoScale;
+    unsigned short _cameraMask;
+    float _targetFrameRate;
+    float _minScale;
+    float _maxScale;
+    float _scale;
+    float _averageFrameTime;
+    float _timeSinceChange;
+    // whether the last change lowered the scale
+    bool _lowered;
+    unsigned int _frame;
+    std::vector<ScaledTarget> _targets;
+    // the target of the camera being rendered
+    ScaledTarget* _currentTarget;
+    GLint _oldFBO;
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+    EventListenerCustom* _backgroundListener;
+#endif
+};
+
+// end of renderer group
+/// @}
+
+NS_CC_END
+
+#endif // __CC_DYNAMIC_RESOLUTION_H__
@@ -0,0 +1,401 @@
+/****************************************************************************
+Copyright (c) 2017 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#include "renderer/CCDynamicTexture.h"
+
+#include <algorithm>
+
+#include "base/CCConfiguration.h"
+#include "base/CCDirector.h"
+#include "base/CCEventDispatcher.h"
+#include "base/CCEventListenerCustom.h"
+#include "base/CCEventType.h"
+#include "renderer/ccGLStateCache.h"
+
+// Pixel unpack buffers are core on desktop GL and GL ES 3, the GL ES 2 headers don't have them.
+// The legacy GL 2.1 context used on Mac has them but no glMapBufferRange().
+#if defined(GL_PIXEL_UNPACK_BUFFER) && (defined(GL_MAP_WRITE_BIT) || (CC_TARGET_PLATFORM == CC_PLATFORM_MAC))
+#define CC_DYNAMIC_TEXTURE_USE_UNPACK_BUFFER 1
+#else
+#define CC_DYNAMIC_TEXTURE_USE_UNPACK_BUFFER 0
+#endif
+
+NS_CC_BEGIN
+
+// the uploads of the last frames may still be read by the GPU from the other buffers
+static const int UNPACK_BUFFER_COUNT = 3;
+static const int MAX_STORAGE_COUNT = 4;
+
+DynamicTexture* DynamicTexture::create(int width, int height, Texture2D::PixelFormat format, int storageCount)
+{
+    auto ret = new (std::nothrow) DynamicTexture();
+    if (ret && ret->init(width, height, format, storageCount))
+    {
+        ret->autorelease();
+        return ret;
+    }
+    CC_SAFE_DELETE(ret);
+    return nullptr;
+}
+
+DynamicTexture::DynamicTexture()
+: _texture(nullptr)
+, _width(0)
+, _height(0)
+, _format(Texture2D::PixelFormat::NONE)
+, _bytesPerPixel(0)
+, _bytesPerRow(0)
+, _currentStorage(0)
+, _currentUnpackBuffer(0)
+, _beforeDrawListener(nullptr)
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+, _rendererRecreatedListener(nullptr)
+#endif
+{
+    _texParams = { GL_LINEAR, GL_LINEAR, GL_CLAMP_TO_EDGE, GL_CLAMP_TO_EDGE };
+}
+
+DynamicTexture::~DynamicTexture()
+{
+    auto eventDispatcher = Director::getInstance()->getEventDispatcher();
+    if (_beforeDrawListener)
+        eventDispatcher->removeEventListener(_beforeDrawListener);
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+    if (_rendererRecreatedListener)
+        eventDispatcher->removeEventListener(_rendererRecreatedListener);
+#endif
+
+    // the texture deletes the storage it uses, it may outlive this object
+    for (auto& storage : _storages)
+    {
+        if (_texture == nullptr || storage.name != _texture->_name)
+            GL::deleteTexture(storage.name);
+    }
+#if CC_DYNAMIC_TEXTURE_USE_UNPACK_BUFFER
+    if (!_unpackBuffers.empty())
+        glDeleteBuffers((GLsizei)_unpackBuffers.size(), _unpackBuffers.data());
+#endif
+    CC_SAFE_RELEASE(_texture);
+}
+
+bool DynamicTexture::init(int width, int height, Texture2D::PixelFormat format, int storageCount)
+{
+    auto& infos = Texture2D::getPixelFormatInfoMap();
+    auto info = infos.find(format);
+    CCASSERT(info != infos.end() && !info->second.compressed, "DynamicTexture: the pixel format has to be an uncompressed one");
+    CCASSERT(width > 0 && height > 0, "DynamicTexture: invalid size");
+    if (info == infos.end() || info->second.compressed || width <= 0 || height <= 0)
+        return false;
+
+    _width = width;
+    _height = height;
+    _format = format;
+    _bytesPerPixel = info->second.bpp / 8;
+    _bytesPerRow = (ssize_t)width * _bytesPerPixel;
+    _pixels.assign(_bytesPerRow * height, 0);
+
+    _texture = new (std::nothrow) Texture2D();
+    if (_texture == nullptr || !_texture->initWithData(_pixels.data(), (ssize_t)_pixels.size(), format, width, height, Size((float)width, (float)height)))
+    {
+        CC_SAFE_RELEASE_NULL(_texture);
+        return false;
+    }
+
+    storageCount = std::min(std::max(storageCount, 1), MAX_STORAGE_COUNT);
+    _storages.resize(storageCount);
+    _storages[0].name = _texture->getName();
+    for (int i = 1; i < storageCount; ++i)
+    {
+        _storages[i].name = createStorage();
+    }
+    _currentStorage = 0;
+
+#if CC_DYNAMIC_TEXTURE_USE_UNPACK_BUFFER
+    _unpackBuffers.resize(UNPACK_BUFFER_COUNT);
+    glGenBuffers(UNPACK_BUFFER_COUNT, _unpackBuffers.data());
+#endif
+
+    auto eventDispatcher = Director::getInstance()->getEventDispatcher();
+    _beforeDrawListener = eventDispatcher->addCustomEventListener(Director::EVENT_BEFORE_DRAW, [this](EventCustom* /*event*/) {
+        commit();
+    });
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+    // the storages were lost with the context, the pixels are still there
+    _rendererRecreatedListener = eventDispatcher->addCustomEventListener(EVENT_RENDERER_RECREATED, [this](EventCustom* /*event*/) {
+        recreate();
+    });
+#endif
+
+    CHECK_GL_ERROR_DEBUG();
+    return true;
+}
+
+GLuint DynamicTexture::createStorage()
+{
+    const auto& info = Texture2D::getPixelFormatInfoMap().at(_format);
+
+    GLuint name = 0;
+    glGenTextures(1, &name);
+    GL::bindTexture2D(name);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, _texParams.minFilter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, _texParams.magFilter);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, _texParams.wrapS);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, _texParams.wrapT);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    glTexImage2D(GL_TEXTURE_2D, 0, info.internalFormat, _width, _height, 0, info.format, info.type, _pixels.data());
+    return name;
+}
+
+void DynamicTexture::recreate()
+{
+    for (auto& storage : _storages)
+    {
+        storage.name = createStorage();
+        storage.dirtyRegions.clear();
+    }
+    _texture->_name = _storages[_currentStorage].name;
+
+#if CC_DYNAMIC_TEXTURE_USE_UNPACK_BUFFER
+    glGenBuffers((GLsizei)_unpackBuffers.size(), _unpackBuffers.data());
+#endif
+}
+
+void DynamicTexture::updateWithData(const void* data, int x, int y, int width, int height)
+{
+    CCASSERT(x >= 0 && y >= 0 && x + width <= _width && y + height <= _height, "DynamicTexture: the region is out of the texture");
+    if (data == nullptr || x < 0 || y < 0 || width <= 0 || height <= 0 || x + width > _width || y + height > _height)
+        return;
+
+    const unsigned char* src = static_cast<const unsigned char*>(data);
+    const size_t rowSize = (size_t)width * _bytesPerPixel;
+    for (int row = 0; row < height; ++row)
+    {
+        memcpy(&_pixels[(y + row) * _bytesPerRow + x * _bytesPerPixel], src + row * rowSize, rowSize);
+    }
+    markDirty(x, y, width, height);
+}
+
+void DynamicTexture::markDirty(int x, int y, int width, int height)
+{
+    Region region;
+    region.x = std::max(x, 0);
+    region.y = std::max(y, 0);
+    region.width = std::min(x + width, _width) - region.x;
+    region.height = std::min(y + height, _height) - region.y;
+    if (region.width <= 0 || region.height <= 0)
+        return;
+
+    // every storage gets the changes made since it was uploaded
+    for (auto& storage : _storages)
+    {
+        addRegion(storage.dirtyRegions, region);
+    }
+}
+
+ssize_t DynamicTexture::getDirtyRegionCount() const
+{
+    return (ssize_t)_storages[(_currentStorage + 1) % _storages.size()].dirtyRegions.size();
+}
+
+void DynamicTexture::addRegion(std::vector<Region>& regions, Region region)
+{
+    auto area = [](const Region& r) { return (long long)r.width * r.height; };
+
+    // merges the regions that overlap or touch, as long as the union doesn't upload many unchanged pixels
+    for (size_t i = 0; i < regions.size();)
+    {
+        const Region& other = regions[i];
+        int left = std::max(region.x, other.x);
+        int bottom = std::max(region.y, other.y);
+        int right = std::min(region.x + region.width, other.x + other.width);
+        int top = std::min(region.y + region.height, other.y + other.height);
+        if (left > right || bottom > top)
+        {
+            ++i;
+            continue;
+        }
+
+        Region merged;
+        merged.x = std::min(region.x, other.x);
+        merged.y = std::min(region.y, other.y);
+        merged.width = std::max(region.x + region.width, other.x + other.width) - merged.x;
+        merged.height = std::max(region.y + region.height, other.y + other.height) - merged.y;
+
+        long long overlap = (long long)(right - left) * (top - bottom);
+        long long unchanged = area(merged) - (area(region) + area(other) - overlap);
+        if (unchanged * 4 > area(merged))
+        {
+            ++i;
+            continue;
+        }
+
+        // the merged region may now touch the regions already checked
+        region = merged;
+        regions.erase(regions.begin() + i);
+        i = 0;
+    }
+    regions.push_back(region);
+
+    if (regions.size() > MAX_DIRTY_REGIONS)
+    {
+        Region bounds = regions[0];
+        for (const auto& r : regions)
+        {
+            int right = std::max(bounds.x + bounds.width, r.x + r.width);
+            int top = std::max(bounds.y + bounds.height, r.y + r.height);
+            bounds.x = std::min(bounds.x, r.x);
+            bounds.y = std::min(bounds.y, r.y);
+            bounds.width = right - bounds.x;
+            bounds.height = top - bounds.y;
+        }
+        regions.clear();
+        regions.push_back(bounds);
+    }
+}
+
+void DynamicTexture::commit()
+{
+    // with several storages the one drawn the longest time ago is updated
+    int next = (_currentStorage + 1) % (int)_storages.size();
+    auto& storage = _storages[next];
+    if (storage.dirtyRegions.empty())
+        return;
+
+    upload(storage.name, storage.dirtyRegions);
+    storage.dirtyRegions.clear();
+
+    _currentStorage = next;
+    _texture->_name = storage.name;
+}
+
+void DynamicTexture::upload(GLuint name, const std::vector<Region>& regions)
+{
+    const auto& info = Texture2D::getPixelFormatInfoMap().at(_format);
+
+    size_t size = 0;
+    for (const auto& region : regions)
+    {
+        size += (size_t)region.width * region.height * _bytesPerPixel;
+    }
+
+    // copies the regions one after the other, tightly packed
+    auto pack = [this, &regions](unsigned char* dst) {
+        for (const auto& region : regions)
+        {
+            const size_t rowSize = (size_t)region.width * _bytesPerPixel;
+            for (int row = 0; row < region.height; ++row)
+            {
+                memcpy(dst, &_pixels[(region.y + row) * _bytesPerRow + region.x * _bytesPerPixel], rowSize);
+                dst += rowSize;
+            }
+        }
+    };
+
+    GL::bindTexture2D(name);
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+#if CC_DYNAMIC_TEXTURE_USE_UNPACK_BUFFER
+    if (!_unpackBuffers.empty())
+    {
+        GLuint buffer = _unpackBuffers[_currentUnpackBuffer];
+        _currentUnpackBuffer = (_currentUnpackBuffer + 1) % (int)_unpackBuffers.size();
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, buffer);
+
+        // the buffer is orphaned, the GPU may still be reading the pixels it had
+#if CC_TARGET_PLATFORM == CC_PLATFORM_MAC
+        glBufferData(GL_PIXEL_UNPACK_BUFFER, (GLsizeiptr)size, nullptr, GL_STREAM_DRAW);
+        void* mapped = glMapBuffer(GL_PIXEL_UNPACK_BUFFER, GL_WRITE_ONLY);
+#else
+        void* mapped = nullptr;
+        if (Configuration::getInstance()->supportsMapBufferRange())
+        {
+            glBufferData(GL_PIXEL_UNPACK_BUFFER, (GLsizeiptr)size, nullptr, GL_STREAM_DRAW);
+            mapped = glMapBufferRange(GL_PIXEL_UNPACK_BUFFER, 0, (GLsizeiptr)size, GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT);
+        }
+#endif
+        if (mapped)
+        {
+            pack(static_cast<unsigned char*>(mapped));
+            glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+        }
+        else
+        {
+            _staging.resize(size);
+            pack(_staging.data());
+            glBufferData(GL_PIXEL_UNPACK_BUFFER, (GLsizeiptr)size, _staging.data(), GL_STREAM_DRAW);
+        }
+
+        size_t offset = 0;
+        for (const auto& region : regions)
+        {
+            glTexSubImage2D(GL_TEXTURE_2D, 0, region.x, region.y, region.width, region.height, info.format, info.type, (const GLvoid*)offset);
+            offset += (size_t)region.width * region.height * _bytesPerPixel;
+        }
+        glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+        CHECK_GL_ERROR_DEBUG();
+        return;
+    }
+#endif
+
+    // without GL_UNPACK_ROW_LENGTH in GL ES 2, only the regions as wide as the texture are uploaded in place
+    size_t offset = 0;
+    bool packed = false;
+    for (const auto& region : regions)
+    {
+        if (region.x == 0 && region.width == _width)
+        {
+            glTexSubImage2D(GL_TEXTURE_2D, 0, 0, region.y, region.width, region.height, info.format, info.type, &_pixels[region.y * _bytesPerRow]);
+        }
+        else
+        {
+            if (!packed)
+            {
+                _staging.resize(size);
+                pack(_staging.data());
+                packed = true;
+            }
+            glTexSubImage2D(GL_TEXTURE_2D, 0, region.x, region.y, region.width, region.height, info.format, info.type, &_staging[offset]);
+        }
+        offset += (size_t)region.width * region.height * _bytesPerPixel;
+    }
+    CHECK_GL_ERROR_DEBUG();
+}
+
+void DynamicTexture::setTexParameters(const Texture2D::TexParams& texParams)
+{
+    _texParams = texParams;
+    for (auto& storage : _storages)
+    {
+        if (storage.name == _texture->_name)
+            continue;
+        GL::bindTexture2D(storage.name);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, texParams.minFilter);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, texParams.magFilter);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, texParams.wrapS);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, texParams.wrapT);
+    }
+    _texture->setTexParameters(texParams);
+}
+
+NS_CC_END
@@ -0,0 +1,162 @@
+/****************************************************************************
+Copyright (c) 2017 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#ifndef __CCDYNAMIC_TEXTURE_H__
+#define __CCDYNAMIC_TEXTURE_H__
+
+#include <vector>
+
+#include "base/CCRef.h"
+#include "renderer/CCTexture2D.h"
+
+NS_CC_BEGIN
+
+class EventListenerCustom;
+
+/**
+ * @addtogroup _2d
+ * @{
+ */
+
+/** @class DynamicTexture
+ * @brief A texture whose pixels change every frame, e.g. video frames, a minimap or a procedural texture.
+ *
+ * The pixels are written in a copy kept in memory, with updateWithData() or getPixels() and markDirty().
+ * The changed regions are merged with the adjacent ones and uploaded once per frame, before the scene is
+ * drawn. Where pixel unpack buffers are available the uploads go through a ring of buffers, so
+ * glTexSubImage2D() returns without waiting for the GPU to read the pixels.
+ *
+ * With more than one storage, every frame uploads into the GL texture that was drawn the longest time ago,
+ * then the Texture2D starts using it. The GPU may still be drawing the previous frame from the other
+ * storages, so the update doesn't wait for it either. The Texture2D object stays the same, the sprites
+ * using it don't have to be told.
+ * @since v3.14
+ */
+class CC_DLL DynamicTexture : public Ref
+{
+public:
+    /** The changed regions are merged into one once there are more of them.*/
+    static const int MAX_DIRTY_REGIONS = 16;
+
+    /** Creates a texture of uncompressed pixels, all of them 0.
+     *
+     * @param width The width of the texture in pixels.
+     * @param height The height of the texture in pixels.
+     * @param format The format of the pixels, it can't be a compressed one.
+     * @param storageCount The number of GL textures the updates cycle through, from 1 to 4.
+     * @return An autoreleased DynamicTexture, or nullptr if the texture can't be created.
+     */
+    static DynamicTexture* create(int width, int height, Texture2D::PixelFormat format = Texture2D::PixelFormat::RGBA8888, int storageCount = 1);
+
+    /** The texture to draw, e.g. with a Sprite.*/
+    Texture2D* getTexture() const { return _texture; }
+
+    int getWidth() const { return _width; }
+    int getHeight() const { return _height; }
+    int getStorageCount() const { return (int)_storages.size(); }
+    ssize_t getBytesPerRow() const { return _bytesPerRow; }
+
+    /** The copy of the pixels, getBytesPerRow() bytes per row from the bottom one.
+     * Call markDirty() after writing in it.
+     */
+    unsigned char* getPixels() { return _pixels.data(); }
+    const unsigned char* getPixels() const { return _pixels.data(); }
+
+    /** Copies the pixels of a region and marks it dirty.
+     *
+     * @param data The pixels of the region, in the format of the texture, tightly packed.
+     */
+    void updateWithData(const void* data, int x, int y, int width, int height);
+
+    /** Marks a region changed in getPixels(), it's uploaded before the next frame is drawn.*/
+    void markDirty(int x, int y, int width, int height);
+    void markAllDirty() { markDirty(0, 0, _width, _height); }
+
+    /** The number of regions waiting for their upload to the next storage.*/
+    ssize_t getDirtyRegionCount() const;
+
+    /** Uploads the dirty regions now instead of before the next frame is drawn.*/
+    void commit();
+
+    /** Sets the parameters of all the storages, Texture2D::setTexParameters() only sets the current one.*/
+    void setTexParameters(const Texture2D::TexParams& texParams);
+
+CC_CONSTRUCTOR_ACCESS:
+    DynamicTexture();
+    virtual ~DynamicTexture();
+
+    bool init(int width, int height, Texture2D::PixelFormat format, int storageCount);
+
+protected:
+    struct Region
+    {
+        int x;
+        int y;
+        int width;
+        int height;
+    };
+
+    struct Storage
+    {
+        GLuint name;
+        std::vector<Region> dirtyRegions;
+    };
+
+    static void addRegion(std::vector<Region>& regions, Region region);
+    GLuint createStorage();
+    void upload(GLuint name, const std::vector<Region>& regions);
+    void recreate();
+
+    Texture2D* _texture;
+    int _width;
+    int _height;
+    Texture2D::PixelFormat _format;
+    int _bytesPerPixel;
+    ssize_t _bytesPerRow;
+    std::vector<unsigned char> _pixels;
+    std::vector<unsigned char> _staging;
+    Texture2D::TexParams _texParams;
+
+    std::vector<Storage> _storages;
+    /** the storage the texture uses */
+    int _currentStorage;
+
+    std::vector<GLuint> _unpackBuffers;
+    int _currentUnpackBuffer;
+
+    EventListenerCustom* _beforeDrawListener;
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+    EventListenerCustom* _rendererRecreatedListener;
+#endif
+
+private:
+    CC_DISALLOW_COPY_AND_ASSIGN(DynamicTexture);
+};
+
+// end of _2d group
+/// @}
+
+NS_CC_END
+
+#endif //__CCDYNAMIC_TEXTURE_H__
@@ -25,6 +25,7 @@
 #include "renderer/CCFrameBuffer.h"
 #include "renderer/CCRenderer.h"
 #include "base/CCDirector.h"
+#include "base/CCStencilStateManager.h"
 #include "base/CCEventCustom.h"
 #include "base/CCEventListenerCustom.h"
 #include "base/CCEventDispatcher.h"
@@ -448,6 +449,7 @@ void FrameBuffer::applyFBO()
     CHECK_GL_ERROR_DEBUG();
     glGetIntegerv(GL_FRAMEBUFFER_BINDING, (GLint*)&_previousFBO);
     glBindFramebuffer(GL_FRAMEBUFFER, _fbo);
+    StencilStateManager::invalidateClearedLayers();
 //    CCASSERT(_fbo==0 || _fbo != _previousFBO, "calling applyFBO without restoring the previous one");
     CHECK_GL_ERROR_DEBUG();
     if(_fboBindingDirty && !isDefaultFBO())
@@ -475,6 +477,7 @@ void FrameBuffer::applyFBO()
 void FrameBuffer::restoreFBO()
 {
     glBindFramebuffer(GL_FRAMEBUFFER, _previousFBO);
+    StencilStateManager::invalidateClearedLayers();
 }
 
 void FrameBuffer::attachDepthStencilTarget(RenderTargetDepthStencil* rt)
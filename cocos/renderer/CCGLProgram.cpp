@@ -35,8 +35,17 @@ THE SOFTWARE.
 #include "base/CCDirector.h"
 #include "base/ccUTF8.h"
 #include "renderer/ccGLStateCache.h"
+#include "renderer/CCGLProgramCache.h"
 #include "platform/CCFileUtils.h"
 
+// GL_OES_get_program_binary on Android, GL_ARB_get_program_binary on desktop.
+// iOS doesn't support program binaries and the legacy GL 2.1 context on Mac doesn't expose them.
+#if defined(GL_PROGRAM_BINARY_LENGTH) && (CC_TARGET_PLATFORM != CC_PLATFORM_MAC) && (CC_TARGET_PLATFORM != CC_PLATFORM_IOS)
+#define CC_GLPROGRAM_USE_BINARY_CACHE 1
+#else
+#define CC_GLPROGRAM_USE_BINARY_CACHE 0
+#endif
+
 // helper functions
 
 static void replaceDefines(const std::string& compileTimeDefines, std::string& out)
@@ -80,6 +89,8 @@ const char* GLProgram::SHADER_NAME_ETC1AS_POSITION_TEXTURE_GRAY_NO_MVP = "#Shade
 
 const char* GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR = "ShaderPositionTextureColor";
 const char* GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR_NO_MVP = "ShaderPositionTextureColor_noMVP";
+const char* GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR_MULTI_TEXTURE_NO_MVP = "ShaderPositionTextureColorMultiTexture_noMVP";
+const char* GLProgram::SHADER_NAME_OVERDRAW_NO_MVP = "ShaderOverdraw_noMVP";
 const char* GLProgram::SHADER_NAME_POSITION_TEXTURE_ALPHA_TEST = "ShaderPositionTextureColorAlphaTest";
 const char* GLProgram::SHADER_NAME_POSITION_TEXTURE_ALPHA_TEST_NO_MV = "ShaderPositionTextureColorAlphaTest_NoMV";
 const char* GLProgram::SHADER_NAME_POSITION_COLOR = "ShaderPositionColor";
@@ -91,11 +102,15 @@ const char* GLProgram::SHADER_NAME_POSITION_TEXTURE_U_COLOR = "ShaderPositionTex
 const char* GLProgram::SHADER_NAME_POSITION_TEXTURE_A8_COLOR = "ShaderPositionTextureA8Color";
 const char* GLProgram::SHADER_NAME_POSITION_U_COLOR = "ShaderPosition_uColor";
 const char* GLProgram::SHADER_NAME_POSITION_LENGTH_TEXTURE_COLOR = "ShaderPositionLengthTextureColor";
+const char* GLProgram::SHADER_NAME_POSITION_LENGTH_TEXTURE_COLOR_NO_MVP = "ShaderPositionLengthTextureColor_noMVP";
 const char* GLProgram::SHADER_NAME_POSITION_GRAYSCALE = "ShaderUIGrayScale";
 const char* GLProgram::SHADER_NAME_LABEL_DISTANCEFIELD_NORMAL = "ShaderLabelDFNormal";
 const char* GLProgram::SHADER_NAME_LABEL_DISTANCEFIELD_GLOW = "ShaderLabelDFGlow";
 const char* GLProgram::SHADER_NAME_LABEL_NORMAL = "ShaderLabelNormal";
 const char* GLProgram::SHADER_NAME_LABEL_OUTLINE = "ShaderLabelOutline";
+const char* GLProgram::SHADER_NAME_LABEL_NORMAL_NO_MVP = "ShaderLabelNormal_noMVP";
+const char* GLProgram::SHADER_NAME_LABEL_OUTLINE_NO_MVP = "ShaderLabelOutline_noMVP";
+const char* GLProgram::SHADER_NAME_LABEL_DISTANCEFIELD_NORMAL_NO_MVP = "ShaderLabelDFNormal_noMVP";
 
 const char* GLProgram::SHADER_3D_POSITION = "Shader3DPosition";
 const char* GLProgram::SHADER_3D_POSITION_TEXTURE = "Shader3DPositionTexture";
@@ -105,6 +120,12 @@ const char* GLProgram::SHADER_3D_POSITION_NORMAL_TEXTURE = "Shader3DPositionNorm
 const char* GLProgram::SHADER_3D_SKINPOSITION_NORMAL_TEXTURE = "Shader3DSkinPositionNormalTexture";
 const char* GLProgram::SHADER_3D_POSITION_BUMPEDNORMAL_TEXTURE = "Shader3DPositionBumpedNormalTexture";
 const char* GLProgram::SHADER_3D_SKINPOSITION_BUMPEDNORMAL_TEXTURE = "Shader3DSkinPositionBumpedNormalTexture";
+const char* GLProgram::SHADER_3D_POSITION_INSTANCED = "Shader3DPositionInstanced";
+const char* GLProgram::SHADER_3D_POSITION_TEXTURE_INSTANCED = "Shader3DPositionTextureInstanced";
+const char* GLProgram::SHADER_3D_POSITION_NORMAL_INSTANCED = "Shader3DPositionNormalInstanced";
+const char* GLProgram::SHADER_3D_POSITION_NORMAL_TEXTURE_INSTANCED = "Shader3DPositionNormalTextureInstanced";
+const char* GLProgram::SHADER_3D_SKINPOSITION_TEXTURE_INSTANCED = "Shader3DSkinPositionTextureInstanced";
+const char* GLProgram::SHADER_3D_SKINPOSITION_NORMAL_TEXTURE_INSTANCED = "Shader3DSkinPositionNormalTextureInstanced";
 const char* GLProgram::SHADER_3D_PARTICLE_COLOR = "Shader3DParticleColor";
 const char* GLProgram::SHADER_3D_PARTICLE_TEXTURE = "Shader3DParticleTexture";
 const char* GLProgram::SHADER_3D_SKYBOX = "Shader3DSkybox";
@@ -129,6 +150,8 @@ const char* GLProgram::UNIFORM_NAME_SAMPLER0 = "CC_Texture0";
 const char* GLProgram::UNIFORM_NAME_SAMPLER1 = "CC_Texture1";
 const char* GLProgram::UNIFORM_NAME_SAMPLER2 = "CC_Texture2";
 const char* GLProgram::UNIFORM_NAME_SAMPLER3 = "CC_Texture3";
+const char* GLProgram::UNIFORM_NAME_BONE_TEXTURE = "CC_BoneTexture";
+const char* GLProgram::UNIFORM_NAME_BONE_TEXTURE_INV_SIZE = "CC_BoneTextureInvSize";
 const char* GLProgram::UNIFORM_NAME_ALPHA_TEST_VALUE = "CC_alpha_value";
 
 // Attribute names
@@ -143,6 +166,8 @@ const char* GLProgram::ATTRIBUTE_NAME_BLEND_WEIGHT = "a_blendWeight";
 const char* GLProgram::ATTRIBUTE_NAME_BLEND_INDEX = "a_blendIndex";
 const char* GLProgram::ATTRIBUTE_NAME_TANGENT = "a_tangent";
 const char* GLProgram::ATTRIBUTE_NAME_BINORMAL = "a_binormal";
+const char* GLProgram::ATTRIBUTE_NAME_INSTANCE_MV_MATRIX = "a_instanceMVMatrix";
+const char* GLProgram::ATTRIBUTE_NAME_INSTANCE_BONE_ROW = "a_instanceBoneRow";
 
 
 
@@ -163,6 +188,28 @@ static const char * COCOS2D_SHADER_UNIFORMS =
         "uniform sampler2D CC_Texture3;\n"
         "//CC INCLUDES END\n\n";
 
+// Vertex shaders compiled with the CC_INSTANCING define read the model view matrix from a per instance attribute.
+// The built in matrices are remapped so that the regular 3D shaders can be used unchanged.
+static const char * COCOS2D_SHADER_INSTANCING =
+        "#ifdef CC_INSTANCING\n"
+        "attribute mat4 a_instanceMVMatrix;\n"
+        "#define CC_MVMatrix a_instanceMVMatrix\n"
+        "#define CC_MVPMatrix (CC_PMatrix * a_instanceMVMatrix)\n"
+        "#define CC_NormalMatrix mat3(a_instanceMVMatrix[0].xyz, a_instanceMVMatrix[1].xyz, a_instanceMVMatrix[2].xyz)\n"
+        "#endif\n"
+        // Skinned shaders compiled with the CC_BONE_TEXTURE define read the rows of the matrix palette from a float texture,
+        // one texture row per palette. The CC_ prefix keeps the uniforms out of the GLProgramState, they are set by MeshCommand.
+        "#ifdef CC_BONE_TEXTURE\n"
+        "attribute float a_instanceBoneRow;\n"
+        "#ifdef GL_ES\n"
+        "uniform highp sampler2D CC_BoneTexture;\n"
+        "#else\n"
+        "uniform sampler2D CC_BoneTexture;\n"
+        "#endif\n"
+        "uniform vec2 CC_BoneTextureInvSize;\n"
+        "#define CC_MATRIX_PALETTE(index) texture2D(CC_BoneTexture, vec2((float(index) + 0.5) * CC_BoneTextureInvSize.x, (a_instanceBoneRow + 0.5) * CC_BoneTextureInvSize.y))\n"
+        "#endif\n";
+
 static const std::string EMPTY_DEFINE;
 
 GLProgram* GLProgram::createWithByteArrays(const GLchar* vShaderByteArray, const GLchar* fShaderByteArray)
@@ -217,6 +264,10 @@ GLProgram::GLProgram()
 : _program(0)
 , _vertShader(0)
 , _fragShader(0)
+, _programBinaryFormat(0)
+, _appliedUniformStateId(0)
+, _appliedUniformStateVersion(0)
+, _applyingUniforms(false)
 , _flags()
 {
     _director = Director::getInstance();
@@ -260,10 +311,46 @@ bool GLProgram::initWithByteArrays(const GLchar* vShaderByteArray, const GLchar*
     replaceDefines(compileTimeDefines, replacedDefines);
 
     _vertShader = _fragShader = 0;
+    _programBinarySources.clear();
+    _programBinary.clear();
+
+#if CC_GLPROGRAM_USE_BINARY_CACHE
+    auto cache = GLProgramCache::getInstance();
+    if (cache && cache->isProgramBinaryCacheEnabled())
+    {
+        // everything that ends up in the shaders is part of the key
+        _programBinarySources = compileTimeHeaders + "\n" + replacedDefines + "\n" + COCOS2D_SHADER_UNIFORMS + COCOS2D_SHADER_INSTANCING
+            + (vShaderByteArray ? vShaderByteArray : "") + "\n" + (fShaderByteArray ? fShaderByteArray : "");
+
+        if (cache->getProgramBinary(_programBinarySources, &_programBinaryFormat, &_programBinary))
+        {
+            // the shaders are only compiled by link() if the driver rejects the binary
+            _pendingVertSource = vShaderByteArray ? vShaderByteArray : "";
+            _pendingFragSource = fShaderByteArray ? fShaderByteArray : "";
+            _pendingCompileTimeHeaders = compileTimeHeaders;
+            _pendingDefines = replacedDefines;
+
+            clearHashUniforms();
+            return true;
+        }
+    }
+#endif
+
+    if (!compileAndAttachShaders(vShaderByteArray, fShaderByteArray, compileTimeHeaders, replacedDefines))
+        return false;
+
+    clearHashUniforms();
 
+    CHECK_GL_ERROR_DEBUG();
+
+    return true;
+}
+
+bool GLProgram::compileAndAttachShaders(const GLchar* vShaderByteArray, const GLchar* fShaderByteArray, const std::string& compileTimeHeaders, const std::string& convertedDefines)
+{
     if (vShaderByteArray)
     {
-        if (!compileShader(&_vertShader, GL_VERTEX_SHADER, vShaderByteArray, compileTimeHeaders, replacedDefines))
+        if (!compileShader(&_vertShader, GL_VERTEX_SHADER, vShaderByteArray, compileTimeHeaders, convertedDefines))
         {
             CCLOG("cocos2d: ERROR: Failed to compile vertex shader");
             return false;
@@ -273,7 +360,7 @@ bool GLProgram::initWithByteArrays(const GLchar* vShaderByteArray, const GLchar*
     // Create and compile fragment shader
     if (fShaderByteArray)
     {
-        if (!compileShader(&_fragShader, GL_FRAGMENT_SHADER, fShaderByteArray, compileTimeHeaders, replacedDefines))
+        if (!compileShader(&_fragShader, GL_FRAGMENT_SHADER, fShaderByteArray, compileTimeHeaders, convertedDefines))
         {
             CCLOG("cocos2d: ERROR: Failed to compile fragment shader");
             return false;
@@ -291,10 +378,6 @@ bool GLProgram::initWithByteArrays(const GLchar* vShaderByteArray, const GLchar*
         glAttachShader(_program, _fragShader);
     }
 
-    clearHashUniforms();
-
-    CHECK_GL_ERROR_DEBUG();
-
     return true;
 }
 
@@ -496,6 +579,7 @@ bool GLProgram::compileShader(GLuint * shader, GLenum type, const GLchar* source
         headersDef.c_str(),
         COCOS2D_SHADER_UNIFORMS,
         convertedDefines.c_str(),
+        type == GL_VERTEX_SHADER ? COCOS2D_SHADER_INSTANCING : "",
         source};
 
     *shader = glCreateShader(type);
@@ -565,6 +649,9 @@ void GLProgram::updateUniforms()
     _builtInUniforms[UNIFORM_SAMPLER2] = glGetUniformLocation(_program, UNIFORM_NAME_SAMPLER2);
     _builtInUniforms[UNIFORM_SAMPLER3] = glGetUniformLocation(_program, UNIFORM_NAME_SAMPLER3);
 
+    _builtInUniforms[UNIFORM_BONE_TEXTURE] = glGetUniformLocation(_program, UNIFORM_NAME_BONE_TEXTURE);
+    _builtInUniforms[UNIFORM_BONE_TEXTURE_INV_SIZE] = glGetUniformLocation(_program, UNIFORM_NAME_BONE_TEXTURE_INV_SIZE);
+
     _flags.usesP = _builtInUniforms[UNIFORM_P_MATRIX] != -1;
     _flags.usesMultiViewP = _builtInUniforms[UNIFORM_MULTIVIEW_P_MATRIX] != -1;
     _flags.usesMV = _builtInUniforms[UNIFORM_MV_MATRIX] != -1;
@@ -589,6 +676,8 @@ void GLProgram::updateUniforms()
         setUniformLocationWith1i(_builtInUniforms[UNIFORM_SAMPLER2], 2);
     if(_builtInUniforms[UNIFORM_SAMPLER3] != -1)
         setUniformLocationWith1i(_builtInUniforms[UNIFORM_SAMPLER3], 3);
+    if(_builtInUniforms[UNIFORM_BONE_TEXTURE] != -1)
+        setUniformLocationWith1i(_builtInUniforms[UNIFORM_BONE_TEXTURE], BONE_TEXTURE_UNIT);
 
     // clear any glErrors created by any not found uniforms
     glGetError();
@@ -602,6 +691,51 @@ bool GLProgram::link()
 
     bindPredefinedVertexAttribs();
 
+#if CC_GLPROGRAM_USE_BINARY_CACHE
+    if (!_programBinary.isNull())
+    {
+        glProgramBinary(_program, _programBinaryFormat, _programBinary.getBytes(), (GLsizei)_programBinary.getSize());
+        glGetProgramiv(_program, GL_LINK_STATUS, &status);
+        _programBinary.clear();
+
+        bool compiled = true;
+        if (status == GL_FALSE)
+        {
+            // binaries can be rejected even when the driver strings didn't change
+            CCLOG("cocos2d: program binary rejected by the driver, compiling the shaders");
+            compiled = compileAndAttachShaders(_pendingVertSource.empty() ? nullptr : _pendingVertSource.c_str(),
+                                               _pendingFragSource.empty() ? nullptr : _pendingFragSource.c_str(),
+                                               _pendingCompileTimeHeaders, _pendingDefines);
+        }
+        _pendingVertSource.clear();
+        _pendingFragSource.clear();
+        _pendingCompileTimeHeaders.clear();
+        _pendingDefines.clear();
+
+        if (status == GL_TRUE)
+        {
+            _programBinarySources.clear();
+            parseVertexAttribs();
+            parseUniforms();
+            return true;
+        }
+        if (!compiled)
+        {
+            _programBinarySources.clear();
+            GL::deleteProgram(_program);
+            _program = 0;
+            return false;
+        }
+    }
+
+#ifdef GL_PROGRAM_BINARY_RETRIEVABLE_HINT
+    if (!_programBinarySources.empty())
+    {
+        glProgramParameteri(_program, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+    }
+#endif
+#endif
+
     glLinkProgram(_program);
 
     // Calling glGetProgramiv(...GL_LINK_STATUS...) will force linking of the program at this moment.
@@ -623,11 +757,36 @@ bool GLProgram::link()
         parseUniforms();
 
         clearShader();
+
+        saveProgramBinary();
     }
+    _programBinarySources.clear();
 
     return (status == GL_TRUE);
 }
 
+void GLProgram::saveProgramBinary()
+{
+#if CC_GLPROGRAM_USE_BINARY_CACHE
+    if (_programBinarySources.empty())
+        return;
+
+    GLint length = 0;
+    glGetProgramiv(_program, GL_PROGRAM_BINARY_LENGTH, &length);
+    if (length <= 0)
+        return;
+
+    GLenum format = 0;
+    unsigned char* bytes = (unsigned char*)malloc(length);
+    glGetProgramBinary(_program, length, &length, &format, bytes);
+
+    Data binary;
+    binary.fastSet(bytes, length);
+    GLProgramCache::getInstance()->addProgramBinary(_programBinarySources, format, binary);
+    CHECK_GL_ERROR_DEBUG();
+#endif
+}
+
 void GLProgram::use()
 {
     GL::useProgram(_program);
@@ -717,6 +876,12 @@ bool GLProgram::updateUniformLocation(GLint location, const GLvoid* data, unsign
         }
     }
 
+    // the value was set outside of GLProgramState::applyUniforms(), it can't skip its values next time
+    if (updated && !_applyingUniforms)
+    {
+        _appliedUniformStateId = 0;
+    }
+
     return updated;
 }
 
@@ -923,6 +1088,9 @@ void GLProgram::setUniformsForBuiltins(const Mat4 &matrixMV)
 {
     const auto& matrixP = _director->getMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION);
 
+    // built-in uniforms don't overlap the user uniforms
+    _applyingUniforms = true;
+
     if (_flags.usesP)
         setUniformLocationWithMatrix4fv(_builtInUniforms[UNIFORM_P_MATRIX], matrixP.m, 1);
     
@@ -981,6 +1149,8 @@ void GLProgram::setUniformsForBuiltins(const Mat4 &matrixMV)
 
     if (_flags.usesRandom)
         setUniformLocationWith4f(_builtInUniforms[GLProgram::UNIFORM_RANDOM01], CCRANDOM_0_1(), CCRANDOM_0_1(), CCRANDOM_0_1(), CCRANDOM_0_1());
+
+    _applyingUniforms = false;
 }
 
 void GLProgram::reset()
@@ -1019,6 +1189,7 @@ inline void GLProgram::clearHashUniforms()
     }
 
     _hashForUniforms.clear();
+    _appliedUniformStateId = 0;
 }
 
 NS_CC_END
@@ -35,6 +35,7 @@ THE SOFTWARE.
 
 #include "base/ccMacros.h"
 #include "base/CCRef.h"
+#include "base/CCData.h"
 #include "base/ccTypes.h"
 #include "platform/CCGL.h"
 #include "math/CCMath.h"
@@ -153,9 +154,19 @@ public:
         UNIFORM_SAMPLER2,
         UNIFORM_SAMPLER3,
         /**@}*/
+        /**Bone matrix texture, used for GPU skinning of instanced meshes.*/
+        UNIFORM_BONE_TEXTURE,
+        /**Inverse size of the bone matrix texture.*/
+        UNIFORM_BONE_TEXTURE_INV_SIZE,
         UNIFORM_MAX,
     };
 
+    /**Texture unit the bone matrix texture is bound to.*/
+    enum
+    {
+        BONE_TEXTURE_UNIT = 7,
+    };
+
     /** Flags used by the uniforms */
     struct UniformFlags {
         unsigned int usesTime:1;
@@ -185,6 +196,17 @@ public:
     static const char* SHADER_NAME_POSITION_TEXTURE_COLOR;
     /**Built in shader for 2d. Support Position, Texture and Color vertex attribute, but without multiply vertex by MVP matrix.*/
     static const char* SHADER_NAME_POSITION_TEXTURE_COLOR_NO_MVP;
+    /**
+    Built in shader for 2d. Like SHADER_NAME_POSITION_TEXTURE_COLOR_NO_MVP, but samples one of CC_Texture0-3 selected by the
+    per vertex attribute `a_textureSlot`. Used by the Renderer to batch sprites with different textures.
+    */
+    static const char* SHADER_NAME_POSITION_TEXTURE_COLOR_MULTI_TEXTURE_NO_MVP;
+    /**
+    Built in shader for 2d. Like SHADER_NAME_POSITION_TEXTURE_COLOR_NO_MVP, but outputs a constant color to be added to the
+    framebuffer, used by the overdraw visualization of the Renderer.
+    @since v3.14
+    */
+    static const char* SHADER_NAME_OVERDRAW_NO_MVP;
     /**Built in shader for 2d. Support Position, Texture vertex attribute, but include alpha test.*/
     static const char* SHADER_NAME_POSITION_TEXTURE_ALPHA_TEST;
     /**Built in shader for 2d. Support Position, Texture and Color vertex attribute, include alpha test and without multiply vertex by MVP matrix.*/
@@ -205,6 +227,11 @@ public:
     static const char* SHADER_NAME_POSITION_U_COLOR;
     /**Built in shader for draw a sector with 90 degrees with center at bottom left point.*/
     static const char* SHADER_NAME_POSITION_LENGTH_TEXTURE_COLOR;
+    /**Built in shader for static DrawNode batching. Same as SHADER_NAME_POSITION_LENGTH_TEXTURE_COLOR, but the vertices are already in world space
+     and the color is already premultiplied by the node opacity.
+     @since v3.14
+     */
+    static const char* SHADER_NAME_POSITION_LENGTH_TEXTURE_COLOR_NO_MVP;
 
     /**Built in shader for ui effects */
     static const char* SHADER_NAME_POSITION_GRAYSCALE;
@@ -215,6 +242,15 @@ public:
     static const char* SHADER_NAME_LABEL_OUTLINE;
     static const char* SHADER_NAME_LABEL_DISTANCEFIELD_NORMAL;
     static const char* SHADER_NAME_LABEL_DISTANCEFIELD_GLOW;
+    /** @} */
+    /** @{
+        Built in shader for label. Like the label shaders above, but the vertices are already in world space so that
+        labels can be drawn through QuadCommands and batched by the renderer. The pass color is baked into the vertex colors.
+    */
+    static const char* SHADER_NAME_LABEL_NORMAL_NO_MVP;
+    static const char* SHADER_NAME_LABEL_OUTLINE_NO_MVP;
+    static const char* SHADER_NAME_LABEL_DISTANCEFIELD_NORMAL_NO_MVP;
+    /** @} */
 
     /**Built in shader used for 3D, support Position vertex attribute, with color specified by a uniform.*/
     static const char* SHADER_3D_POSITION;
@@ -247,6 +283,28 @@ public:
     used in lighting. with color specified by a uniform.
     */
     static const char* SHADER_3D_SKINPOSITION_BUMPEDNORMAL_TEXTURE;
+    /**@{
+    Instanced variants of the built in 3D shaders. The model view matrix is read from the per instance
+    attribute ATTRIBUTE_NAME_INSTANCE_MV_MATRIX instead of the CC_MVMatrix uniform. The normal matrix is
+    taken from the upper 3x3 of the instance matrix, so instances are expected to be uniformly scaled.
+    Only loaded when Configuration::supportsInstancing() is true.
+    */
+    static const char* SHADER_3D_POSITION_INSTANCED;
+    static const char* SHADER_3D_POSITION_TEXTURE_INSTANCED;
+    static const char* SHADER_3D_POSITION_NORMAL_INSTANCED;
+    static const char* SHADER_3D_POSITION_NORMAL_TEXTURE_INSTANCED;
+    /**@}*/
+    /**@{
+    Instanced variants of the built in skinned 3D shaders, compiled with the CC_INSTANCING and CC_BONE_TEXTURE
+    defines. The matrix palette is read from the bone matrix texture row given by the per instance attribute
+    ATTRIBUTE_NAME_INSTANCE_BONE_ROW instead of the u_matrixPalette uniform, so the bone count isn't limited by
+    the uniform budget. Only loaded when Configuration::supportsInstancing() and
+    Configuration::supportsBoneTexture() are true.
+    @since v3.14
+    */
+    static const char* SHADER_3D_SKINPOSITION_TEXTURE_INSTANCED;
+    static const char* SHADER_3D_SKINPOSITION_NORMAL_TEXTURE_INSTANCED;
+    /**@}*/
     /**
     Built in shader for particles, support Position and Texture, with a color specified by a uniform.
     */
@@ -316,6 +374,10 @@ public:
     /**
     @}
     */
+    /**Bone matrix texture uniform.*/
+    static const char* UNIFORM_NAME_BONE_TEXTURE;
+    /**Bone matrix texture inverse size uniform.*/
+    static const char* UNIFORM_NAME_BONE_TEXTURE_INV_SIZE;
     /**Alpha test value uniform.*/
     static const char* UNIFORM_NAME_ALPHA_TEST_VALUE;
     /**
@@ -347,6 +409,10 @@ public:
     static const char* ATTRIBUTE_NAME_TANGENT;
     /**Attribute blend binormal.*/
     static const char* ATTRIBUTE_NAME_BINORMAL;
+    /**Attribute per instance model view matrix, used by shaders compiled with the CC_INSTANCING define.*/
+    static const char* ATTRIBUTE_NAME_INSTANCE_MV_MATRIX;
+    /**Attribute per instance row of the bone matrix texture, used by shaders compiled with the CC_BONE_TEXTURE define.*/
+    static const char* ATTRIBUTE_NAME_INSTANCE_BONE_ROW;
     /**
     end of Built Attribute names
     @}
@@ -438,6 +504,9 @@ public:
     /** calls retrieves the named uniform location for this shader program. */
     GLint getUniformLocationForName(const char* name) const;
 
+    /** Returns the location of a preallocated uniform, -1 if the program does not use it. */
+    GLint getBuiltInUniformLocation(int uniform) const { return _builtInUniforms[uniform]; }
+
     /** calls glUniform1i only if the values are different than the previous call for this same shader program.
      * @js setUniformLocationI32
      * @lua setUniformLocationI32
@@ -566,6 +635,10 @@ protected:
     bool compileShader(GLuint * shader, GLenum type, const GLchar* source, const std::string& compileTimeHeaders, const std::string& convertedDefines);
     bool compileShader(GLuint * shader, GLenum type, const GLchar* source, const std::string& convertedDefines);
     bool compileShader(GLuint * shader, GLenum type, const GLchar* source);
+    /**Compile the shaders and attach them to the program.*/
+    bool compileAndAttachShaders(const GLchar* vShaderByteArray, const GLchar* fShaderByteArray, const std::string& compileTimeHeaders, const std::string& convertedDefines);
+    /**Save the linked program to the program binary cache.*/
+    void saveProgramBinary();
     void clearShader();
 
     void clearHashUniforms();
@@ -578,6 +651,16 @@ protected:
     GLuint            _fragShader;
     /**Built in uniforms.*/
     GLint             _builtInUniforms[UNIFORM_MAX];
+    /**Key of the program in the program binary cache, empty when the cache is disabled.*/
+    std::string       _programBinarySources;
+    /**Binary restored from the cache, loaded by link().*/
+    Data              _programBinary;
+    GLenum            _programBinaryFormat;
+    /**Shader sources kept until link() in case the driver rejects the binary.*/
+    std::string       _pendingVertSource;
+    std::string       _pendingFragSource;
+    std::string       _pendingCompileTimeHeaders;
+    std::string       _pendingDefines;
     /**Indicate whether it has a offline shader compiler or not.*/
     bool              _hasShaderCompiler;
 
@@ -587,6 +670,11 @@ protected:
     std::unordered_map<std::string, VertexAttrib> _vertexAttribs;
     /**Hash value of uniforms for quick access.*/
     std::unordered_map<GLint, std::pair<GLvoid*, unsigned int>> _hashForUniforms;
+    /**Id and version of the GLProgramState whose user uniforms are in _hashForUniforms, the id is 0 when unknown.*/
+    unsigned int _appliedUniformStateId;
+    unsigned int _appliedUniformStateVersion;
+    /**True while the built-in uniforms or the uniforms of a GLProgramState are applied, other updates reset _appliedUniformStateId.*/
+    bool _applyingUniforms;
     //cached director pointer for calling
     Director* _director;
 
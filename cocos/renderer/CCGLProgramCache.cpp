@@ -34,12 +34,21 @@ THE SOFTWARE.
 #include "base/CCEventListenerCustom.h"
 #include "base/CCDirector.h"
 #include "base/CCEventDispatcher.h"
+#include "base/ccUTF8.h"
+#include "platform/CCFileUtils.h"
+#include "xxhash.h"
+
+#include <unordered_set>
 
 NS_CC_BEGIN
 
+extern const char* cocos2dVersion();
+
 enum {
     kShaderType_PositionTextureColor,
     kShaderType_PositionTextureColor_noMVP,
+    kShaderType_PositionTextureColorMultiTexture_noMVP,
+    kShaderType_Overdraw_noMVP,
     kShaderType_PositionTextureColorAlphaTest,
     kShaderType_PositionTextureColorAlphaTestNoMV,
     kShaderType_PositionColor,
@@ -50,11 +59,15 @@ enum {
     kShaderType_PositionTextureA8Color,
     kShaderType_Position_uColor,
     kShaderType_PositionLengthTextureColor,
+    kShaderType_PositionLengthTextureColor_noMVP,
     kShaderType_LabelDistanceFieldNormal,
     kShaderType_LabelDistanceFieldGlow,
     kShaderType_UIGrayScale,
     kShaderType_LabelNormal,
     kShaderType_LabelOutline,
+    kShaderType_LabelNormal_noMVP,
+    kShaderType_LabelOutline_noMVP,
+    kShaderType_LabelDistanceFieldNormal_noMVP,
     kShaderType_3DPosition,
     kShaderType_3DPositionTex,
     kShaderType_3DSkinPositionTex,
@@ -75,11 +88,34 @@ enum {
     kShaderType_ETC1ASPositionTextureGray,
     kShaderType_ETC1ASPositionTextureGray_noMVP,
     kShaderType_LayerRadialGradient,
+    // hardware instancing supports.
+    kShaderType_3DPositionInstanced,
+    kShaderType_3DPositionTexInstanced,
+    kShaderType_3DPositionNormalInstanced,
+    kShaderType_3DPositionNormalTexInstanced,
+    kShaderType_3DSkinPositionTexInstanced,
+    kShaderType_3DSkinPositionNormalTexInstanced,
     kShaderType_MAX,
 };
 
 static GLProgramCache *_sharedGLProgramCache = nullptr;
 
+namespace
+{
+    // Bump it when the layout of the binary files changes
+    const unsigned int PROGRAM_BINARY_MAGIC = 0x42504343; // "CCPB"
+    const unsigned int PROGRAM_BINARY_VERSION = 1;
+
+    struct ProgramBinaryHeader
+    {
+        unsigned int magic;
+        unsigned int version;
+        unsigned int driverHash;
+        unsigned int format;
+        unsigned int length;
+    };
+}
+
 GLProgramCache* GLProgramCache::getInstance()
 {
     if (!_sharedGLProgramCache) {
@@ -111,6 +147,8 @@ void GLProgramCache::purgeSharedShaderCache()
 
 GLProgramCache::GLProgramCache()
 : _programs()
+, _programBinaryCacheEnabled(false)
+, _driverHash(0)
 {
 
 }
@@ -126,6 +164,7 @@ GLProgramCache::~GLProgramCache()
 
 bool GLProgramCache::init()
 {
+    setProgramBinaryCacheEnabled(Configuration::getInstance()->useProgramBinaryCache());
     loadDefaultGLPrograms();
     
     auto listener = EventListenerCustom::create(Configuration::CONFIG_FILE_LOADED, [this](EventCustom* /*event*/){
@@ -149,6 +188,16 @@ void GLProgramCache::loadDefaultGLPrograms()
     loadDefaultGLProgram(p, kShaderType_PositionTextureColor_noMVP);
     _programs.emplace(GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR_NO_MVP, p);
 
+    // Position Texture Color without MVP shader, sampling up to 4 textures
+    p = new (std::nothrow) GLProgram();
+    loadDefaultGLProgram(p, kShaderType_PositionTextureColorMultiTexture_noMVP);
+    _programs.emplace(GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR_MULTI_TEXTURE_NO_MVP, p);
+
+    // Overdraw visualization, without MVP
+    p = new (std::nothrow) GLProgram();
+    loadDefaultGLProgram(p, kShaderType_Overdraw_noMVP);
+    _programs.emplace(GLProgram::SHADER_NAME_OVERDRAW_NO_MVP, p);
+
     // Position Texture Color alpha test
     p = new (std::nothrow) GLProgram();
     loadDefaultGLProgram(p, kShaderType_PositionTextureColorAlphaTest);
@@ -212,6 +261,10 @@ void GLProgramCache::loadDefaultGLPrograms()
     loadDefaultGLProgram(p, kShaderType_PositionLengthTextureColor);
     _programs.emplace(GLProgram::SHADER_NAME_POSITION_LENGTH_TEXTURE_COLOR, p);
 
+    p = new (std::nothrow) GLProgram();
+    loadDefaultGLProgram(p, kShaderType_PositionLengthTextureColor_noMVP);
+    _programs.emplace(GLProgram::SHADER_NAME_POSITION_LENGTH_TEXTURE_COLOR_NO_MVP, p);
+
     p = new (std::nothrow) GLProgram();
     loadDefaultGLProgram(p, kShaderType_LabelDistanceFieldNormal);
     _programs.emplace(GLProgram::SHADER_NAME_LABEL_DISTANCEFIELD_NORMAL, p);
@@ -232,6 +285,18 @@ void GLProgramCache::loadDefaultGLPrograms()
     loadDefaultGLProgram(p, kShaderType_LabelOutline);
     _programs.emplace(GLProgram::SHADER_NAME_LABEL_OUTLINE, p);
 
+    p = new (std::nothrow) GLProgram();
+    loadDefaultGLProgram(p, kShaderType_LabelNormal_noMVP);
+    _programs.emplace(GLProgram::SHADER_NAME_LABEL_NORMAL_NO_MVP, p);
+
+    p = new (std::nothrow) GLProgram();
+    loadDefaultGLProgram(p, kShaderType_LabelOutline_noMVP);
+    _programs.emplace(GLProgram::SHADER_NAME_LABEL_OUTLINE_NO_MVP, p);
+
+    p = new (std::nothrow) GLProgram();
+    loadDefaultGLProgram(p, kShaderType_LabelDistanceFieldNormal_noMVP);
+    _programs.emplace(GLProgram::SHADER_NAME_LABEL_DISTANCEFIELD_NORMAL_NO_MVP, p);
+
     p = new (std::nothrow) GLProgram();
     loadDefaultGLProgram(p, kShaderType_3DPosition);
     _programs.emplace(GLProgram::SHADER_3D_POSITION, p);
@@ -305,6 +370,38 @@ void GLProgramCache::loadDefaultGLPrograms()
     p = new(std::nothrow) GLProgram();
     loadDefaultGLProgram(p, kShaderType_LayerRadialGradient);
     _programs.emplace(GLProgram::SHADER_LAYER_RADIAL_GRADIENT, p);
+
+    /// hardware instancing supports.
+    if (Configuration::getInstance()->supportsInstancing())
+    {
+        p = new(std::nothrow) GLProgram();
+        loadDefaultGLProgram(p, kShaderType_3DPositionInstanced);
+        _programs.emplace(GLProgram::SHADER_3D_POSITION_INSTANCED, p);
+
+        p = new(std::nothrow) GLProgram();
+        loadDefaultGLProgram(p, kShaderType_3DPositionTexInstanced);
+        _programs.emplace(GLProgram::SHADER_3D_POSITION_TEXTURE_INSTANCED, p);
+
+        p = new(std::nothrow) GLProgram();
+        loadDefaultGLProgram(p, kShaderType_3DPositionNormalInstanced);
+        _programs.emplace(GLProgram::SHADER_3D_POSITION_NORMAL_INSTANCED, p);
+
+        p = new(std::nothrow) GLProgram();
+        loadDefaultGLProgram(p, kShaderType_3DPositionNormalTexInstanced);
+        _programs.emplace(GLProgram::SHADER_3D_POSITION_NORMAL_TEXTURE_INSTANCED, p);
+
+        /// bone matrix texture supports.
+        if (Configuration::getInstance()->supportsBoneTexture())
+        {
+            p = new(std::nothrow) GLProgram();
+            loadDefaultGLProgram(p, kShaderType_3DSkinPositionTexInstanced);
+            _programs.emplace(GLProgram::SHADER_3D_SKINPOSITION_TEXTURE_INSTANCED, p);
+
+            p = new(std::nothrow) GLProgram();
+            loadDefaultGLProgram(p, kShaderType_3DSkinPositionNormalTexInstanced);
+            _programs.emplace(GLProgram::SHADER_3D_SKINPOSITION_NORMAL_TEXTURE_INSTANCED, p);
+        }
+    }
 }
 
 void GLProgramCache::reloadDefaultGLPrograms()
@@ -321,6 +418,14 @@ void GLProgramCache::reloadDefaultGLPrograms()
     p->reset();
     loadDefaultGLProgram(p, kShaderType_PositionTextureColor_noMVP);
 
+    p = getGLProgram(GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR_MULTI_TEXTURE_NO_MVP);
+    p->reset();
+    loadDefaultGLProgram(p, kShaderType_PositionTextureColorMultiTexture_noMVP);
+
+    p = getGLProgram(GLProgram::SHADER_NAME_OVERDRAW_NO_MVP);
+    p->reset();
+    loadDefaultGLProgram(p, kShaderType_Overdraw_noMVP);
+
     // Position Texture Color alpha test
     p = getGLProgram(GLProgram::SHADER_NAME_POSITION_TEXTURE_ALPHA_TEST);
     p->reset();
@@ -383,6 +488,10 @@ void GLProgramCache::reloadDefaultGLPrograms()
     p->reset();
     loadDefaultGLProgram(p, kShaderType_PositionLengthTextureColor);
 
+    p = getGLProgram(GLProgram::SHADER_NAME_POSITION_LENGTH_TEXTURE_COLOR_NO_MVP);
+    p->reset();
+    loadDefaultGLProgram(p, kShaderType_PositionLengthTextureColor_noMVP);
+
     p = getGLProgram(GLProgram::SHADER_NAME_LABEL_DISTANCEFIELD_NORMAL);
     p->reset();
     loadDefaultGLProgram(p, kShaderType_LabelDistanceFieldNormal);
@@ -403,6 +512,18 @@ void GLProgramCache::reloadDefaultGLPrograms()
     p->reset();
     loadDefaultGLProgram(p, kShaderType_LabelOutline);
 
+    p = getGLProgram(GLProgram::SHADER_NAME_LABEL_NORMAL_NO_MVP);
+    p->reset();
+    loadDefaultGLProgram(p, kShaderType_LabelNormal_noMVP);
+
+    p = getGLProgram(GLProgram::SHADER_NAME_LABEL_OUTLINE_NO_MVP);
+    p->reset();
+    loadDefaultGLProgram(p, kShaderType_LabelOutline_noMVP);
+
+    p = getGLProgram(GLProgram::SHADER_NAME_LABEL_DISTANCEFIELD_NORMAL_NO_MVP);
+    p->reset();
+    loadDefaultGLProgram(p, kShaderType_LabelDistanceFieldNormal_noMVP);
+
     p = getGLProgram(GLProgram::SHADER_3D_POSITION);
     p->reset();
     loadDefaultGLProgram(p, kShaderType_3DPosition);
@@ -476,6 +597,25 @@ void GLProgramCache::reloadDefaultGLPrograms()
     p = getGLProgram(GLProgram::SHADER_LAYER_RADIAL_GRADIENT);
     loadDefaultGLProgram(p, kShaderType_LayerRadialGradient);
     _programs.emplace(GLProgram::SHADER_LAYER_RADIAL_GRADIENT, p);
+
+    // hardware instancing supports.
+    reloadInstancedGLProgram(GLProgram::SHADER_3D_POSITION_INSTANCED, kShaderType_3DPositionInstanced);
+    reloadInstancedGLProgram(GLProgram::SHADER_3D_POSITION_TEXTURE_INSTANCED, kShaderType_3DPositionTexInstanced);
+    reloadInstancedGLProgram(GLProgram::SHADER_3D_POSITION_NORMAL_INSTANCED, kShaderType_3DPositionNormalInstanced);
+    reloadInstancedGLProgram(GLProgram::SHADER_3D_POSITION_NORMAL_TEXTURE_INSTANCED, kShaderType_3DPositionNormalTexInstanced);
+    reloadInstancedGLProgram(GLProgram::SHADER_3D_SKINPOSITION_TEXTURE_INSTANCED, kShaderType_3DSkinPositionTexInstanced);
+    reloadInstancedGLProgram(GLProgram::SHADER_3D_SKINPOSITION_NORMAL_TEXTURE_INSTANCED, kShaderType_3DSkinPositionNormalTexInstanced);
+}
+
+void GLProgramCache::reloadInstancedGLProgram(const std::string& key, int type)
+{
+    // instanced programs are only created when the device supports instancing
+    GLProgram *p = getGLProgram(key);
+    if (p)
+    {
+        p->reset();
+        loadDefaultGLProgram(p, type);
+    }
 }
 
 void GLProgramCache::reloadDefaultGLProgramsRelativeToLights()
@@ -499,6 +639,10 @@ void GLProgramCache::reloadDefaultGLProgramsRelativeToLights()
     p = getGLProgram(GLProgram::SHADER_3D_SKINPOSITION_BUMPEDNORMAL_TEXTURE);
     p->reset();
     loadDefaultGLProgram(p, kShaderType_3DSkinPositionBumpedNormalTex);
+
+    reloadInstancedGLProgram(GLProgram::SHADER_3D_POSITION_NORMAL_INSTANCED, kShaderType_3DPositionNormalInstanced);
+    reloadInstancedGLProgram(GLProgram::SHADER_3D_POSITION_NORMAL_TEXTURE_INSTANCED, kShaderType_3DPositionNormalTexInstanced);
+    reloadInstancedGLProgram(GLProgram::SHADER_3D_SKINPOSITION_NORMAL_TEXTURE_INSTANCED, kShaderType_3DSkinPositionNormalTexInstanced);
 }
 
 void GLProgramCache::loadDefaultGLProgram(GLProgram *p, int type)
@@ -510,6 +654,13 @@ void GLProgramCache::loadDefaultGLProgram(GLProgram *p, int type)
         case kShaderType_PositionTextureColor_noMVP:
             p->initWithByteArrays(ccPositionTextureColor_noMVP_vert, ccPositionTextureColor_noMVP_frag);
             break;
+        case kShaderType_PositionTextureColorMultiTexture_noMVP:
+            p->initWithByteArrays(ccPositionTextureColorMultiTexture_noMVP_vert, ccPositionTextureColorMultiTexture_noMVP_frag);
+            p->bindAttribLocation("a_textureSlot", GLProgram::VERTEX_ATTRIB_TEX_COORD1);
+            break;
+        case kShaderType_Overdraw_noMVP:
+            p->initWithByteArrays(ccPositionTextureColor_noMVP_vert, ccOverdraw_noMVP_frag);
+            break;
         case kShaderType_PositionTextureColorAlphaTest:
             p->initWithByteArrays(ccPositionTextureColor_vert, ccPositionTextureColorAlphaTest_frag);
             break;
@@ -541,6 +692,9 @@ void GLProgramCache::loadDefaultGLProgram(GLProgram *p, int type)
         case kShaderType_PositionLengthTextureColor:
             p->initWithByteArrays(ccPositionColorLengthTexture_vert, ccPositionColorLengthTexture_frag);
             break;
+        case kShaderType_PositionLengthTextureColor_noMVP:
+            p->initWithByteArrays(ccPositionColorLengthTexture_noMVP_vert, ccPositionColorLengthTexture_frag);
+            break;
         case kShaderType_LabelDistanceFieldNormal:
             p->initWithByteArrays(ccLabel_vert, ccLabelDistanceFieldNormal_frag);
             break;
@@ -557,6 +711,15 @@ void GLProgramCache::loadDefaultGLProgram(GLProgram *p, int type)
         case kShaderType_LabelOutline:
             p->initWithByteArrays(ccLabel_vert, ccLabelOutline_frag);
             break;
+        case kShaderType_LabelNormal_noMVP:
+            p->initWithByteArrays(ccPositionTextureColor_noMVP_vert, ccLabelNormal_frag);
+            break;
+        case kShaderType_LabelOutline_noMVP:
+            p->initWithByteArrays(ccPositionTextureColor_noMVP_vert, ccLabelOutline_frag);
+            break;
+        case kShaderType_LabelDistanceFieldNormal_noMVP:
+            p->initWithByteArrays(ccPositionTextureColor_noMVP_vert, ccLabelDistanceFieldNormal_frag);
+            break;
         case kShaderType_3DPosition:
             p->initWithByteArrays(cc3D_PositionTex_vert, cc3D_Color_frag);
             break;
@@ -632,6 +795,34 @@ void GLProgramCache::loadDefaultGLProgram(GLProgram *p, int type)
         case kShaderType_LayerRadialGradient:
             p->initWithByteArrays(ccPosition_vert, ccShader_LayerRadialGradient_frag);
             break;
+            /// hardware instancing supports.
+        case kShaderType_3DPositionInstanced:
+            p->initWithByteArrays(cc3D_PositionTex_vert, cc3D_Color_frag, "CC_INSTANCING");
+            break;
+        case kShaderType_3DPositionTexInstanced:
+            p->initWithByteArrays(cc3D_PositionTex_vert, cc3D_ColorTex_frag, "CC_INSTANCING");
+            break;
+        case kShaderType_3DPositionNormalInstanced:
+            {
+                std::string def = getShaderMacrosForLight();
+                p->initWithByteArrays((def + std::string(cc3D_PositionNormalTex_vert)).c_str(), (def + std::string(cc3D_ColorNormal_frag)).c_str(), "CC_INSTANCING");
+            }
+            break;
+        case kShaderType_3DPositionNormalTexInstanced:
+            {
+                std::string def = getShaderMacrosForLight();
+                p->initWithByteArrays((def + std::string(cc3D_PositionNormalTex_vert)).c_str(), (def + std::string(cc3D_ColorNormalTex_frag)).c_str(), "CC_INSTANCING");
+            }
+            break;
+        case kShaderType_3DSkinPositionTexInstanced:
+            p->initWithByteArrays(cc3D_SkinPositionTex_vert, cc3D_ColorTex_frag, "CC_INSTANCING;CC_BONE_TEXTURE");
+            break;
+        case kShaderType_3DSkinPositionNormalTexInstanced:
+            {
+                std::string def = getShaderMacrosForLight();
+                p->initWithByteArrays((def + std::string(cc3D_SkinPositionNormalTex_vert)).c_str(), (def + std::string(cc3D_ColorNormalTex_frag)).c_str(), "CC_INSTANCING;CC_BONE_TEXTURE");
+            }
+            break;
         default:
             CCLOG("cocos2d: %s:%d, error shader type", __FUNCTION__, __LINE__);
             return;
@@ -666,6 +857,257 @@ void GLProgramCache::addGLProgram(GLProgram* program, const std::string &key)
     _programs[key] = program;
 }
 
+void GLProgramCache::setProgramBinaryCacheEnabled(bool enabled)
+{
+    if (enabled && !Configuration::getInstance()->supportsProgramBinary())
+    {
+        CCLOG("cocos2d: the program binary cache is not supported, GL_OES_get_program_binary or GL_ARB_get_program_binary is missing");
+        enabled = false;
+    }
+
+    if (enabled)
+    {
+        // a driver update changes the binary format, its strings are part of every entry
+        std::string driver = StringUtils::format("%s|%s|%s|%s",
+                                                 (const char*)glGetString(GL_VENDOR),
+                                                 (const char*)glGetString(GL_RENDERER),
+                                                 (const char*)glGetString(GL_VERSION),
+                                                 cocos2dVersion());
+        _driverHash = XXH32(driver.c_str(), driver.length(), 0);
+
+        auto fileUtils = FileUtils::getInstance();
+        _programBinaryDirectory = fileUtils->getWritablePath() + "program_binaries/";
+        if (!fileUtils->isDirectoryExist(_programBinaryDirectory) && !fileUtils->createDirectory(_programBinaryDirectory))
+        {
+            CCLOG("cocos2d: failed to create the program binary cache directory: %s", _programBinaryDirectory.c_str());
+            enabled = false;
+        }
+    }
+
+    _programBinaryCacheEnabled = enabled;
+}
+
+std::string GLProgramCache::getProgramBinaryPath(const std::string& sources) const
+{
+    // two seeds so that a 32 bits collision doesn't load the wrong program
+    unsigned int low = XXH32(sources.c_str(), sources.length(), 0);
+    unsigned int high = XXH32(sources.c_str(), sources.length(), 0x9E3779B9);
+    return StringUtils::format("%s%08x%08x.bin", _programBinaryDirectory.c_str(), high, low);
+}
+
+bool GLProgramCache::getProgramBinary(const std::string& sources, GLenum* format, Data* binary)
+{
+    if (!_programBinaryCacheEnabled)
+        return false;
+
+    auto fileUtils = FileUtils::getInstance();
+    std::string path = getProgramBinaryPath(sources);
+    if (!fileUtils->isFileExist(path))
+        return false;
+
+    Data data = fileUtils->getDataFromFile(path);
+    ProgramBinaryHeader header;
+    bool valid = (size_t)data.getSize() > sizeof(header);
+    if (valid)
+    {
+        memcpy(&header, data.getBytes(), sizeof(header));
+        valid = header.magic == PROGRAM_BINARY_MAGIC
+            && header.version == PROGRAM_BINARY_VERSION
+            && header.driverHash == _driverHash
+            && header.length == (size_t)data.getSize() - sizeof(header);
+    }
+
+    if (!valid)
+    {
+        CCLOG("cocos2d: removing stale program binary: %s", path.c_str());
+        fileUtils->removeFile(path);
+        return false;
+    }
+
+    *format = header.format;
+    binary->copy(data.getBytes() + sizeof(header), header.length);
+    return true;
+}
+
+void GLProgramCache::addProgramBinary(const std::string& sources, GLenum format, const Data& binary)
+{
+    if (!_programBinaryCacheEnabled || binary.isNull())
+        return;
+
+    ProgramBinaryHeader header;
+    header.magic = PROGRAM_BINARY_MAGIC;
+    header.version = PROGRAM_BINARY_VERSION;
+    header.driverHash = _driverHash;
+    header.format = format;
+    header.length = (unsigned int)binary.getSize();
+
+    ssize_t size = sizeof(header) + binary.getSize();
+    unsigned char* bytes = (unsigned char*)malloc(size);
+    memcpy(bytes, &header, sizeof(header));
+    memcpy(bytes + sizeof(header), binary.getBytes(), binary.getSize());
+
+    Data data;
+    data.fastSet(bytes, size);
+
+    std::string path = getProgramBinaryPath(sources);
+    if (!FileUtils::getInstance()->writeDataToFile(data, path))
+    {
+        CCLOG("cocos2d: failed to write the program binary: %s", path.c_str());
+    }
+}
+
+void GLProgramCache::removeAllProgramBinaries()
+{
+    std::string directory = _programBinaryDirectory.empty() ? FileUtils::getInstance()->getWritablePath() + "program_binaries/" : _programBinaryDirectory;
+    auto fileUtils = FileUtils::getInstance();
+    if (fileUtils->isDirectoryExist(directory))
+    {
+        fileUtils->removeDirectory(directory);
+        if (_programBinaryCacheEnabled)
+            fileUtils->createDirectory(directory);
+    }
+}
+
+std::string GLProgramCache::getVariantKey(const ShaderVariant& variant)
+{
+    return variant.vertexShader + "+" + variant.fragmentShader + "+" + variant.defines;
+}
+
+GLProgram* GLProgramCache::getOrCreateVariant(const ShaderVariant& variant)
+{
+    const std::string key = getVariantKey(variant);
+    auto glprogram = getGLProgram(key);
+
+    if (!glprogram)
+    {
+        glprogram = GLProgram::createWithFilenames(variant.vertexShader, variant.fragmentShader, variant.defines);
+        addGLProgram(glprogram, key);
+    }
+    return glprogram;
+}
+
+// the groups of a variants string, an optional define is a group with an empty first choice
+static std::vector<std::vector<std::string>> parseVariantGroups(const std::string& variants)
+{
+    std::vector<std::vector<std::string>> groups;
+    std::vector<std::string> group;
+    std::string define;
+    auto addDefine = [&]() {
+        auto begin = define.find_first_not_of(" \t");
+        define = begin == std::string::npos ? "" : define.substr(begin, define.find_last_not_of(" \t") - begin + 1);
+        if (!define.empty())
+            group.push_back(define);
+        define.clear();
+    };
+
+    for (size_t i = 0; i <= variants.length(); ++i)
+    {
+        char c = i < variants.length() ? variants[i] : ';';
+        if (c == '|')
+        {
+            addDefine();
+        }
+        else if (c == ';')
+        {
+            addDefine();
+            if (group.size() == 1)
+                group.insert(group.begin(), "");
+            if (!group.empty())
+                groups.push_back(group);
+            group.clear();
+        }
+        else
+        {
+            define.push_back(c);
+        }
+    }
+    return groups;
+}
+
+static std::string joinVariantDefines(const std::string& defines, const std::vector<std::vector<std::string>>& groups, const std::vector<size_t>& choices)
+{
+    std::string ret = defines;
+    for (size_t i = 0; i < groups.size(); ++i)
+    {
+        auto& define = groups[i][choices[i]];
+        if (define.empty())
+            continue;
+        if (!ret.empty() && ret.back() != ';')
+            ret.push_back(';');
+        ret += define;
+    }
+    return ret;
+}
+
+std::string GLProgramCache::getDefaultVariantDefines(const std::string& defines, const std::string& variants)
+{
+    auto groups = parseVariantGroups(variants);
+    return joinVariantDefines(defines, groups, std::vector<size_t>(groups.size(), 0));
+}
+
+void GLProgramCache::addShaderVariants(const std::string& vertexShader, const std::string& fragmentShader,
+                                       const std::string& defines, const std::string& variants, std::vector<ShaderVariant>* shaderVariants)
+{
+    CCASSERT(shaderVariants, "shaderVariants should not be null");
+
+    auto groups = parseVariantGroups(variants);
+    std::vector<size_t> choices(groups.size(), 0);
+    while (true)
+    {
+        shaderVariants->push_back(ShaderVariant(vertexShader, fragmentShader, joinVariantDefines(defines, groups, choices)));
+
+        // next combination, the first group changing fastest
+        size_t i = 0;
+        for (; i < groups.size(); ++i)
+        {
+            if (++choices[i] < groups[i].size())
+                break;
+            choices[i] = 0;
+        }
+        if (i == groups.size())
+            break;
+    }
+}
+
+TimeSlicedQueue::TaskId GLProgramCache::warmUpVariants(const std::vector<ShaderVariant>& variants,
+                                                       const TimeSlicedQueue::CompletionCallback& completion, int priority)
+{
+    // the duplicates are only compiled once
+    std::vector<ShaderVariant> pending;
+    std::unordered_set<std::string> keys;
+    for (auto& variant : variants)
+    {
+        if (keys.insert(getVariantKey(variant)).second)
+            pending.push_back(variant);
+    }
+
+    size_t next = 0;
+    return TimeSlicedQueue::getInstance()->addTask([pending, next](float& progress) mutable {
+        // the ones already in the cache don't use a step
+        auto glprogramcache = GLProgramCache::getInstance();
+        while (next < pending.size() && glprogramcache->isVariantLoaded(pending[next]))
+            ++next;
+        if (next < pending.size())
+            glprogramcache->getOrCreateVariant(pending[next++]);
+
+        progress = pending.empty() ? 1.0f : (float)next / pending.size();
+        return next >= pending.size();
+    }, priority, completion);
+}
+
+void GLProgramCache::removeUnusedVariants(const std::vector<ShaderVariant>& variants)
+{
+    for (auto& variant : variants)
+    {
+        auto it = _programs.find(getVariantKey(variant));
+        if (it != _programs.end() && (!it->second || it->second->getReferenceCount() == 1))
+        {
+            CC_SAFE_RELEASE(it->second);
+            _programs.erase(it);
+        }
+    }
+}
+
 std::string GLProgramCache::getShaderMacrosForLight() const
 {
     GLchar def[256];
@@ -30,8 +30,12 @@ THE SOFTWARE.
 
 #include <string>
 #include <unordered_map>
+#include <vector>
 
 #include "base/CCRef.h"
+#include "base/CCData.h"
+#include "base/CCTimeSlicedQueue.h"
+#include "platform/CCGL.h"
 
 /**
  * @addtogroup renderer
@@ -42,6 +46,20 @@ NS_CC_BEGIN
 
 class GLProgram;
 
+/** A program built from shader files with compile time defines, as GLProgramState::getOrCreateWithShaders() builds it.
+ * @since v3.14
+ */
+struct ShaderVariant
+{
+    ShaderVariant() {}
+    ShaderVariant(const std::string& vertex, const std::string& fragment, const std::string& compileTimeDefines)
+    : vertexShader(vertex), fragmentShader(fragment), defines(compileTimeDefines) {}
+
+    std::string vertexShader;
+    std::string fragmentShader;
+    std::string defines;
+};
+
 /** GLProgramCache
  Singleton that stores manages GLProgram objects (shaders)
  @since v2.0
@@ -94,6 +112,86 @@ public:
     /** reload default programs these are relative to light */
     void reloadDefaultGLProgramsRelativeToLights();
 
+    /** @{
+     Enable/Disable the program binary cache.
+     When enabled every GLProgram, built-in or custom, saves its linked binary under
+     `FileUtils::getWritablePath()` and restores it instead of compiling its shaders the next time.
+     Entries are keyed by the shader sources and invalidated when the GL driver changes.
+     It is enabled by `Configuration::useProgramBinaryCache()` and ignored when
+     `Configuration::supportsProgramBinary()` is `false`.
+     @since v3.14
+     */
+    void setProgramBinaryCacheEnabled(bool enabled);
+    bool isProgramBinaryCacheEnabled() const { return _programBinaryCacheEnabled; }
+    /**
+     @}
+     */
+
+    /** Returns the binary saved for the given program sources, false if there is none or it is stale.
+     * @since v3.14
+     */
+    bool getProgramBinary(const std::string& sources, GLenum* format, Data* binary);
+
+    /** Saves the binary of a linked program built from the given sources.
+     * @since v3.14
+     */
+    void addProgramBinary(const std::string& sources, GLenum format, const Data& binary);
+
+    /** Removes all the saved program binaries from the disk.
+     * @since v3.14
+     */
+    void removeAllProgramBinaries();
+
+    /** Returns the key of the program of a shader variant in the cache.
+     * @since v3.14
+     */
+    static std::string getVariantKey(const ShaderVariant& variant);
+
+    /** Returns the program of a shader variant, it's compiled and added to the cache the first time.
+     * @since v3.14
+     */
+    GLProgram* getOrCreateVariant(const ShaderVariant& variant);
+
+    /** Returns whether the program of a shader variant is in the cache.
+     * @since v3.14
+     */
+    bool isVariantLoaded(const ShaderVariant& variant) const { return _programs.find(getVariantKey(variant)) != _programs.end(); }
+
+    /** @{
+     Enumerates the variants of shaders built with optional defines.
+     `variants` lists groups of defines separated by ';'. A group of a single define is either added
+     to `defines` or not, the defines of a group separated by '|' are exclusive and one of them is
+     always added, e.g. "USE_FOG;MAX_POINT_LIGHT_NUM 1|MAX_POINT_LIGHT_NUM 4" gives 4 variants.
+     The first variant, the default one, has the first define of each exclusive group and none of the
+     optional ones.
+     @since v3.14
+     */
+    static std::string getDefaultVariantDefines(const std::string& defines, const std::string& variants);
+    static void addShaderVariants(const std::string& vertexShader, const std::string& fragmentShader,
+                                  const std::string& defines, const std::string& variants, std::vector<ShaderVariant>* shaderVariants);
+    /**
+     @}
+     */
+
+    /** Compiles the programs of shader variants a few per frame with a TimeSlicedQueue task, so that creating
+     them later, e.g. when parsing a Material, doesn't stall a frame. The programs already in the cache are
+     skipped and the ones with a saved binary are only loaded, see setProgramBinaryCacheEnabled().
+     The programs stay in the cache until removeUnusedVariants() or the cache is destroyed.
+
+     @param variants The variants to compile, in order.
+     @param completion Called with true once they are all compiled, false if the task was cancelled, can be nullptr.
+     @param priority The priority of the task in the TimeSlicedQueue.
+     @return The id of the task, its progress is the share of the variants compiled.
+     @since v3.14
+     */
+    TimeSlicedQueue::TaskId warmUpVariants(const std::vector<ShaderVariant>& variants,
+                                           const TimeSlicedQueue::CompletionCallback& completion = nullptr, int priority = 0);
+
+    /** Removes the programs of shader variants which are only used by the cache.
+     * @since v3.14
+     */
+    void removeUnusedVariants(const std::vector<ShaderVariant>& variants);
+
 private:
     /**
     @{
@@ -101,6 +199,8 @@ private:
     */
     bool init();
     void loadDefaultGLProgram(GLProgram *program, int type);
+    /** Reload an instanced program if it was created, they are skipped when instancing is not supported. */
+    void reloadInstancedGLProgram(const std::string& key, int type);
     /**
     @}
     */
@@ -108,8 +208,16 @@ private:
     /**Get macro define for lights in current openGL driver.*/
     std::string getShaderMacrosForLight() const;
 
+    /**Path of the binary file for the given program sources.*/
+    std::string getProgramBinaryPath(const std::string& sources) const;
+
     /**Predefined shaders.*/
     std::unordered_map<std::string, GLProgram*> _programs;
+
+    bool _programBinaryCacheEnabled;
+    /**Hash of the GL vendor, renderer and version strings, stored in every binary.*/
+    unsigned int _driverHash;
+    std::string _programBinaryDirectory;
 };
 
 NS_CC_END
@@ -40,11 +40,19 @@ THE SOFTWARE.
 #include "base/CCEventDispatcher.h"
 #include "2d/CCCamera.h"
 
+#include <algorithm>
+#include <atomic>
+
+#include "xxhash.h"
+
 NS_CC_BEGIN
 
 // static vector with all the registered custom binding resolvers
 std::vector<GLProgramState::AutoBindingResolver*> GLProgramState::_customAutoBindingResolvers;
 
+// ids of the GLProgramStates, 0 is never used
+static std::atomic<unsigned int> s_nextGLProgramStateId(0);
+
 //
 //
 // UniformValue
@@ -155,6 +163,11 @@ void UniformValue::apply()
     }
 }
 
+bool UniformValue::isAppliedEveryDraw() const
+{
+    return _type != Type::VALUE || _uniform->type == GL_SAMPLER_2D || _uniform->type == GL_SAMPLER_CUBE;
+}
+
 void UniformValue::setCallback(const std::function<void(GLProgram*, Uniform*)> &callback)
 {
     // delete previously set callback
@@ -399,15 +412,7 @@ GLProgramState* GLProgramState::getOrCreateWithGLProgram(GLProgram *glprogram)
 
 GLProgramState* GLProgramState::getOrCreateWithShaders(const std::string& vertexShader, const std::string& fragShader, const std::string& compileTimeDefines)
 {
-    auto glprogramcache = GLProgramCache::getInstance();
-    const std::string key = vertexShader + "+" + fragShader + "+" + compileTimeDefines;
-    auto glprogram = glprogramcache->getGLProgram(key);
-
-    if (!glprogram) {
-        glprogram = GLProgram::createWithFilenames(vertexShader, fragShader, compileTimeDefines);
-        glprogramcache->addGLProgram(glprogram, key);
-    }
-
+    auto glprogram = GLProgramCache::getInstance()->getOrCreateVariant(ShaderVariant(vertexShader, fragShader, compileTimeDefines));
     return create(glprogram);
 }
 
@@ -418,6 +423,8 @@ GLProgramState::GLProgramState()
 , _vertexAttribsFlags(0)
 , _glprogram(nullptr)
 , _nodeBinding(nullptr)
+, _id(++s_nextGLProgramStateId)
+, _uniformsVersion(0)
 {
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID || CC_TARGET_PLATFORM == CC_PLATFORM_WINRT)
     /** listen the event that renderer was recreated on Android/WP8 */
@@ -462,6 +469,7 @@ GLProgramState* GLProgramState::clone() const
     // copy uniforms
     glprogramstate->_uniformsByName = this->_uniformsByName;
     glprogramstate->_uniforms = this->_uniforms;
+    glprogramstate->_uniformLocations = this->_uniformLocations;
     glprogramstate->_uniformAttributeValueDirty = this->_uniformAttributeValueDirty;
 
     // copy textures
@@ -491,11 +499,14 @@ bool GLProgramState::init(GLProgram* glprogram)
         _attributes[attrib.first] = value;
     }
 
+    // reserved, UniformValue is copied when the vector grows
+    _uniforms.reserve(_glprogram->_userUniforms.size());
     for(auto &uniform : _glprogram->_userUniforms) {
-        UniformValue value(&uniform.second, _glprogram);
-        _uniforms[uniform.second.location] = std::move(value);
-        _uniformsByName[uniform.first] = uniform.second.location;
+        _uniformsByName[uniform.first] = (int)_uniforms.size();
+        _uniforms.emplace_back(&uniform.second, _glprogram);
     }
+    updateUniformLocations();
+    ++_uniformsVersion;
 
     return true;
 }
@@ -506,6 +517,8 @@ void GLProgramState::resetGLProgram()
     // the destructor of UniformValue will call a weak pointer
     // which points to the member variable in GLProgram.
     _uniforms.clear();
+    _uniformsByName.clear();
+    _uniformLocations.clear();
     _attributes.clear();
 
     CC_SAFE_RELEASE(_glprogram);
@@ -529,10 +542,13 @@ void GLProgramState::updateUniformsAndAttributes()
     CCASSERT(_glprogram, "invalid glprogram");
     if(_uniformAttributeValueDirty)
     {
-        for(auto& uniformLocation : _uniformsByName)
+        for(auto& uniformIndex : _uniformsByName)
         {
-            _uniforms[uniformLocation.second]._uniform = _glprogram->getUniform(uniformLocation.first);
+            _uniforms[uniformIndex.second]._uniform = _glprogram->getUniform(uniformIndex.first);
         }
+        // the locations may change when the program is linked again
+        updateUniformLocations();
+        ++_uniformsVersion;
         
         _vertexAttribsFlags = 0;
         for(auto& attributeValue : _attributes)
@@ -576,9 +592,32 @@ void GLProgramState::applyUniforms()
 {
     // set uniforms
     updateUniformsAndAttributes();
+
+    // if this state was the last one applied to the GLProgram and no value was set since,
+    // the GLProgram still holds the values, only the ones read on every draw are applied
+    const bool valuesApplied = _glprogram->_appliedUniformStateId == _id && _glprogram->_appliedUniformStateVersion == _uniformsVersion;
+
+    _glprogram->_applyingUniforms = true;
     for(auto& uniform : _uniforms) {
-        uniform.second.apply();
+        if (!valuesApplied || uniform.isAppliedEveryDraw())
+            uniform.apply();
     }
+    _glprogram->_applyingUniforms = false;
+
+    _glprogram->_appliedUniformStateId = _id;
+    _glprogram->_appliedUniformStateVersion = _uniformsVersion;
+}
+
+void GLProgramState::updateUniformLocations()
+{
+    _uniformLocations.clear();
+    _uniformLocations.reserve(_uniforms.size());
+    for (int i = 0, count = (int)_uniforms.size(); i < count; ++i)
+    {
+        if (_uniforms[i]._uniform)
+            _uniformLocations.emplace_back(_uniforms[i]._uniform->location, i);
+    }
+    std::sort(_uniformLocations.begin(), _uniformLocations.end());
 }
 
 void GLProgramState::setGLProgram(GLProgram *glprogram)
@@ -591,6 +630,41 @@ void GLProgramState::setGLProgram(GLProgram *glprogram)
     }
 }
 
+uint32_t GLProgramState::getUniformsHash() const
+{
+    uint32_t hash = 0;
+    for (const auto& uniform : _uniforms)
+    {
+        const GLint location = uniform._uniform->location;
+        hash = XXH32((const void*)&location, sizeof(location), hash);
+        if (uniform._type == UniformValue::Type::VALUE)
+        {
+            // the union is zeroed when constructed, the bytes a value doesn't use stay zero
+            hash = XXH32((const void*)&uniform._value, sizeof(uniform._value), hash);
+        }
+        else if (uniform._type == UniformValue::Type::POINTER)
+        {
+            int components = 1;
+            switch (uniform._uniform->type)
+            {
+                case GL_FLOAT_VEC2: components = 2; break;
+                case GL_FLOAT_VEC3: components = 3; break;
+                case GL_FLOAT_VEC4: components = 4; break;
+                default: break;
+            }
+            const auto& array = uniform._value.floatv;
+            if (array.pointer)
+                hash = XXH32((const void*)array.pointer, (int)(array.size * components * sizeof(float)), hash);
+        }
+        else
+        {
+            const void* self = this;
+            hash = XXH32((const void*)&self, sizeof(self), hash);
+        }
+    }
+    return hash;
+}
+
 uint32_t GLProgramState::getVertexAttribsFlags() const
 {
     return _vertexAttribsFlags;
@@ -604,9 +678,13 @@ ssize_t GLProgramState::getVertexAttribCount() const
 UniformValue* GLProgramState::getUniformValue(GLint uniformLocation)
 {
     updateUniformsAndAttributes();
-    const auto itr = _uniforms.find(uniformLocation);
-    if (itr != _uniforms.end())
-        return &itr->second;
+    const auto itr = std::lower_bound(_uniformLocations.begin(), _uniformLocations.end(), std::make_pair(uniformLocation, 0));
+    if (itr != _uniformLocations.end() && itr->first == uniformLocation)
+    {
+        // the caller is going to set the value
+        ++_uniformsVersion;
+        return &_uniforms[itr->second];
+    }
     return nullptr;
 }
 
@@ -615,7 +693,11 @@ UniformValue* GLProgramState::getUniformValue(const std::string& name)
     updateUniformsAndAttributes();
     const auto itr = _uniformsByName.find(name);
     if (itr != _uniformsByName.end())
+    {
+        // the caller is going to set the value
+        ++_uniformsVersion;
         return &_uniforms[itr->second];
+    }
     return nullptr;
 }
 
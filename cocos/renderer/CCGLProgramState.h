@@ -28,6 +28,7 @@ THE SOFTWARE.
 #define __CCGLPROGRAMSTATE_H__
 
 #include <unordered_map>
+#include <vector>
 
 #include "base/ccTypes.h"
 #include "base/CCVector.h"
@@ -118,6 +119,13 @@ public:
     /**Apply the uniform value to openGL pipeline.*/
     void apply();
 
+    /**
+     Whether the value has to be applied for every draw, even if it wasn't set again.
+     Callbacks and pointers are read when applied, and textures have to be bound again.
+     @since v3.14
+     */
+    bool isAppliedEveryDraw() const;
+
     UniformValue& operator=(const UniformValue& o);
 
 protected:
@@ -314,7 +322,14 @@ public:
     /**@}*/
     
     /**Get the number of user defined uniform count.*/
-    ssize_t getUniformCount() const { return _uniforms.size(); }
+    ssize_t getUniformCount() const { return (ssize_t)_uniforms.size(); }
+
+    /**
+     Get a hash of the values of the user defined uniforms, the arrays set by pointer are hashed by content.
+     The states with uniforms set by callback have a hash of their own, their values aren't known.
+     @since v3.14
+     */
+    uint32_t getUniformsHash() const;
     
     /** @{
      Setting user defined uniforms by uniform string name in the shader.
@@ -466,14 +481,22 @@ protected:
     bool init(GLProgram* program);
     void resetGLProgram();
     void updateUniformsAndAttributes();
+    void updateUniformLocations();
     VertexAttribValue* getVertexAttribValue(const std::string& attributeName);
     UniformValue* getUniformValue(const std::string& uniformName);
     UniformValue* getUniformValue(GLint uniformLocation);
 
 
     bool _uniformAttributeValueDirty;
-    std::unordered_map<std::string, GLint> _uniformsByName;
-    std::unordered_map<GLint, UniformValue> _uniforms;
+    // index of the uniforms in _uniforms
+    std::unordered_map<std::string, int> _uniformsByName;
+    // laid out when the GLProgram is set, applyUniforms() walks it in order
+    std::vector<UniformValue> _uniforms;
+    // (location, index in _uniforms), sorted by location
+    std::vector<std::pair<GLint, int>> _uniformLocations;
+    // bumped whenever a uniform value may have been changed, GLProgram remembers the version it has applied
+    unsigned int _id;
+    unsigned int _uniformsVersion;
     std::unordered_map<std::string, VertexAttribValue> _attributes;
     std::unordered_map<std::string, int> _boundTextureUnits;
 
@@ -27,8 +27,14 @@
 #include "renderer/CCRenderer.h"
 #include "base/CCDirector.h"
 
+#if CC_ENABLE_ALLOCATOR && CC_ENABLE_ENGINE_ALLOCATOR_POOLS
+#include "base/allocator/CCAllocatorStrategyPool.h"
+#endif
+
 NS_CC_BEGIN
 
+CC_DEFINE_ALLOCATOR_POOL(GroupCommand, 64)
+
 GroupCommandManager::GroupCommandManager()
 {
 
@@ -48,6 +54,8 @@ bool GroupCommandManager::init()
 
 int GroupCommandManager::getGroupID()
 {
+    std::lock_guard<std::mutex> lock(_mutex);
+
     //Reuse old id
     if (!_unusedIDs.empty())
     {
@@ -67,6 +75,7 @@ int GroupCommandManager::getGroupID()
 
 void GroupCommandManager::releaseGroupID(int groupID)
 {
+    std::lock_guard<std::mutex> lock(_mutex);
     _groupMapping[groupID] = false;
     _unusedIDs.push_back(groupID);
 }
@@ -28,6 +28,7 @@
 
 #include <vector>
 #include <unordered_map>
+#include <mutex>
 
 #include "base/CCRef.h"
 #include "renderer/CCRenderCommand.h"
@@ -53,6 +54,8 @@ protected:
     bool init();
     std::unordered_map<int, bool> _groupMapping;
     std::vector<int> _unusedIDs;
+    // group commands can be initialized by subtrees visited on worker threads
+    std::mutex _mutex;
 };
 
 /**
@@ -62,6 +65,8 @@ protected:
 class CC_DLL GroupCommand : public RenderCommand
 {
 public:
+    CC_DECLARE_ALLOCATOR_POOL(GroupCommand)
+
     /**@{
      Constructor and Destructor.
      */
@@ -34,6 +34,7 @@
 #include "renderer/CCTexture2D.h"
 #include "renderer/CCGLProgram.h"
 #include "renderer/CCGLProgramState.h"
+#include "renderer/CCGLProgramCache.h"
 #include "base/CCProperties.h"
 #include "base/CCDirector.h"
 #include "platform/CCFileUtils.h"
@@ -48,6 +49,7 @@ NS_CC_BEGIN
 // Helpers declaration
 static const char* getOptionalString(Properties* properties, const char* key, const char* defaultValue);
 static bool isValidUniform(const char* name);
+static void addShaderVariants(Properties* properties, std::vector<ShaderVariant>* variants);
 
 Material* Material::createWithFilename(const std::string& filepath)
 {
@@ -115,6 +117,31 @@ bool Material::initWithFile(const std::string& validfilename)
     return true;
 }
 
+void Material::getShaderVariants(const std::string& path, std::vector<ShaderVariant>* variants)
+{
+    auto validfilename = FileUtils::getInstance()->fullPathForFilename(path);
+    if (validfilename.empty())
+        return;
+
+    // Warning: properties is not a "Ref" object, must be manually deleted
+    Properties* properties = Properties::createNonRefCounted(validfilename);
+    if (properties)
+    {
+        addShaderVariants(properties, variants);
+        CC_SAFE_DELETE(properties);
+    }
+}
+
+TimeSlicedQueue::TaskId Material::warmUp(const std::vector<std::string>& paths, const TimeSlicedQueue::CompletionCallback& completion, int priority)
+{
+    std::vector<ShaderVariant> variants;
+    for (auto& path : paths)
+    {
+        getShaderVariants(path, &variants);
+    }
+    return GLProgramCache::getInstance()->warmUpVariants(variants, completion, priority);
+}
+
 bool Material::initWithProperties(Properties* materialProperties)
 {
     return parseProperties(materialProperties);
@@ -298,7 +325,12 @@ bool Material::parseShader(Pass* pass, Properties* shaderProperties)
     const char* fragShader = getOptionalString(shaderProperties, "fragmentShader", nullptr);
 
     // compileTimeDefines
-    const char* compileTimeDefines = getOptionalString(shaderProperties, "defines", "");
+    std::string compileTimeDefines = getOptionalString(shaderProperties, "defines", "");
+
+    // the optional defines, the material uses the default variant
+    const char* variants = getOptionalString(shaderProperties, "variants", nullptr);
+    if (variants)
+        compileTimeDefines = GLProgramCache::getDefaultVariantDefines(compileTimeDefines, variants);
 
     if (vertShader && fragShader)
     {
@@ -499,10 +531,36 @@ ssize_t Material::getTechniqueCount() const
 static bool isValidUniform(const char* name)
 {
     return !(strcmp(name, "defines")==0 ||
+            strcmp(name, "variants")==0 ||
             strcmp(name, "vertexShader")==0 ||
             strcmp(name, "fragmentShader")==0);
 }
 
+// the variants of the shaders of a namespace and of the ones within it
+static void addShaderVariants(Properties* properties, std::vector<ShaderVariant>* variants)
+{
+    if (strcmp(properties->getNamespace(), "shader") == 0)
+    {
+        const char* vertShader = getOptionalString(properties, "vertexShader", nullptr);
+        const char* fragShader = getOptionalString(properties, "fragmentShader", nullptr);
+        if (vertShader && fragShader)
+        {
+            GLProgramCache::addShaderVariants(vertShader, fragShader,
+                                              getOptionalString(properties, "defines", ""),
+                                              getOptionalString(properties, "variants", ""), variants);
+        }
+        return;
+    }
+
+    properties->rewind();
+    auto space = properties->getNextNamespace();
+    while (space)
+    {
+        addShaderVariants(space, variants);
+        space = properties->getNextNamespace();
+    }
+}
+
 static const char* getOptionalString(Properties* properties, const char* key, const char* defaultValue)
 {
 
@@ -36,6 +36,7 @@
 #include "renderer/CCTechnique.h"
 #include "base/CCRef.h"
 #include "base/CCVector.h"
+#include "base/CCTimeSlicedQueue.h"
 #include "math/Vec2.h"
 #include "math/Vec3.h"
 #include "math/Vec4.h"
@@ -50,6 +51,7 @@ class Pass;
 class GLProgramState;
 class Node;
 class Properties;
+struct ShaderVariant;
 
 /// Material
 class CC_DLL Material : public RenderState
@@ -121,6 +123,24 @@ public:
     /** returns a clone (deep-copy) of the material */
     virtual Material* clone() const;
 
+    /**
+     * Adds the shader variants of all the passes of the materials in a file, without compiling them.
+     * Besides its `defines`, a shader can list the defines it may be built with in `variants`,
+     * see GLProgramCache::addShaderVariants(). The material is built with the default variant.
+     * @since v3.14
+     */
+    static void getShaderVariants(const std::string& path, std::vector<ShaderVariant>* variants);
+
+    /**
+     * Compiles the shader variants of material files a few per frame, so that creating the materials
+     * later doesn't compile their shaders, see GLProgramCache::warmUpVariants().
+     *
+     * @return The id of the TimeSlicedQueue task.
+     * @since v3.14
+     */
+    static TimeSlicedQueue::TaskId warmUp(const std::vector<std::string>& paths,
+                                          const TimeSlicedQueue::CompletionCallback& completion = nullptr, int priority = 0);
+
 protected:
     Material();
     ~Material();
@@ -23,6 +23,7 @@
  ****************************************************************************/
 
 #include "renderer/CCMeshCommand.h"
+#include <algorithm>
 #include "base/ccMacros.h"
 #include "base/CCConfiguration.h"
 #include "base/CCDirector.h"
@@ -41,14 +42,25 @@
 #include "renderer/CCPass.h"
 #include "xxhash.h"
 
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WINRT || CC_TARGET_PLATFORM == CC_PLATFORM_TIZEN)
+#define CC_MESH_USE_INSTANCING 0
+#else
+#define CC_MESH_USE_INSTANCING 1
+#endif
+
 NS_CC_BEGIN
 
+static const int INSTANCE_FLOATS = 17;
+static const GLsizei INSTANCE_STRIDE = sizeof(GLfloat) * INSTANCE_FLOATS;
 
 MeshCommand::MeshCommand()
 : _displayColor(1.0f, 1.0f, 1.0f, 1.0f)
 , _matrixPalette(nullptr)
 , _matrixPaletteSize(0)
 , _materialID(0)
+, _instancingEnabled(false)
+, _instancingKey(0)
+, _boneTextureRow(-1)
 , _vao(0)
 , _material(nullptr)
 , _glProgramState(nullptr)
@@ -185,6 +197,169 @@ uint32_t MeshCommand::getMaterialID() const
     return _materialID;
 }
 
+void MeshCommand::genInstancingKey(const Vec4& color, unsigned int lightMask, const std::vector<BaseLight*>* lights)
+{
+    CCASSERT(_material, "Instancing is only supported when using materials");
+
+    std::vector<uint32_t> keyData;
+    keyData.reserve(16);
+    keyData.push_back((uint32_t)_vertexBuffer);
+    keyData.push_back((uint32_t)_indexBuffer);
+    keyData.push_back((uint32_t)_primitive);
+    keyData.push_back((uint32_t)_indexFormat);
+    keyData.push_back((uint32_t)_indexCount);
+    keyData.push_back((uint32_t)lightMask);
+    keyData.push_back(_material->getStateBlock()->getHash());
+    keyData.push_back(_material->_currentTechnique->getStateBlock()->getHash());
+    const float components[4] = {color.x, color.y, color.z, color.w};
+    for (int i = 0; i < 4; ++i)
+    {
+        uint32_t value;
+        memcpy(&value, &components[i], sizeof(value));
+        keyData.push_back(value);
+    }
+
+    for (const auto& pass: _material->_currentTechnique->_passes)
+    {
+        auto texture = pass->getTexture();
+        intptr_t program = (intptr_t)pass->getGLProgramState()->getGLProgram();
+        keyData.push_back((uint32_t)program);
+        keyData.push_back((uint32_t)((uint64_t)program >> 32));
+        keyData.push_back(texture ? (uint32_t)texture->getName() : 0);
+        keyData.push_back(pass->getStateBlock()->getHash());
+        // the uniforms of a shared material are set by the callback when the command is drawn,
+        // the ones it holds now are another mesh's, the material and the color identify them
+        if (!_beforePassCallback)
+            keyData.push_back(pass->getGLProgramState()->getUniformsHash());
+    }
+
+    if (_beforePassCallback)
+    {
+        intptr_t material = (intptr_t)_material;
+        keyData.push_back((uint32_t)material);
+        keyData.push_back((uint32_t)((uint64_t)material >> 32));
+    }
+
+    if (lights)
+    {
+        for (const auto& light : *lights)
+        {
+            intptr_t pointer = (intptr_t)light;
+            keyData.push_back((uint32_t)pointer);
+            keyData.push_back((uint32_t)((uint64_t)pointer >> 32));
+        }
+    }
+
+    _instancingKey = XXH32((const void*)keyData.data(), (int)(keyData.size() * sizeof(uint32_t)), 0);
+}
+
+void MeshCommand::applyInstanceAttribute(GLProgram* glProgram) const
+{
+    auto attrib = glProgram->getVertexAttrib(GLProgram::ATTRIBUTE_NAME_INSTANCE_MV_MATRIX);
+    if (attrib)
+    {
+        // a mat4 attribute uses 4 consecutive locations, one per column
+        for (int i = 0; i < 4; ++i)
+            glVertexAttrib4fv(attrib->index + i, &_mv.m[i * 4]);
+    }
+
+    auto boneRowAttrib = glProgram->getVertexAttrib(GLProgram::ATTRIBUTE_NAME_INSTANCE_BONE_ROW);
+    if (boneRowAttrib)
+    {
+        glVertexAttrib1f(boneRowAttrib->index, (GLfloat)_boneTextureRow);
+        BoneMatrixTexture::getInstance()->bind(glProgram);
+    }
+}
+
+void MeshCommand::drawInstanced(const std::vector<MeshCommand*>& commands, GLuint instanceBuffer)
+{
+    if (commands.empty())
+        return;
+
+    auto first = commands.front();
+    CCASSERT(first->_material, "Instancing is only supported when using materials");
+
+#if CC_MESH_USE_INSTANCING
+    const GLsizei instanceCount = (GLsizei)commands.size();
+    const bool hardwareInstancing = instanceCount > 1 && Configuration::getInstance()->supportsInstancing();
+    if (hardwareInstancing)
+    {
+        // per instance: the model view matrix followed by the bone texture row
+        std::vector<GLfloat> instances;
+        instances.reserve(commands.size() * INSTANCE_FLOATS);
+        for (const auto& cmd: commands)
+        {
+            instances.insert(instances.end(), cmd->_mv.m, cmd->_mv.m + 16);
+            instances.push_back((GLfloat)cmd->_boneTextureRow);
+        }
+
+        glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(GLfloat) * instances.size(), instances.data(), GL_STREAM_DRAW);
+    }
+#else
+    CC_UNUSED_PARAM(instanceBuffer);
+#endif
+
+    for(const auto& pass: first->_material->_currentTechnique->_passes)
+    {
+        if (first->_beforePassCallback)
+            first->_beforePassCallback(pass);
+        pass->bind(first->_mv);
+        auto glProgram = pass->getGLProgramState()->getGLProgram();
+
+#if CC_MESH_USE_INSTANCING
+        auto attrib = glProgram->getVertexAttrib(GLProgram::ATTRIBUTE_NAME_INSTANCE_MV_MATRIX);
+        if (hardwareInstancing && attrib)
+        {
+            glBindBuffer(GL_ARRAY_BUFFER, instanceBuffer);
+            for (int i = 0; i < 4; ++i)
+            {
+                GLuint location = attrib->index + i;
+                glEnableVertexAttribArray(location);
+                glVertexAttribPointer(location, 4, GL_FLOAT, GL_FALSE, INSTANCE_STRIDE, (GLvoid*)(sizeof(GLfloat) * 4 * i));
+                glVertexAttribDivisor(location, 1);
+            }
+
+            auto boneRowAttrib = glProgram->getVertexAttrib(GLProgram::ATTRIBUTE_NAME_INSTANCE_BONE_ROW);
+            if (boneRowAttrib)
+            {
+                glEnableVertexAttribArray(boneRowAttrib->index);
+                glVertexAttribPointer(boneRowAttrib->index, 1, GL_FLOAT, GL_FALSE, INSTANCE_STRIDE, (GLvoid*)(sizeof(GLfloat) * 16));
+                glVertexAttribDivisor(boneRowAttrib->index, 1);
+                BoneMatrixTexture::getInstance()->bind(glProgram);
+            }
+
+            glDrawElementsInstanced(first->_primitive, (GLsizei)first->_indexCount, first->_indexFormat, 0, instanceCount);
+            CC_INCREMENT_GL_DRAWN_BATCHES_AND_VERTICES(1, first->_indexCount * instanceCount);
+
+            // the attribute locations may be used as regular arrays by other programs
+            for (int i = 0; i < 4; ++i)
+            {
+                GLuint location = attrib->index + i;
+                glVertexAttribDivisor(location, 0);
+                glDisableVertexAttribArray(location);
+            }
+            if (boneRowAttrib)
+            {
+                glVertexAttribDivisor(boneRowAttrib->index, 0);
+                glDisableVertexAttribArray(boneRowAttrib->index);
+            }
+        }
+        else
+#endif
+        {
+            for (const auto& cmd: commands)
+            {
+                cmd->applyInstanceAttribute(glProgram);
+                glDrawElements(first->_primitive, (GLsizei)first->_indexCount, first->_indexFormat, 0);
+                CC_INCREMENT_GL_DRAWN_BATCHES_AND_VERTICES(1, first->_indexCount);
+            }
+        }
+
+        pass->unbind();
+    }
+}
+
 void MeshCommand::preBatchDraw()
 {
     // Do nothing if using material since each pass needs to bind its own VAO
@@ -216,7 +391,11 @@ void MeshCommand::batchDraw()
     {
         for(const auto& pass: _material->_currentTechnique->_passes)
         {
+            if (_beforePassCallback)
+                _beforePassCallback(pass);
             pass->bind(_mv);
+            // the instanced programs read the matrix from the attribute even when the command isn't merged
+            applyInstanceAttribute(pass->getGLProgramState()->getGLProgram());
 
             glDrawElements(_primitive, (GLsizei)_indexCount, _indexFormat, 0);
             CC_INCREMENT_GL_DRAWN_BATCHES_AND_VERTICES(1, _indexCount);
@@ -267,7 +446,11 @@ void MeshCommand::execute()
     {
         for(const auto& pass: _material->_currentTechnique->_passes)
         {
+            if (_beforePassCallback)
+                _beforePassCallback(pass);
             pass->bind(_mv, true);
+            // the instanced programs read the matrix from the attribute even when the command isn't merged
+            applyInstanceAttribute(pass->getGLProgramState()->getGLProgram());
 
             glDrawElements(_primitive, (GLsizei)_indexCount, _indexFormat, 0);
             CC_INCREMENT_GL_DRAWN_BATCHES_AND_VERTICES(1, _indexCount);
@@ -336,4 +519,132 @@ void MeshCommand::listenRendererRecreated(EventCustom* event)
 
 #endif
 
+static BoneMatrixTexture* s_sharedBoneMatrixTexture = nullptr;
+
+BoneMatrixTexture* BoneMatrixTexture::getInstance()
+{
+    if (!s_sharedBoneMatrixTexture)
+    {
+        s_sharedBoneMatrixTexture = new (std::nothrow) BoneMatrixTexture();
+    }
+    return s_sharedBoneMatrixTexture;
+}
+
+void BoneMatrixTexture::destroyInstance()
+{
+    CC_SAFE_DELETE(s_sharedBoneMatrixTexture);
+}
+
+BoneMatrixTexture::BoneMatrixTexture()
+: _rowCount(0)
+, _uploadedRowCount(0)
+, _height(0)
+, _name(0)
+, _afterDrawListener(nullptr)
+{
+    auto dispatcher = Director::getInstance()->getEventDispatcher();
+    _afterDrawListener = dispatcher->addCustomEventListener(Director::EVENT_AFTER_DRAW, [this](EventCustom*) {
+        reset();
+    });
+
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID || CC_TARGET_PLATFORM == CC_PLATFORM_WINRT)
+    // the texture is lost with the context, it is recreated with all rows on the next bind
+    _rendererRecreatedListener = EventListenerCustom::create(EVENT_RENDERER_RECREATED, [this](EventCustom*) {
+        _name = 0;
+        _height = 0;
+        _uploadedRowCount = 0;
+    });
+    dispatcher->addEventListenerWithFixedPriority(_rendererRecreatedListener, -1);
+#endif
+}
+
+BoneMatrixTexture::~BoneMatrixTexture()
+{
+    auto dispatcher = Director::getInstance()->getEventDispatcher();
+    dispatcher->removeEventListener(_afterDrawListener);
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID || CC_TARGET_PLATFORM == CC_PLATFORM_WINRT)
+    dispatcher->removeEventListener(_rendererRecreatedListener);
+#endif
+
+    if (_name)
+        GL::deleteTexture(_name);
+}
+
+int BoneMatrixTexture::addPalette(const Vec4* palette, ssize_t paletteSize)
+{
+    CCASSERT(paletteSize <= WIDTH, "The matrix palette does not fit in one row of the bone texture");
+    paletteSize = std::min(paletteSize, (ssize_t)WIDTH);
+
+    std::lock_guard<std::mutex> lock(_mutex);
+    int row = _rowCount++;
+    if (_rows.size() < (size_t)_rowCount * WIDTH)
+        _rows.resize((size_t)_rowCount * WIDTH);
+    std::copy(palette, palette + paletteSize, _rows.begin() + (size_t)row * WIDTH);
+    return row;
+}
+
+void BoneMatrixTexture::bind(GLProgram* glProgram)
+{
+    upload();
+
+    GL::bindTexture2DN(GLProgram::BONE_TEXTURE_UNIT, _name);
+    GLint location = glProgram->getBuiltInUniformLocation(GLProgram::UNIFORM_BONE_TEXTURE_INV_SIZE);
+    if (location != -1 && _height > 0)
+        glProgram->setUniformLocationWith2f(location, 1.0f / WIDTH, 1.0f / _height);
+}
+
+void BoneMatrixTexture::reset()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    _rowCount = 0;
+    _uploadedRowCount = 0;
+}
+
+void BoneMatrixTexture::upload()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (_uploadedRowCount == _rowCount && _name != 0)
+        return;
+
+#if defined(GL_RGBA32F) && (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32 || CC_TARGET_PLATFORM == CC_PLATFORM_MAC || CC_TARGET_PLATFORM == CC_PLATFORM_LINUX)
+    const GLint internalFormat = GL_RGBA32F;
+#else
+    const GLint internalFormat = GL_RGBA;
+#endif
+
+    if (_name == 0)
+    {
+        glGenTextures(1, &_name);
+        GL::bindTexture2DN(GLProgram::BONE_TEXTURE_UNIT, _name);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    }
+    else
+    {
+        GL::bindTexture2DN(GLProgram::BONE_TEXTURE_UNIT, _name);
+    }
+
+    // grow by powers of two so the storage is rarely reallocated
+    int height = std::max(_height, 16);
+    while (height < _rowCount)
+        height *= 2;
+
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    if (height != _height)
+    {
+        _height = height;
+        _uploadedRowCount = 0;
+        glTexImage2D(GL_TEXTURE_2D, 0, internalFormat, WIDTH, _height, 0, GL_RGBA, GL_FLOAT, nullptr);
+    }
+
+    if (_rowCount > _uploadedRowCount)
+    {
+        glTexSubImage2D(GL_TEXTURE_2D, 0, 0, _uploadedRowCount, WIDTH, _rowCount - _uploadedRowCount, GL_RGBA, GL_FLOAT,
+                        _rows.data() + (size_t)_uploadedRowCount * WIDTH);
+    }
+    _uploadedRowCount = _rowCount;
+}
+
 NS_CC_END
@@ -25,7 +25,10 @@
 #ifndef _CC_MESHCOMMAND_H_
 #define _CC_MESHCOMMAND_H_
 
+#include <functional>
+#include <mutex>
 #include <unordered_map>
+#include <vector>
 #include "renderer/CCRenderCommand.h"
 #include "renderer/CCGLProgram.h"
 #include "renderer/CCRenderState.h"
@@ -37,6 +40,8 @@ class GLProgramState;
 class EventListenerCustom;
 class EventCustom;
 class Material;
+class BaseLight;
+class Pass;
 
 //it is a common mesh
 class CC_DLL MeshCommand : public RenderCommand
@@ -65,6 +70,45 @@ public:
     void genMaterialID(GLuint texID, void* glProgramState, GLuint vertexBuffer, GLuint indexBuffer, BlendFunc blend);
     
     uint32_t getMaterialID() const;
+
+    /**
+     Enable or disable hardware instancing for this command. Only valid for commands using a Material whose
+     passes were compiled with the CC_INSTANCING define (see GLProgram::SHADER_3D_POSITION_INSTANCED).
+     Consecutive commands with the same instancing key are merged by the Renderer into one instanced draw.
+     Disabled by default, see Mesh::setInstancingEnabled().
+     */
+    void setInstancingEnabled(bool enabled) { _instancingEnabled = enabled; }
+    bool isInstancingEnabled() const { return _instancingEnabled; }
+
+    /**
+     Generate the key used to merge commands into one instanced draw. Commands sharing a key must render
+     the same geometry with the same programs, textures, render states and uniform values.
+     The lights are given when the mesh is only lit by some of the lights of the scene.
+     */
+    void genInstancingKey(const Vec4& color, unsigned int lightMask, const std::vector<BaseLight*>* lights = nullptr);
+    uint32_t getInstancingKey() const { return _instancingKey; }
+
+    /**
+     Draw a list of commands sharing the same instancing key with a single instanced draw per pass.
+     The model view matrices are uploaded to instanceBuffer. Falls back to one draw per command
+     when hardware instancing is not supported.
+     */
+    static void drawInstanced(const std::vector<MeshCommand*>& commands, GLuint instanceBuffer);
+
+    /**
+     Set the row of the BoneMatrixTexture holding the matrix palette of this command, used by skinned
+     meshes drawn with programs compiled with the CC_BONE_TEXTURE define. -1 means no row.
+     */
+    void setBoneTextureRow(int row) { _boneTextureRow = row; }
+    int getBoneTextureRow() const { return _boneTextureRow; }
+
+    /**
+     Set a function called before each pass of the Material is bound. A Mesh whose Material is shared with
+     other meshes sets its color, lights and matrix palette there, the values given to the shared GLProgramStates
+     while visiting would be overwritten by the next mesh. Instanced draws call the one of their first command.
+     @since v3.14
+     */
+    void setBeforePassCallback(const std::function<void(Pass*)>& callback) { _beforePassCallback = callback; }
     
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID || CC_TARGET_PLATFORM == CC_PLATFORM_WINRT)
     void listenRendererRecreated(EventCustom* event);
@@ -78,6 +122,9 @@ protected:
     // apply renderstate, not used when using material
     void applyRenderState();
 
+    // set the model view matrix as a constant attribute, used by instanced programs when drawn alone
+    void applyInstanceAttribute(GLProgram* glProgram) const;
+
 
     Vec4 _displayColor; // in order to support tint and fade in fade out
     
@@ -86,6 +133,11 @@ protected:
     int   _matrixPaletteSize;
     
     uint32_t _materialID; //material ID
+
+    bool _instancingEnabled;
+    uint32_t _instancingKey;
+    int _boneTextureRow;
+    std::function<void(Pass*)> _beforePassCallback;
     
     GLuint   _vao; //use vao if possible
     
@@ -117,6 +169,52 @@ protected:
 #endif
 };
 
+/**
+ A float texture holding the matrix palettes of all skinned meshes drawn in the current frame, one palette
+ per row and three texels per bone. It lets instanced skinned meshes fetch their own palette in the vertex
+ shader instead of sharing one u_matrixPalette uniform, and lifts the uniform limit on the bone count.
+ Rows are cleared after each frame is drawn.
+ @since v3.14
+ */
+class CC_DLL BoneMatrixTexture
+{
+public:
+    /** Width of the texture in texels, a palette is at most WIDTH / 3 bones. */
+    static const int WIDTH = 1024;
+
+    static BoneMatrixTexture* getInstance();
+    static void destroyInstance();
+
+    /**
+     Copy a matrix palette to a new row and return its index. The palette is uploaded on the next bind().
+     Thread safe, meshes may be drawn from worker threads.
+     */
+    int addPalette(const Vec4* palette, ssize_t paletteSize);
+
+    /** Upload the pending rows and bind the texture for a program using CC_BoneTexture. */
+    void bind(GLProgram* glProgram);
+
+    /** Drop all rows, called after each frame. */
+    void reset();
+
+protected:
+    BoneMatrixTexture();
+    ~BoneMatrixTexture();
+
+    void upload();
+
+    std::mutex _mutex;
+    std::vector<Vec4> _rows;
+    int _rowCount;
+    int _uploadedRowCount;
+    int _height;
+    GLuint _name;
+    EventListenerCustom* _afterDrawListener;
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID || CC_TARGET_PLATFORM == CC_PLATFORM_WINRT)
+    EventListenerCustom* _rendererRecreatedListener;
+#endif
+};
+
 NS_CC_END
 
 #endif //_CC_MESHCOMMAND_H_
@@ -30,6 +30,7 @@
 
 #include "platform/CCPlatformMacros.h"
 #include "base/ccTypes.h"
+#include "base/allocator/CCAllocatorMacros.h"
 
 /**
  * @addtogroup renderer
@@ -97,8 +98,16 @@ public:
     void set3D(bool value) { _is3D = value; }
     /**Get the depth by current model view matrix.*/
     float getDepth() const { return _depth; }
+    /**
+     Get the key used to sort the command in its render queue. It packs the sort criteria of the
+     queue (global Z order or depth) in the high 32 bits and the insertion order in the low 32 bits.
+     Only valid once the command was added to a queue.
+     */
+    uint64_t getSortKey() const { return _sortKey; }
     
 protected:
+    friend class RenderQueue;
+
     /**Constructor.*/
     RenderCommand();
     /**Destructor.*/
@@ -126,6 +135,9 @@ protected:
     
     /** Depth from the model view matrix.*/
     float _depth;
+
+    /** Sort key, set by the RenderQueue when the command is added. */
+    uint64_t _sortKey;
 };
 
 NS_CC_END
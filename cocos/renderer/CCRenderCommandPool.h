@@ -26,7 +26,7 @@
 #define __CC_RENDERCOMMANDPOOL_H__
 /// @cond DO_NOT_SHOW
 
-#include <list>
+#include <vector>
 
 #include "platform/CCPlatformMacros.h"
 
@@ -36,7 +36,11 @@ template <class T>
 class RenderCommandPool
 {
 public:
+    static const int COMMANDS_ALLOCATE_BLOCK_SIZE = 32;
+
     RenderCommandPool()
+    : _transientBlock(0)
+    , _transientIndex(0)
     {
     }
     ~RenderCommandPool()
@@ -52,6 +56,11 @@ public:
             allocatedPoolBlock = nullptr;
         }
         _allocatedPoolBlocks.clear();
+        for (auto& transientBlock : _transientBlocks)
+        {
+            delete[] transientBlock;
+        }
+        _transientBlocks.clear();
     }
 
     T* generateCommand()
@@ -61,8 +70,8 @@ public:
         {
             AllocateCommands();
         }
-        result = _freePool.front();
-        _freePool.pop_front();
+        result = _freePool.back();
+        _freePool.pop_back();
         //_usedPool.insert(result);
         return result;
     }
@@ -79,21 +88,55 @@ public:
         //_usedPool.erase(ptr);
         
     }
+
+    // Bump allocates a command that stays valid until resetTransientCommands().
+    // The commands are not destroyed on reset, they are reused as is by the next frames,
+    // so the caller has to init() them.
+    T* generateTransientCommand()
+    {
+        if (_transientIndex == COMMANDS_ALLOCATE_BLOCK_SIZE)
+        {
+            ++_transientBlock;
+            _transientIndex = 0;
+        }
+        if (_transientBlock == _transientBlocks.size())
+        {
+            _transientBlocks.push_back(new (std::nothrow) T[COMMANDS_ALLOCATE_BLOCK_SIZE]);
+        }
+        return _transientBlocks[_transientBlock] + _transientIndex++;
+    }
+
+    // Releases all the transient commands at once, the blocks are kept for the next frame.
+    void resetTransientCommands()
+    {
+        _transientBlock = 0;
+        _transientIndex = 0;
+    }
+
+    // The number of transient commands generated since the last reset
+    size_t getTransientCommandCount() const
+    {
+        return _transientBlock * COMMANDS_ALLOCATE_BLOCK_SIZE + _transientIndex;
+    }
 private:
     void AllocateCommands()
     {
-        static const int COMMANDS_ALLOCATE_BLOCK_SIZE = 32;
         T* commands = new (std::nothrow) T[COMMANDS_ALLOCATE_BLOCK_SIZE];
         _allocatedPoolBlocks.push_back(commands);
-        for(int index = 0; index < COMMANDS_ALLOCATE_BLOCK_SIZE; ++index)
+        _freePool.reserve(_allocatedPoolBlocks.size() * COMMANDS_ALLOCATE_BLOCK_SIZE);
+        for(int index = COMMANDS_ALLOCATE_BLOCK_SIZE - 1; index >= 0; --index)
         {
             _freePool.push_back(commands+index);
         }
     }
 
-    std::list<T*> _allocatedPoolBlocks;
-    std::list<T*> _freePool;
+    std::vector<T*> _allocatedPoolBlocks;
+    std::vector<T*> _freePool;
     //std::set<T*> _usedPool;
+
+    std::vector<T*> _transientBlocks;
+    size_t _transientBlock;
+    int _transientIndex;
 };
 
 NS_CC_END
@@ -25,8 +25,13 @@
 #include "renderer/CCRenderer.h"
 
 #include <algorithm>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
 
 #include "renderer/CCTrianglesCommand.h"
+#include "renderer/CCQuadCommand.h"
 #include "renderer/CCBatchCommand.h"
 #include "renderer/CCCustomCommand.h"
 #include "renderer/CCGroupCommand.h"
@@ -44,24 +49,86 @@
 #include "base/CCEventDispatcher.h"
 #include "base/CCEventListenerCustom.h"
 #include "base/CCEventType.h"
+#include "base/ccUTF8.h"
+#include "base/CCProfiling.h"
 #include "2d/CCCamera.h"
 #include "2d/CCScene.h"
+#include "3d/CCAABB.h"
+
+// glMapBufferRange() is core (or aliased to the EXT version in CCGL.h) on these platforms.
+// GL ES 2 platforms without it always use the orphaning path.
+#if defined(GL_MAP_UNSYNCHRONIZED_BIT) && defined(GL_MAP_INVALIDATE_BUFFER_BIT)
+#define CC_RENDERER_USE_MAP_BUFFER_RANGE 1
+#else
+#define CC_RENDERER_USE_MAP_BUFFER_RANGE 0
+#endif
+
+#if CC_RENDERER_USE_MAP_BUFFER_RANGE && defined(GL_SYNC_GPU_COMMANDS_COMPLETE)
+#define CC_RENDERER_USE_SYNC_OBJECTS 1
+#else
+#define CC_RENDERER_USE_SYNC_OBJECTS 0
+#endif
+
+// Timestamp queries come from GL_ARB_timer_query on desktop and GL_EXT_disjoint_timer_query on Android.
+// The legacy GL 2.1 context used on Mac only exposes GL_EXT_timer_query, which can't be nested.
+#if defined(GL_TIMESTAMP) && (CC_TARGET_PLATFORM != CC_PLATFORM_MAC)
+#define CC_RENDERER_USE_TIMER_QUERY 1
+#else
+#define CC_RENDERER_USE_TIMER_QUERY 0
+#endif
+
+// Occlusion queries count the samples with GL_ARB_occlusion_query on desktop,
+// GL_EXT_occlusion_query_boolean only tells whether any sample passed.
+#if defined(CC_PLATFORM_PC) && defined(GL_SAMPLES_PASSED)
+#define CC_RENDERER_OCCLUSION_QUERY_TARGET GL_SAMPLES_PASSED
+#define CC_RENDERER_USE_OCCLUSION_QUERY 1
+#elif defined(GL_ANY_SAMPLES_PASSED)
+#define CC_RENDERER_OCCLUSION_QUERY_TARGET GL_ANY_SAMPLES_PASSED
+#define CC_RENDERER_USE_OCCLUSION_QUERY 1
+#else
+#define CC_RENDERER_USE_OCCLUSION_QUERY 0
+#endif
 
 NS_CC_BEGIN
 
 // helper
-static bool compareRenderCommand(RenderCommand* a, RenderCommand* b)
+// maps a float to an unsigned integer with the same ordering
+static inline uint32_t orderedFloatBits(float value)
+{
+    // -0 and 0 must have the same key
+    if (value == 0)
+        value = 0;
+
+    uint32_t bits;
+    memcpy(&bits, &value, sizeof(bits));
+    return (bits & 0x80000000u) ? ~bits : (bits | 0x80000000u);
+}
+
+static inline uint64_t makeSortKey(float value, size_t insertionOrder)
 {
-    return a->getGlobalOrder() < b->getGlobalOrder();
+    return ((uint64_t)orderedFloatBits(value) << 32) | (uint32_t)insertionOrder;
 }
 
-static bool compare3DCommand(RenderCommand* a, RenderCommand* b)
+static inline uint64_t makeOpaqueSortKey(RenderQueue::OpaqueSortMode mode, RenderCommand* command, size_t insertionOrder)
 {
-    return  a->getDepth() > b->getDepth();
+    if (mode == RenderQueue::OpaqueSortMode::NONE || command->getType() != RenderCommand::Type::MESH_COMMAND)
+        return insertionOrder;
+
+    // front to back, only the depth of the origin of the mesh is known
+    uint32_t value = orderedFloatBits(command->getDepth());
+    if (mode == RenderQueue::OpaqueSortMode::STATE_THEN_FRONT_TO_BACK)
+    {
+        // 16 bits of the material id, then the coarse depth: the meshes of a material stay together
+        // except on collisions, which only cost a state change
+        uint32_t materialID = static_cast<MeshCommand*>(command)->getMaterialID();
+        value = ((materialID ^ (materialID >> 16)) << 16) | (value >> 16);
+    }
+    return ((uint64_t)value << 32) | (uint32_t)insertionOrder;
 }
 
 // queue
 RenderQueue::RenderQueue()
+: _opaqueSortMode(OpaqueSortMode::NONE)
 {
     
 }
@@ -71,11 +138,15 @@ void RenderQueue::push_back(RenderCommand* command)
     float z = command->getGlobalOrder();
     if(z < 0)
     {
-        _commands[QUEUE_GROUP::GLOBALZ_NEG].push_back(command);
+        auto& queue = _commands[QUEUE_GROUP::GLOBALZ_NEG];
+        command->_sortKey = makeSortKey(z, queue.size());
+        queue.push_back(command);
     }
     else if(z > 0)
     {
-        _commands[QUEUE_GROUP::GLOBALZ_POS].push_back(command);
+        auto& queue = _commands[QUEUE_GROUP::GLOBALZ_POS];
+        command->_sortKey = makeSortKey(z, queue.size());
+        queue.push_back(command);
     }
     else
     {
@@ -83,16 +154,23 @@ void RenderQueue::push_back(RenderCommand* command)
         {
             if(command->isTransparent())
             {
-                _commands[QUEUE_GROUP::TRANSPARENT_3D].push_back(command);
+                // back to front
+                auto& queue = _commands[QUEUE_GROUP::TRANSPARENT_3D];
+                command->_sortKey = makeSortKey(-command->getDepth(), queue.size());
+                queue.push_back(command);
             }
             else
             {
-                _commands[QUEUE_GROUP::OPAQUE_3D].push_back(command);
+                auto& queue = _commands[QUEUE_GROUP::OPAQUE_3D];
+                command->_sortKey = makeOpaqueSortKey(_opaqueSortMode, command, queue.size());
+                queue.push_back(command);
             }
         }
         else
         {
-            _commands[QUEUE_GROUP::GLOBALZ_ZERO].push_back(command);
+            auto& queue = _commands[QUEUE_GROUP::GLOBALZ_ZERO];
+            command->_sortKey = makeSortKey(0, queue.size());
+            queue.push_back(command);
         }
     }
 }
@@ -111,9 +189,97 @@ ssize_t RenderQueue::size() const
 void RenderQueue::sort()
 {
     // Don't sort _queue0, it already comes sorted
-    std::stable_sort(std::begin(_commands[QUEUE_GROUP::TRANSPARENT_3D]), std::end(_commands[QUEUE_GROUP::TRANSPARENT_3D]), compare3DCommand);
-    std::stable_sort(std::begin(_commands[QUEUE_GROUP::GLOBALZ_NEG]), std::end(_commands[QUEUE_GROUP::GLOBALZ_NEG]), compareRenderCommand);
-    std::stable_sort(std::begin(_commands[QUEUE_GROUP::GLOBALZ_POS]), std::end(_commands[QUEUE_GROUP::GLOBALZ_POS]), compareRenderCommand);
+    if (_opaqueSortMode != OpaqueSortMode::NONE)
+        sortOpaqueGroup();
+    sortQueueGroup(QUEUE_GROUP::TRANSPARENT_3D);
+    sortQueueGroup(QUEUE_GROUP::GLOBALZ_NEG);
+    sortQueueGroup(QUEUE_GROUP::GLOBALZ_POS);
+}
+
+void RenderQueue::sortOpaqueGroup()
+{
+    // the other commands may change states for the meshes after them, the meshes aren't moved across them
+    auto& commands = _commands[QUEUE_GROUP::OPAQUE_3D];
+    const size_t count = commands.size();
+    size_t begin = 0;
+    for (size_t i = 0; i <= count; ++i)
+    {
+        if (i == count || commands[i]->getType() != RenderCommand::Type::MESH_COMMAND)
+        {
+            sortCommands(commands.data() + begin, i - begin);
+            begin = i + 1;
+        }
+    }
+}
+
+void RenderQueue::sortQueueGroup(QUEUE_GROUP group)
+{
+    auto& commands = _commands[group];
+    sortCommands(commands.data(), commands.size());
+}
+
+void RenderQueue::sortCommands(RenderCommand** commands, size_t count)
+{
+    if (count < 2)
+        return;
+
+    // The insertion order is part of the key: keys are unique and the result is stable.
+    _sortBuffer.resize(count * 2);
+    SortEntry* src = _sortBuffer.data();
+    SortEntry* dst = src + count;
+
+    bool sorted = true;
+    for (size_t i = 0; i < count; ++i)
+    {
+        src[i].key = commands[i]->_sortKey;
+        src[i].command = commands[i];
+        if (i > 0 && src[i].key < src[i - 1].key)
+            sorted = false;
+    }
+    if (sorted)
+        return;
+
+    if (count < 64)
+    {
+        std::sort(src, src + count, [](const SortEntry& a, const SortEntry& b) { return a.key < b.key; });
+    }
+    else
+    {
+        // LSD radix sort, 8 bits per pass. Passes where every key has the same byte are skipped,
+        // which is usually the case for the upper bytes of the insertion order.
+        uint32_t histograms[8][256];
+        memset(histograms, 0, sizeof(histograms));
+        for (size_t i = 0; i < count; ++i)
+        {
+            const uint64_t key = src[i].key;
+            for (int pass = 0; pass < 8; ++pass)
+                ++histograms[pass][(key >> (pass * 8)) & 0xff];
+        }
+
+        for (int pass = 0; pass < 8; ++pass)
+        {
+            const int shift = pass * 8;
+            uint32_t* histogram = histograms[pass];
+            if (histogram[(src[0].key >> shift) & 0xff] == count)
+                continue;
+
+            uint32_t offset = 0;
+            for (int bucket = 0; bucket < 256; ++bucket)
+            {
+                const uint32_t bucketSize = histogram[bucket];
+                histogram[bucket] = offset;
+                offset += bucketSize;
+            }
+
+            for (size_t i = 0; i < count; ++i)
+                dst[histogram[(src[i].key >> shift) & 0xff]++] = src[i];
+
+            std::swap(src, dst);
+        }
+    }
+
+    for (size_t i = 0; i < count; ++i)
+        commands[i] = src[i].command;
 }
 
 RenderCommand* RenderQueue::operator[](ssize_t index) const
@@ -151,9 +317,9 @@ void RenderQueue::realloc(size_t reserveSize)
 
 void RenderQueue::saveRenderState()
 {
-    _isDepthEnabled = glIsEnabled(GL_DEPTH_TEST) != GL_FALSE;
-    _isCullEnabled = glIsEnabled(GL_CULL_FACE) != GL_FALSE;
-    glGetBooleanv(GL_DEPTH_WRITEMASK, &_isDepthWrite);
+    _isDepthEnabled = GL::isEnabled(GL_DEPTH_TEST) != GL_FALSE;
+    _isCullEnabled = GL::isEnabled(GL_CULL_FACE) != GL_FALSE;
+    _isDepthWrite = GL::getDepthMask();
     
     CHECK_GL_ERROR_DEBUG();
 }
@@ -162,32 +328,171 @@ void RenderQueue::restoreRenderState()
 {
     if (_isCullEnabled)
     {
-        glEnable(GL_CULL_FACE);
+        GL::enable(GL_CULL_FACE);
         RenderState::StateBlock::_defaultState->setCullFace(true);
     }
     else
     {
-        glDisable(GL_CULL_FACE);
+        GL::disable(GL_CULL_FACE);
         RenderState::StateBlock::_defaultState->setCullFace(false);
     }
 
     if (_isDepthEnabled)
     {
-        glEnable(GL_DEPTH_TEST);
+        GL::enable(GL_DEPTH_TEST);
         RenderState::StateBlock::_defaultState->setDepthTest(true);
     }
     else
     {
-        glDisable(GL_DEPTH_TEST);
+        GL::disable(GL_DEPTH_TEST);
         RenderState::StateBlock::_defaultState->setDepthTest(false);
     }
     
-    glDepthMask(_isDepthWrite);
+    GL::depthMask(_isDepthWrite);
     RenderState::StateBlock::_defaultState->setDepthWrite(_isDepthEnabled);
 
     CHECK_GL_ERROR_DEBUG();
 }
 
+//
+// Fork-join workers used by the parallel visit. The calling thread runs jobs as well.
+//
+class VisitWorkerPool
+{
+public:
+    explicit VisitWorkerPool(unsigned int workerCount)
+    : _jobs(nullptr)
+    , _nextJob(0)
+    , _finishedJobs(0)
+    , _activeWorkers(0)
+    , _generation(0)
+    , _stop(false)
+    {
+        _slots.resize(workerCount + 1);
+        _slots[0].threadID = std::this_thread::get_id();
+        _threads.reserve(workerCount);
+        for (unsigned int i = 0; i < workerCount; ++i)
+        {
+            _threads.push_back(std::thread(&VisitWorkerPool::workerLoop, this));
+            _slots[i + 1].threadID = _threads.back().get_id();
+        }
+    }
+
+    ~VisitWorkerPool()
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _stop = true;
+        }
+        _condition.notify_all();
+        for (auto& thread : _threads)
+            thread.join();
+    }
+
+    // returns when every job is done
+    void run(const std::vector<std::function<void()>>& jobs)
+    {
+        {
+            std::lock_guard<std::mutex> lock(_mutex);
+            _jobs = &jobs;
+            _nextJob = 0;
+            _finishedJobs = 0;
+            ++_generation;
+        }
+        _condition.notify_all();
+
+        executeJobs(jobs);
+
+        std::unique_lock<std::mutex> lock(_mutex);
+        // workers that picked up this generation must be done with it before `jobs` goes away
+        _doneCondition.wait(lock, [&]{ return _finishedJobs == jobs.size() && _activeWorkers == 0; });
+        _jobs = nullptr;
+    }
+
+    // the context is owned by the calling thread: only that thread reads or writes it
+    void* getContext() const
+    {
+        const auto threadID = std::this_thread::get_id();
+        for (const auto& slot : _slots)
+        {
+            if (slot.threadID == threadID)
+                return slot.context;
+        }
+        return nullptr;
+    }
+
+    void setContext(void* context)
+    {
+        const auto threadID = std::this_thread::get_id();
+        for (auto& slot : _slots)
+        {
+            if (slot.threadID == threadID)
+            {
+                slot.context = context;
+                return;
+            }
+        }
+    }
+
+protected:
+    void executeJobs(const std::vector<std::function<void()>>& jobs)
+    {
+        size_t index;
+        while ((index = _nextJob++) < jobs.size())
+        {
+            jobs[index]();
+            if (++_finishedJobs == jobs.size())
+            {
+                std::lock_guard<std::mutex> lock(_mutex);
+                _doneCondition.notify_all();
+            }
+        }
+    }
+
+    void workerLoop()
+    {
+        unsigned int seenGeneration = 0;
+        for (;;)
+        {
+            const std::vector<std::function<void()>>* jobs = nullptr;
+            {
+                std::unique_lock<std::mutex> lock(_mutex);
+                _condition.wait(lock, [&]{ return _stop || (_jobs && _generation != seenGeneration); });
+                if (_stop)
+                    return;
+                seenGeneration = _generation;
+                jobs = _jobs;
+                ++_activeWorkers;
+            }
+
+            executeJobs(*jobs);
+
+            std::lock_guard<std::mutex> lock(_mutex);
+            --_activeWorkers;
+            _doneCondition.notify_all();
+        }
+    }
+
+    struct Slot
+    {
+        Slot() : context(nullptr) {}
+        std::thread::id threadID;
+        void* context;
+    };
+
+    std::vector<std::thread> _threads;
+    std::vector<Slot> _slots;
+    const std::vector<std::function<void()>>* _jobs;
+    std::atomic<size_t> _nextJob;
+    std::atomic<size_t> _finishedJobs;
+    int _activeWorkers;
+    unsigned int _generation;
+    bool _stop;
+    std::mutex _mutex;
+    std::condition_variable _condition;
+    std::condition_variable _doneCondition;
+};
+
 //
 //
 //
@@ -198,6 +503,7 @@ static const int DEFAULT_RENDER_QUEUE = 0;
 //
 Renderer::Renderer()
 :_lastBatchedMeshCommand(nullptr)
+,_instanceBufferVBO(0)
 ,_filledVertex(0)
 ,_filledIndex(0)
 ,_glViewAssigned(false)
@@ -205,11 +511,50 @@ Renderer::Renderer()
 ,_isDepthTestFor2D(false)
 ,_triBatchesToDraw(nullptr)
 ,_triBatchesToDrawCapacity(-1)
+,_useRingBuffer(false)
+,_ringSegment(0)
+,_ringFilledVertex(0)
+,_ringFilledIndex(0)
+,_batchingEnabled(true)
+,_cullingEnabled(true)
+,_commandStatisticsEnabled(false)
+,_addedCommands(0)
+,_batchBreakStatisticsEnabled(false)
+,_drawingNode(nullptr)
+,_overdrawVisualizationEnabled(false)
+,_overdrawProgram(nullptr)
+,_overdrawCoverageThreshold(0.25f)
+,_overdrawAlphaThreshold(0.05f)
+,_flushCause(BatchBreakCause::COUNT)
+,_hasPendingBatchBreak(false)
+,_pendingBatchBreakCause(BatchBreakCause::COUNT)
+,_pendingBatchBreakCommand(nullptr)
+,_multiTextureBatching(false)
+,_multiTextureProgram(nullptr)
+,_multiTextureBaseProgram(nullptr)
+,_textureSlotVBO(0)
+,_gpuTimingEnabled(false)
+,_gpuFrameTime(0)
+,_occlusionCullingEnabled(false)
+,_opaqueSortMode(RenderQueue::OpaqueSortMode::NONE)
+,_depthPrePassEnabled(false)
+,_occludedCount(0)
+,_lastOccludedCount(0)
+,_parallelVisitEnabled(false)
+,_isRecordingVisits(false)
+,_visitWorkerPool(nullptr)
+,_queueGeneration(1)
 #if CC_ENABLE_CACHE_TEXTURE_DATA
 ,_cacheTextureListener(nullptr)
 #endif
 {
     _groupCommandManager = new (std::nothrow) GroupCommandManager();
+    _commandStatistics.frame = _lastCommandStatistics.frame = 0;
+    resetBatchBreakStatistics();
+    _lastBatchBreakStatistics = _batchBreakStatistics;
+    _overdrawStatistics.frame = 0;
+    _overdrawStatistics.screenPixels = 0;
+    _lastOverdrawStatistics = _overdrawStatistics;
     
     _commandGroupStack.push(DEFAULT_RENDER_QUEUE);
     
@@ -223,17 +568,39 @@ Renderer::Renderer()
     // for the batched TriangleCommand
     _triBatchesToDrawCapacity = 500;
     _triBatchesToDraw = (TriBatchToDraw*) malloc(sizeof(_triBatchesToDraw[0]) * _triBatchesToDrawCapacity);
+
+    for (int i = 0; i < RING_BUFFER_SEGMENTS; ++i)
+        _ringFences[i] = nullptr;
 }
 
 Renderer::~Renderer()
 {
     _renderGroups.clear();
     _groupCommandManager->release();
+
+    delete _visitWorkerPool;
+    for (auto recording : _visitRecordings)
+        delete recording;
     
     glDeleteBuffers(2, _buffersVBO);
+    if (_instanceBufferVBO)
+        glDeleteBuffers(1, &_instanceBufferVBO);
+    if (_textureSlotVBO)
+        glDeleteBuffers(1, &_textureSlotVBO);
+
+    setGPUTimingEnabled(false);
+    releaseOcclusionQueries();
 
     free(_triBatchesToDraw);
 
+#if CC_RENDERER_USE_SYNC_OBJECTS
+    for (int i = 0; i < RING_BUFFER_SEGMENTS; ++i)
+    {
+        if (_ringFences[i])
+            glDeleteSync((GLsync)_ringFences[i]);
+    }
+#endif
+
     if (Configuration::getInstance()->supportsShareableVAO())
     {
         glDeleteVertexArrays(1, &_buffersVAO);
@@ -250,12 +617,17 @@ void Renderer::initGLView()
     _cacheTextureListener = EventListenerCustom::create(EVENT_RENDERER_RECREATED, [this](EventCustom* event){
         /** listen the event that renderer was recreated on Android/WP8 */
         this->setupBuffer();
+        // the queries were lost with the context
+        _occlusionStates.clear();
+        _freeOcclusionQueries.clear();
     });
     
     Director::getInstance()->getEventDispatcher()->addEventListenerWithFixedPriority(_cacheTextureListener, -1);
 #endif
 
     setupBuffer();
+
+    _multiTextureBatching = Configuration::getInstance()->useRendererMultiTextureBatching();
     
     _glViewAssigned = true;
 }
@@ -270,6 +642,126 @@ void Renderer::setupBuffer()
     {
         setupVBO();
     }
+
+    setupRingBuffer();
+
+    // created lazily by the first instanced draw, the old names are invalid after a context loss
+    _instanceBufferVBO = 0;
+    _textureSlotVBO = 0;
+    _gpuTimingFrames.clear();
+    _freeTimerQueries.clear();
+    _gpuScopeStack.clear();
+}
+
+void Renderer::setupRingBuffer()
+{
+    auto conf = Configuration::getInstance();
+#if CC_RENDERER_USE_MAP_BUFFER_RANGE
+    _useRingBuffer = conf->useRendererRingBuffer() && conf->supportsMapBufferRange();
+#else
+    _useRingBuffer = false;
+#endif
+
+    // the GL context might have been recreated: old fences are gone with it
+    for (int i = 0; i < RING_BUFFER_SEGMENTS; ++i)
+        _ringFences[i] = nullptr;
+    _ringSegment = 0;
+    _ringFilledVertex = 0;
+    _ringFilledIndex = 0;
+
+    if (!_useRingBuffer)
+        return;
+
+    // Unlike the default path (see Issue #15652) the storage is allocated once without data,
+    // so the driver has nothing to copy. It is never reallocated afterwards.
+    GL::bindVAO(0);
+    glBindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
+    glBufferData(GL_ARRAY_BUFFER, sizeof(_verts[0]) * VBO_SIZE * RING_BUFFER_SEGMENTS, nullptr, GL_STREAM_DRAW);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffersVBO[1]);
+    glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(_indices[0]) * INDEX_VBO_SIZE * RING_BUFFER_SEGMENTS, nullptr, GL_STREAM_DRAW);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+
+    CHECK_GL_ERROR_DEBUG();
+}
+
+GLintptr Renderer::uploadToRingBuffer()
+{
+#if CC_RENDERER_USE_MAP_BUFFER_RANGE
+    GLbitfield invalidate = GL_MAP_INVALIDATE_RANGE_BIT;
+
+    // not enough room left in the current segment: move on to the next one
+    if (_ringFilledVertex + _filledVertex > VBO_SIZE || _ringFilledIndex + _filledIndex > INDEX_VBO_SIZE)
+    {
+#if CC_RENDERER_USE_SYNC_OBJECTS
+        const bool useFences = Configuration::getInstance()->supportsSyncObjects();
+        if (useFences)
+            _ringFences[_ringSegment] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+#else
+        const bool useFences = false;
+#endif
+        _ringSegment = (_ringSegment + 1) % RING_BUFFER_SEGMENTS;
+        _ringFilledVertex = 0;
+        _ringFilledIndex = 0;
+
+#if CC_RENDERER_USE_SYNC_OBJECTS
+        if (_ringFences[_ringSegment])
+        {
+            // Only blocks when the GPU is more than RING_BUFFER_SEGMENTS - 1 segments behind
+            GLsync fence = (GLsync)_ringFences[_ringSegment];
+            while (glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, 1000000) == GL_TIMEOUT_EXPIRED) {}
+            glDeleteSync(fence);
+            _ringFences[_ringSegment] = nullptr;
+        }
+#endif
+        // Without fences the GPU might still read the segments: orphan the whole buffer
+        // every time the ring wraps around
+        if (!useFences && _ringSegment == 0)
+            invalidate = GL_MAP_INVALIDATE_BUFFER_BIT;
+    }
+
+    const GLbitfield access = GL_MAP_WRITE_BIT | GL_MAP_UNSYNCHRONIZED_BIT | invalidate;
+    const GLintptr vertexOffset = sizeof(_verts[0]) * (_ringSegment * VBO_SIZE + _ringFilledVertex);
+    const GLintptr indexOffset = sizeof(_indices[0]) * (_ringSegment * INDEX_VBO_SIZE + _ringFilledIndex);
+
+    glBindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
+    void* buf = glMapBufferRange(GL_ARRAY_BUFFER, vertexOffset, sizeof(_verts[0]) * _filledVertex, access);
+    if (buf)
+    {
+        memcpy(buf, _verts, sizeof(_verts[0]) * _filledVertex);
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+    }
+    else
+    {
+        glBufferSubData(GL_ARRAY_BUFFER, vertexOffset, sizeof(_verts[0]) * _filledVertex, _verts);
+    }
+
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, _buffersVBO[1]);
+    buf = glMapBufferRange(GL_ELEMENT_ARRAY_BUFFER, indexOffset, sizeof(_indices[0]) * _filledIndex, access);
+    if (buf)
+    {
+        memcpy(buf, _indices, sizeof(_indices[0]) * _filledIndex);
+        glUnmapBuffer(GL_ELEMENT_ARRAY_BUFFER);
+    }
+    else
+    {
+        glBufferSubData(GL_ELEMENT_ARRAY_BUFFER, indexOffset, sizeof(_indices[0]) * _filledIndex, _indices);
+    }
+
+    _ringFilledVertex += _filledVertex;
+    _ringFilledIndex += _filledIndex;
+
+    // The indices are relative to the first vertex of this flush, so point the attributes there
+    GL::enableVertexAttribs(GL::VERTEX_ATTRIB_FLAG_POS_COLOR_TEX);
+    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 3, GL_FLOAT, GL_FALSE, sizeof(_verts[0]), (GLvoid*) (vertexOffset + offsetof(V3F_C4B_T2F, vertices)));
+    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_COLOR, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(_verts[0]), (GLvoid*) (vertexOffset + offsetof(V3F_C4B_T2F, colors)));
+    glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORD, 2, GL_FLOAT, GL_FALSE, sizeof(_verts[0]), (GLvoid*) (vertexOffset + offsetof(V3F_C4B_T2F, texCoords)));
+
+    return indexOffset;
+#else
+    return 0;
+#endif
 }
 
 void Renderer::setupVBOAndVAO()
@@ -347,6 +839,17 @@ void Renderer::mapBuffers()
 
 void Renderer::addCommand(RenderCommand* command)
 {
+    if (_isRecordingVisits)
+    {
+        auto recording = getCurrentRecording();
+        if (recording)
+        {
+            int renderQueue = recording->groupStack.empty() ? -1 : recording->groupStack.top();
+            recording->commands.push_back({command, renderQueue});
+            return;
+        }
+    }
+
     int renderQueue =_commandGroupStack.top();
     addCommand(command, renderQueue);
 }
@@ -357,24 +860,153 @@ void Renderer::addCommand(RenderCommand* command, int renderQueue)
     CCASSERT(renderQueue >=0, "Invalid render queue");
     CCASSERT(command->getType() != RenderCommand::Type::UNKNOWN_COMMAND, "Invalid Command Type");
 
+    if (_isRecordingVisits)
+    {
+        auto recording = getCurrentRecording();
+        if (recording)
+        {
+            recording->commands.push_back({command, renderQueue});
+            return;
+        }
+    }
+
     _renderGroups[renderQueue].push_back(command);
+    ++_addedCommands;
+    if ((_batchBreakStatisticsEnabled || _overdrawVisualizationEnabled) && _drawingNode)
+        _commandNodes[command] = _drawingNode;
 }
 
 void Renderer::pushGroup(int renderQueueID)
 {
     CCASSERT(!_isRendering, "Cannot change render queue while rendering");
+    if (_isRecordingVisits)
+    {
+        auto recording = getCurrentRecording();
+        if (recording)
+        {
+            recording->groupStack.push(renderQueueID);
+            return;
+        }
+    }
     _commandGroupStack.push(renderQueueID);
 }
 
 void Renderer::popGroup()
 {
     CCASSERT(!_isRendering, "Cannot change render queue while rendering");
+    if (_isRecordingVisits)
+    {
+        auto recording = getCurrentRecording();
+        if (recording)
+        {
+            CCASSERT(!recording->groupStack.empty(), "popGroup() without pushGroup() in a parallel visit");
+            recording->groupStack.pop();
+            return;
+        }
+    }
     _commandGroupStack.pop();
 }
 
+void Renderer::setParallelVisitEnabled(bool enabled)
+{
+    CCASSERT(!_isRecordingVisits, "Cannot change the parallel visit mode while visiting");
+    _parallelVisitEnabled = enabled;
+
+    if (enabled && !_visitWorkerPool)
+    {
+        unsigned int workers = std::thread::hardware_concurrency();
+        _visitWorkerPool = new (std::nothrow) VisitWorkerPool(workers > 1 ? workers - 1 : 1);
+        if (!_visitWorkerPool)
+        {
+            // the scene is visited serially
+            CCLOG("cocos2d: the visit workers couldn't be created, parallel visit is disabled");
+            _parallelVisitEnabled = false;
+        }
+    }
+}
+
+Renderer::VisitRecording* Renderer::getCurrentRecording() const
+{
+    return static_cast<VisitRecording*>(_visitWorkerPool->getContext());
+}
+
+bool Renderer::isRecordingVisit() const
+{
+    return _isRecordingVisits && getCurrentRecording() != nullptr;
+}
+
+int Renderer::recordParallelVisits(const Vector<Node*>& children, const Mat4& parentTransform, uint32_t parentFlags)
+{
+    // nested parallel roots are visited by the thread that records their ancestor,
+    // and the command statistics count the nodes visited by this thread
+    if (!_parallelVisitEnabled || !_visitWorkerPool || _isRecordingVisits || isDrawStatisticsEnabled())
+        return 0;
+
+    _visitJobs.clear();
+    for (const auto& child : children)
+    {
+        if (!child->isParallelVisitRoot() || !child->isVisible())
+            continue;
+
+        VisitRecording* recording = nullptr;
+        if (_freeVisitRecordings.empty())
+        {
+            recording = new (std::nothrow) VisitRecording();
+            // a child without a recording is visited serially
+            if (!recording)
+                continue;
+            _visitRecordings.push_back(recording);
+        }
+        else
+        {
+            recording = _freeVisitRecordings.back();
+            _freeVisitRecordings.pop_back();
+        }
+        _recordedVisits[child] = recording;
+
+        auto pool = _visitWorkerPool;
+        _visitJobs.push_back([=, &parentTransform]() {
+            pool->setContext(recording);
+            child->visit(this, parentTransform, parentFlags);
+            pool->setContext(nullptr);
+        });
+    }
+
+    if (_visitJobs.empty())
+        return 0;
+
+    _isRecordingVisits = true;
+    _visitWorkerPool->run(_visitJobs);
+    _isRecordingVisits = false;
+
+    return (int)_visitJobs.size();
+}
+
+bool Renderer::replayParallelVisit(Node* node)
+{
+    auto iter = _recordedVisits.find(node);
+    if (iter == _recordedVisits.end())
+        return false;
+
+    auto recording = iter->second;
+    for (const auto& entry : recording->commands)
+    {
+        if (entry.renderQueueID < 0)
+            addCommand(entry.command);
+        else
+            addCommand(entry.command, entry.renderQueueID);
+    }
+
+    recording->commands.clear();
+    _freeVisitRecordings.push_back(recording);
+    _recordedVisits.erase(iter);
+    return true;
+}
+
 int Renderer::createRenderQueue()
 {
     RenderQueue newRenderQueue;
+    newRenderQueue.setOpaqueSortMode(_opaqueSortMode);
     _renderGroups.push_back(newRenderQueue);
     return (int)_renderGroups.size() - 1;
 }
@@ -394,6 +1026,7 @@ void Renderer::processRenderCommand(RenderCommand* command)
         {
             CCASSERT(cmd->getVertexCount()>= 0 && cmd->getVertexCount() < VBO_SIZE, "VBO for vertex is not big enough, please break the data down or use customized render command");
             CCASSERT(cmd->getIndexCount()>= 0 && cmd->getIndexCount() < INDEX_VBO_SIZE, "VBO for index is not big enough, please break the data down or use customized render command");
+            _flushCause = BatchBreakCause::VBO_FULL;
             drawBatchedTriangles();
         }
         
@@ -404,16 +1037,25 @@ void Renderer::processRenderCommand(RenderCommand* command)
     }
     else if (RenderCommand::Type::MESH_COMMAND == commandType)
     {
+        _flushCause = BatchBreakCause::OTHER_COMMAND;
         flush2D();
         auto cmd = static_cast<MeshCommand*>(command);
-        
-        if (cmd->isSkipBatching() || _lastBatchedMeshCommand == nullptr || _lastBatchedMeshCommand->getMaterialID() != cmd->getMaterialID())
+
+        const bool skipBatching = cmd->isSkipBatching() || !_batchingEnabled;
+        if (cmd->isInstancingEnabled() && !skipBatching)
+        {
+            if (_queuedInstancedMeshCommands.empty() || _queuedInstancedMeshCommands.front()->getInstancingKey() != cmd->getInstancingKey())
+                flush3D();
+
+            _queuedInstancedMeshCommands.push_back(cmd);
+        }
+        else if (skipBatching || _lastBatchedMeshCommand == nullptr || _lastBatchedMeshCommand->getMaterialID() != cmd->getMaterialID())
         {
             flush3D();
 
             CCGL_DEBUG_INSERT_EVENT_MARKER("RENDERER_MESH_COMMAND");
 
-            if(cmd->isSkipBatching())
+            if(skipBatching)
             {
                 // XXX: execute() will call bind() and unbind()
                 // but unbind() shouldn't be call if the next command is a MESH_COMMAND with Material.
@@ -435,14 +1077,23 @@ void Renderer::processRenderCommand(RenderCommand* command)
     }
     else if(RenderCommand::Type::GROUP_COMMAND == commandType)
     {
+        _flushCause = BatchBreakCause::GROUP_COMMAND;
         flush();
         int renderQueueID = ((GroupCommand*) command)->getRenderQueueID();
         CCGL_DEBUG_PUSH_GROUP_MARKER("RENDERER_GROUP_COMMAND");
+        if (_gpuTimingEnabled)
+            beginGPUScope(StringUtils::format("GroupCommand(queue=%d)", renderQueueID));
         visitRenderQueue(_renderGroups[renderQueueID]);
+        // the last triangles of the group end with it
+        if (_hasPendingBatchBreak)
+            _pendingBatchBreakCause = BatchBreakCause::GROUP_COMMAND;
+        if (_gpuTimingEnabled)
+            endGPUScope();
         CCGL_DEBUG_POP_GROUP_MARKER();
     }
     else if(RenderCommand::Type::CUSTOM_COMMAND == commandType)
     {
+        _flushCause = BatchBreakCause::OTHER_COMMAND;
         flush();
         auto cmd = static_cast<CustomCommand*>(command);
         CCGL_DEBUG_INSERT_EVENT_MARKER("RENDERER_CUSTOM_COMMAND");
@@ -450,6 +1101,7 @@ void Renderer::processRenderCommand(RenderCommand* command)
     }
     else if(RenderCommand::Type::BATCH_COMMAND == commandType)
     {
+        _flushCause = BatchBreakCause::OTHER_COMMAND;
         flush();
         auto cmd = static_cast<BatchCommand*>(command);
         CCGL_DEBUG_INSERT_EVENT_MARKER("RENDERER_BATCH_COMMAND");
@@ -457,6 +1109,7 @@ void Renderer::processRenderCommand(RenderCommand* command)
     }
     else if(RenderCommand::Type::PRIMITIVE_COMMAND == commandType)
     {
+        _flushCause = BatchBreakCause::OTHER_COMMAND;
         flush();
         auto cmd = static_cast<PrimitiveCommand*>(command);
         CCGL_DEBUG_INSERT_EVENT_MARKER("RENDERER_PRIMITIVE_COMMAND");
@@ -478,32 +1131,40 @@ void Renderer::visitRenderQueue(RenderQueue& queue)
     const auto& zNegQueue = queue.getSubQueue(RenderQueue::QUEUE_GROUP::GLOBALZ_NEG);
     if (zNegQueue.size() > 0)
     {
+        if (_gpuTimingEnabled)
+            beginGPUScope("GLOBALZ_NEG");
+        if (_overdrawVisualizationEnabled)
+            beginOverdrawPass(queue, "GLOBALZ_NEG");
+
         if(_isDepthTestFor2D)
         {
-            glEnable(GL_DEPTH_TEST);
-            glDepthMask(true);
-            glEnable(GL_BLEND);
+            GL::enable(GL_DEPTH_TEST);
+            GL::depthMask(true);
+            GL::enable(GL_BLEND);
             RenderState::StateBlock::_defaultState->setDepthTest(true);
             RenderState::StateBlock::_defaultState->setDepthWrite(true);
             RenderState::StateBlock::_defaultState->setBlend(true);
         }
         else
         {
-            glDisable(GL_DEPTH_TEST);
-            glDepthMask(false);
-            glEnable(GL_BLEND);
+            GL::disable(GL_DEPTH_TEST);
+            GL::depthMask(false);
+            GL::enable(GL_BLEND);
             RenderState::StateBlock::_defaultState->setDepthTest(false);
             RenderState::StateBlock::_defaultState->setDepthWrite(false);
             RenderState::StateBlock::_defaultState->setBlend(true);
         }
-        glDisable(GL_CULL_FACE);
+        GL::disable(GL_CULL_FACE);
         RenderState::StateBlock::_defaultState->setCullFace(false);
         
         for (const auto& zNegNext : zNegQueue)
         {
             processRenderCommand(zNegNext);
         }
+        _flushCause = BatchBreakCause::QUEUE_GROUP;
         flush();
+        if (_gpuTimingEnabled)
+            endGPUScope();
     }
     
     //
@@ -512,22 +1173,53 @@ void Renderer::visitRenderQueue(RenderQueue& queue)
     const auto& opaqueQueue = queue.getSubQueue(RenderQueue::QUEUE_GROUP::OPAQUE_3D);
     if (opaqueQueue.size() > 0)
     {
+        if (_gpuTimingEnabled)
+            beginGPUScope("OPAQUE_3D");
+        if (_overdrawVisualizationEnabled)
+            beginOverdrawPass(queue, "OPAQUE_3D");
+
         //Clear depth to achieve layered rendering
-        glEnable(GL_DEPTH_TEST);
-        glDepthMask(true);
-        glDisable(GL_BLEND);
-        glEnable(GL_CULL_FACE);
+        GL::enable(GL_DEPTH_TEST);
+        GL::depthMask(true);
+        GL::disable(GL_BLEND);
+        GL::enable(GL_CULL_FACE);
         RenderState::StateBlock::_defaultState->setDepthTest(true);
         RenderState::StateBlock::_defaultState->setDepthWrite(true);
         RenderState::StateBlock::_defaultState->setBlend(false);
         RenderState::StateBlock::_defaultState->setCullFace(true);
 
+        if (_depthPrePassEnabled)
+        {
+            // only the meshes write their depth, the offset keeps it a little behind them so the
+            // shading pass passes the default GL_LESS test where they are visible
+            GL::colorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+            GL::enable(GL_POLYGON_OFFSET_FILL);
+            glPolygonOffset(1.0f, 1.0f);
+            for (const auto& opaqueNext : opaqueQueue)
+            {
+                if (opaqueNext->getType() == RenderCommand::Type::MESH_COMMAND)
+                    processRenderCommand(opaqueNext);
+            }
+            _flushCause = BatchBreakCause::QUEUE_GROUP;
+            flush();
+            glPolygonOffset(0.0f, 0.0f);
+            GL::disable(GL_POLYGON_OFFSET_FILL);
+            GL::colorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+        }
+
         for (const auto& opaqueNext : opaqueQueue)
         {
             processRenderCommand(opaqueNext);
         }
+        _flushCause = BatchBreakCause::QUEUE_GROUP;
         flush();
+        if (_gpuTimingEnabled)
+            endGPUScope();
     }
+
+    // the bounding boxes of the occlusion culling are tested against the opaque objects
+    if (_occlusionCullingEnabled && &queue == &_renderGroups[DEFAULT_RENDER_QUEUE])
+        processOcclusionQueries();
     
     //
     //Process 3D Transparent object
@@ -535,10 +1227,15 @@ void Renderer::visitRenderQueue(RenderQueue& queue)
     const auto& transQueue = queue.getSubQueue(RenderQueue::QUEUE_GROUP::TRANSPARENT_3D);
     if (transQueue.size() > 0)
     {
-        glEnable(GL_DEPTH_TEST);
-        glDepthMask(false);
-        glEnable(GL_BLEND);
-        glEnable(GL_CULL_FACE);
+        if (_gpuTimingEnabled)
+            beginGPUScope("TRANSPARENT_3D");
+        if (_overdrawVisualizationEnabled)
+            beginOverdrawPass(queue, "TRANSPARENT_3D");
+
+        GL::enable(GL_DEPTH_TEST);
+        GL::depthMask(false);
+        GL::enable(GL_BLEND);
+        GL::enable(GL_CULL_FACE);
 
         RenderState::StateBlock::_defaultState->setDepthTest(true);
         RenderState::StateBlock::_defaultState->setDepthWrite(false);
@@ -550,7 +1247,10 @@ void Renderer::visitRenderQueue(RenderQueue& queue)
         {
             processRenderCommand(transNext);
         }
+        _flushCause = BatchBreakCause::QUEUE_GROUP;
         flush();
+        if (_gpuTimingEnabled)
+            endGPUScope();
     }
     
     //
@@ -559,11 +1259,16 @@ void Renderer::visitRenderQueue(RenderQueue& queue)
     const auto& zZeroQueue = queue.getSubQueue(RenderQueue::QUEUE_GROUP::GLOBALZ_ZERO);
     if (zZeroQueue.size() > 0)
     {
+        if (_gpuTimingEnabled)
+            beginGPUScope("GLOBALZ_ZERO");
+        if (_overdrawVisualizationEnabled)
+            beginOverdrawPass(queue, "GLOBALZ_ZERO");
+
         if(_isDepthTestFor2D)
         {
-            glEnable(GL_DEPTH_TEST);
-            glDepthMask(true);
-            glEnable(GL_BLEND);
+            GL::enable(GL_DEPTH_TEST);
+            GL::depthMask(true);
+            GL::enable(GL_BLEND);
 
             RenderState::StateBlock::_defaultState->setDepthTest(true);
             RenderState::StateBlock::_defaultState->setDepthWrite(true);
@@ -571,22 +1276,25 @@ void Renderer::visitRenderQueue(RenderQueue& queue)
         }
         else
         {
-            glDisable(GL_DEPTH_TEST);
-            glDepthMask(false);
-            glEnable(GL_BLEND);
+            GL::disable(GL_DEPTH_TEST);
+            GL::depthMask(false);
+            GL::enable(GL_BLEND);
 
             RenderState::StateBlock::_defaultState->setDepthTest(false);
             RenderState::StateBlock::_defaultState->setDepthWrite(false);
             RenderState::StateBlock::_defaultState->setBlend(true);
         }
-        glDisable(GL_CULL_FACE);
+        GL::disable(GL_CULL_FACE);
         RenderState::StateBlock::_defaultState->setCullFace(false);
         
         for (const auto& zZeroNext : zZeroQueue)
         {
             processRenderCommand(zZeroNext);
         }
+        _flushCause = BatchBreakCause::QUEUE_GROUP;
         flush();
+        if (_gpuTimingEnabled)
+            endGPUScope();
     }
     
     //
@@ -595,11 +1303,16 @@ void Renderer::visitRenderQueue(RenderQueue& queue)
     const auto& zPosQueue = queue.getSubQueue(RenderQueue::QUEUE_GROUP::GLOBALZ_POS);
     if (zPosQueue.size() > 0)
     {
+        if (_gpuTimingEnabled)
+            beginGPUScope("GLOBALZ_POS");
+        if (_overdrawVisualizationEnabled)
+            beginOverdrawPass(queue, "GLOBALZ_POS");
+
         if(_isDepthTestFor2D)
         {
-            glEnable(GL_DEPTH_TEST);
-            glDepthMask(true);
-            glEnable(GL_BLEND);
+            GL::enable(GL_DEPTH_TEST);
+            GL::depthMask(true);
+            GL::enable(GL_BLEND);
             
             RenderState::StateBlock::_defaultState->setDepthTest(true);
             RenderState::StateBlock::_defaultState->setDepthWrite(true);
@@ -607,22 +1320,25 @@ void Renderer::visitRenderQueue(RenderQueue& queue)
         }
         else
         {
-            glDisable(GL_DEPTH_TEST);
-            glDepthMask(false);
-            glEnable(GL_BLEND);
+            GL::disable(GL_DEPTH_TEST);
+            GL::depthMask(false);
+            GL::enable(GL_BLEND);
             
             RenderState::StateBlock::_defaultState->setDepthTest(false);
             RenderState::StateBlock::_defaultState->setDepthWrite(false);
             RenderState::StateBlock::_defaultState->setBlend(true);
         }
-        glDisable(GL_CULL_FACE);
+        GL::disable(GL_CULL_FACE);
         RenderState::StateBlock::_defaultState->setCullFace(false);
         
         for (const auto& zPosNext : zPosQueue)
         {
             processRenderCommand(zPosNext);
         }
+        _flushCause = BatchBreakCause::QUEUE_GROUP;
         flush();
+        if (_gpuTimingEnabled)
+            endGPUScope();
     }
     
     queue.restoreRenderState();
@@ -630,6 +1346,8 @@ void Renderer::visitRenderQueue(RenderQueue& queue)
 
 void Renderer::render()
 {
+    CC_PROFILER_ZONE("Renderer::render");
+
     //Uncomment this once everything is rendered by new renderer
     //glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
 
@@ -644,12 +1362,51 @@ void Renderer::render()
         {
             renderqueue.sort();
         }
+
+        if (_commandStatisticsEnabled)
+            collectCommandStatistics();
+
+        // the batches of another camera don't break the ones of this camera
+        _hasPendingBatchBreak = false;
+
+        if (_overdrawVisualizationEnabled)
+        {
+            auto camera = Camera::getVisitingCamera();
+            _overdrawCamera = camera ? StringUtils::format("Camera(flag=%u, depth=%d)", (unsigned int)camera->getCameraFlag(), (int)camera->getDepth()) : "Camera";
+        }
+
+        if (_gpuTimingEnabled)
+        {
+            auto camera = Camera::getVisitingCamera();
+            beginGPUScope(camera ? StringUtils::format("Camera(flag=%u, depth=%d)", (unsigned int)camera->getCameraFlag(), (int)camera->getDepth()) : "Camera");
+        }
         visitRenderQueue(_renderGroups[0]);
+        if (_gpuTimingEnabled)
+            endGPUScope();
     }
     clean();
     _isRendering = false;
 }
 
+void Renderer::renderAndKeepCommands()
+{
+    CC_PROFILER_ZONE("Renderer::renderAndKeepCommands");
+
+    _isRendering = true;
+
+    if (_glViewAssigned)
+    {
+        // the next render() sorts them again, it keeps the order
+        for (auto &renderqueue : _renderGroups)
+        {
+            renderqueue.sort();
+        }
+
+        visitRenderQueue(_renderGroups[0]);
+    }
+    _isRendering = false;
+}
+
 void Renderer::clean()
 {
     // Clear render group
@@ -663,20 +1420,71 @@ void Renderer::clean()
         _renderGroups[j].clear();
     }
 
-    // Clear batch commands
+    // Recordings are replayed during the visit, this only matters if a visit was interrupted
+    for (auto& recorded : _recordedVisits)
+    {
+        recorded.second->commands.clear();
+        _freeVisitRecordings.push_back(recorded.second);
+    }
+    _recordedVisits.clear();
+
+    // Clear batch commands
     _queuedTriangleCommands.clear();
     _filledVertex = 0;
     _filledIndex = 0;
     _lastBatchedMeshCommand = nullptr;
+    _queuedInstancedMeshCommands.clear();
+
+    // the queue doesn't reference the transient commands anymore
+    _transientCustomCommands.resetTransientCommands();
+    _transientTrianglesCommands.resetTransientCommands();
+    _transientQuadCommands.resetTransientCommands();
+    // 0 is never used, so a node can start with it
+    if (++_queueGeneration == 0)
+        _queueGeneration = 1;
+}
+
+CustomCommand* Renderer::generateTransientCustomCommand()
+{
+    if (_isRecordingVisits)
+    {
+        std::lock_guard<std::mutex> lock(_transientCommandsMutex);
+        return _transientCustomCommands.generateTransientCommand();
+    }
+    return _transientCustomCommands.generateTransientCommand();
+}
+
+TrianglesCommand* Renderer::generateTransientTrianglesCommand()
+{
+    if (_isRecordingVisits)
+    {
+        std::lock_guard<std::mutex> lock(_transientCommandsMutex);
+        return _transientTrianglesCommands.generateTransientCommand();
+    }
+    return _transientTrianglesCommands.generateTransientCommand();
+}
+
+QuadCommand* Renderer::generateTransientQuadCommand()
+{
+    if (_isRecordingVisits)
+    {
+        std::lock_guard<std::mutex> lock(_transientCommandsMutex);
+        return _transientQuadCommands.generateTransientCommand();
+    }
+    return _transientQuadCommands.generateTransientCommand();
 }
 
 void Renderer::clear()
 {
     //Enable Depth mask to make sure glClear clear the depth buffer correctly
-    glDepthMask(true);
-    glClearColor(_clearColor.r, _clearColor.g, _clearColor.b, _clearColor.a);
+    GL::depthMask(true);
+    // the overdraw is added to a black screen
+    if (_overdrawVisualizationEnabled)
+        glClearColor(0, 0, 0, 1);
+    else
+        glClearColor(_clearColor.r, _clearColor.g, _clearColor.b, _clearColor.a);
     glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-    glDepthMask(false);
+    GL::depthMask(false);
 
     RenderState::StateBlock::_defaultState->setDepthWrite(false);
 }
@@ -686,8 +1494,8 @@ void Renderer::setDepthTest(bool enable)
     if (enable)
     {
         glClearDepth(1.0f);
-        glEnable(GL_DEPTH_TEST);
-        glDepthFunc(GL_LEQUAL);
+        GL::enable(GL_DEPTH_TEST);
+        GL::depthFunc(GL_LEQUAL);
 
         RenderState::StateBlock::_defaultState->setDepthTest(true);
         RenderState::StateBlock::_defaultState->setDepthFunction(RenderState::DEPTH_LEQUAL);
@@ -696,7 +1504,7 @@ void Renderer::setDepthTest(bool enable)
     }
     else
     {
-        glDisable(GL_DEPTH_TEST);
+        GL::disable(GL_DEPTH_TEST);
 
         RenderState::StateBlock::_defaultState->setDepthTest(false);
     }
@@ -711,10 +1519,7 @@ void Renderer::fillVerticesAndIndices(const TrianglesCommand* cmd)
 
     // fill vertex, and convert them to world coordinates
     const Mat4& modelView = cmd->getModelView();
-    for(ssize_t i=0; i < cmd->getVertexCount(); ++i)
-    {
-        modelView.transformPoint(&(_verts[i + _filledVertex].vertices));
-    }
+    modelView.transformPoints(&_verts[_filledVertex].vertices, cmd->getVertexCount(), sizeof(V3F_C4B_T2F));
 
     // fill index
     const unsigned short* indices = cmd->getIndices();
@@ -727,8 +1532,29 @@ void Renderer::fillVerticesAndIndices(const TrianglesCommand* cmd)
     _filledIndex += cmd->getIndexCount();
 }
 
+bool Renderer::isMultiTextureBatchable(const TrianglesCommand* cmd)
+{
+    if (_multiTextureBaseProgram == nullptr)
+    {
+        auto cache = GLProgramCache::getInstance();
+        _multiTextureBaseProgram = cache->getGLProgram(GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR_NO_MVP);
+        _multiTextureProgram = cache->getGLProgram(GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR_MULTI_TEXTURE_NO_MVP);
+    }
+
+    // custom uniforms or attributes can't be merged, and the ETC1 alpha texture uses another program
+    auto glProgramState = cmd->getGLProgramState();
+    return _multiTextureProgram
+        && glProgramState->getGLProgram() == _multiTextureBaseProgram
+        && glProgramState->getUniformCount() == 0
+        && glProgramState->getVertexAttribsFlags() == 0;
+}
+
 void Renderer::drawBatchedTriangles()
 {
+    // why the triangles are flushed, the batch after them breaks for this reason
+    auto flushCause = _flushCause;
+    _flushCause = BatchBreakCause::COUNT;
+
     if(_queuedTriangleCommands.empty())
         return;
 
@@ -742,41 +1568,108 @@ void Renderer::drawBatchedTriangles()
     _triBatchesToDraw[0].offset = 0;
     _triBatchesToDraw[0].indicesToDraw = 0;
     _triBatchesToDraw[0].cmd = nullptr;
+    _triBatchesToDraw[0].textureCount = 0;
 
     int batchesTotal = 0;
     int prevMaterialID = -1;
     bool firstCommand = true;
+    bool hasMultiTextureBatches = false;
+    const TrianglesCommand* prevCommand = nullptr;
+
+    if (_batchBreakStatisticsEnabled && _hasPendingBatchBreak)
+    {
+        recordBatchBreak(_pendingBatchBreakCause, _pendingBatchBreakCommand, _queuedTriangleCommands.front());
+        _hasPendingBatchBreak = false;
+    }
 
     for(const auto& cmd : _queuedTriangleCommands)
     {
         auto currentMaterialID = cmd->getMaterialID();
-        const bool batchable = !cmd->isSkipBatching();
+        const bool batchable = !cmd->isSkipBatching() && _batchingEnabled;
+        const bool multiTexture = batchable && _multiTextureBatching && !_overdrawVisualizationEnabled && isMultiTextureBatchable(cmd);
+        const int firstVertex = _filledVertex;
+        int textureSlot = 0;
 
         fillVerticesAndIndices(cmd);
+        if (_overdrawVisualizationEnabled)
+            recordOverdraw(cmd, firstVertex);
 
         // in the same batch ?
-        if (batchable && (prevMaterialID == currentMaterialID || firstCommand))
+        bool sameBatch = false;
+        auto& batch = _triBatchesToDraw[batchesTotal];
+        if (batch.textureCount > 0)
         {
-            CC_ASSERT(firstCommand || _triBatchesToDraw[batchesTotal].cmd->getMaterialID() == cmd->getMaterialID() && "argh... error in logic");
-            _triBatchesToDraw[batchesTotal].indicesToDraw += cmd->getIndexCount();
-            _triBatchesToDraw[batchesTotal].cmd = cmd;
+            // multi texture batch: the blend function must match and a texture slot must be available
+            if (multiTexture && batch.cmd->getBlendType() == cmd->getBlendType())
+            {
+                const GLuint textureID = cmd->getTextureID();
+                for (textureSlot = 0; textureSlot < batch.textureCount && batch.textures[textureSlot] != textureID; ++textureSlot);
+                if (textureSlot < batch.textureCount)
+                    sameBatch = true;
+                else if (batch.textureCount < MULTI_TEXTURE_BATCH_SLOTS)
+                {
+                    batch.textures[batch.textureCount++] = textureID;
+                    sameBatch = true;
+                }
+            }
+        }
+        else
+        {
+            sameBatch = batchable && !multiTexture && (prevMaterialID == currentMaterialID || firstCommand);
+        }
+
+        if (sameBatch)
+        {
+            CC_ASSERT(firstCommand || batch.textureCount > 0 || batch.cmd->getMaterialID() == cmd->getMaterialID() && "argh... error in logic");
+            batch.indicesToDraw += cmd->getIndexCount();
+            batch.cmd = cmd;
         }
         else
         {
             // is this the first one?
             if (!firstCommand) {
+                if (_batchBreakStatisticsEnabled)
+                {
+                    BatchBreakCause cause;
+                    if (!batchable || prevCommand->isSkipBatching() || !_batchingEnabled)
+                        cause = BatchBreakCause::SKIP_BATCHING;
+                    else if (prevCommand->getBlendType() != cmd->getBlendType())
+                        cause = BatchBreakCause::BLEND;
+                    else if (multiTexture && batch.textureCount >= MULTI_TEXTURE_BATCH_SLOTS)
+                        cause = BatchBreakCause::TEXTURE_SLOTS;
+                    else if (prevCommand->getGLProgramState() == cmd->getGLProgramState() && prevCommand->getTextureID() != cmd->getTextureID())
+                        cause = BatchBreakCause::TEXTURE;
+                    else
+                        cause = BatchBreakCause::MATERIAL;
+                    recordBatchBreak(cause, prevCommand, cmd);
+                }
                 batchesTotal++;
                 _triBatchesToDraw[batchesTotal].offset = _triBatchesToDraw[batchesTotal-1].offset + _triBatchesToDraw[batchesTotal-1].indicesToDraw;
             }
 
             _triBatchesToDraw[batchesTotal].cmd = cmd;
             _triBatchesToDraw[batchesTotal].indicesToDraw = (int) cmd->getIndexCount();
+            _triBatchesToDraw[batchesTotal].textureCount = 0;
+
+            if (multiTexture)
+            {
+                _triBatchesToDraw[batchesTotal].textures[0] = cmd->getTextureID();
+                _triBatchesToDraw[batchesTotal].textureCount = 1;
+                textureSlot = 0;
+                hasMultiTextureBatches = true;
+            }
 
             // is this a single batch ? Prevent creating a batch group then
             if (!batchable)
                 currentMaterialID = -1;
         }
 
+        if (multiTexture)
+        {
+            for (int i = firstVertex; i < _filledVertex; ++i)
+                _textureSlots[i] = (GLfloat)textureSlot;
+        }
+
         // capacity full ?
         if (batchesTotal + 1 >= _triBatchesToDrawCapacity) {
             _triBatchesToDrawCapacity *= 1.4;
@@ -784,13 +1677,26 @@ void Renderer::drawBatchedTriangles()
         }
 
         prevMaterialID = currentMaterialID;
+        prevCommand = cmd;
         firstCommand = false;
     }
     batchesTotal++;
 
+    // the next batch breaks if these triangles were flushed by another command, a group or a full buffer
+    _hasPendingBatchBreak = _batchBreakStatisticsEnabled && flushCause != BatchBreakCause::COUNT;
+    _pendingBatchBreakCause = flushCause;
+    _pendingBatchBreakCommand = prevCommand;
+
     /************** 2: Copy vertices/indices to GL objects *************/
     auto conf = Configuration::getInstance();
-    if (conf->supportsShareableVAO() && conf->supportsMapBuffer())
+    GLintptr indexOffset = 0;
+    if (_useRingBuffer)
+    {
+        // no VAO: the attribute pointers change with every flush
+        GL::bindVAO(0);
+        indexOffset = uploadToRingBuffer();
+    }
+    else if (conf->supportsShareableVAO() && conf->supportsMapBuffer())
     {
         //Bind VAO
         GL::bindVAO(_buffersVAO);
@@ -840,18 +1746,53 @@ void Renderer::drawBatchedTriangles()
         glBufferData(GL_ELEMENT_ARRAY_BUFFER, sizeof(_indices[0]) * _filledIndex, _indices, GL_STATIC_DRAW);
     }
 
+    if (hasMultiTextureBatches)
+    {
+        // the slots live in their own buffer so the V3F_C4B_T2F layout stays untouched,
+        // the attribute is only enabled while drawing the multi texture batches
+        if (_textureSlotVBO == 0)
+            glGenBuffers(1, &_textureSlotVBO);
+        glBindBuffer(GL_ARRAY_BUFFER, _textureSlotVBO);
+        glBufferData(GL_ARRAY_BUFFER, sizeof(_textureSlots[0]) * _filledVertex, _textureSlots, GL_STREAM_DRAW);
+        glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_TEX_COORD1, 1, GL_FLOAT, GL_FALSE, 0, (GLvoid*)0);
+        glBindBuffer(GL_ARRAY_BUFFER, 0);
+    }
+
     /************** 3: Draw *************/
     for (int i=0; i<batchesTotal; ++i)
     {
-        CC_ASSERT(_triBatchesToDraw[i].cmd && "Invalid batch");
-        _triBatchesToDraw[i].cmd->useMaterial();
-        glDrawElements(GL_TRIANGLES, (GLsizei) _triBatchesToDraw[i].indicesToDraw, GL_UNSIGNED_SHORT, (GLvoid*) (_triBatchesToDraw[i].offset*sizeof(_indices[0])) );
+        const auto& batch = _triBatchesToDraw[i];
+        CC_ASSERT(batch.cmd && "Invalid batch");
+        if (batch.textureCount > 0)
+        {
+            for (int t = batch.textureCount - 1; t >= 0; --t)
+                GL::bindTexture2DN(t, batch.textures[t]);
+            GL::blendFunc(batch.cmd->getBlendType().src, batch.cmd->getBlendType().dst);
+            _multiTextureProgram->use();
+            _multiTextureProgram->setUniformsForBuiltins(batch.cmd->getModelView());
+
+            glEnableVertexAttribArray(GLProgram::VERTEX_ATTRIB_TEX_COORD1);
+            glDrawElements(GL_TRIANGLES, (GLsizei) batch.indicesToDraw, GL_UNSIGNED_SHORT, (GLvoid*) (indexOffset + batch.offset*sizeof(_indices[0])) );
+            glDisableVertexAttribArray(GLProgram::VERTEX_ATTRIB_TEX_COORD1);
+        }
+        else
+        {
+            batch.cmd->useMaterial();
+            if (_overdrawVisualizationEnabled)
+            {
+                // the texture of the command stays bound, its alpha tells the transparent triangles apart
+                GL::blendFunc(GL_ONE, GL_ONE);
+                _overdrawProgram->use();
+                _overdrawProgram->setUniformsForBuiltins(batch.cmd->getModelView());
+            }
+            glDrawElements(GL_TRIANGLES, (GLsizei) batch.indicesToDraw, GL_UNSIGNED_SHORT, (GLvoid*) (indexOffset + batch.offset*sizeof(_indices[0])) );
+        }
         _drawnBatches++;
-        _drawnVertices += _triBatchesToDraw[i].indicesToDraw;
+        _drawnVertices += batch.indicesToDraw;
     }
 
     /************** 4: Cleanup *************/
-    if (conf->supportsShareableVAO() && conf->supportsMapBuffer())
+    if (!_useRingBuffer && conf->supportsShareableVAO() && conf->supportsMapBuffer())
     {
         //Unbind VAO
         GL::bindVAO(0);
@@ -880,6 +1821,8 @@ void Renderer::flush2D()
 
 void Renderer::flush3D()
 {
+    flushInstancedMeshes();
+
     if (_lastBatchedMeshCommand)
     {
         CCGL_DEBUG_INSERT_EVENT_MARKER("RENDERER_BATCH_MESH");
@@ -889,12 +1832,294 @@ void Renderer::flush3D()
     }
 }
 
+void Renderer::flushInstancedMeshes()
+{
+    if (_queuedInstancedMeshCommands.empty())
+        return;
+
+    CCGL_DEBUG_INSERT_EVENT_MARKER("RENDERER_INSTANCED_MESH");
+
+    if (_instanceBufferVBO == 0)
+        glGenBuffers(1, &_instanceBufferVBO);
+
+    MeshCommand::drawInstanced(_queuedInstancedMeshCommands, _instanceBufferVBO);
+    _queuedInstancedMeshCommands.clear();
+
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
 void Renderer::flushTriangles()
 {
     drawBatchedTriangles();
 }
 
 // helpers
+void Renderer::clearDrawStats()
+{
+    _drawnBatches = _drawnVertices = 0;
+
+    if (_commandStatisticsEnabled)
+    {
+        std::sort(_commandStatistics.queues.begin(), _commandStatistics.queues.end(), [](const CommandStatistics::Queue& a, const CommandStatistics::Queue& b) {
+            return a.total > b.total;
+        });
+        std::stable_sort(_commandStatistics.nodes.begin(), _commandStatistics.nodes.end(), [](const CommandStatistics::NodeCommands& a, const CommandStatistics::NodeCommands& b) {
+            return a.commands > b.commands;
+        });
+        _lastCommandStatistics = std::move(_commandStatistics);
+        _commandStatistics = CommandStatistics();
+        _commandStatistics.frame = Director::getInstance()->getTotalFrames();
+        _commandStatisticsNodes.clear();
+    }
+
+    if (_batchBreakStatisticsEnabled)
+    {
+        _lastBatchBreakStatistics = std::move(_batchBreakStatistics);
+        resetBatchBreakStatistics();
+    }
+
+    if (_overdrawVisualizationEnabled)
+    {
+        auto& nodes = _overdrawStatistics.transparentNodes;
+        for (auto& entry : _overdrawNodes)
+        {
+            float alpha = entry.second.alpha / 255.0f;
+            if (entry.second.coverage >= _overdrawCoverageThreshold && alpha <= _overdrawAlphaThreshold)
+            {
+                OverdrawStatistics::TransparentNode node = {std::move(entry.second.name), std::move(entry.second.type), entry.second.coverage, alpha};
+                nodes.push_back(std::move(node));
+            }
+        }
+        std::sort(nodes.begin(), nodes.end(), [](const OverdrawStatistics::TransparentNode& a, const OverdrawStatistics::TransparentNode& b) {
+            return a.coverage > b.coverage;
+        });
+        _lastOverdrawStatistics = std::move(_overdrawStatistics);
+        resetOverdrawStatistics();
+    }
+
+    // the nodes of the commands of the frame, the next visit adds its own
+    _commandNodes.clear();
+}
+
+void Renderer::setCommandStatisticsEnabled(bool enabled)
+{
+    _commandStatisticsEnabled = enabled;
+    _commandStatistics = CommandStatistics();
+    _commandStatistics.frame = Director::getInstance()->getTotalFrames();
+    _commandStatisticsNodes.clear();
+    if (!enabled)
+    {
+        _lastCommandStatistics = CommandStatistics();
+        _lastCommandStatistics.frame = 0;
+    }
+}
+
+void Renderer::setBatchBreakStatisticsEnabled(bool enabled)
+{
+    _batchBreakStatisticsEnabled = enabled;
+    _hasPendingBatchBreak = false;
+    resetBatchBreakStatistics();
+    if (!enabled)
+    {
+        _lastBatchBreakStatistics = _batchBreakStatistics;
+        _lastBatchBreakStatistics.frame = 0;
+    }
+}
+
+void Renderer::resetBatchBreakStatistics()
+{
+    _batchBreakStatistics.frame = Director::getInstance()->getTotalFrames();
+    for (auto& count : _batchBreakStatistics.causes)
+        count = 0;
+    _batchBreakStatistics.breaks.clear();
+    _commandNodes.clear();
+}
+
+void Renderer::recordBatchBreak(BatchBreakCause cause, const RenderCommand* previous, const RenderCommand* command)
+{
+    ++_batchBreakStatistics.causes[(int)cause];
+    if (_batchBreakStatistics.breaks.size() >= MAX_BATCH_BREAKS)
+        return;
+
+    BatchBreakStatistics::Break entry;
+    entry.cause = cause;
+    auto iter = _commandNodes.find(command);
+    if (iter != _commandNodes.end())
+    {
+        entry.node = iter->second->getName();
+        entry.nodeType = typeid(*iter->second).name();
+    }
+    iter = previous ? _commandNodes.find(previous) : _commandNodes.end();
+    if (iter != _commandNodes.end())
+    {
+        entry.previousNode = iter->second->getName();
+        entry.previousNodeType = typeid(*iter->second).name();
+    }
+    _batchBreakStatistics.breaks.push_back(std::move(entry));
+}
+
+const char* Renderer::getBatchBreakCauseName(BatchBreakCause cause)
+{
+    static const char* names[(int)BatchBreakCause::COUNT] = {
+        "material", "texture", "blend", "skipBatching", "textureSlots", "otherCommand", "groupCommand", "queueGroup", "vboFull"
+    };
+    return cause < BatchBreakCause::COUNT ? names[(int)cause] : "none";
+}
+
+void Renderer::setOverdrawVisualizationEnabled(bool enabled)
+{
+    if (enabled && _overdrawProgram == nullptr)
+        _overdrawProgram = GLProgramCache::getInstance()->getGLProgram(GLProgram::SHADER_NAME_OVERDRAW_NO_MVP);
+
+    _overdrawVisualizationEnabled = enabled && _overdrawProgram;
+    resetOverdrawStatistics();
+    if (!enabled)
+    {
+        _lastOverdrawStatistics = _overdrawStatistics;
+        _lastOverdrawStatistics.frame = 0;
+    }
+}
+
+void Renderer::setOverdrawNodeThresholds(float coverage, float alpha)
+{
+    _overdrawCoverageThreshold = coverage;
+    _overdrawAlphaThreshold = alpha;
+}
+
+void Renderer::resetOverdrawStatistics()
+{
+    auto director = Director::getInstance();
+    auto size = director->getWinSizeInPixels();
+    _overdrawStatistics.frame = director->getTotalFrames();
+    _overdrawStatistics.screenPixels = (double)size.width * size.height;
+    _overdrawStatistics.passes.clear();
+    _overdrawStatistics.transparentNodes.clear();
+    _overdrawNodes.clear();
+}
+
+void Renderer::beginOverdrawPass(const RenderQueue& queue, const char* group)
+{
+    // the render queues of the GroupCommands are part of the pass drawing them
+    if (&queue != &_renderGroups[DEFAULT_RENDER_QUEUE])
+        return;
+
+    OverdrawStatistics::Pass pass = {_overdrawCamera, group, 0, 0};
+    _overdrawStatistics.passes.push_back(std::move(pass));
+}
+
+void Renderer::recordOverdraw(const TrianglesCommand* cmd, int firstVertex)
+{
+    // the vertices are in world coordinates, the shader only multiplies them by the projection
+    const Mat4& projection = Director::getInstance()->getMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_PROJECTION);
+    const unsigned short* indices = cmd->getIndices();
+    const ssize_t indexCount = cmd->getIndexCount();
+
+    // the area in normalized device coordinates, the screen is 2 by 2; the clipping is approximated
+    // by clamping the projected vertices to the screen
+    float area = 0;
+    for (ssize_t i = 0; i + 2 < indexCount; i += 3)
+    {
+        Vec2 points[3];
+        bool inFront = true;
+        for (int v = 0; v < 3 && inFront; ++v)
+        {
+            const Vec3& position = _verts[firstVertex + indices[i + v]].vertices;
+            Vec4 clip;
+            projection.transformVector(Vec4(position.x, position.y, position.z, 1), &clip);
+            inFront = clip.w > 0;
+            if (inFront)
+                points[v].set(clampf(clip.x / clip.w, -1, 1), clampf(clip.y / clip.w, -1, 1));
+        }
+        if (inFront)
+            area += fabsf((points[1].x - points[0].x) * (points[2].y - points[0].y) - (points[2].x - points[0].x) * (points[1].y - points[0].y)) * 0.5f;
+    }
+    const float coverage = area / 4;
+
+    if (_overdrawStatistics.passes.empty())
+    {
+        OverdrawStatistics::Pass pass = {_overdrawCamera, "", 0, 0};
+        _overdrawStatistics.passes.push_back(std::move(pass));
+    }
+    auto& pass = _overdrawStatistics.passes.back();
+    const double pixels = coverage * _overdrawStatistics.screenPixels;
+    pass.pixels += pixels;
+    if (cmd->getBlendType() != BlendFunc::DISABLE)
+        pass.transparentPixels += pixels;
+
+    auto iter = _commandNodes.find(cmd);
+    if (iter == _commandNodes.end())
+        return;
+
+    GLubyte alpha = 0;
+    for (int i = firstVertex; i < _filledVertex; ++i)
+        alpha = std::max(alpha, _verts[i].colors.a);
+
+    // the names are read now, the node may be gone by the end of the frame
+    auto inserted = _overdrawNodes.emplace(iter->second, OverdrawNode());
+    auto& node = inserted.first->second;
+    if (inserted.second)
+    {
+        node.name = iter->second->getName();
+        node.type = typeid(*iter->second).name();
+        node.coverage = 0;
+        node.alpha = 0;
+    }
+    node.coverage += coverage;
+    node.alpha = std::max(node.alpha, alpha);
+}
+
+void Renderer::collectCommandStatistics()
+{
+    // render() runs once per camera, the queues of the cameras of a frame are summed
+    for (size_t i = 0, size = _renderGroups.size(); i < size; ++i)
+    {
+        auto& renderQueue = _renderGroups[i];
+        if (renderQueue.size() == 0)
+            continue;
+
+        auto queue = std::find_if(_commandStatistics.queues.begin(), _commandStatistics.queues.end(), [i](const CommandStatistics::Queue& q) {
+            return q.id == (int)i;
+        });
+        if (queue == _commandStatistics.queues.end())
+        {
+            CommandStatistics::Queue entry = {(int)i, 0, {0}};
+            queue = _commandStatistics.queues.insert(_commandStatistics.queues.end(), entry);
+        }
+
+        for (int group = 0; group < RenderQueue::QUEUE_COUNT; ++group)
+        {
+            const auto& commands = renderQueue.getSubQueue((RenderQueue::QUEUE_GROUP)group);
+            queue->groups[group] += commands.size();
+            queue->total += commands.size();
+            for (const auto& command : commands)
+                ++_commandStatistics.commandTypes[(int)command->getType()];
+        }
+    }
+}
+
+void Renderer::drawWithStatistics(Node* node, const Mat4& transform, uint32_t flags)
+{
+    auto addedCommands = _addedCommands;
+    auto drawingNode = _drawingNode;
+    _drawingNode = node;
+    node->draw(this, transform, flags);
+    _drawingNode = drawingNode;
+    addedCommands = _addedCommands - addedCommands;
+    if (addedCommands == 0 || !_commandStatisticsEnabled)
+        return;
+
+    auto iter = _commandStatisticsNodes.find(node);
+    if (iter != _commandStatisticsNodes.end())
+    {
+        _commandStatistics.nodes[iter->second].commands += addedCommands;
+        return;
+    }
+
+    CommandStatistics::NodeCommands entry = {node->getName(), typeid(*node).name(), addedCommands};
+    _commandStatisticsNodes.emplace(node, _commandStatistics.nodes.size());
+    _commandStatistics.nodes.push_back(std::move(entry));
+}
+
 bool Renderer::checkVisibility(const Mat4 &transform, const Size &size)
 {
     auto director = Director::getInstance();
@@ -902,7 +2127,7 @@ bool Renderer::checkVisibility(const Mat4 &transform, const Size &size)
     
     //If draw to Rendertexture, return true directly.
     // only cull the default camera. The culling algorithm is valid for default camera.
-    if (!scene || (scene && scene->_defaultCamera != Camera::getVisitingCamera()))
+    if (!_cullingEnabled || !scene || (scene && scene->_defaultCamera != Camera::getVisitingCamera()))
         return true;
 
     Rect visibleRect(director->getVisibleOrigin(), director->getVisibleSize());
@@ -928,6 +2153,371 @@ bool Renderer::checkVisibility(const Mat4 &transform, const Size &size)
 }
 
 
+void Renderer::setGPUTimingEnabled(bool enabled)
+{
+#if CC_RENDERER_USE_TIMER_QUERY
+    if (enabled && !Configuration::getInstance()->supportsTimerQuery())
+    {
+        CCLOG("cocos2d: GPU timing is not supported, GL_EXT_disjoint_timer_query or GL_ARB_timer_query is missing");
+        enabled = false;
+    }
+#else
+    enabled = false;
+#endif
+
+    if (_gpuTimingEnabled == enabled)
+        return;
+
+#if CC_RENDERER_USE_TIMER_QUERY
+    if (!enabled)
+    {
+        for (const auto& frame : _gpuTimingFrames)
+            releaseGPUTimingFrame(frame.queries);
+        _gpuTimingFrames.clear();
+        if (!_freeTimerQueries.empty())
+            glDeleteQueries((GLsizei)_freeTimerQueries.size(), &_freeTimerQueries[0]);
+        _freeTimerQueries.clear();
+        _gpuScopeStack.clear();
+        _gpuTimings.clear();
+        _gpuFrameTime = 0;
+    }
+#endif
+    _gpuTimingEnabled = enabled;
+}
+
+void Renderer::beginGPUTimingFrame()
+{
+    if (!_gpuTimingEnabled)
+        return;
+
+    resolveGPUTimingFrames();
+
+    // results that the driver didn't deliver in time are discarded
+    while (_gpuTimingFrames.size() >= GPU_TIMING_PENDING_FRAMES)
+    {
+        releaseGPUTimingFrame(_gpuTimingFrames.front().queries);
+        _gpuTimingFrames.pop_front();
+    }
+    _gpuTimingFrames.push_back(GPUTimingFrame());
+    _gpuScopeStack.clear();
+}
+
+void Renderer::beginGPUScope(const std::string& name)
+{
+    if (_gpuTimingFrames.empty())
+        return;
+
+    auto& frame = _gpuTimingFrames.back();
+    GPUScope scope;
+    scope.name = name;
+    scope.depth = (int)_gpuScopeStack.size();
+    scope.beginQuery = issueTimestampQuery();
+    scope.endQuery = 0;
+
+    _gpuScopeStack.push_back(frame.scopes.size());
+    frame.scopes.push_back(scope);
+}
+
+void Renderer::endGPUScope()
+{
+    if (_gpuTimingFrames.empty() || _gpuScopeStack.empty())
+        return;
+
+    auto& frame = _gpuTimingFrames.back();
+    frame.scopes[_gpuScopeStack.back()].endQuery = issueTimestampQuery();
+    _gpuScopeStack.pop_back();
+}
+
+GLuint Renderer::issueTimestampQuery()
+{
+    GLuint query = 0;
+#if CC_RENDERER_USE_TIMER_QUERY
+    if (_freeTimerQueries.empty())
+    {
+        glGenQueries(1, &query);
+    }
+    else
+    {
+        query = _freeTimerQueries.back();
+        _freeTimerQueries.pop_back();
+    }
+    glQueryCounter(query, GL_TIMESTAMP);
+    _gpuTimingFrames.back().queries.push_back(query);
+    CHECK_GL_ERROR_DEBUG();
+#endif
+    return query;
+}
+
+void Renderer::resolveGPUTimingFrames()
+{
+#if CC_RENDERER_USE_TIMER_QUERY
+    while (!_gpuTimingFrames.empty())
+    {
+        auto& frame = _gpuTimingFrames.front();
+        if (!frame.queries.empty())
+        {
+            // the queries finish in order, the last one tells if the whole frame is available
+            GLint available = 0;
+            glGetQueryObjectiv(frame.queries.back(), GL_QUERY_RESULT_AVAILABLE, &available);
+            if (!available)
+                break;
+
+            bool disjoint = false;
+#ifdef GL_GPU_DISJOINT_EXT
+            // the counters are meaningless if the GPU changed its clock or was preempted
+            GLint disjointOccurred = 0;
+            glGetIntegerv(GL_GPU_DISJOINT_EXT, &disjointOccurred);
+            disjoint = disjointOccurred != 0;
+#endif
+            if (!disjoint)
+            {
+                _gpuTimings.clear();
+                _gpuFrameTime = 0;
+                for (const auto& scope : frame.scopes)
+                {
+                    if (scope.endQuery == 0)
+                        continue;
+
+                    GLuint64 begin = 0, end = 0;
+                    glGetQueryObjectui64v(scope.beginQuery, GL_QUERY_RESULT, &begin);
+                    glGetQueryObjectui64v(scope.endQuery, GL_QUERY_RESULT, &end);
+
+                    GPUTiming timing;
+                    timing.name = scope.name;
+                    timing.depth = scope.depth;
+                    timing.milliseconds = end > begin ? (end - begin) / 1000000.0 : 0.0;
+                    if (scope.depth == 0)
+                        _gpuFrameTime += timing.milliseconds;
+                    _gpuTimings.push_back(timing);
+                }
+            }
+        }
+        releaseGPUTimingFrame(frame.queries);
+        _gpuTimingFrames.pop_front();
+    }
+#endif
+}
+
+void Renderer::releaseGPUTimingFrame(const std::vector<GLuint>& queries)
+{
+    _freeTimerQueries.insert(_freeTimerQueries.end(), queries.begin(), queries.end());
+}
+
+void Renderer::setOpaqueSortMode(RenderQueue::OpaqueSortMode mode)
+{
+    _opaqueSortMode = mode;
+    for (auto& renderQueue : _renderGroups)
+    {
+        renderQueue.setOpaqueSortMode(mode);
+    }
+}
+
+void Renderer::setOcclusionCullingEnabled(bool enabled)
+{
+#if CC_RENDERER_USE_OCCLUSION_QUERY
+    if (enabled && !Configuration::getInstance()->supportsOcclusionQuery())
+    {
+        CCLOG("cocos2d: occlusion culling is not supported, GL_EXT_occlusion_query_boolean or GL_ARB_occlusion_query is missing");
+        enabled = false;
+    }
+#else
+    enabled = false;
+#endif
+
+    if (_occlusionCullingEnabled == enabled)
+        return;
+
+    if (!enabled)
+        releaseOcclusionQueries();
+    _occlusionCullingEnabled = enabled;
+}
+
+bool Renderer::isOccluded(const void* object, const AABB& aabb)
+{
+    auto camera = Camera::getVisitingCamera();
+    if (!_occlusionCullingEnabled || !camera || aabb.isEmpty())
+        return false;
+
+    // the front faces of the box are clipped when the camera is inside it or close to it
+    const Mat4& cameraTransform = camera->getNodeToWorldTransform();
+    Vec3 eye(cameraTransform.m[12], cameraTransform.m[13], cameraTransform.m[14]);
+    float margin = camera->getNearPlane() * 2.0f;
+    bool eyeInside = eye.x > aabb._min.x - margin && eye.x < aabb._max.x + margin
+        && eye.y > aabb._min.y - margin && eye.y < aabb._max.y + margin
+        && eye.z > aabb._min.z - margin && eye.z < aabb._max.z + margin;
+
+    std::lock_guard<std::mutex> lock(_occlusionMutex);
+    auto it = _occlusionStates.find(std::make_pair(object, (const void*)camera));
+    if (it == _occlusionStates.end())
+    {
+        OcclusionState state;
+        state.query = 0;
+        state.visible = true;
+        it = _occlusionStates.insert(std::make_pair(std::make_pair(object, (const void*)camera), state)).first;
+    }
+
+    auto& state = it->second;
+    state.requestFrame = Director::getInstance()->getTotalFrames();
+    state.requested = !eyeInside;
+    state.min = aabb._min;
+    state.max = aabb._max;
+    if (eyeInside)
+        state.visible = true;
+
+    if (!state.visible)
+        ++_occludedCount;
+    return !state.visible;
+}
+
+void Renderer::processOcclusionQueries()
+{
+#if CC_RENDERER_USE_OCCLUSION_QUERY
+    std::lock_guard<std::mutex> lock(_occlusionMutex);
+    unsigned int frame = Director::getInstance()->getTotalFrames();
+    _lastOccludedCount = _occludedCount;
+    _occludedCount = 0;
+
+    // collect the results without waiting, objects keep their previous state until they arrive
+    std::vector<OcclusionState*> tests;
+    for (auto it = _occlusionStates.begin(); it != _occlusionStates.end();)
+    {
+        auto& state = it->second;
+        if (state.query)
+        {
+            GLuint available = 0;
+            glGetQueryObjectuiv(state.query, GL_QUERY_RESULT_AVAILABLE, &available);
+            if (available)
+            {
+                GLuint samples = 0;
+                glGetQueryObjectuiv(state.query, GL_QUERY_RESULT, &samples);
+                state.visible = samples > 0;
+                _freeOcclusionQueries.push_back(state.query);
+                state.query = 0;
+            }
+        }
+
+        if (!state.query && frame - state.requestFrame > (unsigned int)OCCLUSION_STALE_FRAMES)
+        {
+            it = _occlusionStates.erase(it);
+            continue;
+        }
+
+        // hidden objects are tested as soon as possible, the visible ones now and then, spread over the frames
+        if (state.requested && !state.query
+            && (!state.visible || (frame + (unsigned int)OcclusionKeyHash()(it->first)) % OCCLUSION_VISIBLE_QUERY_INTERVAL == 0))
+        {
+            tests.push_back(&state);
+        }
+        state.requested = false;
+        ++it;
+    }
+
+    if (tests.empty())
+        return;
+
+    static const GLushort boxIndices[36] = {
+        0, 1, 3, 0, 3, 2,   4, 6, 7, 4, 7, 5,   // -x, +x
+        0, 4, 5, 0, 5, 1,   2, 3, 7, 2, 7, 6,   // -y, +y
+        0, 2, 6, 0, 6, 4,   1, 5, 7, 1, 7, 3,   // -z, +z
+    };
+    // boxes are drawn in batches that 16 bit indices can address
+    const size_t boxesPerBatch = 65536 / 8;
+
+    auto glProgram = GLProgramCache::getInstance()->getGLProgram(GLProgram::SHADER_NAME_POSITION_U_COLOR);
+    glProgram->use();
+    glProgram->setUniformsForBuiltins(Mat4::IDENTITY);
+
+    if (Configuration::getInstance()->supportsShareableVAO())
+        GL::bindVAO(0);
+    glBindBuffer(GL_ARRAY_BUFFER, 0);
+    glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+    GL::enableVertexAttribs(GL::VERTEX_ATTRIB_FLAG_POSITION);
+
+    GL::colorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+    GL::depthMask(GL_FALSE);
+    GL::enable(GL_DEPTH_TEST);
+    GL::disable(GL_CULL_FACE);
+
+    for (size_t first = 0; first < tests.size(); first += boxesPerBatch)
+    {
+        size_t count = std::min(boxesPerBatch, tests.size() - first);
+        _occlusionVertices.resize(count * 8);
+        _occlusionIndices.resize(count * 36);
+        for (size_t i = 0; i < count; ++i)
+        {
+            const auto& state = *tests[first + i];
+            for (int corner = 0; corner < 8; ++corner)
+            {
+                _occlusionVertices[i * 8 + corner].set(corner & 4 ? state.max.x : state.min.x,
+                                                       corner & 2 ? state.max.y : state.min.y,
+                                                       corner & 1 ? state.max.z : state.min.z);
+            }
+            for (int index = 0; index < 36; ++index)
+                _occlusionIndices[i * 36 + index] = (GLushort)(i * 8 + boxIndices[index]);
+        }
+
+        glVertexAttribPointer(GLProgram::VERTEX_ATTRIB_POSITION, 3, GL_FLOAT, GL_FALSE, 0, _occlusionVertices.data());
+        for (size_t i = 0; i < count; ++i)
+        {
+            GLuint query = 0;
+            if (_freeOcclusionQueries.empty())
+            {
+                glGenQueries(1, &query);
+            }
+            else
+            {
+                query = _freeOcclusionQueries.back();
+                _freeOcclusionQueries.pop_back();
+            }
+
+            glBeginQuery(CC_RENDERER_OCCLUSION_QUERY_TARGET, query);
+            glDrawElements(GL_TRIANGLES, 36, GL_UNSIGNED_SHORT, _occlusionIndices.data() + i * 36);
+            glEndQuery(CC_RENDERER_OCCLUSION_QUERY_TARGET);
+            tests[first + i]->query = query;
+        }
+        CC_INCREMENT_GL_DRAWN_BATCHES_AND_VERTICES(count, count * 36);
+    }
+
+    // the opaque queue state
+    GL::colorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+    GL::depthMask(GL_TRUE);
+    GL::enable(GL_CULL_FACE);
+    CHECK_GL_ERROR_DEBUG();
+#endif
+}
+
+void Renderer::releaseOcclusionQueries()
+{
+#if CC_RENDERER_USE_OCCLUSION_QUERY
+    std::lock_guard<std::mutex> lock(_occlusionMutex);
+    for (const auto& it : _occlusionStates)
+    {
+        if (it.second.query)
+            _freeOcclusionQueries.push_back(it.second.query);
+    }
+    if (!_freeOcclusionQueries.empty())
+        glDeleteQueries((GLsizei)_freeOcclusionQueries.size(), &_freeOcclusionQueries[0]);
+    _freeOcclusionQueries.clear();
+    _occlusionStates.clear();
+#endif
+}
+
+std::string Renderer::getGPUTimingsDescription() const
+{
+    if (!_gpuTimingEnabled)
+        return "GPU timing is disabled\n";
+
+    std::string ret = StringUtils::format("%-48s %10s\n", "Scope", "GPU ms");
+    for (const auto& timing : _gpuTimings)
+    {
+        std::string name(timing.depth * 2, ' ');
+        name += timing.name;
+        ret += StringUtils::format("%-48s %10.3f\n", name.c_str(), timing.milliseconds);
+    }
+    ret += StringUtils::format("%-48s %10.3f\n", "Total", _gpuFrameTime);
+    return ret;
+}
+
 void Renderer::setClearColor(const Color4F &clearColor)
 {
     _clearColor = clearColor;
@@ -27,10 +27,17 @@
 #define __CC_RENDERER_H_
 
 #include <vector>
+#include <deque>
+#include <map>
 #include <stack>
+#include <unordered_map>
+#include <functional>
+#include <mutex>
 
 #include "platform/CCPlatformMacros.h"
+#include "base/CCVector.h"
 #include "renderer/CCRenderCommand.h"
+#include "renderer/CCRenderCommandPool.h"
 #include "renderer/CCGLProgram.h"
 #include "platform/CCGL.h"
 
@@ -60,7 +67,11 @@ NS_CC_BEGIN
 
 class EventListenerCustom;
 class TrianglesCommand;
+class QuadCommand;
+class CustomCommand;
 class MeshCommand;
+class Node;
+class VisitWorkerPool;
 
 /** Class that knows how to sort `RenderCommand` objects.
  Since the commands that have `z == 0` are "pushed back" in
@@ -87,6 +98,20 @@ public:
         QUEUE_COUNT = 5,
     };
 
+    /**
+    How the commands of the OPAQUE_3D group are ordered, see `Renderer::setOpaqueSortMode()`.
+    @since v3.14
+    */
+    enum class OpaqueSortMode
+    {
+        /**In the order they were added.*/
+        NONE,
+        /**Nearest to the camera first, so hidden fragments fail the depth test before they are shaded.*/
+        FRONT_TO_BACK,
+        /**The ones with the same material together, front to back within a material.*/
+        STATE_THEN_FRONT_TO_BACK,
+    };
+
 public:
     /**Constructor.*/
     RenderQueue();
@@ -106,6 +131,10 @@ public:
     std::vector<RenderCommand*>& getSubQueue(QUEUE_GROUP group) { return _commands[group]; }
     /**Get the number of render commands contained in a subqueue.*/
     ssize_t getSubQueueSize(QUEUE_GROUP group) const { return _commands[group].size(); }
+    /**Set how the commands of the OPAQUE_3D group are sorted, for the commands added afterwards. @since v3.14 */
+    void setOpaqueSortMode(OpaqueSortMode mode) { _opaqueSortMode = mode; }
+    /**How the commands of the OPAQUE_3D group are sorted. @since v3.14 */
+    OpaqueSortMode getOpaqueSortMode() const { return _opaqueSortMode; }
 
     /**Save the current DepthState, CullState, DepthWriteState render state.*/
     void saveRenderState();
@@ -113,8 +142,23 @@ public:
     void restoreRenderState();
     
 protected:
+    struct SortEntry
+    {
+        uint64_t key;
+        RenderCommand* command;
+    };
+    /**Radix sort the commands of a queue group by their sort key.*/
+    void sortQueueGroup(QUEUE_GROUP group);
+    /**Radix sort a range of commands by their sort key.*/
+    void sortCommands(RenderCommand** commands, size_t count);
+    /**Sort the runs of mesh commands of the OPAQUE_3D group, the other commands stay in place.*/
+    void sortOpaqueGroup();
+
     /**The commands in the render queue.*/
     std::vector<RenderCommand*> _commands[QUEUE_COUNT];
+    /**Scratch memory used by sort(), kept between frames.*/
+    std::vector<SortEntry> _sortBuffer;
+    OpaqueSortMode _opaqueSortMode;
     
     /**Cull state.*/
     bool _isCullEnabled;
@@ -132,6 +176,7 @@ struct RenderStackElement
 };
 
 class GroupCommandManager;
+class AABB;
 
 /* Class responsible for the rendering in.
 
@@ -146,8 +191,29 @@ public:
     static const int INDEX_VBO_SIZE = VBO_SIZE * 6 / 4;
     /**The rendercommands which can be batched will be saved into a list, this is the reserved size of this list.*/
     static const int BATCH_TRIAGCOMMAND_RESERVED_SIZE = 64;
+    /**The number of VBO_SIZE segments in the vertex/index ring buffers, see `Configuration::useRendererRingBuffer()`.*/
+    static const int RING_BUFFER_SEGMENTS = 3;
+    /**The max number of textures merged into one batch by the multi texture batching, see `setMultiTextureBatchingEnabled()`.*/
+    static const int MULTI_TEXTURE_BATCH_SLOTS = 4;
     /**Reserved for material id, which means that the command could not be batched.*/
     static const int MATERIAL_ID_DO_NOT_BATCH = 0;
+    /**The max number of frames waiting for their GPU timer queries, older frames are dropped.*/
+    static const int GPU_TIMING_PENDING_FRAMES = 4;
+    /**The objects found visible by the occlusion culling are tested again every this many frames.*/
+    static const int OCCLUSION_VISIBLE_QUERY_INTERVAL = 4;
+    /**The occlusion states of the objects that weren't tested for this many frames are dropped.*/
+    static const int OCCLUSION_STALE_FRAMES = 60;
+
+    /** GPU time spent in a render scope: a camera, a render queue group or a GroupCommand. */
+    struct GPUTiming
+    {
+        /**Name of the scope, eg: "Camera(flag=1, depth=0)", "OPAQUE_3D" or "GroupCommand(queue=3)".*/
+        std::string name;
+        /**Nesting level of the scope, cameras are at level 0.*/
+        int depth;
+        /**GPU time in milliseconds.*/
+        double milliseconds;
+    };
     /**Constructor.*/
     Renderer();
     /**Destructor.*/
@@ -171,9 +237,21 @@ public:
     /** Creates a render queue and returns its Id */
     int createRenderQueue();
 
+    /** Returns a render queue, e.g. to read the commands added to a group that isn't drawn by a `GroupCommand`.
+     * @since v3.14
+     */
+    RenderQueue& getRenderQueue(int renderQueueID) { return _renderGroups[renderQueueID]; }
+
     /** Renders into the GLView all the queued `RenderCommand` objects */
     void render();
 
+    /** Renders the queued `RenderCommand` objects and keeps them queued, so they can be rendered again with an other
+     * projection matrix and viewport, like the other eye of a stereo rendering. render() renders them a last time
+     * and cleans them.
+     * @since v3.14
+     */
+    void renderAndKeepCommands();
+
     /** Cleans all `RenderCommand`s in the queue */
     void clean();
 
@@ -191,7 +269,7 @@ public:
     /* RenderCommands (except) TrianglesCommand should update this value */
     void addDrawnVertices(ssize_t number) { _drawnVertices += number; };
     /* clear draw stats */
-    void clearDrawStats() { _drawnBatches = _drawnVertices = 0; }
+    void clearDrawStats();
 
     /**
      * Enable/Disable depth test
@@ -206,6 +284,291 @@ public:
     /** returns whether or not a rectangle is visible or not */
     bool checkVisibility(const Mat4& transform, const Size& size);
 
+    /**
+     * Returns a command of the per-frame arena. It is valid until the queued commands are cleaned at the end of `render()`,
+     * then all of them are released at once. Nodes drawn more than once per frame use them instead of their own command.
+     * The commands are reused by the next frames without being constructed again, call `init()` before adding them.
+     * It can be called while visiting on worker threads.
+     * @since v3.14
+     */
+    CustomCommand* generateTransientCustomCommand();
+    /** @see generateTransientCustomCommand() @since v3.14 */
+    TrianglesCommand* generateTransientTrianglesCommand();
+    /** @see generateTransientCustomCommand() @since v3.14 */
+    QuadCommand* generateTransientQuadCommand();
+    /**
+     * Changes every time the queued commands are cleaned. A node that stores it when adding its own command
+     * knows that the command is still queued if it is drawn again with the same value.
+     * @since v3.14
+     */
+    unsigned int getQueueGeneration() const { return _queueGeneration; }
+
+    /**
+     * Enable/Disable visiting the subtrees marked with `Node::setParallelVisitRoot()` on worker threads.
+     * The recorded commands are merged in scene graph order, so the rendering result doesn't change.
+     * Disabled by default.
+     * @since v3.14
+     */
+    void setParallelVisitEnabled(bool enabled);
+    /** Whether or not parallel visits are enabled. @since v3.14 */
+    bool isParallelVisitEnabled() const { return _parallelVisitEnabled; }
+
+    /**
+     * Enable/Disable batching consecutive `TrianglesCommand`s that use different textures.
+     * Commands using the default `SHADER_NAME_POSITION_TEXTURE_COLOR_NO_MVP` program (without custom uniforms)
+     * and the same blend function are merged while they use up to `MULTI_TEXTURE_BATCH_SLOTS` textures.
+     * The texture slot is streamed per vertex and selected by `SHADER_NAME_POSITION_TEXTURE_COLOR_MULTI_TEXTURE_NO_MVP`.
+     * The initial value comes from `Configuration::useRendererMultiTextureBatching()`.
+     * @since v3.14
+     */
+    void setMultiTextureBatchingEnabled(bool enabled) { _multiTextureBatching = enabled; }
+    /** Whether or not multi texture batching is enabled. @since v3.14 */
+    bool isMultiTextureBatchingEnabled() const { return _multiTextureBatching; }
+
+    /**
+     * Enable/Disable batching of `TrianglesCommand`s and `MeshCommand`s. When disabled, every command is drawn
+     * on its own, to measure what the batching saves on a device. Enabled by default.
+     * @since v3.14
+     */
+    void setBatchingEnabled(bool enabled) { _batchingEnabled = enabled; }
+    /** Whether or not batching is enabled. @since v3.14 */
+    bool isBatchingEnabled() const { return _batchingEnabled; }
+
+    /**
+     * Enable/Disable culling the nodes outside of the visible area: `checkVisibility()`, the spatial index of
+     * `Node` and the frustum culling of `Sprite3D`. The culling of the objects also needs `CC_USE_CULLING`.
+     * Enabled by default.
+     * @since v3.14
+     */
+    void setCullingEnabled(bool enabled) { _cullingEnabled = enabled; }
+    /** Whether or not culling is enabled. @since v3.14 */
+    bool isCullingEnabled() const { return _cullingEnabled; }
+
+    /** The render commands of a frame, see `setCommandStatisticsEnabled()`. @since v3.14 */
+    struct CommandStatistics
+    {
+        struct Queue
+        {
+            int id;
+            ssize_t total;
+            ssize_t groups[RenderQueue::QUEUE_COUNT];
+        };
+        struct NodeCommands
+        {
+            std::string name;
+            std::string type;
+            ssize_t commands;
+        };
+        unsigned int frame;
+        /** the render queues which had commands, the biggest first */
+        std::vector<Queue> queues;
+        /** the number of commands of each RenderCommand::Type */
+        std::map<int, ssize_t> commandTypes;
+        /** the nodes which added commands in Node::visit(), the most first */
+        std::vector<NodeCommands> nodes;
+    };
+
+    /**
+     * Enable/Disable counting the commands of every render queue, command type and node, eg: for the "perf"
+     * command of the Console. The parallel visit isn't used while it's enabled, so every node is counted.
+     * Disabled by default.
+     * @since v3.14
+     */
+    void setCommandStatisticsEnabled(bool enabled);
+    /** Whether or not the command statistics are enabled. @since v3.14 */
+    bool isCommandStatisticsEnabled() const { return _commandStatisticsEnabled; }
+    /** The command statistics of the last complete frame. @since v3.14 */
+    const CommandStatistics& getCommandStatistics() const { return _lastCommandStatistics; }
+
+    /** Why a batch of triangles wasn't merged with the previous one, see `setBatchBreakStatisticsEnabled()`. @since v3.14 */
+    enum class BatchBreakCause
+    {
+        /** another GLProgramState: shader or uniforms */
+        MATERIAL,
+        /** same shader and blend function, another texture */
+        TEXTURE,
+        /** another blend function */
+        BLEND,
+        /** the command skips batching, or batching is disabled */
+        SKIP_BATCHING,
+        /** the texture slots of a multi texture batch are full */
+        TEXTURE_SLOTS,
+        /** a command which isn't a TrianglesCommand was drawn in between, eg: a CustomCommand */
+        OTHER_COMMAND,
+        /** a GroupCommand begins or ends in between */
+        GROUP_COMMAND,
+        /** the commands are in different queue groups of a render queue, eg: negative and positive global z */
+        QUEUE_GROUP,
+        /** the vertex or index buffer is full */
+        VBO_FULL,
+        COUNT
+    };
+
+    /** The batch breaks of a frame, see `setBatchBreakStatisticsEnabled()`. @since v3.14 */
+    struct BatchBreakStatistics
+    {
+        struct Break
+        {
+            BatchBreakCause cause;
+            /** the name and class of the node of the first command of the batch, empty if no node added it */
+            std::string node;
+            std::string nodeType;
+            /** the name and class of the node of the last command of the previous batch */
+            std::string previousNode;
+            std::string previousNodeType;
+        };
+        unsigned int frame;
+        /** the number of breaks of each cause */
+        ssize_t causes[(int)BatchBreakCause::COUNT];
+        /** the breaks in draw order, at most MAX_BATCH_BREAKS */
+        std::vector<Break> breaks;
+    };
+    static const size_t MAX_BATCH_BREAKS = 256;
+
+    /**
+     * Enable/Disable recording why the batches of triangles break and by which nodes, eg: for the "perf breaks"
+     * command of the Console and the stats overlay. Like the command statistics, the parallel visit isn't used
+     * while it's enabled. Disabled by default.
+     * @since v3.14
+     */
+    void setBatchBreakStatisticsEnabled(bool enabled);
+    /** Whether or not the batch break statistics are enabled. @since v3.14 */
+    bool isBatchBreakStatisticsEnabled() const { return _batchBreakStatisticsEnabled; }
+    /** The batch breaks of the last complete frame. @since v3.14 */
+    const BatchBreakStatistics& getBatchBreakStatistics() const { return _lastBatchBreakStatistics; }
+    /** Returns a short name of a cause, eg: "texture". @since v3.14 */
+    static const char* getBatchBreakCauseName(BatchBreakCause cause);
+
+    /** The estimated overdraw of a frame, see `setOverdrawVisualizationEnabled()`. @since v3.14 */
+    struct OverdrawStatistics
+    {
+        /** the triangles drawn by a camera in a queue group of the default render queue */
+        struct Pass
+        {
+            std::string camera;
+            std::string group;
+            /** the pixels covered by the triangles, counted once per layer */
+            double pixels;
+            /** the pixels of the blended triangles, they are drawn over the ones behind them */
+            double transparentPixels;
+        };
+        /** a node covering a large part of the screen while it's (almost) fully transparent */
+        struct TransparentNode
+        {
+            std::string node;
+            std::string nodeType;
+            /** the screens covered by its triangles, above 1 if they overlap */
+            float coverage;
+            /** the largest alpha of its vertices, from 0 to 1 */
+            float alpha;
+        };
+        unsigned int frame;
+        /** the pixels of the screen, the overdraw is the sum of the pixels of the passes divided by it */
+        double screenPixels;
+        std::vector<Pass> passes;
+        /** sorted by coverage, the largest first */
+        std::vector<TransparentNode> transparentNodes;
+    };
+
+    /**
+     * Enable/Disable the overdraw visualization. The triangles are drawn with `SHADER_NAME_OVERDRAW_NO_MVP` and
+     * additive blending, the screen turns from black to red, yellow and white as the pixels are drawn more times.
+     * The triangles whose alpha is near zero are drawn in blue. Meshes and custom commands are drawn as usual.
+     *
+     * While it's enabled the covered pixels of every pass are estimated from the triangles, and the nodes
+     * covering a large area with an alpha near zero are listed, see `getOverdrawStatistics()`. Like the command
+     * statistics, the parallel visit isn't used. Disabled by default.
+     * @since v3.14
+     */
+    void setOverdrawVisualizationEnabled(bool enabled);
+    /** Whether or not the overdraw visualization is enabled. @since v3.14 */
+    bool isOverdrawVisualizationEnabled() const { return _overdrawVisualizationEnabled; }
+    /** The overdraw of the last complete frame. @since v3.14 */
+    const OverdrawStatistics& getOverdrawStatistics() const { return _lastOverdrawStatistics; }
+    /**
+     * Sets when a node is listed in `OverdrawStatistics::transparentNodes`.
+     * @param coverage The share of the screen its triangles must cover, 0.25 by default.
+     * @param alpha The largest alpha of its vertices, 0.05 by default.
+     * @since v3.14
+     */
+    void setOverdrawNodeThresholds(float coverage, float alpha);
+    float getOverdrawCoverageThreshold() const { return _overdrawCoverageThreshold; }
+    float getOverdrawAlphaThreshold() const { return _overdrawAlphaThreshold; }
+
+    /**
+     * Enable/Disable measuring the GPU time of every camera, render queue group and GroupCommand.
+     * Uses timestamp queries from `GL_ARB_timer_query` or `GL_EXT_disjoint_timer_query`, it does nothing
+     * if `Configuration::supportsTimerQuery()` is false. Results are available a few frames later.
+     * @since v3.14
+     */
+    void setGPUTimingEnabled(bool enabled);
+    /** Whether or not GPU timing is enabled. @since v3.14 */
+    bool isGPUTimingEnabled() const { return _gpuTimingEnabled; }
+    /** Timings of the most recent frame whose queries are resolved, in issue order. @since v3.14 */
+    const std::vector<GPUTiming>& getGPUTimings() const { return _gpuTimings; }
+    /** GPU time in milliseconds of the most recent resolved frame, the sum of its cameras. @since v3.14 */
+    double getGPUFrameTime() const { return _gpuFrameTime; }
+    /** Returns the GPU timings as a printable table, used by the Console. @since v3.14 */
+    std::string getGPUTimingsDescription() const;
+    /** Starts a new frame of GPU timings and collects the results of the previous frames. Called by the Director. */
+    void beginGPUTimingFrame();
+
+    /**
+     * Enable/Disable the occlusion culling of 3D objects with GPU occlusion queries.
+     * The objects, eg: `Sprite3D`, call `isOccluded()` before they draw. Their bounding boxes are tested against
+     * the depth buffer after the opaque 3D queue, and the draws of the objects found hidden are skipped once
+     * the results come back, without waiting for them: an object appears one or two frames after it is uncovered.
+     * The boxes are only tested against the default render queue, it does nothing
+     * if `Configuration::supportsOcclusionQuery()` is false. Disabled by default.
+     * @since v3.14
+     */
+    void setOcclusionCullingEnabled(bool enabled);
+    /** Whether or not occlusion culling is enabled. @since v3.14 */
+    bool isOcclusionCullingEnabled() const { return _occlusionCullingEnabled; }
+
+    /**
+     * Sets how the opaque 3D commands of all the render queues are sorted. The mesh commands are reordered
+     * by their material, to save state changes, and front to back by the depth of their origin, to save the
+     * shading of hidden fragments. The other commands of the group, eg: `CustomCommand`s changing states,
+     * keep their place and the meshes aren't moved across them. `RenderQueue::OpaqueSortMode::NONE` by default.
+     * @since v3.14
+     */
+    void setOpaqueSortMode(RenderQueue::OpaqueSortMode mode);
+    /** How the opaque 3D commands are sorted. @since v3.14 */
+    RenderQueue::OpaqueSortMode getOpaqueSortMode() const { return _opaqueSortMode; }
+
+    /**
+     * Enable/Disable the depth pre-pass of the opaque 3D commands. The mesh commands are drawn a first time
+     * with the color writes off, then shaded, so each visible fragment is shaded once whatever the order of
+     * the meshes. It costs a second geometry pass, it pays off with expensive fragment shaders and much overdraw.
+     * Disabled by default.
+     * @since v3.14
+     */
+    void setDepthPrePassEnabled(bool enabled) { _depthPrePassEnabled = enabled; }
+    /** Whether or not the depth pre-pass is enabled. @since v3.14 */
+    bool isDepthPrePassEnabled() const { return _depthPrePassEnabled; }
+    /**
+     * Returns whether or not the object was hidden the last time it was tested for the visiting camera,
+     * and asks to test its world space bounding box again. It can be called while visiting on worker threads.
+     * @since v3.14
+     */
+    bool isOccluded(const void* object, const AABB& aabb);
+    /** The number of objects found occluded while visiting the last rendered camera. @since v3.14 */
+    int getOccludedCount() const { return _lastOccludedCount; }
+
+    //These are used by Node::visit(), they should not be used outside.
+
+    /** Visits the children marked as parallel visit roots on worker threads, returns the number of recorded subtrees. */
+    int recordParallelVisits(const Vector<Node*>& children, const Mat4& parentTransform, uint32_t parentFlags);
+    /** Adds the commands recorded for `node` by `recordParallelVisits()`. Returns false if the node was not recorded. */
+    bool replayParallelVisit(Node* node);
+    /** Whether or not the calling thread is recording the visit of a parallel subtree. */
+    bool isRecordingVisit() const;
+    /** Draws the node and counts the commands it adds, used when the command or batch break statistics are enabled. */
+    void drawWithStatistics(Node* node, const Mat4& transform, uint32_t flags);
+    /** Whether or not the nodes must be drawn with drawWithStatistics(). */
+    bool isDrawStatisticsEnabled() const { return _commandStatisticsEnabled || _batchBreakStatisticsEnabled || _overdrawVisualizationEnabled; }
+
 protected:
 
     //Setup VBO or VAO based on OpenGL extensions
@@ -213,6 +576,9 @@ protected:
     void setupVBOAndVAO();
     void setupVBO();
     void mapBuffers();
+    void setupRingBuffer();
+    // copies _verts/_indices into the ring buffers, returns the byte offset of the indices
+    GLintptr uploadToRingBuffer();
     void drawBatchedTriangles();
 
     //Draw the previews queued triangles and flush previous context
@@ -222,6 +588,8 @@ protected:
     
     void flush3D();
 
+    void flushInstancedMeshes();
+
     void flushTriangles();
 
     void processRenderCommand(RenderCommand* command);
@@ -229,6 +597,21 @@ protected:
 
     void fillVerticesAndIndices(const TrianglesCommand* cmd);
 
+    // whether or not the command can be drawn with the multi texture program
+    bool isMultiTextureBatchable(const TrianglesCommand* cmd);
+
+    // GPU timing scopes, they can be nested
+    void beginGPUScope(const std::string& name);
+    void endGPUScope();
+    GLuint issueTimestampQuery();
+    // reads the results of the pending frames that are available
+    void resolveGPUTimingFrames();
+    void releaseGPUTimingFrame(const std::vector<GLuint>& queries);
+
+    // reads the occlusion results that are available and tests the boxes requested since the last call
+    void processOcclusionQueries();
+    void releaseOcclusionQueries();
+
 
     /* clear color set outside be used in setGLDefaultValues() */
     Color4F _clearColor;
@@ -238,6 +621,9 @@ protected:
     std::vector<RenderQueue> _renderGroups;
 
     MeshCommand* _lastBatchedMeshCommand;
+    // consecutive MeshCommands with the same instancing key, drawn with one instanced draw on flush3D()
+    std::vector<MeshCommand*> _queuedInstancedMeshCommands;
+    GLuint _instanceBufferVBO;
     std::vector<TrianglesCommand*> _queuedTriangleCommands;
 
     //for TrianglesCommand
@@ -246,11 +632,124 @@ protected:
     GLuint _buffersVAO;
     GLuint _buffersVBO[2]; //0: vertex  1: indices
 
+    // Ring buffer upload mode: _buffersVBO hold RING_BUFFER_SEGMENTS segments and every flush
+    // appends to the current one with an unsynchronized map instead of orphaning the buffer
+    bool _useRingBuffer;
+    int _ringSegment;
+    int _ringFilledVertex;
+    int _ringFilledIndex;
+    // GLsync objects guarding each segment, only used when sync objects are supported
+    void* _ringFences[RING_BUFFER_SEGMENTS];
+
+    bool _batchingEnabled;
+    bool _cullingEnabled;
+
+    // Command statistics: the frame in progress, nodes are indexed by their entry while it's counted
+    bool _commandStatisticsEnabled;
+    CommandStatistics _commandStatistics;
+    CommandStatistics _lastCommandStatistics;
+    std::unordered_map<Node*, size_t> _commandStatisticsNodes;
+    ssize_t _addedCommands;
+    void collectCommandStatistics();
+
+    // Batch break statistics: the node which added every command of the frame, and the break the last
+    // flush of triangles leaves for the next batch; a flush sets _flushCause to make one
+    bool _batchBreakStatisticsEnabled;
+    BatchBreakStatistics _batchBreakStatistics;
+    BatchBreakStatistics _lastBatchBreakStatistics;
+    std::unordered_map<const RenderCommand*, Node*> _commandNodes;
+    Node* _drawingNode;
+    BatchBreakCause _flushCause;
+    bool _hasPendingBatchBreak;
+    BatchBreakCause _pendingBatchBreakCause;
+    const RenderCommand* _pendingBatchBreakCommand;
+    void recordBatchBreak(BatchBreakCause cause, const RenderCommand* previous, const RenderCommand* command);
+    void resetBatchBreakStatistics();
+
+    // Overdraw visualization: the pixels of the triangles are added to the current pass, and to the node
+    // which added them, the nodes are filtered by the thresholds at the end of the frame
+    struct OverdrawNode
+    {
+        std::string name;
+        std::string type;
+        float coverage;
+        GLubyte alpha;
+    };
+    bool _overdrawVisualizationEnabled;
+    GLProgram* _overdrawProgram;
+    OverdrawStatistics _overdrawStatistics;
+    OverdrawStatistics _lastOverdrawStatistics;
+    std::unordered_map<const Node*, OverdrawNode> _overdrawNodes;
+    std::string _overdrawCamera;
+    float _overdrawCoverageThreshold;
+    float _overdrawAlphaThreshold;
+    void beginOverdrawPass(const RenderQueue& queue, const char* group);
+    void recordOverdraw(const TrianglesCommand* cmd, int firstVertex);
+    void resetOverdrawStatistics();
+
+    // Multi texture batching: the texture slot of every vertex is uploaded to _textureSlotVBO
+    bool _multiTextureBatching;
+    GLProgram* _multiTextureProgram;
+    GLProgram* _multiTextureBaseProgram;
+    GLuint _textureSlotVBO;
+    GLfloat _textureSlots[VBO_SIZE];
+
+    // GPU timing: every scope records a timestamp query when it begins and when it ends
+    struct GPUScope
+    {
+        std::string name;
+        int depth;
+        GLuint beginQuery;
+        GLuint endQuery;
+    };
+    struct GPUTimingFrame
+    {
+        std::vector<GPUScope> scopes;
+        std::vector<GLuint> queries;
+    };
+    bool _gpuTimingEnabled;
+    std::deque<GPUTimingFrame> _gpuTimingFrames; // pending frames, the current one is at the back
+    std::vector<GLuint> _freeTimerQueries;
+    std::vector<size_t> _gpuScopeStack;
+    std::vector<GPUTiming> _gpuTimings;
+    double _gpuFrameTime;
+
+    // Occlusion culling: the state of an object for a camera, the query tests the box of a previous frame
+    struct OcclusionState
+    {
+        GLuint query;               // 0 if no query is in flight
+        bool visible;
+        bool requested;             // isOccluded() was called since the last queries were issued
+        unsigned int requestFrame;
+        Vec3 min;
+        Vec3 max;
+    };
+    struct OcclusionKeyHash
+    {
+        size_t operator()(const std::pair<const void*, const void*>& key) const
+        {
+            return std::hash<const void*>()(key.first) ^ (std::hash<const void*>()(key.second) * 31);
+        }
+    };
+    bool _occlusionCullingEnabled;
+    RenderQueue::OpaqueSortMode _opaqueSortMode;
+    bool _depthPrePassEnabled;
+    std::unordered_map<std::pair<const void*, const void*>, OcclusionState, OcclusionKeyHash> _occlusionStates;
+    std::vector<GLuint> _freeOcclusionQueries;
+    std::vector<Vec3> _occlusionVertices;
+    std::vector<GLushort> _occlusionIndices;
+    int _occludedCount;
+    int _lastOccludedCount;
+    std::mutex _occlusionMutex;
+
     // Internal structure that has the information for the batches
     struct TriBatchToDraw {
         TrianglesCommand* cmd;  // needed for the Material
         GLsizei indicesToDraw;
         GLsizei offset;
+        // textures of a multi texture batch, 0 for a regular batch
+        GLuint textures[MULTI_TEXTURE_BATCH_SLOTS];
+        int textureCount;
     };
     // capacity of the array of TriBatches
     int _triBatchesToDrawCapacity;
@@ -271,6 +770,35 @@ protected:
     bool _isDepthTestFor2D;
     
     GroupCommandManager* _groupCommandManager;
+
+    // commands recorded while visiting a subtree on a worker thread
+    struct VisitRecording
+    {
+        struct Entry
+        {
+            RenderCommand* command;
+            int renderQueueID; // -1: the current group when the commands are replayed
+        };
+        std::vector<Entry> commands;
+        std::stack<int> groupStack;
+    };
+    VisitRecording* getCurrentRecording() const;
+
+    bool _parallelVisitEnabled;
+    // true while worker threads are recording, the main thread doesn't add commands meanwhile
+    bool _isRecordingVisits;
+    VisitWorkerPool* _visitWorkerPool;
+    std::vector<std::function<void()>> _visitJobs;
+    std::vector<VisitRecording*> _visitRecordings;
+    std::vector<VisitRecording*> _freeVisitRecordings;
+    std::unordered_map<Node*, VisitRecording*> _recordedVisits;
+
+    // per-frame arena, reset by clean()
+    RenderCommandPool<CustomCommand> _transientCustomCommands;
+    RenderCommandPool<TrianglesCommand> _transientTrianglesCommands;
+    RenderCommandPool<QuadCommand> _transientQuadCommands;
+    std::mutex _transientCommandsMutex;
+    unsigned int _queueGeneration;
     
 #if CC_ENABLE_CACHE_TEXTURE_DATA
     EventListenerCustom* _cacheTextureListener;
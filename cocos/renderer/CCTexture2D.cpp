@@ -47,11 +47,24 @@ THE SOFTWARE.
 #include "renderer/ccGLStateCache.h"
 #include "renderer/CCGLProgramCache.h"
 #include "base/CCNinePatchImageParser.h"
+#include "math/MathUtil.h"
+
+#include <mutex>
 
 #if CC_ENABLE_CACHE_TEXTURE_DATA
     #include "renderer/CCTextureCache.h"
 #endif
 
+//#define USE_SSE2_PIXELS   : the pixel conversions use SSE2, always available where it is compiled
+//#define USE_NEON_PIXELS   : the pixel conversions use NEON when MathUtil finds it at runtime
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+    #include <emmintrin.h>
+    #define USE_SSE2_PIXELS
+#elif defined(__ARM_NEON__) || defined(__ARM_NEON)
+    #include <arm_neon.h>
+    #define USE_NEON_PIXELS
+#endif
+
 NS_CC_BEGIN
 
 
@@ -123,6 +136,196 @@ static Texture2D::PixelFormat g_defaultAlphaPixelFormat = Texture2D::PixelFormat
 //////////////////////////////////////////////////////////////////////////
 //convertor function
 
+// The SIMD paths convert blocks of 8 pixels and return the number of bytes of data they converted,
+// the scalar loops finish the rest. They give the same results as the scalar loops.
+namespace {
+    enum class Packed16
+    {
+        RGB565,
+        RGBA4444,
+        RGB5A1,
+    };
+
+#if defined(USE_SSE2_PIXELS)
+    // 4 RGBA8888 pixels to 4 16 bit values in 32 bit lanes
+    template <Packed16 format>
+    inline __m128i packRGBA8888(__m128i p)
+    {
+        if (format == Packed16::RGB565)
+        {
+            return _mm_or_si128(_mm_or_si128(_mm_slli_epi32(_mm_and_si128(p, _mm_set1_epi32(0xF8)), 8),         //R
+                                             _mm_srli_epi32(_mm_and_si128(p, _mm_set1_epi32(0xFC00)), 5)),       //G
+                                _mm_srli_epi32(_mm_and_si128(p, _mm_set1_epi32(0xF80000)), 19));                 //B
+        }
+        else if (format == Packed16::RGBA4444)
+        {
+            return _mm_or_si128(_mm_or_si128(_mm_slli_epi32(_mm_and_si128(p, _mm_set1_epi32(0xF0)), 8),         //R
+                                             _mm_srli_epi32(_mm_and_si128(p, _mm_set1_epi32(0xF000)), 4)),       //G
+                                _mm_or_si128(_mm_srli_epi32(_mm_and_si128(p, _mm_set1_epi32(0xF00000)), 16),     //B
+                                             _mm_srli_epi32(p, 28)));                                            //A
+        }
+        else
+        {
+            return _mm_or_si128(_mm_or_si128(_mm_slli_epi32(_mm_and_si128(p, _mm_set1_epi32(0xF8)), 8),         //R
+                                             _mm_srli_epi32(_mm_and_si128(p, _mm_set1_epi32(0xF800)), 5)),       //G
+                                _mm_or_si128(_mm_srli_epi32(_mm_and_si128(p, _mm_set1_epi32(0xF80000)), 18),     //B
+                                             _mm_srli_epi32(p, 31)));                                            //A
+        }
+    }
+#endif
+
+#if defined(USE_NEON_PIXELS)
+    // NEON is optional on 32 bit Android devices
+    bool isNeonEnabled()
+    {
+        static bool enabled = MathUtil::isNeon32Enabled() || MathUtil::isNeon64Enabled();
+        return enabled;
+    }
+
+    // 8 pixels, as planes of red, green, blue and alpha, to 8 16 bit values
+    template <Packed16 format>
+    inline uint16x8_t packPlanes(uint8x8_t r, uint8x8_t g, uint8x8_t b, uint8x8_t a)
+    {
+        if (format == Packed16::RGB565)
+        {
+            return vorrq_u16(vorrq_u16(vshll_n_u8(vand_u8(r, vdup_n_u8(0xF8)), 8),    //R
+                                       vshll_n_u8(vand_u8(g, vdup_n_u8(0xFC)), 3)),   //G
+                             vmovl_u8(vshr_n_u8(b, 3)));                              //B
+        }
+        else if (format == Packed16::RGBA4444)
+        {
+            return vorrq_u16(vorrq_u16(vshll_n_u8(vand_u8(r, vdup_n_u8(0xF0)), 8),    //R
+                                       vshll_n_u8(vand_u8(g, vdup_n_u8(0xF0)), 4)),   //G
+                             vmovl_u8(vorr_u8(vand_u8(b, vdup_n_u8(0xF0)),            //B
+                                              vshr_n_u8(a, 4))));                     //A
+        }
+        else
+        {
+            return vorrq_u16(vorrq_u16(vshll_n_u8(vand_u8(r, vdup_n_u8(0xF8)), 8),    //R
+                                       vshll_n_u8(vand_u8(g, vdup_n_u8(0xF8)), 3)),   //G
+                             vmovl_u8(vorr_u8(vshr_n_u8(vand_u8(b, vdup_n_u8(0xF8)), 2), //B
+                                              vshr_n_u8(a, 7))));                     //A
+        }
+    }
+#endif
+
+    template <Packed16 format>
+    ssize_t convertRGBA8888To16Fast(const unsigned char* data, ssize_t dataLen, unsigned short* out16)
+    {
+        ssize_t i = 0;
+#if defined(USE_SSE2_PIXELS)
+        for (; i + 32 <= dataLen; i += 32)
+        {
+            __m128i lo = packRGBA8888<format>(_mm_loadu_si128((const __m128i*)(data + i)));
+            __m128i hi = packRGBA8888<format>(_mm_loadu_si128((const __m128i*)(data + i + 16)));
+            // sign extend the values, the saturation of the signed pack then keeps their bits
+            lo = _mm_srai_epi32(_mm_slli_epi32(lo, 16), 16);
+            hi = _mm_srai_epi32(_mm_slli_epi32(hi, 16), 16);
+            _mm_storeu_si128((__m128i*)(out16 + i / 4), _mm_packs_epi32(lo, hi));
+        }
+#elif defined(USE_NEON_PIXELS)
+        if (isNeonEnabled())
+        {
+            for (; i + 32 <= dataLen; i += 32)
+            {
+                uint8x8x4_t p = vld4_u8(data + i);
+                vst1q_u16(out16 + i / 4, packPlanes<format>(p.val[0], p.val[1], p.val[2], p.val[3]));
+            }
+        }
+#endif
+        return i;
+    }
+
+    template <Packed16 format>
+    ssize_t convertRGB888To16Fast(const unsigned char* data, ssize_t dataLen, unsigned short* out16)
+    {
+        // SSE2 has no byte shuffle to spread the 3 byte pixels
+        ssize_t i = 0;
+#if defined(USE_NEON_PIXELS)
+        if (isNeonEnabled())
+        {
+            for (; i + 24 <= dataLen; i += 24)
+            {
+                uint8x8x3_t p = vld3_u8(data + i);
+                vst1q_u16(out16 + i / 3, packPlanes<format>(p.val[0], p.val[1], p.val[2], vdup_n_u8(0xFF)));
+            }
+        }
+#endif
+        return i;
+    }
+
+    ssize_t convertRGB888ToRGBA8888Fast(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
+    {
+        ssize_t i = 0;
+#if defined(USE_NEON_PIXELS)
+        if (isNeonEnabled())
+        {
+            for (; i + 24 <= dataLen; i += 24)
+            {
+                uint8x8x3_t p = vld3_u8(data + i);
+                uint8x8x4_t out = { { p.val[0], p.val[1], p.val[2], vdup_n_u8(0xFF) } };
+                vst4_u8(outData + i / 3 * 4, out);
+            }
+        }
+#endif
+        return i;
+    }
+
+    ssize_t convertRGBA8888ToRGB888Fast(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
+    {
+        ssize_t i = 0;
+#if defined(USE_NEON_PIXELS)
+        if (isNeonEnabled())
+        {
+            for (; i + 32 <= dataLen; i += 32)
+            {
+                uint8x8x4_t p = vld4_u8(data + i);
+                uint8x8x3_t out = { { p.val[0], p.val[1], p.val[2] } };
+                vst3_u8(outData + i / 4 * 3, out);
+            }
+        }
+#endif
+        return i;
+    }
+
+    ssize_t premultiplyAlphaFast(unsigned char* data, ssize_t dataLen)
+    {
+        ssize_t i = 0;
+#if defined(USE_SSE2_PIXELS)
+        const __m128i zero = _mm_setzero_si128();
+        const __m128i one = _mm_set1_epi16(1);
+        const __m128i alphaMask = _mm_set1_epi32((int)0xFF000000);
+        for (; i + 16 <= dataLen; i += 16)
+        {
+            __m128i p = _mm_loadu_si128((const __m128i*)(data + i));
+            __m128i lo = _mm_unpacklo_epi8(p, zero);
+            __m128i hi = _mm_unpackhi_epi8(p, zero);
+            // color * (alpha + 1) >> 8, in 16 bit lanes holding 2 pixels each
+            __m128i alphaLo = _mm_shufflehi_epi16(_mm_shufflelo_epi16(lo, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+            __m128i alphaHi = _mm_shufflehi_epi16(_mm_shufflelo_epi16(hi, _MM_SHUFFLE(3, 3, 3, 3)), _MM_SHUFFLE(3, 3, 3, 3));
+            lo = _mm_srli_epi16(_mm_mullo_epi16(lo, _mm_add_epi16(alphaLo, one)), 8);
+            hi = _mm_srli_epi16(_mm_mullo_epi16(hi, _mm_add_epi16(alphaHi, one)), 8);
+            __m128i result = _mm_packus_epi16(lo, hi);
+            _mm_storeu_si128((__m128i*)(data + i), _mm_or_si128(_mm_andnot_si128(alphaMask, result), _mm_and_si128(alphaMask, p)));
+        }
+#elif defined(USE_NEON_PIXELS)
+        if (isNeonEnabled())
+        {
+            for (; i + 32 <= dataLen; i += 32)
+            {
+                uint8x8x4_t p = vld4_u8(data + i);
+                uint16x8_t alpha = vaddw_u8(vdupq_n_u16(1), p.val[3]);
+                p.val[0] = vshrn_n_u16(vmulq_u16(vmovl_u8(p.val[0]), alpha), 8);
+                p.val[1] = vshrn_n_u16(vmulq_u16(vmovl_u8(p.val[1]), alpha), 8);
+                p.val[2] = vshrn_n_u16(vmulq_u16(vmovl_u8(p.val[2]), alpha), 8);
+                vst4_u8(data + i, p);
+            }
+        }
+#endif
+        return i;
+    }
+}
+
 // IIIIIIII -> RRRRRRRRGGGGGGGGGBBBBBBBB
 void Texture2D::convertI8ToRGB888(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
@@ -277,7 +480,9 @@ void Texture2D::convertAI88ToI8(const unsigned char* data, ssize_t dataLen, unsi
 // RRRRRRRRGGGGGGGGBBBBBBBB -> RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA
 void Texture2D::convertRGB888ToRGBA8888(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
-    for (ssize_t i = 0, l = dataLen - 2; i < l; i += 3)
+    ssize_t converted = convertRGB888ToRGBA8888Fast(data, dataLen, outData);
+    outData += converted / 3 * 4;
+    for (ssize_t i = converted, l = dataLen - 2; i < l; i += 3)
     {
         *outData++ = data[i];         //R
         *outData++ = data[i + 1];     //G
@@ -289,7 +494,9 @@ void Texture2D::convertRGB888ToRGBA8888(const unsigned char* data, ssize_t dataL
 // RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> RRRRRRRRGGGGGGGGBBBBBBBB
 void Texture2D::convertRGBA8888ToRGB888(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
-    for (ssize_t i = 0, l = dataLen - 3; i < l; i += 4)
+    ssize_t converted = convertRGBA8888ToRGB888Fast(data, dataLen, outData);
+    outData += converted / 4 * 3;
+    for (ssize_t i = converted, l = dataLen - 3; i < l; i += 4)
     {
         *outData++ = data[i];         //R
         *outData++ = data[i + 1];     //G
@@ -301,7 +508,9 @@ void Texture2D::convertRGBA8888ToRGB888(const unsigned char* data, ssize_t dataL
 void Texture2D::convertRGB888ToRGB565(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
     unsigned short* out16 = (unsigned short*)outData;
-    for (ssize_t i = 0, l = dataLen - 2; i < l; i += 3)
+    ssize_t converted = convertRGB888To16Fast<Packed16::RGB565>(data, dataLen, out16);
+    out16 += converted / 3;
+    for (ssize_t i = converted, l = dataLen - 2; i < l; i += 3)
     {
         *out16++ = (data[i] & 0x00F8) << 8    //R
             | (data[i + 1] & 0x00FC) << 3     //G
@@ -313,7 +522,9 @@ void Texture2D::convertRGB888ToRGB565(const unsigned char* data, ssize_t dataLen
 void Texture2D::convertRGBA8888ToRGB565(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
     unsigned short* out16 = (unsigned short*)outData;
-    for (ssize_t i = 0, l = dataLen - 3; i < l; i += 4)
+    ssize_t converted = convertRGBA8888To16Fast<Packed16::RGB565>(data, dataLen, out16);
+    out16 += converted / 4;
+    for (ssize_t i = converted, l = dataLen - 3; i < l; i += 4)
     {
         *out16++ = (data[i] & 0x00F8) << 8    //R
             | (data[i + 1] & 0x00FC) << 3     //G
@@ -382,7 +593,9 @@ void Texture2D::convertRGBA8888ToAI88(const unsigned char* data, ssize_t dataLen
 void Texture2D::convertRGB888ToRGBA4444(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
     unsigned short* out16 = (unsigned short*)outData;
-    for (ssize_t i = 0, l = dataLen - 2; i < l; i += 3)
+    ssize_t converted = convertRGB888To16Fast<Packed16::RGBA4444>(data, dataLen, out16);
+    out16 += converted / 3;
+    for (ssize_t i = converted, l = dataLen - 2; i < l; i += 3)
     {
         *out16++ = ((data[i] & 0x00F0) << 8           //R
                     | (data[i + 1] & 0x00F0) << 4     //G
@@ -395,7 +608,9 @@ void Texture2D::convertRGB888ToRGBA4444(const unsigned char* data, ssize_t dataL
 void Texture2D::convertRGBA8888ToRGBA4444(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
     unsigned short* out16 = (unsigned short*)outData;
-    for (ssize_t i = 0, l = dataLen - 3; i < l; i += 4)
+    ssize_t converted = convertRGBA8888To16Fast<Packed16::RGBA4444>(data, dataLen, out16);
+    out16 += converted / 4;
+    for (ssize_t i = converted, l = dataLen - 3; i < l; i += 4)
     {
         *out16++ = (data[i] & 0x00F0) << 8    //R
         | (data[i + 1] & 0x00F0) << 4         //G
@@ -408,7 +623,9 @@ void Texture2D::convertRGBA8888ToRGBA4444(const unsigned char* data, ssize_t dat
 void Texture2D::convertRGB888ToRGB5A1(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
     unsigned short* out16 = (unsigned short*)outData;
-    for (ssize_t i = 0, l = dataLen - 2; i < l; i += 3)
+    ssize_t converted = convertRGB888To16Fast<Packed16::RGB5A1>(data, dataLen, out16);
+    out16 += converted / 3;
+    for (ssize_t i = converted, l = dataLen - 2; i < l; i += 3)
     {
         *out16++ = (data[i] & 0x00F8) << 8    //R
             | (data[i + 1] & 0x00F8) << 3     //G
@@ -421,7 +638,9 @@ void Texture2D::convertRGB888ToRGB5A1(const unsigned char* data, ssize_t dataLen
 void Texture2D::convertRGBA8888ToRGB5A1(const unsigned char* data, ssize_t dataLen, unsigned char* outData)
 {
     unsigned short* out16 = (unsigned short*)outData;
-    for (ssize_t i = 0, l = dataLen - 2; i < l; i += 4)
+    ssize_t converted = convertRGBA8888To16Fast<Packed16::RGB5A1>(data, dataLen, out16);
+    out16 += converted / 4;
+    for (ssize_t i = converted, l = dataLen - 2; i < l; i += 4)
     {
         *out16++ = (data[i] & 0x00F8) << 8    //R
             | (data[i + 1] & 0x00F8) << 3     //G
@@ -429,6 +648,17 @@ void Texture2D::convertRGBA8888ToRGB5A1(const unsigned char* data, ssize_t dataL
             |  (data[i + 3] & 0x0080) >> 7;   //A
     }
 }
+
+// RRRRRRRRGGGGGGGGBBBBBBBBAAAAAAAA -> (RRRRRRRR GGGGGGGG BBBBBBBB) * AAAAAAAA, AAAAAAAA
+void Texture2D::premultiplyAlphaRGBA8888(unsigned char* data, ssize_t dataLen)
+{
+    unsigned int* fourBytes = (unsigned int*)data;
+    for (ssize_t i = premultiplyAlphaFast(data, dataLen); i + 3 < dataLen; i += 4)
+    {
+        unsigned char* p = data + i;
+        fourBytes[i / 4] = CC_RGB_PREMULTIPLY_ALPHA(p[0], p[1], p[2], p[3]);
+    }
+}
 // converter function end
 //////////////////////////////////////////////////////////////////////////
 
@@ -446,6 +676,8 @@ Texture2D::Texture2D()
 , _ninePatchInfo(nullptr)
 , _valid(true)
 , _alphaTexture(nullptr)
+, _gpuMemorySize(0)
+, _gpuMemoryFormat(Texture2D::PixelFormat::NONE)
 {
 }
 
@@ -465,6 +697,7 @@ Texture2D::~Texture2D()
     {
         GL::deleteTexture(_name);
     }
+    setGPUMemorySize(0);
 }
 
 void Texture2D::releaseGLTexture()
@@ -474,6 +707,49 @@ void Texture2D::releaseGLTexture()
         GL::deleteTexture(_name);
     }
     _name = 0;
+    setGPUMemorySize(0);
+}
+
+static std::map<Texture2D::PixelFormat, size_t> s_textureMemory;
+static size_t s_totalTextureMemory = 0;
+
+void Texture2D::setGPUMemorySize(size_t size)
+{
+    if (_gpuMemorySize > 0)
+    {
+        auto iter = s_textureMemory.find(_gpuMemoryFormat);
+        iter->second -= _gpuMemorySize;
+        if (iter->second == 0)
+        {
+            s_textureMemory.erase(iter);
+        }
+        s_totalTextureMemory -= _gpuMemorySize;
+    }
+
+    _gpuMemorySize = size;
+    _gpuMemoryFormat = _pixelFormat;
+
+    if (_gpuMemorySize > 0)
+    {
+        s_textureMemory[_gpuMemoryFormat] += _gpuMemorySize;
+        s_totalTextureMemory += _gpuMemorySize;
+    }
+}
+
+size_t Texture2D::getTextureMemory(Texture2D::PixelFormat format)
+{
+    auto iter = s_textureMemory.find(format);
+    return iter != s_textureMemory.end() ? iter->second : 0;
+}
+
+const std::map<Texture2D::PixelFormat, size_t>& Texture2D::getTextureMemoryByFormat()
+{
+    return s_textureMemory;
+}
+
+size_t Texture2D::getTotalTextureMemory()
+{
+    return s_totalTextureMemory;
 }
 
 
@@ -626,6 +902,7 @@ bool Texture2D::initWithMipmaps(MipmapInfo* mipmaps, int mipmapsNum, PixelFormat
     {
         GL::deleteTexture(_name);
         _name = 0;
+        setGPUMemorySize(0);
     }
 
     glGenTextures(1, &_name);
@@ -666,6 +943,7 @@ bool Texture2D::initWithMipmaps(MipmapInfo* mipmaps, int mipmapsNum, PixelFormat
     // Specify OpenGL texture image
     int width = pixelsWide;
     int height = pixelsHigh;
+    size_t memorySize = 0;
     
     for (int i = 0; i < mipmapsNum; ++i)
     {
@@ -693,6 +971,7 @@ bool Texture2D::initWithMipmaps(MipmapInfo* mipmaps, int mipmapsNum, PixelFormat
             return false;
         }
 
+        memorySize += info.compressed ? (size_t)datalen : (size_t)width * height * info.bpp / 8;
         width = MAX(width >> 1, 1);
         height = MAX(height >> 1, 1);
     }
@@ -706,12 +985,81 @@ bool Texture2D::initWithMipmaps(MipmapInfo* mipmaps, int mipmapsNum, PixelFormat
 
     _hasPremultipliedAlpha = false;
     _hasMipmaps = mipmapsNum > 1;
+    setGPUMemorySize(memorySize);
 
     // shader
     setGLProgram(GLProgramCache::getInstance()->getGLProgram(GLProgram::SHADER_NAME_POSITION_TEXTURE));
     return true;
 }
 
+bool Texture2D::initWithImageMipmaps(Image* image, int baseLevel)
+{
+    CCASSERT(baseLevel >= 0 && baseLevel < image->getNumberOfMipmaps(), "Invalid mipmap level");
+
+    int imageWidth = image->getWidth();
+    int imageHeight = image->getHeight();
+    if (!initWithMipmaps(image->getMipmaps() + baseLevel, image->getNumberOfMipmaps() - baseLevel, image->getRenderFormat(),
+                         MAX(imageWidth >> baseLevel, 1), MAX(imageHeight >> baseLevel, 1)))
+    {
+        return false;
+    }
+
+    // texture coordinates are normalized, the texture keeps the size of the full image
+    _contentSize = Size((float)imageWidth, (float)imageHeight);
+    _pixelsWide = imageWidth;
+    _pixelsHigh = imageHeight;
+    _filePath = image->getFilePath();
+    _hasPremultipliedAlpha = image->hasPremultipliedAlpha();
+    return true;
+}
+
+bool Texture2D::updateWithImageMipmaps(Image* image, int baseLevel)
+{
+    if (_name == 0
+        || image->getRenderFormat() != _pixelFormat
+        || image->getWidth() != _pixelsWide
+        || image->getHeight() != _pixelsHigh
+        || baseLevel < 0 || baseLevel >= image->getNumberOfMipmaps())
+    {
+        return false;
+    }
+
+    const PixelFormatInfo& info = _pixelFormatInfoTables.at(_pixelFormat);
+    MipmapInfo* mipmaps = image->getMipmaps();
+
+    // the texture object and its parameters are kept, the levels past the new chain are ignored by GL
+    glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+    GL::bindTexture2D(_name);
+
+    int width = MAX(_pixelsWide >> baseLevel, 1);
+    int height = MAX(_pixelsHigh >> baseLevel, 1);
+    size_t memorySize = 0;
+    for (int i = baseLevel; i < image->getNumberOfMipmaps(); ++i)
+    {
+        if (info.compressed)
+        {
+            glCompressedTexImage2D(GL_TEXTURE_2D, i - baseLevel, info.internalFormat, (GLsizei)width, (GLsizei)height, 0, mipmaps[i].len, mipmaps[i].address);
+        }
+        else
+        {
+            glTexImage2D(GL_TEXTURE_2D, i - baseLevel, info.internalFormat, (GLsizei)width, (GLsizei)height, 0, info.format, info.type, mipmaps[i].address);
+        }
+
+        memorySize += info.compressed ? (size_t)mipmaps[i].len : (size_t)width * height * info.bpp / 8;
+        width = MAX(width >> 1, 1);
+        height = MAX(height >> 1, 1);
+    }
+
+    GLenum err = glGetError();
+    if (err != GL_NO_ERROR)
+    {
+        CCLOG("cocos2d: Texture2D: Error uploading streamed mipmaps from level: %d . glError: 0x%04X", baseLevel, err);
+        return false;
+    }
+    setGPUMemorySize(memorySize);
+    return true;
+}
+
 bool Texture2D::updateWithData(const void *data,int offsetX,int offsetY,int width,int height)
 {
     if (_name)
@@ -725,6 +1073,33 @@ bool Texture2D::updateWithData(const void *data,int offsetX,int offsetY,int widt
     return false;
 }
 
+bool Texture2D::updateWithRows(const void *data, int firstRow, int rowCount)
+{
+    if (!_name)
+        return false;
+
+    const PixelFormatInfo& info = _pixelFormatInfoTables.at(_pixelFormat);
+    if (info.compressed)
+        return false;
+
+    // other textures may have changed the row alignment since this one was created
+    unsigned int bytesPerRow = (unsigned int)_pixelsWide * info.bpp / 8;
+    if (bytesPerRow % 8 == 0)
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 8);
+    else if (bytesPerRow % 4 == 0)
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+    else if (bytesPerRow % 2 == 0)
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 2);
+    else
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+    GL::bindTexture2D(_name);
+    glTexSubImage2D(GL_TEXTURE_2D, 0, 0, firstRow, (GLsizei)_pixelsWide, rowCount, info.format, info.type, data);
+    CHECK_GL_ERROR_DEBUG();
+
+    return true;
+}
+
 std::string Texture2D::getDescription() const
 {
     return StringUtils::format("<Texture2D | Name = %u | Dimensions = %ld x %ld | Coordinates = (%.2f, %.2f)>", _name, (long)_pixelsWide, (long)_pixelsHigh, _maxS, _maxT);
@@ -1104,7 +1479,40 @@ bool Texture2D::initWithString(const char *text, const FontDefinition& textDefin
     VolatileTextureMgr::addStringTexture(this, text, textDefinition);
 #endif
 
-    bool ret = false;
+    int imageWidth;
+    int imageHeight;
+    bool hasPremultipliedAlpha;
+    Data outData = renderStringData(text, textDefinition, imageWidth, imageHeight, hasPremultipliedAlpha);
+    return initWithRenderedString(outData, imageWidth, imageHeight, hasPremultipliedAlpha);
+}
+
+bool Texture2D::initWithStringData(const std::string& text, const FontDefinition& textDefinition, const Data& data, int width, int height, bool premultipliedAlpha)
+{
+    if (text.empty())
+    {
+        return false;
+    }
+
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+    // cache the texture data
+    VolatileTextureMgr::addStringTexture(this, text.c_str(), textDefinition);
+#endif
+
+    return initWithRenderedString(data, width, height, premultipliedAlpha);
+}
+
+Data Texture2D::renderStringData(const std::string& text, const FontDefinition& textDefinition, int& width, int& height, bool& premultipliedAlpha)
+{
+    // the platforms render with a shared bitmap context
+    static std::mutex s_renderMutex;
+
+    width = height = 0;
+    premultipliedAlpha = false;
+    if (text.empty())
+    {
+        return Data::Null;
+    }
+
     Device::TextAlign align;
     
     if (TextVAlignment::TOP == textDefinition._vertAlignment)
@@ -1125,19 +1533,13 @@ bool Texture2D::initWithString(const char *text, const FontDefinition& textDefin
     else
     {
         CCASSERT(false, "Not supported alignment format!");
-        return false;
+        return Data::Null;
     }
     
 #if (CC_TARGET_PLATFORM != CC_PLATFORM_ANDROID) && (CC_TARGET_PLATFORM != CC_PLATFORM_IOS)
     CCASSERT(textDefinition._stroke._strokeEnabled == false, "Currently stroke only supported on iOS and Android!");
 #endif
 
-    PixelFormat      pixelFormat = g_defaultAlphaPixelFormat;
-    unsigned char* outTempData = nullptr;
-    ssize_t outTempDataLen = 0;
-
-    int imageWidth;
-    int imageHeight;
     auto textDef = textDefinition;
     auto contentScaleFactor = CC_CONTENT_SCALE_FACTOR();
     textDef._fontSize *= contentScaleFactor;
@@ -1146,13 +1548,22 @@ bool Texture2D::initWithString(const char *text, const FontDefinition& textDefin
     textDef._stroke._strokeSize *= contentScaleFactor;
     textDef._shadow._shadowEnabled = false;
     
-    bool hasPremultipliedAlpha;
-    Data outData = Device::getTextureDataForText(text, textDef, align, imageWidth, imageHeight, hasPremultipliedAlpha);
+    std::lock_guard<std::mutex> lock(s_renderMutex);
+    return Device::getTextureDataForText(text.c_str(), textDef, align, width, height, premultipliedAlpha);
+}
+
+bool Texture2D::initWithRenderedString(const Data& outData, int imageWidth, int imageHeight, bool hasPremultipliedAlpha)
+{
     if(outData.isNull())
     {
         return false;
     }
 
+    bool ret = false;
+    PixelFormat      pixelFormat = g_defaultAlphaPixelFormat;
+    unsigned char* outTempData = nullptr;
+    ssize_t outTempDataLen = 0;
+
     Size  imageSize = Size((float)imageWidth, (float)imageHeight);
     pixelFormat = convertDataToFormat(outData.getBytes(), imageWidth*imageHeight*4, PixelFormat::RGBA8888, pixelFormat, &outTempData, &outTempDataLen);
 
@@ -1240,6 +1651,11 @@ void Texture2D::generateMipmap()
     CCASSERT(_pixelsWide == ccNextPOT(_pixelsWide) && _pixelsHigh == ccNextPOT(_pixelsHigh), "Mipmap texture only works in POT textures");
     GL::bindTexture2D( _name );
     glGenerateMipmap(GL_TEXTURE_2D);
+    if (!_hasMipmaps)
+    {
+        // the mipmap chain adds a third of the base level
+        setGPUMemorySize(_gpuMemorySize + _gpuMemorySize / 3);
+    }
     _hasMipmaps = true;
 #if CC_ENABLE_CACHE_TEXTURE_DATA
     VolatileTextureMgr::setHasMipmaps(this, _hasMipmaps);
@@ -1334,7 +1750,12 @@ void Texture2D::setAntiAliasTexParameters()
 
 const char* Texture2D::getStringForFormat() const
 {
-    switch (_pixelFormat) 
+    return getStringForFormat(_pixelFormat);
+}
+
+const char* Texture2D::getStringForFormat(Texture2D::PixelFormat format)
+{
+    switch (format) 
     {
         case Texture2D::PixelFormat::RGBA8888:
             return  "RGBA8888";
@@ -1395,7 +1816,7 @@ const char* Texture2D::getStringForFormat() const
             
         default:
             CCASSERT(false , "unrecognized pixel format");
-            CCLOG("stringForFormat: %ld, cannot give useful result", (long)_pixelFormat);
+            CCLOG("stringForFormat: %ld, cannot give useful result", (long)format);
             break;
     }
 
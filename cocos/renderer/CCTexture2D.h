@@ -37,6 +37,7 @@ THE SOFTWARE.
 
 NS_CC_BEGIN
 
+class Data;
 class Image;
 class NinePatchInfo;
 class SpriteFrame;
@@ -249,6 +250,15 @@ public:
      @param height Specifies the height of the texture subimage.
      */
     bool updateWithData(const void *data,int offsetX,int offsetY,int width,int height);
+
+    /** Update whole rows of the texture, used to spread the upload of big textures over several frames.
+
+     @param data Specifies a pointer to the first row, already converted to the texture pixel format.
+     @param firstRow The first row to update.
+     @param rowCount The number of rows to update.
+     @since v3.14
+     */
+    bool updateWithRows(const void *data, int firstRow, int rowCount);
     /**
     Drawing extensions to make it easy to draw basic quads using a Texture2D object.
     These functions require GL_TEXTURE_2D and both GL_VERTEX_ARRAY and GL_TEXTURE_COORD_ARRAY client states to be enabled.
@@ -300,6 +310,25 @@ public:
      */
     bool initWithString(const char *text, const FontDefinition& textDefinition);
 
+    /** Renders a string with the system font of the platform, in RGBA8888 pixels, like initWithString().
+     * The renders are serialized because the platforms share their text renderer, so it can be called from any thread.
+     *
+     @param text The string.
+     @param textDefinition A FontDefinition object contains font attributes.
+     @param[out] width The width of the pixels.
+     @param[out] height The height of the pixels.
+     @param[out] premultipliedAlpha Whether the pixels have a premultiplied alpha.
+     @return The pixels, null if the string can't be rendered.
+     @since v3.14
+     */
+    static Data renderStringData(const std::string& text, const FontDefinition& textDefinition, int& width, int& height, bool& premultipliedAlpha);
+
+    /** Initializes a texture with the pixels of a string rendered by renderStringData(), on the cocos thread.
+     * The texture is rendered again from the string when the GL context is recreated.
+     * @since v3.14
+     */
+    bool initWithStringData(const std::string& text, const FontDefinition& textDefinition, const Data& data, int width, int height, bool premultipliedAlpha);
+
     /** Sets the min filter, mag filter, wrap s and wrap t texture parameters.
     If the texture size is NPOT (non power of 2), then in can only use GL_CLAMP_TO_EDGE in GL_TEXTURE_WRAP_{S,T}.
 
@@ -351,6 +380,11 @@ public:
      @since v2.0
      */
     const char* getStringForFormat() const;
+
+    /** Helper function that returns the name of a given format.
+     @since v3.14
+     */
+    static const char* getStringForFormat(Texture2D::PixelFormat format);
     CC_DEPRECATED_ATTRIBUTE const char* stringForFormat() const { return getStringForFormat(); };
 
     /** Returns the bits-per-pixel of the in-memory OpenGL texture
@@ -417,6 +451,28 @@ public:
 public:
     /** Get pixel info map, the key-value pairs is PixelFormat and PixelFormatInfo.*/
     static const PixelFormatInfoMap& getPixelFormatInfoMap();
+
+    /** Multiplies the color of RGBA8888 pixels by their alpha in place, like CC_RGB_PREMULTIPLY_ALPHA.
+     * The pixel format conversions and this function use SSE2 or NEON when the CPU has it.
+     * @since v3.14
+     */
+    static void premultiplyAlphaRGBA8888(unsigned char* data, ssize_t dataLen);
+
+    /** Returns the bytes of OpenGL memory used by the alive textures of a pixel format.
+     * It's estimated from the uploaded mipmaps, the driver may pad or compress them.
+     * @since v3.14
+     */
+    static size_t getTextureMemory(Texture2D::PixelFormat format);
+
+    /** Returns the bytes of OpenGL memory used by the alive textures, by pixel format.
+     * @since v3.14
+     */
+    static const std::map<Texture2D::PixelFormat, size_t>& getTextureMemoryByFormat();
+
+    /** Returns the bytes of OpenGL memory used by all the alive textures.
+     * @since v3.14
+     */
+    static size_t getTotalTextureMemory();
     
 private:
     /**
@@ -511,6 +567,17 @@ private:
     static void convertRGBA8888ToRGB5A1(const unsigned char* data, ssize_t dataLen, unsigned char* outData);
 
 protected:
+    // texture streaming of TextureCache: only the mips from baseLevel on are uploaded,
+    // the size of the texture stays the one of the full image
+    bool initWithImageMipmaps(Image* image, int baseLevel);
+    bool updateWithImageMipmaps(Image* image, int baseLevel);
+
+    // accounts the OpenGL memory of the texture to its current pixel format
+    void setGPUMemorySize(size_t size);
+
+    // uploads the RGBA8888 pixels of a rendered string in the default alpha pixel format
+    bool initWithRenderedString(const Data& data, int width, int height, bool premultipliedAlpha);
+
     /** pixel format of the texture */
     Texture2D::PixelFormat _pixelFormat;
 
@@ -547,12 +614,16 @@ protected:
     NinePatchInfo* _ninePatchInfo;
     friend class SpriteFrameCache;
     friend class TextureCache;
+    friend class DynamicTexture;
     friend class ui::Scale9Sprite;
 
     bool _valid;
     std::string _filePath;
 
     Texture2D* _alphaTexture;
+
+    size_t _gpuMemorySize;
+    Texture2D::PixelFormat _gpuMemoryFormat;
 };
 
 
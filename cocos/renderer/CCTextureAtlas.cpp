@@ -52,6 +52,9 @@ NS_CC_BEGIN
 TextureAtlas::TextureAtlas()
     :_indices(nullptr)
     ,_dirty(false)
+    ,_dirtyBegin(0)
+    ,_dirtyEnd(0)
+    ,_bufferedQuads(0)
     ,_texture(nullptr)
     ,_quads(nullptr)
 #if CC_ENABLE_CACHE_TEXTURE_DATA
@@ -105,7 +108,7 @@ void TextureAtlas::setTexture(Texture2D * var)
 V3F_C4B_T2F_Quad* TextureAtlas::getQuads()
 {
     //if someone accesses the quads directly, presume that changes will be made
-    _dirty = true;
+    setDirty(true);
     return _quads;
 }
 
@@ -206,7 +209,7 @@ bool TextureAtlas::initWithTexture(Texture2D *texture, ssize_t capacity)
         setupVBO();
     }
 
-    _dirty = true;
+    setDirty(true);
 
     return true;
 }
@@ -223,7 +226,35 @@ void TextureAtlas::listenRendererRecreated(EventCustom* /*event*/)
     }
     
     // set _dirty to true to force it rebinding buffer
-    _dirty = true;
+    setDirty(true);
+}
+
+void TextureAtlas::setDirty(bool bDirty)
+{
+    _dirty = bDirty;
+    _dirtyBegin = 0;
+    _dirtyEnd = bDirty ? _capacity : 0;
+}
+
+void TextureAtlas::markQuadsDirty(ssize_t index, ssize_t amount)
+{
+    CCASSERT(index >= 0 && amount >= 0, "values must be >= 0");
+    if (amount == 0)
+    {
+        return;
+    }
+
+    if (_dirty)
+    {
+        _dirtyBegin = MIN(_dirtyBegin, index);
+        _dirtyEnd = MAX(_dirtyEnd, index + amount);
+    }
+    else
+    {
+        _dirty = true;
+        _dirtyBegin = index;
+        _dirtyEnd = index + amount;
+    }
 }
 
 std::string TextureAtlas::getDescription() const
@@ -321,7 +352,7 @@ void TextureAtlas::updateQuad(V3F_C4B_T2F_Quad *quad, ssize_t index)
     _quads[index] = *quad;    
 
 
-    _dirty = true;
+    markQuadsDirty(index, 1);
 
 }
 
@@ -344,8 +375,8 @@ void TextureAtlas::insertQuad(V3F_C4B_T2F_Quad *quad, ssize_t index)
 
     _quads[index] = *quad;
 
-
-    _dirty = true;
+    // the following quads were shifted too
+    markQuadsDirty(index, MAX(_totalQuads - index, 1));
 
 }
 
@@ -377,7 +408,7 @@ void TextureAtlas::insertQuads(V3F_C4B_T2F_Quad* quads, ssize_t index, ssize_t a
         j++;
     }
 
-    _dirty = true;
+    markQuadsDirty(index - amount, MAX(_totalQuads - (index - amount), amount));
 }
 
 void TextureAtlas::insertQuadFromIndex(ssize_t oldIndex, ssize_t newIndex)
@@ -406,7 +437,7 @@ void TextureAtlas::insertQuadFromIndex(ssize_t oldIndex, ssize_t newIndex)
     _quads[newIndex] = quadsBackup;
 
 
-    _dirty = true;
+    markQuadsDirty(MIN(oldIndex, newIndex), howMany + 1);
 }
 
 void TextureAtlas::removeQuadAtIndex(ssize_t index)
@@ -425,7 +456,7 @@ void TextureAtlas::removeQuadAtIndex(ssize_t index)
     _totalQuads--;
 
 
-    _dirty = true;
+    markQuadsDirty(index, remaining);
 }
 
 void TextureAtlas::removeQuadsAtIndex(ssize_t index, ssize_t amount)
@@ -441,7 +472,7 @@ void TextureAtlas::removeQuadsAtIndex(ssize_t index, ssize_t amount)
         memmove( &_quads[index], &_quads[index+amount], sizeof(_quads[0]) * remaining );
     }
 
-    _dirty = true;
+    markQuadsDirty(index, remaining);
 }
 
 void TextureAtlas::removeAllQuads()
@@ -527,7 +558,7 @@ bool TextureAtlas::resizeCapacity(ssize_t newCapacity)
     setupIndices();
     mapBuffers();
 
-    _dirty = true;
+    setDirty(true);
 
     return true;
 }
@@ -568,7 +599,7 @@ void TextureAtlas::moveQuadsFromIndex(ssize_t oldIndex, ssize_t amount, ssize_t
 
     free(tempQuads);
 
-    _dirty = true;
+    markQuadsDirty(MIN(oldIndex, newIndex), (oldIndex > newIndex ? oldIndex - newIndex : newIndex - oldIndex) + amount);
 }
 
 void TextureAtlas::moveQuadsFromIndex(ssize_t index, ssize_t newIndex)
@@ -577,6 +608,8 @@ void TextureAtlas::moveQuadsFromIndex(ssize_t index, ssize_t newIndex)
     CCASSERT(newIndex + (_totalQuads - index) <= _capacity, "moveQuadsFromIndex move is out of bounds");
 
     memmove(_quads + newIndex,_quads + index, (_totalQuads - index) * sizeof(_quads[0]));
+
+    markQuadsDirty(MIN(index, newIndex), (index > newIndex ? index - newIndex : newIndex - index) + _totalQuads - index);
 }
 
 void TextureAtlas::fillWithEmptyQuadsFromIndex(ssize_t index, ssize_t amount)
@@ -590,10 +623,53 @@ void TextureAtlas::fillWithEmptyQuadsFromIndex(ssize_t index, ssize_t amount)
     {
         _quads[i] = quad;
     }
+
+    markQuadsDirty(index, amount);
+}
+
+void TextureAtlas::swapQuads(ssize_t index1, ssize_t index2)
+{
+    CCASSERT(index1 >= 0 && index1 < _capacity && index2 >= 0 && index2 < _capacity, "swapQuads: Invalid index");
+
+    std::swap(_quads[index1], _quads[index2]);
+
+    markQuadsDirty(index1, 1);
+    markQuadsDirty(index2, 1);
 }
 
 // TextureAtlas - Drawing
 
+void TextureAtlas::uploadDirtyQuads(bool orphan)
+{
+    // the quads after _totalQuads aren't drawn, they are uploaded once they are counted again
+    auto begin = MIN(_dirtyBegin, _totalQuads);
+    auto end = MIN(_dirtyEnd, _totalQuads);
+    if (_totalQuads > _bufferedQuads)
+    {
+        // quads which were never uploaded are drawn again, eg: after increaseTotalQuadsWith()
+        begin = MIN(begin, _bufferedQuads);
+        end = _totalQuads;
+    }
+
+    // a few modified quads, eg: some moving sprites of a large batch, are uploaded on their own.
+    // when most of them changed the buffer is orphaned, so the driver doesn't wait for the previous draws
+    if (orphan && (end - begin) * 2 > _totalQuads)
+    {
+        glBufferData(GL_ARRAY_BUFFER, sizeof(_quads[0]) * _capacity, nullptr, GL_DYNAMIC_DRAW);
+        void *buf = glMapBuffer(GL_ARRAY_BUFFER, GL_WRITE_ONLY);
+        memcpy(buf, _quads, sizeof(_quads[0])* _totalQuads);
+        glUnmapBuffer(GL_ARRAY_BUFFER);
+        _bufferedQuads = _totalQuads;
+    }
+    else if (end > begin)
+    {
+        glBufferSubData(GL_ARRAY_BUFFER, sizeof(_quads[0]) * begin, sizeof(_quads[0]) * (end - begin), &_quads[begin]);
+        _bufferedQuads = MAX(_bufferedQuads, end);
+    }
+
+    setDirty(false);
+}
+
 void TextureAtlas::drawQuads()
 {
     this->drawNumberOfQuads(_totalQuads, 0);
@@ -625,21 +701,8 @@ void TextureAtlas::drawNumberOfQuads(ssize_t numberOfQuads, ssize_t start)
         if (_dirty) 
         {
             glBindBuffer(GL_ARRAY_BUFFER, _buffersVBO[0]);
-            // option 1: subdata
-//            glBufferSubData(GL_ARRAY_BUFFER, sizeof(_quads[0])*start, sizeof(_quads[0]) * n , &_quads[start] );
-
-            // option 2: data
-//            glBufferData(GL_ARRAY_BUFFER, sizeof(quads_[0]) * (n-start), &quads_[start], GL_DYNAMIC_DRAW);
-
-            // option 3: orphaning + glMapBuffer
-            glBufferData(GL_ARRAY_BUFFER, sizeof(_quads[0]) * _capacity, nullptr, GL_DYNAMIC_DRAW);
-            void *buf = glMapBuffer(GL_ARRAY_BUFFER, GL_WRITE_ONLY);
-            memcpy(buf, _quads, sizeof(_quads[0])* _totalQuads);
-            glUnmapBuffer(GL_ARRAY_BUFFER);
-            
+            uploadDirtyQuads(true);
             glBindBuffer(GL_ARRAY_BUFFER, 0);
-
-            _dirty = false;
         }
 
         GL::bindVAO(_VAOname);
@@ -670,8 +733,7 @@ void TextureAtlas::drawNumberOfQuads(ssize_t numberOfQuads, ssize_t start)
         // FIXME:: update is done in draw... perhaps it should be done in a timer
         if (_dirty) 
         {
-            glBufferSubData(GL_ARRAY_BUFFER, 0, sizeof(_quads[0]) * _totalQuads , &_quads[0] );
-            _dirty = false;
+            uploadDirtyQuads(false);
         }
 
         GL::enableVertexAttribs(GL::VERTEX_ATTRIB_FLAG_POS_COLOR_TEX);
@@ -189,6 +189,12 @@ public:
     */
     void fillWithEmptyQuadsFromIndex(ssize_t index, ssize_t amount);
 
+    /** Swaps the quads at two indexes.
+     Only these two quads are uploaded again when the atlas is drawn.
+     @since v3.14
+    */
+    void swapQuads(ssize_t index1, ssize_t index2);
+
     /** Draws n quads.
     * N can't be greater than the capacity of the Atlas.
     */
@@ -211,7 +217,13 @@ public:
     /** Whether or not the array buffer of the VBO needs to be updated.*/
     bool isDirty() { return _dirty; }
     /** Specify if the array buffer of the VBO needs to be updated. */
-    void setDirty(bool bDirty) { _dirty = bDirty; }
+    void setDirty(bool bDirty);
+    /** Marks an amount of quads starting from index as modified.
+     When the atlas is drawn, only the span of the modified quads is uploaded to the VBO with glBufferSubData,
+     unless it covers most of the quads, in which case the whole buffer is orphaned and mapped.
+     @since v3.14
+    */
+    void markQuadsDirty(ssize_t index, ssize_t amount);
 
     /**Get quads total amount.
      * @js NA
@@ -239,6 +251,7 @@ public:
     
 private:
     void renderCommand();
+    void uploadDirtyQuads(bool orphan);
 
     void setupIndices();
     void mapBuffers();
@@ -250,6 +263,11 @@ protected:
     GLuint              _VAOname;
     GLuint              _buffersVBO[2]; //0: vertex  1: indices
     bool                _dirty; //indicates whether or not the array buffer of the VBO needs to be updated
+    /** the span of the quads that were modified since the last upload, [_dirtyBegin, _dirtyEnd) */
+    ssize_t _dirtyBegin;
+    ssize_t _dirtyEnd;
+    /** the quads from 0 which are up to date in the VBO, except the dirty ones */
+    ssize_t _bufferedQuads;
     /** quantity of quads that are going to be drawn */
     ssize_t _totalQuads;
     /** quantity of quads that can be stored with the current texture atlas size */
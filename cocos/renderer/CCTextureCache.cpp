@@ -31,15 +31,19 @@ THE SOFTWARE.
 #include <stack>
 #include <cctype>
 #include <list>
+#include <algorithm>
 
 #include "renderer/CCTexture2D.h"
 #include "base/ccMacros.h"
 #include "base/ccUTF8.h"
 #include "base/CCDirector.h"
 #include "base/CCScheduler.h"
+#include "base/CCConfiguration.h"
 #include "platform/CCFileUtils.h"
 #include "base/ccUtils.h"
 #include "base/CCNinePatchImageParser.h"
+#include "base/CCProfiling.h"
+#include "base/CCAsyncTaskPool.h"
 
 
 
@@ -67,9 +71,19 @@ TextureCache * TextureCache::getInstance()
 }
 
 TextureCache::TextureCache()
-: _loadingThread(nullptr)
-, _needQuit(false)
+: _needQuit(false)
 , _asyncRefCount(0)
+, _asyncUploadBudget(0)
+, _uploadingStruct(nullptr)
+, _activeDecoders(0)
+, _asyncDecoderCount(0)
+, _memoryBudget(0)
+, _evictedTextureCount(0)
+, _evictedTextureBytes(0)
+, _streamingEnabled(false)
+, _streamingMinSize(64)
+, _textTextureLimit(128)
+, _textTextureUseCount(0)
 {
 }
 
@@ -79,8 +93,10 @@ TextureCache::~TextureCache()
 
     for (auto& texture : _textures)
         texture.second->release();
+    for (auto& text : _textTextures)
+        text.second.texture->release();
 
-    CC_SAFE_DELETE(_loadingThread);
+    CC_SAFE_DELETE(_uploadingStruct);
 }
 
 void TextureCache::destroyInstance()
@@ -106,37 +122,66 @@ struct TextureCache::AsyncStruct
 public:
     AsyncStruct
     ( const std::string& fn,const std::function<void(Texture2D*)>& f,
-      const std::string& key )
+      const std::string& key, int prio )
       : filename(fn), callback(f),callbackKey( key ),
+        priority(prio),
         pixelFormat(Texture2D::getDefaultAlphaPixelFormat()),
-        loadSuccess(false)
+        loadSuccess(false),
+        streamed(false),
+        uploadData(nullptr),
+        uploadDataLen(0),
+        uploadFormat(Texture2D::PixelFormat::NONE),
+        texture(nullptr),
+        uploadedRows(0),
+        cancelled(false),
+        loaded(false)
     {}
 
+    ~AsyncStruct()
+    {
+        if (uploadData != image.getData())
+            free(uploadData);
+        CC_SAFE_RELEASE(texture);
+    }
+
     std::string filename;
     std::function<void(Texture2D*)> callback;
     std::string callbackKey;
+    int priority;
     Image image;
     Image imageAlpha;
     Texture2D::PixelFormat pixelFormat;
     bool loadSuccess;
+
+    // streamed upload, see TextureCache::setAsyncUploadBudget()
+    bool streamed;
+    unsigned char* uploadData;  // converted on the loading thread, may point to the image data
+    ssize_t uploadDataLen;
+    Texture2D::PixelFormat uploadFormat;
+    Texture2D* texture;         // owned until all the rows are uploaded
+    int uploadedRows;
+
+    std::atomic<bool> cancelled;
+    std::atomic<bool> loaded;   // set by the decoder once the fields above may be read by the GL thread
 };
 
 /**
  The addImageAsync logic follow the steps:
- - find the image has been add or not, if not add an AsyncStruct to _requestQueue  (GL thread)
- - get AsyncStruct from _requestQueue, load res and fill image data to AsyncStruct.image, then add AsyncStruct to _responseQueue (Load thread)
- - on schedule callback, get AsyncStruct from _responseQueue, convert image to texture, then delete AsyncStruct (GL thread)
+ - find the image has been add or not, if not add an AsyncStruct to _asyncStructQueue and _pendingStructs, and start a decoder job if less than the decoder count run (GL thread)
+ - take the pending AsyncStruct of highest priority, load res and fill image data to AsyncStruct.image, then mark AsyncStruct as loaded (decoder job)
+ - on schedule callback, take the loaded AsyncStructs no earlier request of the same callbackKey waits for, convert image to texture, then delete AsyncStruct (GL thread)
 
  the Critical Area include these members:
- - _requestQueue: locked by _requestMutex
- - _responseQueue: locked by _responseMutex
+ - _pendingStructs: locked by _pendingMutex
+ - AsyncStruct fields: written by the decoder until loaded is set, read by the GL thread after
 
  the object's life time:
  - AsyncStruct: construct and destruct in GL thread
- - image data: new in Load thread, delete in GL thread(by Image instance)
+ - image data: new in a worker, delete in GL thread(by Image instance)
 
  Note:
  - all AsyncStruct referenced in _asyncStructQueue, for unbind function use.
+ - images are loaded in parallel but callbacks are still called in request order per callbackKey.
 
  How to deal add image many times?
  - At first, this situation is abnormal, we only ensure the logic is correct.
@@ -156,22 +201,33 @@ void TextureCache::addImageAsync(const std::string &path, const std::function<vo
     addImageAsync( path, callback, path );
 }
 
+AsyncOperation<Texture2D*> TextureCache::addImageAsync(const std::string &path, int priority)
+{
+    // a key of its own, unbinding the callbacks of the path doesn't leave the operation pending
+    AsyncOperation<Texture2D*> operation;
+    addImageAsync(path, [operation](Texture2D* texture) {
+        operation.resolve(texture);
+    }, path + "#AsyncOperation", priority);
+    return operation;
+}
+
 /**
  The addImageAsync logic follow the steps:
- - find the image has been add or not, if not add an AsyncStruct to _requestQueue  (GL thread)
- - get AsyncStruct from _requestQueue, load res and fill image data to AsyncStruct.image, then add AsyncStruct to _responseQueue (Load thread)
- - on schedule callback, get AsyncStruct from _responseQueue, convert image to texture, then delete AsyncStruct (GL thread)
+ - find the image has been add or not, if not add an AsyncStruct to _asyncStructQueue and _pendingStructs, and start a decoder job if less than the decoder count run (GL thread)
+ - take the pending AsyncStruct of highest priority, load res and fill image data to AsyncStruct.image, then mark AsyncStruct as loaded (decoder job)
+ - on schedule callback, take the loaded AsyncStructs no earlier request of the same callbackKey waits for, convert image to texture, then delete AsyncStruct (GL thread)
  
  the Critical Area include these members:
- - _requestQueue: locked by _requestMutex
- - _responseQueue: locked by _responseMutex
+ - _pendingStructs: locked by _pendingMutex
+ - AsyncStruct fields: written by the decoder until loaded is set, read by the GL thread after
  
  the object's life time:
  - AsyncStruct: construct and destruct in GL thread
- - image data: new in Load thread, delete in GL thread(by Image instance)
+ - image data: new in a worker, delete in GL thread(by Image instance)
  
  Note:
  - all AsyncStruct referenced in _asyncStructQueue, for unbind function use.
+ - images are loaded in parallel but callbacks are still called in request order per callbackKey.
  
  How to deal add image many times?
  - At first, this situation is abnormal, we only ensure the logic is correct.
@@ -189,6 +245,11 @@ void TextureCache::addImageAsync(const std::string &path, const std::function<vo
  unbindImageAsync(path) would be ambiguous.
  */
 void TextureCache::addImageAsync(const std::string &path, const std::function<void(Texture2D*)>& callback, const std::string& callbackKey)
+{
+    addImageAsync(path, callback, callbackKey, 0);
+}
+
+void TextureCache::addImageAsync(const std::string &path, const std::function<void(Texture2D*)>& callback, const std::string& callbackKey, int priority)
 {
     Texture2D *texture = nullptr;
 
@@ -200,6 +261,7 @@ void TextureCache::addImageAsync(const std::string &path, const std::function<vo
 
     if (texture != nullptr)
     {
+        touchTexture(texture);
         if (callback) callback(texture);
         return;
     }
@@ -210,14 +272,6 @@ void TextureCache::addImageAsync(const std::string &path, const std::function<vo
         return;
     }
 
-    // lazy init
-    if (_loadingThread == nullptr)
-    {
-        // create a new thread to load images
-        _needQuit = false;
-        _loadingThread = new (std::nothrow) std::thread(&TextureCache::loadImage, this);
-    }
-
     if (0 == _asyncRefCount)
     {
         Director::getInstance()->getScheduler()->schedule(CC_SCHEDULE_SELECTOR(TextureCache::addImageAsyncCallBack), this, 0, false);
@@ -227,13 +281,35 @@ void TextureCache::addImageAsync(const std::string &path, const std::function<vo
 
     // generate async struct
     AsyncStruct *data =
-      new (std::nothrow) AsyncStruct(fullpath, callback, callbackKey);
+      new (std::nothrow) AsyncStruct(fullpath, callback, callbackKey, priority);
+    data->streamed = _asyncUploadBudget > 0;
     
     // add async struct into queue
+    _needQuit = false;
     _asyncStructQueue.push_back(data);
-    std::unique_lock<std::mutex> ul(_requestMutex);
-    _requestQueue.push_back(data);
-    _sleepCondition.notify_one();
+
+    auto jobSystem = JobSystem::getInstance();
+    unsigned int decoderCount = _asyncDecoderCount > 0 ? _asyncDecoderCount : std::max(jobSystem->getWorkerCount(), 1u);
+    bool startDecoder = false;
+    {
+        std::lock_guard<std::mutex> lock(_pendingMutex);
+        _pendingStructs.push_back(data);
+        if (_activeDecoders < decoderCount)
+        {
+            ++_activeDecoders;
+            startDecoder = true;
+        }
+    }
+
+    if (startDecoder)
+    {
+        _decoderJobs.erase(std::remove_if(_decoderJobs.begin(), _decoderJobs.end(), [jobSystem](const JobSystem::JobHandle& job) {
+            return jobSystem->isFinished(job);
+        }), _decoderJobs.end());
+        _decoderJobs.push_back(jobSystem->schedule([this]() {
+            decodeAsyncImages();
+        }));
+    }
 }
 
 void TextureCache::unbindImageAsync(const std::string& callbackKey)
@@ -265,71 +341,154 @@ void TextureCache::unbindAllImageAsync()
     }
 }
 
-void TextureCache::loadImage()
+void TextureCache::cancelImageAsync(const std::string& callbackKey)
 {
-    AsyncStruct *asyncStruct = nullptr;
-    while (!_needQuit)
+    if (_asyncStructQueue.empty())
     {
-        std::unique_lock<std::mutex> ul(_requestMutex);
-        // pop an AsyncStruct from request queue
-        if (_requestQueue.empty())
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(_pendingMutex);
+    for (auto& asyncStruct : _asyncStructQueue)
+    {
+        if (asyncStruct->callbackKey != callbackKey)
         {
-            asyncStruct = nullptr;
+            continue;
         }
-        else
+
+        // a texture being uploaded is completed and cached, only its callback is dropped
+        asyncStruct->callback = nullptr;
+        if (asyncStruct == _uploadingStruct)
         {
-            asyncStruct = _requestQueue.front();
-            _requestQueue.pop_front();
+            continue;
         }
+        asyncStruct->cancelled = true;
 
-        if (nullptr == asyncStruct) {
-            if (_needQuit) {
-                break;
+        // not decoded yet, it is loaded already as far as the GL thread is concerned
+        auto it = std::find(_pendingStructs.begin(), _pendingStructs.end(), asyncStruct);
+        if (it != _pendingStructs.end())
+        {
+            _pendingStructs.erase(it);
+            asyncStruct->loaded.store(true, std::memory_order_release);
+        }
+    }
+}
+
+void TextureCache::decodeAsyncImages()
+{
+    // the file buffer is reused by the images of this decoder
+    std::vector<unsigned char> fileData;
+
+    while (true)
+    {
+        AsyncStruct* asyncStruct = nullptr;
+        {
+            std::lock_guard<std::mutex> lock(_pendingMutex);
+            if (_pendingStructs.empty())
+            {
+                --_activeDecoders;
+                return;
             }
-            _sleepCondition.wait(ul);
-            continue;
+
+            // highest priority first, then request order
+            auto best = _pendingStructs.begin();
+            for (auto it = best + 1; it != _pendingStructs.end(); ++it)
+            {
+                if ((*it)->priority > (*best)->priority)
+                    best = it;
+            }
+            asyncStruct = *best;
+            _pendingStructs.erase(best);
         }
-        ul.unlock();
 
-        // load image
-        asyncStruct->loadSuccess = asyncStruct->image.initWithImageFileThreadSafe(asyncStruct->filename);
+        loadImage(asyncStruct, fileData);
+    }
+}
+
+void TextureCache::loadImage(AsyncStruct* asyncStruct, std::vector<unsigned char>& fileData)
+{
+    if (_needQuit || asyncStruct->cancelled)
+    {
+        asyncStruct->loaded.store(true, std::memory_order_release);
+        return;
+    }
+
+    CC_PROFILER_ZONE("TextureCache::loadImage");
 
-        // ETC1 ALPHA supports.
-        if (asyncStruct->loadSuccess && asyncStruct->image.getFileType() == Image::Format::ETC && !s_etc1AlphaFileSuffix.empty())
-        { // check whether alpha texture exists & load it
-            auto alphaFile = asyncStruct->filename + s_etc1AlphaFileSuffix;
-            if (FileUtils::getInstance()->isFileExist(alphaFile))
-                asyncStruct->imageAlpha.initWithImageFileThreadSafe(alphaFile);
+    // load image, like Image::initWithImageFileThreadSafe() but the files that can't be mapped are read into the buffer of the decoder
+    auto fileUtils = FileUtils::getInstance();
+    asyncStruct->image._filePath = asyncStruct->filename;
+    auto mappedFile = fileUtils->mapFileContents(asyncStruct->filename);
+    if (mappedFile)
+    {
+        asyncStruct->loadSuccess = asyncStruct->image.initWithMappedFileData(mappedFile);
+    }
+    else
+    {
+        asyncStruct->loadSuccess = fileUtils->getContents(asyncStruct->filename, &fileData) == FileUtils::Status::OK
+            && asyncStruct->image.initWithImageData(fileData.data(), fileData.size());
+    }
+
+    // ETC1 ALPHA supports.
+    if (asyncStruct->loadSuccess && asyncStruct->image.getFileType() == Image::Format::ETC && !s_etc1AlphaFileSuffix.empty())
+    { // check whether alpha texture exists & load it
+        auto alphaFile = asyncStruct->filename + s_etc1AlphaFileSuffix;
+        if (FileUtils::getInstance()->getContents(alphaFile, &fileData) == FileUtils::Status::OK)
+        {
+            asyncStruct->imageAlpha._filePath = alphaFile;
+            asyncStruct->imageAlpha.initWithImageData(fileData.data(), fileData.size());
         }
-        // push the asyncStruct to response queue
-        _responseMutex.lock();
-        _responseQueue.push_back(asyncStruct);
-        _responseMutex.unlock();
     }
+
+    // streamed images are converted here so that only the upload is left to the GL thread
+    Image& image = asyncStruct->image;
+    if (asyncStruct->loadSuccess && asyncStruct->streamed && !image.isCompressed() && image.getNumberOfMipmaps() <= 1)
+    {
+        auto format = asyncStruct->pixelFormat;
+        if (format == Texture2D::PixelFormat::NONE || format == Texture2D::PixelFormat::AUTO)
+            format = image.getRenderFormat();
+        asyncStruct->uploadFormat = Texture2D::convertDataToFormat(image.getData(), image.getDataLen(), image.getRenderFormat(), format,
+                                                                   &asyncStruct->uploadData, &asyncStruct->uploadDataLen);
+    }
+    else
+    {
+        asyncStruct->streamed = false;
+    }
+
+    asyncStruct->loaded.store(true, std::memory_order_release);
 }
 
 void TextureCache::addImageAsyncCallBack(float /*dt*/)
 {
+    CC_PROFILER_ZONE("TextureCache::addImageAsyncCallBack");
+
     Texture2D *texture = nullptr;
     AsyncStruct *asyncStruct = nullptr;
-    while (true)
+    size_t uploadedBytes = 0;
+    while (_asyncUploadBudget == 0 || uploadedBytes < _asyncUploadBudget)
     {
-        // pop an AsyncStruct from response queue
-        _responseMutex.lock();
-        if (_responseQueue.empty())
+        if (_uploadingStruct)
         {
-            asyncStruct = nullptr;
+            // continue the upload started in a previous frame
+            asyncStruct = _uploadingStruct;
         }
         else
         {
-            asyncStruct = _responseQueue.front();
-            _responseQueue.pop_front();
-
-            // the asyncStruct's sequence order in _asyncStructQueue must equal to the order in _responseQueue
-            CC_ASSERT(asyncStruct == _asyncStructQueue.front());
-            _asyncStructQueue.pop_front();
+            // images complete in any order, the callbacks keep the request order of their callbackKey
+            asyncStruct = nullptr;
+            std::unordered_set<std::string> waitingKeys;
+            for (auto& queued : _asyncStructQueue)
+            {
+                if (waitingKeys.find(queued->callbackKey) != waitingKeys.end())
+                    continue;
+                if (queued->loaded.load(std::memory_order_acquire))
+                {
+                    asyncStruct = queued;
+                    break;
+                }
+                waitingKeys.insert(queued->callbackKey);
+            }
         }
-        _responseMutex.unlock();
 
         if (nullptr == asyncStruct) {
             break;
@@ -337,10 +496,46 @@ void TextureCache::addImageAsyncCallBack(float /*dt*/)
 
         // check the image has been convert to texture or not
         auto it = _textures.find(asyncStruct->filename);
-        if (it != _textures.end())
+        if (asyncStruct->cancelled)
+        {
+            texture = nullptr;
+        }
+        else if (it != _textures.end())
         {
             texture = it->second;
         }
+        else if (asyncStruct->loadSuccess && asyncStruct->streamed)
+        {
+            if (!uploadImageAsyncRows(asyncStruct, &uploadedBytes))
+            {
+                // the budget of this frame is spent, the callback is called when the last rows are uploaded
+                _uploadingStruct = asyncStruct;
+                break;
+            }
+
+            texture = asyncStruct->texture;
+            asyncStruct->texture = nullptr;
+            if (texture)
+            {
+                //parse 9-patch info
+                this->parseNinePatchImage(&asyncStruct->image, texture, asyncStruct->filename);
+#if CC_ENABLE_CACHE_TEXTURE_DATA
+                // cache the texture file name
+                VolatileTextureMgr::addImageTexture(texture, asyncStruct->filename);
+#endif
+                // cache the texture. retain it, since it is added in the map
+                _textures.emplace(asyncStruct->filename, texture);
+                texture->retain();
+                touchTexture(texture);
+                evictIfOverBudget();
+
+                texture->autorelease();
+            }
+            else
+            {
+                CCLOG("cocos2d: failed to call TextureCache::addImageAsync(%s)", asyncStruct->filename.c_str());
+            }
+        }
         else
         {
             // convert image to texture
@@ -351,6 +546,7 @@ void TextureCache::addImageAsyncCallBack(float /*dt*/)
                 texture = new (std::nothrow) Texture2D();
 
                 texture->initWithImage(image, asyncStruct->pixelFormat);
+                uploadedBytes += image->getDataLen();
                 //parse 9-patch info
                 this->parseNinePatchImage(image, texture, asyncStruct->filename);
 #if CC_ENABLE_CACHE_TEXTURE_DATA
@@ -360,6 +556,8 @@ void TextureCache::addImageAsyncCallBack(float /*dt*/)
                 // cache the texture. retain it, since it is added in the map
                 _textures.emplace(asyncStruct->filename, texture);
                 texture->retain();
+                touchTexture(texture);
+                evictIfOverBudget();
 
                 texture->autorelease();
                 // ETC1 ALPHA supports.
@@ -377,6 +575,9 @@ void TextureCache::addImageAsyncCallBack(float /*dt*/)
             }
         }
 
+        _uploadingStruct = nullptr;
+        _asyncStructQueue.erase(std::find(_asyncStructQueue.begin(), _asyncStructQueue.end(), asyncStruct));
+
         // call callback function
         if (asyncStruct->callback)
         {
@@ -394,7 +595,80 @@ void TextureCache::addImageAsyncCallBack(float /*dt*/)
     }
 }
 
+bool TextureCache::uploadImageAsyncRows(AsyncStruct* asyncStruct, size_t* uploadedBytes)
+{
+    Image* image = &(asyncStruct->image);
+    int width = image->getWidth();
+    int height = image->getHeight();
+
+    if (!asyncStruct->texture)
+    {
+        int maxTextureSize = Configuration::getInstance()->getMaxTextureSize();
+        if (width > maxTextureSize || height > maxTextureSize)
+        {
+            CCLOG("cocos2d: WARNING: Image (%d x %d) is bigger than the supported %d x %d", width, height, maxTextureSize, maxTextureSize);
+            return true;
+        }
+
+        // allocate the storage, the rows are sent with glTexSubImage2D
+        auto texture = new (std::nothrow) Texture2D();
+        if (!texture->initWithData(nullptr, asyncStruct->uploadDataLen, asyncStruct->uploadFormat, width, height, Size((float)width, (float)height)))
+        {
+            texture->release();
+            return true;
+        }
+        texture->_filePath = image->getFilePath();
+        texture->_hasPremultipliedAlpha = image->hasPremultipliedAlpha();
+        asyncStruct->texture = texture;
+    }
+
+    size_t bytesPerRow = asyncStruct->uploadDataLen / height;
+    int rows = height - asyncStruct->uploadedRows;
+    if (_asyncUploadBudget > 0)
+    {
+        // at least one row per frame, so that huge rows still progress
+        size_t remaining = _asyncUploadBudget > *uploadedBytes ? _asyncUploadBudget - *uploadedBytes : 0;
+        rows = std::min(rows, std::max(1, (int)(remaining / bytesPerRow)));
+    }
+
+    asyncStruct->texture->updateWithRows(asyncStruct->uploadData + asyncStruct->uploadedRows * bytesPerRow, asyncStruct->uploadedRows, rows);
+    asyncStruct->uploadedRows += rows;
+    *uploadedBytes += rows * bytesPerRow;
+
+    return asyncStruct->uploadedRows >= height;
+}
+
 Texture2D * TextureCache::addImage(const std::string &path)
+{
+    CC_PROFILER_ZONE("TextureCache::addImage");
+
+    return addImageFile(path, false);
+}
+
+Texture2D* TextureCache::addStreamedImage(const std::string& path)
+{
+    CC_PROFILER_ZONE("TextureCache::addStreamedImage");
+
+    return addImageFile(path, _streamingEnabled);
+}
+
+// the largest mip no larger than minSize, 0 when the image can't be streamed
+static int getStreamingBaseLevel(Image* image, int minSize)
+{
+    // ETC1 textures may come with an alpha texture that has to match them
+    int level = 0;
+    if (image->getNumberOfMipmaps() > 1 && image->getFileType() != Image::Format::ETC)
+    {
+        while (level + 1 < image->getNumberOfMipmaps()
+               && MAX(image->getWidth() >> level, image->getHeight() >> level) > minSize)
+        {
+            ++level;
+        }
+    }
+    return level;
+}
+
+Texture2D* TextureCache::addImageFile(const std::string& path, bool streamed)
 {
     Texture2D * texture = nullptr;
     Image* image = nullptr;
@@ -409,7 +683,10 @@ Texture2D * TextureCache::addImage(const std::string &path)
     }
     auto it = _textures.find(fullpath);
     if (it != _textures.end())
+    {
         texture = it->second;
+        touchTexture(texture);
+    }
 
     if (!texture)
     {
@@ -424,7 +701,9 @@ Texture2D * TextureCache::addImage(const std::string &path)
 
             texture = new (std::nothrow) Texture2D();
 
-            if (texture && texture->initWithImage(image))
+            // streamed textures start with their small mips only
+            int baseLevel = streamed ? getStreamingBaseLevel(image, _streamingMinSize) : 0;
+            if (texture && (baseLevel > 0 ? texture->initWithImageMipmaps(image, baseLevel) : texture->initWithImage(image)))
             {
 #if CC_ENABLE_CACHE_TEXTURE_DATA
                 // cache the texture file name
@@ -433,6 +712,22 @@ Texture2D * TextureCache::addImage(const std::string &path)
                 // texture already retained, no need to re-retain it
                 _textures.emplace(fullpath, texture);
 
+                if (baseLevel > 0)
+                {
+                    StreamedTexture& streamedTexture = _streamedTextures[texture];
+                    streamedTexture.fullpath = fullpath;
+                    for (int i = 0; i < image->getNumberOfMipmaps(); ++i)
+                        streamedTexture.levelBytes.push_back(image->getMipmaps()[i].len);
+                    streamedTexture.minResidentLevel = baseLevel;
+                    streamedTexture.residentLevel = baseLevel;
+                    streamedTexture.loadingLevel = -1;
+                    streamedTexture.requestedLevel = baseLevel;
+                    streamedTexture.requestFrame = 0;
+
+                    if (_streamedTextures.size() == 1)
+                        Director::getInstance()->getScheduler()->schedule(CC_SCHEDULE_SELECTOR(TextureCache::updateStreaming), this, 0, false);
+                }
+
                 //-- ANDROID ETC1 ALPHA SUPPORTS.
                 std::string alphaFullPath = path + s_etc1AlphaFileSuffix;
                 if (image->getFileType() == Image::Format::ETC && !s_etc1AlphaFileSuffix.empty() && FileUtils::getInstance()->isFileExist(alphaFullPath))
@@ -450,6 +745,9 @@ Texture2D * TextureCache::addImage(const std::string &path)
 
                 //parse 9-patch info
                 this->parseNinePatchImage(image, texture, path);
+
+                touchTexture(texture);
+                evictIfOverBudget();
             }
             else
             {
@@ -488,6 +786,7 @@ Texture2D* TextureCache::addImage(Image *image, const std::string &key)
         auto it = _textures.find(key);
         if (it != _textures.end()) {
             texture = it->second;
+            touchTexture(texture);
             break;
         }
 
@@ -498,6 +797,8 @@ Texture2D* TextureCache::addImage(Image *image, const std::string &key)
             if (texture->initWithImage(image))
             {
                 _textures.emplace(key, texture);
+                touchTexture(texture);
+                evictIfOverBudget();
             }
             else
             {
@@ -550,6 +851,8 @@ bool TextureCache::reloadTexture(const std::string& fileName)
             bool bRet = image->initWithImageFile(fullpath);
             CC_BREAK_IF(!bRet);
 
+            // the texture gets all its mips again
+            _streamedTextures.erase(texture);
             ret = texture->initWithImage(image);
         } while (0);
     }
@@ -567,15 +870,24 @@ void TextureCache::removeAllTextures()
         texture.second->release();
     }
     _textures.clear();
+    _textureLastUse.clear();
+    _pinnedTextures.clear();
+    _streamedTextures.clear();
+
+    for (auto& text : _textTextures) {
+        text.second.texture->release();
+    }
+    _textTextures.clear();
 }
 
 void TextureCache::removeUnusedTextures()
 {
     for (auto it = _textures.cbegin(); it != _textures.cend(); /* nothing */) {
         Texture2D *tex = it->second;
-        if (tex->getReferenceCount() == 1) {
+        if (tex->getReferenceCount() == 1 && _pinnedTextures.find(tex) == _pinnedTextures.end()) {
             CCLOG("cocos2d: TextureCache: removing unused texture: %s", it->first.c_str());
 
+            forgetTexture(tex);
             tex->release();
             it = _textures.erase(it);
         }
@@ -584,6 +896,8 @@ void TextureCache::removeUnusedTextures()
         }
 
     }
+
+    trimTextTextures(0);
 }
 
 void TextureCache::removeTexture(Texture2D* texture)
@@ -595,6 +909,7 @@ void TextureCache::removeTexture(Texture2D* texture)
 
     for (auto it = _textures.cbegin(); it != _textures.cend(); /* nothing */) {
         if (it->second == texture) {
+            forgetTexture(texture);
             it->second->release();
             it = _textures.erase(it);
             break;
@@ -615,6 +930,7 @@ void TextureCache::removeTextureForKey(const std::string &textureKeyName)
     }
 
     if (it != _textures.end()) {
+        forgetTexture(it->second);
         it->second->release();
         _textures.erase(it);
     }
@@ -631,7 +947,10 @@ Texture2D* TextureCache::getTextureForKey(const std::string &textureKeyName) con
     }
 
     if (it != _textures.end())
+    {
+        touchTexture(it->second);
         return it->second;
+    }
     return nullptr;
 }
 
@@ -658,12 +977,463 @@ std::string TextureCache::getTextureFilePath(cocos2d::Texture2D* texture) const
 
 void TextureCache::waitForQuit()
 {
-    // notify sub thread to quick
-    std::unique_lock<std::mutex> ul(_requestMutex);
+    // the images that haven't started skip the loading, wait for the others
     _needQuit = true;
-    _sleepCondition.notify_one();
-    ul.unlock();
-    if (_loadingThread) _loadingThread->join();
+    for (auto& job : _decoderJobs)
+    {
+        JobSystem::getInstance()->wait(job);
+    }
+    _decoderJobs.clear();
+}
+
+size_t TextureCache::getTextureMemorySize(Texture2D* texture) const
+{
+    // streamed textures are counted with the mips they have once the loads in flight are uploaded
+    auto streamed = _streamedTextures.find(texture);
+    if (streamed != _streamedTextures.end())
+        return streamed->second.getBytes(streamed->second.loadingLevel >= 0 ? streamed->second.loadingLevel : streamed->second.residentLevel);
+
+    // Each texture takes up width * height * bytesPerPixel bytes, mipmaps add a third.
+    size_t bytes = (size_t)texture->getPixelsWide() * texture->getPixelsHigh() * texture->getBitsPerPixelForFormat() / 8;
+    if (texture->hasMipmaps())
+        bytes += bytes / 3;
+
+    auto alphaTexture = texture->getAlphaTexture();
+    if (alphaTexture)
+        bytes += (size_t)alphaTexture->getPixelsWide() * alphaTexture->getPixelsHigh() * alphaTexture->getBitsPerPixelForFormat() / 8;
+    return bytes;
+}
+
+void TextureCache::touchTexture(Texture2D* texture) const
+{
+    _textureLastUse[texture] = Director::getInstance()->getTotalFrames();
+}
+
+void TextureCache::forgetTexture(Texture2D* texture)
+{
+    _textureLastUse.erase(texture);
+    _pinnedTextures.erase(texture);
+    _streamedTextures.erase(texture);
+}
+
+void TextureCache::evictIfOverBudget()
+{
+    if (_memoryBudget > 0)
+    {
+        // streamed mips are dropped before whole textures are evicted
+        trimStreamedTextures(_memoryBudget);
+        evictUnusedTextures(_memoryBudget);
+    }
+}
+
+void TextureCache::setMemoryBudget(size_t bytes)
+{
+    _memoryBudget = bytes;
+    evictIfOverBudget();
+}
+
+size_t TextureCache::getTotalTextureMemory() const
+{
+    size_t totalBytes = 0;
+    for (auto& texture : _textures)
+        totalBytes += getTextureMemorySize(texture.second);
+    return totalBytes;
+}
+
+void TextureCache::setTexturePinned(Texture2D* texture, bool pinned)
+{
+    if (pinned)
+        _pinnedTextures.insert(texture);
+    else
+        _pinnedTextures.erase(texture);
+}
+
+bool TextureCache::isTexturePinned(Texture2D* texture) const
+{
+    return _pinnedTextures.find(texture) != _pinnedTextures.end();
+}
+
+size_t TextureCache::evictUnusedTextures(size_t targetBytes)
+{
+    size_t totalBytes = getTotalTextureMemory();
+    if (totalBytes <= targetBytes)
+        return 0;
+
+    struct Candidate
+    {
+        unsigned int lastUse;
+        size_t bytes;
+        std::unordered_map<std::string, Texture2D*>::iterator it;
+    };
+    std::vector<Candidate> candidates;
+
+    // the textures looked up in this frame are about to be used
+    unsigned int currentFrame = Director::getInstance()->getTotalFrames();
+    for (auto it = _textures.begin(); it != _textures.end(); ++it)
+    {
+        Texture2D* tex = it->second;
+        if (tex->getReferenceCount() != 1 || isTexturePinned(tex))
+            continue;
+
+        auto lastUse = _textureLastUse.find(tex);
+        unsigned int frame = lastUse != _textureLastUse.end() ? lastUse->second : 0;
+        if (frame == currentFrame)
+            continue;
+
+        Candidate candidate = {frame, getTextureMemorySize(tex), it};
+        candidates.push_back(candidate);
+    }
+
+    std::sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b) {
+        return a.lastUse < b.lastUse;
+    });
+
+    size_t freedBytes = 0;
+    for (auto& candidate : candidates)
+    {
+        if (totalBytes - freedBytes <= targetBytes)
+            break;
+
+        CCLOG("cocos2d: TextureCache: evicting texture: %s", candidate.it->first.c_str());
+        Texture2D* tex = candidate.it->second;
+        forgetTexture(tex);
+        _textures.erase(candidate.it);
+        tex->release();
+
+        freedBytes += candidate.bytes;
+        ++_evictedTextureCount;
+        _evictedTextureBytes += candidate.bytes;
+    }
+
+    return freedBytes;
+}
+
+// TextureCache - Streaming
+
+struct TextureCache::StreamedLoad
+{
+    StreamedLoad()
+    : success(false)
+    , loaded(false)
+    {}
+
+    Image image;
+    bool success;
+    std::atomic<bool> loaded;
+};
+
+size_t TextureCache::StreamedTexture::getBytes(int level) const
+{
+    size_t bytes = 0;
+    for (size_t i = level; i < levelBytes.size(); ++i)
+        bytes += levelBytes[i];
+    return bytes;
+}
+
+void TextureCache::loadStreamedMips(StreamedTexture& streamed, int level)
+{
+    // the file is loaded again on a worker, compressed files are mapped instead of read when possible
+    std::shared_ptr<StreamedLoad> load = std::make_shared<StreamedLoad>();
+    std::string fullpath = streamed.fullpath;
+    JobSystem::getInstance()->schedule([load, fullpath]() {
+        load->success = load->image.initWithImageFileThreadSafe(fullpath);
+        load->loaded.store(true, std::memory_order_release);
+    });
+
+    streamed.loadingLevel = level;
+    streamed.load = load;
+}
+
+void TextureCache::requestStreamingSize(Texture2D* texture, float screenPixels)
+{
+    auto it = _streamedTextures.find(texture);
+    if (it == _streamedTextures.end())
+        return;
+
+    // the smallest mip still covering the screen size
+    StreamedTexture& streamed = it->second;
+    int size = MAX(texture->getPixelsWide(), texture->getPixelsHigh());
+    int level = 0;
+    while (level < streamed.minResidentLevel && (size >> (level + 1)) >= screenPixels)
+        ++level;
+
+    unsigned int currentFrame = Director::getInstance()->getTotalFrames();
+    if (streamed.requestFrame != currentFrame || level < streamed.requestedLevel)
+        streamed.requestedLevel = level;
+    streamed.requestFrame = currentFrame;
+}
+
+int TextureCache::getResidentMipLevel(Texture2D* texture) const
+{
+    auto it = _streamedTextures.find(texture);
+    return it != _streamedTextures.end() ? it->second.residentLevel : 0;
+}
+
+void TextureCache::updateStreaming(float /*dt*/)
+{
+    CC_PROFILER_ZONE("TextureCache::updateStreaming");
+
+    // upload the mips loaded since the last frame
+    for (auto it = _streamedTextures.begin(); it != _streamedTextures.end(); /* nothing */)
+    {
+        StreamedTexture& streamed = it->second;
+        if (!streamed.load || !streamed.load->loaded.load(std::memory_order_acquire))
+        {
+            ++it;
+            continue;
+        }
+
+        if (streamed.load->success && it->first->updateWithImageMipmaps(&streamed.load->image, streamed.loadingLevel))
+        {
+            streamed.residentLevel = streamed.loadingLevel;
+            streamed.loadingLevel = -1;
+            streamed.load.reset();
+            ++it;
+        }
+        else
+        {
+            // the texture keeps the mips it has
+            CCLOG("cocos2d: TextureCache: failed to stream the mipmaps of %s", streamed.fullpath.c_str());
+            it = _streamedTextures.erase(it);
+        }
+    }
+
+    if (_streamedTextures.empty())
+    {
+        Director::getInstance()->getScheduler()->unschedule(CC_SCHEDULE_SELECTOR(TextureCache::updateStreaming), this);
+        return;
+    }
+
+    // the textures drawn during the last frame get the mips they requested, as far as the budget allows
+    unsigned int currentFrame = Director::getInstance()->getTotalFrames();
+    size_t totalBytes = _memoryBudget > 0 ? getTotalTextureMemory() : 0;
+    for (auto& item : _streamedTextures)
+    {
+        StreamedTexture& streamed = item.second;
+        if (streamed.loadingLevel >= 0 || streamed.requestFrame + 1 < currentFrame || streamed.requestedLevel >= streamed.residentLevel)
+            continue;
+
+        int level = streamed.requestedLevel;
+        if (_memoryBudget > 0)
+        {
+            size_t residentBytes = streamed.getBytes(streamed.residentLevel);
+            size_t growth = streamed.getBytes(level) - residentBytes;
+            if (totalBytes + growth > _memoryBudget)
+            {
+                trimStreamedTextures(_memoryBudget > growth ? _memoryBudget - growth : 0);
+                totalBytes = getTotalTextureMemory();
+            }
+
+            while (level < streamed.residentLevel && totalBytes + streamed.getBytes(level) - residentBytes > _memoryBudget)
+                ++level;
+            if (level == streamed.residentLevel)
+                continue;
+
+            totalBytes += streamed.getBytes(level) - residentBytes;
+        }
+
+        loadStreamedMips(streamed, level);
+    }
+}
+
+size_t TextureCache::trimStreamedTextures(size_t targetBytes)
+{
+    size_t totalBytes = getTotalTextureMemory();
+    if (totalBytes <= targetBytes)
+        return 0;
+
+    // the textures not drawn during the last frame fall back to their small mips, least recently requested first
+    unsigned int currentFrame = Director::getInstance()->getTotalFrames();
+    std::vector<std::pair<unsigned int, StreamedTexture*>> candidates;
+    for (auto& item : _streamedTextures)
+    {
+        StreamedTexture& streamed = item.second;
+        if (streamed.loadingLevel < 0 && streamed.residentLevel < streamed.minResidentLevel && streamed.requestFrame + 1 < currentFrame)
+            candidates.push_back(std::make_pair(streamed.requestFrame, &streamed));
+    }
+
+    std::sort(candidates.begin(), candidates.end(), [](const std::pair<unsigned int, StreamedTexture*>& a, const std::pair<unsigned int, StreamedTexture*>& b) {
+        return a.first < b.first;
+    });
+
+    size_t droppedBytes = 0;
+    for (auto& candidate : candidates)
+    {
+        if (totalBytes - droppedBytes <= targetBytes)
+            break;
+
+        StreamedTexture* streamed = candidate.second;
+        droppedBytes += streamed->getBytes(streamed->residentLevel) - streamed->getBytes(streamed->minResidentLevel);
+        loadStreamedMips(*streamed, streamed->minResidentLevel);
+    }
+
+    return droppedBytes;
+}
+
+std::string TextureCache::getTextTextureKey(const std::string& text, const FontDefinition& fontDefinition)
+{
+    // what Texture2D::renderStringData() renders, the shadow isn't part of the texture
+    const auto& stroke = fontDefinition._stroke;
+    std::string key = StringUtils::format("%d:%s|%d|%d|%d|%gx%g|%02x%02x%02x%02x|%d|%d|%g",
+        (int)fontDefinition._fontName.size(), fontDefinition._fontName.c_str(), fontDefinition._fontSize,
+        (int)fontDefinition._alignment, (int)fontDefinition._vertAlignment,
+        fontDefinition._dimensions.width, fontDefinition._dimensions.height,
+        fontDefinition._fontFillColor.r, fontDefinition._fontFillColor.g, fontDefinition._fontFillColor.b, fontDefinition._fontAlpha,
+        fontDefinition._enableWrap ? 1 : 0, fontDefinition._overflow, CC_CONTENT_SCALE_FACTOR());
+    if (stroke._strokeEnabled)
+    {
+        key += StringUtils::format("|%02x%02x%02x%02x/%g", stroke._strokeColor.r, stroke._strokeColor.g, stroke._strokeColor.b,
+                                   stroke._strokeAlpha, stroke._strokeSize);
+    }
+    key += '\n';
+    key += text;
+    return key;
+}
+
+Texture2D* TextureCache::findTextTexture(const std::string& key)
+{
+    auto iter = _textTextures.find(key);
+    if (iter == _textTextures.end())
+        return nullptr;
+
+    iter->second.lastUse = ++_textTextureUseCount;
+    return iter->second.texture;
+}
+
+void TextureCache::addTextTexture(const std::string& key, Texture2D* texture)
+{
+    trimTextTextures(_textTextureLimit - 1);
+
+    texture->retain();
+    _textTextures[key] = { texture, ++_textTextureUseCount };
+}
+
+void TextureCache::trimTextTextures(ssize_t count)
+{
+    while ((ssize_t)_textTextures.size() > count)
+    {
+        auto oldest = _textTextures.end();
+        for (auto iter = _textTextures.begin(); iter != _textTextures.end(); ++iter)
+        {
+            if (iter->second.texture->getReferenceCount() == 1 && (oldest == _textTextures.end() || iter->second.lastUse < oldest->second.lastUse))
+            {
+                oldest = iter;
+            }
+        }
+        if (oldest == _textTextures.end())
+            break;
+
+        oldest->second.texture->release();
+        _textTextures.erase(oldest);
+    }
+}
+
+void TextureCache::setTextTextureLimit(int count)
+{
+    _textTextureLimit = MAX(count, 0);
+    trimTextTextures(_textTextureLimit);
+}
+
+Texture2D* TextureCache::getCachedTextureForText(const std::string& text, const FontDefinition& fontDefinition)
+{
+    return findTextTexture(getTextTextureKey(text, fontDefinition));
+}
+
+Texture2D* TextureCache::getTextureForText(const std::string& text, const FontDefinition& fontDefinition)
+{
+    if (text.empty())
+        return nullptr;
+
+    auto key = getTextTextureKey(text, fontDefinition);
+    auto texture = findTextTexture(key);
+    if (texture)
+        return texture;
+
+    texture = new (std::nothrow) Texture2D();
+    if (texture && texture->initWithString(text.c_str(), fontDefinition))
+    {
+        addTextTexture(key, texture);
+        texture->autorelease();
+        return texture;
+    }
+    CC_SAFE_RELEASE(texture);
+    return nullptr;
+}
+
+void TextureCache::getTextureForTextAsync(const std::string& text, const FontDefinition& fontDefinition, const std::function<void(Texture2D*)>& callback)
+{
+    auto key = getTextTextureKey(text, fontDefinition);
+    auto texture = text.empty() ? nullptr : findTextTexture(key);
+    if (texture || text.empty())
+    {
+        // cached, or nothing to render
+        if (callback)
+            callback(texture);
+        return;
+    }
+
+    auto pending = _pendingTextTextures.find(key);
+    if (pending != _pendingTextTextures.end())
+    {
+        pending->second.push_back(callback);
+        return;
+    }
+    _pendingTextTextures[key].push_back(callback);
+
+    struct TextRender
+    {
+        Data data;
+        int width;
+        int height;
+        bool premultipliedAlpha;
+    };
+    auto render = std::make_shared<TextRender>();
+
+    // the renders wait for each other on the text renderer of the platform anyway
+    std::vector<JobSystem::JobHandle> dependencies;
+    if (_textRenderJob)
+    {
+        dependencies.push_back(_textRenderJob);
+    }
+    auto jobSystem = JobSystem::getInstance();
+    _textRenderJob = jobSystem->schedule([text, fontDefinition, render]() {
+        render->data = Texture2D::renderStringData(text, fontDefinition, render->width, render->height, render->premultipliedAlpha);
+    }, dependencies);
+
+    jobSystem->scheduleOnCocosThread([key, text, fontDefinition, render]() {
+        // the cache of the Director, it may have been recreated since the request
+        auto cache = Director::getInstance()->getTextureCache();
+        if (cache == nullptr)
+            return;
+        auto pending = cache->_pendingTextTextures.find(key);
+        if (pending == cache->_pendingTextTextures.end())
+            return;
+
+        auto callbacks = std::move(pending->second);
+        cache->_pendingTextTextures.erase(pending);
+
+        Texture2D* texture = cache->findTextTexture(key);
+        if (texture == nullptr && !render->data.isNull())
+        {
+            texture = new (std::nothrow) Texture2D();
+            if (texture && texture->initWithStringData(text, fontDefinition, render->data, render->width, render->height, render->premultipliedAlpha))
+            {
+                cache->addTextTexture(key, texture);
+                texture->autorelease();
+            }
+            else
+            {
+                CC_SAFE_RELEASE_NULL(texture);
+            }
+        }
+        render->data.clear();
+
+        for (auto& callback : callbacks)
+        {
+            if (callback)
+                callback(texture);
+        }
+    }, { _textRenderJob });
 }
 
 std::string TextureCache::getCachedTextureInfo() const
@@ -672,7 +1442,7 @@ std::string TextureCache::getCachedTextureInfo() const
     char buftmp[4096];
 
     unsigned int count = 0;
-    unsigned int totalBytes = 0;
+    size_t totalBytes = 0;
 
     for (auto& texture : _textures) {
 
@@ -681,12 +1451,12 @@ std::string TextureCache::getCachedTextureInfo() const
 
         Texture2D* tex = texture.second;
         unsigned int bpp = tex->getBitsPerPixelForFormat();
-        // Each texture takes up width * height * bytesPerPixel bytes.
-        auto bytes = tex->getPixelsWide() * tex->getPixelsHigh() * bpp / 8;
+        auto bytes = getTextureMemorySize(tex);
         totalBytes += bytes;
         count++;
-        snprintf(buftmp, sizeof(buftmp) - 1, "\"%s\" rc=%lu id=%lu %lu x %lu @ %ld bpp => %lu KB\n",
+        snprintf(buftmp, sizeof(buftmp) - 1, "\"%s\"%s rc=%lu id=%lu %lu x %lu @ %ld bpp => %lu KB\n",
             texture.first.c_str(),
+            isTexturePinned(tex) ? " pinned" : "",
             (long)tex->getReferenceCount(),
             (long)tex->getName(),
             (long)tex->getPixelsWide(),
@@ -700,6 +1470,24 @@ std::string TextureCache::getCachedTextureInfo() const
     snprintf(buftmp, sizeof(buftmp) - 1, "TextureCache dumpDebugInfo: %ld textures, for %lu KB (%.2f MB)\n", (long)count, (long)totalBytes / 1024, totalBytes / (1024.0f*1024.0f));
     buffer += buftmp;
 
+    if (!_textTextures.empty())
+    {
+        size_t textBytes = 0;
+        for (auto& text : _textTextures)
+        {
+            textBytes += getTextureMemorySize(text.second.texture);
+        }
+        snprintf(buftmp, sizeof(buftmp) - 1, "TextureCache text textures: %ld, for %lu KB\n", (long)_textTextures.size(), (unsigned long)textBytes / 1024);
+        buffer += buftmp;
+    }
+
+    if (_memoryBudget > 0 || _evictedTextureCount > 0)
+    {
+        snprintf(buftmp, sizeof(buftmp) - 1, "TextureCache budget: %lu KB, evicted %u textures for %lu KB\n",
+                 (unsigned long)_memoryBudget / 1024, _evictedTextureCount, (unsigned long)_evictedTextureBytes / 1024);
+        buffer += buftmp;
+    }
+
     return buffer;
 }
 
@@ -723,6 +1511,7 @@ void TextureCache::renameTextureWithKey(const std::string& srcName, const std::s
             bool ret = image->initWithImageFile(dstName);
             if (ret)
             {
+                _streamedTextures.erase(tex);
                 tex->initWithImage(image);
                 _textures.emplace(fullpath, tex);
                 _textures.erase(it);
@@ -28,17 +28,23 @@ THE SOFTWARE.
 #ifndef __CCTEXTURE_CACHE_H__
 #define __CCTEXTURE_CACHE_H__
 
+#include <atomic>
 #include <mutex>
 #include <thread>
 #include <condition_variable>
 #include <queue>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <functional>
+#include <memory>
+#include <vector>
 
 #include "base/CCRef.h"
 #include "renderer/CCTexture2D.h"
 #include "platform/CCImage.h"
+#include "base/CCAsyncTaskPool.h"
+#include "base/CCAsyncOperation.h"
 
 #if CC_ENABLE_CACHE_TEXTURE_DATA
     #include <list>
@@ -126,6 +132,23 @@ public:
     
     void addImageAsync(const std::string &path, const std::function<void(Texture2D*)>& callback, const std::string& callbackKey );
 
+    /** Like addImageAsync(path, callback, callbackKey), the pending images with the highest priority are decoded first.
+     * The callbacks of the requests sharing a callbackKey are still called in request order,
+     * the other requests don't wait for them.
+     * @param priority The priority of the request, 0 for addImageAsync() without priority.
+     * @since v3.14
+     */
+    void addImageAsync(const std::string &path, const std::function<void(Texture2D*)>& callback, const std::string& callbackKey, int priority);
+
+    /** Like addImageAsync(path, callback), returns an operation completed on the cocos thread with the texture,
+     * nullptr if the image can't be loaded. unbindImageAsync(path) doesn't unbind it, unbindAllImageAsync() does
+     * and the operation is never completed.
+     * @since v3.14
+     * @js NA
+     * @lua NA
+     */
+    AsyncOperation<Texture2D*> addImageAsync(const std::string &path, int priority = 0);
+
     /** Unbind a specified bound image asynchronous callback.
      * In the case an object who was bound to an image asynchronous callback was destroyed before the callback is invoked,
      * the object always need to unbind this callback manually.
@@ -139,6 +162,39 @@ public:
      */
     virtual void unbindAllImageAsync();
 
+    /** Cancels the asynchronous loads bound to the callbackKey.
+     * The images not being decoded yet are dropped, the ones being decoded are thrown away once decoded.
+     * Their callbacks are not called and no texture is created.
+     * @param callbackKey The callbackKey used with addImageAsync, the path when none was given.
+     * @since v3.14
+     */
+    void cancelImageAsync(const std::string& callbackKey);
+
+    /** Sets how many images are decoded in parallel by asynchronous loads.
+     * Each decoder runs on a JobSystem worker and reuses its file buffer for the images it decodes.
+     * @param count The number of decoders, 0 for one per JobSystem worker (default).
+     * @since v3.14
+     */
+    void setAsyncDecoderCount(unsigned int count) { _asyncDecoderCount = count; }
+    /** Returns the number of decoders of asynchronous loads, 0 for one per JobSystem worker.
+     * @since v3.14
+     */
+    unsigned int getAsyncDecoderCount() const { return _asyncDecoderCount; }
+
+    /** Sets how many bytes of asynchronously loaded images are uploaded to the GPU per frame.
+     * Image data is then converted to its pixel format on the loading thread, and big textures
+     * are uploaded a band of rows at a time over several frames. Their callbacks are called once
+     * the textures are complete. 0 uploads every loaded image in the frame it arrives (default).
+     * Compressed images and images with mipmaps are always uploaded at once.
+     * @param bytesPerFrame The upload budget in bytes.
+     * @since v3.14
+     */
+    void setAsyncUploadBudget(size_t bytesPerFrame) { _asyncUploadBudget = bytesPerFrame; }
+    /** Returns the per frame upload budget of asynchronously loaded images, in bytes.
+     * @since v3.14
+     */
+    size_t getAsyncUploadBudget() const { return _asyncUploadBudget; }
+
     /** Returns a Texture2D object given an Image.
     * If the image was not previously loaded, it will create a new Texture2D object and it will return it.
     * Otherwise it will return a reference of a previously loaded image.
@@ -172,12 +228,144 @@ public:
     void removeAllTextures();
 
     /** Removes unused textures.
-    * Textures that have a retain count of 1 will be deleted.
+    * Textures that have a retain count of 1 will be deleted, except the pinned ones.
     * It is convenient to call this method after when starting a new Scene.
     * @since v0.8
     */
     void removeUnusedTextures();
 
+    /** Sets the texture memory budget in bytes, 0 means unlimited (default).
+    * When a new texture makes the cache exceed it, unused textures are evicted in least recently used order,
+    * see evictUnusedTextures().
+    * @since v3.14
+    */
+    void setMemoryBudget(size_t bytes);
+    /** Returns the texture memory budget in bytes.
+    * @since v3.14
+    */
+    size_t getMemoryBudget() const { return _memoryBudget; }
+
+    /** Returns the estimated GPU memory used by the cached textures, computed from their size and pixel format.
+    * @since v3.14
+    */
+    size_t getTotalTextureMemory() const;
+
+    /** Returns the number of cached textures.
+    * @since v3.14
+    */
+    ssize_t getTextureCount() const { return (ssize_t)_textures.size(); }
+
+    /** Pins or unpins a texture.
+    * Pinned textures are never evicted and never removed by removeUnusedTextures(), even when nothing uses them.
+    * @since v3.14
+    */
+    void setTexturePinned(Texture2D* texture, bool pinned);
+    /** Whether or not a texture is pinned.
+    * @since v3.14
+    */
+    bool isTexturePinned(Texture2D* texture) const;
+
+    /** Evicts unused textures, the least recently used first, until the cache uses at most targetBytes.
+    * Unused textures have a retain count of 1. Pinned textures and the textures used
+    * during the current frame are kept.
+    * @param targetBytes The memory the cache may still use after the eviction.
+    * @return The number of bytes freed.
+    * @since v3.14
+    */
+    size_t evictUnusedTextures(size_t targetBytes);
+
+    /** Returns the number of textures evicted since the cache was created.
+    * @since v3.14
+    */
+    unsigned int getEvictedTextureCount() const { return _evictedTextureCount; }
+    /** Returns the number of bytes evicted since the cache was created.
+    * @since v3.14
+    */
+    size_t getEvictedTextureBytes() const { return _evictedTextureBytes; }
+
+    /** Returns a Texture2D object given a file image, streaming its mipmaps when streaming is enabled.
+    * A new texture with mipmaps first gets only its mips no larger than the streaming minimum size
+    * uploaded. Its larger mips are loaded on JobSystem workers once requestStreamingSize() asks for them,
+    * and they are dropped again, the least recently requested first, when the textures exceed the memory budget.
+    * Otherwise it behaves like addImage(), textures previously loaded by addImage() stay fully resident.
+    * @param filepath A null terminated string.
+    * @since v3.14
+    */
+    Texture2D* addStreamedImage(const std::string& filepath);
+
+    /** Enables mipmap streaming of the textures loaded by addStreamedImage(), disabled by default.
+    * Textures already streamed keep streaming.
+    * @since v3.14
+    */
+    void setStreamingEnabled(bool enabled) { _streamingEnabled = enabled; }
+    /** Whether or not addStreamedImage() streams the mipmaps.
+    * @since v3.14
+    */
+    bool isStreamingEnabled() const { return _streamingEnabled; }
+
+    /** Sets the largest side, in pixels, of the mips a streamed texture always keeps resident. 64 by default.
+    * @since v3.14
+    */
+    void setStreamingMinSize(int pixels) { _streamingMinSize = pixels; }
+    /** Returns the largest side of the mips streamed textures always keep resident.
+    * @since v3.14
+    */
+    int getStreamingMinSize() const { return _streamingMinSize; }
+
+    /** Asks a streamed texture for the mips it needs to cover screenPixels pixels on screen.
+    * Call it every frame the texture is drawn, the largest request of the frame wins. Sprite3D requests the
+    * projected size of its bounds. Textures that aren't streamed are ignored.
+    * @param texture The texture drawn.
+    * @param screenPixels The size of the texture on screen, in pixels.
+    * @since v3.14
+    */
+    void requestStreamingSize(Texture2D* texture, float screenPixels);
+
+    /** Returns the largest mip level uploaded for a texture, 0 when it is fully resident or not streamed.
+    * @since v3.14
+    */
+    int getResidentMipLevel(Texture2D* texture) const;
+
+    /** Returns the texture of a string rendered with the system font, like Texture2D::initWithString().
+    * The textures are cached by the string and the font definition, so the labels showing the same string with
+    * the same font share a texture instead of rendering it again. The unused ones are kept up to the text
+    * texture limit, and removed by removeUnusedTextures().
+    * @param text The string.
+    * @param fontDefinition The font, its shadow is ignored like by Texture2D::initWithString().
+    * @return The texture, nullptr if the string is empty or can't be rendered.
+    * @since v3.14
+    */
+    Texture2D* getTextureForText(const std::string& text, const FontDefinition& fontDefinition);
+
+    /** Renders a string with the system font on a JobSystem worker, then creates its texture on the cocos thread.
+    * The strings are rendered one at a time, a string already being rendered isn't rendered again.
+    * @param callback Called on the cocos thread with the texture, nullptr if it can't be rendered.
+    *        It is called right away when the texture is cached.
+    * @see getTextureForText()
+    * @since v3.14
+    */
+    void getTextureForTextAsync(const std::string& text, const FontDefinition& fontDefinition, const std::function<void(Texture2D*)>& callback);
+
+    /** Returns the cached texture of a string, nullptr if it isn't cached.
+    * @since v3.14
+    */
+    Texture2D* getCachedTextureForText(const std::string& text, const FontDefinition& fontDefinition);
+
+    /** Sets how many text textures are cached, 128 by default.
+    * When a new one is rendered, the least recently used ones nothing else uses are removed to stay within the limit.
+    * @since v3.14
+    */
+    void setTextTextureLimit(int count);
+    /** Returns how many text textures are cached at most.
+    * @since v3.14
+    */
+    int getTextTextureLimit() const { return _textTextureLimit; }
+
+    /** Returns the number of cached text textures.
+    * @since v3.14
+    */
+    ssize_t getTextTextureCount() const { return (ssize_t)_textTextures.size(); }
+
     /** Deletes a texture from the cache given a texture.
     */
     void removeTexture(Texture2D* texture);
@@ -220,30 +408,96 @@ public:
 
 
 private:
+    struct AsyncStruct;
+
     void addImageAsyncCallBack(float dt);
-    void loadImage();
+    // decoder job: loads the pending images, highest priority first, until none is left
+    void decodeAsyncImages();
+    void loadImage(AsyncStruct* asyncStruct, std::vector<unsigned char>& fileData);
+    Texture2D* addImageFile(const std::string& path, bool streamed);
     void parseNinePatchImage(Image* image, Texture2D* texture, const std::string& path);
+    // LRU bookkeeping of the memory budget
+    void touchTexture(Texture2D* texture) const;
+    void forgetTexture(Texture2D* texture);
+    void evictIfOverBudget();
+    size_t getTextureMemorySize(Texture2D* texture) const;
+    // streaming: loads the mips requested, uploads the loaded ones and drops mips over the budget
+    struct StreamedLoad;
+    // the mips of a streamed texture, level 0 being the largest one
+    struct StreamedTexture
+    {
+        std::string fullpath;
+        std::vector<size_t> levelBytes;
+        // the largest mip always resident
+        int minResidentLevel;
+        // the largest mip uploaded, and the one being loaded or -1
+        int residentLevel;
+        int loadingLevel;
+        // the largest mip requested during requestFrame
+        int requestedLevel;
+        unsigned int requestFrame;
+        std::shared_ptr<StreamedLoad> load;
+
+        // the memory of the mips from level on
+        size_t getBytes(int level) const;
+    };
+    void updateStreaming(float dt);
+    void loadStreamedMips(StreamedTexture& streamed, int level);
+    size_t trimStreamedTextures(size_t targetBytes);
+    // the text textures, by string and font definition
+    static std::string getTextTextureKey(const std::string& text, const FontDefinition& fontDefinition);
+    Texture2D* findTextTexture(const std::string& key);
+    void addTextTexture(const std::string& key, Texture2D* texture);
+    // removes the least recently used text textures nothing else uses, until at most count are left
+    void trimTextTextures(ssize_t count);
 public:
 protected:
-    struct AsyncStruct;
+    bool uploadImageAsyncRows(AsyncStruct* asyncStruct, size_t* uploadedBytes);
     
-    std::thread* _loadingThread;
-
+    // images are loaded by decoder jobs, in parallel, and turned into textures in request order per callbackKey
     std::deque<AsyncStruct*> _asyncStructQueue;
-    std::deque<AsyncStruct*> _requestQueue;
-    std::deque<AsyncStruct*> _responseQueue;
-
-    std::mutex _requestMutex;
-    std::mutex _responseMutex;
-    
-    std::condition_variable _sleepCondition;
+    // the requests not being decoded yet, locked by _pendingMutex
+    std::vector<AsyncStruct*> _pendingStructs;
+    std::mutex _pendingMutex;
+    unsigned int _activeDecoders;
+    unsigned int _asyncDecoderCount;
+    std::vector<JobSystem::JobHandle> _decoderJobs;
 
-    bool _needQuit;
+    std::atomic<bool> _needQuit;
 
     int _asyncRefCount;
 
+    size_t _asyncUploadBudget;
+    // the image whose rows are being uploaded, it is still at the front of _asyncStructQueue
+    AsyncStruct* _uploadingStruct;
+
     std::unordered_map<std::string, Texture2D*> _textures;
 
+    size_t _memoryBudget;
+    // frame of the last lookup of every texture, for the LRU eviction
+    mutable std::unordered_map<Texture2D*, unsigned int> _textureLastUse;
+    std::unordered_set<Texture2D*> _pinnedTextures;
+    unsigned int _evictedTextureCount;
+    size_t _evictedTextureBytes;
+
+    // the textures loaded by addStreamedImage() whose mips are streamed
+    std::unordered_map<Texture2D*, StreamedTexture> _streamedTextures;
+    bool _streamingEnabled;
+    int _streamingMinSize;
+
+    struct TextTexture
+    {
+        Texture2D* texture;
+        unsigned int lastUse;
+    };
+    std::unordered_map<std::string, TextTexture> _textTextures;
+    // the callbacks of the strings being rendered by getTextureForTextAsync()
+    std::unordered_map<std::string, std::vector<std::function<void(Texture2D*)>>> _pendingTextTextures;
+    // the last render, the next one waits for it
+    JobSystem::JobHandle _textRenderJob;
+    int _textTextureLimit;
+    unsigned int _textTextureUseCount;
+
     static std::string s_etc1AlphaFileSuffix;
 };
 
@@ -25,6 +25,8 @@
 #include "renderer/CCTextureCube.h"
 #include "platform/CCImage.h"
 #include "platform/CCFileUtils.h"
+#include "base/CCAsyncTaskPool.h"
+#include "base/ccUtils.h"
 
 #include "renderer/ccGLStateCache.h"
 
@@ -139,7 +141,10 @@ Image* createImage(const std::string& path)
         CC_BREAK_IF(nullptr == image);
 
         bool bRet = image->initWithImageFile(fullpath);
-        CC_BREAK_IF(!bRet);
+        if (!bRet)
+        {
+            CC_SAFE_RELEASE_NULL(image);
+        }
     }
     while (0);
 
@@ -147,6 +152,7 @@ Image* createImage(const std::string& path)
 }
 
 TextureCube::TextureCube()
+: _mipmapsGenerated(false)
 {
     _imgPath.resize(6);
 }
@@ -169,6 +175,52 @@ TextureCube* TextureCube::create(const std::string& positive_x, const std::strin
     return nullptr;
 }
 
+void TextureCube::createAsync(const std::string& positive_x, const std::string& negative_x,
+                              const std::string& positive_y, const std::string& negative_y,
+                              const std::string& positive_z, const std::string& negative_z,
+                              const std::function<void(TextureCube*)>& callback)
+{
+    std::vector<std::string> paths = { positive_x, negative_x, positive_y, negative_y, positive_z, negative_z };
+    auto images = std::make_shared<std::vector<Image*>>(6, nullptr);
+
+    // a job per face, so the faces are decoded in parallel
+    auto jobSystem = JobSystem::getInstance();
+    std::vector<JobSystem::JobHandle> decodes;
+    for (int i = 0; i < 6; i++)
+    {
+        auto path = paths[i];
+        decodes.push_back(jobSystem->schedule([images, i, path]() {
+            (*images)[i] = createImage(path);
+        }));
+    }
+
+    jobSystem->scheduleOnCocosThread([images, paths, callback]() {
+        auto texture = new (std::nothrow) TextureCube();
+        if (texture)
+        {
+            texture->_imgPath = paths;
+            if (texture->initWithImages(*images))
+            {
+                texture->autorelease();
+            }
+            else
+            {
+                CC_SAFE_DELETE(texture);
+            }
+        }
+
+        for (auto img: *images)
+        {
+            CC_SAFE_RELEASE(img);
+        }
+
+        if (callback)
+        {
+            callback(texture);
+        }
+    }, decodes);
+}
+
 bool TextureCube::init(const std::string& positive_x, const std::string& negative_x,
                        const std::string& positive_y, const std::string& negative_y,
                        const std::string& positive_z, const std::string& negative_z)
@@ -189,12 +241,96 @@ bool TextureCube::init(const std::string& positive_x, const std::string& negativ
     images[4] = createImage(positive_z);
     images[5] = createImage(negative_z);
 
+    bool ret = initWithImages(images);
+
+    for (auto img: images)
+    {
+        CC_SAFE_RELEASE(img);
+    }
+
+    return ret;
+}
+
+bool TextureCube::initWithImages(const std::vector<Image*>& images)
+{
+    CCASSERT(images.size() == 6, "TextureCube: needs 6 faces");
+
+    for (int i = 0; i < 6; i++)
+    {
+        if (images[i] == nullptr)
+        {
+            CCLOG("cocos2d: TextureCube: can't load %s", _imgPath[i].c_str());
+            return false;
+        }
+    }
+
+    // the compressed faces and the ones with mipmaps are uploaded level by level, as they are in the files
+    Image* first = images[0];
+    auto pixelFormat = first->getRenderFormat();
+    int width = first->getWidth();
+    int height = first->getHeight();
+    int levels = first->getNumberOfMipmaps();
+    bool sameLayout = true;
+    for (auto img: images)
+    {
+        sameLayout = sameLayout && img->getRenderFormat() == pixelFormat && img->getWidth() == width
+            && img->getHeight() == height && img->getNumberOfMipmaps() == levels;
+    }
+
+    bool uploadLevels = first->isCompressed() || levels > 1;
+    if (uploadLevels && !sameLayout)
+    {
+        if (first->isCompressed())
+        {
+            CCLOG("cocos2d: TextureCube: the compressed faces must have the same size, format and mipmaps");
+            return false;
+        }
+        uploadLevels = false;
+    }
+
+    auto& formatInfos = Texture2D::getPixelFormatInfoMap();
+    if (uploadLevels && formatInfos.find(pixelFormat) == formatInfos.end())
+    {
+        CCLOG("cocos2d: TextureCube: unsupported pixel format");
+        return false;
+    }
+
     GLuint handle;
     glGenTextures(1, &handle);
 
     GL::bindTextureN(0, handle, GL_TEXTURE_CUBE_MAP);
 
-    for (int i = 0; i < 6; i++)
+    size_t memorySize = 0;
+    if (uploadLevels)
+    {
+        const PixelFormatInfo& info = formatInfos.at(pixelFormat);
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 1);
+
+        for (int i = 0; i < 6; i++)
+        {
+            MipmapInfo* mipmaps = images[i]->getMipmaps();
+            int levelWidth = width;
+            int levelHeight = height;
+            for (int level = 0; level < levels; ++level)
+            {
+                if (info.compressed)
+                {
+                    glCompressedTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, level, info.internalFormat,
+                                           levelWidth, levelHeight, 0, mipmaps[level].len, mipmaps[level].address);
+                }
+                else
+                {
+                    glTexImage2D(GL_TEXTURE_CUBE_MAP_POSITIVE_X + i, level, info.internalFormat,
+                                 levelWidth, levelHeight, 0, info.format, info.type, mipmaps[level].address);
+                }
+
+                memorySize += info.compressed ? (size_t)mipmaps[level].len : (size_t)levelWidth * levelHeight * info.bpp / 8;
+                levelWidth = MAX(levelWidth >> 1, 1);
+                levelHeight = MAX(levelHeight >> 1, 1);
+            }
+        }
+    }
+    else for (int i = 0; i < 6; i++)
     {
         Image* img = images[i];
 
@@ -227,25 +363,61 @@ bool TextureCube::init(const std::string& positive_x, const std::string& negativ
 
         if (pData != img->getData())
             delete[] pData;
+
+        memorySize += (size_t)img->getWidth() * img->getHeight() * (ePixelFmt == Texture2D::PixelFormat::RGB888 ? 3 : 4);
+        pixelFormat = ePixelFmt == Texture2D::PixelFormat::RGB888 ? ePixelFmt : Texture2D::PixelFormat::RGBA8888;
+        levels = 1;
     }
 
     glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
-    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, levels > 1 ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
     glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
     glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
 
     _name = handle;
+    _pixelsWide = width;
+    _pixelsHigh = height;
+    _contentSize = Size((float)width, (float)height);
+    _pixelFormat = pixelFormat;
+    _hasMipmaps = levels > 1;
+    setGPUMemorySize(memorySize);
 
     GL::bindTextureN(0, 0, GL_TEXTURE_CUBE_MAP);
 
-    for (auto img: images)
+    // the mipmaps generated before the context was lost
+    if (_mipmapsGenerated)
     {
-        CC_SAFE_RELEASE(img);
+        _mipmapsGenerated = false;
+        generateMipmap();
     }
 
     return true;
 }
 
+void TextureCube::generateMipmap()
+{
+    CCASSERT(_name != 0, __FUNCTION__);
+
+    if (_hasMipmaps)
+        return;
+
+    if (Texture2D::getPixelFormatInfoMap().at(_pixelFormat).compressed || _pixelsWide != ccNextPOT(_pixelsWide) || _pixelsHigh != ccNextPOT(_pixelsHigh))
+    {
+        CCLOG("cocos2d: TextureCube: the mipmaps can only be generated for uncompressed POT faces");
+        return;
+    }
+
+    GL::bindTextureN(0, _name, GL_TEXTURE_CUBE_MAP);
+    glGenerateMipmap(GL_TEXTURE_CUBE_MAP);
+    glTexParameteri(GL_TEXTURE_CUBE_MAP, GL_TEXTURE_MIN_FILTER, GL_LINEAR_MIPMAP_LINEAR);
+    GL::bindTextureN(0, 0, GL_TEXTURE_CUBE_MAP);
+
+    // the mipmap chain adds a third of the base level
+    setGPUMemorySize(_gpuMemorySize + _gpuMemorySize / 3);
+    _hasMipmaps = true;
+    _mipmapsGenerated = true;
+}
+
 void TextureCube::setTexParameters(const TexParams& texParams)
 {
     CCASSERT(_name != 0, __FUNCTION__);
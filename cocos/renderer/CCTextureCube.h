@@ -27,12 +27,15 @@
 
 #include "renderer/CCTexture2D.h"
 
+#include <functional>
 #include <string>
 #include <unordered_map>
 #include "base/ccTypes.h"
 
 NS_CC_BEGIN
 
+class Image;
+
 /**
  * @addtogroup _3d
  * @{
@@ -41,6 +44,9 @@ NS_CC_BEGIN
 /**
  TextureCube is a collection of six separate square textures that are put 
  onto the faces of an imaginary cube.
+
+ The faces can be compressed images, e.g. KTX, KTX2 or PVR files, and their mipmaps are uploaded as they are,
+ so a mip chain prefiltered offline can be sampled for reflections without computing it at runtime.
 */
 class CC_DLL TextureCube: public Texture2D
 {
@@ -58,6 +64,23 @@ public:
                                const std::string& positive_y, const std::string& negative_y,
                                const std::string& positive_z, const std::string& negative_z);
 
+    /** Decodes the 6 faces in parallel with the JobSystem, then creates the texture cube on the cocos thread.
+     * The parameters are the ones of create().
+     *
+     * @param callback Called on the cocos thread with the texture cube, or nullptr if a face can't be loaded.
+     * @since v3.14
+     */
+    static void createAsync(const std::string& positive_x, const std::string& negative_x,
+                            const std::string& positive_y, const std::string& negative_y,
+                            const std::string& positive_z, const std::string& negative_z,
+                            const std::function<void(TextureCube*)>& callback);
+
+    /** Generates the mipmaps of the faces. Only the uncompressed textures with a power of 2 size can generate them,
+     * the compressed ones have the mipmaps of their files.
+     * @since v3.14
+     */
+    void generateMipmap();
+
     /** Sets the min filter, mag filter, wrap s and wrap t texture parameters.
     If the texture size is NPOT (non power of 2), then in can only use GL_CLAMP_TO_EDGE in GL_TEXTURE_WRAP_{S,T}.
     */
@@ -80,8 +103,12 @@ protected:
     bool init(const std::string& positive_x, const std::string& negative_x,
               const std::string& positive_y, const std::string& negative_y,
               const std::string& positive_z, const std::string& negative_z);
+
+    /** Uploads the faces, they must have the same size, format and number of mipmaps.*/
+    bool initWithImages(const std::vector<Image*>& images);
 private:
     std::vector<std::string> _imgPath;
+    bool _mipmapsGenerated;
 };
 
 // end of 3d group
@@ -30,8 +30,14 @@
 #include "renderer/CCRenderer.h"
 #include "renderer/CCTexture2D.h"
 
+#if CC_ENABLE_ALLOCATOR && CC_ENABLE_ENGINE_ALLOCATOR_POOLS
+#include "base/allocator/CCAllocatorStrategyPool.h"
+#endif
+
 NS_CC_BEGIN
 
+CC_DEFINE_ALLOCATOR_POOL(TrianglesCommand, 256)
+
 TrianglesCommand::TrianglesCommand()
 :_materialID(0)
 ,_textureID(0)
@@ -42,6 +42,8 @@ NS_CC_BEGIN
 class CC_DLL TrianglesCommand : public RenderCommand
 {
 public:
+    CC_DECLARE_ALLOCATOR_POOL(TrianglesCommand)
+
     /**The structure of Triangles. */
     struct Triangles
     {
@@ -78,6 +80,8 @@ public:
     uint32_t getMaterialID() const { return _materialID; }
     /**Get the openGL texture handle.*/
     GLuint getTextureID() const { return _textureID; }
+    /**Get the openGL handle of the alpha texture of an ETC1 texture, 0 if none. @since v3.14 */
+    GLuint getAlphaTextureID() const { return _alphaTextureID; }
     /**Get a const reference of triangles.*/
     const Triangles& getTriangles() const { return _triangles; }
     /**Get the vertex count in the triangles.*/
@@ -134,7 +134,7 @@ bool VertexAttribBinding::init(MeshIndexData* meshIndexData, GLProgramState* glP
                                s_attributeNames[meshattribute.vertexAttrib],
                                meshattribute.size,
                                meshattribute.type,
-                               GL_FALSE,
+                               MeshVertexData::isNormalized(meshattribute) ? GL_TRUE : GL_FALSE,
                                meshVertexData->getVertexBuffer()->getSizePerVertex(),
                                (GLvoid*)offset);
         offset += meshattribute.attribSizeBytes;
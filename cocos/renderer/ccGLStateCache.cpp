@@ -53,7 +53,51 @@ namespace
     static GLuint    s_VAO = 0;
     static GLenum    s_activeTexture = -1;
 
+    // fixed function state, -1 when it isn't known
+    enum
+    {
+        CAPABILITY_BLEND,
+        CAPABILITY_DEPTH_TEST,
+        CAPABILITY_CULL_FACE,
+        CAPABILITY_STENCIL_TEST,
+        CAPABILITY_SCISSOR_TEST,
+        CAPABILITY_POLYGON_OFFSET_FILL,
+        CAPABILITY_MAX
+    };
+    static int       s_capabilities[CAPABILITY_MAX] = { -1, -1, -1, -1, -1, -1 };
+    static GLenum    s_depthFunc = -1;
+    static int       s_depthMask = -1;
+    static GLenum    s_cullFace = -1;
+    static GLenum    s_frontFace = -1;
+    static int       s_colorMask = -1;
+    static GLenum    s_stencilFunc = -1;
+    static GLint     s_stencilRef = 0;
+    static GLuint    s_stencilValueMask = 0;
+    static GLenum    s_stencilFail = -1;
+    static GLenum    s_stencilPassDepthFail = -1;
+    static GLenum    s_stencilPassDepthPass = -1;
+    static bool      s_stencilWriteMaskValid = false;
+    static GLuint    s_stencilWriteMask = 0;
+    static GLint     s_viewport[4] = { 0, 0, -1, -1 };
+    static GLint     s_scissor[4] = { 0, 0, -1, -1 };
+
+    static int getCapabilityIndex(GLenum capability)
+    {
+        switch (capability)
+        {
+            case GL_BLEND: return CAPABILITY_BLEND;
+            case GL_DEPTH_TEST: return CAPABILITY_DEPTH_TEST;
+            case GL_CULL_FACE: return CAPABILITY_CULL_FACE;
+            case GL_STENCIL_TEST: return CAPABILITY_STENCIL_TEST;
+            case GL_SCISSOR_TEST: return CAPABILITY_SCISSOR_TEST;
+            case GL_POLYGON_OFFSET_FILL: return CAPABILITY_POLYGON_OFFSET_FILL;
+            default: return -1;
+        }
+    }
+
 #endif // CC_ENABLE_GL_STATE_CACHE
+
+    static unsigned int s_skippedStateCalls = 0;
 }
 
 // GL State Cache functions
@@ -73,10 +117,33 @@ void invalidateStateCache( void )
         s_currentBoundTexture[i] = -1;
     }
 
-    s_blendingSource = -1;
-    s_blendingDest = -1;
     s_GLServerState = 0;
     s_VAO = 0;
+#endif // CC_ENABLE_GL_STATE_CACHE
+
+    invalidateRenderStateCache();
+}
+
+void invalidateRenderStateCache( void )
+{
+#if CC_ENABLE_GL_STATE_CACHE
+    s_blendingSource = -1;
+    s_blendingDest = -1;
+
+    for (int i = 0; i < CAPABILITY_MAX; ++i)
+    {
+        s_capabilities[i] = -1;
+    }
+    s_depthFunc = -1;
+    s_depthMask = -1;
+    s_cullFace = -1;
+    s_frontFace = -1;
+    s_colorMask = -1;
+    s_stencilFunc = -1;
+    s_stencilFail = -1;
+    s_stencilWriteMaskValid = false;
+    s_viewport[2] = s_viewport[3] = -1;
+    s_scissor[2] = s_scissor[3] = -1;
     
 #endif // CC_ENABLE_GL_STATE_CACHE
 }
@@ -100,6 +167,10 @@ void useProgram( GLuint program )
         s_currentShaderProgram = program;
         glUseProgram(program);
     }
+    else
+    {
+        ++s_skippedStateCalls;
+    }
 #else
     glUseProgram(program);
 #endif // CC_ENABLE_GL_STATE_CACHE
@@ -109,12 +180,12 @@ static void SetBlending(GLenum sfactor, GLenum dfactor)
 {
 	if (sfactor == GL_ONE && dfactor == GL_ZERO)
     {
-		glDisable(GL_BLEND);
+		setEnabled(GL_BLEND, false);
         RenderState::StateBlock::_defaultState->setBlend(false);
 	}
     else
     {
-		glEnable(GL_BLEND);
+		setEnabled(GL_BLEND, true);
 		glBlendFunc(sfactor, dfactor);
 
         RenderState::StateBlock::_defaultState->setBlend(true);
@@ -132,6 +203,10 @@ void blendFunc(GLenum sfactor, GLenum dfactor)
         s_blendingDest = dfactor;
         SetBlending(sfactor, dfactor);
     }
+    else
+    {
+        ++s_skippedStateCalls;
+    }
 #else
     SetBlending( sfactor, dfactor );
 #endif // CC_ENABLE_GL_STATE_CACHE
@@ -171,6 +246,10 @@ void bindTexture2DN(GLuint textureUnit, GLuint textureId)
 		activeTexture(GL_TEXTURE0 + textureUnit);
 		glBindTexture(GL_TEXTURE_2D, textureId);
 	}
+    else
+    {
+        ++s_skippedStateCalls;
+    }
 #else
 	glActiveTexture(GL_TEXTURE0 + textureUnit);
 	glBindTexture(GL_TEXTURE_2D, textureId);
@@ -187,6 +266,10 @@ void bindTextureN(GLuint textureUnit, GLuint textureId, GLuint textureType/* = G
         activeTexture(GL_TEXTURE0 + textureUnit);
         glBindTexture(textureType, textureId);
     }
+    else
+    {
+        ++s_skippedStateCalls;
+    }
 #else
     glActiveTexture(GL_TEXTURE0 + textureUnit);
     glBindTexture(textureType, textureId);
@@ -267,6 +350,321 @@ void enableVertexAttribs(uint32_t flags)
     s_attributeFlags = flags;
 }
 
+// GL fixed function state
+
+void setEnabled(GLenum capability, bool enabled)
+{
+#if CC_ENABLE_GL_STATE_CACHE
+    int index = getCapabilityIndex(capability);
+    if (index >= 0)
+    {
+        if (s_capabilities[index] == (int)enabled)
+        {
+            ++s_skippedStateCalls;
+            return;
+        }
+        s_capabilities[index] = enabled;
+    }
+#endif // CC_ENABLE_GL_STATE_CACHE
+
+    if (enabled)
+        glEnable(capability);
+    else
+        glDisable(capability);
+}
+
+bool isEnabled(GLenum capability)
+{
+#if CC_ENABLE_GL_STATE_CACHE
+    int index = getCapabilityIndex(capability);
+    if (index >= 0)
+    {
+        if (s_capabilities[index] < 0)
+            s_capabilities[index] = glIsEnabled(capability) != GL_FALSE;
+        return s_capabilities[index] != 0;
+    }
+#endif // CC_ENABLE_GL_STATE_CACHE
+
+    return glIsEnabled(capability) != GL_FALSE;
+}
+
+void depthFunc(GLenum func)
+{
+#if CC_ENABLE_GL_STATE_CACHE
+    if (s_depthFunc == func)
+    {
+        ++s_skippedStateCalls;
+        return;
+    }
+    s_depthFunc = func;
+#endif // CC_ENABLE_GL_STATE_CACHE
+
+    glDepthFunc(func);
+}
+
+void depthMask(GLboolean flag)
+{
+#if CC_ENABLE_GL_STATE_CACHE
+    int mask = (flag != GL_FALSE);
+    if (s_depthMask == mask)
+    {
+        ++s_skippedStateCalls;
+        return;
+    }
+    s_depthMask = mask;
+#endif // CC_ENABLE_GL_STATE_CACHE
+
+    glDepthMask(flag);
+}
+
+void cullFace(GLenum mode)
+{
+#if CC_ENABLE_GL_STATE_CACHE
+    if (s_cullFace == mode)
+    {
+        ++s_skippedStateCalls;
+        return;
+    }
+    s_cullFace = mode;
+#endif // CC_ENABLE_GL_STATE_CACHE
+
+    glCullFace(mode);
+}
+
+void frontFace(GLenum mode)
+{
+#if CC_ENABLE_GL_STATE_CACHE
+    if (s_frontFace == mode)
+    {
+        ++s_skippedStateCalls;
+        return;
+    }
+    s_frontFace = mode;
+#endif // CC_ENABLE_GL_STATE_CACHE
+
+    glFrontFace(mode);
+}
+
+void colorMask(GLboolean red, GLboolean green, GLboolean blue, GLboolean alpha)
+{
+#if CC_ENABLE_GL_STATE_CACHE
+    int mask = (red != GL_FALSE) | (green != GL_FALSE) << 1 | (blue != GL_FALSE) << 2 | (alpha != GL_FALSE) << 3;
+    if (s_colorMask == mask)
+    {
+        ++s_skippedStateCalls;
+        return;
+    }
+    s_colorMask = mask;
+#endif // CC_ENABLE_GL_STATE_CACHE
+
+    glColorMask(red, green, blue, alpha);
+}
+
+GLenum getDepthFunc()
+{
+#if CC_ENABLE_GL_STATE_CACHE
+    if (s_depthFunc == (GLenum)-1)
+    {
+        GLint func = GL_LESS;
+        glGetIntegerv(GL_DEPTH_FUNC, &func);
+        s_depthFunc = func;
+    }
+    return s_depthFunc;
+#else
+    GLint func = GL_LESS;
+    glGetIntegerv(GL_DEPTH_FUNC, &func);
+    return func;
+#endif // CC_ENABLE_GL_STATE_CACHE
+}
+
+GLboolean getDepthMask()
+{
+#if CC_ENABLE_GL_STATE_CACHE
+    if (s_depthMask < 0)
+    {
+        GLboolean mask = GL_TRUE;
+        glGetBooleanv(GL_DEPTH_WRITEMASK, &mask);
+        s_depthMask = (mask != GL_FALSE);
+    }
+    return s_depthMask ? GL_TRUE : GL_FALSE;
+#else
+    GLboolean mask = GL_TRUE;
+    glGetBooleanv(GL_DEPTH_WRITEMASK, &mask);
+    return mask;
+#endif // CC_ENABLE_GL_STATE_CACHE
+}
+
+void stencilFunc(GLenum func, GLint ref, GLuint mask)
+{
+#if CC_ENABLE_GL_STATE_CACHE
+    if (s_stencilFunc == func && s_stencilRef == ref && s_stencilValueMask == mask)
+    {
+        ++s_skippedStateCalls;
+        return;
+    }
+    s_stencilFunc = func;
+    s_stencilRef = ref;
+    s_stencilValueMask = mask;
+#endif // CC_ENABLE_GL_STATE_CACHE
+
+    glStencilFunc(func, ref, mask);
+}
+
+void stencilOp(GLenum sfail, GLenum dpfail, GLenum dppass)
+{
+#if CC_ENABLE_GL_STATE_CACHE
+    if (s_stencilFail == sfail && s_stencilPassDepthFail == dpfail && s_stencilPassDepthPass == dppass)
+    {
+        ++s_skippedStateCalls;
+        return;
+    }
+    s_stencilFail = sfail;
+    s_stencilPassDepthFail = dpfail;
+    s_stencilPassDepthPass = dppass;
+#endif // CC_ENABLE_GL_STATE_CACHE
+
+    glStencilOp(sfail, dpfail, dppass);
+}
+
+void stencilMask(GLuint mask)
+{
+#if CC_ENABLE_GL_STATE_CACHE
+    if (s_stencilWriteMaskValid && s_stencilWriteMask == mask)
+    {
+        ++s_skippedStateCalls;
+        return;
+    }
+    s_stencilWriteMaskValid = true;
+    s_stencilWriteMask = mask;
+#endif // CC_ENABLE_GL_STATE_CACHE
+
+    glStencilMask(mask);
+}
+
+void getStencilFunc(GLenum* func, GLint* ref, GLuint* mask)
+{
+#if CC_ENABLE_GL_STATE_CACHE
+    if (s_stencilFunc == (GLenum)-1)
+    {
+        glGetIntegerv(GL_STENCIL_FUNC, (GLint *)&s_stencilFunc);
+        glGetIntegerv(GL_STENCIL_REF, &s_stencilRef);
+        glGetIntegerv(GL_STENCIL_VALUE_MASK, (GLint *)&s_stencilValueMask);
+    }
+    *func = s_stencilFunc;
+    *ref = s_stencilRef;
+    *mask = s_stencilValueMask;
+#else
+    glGetIntegerv(GL_STENCIL_FUNC, (GLint *)func);
+    glGetIntegerv(GL_STENCIL_REF, ref);
+    glGetIntegerv(GL_STENCIL_VALUE_MASK, (GLint *)mask);
+#endif // CC_ENABLE_GL_STATE_CACHE
+}
+
+void getStencilOp(GLenum* sfail, GLenum* dpfail, GLenum* dppass)
+{
+#if CC_ENABLE_GL_STATE_CACHE
+    if (s_stencilFail == (GLenum)-1)
+    {
+        glGetIntegerv(GL_STENCIL_FAIL, (GLint *)&s_stencilFail);
+        glGetIntegerv(GL_STENCIL_PASS_DEPTH_FAIL, (GLint *)&s_stencilPassDepthFail);
+        glGetIntegerv(GL_STENCIL_PASS_DEPTH_PASS, (GLint *)&s_stencilPassDepthPass);
+    }
+    *sfail = s_stencilFail;
+    *dpfail = s_stencilPassDepthFail;
+    *dppass = s_stencilPassDepthPass;
+#else
+    glGetIntegerv(GL_STENCIL_FAIL, (GLint *)sfail);
+    glGetIntegerv(GL_STENCIL_PASS_DEPTH_FAIL, (GLint *)dpfail);
+    glGetIntegerv(GL_STENCIL_PASS_DEPTH_PASS, (GLint *)dppass);
+#endif // CC_ENABLE_GL_STATE_CACHE
+}
+
+GLuint getStencilMask()
+{
+#if CC_ENABLE_GL_STATE_CACHE
+    if (!s_stencilWriteMaskValid)
+    {
+        glGetIntegerv(GL_STENCIL_WRITEMASK, (GLint *)&s_stencilWriteMask);
+        s_stencilWriteMaskValid = true;
+    }
+    return s_stencilWriteMask;
+#else
+    GLuint mask = 0;
+    glGetIntegerv(GL_STENCIL_WRITEMASK, (GLint *)&mask);
+    return mask;
+#endif // CC_ENABLE_GL_STATE_CACHE
+}
+
+void viewport(GLint x, GLint y, GLsizei width, GLsizei height)
+{
+#if CC_ENABLE_GL_STATE_CACHE
+    if (s_viewport[0] == x && s_viewport[1] == y && s_viewport[2] == width && s_viewport[3] == height)
+    {
+        ++s_skippedStateCalls;
+        return;
+    }
+    s_viewport[0] = x;
+    s_viewport[1] = y;
+    s_viewport[2] = width;
+    s_viewport[3] = height;
+#endif // CC_ENABLE_GL_STATE_CACHE
+
+    glViewport(x, y, width, height);
+}
+
+void scissor(GLint x, GLint y, GLsizei width, GLsizei height)
+{
+#if CC_ENABLE_GL_STATE_CACHE
+    if (s_scissor[0] == x && s_scissor[1] == y && s_scissor[2] == width && s_scissor[3] == height)
+    {
+        ++s_skippedStateCalls;
+        return;
+    }
+    s_scissor[0] = x;
+    s_scissor[1] = y;
+    s_scissor[2] = width;
+    s_scissor[3] = height;
+#endif // CC_ENABLE_GL_STATE_CACHE
+
+    glScissor(x, y, width, height);
+}
+
+void getViewport(GLint* outViewport)
+{
+#if CC_ENABLE_GL_STATE_CACHE
+    if (s_viewport[2] < 0)
+    {
+        glGetIntegerv(GL_VIEWPORT, s_viewport);
+    }
+    memcpy(outViewport, s_viewport, sizeof(s_viewport));
+#else
+    glGetIntegerv(GL_VIEWPORT, outViewport);
+#endif // CC_ENABLE_GL_STATE_CACHE
+}
+
+void getScissor(GLint* outScissor)
+{
+#if CC_ENABLE_GL_STATE_CACHE
+    if (s_scissor[2] < 0)
+    {
+        glGetIntegerv(GL_SCISSOR_BOX, s_scissor);
+    }
+    memcpy(outScissor, s_scissor, sizeof(s_scissor));
+#else
+    glGetIntegerv(GL_SCISSOR_BOX, outScissor);
+#endif // CC_ENABLE_GL_STATE_CACHE
+}
+
+unsigned int getSkippedStateCalls()
+{
+    return s_skippedStateCalls;
+}
+
+void resetSkippedStateCalls()
+{
+    s_skippedStateCalls = 0;
+}
+
 // GL Uniforms functions
 
 void setProjectionMatrixDirty( void )
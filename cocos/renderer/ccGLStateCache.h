@@ -62,10 +62,19 @@ enum {
  * Invalidates the GL state cache.
  *
  * If CC_ENABLE_GL_STATE_CACHE it will reset the GL state cache.
+ * Call it after changing the GL state without the functions of this file.
  * @since v2.0.0
  */
 void CC_DLL invalidateStateCache(void);
 
+/**
+ * Invalidates the cached capabilities, blend function, depth, culling, color mask, stencil, viewport and scissor states
+ * only, the bound program, textures, VAO and matrices are kept.
+ * Call it after changing these states with raw GL calls, RenderState::StateBlock::invalidate() does.
+ * @since v3.14
+ */
+void CC_DLL invalidateRenderStateCache(void);
+
 /** 
  * Uses the GL program in case program is different than the current one.
 
@@ -182,6 +191,85 @@ void CC_DLL activeTexture(GLenum texture);
  */
 void CC_DLL bindVAO(GLuint vaoId);
 
+/**
+ * Enables or disables a server side capability, if it isn't in that state already.
+ * GL_BLEND, GL_DEPTH_TEST, GL_CULL_FACE, GL_STENCIL_TEST, GL_SCISSOR_TEST and GL_POLYGON_OFFSET_FILL are cached,
+ * the other capabilities are passed to glEnable()/glDisable() directly.
+ *
+ * If CC_ENABLE_GL_STATE_CACHE is disabled, it will call glEnable()/glDisable() directly.
+ * @since v3.14
+ */
+void CC_DLL setEnabled(GLenum capability, bool enabled);
+inline void enable(GLenum capability) { setEnabled(capability, true); }
+inline void disable(GLenum capability) { setEnabled(capability, false); }
+
+/**
+ * Returns whether a capability is enabled, from the cache when it is known instead of calling glIsEnabled().
+ * @since v3.14
+ */
+bool CC_DLL isEnabled(GLenum capability);
+
+/**
+ * Cached glDepthFunc(), glDepthMask(), glCullFace(), glFrontFace() and glColorMask().
+ * The calls that wouldn't change the state are skipped.
+ * @since v3.14
+ */
+void CC_DLL depthFunc(GLenum func);
+void CC_DLL depthMask(GLboolean flag);
+void CC_DLL cullFace(GLenum mode);
+void CC_DLL frontFace(GLenum mode);
+void CC_DLL colorMask(GLboolean red, GLboolean green, GLboolean blue, GLboolean alpha);
+
+/**
+ * Returns the depth function and depth write mask, from the cache when they are known.
+ * @since v3.14
+ */
+GLenum CC_DLL getDepthFunc();
+GLboolean CC_DLL getDepthMask();
+
+/**
+ * Cached glStencilFunc(), glStencilOp() and glStencilMask().
+ * @since v3.14
+ */
+void CC_DLL stencilFunc(GLenum func, GLint ref, GLuint mask);
+void CC_DLL stencilOp(GLenum sfail, GLenum dpfail, GLenum dppass);
+void CC_DLL stencilMask(GLuint mask);
+
+/**
+ * Returns the stencil state, from the cache when it is known.
+ * @since v3.14
+ */
+void CC_DLL getStencilFunc(GLenum* func, GLint* ref, GLuint* mask);
+void CC_DLL getStencilOp(GLenum* sfail, GLenum* dpfail, GLenum* dppass);
+GLuint CC_DLL getStencilMask();
+
+/**
+ * Cached glViewport() and glScissor().
+ * @since v3.14
+ */
+void CC_DLL viewport(GLint x, GLint y, GLsizei width, GLsizei height);
+void CC_DLL scissor(GLint x, GLint y, GLsizei width, GLsizei height);
+
+/**
+ * Returns the viewport as x, y, width, height, from the cache when it is known instead of calling glGetIntegerv().
+ * @since v3.14
+ */
+void CC_DLL getViewport(GLint* outViewport);
+
+/**
+ * Returns the scissor box as x, y, width, height, from the cache when it is known instead of calling glGetIntegerv().
+ * @since v3.14
+ */
+void CC_DLL getScissor(GLint* outScissor);
+
+/**
+ * Returns the number of GL calls skipped by the state cache since the last resetSkippedStateCalls().
+ * The Director resets it every frame and shows it in the stats.
+ * @since v3.14
+ */
+unsigned int CC_DLL getSkippedStateCalls();
+void CC_DLL resetSkippedStateCalls();
+
 // end of support group
 /// @}
 
@@ -23,6 +23,18 @@ attribute vec3 a_normal;
 attribute vec3 a_tangent;
 attribute vec3 a_binormal;
 #endif
+
+// 1 when the normals are quantized by MeshVertexData, octahedral encoded in a_normal.xy
+uniform float u_octahedralNormal;
+
+vec3 getNormal()
+{
+    vec3 n = vec3(a_normal.xy, 1.0 - abs(a_normal.x) - abs(a_normal.y));
+    float t = max(-n.z, 0.0);
+    n.x += n.x >= 0.0 ? -t : t;
+    n.y += n.y >= 0.0 ? -t : t;
+    return mix(a_normal, normalize(n), u_octahedralNormal);
+}
 varying vec2 TextureCoordOut;
 
 #ifdef USE_NORMAL_MAPPING
@@ -53,7 +65,7 @@ void main(void)
     #if ((MAX_DIRECTIONAL_LIGHT_NUM > 0) || (MAX_POINT_LIGHT_NUM > 0) || (MAX_SPOT_LIGHT_NUM > 0))
         vec3 eTangent = normalize(CC_NormalMatrix * a_tangent);
         vec3 eBinormal = normalize(CC_NormalMatrix * a_binormal);
-        vec3 eNormal = normalize(CC_NormalMatrix * a_normal);
+        vec3 eNormal = normalize(CC_NormalMatrix * getNormal());
     #endif
     #if (MAX_DIRECTIONAL_LIGHT_NUM > 0)
         for (int i = 0; i < MAX_DIRECTIONAL_LIGHT_NUM; ++i)
@@ -103,7 +115,7 @@ void main(void)
     #endif
 
     #if ((MAX_DIRECTIONAL_LIGHT_NUM > 0) || (MAX_POINT_LIGHT_NUM > 0) || (MAX_SPOT_LIGHT_NUM > 0))
-        v_normal = CC_NormalMatrix * a_normal;
+        v_normal = CC_NormalMatrix * getNormal();
     #endif
 #endif
 
@@ -143,9 +155,24 @@ attribute vec3 a_tangent;
 attribute vec3 a_binormal;
 #endif
 
+// 1 when the normals are quantized by MeshVertexData, octahedral encoded in a_normal.xy
+uniform float u_octahedralNormal;
+
+vec3 getNormal()
+{
+    vec3 n = vec3(a_normal.xy, 1.0 - abs(a_normal.x) - abs(a_normal.y));
+    float t = max(-n.z, 0.0);
+    n.x += n.x >= 0.0 ? -t : t;
+    n.y += n.y >= 0.0 ? -t : t;
+    return mix(a_normal, normalize(n), u_octahedralNormal);
+}
+
+#ifndef CC_BONE_TEXTURE
 const int SKINNING_JOINT_COUNT = 60;
 // Uniforms
 uniform vec4 u_matrixPalette[SKINNING_JOINT_COUNT * 3];
+#define CC_MATRIX_PALETTE(index) u_matrixPalette[index]
+#endif
 
 // Varyings
 varying vec2 TextureCoordOut;
@@ -176,34 +203,34 @@ void getPositionAndNormal(out vec4 position, out vec3 normal, out vec3 tangent,
     float blendWeight = a_blendWeight[0];
 
     int matrixIndex = int (a_blendIndex[0]) * 3;
-    vec4 matrixPalette1 = u_matrixPalette[matrixIndex] * blendWeight;
-    vec4 matrixPalette2 = u_matrixPalette[matrixIndex + 1] * blendWeight;
-    vec4 matrixPalette3 = u_matrixPalette[matrixIndex + 2] * blendWeight;
+    vec4 matrixPalette1 = CC_MATRIX_PALETTE(matrixIndex) * blendWeight;
+    vec4 matrixPalette2 = CC_MATRIX_PALETTE(matrixIndex + 1) * blendWeight;
+    vec4 matrixPalette3 = CC_MATRIX_PALETTE(matrixIndex + 2) * blendWeight;
 
 
     blendWeight = a_blendWeight[1];
     if (blendWeight > 0.0)
     {
         matrixIndex = int(a_blendIndex[1]) * 3;
-        matrixPalette1 += u_matrixPalette[matrixIndex] * blendWeight;
-        matrixPalette2 += u_matrixPalette[matrixIndex + 1] * blendWeight;
-        matrixPalette3 += u_matrixPalette[matrixIndex + 2] * blendWeight;
+        matrixPalette1 += CC_MATRIX_PALETTE(matrixIndex) * blendWeight;
+        matrixPalette2 += CC_MATRIX_PALETTE(matrixIndex + 1) * blendWeight;
+        matrixPalette3 += CC_MATRIX_PALETTE(matrixIndex + 2) * blendWeight;
 
         blendWeight = a_blendWeight[2];
         if (blendWeight > 0.0)
         {
             matrixIndex = int(a_blendIndex[2]) * 3;
-            matrixPalette1 += u_matrixPalette[matrixIndex] * blendWeight;
-            matrixPalette2 += u_matrixPalette[matrixIndex + 1] * blendWeight;
-            matrixPalette3 += u_matrixPalette[matrixIndex + 2] * blendWeight;
+            matrixPalette1 += CC_MATRIX_PALETTE(matrixIndex) * blendWeight;
+            matrixPalette2 += CC_MATRIX_PALETTE(matrixIndex + 1) * blendWeight;
+            matrixPalette3 += CC_MATRIX_PALETTE(matrixIndex + 2) * blendWeight;
 
             blendWeight = a_blendWeight[3];
             if (blendWeight > 0.0)
             {
                 matrixIndex = int(a_blendIndex[3]) * 3;
-                matrixPalette1 += u_matrixPalette[matrixIndex] * blendWeight;
-                matrixPalette2 += u_matrixPalette[matrixIndex + 1] * blendWeight;
-                matrixPalette3 += u_matrixPalette[matrixIndex + 2] * blendWeight;
+                matrixPalette1 += CC_MATRIX_PALETTE(matrixIndex) * blendWeight;
+                matrixPalette2 += CC_MATRIX_PALETTE(matrixIndex + 1) * blendWeight;
+                matrixPalette3 += CC_MATRIX_PALETTE(matrixIndex + 2) * blendWeight;
             }
         }
     }
@@ -215,7 +242,7 @@ void getPositionAndNormal(out vec4 position, out vec3 normal, out vec3 tangent,
     position.w = p.w;
 
 #if ((MAX_DIRECTIONAL_LIGHT_NUM > 0) || (MAX_POINT_LIGHT_NUM > 0) || (MAX_SPOT_LIGHT_NUM > 0))
-    vec4 n = vec4(a_normal, 0.0);
+    vec4 n = vec4(getNormal(), 0.0);
     normal.x = dot(n, matrixPalette1);
     normal.y = dot(n, matrixPalette2);
     normal.z = dot(n, matrixPalette3);
@@ -22,9 +22,12 @@ attribute vec4 a_blendIndex;
 
 attribute vec2 a_texCoord;
 
+#ifndef CC_BONE_TEXTURE
 const int SKINNING_JOINT_COUNT = 60;
 // Uniforms
 uniform vec4 u_matrixPalette[SKINNING_JOINT_COUNT * 3];
+#define CC_MATRIX_PALETTE(index) u_matrixPalette[index]
+#endif
 
 // Varyings
 varying vec2 TextureCoordOut;
@@ -34,34 +37,34 @@ vec4 getPosition()
     float blendWeight = a_blendWeight[0];
 
     int matrixIndex = int (a_blendIndex[0]) * 3;
-    vec4 matrixPalette1 = u_matrixPalette[matrixIndex] * blendWeight;
-    vec4 matrixPalette2 = u_matrixPalette[matrixIndex + 1] * blendWeight;
-    vec4 matrixPalette3 = u_matrixPalette[matrixIndex + 2] * blendWeight;
+    vec4 matrixPalette1 = CC_MATRIX_PALETTE(matrixIndex) * blendWeight;
+    vec4 matrixPalette2 = CC_MATRIX_PALETTE(matrixIndex + 1) * blendWeight;
+    vec4 matrixPalette3 = CC_MATRIX_PALETTE(matrixIndex + 2) * blendWeight;
     
     
     blendWeight = a_blendWeight[1];
     if (blendWeight > 0.0)
     {
         matrixIndex = int(a_blendIndex[1]) * 3;
-        matrixPalette1 += u_matrixPalette[matrixIndex] * blendWeight;
-        matrixPalette2 += u_matrixPalette[matrixIndex + 1] * blendWeight;
-        matrixPalette3 += u_matrixPalette[matrixIndex + 2] * blendWeight;
+        matrixPalette1 += CC_MATRIX_PALETTE(matrixIndex) * blendWeight;
+        matrixPalette2 += CC_MATRIX_PALETTE(matrixIndex + 1) * blendWeight;
+        matrixPalette3 += CC_MATRIX_PALETTE(matrixIndex + 2) * blendWeight;
         
         blendWeight = a_blendWeight[2];
         if (blendWeight > 0.0)
         {
             matrixIndex = int(a_blendIndex[2]) * 3;
-            matrixPalette1 += u_matrixPalette[matrixIndex] * blendWeight;
-            matrixPalette2 += u_matrixPalette[matrixIndex + 1] * blendWeight;
-            matrixPalette3 += u_matrixPalette[matrixIndex + 2] * blendWeight;
+            matrixPalette1 += CC_MATRIX_PALETTE(matrixIndex) * blendWeight;
+            matrixPalette2 += CC_MATRIX_PALETTE(matrixIndex + 1) * blendWeight;
+            matrixPalette3 += CC_MATRIX_PALETTE(matrixIndex + 2) * blendWeight;
             
             blendWeight = a_blendWeight[3];
             if (blendWeight > 0.0)
             {
                 matrixIndex = int(a_blendIndex[3]) * 3;
-                matrixPalette1 += u_matrixPalette[matrixIndex] * blendWeight;
-                matrixPalette2 += u_matrixPalette[matrixIndex + 1] * blendWeight;
-                matrixPalette3 += u_matrixPalette[matrixIndex + 2] * blendWeight;
+                matrixPalette1 += CC_MATRIX_PALETTE(matrixIndex) * blendWeight;
+                matrixPalette2 += CC_MATRIX_PALETTE(matrixIndex + 1) * blendWeight;
+                matrixPalette3 += CC_MATRIX_PALETTE(matrixIndex + 2) * blendWeight;
             }
         }
     }
@@ -0,0 +1,49 @@
+/*
+ * Copyright (c) 2016 Chukong Technologies Inc.
+ *
+ * Permission is hereby granted, free of charge, to any person obtaining a copy
+ * of this software and associated documentation files (the "Software"), to deal
+ * in the Software without restriction, including without limitation the rights
+ * to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+ * copies of the Software, and to permit persons to whom the Software is
+ * furnished to do so, subject to the following conditions:
+ *
+ * The above copyright notice and this permission notice shall be included in
+ * all copies or substantial portions of the Software.
+ *
+ * THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+ * IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+ * FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+ * AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+ * LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+ * OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+ * THE SOFTWARE.
+ */
+
+const char* ccPositionTextureColorMultiTexture_noMVP_frag = R"(
+#ifdef GL_ES
+precision lowp float;
+varying mediump float v_textureSlot;
+#else
+varying float v_textureSlot;
+#endif
+
+varying vec4 v_fragmentColor;
+varying vec2 v_texCoord;
+
+void main()
+{
+    // samplers can't be indexed dynamically in GLSL ES 1.0
+    vec4 texColor;
+    if (v_textureSlot < 0.5)
+        texColor = texture2D(CC_Texture0, v_texCoord);
+    else if (v_textureSlot < 1.5)
+        texColor = texture2D(CC_Texture1, v_texCoord);
+    else if (v_textureSlot < 2.5)
+        texColor = texture2D(CC_Texture2, v_texCoord);
+    else
+        texColor = texture2D(CC_Texture3, v_texCoord);
+
+    gl_FragColor = v_fragmentColor * texColor;
+}
+)";
@@ -58,6 +58,11 @@ NS_CC_BEGIN
 #include "renderer/ccShader_PositionTextureColor_noMVP.frag"
 #include "renderer/ccShader_PositionTextureColor_noMVP.vert"
 
+//
+#include "renderer/ccShader_PositionTextureColorMultiTexture_noMVP.frag"
+#include "renderer/ccShader_PositionTextureColorMultiTexture_noMVP.vert"
+#include "renderer/ccShader_Overdraw_noMVP.frag"
+
 //
 #include "renderer/ccShader_PositionTextureColorAlphaTest.frag"
 
@@ -67,6 +72,7 @@ NS_CC_BEGIN
 
 #include "renderer/ccShader_PositionColorLengthTexture.frag"
 #include "renderer/ccShader_PositionColorLengthTexture.vert"
+#include "renderer/ccShader_PositionColorLengthTexture_noMVP.vert"
 
 #include "renderer/ccShader_UI_Gray.frag"
 //
@@ -76,6 +76,8 @@
 
 #define BYTE_CODE_FILE_EXT ".jsc"
 
+static const std::string BYTECODE_CACHE_ENGINE = "spidermonkey";
+
 using namespace cocos2d;
 
 static std::string inData;
@@ -94,6 +96,15 @@ static std::unordered_map<void*, js_proxy_t*> _native_js_global_map;
 static std::unordered_map<JSObject*, js_proxy_t*> _js_native_global_map;
 static std::unordered_map<JSObject*, JSObject*> _js_hook_owner_map;
 
+// Removed proxies are kept for reuse: scripts that create and destroy many short lived objects
+// would otherwise allocate and free one proxy per object.
+static std::vector<js_proxy_t*> _js_proxy_pool;
+static size_t _js_proxy_pool_capacity = 1024;
+// counters of the frame being drawn and of the last one
+static JSBBindingStats _js_binding_stats;
+static JSBBindingStats _js_binding_last_frame_stats;
+static EventListenerCustom* _js_binding_stats_listener = nullptr;
+
 static char *_js_log_buf = NULL;
 
 static std::vector<sc_register_sth> registrationList;
@@ -130,6 +141,7 @@ static void executeJSFunctionFromReservedSpot(JSContext *cx, JS::HandleObject ob
     JS::RootedValue thisObj(cx, JS_GetReservedSlot(obj, 1));
     JSAutoCompartment ac(cx, obj);
 
+    ++_js_binding_stats.scriptCalls;
     if (thisObj.isNullOrUndefined()) {
         JS_CallFunctionValue(cx, obj, func, dataVal, retval);
     } else {
@@ -244,6 +256,7 @@ void ScriptingCore::executeJSFunctionWithThisObj(JS::HandleValue thisObj,
         // If it's a NULL pointer, crash will be triggered in 'JS_CallFunctionValue'. To find out the reason of this crash is very difficult.
         // So we have to check the availability of 'retVal'.
         JS::RootedObject jsthis(_cx, thisObj.toObjectOrNull());
+        ++_js_binding_stats.scriptCalls;
         JS_CallFunctionValue(_cx, jsthis, callback, vp, retVal);
     }
 }
@@ -554,6 +567,15 @@ void ScriptingCore::start()
     _engineStartTime = std::chrono::steady_clock::now();
     // for now just this
     createGlobalContext();
+
+    if (_js_binding_stats_listener == nullptr)
+    {
+        jsb_set_proxy_pool_capacity(_js_proxy_pool_capacity);
+        _js_binding_stats_listener = Director::getInstance()->getEventDispatcher()->addCustomEventListener(Director::EVENT_AFTER_DRAW, [](EventCustom*) {
+            _js_binding_last_frame_stats = _js_binding_stats;
+            memset(&_js_binding_stats, 0, sizeof(_js_binding_stats));
+        });
+    }
 }
 
 void ScriptingCore::addRegisterCallback(sc_register_sth callback) {
@@ -574,6 +596,12 @@ void ScriptingCore::removeAllRoots(JSContext *cx)
         it_js = _js_native_global_map.erase(it_js);
     }
     _js_native_global_map.clear();
+
+    for (auto proxy : _js_proxy_pool)
+    {
+        free(proxy);
+    }
+    _js_proxy_pool.clear();
 }
 
 // Just a wrapper around JSPrincipals that allows static construction.
@@ -735,15 +763,53 @@ JS::PersistentRootedScript* ScriptingCore::compileScript(const std::string& path
         op.setFileAndLine(fullPath.c_str(), 1);
 
         bool ok = false;
-#if (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID)
-        std::string jsFileContent = futil->getStringFromFile(fullPath);
-        if (!jsFileContent.empty())
+        auto bytecodeCache = ScriptBytecodeCache::getInstance();
+        if (bytecodeCache->isEnabled())
         {
-            ok = JS::Compile(cx, obj, op, jsFileContent.c_str(), jsFileContent.size(), &(*script));
+            // the XDR bytecode of the sources compiled by the previous launches
+            Data source = futil->getDataFromFile(fullPath);
+            if (!source.isNull())
+            {
+                Data bytecode = bytecodeCache->getBytecode(BYTECODE_CACHE_ENGINE, source.getBytes(), source.getSize());
+                if (!bytecode.isNull())
+                {
+                    *script = JS_DecodeScript(cx, bytecode.getBytes(), static_cast<uint32_t>(bytecode.getSize()), nullptr);
+                    ok = *script != nullptr;
+                    if (!ok)
+                    {
+                        ReportException(cx);
+                    }
+                }
+
+                if (!ok)
+                {
+                    ok = JS::Compile(cx, obj, op, (const char*)source.getBytes(), (size_t)source.getSize(), &(*script));
+                    if (ok)
+                    {
+                        uint32_t length = 0;
+                        void* encoded = JS_EncodeScript(cx, *script, &length);
+                        if (encoded)
+                        {
+                            bytecode.copy((const unsigned char*)encoded, length);
+                            bytecodeCache->setBytecode(BYTECODE_CACHE_ENGINE, source.getBytes(), source.getSize(), bytecode);
+                            js_free(encoded);
+                        }
+                    }
+                }
+            }
         }
+        else
+        {
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID)
+            std::string jsFileContent = futil->getStringFromFile(fullPath);
+            if (!jsFileContent.empty())
+            {
+                ok = JS::Compile(cx, obj, op, jsFileContent.c_str(), jsFileContent.size(), &(*script));
+            }
 #else
-        ok = JS::Compile(cx, obj, op, fullPath.c_str(), &(*script));
+            ok = JS::Compile(cx, obj, op, fullPath.c_str(), &(*script));
 #endif
+        }
         if (ok) {
             compileSucceed = true;
             filename_script[fullPath] = script;
@@ -1561,6 +1627,7 @@ bool ScriptingCore::executeFunctionWithOwner(jsval owner, const char *name, cons
                 break;
             }
 
+            ++_js_binding_stats.scriptCalls;
             bRet = JS_CallFunctionValue(cx, obj, funcVal, args, retVal);
         }
     }while(0);
@@ -2165,6 +2232,56 @@ bool jsb_get_reserved_slot(JSObject *obj, uint32_t idx, jsval& ret)
     return true;
 }
 
+static js_proxy_t* jsb_alloc_proxy()
+{
+    js_proxy_t* proxy = nullptr;
+    if (!_js_proxy_pool.empty())
+    {
+        proxy = _js_proxy_pool.back();
+        _js_proxy_pool.pop_back();
+        ++_js_binding_stats.proxiesReused;
+    }
+    else
+    {
+        proxy = (js_proxy_t *)malloc(sizeof(js_proxy_t));
+        CC_ASSERT(proxy && "not enough memory");
+    }
+    // the memory still holds the object of the previous proxy, which must not go through the write barrier
+    new (&proxy->obj) JS::Heap<JSObject*>();
+    return proxy;
+}
+
+static void jsb_free_proxy(js_proxy_t* proxy)
+{
+    if (_js_proxy_pool.size() < _js_proxy_pool_capacity)
+    {
+        _js_proxy_pool.push_back(proxy);
+    }
+    else
+    {
+        free(proxy);
+    }
+}
+
+const JSBBindingStats& jsb_get_binding_stats()
+{
+    return _js_binding_last_frame_stats;
+}
+
+void jsb_set_proxy_pool_capacity(size_t capacity)
+{
+    _js_proxy_pool_capacity = capacity;
+    _js_proxy_pool.reserve(capacity);
+    while (_js_proxy_pool.size() > capacity)
+    {
+        free(_js_proxy_pool.back());
+        _js_proxy_pool.pop_back();
+    }
+    // reserving the buckets up front avoids rehashing while objects come and go
+    _native_js_global_map.reserve(capacity);
+    _js_native_global_map.reserve(capacity);
+}
+
 js_proxy_t* jsb_new_proxy(void* nativeObj, JS::HandleObject jsHandle)
 {
     js_proxy_t* proxy = nullptr;
@@ -2173,8 +2290,7 @@ js_proxy_t* jsb_new_proxy(void* nativeObj, JS::HandleObject jsHandle)
     if (nativeObj && jsObj)
     {
         // native to JS index
-        proxy = (js_proxy_t *)malloc(sizeof(js_proxy_t));
-        CC_ASSERT(proxy && "not enough memory");
+        proxy = jsb_alloc_proxy();
 
 #if 0
         if (_js_native_global_map.find(jsObj) != _js_native_global_map.end())
@@ -2204,6 +2320,7 @@ js_proxy_t* jsb_new_proxy(void* nativeObj, JS::HandleObject jsHandle)
         // One Proxy in two entries
         _native_js_global_map[nativeObj] = proxy;
         _js_native_global_map[jsObj] = proxy;
+        ++_js_binding_stats.proxiesCreated;
     }
     else CCLOG("jsb_new_proxy: Invalid keys");
 
@@ -2212,6 +2329,7 @@ js_proxy_t* jsb_new_proxy(void* nativeObj, JS::HandleObject jsHandle)
 
 js_proxy_t* jsb_get_native_proxy(void* nativeObj)
 {
+    ++_js_binding_stats.proxyLookups;
     auto search = _native_js_global_map.find(nativeObj);
     if(search != _native_js_global_map.end())
         return search->second;
@@ -2220,6 +2338,7 @@ js_proxy_t* jsb_get_native_proxy(void* nativeObj)
 
 js_proxy_t* jsb_get_js_proxy(JS::HandleObject jsObj)
 {
+    ++_js_binding_stats.proxyLookups;
     auto search = _js_native_global_map.find(jsObj);
     if(search != _js_native_global_map.end())
         return search->second;
@@ -2252,8 +2371,9 @@ void jsb_remove_proxy(js_proxy_t* proxy)
     if (it_js != _js_native_global_map.end())
     {
         // Free it once, since we only have one proxy alloced entry
-        free(it_js->second);
+        jsb_free_proxy(it_js->second);
         _js_native_global_map.erase(it_js);
+        ++_js_binding_stats.proxiesRemoved;
     }
     else CCLOG("jsb_remove_proxy: failed. JS key not found");
 }
@@ -614,6 +614,29 @@ js_proxy_t* jsb_get_js_proxy(JS::HandleObject jsObj);
 void jsb_remove_proxy(js_proxy_t* nativeProxy, js_proxy_t* jsProxy);
 /** removes both the native and js proxies */
 void jsb_remove_proxy(js_proxy_t* proxy);
+
+/**
+ * Counters of the crossings between native code and JS during one frame.
+ * @since v3.14
+ */
+struct JSBBindingStats
+{
+    /** native objects that got a new JS object */
+    uint32_t proxiesCreated;
+    /** proxies removed, usually by the finalizer of their JS object */
+    uint32_t proxiesRemoved;
+    /** proxies taken from the pool instead of being allocated */
+    uint32_t proxiesReused;
+    /** native to JS and JS to native proxy lookups */
+    uint32_t proxyLookups;
+    /** JS functions called from native code: callbacks, events and overridden methods */
+    uint32_t scriptCalls;
+};
+
+/** returns the counters of the last frame drawn */
+const JSBBindingStats& jsb_get_binding_stats();
+/** sets how many removed proxies are kept for reuse, the proxy maps are also reserved for that many objects */
+void jsb_set_proxy_pool_capacity(size_t capacity);
 /** removes the native js object proxy and unroot the js object (if necessary), 
  it's often used when JS object is created by native object */
 void removeJSObject(JSContext* cx, cocos2d::Ref* nativeObj);
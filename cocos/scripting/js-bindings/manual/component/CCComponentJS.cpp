@@ -22,10 +22,13 @@
  THE SOFTWARE.
  ****************************************************************************/
 
+#include <algorithm>
+
 #include "jsapi.h"
 #include "mozilla/Maybe.h"
 #include "scripting/js-bindings/manual/component/CCComponentJS.h"
 #include "base/CCScriptSupport.h"
+#include "2d/CCComponentSystem.h"
 #include "scripting/js-bindings/manual/ScriptingCore.h"
 #include "scripting/js-bindings/manual/cocos2d_specifics.hpp"
 #include "scripting/js-bindings/manual/js_manual_conversions.h"
@@ -35,6 +38,7 @@ NS_CC_BEGIN
 const std::string ComponentJS::ON_ENTER = "onEnter";
 const std::string ComponentJS::ON_EXIT = "onExit";
 const std::string ComponentJS::UPDATE = "update";
+const std::string ComponentJS::UPDATE_ALL = "updateAll";
 
 ComponentJS* ComponentJS::create(const std::string& scriptFileName)
 {
@@ -90,6 +94,65 @@ ComponentJS::ComponentJS(const std::string& scriptFileName)
         
         _jsObj = jsObj;
     }
+
+    setUpdateType(_scriptFileName);
+}
+
+void ComponentJS::registerBatchUpdate(const std::string& scriptFileName, int priority)
+{
+    ComponentSystem::getInstance()->registerType(scriptFileName, &ComponentJS::updateAll, priority);
+}
+
+void ComponentJS::unregisterBatchUpdate(const std::string& scriptFileName)
+{
+    ComponentSystem::getInstance()->unregisterType(scriptFileName);
+}
+
+void ComponentJS::updateAll(const std::vector<Component*>& components, float delta)
+{
+    // the components of a type share a class, the "updateAll" method of the first one is used
+    auto first = std::find_if(components.begin(), components.end(), [](Component* component) {
+        return component && static_cast<ComponentJS*>(component)->_succeedLoadingScript;
+    });
+    if (first == components.end())
+        return;
+
+    ScriptingCore* engine = ScriptingCore::getInstance();
+    JSContext* cx = engine->getGlobalContext();
+    JS::RootedObject owner(cx, (JSObject*)static_cast<ComponentJS*>(*first)->getScriptObject());
+    JSAutoCompartment ac(cx, owner);
+
+    bool hasUpdateAll = false;
+    if (!JS_HasProperty(cx, owner, ComponentJS::UPDATE_ALL.c_str(), &hasUpdateAll) || !hasUpdateAll)
+    {
+        for (auto component : components)
+        {
+            if (component)
+            {
+                component->update(delta);
+            }
+        }
+        return;
+    }
+
+    JS::RootedObject array(cx, JS_NewArrayObject(cx, 0));
+    uint32_t count = 0;
+    for (auto component : components)
+    {
+        auto componentJS = static_cast<ComponentJS*>(component);
+        if (componentJS && componentJS->_succeedLoadingScript)
+        {
+            JS::RootedValue element(cx, OBJECT_TO_JSVAL((JSObject*)componentJS->getScriptObject()));
+            JS_SetElement(cx, array, count++, element);
+        }
+    }
+
+    jsval args[2] = {
+        OBJECT_TO_JSVAL(array),
+        DOUBLE_TO_JSVAL(delta)
+    };
+    JS::RootedValue retval(cx);
+    engine->executeFunctionWithOwner(OBJECT_TO_JSVAL(owner), ComponentJS::UPDATE_ALL.c_str(), 2, args, &retval);
 }
 
 ComponentJS::~ComponentJS()
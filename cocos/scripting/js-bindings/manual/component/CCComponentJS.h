@@ -25,6 +25,7 @@
 #pragma once
 
 #include <string>
+#include <vector>
 #include "2d/CCComponent.h"
 
 NS_CC_BEGIN
@@ -33,6 +34,16 @@ class ComponentJS : public Component
 {
 public:
     static ComponentJS* create(const std::string& scriptFileName);
+
+    /**
+     * Updates the components of a script together, with ComponentSystem. If the component class of the script has
+     * an "updateAll" method, it's called once per frame on the first component with an array of the components and
+     * the delta time, otherwise "update" is called on each component.
+     * @since v3.14
+     */
+    static void registerBatchUpdate(const std::string& scriptFileName, int priority = 0);
+    /** The components of a script are updated one by one by their owners again. @since v3.14 */
+    static void unregisterBatchUpdate(const std::string& scriptFileName);
     
     ComponentJS(const std::string& scriptFileName);
     ~ComponentJS();
@@ -47,6 +58,8 @@ public:
     virtual void onExit();
     
 private:
+    static void updateAll(const std::vector<Component*>& components, float delta);
+
     // Script file path
     std::string _scriptFileName;
     
@@ -58,6 +71,7 @@ private:
     static const std::string ON_ENTER;
     static const std::string ON_EXIT;
     static const std::string UPDATE;
+    static const std::string UPDATE_ALL;
 };
 
 NS_CC_END
@@ -84,4 +84,26 @@ bool JSB_localStorageClear(JSContext *cx, uint32_t argc, jsval *vp) {
     return true;
 }
 
+// Arguments: none
+// Ret value: void
+bool JSB_localStorageBeginBatch(JSContext *cx, uint32_t argc, jsval *vp) {
+    JSB_PRECONDITION2( argc == 0, cx, false, "Invalid number of arguments" );
+    JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+
+    localStorageBeginBatch();
+    args.rval().setUndefined();
+    return true;
+}
+
+// Arguments: none
+// Ret value: void
+bool JSB_localStorageCommitBatch(JSContext *cx, uint32_t argc, jsval *vp) {
+    JSB_PRECONDITION2( argc == 0, cx, false, "Invalid number of arguments" );
+    JS::CallArgs args = JS::CallArgsFromVp(argc, vp);
+
+    localStorageCommitBatch();
+    args.rval().setUndefined();
+    return true;
+}
+
 //#endif // JSB_INCLUDE_SYSTEM
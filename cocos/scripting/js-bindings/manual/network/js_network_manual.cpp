@@ -46,6 +46,10 @@ bool jsval_to_DownloaderHints(JSContext *cx, JS::HandleValue v, cocos2d::network
     ret->countOfMaxProcessingTasks = (uint32_t)countOfMaxProcessingTasks;
     ret->timeoutInSeconds = (uint32_t)timeoutInSeconds;
     ret->tempFileNameSuffix = tempFileNameSuffix;
+    ret->countOfSegmentsPerTask = 0;
+    ret->countOfSegmentRetries = 0;
+    ret->minSizeOfSegmentedFile = 0;
+    ret->maxBytesPerSecond = 0;
     return true;
 }
 
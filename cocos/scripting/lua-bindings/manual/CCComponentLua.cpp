@@ -23,8 +23,10 @@
  ****************************************************************************/
 
 #include "scripting/lua-bindings/manual/CCComponentLua.h"
+#include <algorithm>
 #include <string>
 #include "base/CCScriptSupport.h"
+#include "2d/CCComponentSystem.h"
 #include "platform/CCFileUtils.h"
 #include "scripting/lua-bindings/manual/CCLuaEngine.h"
 #include "scripting/lua-bindings/manual/LuaBasicConversions.h"
@@ -34,6 +36,7 @@ NS_CC_BEGIN
 const std::string ComponentLua::ON_ENTER = "onEnter";
 const std::string ComponentLua::ON_EXIT = "onExit";
 const std::string ComponentLua::UPDATE = "update";
+const std::string ComponentLua::UPDATE_ALL = "updateAll";
 
 #define KEY_COMPONENT  "component"
 
@@ -82,6 +85,58 @@ ComponentLua::ComponentLua(const std::string& scriptFileName)
 , _strIndex("")
 {
     _succeedLoadingScript = loadAndExecuteScript();
+    setUpdateType(_scriptFileName);
+}
+
+void ComponentLua::registerBatchUpdate(const std::string& scriptFileName, int priority)
+{
+    std::string fileName(scriptFileName);
+    adjustScriptFileName(fileName);
+    ComponentSystem::getInstance()->registerType(fileName, &ComponentLua::updateAll, priority);
+}
+
+void ComponentLua::unregisterBatchUpdate(const std::string& scriptFileName)
+{
+    std::string fileName(scriptFileName);
+    adjustScriptFileName(fileName);
+    ComponentSystem::getInstance()->unregisterType(fileName);
+}
+
+void ComponentLua::updateAll(const std::vector<Component*>& components, float delta)
+{
+    // the components of a type share a script, the "updateAll" function of the first one is used
+    auto first = std::find_if(components.begin(), components.end(), [](Component* component) {
+        return component && static_cast<ComponentLua*>(component)->_succeedLoadingScript;
+    });
+    if (first == components.end())
+        return;
+
+    if (!static_cast<ComponentLua*>(*first)->getLuaFunction(ComponentLua::UPDATE_ALL))
+    {
+        lua_pop(LuaEngine::getInstance()->getLuaStack()->getLuaState(), 1);
+        for (auto component : components)
+        {
+            if (component)
+            {
+                component->update(delta);
+            }
+        }
+        return;
+    }
+
+    lua_State *l = LuaEngine::getInstance()->getLuaStack()->getLuaState();
+    lua_newtable(l);                               // stack: updateAll components
+    int count = 0;
+    for (auto component : components)
+    {
+        if (component)
+        {
+            static_cast<ComponentLua*>(component)->getUserData();  // stack: updateAll components userdata
+            lua_rawseti(l, -2, ++count);           // stack: updateAll components
+        }
+    }
+    lua_pushnumber(l, delta);                      // stack: updateAll components delta
+    LuaEngine::getInstance()->getLuaStack()->executeFunction(2);
 }
 
 ComponentLua::~ComponentLua()
@@ -26,6 +26,7 @@
 
 #include <string>
 #include <unordered_map>
+#include <vector>
 #include "2d/CCComponent.h"
 
 NS_CC_BEGIN
@@ -34,6 +35,16 @@ class ComponentLua : public Component
 {
 public:
     static ComponentLua* create(const std::string& scriptFileName);
+
+    /**
+     * Updates the components of a script together, with ComponentSystem. If the table returned by the script has
+     * an "updateAll" function, it's called once per frame with an array of the components and the delta time,
+     * otherwise "update" is called on each component.
+     * @since v3.14
+     */
+    static void registerBatchUpdate(const std::string& scriptFileName, int priority = 0);
+    /** The components of a script are updated one by one by their owners again. @since v3.14 */
+    static void unregisterBatchUpdate(const std::string& scriptFileName);
     
     ComponentLua(const std::string& scriptFileName);
     /**
@@ -55,6 +66,7 @@ private:
     void removeLuaTable();
     
     static void initClass();
+    static void updateAll(const std::vector<Component*>& components, float delta);
     
 private:
     // Script file path
@@ -73,6 +85,7 @@ private:
     static const std::string ON_ENTER;
     static const std::string ON_EXIT;
     static const std::string UPDATE;
+    static const std::string UPDATE_ALL;
 };
 
 NS_CC_END
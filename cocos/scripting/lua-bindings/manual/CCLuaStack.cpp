@@ -55,6 +55,7 @@ extern "C" {
 #include "scripting/lua-bindings/auto/lua_cocos2dx_experimental_auto.hpp"
 #include "scripting/lua-bindings/manual/cocos2d/lua_cocos2dx_experimental_manual.hpp"
 #include "base/ZipUtils.h"
+#include "base/CCScriptBytecodeCache.h"
 #include "deprecated/CCBool.h"
 #include "deprecated/CCDouble.h"
 #include "platform/CCFileUtils.h"
@@ -859,6 +860,47 @@ void skipBOM(const char*& chunk, int& chunkSize)
     }
 }
 
+int writeBytecode(lua_State* /*L*/, const void* bytes, size_t size, void* bytecode)
+{
+    static_cast<std::string*>(bytecode)->append(static_cast<const char*>(bytes), size);
+    return 0;
+}
+
+int loadBufferWithCache(lua_State* L, const char* chunk, int chunkSize, const char* chunkName)
+{
+    // the chunks already compiled start with the signature of the bytecode, e.g. the .luac files
+    auto cache = ScriptBytecodeCache::getInstance();
+    if (!cache->isEnabled() || chunkSize <= 0 || chunk[0] == LUA_SIGNATURE[0])
+    {
+        return luaL_loadbuffer(L, chunk, chunkSize, chunkName);
+    }
+
+    static const std::string ENGINE = "lua";
+    auto source = reinterpret_cast<const unsigned char*>(chunk);
+    Data bytecode = cache->getBytecode(ENGINE, source, chunkSize);
+    if (!bytecode.isNull())
+    {
+        if (luaL_loadbuffer(L, (const char*)bytecode.getBytes(), (size_t)bytecode.getSize(), chunkName) == 0)
+        {
+            return 0;
+        }
+        // e.g. written by Lua when the game now runs LuaJIT, compiled again below
+        lua_pop(L, 1);
+    }
+
+    int r = luaL_loadbuffer(L, chunk, chunkSize, chunkName);
+    if (r == 0)
+    {
+        std::string dumped;
+        if (lua_dump(L, writeBytecode, &dumped) == 0 && !dumped.empty())
+        {
+            bytecode.copy((const unsigned char*)dumped.data(), (ssize_t)dumped.size());
+            cache->setBytecode(ENGINE, source, chunkSize, bytecode);
+        }
+    }
+    return r;
+}
+
 } // end anonymous namespace
 
 int LuaStack::luaLoadBuffer(lua_State *L, const char *chunk, int chunkSize, const char *chunkName)
@@ -883,7 +925,7 @@ int LuaStack::luaLoadBuffer(lua_State *L, const char *chunk, int chunkSize, cons
     else
     {
         skipBOM(chunk, chunkSize);
-        r = luaL_loadbuffer(L, chunk, chunkSize, chunkName);
+        r = loadBufferWithCache(L, chunk, chunkSize, chunkName);
     }
 
 #if defined(COCOS2D_DEBUG) && COCOS2D_DEBUG > 0
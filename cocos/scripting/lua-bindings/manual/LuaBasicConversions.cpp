@@ -32,6 +32,17 @@
 
 std::unordered_map<std::string, std::string>  g_luaType;
 std::unordered_map<std::string, std::string>  g_typeCast;
+bool (*g_luaTypeMissHandler)() = nullptr;
+
+std::unordered_map<std::string, std::string>::const_iterator findLuaType(const std::string& typeName)
+{
+    auto iter = g_luaType.find(typeName);
+    if (g_luaType.end() == iter && nullptr != g_luaTypeMissHandler && g_luaTypeMissHandler())
+    {
+        iter = g_luaType.find(typeName);
+    }
+    return iter;
+}
 
 #if COCOS2D_DEBUG >=1
 void luaval_to_native_err(lua_State* L,const char* msg,tolua_Error* err, const char* funcName)
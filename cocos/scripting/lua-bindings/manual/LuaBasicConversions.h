@@ -54,6 +54,19 @@ using namespace cocos2d;
 extern std::unordered_map<std::string, std::string>  g_luaType;
 extern std::unordered_map<std::string, std::string>  g_typeCast;
 
+/**
+ * Called when a native type isn't in g_luaType, e.g. by lua_module_register_lazy() to register the modules not
+ * used yet. Returns whether it registered new types.
+ * @since v3.14
+ */
+extern bool (*g_luaTypeMissHandler)();
+
+/**
+ * Finds the Lua type of a native type, g_luaType.end() if it isn't bound.
+ * @since v3.14
+ */
+std::unordered_map<std::string, std::string>::const_iterator findLuaType(const std::string& typeName);
+
 #if COCOS2D_DEBUG >=1
 void luaval_to_native_err(lua_State* L,const char* msg,tolua_Error* err, const char* funcName = "");
 #endif
@@ -1077,7 +1090,7 @@ void ccvector_to_luaval(lua_State* L,const cocos2d::Vector<T>& inValue)
         if (nullptr != dynamic_cast<cocos2d::Ref *>(obj))
         {
             std::string typeName = typeid(*obj).name();
-            auto iter = g_luaType.find(typeName);
+            auto iter = findLuaType(typeName);
             if (g_luaType.end() != iter)
             {
                 lua_pushnumber(L, (lua_Number)indexTable);
@@ -1114,7 +1127,7 @@ void ccmap_string_key_to_luaval(lua_State* L, const cocos2d::Map<std::string, T>
         if (nullptr != dynamic_cast<cocos2d::Ref *>(obj))
         {
             std::string name = typeid(*obj).name();
-            auto typeIter = g_luaType.find(name);
+            auto typeIter = findLuaType(name);
             if (g_luaType.end() != typeIter)
             {
                 lua_pushstring(L, key.c_str());
@@ -1186,7 +1199,7 @@ const char* getLuaTypeName(T* ret,const char* type)
     if (nullptr != ret)
     {
         std::string hashName = typeid(*ret).name();
-        auto iter =  g_luaType.find(hashName);
+        auto iter =  findLuaType(hashName);
         if(g_luaType.end() != iter)
         {
             return iter->second.c_str();
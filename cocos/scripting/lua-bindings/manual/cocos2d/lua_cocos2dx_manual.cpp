@@ -4884,6 +4884,547 @@ static void extendMenu(lua_State* tolua_S)
     lua_pop(tolua_S, 1);
 }
 
+// MARK: fast path bindings
+//
+// Hand written bindings for the hottest Node, Sprite and Action APIs. The keys of the table fields are
+// interned once and passed as upvalues, and the type checks only exist in debug builds, like the
+// generated bindings.
+
+enum FastPathUpvalue
+{
+    FAST_PATH_KEY_X = 1,
+    FAST_PATH_KEY_Y,
+    FAST_PATH_KEY_Z,
+    FAST_PATH_KEY_R,
+    FAST_PATH_KEY_G,
+    FAST_PATH_KEY_B,
+    FAST_PATH_UPVALUE_COUNT = FAST_PATH_KEY_B
+};
+
+static void fastPathPushFunction(lua_State* tolua_S, const char* name, lua_CFunction func)
+{
+    lua_pushstring(tolua_S, name);
+    lua_pushstring(tolua_S, "x");
+    lua_pushstring(tolua_S, "y");
+    lua_pushstring(tolua_S, "z");
+    lua_pushstring(tolua_S, "r");
+    lua_pushstring(tolua_S, "g");
+    lua_pushstring(tolua_S, "b");
+    lua_pushcclosure(tolua_S, func, FAST_PATH_UPVALUE_COUNT);
+    lua_rawset(tolua_S, -3);
+}
+
+static float fastPathGetField(lua_State* tolua_S, int lo, int keyUpvalue)
+{
+    lua_pushvalue(tolua_S, lua_upvalueindex(keyUpvalue));
+    lua_gettable(tolua_S, lo);
+    float value = (float)lua_tonumber(tolua_S, -1);
+    lua_pop(tolua_S, 1);
+    return value;
+}
+
+static bool fastPathHasField(lua_State* tolua_S, int lo, int keyUpvalue)
+{
+    lua_pushvalue(tolua_S, lua_upvalueindex(keyUpvalue));
+    lua_gettable(tolua_S, lo);
+    bool exists = !lua_isnil(tolua_S, -1);
+    lua_pop(tolua_S, 1);
+    return exists;
+}
+
+template <typename T>
+static T* fastPathToSelf(lua_State* tolua_S, const char* type, const char* funcName)
+{
+#if COCOS2D_DEBUG >= 1
+    tolua_Error tolua_err;
+    if (!tolua_isusertype(tolua_S, 1, type, 0, &tolua_err))
+    {
+        tolua_error(tolua_S, funcName, &tolua_err);
+        return nullptr;
+    }
+    T* self = static_cast<T*>(tolua_tousertype(tolua_S, 1, 0));
+    if (nullptr == self)
+    {
+        tolua_error(tolua_S, funcName, nullptr);
+    }
+    return self;
+#else
+    return static_cast<T*>(tolua_tousertype(tolua_S, 1, 0));
+#endif
+}
+
+static bool fastPathCheckArgs(lua_State* tolua_S, int argc, int expected, const char* funcName)
+{
+    if (argc != expected)
+    {
+        luaL_error(tolua_S, "%s has wrong number of arguments: %d, was expecting %d\n", funcName, argc, expected);
+        return false;
+    }
+    return true;
+}
+
+static void fastPathCheckNumber(lua_State* tolua_S, int lo, const char* funcName)
+{
+#if COCOS2D_DEBUG >= 1
+    tolua_Error tolua_err;
+    if (!tolua_isnumber(tolua_S, lo, 0, &tolua_err))
+    {
+        tolua_error(tolua_S, funcName, &tolua_err);
+    }
+#endif
+}
+
+static void fastPathCheckTable(lua_State* tolua_S, int lo, const char* funcName)
+{
+#if COCOS2D_DEBUG >= 1
+    tolua_Error tolua_err;
+    if (!tolua_istable(tolua_S, lo, 0, &tolua_err))
+    {
+        tolua_error(tolua_S, funcName, &tolua_err);
+    }
+#endif
+}
+
+static int lua_cocos2dx_Node_setPosition_fast(lua_State* tolua_S)
+{
+    static const char* funcName = "#ferror in function 'cc.Node:setPosition'";
+    Node* self = fastPathToSelf<Node>(tolua_S, "cc.Node", funcName);
+    int argc = lua_gettop(tolua_S) - 1;
+    if (argc == 2)
+    {
+        fastPathCheckNumber(tolua_S, 2, funcName);
+        fastPathCheckNumber(tolua_S, 3, funcName);
+        self->setPosition((float)lua_tonumber(tolua_S, 2), (float)lua_tonumber(tolua_S, 3));
+    }
+    else if (fastPathCheckArgs(tolua_S, argc, 1, "cc.Node:setPosition"))
+    {
+        fastPathCheckTable(tolua_S, 2, funcName);
+        self->setPosition(fastPathGetField(tolua_S, 2, FAST_PATH_KEY_X), fastPathGetField(tolua_S, 2, FAST_PATH_KEY_Y));
+    }
+    lua_settop(tolua_S, 1);
+    return 1;
+}
+
+static int lua_cocos2dx_Node_setPositionX_fast(lua_State* tolua_S)
+{
+    static const char* funcName = "#ferror in function 'cc.Node:setPositionX'";
+    Node* self = fastPathToSelf<Node>(tolua_S, "cc.Node", funcName);
+    fastPathCheckArgs(tolua_S, lua_gettop(tolua_S) - 1, 1, "cc.Node:setPositionX");
+    fastPathCheckNumber(tolua_S, 2, funcName);
+    self->setPositionX((float)lua_tonumber(tolua_S, 2));
+    lua_settop(tolua_S, 1);
+    return 1;
+}
+
+static int lua_cocos2dx_Node_setPositionY_fast(lua_State* tolua_S)
+{
+    static const char* funcName = "#ferror in function 'cc.Node:setPositionY'";
+    Node* self = fastPathToSelf<Node>(tolua_S, "cc.Node", funcName);
+    fastPathCheckArgs(tolua_S, lua_gettop(tolua_S) - 1, 1, "cc.Node:setPositionY");
+    fastPathCheckNumber(tolua_S, 2, funcName);
+    self->setPositionY((float)lua_tonumber(tolua_S, 2));
+    lua_settop(tolua_S, 1);
+    return 1;
+}
+
+static int lua_cocos2dx_Node_setRotation_fast(lua_State* tolua_S)
+{
+    static const char* funcName = "#ferror in function 'cc.Node:setRotation'";
+    Node* self = fastPathToSelf<Node>(tolua_S, "cc.Node", funcName);
+    fastPathCheckArgs(tolua_S, lua_gettop(tolua_S) - 1, 1, "cc.Node:setRotation");
+    fastPathCheckNumber(tolua_S, 2, funcName);
+    self->setRotation((float)lua_tonumber(tolua_S, 2));
+    lua_settop(tolua_S, 1);
+    return 1;
+}
+
+static int lua_cocos2dx_Node_setScale_fast(lua_State* tolua_S)
+{
+    static const char* funcName = "#ferror in function 'cc.Node:setScale'";
+    Node* self = fastPathToSelf<Node>(tolua_S, "cc.Node", funcName);
+    int argc = lua_gettop(tolua_S) - 1;
+    if (argc == 2)
+    {
+        fastPathCheckNumber(tolua_S, 2, funcName);
+        fastPathCheckNumber(tolua_S, 3, funcName);
+        self->setScale((float)lua_tonumber(tolua_S, 2), (float)lua_tonumber(tolua_S, 3));
+    }
+    else if (fastPathCheckArgs(tolua_S, argc, 1, "cc.Node:setScale"))
+    {
+        fastPathCheckNumber(tolua_S, 2, funcName);
+        self->setScale((float)lua_tonumber(tolua_S, 2));
+    }
+    lua_settop(tolua_S, 1);
+    return 1;
+}
+
+static int lua_cocos2dx_Node_setVisible_fast(lua_State* tolua_S)
+{
+    static const char* funcName = "#ferror in function 'cc.Node:setVisible'";
+    Node* self = fastPathToSelf<Node>(tolua_S, "cc.Node", funcName);
+    fastPathCheckArgs(tolua_S, lua_gettop(tolua_S) - 1, 1, "cc.Node:setVisible");
+    self->setVisible(lua_toboolean(tolua_S, 2) != 0);
+    lua_settop(tolua_S, 1);
+    return 1;
+}
+
+static int lua_cocos2dx_Node_setOpacity_fast(lua_State* tolua_S)
+{
+    static const char* funcName = "#ferror in function 'cc.Node:setOpacity'";
+    Node* self = fastPathToSelf<Node>(tolua_S, "cc.Node", funcName);
+    fastPathCheckArgs(tolua_S, lua_gettop(tolua_S) - 1, 1, "cc.Node:setOpacity");
+    fastPathCheckNumber(tolua_S, 2, funcName);
+    self->setOpacity((GLubyte)lua_tonumber(tolua_S, 2));
+    lua_settop(tolua_S, 1);
+    return 1;
+}
+
+static int lua_cocos2dx_Node_setColor_fast(lua_State* tolua_S)
+{
+    static const char* funcName = "#ferror in function 'cc.Node:setColor'";
+    Node* self = fastPathToSelf<Node>(tolua_S, "cc.Node", funcName);
+    fastPathCheckArgs(tolua_S, lua_gettop(tolua_S) - 1, 1, "cc.Node:setColor");
+    fastPathCheckTable(tolua_S, 2, funcName);
+    self->setColor(Color3B((GLubyte)fastPathGetField(tolua_S, 2, FAST_PATH_KEY_R),
+                           (GLubyte)fastPathGetField(tolua_S, 2, FAST_PATH_KEY_G),
+                           (GLubyte)fastPathGetField(tolua_S, 2, FAST_PATH_KEY_B)));
+    lua_settop(tolua_S, 1);
+    return 1;
+}
+
+static int lua_cocos2dx_Sprite_setSpriteFrame_fast(lua_State* tolua_S)
+{
+    static const char* funcName = "#ferror in function 'cc.Sprite:setSpriteFrame'";
+    Sprite* self = fastPathToSelf<Sprite>(tolua_S, "cc.Sprite", funcName);
+    fastPathCheckArgs(tolua_S, lua_gettop(tolua_S) - 1, 1, "cc.Sprite:setSpriteFrame");
+    if (lua_type(tolua_S, 2) == LUA_TSTRING)
+    {
+        size_t len = 0;
+        const char* name = lua_tolstring(tolua_S, 2, &len);
+        self->setSpriteFrame(std::string(name, len));
+    }
+    else
+    {
+#if COCOS2D_DEBUG >= 1
+        tolua_Error tolua_err;
+        if (!tolua_isusertype(tolua_S, 2, "cc.SpriteFrame", 0, &tolua_err))
+        {
+            tolua_error(tolua_S, funcName, &tolua_err);
+        }
+#endif
+        self->setSpriteFrame(static_cast<SpriteFrame*>(tolua_tousertype(tolua_S, 2, 0)));
+    }
+    lua_settop(tolua_S, 1);
+    return 1;
+}
+
+static void fastPathCheckUserTable(lua_State* tolua_S, const char* type, const char* funcName)
+{
+#if COCOS2D_DEBUG >= 1
+    tolua_Error tolua_err;
+    if (!tolua_isusertable(tolua_S, 1, type, 0, &tolua_err))
+    {
+        tolua_error(tolua_S, funcName, &tolua_err);
+    }
+#endif
+}
+
+// MoveTo and MoveBy take a Vec3 when the table has a z field, like the generated bindings
+template <typename T>
+static int lua_cocos2dx_ActionMove_create_fast(lua_State* tolua_S, const char* type, const char* name)
+{
+    fastPathCheckUserTable(tolua_S, type, name);
+    fastPathCheckArgs(tolua_S, lua_gettop(tolua_S) - 1, 2, name);
+    fastPathCheckNumber(tolua_S, 2, name);
+    fastPathCheckTable(tolua_S, 3, name);
+    float duration = (float)lua_tonumber(tolua_S, 2);
+    T* ret = nullptr;
+    if (fastPathHasField(tolua_S, 3, FAST_PATH_KEY_Z))
+    {
+        ret = T::create(duration, Vec3(fastPathGetField(tolua_S, 3, FAST_PATH_KEY_X),
+                                       fastPathGetField(tolua_S, 3, FAST_PATH_KEY_Y),
+                                       fastPathGetField(tolua_S, 3, FAST_PATH_KEY_Z)));
+    }
+    else
+    {
+        ret = T::create(duration, Vec2(fastPathGetField(tolua_S, 3, FAST_PATH_KEY_X),
+                                       fastPathGetField(tolua_S, 3, FAST_PATH_KEY_Y)));
+    }
+    object_to_luaval<T>(tolua_S, type, ret);
+    return 1;
+}
+
+static int lua_cocos2dx_MoveTo_create_fast(lua_State* tolua_S)
+{
+    return lua_cocos2dx_ActionMove_create_fast<MoveTo>(tolua_S, "cc.MoveTo", "cc.MoveTo:create");
+}
+
+static int lua_cocos2dx_MoveBy_create_fast(lua_State* tolua_S)
+{
+    return lua_cocos2dx_ActionMove_create_fast<MoveBy>(tolua_S, "cc.MoveBy", "cc.MoveBy:create");
+}
+
+static int lua_cocos2dx_FadeTo_create_fast(lua_State* tolua_S)
+{
+    static const char* name = "cc.FadeTo:create";
+    fastPathCheckUserTable(tolua_S, "cc.FadeTo", name);
+    fastPathCheckArgs(tolua_S, lua_gettop(tolua_S) - 1, 2, name);
+    fastPathCheckNumber(tolua_S, 2, name);
+    fastPathCheckNumber(tolua_S, 3, name);
+    FadeTo* ret = FadeTo::create((float)lua_tonumber(tolua_S, 2), (GLubyte)lua_tonumber(tolua_S, 3));
+    object_to_luaval<FadeTo>(tolua_S, "cc.FadeTo", ret);
+    return 1;
+}
+
+// Batch setters: cc.Node:batchSetXXX(nodes, values) updates every node of the array in one call.
+// values is either one value used for all the nodes or an array with one value per node.
+static Node* fastPathBatchNode(lua_State* tolua_S, int index, const char* funcName)
+{
+    lua_rawgeti(tolua_S, 2, index);
+#if COCOS2D_DEBUG >= 1
+    tolua_Error tolua_err;
+    if (!tolua_isusertype(tolua_S, -1, "cc.Node", 0, &tolua_err))
+    {
+        tolua_error(tolua_S, funcName, &tolua_err);
+    }
+#endif
+    Node* node = static_cast<Node*>(tolua_tousertype(tolua_S, -1, 0));
+    lua_pop(tolua_S, 1);
+    return node;
+}
+
+static double fastPathBatchNumber(lua_State* tolua_S, int index)
+{
+    if (!lua_istable(tolua_S, 3))
+    {
+        return lua_tonumber(tolua_S, 3);
+    }
+    lua_rawgeti(tolua_S, 3, index);
+    double value = lua_tonumber(tolua_S, -1);
+    lua_pop(tolua_S, 1);
+    return value;
+}
+
+static int fastPathBatchSize(lua_State* tolua_S, const char* funcName)
+{
+    fastPathCheckUserTable(tolua_S, "cc.Node", funcName);
+    fastPathCheckArgs(tolua_S, lua_gettop(tolua_S) - 1, 2, funcName);
+    fastPathCheckTable(tolua_S, 2, funcName);
+    return (int)lua_objlen(tolua_S, 2);
+}
+
+// coords is a flat array {x1, y1, x2, y2, ...}
+static int lua_cocos2dx_Node_batchSetPosition(lua_State* tolua_S)
+{
+    static const char* funcName = "cc.Node:batchSetPosition";
+    int count = fastPathBatchSize(tolua_S, funcName);
+    fastPathCheckTable(tolua_S, 3, funcName);
+    for (int i = 1; i <= count; ++i)
+    {
+        Node* node = fastPathBatchNode(tolua_S, i, funcName);
+        lua_rawgeti(tolua_S, 3, i * 2 - 1);
+        lua_rawgeti(tolua_S, 3, i * 2);
+        if (node)
+        {
+            node->setPosition((float)lua_tonumber(tolua_S, -2), (float)lua_tonumber(tolua_S, -1));
+        }
+        lua_pop(tolua_S, 2);
+    }
+    return 0;
+}
+
+static int lua_cocos2dx_Node_batchSetRotation(lua_State* tolua_S)
+{
+    static const char* funcName = "cc.Node:batchSetRotation";
+    int count = fastPathBatchSize(tolua_S, funcName);
+    for (int i = 1; i <= count; ++i)
+    {
+        Node* node = fastPathBatchNode(tolua_S, i, funcName);
+        if (node)
+        {
+            node->setRotation((float)fastPathBatchNumber(tolua_S, i));
+        }
+    }
+    return 0;
+}
+
+static int lua_cocos2dx_Node_batchSetOpacity(lua_State* tolua_S)
+{
+    static const char* funcName = "cc.Node:batchSetOpacity";
+    int count = fastPathBatchSize(tolua_S, funcName);
+    for (int i = 1; i <= count; ++i)
+    {
+        Node* node = fastPathBatchNode(tolua_S, i, funcName);
+        if (node)
+        {
+            node->setOpacity((GLubyte)fastPathBatchNumber(tolua_S, i));
+        }
+    }
+    return 0;
+}
+
+static int lua_cocos2dx_Node_batchSetVisible(lua_State* tolua_S)
+{
+    static const char* funcName = "cc.Node:batchSetVisible";
+    int count = fastPathBatchSize(tolua_S, funcName);
+    bool perNode = lua_istable(tolua_S, 3);
+    bool visible = lua_toboolean(tolua_S, 3) != 0;
+    for (int i = 1; i <= count; ++i)
+    {
+        Node* node = fastPathBatchNode(tolua_S, i, funcName);
+        if (perNode)
+        {
+            lua_rawgeti(tolua_S, 3, i);
+            visible = lua_toboolean(tolua_S, -1) != 0;
+            lua_pop(tolua_S, 1);
+        }
+        if (node)
+        {
+            node->setVisible(visible);
+        }
+    }
+    return 0;
+}
+
+static void extendFastPath(lua_State* tolua_S)
+{
+    lua_pushstring(tolua_S, "cc.Node");
+    lua_rawget(tolua_S, LUA_REGISTRYINDEX);
+    if (lua_istable(tolua_S, -1))
+    {
+        fastPathPushFunction(tolua_S, "setPosition", lua_cocos2dx_Node_setPosition_fast);
+        fastPathPushFunction(tolua_S, "setPositionX", lua_cocos2dx_Node_setPositionX_fast);
+        fastPathPushFunction(tolua_S, "setPositionY", lua_cocos2dx_Node_setPositionY_fast);
+        fastPathPushFunction(tolua_S, "setRotation", lua_cocos2dx_Node_setRotation_fast);
+        fastPathPushFunction(tolua_S, "setScale", lua_cocos2dx_Node_setScale_fast);
+        fastPathPushFunction(tolua_S, "setVisible", lua_cocos2dx_Node_setVisible_fast);
+        fastPathPushFunction(tolua_S, "setOpacity", lua_cocos2dx_Node_setOpacity_fast);
+        fastPathPushFunction(tolua_S, "setColor", lua_cocos2dx_Node_setColor_fast);
+        tolua_function(tolua_S, "batchSetPosition", lua_cocos2dx_Node_batchSetPosition);
+        tolua_function(tolua_S, "batchSetRotation", lua_cocos2dx_Node_batchSetRotation);
+        tolua_function(tolua_S, "batchSetOpacity", lua_cocos2dx_Node_batchSetOpacity);
+        tolua_function(tolua_S, "batchSetVisible", lua_cocos2dx_Node_batchSetVisible);
+    }
+    lua_pop(tolua_S, 1);
+
+    lua_pushstring(tolua_S, "cc.Sprite");
+    lua_rawget(tolua_S, LUA_REGISTRYINDEX);
+    if (lua_istable(tolua_S, -1))
+    {
+        fastPathPushFunction(tolua_S, "setSpriteFrame", lua_cocos2dx_Sprite_setSpriteFrame_fast);
+    }
+    lua_pop(tolua_S, 1);
+
+    const struct { const char* type; lua_CFunction create; } actions[] = {
+        { "cc.MoveTo", lua_cocos2dx_MoveTo_create_fast },
+        { "cc.MoveBy", lua_cocos2dx_MoveBy_create_fast },
+        { "cc.FadeTo", lua_cocos2dx_FadeTo_create_fast },
+    };
+    for (const auto& action : actions)
+    {
+        lua_pushstring(tolua_S, action.type);
+        lua_rawget(tolua_S, LUA_REGISTRYINDEX);
+        if (lua_istable(tolua_S, -1))
+        {
+            fastPathPushFunction(tolua_S, "create", action.create);
+        }
+        lua_pop(tolua_S, 1);
+    }
+}
+
+// Copies the method found in the metatable of baseType into the metatables of the classes deriving from it,
+// when none of the classes in between overrides it, so the lookup stops at the first metatable.
+static void cacheInheritedMethods(lua_State* tolua_S, const char* baseType, const char* const* names, size_t count)
+{
+    int top = lua_gettop(tolua_S);
+    luaL_getmetatable(tolua_S, baseType);
+    int base = lua_gettop(tolua_S);
+    lua_pushstring(tolua_S, "tolua_super");
+    lua_rawget(tolua_S, LUA_REGISTRYINDEX);
+    int supers = lua_gettop(tolua_S);
+    if (!lua_istable(tolua_S, base) || !lua_istable(tolua_S, supers))
+    {
+        lua_settop(tolua_S, top);
+        return;
+    }
+
+    // tolua_super maps the metatable of every class to the set of the names of its base classes
+    lua_pushnil(tolua_S);
+    while (lua_next(tolua_S, supers))
+    {
+        int mt = lua_gettop(tolua_S) - 1;
+        bool derived = false;
+        if (lua_istable(tolua_S, mt) && lua_istable(tolua_S, -1))
+        {
+            lua_pushstring(tolua_S, baseType);
+            lua_rawget(tolua_S, -2);
+            derived = lua_toboolean(tolua_S, -1) != 0;
+            lua_pop(tolua_S, 1);
+        }
+
+        for (size_t i = 0; derived && i < count; ++i)
+        {
+            lua_pushstring(tolua_S, names[i]);
+            lua_rawget(tolua_S, mt);
+            bool own = !lua_isnil(tolua_S, -1);
+            lua_pop(tolua_S, 1);
+            if (own)
+            {
+                continue;
+            }
+
+            // walk up the metatables like the lookup does
+            lua_pushvalue(tolua_S, mt);
+            for (int depth = 0; depth < 32 && lua_getmetatable(tolua_S, -1); ++depth)
+            {
+                lua_remove(tolua_S, -2);
+                lua_pushstring(tolua_S, names[i]);
+                lua_rawget(tolua_S, -2);
+                if (!lua_isnil(tolua_S, -1))
+                {
+                    break;
+                }
+                lua_pop(tolua_S, 1);
+            }
+            if (!lua_isfunction(tolua_S, -1))
+            {
+                lua_settop(tolua_S, mt + 1);
+                continue;
+            }
+
+            lua_pushstring(tolua_S, names[i]);
+            lua_rawget(tolua_S, base);
+            bool inherited = lua_rawequal(tolua_S, -1, -2) != 0;
+            lua_pop(tolua_S, 1);
+            if (inherited)
+            {
+                lua_pushstring(tolua_S, names[i]);
+                lua_pushvalue(tolua_S, -2);
+                lua_rawset(tolua_S, mt);
+            }
+            lua_settop(tolua_S, mt + 1);
+        }
+        lua_pop(tolua_S, 1);
+    }
+    lua_settop(tolua_S, top);
+}
+
+int register_cocos2dx_fast_method_cache(lua_State* tolua_S)
+{
+    if (nullptr == tolua_S)
+        return 0;
+
+    static const char* const nodeMethods[] = {
+        "setPosition", "setPositionX", "setPositionY", "setRotation", "setScale",
+        "setVisible", "setOpacity", "setColor", "getPosition", "setContentSize", "setAnchorPoint"
+    };
+    cacheInheritedMethods(tolua_S, "cc.Node", nodeMethods, sizeof(nodeMethods) / sizeof(nodeMethods[0]));
+
+    static const char* const spriteMethods[] = { "setSpriteFrame" };
+    cacheInheritedMethods(tolua_S, "cc.Sprite", spriteMethods, sizeof(spriteMethods) / sizeof(spriteMethods[0]));
+    return 1;
+}
+
 static void extendNode(lua_State* tolua_S)
 {
     lua_pushstring(tolua_S,"cc.Node");
@@ -7960,6 +8501,7 @@ int register_all_cocos2dx_manual(lua_State* tolua_S)
         return 0;
 
     extendNode(tolua_S);
+    extendFastPath(tolua_S);
     extendScene(tolua_S);
     extendLayer(tolua_S);
     extendMenuItem(tolua_S);
@@ -61,6 +61,13 @@ TOLUA_API int register_all_cocos2dx_module_manual(lua_State* tolua_S);
 
 TOLUA_API int register_all_cocos2dx_math_manual(lua_State* tolua_S);
 
+/**
+ * Copies the fast path methods of cc.Node and cc.Sprite into the metatables of their subclasses, so calling them
+ * on a ccui.Button does not walk the whole class hierarchy. Call it once every module is registered. Redefining one
+ * of these methods on cc.Node from Lua afterwards does not reach the subclasses.
+ */
+TOLUA_API int register_cocos2dx_fast_method_cache(lua_State* tolua_S);
+
 struct LuaEventAccelerationData
 {
     void* acc;
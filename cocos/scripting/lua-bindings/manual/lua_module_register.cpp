@@ -1,4 +1,5 @@
 #include "scripting/lua-bindings/manual/lua_module_register.h"
+#include "scripting/lua-bindings/manual/cocos2d/lua_cocos2dx_manual.hpp"
 
 #include "scripting/lua-bindings/manual/cocosdenshion/lua_cocos2dx_cocosdenshion_manual.h"
 #include "scripting/lua-bindings/manual/network/lua_cocos2dx_network_manual.h"
@@ -11,6 +12,157 @@
 #include "scripting/lua-bindings/manual/audioengine/lua_cocos2dx_audioengine_manual.h"
 #include "scripting/lua-bindings/manual/physics3d/lua_cocos2dx_physics3d_manual.h"
 #include "scripting/lua-bindings/manual/navmesh/lua_cocos2dx_navmesh_manual.h"
+#include "scripting/lua-bindings/manual/LuaBasicConversions.h"
+
+#include <string.h>
+
+namespace {
+
+// a name whose first read registers a lazy module
+struct LazyTrigger
+{
+    const char* table;
+    const char* key;
+};
+
+struct LazyModule
+{
+    const char* name;
+    int (*registerModule)(lua_State* L);
+    const LazyTrigger* triggers;
+    int triggerCount;
+    bool registered;
+};
+
+const LazyTrigger COCOSTUDIO_TRIGGERS[] = { { "_G", "ccs" }, { "cc", "CSLoader" } };
+const LazyTrigger UI_TRIGGERS[] = { { "_G", "ccui" }, { "ccexp", "VideoPlayer" }, { "ccexp", "WebView" } };
+const LazyTrigger SPINE_TRIGGERS[] = { { "_G", "sp" } };
+
+// in the order of lua_module_register(), a module is registered after the ones before it
+LazyModule s_lazyModules[] = {
+    { "ccs", register_cocostudio_module, COCOSTUDIO_TRIGGERS, 2, false },
+    { "ccui", register_ui_module, UI_TRIGGERS, 3, false },
+    { "sp", register_spine_module, SPINE_TRIGGERS, 1, false },
+};
+const int LAZY_MODULE_COUNT = sizeof(s_lazyModules) / sizeof(s_lazyModules[0]);
+
+lua_State* s_lazyState = nullptr;
+
+void registerLazyModules(lua_State* L, int last)
+{
+    for (int i = 0; i <= last; ++i)
+    {
+        LazyModule& module = s_lazyModules[i];
+        if (module.registered)
+            continue;
+
+        module.registered = true;
+        module.registerModule(L);
+        register_cocos2dx_fast_method_cache(L);
+
+        // cocos/init.lua requires the scripts of the module
+        lua_getglobal(L, "__G__MODULE_REGISTERED__");
+        if (lua_isfunction(L, -1))
+        {
+            lua_pushstring(L, module.name);
+            if (lua_pcall(L, 1, 0, 0) != 0)
+            {
+                CCLOG("[LUA ERROR] registering the scripts of %s: %s", module.name, lua_tostring(L, -1));
+                lua_pop(L, 1);
+            }
+        }
+        else
+        {
+            lua_pop(L, 1);
+        }
+    }
+}
+
+bool registerPendingLazyModules()
+{
+    bool pending = false;
+    for (int i = 0; i < LAZY_MODULE_COUNT; ++i)
+    {
+        pending = pending || !s_lazyModules[i].registered;
+    }
+    if (pending && s_lazyState)
+    {
+        registerLazyModules(s_lazyState, LAZY_MODULE_COUNT - 1);
+    }
+    return pending;
+}
+
+// __index of the tables with triggers, upvalues: the name of the table, its previous __index
+int lazyModuleIndex(lua_State* L)
+{
+    if (lua_type(L, 2) == LUA_TSTRING)
+    {
+        const char* table = lua_tostring(L, lua_upvalueindex(1));
+        const char* key = lua_tostring(L, 2);
+        for (int i = 0; i < LAZY_MODULE_COUNT; ++i)
+        {
+            const LazyModule& module = s_lazyModules[i];
+            for (int j = 0; j < module.triggerCount && !module.registered; ++j)
+            {
+                if (strcmp(module.triggers[j].table, table) == 0 && strcmp(module.triggers[j].key, key) == 0)
+                {
+                    registerLazyModules(L, i);
+                    lua_pushvalue(L, 2);
+                    lua_rawget(L, 1);
+                    if (!lua_isnil(L, -1))
+                        return 1;
+                    lua_pop(L, 1);
+                }
+            }
+        }
+    }
+
+    int previous = lua_upvalueindex(2);
+    if (lua_isfunction(L, previous))
+    {
+        lua_pushvalue(L, previous);
+        lua_pushvalue(L, 1);
+        lua_pushvalue(L, 2);
+        lua_call(L, 2, 1);
+    }
+    else if (lua_istable(L, previous))
+    {
+        lua_pushvalue(L, 2);
+        lua_gettable(L, previous);
+    }
+    else
+    {
+        lua_pushnil(L);
+    }
+    return 1;
+}
+
+void installLazyModuleIndex(lua_State* L, const char* table)
+{
+    lua_getglobal(L, table);
+    if (!lua_istable(L, -1))
+    {
+        lua_pop(L, 1);
+        return;
+    }
+
+    if (!lua_getmetatable(L, -1))
+    {
+        lua_newtable(L);
+        lua_pushvalue(L, -1);
+        lua_setmetatable(L, -3);
+    }
+    lua_pushstring(L, table);
+    lua_pushstring(L, "__index");
+    lua_rawget(L, -3);
+    lua_pushcclosure(L, lazyModuleIndex, 2);
+    lua_pushstring(L, "__index");
+    lua_insert(L, -2);
+    lua_rawset(L, -3);
+    lua_pop(L, 2);
+}
+
+} // namespace
 
 
 int lua_module_register(lua_State* L)
@@ -31,6 +183,38 @@ int lua_module_register(lua_State* L)
 #if CC_USE_NAVMESH
     register_navmesh_module(L);
 #endif
+    // the classes of every module are known now
+    register_cocos2dx_fast_method_cache(L);
+    return 1;
+}
+
+int lua_module_register_lazy(lua_State* L)
+{
+    register_cocosdenshion_module(L);
+    register_network_module(L);
+    register_cocosbuilder_module(L);
+    register_extension_module(L);
+    register_cocos3d_module(L);
+    register_audioengine_module(L);
+#if CC_USE_3D_PHYSICS && CC_ENABLE_BULLET_INTEGRATION
+    register_physics3d_module(L);
+#endif
+#if CC_USE_NAVMESH
+    register_navmesh_module(L);
+#endif
+    // the ui module extends a class of cocos2d-x, that can't wait
+    register_ui_module_extensions(L);
+    register_cocos2dx_fast_method_cache(L);
+
+    // a native object of a class not registered yet is pushed only after its module is registered
+    s_lazyState = L;
+    g_luaTypeMissHandler = registerPendingLazyModules;
+
+    const char* tables[] = { "_G", "cc", "ccexp" };
+    for (const char* table : tables)
+    {
+        installLazyModuleIndex(L, table);
+    }
     return 1;
 }
 
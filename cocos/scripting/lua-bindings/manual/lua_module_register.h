@@ -6,5 +6,15 @@
 
 CC_LUA_DLL  int  lua_module_register(lua_State* L);
 
+/**
+ * Registers the modules like lua_module_register(), but the ones with a table of their own (ccs, ccui, sp)
+ * are registered the first time the table, or one of their classes, is used. The games using a part of the
+ * modules start sooner and use less memory.
+ * The scripts of cocos/init.lua for these modules are required when they are registered, the deprecated aliases
+ * of their classes in the cc table (cc.EditBox, cc.Scale9Sprite) aren't defined.
+ * @since v3.14
+ */
+CC_LUA_DLL  int  lua_module_register_lazy(lua_State* L);
+
 #endif  // __LUA_TEMPLATE_RUNTIME_FRAMEWORKS_RUNTIME_SRC_CLASSES_LUA_MODULE_REGISTER_H__
 
@@ -1174,6 +1174,12 @@ static void extendEventListenerFocusEvent(lua_State* L)
     lua_pop(L, 1);
 }
 
+int register_ui_module_extensions(lua_State* L)
+{
+    extendEventListenerFocusEvent(L);
+    return 1;
+}
+
 int register_ui_module(lua_State* L)
 {
     lua_getglobal(L, "_G");
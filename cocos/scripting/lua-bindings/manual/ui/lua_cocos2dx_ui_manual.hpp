@@ -48,6 +48,13 @@ TOLUA_API int register_all_cocos2dx_ui_manual(lua_State* L);
  */
 TOLUA_API int register_ui_module(lua_State* L);
 
+/**
+ * Registers the extensions of the ui module to the classes of cocos2d-x only, e.g. the Lua handlers of
+ * cc.EventListenerFocus. lua_module_register_lazy() calls it before the ui module is registered.
+ * @since v3.14
+ */
+TOLUA_API int register_ui_module_extensions(lua_State* L);
+
 // end group
 /// @}
 
@@ -99,7 +99,7 @@ _G["CCControlColourPicker"] = DeprecatedExtensionClass.CCControlColourPicker()
 --CCControlColourPicker class will be Deprecated,end
 
 
-if nil == ccui then
+if nil == rawget(_G, "ccui") then
     return
 end
 
@@ -39,7 +39,7 @@ require("cocos.framework.extends.SpriteEx")
 require("cocos.framework.extends.LayerEx")
 require("cocos.framework.extends.MenuEx")
 
-if ccui then
+local function requireUIExtends()
 require("cocos.framework.extends.UIWidget")
 require("cocos.framework.extends.UICheckBox")
 require("cocos.framework.extends.UIEditBox")
@@ -50,6 +50,21 @@ require("cocos.framework.extends.UISlider")
 require("cocos.framework.extends.UITextField")
 end
 
+if rawget(_G, "ccui") then
+    requireUIExtends()
+else
+    -- lua_module_register_lazy() registers ccui when it's first used
+    local moduleRegistered = __G__MODULE_REGISTERED__
+    __G__MODULE_REGISTERED__ = function(name)
+        if moduleRegistered then
+            moduleRegistered(name)
+        end
+        if name == "ccui" then
+            requireUIExtends()
+        end
+    end
+end
+
 require("cocos.framework.package_support")
 
 -- register the build-in packages
@@ -32,17 +32,41 @@ __G__TRACKBACK__ = function(msg)
     return msg
 end
 
+-- the modules registered by lua_module_register_lazy() require their scripts once they are used
+local lazyModuleScripts = {
+    ccs = {
+        "cocos.cocostudio.CocoStudio",
+        "cocos.cocostudio.DeprecatedCocoStudioClass",
+        "cocos.cocostudio.DeprecatedCocoStudioFunc",
+    },
+    ccui = {
+        "cocos.ui.GuiConstants",
+        "cocos.ui.experimentalUIConstants",
+        "cocos.ui.DeprecatedUIEnum",
+        "cocos.ui.DeprecatedUIFunc",
+    },
+    sp = {
+        "cocos.spine.SpineConstants",
+    },
+}
+
+__G__MODULE_REGISTERED__ = function(name)
+    for _, script in ipairs(lazyModuleScripts[name] or {}) do
+        require(script)
+    end
+end
+
 -- opengl
 require "cocos.cocos2d.Opengl"
 require "cocos.cocos2d.OpenglConstants"
 -- audio
 require "cocos.cocosdenshion.AudioEngine"
 -- cocosstudio
-if nil ~= ccs then
+if nil ~= rawget(_G, "ccs") then
     require "cocos.cocostudio.CocoStudio"
 end
 -- ui
-if nil ~= ccui then
+if nil ~= rawget(_G, "ccui") then
     require "cocos.ui.GuiConstants"
     require "cocos.ui.experimentalUIConstants"
 end
@@ -52,7 +76,7 @@ require "cocos.extension.ExtensionConstants"
 -- network
 require "cocos.network.NetworkConstants"
 -- Spine
-if nil ~= sp then
+if nil ~= rawget(_G, "sp") then
     require "cocos.spine.SpineConstants"
 end
 
@@ -69,7 +93,7 @@ require "cocos.cocos2d.DeprecatedCocos2dFunc"
 require "cocos.cocos2d.DeprecatedOpenglEnum"
 
 -- register_cocostudio_module
-if nil ~= ccs then
+if nil ~= rawget(_G, "ccs") then
     require "cocos.cocostudio.DeprecatedCocoStudioClass"
     require "cocos.cocostudio.DeprecatedCocoStudioFunc"
 end
@@ -93,7 +117,7 @@ require "cocos.network.DeprecatedNetworkEnum"
 require "cocos.network.DeprecatedNetworkFunc"
 
 -- register_ui_module
-if nil ~= ccui then
+if nil ~= rawget(_G, "ccui") then
     require "cocos.ui.DeprecatedUIEnum"
     require "cocos.ui.DeprecatedUIFunc"
 end
@@ -130,4 +130,23 @@ void localStorageClear()
     JniHelper::callStaticVoidMethod(className, "clear");
 }
 
+/** starts a transaction */
+void localStorageBeginBatch()
+{
+    assert( _initialized );
+    JniHelper::callStaticVoidMethod(className, "beginBatch");
+}
+
+/** commits the transaction started by localStorageBeginBatch() */
+void localStorageCommitBatch()
+{
+    assert( _initialized );
+    JniHelper::callStaticVoidMethod(className, "commitBatch");
+}
+
+/** not supported, the Java DB helper writes the items */
+void localStorageSetAsyncWrites(bool /*enabled*/)
+{
+}
+
 #endif // #if (CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID)
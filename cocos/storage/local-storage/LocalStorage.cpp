@@ -36,6 +36,10 @@
 #include <stdlib.h>
 #include <assert.h>
 #include <sqlite3.h>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
 
 static int _initialized = 0;
 static sqlite3 *_db;
@@ -43,6 +47,40 @@ static sqlite3_stmt *_stmt_select;
 static sqlite3_stmt *_stmt_remove;
 static sqlite3_stmt *_stmt_update;
 static sqlite3_stmt *_stmt_clear;
+static sqlite3_stmt *_stmt_begin;
+static sqlite3_stmt *_stmt_commit;
+
+static int _batchDepth = 0;
+
+// a write waiting for the background writer
+struct LocalStorageWrite
+{
+    enum class Type
+    {
+        SET,
+        REMOVE,
+        CLEAR
+    };
+
+    Type type;
+    std::string key;
+    std::string value;
+};
+
+static bool _asyncWrites = false;
+// guards the connection and the statements, the writer thread holds it while it writes
+static std::mutex _dbMutex;
+// guards the queues below
+static std::mutex _queueMutex;
+static std::condition_variable _queueCondition;
+// set while a batch is open, only used by the calling thread
+static std::vector<LocalStorageWrite> _batchWrites;
+// committed, not taken by the writer yet
+static std::vector<LocalStorageWrite> _pendingWrites;
+// taken by the writer, being written
+static std::vector<LocalStorageWrite> _writingWrites;
+static std::thread _writerThread;
+static bool _stopWriter = false;
 
 
 static void localStorageCreateTable()
@@ -57,6 +95,131 @@ static void localStorageCreateTable()
         printf("Error in CREATE TABLE\n");
 }
 
+static void localStorageExec(sqlite3_stmt *stmt, const char *error)
+{
+    int ok = sqlite3_step(stmt);
+
+    ok |= sqlite3_reset(stmt);
+
+    if (ok != SQLITE_OK && ok != SQLITE_DONE)
+        printf("%s\n", error);
+}
+
+static void localStorageUpdate(const std::string& key, const std::string& value)
+{
+    int ok = sqlite3_bind_text(_stmt_update, 1, key.c_str(), -1, SQLITE_TRANSIENT);
+    ok |= sqlite3_bind_text(_stmt_update, 2, value.c_str(), -1, SQLITE_TRANSIENT);
+
+    ok |= sqlite3_step(_stmt_update);
+	
+    ok |= sqlite3_reset(_stmt_update);
+	
+    if (ok != SQLITE_OK && ok != SQLITE_DONE)
+        printf("Error in localStorage.setItem()\n");
+}
+
+static void localStorageRemove(const std::string& key)
+{
+    int ok = sqlite3_bind_text(_stmt_remove, 1, key.c_str(), -1, SQLITE_TRANSIENT);
+	
+    ok |= sqlite3_step(_stmt_remove);
+	
+    ok |= sqlite3_reset(_stmt_remove);
+
+    if (ok != SQLITE_OK && ok != SQLITE_DONE)
+        printf("Error in localStorage.removeItem()\n");
+}
+
+static void localStorageWriterLoop()
+{
+    std::unique_lock<std::mutex> lock(_queueMutex);
+    while (true)
+    {
+        _queueCondition.wait(lock, []{ return _stopWriter || !_pendingWrites.empty(); });
+        if (_pendingWrites.empty())
+            break;
+
+        _writingWrites.swap(_pendingWrites);
+        lock.unlock();
+        {
+            // one transaction, so the queued writes are synced to disk once
+            std::lock_guard<std::mutex> dbLock(_dbMutex);
+            localStorageExec(_stmt_begin, "Error in localStorage BEGIN");
+            for (const auto& write : _writingWrites)
+            {
+                switch (write.type)
+                {
+                    case LocalStorageWrite::Type::SET:
+                        localStorageUpdate(write.key, write.value);
+                        break;
+                    case LocalStorageWrite::Type::REMOVE:
+                        localStorageRemove(write.key);
+                        break;
+                    case LocalStorageWrite::Type::CLEAR:
+                        localStorageExec(_stmt_clear, "Error in localStorage.clear()");
+                        break;
+                }
+            }
+            localStorageExec(_stmt_commit, "Error in localStorage COMMIT");
+        }
+        lock.lock();
+        _writingWrites.clear();
+    }
+}
+
+static void localStorageQueueWrite(LocalStorageWrite&& write)
+{
+    if (_batchDepth > 0)
+    {
+        if (write.type == LocalStorageWrite::Type::CLEAR)
+            _batchWrites.clear();
+        _batchWrites.push_back(std::move(write));
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(_queueMutex);
+    if (write.type == LocalStorageWrite::Type::CLEAR)
+        _pendingWrites.clear();
+    _pendingWrites.push_back(std::move(write));
+    _queueCondition.notify_one();
+}
+
+// returns true if a write that isn't in the DB yet decides the item, outFound tells whether it exists
+static bool localStorageFindQueuedItem(const std::vector<LocalStorageWrite>& writes, const std::string& key, std::string *outItem, bool *outFound)
+{
+    for (auto iter = writes.rbegin(); iter != writes.rend(); ++iter)
+    {
+        if (iter->type == LocalStorageWrite::Type::CLEAR || iter->key == key)
+        {
+            *outFound = (iter->type == LocalStorageWrite::Type::SET);
+            if (*outFound)
+                outItem->assign(iter->value);
+            return true;
+        }
+    }
+    return false;
+}
+
+static void localStorageStartWriter()
+{
+    _stopWriter = false;
+    _writerThread = std::thread(localStorageWriterLoop);
+}
+
+static void localStorageStopWriter()
+{
+    if (!_writerThread.joinable())
+        return;
+
+    {
+        std::lock_guard<std::mutex> lock(_queueMutex);
+        _stopWriter = true;
+    }
+    _queueCondition.notify_one();
+    // the writer writes what is still queued before it exits
+    _writerThread.join();
+}
+
 void localStorageInit( const std::string& fullpath/* = "" */)
 {
     if (!_initialized) {
@@ -66,8 +229,14 @@ void localStorageInit( const std::string& fullpath/* = "" */)
         if (fullpath.empty())
             ret = sqlite3_open(":memory:", &_db);
         else
+        {
             ret = sqlite3_open(fullpath.c_str(), &_db);
 
+            // WAL appends the changes to a log instead of rewriting the DB pages, and NORMAL only syncs it on checkpoints
+            ret |= sqlite3_exec(_db, "PRAGMA journal_mode=WAL;", nullptr, nullptr, nullptr);
+            ret |= sqlite3_exec(_db, "PRAGMA synchronous=NORMAL;", nullptr, nullptr, nullptr);
+        }
+
         localStorageCreateTable();
 
         // SELECT
@@ -86,21 +255,35 @@ void localStorageInit( const std::string& fullpath/* = "" */)
         const char *sql_clear = "DELETE FROM data;";
         ret |= sqlite3_prepare_v2(_db, sql_clear, -1, &_stmt_clear, nullptr);
 
+        // Transactions
+        ret |= sqlite3_prepare_v2(_db, "BEGIN;", -1, &_stmt_begin, nullptr);
+        ret |= sqlite3_prepare_v2(_db, "COMMIT;", -1, &_stmt_commit, nullptr);
+
         if (ret != SQLITE_OK) {
             printf("Error initializing DB\n");
             // report error
         }
 		
         _initialized = 1;
+
+        if (_asyncWrites)
+            localStorageStartWriter();
     }
 }
 
 void localStorageFree()
 {
     if (_initialized) {
+        while (_batchDepth > 0)
+            localStorageCommitBatch();
+        localStorageStopWriter();
+
         sqlite3_finalize(_stmt_select);
         sqlite3_finalize(_stmt_remove);
         sqlite3_finalize(_stmt_update);
+        sqlite3_finalize(_stmt_clear);
+        sqlite3_finalize(_stmt_begin);
+        sqlite3_finalize(_stmt_commit);
 
         sqlite3_close(_db);
 		
@@ -112,16 +295,15 @@ void localStorageFree()
 void localStorageSetItem( const std::string& key, const std::string& value)
 {
     assert( _initialized );
-	
-    int ok = sqlite3_bind_text(_stmt_update, 1, key.c_str(), -1, SQLITE_TRANSIENT);
-    ok |= sqlite3_bind_text(_stmt_update, 2, value.c_str(), -1, SQLITE_TRANSIENT);
 
-    ok |= sqlite3_step(_stmt_update);
-	
-    ok |= sqlite3_reset(_stmt_update);
-	
-    if (ok != SQLITE_OK && ok != SQLITE_DONE)
-        printf("Error in localStorage.setItem()\n");
+    if (_asyncWrites)
+    {
+        localStorageQueueWrite({ LocalStorageWrite::Type::SET, key, value });
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(_dbMutex);
+    localStorageUpdate(key, value);
 }
 
 /** gets an item from the LS */
@@ -129,6 +311,20 @@ bool localStorageGetItem( const std::string& key, std::string *outItem )
 {
     assert( _initialized );
 
+    if (_asyncWrites)
+    {
+        bool found = false;
+        if (localStorageFindQueuedItem(_batchWrites, key, outItem, &found))
+            return found;
+
+        std::lock_guard<std::mutex> lock(_queueMutex);
+        if (localStorageFindQueuedItem(_pendingWrites, key, outItem, &found) ||
+            localStorageFindQueuedItem(_writingWrites, key, outItem, &found))
+            return found;
+    }
+
+    std::lock_guard<std::mutex> lock(_dbMutex);
+
     int ok = sqlite3_reset(_stmt_select);
 
     ok |= sqlite3_bind_text(_stmt_select, 1, key.c_str(), -1, SQLITE_TRANSIENT);
@@ -156,25 +352,89 @@ void localStorageRemoveItem( const std::string& key )
 {
     assert( _initialized );
 
-    int ok = sqlite3_bind_text(_stmt_remove, 1, key.c_str(), -1, SQLITE_TRANSIENT);
-	
-    ok |= sqlite3_step(_stmt_remove);
-	
-    ok |= sqlite3_reset(_stmt_remove);
+    if (_asyncWrites)
+    {
+        localStorageQueueWrite({ LocalStorageWrite::Type::REMOVE, key, std::string() });
+        return;
+    }
 
-    if (ok != SQLITE_OK && ok != SQLITE_DONE)
-        printf("Error in localStorage.removeItem()\n");
+    std::lock_guard<std::mutex> lock(_dbMutex);
+    localStorageRemove(key);
 }
 
 /** removes all items from the LS */
 void localStorageClear()
 {
     assert( _initialized );
-    
-    int ok = sqlite3_step(_stmt_clear);
-    
-    if( ok != SQLITE_OK && ok != SQLITE_DONE)
-        printf("Error in localStorage.clear()\n");
+
+    if (_asyncWrites)
+    {
+        localStorageQueueWrite({ LocalStorageWrite::Type::CLEAR, std::string(), std::string() });
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(_dbMutex);
+    localStorageExec(_stmt_clear, "Error in localStorage.clear()");
+}
+
+/** starts a transaction */
+void localStorageBeginBatch()
+{
+    assert( _initialized );
+
+    if (_batchDepth++ > 0 || _asyncWrites)
+        return;
+
+    std::lock_guard<std::mutex> lock(_dbMutex);
+    localStorageExec(_stmt_begin, "Error in localStorage BEGIN");
+}
+
+/** commits the transaction started by localStorageBeginBatch() */
+void localStorageCommitBatch()
+{
+    assert( _initialized );
+    assert( _batchDepth > 0 );
+
+    if (_batchDepth <= 0 || --_batchDepth > 0)
+        return;
+
+    if (_asyncWrites)
+    {
+        if (_batchWrites.empty())
+            return;
+
+        std::lock_guard<std::mutex> lock(_queueMutex);
+        for (auto& write : _batchWrites)
+        {
+            if (write.type == LocalStorageWrite::Type::CLEAR)
+                _pendingWrites.clear();
+            _pendingWrites.push_back(std::move(write));
+        }
+        _batchWrites.clear();
+        _queueCondition.notify_one();
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(_dbMutex);
+    localStorageExec(_stmt_commit, "Error in localStorage COMMIT");
+}
+
+/** moves the writes to a background thread */
+void localStorageSetAsyncWrites(bool enabled)
+{
+    assert( _batchDepth == 0 );
+
+    if (_asyncWrites == enabled)
+        return;
+
+    _asyncWrites = enabled;
+    if (!_initialized)
+        return;
+
+    if (enabled)
+        localStorageStartWriter();
+    else
+        localStorageStopWriter();
 }
 
 #endif // #if (CC_TARGET_PLATFORM != CC_PLATFORM_ANDROID)
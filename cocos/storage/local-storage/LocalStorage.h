@@ -54,6 +54,24 @@ void CC_DLL localStorageRemoveItem( const std::string& key );
 /** Removes all items from the JS. */
 void CC_DLL localStorageClear();
 
+/** Starts a batch. The items set or removed until localStorageCommitBatch() are written in one transaction.
+ * Batches can be nested, only the outermost commit writes.
+ * @since v3.14
+ */
+void CC_DLL localStorageBeginBatch();
+
+/** Commits the batch started by localStorageBeginBatch().
+ * @since v3.14
+ */
+void CC_DLL localStorageCommitBatch();
+
+/** Writes the items on a background thread, so setItem/removeItem/clear don't block on disk I/O.
+ * getItem still returns the items that are not written yet. localStorageFree() waits for the pending writes.
+ * It isn't supported on Android, where the items are always written by the Java DB helper.
+ * @since v3.14
+ */
+void CC_DLL localStorageSetAsyncWrites(bool enabled);
+
 // end group
 /// @}
 
@@ -137,6 +137,12 @@ void Helper::changeLayoutSystemActiveState(bool bActive)
 {
     _activeLayout = bActive;
 }
+    
+bool Helper::isLayoutSystemActive()
+{
+    return _activeLayout;
+}
+    
 void Helper::doLayout(cocos2d::Node *rootNode)
 {
     if(!_activeLayout)
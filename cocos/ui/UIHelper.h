@@ -103,6 +103,13 @@ public:
      */
     static void changeLayoutSystemActiveState(bool active);
     
+    /**
+     * Query whether the layout components are active.
+     *@return True if `LayoutComponent` refreshes its owner, false otherwise.
+     * @since v3.14
+     */
+    static bool isLayoutSystemActive();
+    
     /**
      *@brief  restrict capInsetSize, when the capInsets's width is larger than the textureSize, it will restrict to 0,
      *        the height goes the same way as width.
@@ -74,8 +74,10 @@ _clippingStencil(nullptr),
 _clippingRect(Rect::ZERO),
 _clippingParent(nullptr),
 _clippingRectDirty(true),
+_childrenCullingRect(Rect::ZERO),
 _stencilStateManager(new StencilStateManager()),
 _doLayoutDirty(true),
+_layoutManager(nullptr),
 _isInterceptTouch(false),
 _loopFocus(false),
 _passFocusToChild(true),
@@ -87,6 +89,7 @@ _isFocusPassing(false)
 Layout::~Layout()
 {
     CC_SAFE_RELEASE(_clippingStencil);
+    CC_SAFE_RELEASE(_layoutManager);
     CC_SAFE_DELETE(_stencilStateManager);
 }
     
@@ -240,12 +243,101 @@ void Layout::visit(Renderer *renderer, const Mat4 &parentTransform, uint32_t par
                 break;
         }
     }
+    else if (_childrenCullingRect.size.width > 0 && _childrenCullingRect.size.height > 0)
+    {
+        cullingVisit(renderer, parentTransform, parentFlags);
+    }
     else
     {
         Widget::visit(renderer, parentTransform, parentFlags);
     }
 }
     
+void Layout::setChildrenCullingRect(const Rect& rect)
+{
+    _childrenCullingRect = rect;
+}
+    
+const Rect& Layout::getChildrenCullingRect() const
+{
+    return _childrenCullingRect;
+}
+    
+bool Layout::isChildCulled(Node* child) const
+{
+    const Size& size = child->getContentSize();
+    if (size.width <= 0 || size.height <= 0)
+    {
+        return false;
+    }
+    return !_childrenCullingRect.intersectsRect(child->getBoundingBox());
+}
+    
+void Layout::cullingVisit(Renderer *renderer, const Mat4& parentTransform, uint32_t parentFlags)
+{
+    uint32_t flags = processParentFlags(parentTransform, parentFlags);
+    
+    // IMPORTANT:
+    // To ease the migration to v3.0, we still support the Mat4 stack,
+    // but it is deprecated and your code should not rely on it
+    Director* director = Director::getInstance();
+    CCASSERT(nullptr != director, "Director is null when setting matrix stack");
+    director->pushMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
+    director->loadMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW, _modelViewTransform);
+    
+    int i = 0;      // used by _children
+    int j = 0;      // used by _protectedChildren
+    
+    sortAllChildren();
+    sortAllProtectedChildren();
+    
+    //
+    // draw children and protectedChildren zOrder < 0, skipping the children out of the culling rect
+    //
+    for(auto size = _children.size(); i < size; i++)
+    {
+        auto node = _children.at(i);
+        
+        if (node && node->getLocalZOrder() < 0)
+        {
+            if (!isChildCulled(node))
+                node->visit(renderer, _modelViewTransform, flags);
+        }
+        else
+            break;
+    }
+    
+    for(auto size = _protectedChildren.size(); j < size; j++)
+    {
+        auto node = _protectedChildren.at(j);
+        
+        if (node && node->getLocalZOrder() < 0)
+            node->visit(renderer, _modelViewTransform, flags);
+        else
+            break;
+    }
+    
+    //
+    // draw self
+    //
+    if (isVisitableByVisitingCamera())
+        this->draw(renderer, _modelViewTransform, flags);
+    
+    //
+    // draw children and protectedChildren zOrder >= 0
+    //
+    for(auto it=_protectedChildren.cbegin()+j, itCend = _protectedChildren.cend(); it != itCend; ++it)
+        (*it)->visit(renderer, _modelViewTransform, flags);
+    
+    for(auto it=_children.cbegin()+i, itCend = _children.cend(); it != itCend; ++it)
+    {
+        if (!isChildCulled(*it))
+            (*it)->visit(renderer, _modelViewTransform, flags);
+    }
+    
+    director->popMatrix(MATRIX_STACK_TYPE::MATRIX_STACK_MODELVIEW);
+}
+    
 void Layout::stencilClippingVisit(Renderer *renderer, const Mat4& parentTransform, uint32_t parentFlags)
 {
     if(!_visible)
@@ -337,7 +429,7 @@ void Layout::onBeforeVisitScissor()
     _scissorOldState = glview->isScissorEnabled();
     if (false == _scissorOldState)
     {
-        glEnable(GL_SCISSOR_TEST);
+        GL::enable(GL_SCISSOR_TEST);
     }
 
     // apply scissor box
@@ -369,7 +461,7 @@ void Layout::onAfterVisitScissor()
     else
     {
         // revert scissor test
-        glDisable(GL_SCISSOR_TEST);
+        GL::disable(GL_SCISSOR_TEST);
     }
 }
     
@@ -909,6 +1001,7 @@ void Layout::setLayoutType(Type type)
             supplyTheLayoutParameterLackToChild(static_cast<Widget*>(child));
         }
     }
+    CC_SAFE_RELEASE_NULL(_layoutManager);
     _doLayoutDirty = true;
 }
     
@@ -971,11 +1064,16 @@ void Layout::doLayout()
     
     sortAllChildren();
 
-    LayoutManager* executant = this->createLayoutManager();
+    // The manager only depends on the layout type, keep it between passes
+    if (_layoutManager == nullptr)
+    {
+        _layoutManager = this->createLayoutManager();
+        CC_SAFE_RETAIN(_layoutManager);
+    }
     
-    if (executant)
+    if (_layoutManager)
     {
-        executant->doLayout(this);
+        _layoutManager->doLayout(this);
     }
     
     _doLayoutDirty = false;
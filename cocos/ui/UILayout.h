@@ -343,6 +343,23 @@ public:
      */
     virtual bool isClippingEnabled()const;
     
+    /**
+     * Only visit the children whose bounding box intersects the rect.
+     * Children with an empty content size are always visited since their descendants may draw anywhere.
+     *
+     * @param rect The culling rect in the coordinates of the layout, an empty rect disables culling.
+     * @since v3.14
+     */
+    void setChildrenCullingRect(const Rect& rect);
+    
+    /**
+     * Gets the rect used to cull the children of the layout.
+     *
+     * @return The culling rect, empty when children are not culled.
+     * @since v3.14
+     */
+    const Rect& getChildrenCullingRect() const;
+    
     /**
      * Returns the "class name" of widget.
      */
@@ -481,6 +498,8 @@ protected:
     
     void stencilClippingVisit(Renderer *renderer, const Mat4 &parentTransform, uint32_t parentFlags);
     void scissorClippingVisit(Renderer *renderer, const Mat4 &parentTransform, uint32_t parentFlags);
+    void cullingVisit(Renderer *renderer, const Mat4 &parentTransform, uint32_t parentFlags);
+    bool isChildCulled(Node* child) const;
     
     void setStencilClippingSize(const Size& size);
     const Rect& getClippingRect();
@@ -632,6 +651,7 @@ protected:
     Rect _clippingRect;
     Layout* _clippingParent;
     bool _clippingRectDirty;
+    Rect _childrenCullingRect;
     
     //clipping
     StencilStateManager *_stencilStateManager;
@@ -644,6 +664,7 @@ protected:
     CustomCommand _afterVisitCmdScissor;
     
     bool _doLayoutDirty;
+    LayoutManager* _layoutManager;
     bool _isInterceptTouch;
     
     //whether enable loop focus or not
@@ -49,6 +49,7 @@ namespace ui {
         , _usingPercentHeight(false)
         , _actived(true)
         , _isPercentOnly(false)
+        , _layoutDirty(true)
     {
         _name = __LAYOUT_COMPONENT_NAME;
     }
@@ -129,6 +130,7 @@ namespace ui {
     //OldVersion
     void LayoutComponent::setUsingPercentContentSize(bool isUsed)
     {
+        _layoutDirty = true;
         _usingPercentWidth = _usingPercentHeight = isUsed;
     }
     bool LayoutComponent::getUsingPercentContentSize()const
@@ -173,6 +175,7 @@ namespace ui {
     }
     void LayoutComponent::setPosition(const Point& position)
     {
+        _layoutDirty = true;
         Node* parent = this->getOwnerParent();
         if (parent != nullptr)
         {
@@ -212,6 +215,7 @@ namespace ui {
     }
     void LayoutComponent::setPositionPercentXEnabled(bool isUsed)
     {
+        _layoutDirty = true;
         _usingPositionPercentX = isUsed;
         if (_usingPositionPercentX)
         {
@@ -225,6 +229,7 @@ namespace ui {
     }
     void LayoutComponent::setPositionPercentX(float percentMargin)
     {
+        _layoutDirty = true;
         _positionPercentX = percentMargin;
 
         if (_usingPositionPercentX || _horizontalEdge == HorizontalEdge::Center)
@@ -244,6 +249,7 @@ namespace ui {
     }
     void LayoutComponent::setPositionPercentYEnabled(bool isUsed)
     {
+        _layoutDirty = true;
         _usingPositionPercentY = isUsed;
         if (_usingPositionPercentY)
         {
@@ -257,6 +263,7 @@ namespace ui {
     }
     void LayoutComponent::setPositionPercentY(float percentMargin)
     {
+        _layoutDirty = true;
         _positionPercentY = percentMargin;
 
         if (_usingPositionPercentY || _verticalEdge == VerticalEdge::Center)
@@ -276,6 +283,7 @@ namespace ui {
     }
     void LayoutComponent::setHorizontalEdge(HorizontalEdge hEage)
     {
+        _layoutDirty = true;
         _horizontalEdge = hEage;
         if (_horizontalEdge != HorizontalEdge::None)
         {
@@ -289,6 +297,7 @@ namespace ui {
     }
     void LayoutComponent::setVerticalEdge(VerticalEdge vEage)
     {
+        _layoutDirty = true;
         _verticalEdge = vEage;
         if (_verticalEdge != VerticalEdge::None)
         {
@@ -302,6 +311,7 @@ namespace ui {
     }
     void LayoutComponent::setLeftMargin(float margin)
     {
+        _layoutDirty = true;
         _leftMargin = margin;
     }
 
@@ -311,6 +321,7 @@ namespace ui {
     }
     void LayoutComponent::setRightMargin(float margin)
     {
+        _layoutDirty = true;
         _rightMargin = margin;
     }
 
@@ -320,6 +331,7 @@ namespace ui {
     }
     void LayoutComponent::setTopMargin(float margin)
     {
+        _layoutDirty = true;
         _topMargin = margin;
     }
 
@@ -329,6 +341,7 @@ namespace ui {
     }
     void LayoutComponent::setBottomMargin(float margin)
     {
+        _layoutDirty = true;
         _bottomMargin = margin;
     }
 
@@ -339,6 +352,7 @@ namespace ui {
     }
     void LayoutComponent::setSize(const Size& size)
     {
+        _layoutDirty = true;
         Node* parent = this->getOwnerParent();
         if (parent != nullptr)
         {
@@ -378,6 +392,7 @@ namespace ui {
     }
     void LayoutComponent::setPercentWidthEnabled(bool isUsed)
     {
+        _layoutDirty = true;
         _usingPercentWidth = isUsed;
         if (_usingPercentWidth)
         {
@@ -391,6 +406,7 @@ namespace ui {
     }
     void LayoutComponent::setSizeWidth(float width)
     {
+        _layoutDirty = true;
         Size ownerSize = _owner->getContentSize();
         ownerSize.width = width;
 
@@ -419,6 +435,7 @@ namespace ui {
     }
     void LayoutComponent::setPercentWidth(float percentWidth)
     {
+        _layoutDirty = true;
         _percentWidth = percentWidth;
 
         if (_usingPercentWidth)
@@ -441,6 +458,7 @@ namespace ui {
     }
     void LayoutComponent::setPercentHeightEnabled(bool isUsed)
     {
+        _layoutDirty = true;
         _usingPercentHeight = isUsed;
         if (_usingPercentHeight)
         {
@@ -454,6 +472,7 @@ namespace ui {
     }
     void LayoutComponent::setSizeHeight(float height)
     {
+        _layoutDirty = true;
         Size ownerSize = _owner->getContentSize();
         ownerSize.height = height;
 
@@ -482,6 +501,7 @@ namespace ui {
     }
     void LayoutComponent::setPercentHeight(float percentHeight)
     {
+        _layoutDirty = true;
         _percentHeight = percentHeight;
 
         if (_usingPercentHeight)
@@ -504,6 +524,7 @@ namespace ui {
     }
     void LayoutComponent::setStretchWidthEnabled(bool isUsed)
     {
+        _layoutDirty = true;
         _usingStretchWidth = isUsed;
         if (_usingStretchWidth)
         {
@@ -517,6 +538,7 @@ namespace ui {
     }
     void LayoutComponent::setStretchHeightEnabled(bool isUsed)
     {
+        _layoutDirty = true;
         _usingStretchHeight = isUsed;
         if (_usingStretchHeight)
         {
@@ -524,7 +546,28 @@ namespace ui {
         }
     }
 
-    void LayoutComponent::refreshLayout()
+    static void refreshChildrenLayout(Node* node, bool forceChildren)
+    {
+        if (forceChildren)
+        {
+            ui::Helper::doLayout(node);
+            return;
+        }
+        
+        if (!ui::Helper::isLayoutSystemActive())
+            return;
+        
+        for (auto& child : node->getChildren())
+        {
+            auto com = child->getComponent(__LAYOUT_COMPONENT_NAME);
+            if (nullptr != com)
+            {
+                static_cast<LayoutComponent*>(com)->refreshLayout(false);
+            }
+        }
+    }
+
+    void LayoutComponent::refreshLayout(bool forceChildren)
     {
         if (!_actived)
             return;
@@ -534,6 +577,12 @@ namespace ui {
             return;
 
         const Size& parentSize = parent->getContentSize();
+
+        // laid out against the same sizes with the same settings already, so is its subtree
+        if (!forceChildren && !_layoutDirty
+            && parentSize.equals(_layoutParentSize) && _owner->getContentSize().equals(_layoutOwnerSize))
+            return;
+
         const Point& ownerAnchor = _owner->getAnchorPoint();
         Size ownerSize = _owner->getContentSize();
         Point ownerPosition = _owner->getPosition();
@@ -640,9 +689,18 @@ namespace ui {
             break;
         }
 
+        // the size setters resize the owner at once, compare with the size of the last refresh
+        const Size previousSize = _layoutOwnerSize;
         _owner->setPosition(ownerPosition);
         _owner->setContentSize(ownerSize);
 
+        _layoutDirty = false;
+        _layoutParentSize = parentSize;
+        _layoutOwnerSize = _owner->getContentSize();
+
+        if (!forceChildren && previousSize.equals(_layoutOwnerSize))
+            return;
+
         if (typeid(*_owner) == typeid(PageView))
         {
             PageView* page = static_cast<PageView*>(_owner);
@@ -651,22 +709,29 @@ namespace ui {
             Vector<Widget*> _widgetVector = page->getItems();
             for(auto& item : _widgetVector)
             {
-                ui::Helper::doLayout(item);
+                refreshChildrenLayout(item, forceChildren);
             }
         }
         else
         {
-            ui::Helper::doLayout(_owner);
+            refreshChildrenLayout(_owner, forceChildren);
         }
     }
 
+    bool LayoutComponent::isLayoutDirty()const
+    {
+        return _layoutDirty;
+    }
+
     void LayoutComponent::setActiveEnabled(bool enable)
     {
+        _layoutDirty = true;
         _actived = enable;
     }
 
     void LayoutComponent::setPercentOnlyEnabled(bool enable)
     {
+        _layoutDirty = true;
         _isPercentOnly = enable;
     }
 }
@@ -387,8 +387,20 @@ namespace ui {
 
         /**
          * Refresh layout of the owner.
+         *
+         * When `forceChildren` is false, a clean component is skipped with its subtree: one that no setter changed
+         * since its last refresh, whose parent and owner kept the sizes it was laid out with. The children of a
+         * refreshed owner are only visited if the owner got a new size, and the same rule applies down the tree.
+         *@param forceChildren True to refresh the layout of every descendant, false to only refresh the dirty branches.
          */
-        void refreshLayout();
+        void refreshLayout(bool forceChildren = true);
+
+        /**
+         * Query whether a layout setting changed since the last refresh.
+         *@return True if a setter changed the layout of the owner since it was last refreshed, false otherwise.
+         * @since v3.14
+         */
+        bool isLayoutDirty()const;
 
     protected:
         Node* getOwnerParent();
@@ -419,6 +431,11 @@ namespace ui {
 
         bool            _actived;
         bool            _isPercentOnly;
+
+        // set by the setters, the sizes of the last refresh tell whether the parent or the owner changed since
+        bool            _layoutDirty;
+        Size            _layoutParentSize;
+        Size            _layoutOwnerSize;
     };
 }
 
@@ -48,7 +48,14 @@ _curSelectedIndex(-1),
 _innerContainerDoLayoutDirty(true),
 _listViewEventListener(nullptr),
 _listViewEventSelector(nullptr),
-_eventCallback(nullptr)
+_eventCallback(nullptr),
+_virtualized(false),
+_virtualizationMargin(0.0f),
+_virtualCountCallback(nullptr),
+_virtualSizeCallback(nullptr),
+_virtualBindCallback(nullptr),
+_virtualFirstIndex(0),
+_virtualItemsDirty(true)
 {
     this->setTouchEnabled(true);
 }
@@ -112,6 +119,21 @@ void ListView::onItemListChanged()
 
 void ListView::updateInnerContainerSize()
 {
+    if (_virtualized)
+    {
+        ssize_t count = _virtualItemSizes.size();
+        float length = (count == 0) ? 0.0f : _virtualItemOffsets[count];
+        if (_direction == Direction::HORIZONTAL)
+        {
+            setInnerContainerSize(Size((count == 0) ? 0.0f : length + _leftPadding + _rightPadding, _contentSize.height));
+        }
+        else
+        {
+            setInnerContainerSize(Size(_contentSize.width, (count == 0) ? 0.0f : length + _topPadding + _bottomPadding));
+        }
+        return;
+    }
+    
     switch (_direction)
     {
         case Direction::VERTICAL:
@@ -342,6 +364,8 @@ void ListView::removeAllChildrenWithCleanup(bool cleanup)
     ScrollView::removeAllChildrenWithCleanup(cleanup);
     _curSelectedIndex = -1;
     _items.clear();
+    _virtualVisibleItems.clear();
+    _virtualReusableItems.clear();
     onItemListChanged();
 }
 
@@ -545,16 +569,18 @@ void ListView::setDirection(Direction dir)
         case Direction::BOTH:
             break;
         case Direction::VERTICAL:
-            setLayoutType(Type::VERTICAL);
+            // Virtualized items are placed by the list itself
+            setLayoutType(_virtualized ? Type::ABSOLUTE : Type::VERTICAL);
             break;
         case Direction::HORIZONTAL:
-            setLayoutType(Type::HORIZONTAL);
+            setLayoutType(_virtualized ? Type::ABSOLUTE : Type::HORIZONTAL);
             break;
         default:
             return;
             break;
     }
     ScrollView::setDirection(dir);
+    requestDoLayout();
 }
     
 void ListView::refreshView()
@@ -569,6 +595,29 @@ void ListView::requestDoLayout()
 
 void ListView::doLayout()
 {
+    if (_virtualized)
+    {
+        if (_innerContainerDoLayoutDirty)
+        {
+            // Margins or the direction may have changed
+            bool vertical = (_direction != Direction::HORIZONTAL);
+            ssize_t count = _virtualItemSizes.size();
+            _virtualItemOffsets.resize(count + 1);
+            float offset = 0.0f;
+            for (ssize_t i = 0; i < count; ++i)
+            {
+                _virtualItemOffsets[i] = offset;
+                offset += (vertical ? _virtualItemSizes[i].height : _virtualItemSizes[i].width) + _itemsMargin;
+            }
+            _virtualItemOffsets[count] = (count == 0) ? 0.0f : offset - _itemsMargin;
+            updateInnerContainerSize();
+            _innerContainerDoLayoutDirty = false;
+            _virtualItemsDirty = true;
+        }
+        updateVirtualItems();
+        return;
+    }
+    
     if(!_innerContainerDoLayoutDirty)
     {
         return;
@@ -651,7 +700,7 @@ void ListView::interceptTouchEvent(TouchEventType event, Widget *sender, Touch*
         {
             if (parent && (parent->getParent() == _innerContainer))
             {
-                _curSelectedIndex = getIndex(parent);
+                _curSelectedIndex = _virtualized ? getVirtualItemIndex(parent) : getIndex(parent);
                 break;
             }
             parent = dynamic_cast<Widget*>(parent->getParent());
@@ -853,14 +902,26 @@ Vec2 ListView::calculateItemDestination(const Vec2& positionRatioInView, Widget*
 
 void ListView::jumpToItem(ssize_t itemIndex, const Vec2& positionRatioInView, const Vec2& itemAnchorPoint)
 {
-    Widget* item = getItem(itemIndex);
-    if (item == nullptr)
+    Vec2 destination;
+    if (_virtualized)
     {
-        return;
+        if (itemIndex < 0 || itemIndex >= getVirtualItemCount())
+        {
+            return;
+        }
+        doLayout();
+        destination = calculateVirtualItemDestination(positionRatioInView, itemIndex, itemAnchorPoint);
+    }
+    else
+    {
+        Widget* item = getItem(itemIndex);
+        if (item == nullptr)
+        {
+            return;
+        }
+        doLayout();
+        destination = calculateItemDestination(positionRatioInView, item, itemAnchorPoint);
     }
-    doLayout();
-
-    Vec2 destination = calculateItemDestination(positionRatioInView, item, itemAnchorPoint);
     if(!_bounceEnabled)
     {
         Vec2 delta = destination - getInnerContainerPosition();
@@ -877,12 +938,25 @@ void ListView::scrollToItem(ssize_t itemIndex, const Vec2& positionRatioInView,
 
 void ListView::scrollToItem(ssize_t itemIndex, const Vec2& positionRatioInView, const Vec2& itemAnchorPoint, float timeInSec)
 {
-    Widget* item = getItem(itemIndex);
-    if (item == nullptr)
+    Vec2 destination;
+    if (_virtualized)
     {
-        return;
+        if (itemIndex < 0 || itemIndex >= getVirtualItemCount())
+        {
+            return;
+        }
+        doLayout();
+        destination = calculateVirtualItemDestination(positionRatioInView, itemIndex, itemAnchorPoint);
+    }
+    else
+    {
+        Widget* item = getItem(itemIndex);
+        if (item == nullptr)
+        {
+            return;
+        }
+        destination = calculateItemDestination(positionRatioInView, item, itemAnchorPoint);
     }
-    Vec2 destination = calculateItemDestination(positionRatioInView, item, itemAnchorPoint);
     startAutoScrollToDestination(destination, timeInSec, true);
 }
 
@@ -893,8 +967,7 @@ ssize_t ListView::getCurSelectedIndex() const
 
 void ListView::setCurSelectedIndex(int itemIndex)
 {
-    Widget* item = getItem(itemIndex);
-    if (item == nullptr)
+    if (_virtualized ? (itemIndex < 0 || itemIndex >= getVirtualItemCount()) : (getItem(itemIndex) == nullptr))
     {
         return;
     }
@@ -939,6 +1012,11 @@ void ListView::copySpecialProperties(Widget *widget)
         _listViewEventListener = listViewEx->_listViewEventListener;
         _listViewEventSelector = listViewEx->_listViewEventSelector;
         _eventCallback = listViewEx->_eventCallback;
+        setVirtualizationMargin(listViewEx->_virtualizationMargin);
+        if (listViewEx->_virtualized)
+        {
+            setVirtualDataSource(listViewEx->_virtualCountCallback, listViewEx->_virtualSizeCallback, listViewEx->_virtualBindCallback);
+        }
     }
 }
 
@@ -1091,5 +1169,223 @@ void ListView::startMagneticScroll()
     scrollToItem(getIndex(pTargetItem), magneticAnchorPoint, magneticAnchorPoint);
 }
 
+void ListView::setVirtualDataSource(const ccListViewItemCountCallback& countCallback,
+                                    const ccListViewItemSizeCallback& sizeCallback,
+                                    const ccListViewBindItemCallback& bindCallback)
+{
+    if (!_virtualized)
+    {
+        removeAllItems();
+        _virtualized = true;
+        setDirection(_direction);
+    }
+    _virtualCountCallback = countCallback;
+    _virtualSizeCallback = sizeCallback;
+    _virtualBindCallback = bindCallback;
+    reloadData();
+}
+
+void ListView::reloadData()
+{
+    if (!_virtualized)
+    {
+        return;
+    }
+    
+    ssize_t count = _virtualCountCallback ? std::max((ssize_t)0, _virtualCountCallback(this)) : 0;
+    _virtualItemSizes.resize(count);
+    for (ssize_t i = 0; i < count; ++i)
+    {
+        _virtualItemSizes[i] = _virtualSizeCallback ? _virtualSizeCallback(this, i) : (_model ? _model->getContentSize() : Size::ZERO);
+    }
+    
+    // Every item in view is bound again
+    for (auto item : _virtualVisibleItems)
+    {
+        if (item)
+        {
+            item->setVisible(false);
+            _virtualReusableItems.pushBack(item);
+        }
+    }
+    _virtualVisibleItems.clear();
+    if (_curSelectedIndex >= count)
+    {
+        _curSelectedIndex = -1;
+    }
+    onItemListChanged();
+    requestDoLayout();
+}
+
+void ListView::setVirtualizationMargin(float margin)
+{
+    _virtualizationMargin = std::max(0.0f, margin);
+}
+
+Widget* ListView::getVirtualItem(ssize_t index) const
+{
+    ssize_t slot = index - _virtualFirstIndex;
+    if (!_virtualized || slot < 0 || slot >= (ssize_t)_virtualVisibleItems.size())
+    {
+        return nullptr;
+    }
+    return _virtualVisibleItems[slot];
+}
+
+ssize_t ListView::getVirtualItemIndex(Widget* item) const
+{
+    for (size_t i = 0; i < _virtualVisibleItems.size(); ++i)
+    {
+        if (_virtualVisibleItems[i] == item)
+        {
+            return _virtualFirstIndex + i;
+        }
+    }
+    return -1;
+}
+
+Rect ListView::getVirtualItemRect(ssize_t index) const
+{
+    const Size& innerSize = _innerContainer->getContentSize();
+    const Size& size = _virtualItemSizes[index];
+    Vec2 origin;
+    if (_direction == Direction::HORIZONTAL)
+    {
+        origin.x = _leftPadding + _virtualItemOffsets[index];
+        switch (_gravity)
+        {
+            case Gravity::BOTTOM:
+                origin.y = _bottomPadding;
+                break;
+            case Gravity::CENTER_VERTICAL:
+                origin.y = _bottomPadding + (innerSize.height - _topPadding - _bottomPadding - size.height) / 2;
+                break;
+            default:
+                origin.y = innerSize.height - _topPadding - size.height;
+                break;
+        }
+    }
+    else
+    {
+        origin.y = innerSize.height - _topPadding - _virtualItemOffsets[index] - size.height;
+        switch (_gravity)
+        {
+            case Gravity::RIGHT:
+                origin.x = innerSize.width - _rightPadding - size.width;
+                break;
+            case Gravity::CENTER_HORIZONTAL:
+                origin.x = _leftPadding + (innerSize.width - _leftPadding - _rightPadding - size.width) / 2;
+                break;
+            default:
+                origin.x = _leftPadding;
+                break;
+        }
+    }
+    return Rect(origin, size);
+}
+
+Vec2 ListView::calculateVirtualItemDestination(const Vec2& positionRatioInView, ssize_t index, const Vec2& itemAnchorPoint)
+{
+    const Size& contentSize = getContentSize();
+    Vec2 positionInView;
+    positionInView.x += contentSize.width * positionRatioInView.x;
+    positionInView.y += contentSize.height * positionRatioInView.y;
+    
+    Rect rect = getVirtualItemRect(index);
+    Vec2 itemPosition = rect.origin + Vec2(rect.size.width * itemAnchorPoint.x, rect.size.height * itemAnchorPoint.y);
+    return -(itemPosition - positionInView);
+}
+
+void ListView::updateVirtualItems()
+{
+    // Find the items in view through binary search on their offsets
+    ssize_t count = _virtualItemSizes.size();
+    ssize_t first = 0, last = -1;
+    if (count > 0)
+    {
+        float viewStart, viewEnd;
+        if (_direction == Direction::HORIZONTAL)
+        {
+            viewStart = -_innerContainer->getLeftBoundary() - _leftPadding;
+            viewEnd = viewStart + _contentSize.width;
+        }
+        else
+        {
+            viewEnd = _innerContainer->getTopBoundary() - _topPadding;
+            // Offsets grow downwards from the top of the inner container
+            viewStart = viewEnd - _contentSize.height;
+        }
+        viewStart -= _virtualizationMargin;
+        viewEnd += _virtualizationMargin;
+        
+        auto offsetsBegin = _virtualItemOffsets.begin();
+        auto offsetsEnd = offsetsBegin + count;
+        first = std::max((ssize_t)0, (ssize_t)(std::upper_bound(offsetsBegin, offsetsEnd, viewStart) - offsetsBegin) - 1);
+        last = (ssize_t)(std::lower_bound(offsetsBegin, offsetsEnd, viewEnd) - offsetsBegin) - 1;
+    }
+    
+    if (!_virtualItemsDirty && first == _virtualFirstIndex && last - first + 1 == (ssize_t)_virtualVisibleItems.size())
+    {
+        return;
+    }
+    
+    // Recycle the items scrolled out of view
+    ssize_t previousCount = _virtualVisibleItems.size();
+    for (ssize_t i = 0; i < previousCount; ++i)
+    {
+        ssize_t index = _virtualFirstIndex + i;
+        Widget* item = _virtualVisibleItems[i];
+        if (item && (index < first || index > last))
+        {
+            item->setVisible(false);
+            _virtualReusableItems.pushBack(item);
+            _virtualVisibleItems[i] = nullptr;
+        }
+    }
+    
+    _virtualVisibleItemsSwap.clear();
+    for (ssize_t index = first; index <= last; ++index)
+    {
+        ssize_t slot = index - _virtualFirstIndex;
+        Widget* item = (slot >= 0 && slot < previousCount) ? _virtualVisibleItems[slot] : nullptr;
+        bool needsPosition = _virtualItemsDirty;
+        if (item == nullptr)
+        {
+            if (!_virtualReusableItems.empty())
+            {
+                // Still retained as a child of the inner container
+                item = _virtualReusableItems.back();
+                _virtualReusableItems.popBack();
+                item->setVisible(true);
+            }
+            else if (_model)
+            {
+                item = _model->clone();
+                ScrollView::addChild(item);
+            }
+            else
+            {
+                CCLOG("ListView: an item model is needed to create the items of a virtualized list!");
+            }
+            
+            if (item && _virtualBindCallback)
+            {
+                _virtualBindCallback(this, item, index);
+            }
+            needsPosition = true;
+        }
+        if (item && needsPosition)
+        {
+            Rect rect = getVirtualItemRect(index);
+            const Vec2& anchor = item->getAnchorPoint();
+            item->setPosition(rect.origin + Vec2(rect.size.width * anchor.x, rect.size.height * anchor.y));
+        }
+        _virtualVisibleItemsSwap.push_back(item);
+    }
+    _virtualVisibleItems.swap(_virtualVisibleItemsSwap);
+    _virtualFirstIndex = first;
+    _virtualItemsDirty = false;
+}
+
 }
 NS_CC_END
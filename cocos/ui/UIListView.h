@@ -107,6 +107,14 @@ public:
      */
     typedef std::function<void(Ref*, EventType)> ccListViewCallback;
     
+    /**
+     * Data source callbacks of a virtualized ListView: the count of items, the size of an item
+     * and the binding of an item widget to the data at an index.
+     */
+    typedef std::function<ssize_t(ListView*)> ccListViewItemCountCallback;
+    typedef std::function<Size(ListView*, ssize_t)> ccListViewItemSizeCallback;
+    typedef std::function<void(ListView*, Widget*, ssize_t)> ccListViewBindItemCallback;
+    
     /**
      * Default constructor
      * @js ctor
@@ -316,6 +324,58 @@ public:
      */
     float getScrollDuration() const;
     
+    /**
+     * @brief Turn the ListView into a virtualized list, like extension::TableView.
+     * Only the items in view plus the virtualization margin are instantiated, by cloning the item model, and bound to their data.
+     * Items scrolled out of view are recycled for other indexes, so the scrolling cost doesn't depend on the item count.
+     * The items added with pushBackCustomItem and friends are removed, and magnetic scrolling isn't supported in this mode.
+     * @param countCallback Returns the count of items.
+     * @param sizeCallback Returns the size of the item at an index, the bound item should have the same size.
+     * @param bindCallback Fills an item widget with the data at an index.
+     * @since v3.14
+     */
+    void setVirtualDataSource(const ccListViewItemCountCallback& countCallback,
+                              const ccListViewItemSizeCallback& sizeCallback,
+                              const ccListViewBindItemCallback& bindCallback);
+    
+    /**
+     * @brief Whether the ListView is virtualized.
+     * @since v3.14
+     */
+    bool isVirtualized() const { return _virtualized; }
+    
+    /**
+     * @brief Query the data source again, e.g. after items were added, removed or resized, and rebind the items in view.
+     * @since v3.14
+     */
+    void reloadData();
+    
+    /**
+     * @brief Set the distance beyond each side of the view in which items of a virtualized list are still instantiated.
+     * @param margin The distance in points, 0 by default.
+     * @since v3.14
+     */
+    void setVirtualizationMargin(float margin);
+    
+    /**
+     * @brief Get the distance in which items of a virtualized list are instantiated beyond the view.
+     * @since v3.14
+     */
+    float getVirtualizationMargin() const { return _virtualizationMargin; }
+    
+    /**
+     * @brief Get the count of items of a virtualized list.
+     * @since v3.14
+     */
+    ssize_t getVirtualItemCount() const { return _virtualItemSizes.size(); }
+    
+    /**
+     * @brief Get the widget bound to an index of a virtualized list.
+     * @return The widget, or nullptr if the item isn't instantiated.
+     * @since v3.14
+     */
+    Widget* getVirtualItem(ssize_t index) const;
+    
     //override methods
     virtual void doLayout() override;
     virtual void requestDoLayout() override;
@@ -487,6 +547,11 @@ protected:
     void startMagneticScroll();
     Vec2 calculateItemDestination(const Vec2& positionRatioInView, Widget* item, const Vec2& itemAnchorPoint);
     
+    Rect getVirtualItemRect(ssize_t index) const;
+    Vec2 calculateVirtualItemDestination(const Vec2& positionRatioInView, ssize_t index, const Vec2& itemAnchorPoint);
+    ssize_t getVirtualItemIndex(Widget* item) const;
+    void updateVirtualItems();
+    
 protected:
     Widget* _model;
     
@@ -524,6 +589,21 @@ protected:
 #pragma warning (pop)
 #endif
     ccListViewCallback _eventCallback;
+    
+    bool _virtualized;
+    float _virtualizationMargin;
+    ccListViewItemCountCallback _virtualCountCallback;
+    ccListViewItemSizeCallback _virtualSizeCallback;
+    ccListViewBindItemCallback _virtualBindCallback;
+    // Offset of each item from the top or left padding along the scroll direction, followed by the total length
+    std::vector<float> _virtualItemOffsets;
+    std::vector<Size> _virtualItemSizes;
+    // Items bound to [_virtualFirstIndex, _virtualFirstIndex + _virtualVisibleItems.size())
+    std::vector<Widget*> _virtualVisibleItems;
+    std::vector<Widget*> _virtualVisibleItemsSwap;
+    ssize_t _virtualFirstIndex;
+    Vector<Widget*> _virtualReusableItems;
+    bool _virtualItemsDirty;
 };
 
 }
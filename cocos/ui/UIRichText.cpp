@@ -883,6 +883,9 @@ const std::string RichText::KEY_ANCHOR_TEXT_GLOW_COLOR("KEY_ANCHOR_TEXT_GLOW_COL
 RichText::RichText()
     : _formatTextDirty(true)
     , _leftSpaceWidth(0.0f)
+    , _formattedElementCount(0)
+    , _formattedWidth(0.0f)
+    , _labelBatchNode(nullptr)
 {
     _defaults[KEY_VERTICAL_SPACE] = 0.0f;
     _defaults[KEY_WRAP_MODE] = static_cast<int>(WrapMode::WRAP_PER_WORD);
@@ -900,6 +903,7 @@ RichText::RichText()
 RichText::~RichText()
 {
     _richElements.clear();
+    CC_SAFE_RELEASE(_labelBatchNode);
 }
     
 RichText* RichText::create()
@@ -967,6 +971,11 @@ bool RichText::initWithXML(const std::string& origxml, const ValueMap& defaults,
     
 void RichText::initRenderer()
 {
+    _labelBatchNode = LabelBatchNode::create();
+    CC_SAFE_RETAIN(_labelBatchNode);
+    // the labels follow the opacity and color of the rich text, as its protected children did
+    _labelBatchNode->setCascadeOpacityEnabled(true);
+    _labelBatchNode->setCascadeColorEnabled(true);
 }
 
 void RichText::insertElement(RichElement *element, int index)
@@ -978,7 +987,11 @@ void RichText::insertElement(RichElement *element, int index)
 void RichText::pushBackElement(RichElement *element)
 {
     _richElements.pushBack(element);
-    _formatTextDirty = true;
+    // Appended elements are formatted after the ones already laid out, unless the rows are realigned
+    if (static_cast<HorizontalAlignment>(_defaults.at(KEY_HORIZONTAL_ALIGNMENT).asInt()) != HorizontalAlignment::LEFT)
+    {
+        _formatTextDirty = true;
+    }
 }
     
 void RichText::removeElement(int index)
@@ -1351,15 +1364,27 @@ void RichText::setOpenUrlHandler(const OpenUrlHandler& handleOpenUrl)
 
 void RichText::formatText()
 {
-    if (_formatTextDirty)
+    if (!_ignoreSize && _formattedWidth != _customSize.width)
     {
-        this->removeAllProtectedChildren();
-        _elementRenders.clear();
-        _lineHeights.clear();
-        if (_ignoreSize)
+        _formatTextDirty = true;
+    }
+    if (_formatTextDirty || _formattedElementCount < _richElements.size())
+    {
+        if (_formatTextDirty)
         {
+            _labelBatchNode->removeAllChildren();
+            this->removeAllProtectedChildren();
+            this->addProtectedChild(_labelBatchNode, 1);
+            _elementRenders.clear();
+            _lineHeights.clear();
+            _formattedElementCount = 0;
+            _formattedWidth = _customSize.width;
             addNewLine();
-            for (ssize_t i=0, size = _richElements.size(); i<size; ++i)
+        }
+        
+        if (_ignoreSize)
+        {
+            for (ssize_t i=_formattedElementCount, size = _richElements.size(); i<size; ++i)
             {
                 RichElement* element = _richElements.at(i);
                 Node* elementRenderer = nullptr;
@@ -1450,8 +1475,7 @@ void RichText::formatText()
         }
         else
         {
-            addNewLine();
-            for (ssize_t i=0, size = _richElements.size(); i<size; ++i)
+            for (ssize_t i=_formattedElementCount, size = _richElements.size(); i<size; ++i)
             {
                 RichElement* element = static_cast<RichElement*>(_richElements.at(i));
                 switch (element->_type)
@@ -1488,6 +1512,7 @@ void RichText::formatText()
                 }
             }
         }
+        _formattedElementCount = _richElements.size();
         formatRenderers();
         _formatTextDirty = false;
     }
@@ -1803,7 +1828,7 @@ void RichText::formatRenderers()
             {
                 iter->setAnchorPoint(Vec2::ZERO);
                 iter->setPosition(nextPosX, nextPosY);
-                this->addProtectedChild(iter, 1);
+                attachRenderer(iter);
                 Size iSize = iter->getContentSize();
                 newContentSizeWidth += iSize.width;
                 nextPosX += iSize.width;
@@ -1854,7 +1879,7 @@ void RichText::formatRenderers()
             {
                 iter->setAnchorPoint(Vec2::ZERO);
                 iter->setPosition(nextPosX, nextPosY);
-                this->addProtectedChild(iter, 1);
+                attachRenderer(iter);
                 nextPosX += iter->getContentSize().width;
             }
             
@@ -1862,8 +1887,7 @@ void RichText::formatRenderers()
         }
     }
     
-    _elementRenders.clear();
-    _lineHeights.clear();
+    // the rows are kept so appended elements continue the last one
     
     if (_ignoreSize)
     {
@@ -1877,6 +1901,24 @@ void RichText::formatRenderers()
     updateContentSizeWithTextureSize(_contentSize);
 }
 
+void RichText::attachRenderer(Node* renderer)
+{
+    // laid out by a previous pass already
+    if (renderer->getParent() != nullptr)
+    {
+        return;
+    }
+    
+    if (dynamic_cast<Label*>(renderer))
+    {
+        _labelBatchNode->addChild(renderer);
+    }
+    else
+    {
+        this->addProtectedChild(renderer, 1);
+    }
+}
+
 namespace {
     float getPaddingAmount(const RichText::HorizontalAlignment alignment, const float leftOver) {
         switch ( alignment ) {
@@ -36,6 +36,7 @@ NS_CC_BEGIN
  */
 
 class Label;
+class LabelBatchNode;
 
 namespace ui {
 
@@ -567,6 +568,7 @@ protected:
     void handleImageRenderer(const std::string& filePath, const Color3B& color, GLubyte opacity, int width, int height, const std::string& url);
     void handleCustomRenderer(Node* renderer);
     void formatRenderers();
+    void attachRenderer(Node* renderer);
     void addNewLine();
 	void doHorizontalAlignment(const Vector<Node*>& row, float rowWidth);
 	float stripTrailingWhitespace(const Vector<Node*>& row);
@@ -576,6 +578,11 @@ protected:
     std::vector<Vector<Node*>> _elementRenders;
     std::vector<float> _lineHeights;
     float _leftSpaceWidth;
+    // the elements laid out in _elementRenders, the appended ones are formatted after them
+    ssize_t _formattedElementCount;
+    float _formattedWidth;
+    // draws the text renderers sharing a font atlas together
+    LabelBatchNode* _labelBatchNode;
 
     ValueMap _defaults;             /*!< default values */
     OpenUrlHandler _handleOpenUrl;  /*!< the callback for open URL */
@@ -74,6 +74,7 @@ _outOfBoundaryAmountDirty(true),
 _scrollBarEnabled(true),
 _verticalScrollBar(nullptr),
 _horizontalScrollBar(nullptr),
+_childrenCullingEnabled(true),
 _scrollViewEventListener(nullptr),
 _scrollViewEventSelector(nullptr),
 _eventCallback(nullptr)
@@ -1056,6 +1057,75 @@ void ScrollView::onTouchCancelled(Touch *touch, Event *unusedEvent)
     _isInterceptTouch = false;
 }
 
+void ScrollView::setChildrenCullingEnabled(bool enabled)
+{
+    _childrenCullingEnabled = enabled;
+    if (!enabled)
+    {
+        _innerContainer->setChildrenCullingRect(Rect::ZERO);
+    }
+}
+
+bool ScrollView::isClippingNeeded(const Rect& viewRect) const
+{
+    // The background of the inner container is as large as the inner container
+    if (_innerContainer->getBackGroundColorType() != BackGroundColorType::NONE
+        || _innerContainer->getBackGroundImageTextureSize().width > 0)
+    {
+        return true;
+    }
+    
+    for (const auto& child : _innerContainer->getChildren())
+    {
+        if (!child->isVisible())
+        {
+            continue;
+        }
+        const Size& size = child->getContentSize();
+        if (size.width <= 0 || size.height <= 0)
+        {
+            return true;
+        }
+        Rect box = child->getBoundingBox();
+        bool inside = box.getMinX() >= viewRect.getMinX() && box.getMaxX() <= viewRect.getMaxX()
+            && box.getMinY() >= viewRect.getMinY() && box.getMaxY() <= viewRect.getMaxY();
+        if (!inside && viewRect.intersectsRect(box))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void ScrollView::visit(Renderer *renderer, const Mat4 &parentTransform, uint32_t parentFlags)
+{
+    if (!_visible)
+    {
+        return;
+    }
+    if (!_childrenCullingEnabled)
+    {
+        Layout::visit(renderer, parentTransform, parentFlags);
+        return;
+    }
+    
+    // Lay out first so the inner container is where it will be drawn
+    adaptRenderers();
+    doLayout();
+    
+    Rect viewRect = RectApplyTransform(Rect(Vec2::ZERO, _contentSize), _innerContainer->getParentToNodeTransform());
+    _innerContainer->setChildrenCullingRect(viewRect);
+    
+    if (_clippingEnabled && !isClippingNeeded(viewRect))
+    {
+        Widget::visit(renderer, parentTransform, parentFlags);
+    }
+    else
+    {
+        Layout::visit(renderer, parentTransform, parentFlags);
+    }
+}
+
 void ScrollView::update(float dt)
 {
     if (_autoScrolling)
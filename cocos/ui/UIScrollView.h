@@ -553,6 +553,28 @@ public:
      */
     float getTouchTotalTimeThreshold() const;
     
+    /**
+     * @brief Toggle culling of the children out of view.
+     *
+     * When enabled, children of the inner container outside of the view are not visited,
+     * and clipping is skipped while every child in view lies completely inside it.
+     * Children are assumed to draw within their bounding box.
+     *
+     * @param enabled True to cull the children out of view, false otherwise. It is enabled by default.
+     * @since v3.14
+     */
+    void setChildrenCullingEnabled(bool enabled);
+    
+    /**
+     * @brief Query whether children out of view are culled.
+     *
+     * @return True if children out of view are culled, false otherwise.
+     * @since v3.14
+     */
+    bool isChildrenCullingEnabled() const { return _childrenCullingEnabled; }
+    
+    virtual void visit(Renderer *renderer, const Mat4 &parentTransform, uint32_t parentFlags) override;
+    
     /**
      * Set layout type for scrollview.
      *
@@ -668,6 +690,7 @@ protected:
 protected:
     virtual float getAutoScrollStopEpsilon() const;
     bool fltEqualZero(const Vec2& point) const;
+    bool isClippingNeeded(const Rect& viewRect) const;
     Layout* _innerContainer;
 
     Direction _direction;
@@ -710,6 +733,8 @@ protected:
     ScrollViewBar* _verticalScrollBar;
     ScrollViewBar* _horizontalScrollBar;
     
+    bool _childrenCullingEnabled;
+    
     Ref* _scrollViewEventListener;
 #if defined(__GNUC__) && ((__GNUC__ >= 4) || ((__GNUC__ == 3) && (__GNUC_MINOR__ >= 1)))
 #pragma GCC diagnostic ignored "-Wdeprecated-declarations"
@@ -332,6 +332,17 @@ void Widget::setContentSize(const cocos2d::Size &contentSize)
         _sizePercent.set(spx, spy);
     }
     onSizeChanged();
+    requestParentLayout();
+}
+
+void Widget::requestParentLayout()
+{
+    // Siblings in a linear or relative layout are placed according to the size of this widget
+    Layout* layout = dynamic_cast<Layout*>(_parent);
+    if (layout && layout->getLayoutType() != Layout::Type::ABSOLUTE)
+    {
+        layout->requestDoLayout();
+    }
 }
 
 void Widget::setSize(const Size &size)
@@ -346,7 +357,7 @@ void Widget::setSizePercent(const Vec2 &percent)
         auto component = this->getOrCreateLayoutComponent();
         component->setUsingPercentContentSize(true);
         component->setPercentContentSize(percent);
-        component->refreshLayout();
+        component->refreshLayout(false);
     }
     else
     {
@@ -1057,7 +1068,7 @@ void Widget::setPositionPercent(const Vec2 &percent)
         auto component = this->getOrCreateLayoutComponent();
         component->setPositionPercentX(percent.x);
         component->setPositionPercentY(percent.y);
-        component->refreshLayout();
+        component->refreshLayout(false);
     }
     else
     {
@@ -1166,6 +1177,7 @@ void Widget::setLayoutParameter(LayoutParameter *parameter)
     }
     _layoutParameterDictionary.insert((int)parameter->getLayoutType(), parameter);
     _layoutParameterType = parameter->getLayoutType();
+    requestParentLayout();
 }
 
 LayoutParameter* Widget::getLayoutParameter()const
@@ -918,6 +918,8 @@ protected:
     
     Widget* getWidgetParent();
     void updateContentSizeWithTextureSize(const Size& size);
+    /** Marks the parent layout dirty when it places its children by their size or layout parameter. */
+    void requestParentLayout();
     
     bool isAncestorsEnabled();
     Widget* getAncestorWidget(Node* node);
@@ -41,6 +41,7 @@ NS_CC_BEGIN
 
 VRGenericRenderer::VRGenericRenderer()
 : _vignetteEnabled(true)
+, _singleVisitEnabled(true)
 , _distortion(nullptr)
 , _leftDistortionMesh(nullptr)
 , _rightDistortionMesh(nullptr)
@@ -116,12 +117,21 @@ void VRGenericRenderer::render(Scene* scene, Renderer* renderer)
     rightTransform *= headRotation;
 
     _fb->applyFBO();
-    auto defaultVP = Camera::getDefaultViewport();
-    Camera::setDefaultViewport(_leftEye.viewport);
-    scene->render(renderer, leftTransform, nullptr);
-    Camera::setDefaultViewport(_rightEye.viewport);
-    scene->render(renderer, rightTransform, nullptr);
-    Camera::setDefaultViewport(defaultVP);
+    if (_singleVisitEnabled)
+    {
+        const Mat4 eyeTransforms[] = { leftTransform, rightTransform };
+        const experimental::Viewport eyeViewports[] = { _leftEye.viewport, _rightEye.viewport };
+        scene->renderStereo(renderer, eyeTransforms, eyeViewports, 2);
+    }
+    else
+    {
+        auto defaultVP = Camera::getDefaultViewport();
+        Camera::setDefaultViewport(_leftEye.viewport);
+        scene->render(renderer, leftTransform, nullptr);
+        Camera::setDefaultViewport(_rightEye.viewport);
+        scene->render(renderer, rightTransform, nullptr);
+        Camera::setDefaultViewport(defaultVP);
+    }
     _fb->restoreFBO();
 
     auto texture = _fb->getRenderTarget()->getTexture();
@@ -129,14 +139,14 @@ void VRGenericRenderer::render(Scene* scene, Renderer* renderer)
     _glProgramState->apply(Mat4::IDENTITY);
 
     GLint origViewport[4];
-    glGetIntegerv(GL_VIEWPORT, origViewport);
-    glViewport(0, 0, _texSize.width, _texSize.height);
+    GL::getViewport(origViewport);
+    GL::viewport(0, 0, _texSize.width, _texSize.height);
 
     renderDistortionMesh(_leftDistortionMesh, texture);
     renderDistortionMesh(_rightDistortionMesh, texture);
 
 
-    glViewport(origViewport[0], origViewport[1], origViewport[2], origViewport[3]);
+    GL::viewport(origViewport[0], origViewport[1], origViewport[2], origViewport[3]);
 
     glBindBuffer(GL_ARRAY_BUFFER, 0);
     glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
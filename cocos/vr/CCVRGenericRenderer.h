@@ -61,6 +61,14 @@ public:
     virtual void render(Scene* scene, Renderer* renderer) override;
     virtual VRIHeadTracker* getHeadTracker() override;
 
+    /** Visits the scene once for both eyes and only executes its render commands twice, with the view projection
+     * matrix of each eye, see Scene::renderStereo(). It halves the CPU cost of the scene, true by default.
+     * @since v3.14
+     */
+    void setSingleVisitEnabled(bool enabled) { _singleVisitEnabled = enabled; }
+    /** @since v3.14 */
+    bool isSingleVisitEnabled() const { return _singleVisitEnabled; }
+
 protected:
     void setupGLProgram();
     void renderDistortionMesh(DistortionMesh *mesh, Texture2D* texture);
@@ -74,6 +82,7 @@ protected:
     DistortionMesh* _rightDistortionMesh;
     Distortion* _distortion;
     bool _vignetteEnabled;
+    bool _singleVisitEnabled;
     
     GLProgramState* _glProgramState;
     VRGenericHeadTracker* _headTracker;
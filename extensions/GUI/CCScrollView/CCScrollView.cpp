@@ -31,6 +31,7 @@
 #include "base/CCDirector.h"
 #include "base/CCEventDispatcher.h"
 #include "renderer/CCRenderer.h"
+#include "renderer/ccGLStateCache.h"
 
 #include <algorithm>
 
@@ -597,7 +598,7 @@ void ScrollView::onBeforeDraw()
                 }
             }
             else {
-                glEnable(GL_SCISSOR_TEST);
+                GL::enable(GL_SCISSOR_TEST);
                 glview->setScissorInPoints(frame.origin.x, frame.origin.y, frame.size.width, frame.size.height);
             }
         }
@@ -625,7 +626,7 @@ void ScrollView::onAfterDraw()
                 glview->setScissorInPoints(_parentScissorRect.origin.x, _parentScissorRect.origin.y, _parentScissorRect.size.width, _parentScissorRect.size.height);
             }
             else {
-                glDisable(GL_SCISSOR_TEST);
+                GL::disable(GL_SCISSOR_TEST);
             }
         }
     }
@@ -45,6 +45,12 @@ Size TableViewDataSource::cellSizeForTable(TableView* /*table*/) {
     return Size::ZERO;
 }
 
+void TableViewDataSource::tableCellsPrefetchForIndices(TableView* /*table*/, const std::vector<ssize_t>& /*indices*/)
+{}
+
+void TableViewDataSource::tableCellsCancelPrefetchForIndices(TableView* /*table*/, const std::vector<ssize_t>& /*indices*/)
+{}
+
 TableView* TableView::create()
 {
     return TableView::create(nullptr, Size::ZERO);
@@ -89,12 +95,22 @@ TableView::TableView()
 , _tableViewDelegate(nullptr)
 , _oldDirection(Direction::NONE)
 , _isUsedCellsDirty(false)
+, _prefetchDistance(0)
+, _prefetchBegin(0)
+, _prefetchEnd(0)
+, _lastStartIdx(0)
+, _prefetchForward(true)
+, _prefetchTask(0)
 {
 
 }
 
 TableView::~TableView()
 {
+    if (_prefetchTask != 0)
+    {
+        TimeSlicedQueue::getInstance()->cancel(_prefetchTask);
+    }
     CC_SAFE_DELETE(_indices);
 }
 
@@ -118,6 +134,7 @@ TableView::VerticalFillOrder TableView::getVerticalFillOrder()
 void TableView::reloadData()
 {
     _oldDirection = Direction::NONE;
+    this->_clearPrefetchedCells();
 
     for(const auto &cell : _cellsUsed) {
         if(_tableViewDelegate != nullptr) {
@@ -135,6 +152,7 @@ void TableView::reloadData()
 
     _indices->clear();
     _cellsUsed.clear();
+    _cellsByIndex.clear();
     
     this->_updateCellPositions();
     this->_updateContentSize();
@@ -146,18 +164,17 @@ void TableView::reloadData()
 
 TableViewCell *TableView::cellAtIndex(ssize_t idx)
 {
-    if (_indices->find(idx) != _indices->end())
+    auto iter = _cellsByIndex.find(idx);
+    return iter != _cellsByIndex.end() ? iter->second : nullptr;
+}
+
+void TableView::setPrefetchDistance(ssize_t cellCount)
+{
+    _prefetchDistance = MAX(cellCount, 0);
+    if (_prefetchDistance == 0)
     {
-        for (const auto& cell : _cellsUsed)
-        {
-            if (cell->getIdx() == idx)
-            {
-                return cell;
-            }
-        }
+        this->_clearPrefetchedCells();
     }
-
-    return nullptr;
 }
 
 void TableView::updateCellAtIndex(ssize_t idx)
@@ -177,6 +194,16 @@ void TableView::updateCellAtIndex(ssize_t idx)
     {
         this->_moveCellOutOfSight(cell);
     }
+    // a prepared cell may show the old content
+    auto prefetched = _cellsPrefetched.find(idx);
+    if (prefetched != _cellsPrefetched.end())
+    {
+        cell = prefetched->second;
+        cell->retain();
+        _cellsPrefetched.erase(prefetched);
+        this->_recycleCell(cell);
+        cell->release();
+    }
     cell = _dataSource->tableCellAtIndex(this, idx);
     this->_setIndexForCell(idx, cell);
     this->_addCellIfNecessary(cell);
@@ -197,6 +224,9 @@ void TableView::insertCellAtIndex(ssize_t idx)
 
     long newIdx = 0;
 
+    // the prepared cells are for the old indices
+    this->_clearPrefetchedCells();
+
     auto cell = cellAtIndex(idx);
     if (cell)
     {
@@ -207,6 +237,7 @@ void TableView::insertCellAtIndex(ssize_t idx)
             cell = _cellsUsed.at(i);
             this->_setIndexForCell(cell->getIdx()+1, cell);
         }
+        this->_rebuildCellIndices();
     }
 
     //insert a new cell
@@ -241,17 +272,21 @@ void TableView::removeCellAtIndex(ssize_t idx)
 
     newIdx = _cellsUsed.getIndex(cell);
 
+    // the prepared cells are for the old indices
+    this->_clearPrefetchedCells();
+
     //remove first
     this->_moveCellOutOfSight(cell);
 
     _indices->erase(idx);
     this->_updateCellPositions();
 
-    for (ssize_t i = _cellsUsed.size()-1; i > newIdx; i--)
+    for (ssize_t i = _cellsUsed.size()-1; i >= newIdx; i--)
     {
         cell = _cellsUsed.at(i);
         this->_setIndexForCell(cell->getIdx()-1, cell);
     }
+    this->_rebuildCellIndices();
 }
 
 TableViewCell *TableView::dequeueCell()
@@ -261,9 +296,10 @@ TableViewCell *TableView::dequeueCell()
     if (_cellsFreed.empty()) {
         cell = nullptr;
     } else {
-        cell = _cellsFreed.at(0);
+        // from the back, so dequeuing doesn't move the other free cells
+        cell = _cellsFreed.back();
         cell->retain();
-        _cellsFreed.erase(0);
+        _cellsFreed.popBack();
         cell->autorelease();
     }
     return cell;
@@ -277,9 +313,21 @@ void TableView::_addCellIfNecessary(TableViewCell * cell)
     }
     _cellsUsed.pushBack(cell);
     _indices->insert(cell->getIdx());
+    _cellsByIndex[cell->getIdx()] = cell;
     _isUsedCellsDirty = true;
 }
 
+void TableView::_rebuildCellIndices()
+{
+    _indices->clear();
+    _cellsByIndex.clear();
+    for (const auto& cell : _cellsUsed)
+    {
+        _indices->insert(cell->getIdx());
+        _cellsByIndex[cell->getIdx()] = cell;
+    }
+}
+
 void TableView::_updateContentSize()
 {
     Size size = Size::ZERO;
@@ -412,24 +460,191 @@ long TableView::__indexFromOffset(Vec2 offset)
 }
 
 void TableView::_moveCellOutOfSight(TableViewCell *cell)
+{
+    cell->retain();
+    _cellsUsed.eraseObject(cell);
+    _isUsedCellsDirty = true;
+
+    _indices->erase(cell->getIdx());
+    auto iter = _cellsByIndex.find(cell->getIdx());
+    if (iter != _cellsByIndex.end() && iter->second == cell)
+    {
+        _cellsByIndex.erase(iter);
+    }
+    this->_recycleCell(cell);
+    cell->release();
+}
+
+void TableView::_recycleCell(TableViewCell *cell)
 {
     if(_tableViewDelegate != nullptr) {
         _tableViewDelegate->tableCellWillRecycle(this, cell);
     }
 
     _cellsFreed.pushBack(cell);
-    _cellsUsed.eraseObject(cell);
-    _isUsedCellsDirty = true;
-    
-    _indices->erase(cell->getIdx());
     cell->reset();
-    
+
     if (cell->getParent() == this->getContainer())
     {
         this->getContainer()->removeChild(cell, false);
     }
 }
 
+void TableView::_showCellAtIndex(ssize_t index)
+{
+    auto prefetched = _cellsPrefetched.find(index);
+    if (prefetched == _cellsPrefetched.end())
+    {
+        this->updateCellAtIndex(index);
+        return;
+    }
+
+    TableViewCell *cell = prefetched->second;
+    cell->retain();
+    _cellsPrefetched.erase(prefetched);
+    this->_setIndexForCell(index, cell);
+    this->_addCellIfNecessary(cell);
+    cell->release();
+}
+
+void TableView::_updatePrefetch(ssize_t startIdx, ssize_t endIdx, ssize_t countOfItems)
+{
+    // the prefetch keeps its direction while the visible cells don't change
+    if (startIdx != _lastStartIdx)
+    {
+        _prefetchForward = startIdx > _lastStartIdx;
+        _lastStartIdx = startIdx;
+    }
+
+    ssize_t begin, end;
+    if (_prefetchForward)
+    {
+        begin = endIdx + 1;
+        end = MIN(countOfItems, begin + _prefetchDistance);
+    }
+    else
+    {
+        end = startIdx;
+        begin = MAX(0, end - _prefetchDistance);
+    }
+    end = MAX(begin, end);
+
+    // the prepared cells out of the new range go back to the free cells
+    std::vector<ssize_t> cancelled;
+    for (ssize_t i = _prefetchBegin; i < _prefetchEnd; ++i)
+    {
+        if ((i < begin || i >= end) && (i < startIdx || i > endIdx))
+        {
+            cancelled.push_back(i);
+        }
+    }
+    for (auto iter = _cellsPrefetched.begin(); iter != _cellsPrefetched.end();)
+    {
+        if (iter->first < begin || iter->first >= end)
+        {
+            TableViewCell *cell = iter->second;
+            cell->retain();
+            iter = _cellsPrefetched.erase(iter);
+            this->_recycleCell(cell);
+            cell->release();
+        }
+        else
+        {
+            ++iter;
+        }
+    }
+
+    std::vector<ssize_t> added;
+    _prefetchQueue.clear();
+    for (ssize_t n = 0; n < end - begin; ++n)
+    {
+        ssize_t i = _prefetchForward ? begin + n : end - 1 - n;
+        if (i < _prefetchBegin || i >= _prefetchEnd)
+        {
+            added.push_back(i);
+        }
+        if (_cellsPrefetched.find(i) == _cellsPrefetched.end())
+        {
+            _prefetchQueue.push_back(i);
+        }
+    }
+    _prefetchBegin = begin;
+    _prefetchEnd = end;
+
+    if (!cancelled.empty())
+    {
+        _dataSource->tableCellsCancelPrefetchForIndices(this, cancelled);
+    }
+    if (!added.empty())
+    {
+        _dataSource->tableCellsPrefetchForIndices(this, added);
+    }
+
+    if (!_prefetchQueue.empty() && _prefetchTask == 0)
+    {
+        auto queue = TimeSlicedQueue::getInstance();
+        _prefetchTask = queue->addTask([this](float& /*progress*/) {
+            return this->_prefetchNextCell();
+        }, 0, [this](bool /*done*/) {
+            _prefetchTask = 0;
+        });
+    }
+}
+
+bool TableView::_prefetchNextCell()
+{
+    // a cell per step, the queue runs as many steps as its frame budget allows
+    while (!_prefetchQueue.empty())
+    {
+        ssize_t index = _prefetchQueue.front();
+        _prefetchQueue.pop_front();
+        if (_cellsByIndex.find(index) != _cellsByIndex.end() || _cellsPrefetched.find(index) != _cellsPrefetched.end())
+        {
+            continue;
+        }
+
+        TableViewCell *cell = _dataSource->tableCellAtIndex(this, index);
+        if (cell)
+        {
+            cell->setIdx(index);
+            _cellsPrefetched.insert(index, cell);
+        }
+        break;
+    }
+    return _prefetchQueue.empty();
+}
+
+void TableView::_clearPrefetchedCells()
+{
+    if (_prefetchTask != 0)
+    {
+        TimeSlicedQueue::getInstance()->cancel(_prefetchTask);
+    }
+    _prefetchQueue.clear();
+
+    std::vector<ssize_t> cancelled;
+    for (ssize_t i = _prefetchBegin; i < _prefetchEnd; ++i)
+    {
+        if (_cellsByIndex.find(i) == _cellsByIndex.end())
+        {
+            cancelled.push_back(i);
+        }
+    }
+    _prefetchBegin = _prefetchEnd = 0;
+
+    auto prefetched = _cellsPrefetched;
+    _cellsPrefetched.clear();
+    for (const auto& element : prefetched)
+    {
+        this->_recycleCell(element.second);
+    }
+
+    if (!cancelled.empty() && _dataSource)
+    {
+        _dataSource->tableCellsCancelPrefetchForIndices(this, cancelled);
+    }
+}
+
 void TableView::_setIndexForCell(ssize_t index, TableViewCell *cell)
 {
     cell->setAnchorPoint(Vec2(0.0f, 0.0f));
@@ -572,11 +787,16 @@ void TableView::scrollViewDidScroll(ScrollView* /*view*/)
 
     for (long i = startIdx; i <= endIdx; i++)
     {
-        if (_indices->find(i) != _indices->end())
+        if (_cellsByIndex.find(i) != _cellsByIndex.end())
         {
             continue;
         }
-        this->updateCellAtIndex(i);
+        this->_showCellAtIndex(i);
+    }
+
+    if (_prefetchDistance > 0)
+    {
+        this->_updatePrefetch(startIdx, endIdx, countOfItems);
     }
 
     if(_tableViewDelegate != nullptr) {
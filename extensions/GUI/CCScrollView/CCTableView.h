@@ -29,8 +29,12 @@
 #include "CCScrollView.h"
 #include "CCTableViewCell.h"
 #include "extensions/ExtensionExport.h"
+#include "base/CCMap.h"
+#include "base/CCTimeSlicedQueue.h"
 
+#include <deque>
 #include <set>
+#include <unordered_map>
 #include <vector>
 
 /**
@@ -131,6 +135,21 @@ public:
      * @return number of cells
      */
     virtual ssize_t numberOfCellsInTableView(TableView *table) = 0;
+    /**
+     * Called with the indices of the cells about to be shown by the scroll, before their cells are
+     * prepared, so their data can start loading, e.g. their textures with TextureCache::addImageAsync().
+     * Only called when the table has a prefetch distance. Does nothing by default.
+     *
+     * @param indices the indices, the nearest to the visible cells first
+     * @since v3.14
+     */
+    virtual void tableCellsPrefetchForIndices(TableView* table, const std::vector<ssize_t>& indices);
+    /**
+     * Called with the prefetched indices that won't be shown soon, e.g. after the scroll changed direction.
+     * Does nothing by default.
+     * @since v3.14
+     */
+    virtual void tableCellsCancelPrefetchForIndices(TableView* table, const std::vector<ssize_t>& indices);
 
 };
 
@@ -266,6 +285,21 @@ public:
      * @return a cell at a given index
      */
     TableViewCell *cellAtIndex(ssize_t idx);
+    /**
+     * Sets how many cells are prepared ahead of the visible ones in the scroll direction.
+     * The cells are asked to the data source a few per frame within the budget of the TimeSlicedQueue,
+     * so a fast scroll through a large table doesn't create all the cells it reaches in a single frame.
+     *
+     * @param cellCount the number of cells prepared ahead, 0 by default disables the prefetch
+     * @since v3.14
+     */
+    void setPrefetchDistance(ssize_t cellCount);
+    ssize_t getPrefetchDistance() const { return _prefetchDistance; }
+    /**
+     * Returns the number of prepared cells waiting to be shown.
+     * @since v3.14
+     */
+    ssize_t getPrefetchedCellCount() const { return _cellsPrefetched.size(); }
 
     // Overrides
     virtual void scrollViewDidScroll(ScrollView* view) override;
@@ -286,6 +320,12 @@ protected:
     void _addCellIfNecessary(TableViewCell * cell);
 
     void _updateCellPositions();
+    void _rebuildCellIndices();
+    void _showCellAtIndex(ssize_t index);
+    void _recycleCell(TableViewCell *cell);
+    void _updatePrefetch(ssize_t startIdx, ssize_t endIdx, ssize_t countOfItems);
+    void _clearPrefetchedCells();
+    bool _prefetchNextCell();
 
 
     TableViewCell *_touchedCell;
@@ -312,6 +352,27 @@ protected:
      * free list of cells
      */
     Vector<TableViewCell*> _cellsFreed;
+    /**
+     * the cells of _cellsUsed by index
+     */
+    std::unordered_map<ssize_t, TableViewCell*> _cellsByIndex;
+    /**
+     * cells prepared ahead of the scroll, not in the container yet
+     */
+    Map<ssize_t, TableViewCell*> _cellsPrefetched;
+    /**
+     * indices waiting for their cell to be prepared, the nearest first
+     */
+    std::deque<ssize_t> _prefetchQueue;
+    ssize_t _prefetchDistance;
+    /**
+     * the prefetched indices told to the data source, from _prefetchBegin to _prefetchEnd excluded
+     */
+    ssize_t _prefetchBegin;
+    ssize_t _prefetchEnd;
+    ssize_t _lastStartIdx;
+    bool _prefetchForward;
+    TimeSlicedQueue::TaskId _prefetchTask;
     /**
      * weak link to the data source object
      */
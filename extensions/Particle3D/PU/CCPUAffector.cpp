@@ -218,17 +218,27 @@ void PUAffector::process( PUParticle3D* particle, float delta, bool firstParticl
         firstParticleUpdate(particle, delta);
     }
 
-    if (!_excludedEmitters.empty() && particle->parentEmitter){
-        // Return if the emitter which emits this particle is part of the vector
-        std::string emitterName = particle->parentEmitter->getName();
-        auto iter = std::find(_excludedEmitters.begin(), _excludedEmitters.end(), emitterName);
-        if (iter != _excludedEmitters.end())
-        {
-            return;
-        }
-    }
+    // Return if the emitter which emits this particle is part of the vector
+    if (isExcluded(particle))
+        return;
 
     updatePUAffector(particle, delta);
 }
 
+void PUAffector::processParticles( PUParticle3D* const* particles, size_t count, float delta, bool firstParticle )
+{
+    for (size_t i = 0; i < count; ++i){
+        process(particles[i], delta, firstParticle && i == 0);
+    }
+}
+
+bool PUAffector::isExcluded( const PUParticle3D* particle ) const
+{
+    if (_excludedEmitters.empty() || !particle->parentEmitter)
+        return false;
+
+    const std::string& emitterName = particle->parentEmitter->getName();
+    return std::find(_excludedEmitters.begin(), _excludedEmitters.end(), emitterName) != _excludedEmitters.end();
+}
+
 NS_CC_END
@@ -65,6 +65,11 @@ public:
     virtual void firstParticleUpdate(PUParticle3D *particle, float deltaTime);
     virtual void initParticleForEmission(PUParticle3D* particle);
     void process(PUParticle3D* particle, float delta, bool firstParticle);
+    /** Affects the live particles of a pool at once, used when PUParticleSystem3D batches the affectors.
+        The default implementation calls process() for each particle, affectors override it with a loop
+        that hoists the per-frame values out of the particle loop.
+    */
+    virtual void processParticles(PUParticle3D* const* particles, size_t count, float delta, bool firstParticle);
 
     void setLocalPosition(const Vec3 &pos) { _position = pos; };
     const Vec3 getLocalPosition() const { return _position; };
@@ -112,6 +117,7 @@ CC_CONSTRUCTOR_ACCESS:
 protected:
 
     float calculateAffectSpecialisationFactor (const PUParticle3D* particle);
+    bool isExcluded(const PUParticle3D* particle) const;
     
 protected:
 
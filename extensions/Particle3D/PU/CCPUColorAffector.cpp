@@ -125,6 +125,27 @@ void PUColorAffector::updatePUAffector( PUParticle3D *particle, float /*deltaTim
     }
 }
 
+void PUColorAffector::processParticles( PUParticle3D* const* particles, size_t count, float deltaTime, bool firstParticle )
+{
+    if (!_excludedEmitters.empty()){
+        PUAffector::processParticles(particles, count, deltaTime, firstParticle);
+        return;
+    }
+
+    if (firstParticle && count > 0){
+        firstParticleUpdate(particles[0], deltaTime);
+    }
+
+    if (_colorMap.empty())
+        return;
+
+    // qualified, so the compiler can inline it in the loop
+    for (size_t i = 0; i < count; ++i)
+    {
+        PUColorAffector::updatePUAffector(particles[i], deltaTime);
+    }
+}
+
 PUColorAffector* PUColorAffector::create()
 {
     auto pca = new (std::nothrow) PUColorAffector();
@@ -50,6 +50,7 @@ public:
     static PUColorAffector* create();
 
     virtual void updatePUAffector(PUParticle3D *particle, float deltaTime) override;
+    virtual void processParticles(PUParticle3D* const* particles, size_t count, float deltaTime, bool firstParticle) override;
 
     /** 
     */
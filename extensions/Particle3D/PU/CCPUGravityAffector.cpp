@@ -76,6 +76,32 @@ void PUGravityAffector::updatePUAffector( PUParticle3D *particle, float deltaTim
     }
 }
 
+void PUGravityAffector::processParticles( PUParticle3D* const* particles, size_t count, float deltaTime, bool firstParticle )
+{
+    if (!_excludedEmitters.empty()){
+        PUAffector::processParticles(particles, count, deltaTime, firstParticle);
+        return;
+    }
+
+    if (firstParticle && count > 0){
+        firstParticleUpdate(particles[0], deltaTime);
+    }
+
+    float scaleVelocity = (static_cast<PUParticleSystem3D *>(_particleSystem))->getParticleSystemScaleVelocity();
+    float gravity = scaleVelocity * _gravity * _mass * deltaTime;
+    for (size_t i = 0; i < count; ++i)
+    {
+        PUParticle3D *particle = particles[i];
+        Vec3 distance = _derivedPosition - particle->position;
+        float length = distance.lengthSquared();
+        if (length > 0)
+        {
+            float factor = _affectSpecialisation == AFSP_DEFAULT ? 1.0f : calculateAffectSpecialisationFactor(particle);
+            particle->direction += (gravity * particle->mass / length * factor) * distance;
+        }
+    }
+}
+
 void PUGravityAffector::preUpdateAffector( float /*deltaTime*/ )
 {
     getDerivedPosition();
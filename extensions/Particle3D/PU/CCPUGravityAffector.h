@@ -42,6 +42,7 @@ public:
 
     virtual void preUpdateAffector(float deltaTime) override;
     virtual void updatePUAffector(PUParticle3D *particle, float deltaTime) override;
+    virtual void processParticles(PUParticle3D* const* particles, size_t count, float deltaTime, bool firstParticle) override;
 
     /** 
     */
@@ -55,6 +55,43 @@ void PULinearForceAffector::updatePUAffector( PUParticle3D *particle, float /*de
 
 }
 
+void PULinearForceAffector::processParticles( PUParticle3D* const* particles, size_t count, float deltaTime, bool firstParticle )
+{
+    if (!_excludedEmitters.empty()){
+        PUAffector::processParticles(particles, count, deltaTime, firstParticle);
+        return;
+    }
+
+    if (firstParticle && count > 0){
+        firstParticleUpdate(particles[0], deltaTime);
+    }
+
+    if (_forceApplication == FA_ADD)
+    {
+        if (_affectSpecialisation == AFSP_DEFAULT)
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                particles[i]->direction += _scaledVector;
+            }
+        }
+        else
+        {
+            for (size_t i = 0; i < count; ++i)
+            {
+                particles[i]->direction += _scaledVector * calculateAffectSpecialisationFactor(particles[i]);
+            }
+        }
+    }
+    else
+    {
+        for (size_t i = 0; i < count; ++i)
+        {
+            particles[i]->direction = (particles[i]->direction + _forceVector) / 2;
+        }
+    }
+}
+
 PULinearForceAffector* PULinearForceAffector::create()
 {
     auto plfa = new (std::nothrow) PULinearForceAffector();
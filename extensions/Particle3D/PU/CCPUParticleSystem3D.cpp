@@ -37,6 +37,12 @@
 #include "extensions/Particle3D/PU/CCPUObserverManager.h"
 #include "extensions/Particle3D/PU/CCPUBehaviour.h"
 #include "platform/CCFileUtils.h"
+#include "base/CCAsyncTaskPool.h"
+#include "base/CCDirector.h"
+#include "base/CCEventDispatcher.h"
+#include "base/CCEventListenerCustom.h"
+
+#include <algorithm>
 
 NS_CC_BEGIN
 
@@ -175,6 +181,11 @@ const unsigned int PUParticleSystem3D::DEFAULT_PARTICLE_QUOTA = 500;
 const unsigned int PUParticleSystem3D::DEFAULT_EMITTED_EMITTER_QUOTA = 50;
 const unsigned int PUParticleSystem3D::DEFAULT_EMITTED_SYSTEM_QUOTA = 10;
 const float PUParticleSystem3D::DEFAULT_MAX_VELOCITY = 9999.0f;
+bool PUParticleSystem3D::__batchedUpdateEnabled = false;
+bool PUParticleSystem3D::__parallelUpdateEnabled = false;
+Vector<PUParticleSystem3D*> PUParticleSystem3D::__parallelUpdateQueue;
+unsigned int PUParticleSystem3D::__parallelUpdateFrame = 0;
+EventListenerCustom* PUParticleSystem3D::__parallelUpdateListener = nullptr;
 
 PUParticleSystem3D::PUParticleSystem3D()
 : _emittedEmitterQuota(DEFAULT_EMITTED_EMITTER_QUOTA)
@@ -190,6 +201,7 @@ PUParticleSystem3D::PUParticleSystem3D()
 , _maxVelocitySet(false)
 , _isMarkedForEmission(false)
 , _parentParticleSystem(nullptr)
+, _parallelUpdateTime(-1)
 {
     _particleQuota = DEFAULT_PARTICLE_QUOTA;
 }
@@ -438,9 +450,117 @@ void PUParticleSystem3D::update(float delta)
         }
     }
 
+    // the first update prepares the renders and the pools, keep it on the cocos thread
+    if (__parallelUpdateEnabled && _prepared)
+    {
+        queueParallelUpdate(delta);
+        return;
+    }
+
     forceUpdate(delta);
 }
 
+void PUParticleSystem3D::setParallelUpdateEnabled(bool enabled)
+{
+    if (__parallelUpdateEnabled == enabled)
+        return;
+
+    __parallelUpdateEnabled = enabled;
+    if (!enabled)
+    {
+        runParallelUpdate();
+        if (__parallelUpdateListener)
+        {
+            Director::getInstance()->getEventDispatcher()->removeEventListener(__parallelUpdateListener);
+            CC_SAFE_RELEASE_NULL(__parallelUpdateListener);
+        }
+    }
+}
+
+void PUParticleSystem3D::queueParallelUpdate(float delta)
+{
+    auto director = Director::getInstance();
+
+    // the queue is emptied after the update of every frame, unless the listener was removed with all the others
+    if (!__parallelUpdateQueue.empty() && __parallelUpdateFrame != director->getTotalFrames())
+    {
+        runParallelUpdate();
+        director->getEventDispatcher()->removeEventListener(__parallelUpdateListener);
+        CC_SAFE_RELEASE_NULL(__parallelUpdateListener);
+    }
+    if (__parallelUpdateListener == nullptr)
+    {
+        __parallelUpdateListener = director->getEventDispatcher()->addCustomEventListener(Director::EVENT_AFTER_UPDATE, [](EventCustom*) {
+            runParallelUpdate();
+        });
+        __parallelUpdateListener->retain();
+    }
+    __parallelUpdateFrame = director->getTotalFrames();
+
+    if (_parallelUpdateTime >= 0)
+    {
+        // updated twice in a frame, simulate both steps at once
+        _parallelUpdateTime += delta;
+        return;
+    }
+
+    // the dirty transforms of the ancestors can't be computed on a worker thread, the workers only read them
+    getNodeToWorldTransform();
+
+    _parallelUpdateTime = delta;
+    __parallelUpdateQueue.pushBack(this);
+}
+
+void PUParticleSystem3D::runParallelUpdate()
+{
+    if (__parallelUpdateQueue.empty())
+        return;
+
+    // the systems stay retained by the queue until they are updated
+    Vector<PUParticleSystem3D*> systems;
+    std::swap(systems, __parallelUpdateQueue);
+
+    // the techniques of a system read each other, they are updated in one job in the scheduler order
+    std::vector<std::pair<PUParticleSystem3D*, ssize_t>> order;
+    order.reserve(systems.size());
+    for (ssize_t i = 0; i < systems.size(); ++i)
+    {
+        PUParticleSystem3D* root = systems.at(i);
+        while (root->_parentParticleSystem)
+        {
+            root = root->_parentParticleSystem;
+        }
+        order.push_back(std::make_pair(root, i));
+    }
+    std::sort(order.begin(), order.end());
+
+    std::vector<size_t> groups;
+    for (size_t i = 0; i < order.size(); ++i)
+    {
+        if (i == 0 || order[i].first != order[i - 1].first)
+        {
+            groups.push_back(i);
+        }
+    }
+    groups.push_back(order.size());
+
+    JobSystem::getInstance()->parallelFor(groups.size() - 1, 1, [&systems, &order, &groups](size_t begin, size_t end) {
+        for (size_t group = begin; group < end; ++group)
+        {
+            for (size_t i = groups[group]; i < groups[group + 1]; ++i)
+            {
+                auto system = systems.at(order[i].second);
+                system->forceUpdate(system->_parallelUpdateTime);
+            }
+        }
+    });
+
+    for (auto system : systems)
+    {
+        system->_parallelUpdateTime = -1;
+    }
+}
+
 void PUParticleSystem3D::forceUpdate( float delta )
 {
     if (!_emitters.empty())
@@ -657,14 +777,15 @@ void PUParticleSystem3D::updator( float elapsedTime )
 {
     bool firstActiveParticle = true;
     bool firstParticle = true;
-    processParticle(_particlePool, firstActiveParticle, firstParticle, elapsedTime);
+    auto process = __batchedUpdateEnabled ? &PUParticleSystem3D::processParticleBatch : &PUParticleSystem3D::processParticle;
+    (this->*process)(_particlePool, firstActiveParticle, firstParticle, elapsedTime);
 
     for (auto &iter : _emittedEmitterParticlePool){
-        processParticle(iter.second, firstActiveParticle, firstParticle, elapsedTime);
+        (this->*process)(iter.second, firstActiveParticle, firstParticle, elapsedTime);
     }
 
     for (auto &iter : _emittedSystemParticlePool){
-        processParticle(iter.second, firstActiveParticle, firstParticle, elapsedTime);
+        (this->*process)(iter.second, firstActiveParticle, firstParticle, elapsedTime);
     }
 }
 
@@ -1221,26 +1342,8 @@ void PUParticleSystem3D::processParticle( ParticlePool &pool, bool &firstActiveP
                 }
             }
 
-            if (_render)
-                static_cast<PURender *>(_render)->updateRender(particle, elapsedTime, firstActiveParticle);
-
-            if (_isEnabled && particle->particleType != PUParticle3D::PT_VISUAL){
-                if (particle->particleType == PUParticle3D::PT_EMITTER){
-                    auto emitter = static_cast<PUEmitter *>(particle->particleEntityPtr);
-                    emitter->setLocalPosition(particle->position);
-                    executeEmitParticles(emitter, emitter->calculateRequestedParticles(elapsedTime), elapsedTime);
-                }else if (particle->particleType == PUParticle3D::PT_TECHNIQUE){
-                    auto system = static_cast<PUParticleSystem3D *>(particle->particleEntityPtr);
-                    system->setPosition3D(particle->position);
-                    system->setRotationQuat(particle->orientation);
-                    //system->setScaleX(scl.x);system->setScaleY(scl.y);system->setScaleZ(scl.z);
-                    system->forceUpdate(elapsedTime);
-                }
-            }
-
+            processLiveParticle(particle, elapsedTime, scale, firstActiveParticle);
             firstActiveParticle = false;
-            // Keep latest position
-            particle->latestPosition = particle->position;
 
             //if (_maxVelocitySet && particle->calculateVelocity() > _maxVelocity)
             //{
@@ -1268,7 +1371,6 @@ void PUParticleSystem3D::processParticle( ParticlePool &pool, bool &firstActiveP
             //    particle->heightInWorld = scl.y * particle->height;
             //    particle->depthInWorld = scl.z * particle->depth;
             //}
-            processMotion(particle, elapsedTime, scale, firstActiveParticle);
         }
         else{
             initParticleForExpiration(particle, elapsedTime);
@@ -1297,6 +1399,93 @@ void PUParticleSystem3D::processParticle( ParticlePool &pool, bool &firstActiveP
     }
 }
 
+void PUParticleSystem3D::processParticleBatch( ParticlePool &pool, bool &firstActiveParticle, bool &firstParticle, float elapsedTime )
+{
+    Vec3 scale = getDerivedScale();
+    _batchedParticles.clear();
+    _batchedLiveParticles.clear();
+
+    // the expired particles are locked while walking the pool
+    PUParticle3D *particle = static_cast<PUParticle3D *>(pool.getFirst());
+    while (particle){
+        if (!isExpired(particle, elapsedTime)){
+            particle->process(elapsedTime);
+
+            for (auto it : _emitters) {
+                if (it->isEnabled() && !it->isMarkedForEmission()){
+                    (static_cast<PUEmitter*>(it))->updateEmitter(particle, elapsedTime);
+                }
+            }
+            _batchedLiveParticles.push_back(particle);
+        }
+        else{
+            initParticleForExpiration(particle, elapsedTime);
+            pool.lockLatestData();
+        }
+        _batchedParticles.push_back(particle);
+        particle = static_cast<PUParticle3D *>(pool.getNext());
+    }
+
+    if (!_batchedLiveParticles.empty()){
+        for (auto& it : _affectors) {
+            if (it->isEnabled()){
+                (static_cast<PUAffector*>(it))->processParticles(_batchedLiveParticles.data(), _batchedLiveParticles.size(), elapsedTime, firstActiveParticle);
+            }
+        }
+
+        for (auto live : _batchedLiveParticles){
+            processLiveParticle(live, elapsedTime, scale, firstActiveParticle);
+            firstActiveParticle = false;
+        }
+    }
+
+    for (auto visited : _batchedParticles){
+        for (auto it : _observers){
+            if (it->isEnabled()){
+                it->updateObserver(visited, elapsedTime, firstParticle);
+            }
+        }
+
+        if (visited->hasEventFlags(PUParticle3D::PEF_EXPIRED))
+        {
+            visited->setEventFlags(0);
+            visited->addEventFlags(PUParticle3D::PEF_EXPIRED);
+        }
+        else
+        {
+            visited->setEventFlags(0);
+        }
+
+        visited->timeToLive -= elapsedTime;
+        firstParticle = false;
+    }
+}
+
+void PUParticleSystem3D::processLiveParticle( PUParticle3D* particle, float elapsedTime, const Vec3 &scale, bool firstActiveParticle )
+{
+    if (_render)
+        static_cast<PURender *>(_render)->updateRender(particle, elapsedTime, firstActiveParticle);
+
+    if (_isEnabled && particle->particleType != PUParticle3D::PT_VISUAL){
+        if (particle->particleType == PUParticle3D::PT_EMITTER){
+            auto emitter = static_cast<PUEmitter *>(particle->particleEntityPtr);
+            emitter->setLocalPosition(particle->position);
+            executeEmitParticles(emitter, emitter->calculateRequestedParticles(elapsedTime), elapsedTime);
+        }else if (particle->particleType == PUParticle3D::PT_TECHNIQUE){
+            auto system = static_cast<PUParticleSystem3D *>(particle->particleEntityPtr);
+            system->setPosition3D(particle->position);
+            system->setRotationQuat(particle->orientation);
+            //system->setScaleX(scl.x);system->setScaleY(scl.y);system->setScaleZ(scl.z);
+            system->forceUpdate(elapsedTime);
+        }
+    }
+
+    // Keep latest position
+    particle->latestPosition = particle->position;
+
+    processMotion(particle, elapsedTime, scale, false);
+}
+
 bool PUParticleSystem3D::makeParticleLocal( PUParticle3D* particle )
 {
     if (!particle)
@@ -44,6 +44,7 @@ class PUBehaviour;
 class PUEmitter;
 class PUAffector;
 class Particle3DRender;
+class EventListenerCustom;
 
 enum PUComponentType
 {
@@ -233,6 +234,27 @@ public:
 
     virtual void update(float delta) override;
     void forceUpdate(float delta);
+
+    /**
+     * Runs every affector once over all the live particles of a pool instead of running all the
+     * affectors particle by particle, see PUAffector::processParticles. The particles emitted by
+     * emitted emitters start moving on the next frame.
+     *
+     * @param enabled True to batch the affectors of all the systems, false by default.
+     */
+    static void setBatchedUpdateEnabled(bool enabled) { __batchedUpdateEnabled = enabled; }
+    static bool isBatchedUpdateEnabled() { return __batchedUpdateEnabled; }
+
+    /**
+     * Updates the systems in parallel on the JobSystem once the scheduler has updated everything,
+     * see Director::EVENT_AFTER_UPDATE. The techniques of a system are updated together in their
+     * usual order, different systems at the same time, so PUListener callbacks may be called on a
+     * worker thread.
+     *
+     * @param enabled True to update the systems in parallel, false by default.
+     */
+    static void setParallelUpdateEnabled(bool enabled);
+    static bool isParallelUpdateEnabled() { return __parallelUpdateEnabled; }
     
     /**
      * particle system play control
@@ -373,6 +395,8 @@ protected:
     void executeEmitParticles(PUEmitter* emitter, unsigned requested, float elapsedTime);
     void emitParticles(ParticlePool &pool, PUEmitter* emitter, unsigned requested, float elapsedTime);
     void processParticle(ParticlePool &pool, bool &firstActiveParticle, bool &firstParticle, float elapsedTime);
+    void processParticleBatch(ParticlePool &pool, bool &firstActiveParticle, bool &firstParticle, float elapsedTime);
+    void processLiveParticle(PUParticle3D* particle, float elapsedTime, const Vec3 &scale, bool firstActiveParticle);
     void processMotion(PUParticle3D* particle, float timeElapsed, const Vec3 &scl, bool firstParticle);
     void notifyRescaled(const Vec3 &scl);
     void initParticleForEmission(PUParticle3D* particle);
@@ -381,6 +405,11 @@ protected:
     
     inline bool isExpired(PUParticle3D* particle, float timeElapsed);
 
+    /** Defers forceUpdate to the parallel update of all the systems. */
+    void queueParallelUpdate(float delta);
+    /** Updates the queued systems on the JobSystem, the techniques of a system in one job. */
+    static void runParallelUpdate();
+
     static void convertToUnixStylePath(std::string &path);
 
 protected:
@@ -427,6 +456,18 @@ protected:
     Quaternion                          _latestOrientation;
 
     PUParticleSystem3D *                _parentParticleSystem;
+
+    // the particles of a pool while its affectors are batched
+    std::vector<PUParticle3D*>          _batchedParticles;
+    std::vector<PUParticle3D*>          _batchedLiveParticles;
+
+    float                               _parallelUpdateTime; // time to simulate in the parallel update, -1 if the system isn't queued
+
+    static bool                         __batchedUpdateEnabled;
+    static bool                         __parallelUpdateEnabled;
+    static Vector<PUParticleSystem3D*>  __parallelUpdateQueue;
+    static unsigned int                 __parallelUpdateFrame;
+    static EventListenerCustom*         __parallelUpdateListener;
 };
 
 NS_CC_END
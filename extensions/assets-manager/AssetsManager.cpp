@@ -417,6 +417,8 @@ bool AssetsManager::uncompress()
     
     CCLOG("end uncompressing");
     unzClose(zipfile);
+    // the extracted files may have been looked up before the update
+    FileUtils::getInstance()->purgeNonexistentFileCache();
     
     return true;
 }
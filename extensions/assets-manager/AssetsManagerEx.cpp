@@ -27,6 +27,7 @@
 #include "base/CCDirector.h"
 
 #include <stdio.h>
+#include <algorithm>
 
 #ifdef MINIZIP_FROM_SYSTEM
 #include <minizip/unzip.h>
@@ -34,6 +35,10 @@
 #include "unzip.h"
 #endif
 #include "base/CCAsyncTaskPool.h"
+#include "base/ccUtils.h"
+#include "base/ZipUtils.h"
+#include "base/CCScriptBytecodeCache.h"
+#include "md5/md5.h"
 
 NS_CC_EXT_BEGIN
 
@@ -41,6 +46,9 @@ NS_CC_EXT_BEGIN
 #define VERSION_FILENAME        "version.manifest"
 #define TEMP_MANIFEST_FILENAME  "project.manifest.temp"
 #define MANIFEST_FILENAME       "project.manifest"
+#define PATCH_SUFFIX            ".patch"
+#define PATCH_MAGIC             "BSDIFF4Z"
+#define PATCH_HEADER_SIZE       32
 
 #define BUFFER_SIZE    8192
 #define MAX_FILENAME   512
@@ -49,6 +57,8 @@ NS_CC_EXT_BEGIN
 
 #define SAVE_POINT_INTERVAL 0.1
 
+#define MD5_BLOCK_SIZE  65536
+
 const std::string AssetsManagerEx::VERSION_ID = "@version";
 const std::string AssetsManagerEx::MANIFEST_ID = "@manifest";
 
@@ -75,6 +85,9 @@ AssetsManagerEx::AssetsManagerEx(const std::string& manifestUrl, const std::stri
 , _currConcurrentTask(0)
 , _versionCompareHandle(nullptr)
 , _verifyCallback(nullptr)
+, _asyncVerifyCallback(nullptr)
+, _md5Verification(false)
+, _parsingManifest(false)
 , _inited(false)
 {
     // Init variables
@@ -87,7 +100,11 @@ AssetsManagerEx::AssetsManagerEx(const std::string& manifestUrl, const std::stri
     {
         static_cast<uint32_t>(_maxConcurrentTask),
         DEFAULT_CONNECTION_TIMEOUT,
-        ".tmp"
+        ".tmp",
+        4,
+        3,
+        8 * 1024 * 1024,
+        0
     };
     _downloader = std::shared_ptr<network::Downloader>(new network::Downloader(hints));
     _downloader->onTaskError = std::bind(&AssetsManagerEx::onError, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3, std::placeholders::_4);
@@ -383,7 +400,8 @@ bool AssetsManagerEx::decompress(const std::string &zip)
         {
             //There are not directory entry in some case.
             //So we need to create directory when decompressing file entry
-            if ( !_fileUtils->createDirectory(basename(fullPath)) )
+            // Another zip decompressed in parallel may have created it in the meantime
+            if ( !_fileUtils->createDirectory(basename(fullPath)) && !_fileUtils->isDirectoryExist(basename(fullPath)) )
             {
                 // Failed to create directory
                 CCLOG("AssetsManagerEx : can not create directory %s\n", fullPath.c_str());
@@ -396,7 +414,7 @@ bool AssetsManagerEx::decompress(const std::string &zip)
             // Create all directories in advance to avoid issue
             std::string dir = basename(fullPath);
             if (!_fileUtils->isDirectoryExist(dir)) {
-                if (!_fileUtils->createDirectory(dir)) {
+                if (!_fileUtils->createDirectory(dir) && !_fileUtils->isDirectoryExist(dir)) {
                     // Failed to create directory
                     CCLOG("AssetsManagerEx : can not create directory %s\n", fullPath.c_str());
                     unzClose(zipfile);
@@ -460,47 +478,338 @@ bool AssetsManagerEx::decompress(const std::string &zip)
     }
     
     unzClose(zipfile);
+    // the extracted files may have been looked up before the update
+    _fileUtils->purgeNonexistentFileCache();
     return true;
 }
 
+// Hashes the file by blocks, a large asset isn't read in memory at once
+static std::string getFileMD5(const std::string &path)
+{
+    FILE *fp = fopen(FileUtils::getInstance()->getSuitableFOpen(path).c_str(), "rb");
+    if (fp == nullptr)
+        return "";
+    
+    md5_state_t state;
+    md5_byte_t digest[16];
+    char hexOutput[33] = { 0 };
+    std::vector<unsigned char> buffer(MD5_BLOCK_SIZE);
+    
+    md5_init(&state);
+    size_t read = 0;
+    while ((read = fread(buffer.data(), 1, buffer.size(), fp)) > 0)
+    {
+        md5_append(&state, (const md5_byte_t *)buffer.data(), (int)read);
+    }
+    fclose(fp);
+    md5_finish(&state, digest);
+    
+    for (int di = 0; di < 16; ++di)
+        sprintf(hexOutput + di * 2, "%02x", digest[di]);
+    return hexOutput;
+}
+
+static bool verifyMD5(const std::string &path, const Manifest::Asset &asset)
+{
+    std::string md5 = asset.md5;
+    std::transform(md5.begin(), md5.end(), md5.begin(), ::tolower);
+    return getFileMD5(path) == md5;
+}
+
+static int64_t readPatchInt(const unsigned char *buf)
+{
+    // Sign and magnitude encoding of bsdiff
+    int64_t value = buf[7] & 0x7F;
+    for (int i = 6; i >= 0; --i)
+    {
+        value = value * 256 + buf[i];
+    }
+    return (buf[7] & 0x80) ? -value : value;
+}
+
+bool AssetsManagerEx::patch(const std::string &base, const std::string &patchFile, const std::string &dst, const std::string &md5)
+{
+    Data oldData = _fileUtils->getDataFromFile(base);
+    Data patchData = _fileUtils->getDataFromFile(patchFile);
+    if (oldData.isNull() || patchData.getSize() < PATCH_HEADER_SIZE || memcmp(patchData.getBytes(), PATCH_MAGIC, 8) != 0)
+    {
+        CCLOG("AssetsManagerEx : invalid patch %s or missing base file %s\n", patchFile.c_str(), base.c_str());
+        return false;
+    }
+    
+    unsigned char *header = patchData.getBytes();
+    const int64_t ctrlLength = readPatchInt(header + 8);
+    const int64_t diffLength = readPatchInt(header + 16);
+    const int64_t newSize = readPatchInt(header + 24);
+    const int64_t patchSize = (int64_t)patchData.getSize();
+    if (ctrlLength < 0 || diffLength < 0 || newSize < 0 || PATCH_HEADER_SIZE + ctrlLength + diffLength > patchSize)
+    {
+        CCLOG("AssetsManagerEx : corrupted patch header %s\n", patchFile.c_str());
+        return false;
+    }
+    
+    // Inflate the control, diff and extra blocks
+    unsigned char *blocks[3] = { nullptr, nullptr, nullptr };
+    ssize_t blockSizes[3] = { 0, 0, 0 };
+    unsigned char *blockStart = header + PATCH_HEADER_SIZE;
+    const int64_t compressedSizes[3] = { ctrlLength, diffLength, patchSize - PATCH_HEADER_SIZE - ctrlLength - diffLength };
+    bool ok = true;
+    for (int i = 0; i < 3 && ok; ++i)
+    {
+        if (compressedSizes[i] > 0)
+        {
+            blockSizes[i] = ZipUtils::inflateMemoryWithHint(blockStart, (ssize_t)compressedSizes[i], &blocks[i], i == 0 ? BUFFER_SIZE : MAX((ssize_t)newSize, BUFFER_SIZE));
+            ok = blocks[i] != nullptr;
+        }
+        blockStart += compressedSizes[i];
+    }
+    
+    std::vector<unsigned char> newData;
+    if (ok)
+    {
+        newData.resize((size_t)newSize);
+        const unsigned char *oldBytes = oldData.getBytes();
+        const int64_t oldSize = (int64_t)oldData.getSize();
+        int64_t oldPos = 0, newPos = 0;
+        ssize_t ctrlPos = 0, diffPos = 0, extraPos = 0;
+        while (ok && newPos < newSize)
+        {
+            if (ctrlPos + 24 > blockSizes[0])
+            {
+                ok = false;
+                break;
+            }
+            const int64_t diffCount = readPatchInt(blocks[0] + ctrlPos);
+            const int64_t extraCount = readPatchInt(blocks[0] + ctrlPos + 8);
+            const int64_t seek = readPatchInt(blocks[0] + ctrlPos + 16);
+            ctrlPos += 24;
+            
+            // The diff bytes are added to the old file, the extra bytes are copied as is
+            if (diffCount < 0 || extraCount < 0 || newPos + diffCount + extraCount > newSize
+                || diffPos + diffCount > blockSizes[1] || extraPos + extraCount > blockSizes[2])
+            {
+                ok = false;
+                break;
+            }
+            for (int64_t i = 0; i < diffCount; ++i)
+            {
+                unsigned char value = blocks[1][diffPos + i];
+                if (oldPos + i >= 0 && oldPos + i < oldSize)
+                {
+                    value += oldBytes[oldPos + i];
+                }
+                newData[(size_t)(newPos + i)] = value;
+            }
+            diffPos += (ssize_t)diffCount;
+            newPos += diffCount;
+            oldPos += diffCount;
+            
+            if (extraCount > 0)
+            {
+                memcpy(&newData[(size_t)newPos], blocks[2] + extraPos, (size_t)extraCount);
+            }
+            extraPos += (ssize_t)extraCount;
+            newPos += extraCount;
+            oldPos += seek;
+        }
+    }
+    for (int i = 0; i < 3; ++i)
+    {
+        free(blocks[i]);
+    }
+    if (!ok)
+    {
+        CCLOG("AssetsManagerEx : corrupted patch %s\n", patchFile.c_str());
+        return false;
+    }
+    
+    Data result;
+    result.fastSet(newData.empty() ? nullptr : &newData[0], (ssize_t)newData.size());
+    bool verified = md5.empty() || utils::getDataMD5Hash(result) == md5;
+    bool written = verified && _fileUtils->writeDataToFile(result, dst);
+    // The vector still owns the buffer
+    result.fastSet(nullptr, 0);
+    if (!verified)
+    {
+        CCLOG("AssetsManagerEx : md5 of patched file %s doesn't match the manifest\n", dst.c_str());
+    }
+    return written;
+}
+
 void AssetsManagerEx::decompressDownloadedZip(const std::string &customId, const std::string &storagePath)
+{
+    processDownloadedAsset(customId, storagePath, true);
+}
+
+void AssetsManagerEx::processDownloadedAsset(const std::string &customId, const std::string &storagePath, bool compressed)
 {
     struct AsyncData
     {
         std::string customId;
-        std::string zipFile;
+        std::string file;
+        std::string patchFile;
+        std::string patchBase;
+        bool patched;
+        bool verified;
         bool succeed;
     };
     
-    AsyncData* asyncData = new AsyncData;
+    auto asyncData = std::make_shared<AsyncData>();
     asyncData->customId = customId;
-    asyncData->zipFile = storagePath;
+    asyncData->file = storagePath;
+    asyncData->patched = true;
+    asyncData->verified = true;
     asyncData->succeed = false;
     
-    std::function<void(void*)> decompressFinished = [this](void* param) {
-        auto dataInner = reinterpret_cast<AsyncData*>(param);
-        if (dataInner->succeed)
+    // A downloaded patch produces the asset at the storage path of its unit
+    auto unitIt = _downloadUnits.find(customId);
+    if (unitIt != _downloadUnits.end() && !unitIt->second.patchBase.empty())
+    {
+        asyncData->patchFile = storagePath;
+        asyncData->patchBase = unitIt->second.patchBase;
+        asyncData->file = unitIt->second.storagePath;
+    }
+    
+    // The worker only sees copies, the manifest and the callback may change while it runs
+    std::function<bool(const std::string& path, Manifest::Asset asset)> verify = nullptr;
+    Manifest::Asset asset;
+    auto &assets = _remoteManifest->getAssets();
+    auto assetIt = assets.find(customId);
+    if (assetIt != assets.end())
+    {
+        asset = assetIt->second;
+        verify = _asyncVerifyCallback;
+        // The patched files are already checked against the md5 by patch()
+        if (verify == nullptr && _verifyCallback == nullptr && _md5Verification && !asset.md5.empty() && asyncData->patchFile.empty())
+        {
+            verify = verifyMD5;
+        }
+    }
+    
+    // Keep alive until the result is delivered on the cocos thread
+    retain();
+    auto jobSystem = JobSystem::getInstance();
+    auto job = jobSystem->schedule([this, asyncData, asset, verify, compressed]() {
+        if (!asyncData->patchFile.empty())
+        {
+            asyncData->patched = patch(asyncData->patchBase, asyncData->patchFile, asyncData->file, asset.md5);
+            _fileUtils->removeFile(asyncData->patchFile);
+            if (!asyncData->patched)
+            {
+                return;
+            }
+        }
+        
+        if (verify != nullptr)
+        {
+            asyncData->verified = verify(asyncData->file, asset);
+        }
+        if (!asyncData->verified)
+        {
+            return;
+        }
+        
+        if (compressed)
+        {
+            // Decompress all compressed files
+            asyncData->succeed = decompress(asyncData->file);
+            _fileUtils->removeFile(asyncData->file);
+        }
+        else
+        {
+            asyncData->succeed = true;
+        }
+    });
+    jobSystem->scheduleOnCocosThread([this, asyncData, asset]() {
+        if (!asyncData->patched)
+        {
+            downloadFullAsset(asyncData->customId);
+            release();
+            return;
+        }
+        
+        // Patched files skipped the cocos thread verification in onSuccess
+        if (asyncData->succeed && !asyncData->patchFile.empty() && _asyncVerifyCallback == nullptr && _verifyCallback != nullptr)
         {
-            fileSuccess(dataInner->customId, dataInner->zipFile);
+            asyncData->succeed = asyncData->verified = _verifyCallback(asyncData->file, asset);
+        }
+        
+        if (asyncData->succeed)
+        {
+            fileSuccess(asyncData->customId, asyncData->file);
+        }
+        else if (!asyncData->verified)
+        {
+            fileError(asyncData->customId, "Asset file verification failed after downloaded");
         }
         else
         {
-            std::string errorMsg = "Unable to decompress file " + dataInner->zipFile;
+            std::string errorMsg = "Unable to decompress file " + asyncData->file;
             // Ensure zip file deletion (if decompress failure cause task thread exit anormally)
-            _fileUtils->removeFile(dataInner->zipFile);
+            _fileUtils->removeFile(asyncData->file);
             dispatchUpdateEvent(EventAssetsManagerEx::EventCode::ERROR_DECOMPRESS, "", errorMsg);
-            fileError(dataInner->customId, errorMsg);
+            fileError(asyncData->customId, errorMsg);
         }
-        delete dataInner;
-    };
-    AsyncTaskPool::getInstance()->enqueue(AsyncTaskPool::TaskType::TASK_OTHER, std::move(decompressFinished), (void*)asyncData, [this, asyncData]() {
-        // Decompress all compressed files
-        if (decompress(asyncData->zipFile))
+        release();
+    }, {job});
+}
+
+void AssetsManagerEx::preparePatch(const Manifest::Asset &asset, DownloadUnit &unit)
+{
+    // The local file of a compressed asset is removed once decompressed
+    if (asset.compressed || asset.patches.empty())
+        return;
+    
+    auto &localAssets = _localManifest->getAssets();
+    auto localIt = localAssets.find(unit.customId);
+    if (localIt == localAssets.end() || localIt->second.md5.empty())
+        return;
+    
+    std::string base = _storagePath + localIt->second.path;
+    if (!_fileUtils->isFileExist(base))
+    {
+        // Never updated, the asset is still in the package
+        base = _fileUtils->fullPathForFilename(localIt->second.path);
+        if (base.empty())
+            return;
+    }
+    
+    for (const auto &patch : asset.patches)
+    {
+        if (patch.from == localIt->second.md5)
         {
-            asyncData->succeed = true;
+            unit.srcUrl = _remoteManifest->getPackageUrl() + patch.path;
+            unit.size = patch.size;
+            unit.patchBase = base;
+            return;
         }
-        _fileUtils->removeFile(asyncData->zipFile);
-    });
+    }
+}
+
+void AssetsManagerEx::downloadFullAsset(const std::string &customId)
+{
+    auto unitIt = _downloadUnits.find(customId);
+    auto &assets = _remoteManifest->getAssets();
+    auto assetIt = assets.find(customId);
+    if (unitIt == _downloadUnits.end() || assetIt == assets.end())
+    {
+        fileError(customId, "Unable to apply the patch of asset " + customId);
+        return;
+    }
+    
+    CCLOG("AssetsManagerEx : patch of %s failed, downloading the whole file\n", customId.c_str());
+    DownloadUnit &unit = unitIt->second;
+    if (unit.size > 0 && assetIt->second.size > 0)
+    {
+        _totalSize += assetIt->second.size - unit.size;
+    }
+    unit.srcUrl = _remoteManifest->getPackageUrl() + assetIt->second.path;
+    unit.size = assetIt->second.size;
+    unit.patchBase.clear();
+    _downloadedSize[customId] = 0;
+    
+    _queue.push_back(customId);
+    queueDowload();
 }
 
 void AssetsManagerEx::dispatchUpdateEvent(EventAssetsManagerEx::EventCode code, const std::string &assetId/* = ""*/, const std::string &message/* = ""*/, int curle_code/* = CURLE_OK*/, int curlm_code/* = CURLM_OK*/)
@@ -632,10 +941,39 @@ void AssetsManagerEx::downloadManifest()
 
 void AssetsManagerEx::parseManifest()
 {
-    if (_updateState != State::MANIFEST_LOADED)
+    if (_updateState != State::MANIFEST_LOADED || _parsingManifest)
         return;
 
-    _remoteManifest->parse(_tempManifestPath);
+    // A large manifest takes a while to parse, it's parsed by a worker in a manifest of its own
+    _parsingManifest = true;
+    dispatchUpdateEvent(EventAssetsManagerEx::EventCode::UPDATE_PROGRESSION, "", "Parsing the remote manifest.");
+    
+    auto manifest = new (std::nothrow) Manifest();
+    std::string manifestPath = _tempManifestPath;
+    retain();
+    auto jobSystem = JobSystem::getInstance();
+    auto job = jobSystem->schedule([manifest, manifestPath]() {
+        manifest->parse(manifestPath);
+    });
+    jobSystem->scheduleOnCocosThread([this, manifest]() {
+        _parsingManifest = false;
+        onManifestParsed(manifest);
+        release();
+    }, {job});
+}
+
+void AssetsManagerEx::onManifestParsed(Manifest *manifest)
+{
+    // The temporary manifest shares the remote one once an update started
+    if (_tempManifest == _remoteManifest)
+    {
+        _tempManifest = manifest;
+    }
+    CC_SAFE_RELEASE(_remoteManifest);
+    _remoteManifest = manifest;
+
+    if (_updateState != State::MANIFEST_LOADED)
+        return;
 
     if (!_remoteManifest->isLoaded())
     {
@@ -680,17 +1018,9 @@ void AssetsManagerEx::startUpdate()
     _totalEnabled = false;
     
     // Temporary manifest exists, resuming previous download
-    if (_tempManifest && _tempManifest->isLoaded() && _tempManifest->versionEquals(_remoteManifest))
-    {
-        _tempManifest->saveToFile(_tempManifestPath);
-        _tempManifest->genResumeAssetsList(&_downloadUnits);
-        _totalWaitToDownload = _totalToDownload = (int)_downloadUnits.size();
-        this->batchDownload();
-        
-        std::string msg = StringUtils::format("Resuming from previous unfinished update, %d files remains to be finished.", _totalToDownload);
-        dispatchUpdateEvent(EventAssetsManagerEx::EventCode::UPDATE_PROGRESSION, "", msg);
-    }
-    else
+    bool resuming = _tempManifest && _tempManifest->isLoaded() && _tempManifest->versionEquals(_remoteManifest);
+    bool saveRemote = false;
+    if (!resuming)
     {
         // Temporary manifest exists, but can't be parsed or version doesn't equals remote manifest (out of date)
         if (_tempManifest)
@@ -700,15 +1030,64 @@ void AssetsManagerEx::startUpdate()
             CC_SAFE_RELEASE(_tempManifest);
             // Recreate temp storage path and save remote manifest
             _fileUtils->createDirectory(_tempStoragePath);
-            _remoteManifest->saveToFile(_tempManifestPath);
+            saveRemote = true;
         }
         
         // Temporary manifest will be used to register the download states of each asset,
         // in this case, it equals remote manifest.
         _tempManifest = _remoteManifest;
+    }
+    
+    dispatchUpdateEvent(EventAssetsManagerEx::EventCode::UPDATE_PROGRESSION, "", "Comparing the local and remote manifests.");
+    
+    // Comparing and saving large manifests takes a while, a worker does it while the manifests aren't modified:
+    // the state is UPDATING until the downloads start
+    struct AsyncData
+    {
+        std::unordered_map<std::string, Manifest::AssetDiff> diff;
+        DownloadUnits resumeUnits;
+    };
+    auto asyncData = std::make_shared<AsyncData>();
+    auto tempManifest = _tempManifest;
+    auto localManifest = _localManifest;
+    std::string tempManifestPath = _tempManifestPath;
+    retain();
+    auto jobSystem = JobSystem::getInstance();
+    auto job = jobSystem->schedule([asyncData, tempManifest, localManifest, tempManifestPath, resuming, saveRemote]() {
+        if (resuming)
+        {
+            tempManifest->saveToFile(tempManifestPath);
+            tempManifest->genResumeAssetsList(&asyncData->resumeUnits);
+            return;
+        }
         
         // Check difference between local manifest and remote manifest
-        std::unordered_map<std::string, Manifest::AssetDiff> diff_map = _localManifest->genDiff(_remoteManifest);
+        asyncData->diff = localManifest->genDiff(tempManifest);
+        if (saveRemote || !asyncData->diff.empty())
+        {
+            // Save current download manifest information for resuming
+            tempManifest->saveToFile(tempManifestPath);
+        }
+    });
+    jobSystem->scheduleOnCocosThread([this, asyncData, resuming]() {
+        onDiffGenerated(asyncData->diff, asyncData->resumeUnits, resuming);
+        release();
+    }, {job});
+}
+
+void AssetsManagerEx::onDiffGenerated(const std::unordered_map<std::string, Manifest::AssetDiff> &diff_map, const DownloadUnits &resumeUnits, bool resuming)
+{
+    if (resuming)
+    {
+        _downloadUnits = resumeUnits;
+        _totalWaitToDownload = _totalToDownload = (int)_downloadUnits.size();
+        this->batchDownload();
+        
+        std::string msg = StringUtils::format("Resuming from previous unfinished update, %d files remains to be finished.", _totalToDownload);
+        dispatchUpdateEvent(EventAssetsManagerEx::EventCode::UPDATE_PROGRESSION, "", msg);
+    }
+    else
+    {
         if (diff_map.size() == 0)
         {
             updateSucceed();
@@ -717,8 +1096,6 @@ void AssetsManagerEx::startUpdate()
         {
             // Generate download units for all assets that need to be updated or added
             std::string packageUrl = _remoteManifest->getPackageUrl();
-            // Save current download manifest information for resuming
-            _tempManifest->saveToFile(_tempManifestPath);
             // Preprocessing local files in previous version and creating download folders
             for (auto it = diff_map.begin(); it != diff_map.end(); ++it)
             {
@@ -731,6 +1108,10 @@ void AssetsManagerEx::startUpdate()
                     unit.srcUrl = packageUrl + path;
                     unit.storagePath = _tempStoragePath + path;
                     unit.size = diff.asset.size;
+                    if (diff.type == Manifest::DiffType::MODIFIED)
+                    {
+                        preparePatch(diff.asset, unit);
+                    }
                     _downloadUnits.emplace(unit.customId, unit);
                     _tempManifest->setAssetDownloadState(it->first, Manifest::DownloadState::UNSTARTED);
                 }
@@ -759,9 +1140,12 @@ void AssetsManagerEx::updateSucceed()
         _fileUtils->listFilesRecursively(_tempStoragePath, &files);
         int baseOffset = (int)_tempStoragePath.length();
         std::string relativePath, dstPath;
+        bool scriptsUpdated = false;
         for (std::vector<std::string>::iterator it = files.begin(); it != files.end(); ++it)
         {
             relativePath.assign((*it).substr(baseOffset));
+            scriptsUpdated = scriptsUpdated || _fileUtils->getFileExtension(relativePath) == ".lua"
+                || _fileUtils->getFileExtension(relativePath) == ".js";
             dstPath.assign(_storagePath + relativePath);
             // Create directory
             if (relativePath.back() == '/')
@@ -780,6 +1164,11 @@ void AssetsManagerEx::updateSucceed()
         }
         // Remove temp storage path
         _fileUtils->removeDirectory(_tempStoragePath);
+        // The bytecode of the replaced scripts is never loaded again, don't keep it
+        if (scriptsUpdated)
+        {
+            ScriptBytecodeCache::getInstance()->clear();
+        }
     }
     // 3. swap the localManifest
     CC_SAFE_RELEASE(_localManifest);
@@ -965,7 +1354,6 @@ void AssetsManagerEx::fileError(const std::string& identifier, const std::string
     dispatchUpdateEvent(EventAssetsManagerEx::EventCode::ERROR_UPDATING, identifier, errorStr, errorCode, errorCodeInternal);
     _tempManifest->setAssetDownloadState(identifier, Manifest::DownloadState::UNSTARTED);
     
-    _currConcurrentTask = MAX(0, _currConcurrentTask-1);
     queueDowload();
 }
 
@@ -995,7 +1383,6 @@ void AssetsManagerEx::fileSuccess(const std::string &customId, const std::string
     // Notify asset updated event
     dispatchUpdateEvent(EventAssetsManagerEx::EventCode::ASSET_UPDATED, customId);
     
-    _currConcurrentTask = MAX(0, _currConcurrentTask-1);
     queueDowload();
 }
 
@@ -1018,7 +1405,18 @@ void AssetsManagerEx::onError(const network::DownloadTask& task,
     }
     else
     {
-        fileError(task.identifier, errorStr, errorCode, errorCodeInternal);
+        _currConcurrentTask = MAX(0, _currConcurrentTask-1);
+        
+        auto unitIt = _downloadUnits.find(task.identifier);
+        if (unitIt != _downloadUnits.end() && !unitIt->second.patchBase.empty())
+        {
+            // The patch may not be published for every previous version, retry with the whole file
+            downloadFullAsset(task.identifier);
+        }
+        else
+        {
+            fileError(task.identifier, errorStr, errorCode, errorCodeInternal);
+        }
     }
 }
 
@@ -1092,24 +1490,31 @@ void AssetsManagerEx::onSuccess(const std::string &/*srcUrl*/, const std::string
     }
     else
     {
+        // The download slot is free as soon as the transfer is done,
+        // verification and decompression of this asset overlap the next downloads
+        _currConcurrentTask = MAX(0, _currConcurrentTask-1);
+        
         bool ok = true;
         auto &assets = _remoteManifest->getAssets();
         auto assetIt = assets.find(customId);
-        if (assetIt != assets.end())
+        bool found = assetIt != assets.end();
+        auto unitIt = _downloadUnits.find(customId);
+        bool patched = unitIt != _downloadUnits.end() && !unitIt->second.patchBase.empty();
+        if (found && !patched && _asyncVerifyCallback == nullptr && _verifyCallback != nullptr)
         {
             Manifest::Asset asset = assetIt->second;
-            if (_verifyCallback != nullptr)
-            {
-                ok = _verifyCallback(storagePath, asset);
-            }
+            ok = _verifyCallback(storagePath, asset);
         }
         
         if (ok)
         {
-            bool compressed = assetIt != assets.end() ? assetIt->second.compressed : false;
-            if (compressed)
+            bool compressed = found ? assetIt->second.compressed : false;
+            // The md5 verification is done with the other work of the workers
+            bool md5Check = found && _verifyCallback == nullptr && _md5Verification && !assetIt->second.md5.empty();
+            if (compressed || patched || (found && _asyncVerifyCallback != nullptr) || md5Check)
             {
-                decompressDownloadedZip(customId, storagePath);
+                processDownloadedAsset(customId, storagePath, compressed);
+                queueDowload();
             }
             else
             {
@@ -1168,7 +1573,9 @@ void AssetsManagerEx::queueDowload()
         _currConcurrentTask++;
         DownloadUnit& unit = _downloadUnits[key];
         _fileUtils->createDirectory(basename(unit.storagePath));
-        _downloader->createDownloadFileTask(unit.srcUrl, unit.storagePath, unit.customId);
+        // Patches are downloaded next to the file they produce
+        std::string storagePath = unit.patchBase.empty() ? unit.storagePath : unit.storagePath + PATCH_SUFFIX;
+        _downloader->createDownloadFileTask(unit.srcUrl, storagePath, unit.customId);
         
         _tempManifest->setAssetDownloadState(key, Manifest::DownloadState::DOWNLOADING);
     }
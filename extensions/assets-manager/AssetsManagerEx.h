@@ -126,6 +126,22 @@ public:
      */
     void setVerifyCallback(const std::function<bool(const std::string& path, Manifest::Asset asset)>& callback) {_verifyCallback = callback;};
     
+    /** @brief Set a verification function which is invoked on a worker thread instead of the cocos thread,
+     * so that hashing a downloaded asset overlaps the other downloads and decompressions, e.g. comparing utils::getFileMD5Hash(path) with asset.md5.
+     * The callback must be thread safe, when set it is used in place of the one passed to setVerifyCallback.
+     * @param callback  The verify callback function
+     * @since v3.14
+     */
+    void setAsyncVerifyCallback(const std::function<bool(const std::string& path, Manifest::Asset asset)>& callback) {_asyncVerifyCallback = callback;};
+    
+    /** @brief Verify the downloaded assets against the md5 of the manifest when no verify callback is set.
+     * The files are hashed by blocks on the worker threads of the JobSystem, several files at a time,
+     * the assets without md5 in the manifest aren't verified. Disabled by default.
+     * @since v3.14
+     */
+    void setMD5VerificationEnabled(bool enabled) {_md5Verification = enabled;};
+    bool isMD5VerificationEnabled() const {return _md5Verification;};
+    
 CC_CONSTRUCTOR_ACCESS:
     
     AssetsManagerEx(const std::string& manifestUrl, const std::string& storagePath);
@@ -154,10 +170,38 @@ protected:
     void parseVersion();
     void downloadManifest();
     void parseManifest();
+    /** @brief Called on the cocos thread once the remote manifest was parsed on a worker thread
+     */
+    void onManifestParsed(Manifest *manifest);
     void startUpdate();
+    /** @brief Called on the cocos thread once the assets to download were found on a worker thread
+     */
+    void onDiffGenerated(const std::unordered_map<std::string, Manifest::AssetDiff> &diff_map, const DownloadUnits &resumeUnits, bool resuming);
     void updateSucceed();
     bool decompress(const std::string &filename);
     void decompressDownloadedZip(const std::string &customId, const std::string &storagePath);
+    void processDownloadedAsset(const std::string &customId, const std::string &storagePath, bool compressed);
+    
+    /** @brief Apply a binary patch to a local file, the result is only written when its md5 matches.
+     * The patch uses the bsdiff 4 layout with zlib instead of bzip2 streams: the magic "BSDIFF4Z",
+     * the compressed lengths of the control and diff blocks and the size of the new file as 8 byte integers,
+     * followed by the zlib compressed control, diff and extra blocks.
+     * @param base      Local file of the previous version
+     * @param patchFile Downloaded patch
+     * @param dst       Path of the patched file
+     * @param md5       Expected md5 of the patched file, not checked when empty
+     * @since v3.14
+     */
+    bool patch(const std::string &base, const std::string &patchFile, const std::string &dst, const std::string &md5);
+    
+    /** @brief Turn the download unit of a modified asset into a patch download when the remote manifest
+     * provides a patch from the local version of the asset.
+     */
+    void preparePatch(const Manifest::Asset &asset, DownloadUnit &unit);
+    
+    /** @brief Queue a full download of an asset whose patch can't be downloaded or applied
+     */
+    void downloadFullAsset(const std::string &customId);
     
     /** @brief Update a list of assets under the current AssetsManagerEx context
      */
@@ -319,6 +363,15 @@ private:
     //! Callback function to verify the downloaded assets
     std::function<bool(const std::string& path, Manifest::Asset asset)> _verifyCallback;
     
+    //! Verification callback invoked on a worker thread
+    std::function<bool(const std::string& path, Manifest::Asset asset)> _asyncVerifyCallback;
+    
+    //! Whether the assets are verified against the md5 of the manifest without callback
+    bool _md5Verification;
+    
+    //! Whether the remote manifest is being parsed on a worker thread
+    bool _parsingManifest;
+    
     //! Marker for whether the assets manager is inited
     bool _inited;
 };
@@ -46,6 +46,8 @@
 #define KEY_SIZE                "size"
 #define KEY_COMPRESSED_FILE     "compressedFile"
 #define KEY_DOWNLOAD_STATE      "downloadState"
+#define KEY_PATCHES             "patches"
+#define KEY_FROM                "from"
 
 NS_CC_EXT_BEGIN
 
@@ -440,6 +442,25 @@ Manifest::Asset Manifest::parseAsset(const std::string &path, const rapidjson::V
     }
     else asset.downloadState = DownloadState::UNMARKED;
     
+    if ( json.HasMember(KEY_PATCHES) && json[KEY_PATCHES].IsArray() )
+    {
+        const rapidjson::Value& patches = json[KEY_PATCHES];
+        for (rapidjson::SizeType i = 0; i < patches.Size(); ++i)
+        {
+            const rapidjson::Value& entry = patches[i];
+            if (entry.IsObject()
+                && entry.HasMember(KEY_FROM) && entry[KEY_FROM].IsString()
+                && entry.HasMember(KEY_PATH) && entry[KEY_PATH].IsString())
+            {
+                ManifestAssetPatch patch;
+                patch.from = entry[KEY_FROM].GetString();
+                patch.path = entry[KEY_PATH].GetString();
+                patch.size = entry.HasMember(KEY_SIZE) && entry[KEY_SIZE].IsInt() ? entry[KEY_SIZE].GetInt() : 0;
+                asset.patches.push_back(patch);
+            }
+        }
+    }
+    
     return asset;
 }
 
@@ -44,6 +44,16 @@ struct DownloadUnit
     std::string storagePath;
     std::string customId;
     float       size;
+    //! Local file the downloaded binary patch applies to, empty for a full download
+    std::string patchBase;
+};
+
+//! Binary patch upgrading a previous version of an asset, see AssetsManagerEx::patch for the format
+struct ManifestAssetPatch {
+    //! md5 of the asset version the patch applies to
+    std::string from;
+    std::string path;
+    float size;
 };
 
 struct ManifestAsset {
@@ -52,6 +62,7 @@ struct ManifestAsset {
     bool compressed;
     float size;
     int downloadState;
+    std::vector<ManifestAssetPatch> patches;
 };
 
 typedef std::unordered_map<std::string, DownloadUnit> DownloadUnits;
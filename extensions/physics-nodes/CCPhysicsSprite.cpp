@@ -38,12 +38,29 @@
 
 NS_CC_EXT_BEGIN
 
+namespace
+{
+    // the body state of the last sync of each running sprite, with the same index
+    struct BodyState
+    {
+        float x;
+        float y;
+        float angle;
+    };
+
+    std::vector<PhysicsSprite*> s_syncedSprites;
+    std::vector<BodyState> s_bodyStates;
+    // a single listener syncs all the sprites
+    EventListenerCustom* s_syncListener = nullptr;
+}
+
 PhysicsSprite::PhysicsSprite()
 : _ignoreBodyRotation(false)
 , _CPBody(nullptr)
 , _pB2Body(nullptr)
 , _PTMRatio(0.0f)
-, _syncTransform(nullptr)
+, _syncIndex(-1)
+, _physicsDirty(true)
 {}
 
 PhysicsSprite* PhysicsSprite::create()
@@ -156,7 +173,8 @@ PhysicsSprite* PhysicsSprite::create(const char *pszFileName, const Rect& rect)
 // If you return NO, then getNodeToParentTransform won't be called.
 bool PhysicsSprite::isDirty() const
 {
-    return true;
+    // set by afterUpdate() when the body moved
+    return _dirty;
 }
 
 bool PhysicsSprite::isIgnoreBodyRotation() const
@@ -221,6 +239,7 @@ void PhysicsSprite::setCPBody(cpBody *pBody)
 {
 #if CC_ENABLE_CHIPMUNK_INTEGRATION
     _CPBody = pBody;
+    _physicsDirty = true;
 #else
     CCASSERT(false, "Can't call chipmunk methods when Chipmunk is disabled");
 #endif
@@ -240,6 +259,7 @@ void PhysicsSprite::setB2Body(b2Body *pBody)
 {
 #if CC_ENABLE_BOX2D_INTEGRATION
     _pB2Body = pBody;
+    _physicsDirty = true;
 #else
     CC_UNUSED_PARAM(pBody);
     CCASSERT(false, "Can't call box2d methods when Box2d is disabled");
@@ -260,6 +280,7 @@ void PhysicsSprite::setPTMRatio(float fRatio)
 {
 #if CC_ENABLE_BOX2D_INTEGRATION
      _PTMRatio = fRatio;
+     _physicsDirty = true;
 #else
     CC_UNUSED_PARAM(fRatio);
     CCASSERT(false, "Can't call box2d methods when Box2d is disabled");
@@ -290,6 +311,8 @@ const Vec2& PhysicsSprite::getPosFromPhysics() const
 
 void PhysicsSprite::setPosition(float x, float y)
 {
+    _physicsDirty = true;
+
 #if CC_ENABLE_CHIPMUNK_INTEGRATION
 
     cpVect cpPos = cpv(x, y);
@@ -340,6 +363,8 @@ float PhysicsSprite::getRotation() const
 
 void PhysicsSprite::setRotation(float fRotation)
 {
+    _physicsDirty = true;
+
     if (_ignoreBodyRotation)
     {
         Sprite::setRotation(fRotation);
@@ -426,22 +451,83 @@ void PhysicsSprite::syncPhysicsTransform() const
 void PhysicsSprite::onEnter()
 {
     Node::onEnter();
-    _syncTransform = Director::getInstance()->getEventDispatcher()->addCustomEventListener(Director::EVENT_AFTER_UPDATE, std::bind(&PhysicsSprite::afterUpdate, this, std::placeholders::_1));
-    _syncTransform->retain();
+
+    if (s_syncedSprites.empty())
+    {
+        s_syncListener = Director::getInstance()->getEventDispatcher()->addCustomEventListener(Director::EVENT_AFTER_UPDATE, [](EventCustom*) {
+            PhysicsSprite::syncAllPhysicsTransforms();
+        });
+        s_syncListener->retain();
+    }
+
+    _syncIndex = (ssize_t)s_syncedSprites.size();
+    s_syncedSprites.push_back(this);
+    s_bodyStates.push_back(BodyState());
+    _physicsDirty = true;
 }
 
 void PhysicsSprite::onExit()
 {
-    if (_syncTransform != nullptr)
+    if (_syncIndex >= 0)
     {
-        Director::getInstance()->getEventDispatcher()->removeEventListener(_syncTransform);
-        _syncTransform->release();
+        // the last sprite takes the place of this one
+        auto last = s_syncedSprites.back();
+        s_syncedSprites[_syncIndex] = last;
+        s_bodyStates[_syncIndex] = s_bodyStates.back();
+        last->_syncIndex = _syncIndex;
+        s_syncedSprites.pop_back();
+        s_bodyStates.pop_back();
+        _syncIndex = -1;
+
+        if (s_syncedSprites.empty())
+        {
+            Director::getInstance()->getEventDispatcher()->removeEventListener(s_syncListener);
+            CC_SAFE_RELEASE_NULL(s_syncListener);
+        }
     }
     Node::onExit();
 }
 
+void PhysicsSprite::syncAllPhysicsTransforms()
+{
+    for (size_t i = 0, count = s_syncedSprites.size(); i < count; ++i)
+    {
+        s_syncedSprites[i]->afterUpdate(nullptr);
+    }
+}
+
 void PhysicsSprite::afterUpdate(EventCustom* /*event*/)
 {
+    BodyState& state = s_bodyStates[_syncIndex];
+
+#if CC_ENABLE_CHIPMUNK_INTEGRATION
+
+    if (_CPBody == nullptr)
+        return;
+    // a sleeping body doesn't move, and setting its position or angle wakes it up
+    if (cpBodyIsSleeping(_CPBody) && !_physicsDirty && !_transformDirty)
+        return;
+    cpVect cpPos = cpBodyGetPosition(_CPBody);
+    BodyState current = { (float)cpPos.x, (float)cpPos.y, (float)cpBodyGetAngle(_CPBody) };
+
+#elif CC_ENABLE_BOX2D_INTEGRATION
+
+    if (_pB2Body == nullptr)
+        return;
+    if (!_pB2Body->IsAwake() && !_physicsDirty && !_transformDirty)
+        return;
+    b2Vec2 pos = _pB2Body->GetPosition();
+    BodyState current = { pos.x, pos.y, _pB2Body->GetAngle() };
+#endif
+
+    // _transformDirty is set when the scale, the anchor point or the ignored body rotation changed
+    if (!_physicsDirty && !_transformDirty
+        && current.x == state.x && current.y == state.y && current.angle == state.angle)
+        return;
+
+    state = current;
+    _physicsDirty = false;
+
     syncPhysicsTransform();
     
     _transformDirty = false;
@@ -46,6 +46,8 @@ NS_CC_EXT_BEGIN
  - Position and rotation are going to updated from the physics body
  - If you update the rotation or position manually, the physics body will be updated
  - You can't enble both Chipmunk support and Box2d support at the same time. Only one can be enabled at compile time
+ - The sprites are synced from their bodies together once per frame, after the update; the sleeping bodies
+   and the ones that didn't move are skipped
  * @lua NA
  */
 class CC_EX_DLL PhysicsSprite : public Sprite
@@ -111,6 +113,13 @@ public:
     void setPTMRatio(float fPTMRatio);
     virtual void syncPhysicsTransform() const;
 
+    /** Syncs the transforms of all the running PhysicsSprites from their bodies. Called after the update of
+     * every frame, it can also be called after stepping the physics elsewhere.
+     * The sprites whose bodies are sleeping or didn't move since the last sync aren't updated.
+     * @since v3.14
+     */
+    static void syncAllPhysicsTransforms();
+
     // overrides
     virtual const Vec2& getPosition() const override;
     virtual void getPosition(float* x, float* y) const override;
@@ -130,6 +139,7 @@ public:
 
 protected:
     const Vec2& getPosFromPhysics() const;
+    /** Syncs the sprite from its body if it moved, or if the sprite or the body was changed by hand.*/
     void afterUpdate(EventCustom *event);
 
 protected:
@@ -142,8 +152,10 @@ protected:
     b2Body  *_pB2Body;
     float   _PTMRatio;
     
-    // Event for update synchronise physic transform
-    cocos2d::EventListenerCustom* _syncTransform;
+    // index in the synced sprites and their body states, -1 when not running
+    ssize_t _syncIndex;
+    // the body was moved by the setters, or a new body was set
+    bool    _physicsDirty;
 };
 
 NS_CC_EXT_END
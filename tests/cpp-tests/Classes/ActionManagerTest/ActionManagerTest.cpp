@@ -21,6 +21,9 @@ ActionManagerTests::ActionManagerTests()
     ADD_TEST_CASE(StopActionsByFlagsTest);
     ADD_TEST_CASE(ResumeTest);
     ADD_TEST_CASE(Issue14050Test);
+    ADD_TEST_CASE(ManyShortActionsTest);
+    ADD_TEST_CASE(BatchedTweensTest);
+    ADD_TEST_CASE(BatchedTweensOrderTest);
 }
 
 //------------------------------------------------------------------
@@ -378,3 +381,185 @@ std::string Issue14050Test::subtitle() const
 {
     return "Issue14050. Sprite should not leak.";
 }
+
+//------------------------------------------------------------------
+//
+// ManyShortActionsTest
+//
+//------------------------------------------------------------------
+void ManyShortActionsTest::onEnter()
+{
+    ActionManagerTest::onEnter();
+
+    _finishedActions = 0;
+    _infoLabel = Label::createWithTTF("", "fonts/arial.ttf", 20);
+    _infoLabel->setPosition(Vec2(VisibleRect::center().x, VisibleRect::top().y - 75));
+    addChild(_infoLabel, 1);
+
+    // every node keeps replacing its finished action, so actions are created and
+    // destroyed all the time while the update array stays large
+    auto size = VisibleRect::getVisibleRect().size;
+    for (int i = 0; i < 1000; ++i)
+    {
+        auto node = Sprite::create("Images/r1.png");
+        node->setPosition(VisibleRect::leftBottom() + Vec2(CCRANDOM_0_1() * size.width, CCRANDOM_0_1() * size.height));
+        addChild(node);
+        runShortAction(node);
+    }
+
+    schedule(CC_SCHEDULE_SELECTOR(ManyShortActionsTest::updateInfo), 1.0f);
+}
+
+void ManyShortActionsTest::runShortAction(Node* node)
+{
+    auto move = MoveBy::create(0.05f + CCRANDOM_0_1() * 0.2f, Vec2(CCRANDOM_MINUS1_1() * 10, CCRANDOM_MINUS1_1() * 10));
+    node->runAction(Sequence::create(move, CallFunc::create([this, node]() {
+        ++_finishedActions;
+        runShortAction(node);
+    }), nullptr));
+}
+
+void ManyShortActionsTest::updateInfo(float dt)
+{
+    _infoLabel->setString(StringUtils::format("running: %d, finished per second: %d",
+        (int)Director::getInstance()->getActionManager()->getNumberOfRunningActions(), _finishedActions));
+    _finishedActions = 0;
+}
+
+std::string ManyShortActionsTest::subtitle() const
+{
+    return "1000 nodes replacing their actions as they finish";
+}
+
+//------------------------------------------------------------------
+//
+// BatchedTweensTest
+//
+//------------------------------------------------------------------
+void BatchedTweensTest::onEnter()
+{
+    ActionManagerTest::onEnter();
+
+    _infoLabel = Label::createWithTTF("", "fonts/arial.ttf", 20);
+    _infoLabel->setPosition(Vec2(VisibleRect::center().x, VisibleRect::top().y - 75));
+    addChild(_infoLabel, 1);
+
+    // the left column runs simple tweens which ActionManager batches, the right column runs the
+    // same tweens inside Speed, which steps them one by one. Both columns have to stay the same.
+    std::function<ActionInterval*()> tweens[] = {
+        []() { return MoveBy::create(2, Vec2(0, 150)); },
+        []() { return EaseSineInOut::create(MoveTo::create(2, Vec2(100, 200))); },
+        []() { return EaseIn::create(ScaleTo::create(2, 2.0f), 3.0f); },
+        []() { return EaseBackOut::create(RotateTo::create(2, 270)); },
+        []() { return FadeOut::create(2); },
+        []() { return EaseQuadraticActionInOut::create(TintTo::create(2, Color3B::RED)); },
+    };
+
+    int column = 0;
+    for (auto& tween : tweens)
+    {
+        auto batched = Sprite::create(s_pathGrossini);
+        batched->setPosition(Vec2(VisibleRect::left().x + 40 + column * 35, VisibleRect::center().y - 50));
+        addChild(batched);
+        batched->runAction(tween());
+        _batched.pushBack(batched);
+
+        auto stepped = Sprite::create(s_pathGrossini);
+        stepped->setPosition(batched->getPosition() + Vec2(VisibleRect::getVisibleRect().size.width / 2, 0));
+        addChild(stepped);
+        stepped->runAction(Speed::create(tween(), 1.0f));
+        _stepped.pushBack(stepped);
+
+        ++column;
+    }
+
+    schedule(CC_SCHEDULE_SELECTOR(BatchedTweensTest::compare));
+}
+
+void BatchedTweensTest::compare(float dt)
+{
+    auto offset = Vec2(VisibleRect::getVisibleRect().size.width / 2, 0);
+    for (ssize_t i = 0; i < _batched.size(); ++i)
+    {
+        auto batched = _batched.at(i);
+        auto stepped = _stepped.at(i);
+        if (batched->getPosition() + offset != stepped->getPosition() ||
+            batched->getScaleX() != stepped->getScaleX() ||
+            batched->getRotation() != stepped->getRotation() ||
+            batched->getOpacity() != stepped->getOpacity() ||
+            batched->getColor() != stepped->getColor())
+        {
+            _infoLabel->setString(StringUtils::format("Tween %d differs", (int)i));
+            unschedule(CC_SCHEDULE_SELECTOR(BatchedTweensTest::compare));
+            return;
+        }
+    }
+    _infoLabel->setString("Batched and stepped tweens match");
+}
+
+std::string BatchedTweensTest::subtitle() const
+{
+    return "Batched tweens should match stepped ones";
+}
+
+//------------------------------------------------------------------
+//
+// BatchedTweensOrderTest
+//
+//------------------------------------------------------------------
+void BatchedTweensOrderTest::onEnter()
+{
+    ActionManagerTest::onEnter();
+
+    _infoLabel = Label::createWithTTF("", "fonts/arial.ttf", 20);
+    _infoLabel->setPosition(Vec2(VisibleRect::center().x, VisibleRect::top().y - 75));
+    addChild(_infoLabel, 1);
+
+    auto offset = Vec2(VisibleRect::getVisibleRect().size.width / 2, 0);
+
+    // two actions of a node set the same property, the one added last wins in both columns,
+    // whether it is batched or stepped
+    auto batched = Sprite::create(s_pathGrossini);
+    batched->setPosition(Vec2(VisibleRect::left().x + 60, VisibleRect::center().y - 50));
+    addChild(batched);
+    batched->runAction(Speed::create(ScaleTo::create(2, 0.5f), 1.0f));
+    batched->runAction(ScaleTo::create(2, 2.0f));
+    _batched.pushBack(batched);
+
+    auto stepped = Sprite::create(s_pathGrossini);
+    stepped->setPosition(batched->getPosition() + offset);
+    addChild(stepped);
+    stepped->runAction(Speed::create(ScaleTo::create(2, 0.5f), 1.0f));
+    stepped->runAction(Speed::create(ScaleTo::create(2, 2.0f), 1.0f));
+    _stepped.pushBack(stepped);
+
+    // the rate of a running ease is changed, see changeRate()
+    batched = Sprite::create(s_pathGrossini);
+    batched->setPosition(Vec2(VisibleRect::left().x + 160, VisibleRect::center().y - 50));
+    addChild(batched);
+    _batchedEase = EaseIn::create(MoveBy::create(2, Vec2(0, 150)), 3.0f);
+    batched->runAction(_batchedEase);
+    _batched.pushBack(batched);
+
+    stepped = Sprite::create(s_pathGrossini);
+    stepped->setPosition(batched->getPosition() + offset);
+    addChild(stepped);
+    _steppedEase = EaseIn::create(MoveBy::create(2, Vec2(0, 150)), 3.0f);
+    stepped->runAction(Speed::create(_steppedEase, 1.0f));
+    _stepped.pushBack(stepped);
+
+    schedule(CC_SCHEDULE_SELECTOR(BatchedTweensTest::compare));
+    scheduleOnce(CC_SCHEDULE_SELECTOR(BatchedTweensOrderTest::changeRate), 0.5f);
+}
+
+void BatchedTweensOrderTest::changeRate(float dt)
+{
+    // both eases are still running, they finish after 2 seconds
+    _batchedEase->setRate(0.5f);
+    _steppedEase->setRate(0.5f);
+}
+
+std::string BatchedTweensOrderTest::subtitle() const
+{
+    return "Batched tweens keep the order of the actions and follow rate changes";
+}
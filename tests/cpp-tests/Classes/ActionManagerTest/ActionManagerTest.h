@@ -105,4 +105,45 @@ public:
 protected:
 };
 
+class ManyShortActionsTest : public ActionManagerTest
+{
+public:
+    CREATE_FUNC(ManyShortActionsTest);
+
+    virtual std::string subtitle() const override;
+    virtual void onEnter() override;
+    void runShortAction(cocos2d::Node* node);
+    void updateInfo(float dt);
+protected:
+    cocos2d::Label* _infoLabel;
+    unsigned int _finishedActions;
+};
+
+class BatchedTweensTest : public ActionManagerTest
+{
+public:
+    CREATE_FUNC(BatchedTweensTest);
+
+    virtual std::string subtitle() const override;
+    virtual void onEnter() override;
+    void compare(float dt);
+protected:
+    cocos2d::Label* _infoLabel;
+    cocos2d::Vector<cocos2d::Node*> _batched;
+    cocos2d::Vector<cocos2d::Node*> _stepped;
+};
+
+class BatchedTweensOrderTest : public BatchedTweensTest
+{
+public:
+    CREATE_FUNC(BatchedTweensOrderTest);
+
+    virtual std::string subtitle() const override;
+    virtual void onEnter() override;
+    void changeRate(float dt);
+protected:
+    cocos2d::EaseRateAction* _batchedEase;
+    cocos2d::EaseRateAction* _steppedEase;
+};
+
 #endif
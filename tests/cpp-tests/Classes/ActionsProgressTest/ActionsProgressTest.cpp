@@ -37,6 +37,7 @@ ActionsProgressTests::ActionsProgressTests()
     ADD_TEST_CASE(SpriteProgressBarVarious);
     ADD_TEST_CASE(SpriteProgressBarTintAndFade);
     ADD_TEST_CASE(SpriteProgressWithSpriteFrame);
+    ADD_TEST_CASE(SpriteProgressBatched);
 }
 
 //------------------------------------------------------------------
@@ -392,3 +393,42 @@ std::string SpriteProgressWithSpriteFrame::subtitle() const
 {
     return "Progress With Sprite Frame";
 }
+
+void SpriteProgressBatched::onEnter()
+{
+    SpriteDemo::onEnter();
+
+    auto s = Director::getInstance()->getWinSize();
+
+    SpriteFrameCache::getInstance()->addSpriteFramesWithFile("zwoptex/grossini.plist");
+
+    // cooldowns over their icons, the timers and the sprites share the texture of the frames
+    for (int i = 0; i < 40; ++i)
+    {
+        auto frameName = StringUtils::format("grossini_dance_%02d.png", i % 14 + 1);
+        auto position = Vec2(s.width * (i % 10 + 0.5f) / 10, s.height * (i / 10 + 1.0f) / 5.5f);
+
+        auto icon = Sprite::createWithSpriteFrameName(frameName);
+        icon->setOpacity(96);
+        icon->setScale(0.6f);
+        icon->setPosition(position);
+        addChild(icon);
+
+        auto cooldown = ProgressTimer::create(Sprite::createWithSpriteFrameName(frameName));
+        cooldown->setType(i % 2 ? ProgressTimer::Type::RADIAL : ProgressTimer::Type::BAR);
+        cooldown->setMidpoint(Vec2(0.5f, i % 4 == 0 ? 0.0f : 0.5f));
+        cooldown->setBarChangeRate(Vec2(0, 1));
+        cooldown->setReverseDirection(i % 3 == 0);
+        cooldown->setScale(0.6f);
+        cooldown->setPosition(position);
+        addChild(cooldown);
+
+        auto duration = 1.0f + (i % 5) * 0.5f;
+        cooldown->runAction(RepeatForever::create(Sequence::createWithTwoActions(ProgressFromTo::create(duration, 0, 100), DelayTime::create(0.2f))));
+    }
+}
+
+std::string SpriteProgressBatched::subtitle() const
+{
+    return "40 cooldowns and their icons in a few draw calls";
+}
@@ -103,4 +103,13 @@ public:
     virtual std::string subtitle() const override;
 };
 
+class SpriteProgressBatched : public SpriteDemo
+{
+public:
+    CREATE_FUNC(SpriteProgressBatched);
+
+    virtual void onEnter() override;
+    virtual std::string subtitle() const override;
+};
+
 #endif // _ACTIONS__PROGRESS_TEST_H_
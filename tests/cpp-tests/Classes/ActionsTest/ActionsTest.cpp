@@ -54,6 +54,7 @@ ActionsTests::ActionsTests()
     ADD_TEST_CASE(ActionFade);
     ADD_TEST_CASE(ActionTint);
     ADD_TEST_CASE(ActionAnimate);
+    ADD_TEST_CASE(ActionFlipbookAnimator);
     ADD_TEST_CASE(ActionSequence);
     ADD_TEST_CASE(ActionSequence2);
     ADD_TEST_CASE(ActionSequence3);
@@ -705,6 +706,68 @@ std::string ActionAnimate::subtitle() const
     return "Center: Manual animation. Border: using file format animation";
 }
 
+//------------------------------------------------------------------
+//
+// ActionFlipbookAnimator
+//
+//------------------------------------------------------------------
+void ActionFlipbookAnimator::onEnter()
+{
+    ActionsDemo::onEnter();
+
+    centerSprites(0);
+
+    auto animation = Animation::create();
+    for (int i = 1; i < 15; i++)
+    {
+        char szName[100] = {0};
+        sprintf(szName, "Images/grossini_dance_%02d.png", i);
+        animation->addSpriteFrameWithFile(szName);
+    }
+    animation->setDelayPerUnit(2.8f / 14.0f);
+    animation->setLoops(-1);
+
+    // the clones of an action share the frames of the animation
+    auto animate = Animate::create(animation);
+    auto clone = animate->clone();
+    CCASSERT(clone->getAnimation() == animation, "the clone should share the animation");
+    CCASSERT(animation->getFrameTable()->getFrameCount() == 14, "the table should have the 14 frames");
+    CCASSERT(animation->getFrameTable()->findFrame(0.5f) == 7, "the frame in the middle should be found");
+
+    _animator = FlipbookAnimator::create();
+    _animator->retain();
+
+    auto s = Director::getInstance()->getWinSize();
+    const int columns = 25;
+    const int rows = 10;
+    for (int i = 0; i < columns * rows; ++i)
+    {
+        auto sprite = Sprite::create("Images/grossini_dance_01.png");
+        sprite->setScale(0.3f);
+        sprite->setPosition(s.width * ((i % columns) + 0.5f) / columns, s.height * 0.2f + s.height * 0.6f * ((i / columns) + 0.5f) / rows);
+        addChild(sprite);
+        _animator->play(sprite, animation, 2.8f * i / (columns * rows));
+    }
+    CCASSERT(_animator->getSpriteCount() == columns * rows, "every sprite should be playing");
+}
+
+void ActionFlipbookAnimator::onExit()
+{
+    _animator->stopAll();
+    CC_SAFE_RELEASE_NULL(_animator);
+    ActionsDemo::onExit();
+}
+
+std::string ActionFlipbookAnimator::title() const
+{
+    return "FlipbookAnimator";
+}
+
+std::string ActionFlipbookAnimator::subtitle() const
+{
+    return "250 sprites playing one animation from one update";
+}
+
 //------------------------------------------------------------------
 //
 //    ActionSequence
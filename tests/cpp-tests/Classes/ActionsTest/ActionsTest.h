@@ -185,6 +185,20 @@ private:
     cocos2d::EventListenerCustom* _frameDisplayedListener;
 };
 
+class ActionFlipbookAnimator : public ActionsDemo
+{
+public:
+    CREATE_FUNC(ActionFlipbookAnimator);
+
+    virtual void onEnter() override;
+    virtual void onExit() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+
+private:
+    cocos2d::FlipbookAnimator* _animator;
+};
+
 class ActionSequence : public ActionsDemo
 {
 public:
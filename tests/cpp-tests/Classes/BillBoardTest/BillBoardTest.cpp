@@ -38,6 +38,7 @@ BillBoardTests::BillBoardTests()
 {
     ADD_TEST_CASE(BillBoardRotationTest);
     ADD_TEST_CASE(BillBoardTest);
+    ADD_TEST_CASE(BillBoardBatchTest);
 }
 
 //------------------------------------------------------------------
@@ -306,3 +307,86 @@ void BillBoardTest::rotateCameraCallback(Ref* sender,float value)
     rotation3D.y+= value;
     _camera->setRotation3D(rotation3D);
 }
+
+//------------------------------------------------------------------
+//
+// Billboard Batch Test
+//
+//------------------------------------------------------------------
+BillBoardBatchTest::BillBoardBatchTest()
+: _camera(nullptr)
+, _batched(true)
+, _angle(0.0f)
+{
+    auto s = Director::getInstance()->getWinSize();
+    _camera = Camera::createPerspective(60, (GLfloat)s.width/s.height, 1, 1000);
+    _camera->setCameraFlag(CameraFlag::USER1);
+    addChild(_camera);
+
+    _plainNode = Node::create();
+    addChild(_plainNode);
+    _batchNode = BillBoardBatchNode::create();
+    addChild(_batchNode);
+
+    // a forest of two textures, one draw call per texture when batched
+    std::string imgs[2] = {"Images/Icon.png", "Images/r2.png"};
+    for (int i = 0; i < 50; ++i)
+    {
+        for (int j = 0; j < 50; ++j)
+        {
+            auto billboard = BillBoard::create(imgs[(i + j) % 2], (i % 10) ? BillBoard::Mode::VIEW_POINT_ORIENTED : BillBoard::Mode::VIEW_PLANE_ORIENTED);
+            billboard->setScale(0.1f + CCRANDOM_0_1() * 0.1f);
+            billboard->setPosition3D(Vec3(i * 12.0f - 300.0f, 5.0f, j * 12.0f - 300.0f));
+            billboard->setOpacity(CCRANDOM_0_1() * 128 + 128);
+            _batchNode->addChild(billboard);
+            _billboards.push_back(billboard);
+        }
+    }
+    _batchNode->setCameraMask(2);
+    _plainNode->setCameraMask(2);
+
+    TTFConfig ttfConfig("fonts/arial.ttf", 16);
+    auto menuItem = MenuItemLabel::create(Label::createWithTTF(ttfConfig, "Switch batching"), CC_CALLBACK_1(BillBoardBatchTest::switchBatching, this));
+    menuItem->setPosition(Vec2(s.width - 100, VisibleRect::top().y - 100));
+    auto menu = Menu::create(menuItem, nullptr);
+    menu->setPosition(Vec2::ZERO);
+    addChild(menu, 10);
+
+    _label = Label::createWithTTF(ttfConfig, "batched");
+    _label->setPosition(Vec2(s.width - 100, VisibleRect::top().y - 130));
+    addChild(_label, 10);
+
+    scheduleUpdate();
+}
+
+void BillBoardBatchTest::switchBatching(Ref* /*sender*/)
+{
+    _batched = !_batched;
+    auto from = _batched ? _plainNode : _batchNode;
+    auto to = _batched ? _batchNode : _plainNode;
+    for (auto billboard : _billboards)
+    {
+        billboard->retain();
+        from->removeChild(billboard, false);
+        to->addChild(billboard);
+        billboard->release();
+    }
+    _label->setString(_batched ? "batched" : "not batched");
+}
+
+void BillBoardBatchTest::update(float dt)
+{
+    _angle += dt * 0.2f;
+    _camera->setPosition3D(Vec3(cosf(_angle) * 350.0f, 120.0f, sinf(_angle) * 350.0f));
+    _camera->lookAt(Vec3::ZERO, Vec3(0, 1, 0));
+}
+
+std::string BillBoardBatchTest::title() const
+{
+    return "BillBoard Batch Test";
+}
+
+std::string BillBoardBatchTest::subtitle() const
+{
+    return "2500 billboards facing the camera in the vertex shader";
+}
@@ -69,6 +69,27 @@ protected:
     std::vector<cocos2d::BillBoard*> _billboards;
 };
 
+class BillBoardBatchTest : public TestCase
+{
+public:
+    CREATE_FUNC(BillBoardBatchTest);
+    BillBoardBatchTest();
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual void update(float dt) override;
+
+protected:
+    void switchBatching(cocos2d::Ref* sender);
+
+    cocos2d::Camera* _camera;
+    cocos2d::Node* _plainNode;
+    cocos2d::Node* _batchNode;
+    cocos2d::Label* _label;
+    std::vector<cocos2d::BillBoard*> _billboards;
+    bool _batched;
+    float _angle;
+};
+
 DEFINE_TEST_SUITE(BillBoardTests);
 
 #endif
@@ -45,6 +45,8 @@ Camera3DTests::Camera3DTests()
     ADD_TEST_CASE(CameraArcBallDemo);
     ADD_TEST_CASE(CameraFrameBufferTest);
     ADD_TEST_CASE(BackgroundColorBrushTest);
+    ADD_TEST_CASE(CameraSubtreeMaskTest);
+    ADD_TEST_CASE(CameraDynamicResolutionTest);
 }
 
 //------------------------------------------------------------------
@@ -1496,6 +1498,130 @@ std::string BackgroundColorBrushTest::subtitle() const
     return "right side object colored by CameraBG";
 }
 
+std::string CameraSubtreeMaskTest::title() const
+{
+    return "Subtree camera masks";
+}
+
+std::string CameraSubtreeMaskTest::subtitle() const
+{
+    return "Each camera only walks the nodes it sees";
+}
+
+void CameraSubtreeMaskTest::onEnter()
+{
+    CameraBaseTest::onEnter();
+
+    auto s = Director::getInstance()->getWinSize();
+
+    // a world seen by a perspective camera and by a minimap camera, the UI by the default camera
+    auto world = Node::create();
+    for (int i = 0; i < 400; ++i)
+    {
+        auto sprite = Sprite::create("Images/grossini.png");
+        sprite->setPosition3D(Vec3(CCRANDOM_MINUS1_1() * 300, CCRANDOM_MINUS1_1() * 200, CCRANDOM_MINUS1_1() * 100));
+        sprite->setScale(0.3f);
+        world->addChild(sprite);
+    }
+    world->setCameraMask((unsigned short)CameraFlag::USER1 | (unsigned short)CameraFlag::USER2);
+    addChild(world);
+
+    auto worldCamera = Camera::createPerspective(60, (GLfloat)s.width / s.height, 1, 1000);
+    worldCamera->setPosition3D(Vec3(0, 0, 400));
+    worldCamera->lookAt(Vec3::ZERO);
+    worldCamera->setDepth(-1);
+    worldCamera->setCameraFlag(CameraFlag::USER1);
+    addChild(worldCamera);
+
+    auto minimapCamera = Camera::createOrthographic(s.width, s.height, 1, 1000);
+    minimapCamera->setPosition3D(Vec3(-s.width / 2, -s.height / 2, 500));
+    minimapCamera->setScale(4);
+    minimapCamera->setDepth(1);
+    minimapCamera->setCameraFlag(CameraFlag::USER2);
+    addChild(minimapCamera);
+
+    auto label = Label::createWithTTF(StringUtils::format("world subtree mask: 0x%x, scene subtree mask: 0x%x",
+        world->getSubtreeCameraMask(), getSubtreeCameraMask()), "fonts/arial.ttf", 12);
+    label->setPosition(Vec2(s.width / 2, s.height / 4));
+    addChild(label);
+}
+
+std::string CameraDynamicResolutionTest::title() const
+{
+    return "Dynamic resolution";
+}
+
+std::string CameraDynamicResolutionTest::subtitle() const
+{
+    return "The world camera is scaled, the labels stay sharp";
+}
+
+void CameraDynamicResolutionTest::onEnter()
+{
+    CameraBaseTest::onEnter();
+
+    auto s = Director::getInstance()->getWinSize();
+
+    auto camera = Camera::createPerspective(60, (GLfloat)s.width / s.height, 1, 1000);
+    camera->setPosition3D(Vec3(0, 30, 120));
+    camera->lookAt(Vec3::ZERO);
+    camera->setDepth(-1);
+    camera->setCameraFlag(CameraFlag::USER1);
+    addChild(camera);
+
+    for (int i = 0; i < 5; ++i)
+    {
+        for (int j = 0; j < 5; ++j)
+        {
+            auto model = Sprite3D::create("Sprite3DTest/boss1.obj");
+            model->setScale(3);
+            model->setPosition3D(Vec3((i - 2) * 30.0f, 0, (j - 2) * 30.0f));
+            model->setTexture("Sprite3DTest/boss.png");
+            model->setCameraMask((unsigned short)CameraFlag::USER1);
+            model->runAction(RepeatForever::create(RotateBy::create(2, Vec3(0, 360, 0))));
+            addChild(model);
+        }
+    }
+
+    auto dynamicResolution = Director::getInstance()->getDynamicResolution();
+    dynamicResolution->setEnabled(true);
+    dynamicResolution->setAutoScaleEnabled(false);
+    dynamicResolution->setScaleRange(0.25f, 1);
+    dynamicResolution->setScale(0.5f);
+
+    auto label = Label::createWithTTF("", "fonts/arial.ttf", 14);
+    label->setPosition(Vec2(s.width / 2, s.height / 4));
+    addChild(label);
+    label->schedule([label, dynamicResolution](float) {
+        label->setString(StringUtils::format("scale %.2f, %s", dynamicResolution->getScale(),
+            dynamicResolution->isAutoScaleEnabled() ? "adjusted to the frame time" : "fixed"));
+    }, "label");
+
+    auto lower = MenuItemFont::create("Lower", [dynamicResolution](Ref*) {
+        dynamicResolution->setScale(dynamicResolution->getScale() - 0.25f);
+    });
+    auto higher = MenuItemFont::create("Higher", [dynamicResolution](Ref*) {
+        dynamicResolution->setScale(dynamicResolution->getScale() + 0.25f);
+    });
+    auto automatic = MenuItemFont::create("Auto", [dynamicResolution](Ref*) {
+        dynamicResolution->setAutoScaleEnabled(!dynamicResolution->isAutoScaleEnabled());
+    });
+    auto menu = Menu::create(lower, higher, automatic, nullptr);
+    menu->alignItemsHorizontallyWithPadding(20);
+    menu->setPosition(Vec2(s.width / 2, s.height / 4 - 30));
+    addChild(menu);
+}
+
+void CameraDynamicResolutionTest::onExit()
+{
+    auto dynamicResolution = Director::getInstance()->getDynamicResolution();
+    dynamicResolution->setEnabled(false);
+    dynamicResolution->setAutoScaleEnabled(true);
+    dynamicResolution->setScaleRange(0.5f, 1);
+    dynamicResolution->setScale(1);
+    CameraBaseTest::onExit();
+}
+
 void BackgroundColorBrushTest::onEnter()
 {
     CameraBaseTest::onEnter();
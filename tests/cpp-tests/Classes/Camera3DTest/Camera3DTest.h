@@ -281,4 +281,29 @@ public:
     virtual void onEnter() override;
 };
 
+class CameraSubtreeMaskTest : public CameraBaseTest
+{
+public:
+    CREATE_FUNC(CameraSubtreeMaskTest);
+
+    // overrides
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+
+    virtual void onEnter() override;
+};
+
+class CameraDynamicResolutionTest : public CameraBaseTest
+{
+public:
+    CREATE_FUNC(CameraDynamicResolutionTest);
+
+    // overrides
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+
+    virtual void onEnter() override;
+    virtual void onExit() override;
+};
+
 #endif
@@ -37,6 +37,7 @@ ClippingNodeTests::ClippingNodeTests()
     ADD_TEST_CASE(RawStencilBufferTest6);
     ADD_TEST_CASE(ClippingToRenderTextureTest);
     ADD_TEST_CASE(ClippingRectangleNodeTest);
+    ADD_TEST_CASE(ClippingNodeScissorTest);
 }
 
 //// Demo examples start here
@@ -606,13 +607,13 @@ void RawStencilBufferTest::draw(Renderer *renderer, const Mat4 &transform, uint3
 
 void RawStencilBufferTest::onEnableStencil()
 {
-    glEnable(GL_STENCIL_TEST);
+    GL::enable(GL_STENCIL_TEST);
     CHECK_GL_ERROR_DEBUG();
 }
 
 void RawStencilBufferTest::onDisableStencil()
 {
-    glDisable(GL_STENCIL_TEST);
+    GL::disable(GL_STENCIL_TEST);
     CHECK_GL_ERROR_DEBUG();
 }
 
@@ -680,19 +681,19 @@ void RawStencilBufferTest::onBeforeDrawSprite(int planeIndex, const Vec2& pt)
 void RawStencilBufferTest::setupStencilForClippingOnPlane(GLint plane)
 {
     GLint planeMask = 0x1 << plane;
-    glStencilMask(planeMask);
+    GL::stencilMask(planeMask);
     glClearStencil(0x0);
     glClear(GL_STENCIL_BUFFER_BIT);
     glFlush();
-    glStencilFunc(GL_NEVER, planeMask, planeMask);
-    glStencilOp(GL_REPLACE, GL_KEEP, GL_KEEP);
+    GL::stencilFunc(GL_NEVER, planeMask, planeMask);
+    GL::stencilOp(GL_REPLACE, GL_KEEP, GL_KEEP);
 }
 
 void RawStencilBufferTest::setupStencilForDrawingOnPlane(GLint plane)
 {
     GLint planeMask = 0x1 << plane;
-    glStencilFunc(GL_EQUAL, planeMask, planeMask);
-    glStencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
+    GL::stencilFunc(GL_EQUAL, planeMask, planeMask);
+    GL::stencilOp(GL_KEEP, GL_KEEP, GL_KEEP);
 }
 
 //@implementation RawStencilBufferTest2
@@ -705,12 +706,12 @@ std::string RawStencilBufferTest2::subtitle() const
 void RawStencilBufferTest2::setupStencilForClippingOnPlane(GLint plane)
 {
     RawStencilBufferTest::setupStencilForClippingOnPlane(plane);
-    glDepthMask(GL_FALSE);
+    GL::depthMask(GL_FALSE);
 }
 
 void RawStencilBufferTest2::setupStencilForDrawingOnPlane(GLint plane)
 {
-    glDepthMask(GL_TRUE);
+    GL::depthMask(GL_TRUE);
     RawStencilBufferTest::setupStencilForDrawingOnPlane(plane);
 }
 
@@ -724,13 +725,13 @@ std::string RawStencilBufferTest3::subtitle() const
 void RawStencilBufferTest3::setupStencilForClippingOnPlane(GLint plane)
 {
     RawStencilBufferTest::setupStencilForClippingOnPlane(plane);
-    glDisable(GL_DEPTH_TEST);
-    glDepthMask(GL_FALSE);
+    GL::disable(GL_DEPTH_TEST);
+    GL::depthMask(GL_FALSE);
 }
 
 void RawStencilBufferTest3::setupStencilForDrawingOnPlane(GLint plane)
 {
-    glDepthMask(GL_TRUE);
+    GL::depthMask(GL_TRUE);
     //glEnable(GL_DEPTH_TEST);
     RawStencilBufferTest::setupStencilForDrawingOnPlane(plane);
 }
@@ -754,7 +755,7 @@ std::string RawStencilBufferTest4::subtitle() const
 void RawStencilBufferTest4::setupStencilForClippingOnPlane(GLint plane)
 {
     RawStencilBufferTest::setupStencilForClippingOnPlane(plane);
-    glDepthMask(GL_FALSE);
+    GL::depthMask(GL_FALSE);
 
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32) || (CC_TARGET_PLATFORM == CC_PLATFORM_LINUX) || (CC_TARGET_PLATFORM == CC_PLATFORM_MAC)
     glEnable(GL_ALPHA_TEST);
@@ -772,7 +773,7 @@ void RawStencilBufferTest4::setupStencilForDrawingOnPlane(GLint plane)
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32) || (CC_TARGET_PLATFORM == CC_PLATFORM_LINUX) || (CC_TARGET_PLATFORM == CC_PLATFORM_MAC)
     glDisable(GL_ALPHA_TEST);
 #endif
-    glDepthMask(GL_TRUE);
+    GL::depthMask(GL_TRUE);
     RawStencilBufferTest::setupStencilForDrawingOnPlane(plane);
 }
 
@@ -786,8 +787,8 @@ std::string RawStencilBufferTest5::subtitle() const
 void RawStencilBufferTest5::setupStencilForClippingOnPlane(GLint plane)
 {
     RawStencilBufferTest::setupStencilForClippingOnPlane(plane);
-    glDisable(GL_DEPTH_TEST);
-    glDepthMask(GL_FALSE);
+    GL::disable(GL_DEPTH_TEST);
+    GL::depthMask(GL_FALSE);
 
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32) || (CC_TARGET_PLATFORM == CC_PLATFORM_LINUX) || (CC_TARGET_PLATFORM == CC_PLATFORM_MAC)
     glEnable(GL_ALPHA_TEST);
@@ -805,7 +806,7 @@ void RawStencilBufferTest5::setupStencilForDrawingOnPlane(GLint plane)
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32) || (CC_TARGET_PLATFORM == CC_PLATFORM_LINUX) || (CC_TARGET_PLATFORM == CC_PLATFORM_MAC)
     glDisable(GL_ALPHA_TEST);
 #endif
-    glDepthMask(GL_TRUE);
+    GL::depthMask(GL_TRUE);
     //glEnable(GL_DEPTH_TEST);
     RawStencilBufferTest::setupStencilForDrawingOnPlane(plane);
 }
@@ -824,7 +825,7 @@ void RawStencilBufferTest6::setup()
     auto winPoint = Vec2(Director::getInstance()->getWinSize());
     //by default, glReadPixels will pack data with 4 bytes alignment
     unsigned char bits[4] = {0,0,0,0};
-    glStencilMask(~0);
+    GL::stencilMask(~0);
     glClearStencil(0);
     glClear(GL_STENCIL_BUFFER_BIT);
     glFlush();
@@ -832,7 +833,7 @@ void RawStencilBufferTest6::setup()
     auto clearToZeroLabel = Label::createWithTTF(StringUtils::format("00=%02x", bits[0]), "fonts/arial.ttf", 20);
     clearToZeroLabel->setPosition((winPoint.x / 3) * 1, winPoint.y - 10);
     this->addChild(clearToZeroLabel);
-    glStencilMask(0x0F);
+    GL::stencilMask(0x0F);
     glClearStencil(0xAA);
     glClear(GL_STENCIL_BUFFER_BIT);
     glFlush();
@@ -841,15 +842,15 @@ void RawStencilBufferTest6::setup()
     clearToMaskLabel->setPosition((winPoint.x / 3) * 2, winPoint.y - 10);
     this->addChild(clearToMaskLabel);
 #endif
-    glStencilMask(~0);
+    GL::stencilMask(~0);
 }
 
 void RawStencilBufferTest6::setupStencilForClippingOnPlane(GLint plane)
 {
     GLint planeMask = 0x1 << plane;
-    glStencilMask(planeMask);
-    glStencilFunc(GL_NEVER, 0, planeMask);
-    glStencilOp(GL_REPLACE, GL_KEEP, GL_KEEP);
+    GL::stencilMask(planeMask);
+    GL::stencilFunc(GL_NEVER, 0, planeMask);
+    GL::stencilOp(GL_REPLACE, GL_KEEP, GL_KEEP);
   
     Vec2 pt = Director::getInstance()->getWinSize();
     Vec2 vertices[] = {
@@ -877,10 +878,10 @@ void RawStencilBufferTest6::setupStencilForClippingOnPlane(GLint plane)
 
     CC_INCREMENT_GL_DRAWN_BATCHES_AND_VERTICES(1, 4);
     
-    glStencilFunc(GL_NEVER, planeMask, planeMask);
-    glStencilOp(GL_REPLACE, GL_KEEP, GL_KEEP);
-    glDisable(GL_DEPTH_TEST);
-    glDepthMask(GL_FALSE);
+    GL::stencilFunc(GL_NEVER, planeMask, planeMask);
+    GL::stencilOp(GL_REPLACE, GL_KEEP, GL_KEEP);
+    GL::disable(GL_DEPTH_TEST);
+    GL::depthMask(GL_FALSE);
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32) || (CC_TARGET_PLATFORM == CC_PLATFORM_LINUX) || (CC_TARGET_PLATFORM == CC_PLATFORM_MAC)
     glEnable(GL_ALPHA_TEST);
     glAlphaFunc(GL_GREATER, _alphaThreshold);
@@ -898,7 +899,7 @@ void RawStencilBufferTest6::setupStencilForDrawingOnPlane(GLint plane)
 #if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32) || (CC_TARGET_PLATFORM == CC_PLATFORM_LINUX) || (CC_TARGET_PLATFORM == CC_PLATFORM_MAC)
     glDisable(GL_ALPHA_TEST);
 #endif
-    glDepthMask(GL_TRUE);
+    GL::depthMask(GL_TRUE);
     //glEnable(GL_DEPTH_TEST);
     RawStencilBufferTest::setupStencilForDrawingOnPlane(plane);
     glFlush();
@@ -1070,3 +1071,57 @@ void ClippingRectangleNodeTest::setup()
     content->setPosition(this->getContentSize().width / 2, this->getContentSize().height / 2);
     clipper->addChild(content);
 }
+
+// ClippingNodeScissorTest
+
+std::string ClippingNodeScissorTest::title() const
+{
+    return "ClippingNode Scissor Test";
+}
+
+std::string ClippingNodeScissorTest::subtitle() const
+{
+    return "Rectangles use the scissor test, the rotated one the stencil";
+}
+
+void ClippingNodeScissorTest::setup()
+{
+    auto s = this->getContentSize();
+    for (int i = 0; i < 4; ++i)
+    {
+        auto stencil = DrawNode::create();
+        stencil->drawSolidRect(Vec2::ZERO, Vec2(80, 80), Color4F::WHITE);
+
+        auto clipper = ClippingNode::create(stencil);
+        clipper->setPosition(s.width * (i + 1) / 6 - 40, s.height / 2 - 40);
+        this->addChild(clipper);
+
+        auto content = Sprite::create(s_back2);
+        content->setPosition(40, 40);
+        clipper->addChild(content);
+
+        // the last one can't be clipped with the scissor test
+        if (i == 3)
+        {
+            clipper->runAction(RepeatForever::create(RotateBy::create(4, 360)));
+        }
+        else
+        {
+            clipper->runAction(RepeatForever::create(Sequence::create(MoveBy::create(1, Vec2(0, 40)), MoveBy::create(1, Vec2(0, -40)), nullptr)));
+        }
+    }
+
+    // a clipper nested in another one which can be clipped with the scissor test
+    auto outer = ClippingNode::create(LayerColor::create(Color4B::WHITE, 100, 100));
+    outer->setPosition(s.width * 5 / 6 - 50, s.height / 2 - 50);
+    this->addChild(outer);
+
+    auto inner = DrawNode::create();
+    inner->drawSolidRect(Vec2(-20, -20), Vec2(60, 60), Color4F::WHITE);
+    auto nested = ClippingNode::create(inner);
+    outer->addChild(nested);
+
+    auto content = Sprite::create(s_back2);
+    content->setPosition(50, 50);
+    nested->addChild(content);
+}
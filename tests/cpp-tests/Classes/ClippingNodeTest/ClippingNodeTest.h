@@ -250,4 +250,14 @@ public:
     virtual void setup() override;
 };
 
+class ClippingNodeScissorTest : public BaseClippingNodeTest
+{
+public:
+    CREATE_FUNC(ClippingNodeScissorTest);
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual void setup() override;
+};
+
 #endif //__CLIPPINGNODETEST_H__
@@ -48,6 +48,7 @@ ConsoleTests::ConsoleTests()
 {
     ADD_TEST_CASE(ConsoleCustomCommand);
     ADD_TEST_CASE(ConsoleUploadFile);
+    ADD_TEST_CASE(ConsoleTrace);
 }
 
 BaseTestConsole::BaseTestConsole()
@@ -276,3 +277,65 @@ std::string ConsoleUploadFile::subtitle() const
     return "file uploaded to:" + writablePath + _targetFileName;
 }
 
+//------------------------------------------------------------------
+//
+// ConsoleTrace
+//
+//------------------------------------------------------------------
+
+ConsoleTrace::ConsoleTrace()
+{
+}
+
+ConsoleTrace::~ConsoleTrace()
+{
+}
+
+void ConsoleTrace::onEnter()
+{
+    BaseTestConsole::onEnter();
+
+    auto tracer = TraceProfiler::getInstance();
+    tracer->clear();
+    tracer->setEnabled(true);
+    scheduleUpdate();
+
+    // two seconds of frames, then the same file "trace save" would write
+    scheduleOnce([=](float /*dt*/) {
+        auto path = FileUtils::getInstance()->getWritablePath() + "trace.json";
+        bool saved = tracer->saveChromeTrace(path);
+
+        auto s = Director::getInstance()->getWinSize();
+        auto label = Label::createWithTTF(saved ? path : "Could not save the trace", "fonts/arial.ttf", 12);
+        label->setPosition(Vec2(s.width / 2, s.height / 2));
+        label->setDimensions(s.width * 0.9f, 0);
+        label->setAlignment(TextHAlignment::CENTER);
+        this->addChild(label);
+    }, 2.0f, "save_trace");
+}
+
+void ConsoleTrace::onExit()
+{
+    TraceProfiler::getInstance()->setEnabled(false);
+    BaseTestConsole::onExit();
+}
+
+void ConsoleTrace::update(float /*dt*/)
+{
+    CC_PROFILER_ZONE("ConsoleTrace::update");
+
+    // something to look at in the trace
+    Mat4 m;
+    for (int i = 0; i < 1000; ++i)
+        m.rotateZ(0.01f);
+}
+
+std::string ConsoleTrace::title() const
+{
+    return "Console trace";
+}
+
+std::string ConsoleTrace::subtitle() const
+{
+    return "telnet localhost 5678, then: trace on | off | save | clear";
+}
@@ -78,4 +78,23 @@ private:
     std::string _targetFileName;
 };
 
+class ConsoleTrace : public BaseTestConsole
+{
+public:
+    CREATE_FUNC(ConsoleTrace);
+
+    virtual void onEnter() override;
+    virtual void onExit() override;
+    virtual void update(float dt) override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+
+protected:
+    ConsoleTrace();
+    virtual ~ConsoleTrace();
+
+private:
+    CC_DISALLOW_COPY_AND_ASSIGN(ConsoleTrace);
+};
+
 #endif // _CONSOLE_TEST_H_
@@ -319,7 +319,88 @@ struct DownloaderTest : public TestCase
     }
 };
 
+struct DownloaderSegmentTest : public TestCase
+{
+    CREATE_FUNC(DownloaderSegmentTest);
+
+    virtual std::string title() const override { return "Downloader Segment Test"; }
+    virtual std::string subtitle() const override { return "Big file in 4 range requests, tap again to resume"; }
+
+    std::unique_ptr<network::Downloader> downloader;
+    Label* status;
+    bool throttled;
+
+    DownloaderSegmentTest()
+    : status(nullptr)
+    , throttled(false)
+    {
+        network::DownloaderHints hints =
+        {
+            6,
+            45,
+            ".tmp",
+            4,
+            3,
+            512 * 1024,
+            0
+        };
+        downloader.reset(new network::Downloader(hints));
+    }
+
+    virtual void onEnter() override
+    {
+        TestCase::onEnter();
+
+        auto menu = Menu::create();
+        menu->setPosition(Vec2::ZERO);
+        addChild(menu);
+
+        auto path = FileUtils::getInstance()->getWritablePath() + "CppTests/DownloaderTest/segmented big file";
+        auto download = MenuItemFont::create("Download", [this, path](Ref*) {
+            status->setString("waiting...");
+            downloader->createDownloadFileTask(sURLList[3], path, sNameList[3]);
+        });
+        download->setPosition(VisibleRect::center() + Vec2(0, 60));
+        menu->addChild(download);
+
+        auto throttle = MenuItemFont::create("Limit to 256 KB/s: off", [this](Ref* sender) {
+            throttled = !throttled;
+            downloader->setMaxBytesPerSecond(throttled ? 256 * 1024 : 0);
+            static_cast<MenuItemFont*>(sender)->setString(throttled ? "Limit to 256 KB/s: on" : "Limit to 256 KB/s: off");
+        });
+        throttle->setPosition(VisibleRect::center() + Vec2(0, 20));
+        menu->addChild(throttle);
+
+        status = Label::createWithTTF("", "fonts/arial.ttf", 16);
+        status->setPosition(VisibleRect::center() + Vec2(0, -40));
+        addChild(status);
+
+        downloader->onTaskProgress = [this](const network::DownloadTask& task,
+                                          int64_t bytesReceived,
+                                          int64_t totalBytesReceived,
+                                          int64_t totalBytesExpected)
+        {
+            char buf[64];
+            sprintf(buf, "%.1f%% of %d KB", float(totalBytesReceived * 100) / totalBytesExpected, int(totalBytesExpected / 1024));
+            status->setString(buf);
+        };
+        downloader->onFileTaskSuccess = [this](const network::DownloadTask& task)
+        {
+            status->setString(StringUtils::format("Download [%s] success, %ld bytes.",
+                task.identifier.c_str(), FileUtils::getInstance()->getFileSize(task.storagePath)));
+        };
+        downloader->onTaskError = [this](const network::DownloadTask& task,
+                                         int errorCode,
+                                         int errorCodeInternal,
+                                         const std::string& errorStr)
+        {
+            status->setString(errorStr.length() ? errorStr : "Download failed.");
+        };
+    }
+};
+
 DownloaderTests::DownloaderTests()
 {
     ADD_TEST_CASE(DownloaderTest);
+    ADD_TEST_CASE(DownloaderSegmentTest);
 };
@@ -19,6 +19,7 @@ DrawPrimitivesTests::DrawPrimitivesTests()
     ADD_TEST_CASE(DrawNodeTest);
     ADD_TEST_CASE(PrimitivesCommandTest);
     ADD_TEST_CASE(Issue11942Test);
+    ADD_TEST_CASE(DrawNodeStaticBatchTest);
 }
 
 string DrawPrimitivesBaseTest::title() const
@@ -412,6 +413,44 @@ string Issue11942Test::subtitle() const
     return "drawCircle() with width";
 }
 
+//
+// DrawNodeStaticBatchTest
+//
+DrawNodeStaticBatchTest::DrawNodeStaticBatchTest()
+{
+    auto s = Director::getInstance()->getWinSize();
+    const int columns = 10;
+    const int rows = 6;
+
+    for (int i = 0; i < columns * rows; ++i)
+    {
+        // built once, then only moved, rotated and faded
+        auto draw = DrawNode::create();
+        draw->setStatic(true);
+        draw->setBatchingEnabled(true);
+        draw->drawSolidRect(Vec2(-12, -12), Vec2(12, 12), Color4F(CCRANDOM_0_1(), CCRANDOM_0_1(), CCRANDOM_0_1(), 1));
+        draw->drawDot(Vec2::ZERO, 6, Color4F(1, 1, 1, 0.5f));
+        draw->setPosition(Vec2(s.width * (i % columns + 0.5f) / columns, s.height * (0.2f + 0.6f * (i / columns + 0.5f) / rows)));
+        addChild(draw);
+
+        draw->runAction(RepeatForever::create(RotateBy::create(2, 360)));
+        if (i % 2)
+        {
+            draw->runAction(RepeatForever::create(Sequence::create(FadeTo::create(1, 64), FadeTo::create(1, 255), nullptr)));
+        }
+    }
+}
+
+string DrawNodeStaticBatchTest::title() const
+{
+    return "Static DrawNode batching";
+}
+
+string DrawNodeStaticBatchTest::subtitle() const
+{
+    return "60 static DrawNodes should be drawn in 1 draw call";
+}
+
 
 #if defined(__GNUC__) && ((__GNUC__ >= 4) || ((__GNUC__ == 3) && (__GNUC_MINOR__ >= 1)))
 #pragma GCC diagnostic warning "-Wdeprecated-declarations"
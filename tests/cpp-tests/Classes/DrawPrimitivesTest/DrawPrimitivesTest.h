@@ -72,4 +72,15 @@ public:
 
 };
 
+class DrawNodeStaticBatchTest : public DrawPrimitivesBaseTest
+{
+public:
+    CREATE_FUNC(DrawNodeStaticBatchTest);
+
+    DrawNodeStaticBatchTest();
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+};
+
 #endif
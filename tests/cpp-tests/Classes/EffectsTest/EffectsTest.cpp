@@ -28,6 +28,7 @@ EffectTests::EffectTests()
     ADD_TEST_CASE(SplitColsDemo);
     ADD_TEST_CASE(PageTurn3DDemo);
     ADD_TEST_CASE(PageTurn3DRectDemo);
+    ADD_TEST_CASE(ShaderEffectsDemo);
 }
 
 Shaky3DDemo::Shaky3DDemo()
@@ -317,6 +318,26 @@ PageTurn3DRectDemo::PageTurn3DRectDemo()
     _subtitle = "";
 }
 
+cocos2d::ActionInterval* ShaderEffectsDemo::createEffect(float t)
+{
+    auto size = Director::getInstance()->getWinSize();
+    auto waves = Waves3D::create(t, Size(60,40), 5, 40);
+    auto ripple = Ripple3D::create(t, Size(96,64), Vec2(size.width/2,size.height/2), 240, 4, 160);
+    auto twirl = Twirl::create(t, Size(48,32), Vec2(size.width/2, size.height/2), 1, 2.5f);
+    auto pageTurn = PageTurn3D::create(t, Size(60,40));
+    waves->setShaderEnabled(true);
+    ripple->setShaderEnabled(true);
+    twirl->setShaderEnabled(true);
+    pageTurn->setShaderEnabled(true);
+    return Sequence::create(waves, ripple, twirl, pageTurn, nullptr);
+}
+
+ShaderEffectsDemo::ShaderEffectsDemo()
+{
+    _title = "Grid effects in the vertex shader";
+    _subtitle = "Waves3D, Ripple3D, Twirl and PageTurn3D on fine grids";
+}
+
 #define SID_RESTART        1
 
 EffectBaseTest::EffectBaseTest()
@@ -230,4 +230,13 @@ protected:
     virtual cocos2d::ActionInterval* createEffect(float t) override;
 };
 
+class ShaderEffectsDemo : public EffectBaseTest
+{
+public:
+    CREATE_FUNC(ShaderEffectsDemo);
+    ShaderEffectsDemo();
+protected:
+    virtual cocos2d::ActionInterval* createEffect(float t) override;
+};
+
 #endif
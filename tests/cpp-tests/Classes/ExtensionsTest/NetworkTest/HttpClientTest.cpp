@@ -9,6 +9,8 @@ using namespace cocos2d::network;
 HttpClientTests::HttpClientTests()
 {
     ADD_TEST_CASE(HttpClientTest);
+    ADD_TEST_CASE(HttpClientBurstTest);
+    ADD_TEST_CASE(HttpClientStreamTest);
 }
 
 HttpClientTest::HttpClientTest() 
@@ -374,3 +376,155 @@ void HttpClientTest::onHttpRequestCompleted(HttpClient *sender, HttpResponse *re
         log("request ref count not 2, is %d", response->getHttpRequest()->getReferenceCount());
     }
 }
+
+HttpClientBurstTest::HttpClientBurstTest()
+: _labelStatus(nullptr)
+, _pendingRequests(0)
+{
+    auto winSize = Director::getInstance()->getWinSize();
+
+    auto menuRequest = Menu::create();
+    menuRequest->setPosition(Vec2::ZERO);
+    addChild(menuRequest);
+
+    auto labelSerial = Label::createWithTTF("Burst of 12, one at a time", "fonts/arial.ttf", 22);
+    auto itemSerial = MenuItemLabel::create(labelSerial, CC_CALLBACK_1(HttpClientBurstTest::onMenuBurstClicked, this, 1));
+    itemSerial->setPosition(winSize.width / 2, winSize.height - 80);
+    menuRequest->addChild(itemSerial);
+
+    auto labelConcurrent = Label::createWithTTF("Burst of 12, 8 concurrent", "fonts/arial.ttf", 22);
+    auto itemConcurrent = MenuItemLabel::create(labelConcurrent, CC_CALLBACK_1(HttpClientBurstTest::onMenuBurstClicked, this, 8));
+    itemConcurrent->setPosition(winSize.width / 2, winSize.height - 115);
+    menuRequest->addChild(itemConcurrent);
+
+    _labelStatus = Label::createWithTTF("", "fonts/arial.ttf", 18);
+    _labelStatus->setPosition(winSize.width / 2, winSize.height / 2 - 20);
+    _labelStatus->setAlignment(TextHAlignment::CENTER);
+    addChild(_labelStatus);
+}
+
+HttpClientBurstTest::~HttpClientBurstTest()
+{
+    HttpClient::destroyInstance();
+}
+
+void HttpClientBurstTest::onMenuBurstClicked(cocos2d::Ref *sender, int maxConcurrentRequests)
+{
+    if (_pendingRequests > 0)
+    {
+        return;
+    }
+
+    auto client = HttpClient::getInstance();
+    client->setMaxConcurrentRequests(maxConcurrentRequests);
+
+    // Every request takes a second on the server, the ones tagged with "!" are queued with a higher priority
+    const int REQUEST_COUNT = 12;
+    for (int i = 0; i < REQUEST_COUNT; ++i)
+    {
+        bool important = (i % 4 == 3);
+        HttpRequest* request = new (std::nothrow) HttpRequest();
+        request->setUrl("http://httpbin.org/delay/1");
+        request->setRequestType(HttpRequest::Type::GET);
+        request->setPriority(important ? 1 : 0);
+        request->setTag(StringUtils::format(important ? "%d!" : "%d", i));
+        request->setResponseCallback(CC_CALLBACK_2(HttpClientBurstTest::onHttpRequestCompleted, this));
+        client->send(request);
+        request->release();
+    }
+
+    _pendingRequests = REQUEST_COUNT;
+    _completionOrder.clear();
+    _burstStart = std::chrono::steady_clock::now();
+    _labelStatus->setString("waiting...");
+}
+
+void HttpClientBurstTest::onHttpRequestCompleted(HttpClient *sender, HttpResponse *response)
+{
+    if (!response)
+    {
+        return;
+    }
+
+    --_pendingRequests;
+    _completionOrder += std::string(_completionOrder.empty() ? "" : " ") + response->getHttpRequest()->getTag();
+
+    auto elapsed = std::chrono::duration_cast<std::chrono::milliseconds>(std::chrono::steady_clock::now() - _burstStart).count();
+    _labelStatus->setString(StringUtils::format("%d pending, %d ms\ncompleted: %s",
+        _pendingRequests, (int)elapsed, _completionOrder.c_str()));
+}
+
+HttpClientStreamTest::HttpClientStreamTest()
+: _labelStatus(nullptr)
+{
+    auto winSize = Director::getInstance()->getWinSize();
+
+    auto menuRequest = Menu::create();
+    menuRequest->setPosition(Vec2::ZERO);
+    addChild(menuRequest);
+
+    auto labelSink = Label::createWithTTF("Stream 1MB to a sink", "fonts/arial.ttf", 22);
+    auto itemSink = MenuItemLabel::create(labelSink, CC_CALLBACK_1(HttpClientStreamTest::onMenuSinkClicked, this));
+    itemSink->setPosition(winSize.width / 2, winSize.height - 80);
+    menuRequest->addChild(itemSink);
+
+    auto labelFile = Label::createWithTTF("Stream 1MB to a file", "fonts/arial.ttf", 22);
+    auto itemFile = MenuItemLabel::create(labelFile, CC_CALLBACK_1(HttpClientStreamTest::onMenuFileClicked, this));
+    itemFile->setPosition(winSize.width / 2, winSize.height - 115);
+    menuRequest->addChild(itemFile);
+
+    _labelStatus = Label::createWithTTF("", "fonts/arial.ttf", 18);
+    _labelStatus->setPosition(winSize.width / 2, winSize.height / 2 - 20);
+    addChild(_labelStatus);
+}
+
+HttpClientStreamTest::~HttpClientStreamTest()
+{
+    HttpClient::destroyInstance();
+}
+
+void HttpClientStreamTest::onMenuSinkClicked(cocos2d::Ref *sender)
+{
+    // The sink runs on the network thread, so it only counts and the label is updated in the callback
+    auto streamed = std::make_shared<size_t>(0);
+    auto chunks = std::make_shared<int>(0);
+
+    HttpRequest* request = new (std::nothrow) HttpRequest();
+    request->setUrl("http://httpbin.org/bytes/1048576");
+    request->setRequestType(HttpRequest::Type::GET);
+    request->setResponseDataSink([streamed, chunks](const char* data, size_t size) {
+        *streamed += size;
+        ++(*chunks);
+        return true;
+    });
+    request->setResponseCallback([this, streamed, chunks](HttpClient* client, HttpResponse* response) {
+        _labelStatus->setString(StringUtils::format("%s: %d bytes in %d chunks, %d bytes collected",
+            response->isSucceed() ? "succeeded" : "failed",
+            (int)*streamed, *chunks, (int)response->getResponseData()->size()));
+    });
+    HttpClient::getInstance()->send(request);
+    request->release();
+
+    _labelStatus->setString("waiting...");
+}
+
+void HttpClientStreamTest::onMenuFileClicked(cocos2d::Ref *sender)
+{
+    std::string fullPath = FileUtils::getInstance()->getWritablePath() + "http_stream_test.bin";
+
+    HttpRequest* request = new (std::nothrow) HttpRequest();
+    request->setUrl("http://httpbin.org/bytes/1048576");
+    request->setRequestType(HttpRequest::Type::GET);
+    request->setResponseFile(fullPath);
+    request->setResponseCallback([this, fullPath](HttpClient* client, HttpResponse* response) {
+        auto fileSize = FileUtils::getInstance()->getFileSize(fullPath);
+        _labelStatus->setString(StringUtils::format("%s: file has %ld bytes, %d bytes collected",
+            response->isSucceed() ? "succeeded" : "failed",
+            fileSize, (int)response->getResponseData()->size()));
+        FileUtils::getInstance()->removeFile(fullPath);
+    });
+    HttpClient::getInstance()->send(request);
+    request->release();
+
+    _labelStatus->setString("waiting...");
+}
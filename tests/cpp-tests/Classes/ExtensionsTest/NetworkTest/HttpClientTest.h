@@ -32,4 +32,43 @@ private:
     cocos2d::Label* _labelStatusCode;
 };
 
+class HttpClientBurstTest : public TestCase
+{
+public:
+    CREATE_FUNC(HttpClientBurstTest);
+
+    HttpClientBurstTest();
+    virtual ~HttpClientBurstTest();
+
+    void onMenuBurstClicked(cocos2d::Ref *sender, int maxConcurrentRequests);
+    void onHttpRequestCompleted(cocos2d::network::HttpClient *sender, cocos2d::network::HttpResponse *response);
+
+    virtual std::string title() const override { return "Http Request Burst Test"; }
+    virtual std::string subtitle() const override { return "Prioritized requests should finish first"; }
+
+private:
+    cocos2d::Label* _labelStatus;
+    std::chrono::steady_clock::time_point _burstStart;
+    int _pendingRequests;
+    std::string _completionOrder;
+};
+
+class HttpClientStreamTest : public TestCase
+{
+public:
+    CREATE_FUNC(HttpClientStreamTest);
+
+    HttpClientStreamTest();
+    virtual ~HttpClientStreamTest();
+
+    void onMenuSinkClicked(cocos2d::Ref *sender);
+    void onMenuFileClicked(cocos2d::Ref *sender);
+
+    virtual std::string title() const override { return "Http Streaming Response Test"; }
+    virtual std::string subtitle() const override { return "The body is never collected in the response"; }
+
+private:
+    cocos2d::Label* _labelStatus;
+};
+
 #endif //__HTTPREQUESTHTTP_H
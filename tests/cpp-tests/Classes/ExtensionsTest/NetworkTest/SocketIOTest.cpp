@@ -134,6 +134,15 @@ void SocketIOTest::echotest(SIOClient *client, const std::string& data) {
 
 }
 
+void SocketIOTest::binarytest(SIOClient *client, const std::string& data, const std::vector<std::vector<char>>& attachments) {
+
+	std::stringstream s;
+	s << client->getTag() << " received event binarytest with " << attachments.size() << " attachments";
+
+	_sioClientStatus->setString(s.str().c_str());
+
+}
+
 // onMessage is no longer a required override from the delegate class
 // 'message' events and handlers are now registered in the same way that other events are
 void SocketIOTest::message(network::SIOClient* client, const std::string& data)
@@ -206,6 +215,8 @@ void SocketIOTest::onMenuSIOClientClicked(cocos2d::Ref *sender)
 	_sioClient->on("json", CC_CALLBACK_2(SocketIOTest::json, this));
 	_sioClient->on("connect", CC_CALLBACK_2(SocketIOTest::connect, this));
 	_sioClient->on("disconnect", CC_CALLBACK_2(SocketIOTest::disconnect, this));
+	//events carrying binary attachments receive them beside the json arguments
+	_sioClient->onBinary("binarytest", CC_CALLBACK_3(SocketIOTest::binarytest, this));
 
 }
 
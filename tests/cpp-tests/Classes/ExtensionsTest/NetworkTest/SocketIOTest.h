@@ -79,6 +79,10 @@ public:
 	**/
 	void echotest(cocos2d::network::SIOClient *client, const std::string& data);
 	/**
+	*  @brief Socket.io event handler for custom binary event "binarytest"
+	**/
+	void binarytest(cocos2d::network::SIOClient *client, const std::string& data, const std::vector<std::vector<char>>& attachments);
+	/**
 	*  @brief Socket.io event handler for event "connect"
 	**/
 	void connect(cocos2d::network::SIOClient* client, const std::string& data);
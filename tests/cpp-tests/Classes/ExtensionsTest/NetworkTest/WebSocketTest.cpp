@@ -41,10 +41,15 @@ WebSocketTest::WebSocketTest()
     itemSendText->setPosition(Vec2(winSize.width / 2, winSize.height - MARGIN - 2 * SPACE));
     menuRequest->addChild(itemSendText);
     
+    labelSendText = Label::createWithTTF("Send Pooled Text", "fonts/arial.ttf", 20);
+    itemSendText = MenuItemLabel::create(labelSendText, CC_CALLBACK_1(WebSocketTest::onMenuSendPooledTextClicked, this));
+    itemSendText->setPosition(Vec2(winSize.width / 2, winSize.height - MARGIN - 3 * SPACE));
+    menuRequest->addChild(itemSendText);
+    
     // Send Binary
     auto labelSendBinary = Label::createWithTTF("Send Binary", "fonts/arial.ttf", 20);
     auto itemSendBinary = MenuItemLabel::create(labelSendBinary, CC_CALLBACK_1(WebSocketTest::onMenuSendBinaryClicked, this));
-    itemSendBinary->setPosition(Vec2(winSize.width / 2, winSize.height - MARGIN - 3 * SPACE));
+    itemSendBinary->setPosition(Vec2(winSize.width / 2, winSize.height - MARGIN - 4 * SPACE));
     menuRequest->addChild(itemSendBinary);
     
 
@@ -284,6 +289,32 @@ void WebSocketTest::onMenuSendMultipleTextClicked(cocos2d::Ref *sender)
     }
 }
 
+void WebSocketTest::onMenuSendPooledTextClicked(cocos2d::Ref *sender)
+{
+    if (! _wsiSendText)
+    {
+        return;
+    }
+    
+    if (_wsiSendText->getReadyState() == network::WebSocket::State::OPEN)
+    {
+        _sendTextStatus->setString("Send Pooled Text WS is waiting...");
+        for (int index = 0; index < 15; ++index) {
+            // Build the message in a pooled buffer, the queued messages are sent in a batch
+            std::string message = StringUtils::format("Hello WebSocket, pooled text message index:%d", index);
+            auto data = _wsiSendText->allocSendBuffer(message.length(), false);
+            memcpy(data->bytes, message.c_str(), message.length());
+            _wsiSendText->send(data);
+        }
+    }
+    else
+    {
+        std::string warningStr = "send text websocket instance wasn't ready...";
+        log("%s", warningStr.c_str());
+        _sendTextStatus->setString(warningStr.c_str());
+    }
+}
+
 void WebSocketTest::onMenuSendBinaryClicked(cocos2d::Ref *sender)
 {
     if (! _wsiSendBinary) {
@@ -8,6 +8,7 @@ USING_NS_CC_EXT;
 TableViewTests::TableViewTests()
 {
     ADD_TEST_CASE(TableViewTest);
+    ADD_TEST_CASE(TableViewPrefetchTest);
 }
 
 // on "init" you need to initialize your instance
@@ -90,3 +91,50 @@ ssize_t TableViewTest::numberOfCellsInTableView(TableView *table)
 {
     return 20;
 }
+
+bool TableViewPrefetchTest::init()
+{
+    if ( !TestCase::init() )
+    {
+        return false;
+    }
+
+    Size winSize = Director::getInstance()->getWinSize();
+
+    auto tableView = TableView::create(this, Size(60, 250));
+    tableView->setDirection(ScrollView::Direction::VERTICAL);
+    tableView->setPosition(Vec2(winSize.width/2-30,winSize.height/2-120));
+    tableView->setDelegate(this);
+    tableView->setVerticalFillOrder(TableView::VerticalFillOrder::TOP_DOWN);
+    tableView->setPrefetchDistance(8);
+    this->addChild(tableView);
+    tableView->reloadData();
+
+    return true;
+}
+
+std::string TableViewPrefetchTest::title() const
+{
+    return "TableView prefetch";
+}
+
+std::string TableViewPrefetchTest::subtitle() const
+{
+    return "8 cells are prepared ahead of the scroll, see the console";
+}
+
+ssize_t TableViewPrefetchTest::numberOfCellsInTableView(TableView *table)
+{
+    return 1000;
+}
+
+void TableViewPrefetchTest::tableCellsPrefetchForIndices(TableView* table, const std::vector<ssize_t>& indices)
+{
+    CCLOG("prefetch %ld cells from index %ld, %ld cells prepared", static_cast<long>(indices.size()),
+          static_cast<long>(indices.front()), static_cast<long>(table->getPrefetchedCellCount()));
+}
+
+void TableViewPrefetchTest::tableCellsCancelPrefetchForIndices(TableView* table, const std::vector<ssize_t>& indices)
+{
+    CCLOG("cancel the prefetch of %ld cells from index %ld", static_cast<long>(indices.size()), static_cast<long>(indices.front()));
+}
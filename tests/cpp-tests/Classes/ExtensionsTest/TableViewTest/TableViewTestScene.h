@@ -22,4 +22,18 @@ public:
     virtual ssize_t numberOfCellsInTableView(cocos2d::extension::TableView *table)override;
 };
 
+class TableViewPrefetchTest : public TableViewTest
+{
+public:
+    CREATE_FUNC(TableViewPrefetchTest);
+
+    virtual bool init() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+
+    virtual ssize_t numberOfCellsInTableView(cocos2d::extension::TableView *table)override;
+    virtual void tableCellsPrefetchForIndices(cocos2d::extension::TableView* table, const std::vector<ssize_t>& indices)override;
+    virtual void tableCellsCancelPrefetchForIndices(cocos2d::extension::TableView* table, const std::vector<ssize_t>& indices)override;
+};
+
 #endif // __TABLEVIEWTESTSCENE_H__
@@ -1,4 +1,7 @@
 #include "FileUtilsTest.h"
+#include <thread>
+#include <atomic>
+#include <chrono>
 
 USING_NS_CC;
 
@@ -23,6 +26,12 @@ FileUtilsTests::FileUtilsTests()
     ADD_TEST_CASE(TestFileFuncsAsync);
     ADD_TEST_CASE(TestWriteStringAsync);
     ADD_TEST_CASE(TestWriteDataAsync);
+    ADD_TEST_CASE(TestAssetPack);
+    ADD_TEST_CASE(TestPathCache);
+    ADD_TEST_CASE(TestFileStream);
+    ADD_TEST_CASE(TestGetDataFromFiles);
+    ADD_TEST_CASE(TestDataView);
+    ADD_TEST_CASE(TestAsyncOperation);
 }
 
 // TestResolutionDirectories
@@ -1367,3 +1376,346 @@ std::string TestWriteDataAsync::subtitle() const
 {
     return "";
 }
+
+// TestAssetPack
+
+void TestAssetPack::onEnter()
+{
+    FileUtilsDemo::onEnter();
+    auto sharedFileUtils = FileUtils::getInstance();
+    auto winSize = Director::getInstance()->getWinSize();
+
+    std::string packPath = sharedFileUtils->getWritablePath() + "assetPackTest" + AssetPack::EXTENSION;
+    std::vector<std::string> files = { "Images/grossini.png", "Images/grossinis_sister1.png", "Images/grossinis_sister2.png" };
+    bool written = AssetPack::writePack(packPath, "", files);
+
+    // the pack has the highest priority, like the first search path
+    _defaultSearchPathArray = sharedFileUtils->getOriginalSearchPaths();
+    sharedFileUtils->addSearchPath(packPath, true);
+
+    std::string fullPath = sharedFileUtils->fullPathForFilename(files[0]);
+    bool fromPack = fullPath.find(packPath) == 0;
+    Data original = sharedFileUtils->getDataFromFile(sharedFileUtils->getDefaultResourceRootPath() + files[0]);
+    Data packed = sharedFileUtils->getDataFromFile(files[0]);
+    bool same = original.getSize() == packed.getSize() && memcmp(original.getBytes(), packed.getBytes(), packed.getSize()) == 0;
+
+    auto label = Label::createWithTTF(StringUtils::format("write: %s, found in pack: %s, same contents: %s",
+                                                          written ? "ok" : "failed", fromPack ? "yes" : "no", same ? "yes" : "no"),
+                                      "fonts/Thonburi.ttf", 18);
+    label->setPosition(winSize.width / 2, winSize.height * 3 / 4);
+    addChild(label);
+
+    for (size_t i = 0; i < files.size(); ++i)
+    {
+        auto sprite = Sprite::create(files[i]);
+        sprite->setPosition(winSize.width * (i + 1) / (files.size() + 1), winSize.height / 3);
+        addChild(sprite);
+    }
+}
+
+void TestAssetPack::onExit()
+{
+    FileUtils *sharedFileUtils = FileUtils::getInstance();
+
+    // unmounts the pack
+    sharedFileUtils->setSearchPaths(_defaultSearchPathArray);
+    sharedFileUtils->removeFile(sharedFileUtils->getWritablePath() + "assetPackTest" + AssetPack::EXTENSION);
+
+    FileUtilsDemo::onExit();
+}
+
+std::string TestAssetPack::title() const
+{
+    return "FileUtils: asset pack";
+}
+
+std::string TestAssetPack::subtitle() const
+{
+    return "3 sprites read from a pack in the writable path";
+}
+
+// TestPathCache
+
+void TestPathCache::onEnter()
+{
+    FileUtilsDemo::onEnter();
+    auto sharedFileUtils = FileUtils::getInstance();
+    auto winSize = Director::getInstance()->getWinSize();
+
+    _defaultSearchPathArray = sharedFileUtils->getOriginalSearchPaths();
+    bool popupNotify = sharedFileUtils->isPopupNotify();
+    sharedFileUtils->setPopupNotify(false);
+
+    // the misses are cached, only the first lookup probes the disk
+    const int lookups = 1000;
+    auto begin = std::chrono::steady_clock::now();
+    for (int i = 0; i < lookups; ++i)
+    {
+        sharedFileUtils->isFileExist("Images/optional-hd/missing.png");
+    }
+    auto missTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin).count();
+
+    // the cache of misses is invalidated by writing the file
+    std::string writablePath = sharedFileUtils->getWritablePath();
+    sharedFileUtils->addSearchPath(writablePath, true);
+    bool missing = !sharedFileUtils->isFileExist("pathCacheTest.txt");
+    sharedFileUtils->writeStringToFile("path cache", writablePath + "pathCacheTest.txt");
+    bool found = sharedFileUtils->isFileExist("pathCacheTest.txt");
+
+    // and by renaming a file, the way the downloader moves its temporary files
+    bool renamedMissing = !sharedFileUtils->isFileExist("pathCacheRenamed.txt");
+    sharedFileUtils->renameFile(writablePath, "pathCacheTest.txt", "pathCacheRenamed.txt");
+    bool renamedFound = sharedFileUtils->isFileExist("pathCacheRenamed.txt");
+
+    // workers resolve paths while the search paths change
+    std::atomic<int> mismatches(0);
+    std::vector<std::thread> workers;
+    for (int i = 0; i < 4; ++i)
+    {
+        workers.emplace_back([sharedFileUtils, &mismatches]() {
+            for (int j = 0; j < 500; ++j)
+            {
+                if (sharedFileUtils->fullPathForFilename("Images/grossini.png").empty())
+                    ++mismatches;
+                sharedFileUtils->fullPathForFilename("Images/optional-hd/missing.png");
+            }
+        });
+    }
+    for (int i = 0; i < 100; ++i)
+    {
+        sharedFileUtils->addSearchPath("Images/optional-hd", (i % 2) == 0);
+    }
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+
+    sharedFileUtils->setPopupNotify(popupNotify);
+
+    auto label = Label::createWithTTF(StringUtils::format("%d cached misses: %lldus\nmissing before write: %s, found after: %s\nmissing before rename: %s, found after: %s\nconcurrent lookups failed: %d",
+                                                          lookups, (long long)missTime, missing ? "yes" : "no", found ? "yes" : "no",
+                                                          renamedMissing ? "yes" : "no", renamedFound ? "yes" : "no", mismatches.load()),
+                                      "fonts/Thonburi.ttf", 18);
+    label->setAlignment(TextHAlignment::CENTER);
+    label->setPosition(winSize.width / 2, winSize.height / 2);
+    addChild(label);
+}
+
+void TestPathCache::onExit()
+{
+    FileUtils *sharedFileUtils = FileUtils::getInstance();
+
+    sharedFileUtils->setSearchPaths(_defaultSearchPathArray);
+    sharedFileUtils->removeFile(sharedFileUtils->getWritablePath() + "pathCacheTest.txt");
+    sharedFileUtils->removeFile(sharedFileUtils->getWritablePath() + "pathCacheRenamed.txt");
+
+    FileUtilsDemo::onExit();
+}
+
+std::string TestPathCache::title() const
+{
+    return "FileUtils: path cache";
+}
+
+std::string TestPathCache::subtitle() const
+{
+    return "Misses are cached, 4 threads resolve paths while adding search paths";
+}
+
+// TestFileStream
+
+void TestFileStream::onEnter()
+{
+    FileUtilsDemo::onEnter();
+    auto sharedFileUtils = FileUtils::getInstance();
+    auto winSize = Director::getInstance()->getWinSize();
+
+    const std::string filename = "Images/grossini.png";
+    Data original = sharedFileUtils->getDataFromFile(filename);
+
+    // reads the file in chunks of 1k, then its last 16 bytes
+    bool same = false;
+    bool tail = false;
+    FileStream* stream = sharedFileUtils->openFileStream(filename);
+    if (stream)
+    {
+        std::vector<unsigned char> contents;
+        unsigned char chunk[1024];
+        ssize_t readsize;
+        while ((readsize = stream->read(chunk, sizeof(chunk))) > 0)
+        {
+            contents.insert(contents.end(), chunk, chunk + readsize);
+        }
+        same = stream->getSize() == original.getSize() && (ssize_t)contents.size() == original.getSize()
+            && memcmp(contents.data(), original.getBytes(), contents.size()) == 0;
+
+        tail = stream->readRange(stream->getSize() - 16, chunk, 16) == 16
+            && memcmp(chunk, original.getBytes() + original.getSize() - 16, 16) == 0;
+        delete stream;
+    }
+
+    auto label = Label::createWithTTF(StringUtils::format("%s: read in chunks: %s, last bytes: %s", filename.c_str(),
+                                                          same ? "ok" : "failed", tail ? "ok" : "failed"),
+                                      "fonts/Thonburi.ttf", 18);
+    label->setPosition(winSize.width / 2, winSize.height * 2 / 3);
+    addChild(label);
+
+    auto asyncLabel = Label::createWithTTF("reading async...", "fonts/Thonburi.ttf", 18);
+    asyncLabel->setPosition(winSize.width / 2, winSize.height / 3);
+    addChild(asyncLabel);
+
+    auto total = std::make_shared<ssize_t>(0);
+    auto chunks = std::make_shared<int>(0);
+    ssize_t expected = original.getSize();
+    sharedFileUtils->readFileChunksAsync(filename, 1024, [total, chunks](const Data& chunk) {
+        *total += chunk.getSize();
+        ++(*chunks);
+    }, [asyncLabel, total, chunks, expected](bool success) {
+        asyncLabel->setString(StringUtils::format("async: %s, %d chunks, %s bytes", success ? "ok" : "failed",
+                                                  *chunks, *total == expected ? "all" : "missing"));
+    });
+}
+
+std::string TestFileStream::title() const
+{
+    return "FileUtils: file stream";
+}
+
+std::string TestFileStream::subtitle() const
+{
+    return "Reads a file in 1k chunks, synchronously and async";
+}
+
+// TestGetDataFromFiles
+
+void TestGetDataFromFiles::onEnter()
+{
+    FileUtilsDemo::onEnter();
+    auto winSize = Director::getInstance()->getWinSize();
+
+    std::vector<std::string> files = { "Images/grossini.png", "Images/grossinis_sister1.png", "Images/grossinis_sister2.png",
+                                       "Images/blocks.png", "Images/background.png", "Images/missing-file.png" };
+
+    auto label = Label::createWithTTF("reading...", "fonts/Thonburi.ttf", 18);
+    label->setPosition(winSize.width / 2, winSize.height / 2);
+    addChild(label);
+
+    auto begin = std::chrono::steady_clock::now();
+    FileUtils::getInstance()->getDataFromFiles(files, [files, label, begin](std::vector<Data> results) {
+        auto elapsed = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin).count();
+        int same = 0;
+        for (size_t i = 0; i < files.size(); ++i)
+        {
+            Data data = FileUtils::getInstance()->getDataFromFile(files[i]);
+            if (data.getSize() == results[i].getSize() && (data.isNull() || memcmp(data.getBytes(), results[i].getBytes(), data.getSize()) == 0))
+                ++same;
+        }
+        label->setString(StringUtils::format("%d of %d files read like getDataFromFile() in %lldus",
+                                             same, (int)files.size(), (long long)elapsed));
+    });
+}
+
+std::string TestGetDataFromFiles::title() const
+{
+    return "FileUtils: batched async reads";
+}
+
+std::string TestGetDataFromFiles::subtitle() const
+{
+    return "6 files read with one callback, the last one doesn't exist";
+}
+
+void TestDataView::onEnter()
+{
+    FileUtilsDemo::onEnter();
+    auto winSize = Director::getInstance()->getWinSize();
+
+    auto label = Label::createWithTTF("reading...", "fonts/Thonburi.ttf", 18);
+    label->setPosition(winSize.width / 2, winSize.height / 2);
+    addChild(label);
+
+    auto runTests = []() {
+        auto fs = FileUtils::getInstance();
+        Data data = fs->getDataFromFile("fileLookup.plist");
+        DataView view = fs->getDataViewFromFile("fileLookup.plist");
+        if (view.getSize() != data.getSize() || memcmp(view.getBytes(), data.getBytes(), data.getSize()) != 0)
+            return std::string("failed: the view differs from getDataFromFile()");
+
+        // the slices share the buffer of the file
+        DataView head = view.slice(0, 5);
+        DataView tail = view.slice(5);
+        if (head.getBytes() != view.getBytes() || head.getSize() != 5 || tail.getSize() != view.getSize() - 5 || view.getUseCount() != 3)
+            return std::string("failed: slice");
+        if (!view.slice(view.getSize()).isNull() || view.slice(2, 1000000).getSize() != view.getSize() - 2)
+            return std::string("failed: slice out of the view");
+        if (head.copyString() != std::string((const char*)data.getBytes(), 5))
+            return std::string("failed: copyString");
+
+        std::vector<char> bytes = { 'a', 'b', 'c' };
+        const char* buffer = bytes.data();
+        DataView vectorView(std::move(bytes));
+        if ((const char*)vectorView.getBytes() != buffer || vectorView.getSize() != 3)
+            return std::string("failed: the vector was copied");
+
+        if (!fs->getDataViewFromFile("missing-file.plist").isNull())
+            return std::string("failed: the view of a missing file isn't null");
+
+        return std::string("success: the views share the bytes");
+    };
+
+    label->setString(runTests());
+}
+
+std::string TestDataView::title() const
+{
+    return "FileUtils: getDataViewFromFile()";
+}
+
+std::string TestDataView::subtitle() const
+{
+    return "The slices of a file share its buffer";
+}
+
+// TestAsyncOperation
+
+void TestAsyncOperation::onEnter()
+{
+    FileUtilsDemo::onEnter();
+    auto winSize = Director::getInstance()->getWinSize();
+
+    auto label = Label::createWithTTF("reading...", "fonts/Thonburi.ttf", 18);
+    label->setPosition(winSize.width / 2, winSize.height / 2);
+    addChild(label);
+
+    // both files are read at once, the sizes are added on the reading thread, then the texture is loaded
+    auto fileUtils = FileUtils::getInstance();
+    std::vector<AsyncOperation<Data>> reads = {
+        fileUtils->getDataFromFileAsync("Images/grossini.png"),
+        fileUtils->getDataFromFileAsync("Images/background.png")
+    };
+    whenAll(reads).then(AsyncExecutor::CURRENT, [](const std::vector<Data>& results) {
+        ssize_t size = 0;
+        for (auto& data : results)
+        {
+            size += data.getSize();
+        }
+        return size;
+    }).then([](const ssize_t& size) {
+        CCASSERT(std::this_thread::get_id() == Director::getInstance()->getCocos2dThreadId(), "should run on the cocos thread");
+        return Director::getInstance()->getTextureCache()->addImageAsync("Images/grossini.png").then(AsyncExecutor::CURRENT, [size](Texture2D* texture) {
+            return StringUtils::format("%d bytes read, texture %s", (int)size, texture ? "loaded" : "missing");
+        });
+    }).then([label](const std::string& text) {
+        label->setString(text);
+    });
+}
+
+std::string TestAsyncOperation::title() const
+{
+    return "AsyncOperation";
+}
+
+std::string TestAsyncOperation::subtitle() const
+{
+    return "Reads two files, then loads a texture, without nested callbacks";
+}
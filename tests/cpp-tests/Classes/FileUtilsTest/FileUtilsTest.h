@@ -234,4 +234,70 @@ public:
     virtual std::string subtitle() const override;
 };
 
+class TestAssetPack : public FileUtilsDemo
+{
+public:
+    CREATE_FUNC(TestAssetPack);
+    
+    virtual void onEnter() override;
+    virtual void onExit() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+private:
+    std::vector<std::string> _defaultSearchPathArray;
+};
+
+class TestPathCache : public FileUtilsDemo
+{
+public:
+    CREATE_FUNC(TestPathCache);
+    
+    virtual void onEnter() override;
+    virtual void onExit() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+private:
+    std::vector<std::string> _defaultSearchPathArray;
+};
+
+class TestFileStream : public FileUtilsDemo
+{
+public:
+    CREATE_FUNC(TestFileStream);
+    
+    virtual void onEnter() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+};
+
+class TestGetDataFromFiles : public FileUtilsDemo
+{
+public:
+    CREATE_FUNC(TestGetDataFromFiles);
+    
+    virtual void onEnter() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+};
+
+class TestDataView : public FileUtilsDemo
+{
+public:
+    CREATE_FUNC(TestDataView);
+
+    virtual void onEnter() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+};
+
+class TestAsyncOperation : public FileUtilsDemo
+{
+public:
+    CREATE_FUNC(TestAsyncOperation);
+
+    virtual void onEnter() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+};
+
 #endif /* __FILEUTILSTEST_H__ */
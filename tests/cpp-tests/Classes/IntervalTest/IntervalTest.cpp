@@ -12,6 +12,7 @@ USING_NS_CC;
 IntervalTests::IntervalTests()
 {
     ADD_TEST_CASE(IntervalTest);
+    ADD_TEST_CASE(FramePacingTest);
 }
 
 IntervalTest::IntervalTest()
@@ -116,3 +117,86 @@ void IntervalTest::update(float dt)
     sprintf(time, "%2.1f", _time0);
     _label0->setString(time);
 }
+
+//------------------------------------------------------------------
+//
+// FramePacingTest
+//
+//------------------------------------------------------------------
+
+FramePacingTest::FramePacingTest()
+: _statusLabel(nullptr)
+, _thermalListener(nullptr)
+, _thermalChanges(0)
+{
+    auto s = Director::getInstance()->getWinSize();
+
+    _statusLabel = Label::createWithTTF("", "fonts/arial.ttf", 14);
+    _statusLabel->setPosition(s.width / 2, s.height / 2);
+    addChild(_statusLabel);
+
+    auto thermalItem = MenuItemFont::create("Next thermal state", [](Ref* sender) {
+        auto director = Director::getInstance();
+        int state = ((int)director->getThermalState() + 1) % ((int)Director::ThermalState::CRITICAL + 1);
+        director->setThermalState((Director::ThermalState)state);
+    });
+    auto smoothingItem = MenuItemFont::create("Toggle delta time smoothing", [](Ref* sender) {
+        auto director = Director::getInstance();
+        director->setDeltaTimeSmoothingEnabled(!director->isDeltaTimeSmoothingEnabled());
+    });
+    auto menu = Menu::create(thermalItem, smoothingItem, nullptr);
+    menu->alignItemsVertically();
+    menu->setPosition(s.width / 2, s.height / 4);
+    addChild(menu);
+
+    scheduleUpdate();
+}
+
+void FramePacingTest::onEnter()
+{
+    TestCase::onEnter();
+
+    auto director = Director::getInstance();
+    // 10 fps after 2 seconds without touches
+    director->setIdleAnimationInterval(1 / 10.0f, 2.0f);
+    director->setDeltaTimeSmoothingEnabled(true);
+
+    _thermalListener = director->getEventDispatcher()->addCustomEventListener(Director::EVENT_THERMAL_STATE_CHANGED, [this](EventCustom* event) {
+        CCASSERT(*static_cast<Director::ThermalState*>(event->getUserData()) == Director::getInstance()->getThermalState(), "the event has the new state");
+        ++_thermalChanges;
+    });
+}
+
+void FramePacingTest::onExit()
+{
+    auto director = Director::getInstance();
+    director->getEventDispatcher()->removeEventListener(_thermalListener);
+    director->setIdleAnimationInterval(0);
+    director->setDeltaTimeSmoothingEnabled(false);
+    director->setThermalState(Director::ThermalState::NOMINAL);
+
+    TestCase::onExit();
+}
+
+void FramePacingTest::update(float dt)
+{
+    static const char* thermalStates[] = { "NOMINAL", "FAIR", "SERIOUS", "CRITICAL" };
+    auto director = Director::getInstance();
+
+    char status[256] = {0};
+    sprintf(status, "dt: %.4f  smoothing: %s\neffective interval: %.4f  idle: %s\nthermal state: %s (%d changes)",
+            dt, director->isDeltaTimeSmoothingEnabled() ? "on" : "off",
+            director->getEffectiveAnimationInterval(), director->isIdle() ? "yes" : "no",
+            thermalStates[(int)director->getThermalState()], _thermalChanges);
+    _statusLabel->setString(status);
+}
+
+std::string FramePacingTest::title() const
+{
+    return "Frame pacing";
+}
+
+std::string FramePacingTest::subtitle() const
+{
+    return "Tap nothing for 2 seconds: the frame rate drops to 10 fps";
+}
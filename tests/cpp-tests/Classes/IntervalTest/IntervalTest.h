@@ -26,4 +26,22 @@ protected:
     float        _time0, _time1, _time2, _time3, _time4;
 };
 
+class FramePacingTest : public TestCase
+{
+public:
+    CREATE_FUNC(FramePacingTest);
+    FramePacingTest();
+
+    virtual void onEnter() override;
+    virtual void onExit() override;
+    virtual void update(float dt) override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+
+protected:
+    cocos2d::Label* _statusLabel;
+    cocos2d::EventListenerCustom* _thermalListener;
+    int _thermalChanges;
+};
+
 #endif
@@ -114,6 +114,10 @@ NewLabelTests::NewLabelTests()
     ADD_TEST_CASE(LabelIssue16717);
     ADD_TEST_CASE(LabelIssueLineGap);
     ADD_TEST_CASE(LabelIssue17902);
+    ADD_TEST_CASE(LabelTTFAsyncRasterization);
+    ADD_TEST_CASE(LabelTTFPageLimit);
+    ADD_TEST_CASE(LabelBatchNodeTest);
+    ADD_TEST_CASE(LabelSystemFontTextureCache);
 };
 
 LabelFNTColorAndOpacity::LabelFNTColorAndOpacity()
@@ -3428,4 +3432,217 @@ std::string LabelIssue17902::subtitle() const
     return "";
 }
 
+//
+// LabelTTFAsyncRasterization
+//
+LabelTTFAsyncRasterization::LabelTTFAsyncRasterization()
+{
+    auto center = VisibleRect::center();
+
+    // a size no other test uses, for the atlas to be created with the async rasterization
+    FontAtlasCache::setAsyncRasterizationEnabled(true);
+    _label = Label::createWithTTF("", "fonts/HKYuanMini.ttf", 27);
+    FontAtlasCache::setAsyncRasterizationEnabled(false);
+
+    _label->setDimensions(VisibleRect::getVisibleRect().size.width - 40, 0);
+    _label->setPosition(center);
+    addChild(_label);
+
+    _statusLabel = Label::createWithTTF("", "fonts/arial.ttf", 14);
+    _statusLabel->setPosition(center.x, VisibleRect::bottom().y + 30);
+    addChild(_statusLabel);
+
+    schedule(CC_CALLBACK_1(LabelTTFAsyncRasterization::step, this), 0.05f, "step_key");
+}
+
+void LabelTTFAsyncRasterization::onExit()
+{
+    FontAtlasCache::unloadFontAtlasTTF("fonts/HKYuanMini.ttf");
+    AtlasDemoNew::onExit();
+}
+
+void LabelTTFAsyncRasterization::step(float /*dt*/)
+{
+    if (_text.size() >= 120)
+    {
+        _text.clear();
+    }
+    // CJK ideographs, most of them not rasterized yet
+    _text.push_back(0x4E00 + RandomHelper::random_int(0, 0x51FF));
+
+    std::string utf8;
+    StringUtils::UTF32ToUTF8(_text, utf8);
+    _label->setString(utf8);
+
+    auto atlas = _label->getFontAtlas();
+    _statusLabel->setString(StringUtils::format("pending glyphs: %s", atlas && atlas->hasPendingGlyphs() ? "yes" : "no"));
+}
+
+std::string LabelTTFAsyncRasterization::title() const
+{
+    return "Asynchronous glyph rasterization";
+}
+
+std::string LabelTTFAsyncRasterization::subtitle() const
+{
+    return "The new glyphs appear once rasterized in the background";
+}
+
+//
+// LabelTTFPageLimit
+//
+LabelTTFPageLimit::LabelTTFPageLimit()
+{
+    auto center = VisibleRect::center();
+
+    // a size no other test uses, for the atlas to be created with the limit
+    FontAtlasCache::setMaxPageCount(2);
+    _label = Label::createWithTTF("", "fonts/HKYuanMini.ttf", 61);
+    FontAtlasCache::setMaxPageCount(0);
+
+    _label->setDimensions(VisibleRect::getVisibleRect().size.width - 40, 0);
+    _label->setPosition(center);
+    addChild(_label);
+
+    _statusLabel = Label::createWithTTF("", "fonts/arial.ttf", 14);
+    _statusLabel->setPosition(center.x, VisibleRect::bottom().y + 30);
+    addChild(_statusLabel);
+
+    schedule(CC_CALLBACK_1(LabelTTFPageLimit::step, this), 0.2f, "step_key");
+}
+
+void LabelTTFPageLimit::onExit()
+{
+    FontAtlasCache::unloadFontAtlasTTF("fonts/HKYuanMini.ttf");
+    AtlasDemoNew::onExit();
+}
+
+void LabelTTFPageLimit::step(float /*dt*/)
+{
+    // new CJK ideographs every time, which fill a page every few steps
+    std::u32string text;
+    for (int i = 0; i < 12; ++i)
+    {
+        text.push_back(0x4E00 + RandomHelper::random_int(0, 0x51FF));
+    }
+
+    std::string utf8;
+    StringUtils::UTF32ToUTF8(text, utf8);
+    _label->setString(utf8);
+
+    auto atlas = _label->getFontAtlas();
+    _statusLabel->setString(StringUtils::format("atlas pages: %d", atlas ? (int)atlas->getTextures().size() : 0));
+}
+
+std::string LabelTTFPageLimit::title() const
+{
+    return "Limited font atlas pages";
+}
 
+std::string LabelTTFPageLimit::subtitle() const
+{
+    return "The atlas stays at 2 pages, the pages used least recently are reused";
+}
+
+//
+// LabelBatchNodeTest
+//
+static const int kTagDamageNumber = 1;
+
+LabelBatchNodeTest::LabelBatchNodeTest()
+{
+    auto size = VisibleRect::getVisibleRect().size;
+
+    _batch = LabelBatchNode::create();
+    addChild(_batch);
+
+    // damage numbers: outline and shadow, a few drawn with the normal effect
+    TTFConfig ttfConfig("fonts/arial.ttf", 18);
+    for (int i = 0; i < 300; ++i)
+    {
+        auto label = Label::createWithTTF(ttfConfig, StringUtils::format("%d", RandomHelper::random_int(1, 9999)));
+        label->setPosition(VisibleRect::left().x + RandomHelper::random_real(0.0f, size.width),
+            VisibleRect::bottom().y + RandomHelper::random_real(0.0f, size.height));
+        label->setTextColor(Color4B(255, RandomHelper::random_int(0, 255), 0, 255));
+        if (i % 4 != 0)
+        {
+            label->enableOutline(Color4B::BLACK, 1);
+        }
+        label->enableShadow(Color4B(0, 0, 0, 128), Size(2, -2));
+        _batch->addChild(label, 0, kTagDamageNumber);
+    }
+
+    auto bmfont = Label::createWithBMFont("fonts/bitmapFontTest3.fnt", "BMFont in the batch");
+    bmfont->setPosition(VisibleRect::center());
+    _batch->addChild(bmfont);
+
+    schedule(CC_CALLBACK_1(LabelBatchNodeTest::step, this), "step_key");
+}
+
+void LabelBatchNodeTest::step(float dt)
+{
+    auto visibleRect = VisibleRect::getVisibleRect();
+    for (auto&& child : _batch->getChildren())
+    {
+        if (child->getTag() != kTagDamageNumber)
+        {
+            continue;
+        }
+        auto label = static_cast<Label*>(child);
+
+        label->setPositionY(label->getPositionY() + 40 * dt);
+        if (label->getPositionY() > visibleRect.getMaxY())
+        {
+            label->setPositionY(visibleRect.getMinY());
+            label->setString(StringUtils::format("%d", RandomHelper::random_int(1, 9999)));
+        }
+    }
+}
+
+std::string LabelBatchNodeTest::title() const
+{
+    return "LabelBatchNode";
+}
+
+std::string LabelBatchNodeTest::subtitle() const
+{
+    return "300 labels with outline and shadow in a few draw calls";
+}
+
+LabelSystemFontTextureCache::LabelSystemFontTextureCache()
+{
+    auto size = VisibleRect::getVisibleRect().size;
+    const char* buttons[] = { "Play", "Options", "Quit" };
+
+    // the left column is rendered on the cocos thread, the right one on a worker, all of them share 3 textures
+    for (int i = 0; i < 30; ++i)
+    {
+        auto label = Label::createWithSystemFont(buttons[i % 3], "Arial", 20);
+        label->setSystemFontAsyncRendering(i >= 15);
+        label->setPosition(VisibleRect::left().x + size.width * (i < 15 ? 0.3f : 0.7f),
+            VisibleRect::top().y - 60 - (i % 15) * 20);
+        addChild(label);
+    }
+
+    _statusLabel = Label::createWithTTF("", "fonts/arial.ttf", 16);
+    _statusLabel->setPosition(VisibleRect::center().x, VisibleRect::bottom().y + 30);
+    addChild(_statusLabel);
+
+    schedule(CC_CALLBACK_1(LabelSystemFontTextureCache::step, this), "step_key");
+}
+
+void LabelSystemFontTextureCache::step(float dt)
+{
+    auto textureCache = Director::getInstance()->getTextureCache();
+    _statusLabel->setString(StringUtils::format("%d text textures cached", (int)textureCache->getTextTextureCount()));
+}
+
+std::string LabelSystemFontTextureCache::title() const
+{
+    return "System font texture cache";
+}
+
+std::string LabelSystemFontTextureCache::subtitle() const
+{
+    return "30 labels showing 3 strings, the right ones rendered asynchronously";
+}
@@ -929,4 +929,73 @@ public:
     virtual std::string subtitle() const override;
 };
 
+class LabelTTFAsyncRasterization : public AtlasDemoNew
+{
+public:
+    CREATE_FUNC(LabelTTFAsyncRasterization);
+
+    LabelTTFAsyncRasterization();
+
+    virtual void onExit() override;
+    void step(float dt);
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+
+private:
+    cocos2d::Label* _label;
+    cocos2d::Label* _statusLabel;
+    std::u32string _text;
+};
+
+class LabelTTFPageLimit : public AtlasDemoNew
+{
+public:
+    CREATE_FUNC(LabelTTFPageLimit);
+
+    LabelTTFPageLimit();
+
+    virtual void onExit() override;
+    void step(float dt);
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+
+private:
+    cocos2d::Label* _label;
+    cocos2d::Label* _statusLabel;
+};
+
+class LabelBatchNodeTest : public AtlasDemoNew
+{
+public:
+    CREATE_FUNC(LabelBatchNodeTest);
+
+    LabelBatchNodeTest();
+
+    void step(float dt);
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+
+private:
+    cocos2d::LabelBatchNode* _batch;
+};
+
+class LabelSystemFontTextureCache : public AtlasDemoNew
+{
+public:
+    CREATE_FUNC(LabelSystemFontTextureCache);
+
+    LabelSystemFontTextureCache();
+
+    void step(float dt);
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+
+private:
+    cocos2d::Label* _statusLabel;
+};
+
 #endif
@@ -5,6 +5,7 @@ USING_NS_CC;
 LightTests::LightTests()
 {
     ADD_TEST_CASE(LightTest);
+    ADD_TEST_CASE(LightGridTest);
 }
 
 LightTest::LightTest()
@@ -280,3 +281,45 @@ void LightTest::SwitchLight( Ref* sender, LightType lightType )
         break;
     }
 }
+
+LightGridTest::LightGridTest()
+{
+    auto s = Director::getInstance()->getWinSize();
+    auto camera = Camera::createPerspective(60, (GLfloat)s.width/s.height, 1.0f, 1000.0f);
+    camera->setCameraFlag(CameraFlag::USER1);
+    camera->setPosition3D(Vec3(0.0, 150, 150));
+    camera->lookAt(Vec3(0.0, 0.0, 0.0), Vec3(0.0, 1.0, 0.0));
+    addChild(camera);
+
+    addChild(AmbientLight::create(Color3B(40, 40, 40)));
+
+    // 100 spheres under 100 point lights, each sphere is lit by the few lights around it
+    for (int z = 0; z < 10; ++z)
+    {
+        for (int x = 0; x < 10; ++x)
+        {
+            auto sprite = Sprite3D::create("Sprite3DTest/sphere.c3b");
+            sprite->setPosition3D(Vec3((x - 4.5f) * 20, 0, (z - 4.5f) * 20));
+            sprite->setCameraMask(2);
+            addChild(sprite);
+
+            auto light = PointLight::create(Vec3::ZERO, Color3B(RandomHelper::random_int(64, 255), RandomHelper::random_int(64, 255), RandomHelper::random_int(64, 255)), 25);
+            auto orbit = Node::create();
+            orbit->setPosition3D(sprite->getPosition3D());
+            orbit->addChild(light);
+            light->setPosition3D(Vec3(12, 8, 0));
+            orbit->runAction(RepeatForever::create(RotateBy::create(RandomHelper::random_real(2.0f, 4.0f), Vec3(0, 360, 0))));
+            addChild(orbit);
+        }
+    }
+}
+
+std::string LightGridTest::title() const
+{
+    return "Light Grid";
+}
+
+std::string LightGridTest::subtitle() const
+{
+    return "100 point lights, the meshes only use the lights reaching them";
+}
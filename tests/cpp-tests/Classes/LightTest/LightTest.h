@@ -60,5 +60,15 @@ private:
     cocos2d::Label* _spotLightLabel;
 };
 
+class LightGridTest : public TestCase
+{
+public:
+    CREATE_FUNC(LightGridTest);
+    LightGridTest();
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+};
+
 #endif
 
@@ -49,7 +49,10 @@ MaterialSystemTest::MaterialSystemTest()
     ADD_TEST_CASE(Material_Sprite3DTest);
     ADD_TEST_CASE(Material_parsePerformance);
     ADD_TEST_CASE(Material_invalidate);
+    ADD_TEST_CASE(Material_invalidateStateCache);
     ADD_TEST_CASE(Material_renderState);
+    ADD_TEST_CASE(Material_warmUp);
+    ADD_TEST_CASE(Material_binaryFile);
 }
 
 std::string MaterialSystemBaseTest::title() const
@@ -514,6 +517,79 @@ void Material_invalidate::draw(cocos2d::Renderer *renderer, const cocos2d::Mat4
     renderer->addCommand(&_customCommand);
 }
 
+//
+//
+//
+void Material_invalidateStateCache::onEnter()
+{
+    MaterialSystemBaseTest::onEnter();
+
+    auto sprite = Sprite3D::create("Sprite3DTest/orc.c3b");
+    sprite->setScale(5);
+    sprite->setRotation3D(Vec3(0,180,0));
+    addChild(sprite);
+    sprite->setPositionNormalized(Vec2(0.5f,0.3f));
+    sprite->runAction(RepeatForever::create(RotateBy::create(5, Vec3(0,360,0))));
+}
+
+std::string Material_invalidateStateCache::subtitle() const
+{
+    return "The GL state cache matches GL after StateBlock::invalidate()";
+}
+
+void Material_invalidateStateCache::draw(cocos2d::Renderer *renderer, const cocos2d::Mat4 &transform, uint32_t flags)
+{
+    _customCommand.init(_globalZOrder, transform, flags);
+    _customCommand.func = []() {
+        // change the states behind the cache, the way third party renderers do
+        glDisable(GL_DEPTH_TEST);
+        glDepthMask(GL_FALSE);
+        glDepthFunc(GL_ALWAYS);
+        glEnable(GL_CULL_FACE);
+        glCullFace(GL_FRONT);
+        glFrontFace(GL_CW);
+        glEnable(GL_BLEND);
+        glEnable(GL_STENCIL_TEST);
+        CHECK_GL_ERROR_DEBUG();
+
+        RenderState::StateBlock::invalidate(RenderState::StateBlock::RS_ALL_ONES);
+
+        const GLenum capabilities[] = { GL_BLEND, GL_DEPTH_TEST, GL_CULL_FACE, GL_STENCIL_TEST, GL_SCISSOR_TEST };
+        for (auto capability : capabilities)
+        {
+            CCASSERT(GL::isEnabled(capability) == (glIsEnabled(capability) == GL_TRUE), "capability out of sync");
+        }
+
+        GLboolean depthMask = GL_FALSE;
+        glGetBooleanv(GL_DEPTH_WRITEMASK, &depthMask);
+        CCASSERT(GL::getDepthMask() == depthMask, "depth mask out of sync");
+
+        GLint depthFunc = 0;
+        glGetIntegerv(GL_DEPTH_FUNC, &depthFunc);
+        CCASSERT(GL::getDepthFunc() == (GLenum)depthFunc, "depth function out of sync");
+
+        GLint stencilFunc = 0, stencilRef = 0, stencilMask = 0;
+        glGetIntegerv(GL_STENCIL_FUNC, &stencilFunc);
+        glGetIntegerv(GL_STENCIL_REF, &stencilRef);
+        glGetIntegerv(GL_STENCIL_VALUE_MASK, &stencilMask);
+        GLenum cachedFunc;
+        GLint cachedRef;
+        GLuint cachedMask;
+        GL::getStencilFunc(&cachedFunc, &cachedRef, &cachedMask);
+        CCASSERT(cachedFunc == (GLenum)stencilFunc && cachedRef == stencilRef && cachedMask == (GLuint)stencilMask, "stencil function out of sync");
+        CC_UNUSED_PARAM(cachedFunc);
+        CC_UNUSED_PARAM(cachedRef);
+        CC_UNUSED_PARAM(cachedMask);
+
+        // the states the default state block doesn't restore stay the ones GL has
+        glDisable(GL_STENCIL_TEST);
+        GL::invalidateRenderStateCache();
+        CCASSERT(!GL::isEnabled(GL_STENCIL_TEST), "stencil test out of sync");
+    };
+
+    renderer->addCommand(&_customCommand);
+}
+
 //
 //
 //
@@ -570,6 +646,107 @@ void Material_renderState::draw(cocos2d::Renderer *renderer, const cocos2d::Mat4
     renderer->addCommand(&_customCommand);
 }
 
+//
+// MARK: Material_warmUp
+//
+void Material_warmUp::onEnter()
+{
+    MaterialSystemBaseTest::onEnter();
+
+    std::vector<ShaderVariant> variants;
+    Material::getShaderVariants("Materials/shader_variants.material", &variants);
+
+    auto label = Label::createWithSystemFont(StringUtils::format("Compiling %d shader variants", (int)variants.size()), "Helvetica", 12);
+    label->setPositionNormalized(Vec2(0.5f, 0.2f));
+    addChild(label);
+
+    auto queue = TimeSlicedQueue::getInstance();
+    _warmUpTask = Material::warmUp({"Materials/shader_variants.material"}, [this, label](bool done) {
+        if (!done)
+            return;
+
+        // the programs are in the cache, creating the material doesn't compile them
+        label->setString("Shader variants compiled");
+
+        auto sprite = Sprite3D::create("Sprite3DTest/boss1.obj");
+        sprite->setScale(6);
+        sprite->setMaterial(Material::createWithFilename("Materials/shader_variants.material"));
+        sprite->setPositionNormalized(Vec2(0.5f, 0.5f));
+        addChild(sprite);
+
+        addChild(DirectionLight::create(Vec3(-1, 1, 0), Color3B::GREEN));
+    });
+    queue->setProgressCallback(_warmUpTask, [label](float progress) {
+        label->setString(StringUtils::format("Compiling shader variants: %d%%", (int)(progress * 100)));
+    });
+}
+
+void Material_warmUp::onExit()
+{
+    TimeSlicedQueue::getInstance()->cancel(_warmUpTask);
+    MaterialSystemBaseTest::onExit();
+}
+
+std::string Material_warmUp::subtitle() const
+{
+    return "Shader variants compiled across frames";
+}
+
+//
+//
+//
+void Material_binaryFile::onEnter()
+{
+    MaterialSystemBaseTest::onEnter();
+
+    // the binary copy is read without tokenizing, like a material compiled at build time
+    auto binaryPath = FileUtils::getInstance()->getWritablePath() + "2d_effects.material.bin";
+    auto properties = Properties::createNonRefCounted("Materials/2d_effects.material");
+    bool written = properties->writeBinaryFile(binaryPath);
+    CC_SAFE_DELETE(properties);
+    Properties::purgeCache();
+
+    std::string result = "Failed to write the binary file";
+    if (written)
+    {
+        std::clock_t begin = std::clock();
+        Material* text = Material::createWithFilename("Materials/2d_effects.material");
+        double textSecs = double(std::clock() - begin) / CLOCKS_PER_SEC;
+        begin = std::clock();
+        Material* binary = Material::createWithFilename(binaryPath);
+        double binarySecs = double(std::clock() - begin) / CLOCKS_PER_SEC;
+        begin = std::clock();
+        Material::createWithFilename("Materials/2d_effects.material");
+        double cachedSecs = double(std::clock() - begin) / CLOCKS_PER_SEC;
+
+        if (text && binary)
+        {
+            const char* techniques[] = { "blur", "outline", "noise", "edge_detect" };
+            for (int i = 0; i < 4; ++i)
+            {
+                auto sprite = Sprite::create("Images/grossini.png");
+                sprite->setPositionNormalized(Vec2(0.2f * (i + 1), 0.5f));
+                sprite->setGLProgramState(binary->getTechniqueByName(techniques[i])->getPassByIndex(0)->getGLProgramState());
+                this->addChild(sprite);
+            }
+            result = StringUtils::format("text: %.4fs, binary: %.4fs, cached: %.4fs", textSecs, binarySecs, cachedSecs);
+        }
+        else
+        {
+            result = "Failed to read the binary file";
+        }
+    }
+
+    auto label = Label::createWithSystemFont(result, "Helvetica", 10);
+    label->setPositionNormalized(Vec2(0.5f, 0.2f));
+    addChild(label);
+}
+
+std::string Material_binaryFile::subtitle() const
+{
+    return "Effects read from a binary material";
+}
+
 // MARK: Helper functions
 
 static void printProperties(Properties* properties, int indent)
@@ -126,6 +126,19 @@ public:
     cocos2d::CustomCommand _customCommand;
 };
 
+class Material_invalidateStateCache : public MaterialSystemBaseTest
+{
+public:
+    CREATE_FUNC(Material_invalidateStateCache);
+
+    virtual void onEnter() override;
+    virtual std::string subtitle() const override;
+
+    virtual void draw(cocos2d::Renderer *renderer, const cocos2d::Mat4 &transform, uint32_t flags) override;
+
+    cocos2d::CustomCommand _customCommand;
+};
+
 class Material_renderState : public MaterialSystemBaseTest
 {
 public:
@@ -140,4 +153,26 @@ public:
     cocos2d::CustomCommand _customCommand;
 };
 
+class Material_warmUp : public MaterialSystemBaseTest
+{
+public:
+    CREATE_FUNC(Material_warmUp);
+
+    virtual void onEnter() override;
+    virtual void onExit() override;
+    virtual std::string subtitle() const override;
+
+protected:
+    cocos2d::TimeSlicedQueue::TaskId _warmUpTask;
+};
+
+class Material_binaryFile : public MaterialSystemBaseTest
+{
+public:
+    CREATE_FUNC(Material_binaryFile);
+
+    virtual void onEnter() override;
+    virtual std::string subtitle() const override;
+};
+
 
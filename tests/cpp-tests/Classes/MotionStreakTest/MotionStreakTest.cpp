@@ -15,6 +15,7 @@ MotionStreakTests::MotionStreakTests()
     ADD_TEST_CASE(MotionStreakTest2);
     ADD_TEST_CASE(Issue1358);
     ADD_TEST_CASE(Issue12226);
+    ADD_TEST_CASE(MotionStreakBatchTest);
 }
 
 //------------------------------------------------------------------
@@ -207,6 +208,53 @@ std::string Issue12226::subtitle() const
     return "Image should look without artifacts";
 }
 
+//------------------------------------------------------------------
+//
+// MotionStreakBatchTest
+//
+//------------------------------------------------------------------
+
+void MotionStreakBatchTest::onEnter()
+{
+    MotionStreakTest::onEnter();
+
+    // the streaks share the texture, they are drawn in a few draw calls
+    for (int i = 0; i < 500; ++i)
+    {
+        auto streak = MotionStreak::create(0.5f, 3, 8, Color3B(128 + rand() % 128, 128 + rand() % 128, 128 + rand() % 128), s_streak);
+        addChild(streak);
+        _streaks.pushBack(streak);
+    }
+    _streak = _streaks.front();
+    _angle = 0.0f;
+
+    scheduleUpdate();
+}
+
+void MotionStreakBatchTest::update(float dt)
+{
+    auto size = Director::getInstance()->getWinSize();
+
+    _angle += dt * 90.0f;
+    for (ssize_t i = 0; i < _streaks.size(); ++i)
+    {
+        // a pattern of spirals going out of the center
+        float angle = CC_DEGREES_TO_RADIANS(_angle + i * 360.0f / 50);
+        float radius = (i % 10 + 1) * size.height / 22;
+        _streaks.at(i)->setPosition(Vec2(size.width / 2 + cosf(angle) * radius, size.height / 2 + sinf(angle) * radius));
+    }
+}
+
+std::string MotionStreakBatchTest::title() const
+{
+    return "Streak Batch";
+}
+
+std::string MotionStreakBatchTest::subtitle() const
+{
+    return "500 streaks with the same texture, see the draw calls";
+}
+
 //------------------------------------------------------------------
 //
 // MotionStreakTest
@@ -72,5 +72,19 @@ public:
     virtual void onEnter() override;
 };
 
+class MotionStreakBatchTest : public MotionStreakTest
+{
+public:
+    CREATE_FUNC(MotionStreakBatchTest);
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual void onEnter() override;
+    virtual void update(float dt) override;
+
+    cocos2d::Vector<cocos2d::MotionStreak*> _streaks;
+    float _angle;
+};
+
 
 #endif
@@ -44,6 +44,8 @@ NavMeshTests::NavMeshTests()
 #else
     ADD_TEST_CASE(NavMeshBasicTestDemo);
     ADD_TEST_CASE(NavMeshAdvanceTestDemo);
+    ADD_TEST_CASE(NavMeshAsyncTestDemo);
+    ADD_TEST_CASE(NavMeshStreamingTestDemo);
 #endif
 };
 
@@ -433,4 +435,109 @@ void NavMeshAdvanceTestDemo::touchesEnded(const std::vector<cocos2d::Touch*>& to
     }
 }
 
+bool NavMeshAsyncTestDemo::init()
+{
+    if (!NavMeshBaseTestDemo::init()) return false;
+
+    TTFConfig ttfConfig("fonts/arial.ttf", 15);
+    _pathLabel = Label::createWithTTF(ttfConfig, "Touch to request a path");
+    _pathLabel->setAnchorPoint(Vec2::ANCHOR_TOP_LEFT);
+    _pathLabel->setPosition(Vec2(VisibleRect::left().x, VisibleRect::top().y - 50));
+    addChild(_pathLabel);
+    _requestFrame = 0;
+
+    return true;
+}
+
+void NavMeshAsyncTestDemo::onEnter()
+{
+    NavMeshBaseTestDemo::onEnter();
+
+    getNavMesh()->setAsyncCrowdUpdate(true);
+    getNavMesh()->setPathQueryBudget(32);
+
+    for (int i = 0; i < 32; ++i){
+        float x = cocos2d::random(-50.0f, 50.0f);
+        float z = cocos2d::random(-50.0f, 50.0f);
+        Physics3DWorld::HitResult result;
+        getPhysics3DWorld()->rayCast(Vec3(x, 50.0f, z), Vec3(x, -50.0f, z), &result);
+        createAgent(result.hitPosition);
+    }
+}
+
+std::string NavMeshAsyncTestDemo::title() const
+{
+    return "Navigation Mesh Test";
+}
+
+std::string NavMeshAsyncTestDemo::subtitle() const
+{
+    return "Async Crowd Update And Sliced Path Requests";
+}
+
+void NavMeshAsyncTestDemo::touchesEnded(const std::vector<cocos2d::Touch*>& touches, cocos2d::Event *event)
+{
+    if (!_needMoveAgents) return;
+    if (!touches.empty() && !_agents.empty()){
+        auto touch = touches[0];
+        auto location = touch->getLocationInView();
+        Vec3 nearP(location.x, location.y, 0.0f), farP(location.x, location.y, 1.0f);
+
+        auto size = Director::getInstance()->getWinSize();
+        _camera->unproject(size, &nearP, &nearP);
+        _camera->unproject(size, &farP, &farP);
+
+        Physics3DWorld::HitResult result;
+        getPhysics3DWorld()->rayCast(nearP, farP, &result);
+
+        auto des = result.hitPosition;
+        auto start = _agents[0].first->getOwner()->getPosition3D();
+        _requestFrame = Director::getInstance()->getTotalFrames();
+        getNavMesh()->requestPath(start, des, [this, des](unsigned int /*requestId*/, const std::vector<Vec3> &pathPoints){
+            unsigned int frames = Director::getInstance()->getTotalFrames() - _requestFrame;
+            _pathLabel->setString(StringUtils::format("%d path points found in %u frames", (int)pathPoints.size(), frames));
+            if (!pathPoints.empty())
+                moveAgents(des);
+        });
+    }
+}
+
+void NavMeshStreamingTestDemo::onEnter()
+{
+    NavMeshBaseTestDemo::onEnter();
+
+    auto navMesh = NavMesh::createWithTileStreaming("NavMesh/all_tiles_tilecache.bin", "NavMesh/geomset.txt");
+    navMesh->setDebugDrawEnable(true);
+    setNavMesh(navMesh);
+    navMesh->streamTiles(Vec3::ZERO, 20.0f);
+}
+
+std::string NavMeshStreamingTestDemo::title() const
+{
+    return "Navigation Mesh Test";
+}
+
+std::string NavMeshStreamingTestDemo::subtitle() const
+{
+    return "Tile Streaming, touch to move the streamed area";
+}
+
+void NavMeshStreamingTestDemo::touchesEnded(const std::vector<cocos2d::Touch*>& touches, cocos2d::Event *event)
+{
+    if (!_needMoveAgents) return;
+    if (!touches.empty()){
+        auto touch = touches[0];
+        auto location = touch->getLocationInView();
+        Vec3 nearP(location.x, location.y, 0.0f), farP(location.x, location.y, 1.0f);
+
+        auto size = Director::getInstance()->getWinSize();
+        _camera->unproject(size, &nearP, &nearP);
+        _camera->unproject(size, &farP, &farP);
+
+        Physics3DWorld::HitResult result;
+        getPhysics3DWorld()->rayCast(nearP, farP, &result);
+        getNavMesh()->streamTiles(result.hitPosition, 20.0f);
+    }
+}
+
 #endif
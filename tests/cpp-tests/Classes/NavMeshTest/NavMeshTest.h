@@ -122,6 +122,43 @@ protected:
     cocos2d::Label *_debugLabel;
 };
 
+class NavMeshAsyncTestDemo : public NavMeshBaseTestDemo
+{
+public:
+    CREATE_FUNC(NavMeshAsyncTestDemo);
+
+    // overrides
+    virtual bool init() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+
+    virtual void onEnter() override;
+
+protected:
+
+    virtual void touchesEnded(const std::vector<cocos2d::Touch*>& touches, cocos2d::Event  *event)override;
+
+protected:
+    cocos2d::Label *_pathLabel;
+    unsigned int _requestFrame;
+};
+
+class NavMeshStreamingTestDemo : public NavMeshBaseTestDemo
+{
+public:
+    CREATE_FUNC(NavMeshStreamingTestDemo);
+
+    // overrides
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+
+    virtual void onEnter() override;
+
+protected:
+
+    virtual void touchesEnded(const std::vector<cocos2d::Touch*>& touches, cocos2d::Event  *event)override;
+};
+
 #endif
 
 #endif
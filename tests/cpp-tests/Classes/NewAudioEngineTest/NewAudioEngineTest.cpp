@@ -49,6 +49,9 @@ AudioEngineTests::AudioEngineTests()
     ADD_TEST_CASE(AudioIssue16938Test);
     ADD_TEST_CASE(AudioPlayInFinishedCB);
     ADD_TEST_CASE(AudioUncacheInFinishedCB);
+    ADD_TEST_CASE(AudioCacheBudgetTest);
+    ADD_TEST_CASE(AudioPreloadBatchTest);
+    ADD_TEST_CASE(AudioOutputStatsTest);
     
     //FIXME: Please keep AudioSwitchStateTest to the last position since this test case doesn't work well on each platforms.
     ADD_TEST_CASE(AudioSwitchStateTest);
@@ -1074,4 +1077,145 @@ std::string AudioUncacheInFinishedCB::subtitle() const
     return "Should not crash";
 }
 
+/////////////////////////////////////////////////////////////////////////
+void AudioCacheBudgetTest::onEnter()
+{
+    AudioEngineTestDemo::onEnter();
+
+    AudioEngine::uncacheAll();
+    AudioEngine::setCacheBudget(512 * 1024);
+
+    _statsLabel = Label::createWithTTF("", "fonts/arial.ttf", 16);
+    _statsLabel->setPosition(VisibleRect::center());
+    addChild(_statsLabel);
+
+    _fileIndex = 0;
+    schedule([this](float dt){
+        AudioEngine::play2d(StringUtils::format("audio/SoundEffectsFX009/FX0%d.mp3", 81 + _fileIndex));
+        _fileIndex = (_fileIndex + 1) % 10;
+
+        auto stats = AudioEngine::getCacheStats();
+        _statsLabel->setString(StringUtils::format("cached: %u files, %d / %d bytes\nhits: %u, misses: %u, evictions: %u",
+            stats.cachedFileCount, (int)stats.cachedBytes, (int)stats.budget, stats.hits, stats.misses, stats.evictions));
+    }, 0.5f, "play_effects");
+}
+
+void AudioCacheBudgetTest::onExit()
+{
+    AudioEngine::setCacheBudget(0);
+    AudioEngineTestDemo::onExit();
+}
+
+std::string AudioCacheBudgetTest::title() const
+{
+    return "Decoded audio cache budget";
+}
+
+std::string AudioCacheBudgetTest::subtitle() const
+{
+    return "The cached bytes should stay around the budget";
+}
+
+/////////////////////////////////////////////////////////////////////////
+void AudioPreloadBatchTest::onEnter()
+{
+    AudioEngineTestDemo::onEnter();
+
+    AudioEngine::uncacheAll();
+    _isDestroyed = std::make_shared<bool>(false);
+    auto isDestroyed = _isDestroyed;
+
+    auto bankLabel = Label::createWithTTF("bank: 0 / 10", "fonts/arial.ttf", 20);
+    bankLabel->setPosition(VisibleRect::center() + Vec2(0, 30));
+    addChild(bankLabel);
+
+    auto uiLabel = Label::createWithTTF("ui: loading", "fonts/arial.ttf", 20);
+    uiLabel->setPosition(VisibleRect::center() - Vec2(0, 30));
+    addChild(uiLabel);
+
+    std::vector<std::string> bank;
+    for (int i = 81; i <= 90; ++i)
+    {
+        bank.push_back(StringUtils::format("audio/SoundEffectsFX009/FX0%d.mp3", i));
+    }
+    AudioEngine::preloadBatch(bank, [isDestroyed, bankLabel](int loadedCount, int totalCount){
+        if (*isDestroyed)
+            return;
+        bankLabel->setString(StringUtils::format("bank: %d / %d", loadedCount, totalCount));
+    }, [isDestroyed, bankLabel](bool isSuccess){
+        if (*isDestroyed)
+            return;
+        bankLabel->setString(isSuccess ? "bank: loaded" : "bank: failed");
+    });
+
+    // requested after the bank, it is preloaded before the bank files not started yet
+    AudioEngine::setLowLatency("audio/SmallFile.mp3", true);
+    AudioEngine::preloadBatch({ "audio/SmallFile.mp3" }, nullptr, [isDestroyed, uiLabel](bool isSuccess){
+        if (*isDestroyed)
+            return;
+        uiLabel->setString(isSuccess ? "ui: loaded, low latency" : "ui: failed");
+        AudioEngine::play2d("audio/SmallFile.mp3");
+    }, 1);
+}
 
+void AudioPreloadBatchTest::onExit()
+{
+    *_isDestroyed = true;
+    AudioEngine::setLowLatency("audio/SmallFile.mp3", false);
+    AudioEngineTestDemo::onExit();
+}
+
+std::string AudioPreloadBatchTest::title() const
+{
+    return "Preload a batch of files";
+}
+
+std::string AudioPreloadBatchTest::subtitle() const
+{
+    return "The higher priority ui batch should load before most of the bank";
+}
+
+/////////////////////////////////////////////////////////////////////////
+void AudioOutputStatsTest::onEnter()
+{
+    AudioEngineTestDemo::onEnter();
+
+    AudioEngine::setLowLatency("audio/SmallFile.mp3", true);
+
+    _statsLabel = Label::createWithTTF("", "fonts/arial.ttf", 16);
+    _statsLabel->setPosition(VisibleRect::center());
+    addChild(_statsLabel);
+
+    // a beat, to hear the latency and whether the output underruns
+    schedule([this](float dt){
+        AudioEngine::play2d("audio/SmallFile.mp3");
+
+        auto stats = AudioEngine::getOutputStats();
+        if (stats.output.empty())
+        {
+            _statsLabel->setString("This platform doesn't mix the audio itself");
+            return;
+        }
+
+        float latency = stats.sampleRate > 0 ? stats.bufferSizeInFrames * 1000.0f / stats.sampleRate : 0.0f;
+        _statsLabel->setString(StringUtils::format("%s, %d Hz, burst: %d frames, buffer: %d frames (%.1f ms)\nmixer load: %.2f, peak: %.2f\nunderruns: %u, overloads: %u",
+            stats.output.c_str(), stats.sampleRate, stats.framesPerBurst, stats.bufferSizeInFrames, latency,
+            stats.mixerLoad, stats.mixerPeakLoad, stats.underruns, stats.overloads));
+    }, 0.5f, "beat");
+}
+
+void AudioOutputStatsTest::onExit()
+{
+    AudioEngine::setLowLatency("audio/SmallFile.mp3", false);
+    AudioEngineTestDemo::onExit();
+}
+
+std::string AudioOutputStatsTest::title() const
+{
+    return "Output statistics";
+}
+
+std::string AudioOutputStatsTest::subtitle() const
+{
+    return "AAudio on Android 8.0 and later, OpenSL ES before";
+}
@@ -305,4 +305,50 @@ public:
 private:
 };
 
+class AudioCacheBudgetTest : public AudioEngineTestDemo
+{
+public:
+    CREATE_FUNC(AudioCacheBudgetTest);
+
+    virtual void onEnter() override;
+    virtual void onExit() override;
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+
+private:
+    cocos2d::Label* _statsLabel;
+    int _fileIndex;
+};
+
+class AudioPreloadBatchTest : public AudioEngineTestDemo
+{
+public:
+    CREATE_FUNC(AudioPreloadBatchTest);
+
+    virtual void onEnter() override;
+    virtual void onExit() override;
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+
+private:
+    std::shared_ptr<bool> _isDestroyed;
+};
+
+class AudioOutputStatsTest : public AudioEngineTestDemo
+{
+public:
+    CREATE_FUNC(AudioOutputStatsTest);
+
+    virtual void onEnter() override;
+    virtual void onExit() override;
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+
+private:
+    cocos2d::Label* _statsLabel;
+};
+
 #endif /* defined(__NEWAUDIOENGINE_TEST_H_) */
@@ -34,6 +34,8 @@ EventDispatcherTests::EventDispatcherTests()
     ADD_TEST_CASE(WindowEventsTest);
     ADD_TEST_CASE(Issue8194);
     ADD_TEST_CASE(Issue9898)
+    ADD_TEST_CASE(CustomEventIDTest);
+    ADD_TEST_CASE(TouchHitTestTest);
 }
 
 std::string EventDispatcherTestDemo::title() const
@@ -1663,3 +1665,141 @@ std::string Issue9898::subtitle() const
 {
     return  "Should not crash if dispatch event after remove\n event listener in callback";
 }
+
+// CustomEventIDTest
+
+CustomEventIDTest::CustomEventIDTest()
+{
+    auto origin = Director::getInstance()->getVisibleOrigin();
+    auto size = Director::getInstance()->getVisibleSize();
+
+    auto statusLabel = Label::createWithSystemFont("", "", 20);
+    statusLabel->setPosition(origin + Vec2(size.width/2, size.height/2 - 60));
+    addChild(statusLabel);
+
+    auto node = Node::create();
+    addChild(node);
+
+    int eventID = _eventDispatcher->getCustomEventID("CustomEventIDTest");
+
+    // fixed priority < 0, scene graph priority and fixed priority > 0 are dispatched in that order
+    auto first = EventListenerCustom::create("CustomEventIDTest", [this](EventCustom*) { _order += "a"; });
+    _eventDispatcher->addEventListenerWithFixedPriority(first, -1);
+    auto second = EventListenerCustom::create("CustomEventIDTest", [this](EventCustom*) { _order += "b"; });
+    _eventDispatcher->addEventListenerWithSceneGraphPriority(second, node);
+    auto third = EventListenerCustom::create("CustomEventIDTest", [this](EventCustom*) { _order += "c"; });
+    _eventDispatcher->addEventListenerWithFixedPriority(third, 1);
+    _listeners.pushBack(first);
+    _listeners.pushBack(third);
+
+    auto menuItem = MenuItemFont::create("Dispatch Custom Event by ID", [=](Ref*) {
+        _order.clear();
+        _eventDispatcher->dispatchCustomEvent(eventID);
+        _eventDispatcher->dispatchCustomEvent("CustomEventIDTest");
+        bool passed = _order == "abcabc";
+
+        // the cached listeners have to follow removal and priority changes
+        _order.clear();
+        _eventDispatcher->setPriority(first, 2);
+        _eventDispatcher->dispatchCustomEvent(eventID);
+        passed = passed && _order == "bca";
+        _eventDispatcher->setPriority(first, -1);
+
+        statusLabel->setString(passed ? "Passed" : StringUtils::format("Failed, order: %s", _order.c_str()));
+    });
+    menuItem->setPosition(origin.x + size.width/2, origin.y + size.height/2);
+    auto menu = Menu::create(menuItem, nullptr);
+    menu->setPosition(Vec2::ZERO);
+    addChild(menu);
+}
+
+CustomEventIDTest::~CustomEventIDTest()
+{
+    for (auto& listener : _listeners)
+    {
+        _eventDispatcher->removeEventListener(listener);
+    }
+}
+
+std::string CustomEventIDTest::title() const
+{
+    return "Custom event IDs";
+}
+
+std::string CustomEventIDTest::subtitle() const
+{
+    return "Dispatching by ID should call the listeners in\npriority order and follow priority changes";
+}
+
+// TouchHitTestTest
+
+TouchHitTestTest::TouchHitTestTest()
+: _touchBeganCalls(0)
+{
+    auto origin = Director::getInstance()->getVisibleOrigin();
+    auto size = Director::getInstance()->getVisibleSize();
+
+    auto statusLabel = Label::createWithSystemFont("Touch a sprite", "", 20);
+    statusLabel->setPosition(origin + Vec2(size.width/2, 60));
+    addChild(statusLabel, 1);
+
+    auto onTouchBegan = [this](Touch* touch, Event* event) {
+        ++_touchBeganCalls;
+        auto target = static_cast<Sprite*>(event->getCurrentTarget());
+        Rect rect(Vec2::ZERO, target->getContentSize());
+        if (rect.containsPoint(target->convertToNodeSpace(touch->getLocation())))
+        {
+            target->setColor(Color3B::RED);
+            return true;
+        }
+        return false;
+    };
+    auto onTouchEnded = [this, statusLabel](Touch*, Event* event) {
+        static_cast<Sprite*>(event->getCurrentTarget())->setColor(Color3B::WHITE);
+        statusLabel->setString(StringUtils::format("onTouchBegan calls: %d", _touchBeganCalls));
+        _touchBeganCalls = 0;
+    };
+
+    // only the sprites under the touch, including the moving one, should be asked
+    const int columns = 30;
+    const int rows = 15;
+    for (int y = 0; y < rows; ++y)
+    {
+        for (int x = 0; x < columns; ++x)
+        {
+            auto sprite = Sprite::create("Images/r1.png");
+            sprite->setScale(0.5f);
+            sprite->setPosition(origin + Vec2((x + 0.5f) * size.width / columns, 100 + y * (size.height - 200) / rows));
+            addChild(sprite);
+
+            auto listener = EventListenerTouchOneByOne::create();
+            listener->setSwallowTouches(true);
+            listener->setHitTestEnabled(true);
+            listener->onTouchBegan = onTouchBegan;
+            listener->onTouchEnded = onTouchEnded;
+            _eventDispatcher->addEventListenerWithSceneGraphPriority(listener, sprite);
+        }
+    }
+
+    auto mover = Sprite::create("Images/CyanSquare.png");
+    mover->setPosition(origin + Vec2(size.width/4, size.height/2));
+    mover->runAction(RepeatForever::create(Sequence::create(MoveBy::create(2, Vec2(size.width/2, 0)), MoveBy::create(2, Vec2(-size.width/2, 0)), nullptr)));
+    addChild(mover, 1);
+
+    auto listener = EventListenerTouchOneByOne::create();
+    listener->setSwallowTouches(true);
+    listener->setHitTestEnabled(true);
+    listener->onTouchBegan = onTouchBegan;
+    listener->onTouchEnded = onTouchEnded;
+    _eventDispatcher->addEventListenerWithSceneGraphPriority(listener, mover);
+}
+
+std::string TouchHitTestTest::title() const
+{
+    return "Touch hit testing";
+}
+
+std::string TouchHitTestTest::subtitle() const
+{
+    return "Touching a sprite should call onTouchBegan\nof the sprites under the touch only";
+}
@@ -286,4 +286,32 @@ private:
     cocos2d::EventListenerCustom* _listener;
 };
 
+class CustomEventIDTest : public EventDispatcherTestDemo
+{
+public:
+    CREATE_FUNC(CustomEventIDTest);
+    CustomEventIDTest();
+    virtual ~CustomEventIDTest();
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+
+private:
+    cocos2d::Vector<cocos2d::EventListener*> _listeners;
+    std::string _order;
+};
+
+class TouchHitTestTest : public EventDispatcherTestDemo
+{
+public:
+    CREATE_FUNC(TouchHitTestTest);
+    TouchHitTestTest();
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+
+private:
+    int _touchBeganCalls;
+};
+
 #endif /* defined(__samples__NewEventDispatcherTest__) */
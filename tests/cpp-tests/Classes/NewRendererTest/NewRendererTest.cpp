@@ -40,6 +40,12 @@ NewRendererTests::NewRendererTests()
     ADD_TEST_CASE(RendererBatchQuadTri);
     ADD_TEST_CASE(RendererUniformBatch);
     ADD_TEST_CASE(RendererUniformBatch2);
+    ADD_TEST_CASE(RendererParallelVisit);
+    ADD_TEST_CASE(RendererMultiTextureBatching);
+    ADD_TEST_CASE(RendererGPUTiming);
+    ADD_TEST_CASE(RendererMemoryStats);
+    ADD_TEST_CASE(RendererBatchBreaks);
+    ADD_TEST_CASE(RendererOverdraw);
 };
 
 std::string MultiSceneTest::title() const
@@ -434,7 +440,10 @@ CaptureScreenTest::CaptureScreenTest()
 
     auto label1 = Label::createWithTTF(TTFConfig("fonts/arial.ttf"), "capture all");
     auto mi1 = MenuItemLabel::create(label1, CC_CALLBACK_1(CaptureScreenTest::onCaptured, this));
-    auto menu = Menu::create(mi1, nullptr);
+    auto label2 = Label::createWithTTF(TTFConfig("fonts/arial.ttf"), "capture all async");
+    auto mi2 = MenuItemLabel::create(label2, CC_CALLBACK_1(CaptureScreenTest::onCapturedAsync, this));
+    auto menu = Menu::create(mi1, mi2, nullptr);
+    menu->alignItemsVertically();
     addChild(menu);
     menu->setPosition(s.width / 2, s.height / 4);
 
@@ -466,6 +475,16 @@ void CaptureScreenTest::onCaptured(Ref*)
     utils::captureScreen(CC_CALLBACK_2(CaptureScreenTest::afterCaptured, this), _filename);
 }
 
+void CaptureScreenTest::onCapturedAsync(Ref*)
+{
+    Director::getInstance()->getTextureCache()->removeTextureForKey(_filename);
+    removeChildByTag(childTag);
+    _filename = "CaptureScreenAsyncTest.png";
+    // the pixels are read back and saved a few frames later
+    this->retain();
+    utils::captureScreenAsync(CC_CALLBACK_2(CaptureScreenTest::afterCaptured, this), _filename);
+}
+
 void CaptureScreenTest::afterCaptured(bool succeed, const std::string& outputFile)
 {
     if (succeed)
@@ -778,3 +797,356 @@ std::string RendererUniformBatch2::subtitle() const
 {
     return "Mixing different shader states should work ok";
 }
+
+//
+// RendererParallelVisit
+//
+RendererParallelVisit::RendererParallelVisit()
+{
+    Size s = Director::getInstance()->getWinSize();
+
+    // each column is a parallel root, columns on the left must stay below the ones on the right
+    for (int x = 0; x < 8; ++x)
+    {
+        auto column = Node::create();
+        column->setParallelVisitRoot(true);
+        column->setPosition(Vec2(s.width / 8 * x, 0));
+        addChild(column, x - 4);
+
+        for (int y = 0; y < 200; ++y)
+        {
+            auto sprite = Sprite::create(y % 2 ? "Images/grossini.png" : "Images/grossinis_sister1.png");
+            sprite->setPosition(Vec2(CCRANDOM_0_1() * s.width / 4, CCRANDOM_0_1() * s.height));
+            sprite->setScale(0.4f);
+            sprite->runAction(RepeatForever::create(RotateBy::create(1, 90)));
+            column->addChild(sprite);
+        }
+    }
+}
+
+void RendererParallelVisit::onEnter()
+{
+    MultiSceneTest::onEnter();
+    Director::getInstance()->getRenderer()->setParallelVisitEnabled(true);
+}
+
+void RendererParallelVisit::onExit()
+{
+    Director::getInstance()->getRenderer()->setParallelVisitEnabled(false);
+    MultiSceneTest::onExit();
+}
+
+std::string RendererParallelVisit::title() const
+{
+    return "Parallel visit";
+}
+
+std::string RendererParallelVisit::subtitle() const
+{
+    return "Columns are visited on worker threads.\nOrder should be the same as a sequential visit";
+}
+
+//
+// RendererMultiTextureBatching
+//
+RendererMultiTextureBatching::RendererMultiTextureBatching()
+: _wasEnabled(false)
+{
+    Size s = Director::getInstance()->getWinSize();
+
+    // interleaved textures break the regular auto-batching on every sprite
+    const char* files[] = {"Images/grossini.png", "Images/grossinis_sister1.png", "Images/grossinis_sister2.png", "Images/blocks.png"};
+    for (int i = 0; i < 400; ++i)
+    {
+        auto sprite = Sprite::create(files[i % 4]);
+        sprite->setPosition(Vec2(CCRANDOM_0_1() * s.width, CCRANDOM_0_1() * s.height));
+        sprite->setScale(0.4f);
+        sprite->runAction(RepeatForever::create(RotateBy::create(1, 90)));
+        addChild(sprite);
+    }
+}
+
+void RendererMultiTextureBatching::onEnter()
+{
+    MultiSceneTest::onEnter();
+    auto renderer = Director::getInstance()->getRenderer();
+    _wasEnabled = renderer->isMultiTextureBatchingEnabled();
+    renderer->setMultiTextureBatchingEnabled(true);
+}
+
+void RendererMultiTextureBatching::onExit()
+{
+    Director::getInstance()->getRenderer()->setMultiTextureBatchingEnabled(_wasEnabled);
+    MultiSceneTest::onExit();
+}
+
+std::string RendererMultiTextureBatching::title() const
+{
+    return "Multi texture batching";
+}
+
+std::string RendererMultiTextureBatching::subtitle() const
+{
+    return "400 sprites with 4 interleaved textures.\nShould be drawn in a few draw calls";
+}
+
+//
+// RendererGPUTiming
+//
+RendererGPUTiming::RendererGPUTiming()
+: _wasEnabled(false)
+, _timingsLabel(nullptr)
+{
+    Size s = Director::getInstance()->getWinSize();
+
+    for (int i = 0; i < 200; ++i)
+    {
+        auto sprite = Sprite::create("Images/grossini.png");
+        sprite->setPosition(Vec2(CCRANDOM_0_1() * s.width, CCRANDOM_0_1() * s.height));
+        sprite->runAction(RepeatForever::create(RotateBy::create(1, 90)));
+        addChild(sprite);
+    }
+
+    _timingsLabel = Label::createWithSystemFont("", "", 12);
+    _timingsLabel->setAlignment(TextHAlignment::LEFT);
+    _timingsLabel->setAnchorPoint(Vec2::ANCHOR_TOP_LEFT);
+    _timingsLabel->setPosition(Vec2(10, s.height - 80));
+    addChild(_timingsLabel, 1);
+
+    schedule(CC_SCHEDULE_SELECTOR(RendererGPUTiming::updateTimings), 0.5f);
+}
+
+void RendererGPUTiming::onEnter()
+{
+    MultiSceneTest::onEnter();
+    auto renderer = Director::getInstance()->getRenderer();
+    _wasEnabled = renderer->isGPUTimingEnabled();
+    renderer->setGPUTimingEnabled(true);
+}
+
+void RendererGPUTiming::onExit()
+{
+    Director::getInstance()->getRenderer()->setGPUTimingEnabled(_wasEnabled);
+    MultiSceneTest::onExit();
+}
+
+void RendererGPUTiming::updateTimings(float /*dt*/)
+{
+    auto renderer = Director::getInstance()->getRenderer();
+    _timingsLabel->setString(renderer->isGPUTimingEnabled() ? renderer->getGPUTimingsDescription() : "Timer queries are not supported");
+}
+
+std::string RendererGPUTiming::title() const
+{
+    return "GPU timing";
+}
+
+std::string RendererGPUTiming::subtitle() const
+{
+    return "GPU time of every camera and render queue.\nAlso available with the console command 'gputime'";
+}
+
+//
+// RendererMemoryStats
+//
+RendererMemoryStats::RendererMemoryStats()
+: _wasDisplayed(false)
+, _statsLabel(nullptr)
+{
+    Size s = Director::getInstance()->getWinSize();
+
+    _statsLabel = Label::createWithSystemFont("", "", 12);
+    _statsLabel->setAlignment(TextHAlignment::LEFT);
+    _statsLabel->setAnchorPoint(Vec2::ANCHOR_TOP_LEFT);
+    _statsLabel->setPosition(Vec2(10, s.height - 80));
+    addChild(_statsLabel, 1);
+
+    // new sprites every frame, to see the allocations and the autoreleased objects
+    schedule([this, s](float /*dt*/) {
+        auto sprite = Sprite::create("Images/grossini.png");
+        sprite->setPosition(Vec2(CCRANDOM_0_1() * s.width, CCRANDOM_0_1() * s.height));
+        sprite->runAction(Sequence::create(FadeOut::create(1), RemoveSelf::create(), nullptr));
+        addChild(sprite);
+    }, "spawn");
+    schedule(CC_SCHEDULE_SELECTOR(RendererMemoryStats::updateStats), 0.5f);
+}
+
+void RendererMemoryStats::onEnter()
+{
+    MultiSceneTest::onEnter();
+    auto director = Director::getInstance();
+    _wasDisplayed = director->isDisplayMemoryStats();
+    director->setDisplayMemoryStats(true);
+}
+
+void RendererMemoryStats::onExit()
+{
+    Director::getInstance()->setDisplayMemoryStats(_wasDisplayed);
+    MultiSceneTest::onExit();
+}
+
+void RendererMemoryStats::updateStats(float /*dt*/)
+{
+    _statsLabel->setString(Director::getInstance()->getMemoryStatsDescription());
+}
+
+std::string RendererMemoryStats::title() const
+{
+    return "Memory statistics";
+}
+
+std::string RendererMemoryStats::subtitle() const
+{
+    return "Heap allocations, texture memory, caches and objects.\nAlso available with the console command 'memory'";
+}
+
+//
+// RendererBatchBreaks
+//
+RendererBatchBreaks::RendererBatchBreaks()
+: _wasEnabled(false)
+, _breaksLabel(nullptr)
+{
+    Size s = Director::getInstance()->getWinSize();
+
+    // alternating textures and blend functions, each sprite breaks the batch of the previous one
+    const char* images[] = {"Images/grossini.png", "Images/grossinis_sister1.png"};
+    for (int i = 0; i < 20; ++i)
+    {
+        auto sprite = Sprite::create(images[i % 2]);
+        sprite->setName(StringUtils::format("sprite%d", i));
+        sprite->setPosition(Vec2(s.width * (i + 1) / 21, s.height / 2));
+        if (i % 5 == 4)
+            sprite->setBlendFunc(BlendFunc::ADDITIVE);
+        addChild(sprite);
+    }
+
+    _breaksLabel = Label::createWithSystemFont("", "", 12);
+    _breaksLabel->setAlignment(TextHAlignment::LEFT);
+    _breaksLabel->setAnchorPoint(Vec2::ANCHOR_TOP_LEFT);
+    _breaksLabel->setPosition(Vec2(10, s.height - 80));
+    addChild(_breaksLabel, 1);
+
+    schedule(CC_SCHEDULE_SELECTOR(RendererBatchBreaks::updateBreaks), 0.5f);
+}
+
+void RendererBatchBreaks::onEnter()
+{
+    MultiSceneTest::onEnter();
+    auto renderer = Director::getInstance()->getRenderer();
+    _wasEnabled = renderer->isBatchBreakStatisticsEnabled();
+    renderer->setBatchBreakStatisticsEnabled(true);
+}
+
+void RendererBatchBreaks::onExit()
+{
+    Director::getInstance()->getRenderer()->setBatchBreakStatisticsEnabled(_wasEnabled);
+    MultiSceneTest::onExit();
+}
+
+void RendererBatchBreaks::updateBreaks(float /*dt*/)
+{
+    const auto& statistics = Director::getInstance()->getRenderer()->getBatchBreakStatistics();
+    std::string text;
+    for (int cause = 0; cause < (int)Renderer::BatchBreakCause::COUNT; ++cause)
+    {
+        if (statistics.causes[cause] > 0)
+            text += StringUtils::format("%s: %ld\n", Renderer::getBatchBreakCauseName((Renderer::BatchBreakCause)cause), (long)statistics.causes[cause]);
+    }
+    for (size_t i = 0; i < statistics.breaks.size() && i < 8; ++i)
+    {
+        const auto& entry = statistics.breaks[i];
+        text += StringUtils::format("%s: %s -> %s\n", Renderer::getBatchBreakCauseName(entry.cause), entry.previousNode.c_str(), entry.node.c_str());
+    }
+    _breaksLabel->setString(text);
+}
+
+std::string RendererBatchBreaks::title() const
+{
+    return "Batch breaks";
+}
+
+std::string RendererBatchBreaks::subtitle() const
+{
+    return "Why the batches are broken, and by which nodes.\nAlso available with the console command 'perf breaks'";
+}
+
+//
+// RendererOverdraw
+//
+RendererOverdraw::RendererOverdraw()
+: _wasEnabled(false)
+, _overdrawLabel(nullptr)
+{
+    Size s = Director::getInstance()->getWinSize();
+
+    // a stack of sprites in the middle, the heatmap is brighter where they overlap
+    for (int i = 0; i < 30; ++i)
+    {
+        auto sprite = Sprite::create("Images/grossini.png");
+        sprite->setPosition(Vec2(s.width / 2 + 60 * cosf(i * 0.4f), s.height / 2 + 40 * sinf(i * 0.4f)));
+        addChild(sprite);
+    }
+
+    // almost invisible, but it covers the whole screen: it's listed as a transparent node
+    auto cover = Sprite::create("Images/background3.png");
+    cover->setName("invisibleCover");
+    cover->setPosition(Vec2(s.width / 2, s.height / 2));
+    cover->setScale(s.width / cover->getContentSize().width, s.height / cover->getContentSize().height);
+    cover->setOpacity(3);
+    addChild(cover);
+
+    _overdrawLabel = Label::createWithSystemFont("", "", 12);
+    _overdrawLabel->setAlignment(TextHAlignment::LEFT);
+    _overdrawLabel->setAnchorPoint(Vec2::ANCHOR_TOP_LEFT);
+    _overdrawLabel->setPosition(Vec2(10, s.height - 80));
+    addChild(_overdrawLabel, 1);
+
+    schedule(CC_SCHEDULE_SELECTOR(RendererOverdraw::updateOverdraw), 0.5f);
+}
+
+void RendererOverdraw::onEnter()
+{
+    MultiSceneTest::onEnter();
+    auto renderer = Director::getInstance()->getRenderer();
+    _wasEnabled = renderer->isOverdrawVisualizationEnabled();
+    renderer->setOverdrawVisualizationEnabled(true);
+}
+
+void RendererOverdraw::onExit()
+{
+    Director::getInstance()->getRenderer()->setOverdrawVisualizationEnabled(_wasEnabled);
+    MultiSceneTest::onExit();
+}
+
+void RendererOverdraw::updateOverdraw(float /*dt*/)
+{
+    const auto& statistics = Director::getInstance()->getRenderer()->getOverdrawStatistics();
+    if (statistics.screenPixels <= 0)
+        return;
+
+    double pixels = 0;
+    std::string text;
+    for (const auto& pass : statistics.passes)
+    {
+        pixels += pass.pixels;
+        text += StringUtils::format("%s %s: %.2f screens, %.2f transparent\n", pass.camera.c_str(), pass.group.c_str(),
+            pass.pixels / statistics.screenPixels, pass.transparentPixels / statistics.screenPixels);
+    }
+    text = StringUtils::format("Overdraw: %.2f\n", pixels / statistics.screenPixels) + text;
+    for (const auto& node : statistics.transparentNodes)
+    {
+        text += StringUtils::format("Transparent node %s: %.0f%% of the screen, alpha %.2f\n", node.node.c_str(), node.coverage * 100, node.alpha);
+    }
+    _overdrawLabel->setString(text);
+}
+
+std::string RendererOverdraw::title() const
+{
+    return "Overdraw";
+}
+
+std::string RendererOverdraw::subtitle() const
+{
+    return "Red to white: drawn more times, blue: transparent.\nAlso available with the console command 'perf overdraw'";
+}
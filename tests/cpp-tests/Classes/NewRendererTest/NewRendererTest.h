@@ -124,6 +124,7 @@ protected:
     ~CaptureScreenTest();
 
     void onCaptured(cocos2d::Ref*);
+    void onCapturedAsync(cocos2d::Ref*);
     void afterCaptured(bool succeed, const std::string& outputFile);
 
     std::string _filename;
@@ -192,4 +193,94 @@ protected:
     cocos2d::GLProgramState* createSepiaGLProgramState();
 };
 
+class RendererParallelVisit : public MultiSceneTest
+{
+public:
+    CREATE_FUNC(RendererParallelVisit);
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual void onEnter() override;
+    virtual void onExit() override;
+protected:
+    RendererParallelVisit();
+};
+
+class RendererMultiTextureBatching : public MultiSceneTest
+{
+public:
+    CREATE_FUNC(RendererMultiTextureBatching);
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual void onEnter() override;
+    virtual void onExit() override;
+protected:
+    RendererMultiTextureBatching();
+
+    bool _wasEnabled;
+};
+
+class RendererGPUTiming : public MultiSceneTest
+{
+public:
+    CREATE_FUNC(RendererGPUTiming);
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual void onEnter() override;
+    virtual void onExit() override;
+protected:
+    RendererGPUTiming();
+    void updateTimings(float dt);
+
+    bool _wasEnabled;
+    cocos2d::Label* _timingsLabel;
+};
+
+class RendererMemoryStats : public MultiSceneTest
+{
+public:
+    CREATE_FUNC(RendererMemoryStats);
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual void onEnter() override;
+    virtual void onExit() override;
+protected:
+    RendererMemoryStats();
+    void updateStats(float dt);
+
+    bool _wasDisplayed;
+    cocos2d::Label* _statsLabel;
+};
+
+class RendererBatchBreaks : public MultiSceneTest
+{
+public:
+    CREATE_FUNC(RendererBatchBreaks);
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual void onEnter() override;
+    virtual void onExit() override;
+protected:
+    RendererBatchBreaks();
+    void updateBreaks(float dt);
+
+    bool _wasEnabled;
+    cocos2d::Label* _breaksLabel;
+};
+
+class RendererOverdraw : public MultiSceneTest
+{
+public:
+    CREATE_FUNC(RendererOverdraw);
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual void onEnter() override;
+    virtual void onExit() override;
+protected:
+    RendererOverdraw();
+    void updateOverdraw(float dt);
+
+    bool _wasEnabled;
+    cocos2d::Label* _overdrawLabel;
+};
+
 #endif //__NewRendererTest_H_
@@ -73,6 +73,11 @@ CocosNodeTests::CocosNodeTests()
     ADD_TEST_CASE(NodeNameTest);
     ADD_TEST_CASE(Issue16100Test);
     ADD_TEST_CASE(Issue16735Test);
+    ADD_TEST_CASE(NodeFlatTransformTest);
+    ADD_TEST_CASE(NodeSpatialIndexTest);
+    ADD_TEST_CASE(NodeLODTest);
+    ADD_TEST_CASE(NodeStaticBatchTest);
+    ADD_TEST_CASE(NodeComponentSystemTest);
 }
 
 TestCocosNodeDemo::TestCocosNodeDemo(void)
@@ -1446,6 +1451,46 @@ void NodeNameTest::test(float dt)
     }
     auto findChildren = utils::findChildren(*parent, "node");
     CCAssert(findChildren.size() == 50, "");
+
+    // the same lookups with the child index
+    parent = Node::create();
+    parent->setChildIndexEnabled(true);
+    for (int i = 0; i < 10; ++i)
+    {
+        auto node = Node::create();
+        sprintf(name, "node%d", i);
+        node->setName(name);
+        parent->addChild(node, 0, i);
+
+        auto child = Node::create();
+        child->setName("child");
+        node->addChild(child);
+    }
+    auto node5 = parent->getChildByName("node5");
+    CCAssert(node5 != nullptr && parent->getChildByTag(5) == node5, "");
+
+    node5->setName("renamed");
+    node5->setTag(50);
+    CCAssert(parent->getChildByName("node5") == nullptr && parent->getChildByName("renamed") == node5, "");
+    CCAssert(parent->getChildByTag(5) == nullptr && parent->getChildByTag(50) == node5, "");
+
+    // several children with a name, the first one is found
+    auto node7 = parent->getChildByName("node7");
+    node7->setName("node6");
+    CCAssert(parent->getChildByName("node6") == parent->getChildren().at(6), "");
+
+    i = 0;
+    NodePathQuery query("node[[:digit:]]+/child");
+    parent->enumerateChildren(query, [&i](Node* node) -> bool {
+        ++i;
+        return false;
+    });
+    CCAssert(i == 9, "");
+
+    parent->removeChild(node5);
+    CCAssert(parent->getChildByName("renamed") == nullptr && parent->getChildByTag(50) == nullptr, "");
+    parent->removeAllChildren();
+    CCAssert(parent->getChildByName("node0") == nullptr, "");
 }
 
 //------------------------------------------------------------------
@@ -1557,3 +1602,363 @@ std::string Issue16735Test::subtitle() const
 {
     return "Sprite should appear on the center of screen";
 }
+
+// NodeFlatTransformTest
+
+void NodeFlatTransformTest::onEnter()
+{
+    TestCocosNodeDemo::onEnter();
+
+    auto s = Director::getInstance()->getWinSize();
+
+    // 40 rotating groups of 50 sprites, all moving every frame
+    _root = Node::create();
+    _root->setPosition(s.width / 2, s.height / 2);
+    _root->runAction(RepeatForever::create(RotateBy::create(8, 360)));
+    addChild(_root);
+
+    for (int i = 0; i < 40; ++i)
+    {
+        auto group = Node::create();
+        group->setPosition(Vec2::forAngle((float)(i * 2 * M_PI / 40)) * s.height / 3);
+        group->runAction(RepeatForever::create(RotateBy::create(2, -360)));
+        _root->addChild(group);
+
+        for (int j = 0; j < 50; ++j)
+        {
+            auto sprite = Sprite::create("Images/r1.png");
+            sprite->setScale(0.3f);
+            sprite->setPosition(Vec2::forAngle((float)(j * 2 * M_PI / 50)) * (10 + j));
+            sprite->runAction(RepeatForever::create(RotateBy::create(1, 360)));
+            group->addChild(sprite);
+        }
+    }
+
+    _root->setFlatTransformRoot(true);
+
+    MenuItemFont::setFontSize(18);
+    auto item = MenuItemToggle::createWithCallback(CC_CALLBACK_1(NodeFlatTransformTest::toggleFlatTransform, this),
+                                                   MenuItemFont::create("Flat transforms: on"),
+                                                   MenuItemFont::create("Flat transforms: off"),
+                                                   nullptr);
+    auto menu = Menu::create(item, nullptr);
+    menu->setPosition(s.width / 2, s.height / 6);
+    addChild(menu, 1);
+}
+
+void NodeFlatTransformTest::toggleFlatTransform(Ref* /*sender*/)
+{
+    _root->setFlatTransformRoot(!_root->isFlatTransformRoot());
+}
+
+std::string NodeFlatTransformTest::title() const
+{
+    return "Flat transform hierarchy";
+}
+
+std::string NodeFlatTransformTest::subtitle() const
+{
+    return "2000 moving sprites, both modes should look the same";
+}
+
+// NodeSpatialIndexTest
+
+void NodeSpatialIndexTest::onEnter()
+{
+    TestCocosNodeDemo::onEnter();
+
+    auto s = Director::getInstance()->getWinSize();
+
+    // a map 10 screens wide with 20000 decorations, scrolling back and forth
+    _map = Node::create();
+    _map->setContentSize(Size(s.width * 10, s.height));
+    _map->setSpatialIndexEnabled(true, 128);
+    addChild(_map);
+
+    for (int i = 0; i < 20000; ++i)
+    {
+        auto sprite = Sprite::create("Images/r1.png");
+        sprite->setScale(0.2f);
+        sprite->setPosition(CCRANDOM_0_1() * s.width * 10, CCRANDOM_0_1() * s.height);
+        _map->addChild(sprite, (int)(CCRANDOM_MINUS1_1() * 10));
+    }
+
+    // a few of them keep moving
+    for (int i = 0; i < 20; ++i)
+    {
+        auto sprite = Sprite::create("Images/grossini.png");
+        sprite->setPosition(s.width / 2 + i * s.width / 2, s.height / 2);
+        sprite->runAction(RepeatForever::create(Sequence::create(MoveBy::create(2, Vec2(s.width, 0)), MoveBy::create(2, Vec2(-s.width, 0)), nullptr)));
+        _map->addChild(sprite, 20);
+    }
+
+    auto scroll = MoveBy::create(20, Vec2(-s.width * 9, 0));
+    _map->runAction(RepeatForever::create(Sequence::create(scroll, scroll->reverse(), nullptr)));
+
+    _label = Label::createWithTTF("", "fonts/arial.ttf", 15);
+    _label->setPosition(s.width / 2, s.height / 6);
+    addChild(_label, 1);
+
+    scheduleUpdate();
+}
+
+void NodeSpatialIndexTest::update(float /*dt*/)
+{
+    auto s = Director::getInstance()->getWinSize();
+    Rect screen(-_map->getPositionX(), 0, s.width, s.height);
+    _label->setString(StringUtils::format("visible: %d / %d", (int)_map->getChildrenInRect(screen).size(), (int)_map->getChildrenCount()));
+}
+
+std::string NodeSpatialIndexTest::title() const
+{
+    return "Spatial index";
+}
+
+std::string NodeSpatialIndexTest::subtitle() const
+{
+    return "Only the on-screen children of the map are visited";
+}
+
+//------------------------------------------------------------------
+//
+// NodeLODTest
+//
+//------------------------------------------------------------------
+void NodeLODTest::onEnter()
+{
+    TestCocosNodeDemo::onEnter();
+
+    auto s = Director::getInstance()->getWinSize();
+
+    // a map of 400 units zooming in and out
+    _map = Node::create();
+    _map->setPosition(s.width / 2, s.height / 2);
+    addChild(_map);
+
+    for (int y = 0; y < 20; ++y)
+    {
+        for (int x = 0; x < 20; ++x)
+        {
+            auto unit = LODNode::create();
+            unit->setPosition((x - 9.5f) * 60, (y - 9.5f) * 60);
+
+            // full: the animated sprite with its name
+            auto full = Node::create();
+            auto sprite = Sprite::create("Images/grossini.png");
+            sprite->setScale(0.4f);
+            sprite->runAction(RepeatForever::create(RotateBy::create(2, 360)));
+            full->addChild(sprite);
+            auto name = Label::createWithTTF(StringUtils::format("unit %d", y * 20 + x), "fonts/arial.ttf", 10);
+            name->setPosition(0, -30);
+            full->addChild(name);
+            unit->addLevel(full, 0.6f);
+
+            // simplified: a still sprite
+            auto simplified = Sprite::create("Images/r1.png");
+            simplified->setScale(0.5f);
+            unit->addLevel(simplified, 0.2f);
+
+            // impostor: a dot, nothing below
+            auto impostor = DrawNode::create();
+            impostor->drawDot(Vec2::ZERO, 8, Color4F::GREEN);
+            unit->addLevel(impostor, 0.05f);
+
+            _map->addChild(unit);
+            _units.push_back(unit);
+        }
+    }
+
+    auto zoom = Sequence::create(ScaleTo::create(4, 0.03f), ScaleTo::create(4, 1.5f), nullptr);
+    _map->runAction(RepeatForever::create(zoom));
+
+    _label = Label::createWithTTF("", "fonts/arial.ttf", 15);
+    _label->setPosition(s.width / 2, s.height / 6);
+    addChild(_label, 1);
+
+    scheduleUpdate();
+}
+
+void NodeLODTest::update(float /*dt*/)
+{
+    int counts[4] = { 0, 0, 0, 0 };
+    for (auto unit : _units)
+    {
+        ssize_t level = unit->getCurrentLevel();
+        counts[level == -1 ? 3 : level]++;
+    }
+    _label->setString(StringUtils::format("scale: %.2f, full: %d, simplified: %d, impostor: %d, none: %d",
+                                          _map->getScale(), counts[0], counts[1], counts[2], counts[3]));
+}
+
+std::string NodeLODTest::title() const
+{
+    return "LODNode";
+}
+
+std::string NodeLODTest::subtitle() const
+{
+    return "The units switch representations when zooming out";
+}
+
+//------------------------------------------------------------------
+//
+// NodeStaticBatchTest
+//
+//------------------------------------------------------------------
+void NodeStaticBatchTest::onEnter()
+{
+    TestCocosNodeDemo::onEnter();
+
+    auto s = Director::getInstance()->getWinSize();
+
+    // a background of 600 tiles and 20 labels, drawn in one call per texture
+    _batch = StaticBatchNode::create();
+    _batch->setPosition(s.width / 2, s.height / 2);
+    addChild(_batch);
+
+    for (int y = 0; y < 20; ++y)
+    {
+        for (int x = 0; x < 30; ++x)
+        {
+            auto tile = Sprite::create("Images/r1.png");
+            tile->setScale(0.4f);
+            tile->setPosition((x - 14.5f) * 16, (y - 9.5f) * 16);
+            _batch->addChild(tile, 0, y * 30 + x);
+        }
+    }
+    for (int y = 0; y < 20; ++y)
+    {
+        auto row = Label::createWithTTF(StringUtils::format("row %d", y), "fonts/arial.ttf", 10);
+        row->setPosition(-260, (y - 9.5f) * 16);
+        _batch->addChild(row, 1);
+    }
+
+    // only the batch node moves, the children aren't recorded again
+    _batch->runAction(RepeatForever::create(RotateBy::create(8, 360)));
+
+    _label = Label::createWithTTF("", "fonts/arial.ttf", 15);
+    _label->setPosition(s.width / 2, s.height / 6);
+    addChild(_label, 1);
+
+    // a touch modifies a tile, it needs a new recording
+    auto listener = EventListenerTouchOneByOne::create();
+    listener->onTouchBegan = [this](Touch* /*touch*/, Event* /*event*/) {
+        auto tile = _batch->getChildByTag(RandomHelper::random_int(0, 599));
+        tile->setColor(Color3B::RED);
+        _batch->markDirty();
+        return true;
+    };
+    _eventDispatcher->addEventListenerWithSceneGraphPriority(listener, this);
+
+    schedule([this](float /*dt*/) { updateLabel(); }, 0.5f, "updateLabel");
+}
+
+void NodeStaticBatchTest::updateLabel()
+{
+    _label->setString(StringUtils::format("recorded: %s, draw calls: %d",
+                                          _batch->isRecorded() ? "yes" : "no", (int)_batch->getDrawCallCount()));
+}
+
+std::string NodeStaticBatchTest::title() const
+{
+    return "StaticBatchNode";
+}
+
+std::string NodeStaticBatchTest::subtitle() const
+{
+    return "620 nodes drawn in a few calls, touch to modify a tile";
+}
+
+//------------------------------------------------------------------
+//
+// NodeComponentSystemTest
+//
+//------------------------------------------------------------------
+
+namespace
+{
+    const char* SPIN_COMPONENT_TYPE = "NodeComponentSystemTest.spin";
+
+    // rotates its owner, by itself or with the other spin components
+    class SpinComponent : public Component
+    {
+    public:
+        CREATE_FUNC(SpinComponent);
+
+        virtual bool init() override
+        {
+            setName("spin");
+            setUpdateType(SPIN_COMPONENT_TYPE);
+            return true;
+        }
+
+        virtual void update(float delta) override
+        {
+            _owner->setRotation(_owner->getRotation() + 90 * delta);
+        }
+    };
+}
+
+std::string NodeComponentSystemTest::title() const
+{
+    return "ComponentSystem";
+}
+
+std::string NodeComponentSystemTest::subtitle() const
+{
+    return "400 components updated from one list, touch to toggle";
+}
+
+void NodeComponentSystemTest::onEnter()
+{
+    TestCocosNodeDemo::onEnter();
+
+    auto s = Director::getInstance()->getWinSize();
+    _label = Label::createWithTTF("", "fonts/arial.ttf", 16);
+    _label->setPosition(s.width / 2, s.height - 80);
+    addChild(_label, 1);
+
+    Sprite* sprite = nullptr;
+    for (int i = 0; i < 400; ++i)
+    {
+        sprite = Sprite::create("Images/r1.png");
+        sprite->setScale(0.3f);
+        sprite->setPosition(CCRANDOM_0_1() * s.width, CCRANDOM_0_1() * (s.height - 120) + 20);
+        sprite->addComponent(SpinComponent::create());
+        addChild(sprite);
+    }
+
+    // the paused nodes leave the list
+    sprite->pause();
+
+    ComponentSystem::getInstance()->registerType(SPIN_COMPONENT_TYPE);
+    CCASSERT(ComponentSystem::getInstance()->getComponents(SPIN_COMPONENT_TYPE).size() == 399, "the paused node's component should not be in the list");
+    updateLabel();
+
+    auto listener = EventListenerTouchOneByOne::create();
+    listener->onTouchBegan = [this](Touch*, Event*) {
+        auto system = ComponentSystem::getInstance();
+        if (system->isTypeRegistered(SPIN_COMPONENT_TYPE))
+            system->unregisterType(SPIN_COMPONENT_TYPE);
+        else
+            system->registerType(SPIN_COMPONENT_TYPE);
+        updateLabel();
+        return true;
+    };
+    _eventDispatcher->addEventListenerWithSceneGraphPriority(listener, this);
+}
+
+void NodeComponentSystemTest::onExit()
+{
+    ComponentSystem::getInstance()->unregisterType(SPIN_COMPONENT_TYPE);
+
+    TestCocosNodeDemo::onExit();
+}
+
+void NodeComponentSystemTest::updateLabel()
+{
+    auto system = ComponentSystem::getInstance();
+    _label->setString(StringUtils::format("%s: %d components",
+        system->isTypeRegistered(SPIN_COMPONENT_TYPE) ? "batched" : "updated by their nodes",
+        (int)system->getComponents(SPIN_COMPONENT_TYPE).size()));
+}
@@ -352,4 +352,82 @@ public:
     virtual void onExit() override;
 };
 
+class NodeFlatTransformTest : public TestCocosNodeDemo
+{
+public:
+    CREATE_FUNC(NodeFlatTransformTest);
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+
+    virtual void onEnter() override;
+
+protected:
+    void toggleFlatTransform(cocos2d::Ref* sender);
+
+    cocos2d::Node* _root;
+};
+
+class NodeSpatialIndexTest : public TestCocosNodeDemo
+{
+public:
+    CREATE_FUNC(NodeSpatialIndexTest);
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+
+    virtual void onEnter() override;
+    virtual void update(float dt) override;
+
+protected:
+    cocos2d::Node* _map;
+    cocos2d::Label* _label;
+};
+
+class NodeLODTest : public TestCocosNodeDemo
+{
+public:
+    CREATE_FUNC(NodeLODTest);
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+
+    virtual void onEnter() override;
+    virtual void update(float dt) override;
+
+protected:
+    cocos2d::Node* _map;
+    cocos2d::Label* _label;
+    std::vector<cocos2d::LODNode*> _units;
+};
+
+class NodeStaticBatchTest : public TestCocosNodeDemo
+{
+public:
+    CREATE_FUNC(NodeStaticBatchTest);
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+
+    virtual void onEnter() override;
+
+protected:
+    void updateLabel();
+
+    cocos2d::StaticBatchNode* _batch;
+    cocos2d::Label* _label;
+};
+
+class NodeComponentSystemTest : public TestCocosNodeDemo
+{
+public:
+    CREATE_FUNC(NodeComponentSystemTest);
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+
+    virtual void onEnter() override;
+    virtual void onExit() override;
+
+protected:
+    void updateLabel();
+
+    cocos2d::Label* _label;
+};
+
 #endif
@@ -1049,6 +1049,10 @@ ParticleTests::ParticleTests()
 
     ADD_TEST_CASE(ParticleIssue12310);
     ADD_TEST_CASE(ParticleSpriteFrame);
+    ADD_TEST_CASE(ParticleParallelUpdate);
+    ADD_TEST_CASE(ParticleGPUTest);
+    ADD_TEST_CASE(ParticlePoolTest);
+    ADD_TEST_CASE(ParticleAsyncCreateTest);
 }
 
 ParticleDemo::~ParticleDemo(void)
@@ -2086,3 +2090,206 @@ std::string ParticleSpriteFrame::subtitle() const
 {
     return "Should not use entire texture atlas";
 }
+
+//------------------------------------------------------------------
+//
+// ParticleParallelUpdate
+//
+//------------------------------------------------------------------
+void ParticleParallelUpdate::onEnter()
+{
+    ParticleDemo::onEnter();
+
+    _color->setColor(Color3B::BLACK);
+    removeChild(_background, true);
+    _background = nullptr;
+
+    ParticleSystem::setParallelUpdateEnabled(true);
+
+    auto winSize = Director::getInstance()->getWinSize();
+    const char* plists[] = { "Particles/BoilingFoam.plist", "Particles/Galaxy.plist", "Particles/SpinningPeas.plist" };
+
+    // free, relative and grouped emitters, the free ones move to check the captured transforms
+    for (int i = 0; i < 60; ++i)
+    {
+        auto particle = ParticleSystemQuad::create(plists[i % 3]);
+        particle->setPositionType(static_cast<ParticleSystem::PositionType>(i % 3));
+        particle->setScale(0.25f);
+        particle->setPosition(Vec2((i % 10 + 0.5f) * winSize.width / 10, (i / 10 + 0.5f) * winSize.height / 6));
+        if (particle->getPositionType() == ParticleSystem::PositionType::FREE)
+        {
+            particle->runAction(RepeatForever::create(Sequence::create(MoveBy::create(1, Vec2(30, 0)), MoveBy::create(1, Vec2(-30, 0)), nullptr)));
+        }
+        addChild(particle);
+    }
+}
+
+void ParticleParallelUpdate::onExit()
+{
+    ParticleSystem::setParallelUpdateEnabled(false);
+    ParticleDemo::onExit();
+}
+
+std::string ParticleParallelUpdate::title() const
+{
+    return "Parallel Update";
+}
+
+std::string ParticleParallelUpdate::subtitle() const
+{
+    return "60 emitters simulated on the job system";
+}
+
+//------------------------------------------------------------------
+//
+// ParticleGPUTest
+//
+//------------------------------------------------------------------
+void ParticleGPUTest::onEnter()
+{
+    ParticleDemo::onEnter();
+
+    _color->setColor(Color3B::BLACK);
+    removeChild(_background, true);
+    _background = nullptr;
+
+    auto winSize = Director::getInstance()->getWinSize();
+
+    // the same effect on the CPU and on the GPU, the GPU one with a hundred times more particles
+    auto quad = ParticleSystemQuad::create("Particles/LavaFlow.plist");
+    quad->setPosition(Vec2(winSize.width * 0.25f, winSize.height * 0.3f));
+    addChild(quad);
+
+    auto gpu = ParticleSystemGPU::create("Particles/LavaFlow.plist");
+    gpu->setTotalParticles(gpu->getTotalParticles() * 100);
+    gpu->setEmissionRate(gpu->getTotalParticles() / gpu->getLife());
+    gpu->setPosition(Vec2(winSize.width * 0.75f, winSize.height * 0.3f));
+    addChild(gpu);
+
+    auto peas = ParticleSystemGPU::create("Particles/SpinningPeas.plist");
+    peas->setPosition(Vec2(winSize.width * 0.5f, winSize.height * 0.6f));
+    addChild(peas);
+}
+
+std::string ParticleGPUTest::title() const
+{
+    return "GPU Particles";
+}
+
+std::string ParticleGPUTest::subtitle() const
+{
+    return "Left: ParticleSystemQuad, right: ParticleSystemGPU\nwith 100 times more particles";
+}
+
+//------------------------------------------------------------------
+//
+// ParticlePoolTest
+//
+//------------------------------------------------------------------
+void ParticlePoolTest::onEnter()
+{
+    ParticleDemo::onEnter();
+
+    _color->setColor(Color3B::BLACK);
+    removeChild(_background, true);
+    _background = nullptr;
+
+    auto winSize = Director::getInstance()->getWinSize();
+
+    // the same fire, prewarmed on the job system on the left
+    auto cold = ParticleSystemQuad::create("Particles/Phoenix.plist");
+    cold->setPosition(Vec2(winSize.width * 0.75f, winSize.height * 0.25f));
+    addChild(cold);
+
+    auto warm = ParticleSystemQuad::create("Particles/Phoenix.plist");
+    warm->setPosition(Vec2(winSize.width * 0.25f, winSize.height * 0.25f));
+    this->retain();
+    warm->prewarmAsync(warm->getLife() + warm->getLifeVar(), [this](ParticleSystem* system) {
+        if (isRunning())
+        {
+            addChild(system);
+        }
+        this->release();
+    });
+
+    ParticleSystemQuad::preallocatePool("Particles/ExplodingRing.plist", 8);
+    schedule(CC_SCHEDULE_SELECTOR(ParticlePoolTest::spawnExplosion), 0.25f);
+}
+
+void ParticlePoolTest::onExit()
+{
+    ParticleDemo::onExit();
+    ParticleSystemQuad::purgePool();
+}
+
+void ParticlePoolTest::spawnExplosion(float /*dt*/)
+{
+    auto winSize = Director::getInstance()->getWinSize();
+
+    auto explosion = ParticleSystemQuad::createFromPool("Particles/ExplodingRing.plist");
+    if (explosion == nullptr)
+        return;
+    explosion->setPosition(Vec2(winSize.width * CCRANDOM_0_1(), winSize.height * (0.5f + 0.4f * CCRANDOM_0_1())));
+    explosion->setAutoRemoveOnFinish(true);
+    addChild(explosion);
+}
+
+std::string ParticlePoolTest::title() const
+{
+    return "Pooled and prewarmed systems";
+}
+
+std::string ParticlePoolTest::subtitle() const
+{
+    return "Explosions reused from a pool\nLeft fire prewarmed, right fire not";
+}
+
+//------------------------------------------------------------------
+//
+// ParticleAsyncCreateTest
+//
+//------------------------------------------------------------------
+void ParticleAsyncCreateTest::onEnter()
+{
+    ParticleDemo::onEnter();
+
+    _color->setColor(Color3B::BLACK);
+    removeChild(_background, true);
+    _background = nullptr;
+
+    auto winSize = Director::getInstance()->getWinSize();
+    const char* files[] = {
+        "Particles/BoilingFoam.plist", "Particles/Comet.plist", "Particles/Galaxy.plist",
+        "Particles/LavaFlow.plist", "Particles/SpookyPeas.plist", "Particles/Spiral.plist",
+        // twice, the second request waits for the first one
+        "Particles/Galaxy.plist", "Particles/NotFound.plist"
+    };
+    const int count = sizeof(files) / sizeof(files[0]);
+
+    // the template cache would skip the loading of the files created by the other tests
+    ParticleSystem::purgeCachedData();
+
+    for (int i = 0; i < count; ++i)
+    {
+        Vec2 position(winSize.width * (i % 4 + 0.5f) / 4, winSize.height * (i < 4 ? 0.65f : 0.3f));
+        this->retain();
+        ParticleSystemQuad::createAsync(files[i], [this, position](ParticleSystemQuad* system) {
+            if (system && isRunning())
+            {
+                system->setPosition(position);
+                addChild(system);
+            }
+            this->release();
+        });
+    }
+}
+
+std::string ParticleAsyncCreateTest::title() const
+{
+    return "Systems created asynchronously";
+}
+
+std::string ParticleAsyncCreateTest::subtitle() const
+{
+    return "The plist files and their textures are decoded on worker threads";
+}
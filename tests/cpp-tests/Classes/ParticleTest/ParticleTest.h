@@ -398,4 +398,44 @@ public:
     virtual std::string subtitle() const override;
 };
 
+class ParticleGPUTest : public ParticleDemo
+{
+public:
+    CREATE_FUNC(ParticleGPUTest);
+    virtual void onEnter() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+};
+
+class ParticlePoolTest : public ParticleDemo
+{
+public:
+    CREATE_FUNC(ParticlePoolTest);
+    virtual void onEnter() override;
+    virtual void onExit() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+
+    void spawnExplosion(float dt);
+};
+
+class ParticleAsyncCreateTest : public ParticleDemo
+{
+public:
+    CREATE_FUNC(ParticleAsyncCreateTest);
+    virtual void onEnter() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+};
+
+class ParticleParallelUpdate : public ParticleDemo
+{
+public:
+    CREATE_FUNC(ParticleParallelUpdate);
+    virtual void onEnter() override;
+    virtual void onExit() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+};
+
 #endif
@@ -28,6 +28,9 @@ PhysicsTests::PhysicsTests()
     ADD_TEST_CASE(PhysicsTransformTest);
     ADD_TEST_CASE(PhysicsIssue9959);
     ADD_TEST_CASE(PhysicsIssue15932);
+    ADD_TEST_CASE(PhysicsContactBufferTest);
+    ADD_TEST_CASE(PhysicsBroadphaseTest);
+    ADD_TEST_CASE(PhysicsDeterministicTest);
 }
 
 namespace
@@ -478,7 +481,7 @@ void PhysicsDemoRayCast::onEnter()
 
 void PhysicsDemoRayCast::changeModeCallback(Ref* sender)
 {
-    _mode = (_mode + 1) % 3;
+    _mode = (_mode + 1) % 4;
     
     switch (_mode)
     {
@@ -491,6 +494,9 @@ void PhysicsDemoRayCast::changeModeCallback(Ref* sender)
         case 2:
             ((MenuItemFont*)sender)->setString("Change Mode(multiple)");
             break;
+        case 3:
+            ((MenuItemFont*)sender)->setString("Change Mode(batch)");
+            break;
             
         default:
             break;
@@ -585,6 +591,34 @@ void PhysicsDemoRayCast::update(float /*delta*/)
             
             break;
         }
+        case 3:
+        {
+#define BATCH_RAYCAST_NUM 64
+            PhysicsRayCastQuery rays[BATCH_RAYCAST_NUM];
+            PhysicsRayCastInfo hits[BATCH_RAYCAST_NUM];
+            for (int i = 0; i < BATCH_RAYCAST_NUM; ++i)
+            {
+                float angle = _angle + 2.0f * (float)M_PI * i / BATCH_RAYCAST_NUM;
+                rays[i].start = point1;
+                rays[i].end = point1 + Vec2(L * cosf(angle), L * sinf(angle));
+                rays[i].categoryMask = UINT_MAX;
+            }
+            
+            _physicsWorld->rayCastFirst(rays, BATCH_RAYCAST_NUM, hits, true);
+            
+            for (int i = 0; i < BATCH_RAYCAST_NUM; ++i)
+            {
+                _node->drawSegment(point1, hits[i].contact, 1, STATIC_COLOR);
+                if (hits[i].shape)
+                {
+                    _node->drawDot(hits[i].contact, 2, Color4F(1.0f, 1.0f, 1.0f, 1.0f));
+                }
+            }
+            
+            addChild(_node);
+            
+            break;
+        }
             
         default:
             break;
@@ -1896,4 +1930,231 @@ std::string PhysicsIssue15932::subtitle() const
     return "addComponent()/removeComponent() should not crash";
 }
 
+void PhysicsContactBufferTest::onEnter()
+{
+    PhysicsDemo::onEnter();
+    
+    _physicsWorld->setContactBufferMask(PhysicsWorld::CONTACT_BUFFER_BEGIN | PhysicsWorld::CONTACT_BUFFER_SEPARATE);
+    
+    auto node = Node::create();
+    auto ground = PhysicsBody::createEdgeBox(VisibleRect::getVisibleRect().size);
+    ground->setContactTestBitmask(0xFFFFFFFF);
+    node->addComponent(ground);
+    node->setPosition(VisibleRect::center());
+    this->addChild(node);
+    
+    for (int i = 0; i < 20; i++)
+    {
+        for (int j = 0; j <= i; j++)
+        {
+            auto sp = addGrossiniAtPosition(VisibleRect::bottom() + Vec2((i / 2 - j) * 11, (20 - i) * 23 + 20), 0.2f);
+            sp->getPhysicsBody()->setContactTestBitmask(0xFFFFFFFF);
+        }
+    }
+    
+    _label = Label::createWithTTF("", "fonts/arial.ttf", 16);
+    _label->setPosition(VisibleRect::top() + Vec2(0, -80));
+    this->addChild(_label);
+    
+    scheduleUpdate();
+}
+
+void PhysicsContactBufferTest::update(float /*delta*/)
+{
+    int begins = 0;
+    int separates = 0;
+    for (auto& record : _physicsWorld->getBufferedContacts())
+    {
+        if (record.eventCode == PhysicsContact::EventCode::BEGIN)
+        {
+            ++begins;
+        }
+        else if (record.eventCode == PhysicsContact::EventCode::SEPARATE)
+        {
+            ++separates;
+        }
+    }
+    
+    char text[64];
+    snprintf(text, sizeof(text), "begin: %d separate: %d", begins, separates);
+    _label->setString(text);
+}
+
+std::string PhysicsContactBufferTest::title() const
+{
+    return "Contact Buffer";
+}
+
+std::string PhysicsContactBufferTest::subtitle() const
+{
+    return "The contacts of the last update are read in bulk";
+}
+
+void PhysicsBroadphaseTest::onEnter()
+{
+    PhysicsDemo::onEnter();
+
+    _physicsWorld->setStepStatisticsEnabled(true);
+    _physicsWorld->setSleepTimeThreshold(0.5f);
+
+    auto node = Node::create();
+    node->addComponent(PhysicsBody::createEdgeBox(VisibleRect::getVisibleRect().size));
+    node->setPosition(VisibleRect::center());
+    this->addChild(node);
+
+    // a thousand balls of the same size, the case of the spatial hash
+    for (int i = 0; i < 1000; ++i)
+    {
+        auto ball = makeBall(VisibleRect::center() + Vec2(CCRANDOM_MINUS1_1() * 200, CCRANDOM_MINUS1_1() * 120), 3);
+        this->addChild(ball);
+    }
+
+    MenuItemFont::setFontSize(18);
+    auto item = MenuItemFont::create("Use the spatial hash", [this](Ref* sender) {
+        auto item = static_cast<MenuItemFont*>(sender);
+        if (_physicsWorld->getSpatialIndex() == PhysicsWorld::SpatialIndex::BB_TREE)
+        {
+            // cells about the size of the balls, the static walls stay in their tree
+            _physicsWorld->setSpatialHashCells(10, 10000);
+            _physicsWorld->setSpatialIndex(PhysicsWorld::SpatialIndex::SPATIAL_HASH);
+            item->setString("Use the tree");
+        }
+        else
+        {
+            _physicsWorld->setSpatialIndex(PhysicsWorld::SpatialIndex::BB_TREE);
+            item->setString("Use the spatial hash");
+        }
+    });
+    auto menu = Menu::create(item, nullptr);
+    menu->setPosition(Vec2(VisibleRect::left().x + 120, VisibleRect::top().y - 60));
+    this->addChild(menu);
+
+    _label = Label::createWithTTF("", "fonts/arial.ttf", 14);
+    _label->setPosition(VisibleRect::top() + Vec2(0, -90));
+    this->addChild(_label);
+
+    scheduleUpdate();
+}
+
+void PhysicsBroadphaseTest::update(float /*delta*/)
+{
+    auto& statistics = _physicsWorld->getStepStatistics();
+    if (statistics.steps == 0)
+    {
+        return;
+    }
+
+    char text[128];
+    snprintf(text, sizeof(text), "pairs: %d colliding: %d contacts: %d\ncollisions: %.2f ms solver: %.2f ms",
+             statistics.pairsTested / statistics.steps, statistics.collidingPairs / statistics.steps,
+             statistics.contacts / statistics.steps, statistics.collisionTime * 1000 / statistics.steps,
+             statistics.solverTime * 1000 / statistics.steps);
+    _label->setString(text);
+}
+
+std::string PhysicsBroadphaseTest::title() const
+{
+    return "Broadphase";
+}
+
+std::string PhysicsBroadphaseTest::subtitle() const
+{
+    return "The work of a step with a tree or a spatial hash";
+}
+
+PhysicsDeterministicTest::PhysicsDeterministicTest()
+: _replayScene(nullptr)
+, _steps(0)
+, _diverged(false)
+, _label(nullptr)
+{
+}
+
+PhysicsDeterministicTest::~PhysicsDeterministicTest()
+{
+    CC_SAFE_RELEASE(_replayScene);
+}
+
+void PhysicsDeterministicTest::addBodies(Node* parent, std::vector<PhysicsBody*>& bodies)
+{
+    auto node = Node::create();
+    node->setPosition(VisibleRect::center());
+    parent->addChild(node);
+    node->addComponent(PhysicsBody::createEdgeBox(VisibleRect::getVisibleRect().size));
+
+    // the same pile of boxes in both worlds, the nodes are added before their bodies so that
+    // the bodies join the world of the scene even if it isn't running
+    for (int y = 0; y < 8; ++y)
+    {
+        for (int x = 0; x < 6; ++x)
+        {
+            auto box = Node::create();
+            box->setPosition(VisibleRect::center() + Vec2(x * 34 - 85 + (y % 2) * 9, y * 30 - 60));
+            box->setRotation(x * 7 + y * 11);
+            parent->addChild(box);
+
+            auto body = PhysicsBody::createBox(Size(24, 24));
+            box->addComponent(body);
+            bodies.push_back(body);
+        }
+    }
+}
+
+void PhysicsDeterministicTest::onEnter()
+{
+    PhysicsDemo::onEnter();
+
+    _replayScene = Scene::createWithPhysics();
+    _replayScene->retain();
+
+    for (auto world : { _physicsWorld, _replayScene->getPhysicsWorld() })
+    {
+        world->setDeterministic(true);
+        world->setAutoStep(false);
+    }
+    toggleDebug();
+
+    addBodies(this, _bodies);
+    addBodies(_replayScene, _replayBodies);
+
+    _label = Label::createWithTTF("", "fonts/arial.ttf", 14);
+    _label->setPosition(VisibleRect::top() + Vec2(0, -90));
+    this->addChild(_label);
+
+    scheduleUpdate();
+}
+
+void PhysicsDeterministicTest::update(float /*delta*/)
+{
+    // both worlds are stepped the same way on this thread, whatever the frame rate
+    const float dt = 1.0f / 60;
+    _physicsWorld->step(dt);
+    _replayScene->getPhysicsWorld()->step(dt);
+    ++_steps;
+
+    for (size_t i = 0; i < _bodies.size() && !_diverged; ++i)
+    {
+        if (_bodies[i]->getPosition() != _replayBodies[i]->getPosition()
+            || _bodies[i]->getRotation() != _replayBodies[i]->getRotation())
+        {
+            _diverged = true;
+            CCLOG("PhysicsDeterministicTest: the worlds diverged at step %d", _steps);
+        }
+    }
+
+    char text[64];
+    snprintf(text, sizeof(text), _diverged ? "the worlds diverged" : "%d identical steps", _steps);
+    _label->setString(text);
+}
+
+std::string PhysicsDeterministicTest::title() const
+{
+    return "Deterministic";
+}
+
+std::string PhysicsDeterministicTest::subtitle() const
+{
+    return "A hidden world steps the same pile, the bodies must match";
+}
+
 #endif
@@ -277,4 +277,56 @@ public:
     virtual std::string subtitle() const override;
 };
 
+class PhysicsContactBufferTest : public PhysicsDemo
+{
+public:
+    CREATE_FUNC(PhysicsContactBufferTest);
+
+    void onEnter() override;
+    void update(float delta) override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+
+private:
+    cocos2d::Label* _label;
+};
+
+class PhysicsBroadphaseTest : public PhysicsDemo
+{
+public:
+    CREATE_FUNC(PhysicsBroadphaseTest);
+
+    void onEnter() override;
+    void update(float delta) override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+
+private:
+    cocos2d::Label* _label;
+};
+
+class PhysicsDeterministicTest : public PhysicsDemo
+{
+public:
+    CREATE_FUNC(PhysicsDeterministicTest);
+
+    PhysicsDeterministicTest();
+    virtual ~PhysicsDeterministicTest();
+    void onEnter() override;
+    void update(float delta) override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+
+private:
+    void addBodies(cocos2d::Node* parent, std::vector<cocos2d::PhysicsBody*>& bodies);
+
+    // a scene that isn't shown, its world is stepped along with the one of the test
+    cocos2d::Scene* _replayScene;
+    std::vector<cocos2d::PhysicsBody*> _bodies;
+    std::vector<cocos2d::PhysicsBody*> _replayBodies;
+    int _steps;
+    bool _diverged;
+    cocos2d::Label* _label;
+};
+
 #endif // #if CC_USE_PHYSICS
\ No newline at end of file
@@ -14,6 +14,7 @@ RenderTextureTests::RenderTextureTests()
     ADD_TEST_CASE(RenderTexturePartTest);
     ADD_TEST_CASE(Issue16113Test);
     ADD_TEST_CASE(RenderTextureWithSprite3DIssue16894);
+    ADD_TEST_CASE(RenderTexturePoolTest);
 };
 
 /**
@@ -463,7 +464,7 @@ void RenderTextureTestDepthStencil::draw(Renderer *renderer, const Mat4 &transfo
 
 void RenderTextureTestDepthStencil::onBeforeClear()
 {
-    glStencilMask(0xFF);
+    GL::stencilMask(0xFF);
 
     // Since cocos2d-x v3.7, users should avoid calling GL directly because it will break the internal GL state
     // But if users must call GL directly, they should update the state manually,
@@ -473,9 +474,9 @@ void RenderTextureTestDepthStencil::onBeforeClear()
 void RenderTextureTestDepthStencil::onBeforeStencil()
 {
     //! mark sprite quad into stencil buffer
-    glEnable(GL_STENCIL_TEST);
-    glStencilFunc(GL_NEVER, 1, 0xFF);
-    glStencilOp(GL_REPLACE, GL_REPLACE, GL_REPLACE);
+    GL::enable(GL_STENCIL_TEST);
+    GL::stencilFunc(GL_NEVER, 1, 0xFF);
+    GL::stencilOp(GL_REPLACE, GL_REPLACE, GL_REPLACE);
 
     // Since cocos2d-x v3.7, users should avoid calling GL directly because it will break the internal GL state
     // But if users must call GL directly, they should update the state manually,
@@ -486,7 +487,7 @@ void RenderTextureTestDepthStencil::onBeforeStencil()
 
 void RenderTextureTestDepthStencil::onBeforeDraw()
 {
-    glStencilFunc(GL_NOTEQUAL, 1, 0xFF);
+    GL::stencilFunc(GL_NOTEQUAL, 1, 0xFF);
 
     // Since cocos2d-x v3.7, users should avoid calling GL directly because it will break the internal GL state
     // But if users must call GL directly, they should update the state manually,
@@ -495,7 +496,7 @@ void RenderTextureTestDepthStencil::onBeforeDraw()
 
 void RenderTextureTestDepthStencil::onAfterDraw()
 {
-    glDisable(GL_STENCIL_TEST);
+    GL::disable(GL_STENCIL_TEST);
 
     // Since cocos2d-x v3.7, users should avoid calling GL directly because it will break the internal GL state
     // But if users must call GL directly, they should update the state manually,
@@ -826,3 +827,62 @@ std::string RenderTextureWithSprite3DIssue16894::subtitle() const
 {
     return "3 ships, 1st & 3rd are the same";
 }
+
+//
+// RenderTexturePoolTest
+//
+RenderTexturePoolTest::RenderTexturePoolTest()
+: _renderTexture(nullptr)
+, _created(0)
+{
+    auto s = Director::getInstance()->getWinSize();
+
+    _sprite = Sprite::create("Images/grossini.png");
+    _sprite->retain();
+    _sprite->setPosition(s.width / 4, s.height / 4);
+
+    _label = Label::createWithTTF("", "fonts/arial.ttf", 12);
+    _label->setPosition(s.width / 2, 40);
+    addChild(_label, 1);
+
+    scheduleUpdate();
+}
+
+RenderTexturePoolTest::~RenderTexturePoolTest()
+{
+    _sprite->release();
+}
+
+void RenderTexturePoolTest::update(float dt)
+{
+    auto s = Director::getInstance()->getWinSize();
+    _sprite->setRotation(_sprite->getRotation() + dt * 180);
+
+    // a new render texture each frame, the one of the previous frame goes back to the pool
+    if (_renderTexture)
+    {
+        removeChild(_renderTexture);
+    }
+
+    _renderTexture = RenderTexture::create(s.width / 2, s.height / 2, Texture2D::PixelFormat::RGBA8888, GL_DEPTH24_STENCIL8);
+    _renderTexture->setPosition(s.width / 2, s.height / 2);
+    addChild(_renderTexture);
+    ++_created;
+
+    _renderTexture->beginWithClear(CCRANDOM_0_1() * 0.2f, CCRANDOM_0_1() * 0.2f, 0.5f, 1.0f, 1.0f, 0);
+    _sprite->visit();
+    _renderTexture->end();
+
+    auto pool = RenderTargetPool::getInstance();
+    _label->setString(StringUtils::format("%d render textures created, %u KB pooled", _created, (unsigned int)(pool->getSize() / 1024)));
+}
+
+std::string RenderTexturePoolTest::title() const
+{
+    return "Render target pool";
+}
+
+std::string RenderTexturePoolTest::subtitle() const
+{
+    return "A render texture is created each frame, the GL objects are reused";
+}
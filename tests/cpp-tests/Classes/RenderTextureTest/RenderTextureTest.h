@@ -174,4 +174,23 @@ private:
     cocos2d::RenderTexture* _renderTexWithBuffer;
 };
 
+class RenderTexturePoolTest : public RenderTextureTest
+{
+public:
+    CREATE_FUNC(RenderTexturePoolTest);
+    RenderTexturePoolTest();
+    virtual ~RenderTexturePoolTest();
+
+    virtual void update(float dt) override;
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+
+private:
+    cocos2d::RenderTexture* _renderTexture;
+    cocos2d::Sprite* _sprite;
+    cocos2d::Label* _label;
+    int _created;
+};
+
 #endif
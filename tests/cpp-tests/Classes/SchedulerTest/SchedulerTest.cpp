@@ -2,6 +2,8 @@
 #include "../testResource.h"
 #include "ui/UIText.h"
 
+#include <chrono>
+
 USING_NS_CC;
 USING_NS_CC_EXT;
 using namespace cocos2d::ui;
@@ -36,6 +38,11 @@ SchedulerTests::SchedulerTests()
     ADD_TEST_CASE(SchedulerIssue17149);
     ADD_TEST_CASE(SchedulerRemoveEntryWhileUpdate);
     ADD_TEST_CASE(SchedulerRemoveSelectorDuringCall);
+    ADD_TEST_CASE(SchedulerManyTimers);
+    ADD_TEST_CASE(SchedulerPerformFunctionBudget);
+    ADD_TEST_CASE(SchedulerPipelinedUpdate);
+    ADD_TEST_CASE(SchedulerTimeSlicedQueue);
+    ADD_TEST_CASE(SchedulerFixedUpdate);
 };
 
 //------------------------------------------------------------------
@@ -1474,3 +1481,391 @@ void SchedulerRemoveSelectorDuringCall::callback( float )
     scheduler->unschedule
       (SEL_SCHEDULE(&SchedulerRemoveSelectorDuringCall::callback), this);
 }
+
+//------------------------------------------------------------------
+//
+// SchedulerManyTimers
+//
+//------------------------------------------------------------------
+
+SchedulerManyTimers::SchedulerManyTimers()
+: _timerScheduler(nullptr)
+, _label(nullptr)
+, _triggered(0)
+, _updateTime(0.0)
+, _frames(0)
+{
+}
+
+SchedulerManyTimers::~SchedulerManyTimers()
+{
+    CC_SAFE_RELEASE(_timerScheduler);
+}
+
+std::string SchedulerManyTimers::title() const
+{
+    return "Many interval timers";
+}
+
+std::string SchedulerManyTimers::subtitle() const
+{
+    return "10000 timers on a custom scheduler, update cost must stay low";
+}
+
+void SchedulerManyTimers::onEnter()
+{
+    SchedulerTestLayer::onEnter();
+
+    auto s = Director::getInstance()->getWinSize();
+    _label = Label::createWithTTF("", "fonts/arial.ttf", 20);
+    _label->setPosition(Vec2(s.width / 2, s.height / 2));
+    addChild(_label);
+
+    // the timer wheel only visits the timers that are due, the others cost nothing per frame
+    const int count = 10000;
+    _targets.resize(count);
+    _timerScheduler = new (std::nothrow) Scheduler();
+    for (int i = 0; i < count; ++i)
+    {
+        const float interval = 0.5f + (i % 90) * 0.05f;
+        _timerScheduler->schedule([this](float) {
+            ++_triggered;
+        }, &_targets[i], interval, false, "tick");
+    }
+
+    scheduleUpdate();
+}
+
+void SchedulerManyTimers::update(float dt)
+{
+    auto start = std::chrono::steady_clock::now();
+    _timerScheduler->update(dt);
+    _updateTime += std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+
+    if (++_frames == 60)
+    {
+        _label->setString(StringUtils::format("triggered: %u\nScheduler::update: %.3f ms", _triggered, _updateTime / _frames));
+        _updateTime = 0.0;
+        _frames = 0;
+    }
+}
+
+//------------------------------------------------------------------
+//
+// SchedulerPerformFunctionBudget
+//
+//------------------------------------------------------------------
+
+SchedulerPerformFunctionBudget::SchedulerPerformFunctionBudget()
+: _label(nullptr)
+, _performed(0)
+, _urgentPerformed(0)
+, _frames(0)
+{
+}
+
+std::string SchedulerPerformFunctionBudget::title() const
+{
+    return "performFunctionInCocosThread budget";
+}
+
+std::string SchedulerPerformFunctionBudget::subtitle() const
+{
+    return "500 slow functions spread over frames, urgent ones first.\nThe sprite must keep moving smoothly";
+}
+
+void SchedulerPerformFunctionBudget::onEnter()
+{
+    SchedulerTestLayer::onEnter();
+
+    auto s = Director::getInstance()->getWinSize();
+    _label = Label::createWithTTF("", "fonts/arial.ttf", 20);
+    _label->setPosition(Vec2(s.width / 2, s.height / 2 + 50));
+    addChild(_label);
+
+    auto sprite = Sprite::create("Images/grossini.png");
+    sprite->setPosition(Vec2(s.width / 4, s.height / 2 - 50));
+    addChild(sprite);
+    sprite->runAction(RepeatForever::create(Sequence::create(MoveBy::create(1, Vec2(s.width / 2, 0)), MoveBy::create(1, Vec2(-s.width / 2, 0)), nullptr)));
+
+    auto scheduler = Director::getInstance()->getScheduler();
+    scheduler->setPerformFunctionBudget(0.004f);
+
+    _producer = std::thread([this, scheduler]() {
+        for (int i = 0; i < 500; ++i)
+        {
+            const bool urgent = (i % 5 == 0);
+            scheduler->performFunctionInCocosThread([this, urgent]() {
+                // pretend to upload a texture or parse a response
+                std::this_thread::sleep_for(std::chrono::microseconds(500));
+                ++_performed;
+                if (urgent)
+                {
+                    ++_urgentPerformed;
+                }
+            }, urgent ? -1 : 0);
+        }
+    });
+
+    scheduleUpdate();
+}
+
+void SchedulerPerformFunctionBudget::onExit()
+{
+    _producer.join();
+
+    auto scheduler = Director::getInstance()->getScheduler();
+    scheduler->removeAllFunctionsToBePerformedInCocosThread();
+    scheduler->setPerformFunctionBudget(0.0f);
+
+    SchedulerTestLayer::onExit();
+}
+
+void SchedulerPerformFunctionBudget::update(float dt)
+{
+    if (_performed < 500)
+    {
+        ++_frames;
+    }
+    _label->setString(StringUtils::format("performed: %d / 500 (urgent: %d / 100)\nframes: %d", _performed, _urgentPerformed, _frames));
+}
+
+//------------------------------------------------------------------
+//
+// SchedulerPipelinedUpdate
+//
+//------------------------------------------------------------------
+
+SchedulerPipelinedUpdate::SchedulerPipelinedUpdate()
+: _label(nullptr)
+, _simulatedFrames(0)
+{
+}
+
+std::string SchedulerPipelinedUpdate::title() const
+{
+    return "Pipelined update";
+}
+
+std::string SchedulerPipelinedUpdate::subtitle() const
+{
+    return "The bounces are simulated on a worker\nwhile the frame is rendered";
+}
+
+void SchedulerPipelinedUpdate::onEnter()
+{
+    SchedulerTestLayer::onEnter();
+
+    auto s = Director::getInstance()->getWinSize();
+    _label = Label::createWithTTF("", "fonts/arial.ttf", 20);
+    _label->setPosition(Vec2(s.width / 2, s.height - 80));
+    addChild(_label);
+
+    for (int i = 0; i < 50; ++i)
+    {
+        auto sprite = Sprite::create("Images/ball.png");
+        addChild(sprite);
+        _sprites.push_back(sprite);
+        _positions.push_back(Vec2(CCRANDOM_0_1() * s.width, CCRANDOM_0_1() * s.height));
+        _velocities.push_back(Vec2(CCRANDOM_MINUS1_1() * 200, CCRANDOM_MINUS1_1() * 200));
+    }
+
+    // only the vectors above are touched on the worker, never the sprites
+    Director::getInstance()->schedulePipelinedUpdate([this, s](float dt) {
+        _simulationThread = std::this_thread::get_id();
+        for (size_t i = 0; i < _positions.size(); ++i)
+        {
+            auto& position = _positions[i];
+            auto& velocity = _velocities[i];
+            position += velocity * dt;
+            if (position.x < 0 || position.x > s.width)
+                velocity.x = -velocity.x;
+            if (position.y < 0 || position.y > s.height)
+                velocity.y = -velocity.y;
+        }
+        ++_simulatedFrames;
+    }, "SchedulerPipelinedUpdate");
+
+    scheduleUpdate();
+}
+
+void SchedulerPipelinedUpdate::onExit()
+{
+    Director::getInstance()->unschedulePipelinedUpdate("SchedulerPipelinedUpdate");
+
+    SchedulerTestLayer::onExit();
+}
+
+void SchedulerPipelinedUpdate::update(float dt)
+{
+    // the pipelined update of the last frame has finished
+    for (size_t i = 0; i < _sprites.size(); ++i)
+    {
+        _sprites[i]->setPosition(_positions[i]);
+    }
+
+    bool onWorker = _simulatedFrames > 0 && _simulationThread != Director::getInstance()->getCocos2dThreadId();
+    _label->setString(StringUtils::format("simulated frames: %d, on a worker: %s", _simulatedFrames, onWorker ? "yes" : "no"));
+}
+
+// SchedulerTimeSlicedQueue
+
+SchedulerTimeSlicedQueue::SchedulerTimeSlicedQueue()
+: _label(nullptr)
+, _buildTask(0)
+, _cancelledTask(0)
+{
+}
+
+std::string SchedulerTimeSlicedQueue::title() const
+{
+    return "Time sliced construction";
+}
+
+std::string SchedulerTimeSlicedQueue::subtitle() const
+{
+    return "2000 sprites are created 2ms per frame\nafter a texture and a job, a second task is cancelled";
+}
+
+void SchedulerTimeSlicedQueue::onEnter()
+{
+    SchedulerTestLayer::onEnter();
+
+    auto s = Director::getInstance()->getWinSize();
+    _label = Label::createWithTTF("", "fonts/arial.ttf", 20);
+    _label->setPosition(Vec2(s.width / 2, s.height - 80));
+    addChild(_label, 1);
+
+    auto queue = TimeSlicedQueue::getInstance();
+    auto container = Node::create();
+    addChild(container);
+
+    // 20 sprites per step, the steps run until 2ms of the frame are spent
+    int created = 0;
+    _buildTask = queue->addTask([container, created, s](float& progress) mutable {
+        for (int i = 0; i < 20; ++i, ++created)
+        {
+            auto sprite = Sprite::create("Images/grossini_dance_atlas.png", Rect(0, 0, 85, 121));
+            sprite->setPosition(Vec2(CCRANDOM_0_1() * s.width, CCRANDOM_0_1() * s.height));
+            sprite->setScale(0.25f);
+            container->addChild(sprite);
+        }
+        progress = created / 2000.0f;
+        return created >= 2000;
+    }, 0, [this](bool done) {
+        _buildTask = 0;
+        _label->setString(done ? "built" : "cancelled");
+    });
+    queue->setTaskBudget(_buildTask, 0.002f);
+    queue->waitForTexture(_buildTask, "Images/grossini_dance_atlas.png");
+    queue->waitForJob(_buildTask, JobSystem::getInstance()->schedule([]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    }));
+    queue->setProgressCallback(_buildTask, [this](float progress) {
+        _label->setString(StringUtils::format("building: %d%%", (int)(progress * 100)));
+    });
+
+    // never runs, a lower priority task is cancelled while waiting
+    std::vector<std::function<void()>> steps(10, []() {
+        CCASSERT(false, "the cancelled task should not run");
+    });
+    _cancelledTask = queue->addTask(steps, 1, [](bool done) {
+        CCASSERT(!done, "the task should be cancelled");
+    });
+    queue->waitForJob(_cancelledTask, JobSystem::getInstance()->schedule([]() {
+        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    }));
+    queue->cancel(_cancelledTask);
+}
+
+void SchedulerTimeSlicedQueue::onExit()
+{
+    // the tasks refer to the layer
+    TimeSlicedQueue::getInstance()->cancel(_buildTask);
+
+    SchedulerTestLayer::onExit();
+}
+
+// SchedulerFixedUpdate
+
+namespace
+{
+    // bounces between the sides of the screen, moved by the fixed updates only
+    class FixedUpdateSprite : public Sprite
+    {
+    public:
+        static FixedUpdateSprite* create(const std::string& filename)
+        {
+            auto sprite = new (std::nothrow) FixedUpdateSprite();
+            if (sprite && sprite->initWithFile(filename))
+            {
+                sprite->autorelease();
+                return sprite;
+            }
+            CC_SAFE_DELETE(sprite);
+            return nullptr;
+        }
+
+        virtual void fixedUpdate(float delta) override
+        {
+            auto width = Director::getInstance()->getWinSize().width;
+            auto x = getPositionX() + _speed * delta;
+            if (x < 40 || x > width - 40)
+            {
+                _speed = -_speed;
+                x = clampf(x, 40, width - 40);
+            }
+            setPositionX(x);
+        }
+
+    private:
+        float _speed = 400;
+    };
+}
+
+std::string SchedulerFixedUpdate::title() const
+{
+    return "Fixed timestep update";
+}
+
+std::string SchedulerFixedUpdate::subtitle() const
+{
+    return "10 steps per second, the top sprite is interpolated";
+}
+
+void SchedulerFixedUpdate::onEnter()
+{
+    SchedulerTestLayer::onEnter();
+
+    auto s = Director::getInstance()->getWinSize();
+    _label = Label::createWithTTF("", "fonts/arial.ttf", 20);
+    _label->setPosition(Vec2(s.width / 2, s.height - 80));
+    addChild(_label, 1);
+
+    _scheduler->setFixedTimestep(0.1f);
+
+    auto interpolated = FixedUpdateSprite::create("Images/grossini.png");
+    interpolated->setPosition(Vec2(40, s.height / 2 + 60));
+    interpolated->setFixedUpdateInterpolationEnabled(true);
+    interpolated->scheduleFixedUpdate();
+    addChild(interpolated);
+
+    auto stepped = FixedUpdateSprite::create("Images/grossini.png");
+    stepped->setPosition(Vec2(40, s.height / 2 - 60));
+    stepped->scheduleFixedUpdate();
+    addChild(stepped);
+
+    scheduleUpdate();
+}
+
+void SchedulerFixedUpdate::onExit()
+{
+    _scheduler->setFixedTimestep(1.0f / 60);
+
+    SchedulerTestLayer::onExit();
+}
+
+void SchedulerFixedUpdate::update(float /*dt*/)
+{
+    _label->setString(StringUtils::format("steps: %d alpha: %.2f", _scheduler->getFixedStepCount(), _scheduler->getFixedUpdateAlpha()));
+}
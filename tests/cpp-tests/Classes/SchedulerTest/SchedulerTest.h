@@ -5,6 +5,8 @@
 #include "extensions/cocos-ext.h"
 #include "../BaseTest.h"
 
+#include <thread>
+
 
 DEFINE_TEST_SUITE(SchedulerTests);
 
@@ -432,4 +434,99 @@ private:
     bool _scheduled;
 };
 
+class SchedulerManyTimers : public SchedulerTestLayer
+{
+public:
+    CREATE_FUNC(SchedulerManyTimers);
+    SchedulerManyTimers();
+    ~SchedulerManyTimers();
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual void onEnter() override;
+    virtual void update(float dt) override;
+
+private:
+    cocos2d::Scheduler* _timerScheduler;
+    std::vector<int> _targets;
+    cocos2d::Label* _label;
+    unsigned int _triggered;
+    double _updateTime;
+    unsigned int _frames;
+};
+
+class SchedulerPerformFunctionBudget : public SchedulerTestLayer
+{
+public:
+    CREATE_FUNC(SchedulerPerformFunctionBudget);
+    SchedulerPerformFunctionBudget();
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual void onEnter() override;
+    virtual void onExit() override;
+    virtual void update(float dt) override;
+
+private:
+    std::thread _producer;
+    cocos2d::Label* _label;
+    int _performed;
+    int _urgentPerformed;
+    int _frames;
+};
+
+class SchedulerPipelinedUpdate : public SchedulerTestLayer
+{
+public:
+    CREATE_FUNC(SchedulerPipelinedUpdate);
+    SchedulerPipelinedUpdate();
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual void onEnter() override;
+    virtual void onExit() override;
+    virtual void update(float dt) override;
+
+private:
+    // written by the pipelined update, read by update()
+    std::vector<cocos2d::Vec2> _positions;
+    std::vector<cocos2d::Vec2> _velocities;
+    std::vector<cocos2d::Sprite*> _sprites;
+    cocos2d::Label* _label;
+    std::thread::id _simulationThread;
+    int _simulatedFrames;
+};
+
+class SchedulerTimeSlicedQueue : public SchedulerTestLayer
+{
+public:
+    CREATE_FUNC(SchedulerTimeSlicedQueue);
+    SchedulerTimeSlicedQueue();
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual void onEnter() override;
+    virtual void onExit() override;
+
+private:
+    cocos2d::Label* _label;
+    cocos2d::TimeSlicedQueue::TaskId _buildTask;
+    cocos2d::TimeSlicedQueue::TaskId _cancelledTask;
+};
+
+class SchedulerFixedUpdate : public SchedulerTestLayer
+{
+public:
+    CREATE_FUNC(SchedulerFixedUpdate);
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual void onEnter() override;
+    virtual void onExit() override;
+    virtual void update(float dt) override;
+
+private:
+    cocos2d::Label* _label;
+};
+
 #endif
@@ -18,6 +18,7 @@ ShaderTests::ShaderTests()
     ADD_TEST_CASE(ShaderMonjori);
     ADD_TEST_CASE(ShaderGlow);
     ADD_TEST_CASE(ShaderMultiTexture);
+    ADD_TEST_CASE(ShaderProgramBinaryCache);
 }
 
 ///---------------------------------------
@@ -763,3 +764,69 @@ void ShaderMultiTexture::changeTexture(Ref*)
     auto programState = _sprite->getGLProgramState();
     programState->setUniformTexture("u_texture1", right->getTexture());
 }
+
+// ShaderProgramBinaryCache
+
+ShaderProgramBinaryCache::ShaderProgramBinaryCache()
+: _wasEnabled(false)
+{
+}
+
+std::string ShaderProgramBinaryCache::title() const
+{
+    return "Program binary cache";
+}
+
+std::string ShaderProgramBinaryCache::subtitle() const
+{
+    return "Link time of a custom program,\ncompiled first and then restored from its binary";
+}
+
+bool ShaderProgramBinaryCache::init()
+{
+    if (ShaderTestDemo::init())
+    {
+        auto s = Director::getInstance()->getWinSize();
+        auto cache = GLProgramCache::getInstance();
+        _wasEnabled = cache->isProgramBinaryCacheEnabled();
+        cache->setProgramBinaryCacheEnabled(true);
+
+        std::string text;
+        if (cache->isProgramBinaryCacheEnabled())
+        {
+            auto fragStr = FileUtils::getInstance()->getStringFromFile(FileUtils::getInstance()->fullPathForFilename("Shaders/example_HorizontalColor.fsh"));
+            cache->removeAllProgramBinaries();
+
+            double start = utils::gettime();
+            GLProgram::createWithByteArrays(ccPositionTextureColor_noMVP_vert, fragStr.c_str());
+            double compiled = utils::gettime();
+            auto p = GLProgram::createWithByteArrays(ccPositionTextureColor_noMVP_vert, fragStr.c_str());
+            double restored = utils::gettime();
+
+            text = StringUtils::format("compiled: %.2f ms\nrestored: %.2f ms", (compiled - start) * 1000, (restored - compiled) * 1000);
+
+            auto sprite = Sprite::create("Images/grossini.png");
+            sprite->setGLProgramState(GLProgramState::getOrCreateWithGLProgram(p));
+            sprite->setPosition(s.width / 2, s.height / 2);
+            addChild(sprite);
+        }
+        else
+        {
+            text = "Program binaries are not supported";
+        }
+
+        auto label = Label::createWithTTF(text, "fonts/arial.ttf", 16);
+        label->setPosition(s.width / 2, s.height / 4);
+        addChild(label);
+
+        return true;
+    }
+
+    return false;
+}
+
+void ShaderProgramBinaryCache::onExit()
+{
+    GLProgramCache::getInstance()->setProgramBinaryCacheEnabled(_wasEnabled);
+    ShaderTestDemo::onExit();
+}
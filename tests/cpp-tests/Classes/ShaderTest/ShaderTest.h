@@ -178,4 +178,19 @@ public:
     virtual bool init() override;
 };
 
+class ShaderProgramBinaryCache : public ShaderTestDemo
+{
+public:
+    CREATE_FUNC(ShaderProgramBinaryCache);
+    ShaderProgramBinaryCache();
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual bool init() override;
+    virtual void onExit() override;
+
+protected:
+    bool _wasEnabled;
+};
+
 #endif
@@ -47,6 +47,8 @@ SpineTests::SpineTests()
     ADD_TEST_CASE(RaptorExample);
     ADD_TEST_CASE(SpineboyExample);
     ADD_TEST_CASE(TankExample);
+    ADD_TEST_CASE(ParallelUpdateExample);
+    ADD_TEST_CASE(BakedAnimationExample);
 }
 
 SpineTestLayer::SpineTestLayer()
@@ -234,3 +236,68 @@ bool TankExample::init () {
     
     return true;
 }
+
+// ParallelUpdateExample
+
+bool ParallelUpdateExample::init () {
+    if (!SpineTestLayer::init()) return false;
+    
+    _title = "ParallelUpdateExample";
+    
+    int xMin = _contentSize.width * 0.10f, xMax = _contentSize.width * 0.90f;
+    int yMin = 0, yMax = _contentSize.height * 0.7f;
+    for (int i = 0; i < 50; i++) {
+        // Skeletons created from the same files share their skeleton data and atlas through the SkeletonDataCache.
+        SkeletonAnimation* skeletonNode = SkeletonAnimation::createWithJsonFile("spine/spineboy-ess.json", "spine/spineboy.atlas", 0.6f);
+        skeletonNode->setMix("walk", "jump", 0.2f);
+        skeletonNode->setMix("jump", "run", 0.2f);
+        
+        skeletonNode->setAnimation(0, "walk", true);
+        skeletonNode->addAnimation(0, "jump", false, 3);
+        skeletonNode->addAnimation(0, "run", true);
+        
+        skeletonNode->setPosition(Vec2(
+                                       RandomHelper::random_int(xMin, xMax),
+                                       RandomHelper::random_int(yMin, yMax)
+                                       ));
+        skeletonNode->setScale(0.8);
+        addChild(skeletonNode);
+    }
+    
+    return true;
+}
+
+void ParallelUpdateExample::onEnter () {
+    SpineTestLayer::onEnter();
+    SkeletonAnimation::setParallelUpdateEnabled(true);
+}
+
+void ParallelUpdateExample::onExit () {
+    SkeletonAnimation::setParallelUpdateEnabled(false);
+    SpineTestLayer::onExit();
+}
+
+// BakedAnimationExample
+
+bool BakedAnimationExample::init () {
+    if (!SpineTestLayer::init()) return false;
+    
+    _title = "BakedAnimationExample";
+    
+    int xMin = _contentSize.width * 0.10f, xMax = _contentSize.width * 0.90f;
+    int yMin = 0, yMax = _contentSize.height * 0.7f;
+    for (int i = 0; i < 100; i++) {
+        // The vertices of the animation are sampled by the first skeleton and shared by the others.
+        SkeletonAnimation* skeletonNode = SkeletonAnimation::createWithJsonFile("spine/spineboy-ess.json", "spine/spineboy.atlas", 0.6f);
+        skeletonNode->setBakedAnimation(i % 2 ? "walk" : "run", true);
+        
+        skeletonNode->setPosition(Vec2(
+                                       RandomHelper::random_int(xMin, xMax),
+                                       RandomHelper::random_int(yMin, yMax)
+                                       ));
+        skeletonNode->setScale(0.5);
+        addChild(skeletonNode);
+    }
+    
+    return true;
+}
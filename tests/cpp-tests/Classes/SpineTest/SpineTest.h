@@ -109,4 +109,24 @@ private:
     spine::SkeletonAnimation* skeletonNode;
 };
 
+class ParallelUpdateExample : public SpineTestLayer {
+public:
+    CREATE_FUNC(ParallelUpdateExample);
+    
+    virtual bool init ();
+    virtual void onEnter () override;
+    virtual void onExit () override;
+    
+    virtual std::string subtitle() const override { return "Skeletons updated in parallel, sharing their data"; }
+};
+
+class BakedAnimationExample : public SpineTestLayer {
+public:
+    CREATE_FUNC(BakedAnimationExample);
+    
+    virtual bool init ();
+    
+    virtual std::string subtitle() const override { return "Skeletons playing baked animations"; }
+};
+
 #endif // _EXAMPLELAYER_H_
@@ -28,10 +28,13 @@
 #include "2d/CCCameraBackgroundBrush.h"
 #include "3d/CCSprite3DMaterial.h"
 #include "3d/CCMotionStreak3D.h"
+#include "3d/CCBundle3D.h"
+#include "3d/CCRay.h"
 
 #include "extensions/Particle3D/PU/CCPUParticleSystem3D.h"
 
 #include <algorithm>
+#include <chrono>
 #include "../testResource.h"
 
 USING_NS_CC;
@@ -70,6 +73,18 @@ Sprite3DTests::Sprite3DTests()
     ADD_TEST_CASE(Sprite3DPropertyTest);
     ADD_TEST_CASE(Sprite3DNormalMappingTest);
     ADD_TEST_CASE(Issue16155Test);
+    ADD_TEST_CASE(Sprite3DInstancingTest);
+    ADD_TEST_CASE(Sprite3DSkinInstancingTest);
+    ADD_TEST_CASE(Animate3DParallelUpdateTest);
+    ADD_TEST_CASE(Sprite3DLODTest);
+    ADD_TEST_CASE(Sprite3DTextureStreamingTest);
+    ADD_TEST_CASE(Sprite3DSpatialIndexTest);
+    ADD_TEST_CASE(Sprite3DOcclusionCullingTest);
+    ADD_TEST_CASE(Sprite3DQuantizedVertexTest);
+    ADD_TEST_CASE(Sprite3DMeshOptimizerTest);
+    ADD_TEST_CASE(Sprite3DSkyboxAsyncTest);
+    ADD_TEST_CASE(Sprite3DOpaqueSortTest);
+    ADD_TEST_CASE(Sprite3DSharedMaterialTest);
 };
 
 //------------------------------------------------------------------
@@ -2725,3 +2740,696 @@ std::string Issue16155Test::subtitle() const
 {
     return "Should not leak texture. See console";
 }
+
+//
+// Sprite3DInstancingTest
+//
+Sprite3DInstancingTest::Sprite3DInstancingTest()
+{
+    auto s = Director::getInstance()->getWinSize();
+
+    // the ships of a row share the same mesh, texture, color and render states, so the renderer merges them
+    // into one instanced draw; the red rows and the rows without face culling are drawn apart
+    const int rows = 10;
+    const int cols = 20;
+    for (int i = 0; i < rows; ++i)
+    {
+        for (int j = 0; j < cols; ++j)
+        {
+            auto ship = Sprite3D::create("Sprite3DTest/boss1.obj");
+            ship->setInstancingEnabled(true);
+            ship->setScale(2);
+            ship->setTexture("Sprite3DTest/boss.png");
+            if (i % 3 == 1)
+                ship->setColor(Color3B::RED);
+            else if (i % 3 == 2)
+                ship->setCullFaceEnabled(false);
+            ship->setPosition(Vec2(s.width * (j + 0.5f) / cols, s.height * (i + 0.5f) / rows));
+            ship->setRotation3D(Vec3(90, 0, 0));
+            ship->runAction(RepeatForever::create(RotateBy::create(2 + (i + j) % 3, Vec3(0, 360, 0))));
+            addChild(ship);
+        }
+    }
+}
+
+std::string Sprite3DInstancingTest::title() const
+{
+    return "Sprite3D Instancing Test";
+}
+
+std::string Sprite3DInstancingTest::subtitle() const
+{
+    return Configuration::getInstance()->supportsInstancing() ? "200 ships, one instanced draw per color and culling" : "Instancing not supported, one draw per ship";
+}
+
+//
+// Sprite3DSkinInstancingTest
+//
+Sprite3DSkinInstancingTest::Sprite3DSkinInstancingTest()
+{
+    auto s = Director::getInstance()->getWinSize();
+
+    // each orc plays the animation at its own speed, their palettes are fetched from the bone texture
+    std::string fileName = "Sprite3DTest/orc.c3b";
+    auto animation = Animation3D::create(fileName);
+    const int rows = 5;
+    const int cols = 10;
+    for (int i = 0; i < rows; ++i)
+    {
+        for (int j = 0; j < cols; ++j)
+        {
+            auto orc = Sprite3D::create(fileName);
+            orc->setInstancingEnabled(true);
+            orc->setScale(2);
+            orc->setRotation3D(Vec3(0, 180, 0));
+            orc->setPosition(Vec2(s.width * (j + 0.5f) / cols, s.height * (i + 0.2f) / rows));
+            addChild(orc);
+
+            if (animation)
+            {
+                auto animate = Animate3D::create(animation);
+                animate->setSpeed(0.5f + CCRANDOM_0_1());
+                orc->runAction(RepeatForever::create(animate));
+            }
+        }
+    }
+}
+
+std::string Sprite3DSkinInstancingTest::title() const
+{
+    return "Sprite3D Skin Instancing Test";
+}
+
+std::string Sprite3DSkinInstancingTest::subtitle() const
+{
+    auto conf = Configuration::getInstance();
+    return conf->supportsInstancing() && conf->supportsBoneTexture() ? "50 animated orcs, skinned from a bone texture" : "Bone texture not supported, one draw per orc";
+}
+
+//
+// Sprite3DLODTest
+//
+Sprite3DLODTest::Sprite3DLODTest()
+{
+    auto s = Director::getInstance()->getWinSize();
+
+    // build a coarse level keeping one triangle out of four, a real model would ship its "_LOD1" sub meshes
+    MeshDatas meshDatas;
+    MaterialDatas materialDatas;
+    NodeDatas nodeDatas;
+    std::string fullPath = FileUtils::getInstance()->fullPathForFilename("Sprite3DTest/boss1.obj");
+    if (!Bundle3D::loadObj(meshDatas, materialDatas, nodeDatas, fullPath) || meshDatas.meshDatas.empty())
+        return;
+    const auto& indices = meshDatas.meshDatas[0]->subMeshIndices[0];
+    std::vector<unsigned short> coarseIndices;
+    for (size_t i = 0; i + 2 < indices.size(); i += 12)
+        coarseIndices.insert(coarseIndices.end(), indices.begin() + i, indices.begin() + i + 3);
+
+    const int count = 10;
+    for (int i = 0; i < count; ++i)
+    {
+        auto ship = Sprite3D::create("Sprite3DTest/boss1.obj");
+        ship->setScale(3);
+        ship->setTexture("Sprite3DTest/boss.png");
+        ship->setPosition3D(Vec3(s.width * (i + 0.5f) / count, s.height / 2, 0));
+        ship->setRotation3D(Vec3(90, 0, 0));
+        ship->runAction(RepeatForever::create(Sequence::create(MoveBy::create(2 + i % 3, Vec3(0, 0, -1500)),
+                                                               MoveBy::create(2 + i % 3, Vec3(0, 0, 1500)), nullptr)));
+        addChild(ship);
+
+        auto mesh = ship->getMesh();
+        auto indexData = mesh->getMeshIndexData();
+        auto indexBuffer = IndexBuffer::create(IndexBuffer::IndexType::INDEX_TYPE_SHORT_16, (int)coarseIndices.size());
+        indexBuffer->updateIndices(coarseIndices.data(), (int)coarseIndices.size(), 0);
+        mesh->addLODLevel(MeshIndexData::create(indexData->getId() + "_LOD1", const_cast<MeshVertexData*>(indexData->getMeshVertexData()), indexBuffer, indexData->getAABB()), 60);
+    }
+}
+
+std::string Sprite3DLODTest::title() const
+{
+    return "Sprite3D LOD Test";
+}
+
+std::string Sprite3DLODTest::subtitle() const
+{
+    return "Ships smaller than 60 pixels draw a quarter of their triangles";
+}
+
+//
+// Animate3DParallelUpdateTest
+//
+Animate3DParallelUpdateTest::Animate3DParallelUpdateTest()
+{
+    auto s = Director::getInstance()->getWinSize();
+
+    std::string fileName = "Sprite3DTest/orc.c3b";
+    auto animation = Animation3D::create(fileName);
+    const int rows = 8;
+    const int cols = 16;
+    for (int i = 0; i < rows; ++i)
+    {
+        for (int j = 0; j < cols; ++j)
+        {
+            auto orc = Sprite3D::create(fileName);
+            orc->setScale(1.5f);
+            orc->setRotation3D(Vec3(0, 180, 0));
+            orc->setPosition(Vec2(s.width * (j + 0.5f) / cols, s.height * (i + 0.2f) / rows));
+            addChild(orc);
+
+            if (animation)
+            {
+                auto animate = Animate3D::create(animation);
+                animate->setSpeed(0.5f + CCRANDOM_0_1());
+                orc->runAction(RepeatForever::create(animate));
+            }
+        }
+    }
+}
+
+void Animate3DParallelUpdateTest::onEnter()
+{
+    Sprite3DTestDemo::onEnter();
+    Animate3D::setParallelUpdateEnabled(true);
+}
+
+void Animate3DParallelUpdateTest::onExit()
+{
+    Animate3D::setParallelUpdateEnabled(false);
+    Sprite3DTestDemo::onExit();
+}
+
+std::string Animate3DParallelUpdateTest::title() const
+{
+    return "Animate3D Parallel Update Test";
+}
+
+std::string Animate3DParallelUpdateTest::subtitle() const
+{
+    return "128 orcs animated on the worker threads";
+}
+
+//
+// Sprite3DTextureStreamingTest
+//
+Sprite3DTextureStreamingTest::Sprite3DTextureStreamingTest()
+{
+    auto s = Director::getInstance()->getWinSize();
+    auto textureCache = Director::getInstance()->getTextureCache();
+
+    // every mip of the texture has its own tint, the ship starts with the 16x16 one
+    _streamingEnabled = textureCache->isStreamingEnabled();
+    _streamingMinSize = textureCache->getStreamingMinSize();
+    textureCache->removeTextureForKey("Images/test_128x128_rgba8888_mipmaps.ktx2");
+    textureCache->setStreamingEnabled(true);
+    textureCache->setStreamingMinSize(16);
+
+    auto ship = Sprite3D::create("Sprite3DTest/boss1.obj");
+    ship->setScale(5);
+    ship->setTexture("Images/test_128x128_rgba8888_mipmaps.ktx2");
+    ship->setPosition(Vec2(s.width / 2, s.height / 2));
+    ship->setRotation3D(Vec3(90, 0, 0));
+    ship->runAction(RepeatForever::create(Sequence::create(MoveBy::create(3, Vec3(0, 0, -2000)), MoveBy::create(3, Vec3(0, 0, 2000)), nullptr)));
+    addChild(ship);
+    _texture = ship->getMesh()->getTexture();
+
+    _label = Label::createWithTTF("", "fonts/arial.ttf", 14);
+    _label->setPosition(Vec2(s.width / 2, 40));
+    addChild(_label);
+
+    scheduleUpdate();
+}
+
+Sprite3DTextureStreamingTest::~Sprite3DTextureStreamingTest()
+{
+    auto textureCache = Director::getInstance()->getTextureCache();
+    textureCache->setStreamingEnabled(_streamingEnabled);
+    textureCache->setStreamingMinSize(_streamingMinSize);
+}
+
+void Sprite3DTextureStreamingTest::update(float /*dt*/)
+{
+    auto textureCache = Director::getInstance()->getTextureCache();
+    int level = textureCache->getResidentMipLevel(_texture);
+    _label->setString(StringUtils::format("resident mip: %dx%d, texture memory: %u KB",
+                                          _texture->getPixelsWide() >> level, _texture->getPixelsHigh() >> level,
+                                          (unsigned int)(textureCache->getTotalTextureMemory() / 1024)));
+}
+
+std::string Sprite3DTextureStreamingTest::title() const
+{
+    return "Texture Streaming Test";
+}
+
+std::string Sprite3DTextureStreamingTest::subtitle() const
+{
+    return "The larger mips stream in as the ship comes closer";
+}
+
+//
+// Sprite3DSpatialIndexTest
+//
+Sprite3DSpatialIndexTest::Sprite3DSpatialIndexTest()
+{
+    auto s = Director::getInstance()->getWinSize();
+
+    // a field of static ships, most of them out of the screen
+    const int count = 40;
+    for (int i = 0; i < count; ++i)
+    {
+        for (int j = 0; j < count; ++j)
+        {
+            auto ship = Sprite3D::create("Sprite3DTest/boss1.obj");
+            ship->setScale(2);
+            ship->setTexture("Sprite3DTest/boss.png");
+            ship->setPosition3D(Vec3(s.width * (i - count / 2 + 0.5f) / 8, s.height / 2, -200.0f * j));
+            ship->setRotation3D(Vec3(90, 0, 0));
+            addChild(ship);
+        }
+    }
+
+    auto listener = EventListenerTouchAllAtOnce::create();
+    listener->onTouchesEnded = CC_CALLBACK_2(Sprite3DSpatialIndexTest::onTouchesEnded, this);
+    _eventDispatcher->addEventListenerWithSceneGraphPriority(listener, this);
+}
+
+void Sprite3DSpatialIndexTest::onEnter()
+{
+    Sprite3DTestDemo::onEnter();
+    getScene()->setSpatialIndex3DEnabled(true);
+}
+
+void Sprite3DSpatialIndexTest::onExit()
+{
+    getScene()->setSpatialIndex3DEnabled(false);
+    Sprite3DTestDemo::onExit();
+}
+
+void Sprite3DSpatialIndexTest::onTouchesEnded(const std::vector<Touch*>& touches, Event* event)
+{
+    auto index = getScene()->getSpatialIndex3D();
+    auto camera = getScene()->getDefaultCamera();
+    if (!index || touches.empty())
+        return;
+
+    auto location = touches[0]->getLocationInView();
+    Vec3 nearP = camera->unproject(Vec3(location.x, location.y, -1.0f));
+    Vec3 farP = camera->unproject(Vec3(location.x, location.y, 1.0f));
+    Vec3 direction = farP - nearP;
+    direction.normalize();
+
+    auto ship = index->rayCast(Ray(nearP, direction));
+    if (ship)
+        ship->setColor(ship->getColor() == Color3B::RED ? Color3B::WHITE : Color3B::RED);
+}
+
+std::string Sprite3DSpatialIndexTest::title() const
+{
+    return "Sprite3D Spatial Index Test";
+}
+
+std::string Sprite3DSpatialIndexTest::subtitle() const
+{
+    return "1600 ships culled with a bounding volume hierarchy, tap to pick one";
+}
+
+//
+// Sprite3DOcclusionCullingTest
+//
+Sprite3DOcclusionCullingTest::Sprite3DOcclusionCullingTest()
+{
+    auto s = Director::getInstance()->getWinSize();
+
+    // a wall in the middle of the screen, the ships fly behind it
+    auto wall = Sprite3D::create("Sprite3DTest/box.c3t");
+    wall->setTexture("Sprite3DTest/plane.png");
+    wall->setPosition3D(Vec3(s.width / 2, s.height / 2, 0));
+    wall->setScaleX(s.width * 0.6f);
+    wall->setScaleY(s.height * 0.6f);
+    wall->setScaleZ(10);
+    addChild(wall);
+
+    const int count = 10;
+    for (int i = 0; i < count; ++i)
+    {
+        for (int j = 0; j < count; ++j)
+        {
+            auto ship = Sprite3D::create("Sprite3DTest/boss1.obj");
+            ship->setScale(2);
+            ship->setTexture("Sprite3DTest/boss.png");
+            ship->setPosition3D(Vec3(s.width * (i + 0.5f) / count, s.height * (j + 0.5f) / count, -200));
+            ship->setRotation3D(Vec3(90, 0, 0));
+            ship->runAction(RepeatForever::create(Sequence::create(MoveBy::create(3, Vec3(s.width / 4, 0, 0)),
+                                                                   MoveBy::create(3, Vec3(-s.width / 4, 0, 0)), nullptr)));
+            addChild(ship);
+        }
+    }
+
+    _label = Label::createWithTTF("", "fonts/arial.ttf", 14);
+    _label->setPosition(Vec2(s.width / 2, 40));
+    addChild(_label);
+
+    scheduleUpdate();
+}
+
+void Sprite3DOcclusionCullingTest::onEnter()
+{
+    Sprite3DTestDemo::onEnter();
+    Director::getInstance()->getRenderer()->setOcclusionCullingEnabled(true);
+}
+
+void Sprite3DOcclusionCullingTest::onExit()
+{
+    Director::getInstance()->getRenderer()->setOcclusionCullingEnabled(false);
+    Sprite3DTestDemo::onExit();
+}
+
+void Sprite3DOcclusionCullingTest::update(float /*dt*/)
+{
+    auto renderer = Director::getInstance()->getRenderer();
+    if (renderer->isOcclusionCullingEnabled())
+        _label->setString(StringUtils::format("occluded ships: %d", renderer->getOccludedCount()));
+    else
+        _label->setString("Occlusion queries are not supported");
+}
+
+std::string Sprite3DOcclusionCullingTest::title() const
+{
+    return "Sprite3D Occlusion Culling Test";
+}
+
+std::string Sprite3DOcclusionCullingTest::subtitle() const
+{
+    return "The ships behind the wall are not drawn";
+}
+
+static const char* QUANTIZED_ORC_PATH = "Sprite3DTest/orc.c3b";
+
+Sprite3DQuantizedVertexTest::Sprite3DQuantizedVertexTest()
+{
+    auto s = Director::getInstance()->getWinSize();
+
+    addChild(DirectionLight::create(Vec3(-1.0f, -1.0f, -1.0f), Color3B::WHITE));
+    addChild(AmbientLight::create(Color3B(80, 80, 80)));
+
+    addOrc(Vec2(s.width / 3, s.height / 4), MeshVertexData::QUANTIZE_NONE);
+    addOrc(Vec2(s.width * 2 / 3, s.height / 4), MeshVertexData::QUANTIZE_ALL);
+}
+
+Sprite3D* Sprite3DQuantizedVertexTest::addOrc(const Vec2& position, int quantization)
+{
+    // the cached mesh data keeps the format it was created with
+    Sprite3DCache::getInstance()->removeSprite3DData(QUANTIZED_ORC_PATH);
+    int defaultQuantization = MeshVertexData::getDefaultQuantization();
+    MeshVertexData::setDefaultQuantization(quantization);
+    auto orc = Sprite3D::create(QUANTIZED_ORC_PATH);
+    MeshVertexData::setDefaultQuantization(defaultQuantization);
+
+    orc->setScale(5);
+    orc->setRotation3D(Vec3(0, 180, 0));
+    orc->setPosition(position);
+    orc->setLightMask(0xFFFFFFFF);
+    addChild(orc);
+
+    auto animation = Animation3D::create(QUANTIZED_ORC_PATH);
+    if (animation)
+        orc->runAction(RepeatForever::create(Animate3D::create(animation)));
+
+    int vertexSize = orc->getMeshCount() > 0 ? orc->getMeshByIndex(0)->getVertexSizeInBytes() : 0;
+    auto label = Label::createWithTTF(StringUtils::format("%s: %d bytes per vertex", quantization == MeshVertexData::QUANTIZE_NONE ? "floats" : "quantized", vertexSize), "fonts/arial.ttf", 14);
+    label->setPosition(position + Vec2(0, -20));
+    addChild(label);
+    return orc;
+}
+
+void Sprite3DQuantizedVertexTest::onExit()
+{
+    Sprite3DCache::getInstance()->removeSprite3DData(QUANTIZED_ORC_PATH);
+    Sprite3DTestDemo::onExit();
+}
+
+std::string Sprite3DQuantizedVertexTest::title() const
+{
+    return "Sprite3D Quantized Vertex Test";
+}
+
+std::string Sprite3DQuantizedVertexTest::subtitle() const
+{
+    return "The orc on the right has 16 bit positions, normals and uvs";
+}
+
+Sprite3DMeshOptimizerTest::Sprite3DMeshOptimizerTest()
+{
+    auto s = Director::getInstance()->getWinSize();
+
+    auto ship = Sprite3D::create("Sprite3DTest/boss1.obj");
+    ship->setScale(4);
+    ship->setTexture("Sprite3DTest/boss.png");
+    ship->setPosition(Vec2(s.width / 2, s.height / 2));
+    ship->runAction(RepeatForever::create(RotateBy::create(4, Vec3(0, 360, 0))));
+    addChild(ship);
+
+    // the mesh as exported, then optimized
+    MeshDatas meshdatas;
+    MaterialDatas materialdatas;
+    NodeDatas nodedatas;
+    auto fullPath = FileUtils::getInstance()->fullPathForFilename("Sprite3DTest/boss1.obj");
+    int defaultOptimization = Bundle3D::getDefaultMeshOptimization();
+    Bundle3D::setDefaultMeshOptimization(MeshOptimizer::NONE);
+    bool loaded = Bundle3D::loadObj(meshdatas, materialdatas, nodedatas, fullPath);
+    Bundle3D::setDefaultMeshOptimization(defaultOptimization);
+    if (!loaded || meshdatas.meshDatas.empty())
+        return;
+
+    auto meshdata = meshdatas.meshDatas[0];
+    auto describe = [](const MeshData* data) {
+        float acmr = data->subMeshIndices.empty() ? 0 : MeshOptimizer::getACMR(data->subMeshIndices[0]);
+        return StringUtils::format("%d vertices, %.2f vertices per triangle", (int)(data->vertex.size() * 4 / data->getPerVertexSize()), acmr);
+    };
+    std::string before = describe(meshdata);
+    MeshOptimizer::optimize(*meshdata);
+    std::string after = describe(meshdata);
+
+    auto label = Label::createWithTTF("exported: " + before + "\noptimized: " + after, "fonts/arial.ttf", 14);
+    label->setAlignment(TextHAlignment::CENTER);
+    label->setPosition(Vec2(s.width / 2, 50));
+    addChild(label);
+}
+
+std::string Sprite3DMeshOptimizerTest::title() const
+{
+    return "Sprite3D Mesh Optimizer Test";
+}
+
+std::string Sprite3DMeshOptimizerTest::subtitle() const
+{
+    return "Deduplicated vertices, triangles ordered for the vertex cache";
+}
+
+Sprite3DSkyboxAsyncTest::Sprite3DSkyboxAsyncTest()
+{
+    auto s = Director::getInstance()->getWinSize();
+    auto camera = Camera::createPerspective(60, s.width / s.height, 10, 1000);
+    camera->setPosition3D(Vec3(0.f, 0.f, 50.f));
+    camera->setCameraFlag(CameraFlag::USER1);
+    addChild(camera);
+
+    auto label = Label::createWithTTF("Loading the faces...", "fonts/arial.ttf", 14);
+    label->setPosition(Vec2(s.width / 2, 50));
+    addChild(label, 1, 1);
+
+    // the frame goes on while the faces are decoded, the callback may come after the test is left
+    auto begin = std::chrono::steady_clock::now();
+    auto skybox = Skybox::createAsync("Sprite3DTest/skybox/left.jpg", "Sprite3DTest/skybox/right.jpg",
+        "Sprite3DTest/skybox/top.jpg", "Sprite3DTest/skybox/bottom.jpg",
+        "Sprite3DTest/skybox/front.jpg", "Sprite3DTest/skybox/back.jpg", [begin](Skybox* skybox) {
+            auto parent = skybox ? skybox->getParent() : nullptr;
+            auto label = parent ? dynamic_cast<Label*>(parent->getChildByTag(1)) : nullptr;
+            if (label)
+            {
+                auto elapsed = std::chrono::duration_cast<std::chrono::duration<float>>(std::chrono::steady_clock::now() - begin).count();
+                label->setString(StringUtils::format("Loaded in %.3f seconds", elapsed));
+            }
+        });
+    addChild(skybox);
+
+    camera->runAction(RepeatForever::create(RotateBy::create(10, Vec3(0, 360, 0))));
+    setCameraMask(2);
+}
+
+std::string Sprite3DSkyboxAsyncTest::title() const
+{
+    return "Skybox async loading";
+}
+
+std::string Sprite3DSkyboxAsyncTest::subtitle() const
+{
+    return "The faces are decoded in parallel";
+}
+
+//
+// Sprite3DOpaqueSortTest
+//
+Sprite3DOpaqueSortTest::Sprite3DOpaqueSortTest()
+{
+    auto s = Director::getInstance()->getWinSize();
+    auto camera = Camera::createPerspective(60, s.width / s.height, 1, 1000);
+    camera->setPosition3D(Vec3(0, 20, 60));
+    camera->lookAt(Vec3(0, 0, -40));
+    camera->setCameraFlag(CameraFlag::USER1);
+    addChild(camera);
+
+    // rows of ships one behind the other, added from the back and with alternating textures,
+    // the worst order for the depth test and for the state changes
+    const char* textures[] = { "Sprite3DTest/boss.png", "Sprite3DTest/plane.png" };
+    for (int row = 0; row < 12; ++row)
+    {
+        for (int col = 0; col < 8; ++col)
+        {
+            auto ship = Sprite3D::create("Sprite3DTest/boss1.obj");
+            ship->setScale(3);
+            ship->setTexture(textures[(row + col) % 2]);
+            ship->setPosition3D(Vec3((col - 3.5f) * 12, 0, -100 + row * 8));
+            ship->runAction(RepeatForever::create(RotateBy::create(3 + col % 3, Vec3(0, 360, 0))));
+            addChild(ship);
+        }
+    }
+    setCameraMask((unsigned short)CameraFlag::USER1);
+
+    auto renderer = Director::getInstance()->getRenderer();
+    auto sortItem = MenuItemFont::create("Change the sort mode", [this, renderer](Ref*) {
+        auto mode = renderer->getOpaqueSortMode();
+        if (mode == RenderQueue::OpaqueSortMode::NONE)
+            renderer->setOpaqueSortMode(RenderQueue::OpaqueSortMode::FRONT_TO_BACK);
+        else if (mode == RenderQueue::OpaqueSortMode::FRONT_TO_BACK)
+            renderer->setOpaqueSortMode(RenderQueue::OpaqueSortMode::STATE_THEN_FRONT_TO_BACK);
+        else
+            renderer->setOpaqueSortMode(RenderQueue::OpaqueSortMode::NONE);
+        updateLabel();
+    });
+    auto prePassItem = MenuItemFont::create("Toggle the depth pre-pass", [this, renderer](Ref*) {
+        renderer->setDepthPrePassEnabled(!renderer->isDepthPrePassEnabled());
+        updateLabel();
+    });
+    sortItem->setFontSizeObj(16);
+    prePassItem->setFontSizeObj(16);
+    auto menu = Menu::create(sortItem, prePassItem, nullptr);
+    menu->alignItemsVertically();
+    menu->setPosition(Vec2(s.width - 110, s.height - 80));
+    addChild(menu, 1);
+
+    _label = Label::createWithTTF("", "fonts/arial.ttf", 14);
+    _label->setPosition(Vec2(s.width / 2, 50));
+    addChild(_label, 1);
+    updateLabel();
+}
+
+void Sprite3DOpaqueSortTest::updateLabel()
+{
+    static const char* modes[] = { "submission order", "front to back", "material, then front to back" };
+    auto renderer = Director::getInstance()->getRenderer();
+    _label->setString(StringUtils::format("%s, depth pre-pass %s", modes[(int)renderer->getOpaqueSortMode()],
+        renderer->isDepthPrePassEnabled() ? "on" : "off"));
+}
+
+void Sprite3DOpaqueSortTest::onExit()
+{
+    Sprite3DTestDemo::onExit();
+    auto renderer = Director::getInstance()->getRenderer();
+    renderer->setOpaqueSortMode(RenderQueue::OpaqueSortMode::NONE);
+    renderer->setDepthPrePassEnabled(false);
+}
+
+std::string Sprite3DOpaqueSortTest::title() const
+{
+    return "Opaque 3D sorting";
+}
+
+std::string Sprite3DOpaqueSortTest::subtitle() const
+{
+    return "The image doesn't change, the overdraw and the state changes do";
+}
+
+//
+// Sprite3DSharedMaterialTest
+//
+Sprite3DSharedMaterialTest::Sprite3DSharedMaterialTest()
+: _orcs(nullptr)
+, _sharing(true)
+{
+    auto s = Director::getInstance()->getWinSize();
+    auto camera = Camera::createPerspective(60, s.width / s.height, 1, 1000);
+    camera->setPosition3D(Vec3(0, 30, 80));
+    camera->lookAt(Vec3(0, 0, -20));
+    camera->setCameraFlag(CameraFlag::USER1);
+    addChild(camera);
+
+    auto item = MenuItemFont::create("Toggle the sharing", [this](Ref*) {
+        _sharing = !_sharing;
+        createOrcs();
+    });
+    item->setFontSizeObj(16);
+    auto menu = Menu::create(item, nullptr);
+    menu->setPosition(Vec2(s.width - 80, s.height - 80));
+    addChild(menu, 1);
+
+    _label = Label::createWithTTF("", "fonts/arial.ttf", 14);
+    _label->setPosition(Vec2(s.width / 2, 50));
+    addChild(_label, 1);
+
+    createOrcs();
+}
+
+void Sprite3DSharedMaterialTest::createOrcs()
+{
+    if (_orcs)
+        _orcs->removeFromParent();
+    _orcs = Node::create();
+    addChild(_orcs);
+
+    auto cache = Sprite3DCache::getInstance();
+    cache->setMaterialSharingEnabled(_sharing);
+
+    // the same animated model, only the tinted ones have a color of their own
+    auto animation = Animation3D::create("Sprite3DTest/orc.c3b");
+    for (int row = 0; row < 6; ++row)
+    {
+        for (int col = 0; col < 10; ++col)
+        {
+            auto orc = Sprite3D::create("Sprite3DTest/orc.c3b");
+            orc->setScale(1.5f);
+            orc->setRotation3D(Vec3(0, 180, 0));
+            orc->setPosition3D(Vec3((col - 4.5f) * 10, 0, -60 + row * 12));
+            if ((row + col) % 5 == 0)
+                orc->setColor(Color3B::RED);
+            if (animation)
+                orc->runAction(RepeatForever::create(Animate3D::create(animation)));
+            _orcs->addChild(orc);
+        }
+    }
+    _orcs->setCameraMask((unsigned short)CameraFlag::USER1);
+
+    // the cache keeps the materials of the previous orcs until they are released
+    _orcs->scheduleOnce([this, cache](float) {
+        cache->removeUnusedSharedMaterials();
+        _label->setString(StringUtils::format("sharing %s, %d shared materials for 60 orcs",
+            _sharing ? "on" : "off", (int)cache->getSharedMaterialCount()));
+    }, 0, "label");
+}
+
+void Sprite3DSharedMaterialTest::onExit()
+{
+    Sprite3DTestDemo::onExit();
+    auto cache = Sprite3DCache::getInstance();
+    cache->setMaterialSharingEnabled(false);
+    cache->removeUnusedSharedMaterials();
+}
+
+std::string Sprite3DSharedMaterialTest::title() const
+{
+    return "Shared materials";
+}
+
+std::string Sprite3DSharedMaterialTest::subtitle() const
+{
+    return "The orcs share their GLProgramStates, the red ones too";
+}
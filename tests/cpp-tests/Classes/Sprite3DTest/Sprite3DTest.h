@@ -625,4 +625,150 @@ public:
     virtual std::string subtitle() const override;
 };
 
+class Sprite3DInstancingTest : public Sprite3DTestDemo
+{
+public:
+    CREATE_FUNC(Sprite3DInstancingTest);
+    Sprite3DInstancingTest();
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+};
+
+class Sprite3DSkinInstancingTest : public Sprite3DTestDemo
+{
+public:
+    CREATE_FUNC(Sprite3DSkinInstancingTest);
+    Sprite3DSkinInstancingTest();
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+};
+
+class Sprite3DLODTest : public Sprite3DTestDemo
+{
+public:
+    CREATE_FUNC(Sprite3DLODTest);
+    Sprite3DLODTest();
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+};
+
+class Animate3DParallelUpdateTest : public Sprite3DTestDemo
+{
+public:
+    CREATE_FUNC(Animate3DParallelUpdateTest);
+    Animate3DParallelUpdateTest();
+    virtual void onEnter() override;
+    virtual void onExit() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+};
+
+class Sprite3DTextureStreamingTest : public Sprite3DTestDemo
+{
+public:
+    CREATE_FUNC(Sprite3DTextureStreamingTest);
+    Sprite3DTextureStreamingTest();
+    virtual ~Sprite3DTextureStreamingTest();
+    virtual void update(float dt) override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+
+protected:
+    cocos2d::Texture2D* _texture;
+    cocos2d::Label* _label;
+    bool _streamingEnabled;
+    int _streamingMinSize;
+};
+
+class Sprite3DSpatialIndexTest : public Sprite3DTestDemo
+{
+public:
+    CREATE_FUNC(Sprite3DSpatialIndexTest);
+    Sprite3DSpatialIndexTest();
+    virtual void onEnter() override;
+    virtual void onExit() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+
+    void onTouchesEnded(const std::vector<cocos2d::Touch*>& touches, cocos2d::Event* event);
+};
+
+class Sprite3DOcclusionCullingTest : public Sprite3DTestDemo
+{
+public:
+    CREATE_FUNC(Sprite3DOcclusionCullingTest);
+    Sprite3DOcclusionCullingTest();
+    virtual void onEnter() override;
+    virtual void onExit() override;
+    virtual void update(float dt) override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+
+protected:
+    cocos2d::Label* _label;
+};
+
+class Sprite3DQuantizedVertexTest : public Sprite3DTestDemo
+{
+public:
+    CREATE_FUNC(Sprite3DQuantizedVertexTest);
+    Sprite3DQuantizedVertexTest();
+    virtual void onExit() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+
+protected:
+    cocos2d::Sprite3D* addOrc(const cocos2d::Vec2& position, int quantization);
+};
+
+class Sprite3DMeshOptimizerTest : public Sprite3DTestDemo
+{
+public:
+    CREATE_FUNC(Sprite3DMeshOptimizerTest);
+    Sprite3DMeshOptimizerTest();
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+};
+
+class Sprite3DSkyboxAsyncTest : public Sprite3DTestDemo
+{
+public:
+    CREATE_FUNC(Sprite3DSkyboxAsyncTest);
+    Sprite3DSkyboxAsyncTest();
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+};
+
+class Sprite3DOpaqueSortTest : public Sprite3DTestDemo
+{
+public:
+    CREATE_FUNC(Sprite3DOpaqueSortTest);
+    Sprite3DOpaqueSortTest();
+    virtual void onExit() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+
+protected:
+    void updateLabel();
+
+    cocos2d::Label* _label;
+};
+
+class Sprite3DSharedMaterialTest : public Sprite3DTestDemo
+{
+public:
+    CREATE_FUNC(Sprite3DSharedMaterialTest);
+    Sprite3DSharedMaterialTest();
+    virtual void onExit() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+
+protected:
+    void createOrcs();
+
+    cocos2d::Node* _orcs;
+    cocos2d::Label* _label;
+    bool _sharing;
+};
+
 #endif
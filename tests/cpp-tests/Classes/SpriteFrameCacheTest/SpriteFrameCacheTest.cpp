@@ -33,6 +33,7 @@ USING_NS_CC;
 SpriteFrameCacheTests::SpriteFrameCacheTests()
 {
     ADD_TEST_CASE(SpriteFrameCachePixelFormatTest);
+    ADD_TEST_CASE(SpriteFrameCacheBinaryTest);
 }
 
 SpriteFrameCachePixelFormatTest::SpriteFrameCachePixelFormatTest()
@@ -83,4 +84,45 @@ void SpriteFrameCachePixelFormatTest::loadSpriteFrames(const std::string &file,
     
     SpriteFrameCache::getInstance()->removeSpriteFramesFromFile(file);
     Director::getInstance()->getTextureCache()->removeTexture(texture);
-}
\ No newline at end of file
+}
+
+SpriteFrameCacheBinaryTest::SpriteFrameCacheBinaryTest()
+{
+    const Size screenSize = Director::getInstance()->getWinSize();
+    auto cache = SpriteFrameCache::getInstance();
+    const std::string plist = "Images/test_polygon.plist";
+    const std::string binaryFile = FileUtils::getInstance()->getWritablePath() + "test_polygon.ccsf";
+
+    // copy the frames of the plist, then load them again from the binary file, lazily
+    cache->addSpriteFramesWithFile(plist);
+    const std::string name = "island_polygon.png";
+    SpriteFrame* plistFrame = cache->getSpriteFrameByName(name);
+    Rect plistRect = plistFrame ? plistFrame->getRect() : Rect::ZERO;
+    unsigned int plistVertices = plistFrame ? plistFrame->getPolygonInfo().getVertCount() : 0;
+    cache->removeSpriteFramesFromFile(plist);
+
+    bool written = cache->writeBinarySpriteFramesFile(plist, binaryFile);
+    cache->setLazyFrameCreationEnabled(true);
+    cache->addSpriteFramesWithFile(binaryFile, Director::getInstance()->getTextureCache()->addImage("Images/test_polygon.png"));
+    SpriteFrame* binaryFrame = cache->getSpriteFrameByName(name);
+    cache->setLazyFrameCreationEnabled(false);
+
+    bool matching = written && plistFrame && binaryFrame
+        && binaryFrame->getRect().equals(plistRect)
+        && binaryFrame->getPolygonInfo().getVertCount() == plistVertices;
+    CC_ASSERT(matching);
+
+    if (binaryFrame)
+    {
+        auto sprite = Sprite::createWithSpriteFrame(binaryFrame);
+        sprite->setPosition(screenSize.width / 2, screenSize.height / 2);
+        addChild(sprite);
+    }
+
+    auto label = Label::createWithTTF(matching ? "Frames match" : "Frames don't match", "fonts/arial.ttf", 20);
+    label->setPosition(screenSize.width / 2, screenSize.height * 0.2f);
+    addChild(label);
+
+    cache->removeSpriteFramesFromFile(binaryFile);
+    FileUtils::getInstance()->removeFile(binaryFile);
+}
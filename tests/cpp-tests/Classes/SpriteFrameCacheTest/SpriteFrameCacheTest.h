@@ -44,4 +44,15 @@ private:
     
 private:
     cocos2d::Label *infoLabel;
-};
\ No newline at end of file
+};
+
+class SpriteFrameCacheBinaryTest : public TestCase
+{
+public:
+    CREATE_FUNC(SpriteFrameCacheBinaryTest);
+
+    virtual std::string title() const override { return "Binary sprite frames test"; }
+    virtual std::string subtitle() const override { return "Frames of the plist and of its binary file should match"; }
+
+    SpriteFrameCacheBinaryTest();
+};
@@ -21,6 +21,7 @@ SpritePolygonTest::SpritePolygonTest()
     ADD_TEST_CASE(SpritePolygonTestAutoPolyIsland);
     ADD_TEST_CASE(SpritePolygonTestFrameAnim);
     ADD_TEST_CASE(Issue14017Test);
+    ADD_TEST_CASE(SpritePolygonTestAsync);
 }
 
 SpritePolygonTestCase::SpritePolygonTestCase()
@@ -839,3 +840,42 @@ void Issue14017Test::initSprites()
 
     updateDrawNode();
 }
+
+//
+// SpritePolygonTestAsync
+//
+SpritePolygonTestAsync::SpritePolygonTestAsync()
+{
+    _title = "SpritePolygon ";
+    _subtitle = "AutoPolygon::generatePolygonAsync(), the grossinis share a polygon";
+}
+
+void SpritePolygonTestAsync::initSprites()
+{
+    auto s = Director::getInstance()->getWinSize();
+    // starts from an empty cache, so the polygons are generated on the workers
+    AutoPolygon::purgeCache();
+
+    const char* files[] = { s_pathGrossini, s_pathSister1, s_pathSister2, s_pathGrossini };
+    const int count = sizeof(files) / sizeof(files[0]);
+    for (int i = 0; i < count; i++)
+    {
+        Vec2 position(s.width * (i + 1) / (count + 1), s.height / 2);
+        this->retain();
+        AutoPolygon::generatePolygonAsync(files[i], Rect::ZERO, 2.0f, 0.05f, [this, position](const PolygonInfo& info) {
+            auto sprite = Sprite::create(info);
+            addChild(sprite);
+            sprite->setPosition(position);
+
+            //DrawNode
+            auto spDrawNode = DrawNode::create();
+            spDrawNode->setTag(sprite->getTag());
+            spDrawNode->clear();
+            sprite->addChild(spDrawNode);
+            _drawNodes.pushBack(spDrawNode);
+
+            updateDrawNode();
+            this->release();
+        });
+    }
+}
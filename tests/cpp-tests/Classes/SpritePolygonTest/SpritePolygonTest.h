@@ -193,4 +193,12 @@ public:
     virtual void initSprites() override;
 };
 
+class SpritePolygonTestAsync : public SpritePolygonTestDemo
+{
+public:
+    CREATE_FUNC(SpritePolygonTestAsync);
+    SpritePolygonTestAsync();
+    virtual void initSprites() override;
+};
+
 #endif /* defined(__cocos2d_tests__SpritePolygonTest__) */
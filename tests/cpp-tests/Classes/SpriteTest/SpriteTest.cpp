@@ -136,6 +136,8 @@ SpriteTests::SpriteTests()
     ADD_TEST_CASE(SpriteSlice9Test9);
     ADD_TEST_CASE(SpriteSlice9Test10);
     ADD_TEST_CASE(Issue17119);
+    ADD_TEST_CASE(SpriteDynamicAtlasTest);
+    ADD_TEST_CASE(SpriteBatchNodeFreeSlotsTest);
 };
 
 //------------------------------------------------------------------
@@ -5799,4 +5801,79 @@ void Issue17119::update(float dt)
     }
 }
 
+//------------------------------------------------------------------
+//
+// SpriteDynamicAtlasTest
+//
+//------------------------------------------------------------------
+SpriteDynamicAtlasTest::SpriteDynamicAtlasTest()
+{
+    Size s = Director::getInstance()->getVisibleSize();
+    auto spriteFrameCache = SpriteFrameCache::getInstance();
+
+    // the images already loaded as textures keep them
+    _dynamicAtlasEnabled = spriteFrameCache->isDynamicAtlasEnabled();
+    Director::getInstance()->getTextureCache()->removeUnusedTextures();
+    spriteFrameCache->setDynamicAtlasEnabled(true);
+
+    const char* files[] = {
+        "Images/r1.png", "Images/b1.png", "Images/f1.png", "Images/close.png", "Images/ball.png",
+        "Images/grossini_dance_01.png", "Images/grossini_dance_02.png", "Images/grossini_dance_03.png",
+    };
+    const int count = sizeof(files) / sizeof(files[0]);
+    for (int i = 0; i < 80; ++i)
+    {
+        auto sprite = Sprite::create(files[i % count]);
+        sprite->setPosition(Vec2(s.width * (i % 10 + 0.5f) / 10, s.height * (0.2f + 0.6f * (i / 10) / 8)));
+        addChild(sprite);
+    }
+}
 
+SpriteDynamicAtlasTest::~SpriteDynamicAtlasTest()
+{
+    SpriteFrameCache::getInstance()->setDynamicAtlasEnabled(_dynamicAtlasEnabled);
+}
+
+std::string SpriteDynamicAtlasTest::subtitle() const
+{
+    return StringUtils::format("80 sprites of 8 files on %d atlas page(s), see the draw calls",
+                               (int)SpriteFrameCache::getInstance()->getDynamicAtlasPageCount());
+}
+
+//------------------------------------------------------------------
+//
+// SpriteBatchNodeFreeSlotsTest
+//
+//------------------------------------------------------------------
+
+SpriteBatchNodeFreeSlotsTest::SpriteBatchNodeFreeSlotsTest()
+{
+    _batch = SpriteBatchNode::create("Images/grossini_dance_atlas.png", 500);
+    _batch->setFreeSlotsEnabled(true);
+    addChild(_batch);
+
+    for (int i = 0; i < 400; ++i)
+    {
+        _batch->addChild(createSprite());
+    }
+
+    scheduleUpdate();
+}
+
+Sprite* SpriteBatchNodeFreeSlotsTest::createSprite()
+{
+    Size s = Director::getInstance()->getVisibleSize();
+    int idx = RandomHelper::random_int(0, 13);
+    auto sprite = Sprite::createWithTexture(_batch->getTexture(), Rect(85 * (idx % 5), 121 * (idx / 5), 85, 121));
+    sprite->setScale(0.25f);
+    sprite->setPosition(Vec2(RandomHelper::random_real(0.0f, s.width), RandomHelper::random_real(0.0f, s.height)));
+    return sprite;
+}
+
+void SpriteBatchNodeFreeSlotsTest::update(float dt)
+{
+    // only the removed slot and the moved quad are uploaded again
+    auto& children = _batch->getChildren();
+    _batch->removeChild(children.at(RandomHelper::random_int(0, (int)children.size() - 1)), true);
+    _batch->addChild(createSprite());
+}
@@ -932,4 +932,33 @@ protected:
     cocos2d::Sprite* _s4;
 };
 
+class SpriteDynamicAtlasTest : public SpriteTestDemo
+{
+public:
+    CREATE_FUNC(SpriteDynamicAtlasTest);
+    SpriteDynamicAtlasTest();
+    virtual ~SpriteDynamicAtlasTest();
+    virtual std::string title() const override { return "Dynamic atlas"; };
+    virtual std::string subtitle() const override;
+
+protected:
+    bool _dynamicAtlasEnabled;
+};
+
+class SpriteBatchNodeFreeSlotsTest : public SpriteTestDemo
+{
+public:
+    CREATE_FUNC(SpriteBatchNodeFreeSlotsTest);
+    SpriteBatchNodeFreeSlotsTest();
+    virtual std::string title() const override { return "SpriteBatchNode free slots"; };
+    virtual std::string subtitle() const override { return "a sprite is replaced every frame without shifting the others"; }
+
+    virtual void update(float dt) override;
+
+protected:
+    cocos2d::Sprite* createSprite();
+
+    cocos2d::SpriteBatchNode* _batch;
+};
+
 #endif
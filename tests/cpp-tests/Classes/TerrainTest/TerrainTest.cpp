@@ -7,6 +7,7 @@ TerrainTests::TerrainTests()
     ADD_TEST_CASE(TerrainSimple);
     ADD_TEST_CASE(TerrainWalkThru);
     ADD_TEST_CASE(TerrainWithLightMap);
+    ADD_TEST_CASE(TerrainStreaming);
 }
 
 Vec3 camera_offset(0, 45, 60);
@@ -373,3 +374,107 @@ void TerrainWithLightMap::onTouchesMoved(const std::vector<cocos2d::Touch*>& tou
     cameraPos+=cameraRightDir*newPos.x*0.5*delta;
     _camera->setPosition3D(cameraPos);
 }
+
+TerrainStreaming::TerrainStreaming()
+{
+    Size visibleSize = Director::getInstance()->getVisibleSize();
+
+    //use custom camera
+    _camera = Camera::createPerspective(60,visibleSize.width/visibleSize.height,0.1f,800);
+    _camera->setCameraFlag(CameraFlag::USER1);
+    _camera->setPosition3D(Vec3(512,60,512));
+    _camera->lookAt(Vec3(512,0,400));
+    addChild(_camera);
+
+    const int tiles = 8;
+    const int tileSize = 129;
+    Terrain::DetailMap r("TerrainTest/dirt.jpg"),g("TerrainTest/Grass2.jpg",10),b("TerrainTest/road.jpg"),a("TerrainTest/GreenSkin.jpg",20);
+    Terrain::TerrainData data(generateTiles(tiles, tileSize),"TerrainTest/alphamap.png",r,g,b,a,Size(32,32),40.0f,2);
+
+    _terrain = StreamingTerrain::create(data, tiles, tiles, tileSize);
+    _terrain->setCameraMask(2);
+    addChild(_terrain);
+
+    _label = Label::createWithTTF("", "fonts/arial.ttf", 14);
+    _label->setPosition(Vec2(visibleSize.width / 2, visibleSize.height / 4));
+    addChild(_label);
+
+    auto listener = EventListenerTouchAllAtOnce::create();
+    listener->onTouchesMoved = CC_CALLBACK_2(TerrainStreaming::onTouchesMoved, this);
+    _eventDispatcher->addEventListenerWithSceneGraphPriority(listener, this);
+    scheduleUpdate();
+}
+
+std::string TerrainStreaming::generateTiles(int tiles, int tileSize)
+{
+    auto fileUtils = FileUtils::getInstance();
+    std::string dir = fileUtils->getWritablePath() + "terrain_tiles/";
+    fileUtils->createDirectory(dir);
+
+    //the heights come from one function of the global pixel position, so the tiles' shared borders match
+    std::vector<unsigned char> pixels(tileSize * tileSize * 4, 255);
+    for (int tz = 0; tz < tiles; ++tz)
+    {
+        for (int tx = 0; tx < tiles; ++tx)
+        {
+            for (int i = 0; i < tileSize; ++i)
+            {
+                for (int j = 0; j < tileSize; ++j)
+                {
+                    float x = (float)(tx * (tileSize - 1) + j);
+                    float z = (float)(tz * (tileSize - 1) + i);
+                    float height = 0.5f + 0.25f * sinf(x * 0.03f) * cosf(z * 0.025f) + 0.2f * sinf((x + z) * 0.011f);
+                    unsigned char value = (unsigned char)(clampf(height, 0.0f, 1.0f) * 255);
+                    int offset = (i * tileSize + j) * 4;
+                    pixels[offset] = pixels[offset + 1] = pixels[offset + 2] = value;
+                }
+            }
+            auto image = new (std::nothrow) Image();
+            image->initWithRawData(pixels.data(), pixels.size(), tileSize, tileSize, 8);
+            image->saveToFile(StringUtils::format("%sheight_%d_%d.png", dir.c_str(), tx, tz));
+            image->release();
+        }
+    }
+    return dir + "height_%d_%d.png";
+}
+
+std::string TerrainStreaming::title() const
+{
+    return "Streaming terrain";
+}
+
+std::string TerrainStreaming::subtitle() const
+{
+    return "Drag to fly, tiles page in around the camera";
+}
+
+void TerrainStreaming::update(float /*dt*/)
+{
+    Vec3 cameraPos = _camera->getPosition3D();
+    cameraPos.y = _terrain->getHeight(cameraPos.x, cameraPos.z) + 30;
+    _camera->setPosition3D(cameraPos);
+
+    _label->setString(StringUtils::format("tiles loaded: %d, streaming: %d", _terrain->getLoadedTileCount(), _terrain->getPendingTileCount()));
+}
+
+void TerrainStreaming::onTouchesMoved(const std::vector<cocos2d::Touch*>& touches, cocos2d::Event* event)
+{
+    float delta = Director::getInstance()->getDeltaTime();
+    auto touch = touches[0];
+    auto location = touch->getLocation();
+    auto PreviousLocation = touch->getPreviousLocation();
+    Point newPos = PreviousLocation - location;
+
+    Vec3 cameraDir;
+    Vec3 cameraRightDir;
+    _camera->getNodeToWorldTransform().getForwardVector(&cameraDir);
+    cameraDir.normalize();
+    cameraDir.y=0;
+    _camera->getNodeToWorldTransform().getRightVector(&cameraRightDir);
+    cameraRightDir.normalize();
+    cameraRightDir.y=0;
+    Vec3 cameraPos=  _camera->getPosition3D();
+    cameraPos+=cameraDir*newPos.y*20*delta;
+    cameraPos+=cameraRightDir*newPos.x*20*delta;
+    _camera->setPosition3D(cameraPos);
+}
@@ -86,4 +86,23 @@ protected:
     cocos2d::Camera* _camera;
 };
 
+class TerrainStreaming : public TerrainTestDemo
+{
+public:
+    CREATE_FUNC(TerrainStreaming);
+    TerrainStreaming();
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual void update(float dt) override;
+    void onTouchesMoved(const std::vector<cocos2d::Touch*>& touches, cocos2d::Event* event);
+
+protected:
+    // writes a grid of seamless heightmap tiles, returns the file pattern
+    std::string generateTiles(int tiles, int tileSize);
+
+    cocos2d::StreamingTerrain* _terrain;
+    cocos2d::Camera* _camera;
+    cocos2d::Label* _label;
+};
+
 #endif // !TERRAIN_TESH_H
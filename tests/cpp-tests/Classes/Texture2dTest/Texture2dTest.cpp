@@ -103,11 +103,13 @@ Texture2DTests::Texture2DTests()
     ADD_TEST_CASE(TextureATITCRGB);
     ADD_TEST_CASE(TextureATITCExplicit);
     ADD_TEST_CASE(TextureATITCInterpolated);
+    ADD_TEST_CASE(TextureKTX2);
     
     ADD_TEST_CASE(TextureConvertRGB888);
     ADD_TEST_CASE(TextureConvertRGBA8888);
     ADD_TEST_CASE(TextureConvertI8);
     ADD_TEST_CASE(TextureConvertAI88);
+    ADD_TEST_CASE(TextureDynamic);
 };
 
 //------------------------------------------------------------------
@@ -2197,6 +2199,25 @@ std::string TextureATITCInterpolated::subtitle() const
     return "ATITC RGBA Interpolated Alpha compressed texture test";
 }
 
+TextureKTX2::TextureKTX2()
+{
+    auto sprite = Sprite::create("Images/test_128x128_rgba8888_mipmaps.ktx2");
+    
+    auto size = Director::getInstance()->getWinSize();
+    sprite->setPosition(Vec2(size.width / 2, size.height / 2));
+    sprite->runAction(RepeatForever::create(Sequence::create(ScaleTo::create(2.0f, 0.1f), ScaleTo::create(2.0f, 1.0f), nullptr)));
+    
+    addChild(sprite);
+}
+std::string TextureKTX2::title() const
+{
+    return "KTX2 texture (*.ktx2 file) test";
+}
+std::string TextureKTX2::subtitle() const
+{
+    return "RGBA8888 with mipmaps, each level has its own tint";
+}
+
 static void addImageToDemo(TextureDemo& demo, float x, float y, const char* path, Texture2D::PixelFormat format)
 {
     Texture2D::setDefaultAlphaPixelFormat(format);
@@ -2344,3 +2365,79 @@ std::string TextureConvertAI88::subtitle() const
 {
     return "RGBA8888,RGB888,RGB565,A8,I8,AI88,RGBA4444,RGB5A1";
 }
+
+//------------------------------------------------------------------
+//
+// TextureDynamic
+//
+//------------------------------------------------------------------
+TextureDynamic::TextureDynamic()
+: _dynamicTexture(nullptr)
+, _time(0)
+{
+}
+
+TextureDynamic::~TextureDynamic()
+{
+    CC_SAFE_RELEASE(_dynamicTexture);
+}
+
+void TextureDynamic::onEnter()
+{
+    TextureDemo::onEnter();
+
+    auto s = Director::getInstance()->getWinSize();
+
+    // 3 storages, the frame being drawn is never the one updated
+    _dynamicTexture = DynamicTexture::create(128, 128, Texture2D::PixelFormat::RGBA8888, 3);
+    _dynamicTexture->retain();
+
+    // adjacent rows merge into one region, far away ones don't
+    _dynamicTexture->markDirty(0, 0, 128, 8);
+    _dynamicTexture->markDirty(0, 8, 128, 8);
+    CCASSERT(_dynamicTexture->getDirtyRegionCount() == 1, "adjacent regions should be merged");
+    _dynamicTexture->markDirty(100, 100, 4, 4);
+    CCASSERT(_dynamicTexture->getDirtyRegionCount() == 2, "distant regions should not be merged");
+    _dynamicTexture->commit();
+    CCASSERT(_dynamicTexture->getDirtyRegionCount() == 2, "the next storage should still need the regions");
+
+    auto sprite = Sprite::createWithTexture(_dynamicTexture->getTexture());
+    sprite->setPosition(s.width / 2, s.height / 2);
+    sprite->setScale(2);
+    addChild(sprite);
+
+    schedule(CC_SCHEDULE_SELECTOR(TextureDynamic::updatePixels));
+}
+
+void TextureDynamic::updatePixels(float dt)
+{
+    _time += dt;
+
+    // a moving band of the texture changes every frame, the rest stays
+    const int size = 128;
+    const int bandHeight = 16;
+    int bandY = (int)(_time * 40) % (size - bandHeight);
+    auto pixels = _dynamicTexture->getPixels();
+    for (int y = bandY; y < bandY + bandHeight; ++y)
+    {
+        for (int x = 0; x < size; ++x)
+        {
+            unsigned char* pixel = pixels + y * _dynamicTexture->getBytesPerRow() + x * 4;
+            pixel[0] = (unsigned char)(127 + 127 * sinf(x * 0.1f + _time * 3));
+            pixel[1] = (unsigned char)(127 + 127 * sinf(y * 0.1f + _time * 2));
+            pixel[2] = (unsigned char)(127 + 127 * sinf((x + y) * 0.05f + _time));
+            pixel[3] = 255;
+        }
+    }
+    _dynamicTexture->markDirty(0, bandY, size, bandHeight);
+}
+
+std::string TextureDynamic::title() const
+{
+    return "DynamicTexture";
+}
+
+std::string TextureDynamic::subtitle() const
+{
+    return "A band of pixels updated every frame through 3 storages";
+}
@@ -607,6 +607,17 @@ public:
     virtual std::string subtitle() const override;
 };
 
+// KTX2 container texture test
+class TextureKTX2 : public TextureDemo
+{
+public:
+    CREATE_FUNC(TextureKTX2);
+    TextureKTX2();
+    
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+};
+
 
 // RGB888 texture convert test
 class TextureConvertRGB888 : public TextureDemo
@@ -648,4 +659,22 @@ public:
     virtual std::string subtitle() const override;
 };
 
+// DynamicTexture test
+class TextureDynamic : public TextureDemo
+{
+public:
+    CREATE_FUNC(TextureDynamic);
+    TextureDynamic();
+    virtual ~TextureDynamic();
+    virtual void onEnter() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+
+    void updatePixels(float dt);
+
+private:
+    cocos2d::DynamicTexture* _dynamicTexture;
+    float _time;
+};
+
 #endif // __TEXTURE2D_TEST_H__
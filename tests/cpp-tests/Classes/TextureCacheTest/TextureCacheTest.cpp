@@ -9,6 +9,9 @@ TextureCacheTests::TextureCacheTests()
 {
     ADD_TEST_CASE(TextureCacheTest);
     ADD_TEST_CASE(TextureCacheUnbindTest);
+    ADD_TEST_CASE(TextureCacheStreamedUploadTest);
+    ADD_TEST_CASE(TextureCacheMemoryBudgetTest);
+    ADD_TEST_CASE(TextureCachePriorityTest);
 }
 
 TextureCacheTest::TextureCacheTest()
@@ -180,3 +183,179 @@ void TextureCacheUnbindTest::textureLoadedB(Texture2D* texture)
   s->setPosition(3 * size.width / 4, size.height / 2);
   this->addChild(s);
 }
+
+TextureCacheStreamedUploadTest::TextureCacheStreamedUploadTest()
+: _previousBudget(0)
+, _frames(0)
+{
+    auto size = Director::getInstance()->getWinSize();
+
+    _label = Label::createWithTTF("uploading...", "fonts/arial.ttf", 15);
+    _label->setPosition(Vec2(size.width / 2, 5 * size.height / 6));
+    this->addChild(_label);
+
+    auto cache = Director::getInstance()->getTextureCache();
+    cache->removeTextureForKey("Images/texture2048x2048.png");
+
+    // 16 MB of RGBA8888, uploaded 512 KB per frame
+    _previousBudget = cache->getAsyncUploadBudget();
+    cache->setAsyncUploadBudget(512 * 1024);
+    cache->addImageAsync("Images/texture2048x2048.png", CC_CALLBACK_1(TextureCacheStreamedUploadTest::textureLoaded, this));
+
+    scheduleUpdate();
+}
+
+void TextureCacheStreamedUploadTest::onExit()
+{
+    Director::getInstance()->getTextureCache()->setAsyncUploadBudget(_previousBudget);
+    TestCase::onExit();
+}
+
+void TextureCacheStreamedUploadTest::update(float /*dt*/)
+{
+    ++_frames;
+}
+
+void TextureCacheStreamedUploadTest::textureLoaded(Texture2D* texture)
+{
+    unscheduleUpdate();
+    _label->setString(StringUtils::format("uploaded in %d frames", _frames));
+
+    auto size = Director::getInstance()->getWinSize();
+    auto s = Sprite::createWithTexture(texture);
+    s->setScale(0.15f);
+    s->setPosition(size.width / 2, size.height / 2);
+    this->addChild(s);
+}
+
+std::string TextureCacheStreamedUploadTest::title() const
+{
+    return "Streamed texture upload";
+}
+
+std::string TextureCacheStreamedUploadTest::subtitle() const
+{
+    return "A 2048x2048 texture is uploaded over several frames";
+}
+
+// TextureCacheMemoryBudgetTest
+
+TextureCacheMemoryBudgetTest::TextureCacheMemoryBudgetTest()
+: _previousBudget(0)
+{
+    auto size = Director::getInstance()->getWinSize();
+    auto cache = Director::getInstance()->getTextureCache();
+
+    // grossini.png is shown and pinned, the backgrounds are loaded but unused
+    auto pinned = cache->addImage("Images/grossini.png");
+    cache->setTexturePinned(pinned, true);
+    cache->addImage("Images/background1.png");
+    cache->addImage("Images/background2.png");
+    cache->addImage("Images/background3.png");
+
+    auto sprite = Sprite::createWithTexture(cache->addImage("Images/grossini_dance_01.png"));
+    sprite->setPosition(size.width / 2, size.height / 2);
+    this->addChild(sprite);
+
+    auto before = cache->getTotalTextureMemory();
+    auto evictedBefore = cache->getEvictedTextureCount();
+
+    // a frame later the unused textures are no longer recent, shrink the cache to the textures in use
+    scheduleOnce([=](float /*dt*/) {
+        _previousBudget = cache->getMemoryBudget();
+        cache->setMemoryBudget(1);
+
+        auto label = Label::createWithTTF(StringUtils::format("%lu KB -> %lu KB, %u textures evicted, grossini.png %s",
+                                                              (unsigned long)before / 1024,
+                                                              (unsigned long)cache->getTotalTextureMemory() / 1024,
+                                                              cache->getEvictedTextureCount() - evictedBefore,
+                                                              cache->getTextureForKey("Images/grossini.png") ? "kept" : "evicted"),
+                                          "fonts/arial.ttf", 15);
+        label->setPosition(Vec2(size.width / 2, size.height / 4));
+        this->addChild(label);
+
+        log("%s", cache->getCachedTextureInfo().c_str());
+    }, 0.1f, "evict");
+}
+
+void TextureCacheMemoryBudgetTest::onExit()
+{
+    auto cache = Director::getInstance()->getTextureCache();
+    cache->setTexturePinned(cache->getTextureForKey("Images/grossini.png"), false);
+    cache->setMemoryBudget(_previousBudget);
+    TestCase::onExit();
+}
+
+std::string TextureCacheMemoryBudgetTest::title() const
+{
+    return "Texture memory budget";
+}
+
+std::string TextureCacheMemoryBudgetTest::subtitle() const
+{
+    return "Unused textures are evicted, the pinned and displayed ones are kept";
+}
+
+// TextureCachePriorityTest
+
+TextureCachePriorityTest::TextureCachePriorityTest()
+: _loadedCount(0)
+, _previousDecoderCount(0)
+{
+    auto size = Director::getInstance()->getWinSize();
+
+    _label = Label::createWithTTF("loading...", "fonts/arial.ttf", 15);
+    _label->setPosition(Vec2(size.width / 2, 5 * size.height / 6));
+    this->addChild(_label);
+
+    auto cache = Director::getInstance()->getTextureCache();
+
+    // a single decoder makes the decoding order visible
+    _previousDecoderCount = cache->getAsyncDecoderCount();
+    cache->setAsyncDecoderCount(1);
+
+    for (int i = 1; i <= 12; ++i)
+    {
+        auto path = StringUtils::format("Images/grossini_dance_%02d.png", i);
+        cache->removeTextureForKey(path);
+
+        // every request has its own callbackKey, the callbacks come in decoding order
+        cache->addImageAsync(path, std::bind(&TextureCachePriorityTest::textureLoaded, this, std::placeholders::_1, i),
+                             StringUtils::format("dance_%d", i), i > 9 ? 10 : 0);
+    }
+    cache->cancelImageAsync("dance_5");
+    cache->cancelImageAsync("dance_6");
+}
+
+void TextureCachePriorityTest::textureLoaded(Texture2D* texture, int index)
+{
+    _order += StringUtils::format("%d ", index);
+    _label->setString(_order);
+
+    auto size = Director::getInstance()->getWinSize();
+    auto s = Sprite::createWithTexture(texture);
+    s->setPosition(size.width * (_loadedCount % 5 + 1) / 6, size.height * (2 - _loadedCount / 5) / 4);
+    this->addChild(s);
+    ++_loadedCount;
+}
+
+void TextureCachePriorityTest::onExit()
+{
+    auto cache = Director::getInstance()->getTextureCache();
+    cache->setAsyncDecoderCount(_previousDecoderCount);
+    for (int i = 1; i <= 12; ++i)
+    {
+        cache->cancelImageAsync(StringUtils::format("dance_%d", i));
+    }
+    TestCase::onExit();
+}
+
+std::string TextureCachePriorityTest::title() const
+{
+    return "Async load priority and cancellation";
+}
+
+std::string TextureCachePriorityTest::subtitle() const
+{
+    return "10 to 12 are loaded first, 5 and 6 are cancelled";
+}
@@ -37,4 +37,59 @@ private:
     void textureLoadedB(cocos2d::Texture2D* texture);
 };
 
+class TextureCacheStreamedUploadTest : public TestCase
+{
+public:
+    CREATE_FUNC(TextureCacheStreamedUploadTest);
+
+    TextureCacheStreamedUploadTest();
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual void onExit() override;
+    virtual void update(float dt) override;
+
+private:
+    void textureLoaded(cocos2d::Texture2D* texture);
+
+    cocos2d::Label* _label;
+    size_t _previousBudget;
+    int _frames;
+};
+
+class TextureCacheMemoryBudgetTest : public TestCase
+{
+public:
+    CREATE_FUNC(TextureCacheMemoryBudgetTest);
+
+    TextureCacheMemoryBudgetTest();
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual void onExit() override;
+
+private:
+    size_t _previousBudget;
+};
+
+class TextureCachePriorityTest : public TestCase
+{
+public:
+    CREATE_FUNC(TextureCachePriorityTest);
+
+    TextureCachePriorityTest();
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual void onExit() override;
+
+private:
+    void textureLoaded(cocos2d::Texture2D* texture, int index);
+
+    cocos2d::Label* _label;
+    std::string _order;
+    int _loadedCount;
+    unsigned int _previousDecoderCount;
+};
+
 #endif // _TEXTURECACHE_TEST_H_
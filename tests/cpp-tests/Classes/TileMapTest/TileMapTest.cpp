@@ -56,6 +56,8 @@ TileMapTests::TileMapTests()
     ADD_TEST_CASE(TMXHexAxisXTest);
     ADD_TEST_CASE(Issue16105Test);
     ADD_TEST_CASE(Issue16512Test);
+    ADD_TEST_CASE(TMXGPUMapTest);
+    ADD_TEST_CASE(TMXTileStoreTest);
 }
 
 TileDemo::TileDemo()
@@ -1698,3 +1700,106 @@ std::string Issue16512Test::title() const
 {
     return "Github Issue #16512. Should not crash";
 }
+
+//------------------------------------------------------------------
+//
+// TMXGPUMapTest
+//
+//------------------------------------------------------------------
+TMXGPUMapTest::TMXGPUMapTest()
+: _step(0)
+{
+    auto map = TMXTiledMapGPU::create("TileMaps/orthogonal-test2.tmx");
+    addChild(map, 0, kTagTileMap);
+    map->setScale(0.5f);
+
+    CCLOG("%s", map->getDescription().c_str());
+
+    // the tiles of a row change every step, only their texels are uploaded
+    schedule([map, this](float /*dt*/) {
+        const int layer = 0;
+        const int row = _step % (int)map->getMapSize().height;
+        for (int x = 0; x < (int)map->getMapSize().width; ++x)
+        {
+            Vec2 position(x, row);
+            TMXTileFlags flags;
+            uint32_t gid = map->getTileGIDAt(layer, position, &flags);
+            if (gid != 0)
+            {
+                map->setTileGID(layer, gid, position, (TMXTileFlags)(flags ^ kTMXTileHorizontalFlag));
+            }
+        }
+        map->setTileOpacity(layer, Vec2(0, row), (_step & 1) ? 255 : 64);
+        ++_step;
+    }, 0.1f, "flip");
+}
+
+std::string TMXGPUMapTest::title() const
+{
+    return "TMXTiledMapGPU";
+}
+
+std::string TMXGPUMapTest::subtitle() const
+{
+    return "A row of tiles flips every 0.1s, one draw per layer group";
+}
+
+//------------------------------------------------------------------
+//
+// TMXTileStoreTest
+//
+//------------------------------------------------------------------
+TMXTileStoreTest::TMXTileStoreTest()
+{
+    const std::string tmxFile = "TileMaps/orthogonal-test2.tmx";
+    auto map = TMXTiledMap::create(tmxFile);
+    addChild(map, 0, kTagTileMap);
+
+    // the conversion decodes the layers one by one
+    auto path = FileUtils::getInstance()->getWritablePath() + "orthogonal-test2.ccts";
+    auto lazyInfo = TMXMapInfo::createWithLazyTiles(tmxFile);
+    bool written = lazyInfo && TMXTileStore::writeToFile(lazyInfo, path, 16);
+    auto store = written ? TMXTileStore::create(path) : nullptr;
+
+    auto mapInfo = TMXMapInfo::create(tmxFile);
+    int mismatches = 0;
+    if (store)
+    {
+        auto layerInfo = mapInfo->getLayers().at(0);
+        const int width = (int)layerInfo->_layerSize.width;
+        const int height = (int)layerInfo->_layerSize.height;
+
+        // a region straddling chunks, then every tile
+        std::vector<uint32_t> region(20 * 20);
+        store->getTiles(0, 10, 10, 20, 20, region.data());
+        for (int y = 0; y < 20; ++y)
+        {
+            for (int x = 0; x < 20; ++x)
+            {
+                mismatches += region[y * 20 + x] != layerInfo->_tiles[(10 + y) * width + 10 + x];
+            }
+        }
+        store->setCacheLimit(4);
+        for (int y = 0; y < height; ++y)
+        {
+            for (int x = 0; x < width; ++x)
+            {
+                mismatches += store->getTileGIDAt(0, x, y) != layerInfo->_tiles[y * width + x];
+            }
+        }
+    }
+
+    _result = !store ? "Can't write or read the tile store"
+        : StringUtils::format("%d mismatching tiles, %d chunks kept decoded", mismatches, (int)store->getDecodedChunkCount());
+    CCLOG("%s", _result.c_str());
+}
+
+std::string TMXTileStoreTest::title() const
+{
+    return "TMXTileStore";
+}
+
+std::string TMXTileStoreTest::subtitle() const
+{
+    return _result;
+}
@@ -388,4 +388,28 @@ public:
 
 };
 
+class TMXGPUMapTest : public TileDemo
+{
+public:
+    CREATE_FUNC(TMXGPUMapTest);
+    TMXGPUMapTest();
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+
+private:
+    int _step;
+};
+
+class TMXTileStoreTest : public TileDemo
+{
+public:
+    CREATE_FUNC(TMXTileStoreTest);
+    TMXTileStoreTest();
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+
+private:
+    std::string _result;
+};
+
 #endif
@@ -42,6 +42,7 @@ FastTileMapTests::FastTileMapTests()
     ADD_TEST_CASE(TMXBug987New);
     ADD_TEST_CASE(TMXBug787New);
     ADD_TEST_CASE(TMXGIDObjectsTestNew);
+    ADD_TEST_CASE(TMXChunkedLayerTestNew);
 }
 
 TileDemoNew::TileDemoNew()
@@ -1355,3 +1356,51 @@ std::string TMXGIDObjectsTestNew::subtitle() const
 {
     return "Tiles are created from an object group";
 }
+
+//------------------------------------------------------------------
+//
+// TMXChunkedLayerTestNew
+//
+//------------------------------------------------------------------
+TMXChunkedLayerTestNew::TMXChunkedLayerTestNew()
+: _gid(1)
+{
+    auto map = cocos2d::experimental::TMXTiledMap::create("TileMaps/orthogonal-test2.tmx");
+    addChild(map, 0, kTagTileMap);
+
+    for (auto& child : map->getChildren())
+    {
+        auto layer = dynamic_cast<cocos2d::experimental::TMXLayer*>(child);
+        if (layer)
+        {
+            layer->setChunkSize(16);
+        }
+    }
+
+    schedule(CC_SCHEDULE_SELECTOR(TMXChunkedLayerTestNew::updateRow), 0.5f);
+}
+
+void TMXChunkedLayerTestNew::updateRow(float dt)
+{
+    auto map = (cocos2d::experimental::TMXTiledMap*)getChildByTag(kTagTileMap);
+    auto layer = map->getLayer("Layer 0");
+
+    // changing the gid of existing tiles only uploads their quads
+    auto s = layer->getLayerSize();
+    for (int x = 0; x < s.width; x++)
+    {
+        layer->setTileGID(_gid, Vec2((float)x, s.height - 2));
+    }
+
+    _gid = _gid % 79 + 1;
+}
+
+std::string TMXChunkedLayerTestNew::title() const
+{
+    return "TMX chunked layer";
+}
+
+std::string TMXChunkedLayerTestNew::subtitle() const
+{
+    return "Layers drawn in chunks of 16x16 tiles, drag the screen";
+}
@@ -310,4 +310,18 @@ public:
     virtual std::string subtitle() const override;   
 };
 
+class TMXChunkedLayerTestNew : public TileDemoNew
+{
+public:
+    CREATE_FUNC(TMXChunkedLayerTestNew);
+    TMXChunkedLayerTestNew();
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+
+    void updateRow(float dt);
+
+protected:
+    unsigned int _gid;
+};
+
 #endif
@@ -23,6 +23,7 @@ TouchesTests::TouchesTests()
 {
     ADD_TEST_CASE(PongScene);
     ADD_TEST_CASE(ForceTouchTest);
+    ADD_TEST_CASE(CoalescedTouchTest);
 }
 //------------------------------------------------------------------
 //
@@ -165,3 +166,85 @@ void ForceTouchTest::onTouchesEnded(const std::vector<cocos2d::Touch*>& touches,
     sprintf(formatBuffer, _Info_Formatter, 0.0f, 0.0f);
     _infoLabel->setString(std::string(formatBuffer));
 }
+
+//------------------------------------------------------------------
+//
+// CoalescedTouchTest
+//
+//------------------------------------------------------------------
+bool CoalescedTouchTest::init()
+{
+    if (!TestCase::init())
+        return false;
+
+    _wasCoalesced = false;
+
+    _drawNode = DrawNode::create();
+    addChild(_drawNode);
+
+    _infoLabel = Label::createWithTTF(TTFConfig("fonts/arial.ttf"), "Samples in the last move: 0");
+    _infoLabel->setPosition(VisibleRect::center().x, VisibleRect::bottom().y + 40);
+    addChild(_infoLabel);
+
+    auto listener = EventListenerTouchAllAtOnce::create();
+    listener->onTouchesBegan = [this](const std::vector<Touch*>& touches, Event*) {
+        _drawNode->clear();
+        drawHistory(touches);
+    };
+    listener->onTouchesMoved = [this](const std::vector<Touch*>& touches, Event*) {
+        size_t samples = 0;
+        for (auto touch : touches)
+        {
+            samples = std::max(samples, touch->getHistory().size());
+        }
+        _infoLabel->setString(StringUtils::format("Samples in the last move: %d", (int)samples));
+        drawHistory(touches);
+    };
+    listener->onTouchesEnded = [this](const std::vector<Touch*>& touches, Event*) {
+        drawHistory(touches);
+    };
+    _eventDispatcher->addEventListenerWithSceneGraphPriority(listener, this);
+
+    return true;
+}
+
+void CoalescedTouchTest::onEnter()
+{
+    TestCase::onEnter();
+    auto glview = Director::getInstance()->getOpenGLView();
+    _wasCoalesced = glview->isTouchMovesCoalesced();
+    glview->setTouchMovesCoalesced(true);
+}
+
+void CoalescedTouchTest::onExit()
+{
+    Director::getInstance()->getOpenGLView()->setTouchMovesCoalesced(_wasCoalesced);
+    TestCase::onExit();
+}
+
+void CoalescedTouchTest::drawHistory(const std::vector<Touch*>& touches)
+{
+    // a segment from the previous location through every sample, a dot per sample
+    for (auto touch : touches)
+    {
+        auto from = touch->getPreviousLocation();
+        auto& history = touch->getHistory();
+        for (ssize_t i = 0; i < (ssize_t)history.size(); ++i)
+        {
+            auto to = touch->getHistoricalLocation(i);
+            _drawNode->drawSegment(from, to, 2, Color4F::WHITE);
+            _drawNode->drawDot(to, 3, i + 1 < (ssize_t)history.size() ? Color4F::YELLOW : Color4F::RED);
+            from = to;
+        }
+    }
+}
+
+std::string CoalescedTouchTest::title() const
+{
+    return "Coalesced Touch Moves";
+}
+
+std::string CoalescedTouchTest::subtitle() const
+{
+    return "One move per frame, the yellow dots are the samples in between";
+}
@@ -50,4 +50,23 @@ protected:
     cocos2d::Label * _infoLabel;
 };
 
+class CoalescedTouchTest : public TestCase
+{
+public:
+    CREATE_FUNC(CoalescedTouchTest);
+
+    virtual bool init() override;
+    virtual void onEnter() override;
+    virtual void onExit() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+
+protected:
+    void drawHistory(const std::vector<cocos2d::Touch*>& touches);
+
+    cocos2d::DrawNode* _drawNode;
+    cocos2d::Label* _infoLabel;
+    bool _wasCoalesced;
+};
+
 #endif
@@ -256,6 +256,24 @@ TransitionsTests::TransitionsTests()
     }
 }
 
+// the next transitions draw the scenes from snapshots or not
+static void addSnapshotToggle(Layer* layer)
+{
+    auto toggle = MenuItemToggle::createWithCallback([](Ref* sender) {
+            auto item = static_cast<MenuItemToggle*>(sender);
+            TransitionScene::setDefaultSnapshotMode(item->getSelectedIndex() ? TransitionScene::SnapshotMode::BOTH : TransitionScene::SnapshotMode::NONE);
+        },
+        MenuItemFont::create("Snapshots: Off"),
+        MenuItemFont::create("Snapshots: On"),
+        nullptr);
+    toggle->setSelectedIndex(TransitionScene::getDefaultSnapshotMode() == TransitionScene::SnapshotMode::NONE ? 0 : 1);
+
+    auto size = Director::getInstance()->getWinSize();
+    auto menu = Menu::create(toggle, nullptr);
+    menu->setPosition(Vec2(size.width / 2, 140));
+    layer->addChild(menu);
+}
+
 TestLayer1* TestLayer1::create(const std::string& transitionName)
 {
     auto layer = new (std::nothrow) TestLayer1(transitionName);
@@ -295,6 +313,8 @@ TestLayer1::TestLayer1(const std::string& transitionName)
     addChild( label);
 
     schedule( CC_SCHEDULE_SELECTOR(TestLayer1::step), 1.0f); 
+
+    addSnapshotToggle(this);
 }
 
 TestLayer1::~TestLayer1()
@@ -371,6 +391,8 @@ TestLayer2::TestLayer2(const std::string& transitionName)
     addChild( label);
 
     schedule(CC_SCHEDULE_SELECTOR(TestLayer2::step), 1.0f);
+
+    addSnapshotToggle(this);
 }
 
 TestLayer2::~TestLayer2()
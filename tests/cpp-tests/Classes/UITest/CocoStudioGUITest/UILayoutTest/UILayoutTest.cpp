@@ -18,6 +18,7 @@ UILayoutTests::UILayoutTests()
     ADD_TEST_CASE(UILayoutComponentTest);
     ADD_TEST_CASE(UILayoutComponent_Berth_Test);
     ADD_TEST_CASE(UILayoutComponent_Berth_Stretch_Test);
+    ADD_TEST_CASE(UILayoutComponent_Dirty_Test);
 }
 
 // UILayoutTest
@@ -932,3 +933,74 @@ bool UILayoutComponent_Berth_Stretch_Test::init()
     }
     return false;
 }
+
+bool UILayoutComponent_Dirty_Test::init()
+{
+    if (UILayoutComponentTest::init())
+    {
+        // a panel holding a box inside a box, and a sibling panel
+        auto panel = LayerColor::create(Color4B(200, 100, 0, 255));
+        _baseLayer->addChild(panel);
+        auto panelLayout = LayoutComponent::bindLayoutComponent(panel);
+        panelLayout->setPercentWidthEnabled(true);
+        panelLayout->setPercentHeightEnabled(true);
+        panelLayout->setPercentContentSize(Vec2(0.5f, 0.5f));
+        panelLayout->setHorizontalEdge(LayoutComponent::HorizontalEdge::Left);
+        panelLayout->setVerticalEdge(LayoutComponent::VerticalEdge::Bottom);
+
+        auto box = LayerColor::create(Color4B(0, 100, 200, 255), 60, 60);
+        panel->addChild(box);
+        auto boxLayout = LayoutComponent::bindLayoutComponent(box);
+        boxLayout->setHorizontalEdge(LayoutComponent::HorizontalEdge::Left);
+        boxLayout->setVerticalEdge(LayoutComponent::VerticalEdge::Bottom);
+        boxLayout->setLeftMargin(10);
+        boxLayout->setBottomMargin(10);
+
+        auto innerBox = LayerColor::create(Color4B(0, 200, 100, 255), 20, 20);
+        box->addChild(innerBox);
+        auto innerBoxLayout = LayoutComponent::bindLayoutComponent(innerBox);
+        innerBoxLayout->setHorizontalEdge(LayoutComponent::HorizontalEdge::Right);
+        innerBoxLayout->setVerticalEdge(LayoutComponent::VerticalEdge::Top);
+        innerBoxLayout->setRightMargin(5);
+        innerBoxLayout->setTopMargin(5);
+
+        auto sibling = LayerColor::create(Color4B(100, 100, 100, 255), 40, 40);
+        _baseLayer->addChild(sibling);
+        auto siblingLayout = LayoutComponent::bindLayoutComponent(sibling);
+        siblingLayout->setPositionPercentXEnabled(true);
+        siblingLayout->setPositionPercentYEnabled(true);
+        siblingLayout->setPositionPercentX(0.6f);
+        siblingLayout->setPositionPercentY(0.6f);
+
+        ui::Helper::doLayout(_baseLayer);
+        CCASSERT(!panelLayout->isLayoutDirty() && !boxLayout->isLayoutDirty() && !innerBoxLayout->isLayoutDirty(),
+                 "A refreshed subtree must be clean!");
+        const Vec2 boxPosition = box->getPosition();
+        const Vec2 innerBoxPosition = innerBox->getPosition();
+
+        // moving the sibling only dirties the sibling
+        siblingLayout->setPositionPercentX(0.7f);
+        CCASSERT(siblingLayout->isLayoutDirty() && !panelLayout->isLayoutDirty(), "Only the sibling must be dirty!");
+        siblingLayout->refreshLayout(false);
+
+        // the inner box is moved by hand: a refresh of the clean panel skips it, a forced one puts it back
+        innerBox->setPosition(Vec2::ZERO);
+        panelLayout->refreshLayout(false);
+        CCASSERT(innerBox->getPosition().equals(Vec2::ZERO), "The clean subtree must be skipped!");
+        panelLayout->refreshLayout();
+        CCASSERT(innerBox->getPosition().equals(innerBoxPosition), "A forced refresh must lay out the whole subtree!");
+
+        // resizing the panel lays out its box again, the box keeps its size so its inner box is skipped
+        panelLayout->setPercentWidth(0.8f);
+        CCASSERT(panelLayout->isLayoutDirty(), "The resized panel must be dirty!");
+        box->setPosition(Vec2::ZERO);
+        innerBox->setPosition(Vec2::ZERO);
+        panelLayout->refreshLayout(false);
+        CCASSERT(!panelLayout->isLayoutDirty(), "The panel must be clean once refreshed!");
+        CCASSERT(box->getPosition().equals(boxPosition), "The box of the resized panel must be laid out again!");
+        CCASSERT(innerBox->getPosition().equals(Vec2::ZERO), "The box kept its size, its subtree must be skipped!");
+
+        return true;
+    }
+    return false;
+}
@@ -161,4 +161,12 @@ public:
     CREATE_FUNC(UILayoutComponent_Berth_Stretch_Test);
 };
 
+class UILayoutComponent_Dirty_Test : public UILayoutComponentTest
+{
+public:
+    virtual bool init() override;
+
+    CREATE_FUNC(UILayoutComponent_Dirty_Test);
+};
+
 #endif /* defined(__TestCpp__UILayoutTest__) */
@@ -17,6 +17,7 @@ UIListViewTests::UIListViewTests()
     ADD_TEST_CASE(UIListViewTest_PaddingHorizontal);
     ADD_TEST_CASE(Issue12692);
     ADD_TEST_CASE(Issue8316);
+    ADD_TEST_CASE(UIListViewTest_Virtualized);
 }
 
 // UIListViewTest_Vertical
@@ -1057,3 +1058,69 @@ void UIListViewTest_Padding::sliderEvent(Ref *pSender, Slider::EventType type)
         }
     }
 }
+
+// UIListViewTest_Virtualized
+
+bool UIListViewTest_Virtualized::init()
+{
+    if (!UIScene::init())
+    {
+        return false;
+    }
+    
+    Size layerSize = _uiLayer->getContentSize();
+    static const ssize_t NUMBER_OF_ITEMS = 10000;
+    
+    _titleLabel = Text::create("10000 items, only visible ones are created", font_UIListViewTest, 24);
+    _titleLabel->setAnchorPoint(Vec2::ANCHOR_MIDDLE);
+    _titleLabel->setPosition(Vec2(layerSize / 2) + Vec2(0, layerSize.height / 4 + 30));
+    _uiLayer->addChild(_titleLabel, 3);
+    
+    _listView = ListView::create();
+    _listView->setDirection(ui::ScrollView::Direction::VERTICAL);
+    _listView->setBounceEnabled(true);
+    _listView->setBackGroundImage("cocosui/green_edit.png");
+    _listView->setBackGroundImageScale9Enabled(true);
+    _listView->setContentSize(layerSize / 2);
+    _listView->setScrollBarPositionFromCorner(Vec2(7, 7));
+    _listView->setItemsMargin(2.0f);
+    _listView->setGravity(ListView::Gravity::CENTER_HORIZONTAL);
+    _listView->setAnchorPoint(Vec2::ANCHOR_MIDDLE);
+    _listView->setPosition(layerSize / 2);
+    _uiLayer->addChild(_listView);
+    
+    // The model is cloned only for the rows in view
+    Button* model = Button::create("cocosui/button.png", "cocosui/buttonHighlighted.png");
+    model->setScale9Enabled(true);
+    model->setContentSize(Size(200, 40));
+    _listView->setItemModel(model);
+    
+    _listView->setVirtualizationMargin(40);
+    _listView->setVirtualDataSource(
+        [](ListView*) { return NUMBER_OF_ITEMS; },
+        [](ListView*, ssize_t index) { return Size(200, (index % 3 == 0) ? 60 : 40); },
+        [](ListView*, Widget* item, ssize_t index) {
+            Button* button = static_cast<Button*>(item);
+            button->setContentSize(Size(200, (index % 3 == 0) ? 60 : 40));
+            button->setTitleText(StringUtils::format("Row %d", (int)index));
+        });
+    
+    _listView->addEventListener((ui::ListView::ccListViewCallback)[this](Ref*, ListView::EventType type) {
+        if (type == ListView::EventType::ON_SELECTED_ITEM_END)
+        {
+            _titleLabel->setString(StringUtils::format("Selected row %d", (int)_listView->getCurSelectedIndex()));
+        }
+    });
+    
+    auto button = Button::create("cocosui/backtotoppressed.png", "cocosui/backtotopnormal.png");
+    button->setAnchorPoint(Vec2::ANCHOR_MIDDLE_LEFT);
+    button->setScale(0.8f);
+    button->setPosition(Vec2(layerSize / 2) + Vec2(layerSize.width / 4 + 10, 0));
+    button->setTitleText("Go to 5000");
+    button->addClickEventListener([this](Ref*) {
+        _listView->jumpToItem(5000, Vec2::ANCHOR_MIDDLE, Vec2::ANCHOR_MIDDLE);
+    });
+    _uiLayer->addChild(button);
+    
+    return true;
+}
@@ -216,4 +216,18 @@ public:
     }
 };
 
+
+// Test for a virtualized list with recycled items
+class UIListViewTest_Virtualized : public UIScene
+{
+public:
+    CREATE_FUNC(UIListViewTest_Virtualized);
+    
+    virtual bool init() override;
+    
+protected:
+    cocos2d::ui::ListView* _listView;
+    cocos2d::ui::Text* _titleLabel;
+};
+
 #endif /* defined(__TestCpp__UIListViewTest__) */
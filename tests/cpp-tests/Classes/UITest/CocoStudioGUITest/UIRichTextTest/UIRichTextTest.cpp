@@ -24,6 +24,27 @@ UIRichTextTests::UIRichTextTests()
     ADD_TEST_CASE(UIRichTextXMLShadow);
     ADD_TEST_CASE(UIRichTextXMLGlow);
     ADD_TEST_CASE(UIRichTextXMLExtend);
+    ADD_TEST_CASE(UIRichTextAppend);
+    ADD_TEST_CASE(UIRichTextAppendAligned);
+    ADD_TEST_CASE(UIRichTextBatchCascade);
+}
+
+namespace {
+    // exposes the formatting state of RichText to the tests below
+    class InspectedRichText : public RichText
+    {
+    public:
+        CREATE_FUNC(InspectedRichText);
+
+        Node* getLabelBatchNode() const { return _labelBatchNode; }
+        ssize_t getFormattedElementCount() const { return _formattedElementCount; }
+        bool isFormatTextDirty() const { return _formatTextDirty; }
+    };
+
+    InspectedRichText* inspect(RichText* richText)
+    {
+        return static_cast<InspectedRichText*>(richText);
+    }
 }
 
 
@@ -1755,3 +1776,232 @@ void UIRichTextXMLExtend::switchAlignment(Ref *sender, Widget::TouchEventType ty
 		_richText->setHorizontalAlignment(alignment);
 	}
 }
+
+//
+// UIRichTextAppend
+//
+bool UIRichTextAppend::init()
+{
+    if (UIScene::init())
+    {
+        Size widgetSize = _widget->getContentSize();
+        _appendedCount = 0;
+
+        Text *alert = Text::create("Appended elements are laid out after the others", "fonts/Marker Felt.ttf", 20);
+        alert->setColor(Color3B(159, 168, 176));
+        alert->setPosition(Vec2(widgetSize.width / 2.0f, widgetSize.height / 2.0f - alert->getContentSize().height * 4.5));
+        _widget->addChild(alert);
+
+        Button* button = Button::create("cocosui/animationbuttonnormal.png", "cocosui/animationbuttonpressed.png");
+        button->setTouchEnabled(true);
+        button->setTitleText("append");
+        button->setPosition(Vec2(widgetSize.width / 2, widgetSize.height / 2.0f + button->getContentSize().height * 2.5));
+        button->addTouchEventListener(CC_CALLBACK_2(UIRichTextAppend::appendElement, this));
+        button->setLocalZOrder(10);
+        _widget->addChild(button);
+
+        // RichText
+        _richText = InspectedRichText::create();
+        _richText->ignoreContentAdaptWithSize(false);
+        _richText->setContentSize(Size(120, 100));
+        _richText->pushBackElement(RichElementText::create(0, Color3B::WHITE, 255, "The first line ", "Helvetica", 10));
+        _richText->pushBackElement(RichElementText::create(1, Color3B::YELLOW, 255, "is left aligned. ", "Helvetica", 10));
+        _richText->formatText();
+
+        auto batchNode = inspect(_richText)->getLabelBatchNode();
+        const ssize_t labelCount = batchNode->getChildrenCount();
+        const float height = _richText->getContentSize().height;
+        auto firstLabel = batchNode->getChildren().at(0);
+        firstLabel->retain();
+
+        // appending to a left aligned text keeps the renderers laid out already
+        _richText->pushBackElement(RichElementText::create(2, Color3B::GREEN, 255, "The appended words wrap on the next lines of the rich text. ", "Helvetica", 10));
+        CCASSERT(!inspect(_richText)->isFormatTextDirty(), "Appending to a left aligned text must not dirty the whole text!");
+        CCASSERT(inspect(_richText)->getFormattedElementCount() == 2, "Only the first two elements are formatted yet!");
+
+        _richText->formatText();
+        CCASSERT(inspect(_richText)->getFormattedElementCount() == 3, "The appended element must be formatted!");
+        CCASSERT(firstLabel->getParent() == batchNode, "The first label must be kept in the batch node!");
+        CCASSERT(batchNode->getChildrenCount() > labelCount + 1, "The appended text must wrap on several labels!");
+        CCASSERT(_richText->getContentSize().height > height, "The appended text must add lines!");
+        firstLabel->release();
+
+        _richText->setPosition(Vec2(widgetSize.width / 2, widgetSize.height / 2));
+        _richText->setLocalZOrder(10);
+        _widget->addChild(_richText);
+
+        return true;
+    }
+    return false;
+}
+
+void UIRichTextAppend::appendElement(Ref *pSender, Widget::TouchEventType type)
+{
+    if (type == Widget::TouchEventType::ENDED)
+    {
+        auto text = StringUtils::format("appended %d ", ++_appendedCount);
+        _richText->pushBackElement(RichElementText::create(0, Color3B::ORANGE, 255, text, "Helvetica", 10));
+    }
+}
+
+//
+// UIRichTextAppendAligned
+//
+bool UIRichTextAppendAligned::init()
+{
+    if (UIScene::init())
+    {
+        Size widgetSize = _widget->getContentSize();
+        _appendedCount = 0;
+
+        Text *alert = Text::create("Appending to centered text reformats it", "fonts/Marker Felt.ttf", 20);
+        alert->setColor(Color3B(159, 168, 176));
+        alert->setPosition(Vec2(widgetSize.width / 2.0f, widgetSize.height / 2.0f - alert->getContentSize().height * 4.5));
+        _widget->addChild(alert);
+
+        Button* button = Button::create("cocosui/animationbuttonnormal.png", "cocosui/animationbuttonpressed.png");
+        button->setTouchEnabled(true);
+        button->setTitleText("append");
+        button->setPosition(Vec2(widgetSize.width * 1 / 3, widgetSize.height / 2.0f + button->getContentSize().height * 2.5));
+        button->addTouchEventListener(CC_CALLBACK_2(UIRichTextAppendAligned::appendElement, this));
+        button->setLocalZOrder(10);
+        _widget->addChild(button);
+
+        Button* button2 = Button::create("cocosui/animationbuttonnormal.png", "cocosui/animationbuttonpressed.png");
+        button2->setTouchEnabled(true);
+        button2->setTitleText("alignment");
+        button2->setPosition(Vec2(widgetSize.width * 2 / 3, widgetSize.height / 2.0f + button2->getContentSize().height * 2.5));
+        button2->addTouchEventListener(CC_CALLBACK_2(UIRichTextAppendAligned::switchAlignment, this));
+        button2->setLocalZOrder(10);
+        _widget->addChild(button2);
+
+        // RichText
+        _richText = InspectedRichText::create();
+        _richText->ignoreContentAdaptWithSize(false);
+        _richText->setContentSize(Size(120, 100));
+        _richText->setHorizontalAlignment(RichText::HorizontalAlignment::CENTER);
+        _richText->pushBackElement(RichElementText::create(0, Color3B::WHITE, 255, "The rows ", "Helvetica", 10));
+        _richText->pushBackElement(RichElementText::create(1, Color3B::YELLOW, 255, "are centered. ", "Helvetica", 10));
+        _richText->formatText();
+
+        auto batchNode = inspect(_richText)->getLabelBatchNode();
+        auto firstLabel = batchNode->getChildren().at(0);
+        firstLabel->retain();
+
+        // the rows are realigned, so appending formats everything again
+        _richText->pushBackElement(RichElementText::create(2, Color3B::GREEN, 255, "The appended words wrap and every row is centered again. ", "Helvetica", 10));
+        CCASSERT(inspect(_richText)->isFormatTextDirty(), "Appending to a centered text must dirty the whole text!");
+
+        _richText->formatText();
+        CCASSERT(inspect(_richText)->getFormattedElementCount() == 3, "All the elements must be formatted!");
+        CCASSERT(firstLabel->getParent() == nullptr, "The labels must have been created again!");
+        firstLabel->release();
+
+        // every row is centered in the width of the rich text
+        for (const auto& label : batchNode->getChildren())
+        {
+            CCASSERT(label->getPositionX() >= 0 && label->getPositionX() + label->getContentSize().width <= 120 + 1,
+                     "The rows must fit in the rich text!");
+        }
+
+        _richText->setPosition(Vec2(widgetSize.width / 2, widgetSize.height / 2));
+        _richText->setLocalZOrder(10);
+        _widget->addChild(_richText);
+
+        return true;
+    }
+    return false;
+}
+
+void UIRichTextAppendAligned::appendElement(Ref *pSender, Widget::TouchEventType type)
+{
+    if (type == Widget::TouchEventType::ENDED)
+    {
+        auto text = StringUtils::format("appended %d ", ++_appendedCount);
+        _richText->pushBackElement(RichElementText::create(0, Color3B::ORANGE, 255, text, "Helvetica", 10));
+    }
+}
+
+void UIRichTextAppendAligned::switchAlignment(Ref *sender, Widget::TouchEventType type)
+{
+    if (type == Widget::TouchEventType::ENDED)
+    {
+        auto alignment = _richText->getHorizontalAlignment();
+        alignment = static_cast<RichText::HorizontalAlignment>((static_cast<std::underlying_type<RichText::HorizontalAlignment>::type>(alignment)+1) % 3);
+        _richText->setHorizontalAlignment(alignment);
+    }
+}
+
+//
+// UIRichTextBatchCascade
+//
+bool UIRichTextBatchCascade::init()
+{
+    if (UIScene::init())
+    {
+        Size widgetSize = _widget->getContentSize();
+
+        _urlStatus = Text::create("The url hasn't been opened", "fonts/Marker Felt.ttf", 20);
+        _urlStatus->setColor(Color3B(159, 168, 176));
+        _urlStatus->setPosition(Vec2(widgetSize.width / 2.0f, widgetSize.height / 2.0f - _urlStatus->getContentSize().height * 4.5));
+        _widget->addChild(_urlStatus);
+
+        // RichText
+        _richText = InspectedRichText::create();
+        _richText->ignoreContentAdaptWithSize(false);
+        // wide enough for the link to stay on one label
+        _richText->setContentSize(Size(400, 100));
+        _richText->pushBackElement(RichElementText::create(0, Color3B::WHITE, 255, "Half transparent red text, ", "Helvetica", 14));
+        _richText->pushBackElement(RichElementText::create(1, Color3B::WHITE, 255, "tap this link", "Helvetica", 14,
+                                                           RichElementText::URL_FLAG, "http://www.cocos2d-x.org"));
+        _richText->setOpenUrlHandler([this](const std::string& url) {
+            _urlStatus->setString("Opened " + url);
+        });
+        _richText->setOpacity(128);
+        _richText->setColor(Color3B::RED);
+        _richText->formatText();
+
+        // the opacity and color of the rich text reach the labels through the batch node
+        auto batchNode = inspect(_richText)->getLabelBatchNode();
+        CCASSERT(batchNode->getChildrenCount() > 0, "The text must be rendered by the batch node!");
+        for (const auto& label : batchNode->getChildren())
+        {
+            CCASSERT(label->getDisplayedOpacity() == _richText->getDisplayedOpacity(), "The label must follow the opacity of the rich text!");
+            CCASSERT(label->getDisplayedColor() == _richText->getDisplayedColor(), "The label must follow the color of the rich text!");
+        }
+
+        _richText->setOpacity(255);
+        for (const auto& label : batchNode->getChildren())
+        {
+            CCASSERT(label->getDisplayedOpacity() == 255, "The label must follow the opacity of the rich text!");
+        }
+        _richText->setOpacity(128);
+
+        _richText->setPosition(Vec2(widgetSize.width / 2, widgetSize.height / 2));
+        _richText->setLocalZOrder(10);
+        _widget->addChild(_richText);
+
+        return true;
+    }
+    return false;
+}
+
+void UIRichTextBatchCascade::onEnter()
+{
+    UIScene::onEnter();
+
+    // tap the url label, its touch listener is resumed once it runs
+    auto batchNode = inspect(_richText)->getLabelBatchNode();
+    auto urlLabel = batchNode->getChildren().back();
+    auto location = urlLabel->convertToWorldSpace(Vec2(urlLabel->getContentSize() / 2));
+    location = Director::getInstance()->convertToUI(location);
+
+    Touch touch;
+    touch.setTouchInfo(0, location.x, location.y);
+    EventTouch event;
+    event.setEventCode(EventTouch::EventCode::ENDED);
+    event.setTouches({ &touch });
+    _eventDispatcher->dispatchEvent(&event);
+
+    CCASSERT(_urlStatus->getString() == "Opened http://www.cocos2d-x.org", "The url must be opened by a tap on its label!");
+}
@@ -242,4 +242,44 @@ protected:
     cocos2d::ui::RichText* _richText;
 };
 
+class UIRichTextAppend : public UIScene
+{
+public:
+    CREATE_FUNC(UIRichTextAppend);
+
+    bool init() override;
+    void appendElement(cocos2d::Ref* sender, cocos2d::ui::Widget::TouchEventType type);
+
+protected:
+    cocos2d::ui::RichText* _richText;
+    int _appendedCount;
+};
+
+class UIRichTextAppendAligned : public UIScene
+{
+public:
+    CREATE_FUNC(UIRichTextAppendAligned);
+
+    bool init() override;
+    void appendElement(cocos2d::Ref* sender, cocos2d::ui::Widget::TouchEventType type);
+    void switchAlignment(cocos2d::Ref* sender, cocos2d::ui::Widget::TouchEventType type);
+
+protected:
+    cocos2d::ui::RichText* _richText;
+    int _appendedCount;
+};
+
+class UIRichTextBatchCascade : public UIScene
+{
+public:
+    CREATE_FUNC(UIRichTextBatchCascade);
+
+    bool init() override;
+    virtual void onEnter() override;
+
+protected:
+    cocos2d::ui::RichText* _richText;
+    cocos2d::ui::Text* _urlStatus;
+};
+
 #endif /* defined(__TestCpp__UIRichTextTest__) */
@@ -338,6 +338,38 @@ void RefPtrTest::onEnter()
         CC_ASSERT(theString->getReferenceCount() == 2);
         CC_ASSERT(theString->compare("Hello world!") == 0);
     }
+
+    // TEST(createRefPtr)
+    {
+        auto pool = PoolManager::getInstance()->getCurrentPool();
+        pool->setStatisticsEnabled(true);
+
+        RefPtr<__String> theString = createRefPtr<__String>("Hello world!");
+        CC_ASSERT(theString->getReferenceCount() == 1);
+        CC_ASSERT(theString->compare("Hello world!") == 0);
+        CC_ASSERT(!pool->contains(theString));
+
+        // the RefPtr owns the only reference
+        __String * theStringPtr = theString;
+        theStringPtr->retain();
+        theString.reset();
+        CC_ASSERT(theStringPtr->getReferenceCount() == 1);
+        theStringPtr->release();
+
+        // only the autoreleased objects are counted
+        {
+            AutoreleasePool tempPool;
+            tempPool.setStatisticsEnabled(true);
+            __String::create("Hello");
+            __String::create("World");
+            createRefPtr<__String>("!");
+            tempPool.clear();
+            CC_ASSERT(tempPool.getLastClearCount() == 2);
+            auto stats = tempPool.getLastClearStatistics();
+            CC_ASSERT(stats.size() == 1 && stats[0].second == 2);
+        }
+        pool->setStatisticsEnabled(false);
+    }
 #else
     log("RefPtr tests are not executed in release mode");
 #endif
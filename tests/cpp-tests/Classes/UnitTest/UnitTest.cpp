@@ -2,6 +2,10 @@
 #include "RefPtrTest.h"
 #include "ui/UIHelper.h"
 #include "network/Uri.h"
+#include "base/CCAsyncTaskPool.h"
+#include "renderer/CCRenderCommandPool.h"
+#include "renderer/CCCustomCommand.h"
+#include "base/ZipUtils.h"
 
 USING_NS_CC;
 using namespace cocos2d::network;
@@ -53,6 +57,10 @@ UnitTests::UnitTests()
     ADD_TEST_CASE(UIHelperSubStringTest);
     ADD_TEST_CASE(ParseUriTest);
     ADD_TEST_CASE(ResizableBufferAdapterTest);
+    ADD_TEST_CASE(JobSystemTest);
+    ADD_TEST_CASE(RenderCommandPoolTest);
+    ADD_TEST_CASE(NodeWorldTransformTest);
+    ADD_TEST_CASE(EncryptedCCZTest);
 #ifdef UNIT_TEST_FOR_OPTIMIZED_MATH_UTIL
     ADD_TEST_CASE(MathUtilTest);
 #endif
@@ -607,6 +615,17 @@ void ValueTest::onEnter()
     Value v11(createValueMapIntKey());
     CCASSERT(v11.getType() == Value::Type::INT_KEY_MAP, "v11's value type is Value::Type::INT_KEY_MAP.");
     CCASSERT(!v11.isNull(), "v11 is not null.");
+
+    // short strings are stored in place, long ones in a std::string
+    std::string longString("a string too long to be stored in place");
+    Value v12(longString);
+    Value v13(std::move(longString));
+    CCASSERT(v12 == v13 && v12.asString() == "a string too long to be stored in place", "v12 and v13 should be equal.");
+    CCASSERT(v7 != v8 && v7 == Value(v7) && v7.asString() == "string", "v7 should only be equal to its copy.");
+    v12 = v7;
+    v13 = std::move(v8);
+    CCASSERT(v12 == v7 && v13.asString() == "string2" && v8.isNull(), "v12 should be a copy of v7 and v13 should be string2.");
+    CCASSERT(Value("12").asInt() == 12 && !Value("false").asBool(), "short strings should be converted.");
 }
 
 std::string ValueTest::subtitle() const
@@ -757,6 +776,26 @@ static void doUTFConversion()
     CCASSERT(!StringUtils::isUnicodeSpace(0xFFFF), "StringUtils::isUnicodeSpace failed");
     
     CCASSERT(!StringUtils::isCJKUnicode(0xFFFF) && StringUtils::isCJKUnicode(0x3100), "StringUtils::isCJKUnicode failed");
+
+    //---------------------------
+    // ASCII runs mixed with multi-byte characters, longer than one vector block
+    std::string mixedUTF8 = "abcdefghijklmnopqrstuvwxyz" + originalUTF8 + "0123456789abcdefghij";
+    std::u32string mixedUTF32;
+    isSuccess = StringUtils::UTF8ToUTF32(mixedUTF8, mixedUTF32);
+    CCASSERT(isSuccess && mixedUTF32.length() == TEST_CODE_NUM + 46, "StringUtils::UTF8ToUTF32 failed");
+    CCASSERT(mixedUTF32[25] == 'z' && mixedUTF32[TEST_CODE_NUM + 26] == '0', "StringUtils::UTF8ToUTF32 failed");
+
+    std::string backUTF8;
+    isSuccess = StringUtils::UTF32ToUTF8(mixedUTF32, backUTF8);
+    CCASSERT(isSuccess && backUTF8 == mixedUTF8, "StringUtils::UTF32ToUTF8 failed");
+
+    std::u16string asciiUTF16 = u"0123456789abcdefghijklmnopqrstuvwxyz";
+    isSuccess = StringUtils::UTF16ToUTF8(asciiUTF16, backUTF8);
+    CCASSERT(isSuccess && backUTF8 == "0123456789abcdefghijklmnopqrstuvwxyz", "StringUtils::UTF16ToUTF8 failed");
+
+    // the output is left untouched when the input isn't valid UTF8
+    isSuccess = StringUtils::UTF8ToUTF32("abcdefghijklmnopqrstuvwxyz\xff", mixedUTF32);
+    CCASSERT(!isSuccess && mixedUTF32.length() == TEST_CODE_NUM + 46, "StringUtils::UTF8ToUTF32 failed");
 }
 
 void UTFConversionTest::onEnter()
@@ -1691,3 +1730,257 @@ std::string ResizableBufferAdapterTest::subtitle() const
 }
 
 
+
+// JobSystemTest
+
+void JobSystemTest::onEnter()
+{
+    UnitTestDemo::onEnter();
+
+    auto jobSystem = JobSystem::getInstance();
+    EXPECT_TRUE(jobSystem->getWorkerCount() >= 2);
+
+    // dependencies run before their dependents
+    std::atomic<int> step(0);
+    auto first = jobSystem->schedule([&step]() { step = 1; });
+    auto left = jobSystem->schedule([&step]() { EXPECT_TRUE(step >= 1); }, { first });
+    auto right = jobSystem->schedule([&step]() { EXPECT_TRUE(step >= 1); }, { first });
+    auto last = jobSystem->schedule([&step]() { step = 2; }, { left, right });
+    jobSystem->wait(last);
+    EXPECT_EQ(step.load(), 2);
+    EXPECT_TRUE(jobSystem->isFinished(first));
+
+    // every index is visited exactly once
+    std::vector<int> visits(10000, 0);
+    jobSystem->parallelFor(visits.size(), 64, [&visits](size_t begin, size_t end) {
+        for (size_t i = begin; i < end; ++i)
+            ++visits[i];
+    });
+    for (auto count : visits)
+        EXPECT_EQ(count, 1);
+
+    // continuations on the cocos thread run from the scheduler
+    auto label = Label::createWithSystemFont("waiting for the cocos thread continuation", "", 18);
+    label->setPosition(VisibleRect::center());
+    addChild(label);
+    label->retain();
+    jobSystem->scheduleOnCocosThread([label]() {
+        label->setString("cocos thread continuation called");
+        label->release();
+    }, { last });
+
+    // tasks of a type of the async task pool still run one after the other, in order
+    auto order = std::make_shared<std::vector<int>>();
+    for (int i = 0; i < 16; ++i)
+    {
+        AsyncTaskPool::getInstance()->enqueue(AsyncTaskPool::TaskType::TASK_OTHER, [order, i]() {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+            order->push_back(i);
+        });
+    }
+    AsyncTaskPool::getInstance()->enqueue(AsyncTaskPool::TaskType::TASK_OTHER, [order](void*) {
+        EXPECT_EQ(order->size(), (size_t)16);
+        for (int i = 0; i < (int)order->size(); ++i)
+            EXPECT_EQ((*order)[i], i);
+    }, nullptr, []() {});
+}
+
+std::string JobSystemTest::subtitle() const
+{
+    return "JobSystem Test";
+}
+
+// RenderCommandPoolTest
+
+void RenderCommandPoolTest::onEnter()
+{
+    UnitTestDemo::onEnter();
+
+    const int blockSize = RenderCommandPool<CustomCommand>::COMMANDS_ALLOCATE_BLOCK_SIZE;
+    RenderCommandPool<CustomCommand> pool;
+
+    // the freed commands are handed out again
+    auto first = pool.generateCommand();
+    auto second = pool.generateCommand();
+    EXPECT_NE(first, second);
+    pool.pushBackCommand(second);
+    EXPECT_EQ(pool.generateCommand(), second);
+    pool.pushBackCommand(first);
+    pool.pushBackCommand(second);
+
+    // transient commands are contiguous inside a block and all distinct
+    std::vector<CustomCommand*> frame;
+    for (int i = 0; i < blockSize * 2 + 1; ++i)
+        frame.push_back(pool.generateTransientCommand());
+    EXPECT_EQ(pool.getTransientCommandCount(), (size_t)(blockSize * 2 + 1));
+    for (int i = 1; i < blockSize; ++i)
+        EXPECT_EQ(frame[i], frame[0] + i);
+    auto frameStart = frame[0];
+    std::sort(frame.begin(), frame.end());
+    EXPECT_TRUE(std::unique(frame.begin(), frame.end()) == frame.end());
+
+    // a reset releases them all, the next frame reuses the same memory
+    pool.resetTransientCommands();
+    EXPECT_EQ(pool.getTransientCommandCount(), (size_t)0);
+    EXPECT_EQ(pool.generateTransientCommand(), frameStart);
+    for (int i = 1; i < blockSize * 2 + 1; ++i)
+        EXPECT_TRUE(std::binary_search(frame.begin(), frame.end(), pool.generateTransientCommand()));
+
+    // the per-frame arena of the renderer is cleaned with the render queues
+    auto renderer = Director::getInstance()->getRenderer();
+    auto generation = renderer->getQueueGeneration();
+    EXPECT_NE(generation, 0u);
+    EXPECT_NE(renderer->generateTransientCustomCommand(), renderer->generateTransientCustomCommand());
+    renderer->clean();
+    EXPECT_NE(renderer->getQueueGeneration(), generation);
+}
+
+std::string RenderCommandPoolTest::subtitle() const
+{
+    return "RenderCommandPool Test";
+}
+
+// NodeWorldTransformTest
+
+void NodeWorldTransformTest::onEnter()
+{
+    UnitTestDemo::onEnter();
+
+    auto root = Node::create();
+    auto parent = Node::create();
+    auto child = Node::create();
+    root->addChild(parent);
+    parent->addChild(child);
+    root->setPosition(10, 20);
+    parent->setRotation(90);
+    child->setPosition(5, 0);
+
+    auto nearEqual = [](const Vec2& a, const Vec2& b) { return a.distance(b) < 0.001f; };
+
+    // the cached transform follows the changes of the ancestors
+    EXPECT_TRUE(nearEqual(child->convertToWorldSpace(Vec2::ZERO), Vec2(10, 15)));
+    root->setPosition(0, 0);
+    EXPECT_TRUE(nearEqual(child->convertToWorldSpace(Vec2::ZERO), Vec2(0, -5)));
+    parent->setScale(2);
+    EXPECT_TRUE(nearEqual(child->convertToWorldSpace(Vec2::ZERO), Vec2(0, -10)));
+
+    // and a new parent
+    auto other = Node::create();
+    other->setPosition(100, 100);
+    child->retain();
+    child->removeFromParent();
+    other->addChild(child);
+    child->release();
+    EXPECT_TRUE(nearEqual(child->convertToWorldSpace(Vec2::ZERO), Vec2(105, 100)));
+    EXPECT_TRUE(nearEqual(child->convertToNodeSpace(Vec2(105, 100)), Vec2::ZERO));
+
+    // the batched conversions match the single ones
+    Vec2 points[] = { Vec2(0, 0), Vec2(1, 2), Vec2(-3, 4), Vec2(50, -60) };
+    const ssize_t count = sizeof(points) / sizeof(points[0]);
+    Vec2 worldPoints[count];
+    Vec2 nodePoints[count];
+    child->setRotation(30);
+    child->convertToWorldSpace(points, worldPoints, count);
+    child->convertToNodeSpace(worldPoints, nodePoints, count);
+    for (ssize_t i = 0; i < count; ++i)
+    {
+        EXPECT_TRUE(nearEqual(worldPoints[i], child->convertToWorldSpace(points[i])));
+        EXPECT_TRUE(nearEqual(nodePoints[i], points[i]));
+    }
+}
+
+std::string NodeWorldTransformTest::subtitle() const
+{
+    return "Node world transform cache Test";
+}
+
+// EncryptedCCZTest
+
+namespace {
+    // the long key of ZipUtils, built the same way from the four key parts
+    void makeCCZKey(const unsigned int parts[4], unsigned int key[1024])
+    {
+        memset(key, 0, 1024 * sizeof(unsigned int));
+        unsigned int y, p, e;
+        unsigned int rounds = 6;
+        unsigned int sum = 0;
+        unsigned int z = key[1023];
+        do
+        {
+            sum += 0x9e3779b9;
+            e = (sum >> 2) & 3;
+            for (p = 0; p < 1023; p++)
+            {
+                y = key[p + 1];
+                z = key[p] += (((z>>5^y<<2) + (y>>3^z<<4)) ^ ((sum^y) + (parts[(p&3)^e] ^ z)));
+            }
+            y = key[0];
+            z = key[1023] += (((z>>5^y<<2) + (y>>3^z<<4)) ^ ((sum^y) + (parts[(p&3)^e] ^ z)));
+        } while (--rounds);
+    }
+}
+
+void EncryptedCCZTest::onEnter()
+{
+    UnitTestDemo::onEnter();
+
+    // 38 bytes stored in a zlib stream: 65 bytes of ccz, the last one isn't encrypted
+    const std::string payload = "an encrypted ccz whose size isn't even";
+    std::vector<unsigned char> stream = { 0x78, 0x01, 0x01 };
+    stream.push_back(payload.size() & 0xff);
+    stream.push_back(payload.size() >> 8);
+    stream.push_back(~payload.size() & 0xff);
+    stream.push_back((~payload.size() >> 8) & 0xff);
+    stream.insert(stream.end(), payload.begin(), payload.end());
+    unsigned int a = 1, b = 0;
+    for (unsigned char c : payload)
+    {
+        a = (a + c) % 65521;
+        b = (b + a) % 65521;
+    }
+    const unsigned int adler = (b << 16) | a;
+    for (int shift = 24; shift >= 0; shift -= 8)
+        stream.push_back((adler >> shift) & 0xff);
+
+    std::vector<unsigned char> ccz(sizeof(CCZHeader));
+    ccz.insert(ccz.end(), stream.begin(), stream.end());
+    EXPECT_EQ(ccz.size(), (size_t)65);
+
+    auto header = reinterpret_cast<CCZHeader*>(ccz.data());
+    memcpy(header->sig, "CCZp", 4);
+    header->compression_type = CC_SWAP_INT16_BIG_TO_HOST((unsigned short)CCZ_COMPRESSION_ZLIB);
+    header->version = 0;
+    header->len = CC_SWAP_INT32_BIG_TO_HOST((unsigned int)payload.size());
+
+    // encrypted from the len field, the checksum is the one of the clear ints
+    const size_t enclen = (ccz.size() - 12) / 4;
+    std::vector<unsigned int> ints(enclen);
+    memcpy(ints.data(), ccz.data() + 12, enclen * 4);
+    unsigned int checksum = 0;
+    for (size_t i = 0; i < enclen && i < 128; ++i)
+        checksum ^= ints[i];
+    header->reserved = CC_SWAP_INT32_BIG_TO_HOST(checksum);
+
+    const unsigned int parts[4] = { 0x12345678, 0x9abcdef0, 0x0fedcba9, 0x87654321 };
+    std::vector<unsigned int> key(1024);
+    makeCCZKey(parts, key.data());
+    size_t k = 0;
+    for (size_t i = 0; i < enclen; i += (i < 512 ? 1 : 64))
+    {
+        ints[i] ^= key[k];
+        k = (k + 1) % 1024;
+    }
+    memcpy(ccz.data() + 12, ints.data(), enclen * 4);
+
+    ZipUtils::setPvrEncryptionKey(parts[0], parts[1], parts[2], parts[3]);
+    unsigned char* out = nullptr;
+    int outLength = ZipUtils::inflateCCZBuffer(ccz.data(), ccz.size(), &out);
+    EXPECT_EQ(outLength, (int)payload.size());
+    EXPECT_TRUE(out != nullptr && memcmp(out, payload.data(), payload.size()) == 0);
+    free(out);
+}
+
+std::string EncryptedCCZTest::subtitle() const
+{
+    return "Encrypted CCZ of an odd size";
+}
@@ -79,5 +79,37 @@ public:
     virtual std::string subtitle() const override;
 };
 
+class JobSystemTest : public UnitTestDemo
+{
+public:
+    CREATE_FUNC(JobSystemTest);
+    virtual void onEnter() override;
+    virtual std::string subtitle() const override;
+};
+
+class RenderCommandPoolTest : public UnitTestDemo
+{
+public:
+    CREATE_FUNC(RenderCommandPoolTest);
+    virtual void onEnter() override;
+    virtual std::string subtitle() const override;
+};
+
+class NodeWorldTransformTest : public UnitTestDemo
+{
+public:
+    CREATE_FUNC(NodeWorldTransformTest);
+    virtual void onEnter() override;
+    virtual std::string subtitle() const override;
+};
+
+class EncryptedCCZTest : public UnitTestDemo
+{
+public:
+    CREATE_FUNC(EncryptedCCZTest);
+    virtual void onEnter() override;
+    virtual std::string subtitle() const override;
+};
+
 
 #endif /* __UNIT_TEST__ */
@@ -16,6 +16,7 @@ USING_NS_CC;
 UserDefaultTests::UserDefaultTests()
 {
     ADD_TEST_CASE(UserDefaultTest);
+    ADD_TEST_CASE(UserDefaultBatchTest);
 }
 
 UserDefaultTest::UserDefaultTest()
@@ -177,3 +178,57 @@ UserDefaultTest::~UserDefaultTest()
 }
 
 
+
+UserDefaultBatchTest::UserDefaultBatchTest()
+{
+    auto s = Director::getInstance()->getWinSize();
+    this->_label = Label::createWithTTF("result", "fonts/arial.ttf", 12);
+    addChild(this->_label, 0);
+    this->_label->setPosition(Vec2(s.width / 2, s.height / 2));
+
+    doTest();
+}
+
+void UserDefaultBatchTest::doTest()
+{
+    auto userDefault = UserDefault::getInstance();
+    userDefault->deleteValueForKey("batch_string");
+    userDefault->deleteValueForKey("batch_integer");
+
+    // nested batches, only the outermost commit writes
+    userDefault->beginBatch();
+    userDefault->setStringForKey("batch_string", "batched");
+    userDefault->beginBatch();
+    userDefault->setIntegerForKey("batch_integer", 42);
+    userDefault->commit();
+    CCASSERT(userDefault->isInBatch(), "UserDefault nested batch failed");
+
+    // values of the batch are visible before it is committed
+    CCASSERT(userDefault->getStringForKey("batch_string") == "batched", "UserDefault batch failed");
+    CCASSERT(userDefault->getIntegerForKey("batch_integer") == 42, "UserDefault batch failed");
+
+#if (CC_TARGET_PLATFORM != CC_PLATFORM_IOS && CC_TARGET_PLATFORM != CC_PLATFORM_MAC && CC_TARGET_PLATFORM != CC_PLATFORM_ANDROID)
+    // the xml file isn't written until the batch is committed
+    std::string content = FileUtils::getInstance()->getStringFromFile(UserDefault::getXMLFilePath());
+    CCASSERT(content.find("batch_integer") == std::string::npos, "UserDefault batch wrote the file early");
+#endif
+
+    userDefault->commit(true);
+    CCASSERT(!userDefault->isInBatch(), "UserDefault batch failed");
+
+    // waits for the asynchronous commit
+    userDefault->flush();
+
+#if (CC_TARGET_PLATFORM != CC_PLATFORM_IOS && CC_TARGET_PLATFORM != CC_PLATFORM_MAC && CC_TARGET_PLATFORM != CC_PLATFORM_ANDROID)
+    content = FileUtils::getInstance()->getStringFromFile(UserDefault::getXMLFilePath());
+    CCASSERT(content.find("batch_integer") != std::string::npos, "UserDefault commit didn't write the file");
+#endif
+
+    char strTemp[256] = "";
+    sprintf(strTemp, "batch_string is %s\nbatch_integer is %d",
+            userDefault->getStringForKey("batch_string").c_str(), userDefault->getIntegerForKey("batch_integer"));
+    this->_label->setString(strTemp);
+
+    userDefault->deleteValueForKey("batch_string");
+    userDefault->deleteValueForKey("batch_integer");
+}
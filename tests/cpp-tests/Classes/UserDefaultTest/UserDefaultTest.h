@@ -20,4 +20,17 @@ private:
     cocos2d::Label* _label;
 };
 
+class UserDefaultBatchTest : public TestCase
+{
+public:
+    CREATE_FUNC(UserDefaultBatchTest);
+    UserDefaultBatchTest();
+
+    virtual std::string title() const override { return "UserDefault batched writes"; }
+
+private:
+    void doTest();
+    cocos2d::Label* _label;
+};
+
 #endif // _USERDEFAULT_TEST_H_
@@ -336,9 +336,9 @@ void Effect3DOutline::draw(const Mat4 &transform)
     _glProgramState->setUniformVec4("u_color", Vec4(color.r, color.g, color.b, color.a));
     if(_sprite && _sprite->getMesh())
     {
-        glEnable(GL_CULL_FACE);
-        glCullFace(GL_FRONT);
-        glEnable(GL_DEPTH_TEST);
+        GL::enable(GL_CULL_FACE);
+        GL::cullFace(GL_FRONT);
+        GL::enable(GL_DEPTH_TEST);
 
         auto mesh = _sprite->getMesh();
         glBindBuffer(GL_ARRAY_BUFFER, mesh->getVertexBuffer());
@@ -360,9 +360,9 @@ void Effect3DOutline::draw(const Mat4 &transform)
 
         glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
         glBindBuffer(GL_ARRAY_BUFFER, 0);
-        glDisable(GL_DEPTH_TEST);
-        glCullFace(GL_BACK);
-        glDisable(GL_CULL_FACE);
+        GL::disable(GL_DEPTH_TEST);
+        GL::cullFace(GL_BACK);
+        GL::disable(GL_CULL_FACE);
     }
 }
 
@@ -136,6 +136,17 @@ var LocalStorageTest = SysTestBase.extend({
         cc.log( ls.getItem(key1) );
         cc.log( ls.getItem(key2) );
         cc.log( ls.getItem(key3) );
+
+        // native only, the items of a batch are written in one transaction
+        if (ls.beginBatch) {
+            cc.log("- Adding items in a batch");
+            ls.beginBatch();
+            for (var i = 0; i < 100; i++)
+                ls.setItem(key + i, "Hello batch " + i);
+            ls.commitBatch();
+            cc.log( ls.getItem(key + 99) );
+            ls.clear();
+        }
     }
 
 });
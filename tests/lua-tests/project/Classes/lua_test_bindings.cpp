@@ -201,7 +201,7 @@ void DrawNode3D::onDraw(const Mat4 &transform, uint32_t flags)
     auto glProgram = getGLProgram();
     glProgram->use();
     glProgram->setUniformsForBuiltins(transform);
-    glEnable(GL_DEPTH_TEST);
+    GL::enable(GL_DEPTH_TEST);
     GL::blendFunc(_blendFunc.src, _blendFunc.dst);
     
     if (_dirty)
@@ -230,7 +230,7 @@ void DrawNode3D::onDraw(const Mat4 &transform, uint32_t flags)
     glBindBuffer(GL_ARRAY_BUFFER, 0);
     
     CC_INCREMENT_GL_DRAWN_BATCHES_AND_VERTICES(1,_bufferCount);
-	glDisable(GL_DEPTH_TEST);
+	GL::disable(GL_DEPTH_TEST);
     CHECK_GL_ERROR_DEBUG();
 }
 
@@ -0,0 +1,182 @@
+/****************************************************************************
+Copyright (c) 2017 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#include "BenchmarkRunner.h"
+#include "cocos2d.h"
+
+USING_NS_CC;
+
+#define LISTENER_COUNT 100
+#define TIMER_COUNT 1000
+#define SEARCH_PATH_COUNT 5
+
+template <typename T>
+static std::shared_ptr<T> adoptRef(T* object)
+{
+    return std::shared_ptr<T>(object, [](T* ref) { ref->release(); });
+}
+
+static void addEventDispatcherBenchmarks(BenchmarkRunner& runner)
+{
+    auto dispatcher = adoptRef(new (std::nothrow) EventDispatcher());
+    dispatcher->setEnabled(true);
+
+    auto counter = std::make_shared<int>(0);
+    for (int i = 0; i < LISTENER_COUNT; ++i)
+    {
+        dispatcher->addCustomEventListener("benchmark_event", [counter](EventCustom*) {
+            ++*counter;
+        });
+        // the other events make the lookup by name realistic
+        dispatcher->addCustomEventListener(StringUtils::format("benchmark_event_%d", i), [counter](EventCustom*) {
+            ++*counter;
+        });
+    }
+
+    runner.add("EventDispatcher::dispatchCustomEvent by name, 100 listeners", [dispatcher, counter](int iterations) {
+        for (int i = 0; i < iterations; ++i)
+        {
+            dispatcher->dispatchCustomEvent("benchmark_event");
+        }
+        doNotOptimize(*counter);
+    });
+
+    int eventID = dispatcher->getCustomEventID("benchmark_event");
+    runner.add("EventDispatcher::dispatchCustomEvent by id, 100 listeners", [dispatcher, counter, eventID](int iterations) {
+        for (int i = 0; i < iterations; ++i)
+        {
+            dispatcher->dispatchCustomEvent(eventID);
+        }
+        doNotOptimize(*counter);
+    });
+
+    runner.add("EventDispatcher::dispatchCustomEvent no listener", [dispatcher](int iterations) {
+        for (int i = 0; i < iterations; ++i)
+        {
+            dispatcher->dispatchCustomEvent("benchmark_no_listener");
+        }
+    });
+}
+
+static std::shared_ptr<Scheduler> createScheduler(float interval, std::shared_ptr<int> counter)
+{
+    auto scheduler = adoptRef(new (std::nothrow) Scheduler());
+    // any distinct addresses can be targets
+    auto targets = std::make_shared<std::vector<char>>(TIMER_COUNT);
+    for (int i = 0; i < TIMER_COUNT; ++i)
+    {
+        scheduler->schedule([counter, targets](float) {
+            ++*counter;
+        }, &(*targets)[i], interval, false, "benchmark");
+    }
+    return scheduler;
+}
+
+static void addSchedulerBenchmarks(BenchmarkRunner& runner)
+{
+    auto counter = std::make_shared<int>(0);
+
+    auto everyFrame = createScheduler(0, counter);
+    runner.add("Scheduler::update 1000 timers every frame", [everyFrame, counter](int iterations) {
+        for (int i = 0; i < iterations; ++i)
+        {
+            everyFrame->update(1 / 60.0f);
+        }
+        doNotOptimize(*counter);
+    });
+
+    // most of them are only ticked
+    auto everySecond = createScheduler(1, counter);
+    runner.add("Scheduler::update 1000 timers every second", [everySecond, counter](int iterations) {
+        for (int i = 0; i < iterations; ++i)
+        {
+            everySecond->update(1 / 60.0f);
+        }
+        doNotOptimize(*counter);
+    });
+}
+
+static void addFileUtilsBenchmarks(BenchmarkRunner& runner)
+{
+    auto fileUtils = FileUtils::getInstance();
+    auto root = fileUtils->getWritablePath() + "micro-benchmarks/";
+
+    // the file is only found in the last search path
+    auto searchPaths = std::make_shared<std::vector<std::string>>();
+    for (int i = 0; i < SEARCH_PATH_COUNT; ++i)
+    {
+        auto path = StringUtils::format("%ssearch%d/", root.c_str(), i);
+        fileUtils->createDirectory(path);
+        searchPaths->push_back(path);
+    }
+    fileUtils->writeStringToFile("benchmark", searchPaths->back() + "file.txt");
+
+    auto withSearchPaths = [searchPaths](const std::function<void()>& function) {
+        auto fileUtils = FileUtils::getInstance();
+        auto oldSearchPaths = fileUtils->getSearchPaths();
+        fileUtils->setSearchPaths(*searchPaths);
+        function();
+        fileUtils->setSearchPaths(oldSearchPaths);
+    };
+
+    runner.add("FileUtils::fullPathForFilename cached", [withSearchPaths](int iterations) {
+        withSearchPaths([iterations]() {
+            auto fileUtils = FileUtils::getInstance();
+            for (int i = 0; i < iterations; ++i)
+            {
+                auto path = fileUtils->fullPathForFilename("file.txt");
+                doNotOptimize(path);
+            }
+        });
+    });
+
+    runner.add("FileUtils::fullPathForFilename uncached, 5 search paths", [withSearchPaths](int iterations) {
+        withSearchPaths([iterations]() {
+            auto fileUtils = FileUtils::getInstance();
+            for (int i = 0; i < iterations; ++i)
+            {
+                fileUtils->purgeCachedEntries();
+                auto path = fileUtils->fullPathForFilename("file.txt");
+                doNotOptimize(path);
+            }
+        });
+    });
+
+    runner.add("FileUtils::fullPathForFilename absolute", [searchPaths](int iterations) {
+        auto fileUtils = FileUtils::getInstance();
+        auto fullPath = searchPaths->back() + "file.txt";
+        for (int i = 0; i < iterations; ++i)
+        {
+            auto path = fileUtils->fullPathForFilename(fullPath);
+            doNotOptimize(path);
+        }
+    });
+}
+
+void addBaseBenchmarks(BenchmarkRunner& runner)
+{
+    addEventDispatcherBenchmarks(runner);
+    addSchedulerBenchmarks(runner);
+    addFileUtilsBenchmarks(runner);
+}
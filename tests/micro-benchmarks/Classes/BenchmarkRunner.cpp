@@ -0,0 +1,160 @@
+/****************************************************************************
+Copyright (c) 2017 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#include "BenchmarkRunner.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "cocos2d.h"
+
+#define MAX_ITERATIONS (1 << 30)
+
+BenchmarkRunner::Options::Options()
+: repetitions(10)
+, minTimeMs(50)
+{
+}
+
+void BenchmarkRunner::parseArguments(int argc, char* argv[], Options* options)
+{
+    for (int i = 1; i < argc; ++i)
+    {
+        bool hasValue = i + 1 < argc;
+
+        if (strcmp(argv[i], "--filter") == 0 && hasValue)
+            options->filter = argv[++i];
+        else if (strcmp(argv[i], "--repetitions") == 0 && hasValue)
+            options->repetitions = std::max(1, atoi(argv[++i]));
+        else if (strcmp(argv[i], "--min-time") == 0 && hasValue)
+            options->minTimeMs = std::max(1.0, atof(argv[++i]));
+        else if (strcmp(argv[i], "--json") == 0 && hasValue)
+            options->jsonPath = argv[++i];
+        else
+            fprintf(stderr, "Unknown argument: %s\n", argv[i]);
+    }
+}
+
+void BenchmarkRunner::add(const std::string& name, const Function& function)
+{
+    _benchmarks.push_back(std::make_pair(name, function));
+}
+
+static double measureMs(const BenchmarkRunner::Function& function, int iterations)
+{
+    auto begin = std::chrono::steady_clock::now();
+    function(iterations);
+    auto end = std::chrono::steady_clock::now();
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(end - begin).count() / 1000000.0;
+}
+
+BenchmarkRunner::Result BenchmarkRunner::runBenchmark(const std::string& name, const Function& function, const Options& options)
+{
+    // the first runs also warm up the caches
+    int iterations = 1;
+    double elapsedMs = measureMs(function, iterations);
+    while (elapsedMs < options.minTimeMs && iterations < MAX_ITERATIONS)
+    {
+        double scale = elapsedMs > 0 ? options.minTimeMs / elapsedMs * 1.2 : 10;
+        iterations = (int)std::min((double)MAX_ITERATIONS, std::max(iterations * 2.0, std::min(iterations * scale, iterations * 10.0)));
+        elapsedMs = measureMs(function, iterations);
+    }
+
+    std::vector<double> samples;
+    for (int i = 0; i < options.repetitions; ++i)
+    {
+        samples.push_back(measureMs(function, iterations) * 1000000.0 / iterations);
+    }
+    std::sort(samples.begin(), samples.end());
+
+    double sum = 0;
+    for (auto sample : samples)
+    {
+        sum += sample;
+    }
+    double mean = sum / samples.size();
+
+    double variance = 0;
+    for (auto sample : samples)
+    {
+        variance += (sample - mean) * (sample - mean);
+    }
+    variance /= samples.size();
+
+    Result result;
+    result.name = name;
+    result.iterations = iterations;
+    result.minNs = samples.front();
+    result.medianNs = samples[samples.size() / 2];
+    result.meanNs = mean;
+    result.stddevNs = std::sqrt(variance);
+    return result;
+}
+
+int BenchmarkRunner::run(const Options& options)
+{
+    std::vector<Result> results;
+
+    printf("%-60s %12s %12s %12s %8s %12s\n", "benchmark", "min ns", "median ns", "mean ns", "stddev", "iterations");
+    for (auto& benchmark : _benchmarks)
+    {
+        if (!options.filter.empty() && benchmark.first.find(options.filter) == std::string::npos)
+            continue;
+
+        auto result = runBenchmark(benchmark.first, benchmark.second, options);
+        printf("%-60s %12.1f %12.1f %12.1f %7.1f%% %12d\n", result.name.c_str(), result.minNs, result.medianNs, result.meanNs,
+               result.meanNs > 0 ? result.stddevNs * 100 / result.meanNs : 0, result.iterations);
+        fflush(stdout);
+        results.push_back(result);
+    }
+
+    if (!options.jsonPath.empty() && !writeJson(results, options))
+    {
+        fprintf(stderr, "Can't write %s\n", options.jsonPath.c_str());
+        return 1;
+    }
+    return 0;
+}
+
+bool BenchmarkRunner::writeJson(const std::vector<Result>& results, const Options& options)
+{
+    FILE* fp = fopen(options.jsonPath.c_str(), "w");
+    if (fp == nullptr)
+        return false;
+
+    // the names are ours, they don't need to be escaped
+    fprintf(fp, "{\"engineVersion\":\"%s\",\"repetitions\":%d,\"minTimeMs\":%g,\"benchmarks\":[",
+            cocos2d::cocos2dVersion(), options.repetitions, options.minTimeMs);
+    for (size_t i = 0; i < results.size(); ++i)
+    {
+        const auto& result = results[i];
+        fprintf(fp, "%s{\"name\":\"%s\",\"iterations\":%d,\"minNs\":%.3f,\"medianNs\":%.3f,\"meanNs\":%.3f,\"stddevNs\":%.3f}",
+                i > 0 ? "," : "", result.name.c_str(), result.iterations, result.minNs, result.medianNs, result.meanNs, result.stddevNs);
+    }
+    fprintf(fp, "]}\n");
+    fclose(fp);
+    return true;
+}
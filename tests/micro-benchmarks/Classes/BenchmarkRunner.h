@@ -0,0 +1,104 @@
+/****************************************************************************
+Copyright (c) 2017 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#ifndef __MICRO_BENCHMARKS_BENCHMARK_RUNNER_H__
+#define __MICRO_BENCHMARKS_BENCHMARK_RUNNER_H__
+
+#include <functional>
+#include <string>
+#include <vector>
+
+/**
+ * Keeps the compiler from optimizing away a value computed by a benchmark.
+ */
+template <typename T>
+inline void doNotOptimize(const T& value)
+{
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(value) : "memory");
+#else
+    static volatile const void* s_sink;
+    s_sink = &value;
+#endif
+}
+
+/**
+ * Runs the registered benchmarks and reports the time of one operation in nanoseconds.
+ *
+ * The iterations of a benchmark are calibrated until one repetition lasts `minTimeMs`, then it's repeated
+ * `repetitions` times after a warmup repetition. The min, median, mean and standard deviation of the
+ * repetitions are reported, so two runs on the same machine can be compared.
+ */
+class BenchmarkRunner
+{
+public:
+    /** Runs the operation `iterations` times.*/
+    typedef std::function<void(int iterations)> Function;
+
+    struct Options
+    {
+        Options();
+
+        /** Only the benchmarks whose name contains it run, "--filter TEXT".*/
+        std::string filter;
+        /** "--repetitions N".*/
+        int repetitions;
+        /** The minimum time of a repetition, "--min-time MS".*/
+        double minTimeMs;
+        /** File of the JSON report, none if empty, "--json PATH".*/
+        std::string jsonPath;
+    };
+
+    /** Parses the command line arguments into the options.*/
+    static void parseArguments(int argc, char* argv[], Options* options);
+
+    void add(const std::string& name, const Function& function);
+
+    /** Runs the benchmarks, returns 0 on success.*/
+    int run(const Options& options);
+
+private:
+    struct Result
+    {
+        std::string name;
+        int iterations;
+        double minNs;
+        double medianNs;
+        double meanNs;
+        double stddevNs;
+    };
+
+    Result runBenchmark(const std::string& name, const Function& function, const Options& options);
+    bool writeJson(const std::vector<Result>& results, const Options& options);
+
+    std::vector<std::pair<std::string, Function>> _benchmarks;
+};
+
+// each file of benchmarks adds its own ones
+void addMathBenchmarks(BenchmarkRunner& runner);
+void addContainerBenchmarks(BenchmarkRunner& runner);
+void addRendererBenchmarks(BenchmarkRunner& runner);
+void addBaseBenchmarks(BenchmarkRunner& runner);
+
+#endif // __MICRO_BENCHMARKS_BENCHMARK_RUNNER_H__
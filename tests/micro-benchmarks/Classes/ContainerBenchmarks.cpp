@@ -0,0 +1,139 @@
+/****************************************************************************
+Copyright (c) 2017 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#include "BenchmarkRunner.h"
+#include "cocos2d.h"
+
+USING_NS_CC;
+
+#define ELEMENT_COUNT 1000
+
+void addContainerBenchmarks(BenchmarkRunner& runner)
+{
+    // the containers retain the nodes, and the benchmarks the containers
+    std::vector<Node*> nodes;
+    auto vector = std::make_shared<Vector<Node*>>();
+    auto map = std::make_shared<Map<std::string, Node*>>();
+    for (int i = 0; i < ELEMENT_COUNT; ++i)
+    {
+        auto node = Node::create();
+        node->setName(StringUtils::format("node%d", i));
+        nodes.push_back(node);
+        vector->pushBack(node);
+        map->insert(node->getName(), node);
+    }
+
+    runner.add("Vector<Node*>::pushBack+clear 1000", [vector, nodes](int iterations) {
+        Vector<Node*> values;
+        for (int i = 0; i < iterations; ++i)
+        {
+            for (auto node : nodes)
+            {
+                values.pushBack(node);
+            }
+            values.clear();
+        }
+    });
+
+    runner.add("Vector<Node*>::pushBack+clear reserved 1000", [vector, nodes](int iterations) {
+        Vector<Node*> values(ELEMENT_COUNT);
+        for (int i = 0; i < iterations; ++i)
+        {
+            for (auto node : nodes)
+            {
+                values.pushBack(node);
+            }
+            values.clear();
+        }
+    });
+
+    runner.add("Vector<Node*>::iterate 1000", [vector](int iterations) {
+        for (int i = 0; i < iterations; ++i)
+        {
+            int tags = 0;
+            for (auto node : *vector)
+            {
+                tags += node->getTag();
+            }
+            doNotOptimize(tags);
+        }
+    });
+
+    runner.add("Vector<Node*>::getIndex 1000", [vector, nodes](int iterations) {
+        for (int i = 0; i < iterations; ++i)
+        {
+            auto index = vector->getIndex(nodes[i % ELEMENT_COUNT]);
+            doNotOptimize(index);
+        }
+    });
+
+    runner.add("Vector<Node*>::insert+erase front 1000", [vector, nodes](int iterations) {
+        for (int i = 0; i < iterations; ++i)
+        {
+            vector->insert(0, nodes[i % ELEMENT_COUNT]);
+            vector->erase(0);
+        }
+    });
+
+    runner.add("Map<std::string,Node*>::insert+clear 1000", [map, nodes](int iterations) {
+        Map<std::string, Node*> values;
+        for (int i = 0; i < iterations; ++i)
+        {
+            for (auto node : nodes)
+            {
+                values.insert(node->getName(), node);
+            }
+            values.clear();
+        }
+    });
+
+    runner.add("Map<std::string,Node*>::at 1000", [map, nodes](int iterations) {
+        for (int i = 0; i < iterations; ++i)
+        {
+            auto node = map->at(nodes[i % ELEMENT_COUNT]->getName());
+            doNotOptimize(node);
+        }
+    });
+
+    runner.add("Map<std::string,Node*>::find missing 1000", [map](int iterations) {
+        std::string key = "missing";
+        for (int i = 0; i < iterations; ++i)
+        {
+            auto found = map->find(key) != map->end();
+            doNotOptimize(found);
+        }
+    });
+
+    runner.add("Map<std::string,Node*>::iterate 1000", [map](int iterations) {
+        for (int i = 0; i < iterations; ++i)
+        {
+            int tags = 0;
+            for (auto& pair : *map)
+            {
+                tags += pair.second->getTag();
+            }
+            doNotOptimize(tags);
+        }
+    });
+}
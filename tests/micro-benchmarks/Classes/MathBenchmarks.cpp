@@ -0,0 +1,201 @@
+/****************************************************************************
+Copyright (c) 2017 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#include "BenchmarkRunner.h"
+#include "cocos2d.h"
+
+// the scalar and NEON implementations are inline classes, they can be measured on their own.
+// the SSE one is only reachable through Mat4.
+#include "math/MathUtil.inl"
+#if defined(__aarch64__) || defined(__arm64__)
+#define BENCHMARK_NEON64
+#include "math/MathUtilNeon64.inl"
+#elif defined(__ARM_NEON__)
+#define BENCHMARK_NEON32
+#include "math/MathUtilNeon.inl"
+#endif
+
+USING_NS_CC;
+
+// enough different values that nothing is folded, small enough to stay in the L1 cache
+#define VALUE_COUNT 64
+// the vertices of 64 quads
+#define VERTEX_COUNT 256
+
+static std::vector<Mat4> createMatrices()
+{
+    std::vector<Mat4> matrices(VALUE_COUNT);
+    for (int i = 0; i < VALUE_COUNT; ++i)
+    {
+        Mat4::createRotation(Vec3(1, i, 2).getNormalized(), i * 0.1f, &matrices[i]);
+        matrices[i].translate(i, -i, i * 0.5f);
+        matrices[i].scale(1 + i * 0.01f);
+    }
+    return matrices;
+}
+
+static std::vector<Vec3> createVectors()
+{
+    std::vector<Vec3> vectors(VALUE_COUNT);
+    for (int i = 0; i < VALUE_COUNT; ++i)
+    {
+        vectors[i] = Vec3(i + 1.0f, i * 0.5f - 3, 7.0f - i);
+    }
+    return vectors;
+}
+
+void addMathBenchmarks(BenchmarkRunner& runner)
+{
+    auto matrices = createMatrices();
+    auto vectors = createVectors();
+
+    runner.add("Mat4::multiply", [matrices](int iterations) {
+        Mat4 dst;
+        for (int i = 0; i < iterations; ++i)
+        {
+            Mat4::multiply(matrices[i % VALUE_COUNT], matrices[(i + 1) % VALUE_COUNT], &dst);
+            doNotOptimize(dst);
+        }
+    });
+
+    runner.add("MathUtilC::multiplyMatrix (scalar)", [matrices](int iterations) {
+        Mat4 dst;
+        for (int i = 0; i < iterations; ++i)
+        {
+            MathUtilC::multiplyMatrix(matrices[i % VALUE_COUNT].m, matrices[(i + 1) % VALUE_COUNT].m, dst.m);
+            doNotOptimize(dst);
+        }
+    });
+
+#if defined(BENCHMARK_NEON64)
+    runner.add("MathUtilNeon64::multiplyMatrix", [matrices](int iterations) {
+        Mat4 dst;
+        for (int i = 0; i < iterations; ++i)
+        {
+            MathUtilNeon64::multiplyMatrix(matrices[i % VALUE_COUNT].m, matrices[(i + 1) % VALUE_COUNT].m, dst.m);
+            doNotOptimize(dst);
+        }
+    });
+#elif defined(BENCHMARK_NEON32)
+    if (MathUtil::isNeon32Enabled())
+    {
+        runner.add("MathUtilNeon::multiplyMatrix", [matrices](int iterations) {
+            Mat4 dst;
+            for (int i = 0; i < iterations; ++i)
+            {
+                MathUtilNeon::multiplyMatrix(matrices[i % VALUE_COUNT].m, matrices[(i + 1) % VALUE_COUNT].m, dst.m);
+                doNotOptimize(dst);
+            }
+        });
+    }
+#endif
+
+    runner.add("Mat4::transformPoint", [matrices, vectors](int iterations) {
+        Vec3 dst;
+        for (int i = 0; i < iterations; ++i)
+        {
+            matrices[i % VALUE_COUNT].transformPoint(vectors[i % VALUE_COUNT], &dst);
+            doNotOptimize(dst);
+        }
+    });
+
+    // the positions of a batch of sprite vertices, the way Renderer::fillVerticesAndIndices() transforms them
+    std::vector<V3F_C4B_T2F> vertices(VERTEX_COUNT);
+    for (int i = 0; i < VERTEX_COUNT; ++i)
+    {
+        vertices[i].vertices = vectors[i % VALUE_COUNT];
+    }
+
+    runner.add("Mat4::transformPoint (256 vertices)", [matrices, vertices](int iterations) {
+        auto dst = vertices;
+        for (int i = 0; i < iterations; ++i)
+        {
+            const Mat4& matrix = matrices[i % VALUE_COUNT];
+            for (auto& vertex : dst)
+            {
+                matrix.transformPoint(&vertex.vertices);
+            }
+            doNotOptimize(dst[0]);
+        }
+    });
+
+    runner.add("Mat4::transformPoints (256 vertices)", [matrices, vertices](int iterations) {
+        auto dst = vertices;
+        for (int i = 0; i < iterations; ++i)
+        {
+            matrices[i % VALUE_COUNT].transformPoints(&dst[0].vertices, dst.size(), sizeof(V3F_C4B_T2F));
+            doNotOptimize(dst[0]);
+        }
+    });
+
+    runner.add("Mat4::inverse", [matrices](int iterations) {
+        for (int i = 0; i < iterations; ++i)
+        {
+            auto dst = matrices[i % VALUE_COUNT].getInversed();
+            doNotOptimize(dst);
+        }
+    });
+
+    runner.add("Vec3::add+scale", [vectors](int iterations) {
+        Vec3 dst;
+        for (int i = 0; i < iterations; ++i)
+        {
+            dst = vectors[i % VALUE_COUNT] + vectors[(i + 1) % VALUE_COUNT] * 0.5f;
+            doNotOptimize(dst);
+        }
+    });
+
+    runner.add("Vec3::dot", [vectors](int iterations) {
+        for (int i = 0; i < iterations; ++i)
+        {
+            float dot = vectors[i % VALUE_COUNT].dot(vectors[(i + 1) % VALUE_COUNT]);
+            doNotOptimize(dot);
+        }
+    });
+
+    runner.add("Vec3::cross", [vectors](int iterations) {
+        Vec3 dst;
+        for (int i = 0; i < iterations; ++i)
+        {
+            Vec3::cross(vectors[i % VALUE_COUNT], vectors[(i + 1) % VALUE_COUNT], &dst);
+            doNotOptimize(dst);
+        }
+    });
+
+    runner.add("Vec3::normalize", [vectors](int iterations) {
+        for (int i = 0; i < iterations; ++i)
+        {
+            auto dst = vectors[i % VALUE_COUNT].getNormalized();
+            doNotOptimize(dst);
+        }
+    });
+
+    runner.add("Vec3::distance", [vectors](int iterations) {
+        for (int i = 0; i < iterations; ++i)
+        {
+            float distance = vectors[i % VALUE_COUNT].distance(vectors[(i + 1) % VALUE_COUNT]);
+            doNotOptimize(distance);
+        }
+    });
+}
@@ -0,0 +1,148 @@
+/****************************************************************************
+Copyright (c) 2017 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#include "BenchmarkRunner.h"
+#include "cocos2d.h"
+
+USING_NS_CC;
+
+#define COMMAND_COUNT 1000
+
+namespace {
+
+// exposes the batching internals
+class BenchmarkRenderer : public Renderer
+{
+public:
+    void fill(const std::vector<TrianglesCommand*>& commands)
+    {
+        _filledVertex = 0;
+        _filledIndex = 0;
+        for (auto command : commands)
+        {
+            fillVerticesAndIndices(command);
+        }
+    }
+};
+
+struct QuadCommands
+{
+    QuadCommands()
+    : commands(COMMAND_COUNT)
+    , indices{ 0, 1, 2, 3, 2, 1 }
+    {
+        V3F_C4B_T2F vertex;
+        vertex.colors = Color4B::WHITE;
+        vertex.vertices = Vec3(0, 0, 0);
+        vertex.texCoords = Tex2F(0, 0);
+        vertices[0] = vertex;
+        vertex.vertices = Vec3(32, 0, 0);
+        vertex.texCoords = Tex2F(1, 0);
+        vertices[1] = vertex;
+        vertex.vertices = Vec3(0, 32, 0);
+        vertex.texCoords = Tex2F(0, 1);
+        vertices[2] = vertex;
+        vertex.vertices = Vec3(32, 32, 0);
+        vertex.texCoords = Tex2F(1, 1);
+        vertices[3] = vertex;
+
+        TrianglesCommand::Triangles triangles;
+        triangles.verts = vertices;
+        triangles.vertCount = 4;
+        triangles.indices = indices;
+        triangles.indexCount = 6;
+
+        auto glProgramState = GLProgramState::getOrCreateWithGLProgramName(GLProgram::SHADER_NAME_POSITION_TEXTURE_COLOR_NO_MVP);
+        for (int i = 0; i < COMMAND_COUNT; ++i)
+        {
+            Mat4 transform;
+            Mat4::createTranslation(i % 40 * 24.0f, i / 40 * 24.0f, 0, &transform);
+            commandPointers.push_back(&commands[i]);
+            commands[i].init(0.0f, (GLuint)0, glProgramState, BlendFunc::ALPHA_PREMULTIPLIED, triangles, transform, 0u);
+        }
+    }
+
+    std::vector<TrianglesCommand> commands;
+    std::vector<TrianglesCommand*> commandPointers;
+    V3F_C4B_T2F vertices[4];
+    unsigned short indices[6];
+};
+
+struct SortCommands
+{
+    SortCommands()
+    : commands(COMMAND_COUNT)
+    {
+        // the mix of a scene: most in the 0 queue, some ordered 2D ones and a few 3D ones
+        std::srand(1);
+        for (int i = 0; i < COMMAND_COUNT; ++i)
+        {
+            auto& command = commands[i];
+            int kind = std::rand() % 10;
+            if (kind < 6)
+                command.init(0);
+            else if (kind < 8)
+                command.init((float)(std::rand() % 100 - 50));
+            else
+            {
+                Mat4 transform;
+                Mat4::createTranslation(0, 0, (float)(std::rand() % 1000), &transform);
+                // no camera is visited, so they all have the same depth
+                command.init(0, transform, Node::FLAGS_RENDER_AS_3D);
+                command.setTransparent(kind == 9);
+            }
+        }
+    }
+
+    std::vector<CustomCommand> commands;
+};
+
+}
+
+void addRendererBenchmarks(BenchmarkRunner& runner)
+{
+    auto sortCommands = std::make_shared<SortCommands>();
+    runner.add("RenderQueue::push_back+sort 1000", [sortCommands](int iterations) {
+        RenderQueue queue;
+        for (int i = 0; i < iterations; ++i)
+        {
+            queue.clear();
+            for (auto& command : sortCommands->commands)
+            {
+                queue.push_back(&command);
+            }
+            queue.sort();
+            doNotOptimize(queue);
+        }
+    });
+
+    auto quadCommands = std::make_shared<QuadCommands>();
+    auto renderer = std::make_shared<BenchmarkRenderer>();
+    runner.add("Renderer::fillVerticesAndIndices 1000 quads", [quadCommands, renderer](int iterations) {
+        for (int i = 0; i < iterations; ++i)
+        {
+            renderer->fill(quadCommands->commandPointers);
+        }
+    });
+}
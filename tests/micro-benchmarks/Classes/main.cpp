@@ -0,0 +1,83 @@
+/****************************************************************************
+Copyright (c) 2017 Chukong Technologies Inc.
+
+http://www.cocos2d-x.org
+
+Permission is hereby granted, free of charge, to any person obtaining a copy
+of this software and associated documentation files (the "Software"), to deal
+in the Software without restriction, including without limitation the rights
+to use, copy, modify, merge, publish, distribute, sublicense, and/or sell
+copies of the Software, and to permit persons to whom the Software is
+furnished to do so, subject to the following conditions:
+
+The above copyright notice and this permission notice shall be included in
+all copies or substantial portions of the Software.
+
+THE SOFTWARE IS PROVIDED "AS IS", WITHOUT WARRANTY OF ANY KIND, EXPRESS OR
+IMPLIED, INCLUDING BUT NOT LIMITED TO THE WARRANTIES OF MERCHANTABILITY,
+FITNESS FOR A PARTICULAR PURPOSE AND NONINFRINGEMENT. IN NO EVENT SHALL THE
+AUTHORS OR COPYRIGHT HOLDERS BE LIABLE FOR ANY CLAIM, DAMAGES OR OTHER
+LIABILITY, WHETHER IN AN ACTION OF CONTRACT, TORT OR OTHERWISE, ARISING FROM,
+OUT OF OR IN CONNECTION WITH THE SOFTWARE OR THE USE OR OTHER DEALINGS IN
+THE SOFTWARE.
+****************************************************************************/
+
+#include "BenchmarkRunner.h"
+#include "cocos2d.h"
+
+USING_NS_CC;
+
+class AppDelegate : private Application
+{
+public:
+    explicit AppDelegate(const BenchmarkRunner::Options& options)
+    : _options(options)
+    , _result(0)
+    {
+    }
+
+    int getResult() const { return _result; }
+
+    virtual void initGLContextAttrs() override
+    {
+        GLContextAttrs glContextAttrs = {8, 8, 8, 8, 24, 8};
+        GLView::setGLContextAttrs(glContextAttrs);
+    }
+
+    virtual bool applicationDidFinishLaunching() override
+    {
+        // a hidden window gives the renderer benchmarks a context and the default programs
+        auto director = Director::getInstance();
+        auto glview = GLViewImpl::createWithRect("micro-benchmarks", Rect(0, 0, 64, 64));
+        glfwHideWindow(glview->getWindow());
+        director->setOpenGLView(glview);
+
+        BenchmarkRunner runner;
+        addMathBenchmarks(runner);
+        addContainerBenchmarks(runner);
+        addRendererBenchmarks(runner);
+        addBaseBenchmarks(runner);
+        _result = runner.run(_options);
+
+        // the main loop purges the director and returns
+        director->end();
+        return true;
+    }
+
+    virtual void applicationDidEnterBackground() override {}
+    virtual void applicationWillEnterForeground() override {}
+
+private:
+    BenchmarkRunner::Options _options;
+    int _result;
+};
+
+int main(int argc, char *argv[])
+{
+    BenchmarkRunner::Options options;
+    BenchmarkRunner::parseArguments(argc, argv, &options);
+
+    AppDelegate app(options);
+    Application::getInstance()->run();
+    return app.getResult();
+}
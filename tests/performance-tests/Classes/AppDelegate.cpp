@@ -74,7 +74,20 @@ bool AppDelegate::applicationDidFinishLaunching()
 
     register_all_packages();
 
-    TestController::getInstance();
+    auto controller = TestController::getInstance();
+
+    TestController::BenchmarkOptions benchmarkOptions;
+    if (TestController::parseBenchmarkArguments(TestController::getLaunchArguments(), &benchmarkOptions))
+    {
+#if (CC_TARGET_PLATFORM == CC_PLATFORM_WIN32) || (CC_TARGET_PLATFORM == CC_PLATFORM_MAC) || (CC_TARGET_PLATFORM == CC_PLATFORM_LINUX)
+        // still rendered, into the framebuffer of the hidden window
+        if (benchmarkOptions.headless)
+        {
+            glfwHideWindow(static_cast<GLViewImpl*>(glview)->getWindow());
+        }
+#endif
+        controller->startBenchmark(benchmarkOptions);
+    }
 
     return true;
 }
@@ -19,6 +19,7 @@
 #define KEY_TIMESTAMP           "timeStamp"
 
 #define FILE_VERSION          1
+#define BENCHMARK_FILE_NAME_FMT "Benchmark-%s-%s.json"
 
 #define USE_PRETTY_OUTPUT_FORMAT        0
 #define USE_JSON_FORMAT                 1
@@ -211,17 +212,8 @@ void Profile::testCaseEnd()
     testData[curTestName] = Value(theData);
 }
 
-void Profile::flush()
+static std::string getOutputPath()
 {
-    // record the format version
-    testData[KEY_FILE_VERSION] = Value(FILE_VERSION);
-    testData[KEY_DEVICE] = Value(DEVICE_NAME);
-    testData[KEY_OS_VERSION] = Value(OS_VERSION);
-    testData[KEY_ENGINE_VERSION] = Value(cocos2d::cocos2dVersion());
-    time_t t = time(0);
-    localtime(&t);
-    testData[KEY_TIMESTAMP] = Value(genStr("%ld", t));
-
 #if CC_TARGET_PLATFORM == CC_PLATFORM_ANDROID
     std::string checkPath = "/mnt/sdcard/PerfTest";
     auto writablePath = checkPath;
@@ -235,6 +227,24 @@ void Profile::flush()
 #else
     auto writablePath = cocos2d::FileUtils::getInstance()->getWritablePath();
 #endif
+    return writablePath;
+}
+
+static void addDeviceInfo(ValueMap& data, time_t t)
+{
+    // record the format version
+    data[KEY_FILE_VERSION] = Value(FILE_VERSION);
+    data[KEY_DEVICE] = Value(DEVICE_NAME);
+    data[KEY_OS_VERSION] = Value(OS_VERSION);
+    data[KEY_ENGINE_VERSION] = Value(cocos2d::cocos2dVersion());
+    data[KEY_TIMESTAMP] = Value(genStr("%ld", t));
+}
+
+void Profile::flush()
+{
+    time_t t = time(0);
+    addDeviceInfo(testData, t);
+    auto writablePath = getOutputPath();
 
 #if USE_JSON_FORMAT
     char timeStr[64];
@@ -268,3 +278,41 @@ void Profile::flush()
     cocos2d::FileUtils::getInstance()->writeValueMapToFile(testData, plistFullPath);
 #endif // #endif USE_JSON_FORMAT
 }
+
+std::string Profile::writeBenchmarkReport(cocos2d::ValueMap report, const std::string& path)
+{
+    time_t t = time(0);
+    addDeviceInfo(report, t);
+
+    std::string fullPath = path;
+    if (fullPath.empty())
+    {
+        char timeStr[64];
+        strftime(timeStr, sizeof(timeStr), "%Y-%m-%d-%H%M", localtime(&t));
+        std::string fileName = genStr(BENCHMARK_FILE_NAME_FMT, DEVICE_NAME, timeStr);
+        fullPath = genStr("%s/%s", getOutputPath().c_str(), fileName.c_str());
+    }
+
+    rapidjson::Document document;
+    rapidjson::Value theData = valueMapToJson(report, document.GetAllocator());
+    rapidjson::StringBuffer buffer;
+    rapidjson::Writer<rapidjson::StringBuffer> writer(buffer);
+    theData.Accept(writer);
+
+    if (fullPath == "-")
+    {
+        fprintf(stdout, "%s\n", buffer.GetString());
+        fflush(stdout);
+        return fullPath;
+    }
+
+    FILE *fp = fopen(fullPath.c_str(), "w");
+    if (fp == nullptr)
+    {
+        cocos2d::log("Can't write the benchmark report to %s", fullPath.c_str());
+        return "";
+    }
+    fputs(buffer.GetString(), fp);
+    fclose(fp);
+    return fullPath;
+}
@@ -2,6 +2,7 @@
 #define __PROFILE_H__
 
 #include <string.h>
+#include <string>
 #include <vector>
 #include "base/CCMap.h"
 #include "base/CCValue.h"
@@ -27,6 +28,10 @@ public:
     // write the test result to file
     void flush();
 
+    // write a benchmark report to the path, "-" is stdout and empty is next to the test results.
+    // returns the path written.
+    std::string writeBenchmarkReport(cocos2d::ValueMap report, const std::string& path);
+
 protected:
     cocos2d::ValueMap testData;
     
@@ -195,7 +195,13 @@ void TestList::runThisTest()
         });
         autoTestItem->setPosition(Vec2(VisibleRect::left().x + 80, VisibleRect::bottom().y + 100));
 
-        auto menu = Menu::create(closeItem, autoTestItem, nullptr);
+        auto benchmarkLabel = Label::createWithTTF("Start Benchmark","fonts/arial.ttf",25);
+        auto benchmarkItem = MenuItemLabel::create(benchmarkLabel, [&](Ref* sender){
+            TestController::getInstance()->startBenchmark(TestController::BenchmarkOptions());
+        });
+        benchmarkItem->setPosition(Vec2(VisibleRect::left().x + 90, VisibleRect::bottom().y + 60));
+
+        auto menu = Menu::create(closeItem, autoTestItem, benchmarkItem, nullptr);
         menu->setPosition(Vec2::ZERO);
         scene->addChild(menu, 1);
     }
@@ -10,6 +10,7 @@ enum {
     kMaxNodes = 200,
     kInitNodeCount = 20,
     kNodesIncrease = 10,
+    kCachedStringCount = 8,
 };
 
 enum {
@@ -23,6 +24,7 @@ enum {
     kCaseLabelTTFUpdate = 0,
     kCaseLabelBMFontUpdate,
     kCaseLabelUpdate,
+    kCaseLabelCachedUpdate,
     kCaseLabelBMFontBigLabels,
     kCaseLabelBigLabels,
     
@@ -44,6 +46,7 @@ PerformceLabelTests::PerformceLabelTests()
     addTestCase("LabelTTF Performance Test", [](){ return LabelMainScene::create(); });
     addTestCase("LabelBMFont Performance Test", [](){ return LabelMainScene::create(); });
     addTestCase("Label Performance Test", [](){ return LabelMainScene::create(); });
+    addTestCase("Label layout cache Performance Test", [](){ return LabelMainScene::create(); });
     addTestCase("LabelBMFont large text Performance", [](){ return LabelMainScene::create(); });
     addTestCase("Label large text Performance", [](){ return LabelMainScene::create(); });
 }
@@ -102,6 +105,8 @@ std::string LabelMainScene::title() const
         return "Testing LabelBMFont Update";
     case kCaseLabelUpdate:
         return "Testing Label Update";
+    case kCaseLabelCachedUpdate:
+        return "Testing Label Update with layout cache";
     case kCaseLabelBMFontBigLabels:
         return "Testing LabelBMFont Big Labels";
     case kCaseLabelBigLabels:
@@ -171,6 +176,20 @@ void LabelMainScene::onIncrease(Ref* sender)
             }
             break;
         }        
+    case kCaseLabelCachedUpdate:
+        {
+            TTFConfig ttfConfig("fonts/arial.ttf", 60, GlyphCollection::DYNAMIC);
+            for( int i=0;i< kNodesIncrease;i++)
+            {
+                auto label = Label::createWithTTF(ttfConfig, "Label", TextHAlignment::LEFT);
+                label->setLayoutCacheSize(kCachedStringCount);
+                label->setPosition(Vec2((size.width/2 + rand() % 50), ((int)size.height/2 + rand() % 50)));
+                _labelContainer->addChild(label, 1, _quantityNodes);
+
+                _quantityNodes++;
+            }
+            break;
+        }
     case kCaseLabelBMFontBigLabels:
         for( int i=0;i< kNodesIncrease;i++)
         {
@@ -230,12 +249,20 @@ void LabelMainScene::updateText(float dt)
             minFrameRate = curFrameRate;
     }
 
-    if(_curTestCase > kCaseLabelUpdate)
+    if(_curTestCase > kCaseLabelCachedUpdate)
         return;
 
     _accumulativeTime += dt;
     char text[20];
-    sprintf(text,"%.2f",_accumulativeTime);
+    if (_curTestCase == kCaseLabelCachedUpdate)
+    {
+        // a score switching between a few values
+        sprintf(text, "%d", (int)(_accumulativeTime * 60) % kCachedStringCount * 100);
+    }
+    else
+    {
+        sprintf(text,"%.2f",_accumulativeTime);
+    }
 
     auto& children = _labelContainer->getChildren();
     switch (_curTestCase)
@@ -253,6 +280,7 @@ void LabelMainScene::updateText(float dt)
         }
         break;
     case kCaseLabelUpdate:
+    case kCaseLabelCachedUpdate:
         for(const auto &child : children) {
             Label* label = (Label*)child;
             label->setString(text);
@@ -335,6 +363,9 @@ void LabelMainScene::endStat(float dt)
         case kCaseLabelUpdate:
             tf = "Label";
             break;
+        case kCaseLabelCachedUpdate:
+            tf = "Label Cached";
+            break;
         case kCaseLabelBMFontBigLabels:
             tf = "LabelBMFont Big Labels";
             break;
@@ -45,6 +45,7 @@ PerformceNodeChildrenTests::PerformceNodeChildrenTests()
 //    ADD_TEST_CASE(ReorderSpriteSheet);
 //    ADD_TEST_CASE(SortAllChildrenSpriteSheet);
     ADD_TEST_CASE(VisitSceneGraph);
+    ADD_TEST_CASE(ReorderFewChildren);
 }
 
 enum {
@@ -980,3 +981,73 @@ const char*  VisitSceneGraph::testName()
 {
     return "visit()";
 }
+
+////////////////////////////////////////////////////////
+//
+// ReorderFewChildren
+//
+////////////////////////////////////////////////////////
+void ReorderFewChildren::initWithQuantityOfNodes(unsigned int nodes)
+{
+    _layer = Node::create();
+    addChild(_layer);
+
+    NodeChildrenMainScene::initWithQuantityOfNodes(nodes);
+    scheduleUpdate();
+}
+
+void ReorderFewChildren::updateQuantityOfNodes()
+{
+    // increase nodes
+    if( currentQuantityOfNodes < quantityOfNodes )
+    {
+        for(int i = 0; i < (quantityOfNodes-currentQuantityOfNodes); i++)
+        {
+            auto node = Node::create();
+            _layer->addChild(node, CCRANDOM_MINUS1_1() * 1000, 1000 + currentQuantityOfNodes + i);
+        }
+    }
+
+    // decrease nodes
+    else if ( currentQuantityOfNodes > quantityOfNodes )
+    {
+        for(int i = 0; i < (currentQuantityOfNodes-quantityOfNodes); i++)
+        {
+            _layer->removeChildByTag(1000 + currentQuantityOfNodes - i -1 );
+        }
+    }
+
+    currentQuantityOfNodes = quantityOfNodes;
+    _layer->sortAllChildren();
+}
+
+void ReorderFewChildren::update(float dt)
+{
+    // like an isometric layer: 1% of the children change their z order every frame
+    auto& children = _layer->getChildren();
+    auto count = children.size();
+    for (ssize_t i = 0; count > 0 && i < count / 100 + 1; i++)
+    {
+        auto child = children.at(cocos2d::random((ssize_t)0, count - 1));
+        child->setLocalZOrder(CCRANDOM_MINUS1_1() * 1000);
+    }
+
+    CC_PROFILER_START( this->profilerName() );
+    _layer->sortAllChildren();
+    CC_PROFILER_STOP( this->profilerName() );
+}
+
+std::string ReorderFewChildren::title() const
+{
+    return "Node::sortAllChildren() with few changes";
+}
+
+std::string ReorderFewChildren::subtitle() const
+{
+    return "1% of the children are reordered every frame. See console";
+}
+
+const char*  ReorderFewChildren::testName()
+{
+    return "sortAllChildren()";
+}
@@ -218,4 +218,21 @@ public:
     virtual const char* testName() override;
 };
 
+class ReorderFewChildren : public NodeChildrenMainScene
+{
+public:
+    CREATE_FUNC(ReorderFewChildren);
+
+    void initWithQuantityOfNodes(unsigned int nodes) override;
+
+    virtual void update(float dt) override;
+    void updateQuantityOfNodes() override;
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual const char* testName() override;
+
+protected:
+    cocos2d::Node* _layer;
+};
+
 #endif // __PERFORMANCE_NODE_CHILDREN_TEST_H__
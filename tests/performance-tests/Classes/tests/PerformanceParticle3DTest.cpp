@@ -21,6 +21,8 @@ static int autoTestParticleCounts[] = {
 PerformceParticle3DTests::PerformceParticle3DTests()
 {
     ADD_TEST_CASE(Particle3DPerformTest);
+    ADD_TEST_CASE(Particle3DBatchedPerformTest);
+    ADD_TEST_CASE(Particle3DParallelPerformTest);
 }
 
 ////////////////////////////////////////////////////////
@@ -86,6 +88,22 @@ void Particle3DMainScene::initScene()
     schedule(CC_SCHEDULE_SELECTOR(Particle3DMainScene::step));
 }
 
+void Particle3DMainScene::onEnter()
+{
+    Scene::onEnter();
+
+    PUParticleSystem3D::setBatchedUpdateEnabled(_batchedUpdate);
+    PUParticleSystem3D::setParallelUpdateEnabled(_parallelUpdate);
+}
+
+void Particle3DMainScene::onExit()
+{
+    PUParticleSystem3D::setBatchedUpdateEnabled(false);
+    PUParticleSystem3D::setParallelUpdateEnabled(false);
+
+    Scene::onExit();
+}
+
 void Particle3DMainScene::onExitTransitionDidStart()
 {
     Scene::onExitTransitionDidStart();
@@ -101,7 +119,8 @@ void Particle3DMainScene::onEnterTransitionDidFinish()
     Scene::onEnterTransitionDidFinish();
     
     if (this->isAutoTesting()) {
-        Profile::getInstance()->testCaseBegin("Particle3DTest",
+        const char* testName = _parallelUpdate ? "Particle3DParallelTest" : (_batchedUpdate ? "Particle3DBatchedTest" : "Particle3DTest");
+        Profile::getInstance()->testCaseBegin(testName,
                                               genStrVector("ParticleSystemCount", nullptr),
                                               genStrVector("Avg", "Min", "Max", nullptr));
         autoTestIndex = 0;
@@ -246,3 +265,46 @@ bool Particle3DPerformTest::init()
 
     return false;
 }
+
+////////////////////////////////////////////////////////
+//
+// Particle3DBatchedPerformTest
+//
+////////////////////////////////////////////////////////
+std::string Particle3DBatchedPerformTest::title() const
+{
+    return "Particle3D Batched Affectors Test";
+}
+
+bool Particle3DBatchedPerformTest::init()
+{
+    if (Particle3DMainScene::init())
+    {
+        _batchedUpdate = true;
+        initScene();
+        return true;
+    }
+    return false;
+}
+
+////////////////////////////////////////////////////////
+//
+// Particle3DParallelPerformTest
+//
+////////////////////////////////////////////////////////
+std::string Particle3DParallelPerformTest::title() const
+{
+    return "Particle3D Batched Parallel Test";
+}
+
+bool Particle3DParallelPerformTest::init()
+{
+    if (Particle3DMainScene::init())
+    {
+        _batchedUpdate = true;
+        _parallelUpdate = true;
+        initScene();
+        return true;
+    }
+    return false;
+}
@@ -17,6 +17,8 @@ public:
     virtual void doTest() = 0;
 
     // overrides
+    virtual void onEnter() override;
+    virtual void onExit() override;
     virtual void onExitTransitionDidStart() override;
     virtual void onEnterTransitionDidFinish() override;
     void beginStat(float dt);
@@ -35,6 +37,10 @@ protected:
     float      totalStatTime;
     float      minFrameRate;
     float      maxFrameRate;
+
+    // update modes of PUParticleSystem3D used by the test
+    bool       _batchedUpdate = false;
+    bool       _parallelUpdate = false;
 };
 
 class Particle3DPerformTest : public Particle3DMainScene
@@ -47,4 +53,24 @@ public:
     virtual void doTest()override{};
 };
 
+class Particle3DBatchedPerformTest : public Particle3DMainScene
+{
+public:
+    CREATE_FUNC(Particle3DBatchedPerformTest);
+
+    virtual bool init() override;
+    virtual std::string title() const override;
+    virtual void doTest()override{};
+};
+
+class Particle3DParallelPerformTest : public Particle3DMainScene
+{
+public:
+    CREATE_FUNC(Particle3DParallelPerformTest);
+
+    virtual bool init() override;
+    virtual std::string title() const override;
+    virtual void doTest()override{};
+};
+
 #endif
@@ -6,6 +6,7 @@ USING_NS_CC;
 PerformceTextureTests::PerformceTextureTests()
 {
     ADD_TEST_CASE(TexturePerformceTest);
+    ADD_TEST_CASE(TextureConversionPerformceTest);
 }
 
 static float calculateDeltaTime( struct timeval *lastUpdate )
@@ -332,3 +333,98 @@ std::string TexturePerformceTest::subtitle() const
 {
     return "See console for results";
 }
+
+////////////////////////////////////////////////////////
+//
+// TextureConversionPerformceTest
+//
+////////////////////////////////////////////////////////
+void TextureConversionPerformceTest::performTests()
+{
+    if (isAutoTesting()) {
+        Profile::getInstance()->testCaseBegin("TextureConversionTest",
+                                              genStrVector("Conversion", "Resolution", nullptr),
+                                              genStrVector("Time", nullptr));
+    }
+
+    static const int SIZE = 1024;
+    static const int LOOPS = 10;
+    const ssize_t pixels = SIZE * SIZE;
+
+    std::vector<unsigned char> rgba(pixels * 4);
+    for (ssize_t i = 0; i < pixels * 4; ++i)
+        rgba[i] = (unsigned char)(i * 7 + i / 13);
+
+    auto image = new (std::nothrow) Image();
+    image->initWithRawData(rgba.data(), rgba.size(), SIZE, SIZE, 8, false);
+
+    // the conversions are private to Texture2D, they are timed with the upload,
+    // RGBA8888 is uploaded without conversion and gives the time of the upload alone
+    struct Conversion
+    {
+        const char* name;
+        Texture2D::PixelFormat format;
+    };
+    const Conversion conversions[] = {
+        { "RGBA8888", Texture2D::PixelFormat::RGBA8888 },
+        { "RGBA8888 -> RGB888", Texture2D::PixelFormat::RGB888 },
+        { "RGBA8888 -> RGB565", Texture2D::PixelFormat::RGB565 },
+        { "RGBA8888 -> RGBA4444", Texture2D::PixelFormat::RGBA4444 },
+        { "RGBA8888 -> RGB5A1", Texture2D::PixelFormat::RGB5A1 },
+    };
+
+    struct timeval now;
+    log("--------");
+    log("--- %d x %d, %d times ---", SIZE, SIZE, LOOPS);
+
+    for (const auto& conversion : conversions)
+    {
+        gettimeofday(&now, nullptr);
+        for (int i = 0; i < LOOPS; ++i)
+        {
+            auto texture = new (std::nothrow) Texture2D();
+            texture->initWithImage(image, conversion.format);
+            texture->release();
+        }
+        auto dt = calculateDeltaTime(&now) * 1000 / LOOPS;
+        log("%s  ms:%f", conversion.name, dt);
+        if (isAutoTesting())
+            Profile::getInstance()->addTestResult(genStrVector(conversion.name, genStr("%dx%d", SIZE, SIZE).c_str(), nullptr),
+                                                  genStrVector(genStr("%fms", dt).c_str(), nullptr));
+    }
+    image->release();
+
+    std::vector<unsigned char> out(pixels * 4);
+    gettimeofday(&now, nullptr);
+    for (int i = 0; i < LOOPS; ++i)
+    {
+        std::copy(rgba.begin(), rgba.end(), out.begin());
+        Texture2D::premultiplyAlphaRGBA8888(out.data(), out.size());
+    }
+    auto dt = calculateDeltaTime(&now) * 1000 / LOOPS;
+    log("premultiply alpha  ms:%f", dt);
+    if (isAutoTesting())
+    {
+        Profile::getInstance()->addTestResult(genStrVector("premultiply alpha", genStr("%dx%d", SIZE, SIZE).c_str(), nullptr),
+                                              genStrVector(genStr("%fms", dt).c_str(), nullptr));
+        Profile::getInstance()->testCaseEnd();
+        setAutoTesting(false);
+    }
+}
+
+void TextureConversionPerformceTest::onEnter()
+{
+    TestCase::onEnter();
+
+    performTests();
+}
+
+std::string TextureConversionPerformceTest::title() const
+{
+    return "Texture Conversion Performance Test";
+}
+
+std::string TextureConversionPerformceTest::subtitle() const
+{
+    return "Pixel format conversions, see console for results";
+}
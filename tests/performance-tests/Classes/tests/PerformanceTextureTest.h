@@ -18,4 +18,16 @@ public:
     virtual void onEnter() override;
 };
 
+class TextureConversionPerformceTest : public TestCase
+{
+public:
+    CREATE_FUNC(TextureConversionPerformceTest);
+
+    virtual void performTests();
+
+    virtual std::string title() const override;
+    virtual std::string subtitle() const override;
+    virtual void onEnter() override;
+};
+
 #endif
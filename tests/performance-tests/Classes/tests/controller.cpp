@@ -1,6 +1,10 @@
 #include "controller.h"
 #include <functional>
 #include <chrono>
+#include <algorithm>
+#include <atomic>
+#include <cstdlib>
+#include <new>
 #include "BaseTest.h"
 #include "tests.h"
 #include "Profile.h"
@@ -15,6 +19,93 @@ USING_NS_CC;
 static void initCrashCatch();
 static void disableCrashCatch();
 
+// The engine is linked statically, so replacing the global operator new counts its allocations too.
+// On Windows it's a DLL with its own allocator.
+#if CC_TARGET_PLATFORM != CC_PLATFORM_WIN32 && CC_TARGET_PLATFORM != CC_PLATFORM_WINRT
+#define BENCHMARK_COUNT_ALLOCATIONS 1
+#else
+#define BENCHMARK_COUNT_ALLOCATIONS 0
+#endif
+
+#if BENCHMARK_COUNT_ALLOCATIONS
+static std::atomic<unsigned long long> s_allocationCount(0);
+
+static void* countedAlloc(std::size_t size)
+{
+    ++s_allocationCount;
+    return std::malloc(size ? size : 1);
+}
+
+void* operator new(std::size_t size)
+{
+    void* p = countedAlloc(size);
+    // out of memory, the benchmark can't go on anyway
+    if (p == nullptr)
+        std::abort();
+    return p;
+}
+
+void* operator new[](std::size_t size)
+{
+    void* p = countedAlloc(size);
+    if (p == nullptr)
+        std::abort();
+    return p;
+}
+
+void* operator new(std::size_t size, const std::nothrow_t&) noexcept
+{
+    return countedAlloc(size);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t&) noexcept
+{
+    return countedAlloc(size);
+}
+
+void operator delete(void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void* p) noexcept
+{
+    std::free(p);
+}
+
+void operator delete(void* p, const std::nothrow_t&) noexcept
+{
+    std::free(p);
+}
+
+void operator delete[](void* p, const std::nothrow_t&) noexcept
+{
+    std::free(p);
+}
+#endif
+
+static unsigned long long getAllocationCount()
+{
+#if BENCHMARK_COUNT_ALLOCATIONS
+    return s_allocationCount;
+#else
+    return 0;
+#endif
+}
+
+std::vector<std::string> TestController::s_launchArguments;
+
+TestController::BenchmarkOptions::BenchmarkOptions()
+: warmupFrames(60)
+, frames(300)
+, iterations(3)
+, fixedDeltaTime(1.0f / 60)
+, seed(1)
+, headless(false)
+, exitWhenDone(false)
+{
+}
+
 class RootTests : public TestList
 {
 public:
@@ -39,6 +130,15 @@ TestController::TestController()
 : _stopAutoTest(true)
 , _isRunInBackground(false)
 , _testSuite(nullptr)
+, _benchmarkCaseIndex(0)
+, _benchmarkIteration(0)
+, _benchmarkFrame(-1)
+, _benchmarkFinishing(false)
+, _benchmarkAllocationCount(0)
+, _benchmarkSavedAnimationInterval(1.0f / 60)
+, _benchmarkSavedDisplayStats(false)
+, _benchmarkBeforeUpdateListener(nullptr)
+, _benchmarkAfterDrawListener(nullptr)
 {
     _director = Director::getInstance();
     _rootTestList = new (std::nothrow) RootTests;
@@ -47,13 +147,23 @@ TestController::TestController()
 
 TestController::~TestController()
 {
+    if (isBenchmarking())
+    {
+        _director->getEventDispatcher()->removeEventListener(_benchmarkBeforeUpdateListener);
+        _director->getEventDispatcher()->removeEventListener(_benchmarkAfterDrawListener);
+    }
+    for (auto test : _benchmarkTests)
+    {
+        test->release();
+    }
+
     _rootTestList->release();
     _rootTestList = nullptr;
 }
 
 void TestController::startAutoTest()
 {
-    if (!_autoTestThread.joinable())
+    if (!_autoTestThread.joinable() && !isBenchmarking())
     {
         _stopAutoTest = false;
         _logIndentation = "";
@@ -308,6 +418,284 @@ bool TestController::checkTest(TestCase* testCase)
     return true;
 }
 
+bool TestController::parseBenchmarkArguments(const std::vector<std::string>& args, BenchmarkOptions* options)
+{
+    bool benchmark = false;
+    for (size_t i = 0; i < args.size(); ++i)
+    {
+        const auto& arg = args[i];
+        bool hasValue = i + 1 < args.size();
+
+        if (arg == "--benchmark")
+            benchmark = true;
+        else if (arg == "--headless")
+            options->headless = true;
+        else if (arg == "--exit")
+            options->exitWhenDone = true;
+        else if (arg == "--warmup" && hasValue)
+            options->warmupFrames = std::max(0, atoi(args[++i].c_str()));
+        else if (arg == "--frames" && hasValue)
+            options->frames = std::max(1, atoi(args[++i].c_str()));
+        else if (arg == "--iterations" && hasValue)
+            options->iterations = std::max(1, atoi(args[++i].c_str()));
+        else if (arg == "--delta-time" && hasValue)
+            options->fixedDeltaTime = std::max(0.0f, (float)atof(args[++i].c_str()));
+        else if (arg == "--seed" && hasValue)
+            options->seed = (unsigned int)strtoul(args[++i].c_str(), nullptr, 10);
+        else if (arg == "--filter" && hasValue)
+            options->filter = args[++i];
+        else if (arg == "--output" && hasValue)
+            options->outputPath = args[++i];
+    }
+
+    return benchmark;
+}
+
+void TestController::startBenchmark(const BenchmarkOptions& options)
+{
+    if (isBenchmarking() || !_stopAutoTest)
+    {
+        logEx("%sThe benchmark can't run with another one or the auto test", LOG_TAG);
+        return;
+    }
+
+    _benchmarkOptions = options;
+    _benchmarkCases.clear();
+    _benchmarkResults.clear();
+    collectBenchmarkCases(_rootTestList, "");
+    logEx("%sBegin benchmark: %d test cases", LOG_TAG, (int)_benchmarkCases.size());
+
+    _benchmarkCaseIndex = 0;
+    _benchmarkIteration = 0;
+    _benchmarkFrame = -1;
+    _benchmarkFinishing = false;
+
+    // the measurement shouldn't wait for the frame rate, the stats would add draw calls
+    _benchmarkSavedAnimationInterval = _director->getAnimationInterval();
+    _benchmarkSavedDisplayStats = _director->isDisplayStats();
+    _director->setDisplayStats(false);
+    _director->setAnimationInterval(1.0f / 1000);
+    _director->setFixedDeltaTime(_benchmarkOptions.fixedDeltaTime);
+
+    auto dispatcher = _director->getEventDispatcher();
+    _benchmarkBeforeUpdateListener = dispatcher->addCustomEventListener(Director::EVENT_BEFORE_UPDATE, [this](EventCustom*){
+        _benchmarkFrameBegin = std::chrono::steady_clock::now();
+    });
+    _benchmarkAfterDrawListener = dispatcher->addCustomEventListener(Director::EVENT_AFTER_DRAW, [this](EventCustom*){
+        runBenchmarkFrame();
+    });
+    _benchmarkFrameBegin = std::chrono::steady_clock::now();
+    _benchmarkAllocationCount = getAllocationCount();
+}
+
+void TestController::collectBenchmarkCases(TestList* testList, const std::string& path)
+{
+    int testIndex = 0;
+    for (auto& callback : testList->_testCallbacks)
+    {
+        auto testName = testList->_childTestNames[testIndex++];
+        if (!callback)
+            continue;
+
+        auto test = callback();
+        test->setTestParent(testList);
+        test->setTestName(testName);
+        _benchmarkTests.push_back(test);
+
+        auto testPath = path + testName + "/";
+        if (test->isTestList())
+        {
+            collectBenchmarkCases((TestList*)test, testPath);
+            continue;
+        }
+
+        auto testSuite = (TestSuite*)test;
+        for (int i = 0; i < (int)testSuite->_childTestNames.size(); ++i)
+        {
+            auto casePath = testPath + testSuite->_childTestNames[i];
+            if (_benchmarkOptions.filter.empty() || casePath.find(_benchmarkOptions.filter) != std::string::npos)
+            {
+                _benchmarkCases.push_back({ testSuite, i, casePath });
+            }
+        }
+    }
+}
+
+void TestController::runBenchmarkFrame()
+{
+    auto frameTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - _benchmarkFrameBegin).count() / 1000.0f;
+    auto allocationCount = getAllocationCount();
+    auto allocations = (int)(allocationCount - _benchmarkAllocationCount);
+    _benchmarkAllocationCount = allocationCount;
+
+    if (_benchmarkFinishing)
+    {
+        // the last test case has been replaced in this frame, its suite isn't used any more
+        auto dispatcher = _director->getEventDispatcher();
+        dispatcher->removeEventListener(_benchmarkBeforeUpdateListener);
+        dispatcher->removeEventListener(_benchmarkAfterDrawListener);
+        _benchmarkBeforeUpdateListener = nullptr;
+        _benchmarkAfterDrawListener = nullptr;
+
+        for (auto test : _benchmarkTests)
+        {
+            test->release();
+        }
+        _benchmarkTests.clear();
+        _benchmarkCases.clear();
+
+        if (_benchmarkOptions.exitWhenDone)
+        {
+            _director->end();
+        }
+        return;
+    }
+
+    if (_benchmarkFrame < 0)
+    {
+        if (_benchmarkCaseIndex >= _benchmarkCases.size())
+        {
+            finishBenchmark();
+        }
+        else
+        {
+            loadBenchmarkCase();
+        }
+        return;
+    }
+
+    // the first frame replaces the scene
+    if (++_benchmarkFrame <= _benchmarkOptions.warmupFrames + 1)
+        return;
+
+    _benchmarkFrameTimes.push_back(frameTime);
+    _benchmarkDrawCalls.push_back((int)_director->getRenderer()->getDrawnBatches());
+    _benchmarkAllocations.push_back(allocations);
+
+    if (_benchmarkFrame - _benchmarkOptions.warmupFrames - 1 < _benchmarkOptions.frames)
+        return;
+
+    // the mean of this iteration
+    float sum = 0;
+    auto iterationBegin = _benchmarkFrameTimes.end() - _benchmarkOptions.frames;
+    for (auto it = iterationBegin; it != _benchmarkFrameTimes.end(); ++it)
+    {
+        sum += *it;
+    }
+    _benchmarkIterationMeans.push_back(sum / _benchmarkOptions.frames);
+
+    _benchmarkFrame = -1;
+    if (++_benchmarkIteration >= _benchmarkOptions.iterations)
+    {
+        addBenchmarkResult();
+        _benchmarkIteration = 0;
+        ++_benchmarkCaseIndex;
+    }
+}
+
+void TestController::loadBenchmarkCase()
+{
+    auto& benchmarkCase = _benchmarkCases[_benchmarkCaseIndex];
+    if (_benchmarkIteration == 0)
+    {
+        logEx("%s%sBenchmark:%s", LOG_TAG, LOG_INDENTATION, benchmarkCase.path.c_str());
+    }
+
+    // the same random numbers for each run
+    std::srand(_benchmarkOptions.seed);
+
+    auto testSuite = benchmarkCase.suite;
+    testSuite->_currTestIndex = benchmarkCase.index;
+    auto scene = testSuite->_testCallbacks[benchmarkCase.index]();
+
+    auto transitionScene = dynamic_cast<TransitionScene*>(scene);
+    auto testCase = (TestCase*)(transitionScene ? transitionScene->getInScene() : scene);
+    testCase->setTestSuite(testSuite);
+    testCase->setTestCaseName(testSuite->_childTestNames[benchmarkCase.index]);
+    _testSuite = testSuite;
+
+    _director->replaceScene(scene);
+    _benchmarkFrame = 0;
+}
+
+static ValueMap getBenchmarkStats(std::vector<float> samples)
+{
+    std::sort(samples.begin(), samples.end());
+    // nearest rank
+    auto percentile = [&samples](float p) {
+        return samples[(size_t)(p * (samples.size() - 1) + 0.5f)];
+    };
+
+    double sum = 0;
+    for (auto sample : samples)
+    {
+        sum += sample;
+    }
+
+    ValueMap stats;
+    stats["mean"] = sum / samples.size();
+    stats["p50"] = percentile(0.5f);
+    stats["p99"] = percentile(0.99f);
+    stats["min"] = samples.front();
+    stats["max"] = samples.back();
+    return stats;
+}
+
+void TestController::addBenchmarkResult()
+{
+    ValueMap result;
+    result["name"] = _benchmarkCases[_benchmarkCaseIndex].path;
+    result["frames"] = (int)_benchmarkFrameTimes.size();
+    result["frameTimeMs"] = getBenchmarkStats(_benchmarkFrameTimes);
+    result["drawCalls"] = getBenchmarkStats(std::vector<float>(_benchmarkDrawCalls.begin(), _benchmarkDrawCalls.end()));
+    if (BENCHMARK_COUNT_ALLOCATIONS)
+    {
+        result["allocations"] = getBenchmarkStats(std::vector<float>(_benchmarkAllocations.begin(), _benchmarkAllocations.end()));
+    }
+
+    ValueVector iterationMeans;
+    for (auto mean : _benchmarkIterationMeans)
+    {
+        iterationMeans.push_back(Value(mean));
+    }
+    result["iterationFrameTimeMs"] = iterationMeans;
+
+    _benchmarkResults.push_back(Value(result));
+
+    _benchmarkFrameTimes.clear();
+    _benchmarkIterationMeans.clear();
+    _benchmarkDrawCalls.clear();
+    _benchmarkAllocations.clear();
+}
+
+void TestController::finishBenchmark()
+{
+    ValueMap options;
+    options["warmupFrames"] = _benchmarkOptions.warmupFrames;
+    options["frames"] = _benchmarkOptions.frames;
+    options["iterations"] = _benchmarkOptions.iterations;
+    options["fixedDeltaTime"] = _benchmarkOptions.fixedDeltaTime;
+    options["seed"] = (int)_benchmarkOptions.seed;
+    options["filter"] = _benchmarkOptions.filter;
+
+    ValueMap report;
+    report["options"] = options;
+    report["results"] = _benchmarkResults;
+    _benchmarkResults.clear();
+
+    auto path = Profile::getInstance()->writeBenchmarkReport(report, _benchmarkOptions.outputPath);
+    logEx("%sEnd benchmark, report: %s", LOG_TAG, path.c_str());
+
+    _director->setFixedDeltaTime(0);
+    _director->setAnimationInterval(_benchmarkSavedAnimationInterval);
+    _director->setDisplayStats(_benchmarkSavedDisplayStats);
+
+    // the suites are released once the root list replaced the last test case
+    _testSuite = nullptr;
+    _rootTestList->runThisTest();
+    _benchmarkFinishing = true;
+}
+
 void TestController::handleCrash()
 {
     disableCrashCatch();
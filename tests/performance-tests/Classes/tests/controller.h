@@ -25,10 +25,14 @@ THE SOFTWARE.
 #ifndef _CPPTESTS_CONTROLLER_H__
 #define _CPPTESTS_CONTROLLER_H__
 
+#include <chrono>
 #include <condition_variable>
 #include <string>
 #include <thread>
+#include <vector>
+#include "base/CCValue.h"
 
+class TestBase;
 class TestList;
 class TestSuite;
 class TestCase;
@@ -39,6 +43,7 @@ namespace cocos2d
     class Touch;
     class Event;
     class EventListenerTouchOneByOne;
+    class EventListenerCustom;
 }
 
 class TestController
@@ -52,6 +57,48 @@ public:
     void startAutoTest();
     void stopAutoTest();
 
+    /** Options of the benchmark runner.*/
+    struct BenchmarkOptions
+    {
+        BenchmarkOptions();
+
+        /** Frames run before each measurement, "--warmup N".*/
+        int warmupFrames;
+        /** Frames measured per iteration, "--frames N".*/
+        int frames;
+        /** How many times each test case is loaded and measured, "--iterations N".*/
+        int iterations;
+        /** Game time advanced by each frame, "--delta-time SECONDS".*/
+        float fixedDeltaTime;
+        /** Seed of std::rand before each test case is created, "--seed N".*/
+        unsigned int seed;
+        /** Only the test cases whose path contains it run, "--filter TEXT".*/
+        std::string filter;
+        /** File of the JSON report, "-" is stdout, "--output PATH". Next to the Profile results if empty.*/
+        std::string outputPath;
+        /** Whether the window is hidden, "--headless". Only on desktop.*/
+        bool headless;
+        /** Whether the application ends with the benchmark, "--exit".*/
+        bool exitWhenDone;
+    };
+
+    /**
+     * Parses the command line arguments of the benchmark runner.
+     * Returns true if "--benchmark" is one of them.
+     */
+    static bool parseBenchmarkArguments(const std::vector<std::string>& args, BenchmarkOptions* options);
+    /** The command line arguments, set by the main function of the platform.*/
+    static void setLaunchArguments(const std::vector<std::string>& args) { s_launchArguments = args; }
+    static const std::vector<std::string>& getLaunchArguments() { return s_launchArguments; }
+
+    /**
+     * Runs every test case in sequence with a fixed delta time, and writes the frame time (mean/p50/p99),
+     * draw calls and allocations of each one into a JSON report.
+     * The frame time is the CPU time from the update to the end of the draw, the swap isn't part of it.
+     */
+    void startBenchmark(const BenchmarkOptions& options);
+    bool isBenchmarking() const { return _benchmarkAfterDrawListener != nullptr; }
+
     void handleCrash();
 
     void onEnterBackground();
@@ -72,6 +119,12 @@ private:
 
     void logEx(const char * format, ...);
 
+    void collectBenchmarkCases(TestList* testList, const std::string& path);
+    void runBenchmarkFrame();
+    void loadBenchmarkCase();
+    void addBenchmarkResult();
+    void finishBenchmark();
+
     bool _stopAutoTest;
     bool _isRunInBackground;
 
@@ -86,6 +139,39 @@ private:
     cocos2d::Director* _director;
 
     std::string _logIndentation;
+
+    struct BenchmarkCase
+    {
+        TestSuite* suite;
+        int index;
+        std::string path;
+    };
+
+    static std::vector<std::string> s_launchArguments;
+
+    BenchmarkOptions _benchmarkOptions;
+    std::vector<BenchmarkCase> _benchmarkCases;
+    // the test lists and suites created for the benchmark, released at the end
+    std::vector<TestBase*> _benchmarkTests;
+    size_t _benchmarkCaseIndex;
+    int _benchmarkIteration;
+    // -1 until the test case is loaded
+    int _benchmarkFrame;
+    bool _benchmarkFinishing;
+
+    std::vector<float> _benchmarkFrameTimes;
+    std::vector<float> _benchmarkIterationMeans;
+    std::vector<int> _benchmarkDrawCalls;
+    std::vector<int> _benchmarkAllocations;
+    cocos2d::ValueVector _benchmarkResults;
+
+    std::chrono::steady_clock::time_point _benchmarkFrameBegin;
+    unsigned long long _benchmarkAllocationCount;
+    float _benchmarkSavedAnimationInterval;
+    bool _benchmarkSavedDisplayStats;
+
+    cocos2d::EventListenerCustom* _benchmarkBeforeUpdateListener;
+    cocos2d::EventListenerCustom* _benchmarkAfterDrawListener;
 };
 
 #endif
@@ -24,11 +24,14 @@
 
 #include "AppDelegate.h"
 #include "cocos2d.h"
+#include "controller.h"
 
 USING_NS_CC;
 
 int main(int argc, char *argv[])
 {
+    TestController::setLaunchArguments(std::vector<std::string>(argv + 1, argv + argc));
+
     AppDelegate app;
     return Application::getInstance()->run();
 }
@@ -1,6 +1,7 @@
 #include "main.h"
 #include "AppDelegate.h"
 #include "cocos2d.h"
+#include "controller.h"
 
 USING_NS_CC;
 
@@ -12,6 +13,15 @@ int WINAPI _tWinMain(HINSTANCE hInstance,
     UNREFERENCED_PARAMETER(hPrevInstance);
     UNREFERENCED_PARAMETER(lpCmdLine);
 
+    std::vector<std::string> args;
+    for (int i = 1; i < __argc; ++i)
+    {
+        char arg[1024] = { 0 };
+        WideCharToMultiByte(CP_UTF8, 0, __wargv[i], -1, arg, sizeof(arg) - 1, nullptr, nullptr);
+        args.push_back(arg);
+    }
+    TestController::setLaunchArguments(args);
+
     // create the application instance
     AppDelegate app;
     return Application::getInstance()->run();